@@ -30,6 +30,9 @@ lib.i2c_write_to_device.restype = c_int32
 lib.i2c_read_from_device.argtypes = [I2CDeviceHandle, POINTER(c_uint8), c_uint32]
 lib.i2c_read_from_device.restype = c_int32
 
+lib.i2c_wait_for_data.argtypes = [I2CDeviceHandle, c_int32]
+lib.i2c_wait_for_data.restype = c_bool
+
 # Create device
 device = lib.i2c_device_create(1, 0x30)
 
@@ -41,12 +44,15 @@ device = lib.i2c_device_create(1, 0x30)
 # result = lib.i2c_write_to_device(device, write_data, write_len)
 # print(f"Write result: {result}")
 
-# Prepare buffer to read into
+# Prepare buffer to read into, once: the library reads each message straight into it
 read_buffer = (c_uint8 * 1000)()
 read_len = 1000
 
 # Read from device
 while True:
+    # sleep until the device raises its IRQ line
+    if not lib.i2c_wait_for_data(device, -1):
+        continue
     read_count = lib.i2c_read_from_device(device, read_buffer, read_len)
     if read_count > 0:
         print(f"Read {read_count} values: {[read_buffer[i] for i in range(read_count)]}")
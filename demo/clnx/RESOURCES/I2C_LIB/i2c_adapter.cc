@@ -1,6 +1,8 @@
 #include "i2c_adapter.h"
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -14,6 +16,7 @@ extern "C"
 #include <fcntl.h>         //Needed for I2C port
 #include <sys/ioctl.h>     //Needed for I2C port
 #include <linux/i2c-dev.h> //Needed for I2C port
+#include <linux/i2c.h>     //Needed for I2C_RDWR
 #include <i2c/smbus.h>
 #include "i2c_intr_gpio.h"
 }
@@ -21,6 +24,8 @@ extern "C"
 namespace
 {
     constexpr uint32_t SMBUS_BLOCK_LEN = 32;
+    constexpr uint8_t PAGE_SELECT_REG = 0x4;
+    constexpr int16_t PAGE_UNKNOWN = -1;
 
     typedef enum
     {
@@ -96,7 +101,7 @@ namespace
         int16_t checksum;
     };
 
-    int16_t get_checksum(som_i2c_packet_t packet)
+    int16_t get_checksum(const som_i2c_packet_t &packet)
     {
         fletcher_checksum_t checksum = CreateFletcherChecksum();
         checksum = AddInt32ToChecksum(checksum, packet.idx);
@@ -104,6 +109,49 @@ namespace
         checksum = AddInt32ArrayToChecksum(checksum, (int32_t *)packet.data, ((packet.length + 3) & ~3) / 4);
         return FletcherCheckSumAsInt16(checksum);
     }
+
+    // The device refreshes the D2H pages once the previous packet is acknowledged.
+    // A page read is itself a bus transaction, so the first polls go back to back,
+    // then sleeps grow up to PAGE_POLL_MAX_SLEEP_US until PAGE_WAIT_TIMEOUT_MS.
+    constexpr uint32_t PAGE_SPIN_POLLS = 4;
+    constexpr uint32_t PAGE_POLL_MIN_SLEEP_US = 50;
+    constexpr uint32_t PAGE_POLL_MAX_SLEEP_US = 1000;
+    constexpr uint32_t PAGE_WAIT_TIMEOUT_MS = 200;
+
+    // Where the host acknowledges a D2H packet, with its checksum, and clears
+    // the device interrupt.
+    constexpr uint8_t ACK_PAGE = 0x1;
+    constexpr uint8_t ACK_REG = 0x10;
+    constexpr uint8_t INTERRUPT_PAGE = 0x0;
+    constexpr uint8_t INTERRUPT_CLEAR_REG = 0x3;
+
+    //-----------------------------------------------------------------------------
+    // Poll until page_ready() returns true, spinning first and sleeping after.
+    // Returns false if the page did not become ready within PAGE_WAIT_TIMEOUT_MS.
+    template <typename PageReady>
+    bool wait_for_page(PageReady page_ready)
+    {
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(PAGE_WAIT_TIMEOUT_MS);
+        uint32_t sleep_us = PAGE_POLL_MIN_SLEEP_US;
+
+        for (uint32_t polls = 0;; ++polls)
+        {
+            if (page_ready())
+            {
+                return true;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            if (polls >= PAGE_SPIN_POLLS)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+                sleep_us = std::min(sleep_us * 2, PAGE_POLL_MAX_SLEEP_US);
+            }
+        }
+    }
 }
 
 void I2CDevice::init(uint8_t adapter_number, uint8_t device_number, uint8_t irq_pin)
@@ -122,6 +170,11 @@ void I2CDevice::init(uint8_t adapter_number, uint8_t device_number, uint8_t irq_
         throw std::runtime_error("failed to ioctl i2c\n");
     }
 
+    unsigned long funcs = 0;
+    _device_number = device_number;
+    _has_i2c_rdwr = (ioctl(_file, I2C_FUNCS, &funcs) == 0) && (funcs & I2C_FUNC_I2C);
+    _page = PAGE_UNKNOWN;
+
     init_i2c_intr_gpio(irq_pin);
     clear_device_interrupt();
 }
@@ -137,10 +190,89 @@ I2CDevice::I2CDevice(uint8_t adapter_number, uint8_t device_number)
 	init(adapter_number, device_number, 17);
 }
 
+I2CDevice::~I2CDevice()
+{
+    fini_i2c_intr_gpio();
+    close(_file);
+}
+
+int32_t I2CDevice::select_page(uint8_t page)
+{
+    if (_page == page)
+    {
+        return 0;
+    }
+
+    int32_t ret = i2c_smbus_write_byte_data(_file, PAGE_SELECT_REG, page);
+    _page = (ret < 0) ? PAGE_UNKNOWN : page;
+    return ret;
+}
+
 int32_t I2CDevice::write_data(uint8_t page, uint8_t address, uint8_t *data, uint32_t length)
 {
-    // select page
-    i2c_smbus_write_byte_data(_file, 0x4, page);
+    if (!_has_i2c_rdwr)
+    {
+        return write_data_smbus(page, address, data, length);
+    }
+
+    // one combined transaction: [page select] + address and the whole length
+    uint8_t page_select[] = {PAGE_SELECT_REG, page};
+    std::vector<uint8_t> payload(length + 1);
+    payload[0] = address;
+    std::copy(data, data + length, payload.begin() + 1);
+
+    struct i2c_msg msgs[2];
+    uint32_t nmsgs = 0;
+    if (_page != page)
+    {
+        msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(page_select), .buf = page_select};
+    }
+    msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = (uint16_t)payload.size(), .buf = payload.data()};
+
+    struct i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = nmsgs};
+    if (ioctl(_file, I2C_RDWR, &xfer) < 0)
+    {
+        _page = PAGE_UNKNOWN;
+        return -errno;
+    }
+
+    _page = page;
+    return length;
+}
+
+int32_t I2CDevice::read_data(uint8_t page, uint8_t address, uint8_t *data, uint32_t length)
+{
+    if (!_has_i2c_rdwr)
+    {
+        return read_data_smbus(page, address, data, length);
+    }
+
+    // one combined transaction: [page select] + address, repeated START, whole length read
+    uint8_t page_select[] = {PAGE_SELECT_REG, page};
+
+    struct i2c_msg msgs[3];
+    uint32_t nmsgs = 0;
+    if (_page != page)
+    {
+        msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(page_select), .buf = page_select};
+    }
+    msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = 1, .buf = &address};
+    msgs[nmsgs++] = {.addr = _device_number, .flags = I2C_M_RD, .len = (uint16_t)length, .buf = data};
+
+    struct i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = nmsgs};
+    if (ioctl(_file, I2C_RDWR, &xfer) < 0)
+    {
+        _page = PAGE_UNKNOWN;
+        return -errno;
+    }
+
+    _page = page;
+    return length;
+}
+
+int32_t I2CDevice::write_data_smbus(uint8_t page, uint8_t address, uint8_t *data, uint32_t length)
+{
+    select_page(page);
     uint32_t blocks = length / SMBUS_BLOCK_LEN;
     uint32_t bytes_written = 0;
 
@@ -156,11 +288,9 @@ int32_t I2CDevice::write_data(uint8_t page, uint8_t address, uint8_t *data, uint
     return bytes_written;
 }
 
-int32_t I2CDevice::read_data(uint8_t page, uint8_t address, uint8_t *data, uint32_t length)
+int32_t I2CDevice::read_data_smbus(uint8_t page, uint8_t address, uint8_t *data, uint32_t length)
 {
-    // select page
-    uint8_t ret = i2c_smbus_write_byte_data(_file, 0x4, page);
-    uint8_t expected_page = i2c_smbus_read_byte_data(_file, 0x4);
+    select_page(page);
 
     uint32_t blocks = length / SMBUS_BLOCK_LEN;
     uint32_t bytes_read = 0;
@@ -184,7 +314,7 @@ I2CDevice::interrupt_register_t I2CDevice::read_device_interrupt()
 
     if (is_i2c_intr_asserted())
     {
-        ret = i2c_smbus_write_byte_data(_file, 0x4, 0);
+        ret = select_page(0);
         interrupt_val = i2c_smbus_read_byte_data(_file, 0x3);
         interrupt_ready = interrupt_val & 1;
         interrupt_val = interrupt_val >> 1 & 0x7f;
@@ -195,7 +325,7 @@ I2CDevice::interrupt_register_t I2CDevice::read_device_interrupt()
 
 void I2CDevice::write_device_interrupt(uint8_t interrupt)
 {
-    uint8_t ret = i2c_smbus_write_byte_data(_file, 0x4, 0);
+    uint8_t ret = select_page(0);
 
     uint8_t interrupt_val = i2c_smbus_write_byte_data(_file, 0x2, interrupt);
 }
@@ -204,78 +334,184 @@ void I2CDevice::clear_device_interrupt()
 {
     clear_i2c_intr_asserted();
 
-    uint8_t ret = i2c_smbus_write_byte_data(_file, 0x4, 0);
+    uint8_t ret = select_page(0);
 
     uint8_t interrupt_val = i2c_smbus_write_byte_data(_file, 0x3, 1);
 }
 
-std::vector<uint8_t> I2CDevice::read_from_device()
+bool I2CDevice::wait_for_data(int32_t timeout_ms)
 {
-    std::vector<uint8_t> data;
+    return wait_i2c_intr_asserted(timeout_ms) > 0;
+}
+
+int I2CDevice::interrupt_fd()
+{
+    return get_i2c_intr_fd();
+}
+
+int32_t I2CDevice::read_packets(void (*sink)(void *ctx, const uint8_t *data, uint32_t length), void *ctx)
+{
+    constexpr uint32_t NUM_D2H_PAGES = sizeof(D2H_PAGES) / sizeof(D2H_PAGES[0]);
+
+    // packets are read straight into this one, never copied
+    som_i2c_packet_t packet;
+
+    // With I2C_RDWR, the acknowledgement of a packet and the interrupt clear
+    // go out in the same transaction as the first read of the next packet, so
+    // a packet costs one transaction instead of five when the device keeps up.
+    uint32_t ack_checksum = 0;
+    bool ack_pending = false;
+
+    auto send_ack = [&]()
+    {
+        write_data(ACK_PAGE, ACK_REG, (uint8_t *)&ack_checksum, 4);
+        clear_device_interrupt();
+        ack_pending = false;
+    };
+
     auto read_packet = [&]()
     {
-        som_i2c_packet_t packet;
-        for (int i = 0; i < sizeof(D2H_PAGES) / sizeof(D2H_PAGES[0]); ++i){
-            read_data(D2H_PAGES[i], 0x10, (uint8_t *)&packet + i * ISH_BLOCK_LEN * 4, ISH_BLOCK_LEN * 4);
+        if (!_has_i2c_rdwr)
+        {
+            if (ack_pending)
+            {
+                send_ack();
+            }
+            for (uint32_t i = 0; i < NUM_D2H_PAGES; ++i){
+                read_data(D2H_PAGES[i], 0x10, (uint8_t *)&packet + i * ISH_BLOCK_LEN * 4, ISH_BLOCK_LEN * 4);
+            }
+            return;
+        }
+
+        uint8_t ack_select[] = {PAGE_SELECT_REG, ACK_PAGE};
+        uint8_t ack[5] = {ACK_REG};
+        uint8_t clear_select[] = {PAGE_SELECT_REG, INTERRUPT_PAGE};
+        uint8_t clear[] = {INTERRUPT_CLEAR_REG, 1};
+        uint8_t page_select[NUM_D2H_PAGES][2];
+        uint8_t address = 0x10;
+
+        struct i2c_msg msgs[4 + 3 * NUM_D2H_PAGES];
+        uint32_t nmsgs = 0;
+        if (ack_pending)
+        {
+            std::copy((uint8_t *)&ack_checksum, (uint8_t *)&ack_checksum + 4, ack + 1);
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(ack_select), .buf = ack_select};
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(ack), .buf = ack};
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(clear_select), .buf = clear_select};
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = sizeof(clear), .buf = clear};
+            clear_i2c_intr_asserted();
+        }
+        for (uint32_t i = 0; i < NUM_D2H_PAGES; ++i)
+        {
+            page_select[i][0] = PAGE_SELECT_REG;
+            page_select[i][1] = D2H_PAGES[i];
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = 2, .buf = page_select[i]};
+            msgs[nmsgs++] = {.addr = _device_number, .flags = 0, .len = 1, .buf = &address};
+            msgs[nmsgs++] = {.addr = _device_number, .flags = I2C_M_RD, .len = ISH_BLOCK_LEN * 4,
+                             .buf = (uint8_t *)&packet + i * ISH_BLOCK_LEN * 4};
+        }
+
+        struct i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = nmsgs};
+        if (ioctl(_file, I2C_RDWR, &xfer) < 0)
+        {
+            // the acknowledgement goes again with the next poll
+            _page = PAGE_UNKNOWN;
+            packet.checksum = ~get_checksum(packet);
+            return;
         }
-        return packet;
+        _page = D2H_PAGES[NUM_D2H_PAGES - 1];
+        ack_pending = false;
     };
 
     interrupt_register_t interrupt = read_device_interrupt();
 
     if (!interrupt.interrupt_ready)
     {
-        return data;
+        return 0;
     }
     if (interrupt.interrupt_val != ISH_INT_DATA_TRANSMISSION)
     {
-        return data; // wrong interrupt value - how did that happen?
+        return 0; // wrong interrupt value - how did that happen?
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(2)); // wait for page to refresh
 
     uint32_t packet_idx = 0xffff;
+    int32_t total_length = 0;
     while (packet_idx != 1)
     {
-        som_i2c_packet_t packet = read_packet();
-
-        int16_t expected_checksum = packet.checksum;
+        int16_t calculated_checksum;
 
-        int16_t calculated_checksum = get_checksum(packet);
-        if (expected_checksum != calculated_checksum)
+        // the page is ready once it holds a whole packet (checksum matches) that
+        // is not the one acknowledged last (page didn't update yet)
+        bool page_ready = wait_for_page([&]()
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(2));
-            continue;
-        }
-
-        else
+            read_packet();
+            calculated_checksum = get_checksum(packet);
+            return (packet.checksum == calculated_checksum) && (packet.idx != packet_idx);
+        });
+        if (!page_ready)
         {
-            if (packet.idx == packet_idx)
-            {
-                // page didn't update yet, this is the old packet
-                continue;
-            }
-            std::chrono::steady_clock::time_point ack_time = std::chrono::steady_clock::now();
-
-            // write checksum into debug reg to acknowledge
-            uint32_t checksum_4bytes = calculated_checksum;
-            write_data(0x1, 0x10, (uint8_t *)&checksum_4bytes, 4);
+            fprintf(stderr, "timed out waiting for packet after idx %u\n", packet_idx);
+            clear_device_interrupt();
+            return -1;
         }
 
+        // the checksum written into the debug reg acknowledges the packet, and
+        // goes out with the next read
+        ack_checksum = (uint32_t)(int32_t)calculated_checksum;
+        ack_pending = true;
+
         packet_idx = packet.idx;
-        for (int i = 0; i < packet.length; ++i){
-        }
-        data.insert(data.end(), packet.data, packet.data + packet.length);
-		
-		//clear interrupt
-		clear_device_interrupt();
-		
-        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // wait for page to refresh
+        sink(ctx, packet.data, packet.length);
+        total_length += packet.length;
     }
 
+    // no next read for the last one
+    send_ack();
+
+    return total_length;
+}
+
+std::vector<uint8_t> I2CDevice::read_from_device()
+{
+    std::vector<uint8_t> data;
+    auto append = [](void *ctx, const uint8_t *packet_data, uint32_t length)
+    {
+        std::vector<uint8_t> *data = static_cast<std::vector<uint8_t> *>(ctx);
+        data->insert(data->end(), packet_data, packet_data + length);
+    };
 
+    if (read_packets(append, &data) < 0)
+    {
+        data.clear();
+    }
     return data;
 }
 
+int32_t I2CDevice::read_from_device(uint8_t *data, uint32_t max_length)
+{
+    struct buffer_t
+    {
+        uint8_t *data;
+        uint32_t max_length;
+        uint32_t length;
+    } buffer = {.data = data, .max_length = max_length, .length = 0};
+
+    // whatever doesn't fit is still read and acknowledged, to keep in step with the device
+    auto copy = [](void *ctx, const uint8_t *packet_data, uint32_t length)
+    {
+        buffer_t *buffer = static_cast<buffer_t *>(ctx);
+        if (buffer->length < buffer->max_length)
+        {
+            uint32_t count = std::min(length, buffer->max_length - buffer->length);
+            std::copy(packet_data, packet_data + count, buffer->data + buffer->length);
+        }
+        buffer->length += length;
+    };
+
+    int32_t total_length = read_packets(copy, &buffer);
+    return (total_length < 0) ? 0 : total_length;
+}
+
 int32_t I2CDevice::write_to_device(uint8_t *data, uint32_t length)
 {
     // first block write
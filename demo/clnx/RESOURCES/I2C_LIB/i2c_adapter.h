@@ -17,6 +17,7 @@ class I2CDevice
 public:
     I2CDevice(uint8_t adapter_number, uint8_t device_number);
     I2CDevice(uint8_t adapter_number, uint8_t device_number, uint8_t irq_pin);
+    ~I2CDevice();
 
     int32_t write_data(uint8_t page, uint8_t address, uint8_t *data, uint32_t length);
 
@@ -30,13 +31,30 @@ public:
 
     int32_t write_to_device(uint8_t *data, uint32_t length); // bytes_view or something if it exists
     std::vector<uint8_t> read_from_device(); //no buffer length needed if we return std::vector
+    // Reads a message into data without allocating. Returns the message length, which
+    // is larger than max_length if the message was cut short, or 0 if there was none.
+    int32_t read_from_device(uint8_t *data, uint32_t max_length);
 
     interrupt_register_t read_device_interrupt();
     void write_device_interrupt(uint8_t interrupt);
     void clear_device_interrupt();
 
+    // Block until the device raises its IRQ line, up to timeout_ms (-1 for ever).
+    // Returns true if read_from_device() should be called.
+    bool wait_for_data(int32_t timeout_ms);
+    // File descriptor readable when the IRQ line is raised, for poll/epoll.
+    int interrupt_fd();
+
 private:
     void init(uint8_t adapter_number, uint8_t device_number, uint8_t irq_pin);
 
+    int32_t select_page(uint8_t page);
+    int32_t read_packets(void (*sink)(void *ctx, const uint8_t *data, uint32_t length), void *ctx);
+    int32_t write_data_smbus(uint8_t page, uint8_t address, uint8_t *data, uint32_t length);
+    int32_t read_data_smbus(uint8_t page, uint8_t address, uint8_t *data, uint32_t length);
+
     int _file;
+    uint8_t _device_number;
+    bool _has_i2c_rdwr; // adapter takes combined transactions (I2C_RDWR)
+    int16_t _page;      // page last selected on the device, -1 if unknown
 };
@@ -2,48 +2,110 @@
 #include <string.h>
 #include <errno.h>
 #include <stdlib.h>
-#include <wiringPi.h>
-#include <wpiExtensions.h>
+#include <poll.h>
+#include <gpiod.h>
+#include <atomic>
 #include <cstdint>
 
 extern "C"
 {
 
-volatile bool intr_asserted = false;
+#define I2C_INTR_GPIO_CHIP     "gpiochip0"
+#define I2C_INTR_GPIO_CONSUMER "i2c_intr"
 
-static void intr_handler (void) 
-{ 
-    //printf("IRQ\n");
-    intr_asserted = true;
+static struct gpiod_chip *intr_chip = NULL;
+static struct gpiod_line *intr_line = NULL;
+static std::atomic<bool> intr_asserted(false);
+
+// Read the pending edge events of the IRQ line, if any, without blocking.
+// Returns 1 if the line fell since last time, 0 if not, -1 on error.
+static int drain_intr_events(int timeout_ms)
+{
+    struct pollfd pfd = {.fd = gpiod_line_event_get_fd(intr_line), .events = POLLIN | POLLPRI, .revents = 0};
+    struct gpiod_line_event events[16];
+    int ret;
+
+    ret = poll(&pfd, 1, timeout_ms);
+    if (ret <= 0)
+    {
+        return (ret < 0 && errno != EINTR) ? -1 : 0;
+    }
+
+    // more than one edge may be queued, they all mean the same
+    if (gpiod_line_event_read_multiple(intr_line, events, sizeof(events) / sizeof(events[0])) < 0)
+    {
+        return -1;
+    }
+    intr_asserted.store(true, std::memory_order_release);
+    return 1;
 }
 
 void init_i2c_intr_gpio( uint8_t IRQpin )
 {
-    int major, minor;
-    intr_asserted = false;
+    intr_asserted.store(false);
 
-    wiringPiVersion(&major, &minor);
+    intr_chip = gpiod_chip_open_by_name(I2C_INTR_GPIO_CHIP);
+    if (intr_chip == NULL)
+    {
+        printf("Failed to open %s: %s\n", I2C_INTR_GPIO_CHIP, strerror(errno));
+        return;
+    }
 
-    printf("\nISR test (WiringPi %d.%d)\n", major, minor);
+    intr_line = gpiod_chip_get_line(intr_chip, IRQpin);
+    if (intr_line == NULL ||
+        gpiod_line_request_falling_edge_events_flags(intr_line, I2C_INTR_GPIO_CONSUMER,
+                                                     GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP) < 0)
+    {
+        printf("Failed IRQ @ GPIO%d: %s\n", IRQpin, strerror(errno));
+        gpiod_chip_close(intr_chip);
+        intr_chip = NULL;
+        intr_line = NULL;
+        return;
+    }
+    printf("Succeeded IRQ @ GPIO%d \n", IRQpin);
+}
 
-    wiringPiSetupPinType(WPI_PIN_BCM);
-    
-    pinMode(IRQpin, INPUT);
-    pullUpDnControl(IRQpin, PUD_UP);
-    printf("Testing IRQ @ GPIO%d \n", IRQpin);
-    int err = wiringPiISR (IRQpin, INT_EDGE_FALLING , &intr_handler);
-    printf("%s IRQ @ GPIO%d \n", (err == 0) ? "Succeeded" : "Failed", IRQpin);
+void fini_i2c_intr_gpio()
+{
+    if (intr_chip != NULL)
+    {
+        // closing the chip releases the line
+        gpiod_chip_close(intr_chip);
+        intr_chip = NULL;
+        intr_line = NULL;
+    }
 }
 
 bool is_i2c_intr_asserted()
 {
-    return intr_asserted;
-    //return true;
+    if (intr_line != NULL && !intr_asserted.load(std::memory_order_acquire))
+    {
+        drain_intr_events(0);
+    }
+    return intr_asserted.load(std::memory_order_acquire);
 }
 
 void clear_i2c_intr_asserted()
 {
-    intr_asserted = false;
+    intr_asserted.store(false, std::memory_order_release);
+}
+
+int wait_i2c_intr_asserted( int timeout_ms )
+{
+    if (intr_asserted.load(std::memory_order_acquire))
+    {
+        return 1;
+    }
+    if (intr_line == NULL)
+    {
+        return -1;
+    }
+    return drain_intr_events(timeout_ms);
+}
+
+int get_i2c_intr_fd()
+{
+    return (intr_line != NULL) ? gpiod_line_event_get_fd(intr_line) : -1;
 }
 
 }
@@ -4,9 +4,17 @@ extern "C"
 #endif
 
 void init_i2c_intr_gpio( uint8_t IRQpin );
+void fini_i2c_intr_gpio();
 bool is_i2c_intr_asserted();
 void clear_i2c_intr_asserted();
 
+// Block until the IRQ line falls, up to timeout_ms (-1 for ever).
+// Returns 1 if asserted, 0 on timeout, -1 on error.
+int wait_i2c_intr_asserted( int timeout_ms );
+
+// File descriptor readable on an IRQ edge, for poll/epoll based event loops.
+int get_i2c_intr_fd();
+
 #ifdef __cplusplus
 }
 #endif
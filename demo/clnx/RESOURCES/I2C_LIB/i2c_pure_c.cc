@@ -11,7 +11,6 @@
 //=============================================================================
 #include "i2c_pure_c.h"
 #include "i2c_adapter.h"
-#include <vector>
 
 extern "C" {
 
@@ -36,12 +35,9 @@ int32_t i2c_write_to_device(I2CDeviceHandle handle, uint8_t* data, uint32_t leng
 }
 
 int32_t i2c_read_from_device(I2CDeviceHandle handle, uint8_t* out_data, uint32_t max_length) {
-    std::vector<uint8_t> result = static_cast<I2CDevice*>(handle)->read_from_device();
-    uint32_t count = (result.size() < max_length) ? result.size() : max_length;
-    for (uint32_t i = 0; i < count; ++i) {
-        out_data[i] = result[i];
-    }
-    return count;
+    // read in place, a message longer than max_length is cut short
+    int32_t length = static_cast<I2CDevice*>(handle)->read_from_device(out_data, max_length);
+    return ((uint32_t)length < max_length) ? length : max_length;
 }
 
 interrupt_register_t i2c_read_device_interrupt(I2CDeviceHandle handle) {
@@ -56,4 +52,12 @@ void i2c_write_device_interrupt(I2CDeviceHandle handle, uint8_t interrupt) {
     static_cast<I2CDevice*>(handle)->write_device_interrupt(interrupt);
 }
 
+bool i2c_wait_for_data(I2CDeviceHandle handle, int32_t timeout_ms) {
+    return static_cast<I2CDevice*>(handle)->wait_for_data(timeout_ms);
+}
+
+int i2c_get_interrupt_fd(I2CDeviceHandle handle) {
+    return static_cast<I2CDevice*>(handle)->interrupt_fd();
+}
+
 }
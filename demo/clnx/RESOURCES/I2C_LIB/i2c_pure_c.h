@@ -27,6 +27,8 @@ extern "C"
     int32_t i2c_read_data(I2CDeviceHandle handle, uint8_t page, uint8_t address, uint8_t *data, uint32_t length);
 
     int32_t i2c_write_to_device(I2CDeviceHandle handle, uint8_t* data, uint32_t length);
+    // Reads a message into out_data, with no heap allocation. Returns the bytes
+    // stored, at most max_length, or 0 if there was no message.
     int32_t i2c_read_from_device(I2CDeviceHandle handle, uint8_t* out_data, uint32_t max_length);
 
     typedef struct
@@ -38,6 +40,9 @@ extern "C"
     interrupt_register_t i2c_read_device_interrupt(I2CDeviceHandle handle);
     void i2c_write_device_interrupt(I2CDeviceHandle handle, uint8_t interrupt);
 
+    bool i2c_wait_for_data(I2CDeviceHandle handle, int32_t timeout_ms);
+    int i2c_get_interrupt_fd(I2CDeviceHandle handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,7 +8,7 @@
 #
 
 
-from ctypes import CDLL, POINTER, c_int32, c_uint32, c_uint8, c_void_p
+from ctypes import CDLL, POINTER, c_bool, c_int32, c_uint32, c_uint8, c_void_p
 import queue
 import threading
 
@@ -34,6 +34,9 @@ class I2CSerial():
 
         lib.i2c_read_from_device.argtypes = [I2CDeviceHandle, POINTER(c_uint8), c_uint32]
         lib.i2c_read_from_device.restype = c_int32
+
+        lib.i2c_wait_for_data.argtypes = [I2CDeviceHandle, c_int32]
+        lib.i2c_wait_for_data.restype = c_bool
         device = lib.i2c_device_create(1, 0x30)
         read_buffer = (c_uint8 * 1000)()
         read_len = 1000
@@ -43,8 +46,11 @@ class I2CSerial():
             if (kill_thread.is_set()):
                 return
             
-            #try to read data
-            data_read = lib.i2c_read_from_device(device, read_buffer,read_len)
+            #sleep until the device has data, waking up now and then to write and check for kill
+            data_read = 0
+            if write_queue.qsize() != 0 or lib.i2c_wait_for_data(device, 10):
+                #try to read data
+                data_read = lib.i2c_read_from_device(device, read_buffer,read_len)
 
             #try to write after we've finished reading so host and device aren't both writing at once
             if not write_queue.qsize() == 0:
@@ -0,0 +1,263 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Lattice Semiconductor Corp. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by LSCC and are protected
+// by copyright law. They may not be disclosed to third parties or copied
+// or duplicated in any form, in whole or in part, without the prior
+// written consent of LSCC.
+//
+//=============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+// what to do with a payload pushed while the queue is full
+enum class QueueFullPolicy
+{
+	DROP_OLDEST, // evict the oldest queued payload, the consumers always see the latest data
+	DROP_NEWEST  // discard the payload being pushed, the queued payloads are all kept
+};
+
+struct QueueCounters
+{
+	uint64_t pushed;
+	uint64_t popped;
+	uint64_t droppedOldest;
+	uint64_t droppedNewest;
+};
+
+// Lock-free bounded multi-producer multi-consumer queue (Vyukov's ring).
+// Each slot has a sequence number telling whether it holds data for the
+// current lap, so producers and consumers only contend on their own index.
+// Push never blocks: a full queue drops a payload as per the policy.
+template< typename T >
+class BoundedQueue
+{
+public:
+	// capacity is rounded up to a power of two
+	BoundedQueue( size_t capacity, QueueFullPolicy policy )
+		: m_policy{ policy }
+	{
+		auto size{ size_t{ 2 } };
+		while( size < capacity )
+		{
+			size <<= 1;
+		}
+		m_mask = size - 1;
+		m_slots = std::make_unique< Slot[] >( size );
+		for( auto n{ size_t{ 0 } }; n < size; ++n )
+		{
+			m_slots[n].sequence.store( n, std::memory_order_relaxed );
+		}
+	}
+
+	BoundedQueue( const BoundedQueue & ) = delete;
+	BoundedQueue &operator=( const BoundedQueue & ) = delete;
+
+	// returns false if the pushed payload was dropped
+	bool Push( const T &value )
+	{
+		while( !TryPush( value ) )
+		{
+			if( m_policy == QueueFullPolicy::DROP_NEWEST )
+			{
+				m_droppedNewest.fetch_add( 1, std::memory_order_relaxed );
+				return false;
+			}
+
+			//make room by evicting the oldest payload, then try again
+			T evicted;
+			if( TryPop( evicted, false ) )
+			{
+				m_droppedOldest.fetch_add( 1, std::memory_order_relaxed );
+			}
+		}
+
+		m_pushed.fetch_add( 1, std::memory_order_relaxed );
+		return true;
+	}
+
+	bool Pop( T &value )
+	{
+		return TryPop( value, true );
+	}
+
+	QueueCounters Counters() const
+	{
+		return { m_pushed.load( std::memory_order_relaxed ), m_popped.load( std::memory_order_relaxed ),
+				 m_droppedOldest.load( std::memory_order_relaxed ), m_droppedNewest.load( std::memory_order_relaxed ) };
+	}
+
+private:
+	struct alignas( 64 ) Slot
+	{
+		std::atomic< size_t > sequence;
+		T value;
+	};
+
+	bool TryPush( const T &value )
+	{
+		auto pos{ m_enqueuePos.load( std::memory_order_relaxed ) };
+		for( ;; )
+		{
+			auto &slot{ m_slots[pos & m_mask] };
+			auto seq{ slot.sequence.load( std::memory_order_acquire ) };
+			auto diff{ static_cast< intptr_t >( seq ) - static_cast< intptr_t >( pos ) };
+			if( diff == 0 )
+			{
+				if( m_enqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+				{
+					slot.value = value;
+					slot.sequence.store( pos + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if( diff < 0 )
+			{
+				return false; //full
+			}
+			else
+			{
+				pos = m_enqueuePos.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	bool TryPop( T &value, bool countPopped )
+	{
+		auto pos{ m_dequeuePos.load( std::memory_order_relaxed ) };
+		for( ;; )
+		{
+			auto &slot{ m_slots[pos & m_mask] };
+			auto seq{ slot.sequence.load( std::memory_order_acquire ) };
+			auto diff{ static_cast< intptr_t >( seq ) - static_cast< intptr_t >( pos + 1 ) };
+			if( diff == 0 )
+			{
+				if( m_dequeuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+				{
+					value = slot.value;
+					slot.sequence.store( pos + m_mask + 1, std::memory_order_release );
+					if( countPopped )
+					{
+						m_popped.fetch_add( 1, std::memory_order_relaxed );
+					}
+					return true;
+				}
+			}
+			else if( diff < 0 )
+			{
+				return false; //empty
+			}
+			else
+			{
+				pos = m_dequeuePos.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	QueueFullPolicy m_policy;
+	size_t m_mask{};
+	std::unique_ptr< Slot[] > m_slots;
+
+	alignas( 64 ) std::atomic< size_t > m_enqueuePos{ 0 };
+	alignas( 64 ) std::atomic< size_t > m_dequeuePos{ 0 };
+
+	std::atomic< uint64_t > m_pushed{ 0 };
+	std::atomic< uint64_t > m_popped{ 0 };
+	std::atomic< uint64_t > m_droppedOldest{ 0 };
+	std::atomic< uint64_t > m_droppedNewest{ 0 };
+};
+
+// Hands payloads from an SDK callback to worker threads through a
+// BoundedQueue, so the callback returns right away whatever the workers do.
+// Post() is cheap enough to call from the callback: one slot copy and a
+// semaphore release, no allocation and no lock.
+template< typename T >
+class CallbackWorkQueue
+{
+public:
+	using Handler = std::function< void( const T & ) >;
+
+	CallbackWorkQueue( size_t capacity, QueueFullPolicy policy, unsigned numberOfWorkers, Handler handler )
+		: m_queue{ capacity, policy }
+		, m_handler{ std::move( handler ) }
+	{
+		for( auto n{ 0u }; n < numberOfWorkers; ++n )
+		{
+			m_workers.emplace_back( [this] { WorkerLoop(); } );
+		}
+	}
+
+	~CallbackWorkQueue()
+	{
+		Stop();
+	}
+
+	CallbackWorkQueue( const CallbackWorkQueue & ) = delete;
+	CallbackWorkQueue &operator=( const CallbackWorkQueue & ) = delete;
+
+	// returns false if the payload was dropped
+	bool Post( const T &value )
+	{
+		if( !m_queue.Push( value ) )
+		{
+			return false;
+		}
+		m_available.release();
+		return true;
+	}
+
+	// lets the workers finish the queued payloads, then joins them
+	void Stop()
+	{
+		if( m_stop.exchange( true ) )
+		{
+			return;
+		}
+		m_available.release( static_cast< std::ptrdiff_t >( m_workers.size() ) );
+		for( auto &worker : m_workers )
+		{
+			worker.join();
+		}
+	}
+
+	QueueCounters Counters() const
+	{
+		return m_queue.Counters();
+	}
+
+private:
+	void WorkerLoop()
+	{
+		T value;
+		for( ;; )
+		{
+			m_available.acquire();
+			//a release may find its payload evicted already, or be a stop wakeup
+			while( m_queue.Pop( value ) )
+			{
+				m_handler( value );
+			}
+			if( m_stop.load( std::memory_order_acquire ) )
+			{
+				return;
+			}
+		}
+	}
+
+	BoundedQueue< T > m_queue;
+	Handler m_handler;
+	std::counting_semaphore<> m_available{ 0 };
+	std::atomic< bool > m_stop{ false };
+	std::vector< std::thread > m_workers;
+};
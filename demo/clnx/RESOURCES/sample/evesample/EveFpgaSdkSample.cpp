@@ -17,6 +17,8 @@
 #include "EveFpga.h"
 #include "EveImage.h"
 
+#include "CallbackWorkQueue.h"
+
 #if defined(WIN32)
 #include <combaseapi.h>
 #include <mfapi.h>
@@ -29,7 +31,31 @@ static EveProcessingCallbackReturnData eveCallbackReturnData{};
 
 static auto counter{ 0 };
 
+//a copy of the FPGA data of one frame, handed from the EVE callback to the workers
+struct FramePayload
+{
+	int frameNumber;
+	CFpgaData data;
+};
+
+//frames queued for the workers, a slow worker drops the oldest frames instead of stalling EVE
+constexpr size_t FRAME_QUEUE_CAPACITY{ 8 };
+constexpr unsigned NUMBER_OF_WORKERS{ 2 };
+
+//this is where the real work on a frame goes, it runs on a worker thread
+static void ConsumeFrame( const FramePayload &payload )
+{
+	std::ostringstream message;
+	message << "Frame " << payload.frameNumber << ", number of users: "
+			<< payload.data.pipelineData.dataContent.numberOfUsers << "\n";
+	std::cout << message.str();
+}
+
+static CallbackWorkQueue< FramePayload > frameQueue{ FRAME_QUEUE_CAPACITY, QueueFullPolicy::DROP_OLDEST,
+													 NUMBER_OF_WORKERS, ConsumeFrame };
+
 // this is the data callback that will be called by EVE after a frame is processed
+// it only copies the data out and returns, EVE does not wait for the processing
 static void ProcessData( EveProcessingCallbackReturnData *returnData )
 {
 	std::lock_guard<std::mutex> lock{ callbackMutex };
@@ -44,7 +70,7 @@ static void ProcessData( EveProcessingCallbackReturnData *returnData )
 	auto fpgaData{ EveGetFpgaData() };
 	if( fpgaData.data )
 	{
-		std::cout << "Number of users: " << fpgaData.data->pipelineData.dataContent.numberOfUsers << "\n";
+		frameQueue.Post( FramePayload{ counter, *fpgaData.data } );
 	}
 
 	*returnData = eveCallbackReturnData;
@@ -153,6 +179,12 @@ static int Run()
 
 	ShutdownEve();
 
+	//let the workers finish the frames still queued
+	frameQueue.Stop();
+	auto counters{ frameQueue.Counters() };
+	std::cout << "Frames queued: " << counters.pushed << ", processed: " << counters.popped
+			  << ", dropped oldest: " << counters.droppedOldest << ", dropped newest: " << counters.droppedNewest << "\n";
+
 	return 0;
 }
 
@@ -62,36 +62,58 @@ euler_angles_t RotationMatrixToEulerAngles( const fp_mat_t *rotationMatrix )
     return result;
 }
 
+//-----------------------------------------------------------------------------
+// Product of two fixed point numbers of fracBits fractional bits, as FPMul().
+// Sines and cosines are at most 1 << fracBits, their products fit 32 bits.
+static inline int32_t MulTrig( int32_t a, int32_t b, uint8_t fracBits )
+{
+    return ( a * b ) >> fracBits;
+}
+
 //-----------------------------------------------------------------------------
 // See https://en.wikipedia.org/wiki/Rotation_matrix for explanations (section
 // General 3D rotations). Pitch, roll and yaw are respectively rotations around
 // axis x, z and y. Order of rotation is roll, then pitch, then yaw.
+// The sines and cosines share their fracBits, the products are done on their
+// raw values; the results are the ones of FPMul().
 void EulerAnglesToRotationMatrix( const euler_angles_t *euler, fp_mat_t *rotMat )
 {
-    fp_t cos1 = FPCos( euler->yaw );
-    fp_t cos2 = FPCos( euler->pitch );
-    fp_t cos3 = FPCos( euler->roll );
-    fp_t sin1 = FPSin( euler->yaw );
-    fp_t sin2 = FPSin( euler->pitch );
-    fp_t sin3 = FPSin( euler->roll );
+    fp_t fpSin1, fpSin2, fpSin3;
+    fp_t fpCos1, fpCos2, fpCos3;
+
+    FPSinCos( euler->yaw, &fpSin1, &fpCos1 );
+    FPSinCos( euler->pitch, &fpSin2, &fpCos2 );
+    FPSinCos( euler->roll, &fpSin3, &fpCos3 );
+
+    uint8_t f = fpCos1.fracBits;
+
+    assert( f <= 15, EC_FP_CANNOT_REPRESENT_NUMBER,
+        "EulerAnglesToRotationMatrix: %d fractional bits overflow\r\n", f );
+
+    int32_t cos1 = fpCos1.n, cos2 = fpCos2.n, cos3 = fpCos3.n;
+    int32_t sin1 = fpSin1.n, sin2 = fpSin2.n, sin3 = fpSin3.n;
 
-    fp_t m11 = FPAdd( FPMul( cos1, cos3 ), FPMul( FPMul( sin1, sin2 ), sin3 ) );
-    fp_t m12 = FPSub( FPMul( FPMul( cos3, sin1 ), sin2 ), FPMul( cos1, sin3 ) );
-    fp_t m13 = FPMul( cos2, sin1 );
-    fp_t m21 = FPMul( cos2, sin3 );
-    fp_t m22 = FPMul( cos2, cos3 );
-    fp_t m23 = FPMinus( sin2 );
-    fp_t m31 = FPSub( FPMul( FPMul( cos1, sin2 ), sin3 ), FPMul( cos3, sin1 ) );
-    fp_t m32 = FPAdd( FPMul( FPMul( cos1, cos3 ), sin2 ), FPMul( sin1, sin3 ) );
-    fp_t m33 = FPMul( cos1, cos2 );
+    int32_t m11 = MulTrig( cos1, cos3, f ) +
+        MulTrig( MulTrig( sin1, sin2, f ), sin3, f );
+    int32_t m12 = MulTrig( MulTrig( cos3, sin1, f ), sin2, f ) -
+        MulTrig( cos1, sin3, f );
+    int32_t m13 = MulTrig( cos2, sin1, f );
+    int32_t m21 = MulTrig( cos2, sin3, f );
+    int32_t m22 = MulTrig( cos2, cos3, f );
+    int32_t m23 = -sin2;
+    int32_t m31 = MulTrig( MulTrig( cos1, sin2, f ), sin3, f ) -
+        MulTrig( cos3, sin1, f );
+    int32_t m32 = MulTrig( MulTrig( cos1, cos3, f ), sin2, f ) +
+        MulTrig( sin1, sin3, f );
+    int32_t m33 = MulTrig( cos1, cos2, f );
 
-    MatSet( *rotMat, 0, 0, m11 );
-    MatSet( *rotMat, 0, 1, m12 );
-    MatSet( *rotMat, 0, 2, m13 );
-    MatSet( *rotMat, 1, 0, m21 );
-    MatSet( *rotMat, 1, 1, m22 );
-    MatSet( *rotMat, 1, 2, m23 );
-    MatSet( *rotMat, 2, 0, m31 );
-    MatSet( *rotMat, 2, 1, m32 );
-    MatSet( *rotMat, 2, 2, m33 );
+    MatSet( *rotMat, 0, 0, InterpretIntAsFP( m11, f ) );
+    MatSet( *rotMat, 0, 1, InterpretIntAsFP( m12, f ) );
+    MatSet( *rotMat, 0, 2, InterpretIntAsFP( m13, f ) );
+    MatSet( *rotMat, 1, 0, InterpretIntAsFP( m21, f ) );
+    MatSet( *rotMat, 1, 1, InterpretIntAsFP( m22, f ) );
+    MatSet( *rotMat, 1, 2, InterpretIntAsFP( m23, f ) );
+    MatSet( *rotMat, 2, 0, InterpretIntAsFP( m31, f ) );
+    MatSet( *rotMat, 2, 1, InterpretIntAsFP( m32, f ) );
+    MatSet( *rotMat, 2, 2, InterpretIntAsFP( m33, f ) );
 }
@@ -38,6 +38,6 @@ void assert_dbg( bool condition, int err, const char *format, ... )
 {
 	va_list args;
 	va_start(args, format);
-	GARD__DBG_ASSERT( condition, err, format, args );
+	GARD__ASSERT( condition, err, format, args );
 	va_end(args);
 }
\ No newline at end of file
@@ -20,18 +20,48 @@
 #include "errors.h"
 
 //=============================================================================
-// M A C R O S
+// C O N S T A N T S
+
+// Assertion levels, APP_ASSERT_LEVEL enables the checks of its level and below:
+// - release: assert_rel() only, the checks guarding against corrupting memory
+// - debug: assert(), the checks of the cold paths, e.g. initialization and
+//   configuration
+// - paranoid: assert_paranoid(), the checks of the hot paths, run for every
+//   box, element or operation of a frame
+#define APP_ASSERT_LEVEL_RELEASE  0
+#define APP_ASSERT_LEVEL_DEBUG    1
+#define APP_ASSERT_LEVEL_PARANOID 2
 
+// Set by the Makefile ASSERTS option, every check by default in DEBUG
+#ifndef APP_ASSERT_LEVEL
 #ifdef DEBUG
+#define APP_ASSERT_LEVEL APP_ASSERT_LEVEL_PARANOID
+#else
+#define APP_ASSERT_LEVEL APP_ASSERT_LEVEL_RELEASE
+#endif
+#endif
+
+//=============================================================================
+// M A C R O S
+
+#if APP_ASSERT_LEVEL >= APP_ASSERT_LEVEL_DEBUG
 #define assert(condition, err, format, ...) assert_dbg(condition, err, format, ## __VA_ARGS__ )
 #else
 #define assert(...)
 #endif
 
+#if APP_ASSERT_LEVEL >= APP_ASSERT_LEVEL_PARANOID
+#define assert_paranoid(condition, err, format, ...) assert_dbg(condition, err, format, ## __VA_ARGS__ )
+#else
+#define assert_paranoid(...)
+#endif
+
 //=============================================================================
 // F U N C T I O N S   D E C L A R A T I O N S
 
 // Check condition is true and exits the program otherwise. 
+// Only called by the assert() and assert_paranoid() macros, which compile out
+// below their level.
 // Before exiting, the function will display a message the same way as printf,
 // meaning format and subsequent arguments can be used the same way printf would
 // be. On exit, the provided error code will be sent out.
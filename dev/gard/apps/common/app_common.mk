@@ -0,0 +1,63 @@
+#=============================================================================
+#
+# Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+#
+# These coded instructions, statements, and computer programs contain
+# unpublished proprietary information written by MMX and
+# are protected by copyright law. They may not be disclosed
+# to third parties or copied or duplicated in any form, in whole or
+# in part, without the prior written consent of MMX.
+#
+#=============================================================================
+
+# Common app module library: the post-processing, fixed point, box, matrix,
+# etc. code shared by all the app modules, built once per app configuration
+# as a static library the app module links with.
+#
+# Include it from an app module Makefile, after the GARD FW Makefiles, with
+# APP_COMMON_DIR set to this folder, then:
+# * add $(APP_COMMON_LIB) to the link prerequisites and command, after OBJS
+# * add $(APP_COMMON_OBJ_DIRS) to the created directories
+# The library objects are built with the app CFLAGS, so with its defines, and
+# $(APP_COMMON_CFLAGS).
+
+# Bump on changes of the library interface used by the app modules
+APP_COMMON_VERSION := 1.0
+
+# Optimisation profile of the library in release, whatever the app module
+# uses, e.g. `make build_app_module APP_COMMON_PROFILE=speed`:
+# - size: -Os, the default, as the app module
+# - speed: -O2, for the post-processing hot paths, if the binary still fits
+# In debug, the library is built as the app module, to be debuggable.
+APP_COMMON_PROFILE ?= size
+ifeq ($(DEBUG),false)
+    ifeq ($(APP_COMMON_PROFILE),speed)
+        APP_COMMON_CFLAGS := -O2 -flto
+    else
+        APP_COMMON_CFLAGS := -Os -flto
+    endif
+else
+    APP_COMMON_CFLAGS :=
+endif
+
+# The LTO plugin aware archiver, so the app link still optimises across the
+# library and the app module
+APP_COMMON_AR := $(CC)-ar
+
+APP_COMMON_SRCS := $(shell $(FIND_CMD) $(APP_COMMON_DIR)/ -type f -name '*.c') $(shell $(FIND_CMD) $(APP_COMMON_DIR)/ -type f -name '*.S')
+APP_COMMON_INCLUDES := $(shell $(FIND_CMD) $(APP_COMMON_DIR)/ -type d)
+
+APP_COMMON_OUTPUT_DIR := $(TGT_OUTPUT_DIR)/app_common
+APP_COMMON_OBJS := $(patsubst $(APP_COMMON_DIR)/%,$(APP_COMMON_OUTPUT_DIR)/%.o,$(basename $(APP_COMMON_SRCS)))
+APP_COMMON_OBJ_DIRS := $(sort $(dir $(APP_COMMON_OBJS)))
+APP_COMMON_LIB := $(APP_COMMON_OUTPUT_DIR)/libapp_common-$(APP_COMMON_VERSION).a
+
+$(APP_COMMON_OUTPUT_DIR)/%.o: $(APP_COMMON_DIR)/%.c $(MKFILE)
+	$(CC) $(CFLAGS) $(APP_COMMON_CFLAGS) -c $< -o $@
+
+$(APP_COMMON_OUTPUT_DIR)/%.o: $(APP_COMMON_DIR)/%.S $(MKFILE)
+	$(CC) $(CFLAGS) $(APP_COMMON_CFLAGS) -c $< -o $@
+
+$(APP_COMMON_LIB): $(APP_COMMON_OBJS)
+	@rm -f $@
+	$(APP_COMMON_AR) rcs $@ $^
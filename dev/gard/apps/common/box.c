@@ -18,6 +18,7 @@
 #include "box.h"
 #include "debug.h"
 #include "quick_select.h"
+#include "scratch_arena.h"
 
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
@@ -241,7 +242,7 @@ fp_t ComputeGeometricArea( geometric_box_t box )
 //
 fp_t ComputeGeometricIoU( geometric_box_t box1, geometric_box_t box2 )
 {
-	assert(
+	assert_paranoid(
 		box1.left.fracBits == box2.left.fracBits, EC_FP_NOT_EQUIVALENT,
 		"Boxes don't use the same number of fractional bits: %d %d\r\n",
 		box1.left.fracBits, box2.left.fracBits );
@@ -264,6 +265,108 @@ fp_t ComputeGeometricIoU( geometric_box_t box1, geometric_box_t box2 )
 	return iou;
 }
 
+//----------------------------------------------------------------------------
+//
+q10_box_t GeometricBoxToQ10( const geometric_box_t *box )
+{
+	q10_box_t res = {
+		.left = FPToQ10( box->left ),
+		.top = FPToQ10( box->top ),
+		.right = FPToQ10( box->right ),
+		.bottom = FPToQ10( box->bottom ) };
+	return res;
+}
+
+//----------------------------------------------------------------------------
+//
+int64_t ComputeQ10Area( const q10_box_t *box )
+{
+	// Areas are Q42.20, they overflow 32 bits for boxes above about
+	// 45 x 45 pixels.
+	return ( int64_t )( box->right - box->left ) * ( box->bottom - box->top );
+}
+
+//----------------------------------------------------------------------------
+//
+int64_t ComputeQ10IntersectionArea(
+	const q10_box_t *box1,
+	const q10_box_t *box2 )
+{
+	q21_10_t top = box1->top < box2->top ? box2->top : box1->top;
+	q21_10_t left = box1->left < box2->left ? box2->left : box1->left;
+	q21_10_t bottom = box1->bottom < box2->bottom ? box1->bottom : box2->bottom;
+	q21_10_t right = box1->right < box2->right ? box1->right : box2->right;
+	q21_10_t width = right > left ? right - left : 0;
+	q21_10_t height = bottom > top ? bottom - top : 0;
+	return ( int64_t ) width * height;
+}
+
+//----------------------------------------------------------------------------
+//
+q21_10_t ComputeQ10IoU( const q10_box_t *box1, const q10_box_t *box2 )
+{
+	int64_t interArea = ComputeQ10IntersectionArea( box1, box2 );
+	int64_t unionArea =
+		ComputeQ10Area( box1 ) + ComputeQ10Area( box2 ) - interArea;
+
+	if( unionArea <= 0 )
+	{
+		return 0;
+	}
+	return ( q21_10_t )( ( interArea << Q10_FRAC_BITS ) / unionArea );
+}
+
+//----------------------------------------------------------------------------
+//
+bool Q10IoUExceeds(
+	const q10_box_t *box1,
+	const q10_box_t *box2,
+	q21_10_t threshold )
+{
+	int64_t interArea = ComputeQ10IntersectionArea( box1, box2 );
+	if( interArea == 0 )
+	{
+		return false;
+	}
+
+	// ComputeQ10IoU() > t is ( intersection << 10 ) / union >= t + 1, that is
+	// ( intersection << 10 ) >= ( t + 1 ) * union, union being positive for
+	// boxes that intersect. The areas are Q42.20 and t + 1 is at most 2^11
+	// for t <= 1, so the products fit 64 bits for boxes up to 2^30 square
+	// pixels.
+	int64_t unionArea =
+		ComputeQ10Area( box1 ) + ComputeQ10Area( box2 ) - interArea;
+	return ( interArea << Q10_FRAC_BITS ) >=
+		( int64_t )( threshold + 1 ) * unionArea;
+}
+
+//----------------------------------------------------------------------------
+//
+bool GeometricBoxesOverlap(
+	const geometric_box_t *box1,
+	const geometric_box_t *box2 )
+{
+	return FPLt( box1->left, box2->right ) && FPLt( box2->left, box1->right ) &&
+		FPLt( box1->top, box2->bottom ) && FPLt( box2->top, box1->bottom );
+}
+
+//----------------------------------------------------------------------------
+//
+bool IoUExceeds(
+	const geometric_box_t *box1,
+	const geometric_box_t *box2,
+	fp_t threshold )
+{
+	if( !GeometricBoxesOverlap( box1, box2 ) )
+	{
+		return false;
+	}
+
+	q10_box_t q10Box1 = GeometricBoxToQ10( box1 );
+	q10_box_t q10Box2 = GeometricBoxToQ10( box2 );
+	return Q10IoUExceeds( &q10Box1, &q10Box2, FPToQ10( threshold ) );
+}
+
 //----------------------------------------------------------------------------
 //
 geometric_box_t CropGeometricBox(
@@ -475,26 +578,29 @@ size_t MatchGeometricBox(
         return 0;
     }
     
-    size_t bestCandidate = 0;
-    fp_t bestIoU = ComputeGeometricIoU( *toMatch, candidates[0] );
-    for( size_t i = 1; i < candidatesNb; ++i )
+    // The candidates are ranked by their Q10 IoU, the threshold included, so
+    // only a candidate that beats the best one so far has its IoU divided out.
+    q10_box_t q10ToMatch = GeometricBoxToQ10( toMatch );
+    size_t bestCandidate = candidatesNb;
+    q21_10_t bestIoU = FPToQ10( iouThreshold );
+    for( size_t i = 0; i < candidatesNb; ++i )
     {
-        fp_t currentIoU = ComputeGeometricIoU( *toMatch, candidates[i] );
-        if( FPGe( currentIoU, bestIoU ) )
+        if( !GeometricBoxesOverlap( toMatch, &candidates[i] ) )
         {
-            bestIoU = currentIoU;
+            continue;
+        }
+        q10_box_t q10Candidate = GeometricBoxToQ10( &candidates[i] );
+
+        // The last of the candidates with the best IoU wins
+        q21_10_t iouToBeat = bestCandidate == candidatesNb ? bestIoU : bestIoU - 1;
+        if( Q10IoUExceeds( &q10ToMatch, &q10Candidate, iouToBeat ) )
+        {
+            bestIoU = ComputeQ10IoU( &q10ToMatch, &q10Candidate );
             bestCandidate = i;
         }
     }
-    
-    if( FPGt( bestIoU, iouThreshold ) )
-    {
-        return bestCandidate;
-    }
-    else
-    {
-        return candidatesNb;
-    }
+
+    return bestCandidate;
 }
 
 //-----------------------------------------------------------------------------
@@ -644,13 +750,16 @@ void Match(const geometric_box_t *list1,
 
 {
 
+    // The pairs grow with sizeList1 * sizeList2, they are in the scratch arena
+    // rather than on the stack. See object_tracker.h to match in crowded scenes.
+    scratch_mark_t mark = ScratchMark();
     int32_t numberOfMatches = sizeList1 * sizeList2;
-    box_pair_t matches[numberOfMatches];
-    int16_t matchValues[numberOfMatches];
-    size_t indices[numberOfMatches];
+    box_pair_t *matches = ScratchAllocArray( box_pair_t, numberOfMatches );
+    int16_t *matchValues = ScratchAllocArray( int16_t, numberOfMatches );
+    size_t *indices = ScratchAllocArray( size_t, numberOfMatches );
 
-    bool usedBoxA[sizeList1];
-    bool usedBoxB[sizeList2];
+    bool *usedBoxA = ScratchAllocArray( bool, sizeList1 );
+    bool *usedBoxB = ScratchAllocArray( bool, sizeList2 );
 
     // Make sure assignment[0] is -1, if sizeList1 is 0 then none of the initialization happens
     assignment[0] = -1;
@@ -696,4 +805,6 @@ void Match(const geometric_box_t *list1,
             usedBoxB[matches[indices[i]].boxB] = true;
         }
     }
+
+    ScratchRelease( mark );
 }
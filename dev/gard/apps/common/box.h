@@ -71,6 +71,17 @@ typedef struct
 	fp_t bottom;
 } geometric_box_t;
 
+// Geometric box with Q21.10 coordinates, a quarter of the size of a
+// geometric_box_t, for the hot loops of the post-processing.
+// The box is assumed to be valid : left < right and top < bottom.
+typedef struct
+{
+	q21_10_t left;
+	q21_10_t top;
+	q21_10_t right;
+	q21_10_t bottom;
+} q10_box_t;
+
 // Meant to represent boxes in pixel world.
 // The box is assumed to be valid : left < right and top < bottom.
 // Avoid direct manipulation and prefer using function to ensure integrity.
@@ -282,6 +293,52 @@ fp_t ComputeGeometricIoURef(
 	geometric_box_t *box1,
 	geometric_box_t *box2 );
 
+// Returns the box with Q21.10 coordinates.
+// This can lead to loss of precision if box uses more than 10 fractional bits.
+q10_box_t GeometricBoxToQ10(
+	const geometric_box_t *box ); // Box to convert
+
+// Computes the area of a box with Q21.10 coordinates, as a Q42.20 number.
+int64_t ComputeQ10Area(
+	const q10_box_t *box );
+
+// Computes the area of the intersection of two boxes with Q21.10 coordinates,
+// as a Q42.20 number, 0 if they do not intersect.
+int64_t ComputeQ10IntersectionArea(
+	const q10_box_t *box1,
+	const q10_box_t *box2 );
+
+// Computes intersection over union of two boxes with Q21.10 coordinates.
+// The result is a Q21.10 number, 0 if both boxes are empty.
+q21_10_t ComputeQ10IoU(
+	const q10_box_t *box1,
+	const q10_box_t *box2 );
+
+// Tells if ComputeQ10IoU( box1, box2 ) > threshold, without a division,
+// testing ( intersection << 10 ) >= ( threshold + 1 ) * union. Boxes that do
+// not intersect return false at once.
+// threshold is a Q21.10 number expected in [0, 1].
+bool Q10IoUExceeds(
+	const q10_box_t *box1, // First box
+	const q10_box_t *box2, // Second box
+	q21_10_t threshold );  // IoU value to exceed
+
+// Tells if two boxes with the same number of fractional bits have an
+// intersection of non-zero area. This is cheaper than converting them to
+// Q21.10 first.
+bool GeometricBoxesOverlap(
+	const geometric_box_t *box1,  // First box
+	const geometric_box_t *box2 ); // Second box
+
+// Tells if the intersection over union of two boxes is greater than threshold,
+// as Q10IoUExceeds() on the boxes and the threshold in Q21.10. Boxes that do
+// not overlap return false before the conversion.
+// threshold is expected in [0, 1].
+bool IoUExceeds(
+	const geometric_box_t *box1, // First box
+	const geometric_box_t *box2, // Second box
+	fp_t threshold );            // IoU value to exceed
+
 // Crops the box coordinates so that they fit in the container.
 // It is assumed that box and container use the same number of fraction bits.
 // Fixed point representation of the resulting box uses the same number of
@@ -326,9 +383,11 @@ bool PointInsideBox(geometric_point_2d_t point, geometric_box_t box);
 
 //----------------------------------------------------------------------------
 // In geometric boxes list candidates, find the box such that:
-// - IoU( toMatch, box ) >= iouThreshold
+// - IoU( toMatch, box ) > iouThreshold
 // - for all other boxes in candidates,
 //     IoU( toMatch, box ) >= IoU (toMatch, otherBox )
+// The IoUs are the ones of ComputeQ10IoU(), the last of the boxes with the
+// best one is returned.
 // This function returns the index of the matched box in the candidates array.
 // If no match was found (because the len(array) == 0 or because the IoU
 // threshold was not met for any candidate, the function returns candidatesNb.
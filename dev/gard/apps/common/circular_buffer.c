@@ -0,0 +1,178 @@
+//=============================================================================fC
+//
+// Copyright(c) 2022 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "circular_buffer.h"
+#include "app_assert.h"
+
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+int PushToBuffer( circ_bbuf_t *buffer, int32_t data )
+{
+    // Full
+    if( buffer->count == buffer->maxlen ) 
+    {
+        return -1;
+    }
+
+    buffer->buffer[buffer->head] = data;
+    buffer->head = buffer->head + 1 == buffer->maxlen ? 0 : buffer->head + 1;
+    ++buffer->count;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool PopFromBuffer( circ_bbuf_t *buffer, int32_t *data )
+{
+    // Empty
+    if( buffer->count == 0 )
+    {
+        return false;
+    }
+
+    *data = buffer->buffer[buffer->tail];
+    buffer->tail = buffer->tail + 1 == buffer->maxlen ? 0 : buffer->tail + 1;
+    --buffer->count;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+void ResetBuffer( circ_bbuf_t *c )
+{
+	c->head = 0;
+	c->tail = 0;
+    c->count = 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+uint8_t GetBufferSize( const circ_bbuf_t *c ) 
+{
+    return c->count;
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t GetBufferValueAt( const circ_bbuf_t *buffer, uint8_t index ) 
+{
+    assert( index < buffer->count, EC_OUT_OF_BOUNDS, "Circular buffer index is out of bounds. Index: %u. Actual size: %u", index, buffer->count );
+    // tail and index are both below maxlen, one wrap at most
+    uint32_t actualIndex = ( uint32_t )buffer->tail + index;
+    actualIndex -= actualIndex >= buffer->maxlen ? buffer->maxlen : 0;
+    return buffer->buffer[actualIndex];
+}
+
+//-----------------------------------------------------------------------------
+//
+int PushToPow2Buffer( circ_pow2_buf_t *c, int32_t data )
+{
+    // Full
+    if( c->count == ( 1u << c->sizeLog2 ) )
+    {
+        return -1;
+    }
+
+    c->buffer[c->head] = data;
+    c->head = ( uint8_t )( ( c->head + 1 ) & ( ( 1u << c->sizeLog2 ) - 1 ) );
+    ++c->count;
+    c->sum += data;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool PushOverwritePow2Buffer( circ_pow2_buf_t *c, int32_t data )
+{
+    bool full = c->count == ( 1u << c->sizeLog2 );
+
+    // Once full, the head is on the oldest value
+    if( full )
+    {
+        c->sum -= c->buffer[c->head];
+    }
+    else
+    {
+        ++c->count;
+    }
+
+    c->buffer[c->head] = data;
+    c->head = ( uint8_t )( ( c->head + 1 ) & ( ( 1u << c->sizeLog2 ) - 1 ) );
+    c->sum += data;
+    return full;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool PopFromPow2Buffer( circ_pow2_buf_t *c, int32_t *data )
+{
+    // Empty
+    if( c->count == 0 )
+    {
+        return false;
+    }
+
+    *data = GetPow2BufferValueAt( c, 0 );
+    --c->count;
+    c->sum -= *data;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+void ResetPow2Buffer( circ_pow2_buf_t *c )
+{
+    c->head = 0;
+    c->count = 0;
+    c->sum = 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t GetPow2BufferMean( const circ_pow2_buf_t *c )
+{
+    if( c->count == ( 1u << c->sizeLog2 ) )
+    {
+        return ( int32_t )( c->sum >> c->sizeLog2 );
+    }
+
+    if( c->count == 0 )
+    {
+        return 0;
+    }
+
+    // Filling up, the division rounds towards 0 and the mean down
+    int64_t mean = c->sum / c->count;
+    mean -= ( c->sum < 0 && mean * c->count != c->sum ) ? 1 : 0;
+    return ( int32_t )mean;
+}
+
+//-----------------------------------------------------------------------------
+//
+void GetPow2BufferSpans( const circ_pow2_buf_t *c, circ_spans_t *spans )
+{
+    uint32_t size = 1u << c->sizeLog2;
+    uint32_t tail = ( uint32_t )( c->head - c->count ) & ( size - 1 );
+    uint32_t firstNb = size - tail < c->count ? size - tail : c->count;
+
+    spans->first = &c->buffer[tail];
+    spans->firstNb = ( uint8_t )firstNb;
+    spans->second = c->buffer;
+    spans->secondNb = ( uint8_t )( c->count - firstNb );
+}
@@ -0,0 +1,156 @@
+//=============================================================================
+//
+// Copyright(c) 2022 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef CIRCULAR_BUFFER_H
+#define CIRCULAR_BUFFER_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stdint.h>
+#include "types.h" // instead of std bool
+
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+typedef struct
+{
+	int32_t *const buffer;
+	uint8_t head;
+	uint8_t tail;
+    uint8_t count;
+	const uint8_t maxlen;
+} circ_bbuf_t;
+
+
+// Circular buffer of a power of two capacity, indexed with a mask instead of
+// a division. It also keeps the sum of its values, for an O(1) mean.
+typedef struct
+{
+    int32_t *const buffer;
+    uint8_t head;           // Position of the next value
+    uint8_t count;
+    const uint8_t sizeLog2; // The capacity is 1 << sizeLog2, at most 128
+    int64_t sum;            // Sum of the values held
+} circ_pow2_buf_t;
+
+// The values of a circular buffer, oldest first, as two contiguous spans so
+// that they can be reduced without indexing each one. second is used once
+// the values wrap around the end of the storage.
+typedef struct
+{
+    const int32_t *first;
+    uint8_t firstNb;
+    const int32_t *second;
+    uint8_t secondNb;
+} circ_spans_t;
+
+
+//=============================================================================
+// M A C R O S
+
+#define CreateCircularBuffer( name, size )\
+    int32_t name##_data_space[size];      \
+    circ_bbuf_t name = {                  \
+        .buffer = name##_data_space,      \
+        .head = 0,                        \
+        .tail = 0,                        \
+        .count = 0,                       \
+        .maxlen = size                    \
+    }
+
+#define CreateStaticCircularBuffer( name, size )    \
+    static int32_t name##_data_space[size];         \
+    static circ_bbuf_t name = {                     \
+        .buffer = name##_data_space,                \
+        .head = 0,                                  \
+        .tail = 0,                                  \
+        .count = 0,                                 \
+        .maxlen = size                              \
+    }
+
+// Capacities above 128 do not fit the uint8_t count, a negative array size
+// stops them at compile time.
+#define CreatePow2CircularBuffer( name, log2Size )                       \
+    typedef char name##_size_check[( log2Size ) <= 7 ? 1 : -1];          \
+    int32_t name##_data_space[1 << ( log2Size )];                        \
+    circ_pow2_buf_t name = {                                             \
+        .buffer = name##_data_space,                                     \
+        .head = 0,                                                       \
+        .count = 0,                                                      \
+        .sizeLog2 = ( log2Size ),                                        \
+        .sum = 0                                                         \
+    }
+
+#define CreateStaticPow2CircularBuffer( name, log2Size )                 \
+    typedef char name##_size_check[( log2Size ) <= 7 ? 1 : -1];          \
+    static int32_t name##_data_space[1 << ( log2Size )];                 \
+    static circ_pow2_buf_t name = {                                      \
+        .buffer = name##_data_space,                                     \
+        .head = 0,                                                       \
+        .count = 0,                                                      \
+        .sizeLog2 = ( log2Size ),                                        \
+        .sum = 0                                                         \
+    }
+
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+int PushToBuffer( circ_bbuf_t *buffer, int32_t data );
+
+bool PopFromBuffer( circ_bbuf_t *buffer, int32_t *data );
+
+void ResetBuffer( circ_bbuf_t *c );
+
+uint8_t GetBufferSize( const circ_bbuf_t *c );
+
+int32_t GetBufferValueAt( const circ_bbuf_t *buffer, uint8_t index );
+
+// Returns -1 if the buffer is full, 0 otherwise.
+int PushToPow2Buffer( circ_pow2_buf_t *c, int32_t data );
+
+// Pushes data, dropping the oldest value if the buffer is full. Returns true
+// if a value was dropped.
+bool PushOverwritePow2Buffer( circ_pow2_buf_t *c, int32_t data );
+
+bool PopFromPow2Buffer( circ_pow2_buf_t *c, int32_t *data );
+
+void ResetPow2Buffer( circ_pow2_buf_t *c );
+
+// Mean of the values held, rounded down, 0 if there are none. A shift once the
+// buffer is full.
+int32_t GetPow2BufferMean( const circ_pow2_buf_t *c );
+
+void GetPow2BufferSpans( const circ_pow2_buf_t *c, circ_spans_t *spans );
+
+static inline uint8_t GetPow2BufferSize( const circ_pow2_buf_t *c )
+{
+    return c->count;
+}
+
+static inline int64_t GetPow2BufferSum( const circ_pow2_buf_t *c )
+{
+    return c->sum;
+}
+
+// index 0 is the oldest value. It is not checked against the count, for
+// loops over the values; it cannot reach out of the storage.
+static inline int32_t GetPow2BufferValueAt(
+    const circ_pow2_buf_t *c, uint8_t index )
+{
+    uint8_t mask = ( uint8_t )( ( 1u << c->sizeLog2 ) - 1 );
+    return c->buffer[( c->head - c->count + index ) & mask];
+}
+
+#endif
@@ -0,0 +1,300 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+
+#include "box.h"
+#include "defect_detection_module.h"
+#include "int16_kernels.h"
+#include "assert.h"
+
+
+const int32_dim_t DEFECT_DETECTION_NETWORK_INPUT_DIM =
+    CreateLiteralInt32Dim(288, 384);
+
+const fp_t DEFECT_DETECTION_SCORE_THRESHOLD = FloatToFP(0.14, FRAC_BITS); // Range [0, 2]: 0 >> no defect, 2 >> defect
+
+
+// Default smoothing of the distances, mean of the last 8 frames
+#define DEFECT_DETECTION_SCORE_FILTER_MODE          SCORE_FILTER_MEAN
+#define DEFECT_DETECTION_SCORE_FILTER_WINDOW_LOG2   3
+
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+defect_detection_t InitDefectDetection( void )
+{
+    defect_detection_preprocessor_t preprocessor = {
+        .scalerConfig = {
+            .roi = CreatePixelBox(0, 0, DEFECT_DETECTION_NETWORK_INPUT_DIM.width, DEFECT_DETECTION_NETWORK_INPUT_DIM.height),
+            .nbChannels = DEFECT_DETECTION_NETWORK_INPUT_CHANNELS
+        },
+    };
+
+    defect_detection_postprocessor_t postprocessor = {
+        .nbRegisteredVectors = 0,
+        .scoreThreshold = DEFECT_DETECTION_SCORE_THRESHOLD
+    };
+    InitScoreFilter(
+        &postprocessor.scoreFilter,
+        DEFECT_DETECTION_SCORE_FILTER_MODE,
+        DEFECT_DETECTION_SCORE_FILTER_WINDOW_LOG2 );
+
+    defect_detection_t defectDetection = {
+        .input = preprocessor,
+        .output = postprocessor
+    };
+
+    return defectDetection;
+}
+
+//-----------------------------------------------------------------------------
+//
+static uint32_t ComputeNormInt(const int16_t *vector, uint8_t vectorSize)
+{
+    return ISqrt64((uint64_t)Int16DotProduct(vector, vector, vectorSize));
+}
+
+//-----------------------------------------------------------------------------
+//
+static void StoreReferenceVector(
+    defect_detection_postprocessor_t *output,
+    uint8_t index,
+    const int16_t *refVector,
+    uint32_t refVectorNorm )
+{
+    // Store not normalized vector, and its norm
+    for (uint8_t i = 0; i < DEFECT_DETECTION_VECTOR_SIZE_16B; ++i)
+    {
+        output->refVectors[index][i] = refVector[i];
+    }
+    output->refVectorNorms[index] = refVectorNorm;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool AddReferenceVector(defect_detection_t *defectDetection, const int16_t *refVector)
+{
+    return AddReferenceVectorWithNorm(
+        defectDetection,
+        refVector,
+        ComputeNormInt(refVector, DEFECT_DETECTION_VECTOR_SIZE_16B) );
+}
+
+//-----------------------------------------------------------------------------
+//
+bool AddReferenceVectorWithNorm(
+    defect_detection_t *defectDetection,
+    const int16_t *refVector,
+    uint32_t refVectorNorm )
+{
+    GARD__ASSERT(defectDetection->output.nbRegisteredVectors < DEFECT_DETECTION_NB_REF_IMAGE,
+                 "Maximum number of reference vectors reached");
+
+    StoreReferenceVector(
+        &defectDetection->output,
+        defectDetection->output.nbRegisteredVectors,
+        refVector,
+        refVectorNorm );
+    ++defectDetection->output.nbRegisteredVectors;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool ReplaceReferenceVector(
+    defect_detection_t *defectDetection,
+    uint8_t index,
+    const int16_t *refVector )
+{
+    if (index > defectDetection->output.nbRegisteredVectors ||
+        index >= DEFECT_DETECTION_NB_REF_IMAGE)
+    {
+        return false;
+    }
+
+    StoreReferenceVector(
+        &defectDetection->output,
+        index,
+        refVector,
+        ComputeNormInt(refVector, DEFECT_DETECTION_VECTOR_SIZE_16B) );
+    if (index == defectDetection->output.nbRegisteredVectors)
+    {
+        ++defectDetection->output.nbRegisteredVectors;
+    }
+    return true;
+}
+
+#if DEFECT_DETECTION_PATCH_GRID > 0
+//-----------------------------------------------------------------------------
+//
+bool SetPatchReferenceVectors(
+    defect_detection_t *defectDetection,
+    const int16_t *patchRefVectors )
+{
+    defect_detection_postprocessor_t *output = &defectDetection->output;
+
+    for (uint32_t p = 0; p < DEFECT_DETECTION_NB_PATCHES; ++p)
+    {
+        const int16_t *patchRefVector = &patchRefVectors[p * DEFECT_DETECTION_VECTOR_SIZE_16B];
+        for (uint8_t i = 0; i < DEFECT_DETECTION_VECTOR_SIZE_16B; ++i)
+        {
+            output->patchRefVectors[p][i] = patchRefVector[i];
+        }
+        output->patchRefVectorNorms[p] = ComputeNormInt(patchRefVector, DEFECT_DETECTION_VECTOR_SIZE_16B);
+    }
+    output->hasPatchRefVectors = true;
+    return true;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//
+bool UpdateThreshold(defect_detection_t *defectDetection, int32_t rawThreshold )
+{
+    defectDetection->output.scoreThreshold = InterpretIntAsFP( rawThreshold, FRAC_BITS );
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+bool SetScoreFilter(
+    defect_detection_t *defectDetection,
+    score_filter_mode_t mode,
+    uint8_t windowLog2 )
+{
+    return InitScoreFilter( &defectDetection->output.scoreFilter, mode, windowLog2 );
+}
+
+//-----------------------------------------------------------------------------
+//
+static int32_t CosineSimilarityInt(uint32_t normA, uint32_t normB, int64_t dotProduct)
+{
+    // Avoid division by zero
+    normA = normA == 0 ? 1 : normA;
+    normB = normB == 0 ? 1 : normB;
+
+    int64_t result = ( dotProduct << FRAC_BITS ) / ((int64_t)normA * (int64_t)normB);
+
+    GARD__PARANOID_ASSERT(result < INT32_MAX, 
+        "Cosine similarity result overflow");
+    GARD__PARANOID_ASSERT(result > INT32_MIN, 
+        "Cosine similarity result underflow");
+
+    const int32_t maxSimilarity = (1 << FRAC_BITS);
+    const int32_t minSimilarity = -(1 << FRAC_BITS);
+    result = result > maxSimilarity ? maxSimilarity : result;
+    result = result < minSimilarity ? minSimilarity : result;
+
+    return (int32_t)result;
+}
+
+#if DEFECT_DETECTION_PATCH_GRID > 0
+//-----------------------------------------------------------------------------
+// Fills the heatmap with the distance of each patch vector to the reference of
+// its patch. The patch distances are not smoothed over the frames, so that a
+// defect moving with the part is not smeared.
+static void ComputeHeatmap(
+    const defect_detection_postprocessor_t *output,
+    const int16_t *patchVectors,
+    uint8_t *heatmap )
+{
+    for (uint32_t p = 0; p < DEFECT_DETECTION_NB_PATCHES; ++p)
+    {
+        if (!output->hasPatchRefVectors)
+        {
+            heatmap[p] = 0;
+            continue;
+        }
+
+        const int16_t *patchVector = &patchVectors[p * DEFECT_DETECTION_VECTOR_SIZE_16B];
+        int64_t dotProduct = Int16DotProduct(
+            patchVector,
+            output->patchRefVectors[p],
+            DEFECT_DETECTION_VECTOR_SIZE_16B);
+        int32_t distance = (1 << FRAC_BITS) - CosineSimilarityInt(
+            ComputeNormInt(patchVector, DEFECT_DETECTION_VECTOR_SIZE_16B),
+            output->patchRefVectorNorms[p],
+            dotProduct );
+        int32_t cell = distance >> DEFECT_DETECTION_HEATMAP_SHIFT;
+
+        heatmap[p] = cell > UINT8_MAX ? UINT8_MAX : (uint8_t)cell;
+    }
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//
+defect_detection_result_t FinishDefectDetection(
+    defect_detection_t *defectDetection,
+    const int16_t *outputVector 
+    )
+{
+    const defect_detection_postprocessor_t *output = &defectDetection->output;
+    uint32_t normA = ComputeNormInt(outputVector, DEFECT_DETECTION_VECTOR_SIZE_16B);
+    int64_t safeNormA = normA == 0 ? 1 : normA;
+
+    // A reference is within the score threshold if its similarity is at least
+    // 1 - threshold, i.e. dotProduct << FRAC_BITS >= minSimilarity * normA * normB
+    int64_t minSimilarity =
+        (1 << FRAC_BITS) - ConvertFP(output->scoreThreshold, FRAC_BITS).n;
+
+    // The nearest reference maximizes dotProduct / normB, compared by cross
+    // multiplication with the precomputed norms so that only the winner is
+    // divided
+    int64_t bestDotProduct = 0;
+    int64_t bestNorm = 1;
+    for (uint8_t r = 0; r < output->nbRegisteredVectors; ++r)
+    {
+        int64_t dotProduct = Int16DotProduct(
+            outputVector,
+            output->refVectors[r],
+            DEFECT_DETECTION_VECTOR_SIZE_16B);
+        int64_t normB = output->refVectorNorms[r] == 0 ? 1 : output->refVectorNorms[r];
+
+        if (r == 0 || dotProduct * bestNorm > bestDotProduct * normB)
+        {
+            bestDotProduct = dotProduct;
+            bestNorm = normB;
+        }
+        if ((dotProduct << FRAC_BITS) >= minSimilarity * safeNormA * normB)
+        {
+            break;
+        }
+    }
+
+    int32_t cosSimilarityInt = CosineSimilarityInt(
+        normA,
+        (uint32_t)bestNorm,
+        bestDotProduct );
+    int32_t distance = (1 << FRAC_BITS) - cosSimilarityInt; // Move from simialrity [-1, 1] to distance [0, 2] range
+
+    int32_t avgDistance =
+        UpdateScoreFilter( &defectDetection->output.scoreFilter, distance );
+
+    fp_t avgDistanceFP = InterpretIntAsFP( avgDistance, FRAC_BITS );
+
+    defect_detection_result_t result = {.score = avgDistanceFP, .isDefective = FPGt( avgDistanceFP, defectDetection->output.scoreThreshold ) };
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    ComputeHeatmap(
+        output,
+        outputVector + DEFECT_DETECTION_VECTOR_SIZE_16B,
+        result.heatmap );
+#endif
+    return result;
+}
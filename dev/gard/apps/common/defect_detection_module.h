@@ -0,0 +1,145 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "box.h"
+#include "fixed_point.h"
+#include "score_filter.h"
+
+#define DEFECT_DETECTION_VECTOR_SIZE_16B        32
+// Number of reference vectors of normal images, stored in the model data
+// before the score threshold
+#ifndef DEFECT_DETECTION_NB_REF_IMAGE
+#define DEFECT_DETECTION_NB_REF_IMAGE           1   // Normal image
+#endif
+#define FRAC_BITS                               10
+// Number of channels of the network input: 3, RGB planar, or 1 for the models
+// trained on luminance, for which the images are captured in grayscale
+#ifndef DEFECT_DETECTION_NETWORK_INPUT_CHANNELS
+#define DEFECT_DETECTION_NETWORK_INPUT_CHANNELS 3
+#endif
+// Side of the grid of patches the networks trained for localisation output a
+// vector for, after the vector of the whole image, row by row. 0 for the
+// networks which output the vector of the whole image only.
+#ifndef DEFECT_DETECTION_PATCH_GRID
+#define DEFECT_DETECTION_PATCH_GRID             0
+#endif
+#define DEFECT_DETECTION_NB_PATCHES             (DEFECT_DETECTION_PATCH_GRID * DEFECT_DETECTION_PATCH_GRID)
+// A heatmap cell is the distance of the patch to its reference in units of
+// 1/128, 0 to 2 saturated to 255
+#define DEFECT_DETECTION_HEATMAP_SHIFT          (FRAC_BITS - 7)
+
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+typedef struct
+{
+    pixel_box_t roi;
+    uint8_t nbChannels;
+} scaler_config_t;
+
+
+// Contains information used to preprocess the network input
+typedef struct
+{
+	scaler_config_t scalerConfig;
+} defect_detection_preprocessor_t;
+
+
+// Contains information used to retrieve and interpret the result of the network.
+typedef struct
+{
+    int16_t refVectors[DEFECT_DETECTION_NB_REF_IMAGE][DEFECT_DETECTION_VECTOR_SIZE_16B];
+    uint32_t refVectorNorms[DEFECT_DETECTION_NB_REF_IMAGE];
+    uint8_t nbRegisteredVectors;
+    fp_t scoreThreshold;
+    score_filter_t scoreFilter; // Smooths the distances of the frames
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    int16_t patchRefVectors[DEFECT_DETECTION_NB_PATCHES][DEFECT_DETECTION_VECTOR_SIZE_16B];
+    uint32_t patchRefVectorNorms[DEFECT_DETECTION_NB_PATCHES];
+    bool hasPatchRefVectors;
+#endif
+} defect_detection_postprocessor_t;
+
+
+// Contains information used to run the network.
+typedef struct
+{
+	defect_detection_preprocessor_t input;
+	defect_detection_postprocessor_t output;
+} defect_detection_t;
+
+
+typedef struct {
+    fp_t score;
+    bool isDefective;
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    // Distance of each patch to its reference, row by row, see
+    // DEFECT_DETECTION_HEATMAP_SHIFT. All 0 without patch references.
+    uint8_t heatmap[DEFECT_DETECTION_NB_PATCHES];
+#endif
+} defect_detection_result_t;
+
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+defect_detection_t InitDefectDetection( void );
+
+bool AddReferenceVector(defect_detection_t *defectDetection, const int16_t *refVector);
+
+// Same as AddReferenceVector(), with the norm of the vector computed before,
+// e.g. saved with it in flash
+bool AddReferenceVectorWithNorm(
+    defect_detection_t *defectDetection,
+    const int16_t *refVector,
+    uint32_t refVectorNorm );
+
+// Overwrites the registered reference vector at index, or registers a new one
+// if index is the number of registered vectors. Returns false if index is out
+// of range.
+bool ReplaceReferenceVector(
+    defect_detection_t *defectDetection,
+    uint8_t index,
+    const int16_t *refVector );
+
+bool UpdateThreshold(defect_detection_t *defectDetection, int32_t rawThreshold );
+
+// Sets how the distances of the frames are smoothed into the score, see
+// score_filter.h. The filter restarts from the next frame.
+bool SetScoreFilter(
+    defect_detection_t *defectDetection,
+    score_filter_mode_t mode,
+    uint8_t windowLog2 );
+
+#if DEFECT_DETECTION_PATCH_GRID > 0
+// Sets the reference vector of every patch, DEFECT_DETECTION_NB_PATCHES
+// vectors row by row, as output by the network for a normal image
+bool SetPatchReferenceVectors(
+    defect_detection_t *defectDetection,
+    const int16_t *patchRefVectors );
+#endif
+
+// Scores the output vector against the nearest registered reference vector,
+// the one of greatest cosine similarity. The search stops at the first
+// reference whose distance is within the score threshold. With
+// DEFECT_DETECTION_PATCH_GRID, the patch vectors following it in the network
+// output are compared to the patch references into the heatmap, the score is
+// not changed by them.
+defect_detection_result_t FinishDefectDetection(
+    defect_detection_t *defectDetection,
+    const int16_t *outputVector 
+);
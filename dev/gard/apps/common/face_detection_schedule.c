@@ -0,0 +1,133 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "face_detection_schedule.h"
+
+#include <stddef.h>
+
+#include "app_assert.h"
+#include "errors.h"
+
+//=============================================================================
+// C O N S T R U C T O R (S) / D E S T R U C T O R   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+face_detection_schedule_t CreateFaceDetectionSchedule(
+    int32_t detectionPeriod,
+    fp_t minFitConfidence,
+    fp_t roiScale,
+    int32_dim_t sourceImageDim )
+{
+    assert( detectionPeriod > 0, EC_NEGATIVE_OR_ZERO,
+        "Detection period is less or equal to 0: %d\r\n", detectionPeriod );
+
+    face_detection_schedule_t schedule = {
+        .detectionPeriod = detectionPeriod,
+        .minFitConfidence = minFitConfidence,
+        .roiScale = roiScale,
+        .sourceImageDim = sourceImageDim,
+        .framesSinceDetection = 0,
+        .tracking = false,
+        .detectionsNb = 0,
+        .trackedFramesNb = 0 };
+
+    return schedule;
+}
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+face_roi_source_t NextFaceRoISource( face_detection_schedule_t *schedule )
+{
+    if( !schedule->tracking ||
+        schedule->framesSinceDetection + 1 >= schedule->detectionPeriod )
+    {
+        schedule->framesSinceDetection = 0;
+        ++schedule->detectionsNb;
+        return FACE_ROI_FROM_DETECTION;
+    }
+
+    ++schedule->framesSinceDetection;
+    ++schedule->trackedFramesNb;
+    return FACE_ROI_FROM_LANDMARKS;
+}
+
+//-----------------------------------------------------------------------------
+//
+geometric_box_t GetTrackedFaceRoI( const face_detection_schedule_t *schedule )
+{
+    return schedule->roi;
+}
+
+//-----------------------------------------------------------------------------
+//
+void UpdateFaceDetectionSchedule(
+    face_detection_schedule_t *schedule,
+    const landmarks_2d_facefit_t *landmarks,
+    const uint8_t indices[],
+    size_t landmarksNb,
+    fp_t fitConfidence )
+{
+    if( FPLt( fitConfidence, schedule->minFitConfidence ) )
+    {
+        LoseFaceTracking( schedule );
+        return;
+    }
+
+    geometric_box_t box = indices != NULL
+        ? BoxFromSubLandmarks( indices, landmarks, landmarksNb )
+        : BoxFromLandmarks( landmarks, landmarksNb );
+
+    // The box is scaled around its center, the landmarks only cover the
+    // inside of the face the face-fit needs to see whole
+    uint8_t fracBits = box.left.fracBits;
+    fp_t two = CreateFPInt( 2, fracBits );
+    fp_t centerX = FPDiv( FPAdd( box.left, box.right ), two );
+    fp_t centerY = FPDiv( FPAdd( box.top, box.bottom ), two );
+    fp_t halfWidth = FPMul( FPDiv( GetGeometricBoxWidth( &box ), two ), schedule->roiScale );
+    fp_t halfHeight = FPMul( FPDiv( GetGeometricBoxHeight( &box ), two ), schedule->roiScale );
+
+    geometric_box_t roi = CreateGeometricBox(
+        FPSub( centerX, halfWidth ), FPSub( centerY, halfHeight ),
+        FPAdd( centerX, halfWidth ), FPAdd( centerY, halfHeight ) );
+
+    fp_t zero = CreateFPInt( 0, fracBits );
+    geometric_box_t image = CreateGeometricBox(
+        zero, zero,
+        CreateFPInt( schedule->sourceImageDim.width, fracBits ),
+        CreateFPInt( schedule->sourceImageDim.height, fracBits ) );
+    roi = CropGeometricBox( roi, image );
+
+    // A face that left the image is looked for again by the detection
+    if( !FPGt( GetGeometricBoxWidth( &roi ), zero ) ||
+        !FPGt( GetGeometricBoxHeight( &roi ), zero ) )
+    {
+        LoseFaceTracking( schedule );
+        return;
+    }
+
+    schedule->roi = roi;
+    schedule->tracking = true;
+}
+
+//-----------------------------------------------------------------------------
+//
+void LoseFaceTracking( face_detection_schedule_t *schedule )
+{
+    schedule->tracking = false;
+}
@@ -0,0 +1,100 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef FACE_DETECTION_SCHEDULE_H
+#define FACE_DETECTION_SCHEDULE_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stdint.h>
+
+#include "box.h"
+#include "fixed_point.h"
+#include "landmarks.h"
+#include "types.h" // instead of std bool
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Where the region of interest of the face-fit of a frame comes from
+typedef enum
+{
+    FACE_ROI_FROM_DETECTION = 0, // FaceDetection() runs, the face-fit runs on
+                                 // the box of the ideal user
+    FACE_ROI_FROM_LANDMARKS,     // FaceDetection() is skipped, the face-fit
+                                 // runs on GetTrackedFaceRoI()
+} face_roi_source_t;
+
+// Schedules the full face detection of the HMI pipeline every
+// detectionPeriod frames. In the frames between, the face-fit of the tracked
+// user runs on the box of its landmarks of the previous frame, scaled by
+// roiScale, which saves the face detection network run.
+// The detection runs again before the period is over when the face-fit
+// confidence drops below minFitConfidence, when the landmarks box leaves the
+// image or when the tracking is lost with LoseFaceTracking().
+// Per frame, the pipeline calls NextFaceRoISource(), runs FaceDetection()
+// and the ideal user selection or not as it returns, then the face-fit, then
+// UpdateFaceDetectionSchedule() with its landmarks.
+typedef struct
+{
+    int32_t detectionPeriod;   // Frames from a detection to the next, 1 to
+                               // detect on every frame
+    fp_t minFitConfidence;     // Face-fit confidence below which the next
+                               // frame runs the detection
+    fp_t roiScale;             // Scale of the landmarks box to the ROI
+    int32_dim_t sourceImageDim; // The ROI is cropped to the source image
+    int32_t framesSinceDetection;
+    bool tracking;             // roi holds the box of the last landmarks
+    geometric_box_t roi;       // ROI of the face-fit of the next frame
+    uint32_t detectionsNb;     // Frames that ran the detection
+    uint32_t trackedFramesNb;  // Frames that took the ROI from the landmarks
+} face_detection_schedule_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Creates a schedule that runs the detection on the first frame.
+// It is assumed that detectionPeriod is greater than 0 and roiScale greater
+// than 1.
+face_detection_schedule_t CreateFaceDetectionSchedule(
+    int32_t detectionPeriod,     // Frames from a detection to the next
+    fp_t minFitConfidence,       // Face-fit confidence to keep tracking
+    fp_t roiScale,               // Scale of the landmarks box to the ROI
+    int32_dim_t sourceImageDim ); // Dimensions of the source image
+
+// Returns where the face-fit ROI of the frame comes from, and counts the
+// frame as a detection or a tracked frame.
+face_roi_source_t NextFaceRoISource( face_detection_schedule_t *schedule );
+
+// Returns the face-fit ROI of a FACE_ROI_FROM_LANDMARKS frame, in source
+// image coordinates, with the fractional bits of the landmarks.
+geometric_box_t GetTrackedFaceRoI( const face_detection_schedule_t *schedule );
+
+// Takes the face-fit landmarks of the frame, in source image coordinates, as
+// the ROI of the next frame, with BoxFromSubLandmarks() if indices is not
+// NULL, else BoxFromLandmarks(). A fit confidence below minFitConfidence
+// loses the tracking instead.
+// It is assumed that landmarksNb is greater than 0 and that fitConfidence has
+// the fixed point representation of minFitConfidence.
+void UpdateFaceDetectionSchedule(
+    face_detection_schedule_t *schedule,
+    const landmarks_2d_facefit_t *landmarks, // Face-fit landmarks of the frame
+    const uint8_t indices[],  // Landmarks to enclose, NULL for all of them
+    size_t landmarksNb,       // Number of indices, or of landmarks
+    fp_t fitConfidence );     // Face-fit confidence of the frame
+
+// Loses the tracking, so that the next frame runs the detection, e.g. when
+// the face-fit did not run or there is no ideal user.
+void LoseFaceTracking( face_detection_schedule_t *schedule );
+
+#endif
@@ -83,6 +83,63 @@ static const fp_t ACOS_LUT[ACOS_LUT_LEN] =
     { 0, 10 }
 };
 
+// Number of CORDIC iterations of FPAtan2() and FPAsin(), at most
+// CORDIC_ATAN_LUT_LEN. The error of the angle is within atan(2^-(n-1)) after
+// n iterations, 12 iterations are within 5e-4 radian, half a Q10 lsb.
+#ifndef FP_ATAN2_CORDIC_ITERATIONS
+#define FP_ATAN2_CORDIC_ITERATIONS 12
+#endif
+
+// Lookup table of the CORDIC rotation angles: atan(2^-i) for i = 0 to 15, with
+// CORDIC_FRAC_BITS fractional bits.
+#define CORDIC_ATAN_LUT_LEN 16
+#define CORDIC_FRAC_BITS    16
+#define CORDIC_PI           205887
+static const int32_t CORDIC_ATAN_LUT[CORDIC_ATAN_LUT_LEN] =
+{
+    51472, 30386, 16055, 8150, 4091, 2047, 1024, 512,
+    256, 128, 64, 32, 16, 8, 4, 2
+};
+
+#if FP_ATAN2_CORDIC_ITERATIONS > CORDIC_ATAN_LUT_LEN
+#error "FP_ATAN2_CORDIC_ITERATIONS exceeds CORDIC_ATAN_LUT_LEN"
+#endif
+
+// Lookup table to compute sigmoid values: sigmoid(i / 16) for i = 0 to 256,
+// i.e. x = 0 to 16, with 15 fractional bits. Linear interpolation between the
+// entries is within 1e-4 of the sigmoid.
+#define SIGMOID_LUT_LEN         257
+#define SIGMOID_LUT_STEP_BITS   4
+#define SIGMOID_LUT_FRAC_BITS   15
+static const uint16_t SIGMOID_LUT[SIGMOID_LUT_LEN] =
+{
+    16384, 16896, 17407, 17916, 18421, 18923, 19420, 19912, 20397, 20874,
+    21344, 21804, 22255, 22696, 23127, 23547, 23955, 24352, 24737, 25110,
+    25471, 25819, 26155, 26479, 26790, 27090, 27377, 27653, 27917, 28169,
+    28411, 28642, 28862, 29072, 29272, 29462, 29644, 29816, 29979, 30135,
+    30282, 30422, 30555, 30680, 30799, 30912, 31018, 31119, 31214, 31304,
+    31389, 31469, 31545, 31616, 31684, 31747, 31807, 31864, 31917, 31968,
+    32015, 32060, 32102, 32141, 32179, 32214, 32247, 32278, 32307, 32335,
+    32361, 32385, 32408, 32430, 32450, 32469, 32487, 32504, 32520, 32535,
+    32549, 32562, 32574, 32586, 32597, 32607, 32617, 32626, 32635, 32643,
+    32650, 32657, 32664, 32670, 32676, 32682, 32687, 32692, 32696, 32701,
+    32705, 32709, 32712, 32716, 32719, 32722, 32725, 32727, 32730, 32732,
+    32734, 32736, 32738, 32740, 32742, 32743, 32745, 32746, 32747, 32749,
+    32750, 32751, 32752, 32753, 32754, 32755, 32756, 32756, 32757, 32758,
+    32758, 32759, 32759, 32760, 32760, 32761, 32761, 32762, 32762, 32762,
+    32763, 32763, 32763, 32764, 32764, 32764, 32764, 32765, 32765, 32765,
+    32765, 32765, 32766, 32766, 32766, 32766, 32766, 32766, 32766, 32766,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768,
+    32768, 32768, 32768, 32768, 32768, 32768, 32768
+};
 
 //=============================================================================
 // M A C R O S
@@ -425,7 +482,7 @@ static inline fp_t FPSqrt( fp_t op )
 // It is assumed op2 is different from 0.
 static inline fp_t FPDiv( fp_t op1, fp_t op2 )
 {
-	assert( op2.n != 0, EC_ZERO_VALUE, "FPDiv: Can't divide by 0.\r\n" );
+	assert_paranoid( op2.n != 0, EC_ZERO_VALUE, "FPDiv: Can't divide by 0.\r\n" );
 	
 	// When dividing one fixed point number op1 by fixed point number op2
 	// we are subtracting op2 frac bits from op1 frac bits.
@@ -645,15 +702,10 @@ static inline fp_t FPMinus( fp_t x )
 }
 
 //-----------------------------------------------------------------------------
-// Compute the cosine of x. 
-// x is expected to be in radians.
-static inline fp_t FPCos( fp_t x )
+// Moves angle x to [0, 2*PI), where cos(x) and sin(x) are the same.
+static inline fp_t FPReduceAngle( fp_t x )
 {
-	// This function actually computes result for 0 <= x < PI.
-	// First step is to move x to this interval
-
-    uint8_t fracBits = x.fracBits;
-    fp_t zero = CreateFPInt( 0, fracBits );
+    fp_t zero = CreateFPInt( 0, x.fracBits );
 
 	// Set x value between 0 and 2pi
     while( FPLt( x, zero ) )
@@ -666,39 +718,49 @@ static inline fp_t FPCos( fp_t x )
 		// cos(x) = cos(x - 2*PI)
         x = FPSub( x, TAU );
     }
+    return x;
+}
 
-	// Here, 0 <= x < 2*PI
+//-----------------------------------------------------------------------------
+// Compute the cosine of x, with 0 <= x < 2*PI, see FPReduceAngle().
+static inline fp_t FPCosReduced( fp_t x )
+{
+    uint8_t fracBits = x.fracBits;
+    fp_t zero = CreateFPInt( 0, fracBits );
+    bool negate = false;
 
 	// PI < x < 2PI
     if( FPGt( x, PI ) )
     {
 		// 0 < (x - PI) < PI
 		// cos(x) = -cos(x-PI)
-        return FPMinus( FPCos( FPSub( x, PI ) ) );
+        x = FPSub( x, PI );
+        negate = true;
     }
 
-	// If we're here, 0 <= x < PI
-	// cos(PI/2) = 0
-    if( FPEq( x, HALF_PI ) )
+	// If we're here, 0 <= x <= PI
+	// PI/2 < x <= PI
+    if( FPGt( x, HALF_PI ) )
     {
-        return zero;
+		// 0 <= (PI - x) <= PI/2, PI not being twice HALF_PI
+		// cos(x) = -cos(PI-x)
+        x = FPSub( PI, x );
+        negate = !negate;
     }
 
-	// If we're here, 0 <= x < PI
-
-	// PI/2 < x < PI
-    if( FPGe( x, HALF_PI ) )
+	// cos(PI/2) = 0
+    if( FPEq( x, HALF_PI ) )
     {
-		// 0 < (PI - x) < PI/2 
-		// cos(x) = -cos(PI-x)
-		return FPMinus( FPCos( FPSub( PI, x ) ) );
+        return zero;
     }
 
-	// if we're here, 0 <= x <= PI/2
+	// if we're here, 0 <= x < PI/2
 	// Actual computation happens from there
-	
-	// Interpolate cos(x) value using the lookup table content
-    fp_t fpIndex = FPDiv( x, HALF_PI );
+
+	// Interpolate cos(x) value using the lookup table content. x << 10 fits 32
+	// bits, a 32-bit division gives the quotient of FPDiv( x, HALF_PI ).
+    fp_t fpIndex = InterpretIntAsFP(
+        ( x.n << HALF_PI.fracBits ) / HALF_PI.n, fracBits );
     fpIndex.n *= COS_LUT_LEN - 1;
 
     int index = FPFloor( fpIndex );
@@ -707,8 +769,17 @@ static inline fp_t FPCos( fp_t x )
     fp_t value2 = COS_LUT[index + 1];
     fp_t distance = FPSub( value2, value1 );
     fp_t ratio = FPSub( fpIndex, CreateFPInt( index, fracBits ) );
+    fp_t result = FPAdd( value1, FPMul( ratio, distance ) );
 
-    return FPAdd( value1, FPMul( ratio, distance ) );
+    return negate ? FPMinus( result ) : result;
+}
+
+//-----------------------------------------------------------------------------
+// Compute the cosine of x. 
+// x is expected to be in radians.
+static inline fp_t FPCos( fp_t x )
+{
+    return FPCosReduced( FPReduceAngle( x ) );
 }
 
 //-----------------------------------------------------------------------------
@@ -720,6 +791,24 @@ static inline fp_t FPSin( fp_t x )
     return FPCos( FPSub( x, HALF_PI ) );
 }
 
+//-----------------------------------------------------------------------------
+// Compute both the sine and the cosine of x, with a single reduction of x.
+// The results are the ones of FPSin() and FPCos().
+// x is expected to be in radians.
+static inline void FPSinCos( fp_t x, fp_t *sin, fp_t *cos )
+{
+    x = FPReduceAngle( x );
+    *cos = FPCosReduced( x );
+
+	// sin(x) = cos(x - PI/2), x - PI/2 being back in [0, 2PI) with one turn
+    x = FPSub( x, HALF_PI );
+    if( IsFPNegative( x ) )
+    {
+        x = FPAdd( x, TAU );
+    }
+    *sin = FPCosReduced( x );
+}
+
 //-----------------------------------------------------------------------------
 // Compute the tan of x.
 // x is expected to be in radians.
@@ -777,21 +866,6 @@ static inline fp_t FPAcos( fp_t x )
     return FPAdd( value1, FPMul( ratio, distance ) );
 }
 
-//-----------------------------------------------------------------------------
-// Compute the arc sine of x. 
-// x is expected to be in [-1 ,1]
-static inline fp_t FPAsin( fp_t x )
-{
-	assert(
-		FPLe( FPMinus( CreateFPInt( 1, x.fracBits ) ), x ) &&
-		FPLe( x, CreateFPInt( 1, x.fracBits ) ),
-		EC_OUT_OF_BOUNDS,
-		"FPAsin: x value %d is not in interval [%d, %d]\r\n",
-		x.n, CreateFPInt( -1, x.fracBits ).n, CreateFPInt( 1, x.fracBits ).n );
-	// arcsin(x) = PI/2 - arccos(x)
-    return FPSub( HALF_PI, FPAcos( x ) );
-}
-
 //-----------------------------------------------------------------------------
 // Compute the arc tan of x. 
 static inline fp_t FPAtan( fp_t x )
@@ -845,66 +919,133 @@ static inline fp_t FPAtan( fp_t x )
 }
 
 //-----------------------------------------------------------------------------
-// Compute the direct angle between vector (1, 0) and (x, y)
+// Compute the direct angle between vector (1, 0) and (x, y), in (-PI, PI].
+// The vector is rotated onto the x axis by FP_ATAN2_CORDIC_ITERATIONS CORDIC
+// steps of shifts and adds, the angle being the sum of CORDIC_ATAN_LUT
+// entries of the steps. There is no division, and the result does not depend
+// on the scale of the vector.
+// x and y are assumed to have the same fixed point representation. Result has
+// the same fixed point representation as x.
+// arctan2(0, 0) is undefined, 0 is returned.
 static inline fp_t FPAtan2( fp_t y, fp_t x )
 {
     uint8_t fracBits = x.fracBits;
-    fp_t zero = CreateFPInt( 0, fracBits );
-    
-	// Using the following definition or arctan2:
-	// arctan2(y, x) =
-	//   - arctan(y / x)      if x > 0
-	//   - arctan(y / x) + PI if x < 0 and y > 0
-	//   - arctan(y / x) - PI if x < 0 and y < 0
-	//   - PI/2               if x = 0 and y > 0
-	//   - -PI/2              if x = 0 and y < 0
-	//   - 0                  if x = 0 and y = 0
-	//
-	// arctan(0, 0) should actually be undefined
-
-    if( FPEq( x, zero ) )
+    int32_t vx = x.n;
+    int32_t vy = y.n;
+    int32_t angle = 0;
+
+    if( vx == 0 && vy == 0 )
     {
-        if( FPEq( y, zero ) )
-        {
-            return zero;
-        }
-        else
-        {
-            if( FPGt( y, zero ) )
-            {
-                return HALF_PI;
-            }
-            else
-            {
-                return FPMinus( HALF_PI );
-            }
-        }
+        return CreateFPInt( 0, fracBits );
     }
-    else if( FPGt( x, zero ) )
+
+	// CORDIC converges for vectors in the right half plane.
+	// arctan2(y, x) = arctan2(-y, -x) + PI if y >= 0, - PI otherwise
+    if( vx < 0 )
     {
-        return FPAtan( FPDiv( y, x ) );
+        angle = vy >= 0 ? CORDIC_PI : -CORDIC_PI;
+        vx = -vx;
+        vy = -vy;
+    }
+
+	// Scale the vector to 29 significant bits: the steps keep all the
+	// precision, and the CORDIC gain of 1.65 leaves it within 31 bits.
+    uint32_t magnitude = ( uint32_t )vx | ( uint32_t )( vy < 0 ? -vy : vy );
+    int32_t shift = __builtin_clz( magnitude ) - 3;
+    if( shift >= 0 )
+    {
+        vx <<= shift;
+        vy <<= shift;
     }
     else
     {
-        if( FPGe( y, zero ) )
+        vx >>= -shift;
+        vy >>= -shift;
+    }
+
+    for( int32_t i = 0; i < FP_ATAN2_CORDIC_ITERATIONS; ++i )
+    {
+        int32_t dx = vx >> i;
+        int32_t dy = vy >> i;
+        if( vy > 0 )
         {
-            return FPAdd( FPAtan( FPDiv( y, x ) ), PI );
+            vx += dy;
+            vy -= dx;
+            angle += CORDIC_ATAN_LUT[i];
         }
         else
         {
-            return FPSub( FPAtan( FPDiv( y, x ) ), PI );
+            vx -= dy;
+            vy += dx;
+            angle -= CORDIC_ATAN_LUT[i];
         }
     }
+
+	// Back to fracBits, rounded
+    int32_t dropped = CORDIC_FRAC_BITS - fracBits;
+    fp_t result = {
+        .n = dropped > 0 ?
+            ( angle + ( 1 << ( dropped - 1 ) ) ) >> dropped :
+            angle << -dropped,
+        .fracBits = fracBits };
+    return result;
 }
 
 //-----------------------------------------------------------------------------
-// Compute an approximation of 1 / (1 + e^-x)
-// TODO: this is not a good approximation, we can and should probably do much 
-// better.
+// Compute the arc sine of x, as arctan2(x, sqrt(1 - x^2)) with FPAtan2().
+// x is expected to be in [-1 ,1]
+// Result has the same fixed point representation as x.
+static inline fp_t FPAsin( fp_t x )
+{
+	assert(
+		FPLe( FPMinus( CreateFPInt( 1, x.fracBits ) ), x ) &&
+		FPLe( x, CreateFPInt( 1, x.fracBits ) ),
+		EC_OUT_OF_BOUNDS,
+		"FPAsin: x value %d is not in interval [%d, %d]\r\n",
+		x.n, CreateFPInt( -1, x.fracBits ).n, CreateFPInt( 1, x.fracBits ).n );
+
+	// 1 - x^2 with 2 * fracBits fractional bits, its integer square root has
+	// fracBits
+    uint64_t oneMinusSquare =
+        ( ( uint64_t )1 << ( 2 * x.fracBits ) ) - ( int64_t )x.n * x.n;
+    fp_t cos = InterpretIntAsFP(
+        ( int32_t )ISqrt64( oneMinusSquare ), x.fracBits );
+    return FPAtan2( x, cos );
+}
+
+//-----------------------------------------------------------------------------
+// Compute 1 / (1 + e^-x) by linear interpolation of SIGMOID_LUT, using
+// sigmoid(-x) = 1 - sigmoid(x) for negative x. The result has the fracBits of x.
 static inline fp_t FPSigmoid( fp_t x )
 {
-    fp_t scale = InterpretIntAsFP( 325, 10 );
-    return FPMul( FPAdd( FPAtan( x ), HALF_PI ), scale );
+    int64_t magnitude = x.n < 0 ? -( int64_t )x.n : ( int64_t )x.n;
+    // |x| in LUT steps with 16 fractional bits
+    int64_t pos = ( magnitude << ( SIGMOID_LUT_STEP_BITS + 16 ) ) >> x.fracBits;
+    int32_t y;
+
+    if( pos >= ( ( int64_t )( SIGMOID_LUT_LEN - 1 ) << 16 ) )
+    {
+        y = SIGMOID_LUT[SIGMOID_LUT_LEN - 1];
+    }
+    else
+    {
+        int32_t index = ( int32_t )( pos >> 16 );
+        int32_t frac  = ( int32_t )( pos & 0xFFFF );
+        int32_t y0    = SIGMOID_LUT[index];
+        int32_t y1    = SIGMOID_LUT[index + 1];
+        y = y0 + ( int32_t )( ( ( int64_t )( y1 - y0 ) * frac ) >> 16 );
+    }
+
+    if( x.n < 0 )
+    {
+        y = ( 1 << SIGMOID_LUT_FRAC_BITS ) - y;
+    }
+
+    if( x.fracBits >= SIGMOID_LUT_FRAC_BITS )
+    {
+        return InterpretIntAsFP( ( int32_t )( ( int64_t )y << ( x.fracBits - SIGMOID_LUT_FRAC_BITS ) ), x.fracBits );
+    }
+    return InterpretIntAsFP( y >> ( SIGMOID_LUT_FRAC_BITS - x.fracBits ), x.fracBits );
 }
 
 //-----------------------------------------------------------------------------
@@ -1042,4 +1183,72 @@ static inline int32_t FPToStr( fp_t num, char* numStr, int32_t bufSize ) {
     return written + 1; // Count '\0' character
 }
 
+//=============================================================================
+// F I X E D   F O R M A T   T Y P E S
+//
+// Numbers whose fractional bits are set by their type rather than carried
+// along, for the hot loops of the post-processing. They are plain integers:
+// numbers of the same format are added, subtracted and compared with the
+// integer operators, only multiplication and division need the functions
+// below. The ML engine output is Q5.10, i.e. int16_t with 10 fractional bits,
+// and Q21.10 holds the results of computations on it, e.g. box coordinates.
+
+#define Q10_FRAC_BITS 10
+#define Q10_ONE       ( 1 << Q10_FRAC_BITS )
+
+// Represents a real number n * 2^-10 on 16 bits: -32 to 32.
+typedef int16_t q5_10_t;
+
+// Represents a real number n * 2^-10 on 32 bits: -2097152 to 2097152.
+typedef int32_t q21_10_t;
+
+// Get a Q21.10 number from an integer or a floating point number in
+// compilation time.
+#define IntToQ10( intNum )     ( ( q21_10_t )( intNum ) * Q10_ONE )
+#define FloatToQ10( floatNum ) ( ( q21_10_t )( ( floatNum ) * Q10_ONE ) )
+
+//-----------------------------------------------------------------------------
+// Returns the Q21.10 representation of the fixed point number x.
+// This can lead to loss of precision or overflow.
+static inline q21_10_t FPToQ10( fp_t x )
+{
+	if( x.fracBits >= Q10_FRAC_BITS )
+	{
+		return x.n >> ( x.fracBits - Q10_FRAC_BITS );
+	}
+	return x.n << ( Q10_FRAC_BITS - x.fracBits );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the fixed point representation of the Q21.10 number x, with
+// Q10_FRAC_BITS fractional bits.
+static inline fp_t Q10ToFP( q21_10_t x )
+{
+	return InterpretIntAsFP( x, Q10_FRAC_BITS );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the nearest integer number lower than or equal to x.
+static inline int32_t Q10ToInt32( q21_10_t x )
+{
+	return x >> Q10_FRAC_BITS;
+}
+
+//-----------------------------------------------------------------------------
+// Performs multiplication of two Q21.10 numbers.
+static inline q21_10_t Q10Mul( q21_10_t op1, q21_10_t op2 )
+{
+	return ( q21_10_t )( ( ( int64_t ) op1 * op2 ) >> Q10_FRAC_BITS );
+}
+
+//-----------------------------------------------------------------------------
+// Performs division of two Q21.10 numbers.
+// It is assumed op2 is different from 0.
+static inline q21_10_t Q10Div( q21_10_t op1, q21_10_t op2 )
+{
+	assert( op2 != 0, EC_ZERO_VALUE, "Q10Div: Can't divide by 0.\r\n" );
+
+	return ( q21_10_t )( ( ( int64_t ) op1 << Q10_FRAC_BITS ) / op2 );
+}
+
 #endif
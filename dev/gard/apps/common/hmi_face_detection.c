@@ -2,6 +2,7 @@
 #include "range.h"
 #include "anchor.h"
 #include "frame_data.h"
+#include "landmarks.h"
 #include "postprocessing_fixed_point.h"
 #include "postprocessing_bounding_box.h"
 #include "postprocessing_geometric_point.h"
@@ -9,6 +10,8 @@
 #include "postprocessing_anchor_based_detection.h"
 #include "source_image.h"
 #include "ml_engine_config.h"
+#include "ml_io.h"
+#include "scratch_arena.h"
 #include "types.h"
 
 
@@ -93,6 +96,52 @@ const fp_t FACE_DETECTION_NMS_THRESHOLD =
 	}
 
 
+// Channel layout of the face detection network output. Each channel holds
+// one int16 value per anchor, for all the anchors of the grid, and the
+// channels are stored one after the other. The landmark channels interleave
+// the x and y coordinates.
+typedef struct
+{
+    int32_t confidence;
+    int32_t deltaX;
+    int32_t deltaY;
+    int32_t deltaW;
+    int32_t deltaH;
+    int32_t landmarkX[ROUGH_LANDMARKS_NB];
+    int32_t landmarkY[ROUGH_LANDMARKS_NB];
+    int32_t pitch;
+    int32_t yaw;
+    int32_t roll;
+} face_detection_channel_layout_t;
+
+static const face_detection_channel_layout_t FACE_DETECTION_CHANNEL_LAYOUT = {
+    .confidence = 0,
+    .deltaX = 1,
+    .deltaY = 2,
+    .deltaW = 3,
+    .deltaH = 4,
+    .landmarkX = { 5, 7, 9, 11, 13 },
+    .landmarkY = { 6, 8, 10, 12, 14 },
+    .pitch = 15,
+    .yaw = 16,
+    .roll = 17
+};
+
+static inline const int16_t *FaceDetectionChannel(
+    const int16_t *output, int32_t channelOffset, int32_t channel )
+{
+    return output + channelOffset * channel;
+}
+
+static inline fp_t FaceDetectionRawValue(
+    const int16_t *output, int32_t channelOffset, int32_t channel,
+    size_t index )
+{
+    return InterpretIntAsFP(
+        FaceDetectionChannel( output, channelOffset, channel )[index],
+        ML_ENGINE_OUTPUT_FRAC_BITS );
+}
+
 int32_t FaceDetection(
 	uint32_t FACE_DETECTION_NETWORK_OUTPUT_ADDR,
     fp_t *confidence,
@@ -108,52 +157,10 @@ int32_t FaceDetection(
 		FACE_DETECTION_NETWORK_GRID_DIM.width *
 		FACE_DETECTION_NETWORK_GRID_DIM.height *
 		FACE_DETECTION_NETWORK_ANCHORS_PER_CELL;
-	const int16_t *const FACE_DETECTION_NETWORK_CONFIDENCE_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 0;
-    const int16_t *const FACE_DETECTION_NETWORK_DELTA_X_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 1;
-    const int16_t *const FACE_DETECTION_NETWORK_DELTA_Y_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 2;
-    const int16_t *const FACE_DETECTION_NETWORK_DELTA_W_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 3;
-    const int16_t *const FACE_DETECTION_NETWORK_DELTA_H_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 4;
-    const int16_t *const FACE_DETECTION_NETWORK_LDK_X_OUTPUT_ADDR[5] = {
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 5,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 7,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 9,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 11,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 13 };
-    const int16_t *const FACE_DETECTION_NETWORK_LDK_Y_OUTPUT_ADDR[5] = {
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 6,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 8,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 10,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 12,
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 14 };
-    const int16_t *const FACE_DETECTION_NETWORK_PITCH_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 15;
-    const int16_t *const FACE_DETECTION_NETWORK_YAW_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 16;
-    const int16_t *const FACE_DETECTION_NETWORK_ROLL_OUTPUT_ADDR =
-        (int16_t *)FACE_DETECTION_NETWORK_OUTPUT_ADDR +
-        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * 17;
+	const int16_t *const FACE_DETECTION_NETWORK_OUTPUT_PTR =
+		(int16_t *)MLIOPointer(FACE_DETECTION_NETWORK_OUTPUT_ADDR);
+	const face_detection_channel_layout_t *const layout =
+		&FACE_DETECTION_CHANNEL_LAYOUT;
 
 
 // #ifndef N2STEP_SCALER
@@ -178,17 +185,40 @@ int32_t FaceDetection(
     // scaler_config_t faceDetectionScalerConfig = CreateScalerConfig(
     //     faceDetectionSource, faceDetectionRoI, false, faceDetectionOutput);
 
+    // The confidences of all the anchors are scanned, from a copy in the
+    // scratch arena; the other channels are read at the kept anchors only
+    scratch_mark_t mark = ScratchMark();
+    const int16_t *confidences = MLIOCopyPlanes(
+        FACE_DETECTION_NETWORK_OUTPUT_ADDR +
+            FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET * layout->confidence *
+                sizeof( int16_t ),
+        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+        FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+        1 );
+
     fp_postprocessing_config_t faceDetectionConfidenceConfig =
         CreateFPPostprocessingConfig(
-            FACE_DETECTION_NETWORK_CONFIDENCE_OUTPUT_ADDR,
+            confidences,
             ML_ENGINE_OUTPUT_FRAC_BITS,
             FPSigmoid);
 
     bounding_boxes_postprocessing_config_t faceDetectionBoundingBoxesConfig = {
-        .deltaXPtr = FACE_DETECTION_NETWORK_DELTA_X_OUTPUT_ADDR,
-        .deltaYPtr = FACE_DETECTION_NETWORK_DELTA_Y_OUTPUT_ADDR,
-        .deltaWPtr = FACE_DETECTION_NETWORK_DELTA_W_OUTPUT_ADDR,
-        .deltaHPtr = FACE_DETECTION_NETWORK_DELTA_H_OUTPUT_ADDR,
+        .deltaXPtr = FaceDetectionChannel(
+            FACE_DETECTION_NETWORK_OUTPUT_PTR,
+            FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+            layout->deltaX ),
+        .deltaYPtr = FaceDetectionChannel(
+            FACE_DETECTION_NETWORK_OUTPUT_PTR,
+            FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+            layout->deltaY ),
+        .deltaWPtr = FaceDetectionChannel(
+            FACE_DETECTION_NETWORK_OUTPUT_PTR,
+            FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+            layout->deltaW ),
+        .deltaHPtr = FaceDetectionChannel(
+            FACE_DETECTION_NETWORK_OUTPUT_PTR,
+            FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+            layout->deltaH ),
         .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
         .gridDim = FACE_DETECTION_NETWORK_GRID_DIM,
         .gridCoordinatesToAnchor = FaceDetectionGridCoordinatesToAnchor,
@@ -210,12 +240,13 @@ int32_t FaceDetection(
         CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
         CreateFPInt(SOURCE_IMAGE_HEIGHT, ML_ENGINE_OUTPUT_FRAC_BITS));
 
+    fp_affine_map_t faceDetectionToSourceX = CreateFPAffineMap(
+        &faceDetectionCoordinateXRange, &sourceCoordinateXRange );
+    fp_affine_map_t faceDetectionToSourceY = CreateFPAffineMap(
+        &faceDetectionCoordinateYRange, &sourceCoordinateYRange );
+
     size_t nbFaces = 0;
     size_t faceIndices[FACE_DETECTION_CAP];
-    geometric_point_2d_t faceLandmarks[5][FACE_DETECTION_CAP];
-    fp_t facePitch[FACE_DETECTION_CAP];
-    fp_t faceYaw[FACE_DETECTION_CAP];
-    fp_t faceRoll[FACE_DETECTION_CAP];
 
     // CropAndResizeImage(&faceDetectionScalerConfig, true);
     // if ( !WaitForInterrupt(INT_SCALER, 500) )
@@ -252,84 +283,63 @@ int32_t FaceDetection(
         faceIndices,
         confidence,
         boxes );
+    ScratchRelease( mark );
 
-    for( size_t i = 0; i < 5; ++i )
-    {
-        anchor_geometric_point_2d_postprocessing_config_t
-        faceDetectionLandmarksConfig = {
-            .xPtr = FACE_DETECTION_NETWORK_LDK_X_OUTPUT_ADDR[i],
-            .yPtr = FACE_DETECTION_NETWORK_LDK_Y_OUTPUT_ADDR[i],
-            .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
-            .gridDim = FACE_DETECTION_NETWORK_GRID_DIM,
-            .gridCoordinatesToAnchor = FaceDetectionGridCoordinatesToAnchor,
-            .rawToGeometricPoint = FaceDetectionRawToLandmarks
-        };
-
-        RawToAnchorBasedGeometricPoint2D(
-            faceIndices,
-            nbFaces,
-            &faceDetectionLandmarksConfig,
-            faceLandmarks[i] );
-    }
-
-    fp_postprocessing_config_t faceDetectionPitchConfig = {
-        .dataPtr = FACE_DETECTION_NETWORK_PITCH_OUTPUT_ADDR,
-        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
-        .rawToFP = RadiansToDegrees
-    };
-
-    RawToFP( faceIndices, nbFaces, &faceDetectionPitchConfig, facePitch );
-
-    fp_postprocessing_config_t faceDetectionYawConfig = {
-        .dataPtr = FACE_DETECTION_NETWORK_YAW_OUTPUT_ADDR,
-        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
-        .rawToFP = RadiansToDegrees
-    };
-
-    RawToFP( faceIndices, nbFaces, &faceDetectionYawConfig, faceYaw );
-
-    fp_postprocessing_config_t faceDetectionRollConfig = {
-        .dataPtr = FACE_DETECTION_NETWORK_ROLL_OUTPUT_ADDR,
-        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
-        .rawToFP = RadiansToDegrees
-    };
-
-    RawToFP( faceIndices, nbFaces, &faceDetectionRollConfig, faceRoll );
-
-    // Change boxes coordinates to source image coordinate system
+    // Only the faces that passed the confidence threshold and the NMS are
+    // left, decode their landmarks and angles in one pass, reading each of
+    // the remaining channels at the index of the face only.
     for (int32_t i = 0; i < (int32_t) nbFaces; ++i)
     {
-        fp_t left = FPMap(
-            boxes[i].left,
-            &faceDetectionCoordinateXRange, &sourceCoordinateXRange );
-        fp_t right = FPMap(
-            boxes[i].right,
-            &faceDetectionCoordinateXRange, &sourceCoordinateXRange );
-        fp_t top = FPMap(
-            boxes[i].top,
-            &faceDetectionCoordinateYRange, &sourceCoordinateYRange );
-         fp_t bottom = FPMap(
-            boxes[i].bottom,
-            &faceDetectionCoordinateYRange, &sourceCoordinateYRange );
+        size_t index = faceIndices[i];
+        anchor_grid_coords_t coords = IndexToGridCoordinates(
+            index, FACE_DETECTION_NETWORK_GRID_DIM );
+        anchor_t anchor = FaceDetectionGridCoordinatesToAnchor( &coords );
+
+        // Change boxes coordinates to source image coordinate system
+        fp_t left = FPApplyAffine( boxes[i].left, &faceDetectionToSourceX );
+        fp_t right = FPApplyAffine( boxes[i].right, &faceDetectionToSourceX );
+        fp_t top = FPApplyAffine( boxes[i].top, &faceDetectionToSourceY );
+        fp_t bottom = FPApplyAffine( boxes[i].bottom, &faceDetectionToSourceY );
         boxes[i] = CreateGeometricBox( left, top, right, bottom );
 
-        for( int32_t j = 0; j < 5; ++j )
+        for( int32_t j = 0; j < ROUGH_LANDMARKS_NB; ++j )
         {
-            fp_t x = FPMap(
-                faceLandmarks[j][i].x,
-                &faceDetectionCoordinateXRange, &sourceCoordinateXRange );
-            fp_t y = FPMap(
-                faceLandmarks[j][i].y,
-                &faceDetectionCoordinateYRange, &sourceCoordinateYRange );
-            faceLandmarks[j][i] = CreateGeometricPoint( x, y );
+            fp_t rawX = FaceDetectionRawValue(
+                FACE_DETECTION_NETWORK_OUTPUT_PTR,
+                FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+                layout->landmarkX[j], index );
+            fp_t rawY = FaceDetectionRawValue(
+                FACE_DETECTION_NETWORK_OUTPUT_PTR,
+                FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+                layout->landmarkY[j], index );
+            geometric_point_2d_t landmark =
+                FaceDetectionRawToLandmarks( rawX, rawY, &anchor );
+
+            fp_t x = FPApplyAffine(
+                landmark.x, &faceDetectionToSourceX );
+            fp_t y = FPApplyAffine(
+                landmark.y, &faceDetectionToSourceY );
             SetLandmark2dFaceDet(
-                &frameData->detectedUsers[i].landmarks, j, faceLandmarks[j][i] );
+                &frameData->detectedUsers[i].landmarks, j,
+                CreateGeometricPoint( x, y ) );
         }
 
         frameData->detectedUsers[i].roiPtr = &boxes[i];
-        frameData->detectedUsers[i].eulerAnglesICS.pitch = facePitch[i];
-        frameData->detectedUsers[i].eulerAnglesICS.yaw = faceYaw[i];
-        frameData->detectedUsers[i].eulerAnglesICS.roll = faceRoll[i];
+        frameData->detectedUsers[i].eulerAnglesICS.pitch = RadiansToDegrees(
+            FaceDetectionRawValue(
+                FACE_DETECTION_NETWORK_OUTPUT_PTR,
+                FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+                layout->pitch, index ) );
+        frameData->detectedUsers[i].eulerAnglesICS.yaw = RadiansToDegrees(
+            FaceDetectionRawValue(
+                FACE_DETECTION_NETWORK_OUTPUT_PTR,
+                FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+                layout->yaw, index ) );
+        frameData->detectedUsers[i].eulerAnglesICS.roll = RadiansToDegrees(
+            FaceDetectionRawValue(
+                FACE_DETECTION_NETWORK_OUTPUT_PTR,
+                FACE_DETECTION_NETWORK_OUTPUT_CHANNEL_OFFSET,
+                layout->roll, index ) );
     }
     return nbFaces;
 }
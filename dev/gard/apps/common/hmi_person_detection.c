@@ -0,0 +1,330 @@
+//=============================================================================
+//
+// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+// #include "interrupt.h"
+#include "quick_select.h"
+// #include "wait.h"
+
+#include "preprocessing/bounding_box.h"
+
+#include "postprocessing/postprocessing_detection_head.h"
+#include "postprocessing/postprocessing_filters.h"
+// #include <convert3d.h>
+
+// #include "ml_engine_config.h"
+#include "hmi_person_detection.h"
+#include "ml_engine_config.h"
+#include "ml_io.h"
+#include "source_image.h"
+// #include "config/addresses.h"
+
+//=============================================================================
+// C O N S T A N T S
+
+
+const int32_dim_t PERSON_DETECTION_NETWORK_INPUT_DIM =
+    CreateLiteralInt32Dim( 256, 144 );
+
+const fp_t PERSON_DETECTION_CONFIDENCE_THRESHOLD = // TODO test 0.50, 0.55, 0.60
+    CreateLiteralFP( 55, 100, ML_ENGINE_OUTPUT_FRAC_BITS );
+
+const fp_t PERSON_DETECTION_NMS_THRESHOLD = 
+    CreateLiteralFP( 40, 100, ML_ENGINE_OUTPUT_FRAC_BITS );
+
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+// Returns the anchor of a grid cell: its center, in the network input image.
+static inline anchor_t PersonDetectionCellToAnchor(
+    int32_t row,
+    int32_t col,
+    int32_t anchorIndex,
+    int32_t gridWidth,
+    int32_t gridHeight )
+{
+    (void)anchorIndex; // one anchor per cell
+
+    // Transform relative results from the NN to absolute values coordinates in
+    // the input image
+    fp_t strideX =
+        CreateFPInt( PERSON_DETECTION_NETWORK_INPUT_DIM.width / gridWidth,
+            ML_ENGINE_OUTPUT_FRAC_BITS );
+    fp_t strideY =
+        CreateFPInt( PERSON_DETECTION_NETWORK_INPUT_DIM.height / gridHeight,
+            ML_ENGINE_OUTPUT_FRAC_BITS );
+    
+    fp_t centerX = CreateFPInt( col, ML_ENGINE_OUTPUT_FRAC_BITS );
+    fp_t centerY = CreateFPInt( row, ML_ENGINE_OUTPUT_FRAC_BITS );
+    
+    fp_t half = CreateFP( 1, 2, ML_ENGINE_OUTPUT_FRAC_BITS );
+    centerX = FPAdd( FPMul( strideX, half), FPMul( strideX, centerX));
+    centerY = FPAdd( FPMul( strideY, half), FPMul( strideY, centerY));
+    
+    anchor_t anchor = {
+        .center = CreateGeometricPoint( centerX, centerY ),
+        .dimensions = { // set to 0x0 (unused with anchor free detection)
+            .width = CreateLiteralFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS ),
+            .height = CreateLiteralFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS )
+        }
+    };
+    return anchor;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the box of the distances of its sides to the anchor center.
+static inline geometric_box_t PersonDetectionRawToBoundingBox(
+    fp_t rawDeltaX, fp_t rawDeltaY, fp_t rawDeltaW, fp_t rawDeltaH,
+    const anchor_t *anchor )
+{    
+    int32_t fracBits = rawDeltaX.fracBits;    
+    fp_t deltaScale =
+        CreateFPInt( PERSON_DETECTION_NETWORK_INPUT_DIM.width / 32, fracBits );
+
+    // Compute the box top left and bottom right coordinates from center
+    fp_t left = FPSub( anchor->center.x, FPMul(rawDeltaX, deltaScale) );
+    fp_t right = FPAdd( anchor->center.x, FPMul(rawDeltaW, deltaScale) );
+    fp_t top = FPSub( anchor->center.y, FPMul(rawDeltaY, deltaScale) );
+    fp_t bottom = FPAdd( anchor->center.y, FPMul(rawDeltaH, deltaScale) );
+    
+    return CreateGeometricBox( left, top, right, bottom );
+}
+
+// Channels of each person detection head
+enum
+{
+    PERSON_DETECTION_CHANNEL_DELTA_X1 = 0,
+    PERSON_DETECTION_CHANNEL_DELTA_Y1,
+    PERSON_DETECTION_CHANNEL_DELTA_X2,
+    PERSON_DETECTION_CHANNEL_DELTA_Y2,
+    PERSON_DETECTION_CHANNEL_CONFIDENCE,
+    PERSON_DETECTION_CHANNEL_FRONTAL,
+    PERSON_DETECTION_CHANNEL_NON_FRONTAL,
+    PERSON_DETECTION_NB_CHANNELS
+};
+
+// Person detection heads, one per grid/level of detection, in the order of
+// the network output: HEAD( name, offset, grid width, grid height )
+#define PERSON_DETECTION_HEADS( HEAD )                                        \
+    HEAD( PersonDetection16x9, 0, 16, 9 )                                     \
+    HEAD( PersonDetection32x18, PersonDetection16x9_SIZE, 32, 18 )
+
+#define DEFINE_PERSON_DETECTION_HEAD( name, offset, gridWidth, gridHeight )   \
+    DEFINE_DETECTION_HEAD( name, offset, gridWidth, gridHeight, 1,            \
+        PERSON_DETECTION_NB_CHANNELS, PERSON_DETECTION_CHANNEL_DELTA_X1,      \
+        PERSON_DETECTION_CHANNEL_CONFIDENCE, ML_ENGINE_OUTPUT_FRAC_BITS,      \
+        PersonDetectionCellToAnchor, PersonDetectionRawToBoundingBox,         \
+        FPSigmoid )
+
+PERSON_DETECTION_HEADS( DEFINE_PERSON_DETECTION_HEAD )
+
+#define COUNT_PERSON_DETECTION_HEAD( name, offset, gridWidth, gridHeight ) + 1
+#define PERSON_DETECTION_NB_HEADS \
+    ( 0 PERSON_DETECTION_HEADS( COUNT_PERSON_DETECTION_HEAD ) )
+
+//-----------------------------------------------------------------------------
+// Reads the raw confidence and the frontal scores of the persons detected by a
+// head, and appends them to the results of all the heads from first.
+static void AppendPersonDetectionAttributes(
+    const int16_t *head,    // First channel of the head
+    int32_t nbOutputs,      // Number of boxes of the head
+    const size_t *indices,  // Indices of the detected persons in the head
+    size_t size,            // Number of detected persons
+    size_t first,           // Position of the first one in the results
+    int16_t *allConfidencesRaw,
+    fp_t *personFrontal,
+    fp_t *personNonFrontal,
+    bool *allIsFrontal )
+{
+    const int16_t *confidenceRaw =
+        head + nbOutputs * PERSON_DETECTION_CHANNEL_CONFIDENCE;
+    fp_postprocessing_config_t frontalConfig = {
+        .dataPtr = head + nbOutputs * PERSON_DETECTION_CHANNEL_FRONTAL,
+        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
+        .rawToFP = FPId
+    };
+    fp_postprocessing_config_t nonFrontalConfig = {
+        .dataPtr = head + nbOutputs * PERSON_DETECTION_CHANNEL_NON_FRONTAL,
+        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
+        .rawToFP = FPId
+    };
+
+    RawToFP( indices, size, &frontalConfig, personFrontal + first );
+    RawToFP( indices, size, &nonFrontalConfig, personNonFrontal + first );
+
+    for( size_t i = first; i < first + size; ++i )
+    {
+        allConfidencesRaw[i] = confidenceRaw[indices[i - first]];
+        allIsFrontal[i] = FPGt( personFrontal[i], personNonFrontal[i] );
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t PersonDetection(
+    uint32_t PERSON_DETECTION_NETWORK_OUTPUT_ADDR,
+    fp_t *confidence,
+    geometric_box_t *boxes,
+    bool *isFrontal,
+    fp_t *isFrontalConfidence,
+    fp_t *isNotFrontalConfidence)
+{
+    const int16_t *output = (const int16_t *)MLIOPointer(PERSON_DETECTION_NETWORK_OUTPUT_ADDR);
+        
+// #ifndef N2STEP_SCALER
+//     scaler_source_image_t personDetectionSource = CreateScalerSourceImage(
+//         0, REGULAR_FRAME_BUFFER_SOURCE_IMAGE_DIM,
+//         0, REGULAR_FRAME_BUFFER_SOURCE_IMAGE_ROI, false);
+// #else
+//     scaler_source_image_t personDetectionSource = CreateScalerSourceImage(
+//         0, SOURCE_IMAGE_DIM,
+//         0, SOURCE_IMAGE_ROI, false);
+// #endif
+
+    // pixel_box_t personDetectionRoI = CreatePixelBox(
+    //     0, 0,
+    //     SOURCE_IMAGE_ROI.dimensions.width,
+    //     SOURCE_IMAGE_ROI.dimensions.height);
+
+    // scaler_output_image_t personDetectionOutput = CreateScalerOutputImage(
+    //     (int32_t)PERSON_DETECTION_NETWORK_INPUT_ADDR,
+    //     PERSON_DETECTION_NETWORK_INPUT_DIM);
+
+    // scaler_config_t personDetectionScalerConfig = CreateScalerConfig(
+    //     personDetectionSource, personDetectionRoI, false, personDetectionOutput);
+
+    fp_range_t personDetectionCoordinateXRange = CreateFPRange(
+        CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
+        CreateFPInt(PERSON_DETECTION_NETWORK_INPUT_DIM.width, ML_ENGINE_OUTPUT_FRAC_BITS));
+
+    fp_range_t personDetectionCoordinateYRange = CreateFPRange(
+        CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
+        CreateFPInt(PERSON_DETECTION_NETWORK_INPUT_DIM.height, ML_ENGINE_OUTPUT_FRAC_BITS));
+
+    fp_range_t sourceCoordinateXRange = CreateFPRange(
+        CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
+        CreateFPInt(SOURCE_IMAGE_WIDTH, ML_ENGINE_OUTPUT_FRAC_BITS));
+
+    fp_range_t sourceCoordinateYRange = CreateFPRange(
+        CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
+        CreateFPInt(SOURCE_IMAGE_HEIGHT, ML_ENGINE_OUTPUT_FRAC_BITS));
+
+    fp_affine_map_t personDetectionToSourceX = CreateFPAffineMap(
+        &personDetectionCoordinateXRange, &sourceCoordinateXRange );
+    fp_affine_map_t personDetectionToSourceY = CreateFPAffineMap(
+        &personDetectionCoordinateYRange, &sourceCoordinateYRange );
+
+    size_t nbPersons, nbPersonsTotal = 0;
+    // Arrays containing results from all the outputs/scale levels
+    size_t allPersonIndices[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    fp_t allConfidences[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    int16_t allConfidencesRaw[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS]; // to be used with QuickSelect() later
+    geometric_box_t allBoxes[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    bool allIsFrontal[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    fp_t personFrontal[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    fp_t personNonFrontal[PERSON_DETECTION_CAP * PERSON_DETECTION_NB_HEADS];
+    
+    // CropAndResizeImage(&personDetectionScalerConfig, true);
+    // if( !WaitForInterrupt(INT_SCALER, 500) )
+    // {
+    //     return 0;
+    // }
+    
+    // // Start PD
+    // RunMLEngine(
+    //     (int32_t)PERSON_DETECTION_NETWORK_FIRMWARE_ADDR,
+    //     (int32_t)PERSON_DETECTION_NETWORK_INPUT_ADDR,
+    //     PERSON_DETECTION_NETWORK_INPUT_DIM.width *
+    //         PERSON_DETECTION_NETWORK_INPUT_DIM.height,
+    //     true);
+    
+    // // Wait for ML engine    
+    // if( !WaitForInterrupt(INT_ML_ENGINE, 500) )
+    // {
+    //     return 0;
+    // }
+    
+    // Postprocess PD, each head, and continue writing the results of a head
+    // from those of the previous ones
+#define POSTPROCESS_PERSON_DETECTION_HEAD( name, offset, gridWidth, gridHeight ) \
+    nbPersons = name##Postprocess(                                            \
+        output,                                                               \
+        PERSON_DETECTION_CAP,                                                 \
+        PERSON_DETECTION_CONFIDENCE_THRESHOLD,                                \
+        CreateFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS ), /* skip NMS for now */  \
+        allPersonIndices,                                                     \
+        &allConfidences[nbPersonsTotal],                                      \
+        &allBoxes[nbPersonsTotal] );                                          \
+    AppendPersonDetectionAttributes(                                          \
+        name##Channel( output, 0 ),                                           \
+        name##_NB_OUTPUTS,                                                    \
+        allPersonIndices,                                                     \
+        nbPersons,                                                            \
+        nbPersonsTotal,                                                       \
+        allConfidencesRaw,                                                    \
+        personFrontal,                                                        \
+        personNonFrontal,                                                     \
+        allIsFrontal );                                                       \
+    nbPersonsTotal += nbPersons;
+
+    PERSON_DETECTION_HEADS( POSTPROCESS_PERSON_DETECTION_HEAD )
+#undef POSTPROCESS_PERSON_DETECTION_HEAD
+    
+    // reset all indices for 2nd pass of filtering on both outputs
+    for( size_t i = 0; i < nbPersonsTotal; ++i )
+    {
+        allPersonIndices[i] = i;
+    }
+    
+    // perform QuickSelect on both outputs
+    QuickSelect( allPersonIndices, nbPersonsTotal, allConfidencesRaw, PERSON_DETECTION_CAP );
+    nbPersonsTotal = nbPersonsTotal > PERSON_DETECTION_CAP ? PERSON_DETECTION_CAP : nbPersonsTotal;
+
+    // copy detections results to output params
+    for( size_t i = 0; i < nbPersonsTotal; ++i )
+    {
+        confidence[i] = allConfidences[allPersonIndices[i]];
+        boxes[i] = allBoxes[allPersonIndices[i]];
+    }
+    
+    // perform NMS on both outputs
+    nbPersonsTotal = FilterOutBelowIoUThreshold(
+        PERSON_DETECTION_NMS_THRESHOLD, 
+        nbPersonsTotal,
+        allPersonIndices,
+        confidence,
+        boxes );        
+    
+    // copy frontal/non-frontal results
+    for( size_t i = 0; i < nbPersonsTotal; ++i )
+    {
+        isFrontal[i] = allIsFrontal[allPersonIndices[i]];
+        isFrontalConfidence[i] = personFrontal[allPersonIndices[i]];
+        isNotFrontalConfidence[i] = personNonFrontal[allPersonIndices[i]];
+    }
+    
+    // Change boxes coordinates to source image coordinate system
+    for (size_t i = 0; i < nbPersonsTotal; ++i)
+    {
+        fp_t left = FPApplyAffine( boxes[i].left, &personDetectionToSourceX );
+        fp_t right = FPApplyAffine( boxes[i].right, &personDetectionToSourceX );
+        fp_t top = FPApplyAffine( boxes[i].top, &personDetectionToSourceY );
+        fp_t bottom = FPApplyAffine( boxes[i].bottom, &personDetectionToSourceY );
+        boxes[i] = CreateGeometricBox( left, top, right, bottom );
+    }
+    
+    return nbPersonsTotal;
+}
\ No newline at end of file
@@ -81,6 +81,7 @@ ideal_user_manager_t CreateIdealUserManager(
 		.similarityRatio = similarityRatio,
 		.idealUserPrefFactor = idealUserPrefFactor,
 		.sourceImageDim = sourceImageDim,
+		.incrementalTracking = false,
 		.MINUS_ONE = CreateFPInt( -1, iouThreshold.fracBits ),
 		.ZERO_VALUE = CreateFPInt( 0, iouThreshold.fracBits ) };
 
@@ -116,29 +117,49 @@ void UpdateIdealFaceBox( ideal_user_manager_t *manager, geometric_box_t box )
 // Search for a geometric_box_t in boxes that match the geometric_box_t 
 // boxToMatch.
 // A box is a match if its intersection over union with boxToMatch is greater
-// than the threshold.
+// than the threshold, both in Q21.10 as with ComputeQ10IoU().
 // The function returns the index of the best match (greater intersection over
-// union) or -1 if no match is found.
+// union, the first one on a tie) or -1 if no match is found.
 int MatchBox(
 	const geometric_box_t *boxes, // List of candidate boxes
 	int32_t boxesNb,              // Number of candidate boxes
 	geometric_box_t boxToMatch,   // The box to match
 	fp_t threshold )              // IoU value beyond which a candidate is kept
 {
-	fp_t bestIoU = CreateFP( 0, 1, boxToMatch.left.fracBits );
+	// The candidates are ranked by their Q10 IoU, the threshold included, so
+	// only a candidate that beats the best one so far has its IoU divided out
+	q10_box_t q10ToMatch = GeometricBoxToQ10( &boxToMatch );
+	q21_10_t bestIoU = FPToQ10( threshold );
 	int bestCandidateIdx = -1;
 	for( int32_t i = 0; i < boxesNb; ++i )
 	{
-		fp_t iou = ComputeGeometricIoU( boxToMatch, boxes[i] );
-		if( FPGt( iou, bestIoU ) && FPGt( iou, threshold ) )
+		if( !GeometricBoxesOverlap( &boxToMatch, &boxes[i] ) )
 		{
-			bestIoU = iou;
+			continue;
+		}
+		q10_box_t q10Candidate = GeometricBoxToQ10( &boxes[i] );
+		if( Q10IoUExceeds( &q10ToMatch, &q10Candidate, bestIoU ) )
+		{
+			bestIoU = ComputeQ10IoU( &q10ToMatch, &q10Candidate );
 			bestCandidateIdx = i;
 		}
 	}
 	return bestCandidateIdx;
 }
 
+//-----------------------------------------------------------------------------
+// Returns the squared distance between the box center and the point, with the
+// fractional bits of the box coordinates.
+static inline int64_t SquaredDistToPoint(
+    const geometric_box_t *box,
+    const geometric_point_2d_t *point )
+{
+    geometric_point_2d_t center = GetGeometricBoxCenter( box );
+    int64_t dx = (int64_t)center.x.n - point->x.n;
+    int64_t dy = (int64_t)center.y.n - point->y.n;
+    return ( dx * dx + dy * dy ) >> box->left.fracBits;
+}
+
 //-----------------------------------------------------------------------------
 // Select a box among detected that is likely to be the more relevant user in
 // image. The function returns the index of the ideal user or size if none is
@@ -156,14 +177,28 @@ size_t SelectIdealUser(
     {
         return size;
     }
-    
+    assert_paranoid( focusPoint->x.fracBits == boxes[0].left.fracBits,
+        EC_FP_NOT_EQUIVALENT, "Focus point and boxes fractional bits differ\r\n" );
+
+    // The ideal user is favored against a new candidate by scaling its area
+    // by idealUserPreferenceCoef and dividing its distance to the focus point
+    // by it. The area ratio and distance comparisons are cross-multiplied,
+    // so all the terms are scaled by 2^coefBits, and the distances compared
+    // squared:
+    //  |currentArea - idealAreaFavored| < areaRatioThreshold * idealAreaFavored
+    //  currentDist^2 * coef^2 < idealDist^2
+    int32_t coefBits = idealUserPreferenceCoef.fracBits;
+    int32_t thresholdBits = areaRatioThreshold.fracBits;
+    int64_t coefSquared =
+        (int64_t)idealUserPreferenceCoef.n * idealUserPreferenceCoef.n;
+
     // if we have a previous ideal user id, we start with it as reference    
     size_t idealIdx = currentIdealUserIdx < size ? currentIdealUserIdx : 0;
-    fp_t idealArea = ComputeGeometricArea( boxes[idealIdx] );
-    geometric_point_2d_t currentCenter =
-        GetGeometricBoxCenter( &boxes[idealIdx] );
-    fp_t idealDistToCenter = VectorNorm2d(
-        CreateGeometricVector2d( currentCenter, *focusPoint ) );        
+    int64_t idealAreaFavored = (int64_t)ComputeGeometricArea(
+        boxes[idealIdx] ).n * idealUserPreferenceCoef.n;
+    int64_t areaDeltaThreshold = idealAreaFavored * areaRatioThreshold.n;
+    int64_t idealDistSquared =
+        SquaredDistToPoint( &boxes[idealIdx], focusPoint ) << ( 2 * coefBits );
 
     for( size_t i = 0; i < size ; ++i )
     {
@@ -173,31 +208,28 @@ size_t SelectIdealUser(
         }
         else
         {
-            fp_t currentArea = ComputeGeometricArea( boxes[i] );
-            geometric_point_2d_t currentCenter = GetGeometricBoxCenter( &boxes[i] );
-            fp_t currentDistToCenter = VectorNorm2d(
-                CreateGeometricVector2d( currentCenter, *focusPoint ) );
-            
-            // these values are scaled to favor against the new candidate
-            fp_t idealAreaFavored = 
-                FPMul(idealArea, idealUserPreferenceCoef);
-            fp_t idealDistToCenterFavored =
-                FPDiv( idealDistToCenter, idealUserPreferenceCoef) ;
-            fp_t currentAreaToIdealRatio = FPDiv(
-                FPSub( currentArea, idealAreaFavored ), idealAreaFavored );
-            bool areaSimilar = FPLt(
-                FPAbs( currentAreaToIdealRatio ), areaRatioThreshold );
+            int64_t currentArea =
+                (int64_t)ComputeGeometricArea( boxes[i] ).n << coefBits;
+            int64_t currentDistSquared =
+                SquaredDistToPoint( &boxes[i], focusPoint );
+
+            // these values are scaled by 2^thresholdBits, as the threshold
+            int64_t areaDelta =
+                ( currentArea - idealAreaFavored ) * ( 1 << thresholdBits );
+            bool areaSimilar = areaDelta < areaDeltaThreshold &&
+                -areaDelta < areaDeltaThreshold;
             bool closestToIdeal =
-                FPLt( currentDistToCenter, idealDistToCenterFavored );
-            bool currentAreaIsBigger =
-                FPGt( currentAreaToIdealRatio, areaRatioThreshold );
+                currentDistSquared * coefSquared < idealDistSquared;
+            bool currentAreaIsBigger = areaDelta > areaDeltaThreshold;
             bool betterCandidate =
                 ( areaSimilar && closestToIdeal ) || currentAreaIsBigger;
             if ( betterCandidate)
             {
                 idealIdx = i;
-                idealArea = currentArea;
-                idealDistToCenter = currentDistToCenter;
+                idealAreaFavored = ( currentArea >> coefBits ) *
+                    idealUserPreferenceCoef.n;
+                areaDeltaThreshold = idealAreaFavored * areaRatioThreshold.n;
+                idealDistSquared = currentDistSquared << ( 2 * coefBits );
             }
         }
     }
@@ -208,7 +240,9 @@ size_t SelectIdealUser(
 // Checks if the boxes at indices user1 and user2 in arrays boxes1 and boxes2
 // bound or not the same user.
 // If the IoU of the two boxes is greater than threshold, the functions returns
-// true, otherwise it returns false.
+// true, otherwise it returns false. The test is IoUExceeds(), in Q21.10 and
+// strict: it used to be IoU >= threshold, an IoU equal to threshold no longer
+// makes the same user.
 // If user1 or user2 is negative, the functions returns false.
 // It is assumed user1 and user2 values are lessert than the size of array1 and
 // array2.
@@ -218,8 +252,7 @@ bool AreSameUser(
 	fp_t threshold )             // Value over which the two users are
 	                             // said to be identical
 {
-    fp_t iou = ComputeGeometricIoU( *box1, *box2 );
-    return FPGe( iou, threshold );
+    return IoUExceeds( box1, box2, threshold );
 }
 
 //-----------------------------------------------------------------------------
@@ -267,12 +300,50 @@ int MergeBoxes( ideal_user_manager_t *manager, geometric_box_t *boxes,
 	return boxCount;
 }
 
+//-----------------------------------------------------------------------------
+// Keeps the current ideal user if it matches one of the saved boxes, without
+// scoring the other candidates. Returns true if the ideal user was kept,
+// false if all the candidates have to be scored.
+static bool TrackIdealUser( ideal_user_manager_t *manager )
+{
+	if( !manager->idealUserAvailable )
+	{
+		return false;
+	}
+
+	geometric_box_t scaledBox = NormalizeBoxToCommonScale(
+		manager->idealUserBox,
+		manager->detectionBoxSize,
+		manager->ZERO_VALUE );
+	int matchIdx = MatchBox( manager->savedBoxes, manager->savedBoxesNb,
+		scaledBox, manager->iouThreshold );
+	if( matchIdx < 0 )
+	{
+		return false;
+	}
+
+	// Same outcome as a full update selecting the matched box again
+	manager->idealUserChangedSinceLastQuery = false;
+	manager->detectionBoxSize = (fp_dim_t) {
+		.width = GetGeometricBoxWidth( &manager->savedBoxes[matchIdx] ),
+		.height = GetGeometricBoxHeight( &manager->savedBoxes[matchIdx] )
+	};
+	manager->idealUserInSavedBoxesIdx = matchIdx;
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // Updates the ideal user for this time step.
 // The ideal user may not change or there may be no new ideal user.
 // It is assumed the boxes array size is boxesNb.
 void UpdateIdealUser( ideal_user_manager_t *manager )
 {
+    // A re-detected ideal user is kept as is in incremental tracking
+    if( manager->incrementalTracking && TrackIdealUser( manager ) )
+    {
+        return;
+    }
+
     // Create boxes normalized to a common scale for evaluation purposes
 	// The array can contain one element more than the number of detected users
 	// since the ideal user may not have been detected during latest face detection.
@@ -381,6 +452,15 @@ void UpdateIdealUserManagerCandidates(
 	StoreCandidates( manager, boxes, boxesNb );
 }
 
+//-----------------------------------------------------------------------------
+//
+void SetIdealUserIncrementalTracking(
+	ideal_user_manager_t *manager,
+	bool enabled )
+{
+	manager->incrementalTracking = enabled;
+}
+
 //-----------------------------------------------------------------------------
 //
 bool IdealUserChangedSinceLastQuery( ideal_user_manager_t *manager )
@@ -56,6 +56,8 @@ typedef struct
 	bool idealUserChangedSinceLastQuery; // Track changes to ideal user
 	int32_t idealUserInSavedBoxesIdx; // If the ideal user is in detected users,
 	                                 // its index. Kept for convenience.
+	bool incrementalTracking;   // Keep a re-detected ideal user without
+	                            // scoring the other candidates
 
 	fp_t MINUS_ONE;       // Constant for convenience
 	fp_t ZERO_VALUE;      // Constant for convenience
@@ -88,6 +90,16 @@ void UpdateIdealUserManagerCandidates(
 // It is assumed the boxes array size is boxesNb.
 void UpdateIdealUser( ideal_user_manager_t *manager );
 
+// Enables or disables the incremental tracking of the ideal user, disabled
+// by default. When enabled, UpdateIdealUser first matches the current ideal
+// user against the saved boxes with an IoU test, and keeps it without scoring
+// the other candidates when it is found. All the candidates are scored only
+// when the ideal user is not re-detected, or when there is none. A new
+// candidate can then no longer take over a re-detected ideal user.
+void SetIdealUserIncrementalTracking(
+	ideal_user_manager_t *manager, // Ideal user manager to be updated
+	bool enabled );                // True to enable incremental tracking
+
 // Removes the face box associated with the current ideal user from the list
 // of saved boxes
 void RemoveIdealUser( ideal_user_manager_t *manager );
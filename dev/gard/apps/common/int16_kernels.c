@@ -0,0 +1,256 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "int16_kernels.h"
+#include "utils.h"
+
+#if INT16_KERNELS_RVV
+#include <riscv_vector.h>
+#endif
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT int64_t Int16DotProduct(
+    const int16_t *a,
+    const int16_t *b,
+    size_t size )
+{
+#if INT16_KERNELS_RVV
+    // Widening products to 32 bits, reduced into a 64-bit sum
+    vint64m1_t sum = __riscv_vmv_s_x_i64m1( 0, 1 );
+    while( size > 0 )
+    {
+        size_t vl = __riscv_vsetvl_e16m1( size );
+        vint16m1_t va = __riscv_vle16_v_i16m1( a, vl );
+        vint16m1_t vb = __riscv_vle16_v_i16m1( b, vl );
+        vint32m2_t products = __riscv_vwmul_vv_i32m2( va, vb, vl );
+        sum = __riscv_vwredsum_vs_i32m2_i64m1( products, sum, vl );
+        a += vl;
+        b += vl;
+        size -= vl;
+    }
+    return __riscv_vmv_x_s_i64m1_i64( sum );
+#else
+    int64_t sum = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        sum += ( int32_t )a[i] * ( int32_t )b[i];
+    }
+    return sum;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT size_t Int16ArgMax(
+    const int16_t *data,
+    size_t stride,
+    size_t size )
+{
+#if INT16_KERNELS_RVV
+    int16_t maxValue = data[0];
+    size_t maxIndex = 0;
+    size_t first = 0;
+    while( first < size )
+    {
+        size_t vl = __riscv_vsetvl_e16m1( size - first );
+        vint16m1_t values = __riscv_vlse16_v_i16m1(
+            &data[first * stride], stride * sizeof( int16_t ), vl );
+        int16_t chunkMax = __riscv_vmv_x_s_i16m1_i16(
+            __riscv_vredmax_vs_i16m1_i16m1(
+                values, __riscv_vmv_s_x_i16m1( INT16_MIN, 1 ), vl ) );
+
+        // Only a strictly greater value moves the position, so that the first
+        // of equal values is kept
+        if( chunkMax > maxValue )
+        {
+            vbool16_t isMax = __riscv_vmseq_vx_i16m1_b16( values, chunkMax, vl );
+            maxValue = chunkMax;
+            maxIndex = first + __riscv_vfirst_m_b16( isMax, vl );
+        }
+        first += vl;
+    }
+    return maxIndex;
+#else
+    int16_t maxValue = data[0];
+    size_t maxIndex = 0;
+    for( size_t i = 1; i < size; ++i )
+    {
+        if( data[i * stride] > maxValue )
+        {
+            maxValue = data[i * stride];
+            maxIndex = i;
+        }
+    }
+    return maxIndex;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT size_t Int16CompactAboveThreshold(
+    const int16_t *data,
+    size_t size,
+    int32_t threshold,
+    size_t *indices )
+{
+    if( threshold >= INT16_MAX )
+    {
+        return 0;
+    }
+    if( threshold < INT16_MIN )
+    {
+        // Compare to INT16_MIN - 1 without leaving the int16 range
+        for( size_t i = 0; i < size; ++i )
+        {
+            indices[i] = i;
+        }
+        return size;
+    }
+
+#if INT16_KERNELS_RVV
+    // size_t is 32 bits on RV32, the positions are compressed as uint32
+    size_t count = 0;
+    size_t first = 0;
+    while( first < size )
+    {
+        size_t vl = __riscv_vsetvl_e16m1( size - first );
+        vint16m1_t values = __riscv_vle16_v_i16m1( &data[first], vl );
+        vbool16_t isAbove =
+            __riscv_vmsgt_vx_i16m1_b16( values, ( int16_t )threshold, vl );
+        vuint32m2_t positions = __riscv_vadd_vx_u32m2(
+            __riscv_vid_v_u32m2( vl ), ( uint32_t )first, vl );
+        vuint32m2_t kept = __riscv_vcompress_vm_u32m2( positions, isAbove, vl );
+        size_t keptNb = __riscv_vcpop_m_b16( isAbove, vl );
+        __riscv_vse32_v_u32m2( ( uint32_t * )&indices[count], kept, keptNb );
+        count += keptNb;
+        first += vl;
+    }
+    return count;
+#else
+    size_t count = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        if( data[i] > threshold )
+        {
+            indices[count++] = i;
+        }
+    }
+    return count;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT size_t Int8ArgMax(
+    const int8_t *data,
+    size_t stride,
+    size_t size )
+{
+#if INT16_KERNELS_RVV
+    int8_t maxValue = data[0];
+    size_t maxIndex = 0;
+    size_t first = 0;
+    while( first < size )
+    {
+        size_t vl = __riscv_vsetvl_e8m1( size - first );
+        vint8m1_t values = __riscv_vlse8_v_i8m1(
+            &data[first * stride], stride * sizeof( int8_t ), vl );
+        int8_t chunkMax = __riscv_vmv_x_s_i8m1_i8(
+            __riscv_vredmax_vs_i8m1_i8m1(
+                values, __riscv_vmv_s_x_i8m1( INT8_MIN, 1 ), vl ) );
+
+        // Only a strictly greater value moves the position, so that the first
+        // of equal values is kept
+        if( chunkMax > maxValue )
+        {
+            vbool8_t isMax = __riscv_vmseq_vx_i8m1_b8( values, chunkMax, vl );
+            maxValue = chunkMax;
+            maxIndex = first + __riscv_vfirst_m_b8( isMax, vl );
+        }
+        first += vl;
+    }
+    return maxIndex;
+#else
+    int8_t maxValue = data[0];
+    size_t maxIndex = 0;
+    for( size_t i = 1; i < size; ++i )
+    {
+        if( data[i * stride] > maxValue )
+        {
+            maxValue = data[i * stride];
+            maxIndex = i;
+        }
+    }
+    return maxIndex;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT size_t Int8CompactAboveThreshold(
+    const int8_t *data,
+    size_t size,
+    int32_t threshold,
+    size_t *indices )
+{
+    if( threshold >= INT8_MAX )
+    {
+        return 0;
+    }
+    if( threshold < INT8_MIN )
+    {
+        // Compare to INT8_MIN - 1 without leaving the int8 range
+        for( size_t i = 0; i < size; ++i )
+        {
+            indices[i] = i;
+        }
+        return size;
+    }
+
+#if INT16_KERNELS_RVV
+    // size_t is 32 bits on RV32, the positions are compressed as uint32
+    size_t count = 0;
+    size_t first = 0;
+    while( first < size )
+    {
+        size_t vl = __riscv_vsetvl_e8m1( size - first );
+        vint8m1_t values = __riscv_vle8_v_i8m1( &data[first], vl );
+        vbool8_t isAbove =
+            __riscv_vmsgt_vx_i8m1_b8( values, ( int8_t )threshold, vl );
+        vuint32m4_t positions = __riscv_vadd_vx_u32m4(
+            __riscv_vid_v_u32m4( vl ), ( uint32_t )first, vl );
+        vuint32m4_t kept = __riscv_vcompress_vm_u32m4( positions, isAbove, vl );
+        size_t keptNb = __riscv_vcpop_m_b8( isAbove, vl );
+        __riscv_vse32_v_u32m4( ( uint32_t * )&indices[count], kept, keptNb );
+        count += keptNb;
+        first += vl;
+    }
+    return count;
+#else
+    size_t count = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        if( data[i] > threshold )
+        {
+            indices[count++] = i;
+        }
+    }
+    return count;
+#endif
+}
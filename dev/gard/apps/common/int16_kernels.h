@@ -0,0 +1,80 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef INT16_KERNELS_H
+#define INT16_KERNELS_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=============================================================================
+// C O N S T A N T S
+
+// The int16 kernels, and their int8 versions, use the RISC-V vector extension
+// when the compiler targets it with 64-bit elements (-march=..._v or _zve64x) on RV32, unless
+// INT16_KERNELS_SCALAR is defined. Otherwise they are plain C loops.
+#if !defined( INT16_KERNELS_SCALAR ) && defined( __riscv_vector ) && \
+    defined( __riscv_v_intrinsic ) && defined( __riscv_v_elen ) && \
+    __riscv_v_elen >= 64 && __riscv_xlen == 32
+#define INT16_KERNELS_RVV 1
+#else
+#define INT16_KERNELS_RVV 0
+#endif
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+//----------------------------------------------------------------------------
+// Computes the dot product of two int16 vectors of size elements.
+int64_t Int16DotProduct(
+    const int16_t *a, // First vector
+    const int16_t *b, // Second vector
+    size_t size );    // Number of elements of the vectors
+
+//----------------------------------------------------------------------------
+// Returns the position of the greatest of size int16 values, the first one if
+// several are equal. The values are stride elements apart, e.g. the planes of
+// a network output. size is assumed to be greater than 0.
+size_t Int16ArgMax(
+    const int16_t *data, // First value
+    size_t stride,       // Distance between two values, in elements
+    size_t size );       // Number of values
+
+//----------------------------------------------------------------------------
+// Writes to indices, in increasing order, the positions of the values of data
+// greater than threshold, and returns their number.
+// It is assumed that indices points to an array of size elements.
+size_t Int16CompactAboveThreshold(
+    const int16_t *data, // Values to compare
+    size_t size,         // Number of values
+    int32_t threshold,   // Values lesser than or equal to it are left out
+    size_t *indices );   // Positions of the values above threshold
+
+//----------------------------------------------------------------------------
+// Same as Int16ArgMax(), for int8 values, e.g. of networks with 8-bit outputs.
+size_t Int8ArgMax(
+    const int8_t *data, // First value
+    size_t stride,      // Distance between two values, in elements
+    size_t size );      // Number of values
+
+//----------------------------------------------------------------------------
+// Same as Int16CompactAboveThreshold(), for int8 values.
+size_t Int8CompactAboveThreshold(
+    const int8_t *data, // Values to compare
+    size_t size,        // Number of values
+    int32_t threshold,  // Values lesser than or equal to it are left out
+    size_t *indices );  // Positions of the values above threshold
+
+#endif
@@ -0,0 +1,103 @@
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "isqrt.h"
+
+#include "app_assert.h"
+#include "errors.h"
+
+//=============================================================================
+// C O N S T A N T S
+
+// 256 * sqrt( m + 0.5 ) rounded, for m from 64 to 255: the seed of the Newton
+// step for the 8 leading bits m of the operand, shifted by an even number of
+// bits. Its relative error is below 2^-8, so one Newton step gets the 16 bits
+// of a 32-bit square root to within 1.
+static const uint16_t sqrtSeed[192] =
+{
+    2056, 2072, 2088, 2103, 2119, 2134, 2149, 2165, 2180, 2195, 2210, 2224,
+    2239, 2254, 2268, 2283, 2297, 2311, 2325, 2339, 2353, 2367, 2381, 2395,
+    2408, 2422, 2435, 2449, 2462, 2475, 2489, 2502, 2515, 2528, 2541, 2554,
+    2566, 2579, 2592, 2604, 2617, 2629, 2642, 2654, 2667, 2679, 2691, 2703,
+    2715, 2727, 2739, 2751, 2763, 2775, 2787, 2798, 2810, 2822, 2833, 2845,
+    2856, 2868, 2879, 2891, 2902, 2913, 2924, 2936, 2947, 2958, 2969, 2980,
+    2991, 3002, 3013, 3024, 3034, 3045, 3056, 3067, 3077, 3088, 3099, 3109,
+    3120, 3130, 3141, 3151, 3161, 3172, 3182, 3192, 3203, 3213, 3223, 3233,
+    3243, 3253, 3263, 3273, 3283, 3293, 3303, 3313, 3323, 3333, 3343, 3353,
+    3362, 3372, 3382, 3391, 3401, 3411, 3420, 3430, 3439, 3449, 3458, 3468,
+    3477, 3487, 3496, 3505, 3515, 3524, 3533, 3543, 3552, 3561, 3570, 3579,
+    3589, 3598, 3607, 3616, 3625, 3634, 3643, 3652, 3661, 3670, 3679, 3688,
+    3697, 3705, 3714, 3723, 3732, 3741, 3749, 3758, 3767, 3775, 3784, 3793,
+    3801, 3810, 3819, 3827, 3836, 3844, 3853, 3861, 3870, 3878, 3887, 3895,
+    3903, 3912, 3920, 3929, 3937, 3945, 3954, 3962, 3970, 3978, 3987, 3995,
+    4003, 4011, 4019, 4027, 4036, 4044, 4052, 4060, 4068, 4076, 4084, 4092,
+};
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+// floor( sqrt( n ) ) of an unsigned 32-bit integer.
+//
+// The operand is normalised with a count of leading zeros, a single clz with
+// Zbb on RV32, the seed is read from sqrtSeed and refined by one Newton step.
+// A Newton step never goes below floor( sqrt( n ) ), so the result is at most
+// one too large and a compare fixes it. There are no loops and a single
+// division.
+static uint32_t ISqrt32( uint32_t n )
+{
+    if( n == 0 )
+    {
+        return 0;
+    }
+
+    // Even shift bringing the 8 leading bits in [64, 256), left for n < 64
+    int32_t shift = ( ( int32_t )( 32 - __builtin_clz( n ) ) - 7 ) & ~1;
+    uint32_t m = shift >= 0 ? n >> shift : n << -shift;
+    int32_t seedShift = shift / 2 - 8;
+    uint32_t x = sqrtSeed[m - 64];
+
+    x = seedShift >= 0 ? x << seedShift : x >> -seedShift;
+    x = ( x + n / x ) >> 1;
+
+    // 65536 * 65536 does not fit, and is never the result
+    x = x > UINT16_MAX ? UINT16_MAX : x;
+    x -= x * x > n ? 1 : 0;
+    return x;
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t ISqrt( int32_t n )
+{
+	assert( n >= 0, EC_NEGATIVE_VALUE,
+	    "Can't extract the sqrt of negative number: %d\r\n", n );
+
+    return ( int32_t )ISqrt32( ( uint32_t )n );
+}
+
+
+//-----------------------------------------------------------------------------
+// Above 32 bits, the square root r of the 32 leading bits, shifted by an even
+// number of bits, gives the 16 leading bits of the result and seeds one
+// Newton step, which gets the 32 bits to within 1.
+uint32_t ISqrt64(uint64_t n)
+{
+    if( n <= UINT32_MAX )
+    {
+        return ISqrt32( ( uint32_t )n );
+    }
+
+    // Even shift bringing the 32 leading bits in [2^30, 2^32)
+    uint32_t shift = ( uint32_t )( 64 - __builtin_clzll( n ) - 31 ) & ~1u;
+    uint32_t r = ISqrt32( ( uint32_t )( n >> shift ) );
+
+    // sqrt( n ) is in [r, r + 1) * 2^(shift / 2), seed with the middle
+    uint64_t x = ( ( uint64_t )( 2 * r + 1 ) ) << ( shift / 2 - 1 );
+    x = ( x + n / x ) >> 1;
+
+    // 2^32 * 2^32 does not fit, and is never the result
+    x = x > UINT32_MAX ? UINT32_MAX : x;
+    x -= x * x > n ? 1 : 0;
+    return ( uint32_t )x;
+}
@@ -22,6 +22,16 @@
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
 
+//-----------------------------------------------------------------------------
+// Returns the box of raw coordinates extents, of fracBits fractional bits.
+static inline geometric_box_t BoxFromExtents(
+	int32_t left, int32_t top, int32_t right, int32_t bottom, uint8_t fracBits )
+{
+	return CreateGeometricBox(
+		InterpretIntAsFP( left, fracBits ), InterpretIntAsFP( top, fracBits ),
+		InterpretIntAsFP( right, fracBits ), InterpretIntAsFP( bottom, fracBits ) );
+}
+
 //-----------------------------------------------------------------------------
 //
 geometric_point_2d_t LandmarksMean2dFaceFit(
@@ -29,17 +39,21 @@ geometric_point_2d_t LandmarksMean2dFaceFit(
 	const uint8_t *indices,				// indices of the relevant landmarks
 	size_t indicesNb )					// number of indices
 {
-	geometric_point_2d_t mean = GetLandmark2dFaceFit( landmarks, indices[0] );
+	// All landmarks share landmarks->fracBits, the coordinates are summed
+	// as they are
+	int32_t sumX = 0;
+	int32_t sumY = 0;
 
-	for( size_t i = 1; i < indicesNb; ++i )
+	for( size_t i = 0; i < indicesNb; ++i )
 	{
-		geometric_point_2d_t landmark = GetLandmark2dFaceFit( landmarks, indices[i] );
-		mean.x = FPAdd( mean.x, landmark.x );
-		mean.y = FPAdd( mean.y, landmark.y );
+		sumX += landmarks->x[indices[i]];
+		sumY += landmarks->y[indices[i]];
 	}
 
-	mean.x.n /= (int) indicesNb;
-	mean.y.n /= (int) indicesNb;
+	geometric_point_2d_t mean = {
+		.x = InterpretIntAsFP( sumX / (int) indicesNb, landmarks->fracBits ),
+		.y = InterpretIntAsFP( sumY / (int) indicesNb, landmarks->fracBits )
+	};
 	return mean;
 }
 
@@ -136,11 +150,15 @@ void PopulateLandmarks2d( landmarks_2d_facefit_t *landmarks, size_t landmarksNb,
 void TranslateLandmarks2dFaceFit(
 	landmarks_2d_facefit_t *landmarks, size_t pointsNb, geometric_vector_2d_t vector )
 {
+	assert( vector.x.fracBits == landmarks->fracBits &&
+		vector.y.fracBits == landmarks->fracBits, EC_FP_NOT_EQUIVALENT,
+		"Translation fracbits != landmarks fracbits: %d %d\r\n",
+		vector.x.fracBits, landmarks->fracBits );
+
 	for( size_t i = 0; i < pointsNb; ++i )
 	{
-		geometric_point_2d_t landmark = GetLandmark2dFaceFit( landmarks, i);
-		landmark = TranslateGeometricPoint2d( landmark, vector );
-		SetLandmark2dFaceFit( landmarks, i, landmark );
+		landmarks->x[i] += vector.x.n;
+		landmarks->y[i] += vector.y.n;
 	}
 }
 
@@ -165,28 +183,22 @@ geometric_box_t BoxFromLandmarks(
 {
 	assert( landmarksNb > 0, EC_NEGATIVE_OR_ZERO,
 	    "landmarks nb. is less or equal to 0\r\n" );
-	
-	geometric_point_2d_t landmark = GetLandmark2dFaceFit( landmarks, 0);
 
-	fp_t left = landmark.x;
-	fp_t top = landmark.y;
-	fp_t right = landmark.x;
-	fp_t bottom = landmark.y;
+	int32_t left = landmarks->x[0];
+	int32_t top = landmarks->y[0];
+	int32_t right = landmarks->x[0];
+	int32_t bottom = landmarks->y[0];
 
 	for( size_t i = 1; i < landmarksNb; ++i )
 	{
-		landmark = GetLandmark2dFaceFit( landmarks, i );
-		left = FPLt( left, landmark.x ) ?
-			left : landmark.x;
-		right = FPLt( right, landmark.x ) ?
-			landmark.x : right;
-		top = FPLt( top, landmark.y ) ?
-			top : landmark.y;
-		bottom = FPLt( bottom, landmark.y ) ?
-			landmark.y : bottom;
+		int32_t x = landmarks->x[i];
+		int32_t y = landmarks->y[i];
+		left = x < left ? x : left;
+		right = x > right ? x : right;
+		top = y < top ? y : top;
+		bottom = y > bottom ? y : bottom;
 	}
-	geometric_box_t bbox = CreateGeometricBox( left, top, right, bottom );
-	return bbox;
+	return BoxFromExtents( left, top, right, bottom, landmarks->fracBits );
 }
 
 //----------------------------------------------------------------------------
@@ -198,28 +210,75 @@ geometric_box_t BoxFromSubLandmarks(
 {
 	assert( indicesNb > 0, EC_NEGATIVE_OR_ZERO,
 		"Indices nb. is less or equal to 0\r\n" );
-	
-	geometric_point_2d_t landmark = GetLandmark2dFaceFit( landmarks, indices[0] );
 
-	fp_t left = landmark.x;
-	fp_t top = landmark.y;
-	fp_t right = landmark.x;
-	fp_t bottom = landmark.y;
+	int32_t left = landmarks->x[indices[0]];
+	int32_t top = landmarks->y[indices[0]];
+	int32_t right = left;
+	int32_t bottom = top;
 
-	for( size_t i = 0; i < indicesNb; ++i )
+	for( size_t i = 1; i < indicesNb; ++i )
+	{
+		int32_t x = landmarks->x[indices[i]];
+		int32_t y = landmarks->y[indices[i]];
+		left = x < left ? x : left;
+		right = x > right ? x : right;
+		top = y < top ? y : top;
+		bottom = y > bottom ? y : bottom;
+	}
+	return BoxFromExtents( left, top, right, bottom, landmarks->fracBits );
+}
+
+//----------------------------------------------------------------------------
+//
+landmarks_2d_stats_t Landmarks2dStatsFaceFit(
+	landmarks_2d_facefit_t *landmarks,
+	size_t landmarksNb,
+	const geometric_vector_2d_t *translation )
+{
+	assert( landmarksNb > 0, EC_NEGATIVE_OR_ZERO,
+	    "landmarks nb. is less or equal to 0\r\n" );
+
+	int32_t dx = 0;
+	int32_t dy = 0;
+	if( translation != NULL )
 	{
-		landmark = GetLandmark2dFaceFit( landmarks, indices[i] );
-		left = FPLt( left, landmark.x ) ?
-			left : landmark.x;
-		top = FPLt( top, landmark.y ) ?
-			top : landmark.y;
-		right = FPLt( right, landmark.x ) ?
-			landmark.x : right;
-		bottom = FPLt( bottom, landmark.y ) ?
-			landmark.y : bottom;
+		assert( translation->x.fracBits == landmarks->fracBits &&
+			translation->y.fracBits == landmarks->fracBits, EC_FP_NOT_EQUIVALENT,
+			"Translation fracbits != landmarks fracbits: %d %d\r\n",
+			translation->x.fracBits, landmarks->fracBits );
+		dx = translation->x.n;
+		dy = translation->y.n;
 	}
-	geometric_box_t bbox = CreateGeometricBox( left, top, right, bottom );
-	return bbox;
+
+	int32_t left = INT32_MAX;
+	int32_t top = INT32_MAX;
+	int32_t right = INT32_MIN;
+	int32_t bottom = INT32_MIN;
+	int32_t sumX = 0;
+	int32_t sumY = 0;
+
+	// Adding a zero translation costs less than a second loop, and keeps the
+	// landmarks read and written once
+	for( size_t i = 0; i < landmarksNb; ++i )
+	{
+		int32_t x = landmarks->x[i] + dx;
+		int32_t y = landmarks->y[i] + dy;
+		landmarks->x[i] = x;
+		landmarks->y[i] = y;
+		sumX += x;
+		sumY += y;
+		left = x < left ? x : left;
+		right = x > right ? x : right;
+		top = y < top ? y : top;
+		bottom = y > bottom ? y : bottom;
+	}
+
+	landmarks_2d_stats_t stats = {
+		.mean = {
+			.x = InterpretIntAsFP( sumX / (int) landmarksNb, landmarks->fracBits ),
+			.y = InterpretIntAsFP( sumY / (int) landmarksNb, landmarks->fracBits ) },
+		.box = BoxFromExtents( left, top, right, bottom, landmarks->fracBits ) };
+	return stats;
 }
 
 //-----------------------------------------------------------------------------
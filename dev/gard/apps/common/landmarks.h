@@ -44,6 +44,18 @@ FP_LANDMARKS( DEFAULT_LANDMARKS_NB, facefit ); // struct with all landmarks for
 FP_LANDMARKS( ROUGH_LANDMARKS_NB, facedet ); // struct with a reduced number of landmarks for face detection
 FP_LANDMARKS( EYELID_MIDDLE_INDICES_LEN, eyelid ); // struct with eyelid landmarks
 
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Mean and bounding box of a landmarks list, see Landmarks2dStatsFaceFit()
+typedef struct
+{
+	geometric_point_2d_t mean;
+	geometric_box_t box;
+} landmarks_2d_stats_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
 
 //-----------------------------------------------------------------------------
 // Computes the mean of multiple landmarks.
@@ -110,6 +122,19 @@ geometric_box_t BoxFromSubLandmarks(
 	const landmarks_2d_facefit_t *landmarks, // List of landmarks
 	size_t indicesNb);                   // Number of landmarks to enclose
 
+// Computes the mean and the bounding box of a landmarks list in a single
+// pass, translating the landmarks first if translation is not NULL. This
+// replaces TranslateLandmarks2dFaceFit(), LandmarksMean2dFaceFit() on all the
+// landmarks and BoxFromLandmarks(), which each read the whole list.
+// Fixed point representation of the results uses the same number of
+// fractional bits as the landmarks.
+// It is assumed that landmarksNb is greater than 0 and that the translation
+// uses the same number of fractional bits as the landmarks.
+landmarks_2d_stats_t Landmarks2dStatsFaceFit(
+	landmarks_2d_facefit_t *landmarks,         // Landmarks, translated in place
+	size_t landmarksNb,                        // Number of landmarks
+	const geometric_vector_2d_t *translation ); // Translation, or NULL
+
 void DebugOutputLandmarks2D( landmarks_2d_facefit_t *landmarks, size_t landmarksNb );
 
 void DebugOutputLandmarks3D( landmarks_3d_facefit_t *landmarks, size_t landmarksNb );
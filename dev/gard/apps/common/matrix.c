@@ -19,9 +19,87 @@
 #include "debug.h"
 #include "errors.h"
 
+//=============================================================================
+// M A C R O S
+
+// Sum of products of row i of op1 by column j of op2, n x n dense matrices
+#define DOT2( op1, op2, i, j ) \
+    ( ( int64_t )op1[2 * i] * op2[j] + ( int64_t )op1[2 * i + 1] * op2[2 + j] )
+
+#define DOT3( op1, op2, i, j ) \
+    ( ( int64_t )op1[3 * i] * op2[j] + \
+      ( int64_t )op1[3 * i + 1] * op2[3 + j] + \
+      ( int64_t )op1[3 * i + 2] * op2[6 + j] )
+
+#define DOT6( op1, op2, i, j ) \
+    ( ( int64_t )op1[6 * i] * op2[j] + \
+      ( int64_t )op1[6 * i + 1] * op2[6 + j] + \
+      ( int64_t )op1[6 * i + 2] * op2[12 + j] + \
+      ( int64_t )op1[6 * i + 3] * op2[18 + j] + \
+      ( int64_t )op1[6 * i + 4] * op2[24 + j] + \
+      ( int64_t )op1[6 * i + 5] * op2[30 + j] )
+
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
 
+//-----------------------------------------------------------------------------
+//
+void MatMul2x2(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift )
+{
+    res[0] = ( int32_t )( DOT2( op1, op2, 0, 0 ) >> shift );
+    res[1] = ( int32_t )( DOT2( op1, op2, 0, 1 ) >> shift );
+    res[2] = ( int32_t )( DOT2( op1, op2, 1, 0 ) >> shift );
+    res[3] = ( int32_t )( DOT2( op1, op2, 1, 1 ) >> shift );
+}
+
+//-----------------------------------------------------------------------------
+//
+void MatMul3x3(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift )
+{
+    res[0] = ( int32_t )( DOT3( op1, op2, 0, 0 ) >> shift );
+    res[1] = ( int32_t )( DOT3( op1, op2, 0, 1 ) >> shift );
+    res[2] = ( int32_t )( DOT3( op1, op2, 0, 2 ) >> shift );
+    res[3] = ( int32_t )( DOT3( op1, op2, 1, 0 ) >> shift );
+    res[4] = ( int32_t )( DOT3( op1, op2, 1, 1 ) >> shift );
+    res[5] = ( int32_t )( DOT3( op1, op2, 1, 2 ) >> shift );
+    res[6] = ( int32_t )( DOT3( op1, op2, 2, 0 ) >> shift );
+    res[7] = ( int32_t )( DOT3( op1, op2, 2, 1 ) >> shift );
+    res[8] = ( int32_t )( DOT3( op1, op2, 2, 2 ) >> shift );
+}
+
+//-----------------------------------------------------------------------------
+// Only the dot products are unrolled, fully unrolling the 36 of them would
+// cost more code than it saves cycles.
+void MatMul6x6(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift )
+{
+    for( size_t i = 0; i < 6; ++i )
+    {
+        for( size_t j = 0; j < 6; ++j )
+        {
+            res[6 * i + j] = ( int32_t )( DOT6( op1, op2, i, j ) >> shift );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Returns whether the matrix elements are stored densely in row major order.
+static inline bool IsDenseMat( const fp_mat_t mat )
+{
+    return mat.rowStride == ( int )mat.cols && mat.colStride == 1;
+}
+
 //-----------------------------------------------------------------------------
 //
 void MatMul(
@@ -29,34 +107,59 @@ void MatMul(
     const fp_mat_t op2,
     fp_mat_t res )
 {
-    assert( op1.data != res.data && op2.data != res.data, EC_INVALID_MATRIX,
+    assert_paranoid( op1.data != res.data && op2.data != res.data, EC_INVALID_MATRIX,
         "MatMul: The result matrix can't be one of the operands: op1 == %p, op2 == %p, res == %p\r\n",
         op1.data, op2.data, res.data );
-    assert( op1.rows == res.rows,
+    assert_paranoid( op1.rows == res.rows,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatMul: Operand 1 and result rows don't match: %d and %d\r\n",
         op1.rows, res.rows );
-    assert( op2.cols == res.cols,
+    assert_paranoid( op2.cols == res.cols,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatMul: Operand 2 and result cols don't match: %d and %d\r\n",
         op2.cols, res.cols );
-    assert( op1.cols == op2.rows,
+    assert_paranoid( op1.cols == op2.rows,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatMul: Operand 1 cols and operand 2 rows don't match: %d and %d\r\n",
         op1.rows, op2.cols );
-    assert( op1.fracBits == res.fracBits,
+    assert_paranoid( op1.fracBits == res.fracBits,
         EC_MATRIX_FRACBITS_DONT_MATCH,
         "MatMul: Result and op1 matrices number of fractional bits are different: %d != %d\r\n",
         op1.fracBits, res.fracBits );
-    assert( op1.rowsFilter == 0 && op1.colsFilter == 0,
+    assert_paranoid( op1.rowsFilter == 0 && op1.colsFilter == 0,
         EC_INVALID_MATRIX,
         "MatMul: Operand 1 rows/cols are filtered. Mul not supported\r\n",
         op1.fracBits, res.fracBits );
-    assert( op2.rowsFilter == 0 && op2.colsFilter == 0,
+    assert_paranoid( op2.rowsFilter == 0 && op2.colsFilter == 0,
         EC_INVALID_MATRIX,
         "MatMul: Operand 2 rows/cols are filtered. Mul not supported\r\n",
         op1.fracBits, res.fracBits );
 
+    // Square operands of the common sizes, stored densely, go to the unrolled
+    // kernels
+    if( op1.rows == op1.cols && op2.rows == op2.cols &&
+        IsDenseMat( op1 ) && IsDenseMat( op2 ) && IsDenseMat( res ) )
+    {
+        const int32_t *a = ( const int32_t * )op1.data;
+        const int32_t *b = ( const int32_t * )op2.data;
+        int32_t *r = ( int32_t * )res.data;
+
+        switch( op1.rows )
+        {
+        case 2:
+            MatMul2x2( a, b, r, op2.fracBits );
+            return;
+        case 3:
+            MatMul3x3( a, b, r, op2.fracBits );
+            return;
+        case 6:
+            MatMul6x6( a, b, r, op2.fracBits );
+            return;
+        default:
+            break;
+        }
+    }
+
     for( size_t i = 0; i < op1.rows; ++i )
     {
         size_t iRowPosOp1 = i * op1.rowStride;   
@@ -552,6 +655,90 @@ bool InvertSquareMatrix6x6(
     return true;
 }
 
+//-----------------------------------------------------------------------------
+// LDLT factorization, A = L * D * L^T with L unit lower triangular and D
+// diagonal, then forward and back substitutions. The factors are raw fixed
+// point numbers with the fracBits of mat, the sums of products are 64 bits
+// and shifted once.
+bool SolveSym6x6(
+    const fp_mat_t mat,
+    const fp_mat_t rhs,
+    fp_mat_t sol )
+{
+    assert( mat.cols == mat.rows && mat.cols == 6,
+        EC_MATRICES_DIM_DONT_MATCH,
+        "SolveSym6x6: Matrix is not square and 6x6!: %dx%d\r\n",
+        mat.rows, mat.cols );
+    assert( rhs.rows == 6 && rhs.cols == 1 && sol.rows == 6 && sol.cols == 1,
+        EC_MATRICES_DIM_DONT_MATCH,
+        "SolveSym6x6: Vectors are not 6x1!: %dx%d and %dx%d\r\n",
+        rhs.rows, rhs.cols, sol.rows, sol.cols );
+
+    uint8_t fracBits = mat.fracBits;
+
+    // Lower triangle of L, D on the diagonal
+    int32_t ld[6][6];
+    // L[j][k] * D[k] of the row being factored
+    int32_t ldRow[6];
+    int32_t y[6];
+
+    for( size_t j = 0; j < 6; ++j )
+    {
+        int64_t acc = 0;
+        for( size_t k = 0; k < j; ++k )
+        {
+            ldRow[k] = ( int32_t )( ( ( int64_t )ld[j][k] * ld[k][k] ) >> fracBits );
+            acc += ( int64_t )ld[j][k] * ldRow[k];
+        }
+        int32_t d = MatGet( mat, j, j ).n - ( int32_t )( acc >> fracBits );
+        if( d <= 0 )
+        {
+            // Not positive definite, or lost to rounding
+            return false;
+        }
+        ld[j][j] = d;
+
+        for( size_t i = j + 1; i < 6; ++i )
+        {
+            acc = 0;
+            for( size_t k = 0; k < j; ++k )
+            {
+                acc += ( int64_t )ld[i][k] * ldRow[k];
+            }
+            int64_t num = ( int64_t )MatGet( mat, i, j ).n - ( acc >> fracBits );
+            ld[i][j] = ( int32_t )( ( num << fracBits ) / d );
+        }
+    }
+
+    // L * z = rhs, then y = z / D
+    for( size_t i = 0; i < 6; ++i )
+    {
+        int64_t acc = 0;
+        for( size_t k = 0; k < i; ++k )
+        {
+            acc += ( int64_t )ld[i][k] * y[k];
+        }
+        y[i] = MatGet( rhs, i, 0 ).n - ( int32_t )( acc >> fracBits );
+    }
+    for( size_t i = 0; i < 6; ++i )
+    {
+        y[i] = ( int32_t )( ( ( int64_t )y[i] << fracBits ) / ld[i][i] );
+    }
+
+    // L^T * sol = y
+    for( size_t i = 6; i-- > 0; )
+    {
+        int64_t acc = 0;
+        for( size_t k = i + 1; k < 6; ++k )
+        {
+            acc += ( int64_t )ld[k][i] * y[k];
+        }
+        y[i] -= ( int32_t )( acc >> fracBits );
+        MatSet( sol, i, 0, InterpretIntAsFP( y[i], sol.fracBits ) );
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 //
 fp_mat_t FilterRows( fp_mat_t mat, const uint8_t *indices, size_t indicesLen )
@@ -199,11 +199,11 @@ static inline fp_t MatGet(
     size_t row,
     size_t col )
 {
-    assert( row < mat.rows,
+    assert_paranoid( row < mat.rows,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatGet: row index greater than or equal to matrix rows number: %d > %d\r\n",
         row, mat.rows );
-    assert( col < mat.cols,
+    assert_paranoid( col < mat.cols,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatGet: col index greater than or equal to matrix cols number: %d > %d\r\n",
         col, mat.cols );
@@ -228,15 +228,15 @@ static inline void MatSet(
     size_t col,
     const fp_t value )
 {
-    assert( row < mat.rows,
+    assert_paranoid( row < mat.rows,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatSet: row index greater than or equal to matrix rows number: %d > %d\r\n",
         row, mat.rows );
-    assert( col < mat.cols,
+    assert_paranoid( col < mat.cols,
         EC_MATRICES_DIM_DONT_MATCH,
         "MatSet: col index greater than or equal to matrix cols number: %d > %d\r\n",
         col, mat.cols );
-    assert( mat.fracBits == value.fracBits,
+    assert_paranoid( mat.fracBits == value.fracBits,
         EC_MATRIX_FRACBITS_DONT_MATCH,
         "MatSet: matrix and value number of fractional bits are different: %d != %d\r\n",
         mat.fracBits, value.fracBits );
@@ -262,6 +262,30 @@ void MatMul(
     const fp_mat_t op2,
     fp_mat_t res );
 
+// Multiply square matrices op1 by op2 of raw fixed point numbers and store the
+// result in res, shifting the sums of products right by shift, op2 number of
+// fractional bits. The matrices are dense and row major: element (i, j) is
+// at i * n + j.
+// MatMul() dispatches to these kernels when its operands allow it.
+// It is assumed res is not op1 nor op2.
+void MatMul2x2(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift );
+
+void MatMul3x3(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift );
+
+void MatMul6x6(
+    const int32_t *op1,
+    const int32_t *op2,
+    int32_t *res,
+    uint8_t shift );
+
 // Compute the norm of a matrix.
 // Returning a boolean to account for overflow cases.
 bool MatrixNorm( const fp_mat_t mat, fp_t *result );
@@ -370,6 +394,18 @@ bool InvertSquareMatrix6x6(
     const fp_mat_t mat,
     fp_mat_t inv );
 
+// Solve mat * sol = rhs for a symmetric positive definite 6x6 matrix mat,
+// such as the normal equations of a least squares fit, by LDLT factorization.
+// This is about a third of the operations of InvertSquareMatrix6x6() and a
+// product, and more accurate. Only the lower triangle of mat is read.
+// It is assumed rhs and sol are 6x1 and use the fixed point representation of
+// mat.
+// Returns false if mat is not positive definite, sol is then unchanged.
+bool SolveSym6x6(
+    const fp_mat_t mat,
+    const fp_mat_t rhs,
+    fp_mat_t sol );
+
 // Remove matrix mat's rows that are not in the indices list.
 // It is assumed mat is not already row filtered.
 // it is assumed the indices list length is lesser than mat.rows
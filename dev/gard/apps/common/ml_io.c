@@ -1,6 +1,6 @@
 //=============================================================================
 //
-// Copyright(c) 2022 Mirametrix Inc. All rights reserved.
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
 //
 // These coded instructions, statements, and computer programs contain
 // unpublished proprietary information written by MMX and
@@ -13,31 +13,32 @@
 //=============================================================================
 // I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
 
-#include "app_assert.h"
+#include <string.h>
 
-#include <stdarg.h>
+#include "ml_io.h"
 
-#include "assert.h"
+#include "scratch_arena.h"
 
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
 
 //-----------------------------------------------------------------------------
 //
-void assert_rel( bool condition, int err, const char *format, ... )
+const int16_t *MLIOCopyPlanes(
+    uint32_t address,
+    size_t planeSize,
+    size_t planeStride,
+    size_t planesNb )
 {
-	va_list args;
-	va_start(args, format);
-	GARD__ASSERT( condition, err, format, args );
-	va_end(args);	
-}
+    int16_t *copy = ScratchAllocArray( int16_t, planeSize * planesNb );
+    const int16_t *plane = ( const int16_t * )MLIOPointer( address );
 
-//-----------------------------------------------------------------------------
-//
-void assert_dbg( bool condition, int err, const char *format, ... )
-{
-	va_list args;
-	va_start(args, format);
-	GARD__DBG_ASSERT( condition, err, format, args );
-	va_end(args);
-}
\ No newline at end of file
+    // memcpy() reads whole words, half the accesses of the int16 reads of the
+    // decoding loops
+    for( size_t i = 0; i < planesNb; ++i )
+    {
+        memcpy( &copy[i * planeSize], plane, planeSize * sizeof( int16_t ) );
+        plane += planeStride;
+    }
+    return copy;
+}
@@ -0,0 +1,59 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef ML_IO_H
+#define ML_IO_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memmap.h"
+
+#ifdef GARD_HOST_SIM
+// Host buffer standing for the HRAM ML IO region, see apps/host_sim
+extern uint8_t *host_sim_ml_io;
+#endif
+
+//=============================================================================
+// M A C R O S
+
+// Pointer to the ML engine input / output buffers at a GARD address of the
+// HRAM ML IO region, e.g. a network output. In the host simulation, the
+// address is translated to the host buffer the recorded outputs are loaded in.
+#ifdef GARD_HOST_SIM
+#define MLIOPointer( address ) \
+    ( ( void * )( host_sim_ml_io + ( ( uint32_t )( address ) - HRAM_ML_IO_START_ADDR ) ) )
+#else
+#define MLIOPointer( address ) \
+    ( ( void * )( uintptr_t )( uint32_t )( address ) )
+#endif
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Copies planesNb channel planes of planeSize int16 values of a network output,
+// the first at address and each next one planeStride values after the previous
+// one, back to back to the scratch arena, and returns the copy. It is released
+// with the scratch mark of the caller.
+// The post-processing scans of whole planes, e.g. of the confidences, then
+// read the TCM instead of the ML IO region, whose accesses are slower; the
+// planes read at a few indices only are better left where they are.
+const int16_t *MLIOCopyPlanes(
+    uint32_t address,
+    size_t planeSize,
+    size_t planeStride,
+    size_t planesNb );
+
+#endif
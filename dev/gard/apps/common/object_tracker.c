@@ -0,0 +1,409 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "object_tracker.h"
+
+#include "box.h"
+#include "quick_select.h"
+#include "scratch_arena.h"
+#include "types.h" // instead of std bool
+#include "utils.h"
+
+//=============================================================================
+// C O N S T A N T S
+
+#define GRID_CELLS_NB ( OBJECT_TRACKER_GRID_SIZE * OBJECT_TRACKER_GRID_SIZE )
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Detections bucketed by grid cell: the positions of the detections of cell c
+// are positions[cellStarts[c]] to positions[cellStarts[c + 1] - 1].
+typedef struct
+{
+    uint16_t cellStarts[GRID_CELLS_NB + 1];
+    uint16_t *positions;
+    int16_t cellWidth;
+    int16_t cellHeight;
+} detection_grid_t;
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+static inline int16_t Clamp16( int32_t value, int32_t low, int32_t high )
+{
+    return ( int16_t )( value < low ? low : value > high ? high : value );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the grid cell, along one axis, of a coordinate.
+static inline int32_t GetCell( int32_t coordinate, int16_t cellSize )
+{
+    return Clamp16(
+        coordinate / cellSize, 0, OBJECT_TRACKER_GRID_SIZE - 1 );
+}
+
+//-----------------------------------------------------------------------------
+//
+static void EndTrack( object_track_t *track )
+{
+    track->id = 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+void InitObjectTracker(
+    object_tracker_t *tracker,
+    int16_t frameWidth,
+    int16_t frameHeight,
+    fp_t minIoU,
+    uint8_t maxMisses )
+{
+    for( size_t i = 0; i < OBJECT_TRACKER_MAX_TRACKS; ++i )
+    {
+        EndTrack( &tracker->tracks[i] );
+    }
+    tracker->nextId = 1;
+    tracker->frameWidth = frameWidth;
+    tracker->frameHeight = frameHeight;
+    tracker->minIoU = FPToQ10( minIoU );
+    tracker->maxMisses = maxMisses;
+}
+
+//-----------------------------------------------------------------------------
+//
+void PredictObjectTracks( object_tracker_t *tracker )
+{
+    for( size_t i = 0; i < OBJECT_TRACKER_MAX_TRACKS; ++i )
+    {
+        object_track_t *track = &tracker->tracks[i];
+
+        if( track->id != 0 && track->frames < UINT16_MAX )
+        {
+            ++track->frames;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+void GetPredictedTrackBox(
+    const object_track_t *track,
+    int16_t *left,
+    int16_t *top,
+    int16_t *right,
+    int16_t *bottom )
+{
+    int32_t dx = ( ( int32_t )track->velocityX * track->frames ) >>
+        OBJECT_TRACKER_VELOCITY_FRAC_BITS;
+    int32_t dy = ( ( int32_t )track->velocityY * track->frames ) >>
+        OBJECT_TRACKER_VELOCITY_FRAC_BITS;
+
+    *left = Clamp16( track->left + dx, INT16_MIN, INT16_MAX );
+    *top = Clamp16( track->top + dy, INT16_MIN, INT16_MAX );
+    *right = Clamp16( track->right + dx, INT16_MIN, INT16_MAX );
+    *bottom = Clamp16( track->bottom + dy, INT16_MIN, INT16_MAX );
+}
+
+//-----------------------------------------------------------------------------
+// Buckets the detections by the grid cell of their box centre, with a counting
+// sort.
+static void FillDetectionGrid(
+    const object_tracker_t *tracker,
+    const object_tracker_detections_t *detections,
+    detection_grid_t *grid )
+{
+    uint16_t *cells = ScratchAllocArray( uint16_t, detections->size );
+
+    grid->cellWidth = MAX(
+        1, ( tracker->frameWidth + OBJECT_TRACKER_GRID_SIZE - 1 ) /
+        OBJECT_TRACKER_GRID_SIZE );
+    grid->cellHeight = MAX(
+        1, ( tracker->frameHeight + OBJECT_TRACKER_GRID_SIZE - 1 ) /
+        OBJECT_TRACKER_GRID_SIZE );
+
+    for( size_t c = 0; c <= GRID_CELLS_NB; ++c )
+    {
+        grid->cellStarts[c] = 0;
+    }
+    for( size_t i = 0; i < detections->size; ++i )
+    {
+        uint16_t position = detections->order[i];
+        int32_t x = ( detections->lefts[position] +
+            detections->rights[position] ) / 2;
+        int32_t y = ( detections->tops[position] +
+            detections->bottoms[position] ) / 2;
+
+        cells[i] = GetCell( y, grid->cellHeight ) * OBJECT_TRACKER_GRID_SIZE +
+            GetCell( x, grid->cellWidth );
+        ++grid->cellStarts[cells[i] + 1];
+    }
+    for( size_t c = 0; c < GRID_CELLS_NB; ++c )
+    {
+        grid->cellStarts[c + 1] += grid->cellStarts[c];
+    }
+
+    // Fill the cells, cellStarts[c] moving to the end of the cell c meanwhile
+    grid->positions = ScratchAllocArray( uint16_t, detections->size );
+    for( size_t i = 0; i < detections->size; ++i )
+    {
+        grid->positions[grid->cellStarts[cells[i]]++] = detections->order[i];
+    }
+    for( size_t c = GRID_CELLS_NB; c > 0; --c )
+    {
+        grid->cellStarts[c] = grid->cellStarts[c - 1];
+    }
+    grid->cellStarts[0] = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Lists the pairs of a track and a detection of the same class whose IoU is at
+// least the tracker minimum. A detection is only a candidate if its centre is
+// within the size of the predicted track box from the track centre, so only
+// the grid cells of this gate are searched.
+// Returns the number of pairs.
+static size_t FindCandidatePairs(
+    const object_tracker_t *tracker,
+    const object_tracker_detections_t *detections,
+    const detection_grid_t *grid,
+    uint8_t *pairTracks,
+    uint16_t *pairPositions,
+    int16_t *pairIoUs )
+{
+    size_t pairsNb = 0;
+
+    for( size_t t = 0; t < OBJECT_TRACKER_MAX_TRACKS; ++t )
+    {
+        const object_track_t *track = &tracker->tracks[t];
+        q10_box_t trackBox;
+        int16_t left, top, right, bottom;
+
+        if( track->id == 0 )
+        {
+            continue;
+        }
+        GetPredictedTrackBox( track, &left, &top, &right, &bottom );
+        trackBox = ( q10_box_t ){ left, top, right, bottom };
+
+        int32_t x = ( left + right ) / 2;
+        int32_t y = ( top + bottom ) / 2;
+        int32_t width = right - left;
+        int32_t height = bottom - top;
+        int32_t firstColumn = GetCell( x - width, grid->cellWidth );
+        int32_t lastColumn = GetCell( x + width, grid->cellWidth );
+        int32_t firstRow = GetCell( y - height, grid->cellHeight );
+        int32_t lastRow = GetCell( y + height, grid->cellHeight );
+
+        for( int32_t row = firstRow; row <= lastRow; ++row )
+        {
+            for( int32_t column = firstColumn; column <= lastColumn; ++column )
+            {
+                size_t cell = row * OBJECT_TRACKER_GRID_SIZE + column;
+
+                for( size_t i = grid->cellStarts[cell];
+                    i < grid->cellStarts[cell + 1]; ++i )
+                {
+                    uint16_t position = grid->positions[i];
+                    q10_box_t box = {
+                        detections->lefts[position],
+                        detections->tops[position],
+                        detections->rights[position],
+                        detections->bottoms[position] };
+                    int32_t dx = ( box.left + box.right ) / 2 - x;
+                    int32_t dy = ( box.top + box.bottom ) / 2 - y;
+
+                    if( detections->classes[position] != track->objectClass ||
+                        dx > width || -dx > width ||
+                        dy > height || -dy > height )
+                    {
+                        continue;
+                    }
+
+                    q21_10_t iou = ComputeQ10IoU( &trackBox, &box );
+                    if( iou < tracker->minIoU ||
+                        pairsNb == OBJECT_TRACKER_MAX_PAIRS )
+                    {
+                        continue;
+                    }
+                    pairTracks[pairsNb] = ( uint8_t )t;
+                    pairPositions[pairsNb] = position;
+                    pairIoUs[pairsNb] = ( int16_t )iou;
+                    ++pairsNb;
+                }
+            }
+        }
+    }
+    return pairsNb;
+}
+
+//-----------------------------------------------------------------------------
+// Continues a track with its matched detection. The velocity moves halfway to
+// the one measured since the previous match.
+static void ContinueTrack(
+    object_track_t *track,
+    const object_tracker_detections_t *detections,
+    uint16_t position )
+{
+    int16_t left = detections->lefts[position];
+    int16_t top = detections->tops[position];
+    int16_t right = detections->rights[position];
+    int16_t bottom = detections->bottoms[position];
+    int32_t frames = MAX( track->frames, 1 );
+    int32_t velocityX = ( ( ( left + right ) - ( track->left + track->right ) )
+        * ( 1 << ( OBJECT_TRACKER_VELOCITY_FRAC_BITS - 1 ) ) ) / frames;
+    int32_t velocityY = ( ( ( top + bottom ) - ( track->top + track->bottom ) )
+        * ( 1 << ( OBJECT_TRACKER_VELOCITY_FRAC_BITS - 1 ) ) ) / frames;
+
+    if( track->hits == 1 )
+    {
+        // First velocity measure
+        track->velocityX = Clamp16( velocityX, INT16_MIN, INT16_MAX );
+        track->velocityY = Clamp16( velocityY, INT16_MIN, INT16_MAX );
+    }
+    else
+    {
+        track->velocityX = Clamp16(
+            ( track->velocityX + velocityX ) / 2, INT16_MIN, INT16_MAX );
+        track->velocityY = Clamp16(
+            ( track->velocityY + velocityY ) / 2, INT16_MIN, INT16_MAX );
+    }
+    track->left = left;
+    track->top = top;
+    track->right = right;
+    track->bottom = bottom;
+    track->frames = 0;
+    track->misses = 0;
+    if( track->hits < UINT16_MAX )
+    {
+        ++track->hits;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Starts a track on a free slot with a detection.
+// Returns the track ID, or 0 if there is no free slot.
+static uint16_t StartTrack(
+    object_tracker_t *tracker,
+    const object_tracker_detections_t *detections,
+    uint16_t position )
+{
+    for( size_t t = 0; t < OBJECT_TRACKER_MAX_TRACKS; ++t )
+    {
+        object_track_t *track = &tracker->tracks[t];
+
+        if( track->id != 0 )
+        {
+            continue;
+        }
+        track->id = tracker->nextId;
+        tracker->nextId = tracker->nextId == UINT16_MAX ?
+            1 : tracker->nextId + 1;
+        track->objectClass = detections->classes[position];
+        track->left = detections->lefts[position];
+        track->top = detections->tops[position];
+        track->right = detections->rights[position];
+        track->bottom = detections->bottoms[position];
+        track->velocityX = 0;
+        track->velocityY = 0;
+        track->frames = 0;
+        track->misses = 0;
+        track->hits = 1;
+        return track->id;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+void UpdateObjectTracker(
+    object_tracker_t *tracker,
+    const object_tracker_detections_t *detections,
+    uint16_t *trackIds )
+{
+    scratch_mark_t mark = ScratchMark();
+    detection_grid_t grid;
+    bool matchedTracks[OBJECT_TRACKER_MAX_TRACKS] = { false };
+    uint8_t *pairTracks = ScratchAllocArray( uint8_t, OBJECT_TRACKER_MAX_PAIRS );
+    uint16_t *pairPositions =
+        ScratchAllocArray( uint16_t, OBJECT_TRACKER_MAX_PAIRS );
+    int16_t *pairIoUs = ScratchAllocArray( int16_t, OBJECT_TRACKER_MAX_PAIRS );
+    size_t *pairOrder = ScratchAllocArray( size_t, OBJECT_TRACKER_MAX_PAIRS );
+
+    PredictObjectTracks( tracker );
+
+    for( size_t i = 0; i < detections->size; ++i )
+    {
+        trackIds[detections->order[i]] = 0;
+    }
+
+    FillDetectionGrid( tracker, detections, &grid );
+    size_t pairsNb = FindCandidatePairs(
+        tracker, detections, &grid, pairTracks, pairPositions, pairIoUs );
+
+    // Greedy assignment, by decreasing IoU
+    for( size_t i = 0; i < pairsNb; ++i )
+    {
+        pairOrder[i] = i;
+    }
+    QuickSort( pairOrder, pairIoUs, pairsNb );
+    for( size_t i = pairsNb; i > 0; --i )
+    {
+        size_t pair = pairOrder[i - 1];
+        uint8_t t = pairTracks[pair];
+        uint16_t position = pairPositions[pair];
+
+        if( matchedTracks[t] || trackIds[position] != 0 )
+        {
+            continue;
+        }
+        matchedTracks[t] = true;
+        ContinueTrack( &tracker->tracks[t], detections, position );
+        trackIds[position] = tracker->tracks[t].id;
+    }
+
+    // Lost tracks
+    for( size_t t = 0; t < OBJECT_TRACKER_MAX_TRACKS; ++t )
+    {
+        object_track_t *track = &tracker->tracks[t];
+
+        if( track->id == 0 || matchedTracks[t] )
+        {
+            continue;
+        }
+        if( track->misses >= tracker->maxMisses )
+        {
+            EndTrack( track );
+        }
+        else
+        {
+            ++track->misses;
+        }
+    }
+
+    // New tracks, in the detections order
+    for( size_t i = 0; i < detections->size; ++i )
+    {
+        uint16_t position = detections->order[i];
+
+        if( trackIds[position] == 0 )
+        {
+            trackIds[position] = StartTrack( tracker, detections, position );
+        }
+    }
+
+    ScratchRelease( mark );
+}
@@ -0,0 +1,117 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef OBJECT_TRACKER_H
+#define OBJECT_TRACKER_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+//=============================================================================
+// C O N S T A N T S
+
+// Maximum number of objects tracked at once
+#define OBJECT_TRACKER_MAX_TRACKS       32
+
+// The detections are bucketed by their box centre on a grid of
+// OBJECT_TRACKER_GRID_SIZE x OBJECT_TRACKER_GRID_SIZE cells over the frame,
+// a track is only compared to the detections of the cells its gate overlaps
+#define OBJECT_TRACKER_GRID_SIZE        8
+
+// Maximum number of gated track and detection pairs of a frame
+#define OBJECT_TRACKER_MAX_PAIRS        ( OBJECT_TRACKER_MAX_TRACKS * 8 )
+
+// Fractional bits of the track velocities
+#define OBJECT_TRACKER_VELOCITY_FRAC_BITS 4
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// A tracked object. Boxes are int16 coordinates in any unit, the same as the
+// detections, e.g. pixels with some fractional bits.
+typedef struct
+{
+    uint16_t id;          // Track ID, 0 if the slot is free
+    uint8_t objectClass;
+    uint8_t misses;       // Detection frames since the last match
+    uint16_t frames;      // Frames since the last match
+    uint16_t hits;        // Matches since the track started
+    int16_t left;         // Box of the last match
+    int16_t top;
+    int16_t right;
+    int16_t bottom;
+    int16_t velocityX;    // Box centre velocity, in box units per frame with
+    int16_t velocityY;    // OBJECT_TRACKER_VELOCITY_FRAC_BITS fractional bits
+} object_track_t;
+
+typedef struct
+{
+    object_track_t tracks[OBJECT_TRACKER_MAX_TRACKS];
+    uint16_t nextId;
+    int16_t frameWidth;   // Extent of the box centres, in box units
+    int16_t frameHeight;
+    q21_10_t minIoU;      // IoU from which a detection continues a track
+    uint8_t maxMisses;    // Detection frames after which a lost track ends
+} object_tracker_t;
+
+// Detections of a frame, as arrays of at least size elements, e.g. after NMS
+typedef struct
+{
+    const int16_t *lefts;
+    const int16_t *tops;
+    const int16_t *rights;
+    const int16_t *bottoms;
+    const uint8_t *classes;
+    const uint16_t *order; // Positions of the detections in the arrays, the
+                           // first ones get the new tracks if they run out
+    size_t size;
+} object_tracker_detections_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Ends all the tracks and sets the tracker parameters.
+void InitObjectTracker(
+    object_tracker_t *tracker,
+    int16_t frameWidth,   // Extent of the box centres, in box units
+    int16_t frameHeight,
+    fp_t minIoU,          // IoU from which a detection continues a track
+    uint8_t maxMisses );  // Detection frames after which a lost track ends
+
+// Advances the tracks by a frame without detection, e.g. when the detection
+// runs every other frame. See GetPredictedTrackBox().
+void PredictObjectTracks( object_tracker_t *tracker );
+
+// Associates the detections of a frame to the tracks, predicted with constant
+// velocity, greedily by decreasing IoU. Unmatched detections start new tracks.
+// trackIds[position] is set to the track ID of each detection, or 0 if there is
+// no free track.
+void UpdateObjectTracker(
+    object_tracker_t *tracker,
+    const object_tracker_detections_t *detections,
+    uint16_t *trackIds );
+
+// Returns the box of the track at the current frame, predicted from its last
+// match with its velocity.
+void GetPredictedTrackBox(
+    const object_track_t *track,
+    int16_t *left,
+    int16_t *top,
+    int16_t *right,
+    int16_t *bottom );
+
+#endif
@@ -16,6 +16,7 @@
 #include "postprocessing_anchor_based_detection.h"
 #include "postprocessing_filters.h"
 #include "quick_select.h"
+#include "scratch_arena.h"
 
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
@@ -33,48 +34,85 @@ int32_t PostprocessAnchorBasedDetection(
     fp_t *confidence,
     geometric_box_t *boxes )
 {
-    // Create a list of indices, ordered from 0 to nbOutputs.
-    size_t currentIndices[nbOutputs];
-    for( int32_t i = 0; i < nbOutputs; ++i )
+    int32_t maxIndex = maxBoxes < nbOutputs ? maxBoxes : nbOutputs;
+    maxIndex = maxIndex > 0 ? maxIndex : 0;
+
+    scratch_mark_t mark = ScratchMark();
+    size_t *currentIndices = ScratchAllocArray( size_t, maxIndex );
+    size_t nbBoxes = SelectAnchorBasedDetections(
+        nbOutputs,
+        confidenceConfig,
+        maxIndex,
+        confidenceThreshold,
+        currentIndices,
+        confidence );
+
+    // Get the bounding boxes associated with the indices in currentIndices
+    RawToBoundingBoxes( currentIndices, nbBoxes, boundingBoxConfig, boxes );
+
+    nbBoxes = FilterAnchorBasedDetections(
+        nmsIoUThreshold,
+        nbBoxes,
+        currentIndices,
+        confidence,
+        boxes );
+
+    for ( size_t i = 0; i < nbBoxes; ++i )
     {
-        currentIndices[i] = i;
+        indices[i] = currentIndices[i];
     }
 
-    int32_t maxIndex = maxBoxes < nbOutputs ? maxBoxes : nbOutputs;
+    ScratchRelease( mark );
+    return nbBoxes;
+}
 
-    // The maxBoxes first indices of currentIndices will be the ones associated
-    // with the maxBoxes greatest confidence scores.
-    QuickSelect( currentIndices, nbOutputs, confidenceConfig->dataPtr, maxIndex );
+//-----------------------------------------------------------------------------
+//
+size_t SelectAnchorBasedDetections(
+    int32_t nbOutputs,
+    const fp_postprocessing_config_t *confidenceConfig,
+    int32_t maxBoxes,
+    fp_t confidenceThreshold,
+    size_t *indices,
+    fp_t *confidence )
+{
+    int32_t maxIndex = maxBoxes < nbOutputs ? maxBoxes : nbOutputs;
+    maxIndex = maxIndex > 0 ? maxIndex : 0;
 
-    // Get the confidence scores for the maxBoxes first indices of currentIndices
-    RawToFP( currentIndices, maxIndex, confidenceConfig, confidence );
+    // Scan the raw confidence scores once, against the confidence threshold
+    // converted to the raw data, and keep the indices of at most maxBoxes of
+    // the remaining ones, those with the greatest confidence scores.
+    size_t nbBoxes = SelectRawAboveThreshold(
+        confidenceConfig, nbOutputs, confidenceThreshold, maxIndex, indices );
 
-    // Remove from the indices and confidence arrays the indices and confidence
-    // scores lesser than or equal to the confidence threshold
-    size_t nbBoxes = FilterOutBelowThreshold(
-        confidenceThreshold, maxIndex, currentIndices, confidence );
+    // Get the confidence scores for the remaining indices
+    RawToFP( indices, nbBoxes, confidenceConfig, confidence );
 
-    // Get the bounding boxes associated with the indices in currentIndices
-    RawToBoundingBoxes( currentIndices, nbBoxes, boundingBoxConfig, boxes );
+    return nbBoxes;
+}
 
-    // Remove from currentIndices, confidence and boxes the indices, confidence
+//-----------------------------------------------------------------------------
+//
+size_t FilterAnchorBasedDetections(
+    fp_t nmsIoUThreshold,
+    size_t size,
+    size_t *indices,
+    fp_t *confidence,
+    geometric_box_t *boxes )
+{
+    // Remove from indices, confidence and boxes the indices, confidence
     // scores and bounding boxes for which the bounding box is a duplicate of
     // another bounding box with greater confidence.
     // Duplicate identification is based on the IoU score between two bounding
     // boxes.
     if( FPLt( nmsIoUThreshold, CreateFPInt( 1, nmsIoUThreshold.fracBits ) ) )
     {
-        nbBoxes = FilterOutBelowIoUThreshold(
+        size = FilterOutBelowIoUThreshold(
             nmsIoUThreshold,
-            nbBoxes,
-            currentIndices,
+            size,
+            indices,
             confidence,
             boxes );
     }
-
-    for ( size_t i = 0; i < nbBoxes; ++i )
-    {
-        indices[i] = currentIndices[i];
-    }
-    return nbBoxes;
+    return size;
 }
@@ -28,6 +28,8 @@
 // algorithm on the selected bounding boxes.
 // It is guaranteed to select the bounding boxes with the highest confidence
 // scores.
+// The confidence threshold is compared to the raw data, see
+// FPToRawThreshold(), so confidenceConfig->rawToFP must be non-decreasing.
 int32_t PostprocessAnchorBasedDetection(
     int32_t nbOutputs, // Number of bounding boxes from the model
     const fp_postprocessing_config_t *confidenceConfig, // postprocessing configuration for the confidence scores
@@ -41,4 +43,28 @@ int32_t PostprocessAnchorBasedDetection(
     fp_t *confidence, // Confidence scores of the bounding boxes returned
     geometric_box_t *boxes ); // Bounding boxes returned 
 
+// First step of PostprocessAnchorBasedDetection(): selects at most maxBoxes
+// indices whose confidence scores are above confidenceThreshold, those with
+// the greatest ones, and interprets their confidence scores.
+// Returns the number of selected indices.
+size_t SelectAnchorBasedDetections(
+    int32_t nbOutputs, // Number of bounding boxes from the model
+    const fp_postprocessing_config_t *confidenceConfig, // postprocessing configuration for the confidence scores
+    int32_t maxBoxes, // Maximum number of indices to select
+    fp_t confidenceThreshold, // Threshold below which an index won't be
+                              // selected
+    size_t *indices, // Selected indices, of at least maxBoxes elements
+    fp_t *confidence ); // Confidence scores of the selected indices
+
+// Last step of PostprocessAnchorBasedDetection(): applies the NMS algorithm on
+// the decoded bounding boxes, unless nmsIoUThreshold is 1 or more.
+// Returns the number of remaining bounding boxes.
+size_t FilterAnchorBasedDetections(
+    fp_t nmsIoUThreshold, // IoU threshold above which two bounding boxes are
+                          // identified
+    size_t size,      // Number of bounding boxes
+    size_t *indices,  // Indices of the bounding boxes
+    fp_t *confidence, // Confidence scores of the bounding boxes
+    geometric_box_t *boxes ); // Bounding boxes
+
 #endif
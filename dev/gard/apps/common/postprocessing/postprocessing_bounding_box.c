@@ -18,6 +18,21 @@
 //=============================================================================
 // F U N C T I O N S   C O D E   S E C T I O N
 
+//-----------------------------------------------------------------------------
+// Returns the raw delta at position index of data8 or data16, depending on the
+// config element type, minus the config zero point.
+static inline int32_t GetRawDelta(
+    const bounding_boxes_postprocessing_config_t *config, // postprocessing data
+    const int16_t *data16, // int16 deltas, if the element type is int16
+    const int8_t *data8,   // int8 deltas, if the element type is int8
+    size_t index )         // position in the raw data
+{
+    int32_t stored = config->elementType == RAW_ELEMENT_INT8
+        ? data8[index]
+        : data16[index];
+    return stored - config->zeroPoint;
+}
+
 //-----------------------------------------------------------------------------
 //
 void RawToBoundingBoxes(
@@ -33,13 +48,17 @@ void RawToBoundingBoxes(
         anchor_t anchor = config->gridCoordinatesToAnchor( &coords );
         
         fp_t rawDeltaX =
-            InterpretIntAsFP( config->deltaXPtr[indices[i]], config->fracBits );
+            InterpretIntAsFP( GetRawDelta( config, config->deltaXPtr,
+                config->deltaX8Ptr, indices[i] ), config->fracBits );
         fp_t rawDeltaY =
-            InterpretIntAsFP( config->deltaYPtr[indices[i]], config->fracBits );
+            InterpretIntAsFP( GetRawDelta( config, config->deltaYPtr,
+                config->deltaY8Ptr, indices[i] ), config->fracBits );
         fp_t rawDeltaW =
-            InterpretIntAsFP( config->deltaWPtr[indices[i]], config->fracBits );
+            InterpretIntAsFP( GetRawDelta( config, config->deltaWPtr,
+                config->deltaW8Ptr, indices[i] ), config->fracBits );
         fp_t rawDeltaH =
-            InterpretIntAsFP( config->deltaHPtr[indices[i]], config->fracBits );
+            InterpretIntAsFP( GetRawDelta( config, config->deltaHPtr,
+                config->deltaH8Ptr, indices[i] ), config->fracBits );
         
         boxes[i] = config->rawToBoundingBox(
             rawDeltaX, rawDeltaY, rawDeltaW, rawDeltaH, &anchor );
@@ -18,6 +18,7 @@
 
 #include "anchor.h"
 #include "box.h"
+#include "postprocessing_fixed_point.h"
 
 //=============================================================================
 // S T R U C T   D E C L A R A T I O N S
@@ -37,13 +38,31 @@ typedef geometric_box_t (*RawToBoundingBoxFunction) (
         fp_t rawDeltaH, // deltaH read from the model output
         const anchor_t *anchor ); // anchor to apply the deltas to
 
-// Contains all data required to interpret 4 arrays of int16 values as an array
-// of bounding boxes.
+// Contains all data required to interpret 4 arrays of int16 or int8 values as
+// an array of bounding boxes. The int8 pointers are used if elementType is
+// RAW_ELEMENT_INT8, the values are then read directly, with the zero point
+// subtracted, as for fp_postprocessing_config_t.
 typedef struct{
-    const int16_t *const deltaXPtr; // delta X values raw data
-    const int16_t *const deltaYPtr; // delta Y values raw data
-    const int16_t *const deltaWPtr; // delta W values raw data
-    const int16_t *const deltaHPtr; // delta H values raw data
+    union
+    {
+        const int16_t *const deltaXPtr; // delta X values raw data
+        const int8_t *const deltaX8Ptr;
+    };
+    union
+    {
+        const int16_t *const deltaYPtr; // delta Y values raw data
+        const int8_t *const deltaY8Ptr;
+    };
+    union
+    {
+        const int16_t *const deltaWPtr; // delta W values raw data
+        const int8_t *const deltaW8Ptr;
+    };
+    union
+    {
+        const int16_t *const deltaHPtr; // delta H values raw data
+        const int8_t *const deltaH8Ptr;
+    };
     const int32_t fracBits;         // Number of fractional bits to interpret
                                     // raw data as fixed point numbers.
     const int32_dim_t gridDim;            // Size of the output grid of the detection
@@ -54,6 +73,9 @@ typedef struct{
     
     // Raw deltas + anchor to bounding box
     RawToBoundingBoxFunction rawToBoundingBox;
+
+    const raw_element_type_t elementType; // Type of the raw data values
+    const int32_t zeroPoint;              // Stored value of the raw value 0
 } bounding_boxes_postprocessing_config_t;
 
 //=============================================================================
@@ -47,6 +47,13 @@ int32_t PostprocessCompactModel(
             "PostprocessCompactModel: expected a %d sized indice list, got size %d\r\n",
             nbOutputs, ANCHOR_BASED_DETECTION_MAX_INDICES_LIST_SIZE);
     
+    // The face probabilities are compared as int16 values
+    assert( confidenceConfig->elementType == RAW_ELEMENT_INT16 &&
+            faceProbConfig->elementType == RAW_ELEMENT_INT16 &&
+            noFaceProbConfig->elementType == RAW_ELEMENT_INT16,
+            EC_FUNCTION_NOT_IMPLEMENTED,
+            "PostprocessCompactModel: only int16 outputs are supported\r\n" );
+
     // Prevent issues if nbOutputs > ANCHOR_BASED_DETECTION_MAX_INDICES_LIST_SIZE
     nbOutputs = ( nbOutputs <= ANCHOR_BASED_DETECTION_MAX_INDICES_LIST_SIZE ) ?
         nbOutputs :
@@ -67,17 +74,24 @@ int32_t PostprocessCompactModel(
     }
     
     // The maxBoxes first indices of currentIndices will be the ones associated
-    // with the maxBoxes greatest confidence scores.
-    QuickSelect( currentIndices, nbOutputs, rawConf, maxBoxes );
-    
-    // Get the confidence scores for the maxBoxes first indices of currentIndices
-    RawToFP( currentIndices, maxBoxes, confidenceConfig, confidence );
- 
-    // Remove from the indices and confidence arrays the indices and confidence
-    // scores lesser than or equal to the confidence threshold
-    size_t nbBoxes = FilterOutBelowThreshold(
-        confidenceThreshold, maxBoxes, currentIndices, confidence );
+    // with the maxBoxes greatest confidence scores. Most scores are the 0 of
+    // the non-face outputs, which QuickSelectKeyed() sets aside in one pass.
+    quick_select_key_t selectKeys[ANCHOR_BASED_DETECTION_MAX_INDICES_LIST_SIZE];
+    QuickSelectKeyed( currentIndices, nbOutputs, rawConf, maxBoxes, selectKeys );
     
+    // Remove from the maxBoxes first indices of currentIndices the ones whose
+    // confidence score is lesser than or equal to the confidence threshold.
+    // The threshold is converted to the raw data once, so that the confidence
+    // scores are only computed for the remaining indices.
+    size_t nbBoxes = FilterOutRawBelowThreshold(
+        FPToRawThreshold( confidenceConfig, confidenceThreshold ),
+        maxBoxes,
+        currentIndices,
+        confidenceConfig->dataPtr );
+
+    // Get the confidence scores for the remaining indices
+    RawToFP( currentIndices, nbBoxes, confidenceConfig, confidence );
+
     // Get the bounding boxes associated with the indices in currentIndices
     RawToBoundingBoxes( currentIndices, nbBoxes, boundingBoxConfig, boxes );
     
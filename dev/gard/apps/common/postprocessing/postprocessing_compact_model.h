@@ -29,6 +29,8 @@
 // algorithm on the selected bounding boxes.
 // It is guaranteed to select the bounding boxes with the highest confidence
 // scores.
+// The confidence threshold is compared to the raw data, see
+// FPToRawThreshold(), so confidenceConfig->rawToFP must be non-decreasing.
 int32_t PostprocessCompactModel(
     int32_t nbOutputs, // Number of bounding boxes from the model
     const fp_postprocessing_config_t *confidenceConfig, // postprocessing configuration for the confidence scores
@@ -0,0 +1,128 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef POSTPROCESSING_DETECTION_HEAD_H
+#define POSTPROCESSING_DETECTION_HEAD_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "postprocessing_anchor_based_detection.h"
+
+//=============================================================================
+// M A C R O S
+
+// A detection head is the part of an anchor based detection model output
+// decoding the boxes of one grid. It holds nbChannels channels of int16 raw
+// data, each one of gridWidth x gridHeight x anchorsPerCell values, in the
+// order of IndexToGridCoordinates(). Four consecutive channels, from
+// deltaChannel, are the raw deltas of the boxes.
+//
+// DEFINE_DETECTION_HEAD() defines, for a head starting offset int16 values
+// after the model output:
+//
+//  name##_NB_OUTPUTS   Number of boxes of the head
+//  name##_SIZE         Number of int16 values of the head, i.e. the offset of
+//                      the head following it
+//  name##Channel()     Returns a channel of the head
+//  name##RawToBoundingBoxes()
+//                      Same as RawToBoundingBoxes(), for the head
+//  name##Postprocess() Same as PostprocessAnchorBasedDetection(), for the head,
+//                      with the raw confidence scores in confidenceChannel
+//                      interpreted by toConfidence
+//
+// The box decode loop is specialised for the head: the grid and channel
+// dimensions are constants, and the anchor and box functions are called
+// directly, so they should be static inline ones:
+//
+//  anchor_t toAnchor( int32_t row, int32_t col, int32_t anchor,
+//      int32_t gridWidth, int32_t gridHeight );
+//  geometric_box_t toBox( fp_t rawDeltaX, fp_t rawDeltaY, fp_t rawDeltaW,
+//      fp_t rawDeltaH, const anchor_t *anchor );
+//
+// A model with several heads lists them with an X-macro, see
+// hmi_person_detection.c.
+#define DEFINE_DETECTION_HEAD( name, offset, gridWidth, gridHeight,           \
+    anchorsPerCell, nbChannels, deltaChannel, confidenceChannel, fracBits,    \
+    toAnchor, toBox, toConfidence )                                           \
+                                                                              \
+enum                                                                          \
+{                                                                             \
+    name##_NB_CELLS = ( gridWidth ) * ( gridHeight ),                         \
+    name##_NB_OUTPUTS = name##_NB_CELLS * ( anchorsPerCell ),                 \
+    name##_SIZE = ( offset ) + name##_NB_OUTPUTS * ( nbChannels )             \
+};                                                                            \
+                                                                              \
+static inline const int16_t *name##Channel(                                   \
+    const int16_t *output,                                                    \
+    int32_t channel )                                                         \
+{                                                                             \
+    return output + ( offset ) + name##_NB_OUTPUTS * channel;                 \
+}                                                                             \
+                                                                              \
+static inline void name##RawToBoundingBoxes(                                  \
+    const int16_t *output,                                                    \
+    const size_t *indices,                                                    \
+    size_t size,                                                              \
+    geometric_box_t *boxes )                                                  \
+{                                                                             \
+    const int16_t *deltas = name##Channel( output, deltaChannel );            \
+                                                                              \
+    for( size_t i = 0; i < size; ++i )                                        \
+    {                                                                         \
+        size_t index = indices[i];                                            \
+        size_t cell = index % name##_NB_CELLS;                                \
+        anchor_t anchor = toAnchor(                                           \
+            cell / ( gridWidth ), cell % ( gridWidth ),                       \
+            index / name##_NB_CELLS, gridWidth, gridHeight );                 \
+                                                                              \
+        boxes[i] = toBox(                                                     \
+            InterpretIntAsFP( deltas[index], fracBits ),                      \
+            InterpretIntAsFP( deltas[index + name##_NB_OUTPUTS], fracBits ),  \
+            InterpretIntAsFP(                                                 \
+                deltas[index + name##_NB_OUTPUTS * 2], fracBits ),            \
+            InterpretIntAsFP(                                                 \
+                deltas[index + name##_NB_OUTPUTS * 3], fracBits ),            \
+            &anchor );                                                        \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static inline int32_t name##Postprocess(                                      \
+    const int16_t *output,                                                    \
+    int32_t maxBoxes,                                                         \
+    fp_t confidenceThreshold,                                                 \
+    fp_t nmsIoUThreshold,                                                     \
+    size_t *indices, /* Of at least maxBoxes elements */                      \
+    fp_t *confidence,                                                         \
+    geometric_box_t *boxes )                                                  \
+{                                                                             \
+    fp_postprocessing_config_t confidenceConfig =                             \
+        CreateFPPostprocessingConfig(                                         \
+            name##Channel( output, confidenceChannel ),                       \
+            fracBits,                                                         \
+            toConfidence );                                                   \
+                                                                              \
+    size_t nbBoxes = SelectAnchorBasedDetections(                             \
+        name##_NB_OUTPUTS,                                                    \
+        &confidenceConfig,                                                    \
+        maxBoxes,                                                             \
+        confidenceThreshold,                                                  \
+        indices,                                                              \
+        confidence );                                                         \
+                                                                              \
+    name##RawToBoundingBoxes( output, indices, nbBoxes, boxes );              \
+                                                                              \
+    return FilterAnchorBasedDetections(                                       \
+        nmsIoUThreshold, nbBoxes, indices, confidence, boxes );               \
+}
+
+#endif
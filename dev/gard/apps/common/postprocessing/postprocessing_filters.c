@@ -0,0 +1,231 @@
+//=============================================================================
+//
+// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "postprocessing_filters.h"
+
+#include "scratch_arena.h"
+
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+size_t FilterOutBelowThreshold (
+    fp_t threshold,  // Threshold value
+    size_t size,     // Size of the input lists
+    size_t *indices, // Indices list
+    fp_t *score )    // Score list
+{
+    size_t i = 0;
+    while( i < size )
+    {
+        if ( FPLe( score[i], threshold ) )
+        {
+            // Moving the last element of the lists to replace the removed one
+            score[i] = score[size - 1];
+            indices[i] = indices[size - 1];
+            // Lists are now 1 element shorter
+            size -= 1;
+            // Since we have to test the element we just moved at index i
+            // we don't increment i to test the new element during next loop
+            // iteration
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+//
+size_t FilterOutRawBelowThreshold (
+    int32_t rawThreshold, // Threshold value on the raw data
+    size_t size,          // Size of the input list
+    size_t *indices,      // Indices list
+    const int16_t *data ) // Raw data the indices refer to
+{
+    size_t i = 0;
+    while( i < size )
+    {
+        if ( data[indices[i]] <= rawThreshold )
+        {
+            // Moving the last element of the list to replace the removed one
+            indices[i] = indices[size - 1];
+            size -= 1;
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+// Tells if the box at position index1 goes before the one at position index2
+// in the NMS order: by class first if the classes are bucketed, then by
+// decreasing score.
+static inline bool IsBeforeInNMSOrder(
+    size_t index1,       // Position of the first box
+    size_t index2,       // Position of the second box
+    const fp_t *score,   // Scores list
+    const int32_t *classes ) // Classes list, NULL if not bucketed
+{
+    if( classes != NULL && classes[index1] != classes[index2] )
+    {
+        return classes[index1] < classes[index2];
+    }
+    return FPGt( score[index1], score[index2] );
+}
+
+//-----------------------------------------------------------------------------
+//
+size_t FilterOutBelowIoUThresholdWithClassSwitch (
+    fp_t iouThreshold, // IoU value below which two bounding boxes are different
+    size_t size,       // Size of the input lists
+    size_t *indices,   // Indices list
+    fp_t *score,       // Scores list
+    geometric_box_t *boxes, // Bounding boxes list
+    int32_t *classes, // Classes list
+    bool compareDifferentClasses ) // Compare boxes of different classe (true) or not (false)
+{
+    const int32_t *buckets = compareDifferentClasses ? NULL : classes;
+
+    // The boxes are compared in Q21.10, a quarter of the size of
+    // geometric_box_t and without fractional bits checks, with their areas
+    // computed once. The lists themselves are only compacted at the end.
+    scratch_mark_t mark = ScratchMark();
+    q10_box_t *q10Boxes = ScratchAllocArray( q10_box_t, size );
+    int64_t *areas = ScratchAllocArray( int64_t, size );
+    uint16_t *order = ScratchAllocArray( uint16_t, size );
+    bool *suppressed = ScratchAllocArray( bool, size );
+    q21_10_t q10IoUThreshold = FPToQ10( iouThreshold );
+
+    for( size_t i = 0; i < size; ++i )
+    {
+        q10Boxes[i] = GeometricBoxToQ10( &boxes[i] );
+        areas[i] = ComputeQ10Area( &q10Boxes[i] );
+        suppressed[i] = false;
+
+        // Insertion sort of the positions in NMS order, the lists are short
+        // once thresholded.
+        size_t j = i;
+        while( j > 0 && IsBeforeInNMSOrder( i, order[j - 1], score, buckets ) )
+        {
+            order[j] = order[j - 1];
+            j -= 1;
+        }
+        order[j] = ( uint16_t ) i;
+    }
+
+    // Greedy NMS: each box that is not suppressed suppresses the boxes with
+    // lower scores, of its class if bucketed, whose IoU with it reaches the
+    // threshold. IoU >= t is tested as intersection * (1 + t) >=
+    // t * (area1 + area2), which needs no division.
+    for( size_t i = 0; i < size; ++i )
+    {
+        size_t index1 = order[i];
+        if( suppressed[index1] )
+        {
+            continue;
+        }
+
+        for( size_t j = i + 1; j < size; ++j )
+        {
+            size_t index2 = order[j];
+            if( buckets != NULL && buckets[index2] != buckets[index1] )
+            {
+                // The remaining boxes belong to other classes
+                break;
+            }
+            if( suppressed[index2] )
+            {
+                continue;
+            }
+
+            int64_t interArea =
+                ComputeQ10IntersectionArea( &q10Boxes[index1], &q10Boxes[index2] );
+            int64_t areaSum = areas[index1] + areas[index2];
+            if( areaSum - interArea > 0 &&
+                interArea * ( Q10_ONE + q10IoUThreshold ) >=
+                    areaSum * q10IoUThreshold )
+            {
+                suppressed[index2] = true;
+            }
+        }
+    }
+
+    // Compact the lists, keeping the order of the remaining elements
+    size_t kept = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        if( suppressed[i] )
+        {
+            continue;
+        }
+        if( kept != i )
+        {
+            indices[kept] = indices[i];
+            score[kept] = score[i];
+            boxes[kept] = boxes[i];
+            if( !compareDifferentClasses )
+            {
+                classes[kept] = classes[i];
+            }
+        }
+        kept += 1;
+    }
+
+    ScratchRelease( mark );
+    return kept;
+}
+
+size_t FilterOutBelowIoUThreshold (
+    fp_t iouThreshold, // IoU value below which two bounding boxes are different
+    size_t size,       // Size of the input lists
+    size_t *indices,   // Indices list
+    fp_t *score,       // Scores list
+    geometric_box_t *boxes ) // Bounding boxes list
+{
+    return FilterOutBelowIoUThresholdWithClassSwitch(
+        iouThreshold,
+        size,
+        indices,
+        score,
+        boxes,
+        NULL,
+        true );
+}
+
+size_t FilterOutSameClassBelowIoUThreshold (
+    fp_t iouThreshold, // IoU value below which two bounding boxes are different
+    size_t size,       // Size of the input lists
+    size_t *indices,   // Indices list
+    fp_t *score,       // Scores list
+    geometric_box_t *boxes, // Bounding boxes list
+    int32_t *classes ) // Classes list
+{
+    return FilterOutBelowIoUThresholdWithClassSwitch(
+        iouThreshold,
+        size,
+        indices,
+        score,
+        boxes,
+        classes,
+        false );
+}
@@ -37,11 +37,27 @@ size_t FilterOutBelowThreshold (
     size_t *indices, // Indices list
     fp_t *score );   // Score list 
 
+// Remove from the list of indices elements whose raw data is lesser than or
+// equal to the raw threshold, see FPToRawThreshold().
+// Those are in place changes, the input list is modified.
+//
+// THIS FUNCTION DOESN'T PRESERVE ORDER OF THE LIST'S ELEMENTS.
+//
+// The function returns the new size of the list.
+size_t FilterOutRawBelowThreshold (
+    int32_t rawThreshold, // Threshold value on the raw data
+    size_t size,          // Size of the input list
+    size_t *indices,      // Indices list
+    const int16_t *data ); // Raw data the indices refer to
+
 // Remove from the list of bounding boxes elements that are too similar to 
 // another more trustable one. Indices and scores associated to the removed 
 // elements are also removed from their respective lists.
 // Those are in place changes, the input lists are modified. 
 // The iouThreshold value is used to compare similarity between bounding boxes.
+// Boxes are processed by decreasing score (greedy NMS), a box is removed if
+// its IoU with a remaining box of greater score reaches iouThreshold.
+// The lists must hold at most 65535 elements.
 //
 // THIS FUNCTION DOESN'T PRESERVE ORDER OF THE LISTS' ELEMENTS.
 //
@@ -58,6 +74,9 @@ size_t FilterOutBelowIoUThreshold (
 // removed  elements are also removed from their respective lists.
 // Those are in place changes, the input lists are modified. 
 // The iouThreshold value is used to compare similarity between bounding boxes.
+// Boxes are processed by decreasing score (greedy NMS), a box is removed if
+// its IoU with a remaining box of greater score reaches iouThreshold.
+// The lists must hold at most 65535 elements.
 //
 // TWO BOXES BELONGING TO TWO DIFFERENT CLASSES WON'T BE COMPARED TO EACH OTHER
 //
@@ -0,0 +1,135 @@
+//=============================================================================
+//
+// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "postprocessing_fixed_point.h"
+
+#include "quick_select.h"
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+fp_postprocessing_config_t CreateFPPostprocessingConfig(
+    const int16_t *dataPtr,
+    int32_t fracBits,
+    RawToFPFunction rawToFP )
+{
+    fp_postprocessing_config_t config = {
+        .dataPtr = dataPtr,
+        .fracBits = fracBits,
+        .rawToFP = rawToFP
+    };
+    return config;
+}
+
+//-----------------------------------------------------------------------------
+//
+fp_postprocessing_config_t CreateQuantizedFPPostprocessingConfig(
+    const void *dataPtr,
+    raw_element_type_t elementType,
+    int32_t fracBits,
+    int32_t zeroPoint,
+    RawToFPFunction rawToFP )
+{
+    fp_postprocessing_config_t config = {
+        .dataPtr = dataPtr,
+        .fracBits = fracBits,
+        .rawToFP = rawToFP,
+        .elementType = elementType,
+        .zeroPoint = zeroPoint
+    };
+    return config;
+}
+
+//-----------------------------------------------------------------------------
+//
+void RawToFP(
+    const size_t *indices,
+    size_t size,
+    const fp_postprocessing_config_t *config,
+    fp_t *values )
+{
+    for( size_t i = 0; i < size; ++i )
+    {        
+        // Raw FP
+        values[i] = InterpretIntAsFP(
+            GetRawValue( config, indices[i] ), config->fracBits );
+        
+        // Mapping
+        if(config->rawToFP != NULL)
+        {
+            values[i] =
+                config->rawToFP( values[i] );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t FPToRawThreshold(
+    const fp_postprocessing_config_t *config,
+    fp_t threshold )
+{
+    // Binary search of the greatest stored value whose interpreted value is
+    // lesser than or equal to the threshold, low passes the test or is below
+    // the element type range and high fails it or is above that range.
+    int32_t low = config->elementType == RAW_ELEMENT_INT8
+        ? INT8_MIN - 1
+        : INT16_MIN - 1;
+    int32_t high = config->elementType == RAW_ELEMENT_INT8
+        ? INT8_MAX + 1
+        : INT16_MAX + 1;
+    while( high - low > 1 )
+    {
+        int32_t middle = low + ( high - low ) / 2;
+        fp_t value =
+            InterpretIntAsFP( middle - config->zeroPoint, config->fracBits );
+        if( config->rawToFP != NULL )
+        {
+            value = config->rawToFP( value );
+        }
+
+        if( FPLe( value, threshold ) )
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+//-----------------------------------------------------------------------------
+//
+size_t SelectRawAboveThreshold(
+    const fp_postprocessing_config_t *config,
+    size_t size,
+    fp_t threshold,
+    size_t k,
+    size_t *indices )
+{
+    int32_t rawThreshold = FPToRawThreshold( config, threshold );
+
+    if( config->elementType == RAW_ELEMENT_INT8 )
+    {
+        return HeapSelectAboveThresholdInt8(
+            indices, size, config->data8Ptr, rawThreshold, k );
+    }
+    return HeapSelectAboveThreshold(
+        indices, size, config->dataPtr, rawThreshold, k );
+}
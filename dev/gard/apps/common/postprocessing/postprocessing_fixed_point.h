@@ -0,0 +1,131 @@
+//=============================================================================
+//
+// Copyright(c) 2022 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef POSTPROCESSING_FIXED_POINT_H
+#define POSTPROCESSING_FIXED_POINT_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Function transforming raw fixed point into its interpreted value.
+// For example, it could be sigmoid applied to the raw value to get a
+// confidence score.
+typedef fp_t (*RawToFPFunction) ( fp_t ); 
+
+// Type of the values of a model output, as quantised by the model compiler.
+typedef enum
+{
+    RAW_ELEMENT_INT16 = 0, // int16 values, the default
+    RAW_ELEMENT_INT8       // int8 values, of networks quantised to 8 bits
+} raw_element_type_t;
+
+// Contains all data required to interpret an array of int16 or int8 values as
+// an array of fp_t.
+// A stored value s is interpreted as the fixed point number
+// (s - zeroPoint) / 2^fracBits. Configurations which only set dataPtr,
+// fracBits and rawToFP are int16 outputs without zero point.
+typedef struct
+{
+    union
+    {
+        const int16_t *dataPtr;    // pointer to an array containing raw data
+        const int8_t *data8Ptr;    // same, if elementType is RAW_ELEMENT_INT8
+    };
+    int32_t fracBits;        // since the raw data is signed fixed point,
+                                   // we need the number of fraction bits
+    RawToFPFunction rawToFP; // function to transform the raw data to fixed 
+                                   // point numbers
+    raw_element_type_t elementType; // type of the raw data values
+    int32_t zeroPoint;             // stored value of the raw value 0
+} fp_postprocessing_config_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+fp_postprocessing_config_t CreateFPPostprocessingConfig(
+    const int16_t *dataPtr, // pointer to an array containing raw data
+    const int32_t fracBits,       // number of fractional bits to use when interpreting
+                            // dataPtr values as fixed point numbers
+    const RawToFPFunction rawToFP ); // function to transform raw data to fixed point
+                               // numbers
+
+// Same as CreateFPPostprocessingConfig(), for a model output of any element
+// type, with a zero point, e.g. an int8 output read directly from the ML
+// engine instead of being widened to int16.
+fp_postprocessing_config_t CreateQuantizedFPPostprocessingConfig(
+    const void *dataPtr,            // pointer to an array of elementType values
+    raw_element_type_t elementType, // type of the dataPtr values
+    int32_t fracBits,               // number of fractional bits of the values
+    int32_t zeroPoint,              // stored value of the raw value 0
+    RawToFPFunction rawToFP );      // function to transform raw data to fixed
+                                    // point numbers
+
+// Returns the raw value at position index of the config data, its stored
+// value minus the zero point.
+static inline int32_t GetRawValue(
+    const fp_postprocessing_config_t *config, // postprocessing data
+    size_t index )                            // position in the raw data
+{
+    int32_t stored = config->elementType == RAW_ELEMENT_INT8
+        ? config->data8Ptr[index]
+        : config->dataPtr[index];
+    return stored - config->zeroPoint;
+}
+
+// Interpret some of the raw data to fixed point number.
+// The processed fixed point numbers are those located at the values contained
+// in array indices.
+// As an example, if indices = {4, 6, 1}, the function will process the 4th,
+// 6th and first position in the config.dataPtr array to create fixed point
+// numbers.
+void RawToFP(
+    const size_t *indices,                    // position to process in raw data
+    size_t size,                              // number of position to process
+    const fp_postprocessing_config_t *config, // postprocessing data
+    fp_t *values );                           // output array of fixed point
+                                              // numbers of size
+
+// Convert a threshold on the interpreted values to a threshold on the raw
+// data, so that the raw data can be compared directly without calling
+// config->rawToFP. config->rawToFP must be non-decreasing (sigmoid is), the
+// interpreted value of a stored value s is then lesser than or equal to
+// threshold if and only if s is lesser than or equal to the returned threshold.
+// The returned threshold is on the stored values, the zero point included.
+// It is below the element type range if no stored value passes that test.
+int32_t FPToRawThreshold(
+    const fp_postprocessing_config_t *config, // postprocessing data
+    fp_t threshold );                         // threshold on the interpreted
+                                              // values
+
+// Selects the indices of at most k values of the config data, among the first
+// size ones, whose interpreted values are greater than threshold, those with
+// the greatest values, with HeapSelectAboveThreshold() or its int8 version.
+// The raw data is compared directly to the threshold converted with
+// FPToRawThreshold(). It is assumed that indices points to an array of size k.
+// Returns the number of selected indices, in no particular order.
+size_t SelectRawAboveThreshold(
+    const fp_postprocessing_config_t *config, // postprocessing data
+    size_t size,                              // number of values to scan
+    fp_t threshold,                           // threshold on the interpreted
+                                              // values
+    size_t k,                                 // maximum number of indices
+    size_t *indices );                        // selected indices
+
+#endif
\ No newline at end of file
@@ -56,13 +56,14 @@ typedef struct
         fp_t zero = CreateFPInt( 0, raw[0].fracBits ); \
         fp_range_t originRange = argOriginRange; \
         fp_range_t imageRange = argImageRange; \
+        fp_affine_map_t map = CreateFPAffineMap( &originRange, &imageRange ); \
         \
-        fp_t R1 = FPMap( raw[0], &originRange, &imageRange ); \
-        fp_t R2 = FPMap( raw[1], &originRange, &imageRange ); \
-        fp_t R3 = FPMap( raw[2], &originRange, &imageRange ); \
-        fp_t R4 = FPMap( raw[3], &originRange, &imageRange ); \
-        fp_t R5 = FPMap( raw[4], &originRange, &imageRange ); \
-        fp_t R6 = FPMap( raw[5], &originRange, &imageRange ); \
+        fp_t R1 = FPApplyAffine( raw[0], &map ); \
+        fp_t R2 = FPApplyAffine( raw[1], &map ); \
+        fp_t R3 = FPApplyAffine( raw[2], &map ); \
+        fp_t R4 = FPApplyAffine( raw[3], &map ); \
+        fp_t R5 = FPApplyAffine( raw[4], &map ); \
+        fp_t R6 = FPApplyAffine( raw[5], &map ); \
          \
         CreateFPMat(V1, 3, 1, R1.fracBits ); \
         MatSet(V1, 0, 0, R1 ); \
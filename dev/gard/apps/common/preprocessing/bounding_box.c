@@ -47,3 +47,61 @@ pixel_box_t ComputeRoIFromBoundingBox(
         FPRound( FPAdd( box->bottom, scaledFrameThickness ) ) );
     return roi;
 }
+
+//-----------------------------------------------------------------------------
+// Maps a pixel coordinate of the source image to the captured image, clipped
+// to [0, capturedSize].
+static inline uint16_t SourceToCapturedCoordinate(
+    int32_t coordinate, int32_t sourceSize, int32_t capturedSize )
+{
+    int64_t mapped = (int64_t)coordinate * capturedSize / sourceSize;
+    mapped = mapped < 0 ? 0 : mapped;
+    mapped = mapped > capturedSize ? capturedSize : mapped;
+    return (uint16_t)mapped;
+}
+
+//-----------------------------------------------------------------------------
+//
+uint32_t ComputeRoIBatchFromBoundingBoxes(
+    const geometric_box_t *boxes,
+    size_t nbBoxes,
+    int32_t referenceFrameThickness,
+    const geometric_box_t *referenceBox,
+    int32_dim_t sourceImageDim,
+    int32_dim_t capturedImageDim,
+    struct roi_box *rois,
+    size_t *boxIndices,
+    uint32_t maxRoIs )
+{
+    uint32_t nbRoIs = 0;
+    for( size_t i = 0; i < nbBoxes && nbRoIs < maxRoIs; ++i )
+    {
+        pixel_box_t roi = ComputeRoIFromBoundingBox(
+            &boxes[i], referenceFrameThickness, referenceBox );
+
+        // The scaler crop bounds are left/upper inclusive and right/bottom
+        // exclusive, as the pixel box ones.
+        struct roi_box cropped = {
+            .left = SourceToCapturedCoordinate(
+                roi.left, sourceImageDim.width, capturedImageDim.width ),
+            .right = SourceToCapturedCoordinate(
+                roi.right, sourceImageDim.width, capturedImageDim.width ),
+            .upper = SourceToCapturedCoordinate(
+                roi.top, sourceImageDim.height, capturedImageDim.height ),
+            .bottom = SourceToCapturedCoordinate(
+                roi.bottom, sourceImageDim.height, capturedImageDim.height )
+        };
+        if( cropped.left >= cropped.right || cropped.upper >= cropped.bottom )
+        {
+            continue;
+        }
+
+        rois[nbRoIs] = cropped;
+        if( boxIndices != NULL )
+        {
+            boxIndices[nbRoIs] = i;
+        }
+        ++nbRoIs;
+    }
+    return nbRoIs;
+}
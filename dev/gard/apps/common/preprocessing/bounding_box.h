@@ -17,6 +17,7 @@
 // I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
 
 #include "box.h"
+#include "image_info.h"
 
 //=============================================================================
 // F U N C T I O N S   D E C L A R A T I O N S
@@ -36,4 +37,26 @@ pixel_box_t ComputeRoIFromBoundingBox(
                                            // side if bestRatio is 1
     const geometric_box_t *referenceBox ); // box to compare to to establish ratio
 
+// Fills rois with the regions of the captured image to crop and rescale for
+// a second-stage network, one per bounding box, to be passed as the p_rois of
+// run_network_on_rois_async(). The scaler then crops and rescales each region
+// straight into the network input, instead of the whole image being rescaled.
+// Each bounding box, in source image coordinates, is enlarged with
+// ComputeRoIFromBoundingBox, mapped to the captured image and clipped to it.
+// The boxes whose region is empty once clipped are left out. If boxIndices is
+// not NULL, it receives the index in boxes of the box of each region.
+// Returns the number of regions stored, at most maxRoIs.
+// It is assumed sourceImageDim contains values greater than zero.
+uint32_t ComputeRoIBatchFromBoundingBoxes(
+    const geometric_box_t *boxes,          // bounding boxes to crop
+    size_t nbBoxes,                        // number of bounding boxes
+    int32_t referenceFrameThickness,       // see ComputeRoIFromBoundingBox
+    const geometric_box_t *referenceBox,   // see ComputeRoIFromBoundingBox
+    int32_dim_t sourceImageDim,            // dimensions of the box coordinates
+                                           // system
+    int32_dim_t capturedImageDim,          // dimensions of the captured image
+    struct roi_box *rois,                  // regions to crop, of size maxRoIs
+    size_t *boxIndices,                    // NULL or array of size maxRoIs
+    uint32_t maxRoIs );                    // capacity of rois and boxIndices
+
 #endif
\ No newline at end of file
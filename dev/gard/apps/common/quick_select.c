@@ -0,0 +1,427 @@
+//=============================================================================
+//
+// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "quick_select.h"
+
+#include "app_assert.h"
+#include "errors.h"
+#include "int16_kernels.h"
+#include "types.h"
+#include "utils.h"
+
+// Number of scores HeapSelectAboveThreshold() compares to the threshold at once
+#define HEAP_SELECT_BLOCK_SIZE 64
+
+// Partitions QuickSelectKeyed() makes per bit of the array size before it
+// falls back to a heap sort
+#define QUICK_SELECT_DEPTH_PER_BIT 2
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//----------------------------------------------------------------------------
+// Swaps the elements at positions idx1 and idx2 in array.
+// It is assumed that idx1 and idx2 values are less than the array size and
+// greater than or equal to zero.
+static inline void Swap(
+    size_t *array, // Array to swap elements from
+    size_t idx1,   // index of the first element
+    size_t idx2)   // index of the second element
+{
+    size_t tmp;
+    tmp = array[idx1];
+    array[idx1] = array[idx2];
+    array[idx2] = tmp;
+}
+
+//----------------------------------------------------------------------------
+// Groups the indices in indices array into two groups such that :
+// - those whose associated value is greater than the value associated with
+//   pivot are placed at the left of pivot position ;
+// - those whose associated value is lesser than the value associated with
+//   pivot are places at the right of pivot position.
+// It is assumed that indices is an array containing one instance of each number
+// from 0 to size(indices)-1.
+// It is assumed that indices and confidence point to same-size arrays.
+// It is assumed that left <= right.
+// It is assumed that pivot, left and right values are lesser than the size of
+// the indices and confidences arrays and greater then 0.
+static size_t PartitionArray(
+    size_t *indices,           // Indices to partition
+    volatile const int16_t *score,      // Score values associated with indices
+    size_t left, size_t right, // Limits of the subarray we are partitioning
+    size_t pivot,              // Pivot index to partition around
+    bool descending)           // Partition values such that if true,
+                               // left values are greater than right and vice versa if false
+{
+    assert(
+        left <= right, EC_OUT_OF_BOUNDS,
+        "Left is greater than right: %d %d\r\n", left, right);
+
+    int16_t pivotValue = score[indices[pivot]];
+    Swap(indices, pivot, right);
+    size_t storeIndex = left;
+
+    for (size_t i = left; i <= right; ++i)
+    {
+        if (descending ? score[indices[i]] > pivotValue : score[indices[i]] < pivotValue)
+        {
+            Swap(indices, storeIndex, i);
+            storeIndex += 1;
+        }
+    }
+    Swap(indices, storeIndex, right);
+    return storeIndex;
+}
+
+//----------------------------------------------------------------------------
+//
+void QuickSelect(
+    size_t *indices,      // Indices of the confidence array
+    size_t arraySize,     // Size of the indices and confidence arrays
+    volatile const int16_t *score, // Contains the confidence of boxes
+    size_t k)             // Number of elements to select
+{
+    size_t left = 0;
+    size_t right = arraySize - 1;
+
+    if (right - left + 1 <= k)
+    {
+        return;
+    }
+
+    while (true)
+    {
+        if (left == right)
+        {
+            return;
+        }
+
+        size_t pivot = left + (right - left) / 2;
+        pivot = PartitionArray(indices, score, left, right, pivot, true);
+
+        if (k == pivot)
+        {
+            return;
+        }
+        else if (k < pivot)
+        {
+            right = pivot - 1;
+        }
+        else
+        {
+            left = pivot + 1;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Swaps the keys at positions idx1 and idx2 in keys.
+static inline void SwapKeys(
+    quick_select_key_t *keys, // Keys to swap elements from
+    size_t idx1,              // index of the first element
+    size_t idx2)              // index of the second element
+{
+    quick_select_key_t tmp = keys[idx1];
+    keys[idx1] = keys[idx2];
+    keys[idx2] = tmp;
+}
+
+//----------------------------------------------------------------------------
+// Returns the median of three scores.
+static inline int16_t MedianOfThree(int16_t a, int16_t b, int16_t c)
+{
+    if (a > b)
+    {
+        int16_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    // a <= b, the median is c clamped to [a, b]
+    return c < a ? a : (c > b ? b : c);
+}
+
+//----------------------------------------------------------------------------
+// Groups the keys in [left, right) such that those whose score is greater
+// than pivot, or equal to it if equal, come first. Returns the position of
+// the first key of the others.
+static inline size_t PartitionKeys(
+    quick_select_key_t *keys, // Keys to partition
+    size_t left, size_t right, // Limits of the subarray, right excluded
+    int16_t pivot,            // Score to partition around
+    bool equal)               // Put first the keys equal to pivot
+{
+    while (true)
+    {
+        while (left < right && (equal ? keys[left].score == pivot : keys[left].score > pivot))
+        {
+            ++left;
+        }
+        while (left < right && !(equal ? keys[right - 1].score == pivot : keys[right - 1].score > pivot))
+        {
+            --right;
+        }
+        if (left >= right)
+        {
+            return left;
+        }
+        SwapKeys(keys, left++, --right);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Moves down the key at position i of the min-heap of size heapSize until it
+// is not greater than its children.
+static void SiftDownKeys(
+    quick_select_key_t *keys, // Keys ordered as a min-heap
+    size_t heapSize,          // Number of keys in the heap
+    size_t i)                 // Position of the key to move down
+{
+    while (true)
+    {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+
+        if (left < heapSize && keys[left].score < keys[smallest].score)
+        {
+            smallest = left;
+        }
+        if (right < heapSize && keys[right].score < keys[smallest].score)
+        {
+            smallest = right;
+        }
+        if (smallest == i)
+        {
+            return;
+        }
+        SwapKeys(keys, i, smallest);
+        i = smallest;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Sorts keys by decreasing score, in O(size log(size)) whatever the scores.
+static void HeapSortKeysDescending(
+    quick_select_key_t *keys, // Keys to sort
+    size_t size)              // Number of keys
+{
+    for (size_t i = size / 2; i-- > 0;)
+    {
+        SiftDownKeys(keys, size, i);
+    }
+    // The lowest score of the heap goes to its end, then the next lowest...
+    for (size_t end = size - 1; end > 0; --end)
+    {
+        SwapKeys(keys, 0, end);
+        SiftDownKeys(keys, end, 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+//
+GARD__HOT void QuickSelectKeyed(
+    size_t *indices,
+    size_t arraySize,
+    volatile const int16_t *score,
+    size_t k,
+    quick_select_key_t *keys)
+{
+    if (arraySize <= k)
+    {
+        return;
+    }
+
+    assert(
+        arraySize <= (size_t)UINT16_MAX + 1, EC_OUT_OF_BOUNDS,
+        "Too many scores to select from: %d\r\n", arraySize);
+
+    // The scores are read once, the partitions then only compare the keys
+    for (size_t i = 0; i < arraySize; ++i)
+    {
+        keys[i].score = score[indices[i]];
+        keys[i].index = (uint16_t)indices[i];
+    }
+
+    size_t depth = 0;
+    for (size_t n = arraySize; n > 1; n >>= 1)
+    {
+        depth += QUICK_SELECT_DEPTH_PER_BIT;
+    }
+
+    size_t left = 0;
+    size_t right = arraySize; // Exclusive
+    while (right - left > 1)
+    {
+        if (depth == 0)
+        {
+            HeapSortKeysDescending(&keys[left], right - left);
+            break;
+        }
+        --depth;
+
+        int16_t pivot = MedianOfThree(
+            keys[left].score, keys[left + (right - left) / 2].score, keys[right - 1].score);
+
+        // Keys greater than the pivot go to [left, greater), then, if the
+        // k-th key is not among them, those equal to it to [greater, lesser)
+        // and the lesser ones to [lesser, right)
+        size_t greater = PartitionKeys(keys, left, right, pivot, false);
+        if (k < greater)
+        {
+            right = greater;
+            continue;
+        }
+
+        size_t lesser = PartitionKeys(keys, greater, right, pivot, true);
+        if (k <= lesser)
+        {
+            // The k first keys are the greater ones and some equal ones
+            break;
+        }
+        left = lesser;
+    }
+
+    for (size_t i = 0; i < arraySize; ++i)
+    {
+        indices[i] = keys[i].index;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Defines SiftDown##suffix(), which moves down the element at position i of
+// the min-heap of size heapSize until it is not greater than its children,
+// and name(), the heap selection of at most k scores above threshold, for
+// scores of type scoreType compared to the threshold by blocks with
+// compactAboveThreshold.
+// The int16 and int8 selections are the same code on different score types.
+#define DEFINE_HEAP_SELECT_ABOVE_THRESHOLD(name, suffix, scoreType, compactAboveThreshold) \
+static void SiftDown##suffix(                                                   \
+    size_t *heap,                    /* Indices ordered as a min-heap */        \
+    volatile const scoreType *score, /* Score values associated with indices */ \
+    size_t heapSize,                 /* Number of elements in the heap */       \
+    size_t i)                        /* Position of the element to move down */ \
+{                                                                               \
+    while (true)                                                                \
+    {                                                                           \
+        size_t smallest = i;                                                    \
+        size_t left = 2 * i + 1;                                                \
+        size_t right = left + 1;                                                \
+                                                                                \
+        if (left < heapSize && score[heap[left]] < score[heap[smallest]])       \
+        {                                                                       \
+            smallest = left;                                                    \
+        }                                                                       \
+        if (right < heapSize && score[heap[right]] < score[heap[smallest]])     \
+        {                                                                       \
+            smallest = right;                                                   \
+        }                                                                       \
+        if (smallest == i)                                                      \
+        {                                                                       \
+            return;                                                             \
+        }                                                                       \
+        Swap(heap, i, smallest);                                                \
+        i = smallest;                                                           \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+GARD__HOT size_t name(                                                          \
+    size_t *indices,                                                            \
+    size_t arraySize,                                                           \
+    volatile const scoreType *score,                                            \
+    int32_t threshold,                                                          \
+    size_t k)                                                                   \
+{                                                                               \
+    size_t heapSize = 0;                                                        \
+    size_t candidates[HEAP_SELECT_BLOCK_SIZE];                                  \
+                                                                                \
+    if (k == 0)                                                                 \
+    {                                                                           \
+        return 0;                                                               \
+    }                                                                           \
+                                                                                \
+    for (size_t first = 0; first < arraySize; first += HEAP_SELECT_BLOCK_SIZE)  \
+    {                                                                           \
+        size_t blockSize = arraySize - first < HEAP_SELECT_BLOCK_SIZE           \
+            ? arraySize - first                                                 \
+            : HEAP_SELECT_BLOCK_SIZE;                                           \
+                                                                                \
+        /* Once the heap is full, only values above its lowest one can enter */ \
+        int32_t blockThreshold = heapSize < k ? threshold : score[indices[0]];  \
+        size_t candidatesNb = compactAboveThreshold(                            \
+            (const scoreType *)&score[first], blockSize, blockThreshold,        \
+            candidates);                                                        \
+                                                                                \
+        for (size_t c = 0; c < candidatesNb; ++c)                               \
+        {                                                                       \
+            size_t index = first + candidates[c];                               \
+            scoreType value = score[index];                                     \
+                                                                                \
+            if (heapSize < k)                                                   \
+            {                                                                   \
+                /* Move the new element up until its parent is not greater */   \
+                size_t i = heapSize++;                                          \
+                indices[i] = index;                                             \
+                while (i > 0 && score[indices[(i - 1) / 2]] > value)            \
+                {                                                               \
+                    Swap(indices, i, (i - 1) / 2);                              \
+                    i = (i - 1) / 2;                                            \
+                }                                                               \
+            }                                                                   \
+            else if (value > score[indices[0]])                                 \
+            {                                                                   \
+                /* Replace the lowest selected element */                       \
+                indices[0] = index;                                             \
+                SiftDown##suffix(indices, score, heapSize, 0);                  \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    return heapSize;                                                            \
+}
+
+DEFINE_HEAP_SELECT_ABOVE_THRESHOLD(
+    HeapSelectAboveThreshold, Int16, int16_t, Int16CompactAboveThreshold)
+DEFINE_HEAP_SELECT_ABOVE_THRESHOLD(
+    HeapSelectAboveThresholdInt8, Int8, int8_t, Int8CompactAboveThreshold)
+
+void QuickSortImpl(
+    size_t *indices,
+    const int16_t *score,
+    size_t left,
+    size_t right)
+{
+    if (left < right)
+    {
+        size_t pivot = left + (right - left) / 2;
+        pivot = PartitionArray(indices, score, left, right, pivot, false);
+
+        if (pivot > 0) // To prevent size_t underflow
+        {
+            QuickSortImpl(indices, score, left, pivot - 1);
+        }
+        QuickSortImpl(indices, score, pivot + 1, right);
+    }
+}
+
+void QuickSort(
+    size_t *indices,
+    const int16_t *score,
+    size_t arraySize)
+{
+    if (arraySize > 0)
+    {
+        QuickSortImpl(indices, score, 0, arraySize - 1);
+    }
+}
\ No newline at end of file
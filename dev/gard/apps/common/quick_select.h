@@ -0,0 +1,103 @@
+//=============================================================================
+//
+// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#ifndef QUICK_SELECT_H
+#define QUICK_SELECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+//----------------------------------------------------------------------------
+// Performs the QuickSelect algorithm on the indices array based on the
+// values in the confidence array. This functions selects the indices
+// associated with the highest values of the confidence array.
+// See https://en.wikipedia.org/wiki/Quickselect for more details.
+// IMPORTANT: This function changes the array indices points to.
+// It is assumed that indices and confidence point to arrays of size arraySize.
+void QuickSelect(
+    size_t *indices,      // Indices of the confidence array
+    size_t arraySize,     // Size of the indices and confidence arrays
+    volatile const int16_t *score, // Contains the confidence of boxes
+    size_t k);            // Number of elements to select
+
+//----------------------------------------------------------------------------
+// A score and its index, the keys QuickSelectKeyed() partitions.
+typedef struct
+{
+    int16_t score;
+    uint16_t index;
+} quick_select_key_t;
+
+//----------------------------------------------------------------------------
+// Same selection as QuickSelect(), in time linear in arraySize whatever the
+// scores: it partitions (score, index) keys copied to keys, in three groups
+// around a median-of-three pivot, so that equal scores, e.g. the zeroed
+// scores of PostprocessCompactModel(), are set aside in a single pass. Too
+// many partitions fall back to a heap sort of the remaining keys.
+// IMPORTANT: This function changes the array indices points to.
+// It is assumed that indices and score point to arrays of size arraySize,
+// keys to an array of size arraySize, and arraySize to be at most
+// UINT16_MAX + 1.
+void QuickSelectKeyed(
+    size_t *indices,      // Indices of the confidence array
+    size_t arraySize,     // Size of the indices and confidence arrays
+    volatile const int16_t *score, // Contains the confidence of boxes
+    size_t k,             // Number of elements to select
+    quick_select_key_t *keys); // Work array of arraySize keys
+
+//----------------------------------------------------------------------------
+// Scans the score array once and selects the indices of at most k values of
+// the score array greater than threshold, those with the highest values.
+// The selected indices are kept in a min-heap of size k, so the function
+// does not need an array of all the indices like QuickSelect does.
+// The scores are compared to the threshold by blocks, with
+// Int16CompactAboveThreshold().
+// It is assumed that indices points to an array of size k.
+// The function returns the number of selected indices, the selected indices
+// are in no particular order.
+size_t HeapSelectAboveThreshold(
+    size_t *indices,      // Selected indices of the score array
+    size_t arraySize,     // Size of the score array
+    volatile const int16_t *score, // Contains the confidence of boxes
+    int32_t threshold,    // Values lesser than or equal to it are not selected
+    size_t k);            // Maximum number of elements to select
+
+//----------------------------------------------------------------------------
+// Same as HeapSelectAboveThreshold(), for int8 scores, e.g. the outputs of
+// networks quantised to 8 bits. The scores are compared to the threshold
+// with Int8CompactAboveThreshold().
+size_t HeapSelectAboveThresholdInt8(
+    size_t *indices,      // Selected indices of the score array
+    size_t arraySize,     // Size of the score array
+    volatile const int8_t *score, // Contains the confidence of boxes
+    int32_t threshold,    // Values lesser than or equal to it are not selected
+    size_t k);            // Maximum number of elements to select
+
+
+//----------------------------------------------------------------------------
+// Performs the Quicksort algorithm on the indices array based on the
+// values in the score array. This functions sorts the indices
+// in order of the lowest values of the score array.
+// IMPORTANT: This function changes the array indices points to.
+// It is assumed that indices and confidence point to arrays of size arraySize.
+void QuickSort(
+    size_t *indices,
+    const int16_t *score,
+    size_t arraySize);
+
+#endif
\ No newline at end of file
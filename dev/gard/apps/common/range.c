@@ -33,4 +33,37 @@ fp_t FPMap(
     result = FPDiv( result, originRangeSize );
     result = FPAdd( result, imageRange->min );
     return result;
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+// The scale is computed once with the divide FPMap() does for every point.
+fp_affine_map_t CreateFPAffineMap(
+    const fp_range_t *originRange, const fp_range_t *imageRange )
+{
+    fp_t originRangeSize = GetFPRangeSize( originRange );
+    fp_t imageRangeSize = GetFPRangeSize( imageRange );
+    assert( originRangeSize.n > 0, EC_ZERO_VALUE,
+        "CreateFPAffineMap: Empty origin range.\r\n" );
+
+    int64_t num = ( int64_t )imageRangeSize.n <<
+        ( FP_AFFINE_MAP_SCALE_FRAC_BITS + originRangeSize.fracBits );
+    int64_t den = ( int64_t )originRangeSize.n << imageRangeSize.fracBits;
+    fp_affine_map_t map = {
+        .originMin = originRange->min,
+        .imageMin = imageRange->min,
+        .scale = InterpretIntAsFP(
+            ( int32_t )( num / den ), FP_AFFINE_MAP_SCALE_FRAC_BITS ),
+        .isShift = false,
+        .shift = 0 };
+
+    // An exact power of two ratio, such as a network input half the size of
+    // the source image, needs no multiply.
+    uint32_t scale = ( uint32_t )map.scale.n;
+    if( num % den == 0 && scale != 0 && ( scale & ( scale - 1 ) ) == 0 )
+    {
+        map.isShift = true;
+        map.shift = ( int8_t )( __builtin_ctz( scale ) -
+            FP_AFFINE_MAP_SCALE_FRAC_BITS );
+    }
+    return map;
+}
@@ -30,9 +30,24 @@ typedef struct
     const fp_t max; // max is included in the range.
 } fp_range_t;
 
+// Affine function mapping an origin range to an image range, precomputed by
+// CreateFPAffineMap() so that FPApplyAffine() does not divide.
+typedef struct
+{
+    fp_t originMin;
+    fp_t imageMin;
+    fp_t scale;    // Image range size / origin range size, in
+                   // FP_AFFINE_MAP_SCALE_FRAC_BITS
+    bool isShift;  // The scale is a power of two, applied as a shift
+    int8_t shift;  // log2 of the scale when isShift, negative to shift right
+} fp_affine_map_t;
+
 //=============================================================================
 // M A C R O S   D E C L A R A T I O N S
 
+// Fractional bits of the scale of an fp_affine_map_t
+#define FP_AFFINE_MAP_SCALE_FRAC_BITS 16
+
 // Creates a literal fp_range_t struct. This is useful to initialize static or
 // global variables. literalFPMin and literalFPMax have to be literal fp_t
 // struct.
@@ -74,4 +89,29 @@ static inline fp_t GetFPRangeSize( const fp_range_t *range )
 // system.
 fp_t FPMap( 
     fp_t n, const fp_range_t *originRange, const fp_range_t *imageRange );
+
+// Precomputes the affine function of FPMap() from originRange to imageRange,
+// for ranges that are fixed over many points.
+// It is assumed originRange is not empty and both ranges use the same number
+// of fractional bits as the numbers to map.
+fp_affine_map_t CreateFPAffineMap(
+    const fp_range_t *originRange, const fp_range_t *imageRange );
+
+// Linearly maps n with an affine function from CreateFPAffineMap(), with a
+// multiply or a shift instead of the divide of FPMap(). Results may differ
+// from FPMap() by one lsb, from rounding.
+static inline fp_t FPApplyAffine( fp_t n, const fp_affine_map_t *map )
+{
+    fp_t result = FPSub( n, map->originMin );
+    if( map->isShift )
+    {
+        result = map->shift >= 0 ?
+            FPLShift( result, map->shift ) : FPRShift( result, -map->shift );
+    }
+    else
+    {
+        result = FPMul( result, map->scale );
+    }
+    return FPAdd( result, map->imageMin );
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "result_change.h"
+
+#include "box.h"
+#include "utils.h"
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+void InitResultChange(
+    result_change_t *change,
+    fp_t minIoU,
+    int32_t maxScoreDelta,
+    uint16_t heartbeatInterval )
+{
+    change->minIoU = FPToQ10( minIoU );
+    change->maxScoreDelta = maxScoreDelta;
+    change->heartbeatInterval = heartbeatInterval;
+    InvalidateResultChange( change );
+}
+
+//-----------------------------------------------------------------------------
+//
+void InvalidateResultChange( result_change_t *change )
+{
+    change->primed = false;
+    change->unchangedFrames = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the decision for results that are changed or not.
+static result_change_decision_t Decide(
+    result_change_t *change,
+    bool changed )
+{
+    if( changed || !change->primed )
+    {
+        change->primed = true;
+        change->unchangedFrames = 0;
+        return RESULT_CHANGE_SEND;
+    }
+
+    ++change->unchangedFrames;
+    if( change->heartbeatInterval != 0 &&
+        change->unchangedFrames >= change->heartbeatInterval )
+    {
+        change->unchangedFrames = 0;
+        return RESULT_CHANGE_HEARTBEAT;
+    }
+    return RESULT_CHANGE_SKIP;
+}
+
+//-----------------------------------------------------------------------------
+//
+static inline int32_t Abs32( int32_t value )
+{
+    return value < 0 ? -value : value;
+}
+
+//-----------------------------------------------------------------------------
+// Returns whether the object matches one of the sent objects not used yet,
+// and marks it used.
+static bool MatchSentObject(
+    const result_change_t *change,
+    const result_change_object_t *object,
+    bool *used )
+{
+    q10_box_t box = { object->left, object->top, object->right, object->bottom };
+
+    for( size_t i = 0; i < MIN( change->nbObjects, RESULT_CHANGE_MAX_OBJECTS );
+        ++i )
+    {
+        const result_change_object_t *sent = &change->objects[i];
+        q10_box_t sentBox = { sent->left, sent->top, sent->right, sent->bottom };
+
+        if( used[i] || sent->objectClass != object->objectClass ||
+            Abs32( sent->confidence - object->confidence ) >
+                change->maxScoreDelta ||
+            ComputeQ10IoU( &box, &sentBox ) < change->minIoU )
+        {
+            continue;
+        }
+        used[i] = true;
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//
+result_change_decision_t CheckObjectsChange(
+    result_change_t *change,
+    const int16_t *lefts,
+    const int16_t *tops,
+    const int16_t *rights,
+    const int16_t *bottoms,
+    const uint8_t *classes,
+    const int16_t *confidences,
+    const uint16_t *order,
+    size_t size )
+{
+    size_t compared = MIN( size, RESULT_CHANGE_MAX_OBJECTS );
+    result_change_object_t objects[RESULT_CHANGE_MAX_OBJECTS];
+    bool used[RESULT_CHANGE_MAX_OBJECTS] = { false };
+    bool changed = size != change->nbObjects;
+
+    for( size_t i = 0; i < compared; ++i )
+    {
+        uint16_t p = order[i];
+
+        objects[i] = ( result_change_object_t ){
+            lefts[p], tops[p], rights[p], bottoms[p], confidences[p],
+            classes[p] };
+        changed = changed || !MatchSentObject( change, &objects[i], used );
+    }
+
+    result_change_decision_t decision = Decide( change, changed );
+    if( decision == RESULT_CHANGE_SEND )
+    {
+        change->nbObjects = size;
+        for( size_t i = 0; i < compared; ++i )
+        {
+            change->objects[i] = objects[i];
+        }
+    }
+    return decision;
+}
+
+//-----------------------------------------------------------------------------
+//
+result_change_decision_t CheckScoreChange(
+    result_change_t *change,
+    int32_t score,
+    bool verdict )
+{
+    bool changed = verdict != change->verdict ||
+        Abs32( score - change->score ) > change->maxScoreDelta;
+
+    result_change_decision_t decision = Decide( change, changed );
+    if( decision == RESULT_CHANGE_SEND )
+    {
+        change->score = score;
+        change->verdict = verdict;
+    }
+    return decision;
+}
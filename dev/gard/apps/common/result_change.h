@@ -0,0 +1,106 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef RESULT_CHANGE_H
+#define RESULT_CHANGE_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fixed_point.h"
+#include "types.h" // instead of std bool
+
+//=============================================================================
+// C O N S T A N T S
+
+// Number of objects, of greatest confidence, compared between two frames
+#define RESULT_CHANGE_MAX_OBJECTS 16
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+typedef enum
+{
+    RESULT_CHANGE_SEND = 0,  // The results changed, send them
+    RESULT_CHANGE_HEARTBEAT, // Unchanged for heartbeatInterval frames, send
+                             // a heartbeat
+    RESULT_CHANGE_SKIP       // Unchanged, send nothing
+} result_change_decision_t;
+
+// A result object, with the same box coordinates and confidence as the
+// detections given to CheckObjectsChange()
+typedef struct
+{
+    int16_t left;
+    int16_t top;
+    int16_t right;
+    int16_t bottom;
+    int16_t confidence;
+    uint8_t objectClass;
+} result_change_object_t;
+
+// Compares the results of each frame with the last ones sent.
+typedef struct
+{
+    q21_10_t minIoU;           // Lower box IoU is a change
+    int32_t maxScoreDelta;     // Greater confidence or score change is a change
+    uint16_t heartbeatInterval; // Unchanged frames between heartbeats, 0 for
+                                // none
+    uint16_t unchangedFrames;  // Frames since the last results or heartbeat
+    bool primed;               // Results were sent
+    uint16_t nbObjects;        // Last sent results
+    result_change_object_t objects[RESULT_CHANGE_MAX_OBJECTS];
+    int32_t score;
+    bool verdict;
+} result_change_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Sets the thresholds of what is a change. The next results are sent.
+void InitResultChange(
+    result_change_t *change,
+    fp_t minIoU,
+    int32_t maxScoreDelta,
+    uint16_t heartbeatInterval );
+
+// Makes the next results be sent, e.g. after the last ones could not be.
+void InvalidateResultChange( result_change_t *change );
+
+// Compares the detections, the first RESULT_CHANGE_MAX_OBJECTS of order, with
+// the last sent ones. They are unchanged if there are as many, and each matches
+// a distinct sent object of the same class, with a box IoU of at least minIoU
+// and a confidence within maxScoreDelta. The detections are kept as the last
+// sent ones if the decision is RESULT_CHANGE_SEND.
+result_change_decision_t CheckObjectsChange(
+    result_change_t *change,
+    const int16_t *lefts,
+    const int16_t *tops,
+    const int16_t *rights,
+    const int16_t *bottoms,
+    const uint8_t *classes,
+    const int16_t *confidences,
+    const uint16_t *order,
+    size_t size );
+
+// Compares a score and its verdict with the last sent ones. They are unchanged
+// if the verdict is the same and the score within maxScoreDelta. They are kept
+// as the last sent ones if the decision is RESULT_CHANGE_SEND.
+result_change_decision_t CheckScoreChange(
+    result_change_t *change,
+    int32_t score,
+    bool verdict );
+
+#endif
@@ -0,0 +1,116 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "score_filter.h"
+
+#include <stddef.h>
+
+#include "quick_select.h"
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+bool InitScoreFilter(
+    score_filter_t *filter,
+    score_filter_mode_t mode,
+    uint8_t windowLog2 )
+{
+    if( mode >= SCORE_FILTER_MODES_NB ||
+        windowLog2 > SCORE_FILTER_MAX_WINDOW_LOG2 )
+    {
+        return false;
+    }
+
+    filter->mode = mode;
+    filter->windowLog2 = windowLog2;
+    ResetScoreFilter( filter );
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+void ResetScoreFilter( score_filter_t *filter )
+{
+    filter->head = 0;
+    filter->primed = false;
+    filter->accum = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the median of the window, the smallest of its (n + 1) / 2 greatest
+// scores.
+static int32_t GetWindowMedian( const score_filter_t *filter )
+{
+    size_t windowSize = ( size_t )1 << filter->windowLog2;
+    size_t k = ( windowSize + 1 ) / 2;
+    int16_t scores[SCORE_FILTER_MAX_WINDOW];
+    size_t indices[SCORE_FILTER_MAX_WINDOW];
+
+    for( size_t i = 0; i < windowSize; ++i )
+    {
+        scores[i] = ( int16_t )filter->scores[i];
+        indices[i] = i;
+    }
+    QuickSelect( indices, windowSize, scores, k );
+
+    int16_t median = scores[indices[0]];
+    for( size_t i = 1; i < k; ++i )
+    {
+        median = scores[indices[i]] < median ? scores[indices[i]] : median;
+    }
+    return median;
+}
+
+//-----------------------------------------------------------------------------
+//
+int32_t UpdateScoreFilter( score_filter_t *filter, int32_t score )
+{
+    uint8_t windowSize = 1 << filter->windowLog2;
+
+    if( !filter->primed )
+    {
+        // Fill the window with the first score
+        for( uint8_t i = 0; i < windowSize; ++i )
+        {
+            filter->scores[i] = score;
+        }
+        filter->accum = score << filter->windowLog2;
+        filter->head = 0;
+        filter->primed = true;
+        return score;
+    }
+
+    switch( filter->mode )
+    {
+    case SCORE_FILTER_EMA:
+        // accum is the EMA scaled by windowSize
+        filter->accum += score - ( filter->accum >> filter->windowLog2 );
+        return filter->accum >> filter->windowLog2;
+
+    case SCORE_FILTER_MEDIAN:
+        filter->scores[filter->head] = score;
+        filter->head = ( filter->head + 1 ) & ( windowSize - 1 );
+        return GetWindowMedian( filter );
+
+    case SCORE_FILTER_MEAN:
+    default:
+        filter->accum += score - filter->scores[filter->head];
+        filter->scores[filter->head] = score;
+        filter->head = ( filter->head + 1 ) & ( windowSize - 1 );
+        return filter->accum >> filter->windowLog2;
+    }
+}
@@ -0,0 +1,73 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef SCORE_FILTER_H
+#define SCORE_FILTER_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stdint.h>
+#include "types.h" // instead of std bool
+
+//=============================================================================
+// C O N S T A N T S
+
+// The window of a score filter is 1 << windowLog2 scores, up to
+// 1 << SCORE_FILTER_MAX_WINDOW_LOG2
+#define SCORE_FILTER_MAX_WINDOW_LOG2    4
+#define SCORE_FILTER_MAX_WINDOW         ( 1 << SCORE_FILTER_MAX_WINDOW_LOG2 )
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+typedef enum
+{
+    SCORE_FILTER_MEAN = 0, // Mean of the window, by a shift
+    SCORE_FILTER_EMA,      // Exponential moving average of weight
+                           // 1 / (1 << windowLog2)
+    SCORE_FILTER_MEDIAN,   // Median of the window, the upper one if even
+    SCORE_FILTER_MODES_NB
+} score_filter_mode_t;
+
+// Smooths a stream of integer scores. The first score fills the whole window,
+// so that the output is valid from the first score on.
+typedef struct
+{
+    score_filter_mode_t mode;
+    uint8_t windowLog2;
+    uint8_t head;   // Position of the next score in scores
+    bool primed;    // The window holds scores
+    int32_t accum;  // Sum of the window, or EMA scaled by 1 << windowLog2
+    int32_t scores[SCORE_FILTER_MAX_WINDOW];
+} score_filter_t;
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Sets the mode and the window of the filter and empties it.
+// Returns false, leaving the filter unchanged, if the mode or window is not
+// supported.
+bool InitScoreFilter(
+    score_filter_t *filter,
+    score_filter_mode_t mode,
+    uint8_t windowLog2 );
+
+// Empties the filter, the next score fills its window again.
+void ResetScoreFilter( score_filter_t *filter );
+
+// Adds a score to the filter and returns the filtered score.
+// The scores are assumed to fit in int16 for the median, and their sum over the
+// window in int32.
+int32_t UpdateScoreFilter( score_filter_t *filter, int32_t score );
+
+#endif
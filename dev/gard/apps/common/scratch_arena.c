@@ -0,0 +1,76 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "scratch_arena.h"
+
+#include "app_assert.h"
+#include "errors.h"
+
+//=============================================================================
+// V A R I A B L E S
+
+// The arena is in its own section, .app_scratch, so that the linker map shows
+// it apart from the rest of .bss.
+static uint8_t scratchArena[SCRATCH_ARENA_SIZE]
+    __attribute__(( section( ".app_scratch" ), aligned( 8 ) ));
+static size_t scratchUsed = 0;
+static size_t scratchPeak = 0;
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+//
+void *ScratchAlloc( size_t size )
+{
+    size_t start = ( scratchUsed + 7 ) & ~( size_t )7;
+
+    assert_rel( size <= SCRATCH_ARENA_SIZE - start, EC_LIMITED_RESOURCE_SHORTAGE,
+        "Scratch arena exhausted: %d + %d bytes\r\n", start, size );
+
+    scratchUsed = start + size;
+    scratchPeak = scratchUsed > scratchPeak ? scratchUsed : scratchPeak;
+    return &scratchArena[start];
+}
+
+//-----------------------------------------------------------------------------
+//
+scratch_mark_t ScratchMark( void )
+{
+    return scratchUsed;
+}
+
+//-----------------------------------------------------------------------------
+//
+void ScratchRelease( scratch_mark_t mark )
+{
+    assert( mark <= scratchUsed, EC_RELEASING_NON_ALLOCATED_RESOURCE,
+        "Scratch arena released above its use: %d %d\r\n", mark, scratchUsed );
+    scratchUsed = mark;
+}
+
+//-----------------------------------------------------------------------------
+//
+void ScratchReset( void )
+{
+    scratchUsed = 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+size_t ScratchPeak( void )
+{
+    return scratchPeak;
+}
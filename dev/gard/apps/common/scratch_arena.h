@@ -0,0 +1,64 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=============================================================================
+// C O N S T A N T S
+
+// Size of the scratch arena in bytes. It holds the per-frame work arrays of the
+// post-processing, which would not fit the 8 KiB stack, e.g. the NMS of 500
+// boxes needs about 14 KiB.
+#ifndef SCRATCH_ARENA_SIZE
+#define SCRATCH_ARENA_SIZE ( 16 * 1024 )
+#endif
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Position of the arena to release to, see ScratchMark()
+typedef size_t scratch_mark_t;
+
+//=============================================================================
+// M A C R O S
+
+#define ScratchAllocArray( type, count ) \
+    ( ( type * )ScratchAlloc( sizeof( type ) * ( count ) ) )
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Returns size bytes of the arena, aligned on 8 bytes. Running out of arena is
+// a fatal error, the arena size being a build time bound of the post-processing.
+void *ScratchAlloc( size_t size );
+
+// Returns the current position of the arena, to release what is allocated
+// after it with ScratchRelease().
+scratch_mark_t ScratchMark( void );
+
+// Releases what was allocated since mark was taken.
+void ScratchRelease( scratch_mark_t mark );
+
+// Releases the whole arena, at the start of the processing of a frame.
+void ScratchReset( void );
+
+// Returns the greatest number of bytes of the arena used at once so far.
+size_t ScratchPeak( void );
+
+#endif
@@ -14,6 +14,8 @@
 //=============================================================================
 // I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
 
+#include <stddef.h>
+
 #include "defect_detection_module.h"
 #include "app_module.h"
 #include "memmap.h"
@@ -24,6 +26,10 @@
 #include "assert.h"
 #include "camera_config.h"
 #include "utils.h"
+#include "result_packet.h"
+#include "result_change.h"
+#include "cpu.h"
+#include "gard_hub_iface.h"
 
 
 //=============================================================================
@@ -31,13 +37,124 @@
 
 #define APP_MODULE_OUTPUT_SIZE    34  // bytes
 
+// The heatmap of the patches goes in the compact result packet only
+#if DEFECT_DETECTION_PATCH_GRID > 0 && defined(RESULT_PACKET_COMPACT)
+#define APP_MODULE_HEATMAP_SIZE   RESULT_PACKET_HEATMAP_SIZE(DEFECT_DETECTION_NB_PATCHES)
+#else
+#define APP_MODULE_HEATMAP_SIZE   0
+#endif
+
+// With SUPPRESS_UNCHANGED_RESULTS, the result is only sent when the verdict
+// changes or the score moves by more than RESULT_CHANGE_MAX_SCORE_DELTA. Every
+// RESULT_CHANGE_HEARTBEAT_FRAMES unchanged frames, a heartbeat is sent: an
+// unchanged record with the compact result packet, the result again with the
+// legacy one.
+#define RESULT_CHANGE_MAX_SCORE_DELTA   20  // 0.02, with FRAC_BITS
+#define RESULT_CHANGE_HEARTBEAT_FRAMES  30
+
+// One more output buffer than FW Core queues, so that one is always free
+#define APP_MODULE_OUTPUT_NB      (APP_TX_QUEUE_DEPTH + 1)
+
+// Most parts inspected per frame, see DEFECT_DETECTION_CMD_SET_ROIS
+#ifndef DEFECT_DETECTION_MAX_ROIS
+#define DEFECT_DETECTION_MAX_ROIS           6
+#endif
+
+// The results of the ROIs go in the compact result packet only, each an
+// object record, its ROI and index, then its score and heatmap records
+#ifdef RESULT_PACKET_COMPACT
+#define APP_MODULE_ROI_RESULT_SIZE \
+    (RESULT_PACKET_MAX_OBJECT_SIZE + 8 + APP_MODULE_HEATMAP_SIZE)
+#define APP_MODULE_ROI_RESULTS_SIZE \
+    (DEFECT_DETECTION_MAX_ROIS * APP_MODULE_ROI_RESULT_SIZE)
+#else
+#define APP_MODULE_ROI_RESULTS_SIZE 0
+#endif
+
+// The vector of the image, then those of the patches
+#define DEFECT_DETECTION_OUTPUT_SIZE_16B \
+    ((1 + DEFECT_DETECTION_NB_PATCHES) * DEFECT_DETECTION_VECTOR_SIZE_16B)
+
+// Module holding the reference vectors and the score threshold
+#define DEFECT_DETECTION_REF_MODULE_UID     0x5001
+
+// Host command enrolling the output vector of the last frame as a reference
+// vector, and saving the reference vectors to flash. Its body is the index of
+// the reference vector to replace, the number of registered vectors to add
+// one, in the low 16 bits, and the index of the ROI in the high 16 bits, 0
+// when the whole image is inspected. With DEFECT_DETECTION_PATCH_GRID, the
+// patch vectors of the frame become the patch references too.
+#define DEFECT_DETECTION_CMD_ENROL          (APP_COMMAND_ID_FIRST + 0)
+
+// Host command setting the ROIs inspected from the next frame on, one part
+// each, see defect_detection_rois_t. Each ROI is rescaled to the network
+// input and has its own reference vectors, threshold and score filter, ROI i
+// saved at i times the size of defect_detection_refs_t in the module. No ROI
+// goes back to inspecting the whole image, with the references of ROI 0.
+#define DEFECT_DETECTION_CMD_SET_ROIS       (APP_COMMAND_ID_FIRST + 1)
+
+// Status of DEFECT_DETECTION_CMD_ENROL
+#define ENROL_STATUS_SUCCESS                0
+#define ENROL_STATUS_NO_FRAME               1
+#define ENROL_STATUS_BAD_INDEX              2
+#define ENROL_STATUS_WRITE_FAILED           3
+
+// Status of DEFECT_DETECTION_CMD_SET_ROIS
+#define ROIS_STATUS_SUCCESS                 0
+#define ROIS_STATUS_BAD_COUNT               1
+#define ROIS_STATUS_BAD_ROI                 2
+#define ROIS_STATUS_UNSUPPORTED             3  // Legacy result packets
+
+// Marks the reference vector norms saved after the threshold, "DDN1"
+#define DEFECT_DETECTION_NORMS_SIGNATURE    0x314E4444U
+
+// Contents of the reference vector module. The original modules end with the
+// threshold; the norms are saved after it when the module has room for them,
+// so that they are not computed again at every start.
+typedef struct {
+    int16_t refVectors[DEFECT_DETECTION_NB_REF_IMAGE][DEFECT_DETECTION_VECTOR_SIZE_16B];
+    int32_t rawThreshold;
+    uint32_t normsSignature;
+    uint32_t nbRefVectors;
+    uint32_t refVectorNorms[DEFECT_DETECTION_NB_REF_IMAGE];
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    uint32_t nbPatches;  // DEFECT_DETECTION_NB_PATCHES if the patches are set
+    int16_t patchRefVectors[DEFECT_DETECTION_NB_PATCHES][DEFECT_DETECTION_VECTOR_SIZE_16B];
+#endif
+} defect_detection_refs_t;
+
+#define DEFECT_DETECTION_REFS_LEGACY_SIZE   offsetof(defect_detection_refs_t, normsSignature)
+
+// Body of DEFECT_DETECTION_CMD_SET_ROIS, the ROIs in the source image
+// coordinates. Only the first nbRois are used.
 typedef struct {
-    defect_detection_t defectDetection;
+    uint32_t nbRois;
+    struct roi_box rois[DEFECT_DETECTION_MAX_ROIS];
+} defect_detection_rois_t;
+
+typedef struct {
+    // One per ROI, the first one also inspects the whole image
+    defect_detection_t defectDetection[DEFECT_DETECTION_MAX_ROIS];
     struct network_info defectDetectionNetworkInfo;
-    defect_detection_result_t defectDetectionResult;
-    unsigned char output[APP_MODULE_OUTPUT_SIZE + 3]; // +3 for start flag and length
-    uint8_t streamComplete;
-    uint32_t skipOutputNb;
+    defect_detection_result_t defectDetectionResult[DEFECT_DETECTION_MAX_ROIS];
+    uint32_t nbResults;  // ROIs of the results, 0 for the whole image
+    unsigned char output[APP_MODULE_OUTPUT_NB][APP_MODULE_OUTPUT_SIZE + 3 + APP_MODULE_HEATMAP_SIZE + APP_MODULE_ROI_RESULTS_SIZE]; // +3 for start flag and length
+    uint8_t streamComplete[APP_MODULE_OUTPUT_NB];
+    uint32_t outputIdx;
+    uint32_t frameSequence;
+    uint32_t frameTimestampMs;
+    result_change_t resultChange;
+    // Output of the network for each ROI of the last frame, or for the image
+    int16_t lastVectors[DEFECT_DETECTION_MAX_ROIS][DEFECT_DETECTION_OUTPUT_SIZE_16B];
+    uint32_t nbLastVectors;
+    // Written by the batch of ROIs while it runs
+    int16_t batchVectors[DEFECT_DETECTION_MAX_ROIS][DEFECT_DETECTION_OUTPUT_SIZE_16B];
+    defect_detection_rois_t rois;         // Inspected from this frame
+    defect_detection_rois_t pendingRois;  // From the next frame, if roisPending
+    bool roisPending;
+    defect_detection_rois_t roisBody;     // Body of DEFECT_DETECTION_CMD_SET_ROIS
+    uint32_t enrolIndex;  // Body of DEFECT_DETECTION_CMD_ENROL
+    defect_detection_refs_t refs;  // Staging of the module read and write
 } app_module_context_t;
 
 
@@ -62,49 +179,245 @@ app_handle_t app_preinit(void)
 {
     static app_module_context_t appCtxt;
 
-    appCtxt.defectDetection = InitDefectDetection();
+    for( uint32_t i = 0; i < DEFECT_DETECTION_MAX_ROIS; ++i )
+    {
+        appCtxt.defectDetection[i] = InitDefectDetection();
+    }
 
     return (app_handle_t)&appCtxt;
 }
 
 
+//-----------------------------------------------------------------------------
+// Offset in the module of the references of an ROI
+static inline uint32_t GetReferenceVectorsOffset(uint32_t roi)
+{
+    return DEFECT_DETECTION_NETWORK_REF_VECTOR_OFFSET
+        + roi * sizeof(defect_detection_refs_t);
+}
+
+
+//-----------------------------------------------------------------------------
+// Registers the reference vectors and the threshold of an ROI from the module.
+// The saved norms are used if the module has them, else they are computed.
+// Only ROI 0 is read from the original modules, without the norms. Returns
+// false if the ROI has no reference vector.
+static bool LoadReferenceVectors(app_module_context_t *appCtxt, uint32_t roi)
+{
+    defect_detection_t *defectDetection = &appCtxt->defectDetection[roi];
+    defect_detection_refs_t *refs = &appCtxt->refs;
+    uint32_t bytesNb = read_module_data(
+        DEFECT_DETECTION_REF_MODULE_UID,
+        GetReferenceVectorsOffset(roi),
+        sizeof(*refs),
+        (uint8_t *)refs);
+
+    if( bytesNb == sizeof(*refs)
+        && refs->normsSignature == DEFECT_DETECTION_NORMS_SIGNATURE
+        && refs->nbRefVectors <= DEFECT_DETECTION_NB_REF_IMAGE )
+    {
+        for( uint32_t i = 0; i < refs->nbRefVectors; ++i )
+        {
+            AddReferenceVectorWithNorm( defectDetection,
+                                        refs->refVectors[i],
+                                        refs->refVectorNorms[i] );
+        }
+#if DEFECT_DETECTION_PATCH_GRID > 0
+        if( refs->nbPatches == DEFECT_DETECTION_NB_PATCHES )
+        {
+            SetPatchReferenceVectors( defectDetection,
+                                      &refs->patchRefVectors[0][0] );
+        }
+#endif
+    }
+    else if( roi == 0 )
+    {
+        for( uint32_t i = 0; i < DEFECT_DETECTION_NB_REF_IMAGE; ++i )
+        {
+            if( bytesNb >= (i + 1) * sizeof(refs->refVectors[0]) )
+            {
+                AddReferenceVector( defectDetection, refs->refVectors[i] );
+            }
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if( bytesNb >= DEFECT_DETECTION_REFS_LEGACY_SIZE )
+    {
+        UpdateThreshold( defectDetection, refs->rawThreshold );
+    }
+
+    return defectDetection->output.nbRegisteredVectors > 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Writes the registered reference vectors, the threshold and the norms of an
+// ROI to the module. Modules made without room for the norms get the first
+// two only, of ROI 0.
+static bool SaveReferenceVectors(app_module_context_t *appCtxt, uint32_t roi)
+{
+    const defect_detection_postprocessor_t *output = &appCtxt->defectDetection[roi].output;
+    defect_detection_refs_t *refs = &appCtxt->refs;
+
+    memset(refs, 0, sizeof(*refs));
+    memcpy(refs->refVectors, output->refVectors, sizeof(refs->refVectors));
+    memcpy(refs->refVectorNorms, output->refVectorNorms, sizeof(refs->refVectorNorms));
+    refs->rawThreshold = ConvertFP(output->scoreThreshold, FRAC_BITS).n;
+    refs->normsSignature = DEFECT_DETECTION_NORMS_SIGNATURE;
+    refs->nbRefVectors = output->nbRegisteredVectors;
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    if( output->hasPatchRefVectors )
+    {
+        refs->nbPatches = DEFECT_DETECTION_NB_PATCHES;
+        memcpy(refs->patchRefVectors, output->patchRefVectors, sizeof(refs->patchRefVectors));
+    }
+#endif
+
+    if( write_module_data( DEFECT_DETECTION_REF_MODULE_UID,
+                           GetReferenceVectorsOffset(roi),
+                           sizeof(*refs),
+                           (const uint8_t *)refs ) == sizeof(*refs) )
+    {
+        return true;
+    }
+
+    // Without the norms, all the slots are loaded back: only a full set holds
+    return roi == 0
+        && output->nbRegisteredVectors == DEFECT_DETECTION_NB_REF_IMAGE
+        && write_module_data( DEFECT_DETECTION_REF_MODULE_UID,
+                              DEFECT_DETECTION_NETWORK_REF_VECTOR_OFFSET,
+                              DEFECT_DETECTION_REFS_LEGACY_SIZE,
+                              (const uint8_t *)refs ) == DEFECT_DETECTION_REFS_LEGACY_SIZE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Handles DEFECT_DETECTION_CMD_ENROL. Saving to flash blocks the main loop
+// while the sectors of the module are erased and programmed.
+static uint32_t EnrolLastVector(app_handle_t appContext, uint8_t commandId,
+                                uint8_t *body, uint32_t bodySize)
+{
+    app_module_context_t *appCtxt = (app_module_context_t *)appContext;
+    uint32_t index = appCtxt->enrolIndex & 0xFFFFU;
+    uint32_t roi = appCtxt->enrolIndex >> 16;
+
+    if( appCtxt->nbLastVectors == 0 )
+    {
+        return ENROL_STATUS_NO_FRAME;
+    }
+
+    if( index > UINT8_MAX
+        || roi >= appCtxt->nbLastVectors
+        || !ReplaceReferenceVector( &appCtxt->defectDetection[roi],
+                                    (uint8_t)index,
+                                    appCtxt->lastVectors[roi] ) )
+    {
+        return ENROL_STATUS_BAD_INDEX;
+    }
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    // A single set of patch references, from the last frame enrolled
+    SetPatchReferenceVectors( &appCtxt->defectDetection[roi],
+                              &appCtxt->lastVectors[roi][DEFECT_DETECTION_VECTOR_SIZE_16B] );
+#endif
+
+    return SaveReferenceVectors(appCtxt, roi)
+        ? ENROL_STATUS_SUCCESS
+        : ENROL_STATUS_WRITE_FAILED;
+}
+
+
+//-----------------------------------------------------------------------------
+// Handles DEFECT_DETECTION_CMD_SET_ROIS. The ROIs are taken at the start of
+// the next frame, so that the results of a frame are those of its ROIs.
+static uint32_t SetRoIs(app_handle_t appContext, uint8_t commandId,
+                        uint8_t *body, uint32_t bodySize)
+{
+    app_module_context_t *appCtxt = (app_module_context_t *)appContext;
+    const defect_detection_rois_t *rois = &appCtxt->roisBody;
+
+    if( rois->nbRois > DEFECT_DETECTION_MAX_ROIS )
+    {
+        return ROIS_STATUS_BAD_COUNT;
+    }
+#ifndef RESULT_PACKET_COMPACT
+    if( rois->nbRois > 0 )
+    {
+        return ROIS_STATUS_UNSUPPORTED;
+    }
+#endif
+
+    for( uint32_t i = 0; i < rois->nbRois; ++i )
+    {
+        const struct roi_box *roi = &rois->rois[i];
+        if( roi->left >= roi->right || roi->upper >= roi->bottom
+            || roi->right > SOURCE_IMAGE_ROI.right
+            || roi->bottom > SOURCE_IMAGE_ROI.bottom )
+        {
+            return ROIS_STATUS_BAD_ROI;
+        }
+    }
+
+    appCtxt->pendingRois = *rois;
+    appCtxt->roisPending = true;
+    return ROIS_STATUS_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// Inspects the ROIs set by DEFECT_DETECTION_CMD_SET_ROIS from this frame on.
+// The scores of the parts of the previous ROIs are not carried over.
+static void ApplyPendingRoIs(app_module_context_t *ctxt)
+{
+    ctxt->rois = ctxt->pendingRois;
+    ctxt->roisPending = false;
+
+    for( uint32_t i = 0; i < DEFECT_DETECTION_MAX_ROIS; ++i )
+    {
+        ResetScoreFilter( &ctxt->defectDetection[i].output.scoreFilter );
+    }
+    InvalidateResultChange(&ctxt->resultChange);
+}
+
+
 //-----------------------------------------------------------------------------
 //
 app_handle_t app_init(app_handle_t appContext)
 {
     app_module_context_t *appCtxt = (app_module_context_t *)appContext;
-    appCtxt->streamComplete = true;
-    appCtxt->skipOutputNb = 0;
-
-    // Add reference vectors
-    int16_t __attribute__((aligned(4))) rawRefVector[DEFECT_DETECTION_VECTOR_SIZE_16B];
-    for(uint8_t i=0; i < DEFECT_DETECTION_NB_REF_IMAGE; ++i)
-    {
-        uint32_t bytesNb = read_module_data( 
-            0x5001, 
-            DEFECT_DETECTION_NETWORK_REF_VECTOR_OFFSET + i*DEFECT_DETECTION_VECTOR_SIZE_16B*2, 
-            DEFECT_DETECTION_VECTOR_SIZE_16B*2, 
-            (uint8_t *)rawRefVector);
-        if(bytesNb == DEFECT_DETECTION_VECTOR_SIZE_16B*2)
-        { 
-            AddReferenceVector( &appCtxt->defectDetection, rawRefVector );
-        }
+    for( uint32_t i = 0; i < APP_MODULE_OUTPUT_NB; ++i )
+    {
+        appCtxt->streamComplete[i] = true;
     }
-    
-    // Read threshold
-    int32_t __attribute__((aligned(4))) rawThreshold;
-    uint32_t bytesNb = read_module_data( 
-        0x5001, 
-        DEFECT_DETECTION_NETWORK_REF_VECTOR_OFFSET + DEFECT_DETECTION_NB_REF_IMAGE*DEFECT_DETECTION_VECTOR_SIZE_16B*2, 
-        4, 
-        (uint8_t *)&rawThreshold);
-    
-    if(bytesNb == 4)
+    appCtxt->outputIdx = 0;
+    InitResultChange(&appCtxt->resultChange, CreateFPInt(0, FRAC_BITS),
+                     RESULT_CHANGE_MAX_SCORE_DELTA,
+                     RESULT_CHANGE_HEARTBEAT_FRAMES);
+
+    LoadReferenceVectors(appCtxt, 0);
+
+    GARD__ASSERT(appCtxt->defectDetection[0].output.nbRegisteredVectors > 0, "No reference vectors registered");
+
+    // The ROIs never enrolled inspect the same parts as ROI 0
+    for( uint32_t i = 1; i < DEFECT_DETECTION_MAX_ROIS; ++i )
     {
-        UpdateThreshold( &appCtxt->defectDetection, rawThreshold );
+        if( !LoadReferenceVectors(appCtxt, i) )
+        {
+            appCtxt->defectDetection[i] = appCtxt->defectDetection[0];
+        }
     }
 
-    GARD__ASSERT(appCtxt->defectDetection.output.nbRegisteredVectors > 0, "No reference vectors registered");
+    register_host_command(DEFECT_DETECTION_CMD_ENROL,
+                          (uint8_t *)&appCtxt->enrolIndex,
+                          sizeof(appCtxt->enrolIndex),
+                          EnrolLastVector, appCtxt);
+    register_host_command(DEFECT_DETECTION_CMD_SET_ROIS,
+                          (uint8_t *)&appCtxt->roisBody,
+                          sizeof(appCtxt->roisBody),
+                          SetRoIs, appCtxt);
 
     // Add network
     struct network_info network =
@@ -112,9 +425,13 @@ app_handle_t app_init(app_handle_t appContext)
         .network       = 0x2001,
         .inout_offset  = DEFECT_DETECTION_NETWORK_INPUT_ADDR,
         .inout_size    = 
-            appCtxt->defectDetection.input.scalerConfig.roi.dimensions.width 
-            * appCtxt->defectDetection.input.scalerConfig.roi.dimensions.height 
-            * appCtxt->defectDetection.input.scalerConfig.nbChannels,
+            appCtxt->defectDetection[0].input.scalerConfig.roi.dimensions.width 
+            * appCtxt->defectDetection[0].input.scalerConfig.roi.dimensions.height 
+            * appCtxt->defectDetection[0].input.scalerConfig.nbChannels,
+        .input_format  =
+            appCtxt->defectDetection[0].input.scalerConfig.nbChannels == 1
+            ? IMAGE_FORMAT__GRAYSCALE
+            : IMAGE_FORMAT__RGB_PLANAR,
     };
     appCtxt->defectDetectionNetworkInfo = network;
 
@@ -135,64 +452,241 @@ app_handle_t app_init(app_handle_t appContext)
 
 
 //-----------------------------------------------------------------------------
-//
+// Called by the FW Core with the network outputs of the ROIs of the batch
+static enum app_ret_code FinishRoIBatch(app_handle_t appContext,
+                                        void *results,
+                                        uint32_t nbRois);
+
+
+//-----------------------------------------------------------------------------
+// With ROIs, the network runs on each of them as a batch, rescaled back to
+// back from the captured image, instead of on the whole image now in its
+// input.
 enum app_ret_code app_preprocess(app_handle_t appContext, void *imageData)
 {
+    app_module_context_t *ctxt = (app_module_context_t *)appContext;
+
+    if( ctxt->roisPending )
+    {
+        ApplyPendingRoIs(ctxt);
+    }
+
+    if( ctxt->rois.nbRois > 0 )
+    {
+        const scaler_config_t *scalerConfig = &ctxt->defectDetection[0].input.scalerConfig;
+        struct roi_batch batch = {
+            .network = ctxt->defectDetectionNetworkInfo.network,
+            .in_width = (uint16_t)scalerConfig->roi.dimensions.width,
+            .in_height = (uint16_t)scalerConfig->roi.dimensions.height,
+            .p_rois = ctxt->rois.rois,
+            .count_of_rois = ctxt->rois.nbRois,
+            .p_results = ctxt->batchVectors,
+            .result_size = sizeof(ctxt->batchVectors[0]),
+            .done_cb = FinishRoIBatch };
+
+        if( run_network_on_rois_async(&batch) )
+        {
+            return APP_CODE__SUCCESS;
+        }
+        // Else, e.g. in the host simulation, the whole image is inspected
+    }
+
     start_ml_engine();
     return APP_CODE__SUCCESS;
 }
 
 
+#ifdef RESULT_PACKET_COMPACT
+//-----------------------------------------------------------------------------
+// Returns the capture start time of the image of the ML run just done, in ms
+// since boot, wrapping at 2^32.
+static inline uint32_t GetCaptureTimestampMs(void)
+{
+    return (uint32_t)(get_frame_capture_time() / (CLINT_TIMEBASE_FREQ / 1000U));
+}
+#else
 //-----------------------------------------------------------------------------
 //
 static void AppendAppData(uint8_t *outputPointer, size_t *indexPointer, const void *data, size_t dataSize) {
     memcpy(&outputPointer[*indexPointer], data, dataSize);
     *indexPointer += dataSize;
 }
+#endif
 
 
+#ifdef SUPPRESS_UNCHANGED_RESULTS
 //-----------------------------------------------------------------------------
-//
+// Compares the results of the frame with the last sent ones. The ROIs are
+// compared as objects, their verdict in the class so that a new verdict is a
+// change.
+static result_change_decision_t CheckResultsChange(app_module_context_t *ctxt)
+{
+    if( ctxt->nbResults == 0 )
+    {
+        return CheckScoreChange(
+            &ctxt->resultChange, ctxt->defectDetectionResult[0].score.n,
+            ctxt->defectDetectionResult[0].isDefective);
+    }
+
+    int16_t lefts[DEFECT_DETECTION_MAX_ROIS];
+    int16_t tops[DEFECT_DETECTION_MAX_ROIS];
+    int16_t rights[DEFECT_DETECTION_MAX_ROIS];
+    int16_t bottoms[DEFECT_DETECTION_MAX_ROIS];
+    uint8_t classes[DEFECT_DETECTION_MAX_ROIS];
+    int16_t scores[DEFECT_DETECTION_MAX_ROIS];
+    uint16_t order[DEFECT_DETECTION_MAX_ROIS];
+
+    for( uint32_t i = 0; i < ctxt->nbResults; ++i )
+    {
+        const struct roi_box *roi = &ctxt->rois.rois[i];
+        lefts[i] = (int16_t)roi->left;
+        tops[i] = (int16_t)roi->upper;
+        rights[i] = (int16_t)roi->right;
+        bottoms[i] = (int16_t)roi->bottom;
+        classes[i] = (uint8_t)((i << 1) | (ctxt->defectDetectionResult[i].isDefective ? 1 : 0));
+        scores[i] = (int16_t)ctxt->defectDetectionResult[i].score.n;
+        order[i] = (uint16_t)i;
+    }
+
+    return CheckObjectsChange(&ctxt->resultChange, lefts, tops, rights,
+                              bottoms, classes, scores, order,
+                              ctxt->nbResults);
+}
+#endif
+
+
+#ifdef RESULT_PACKET_COMPACT
+//-----------------------------------------------------------------------------
+// Writes the score and the heatmap of a result
+static void AddResultRecords(struct result_packet_writer *writer,
+                             const defect_detection_result_t *result)
+{
+    result_packet_add_score(writer, RESULT_FIELD_VERDICT,
+                            result->score.n,
+                            result->score.fracBits,
+                            result->isDefective);
+#if DEFECT_DETECTION_PATCH_GRID > 0
+    result_packet_add_heatmap(writer, DEFECT_DETECTION_PATCH_GRID,
+                              DEFECT_DETECTION_PATCH_GRID,
+                              result->heatmap);
+#endif
+}
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Sends the results of the frame in one packet. With ROIs, each is an object
+// record of the ROI, its index as the class, followed by its score and
+// heatmap records.
 static void SendAppData(app_module_context_t *ctxt) {
+    uint8_t *output = ctxt->output[ctxt->outputIdx];
+    uint8_t *streamComplete = &ctxt->streamComplete[ctxt->outputIdx];
+
+    // Buffers are sent in order, so the next one is free unless FW Core is
+    // holding more of them than it queues.
+    if( !*streamComplete )
+    {
+        return;
+    }
+
+#ifdef SUPPRESS_UNCHANGED_RESULTS
+    result_change_decision_t decision = CheckResultsChange(ctxt);
+    if( decision == RESULT_CHANGE_SKIP )
+    {
+        return;
+    }
+#endif
+
+#ifdef RESULT_PACKET_COMPACT
+    struct result_packet_writer writer;
+    result_packet_begin(&writer, output, sizeof(ctxt->output[0]),
+                        ctxt->frameSequence, ctxt->frameTimestampMs,
+                        SOURCE_IMAGE_ROI.left, SOURCE_IMAGE_ROI.top,
+                        SOURCE_IMAGE_ROI.dimensions.width,
+                        SOURCE_IMAGE_ROI.dimensions.height);
+    bool heartbeat = false;
+#ifdef SUPPRESS_UNCHANGED_RESULTS
+    heartbeat = decision == RESULT_CHANGE_HEARTBEAT;
+#endif
+    if( heartbeat )
+    {
+        result_packet_add_unchanged(&writer);
+    }
+    else if( ctxt->nbResults == 0 )
+    {
+        AddResultRecords(&writer, &ctxt->defectDetectionResult[0]);
+    }
+    else
+    {
+        for( uint32_t i = 0; i < ctxt->nbResults; ++i )
+        {
+            const struct roi_box *roi = &ctxt->rois.rois[i];
+            result_packet_add_object(&writer, RESULT_FIELD_CLASS,
+                                     roi->left, roi->upper,
+                                     roi->right, roi->bottom,
+                                     i, 0, 0);
+            AddResultRecords(&writer, &ctxt->defectDetectionResult[i]);
+        }
+    }
+    size_t index = result_packet_end(&writer);
+#else
 	size_t index = 0;
-    ctxt->output[index] = 0x7e;                             // start flag
+    output[index] = 0x7e;                                   // start flag
     index++;
 
-    ctxt->output[index] = APP_MODULE_OUTPUT_SIZE;
+    output[index] = APP_MODULE_OUTPUT_SIZE;
     index++;
-    ctxt->output[index] = 0;
+    output[index] = 0;
     index++;
 
-    ctxt->output[index] = 1;                                // RT_DATA
+    output[index] = 1;                                      // RT_DATA
     index++;
-    ctxt->output[index] = 0x64;                             // RT_DATA version
+    output[index] = 0x64;                                   // RT_DATA version
     index++;
 
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.dimensions.width, sizeof(SOURCE_IMAGE_ROI.dimensions.width));
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.dimensions.height, sizeof(SOURCE_IMAGE_ROI.dimensions.height));
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.left, sizeof(SOURCE_IMAGE_ROI.left));
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.top, sizeof(SOURCE_IMAGE_ROI.top));
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.right, sizeof(SOURCE_IMAGE_ROI.right));
-    AppendAppData(ctxt->output, &index, &SOURCE_IMAGE_ROI.bottom, sizeof(SOURCE_IMAGE_ROI.bottom));
-
-    AppendAppData(ctxt->output, &index, &ctxt->defectDetectionResult.score.n, sizeof(ctxt->defectDetectionResult.score.n));
-    uint32_t isDefective = ctxt->defectDetectionResult.isDefective ? 1 : 0;  // bool as 4 bytes
-    AppendAppData(ctxt->output, &index, &isDefective, sizeof(isDefective));
-
-    uint8_t MAX_SKIP_OUTPUT_NB = 9;
-    if( ctxt->streamComplete || ctxt->skipOutputNb > MAX_SKIP_OUTPUT_NB)
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.dimensions.width, sizeof(SOURCE_IMAGE_ROI.dimensions.width));
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.dimensions.height, sizeof(SOURCE_IMAGE_ROI.dimensions.height));
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.left, sizeof(SOURCE_IMAGE_ROI.left));
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.top, sizeof(SOURCE_IMAGE_ROI.top));
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.right, sizeof(SOURCE_IMAGE_ROI.right));
+    AppendAppData(output, &index, &SOURCE_IMAGE_ROI.bottom, sizeof(SOURCE_IMAGE_ROI.bottom));
+
+    AppendAppData(output, &index, &ctxt->defectDetectionResult[0].score.n, sizeof(ctxt->defectDetectionResult[0].score.n));
+    uint32_t isDefective = ctxt->defectDetectionResult[0].isDefective ? 1 : 0;  // bool as 4 bytes
+    AppendAppData(output, &index, &isDefective, sizeof(isDefective));
+#endif
+
+    // A buffer the queue has no room for stays free for the next output.
+    *streamComplete = false;
+    if( stream_data_to_host_async(output, index, 100, streamComplete) )
     {
-        ctxt->streamComplete = false;
-        ctxt->skipOutputNb = 0;
-        stream_data_to_host_async(ctxt->output, index, 100, &ctxt->streamComplete);
+        ctxt->outputIdx = (ctxt->outputIdx + 1) % APP_MODULE_OUTPUT_NB;
     }
     else
     {
-        ctxt->skipOutputNb += 1;
+        *streamComplete = true;
+        // Compare the next result with the last one actually sent
+        InvalidateResultChange(&ctxt->resultChange);
     }
 }
 
 
+//-----------------------------------------------------------------------------
+// Starts the capture of the next frame and sends the results of this one
+static void FinishFrame(app_module_context_t *ctxt)
+{
+    // Read before the next capture moves on to another image
+    ctxt->frameSequence = get_frame_sequence();
+#ifdef RESULT_PACKET_COMPACT
+    ctxt->frameTimestampMs = GetCaptureTimestampMs();
+#endif
+
+    capture_image_async();
+
+    SendAppData(ctxt);
+}
+
+
 //-----------------------------------------------------------------------------
 //
 enum app_ret_code app_ml_done(app_handle_t appContext, void *mlResults)
@@ -200,11 +694,41 @@ enum app_ret_code app_ml_done(app_handle_t appContext, void *mlResults)
     app_module_context_t *ctxt = (app_module_context_t *)appContext;
 
     int16_t *outputVector = (int16_t *)mlResults;
-    ctxt->defectDetectionResult = FinishDefectDetection(&ctxt->defectDetection, outputVector);
+    ctxt->defectDetectionResult[0] = FinishDefectDetection(&ctxt->defectDetection[0], outputVector);
+    ctxt->nbResults = 0;
 
-    capture_image_async();
+    // Kept for enrolment, the ML output is overwritten by the next run
+    memcpy(ctxt->lastVectors[0], outputVector, sizeof(ctxt->lastVectors[0]));
+    ctxt->nbLastVectors = 1;
 
-    SendAppData(ctxt);
+    FinishFrame(ctxt);
+
+    return APP_CODE__SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// nbRois is less than the ROIs set if one is not within the captured image,
+// the ROIs from it on have no result.
+static enum app_ret_code FinishRoIBatch(app_handle_t appContext,
+                                        void *results,
+                                        uint32_t nbRois)
+{
+    app_module_context_t *ctxt = (app_module_context_t *)appContext;
+    const int16_t (*outputVectors)[DEFECT_DETECTION_OUTPUT_SIZE_16B] = results;
+
+    for( uint32_t i = 0; i < nbRois; ++i )
+    {
+        ctxt->defectDetectionResult[i] =
+            FinishDefectDetection(&ctxt->defectDetection[i], outputVectors[i]);
+    }
+    ctxt->nbResults = nbRois;
+
+    // Kept for enrolment, the batch reuses its buffer with the next frame
+    memcpy(ctxt->lastVectors, outputVectors, nbRois * sizeof(ctxt->lastVectors[0]));
+    ctxt->nbLastVectors = nbRois;
+
+    FinishFrame(ctxt);
 
     return APP_CODE__SUCCESS;
 }
@@ -0,0 +1,215 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "func_profile.h"
+
+/**
+ * The App Module and common code built with -finstrument-functions call
+ * __cyg_profile_func_enter() and __cyg_profile_func_exit() around each of
+ * their functions. The time spent in each function is accumulated, with and
+ * without the functions it calls. Nothing here is instrumented.
+ */
+
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+/* Most functions profiled, a power of two. */
+#define FUNC_PROFILE_MAX_FUNCS (1024U)
+
+/* Deepest call chain profiled, the deeper calls are counted in their caller. */
+#define FUNC_PROFILE_MAX_DEPTH (256U)
+
+struct func_profile_entry {
+	void    *fn;
+	uint64_t calls;
+	uint64_t total_ns;
+	uint64_t self_ns;
+};
+
+struct func_profile_frame {
+	struct func_profile_entry *p_entry;
+	uint64_t                   start_ns;
+	uint64_t                   callees_ns;
+};
+
+static struct func_profile_entry funcs[FUNC_PROFILE_MAX_FUNCS];
+static uint32_t                  count_of_funcs;
+static struct func_profile_frame stack[FUNC_PROFILE_MAX_DEPTH];
+static uint32_t                  depth;
+static uint32_t                  lost_depth;
+
+static NO_INSTRUMENT uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static NO_INSTRUMENT struct func_profile_entry *find_entry(void *fn)
+{
+	uint32_t slot = (uint32_t)(((uintptr_t)fn >> 4) * 2654435761U) &
+					(FUNC_PROFILE_MAX_FUNCS - 1U);
+
+	for (uint32_t i = 0; i < FUNC_PROFILE_MAX_FUNCS; i++) {
+		struct func_profile_entry *p_entry = &funcs[slot];
+
+		if (p_entry->fn == fn) {
+			return p_entry;
+		}
+		if (NULL == p_entry->fn) {
+			p_entry->fn = fn;
+			count_of_funcs++;
+			return p_entry;
+		}
+		slot = (slot + 1U) & (FUNC_PROFILE_MAX_FUNCS - 1U);
+	}
+
+	return NULL;
+}
+
+NO_INSTRUMENT void __cyg_profile_func_enter(void *fn, void *call_site)
+{
+	struct func_profile_entry *p_entry;
+
+	(void)call_site;
+
+	p_entry = find_entry(fn);
+	if ((depth >= FUNC_PROFILE_MAX_DEPTH) || (NULL == p_entry)) {
+		lost_depth++;
+		return;
+	}
+
+	stack[depth].p_entry    = p_entry;
+	stack[depth].callees_ns = 0;
+	stack[depth].start_ns   = now_ns();
+	depth++;
+}
+
+NO_INSTRUMENT void __cyg_profile_func_exit(void *fn, void *call_site)
+{
+	uint64_t elapsed_ns;
+
+	(void)fn;
+	(void)call_site;
+
+	if (lost_depth > 0U) {
+		lost_depth--;
+		return;
+	}
+	if (0U == depth) {
+		return;
+	}
+
+	depth--;
+	elapsed_ns = now_ns() - stack[depth].start_ns;
+	stack[depth].p_entry->calls++;
+	stack[depth].p_entry->total_ns += elapsed_ns;
+	stack[depth].p_entry->self_ns += elapsed_ns - stack[depth].callees_ns;
+	if (depth > 0U) {
+		stack[depth - 1U].callees_ns += elapsed_ns;
+	}
+}
+
+/**
+ * resolve_static_name() writes the name of the function at offset in the
+ * executable with addr2line, the static functions not being in the dynamic
+ * symbol table.
+ *
+ * @return true if the function was named.
+ */
+static NO_INSTRUMENT bool resolve_static_name(uintptr_t offset, char *name,
+											  size_t name_size)
+{
+	char  command[128];
+	FILE *p_pipe;
+	bool  named = false;
+
+	snprintf(command, sizeof(command),
+			 "addr2line -f -e /proc/%d/exe 0x%lx 2>/dev/null", (int)getpid(),
+			 (unsigned long)offset);
+	p_pipe = popen(command, "r");
+	if (NULL == p_pipe) {
+		return false;
+	}
+
+	if ((NULL != fgets(name, (int)name_size, p_pipe)) && ('?' != name[0])) {
+		name[strcspn(name, "\n")] = '\0';
+		named = true;
+	}
+
+	pclose(p_pipe);
+	return named;
+}
+
+static NO_INSTRUMENT int compare_self_time(const void *p_a, const void *p_b)
+{
+	const struct func_profile_entry *p_entry_a = p_a;
+	const struct func_profile_entry *p_entry_b = p_b;
+
+	if (p_entry_a->self_ns != p_entry_b->self_ns) {
+		return p_entry_a->self_ns < p_entry_b->self_ns ? 1 : -1;
+	}
+	return 0;
+}
+
+NO_INSTRUMENT void func_profile_report(FILE *p_file, uint32_t max_funcs)
+{
+	struct func_profile_entry sorted[FUNC_PROFILE_MAX_FUNCS];
+	uint32_t                  count = 0;
+
+	for (uint32_t i = 0; i < FUNC_PROFILE_MAX_FUNCS; i++) {
+		if ((NULL != funcs[i].fn) && (funcs[i].calls > 0U)) {
+			sorted[count++] = funcs[i];
+		}
+	}
+	if (0U == count) {
+		return;
+	}
+	qsort(sorted, count, sizeof(sorted[0]), compare_self_time);
+
+	/**
+	 * The static functions that addr2line cannot name are given by their
+	 * offset in the executable.
+	 */
+	fprintf(p_file, "\nFunctions by self time (the %u of %u with the most):\n",
+			count < max_funcs ? count : max_funcs, count);
+	fprintf(p_file, "%12s %12s %12s %12s  %s\n", "calls", "self us",
+			"total us", "ns/call", "function");
+	for (uint32_t i = 0; (i < count) && (i < max_funcs); i++) {
+		Dl_info info;
+		char    name[64];
+
+		if ((0 != dladdr(sorted[i].fn, &info)) && (NULL != info.dli_sname)) {
+			snprintf(name, sizeof(name), "%s", info.dli_sname);
+		} else if (0 != dladdr(sorted[i].fn, &info)) {
+			uintptr_t offset =
+				(uintptr_t)sorted[i].fn - (uintptr_t)info.dli_fbase;
+
+			if (!resolve_static_name(offset, name, sizeof(name))) {
+				snprintf(name, sizeof(name), "? +0x%lx", (unsigned long)offset);
+			}
+		} else {
+			snprintf(name, sizeof(name), "? %p", sorted[i].fn);
+		}
+
+		fprintf(p_file, "%12llu %12.1f %12.1f %12.1f  %s\n",
+				(unsigned long long)sorted[i].calls,
+				(double)sorted[i].self_ns / 1000.0,
+				(double)sorted[i].total_ns / 1000.0,
+				(double)sorted[i].self_ns / (double)sorted[i].calls, name);
+	}
+}
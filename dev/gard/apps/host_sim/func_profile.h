@@ -0,0 +1,21 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef FUNC_PROFILE_H
+#define FUNC_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * func_profile_report() prints the calls and the time of the instrumented
+ * functions, the max_funcs with the greatest self time first. Nothing is
+ * printed unless the App Module was built with PROFILE=functions.
+ */
+void func_profile_report(FILE *p_file, uint32_t max_funcs);
+
+#endif /* FUNC_PROFILE_H */
@@ -0,0 +1,384 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "fw_core_sim.h"
+#include "fw_core.h"
+#include "assert.h"
+#include "utils.h"
+#include "cpu.h"
+#include "camera_config.h"
+
+struct fw_core_sim_state fw_core_sim = {
+	.scheduled_network = INVALID_NETWORK_HANDLE,
+};
+
+/* Host buffer standing for the HRAM ML IO region, see ml_io.h. */
+uint8_t *host_sim_ml_io;
+
+struct network_info *fw_core_sim_find_network(ml_network_handle_t network)
+{
+	if (NULL == fw_core_sim.p_networks) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < fw_core_sim.p_networks->count_of_networks; i++) {
+		if (fw_core_sim.p_networks->networks[i].network == network) {
+			return &fw_core_sim.p_networks->networks[i];
+		}
+	}
+
+	return NULL;
+}
+
+bool set_uart_parameters(void    *uart_handle,
+						 uint32_t baud_rate,
+						 uint8_t  parity,
+						 uint8_t  stop_bits)
+{
+	return true;
+}
+
+bool set_i2c_target_parameters(void    *i2c_handle,
+							   uint32_t clock_speed,
+							   uint8_t  target_address)
+{
+	return true;
+}
+
+/**
+ * register_networks() keeps the list of networks, the recorded outputs are
+ * loaded at their inout_offset.
+ */
+bool register_networks(struct networks *list_of_networks)
+{
+	GARD__ASSERT(NULL != list_of_networks, "Invalid list of networks");
+
+	fw_core_sim.p_networks = list_of_networks;
+
+	return true;
+}
+
+bool schedule_network_to_run(ml_network_handle_t network)
+{
+	if (NULL == fw_core_sim_find_network(network)) {
+		return false;
+	}
+
+	fw_core_sim.scheduled_network = network;
+
+	return true;
+}
+
+bool prefetch_network(ml_network_handle_t network)
+{
+	return NULL != fw_core_sim_find_network(network);
+}
+
+/**
+ * queue_networks_to_run() only runs the first network of the queue, a
+ * recording holds the outputs of one network per frame.
+ */
+bool queue_networks_to_run(const ml_network_handle_t *p_networks,
+						   uint32_t                   count)
+{
+	if ((0U == count) || (count > ML_RUN_QUEUE_DEPTH)) {
+		return false;
+	}
+
+	return schedule_network_to_run(p_networks[0]);
+}
+
+ml_network_handle_t get_uid_of_next_network_to_run(void)
+{
+	return fw_core_sim.scheduled_network;
+}
+
+int32_t get_uid_of_currently_running_network(void)
+{
+	return fw_core_sim.ml_engine_started ? (int32_t)fw_core_sim.scheduled_network
+										 : -1;
+}
+
+void *register_buffer_for_host_data(uint8_t     *buffer,
+									uint32_t     buffer_size,
+									rx_handler_t app_rx_handler)
+{
+	/* No data is received from the Host in the simulation. */
+	return buffer;
+}
+
+bool register_host_command(uint8_t            command_id,
+						   uint8_t           *body,
+						   uint32_t           body_size,
+						   host_cmd_handler_t app_cmd_handler,
+						   app_handle_t       app_context)
+{
+	return true;
+}
+
+/**
+ * stream_data_to_host_async() writes the data to the stream file right away,
+ * as a record of the frame index and the count of bytes (32 bits each, host
+ * byte order) followed by the data, so the buffer is complete on return.
+ */
+bool stream_data_to_host_async(uint8_t *data,
+							   uint32_t count_of_data_bytes,
+							   uint32_t timeout_ms,
+							   uint8_t *p_send_complete)
+{
+	if ((NULL == data) || (0U == count_of_data_bytes)) {
+		fw_core_sim.packets_rejected++;
+		return false;
+	}
+
+	if (NULL != fw_core_sim.p_stream_file) {
+		fwrite(&fw_core_sim.frame, sizeof(fw_core_sim.frame), 1,
+			   fw_core_sim.p_stream_file);
+		fwrite(&count_of_data_bytes, sizeof(count_of_data_bytes), 1,
+			   fw_core_sim.p_stream_file);
+		fwrite(data, 1, count_of_data_bytes, fw_core_sim.p_stream_file);
+	}
+
+	fw_core_sim.packets_sent++;
+	fw_core_sim.packet_bytes_sent += count_of_data_bytes;
+
+	if (NULL != p_send_complete) {
+		*p_send_complete = true;
+	}
+
+	return true;
+}
+
+/**
+ * stream_spans_to_host_async() writes the spans to the stream file as one
+ * record, as stream_data_to_host_async() does for a single buffer.
+ */
+bool stream_spans_to_host_async(const struct tx_span *p_spans,
+								uint32_t              count_of_spans,
+								bool                  hold_ml_output,
+								uint32_t              timeout_ms,
+								uint8_t              *p_send_complete)
+{
+	uint32_t size = 0;
+	uint32_t idx;
+
+	if ((NULL == p_spans) || (0U == count_of_spans) ||
+		(count_of_spans > APP_TX_MAX_SPANS)) {
+		fw_core_sim.packets_rejected++;
+		return false;
+	}
+
+	for (idx = 0; idx < count_of_spans; idx++) {
+		size += p_spans[idx].size;
+	}
+	if (0U == size) {
+		fw_core_sim.packets_rejected++;
+		return false;
+	}
+
+	if (NULL != fw_core_sim.p_stream_file) {
+		fwrite(&fw_core_sim.frame, sizeof(fw_core_sim.frame), 1,
+			   fw_core_sim.p_stream_file);
+		fwrite(&size, sizeof(size), 1, fw_core_sim.p_stream_file);
+		for (idx = 0; idx < count_of_spans; idx++) {
+			fwrite(p_spans[idx].p_data, 1, p_spans[idx].size,
+				   fw_core_sim.p_stream_file);
+		}
+	}
+
+	fw_core_sim.packets_sent++;
+	fw_core_sim.packet_bytes_sent += size;
+
+	if (NULL != p_send_complete) {
+		*p_send_complete = true;
+	}
+
+	return true;
+}
+
+bool send_event_to_host(uint8_t *event_data,
+						uint32_t count_of_data_bytes,
+						uint32_t timeout_ms)
+{
+	return stream_data_to_host_async(event_data, count_of_data_bytes,
+									 timeout_ms, NULL);
+}
+
+/**
+ * capture_image_async() only counts the captures, the harness runs the next
+ * frame of the recording once the App Module is done with the current one.
+ */
+void capture_image_async(void)
+{
+	fw_core_sim.captures++;
+}
+
+void start_camera_streaming(void)
+{
+}
+
+void set_capture_ahead(bool enable)
+{
+}
+
+bool set_continuous_capture(bool enable, enum frame_ring_policy policy)
+{
+	return true;
+}
+
+uint32_t get_frame_sequence(void)
+{
+	return fw_core_sim.frame;
+}
+
+/* The frames are captured when they are processed, at the simulated time. */
+uint64_t get_frame_capture_time(void)
+{
+	return get_cpu_tsc();
+}
+
+bool set_inference_rate(enum inference_rate_modes mode, uint32_t param)
+{
+	return true;
+}
+
+void start_ml_engine(void)
+{
+	fw_core_sim.ml_engine_started = true;
+	fw_core_sim.ml_runs++;
+}
+
+bool crop_and_rescale_image(struct image_info *in_image,
+							struct image_info *scaled_image)
+{
+	/* There is no image in the simulation. */
+	return false;
+}
+
+bool run_network_on_rois_async(const struct roi_batch *p_batch)
+{
+	/* ROI batches are not simulated. */
+	return false;
+}
+
+void schedule_image_processing_done_event(void)
+{
+	fw_core_sim.image_processing_done_due = true;
+}
+
+void register_app_task(struct task *p_task,
+					   const char  *name,
+					   task_fn_t    fn,
+					   app_handle_t app_context)
+{
+	struct task **pp_last;
+
+	p_task->name = name;
+	p_task->fn   = fn;
+	p_task->ctx  = (void *)app_context;
+	p_task->prio = TASK_PRIO_BACKGROUND;
+	p_task->next = NULL;
+
+	for (pp_last = &fw_core_sim.p_app_tasks; NULL != *pp_last;
+		 pp_last = &(*pp_last)->next) {
+	}
+	*pp_last = p_task;
+}
+
+void fw_core_sim_run_app_tasks(void)
+{
+	struct task *p_task;
+	bool         did_work;
+
+	do {
+		did_work = false;
+		for (p_task = fw_core_sim.p_app_tasks; NULL != p_task;
+			 p_task = p_task->next) {
+			if (p_task->fn(p_task->ctx)) {
+				p_task->stats.runs++;
+				did_work = true;
+			}
+		}
+	} while (did_work);
+}
+
+/**
+ * read_module_data() reads the module data file given to the harness, the
+ * same for all the modules.
+ */
+uint32_t read_module_data(uint32_t module_uid,
+						  uint32_t module_read_offset,
+						  uint32_t read_bytes,
+						  uint8_t *buffer)
+{
+	if ((NULL == fw_core_sim.p_module_data) ||
+		(module_read_offset >= fw_core_sim.module_data_size)) {
+		return 0;
+	}
+
+	read_bytes = MIN(read_bytes,
+					 fw_core_sim.module_data_size - module_read_offset);
+	memcpy(buffer, &fw_core_sim.p_module_data[module_read_offset], read_bytes);
+
+	return read_bytes;
+}
+
+/**
+ * write_module_data() writes into the module data file loaded in memory, it is
+ * not saved back to the file. Like on the GARD the module does not grow.
+ */
+uint32_t write_module_data(uint32_t       module_uid,
+						   uint32_t       module_write_offset,
+						   uint32_t       write_bytes,
+						   const uint8_t *buffer)
+{
+	if ((NULL == fw_core_sim.p_module_data) ||
+		(module_write_offset >= fw_core_sim.module_data_size) ||
+		(write_bytes > fw_core_sim.module_data_size - module_write_offset)) {
+		return 0;
+	}
+
+	memcpy(&fw_core_sim.p_module_data[module_write_offset], buffer,
+		   write_bytes);
+
+	return write_bytes;
+}
+
+const void *map_module_data(uint32_t  module_uid,
+							uint32_t  module_read_offset,
+							uint32_t *mapped_bytes)
+{
+	if ((NULL == fw_core_sim.p_module_data) ||
+		(module_read_offset >= fw_core_sim.module_data_size)) {
+		return NULL;
+	}
+
+	*mapped_bytes = fw_core_sim.module_data_size - module_read_offset;
+
+	return &fw_core_sim.p_module_data[module_read_offset];
+}
+
+/**
+ * get_cpu_tsc() returns the simulated time in CLINT_TIMEBASE_FREQ ticks, as
+ * the GARD TSC.
+ */
+uint64_t get_cpu_tsc(void)
+{
+	return fw_core_sim.now_ms * (CLINT_TIMEBASE_FREQ / 1000U);
+}
+
+void gard_assert_failed(const i8 *assert_expr,
+						const i8 *filename,
+						const u32 lineno,
+						...)
+{
+	fprintf(stderr, "Assertion failed on frame %u: %s (%s:%u)\n",
+			fw_core_sim.frame, assert_expr, filename, lineno);
+	abort();
+}
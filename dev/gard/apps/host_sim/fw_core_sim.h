@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef FW_CORE_SIM_H
+#define FW_CORE_SIM_H
+
+#include <stdio.h>
+
+#include "gard_types.h"
+#include "network_info.h"
+#include "task_sched.h"
+
+/**
+ * The simulated FW Core stands for the FW Core services used by the App
+ * Modules (fw_core.h), so that they run on the host. The ML engine runs are
+ * replaced by recorded ML outputs loaded in host_sim_ml_io, the data streamed
+ * to the Host is written to a file, and the time is simulated, so that the
+ * outputs of a recording are the same on every run.
+ */
+
+/* Simulated time between two frames, in ms. */
+#define FW_CORE_SIM_FRAME_PERIOD_MS (33U)
+
+struct fw_core_sim_state {
+	/* Networks registered with register_networks(). */
+	struct networks *p_networks;
+	/* Network to be run by the next start_ml_engine(). */
+	ml_network_handle_t scheduled_network;
+	/* Set by start_ml_engine(), cleared by the harness once the run is done. */
+	bool ml_engine_started;
+	/* Set by schedule_image_processing_done_event(). */
+	bool image_processing_done_due;
+	/* Tasks registered with register_app_task(), in order. */
+	struct task *p_app_tasks;
+	/* Counts of the requests of the App Module. */
+	uint32_t captures;
+	uint32_t ml_runs;
+	uint32_t packets_sent;
+	uint32_t packet_bytes_sent;
+	uint32_t packets_rejected;
+	/* Simulated time, in ms. */
+	uint64_t now_ms;
+	/* Index of the frame being processed. */
+	uint32_t frame;
+	/* File receiving the streamed data, NULL to drop it. */
+	FILE *p_stream_file;
+	/* Module data returned by read_module_data(), whatever the module. */
+	uint8_t *p_module_data;
+	uint32_t module_data_size;
+};
+
+extern struct fw_core_sim_state fw_core_sim;
+
+/**
+ * fw_core_sim_run_app_tasks() runs the tasks of the App Module until they are
+ * all idle, as the FW Core main loop does between two frames.
+ */
+void fw_core_sim_run_app_tasks(void);
+
+/**
+ * fw_core_sim_find_network() returns the registered network of the given
+ * handle, NULL if there is none.
+ */
+struct network_info *fw_core_sim_find_network(ml_network_handle_t network);
+
+#endif /* FW_CORE_SIM_H */
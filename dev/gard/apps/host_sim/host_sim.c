@@ -0,0 +1,348 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "fw_core_sim.h"
+#include "func_profile.h"
+#include "fw_core.h"
+#include "memmap.h"
+#include "ml_io.h"
+
+/**
+ * Host simulation of an App Module: the App Module callbacks are run by this
+ * harness, in the order of the FW Core main loop, on the ML outputs recorded
+ * on GARD, one frame of the recording per ML run. The time of each callback is
+ * measured, and the data streamed to the Host can be written to a file to be
+ * compared with the one of a reference run.
+ */
+
+/* Functions reported with PROFILE=functions. */
+#define HOST_SIM_REPORTED_FUNCS (25U)
+
+enum host_sim_callback {
+	HOST_SIM_CALLBACK__PREPROCESS = 0,
+	HOST_SIM_CALLBACK__ML_DONE,
+	HOST_SIM_CALLBACK__IMAGE_PROCESSING_DONE,
+	HOST_SIM_CALLBACK__COUNT
+};
+
+static const char *const callback_names[HOST_SIM_CALLBACK__COUNT] = {
+	"app_preprocess",
+	"app_ml_done",
+	"app_image_processing_done",
+};
+
+/* Times of the calls of a callback, in ns. */
+struct host_sim_times {
+	uint64_t *p_ns;
+	uint32_t  count;
+	uint32_t  capacity;
+};
+
+static struct host_sim_times times[HOST_SIM_CALLBACK__COUNT];
+
+static void print_usage(const char *p_name)
+{
+	printf("Usage: %s [options] <recording>\n", p_name);
+	printf("  <recording>  ML outputs recorded on GARD, frames back to back,\n");
+	printf("               each one read at the inout_offset of the scheduled "
+		   "network\n");
+	printf("  -f <bytes>   size of a frame of the recording, the inout_size of "
+		   "the\n");
+	printf("               network scheduled first by default\n");
+	printf("  -r <count>   times the recording is run, 1 by default\n");
+	printf("  -o <file>    file the data streamed to the Host is written to\n");
+	printf("  -m <file>    module data returned by read_module_data()\n");
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void add_time(enum host_sim_callback callback, uint64_t ns)
+{
+	struct host_sim_times *p_times = &times[callback];
+
+	if (p_times->count == p_times->capacity) {
+		uint32_t  capacity = p_times->capacity ? p_times->capacity * 2U : 1024U;
+		uint64_t *p_ns = realloc(p_times->p_ns, capacity * sizeof(uint64_t));
+
+		if (NULL == p_ns) {
+			return;
+		}
+		p_times->p_ns     = p_ns;
+		p_times->capacity = capacity;
+	}
+	p_times->p_ns[p_times->count++] = ns;
+}
+
+static int compare_times(const void *p_a, const void *p_b)
+{
+	uint64_t a = *(const uint64_t *)p_a;
+	uint64_t b = *(const uint64_t *)p_b;
+
+	return (a > b) - (a < b);
+}
+
+static void print_times(void)
+{
+	printf("%-26s %8s %10s %10s %10s %10s %10s\n", "callback", "calls",
+		   "mean us", "min us", "p50 us", "p99 us", "max us");
+
+	for (uint32_t i = 0; i < HOST_SIM_CALLBACK__COUNT; i++) {
+		struct host_sim_times *p_times = &times[i];
+		uint64_t               total   = 0;
+
+		if (0U == p_times->count) {
+			continue;
+		}
+		qsort(p_times->p_ns, p_times->count, sizeof(uint64_t), compare_times);
+		for (uint32_t j = 0; j < p_times->count; j++) {
+			total += p_times->p_ns[j];
+		}
+
+		printf("%-26s %8u %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+			   callback_names[i], p_times->count,
+			   (double)total / p_times->count / 1000.0,
+			   (double)p_times->p_ns[0] / 1000.0,
+			   (double)p_times->p_ns[p_times->count / 2U] / 1000.0,
+			   (double)p_times->p_ns[(p_times->count * 99U) / 100U] / 1000.0,
+			   (double)p_times->p_ns[p_times->count - 1U] / 1000.0);
+	}
+}
+
+static uint8_t *read_file(const char *p_path, uint32_t *p_size)
+{
+	FILE    *p_file = fopen(p_path, "rb");
+	uint8_t *p_data = NULL;
+	long     size;
+
+	if (NULL == p_file) {
+		return NULL;
+	}
+
+	if ((0 == fseek(p_file, 0, SEEK_END)) && ((size = ftell(p_file)) > 0) &&
+		(0 == fseek(p_file, 0, SEEK_SET))) {
+		p_data = malloc((size_t)size);
+		if ((NULL != p_data) &&
+			(fread(p_data, 1, (size_t)size, p_file) != (size_t)size)) {
+			free(p_data);
+			p_data = NULL;
+		}
+		*p_size = (uint32_t)size;
+	}
+
+	fclose(p_file);
+	return p_data;
+}
+
+/**
+ * run_frame() runs the App Module on the frame of the recording that is in the
+ * ML IO region, as the FW Core main loop does once the image is captured.
+ *
+ * @return false if the App Module asked for a network that is not registered.
+ */
+static bool run_frame(app_handle_t app_context)
+{
+	struct network_info *p_network;
+	enum app_ret_code    ret;
+	uint64_t             start;
+	uint64_t             busy_ns = 0;
+
+	start = now_ns();
+	(app_module_callbacks.app_preprocess_cb)(app_context, NULL);
+	add_time(HOST_SIM_CALLBACK__PREPROCESS, now_ns() - start);
+
+	/* The App Module may drop the image without running the ML engine. */
+	if (fw_core_sim.ml_engine_started) {
+		fw_core_sim.ml_engine_started = false;
+
+		p_network = fw_core_sim_find_network(fw_core_sim.scheduled_network);
+		if (NULL == p_network) {
+			return false;
+		}
+
+		/* Post-processing is timed over its slices only, as on GARD. */
+		do {
+			start = now_ns();
+			ret   = (app_module_callbacks.app_ml_done_cb)(
+				  app_context, MLIOPointer(p_network->inout_offset));
+			busy_ns += now_ns() - start;
+		} while (APP_CODE__CONTINUE == ret);
+		add_time(HOST_SIM_CALLBACK__ML_DONE, busy_ns);
+	}
+
+	if (fw_core_sim.image_processing_done_due) {
+		fw_core_sim.image_processing_done_due = false;
+
+		start = now_ns();
+		(app_module_callbacks.app_image_processing_done_cb)(app_context);
+		add_time(HOST_SIM_CALLBACK__IMAGE_PROCESSING_DONE, now_ns() - start);
+	}
+
+	/* The deferred work is done before the next frame, as on an idle GARD. */
+	fw_core_sim_run_app_tasks();
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	const char          *p_stream_path = NULL;
+	const char          *p_module_path = NULL;
+	FILE                *p_recording   = NULL;
+	struct network_info *p_network;
+	app_handle_t         app_context;
+	uint32_t             frame_size = 0;
+	uint32_t             repeat     = 1;
+	uint32_t             frames_in_recording = 0;
+	uint32_t             io_offset;
+	int                  opt;
+	int                  ret = -1;
+
+	while ((opt = getopt(argc, argv, "f:r:o:m:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			frame_size = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			repeat = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'o':
+			p_stream_path = optarg;
+			break;
+		case 'm':
+			p_module_path = optarg;
+			break;
+		default:
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+	if (optind != argc - 1) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	host_sim_ml_io = calloc(1, HRAM_ML_IO_SIZE);
+	if (NULL == host_sim_ml_io) {
+		printf("Failed to allocate the ML IO region\n");
+		goto err_sim_1;
+	}
+
+	p_recording = fopen(argv[optind], "rb");
+	if (NULL == p_recording) {
+		printf("Failed to open recording %s\n", argv[optind]);
+		goto err_sim_2;
+	}
+
+	if (NULL != p_stream_path) {
+		fw_core_sim.p_stream_file = fopen(p_stream_path, "wb");
+		if (NULL == fw_core_sim.p_stream_file) {
+			printf("Failed to open %s\n", p_stream_path);
+			goto err_sim_3;
+		}
+	}
+
+	if (NULL != p_module_path) {
+		fw_core_sim.p_module_data =
+			read_file(p_module_path, &fw_core_sim.module_data_size);
+		if (NULL == fw_core_sim.p_module_data) {
+			printf("Failed to read module data %s\n", p_module_path);
+			goto err_sim_4;
+		}
+	}
+
+	/* The App Module initializes as on boot. */
+	app_context = NULL;
+	if (NULL != app_module_callbacks.app_preinit_cb) {
+		app_context = (app_module_callbacks.app_preinit_cb)();
+	}
+	app_context = (app_module_callbacks.app_init_cb)(app_context);
+
+	p_network = fw_core_sim_find_network(fw_core_sim.scheduled_network);
+	if (NULL == p_network) {
+		printf("No network scheduled by app_init()\n");
+		goto err_sim_5;
+	}
+	if (0U == frame_size) {
+		frame_size = p_network->inout_size;
+	}
+
+	for (uint32_t run = 0; run < repeat; run++) {
+		rewind(p_recording);
+		frames_in_recording = 0;
+
+		for (;;) {
+			/* The frame is read where the scheduled network outputs it. */
+			p_network = fw_core_sim_find_network(fw_core_sim.scheduled_network);
+			if (NULL == p_network) {
+				printf("Frame %u: no network scheduled\n", fw_core_sim.frame);
+				goto err_sim_5;
+			}
+			io_offset = p_network->inout_offset - HRAM_ML_IO_START_ADDR;
+			if ((io_offset > HRAM_ML_IO_SIZE) ||
+				(frame_size > HRAM_ML_IO_SIZE - io_offset)) {
+				printf("Frame %u: %u bytes at 0x%08x are not in the ML IO "
+					   "region\n",
+					   fw_core_sim.frame, frame_size, p_network->inout_offset);
+				goto err_sim_5;
+			}
+
+			if (fread(&host_sim_ml_io[io_offset], 1, frame_size, p_recording) !=
+				frame_size) {
+				break;
+			}
+			frames_in_recording++;
+
+			if (!run_frame(app_context)) {
+				printf("Frame %u: the scheduled network is not registered\n",
+					   fw_core_sim.frame);
+				goto err_sim_5;
+			}
+
+			fw_core_sim.frame++;
+			fw_core_sim.now_ms += FW_CORE_SIM_FRAME_PERIOD_MS;
+		}
+	}
+
+	if (0U == frames_in_recording) {
+		printf("The recording holds no frame of %u bytes\n", frame_size);
+		goto err_sim_5;
+	}
+
+	printf("Frames: %u (%u per run of the recording), ML runs: %u\n",
+		   fw_core_sim.frame, frames_in_recording, fw_core_sim.ml_runs);
+	printf("Data sent to the Host: %u packets, %u bytes, %u rejected\n\n",
+		   fw_core_sim.packets_sent, fw_core_sim.packet_bytes_sent,
+		   fw_core_sim.packets_rejected);
+	print_times();
+	func_profile_report(stdout, HOST_SIM_REPORTED_FUNCS);
+
+	ret = 0;
+
+err_sim_5:
+	free(fw_core_sim.p_module_data);
+err_sim_4:
+	if (NULL != fw_core_sim.p_stream_file) {
+		fclose(fw_core_sim.p_stream_file);
+	}
+err_sim_3:
+	fclose(p_recording);
+err_sim_2:
+	free(host_sim_ml_io);
+err_sim_1:
+	return ret;
+}
@@ -0,0 +1,28 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+
+#include "primitives_bench.h"
+
+/**
+ * Runs the micro-benchmarks of the common primitives on the host, the same
+ * ones the primitives_bench App Module runs on GARD.
+ */
+
+/* Size of the text table of the results. */
+#define PRIMITIVES_BENCH_REPORT_SIZE (2048U)
+
+int main(void)
+{
+	static char report[PRIMITIVES_BENCH_REPORT_SIZE];
+
+	(void)FormatPrimitivesBench(report, sizeof(report));
+	fputs(report, stdout);
+
+	return 0;
+}
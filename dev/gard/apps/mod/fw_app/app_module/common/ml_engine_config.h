@@ -1,23 +0,0 @@
-//=============================================================================
-//
-// Copyright(c) 2024 Mirametrix Inc. All rights reserved.
-//
-// These coded instructions, statements, and computer programs contain
-// unpublished proprietary information written by MMX and
-// are protected by copyright law. They may not be disclosed
-// to third parties or copied or duplicated in any form, in whole or
-// in part, without the prior written consent of MMX.
-//
-//=============================================================================
-
-#ifndef HAND_GESTURE_PIPELINE_ML_ENGINE_CONFIG_H
-#define HAND_GESTURE_PIPELINE_ML_ENGINE_CONFIG_H
-
-#include <stdint.h>
-
-//=============================================================================
-// C O N S T A N T S
-
-static const int32_t ML_ENGINE_OUTPUT_FRAC_BITS = 10;
-
-#endif
\ No newline at end of file
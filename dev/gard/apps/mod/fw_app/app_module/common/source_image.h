@@ -1,18 +0,0 @@
-//=============================================================================
-//
-// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
-//
-// These coded instructions, statements, and computer programs contain
-// unpublished proprietary information written by MMX and
-// are protected by copyright law. They may not be disclosed
-// to third parties or copied or duplicated in any form, in whole or
-// in part, without the prior written consent of MMX.
-//
-//=============================================================================
-#ifndef SOURCE_IMAGE_H
-#define SOURCE_IMAGE_H
-
-#define SOURCE_IMAGE_WIDTH 480
-#define SOURCE_IMAGE_HEIGHT 270
-
-#endif
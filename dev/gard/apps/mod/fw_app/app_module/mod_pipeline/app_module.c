@@ -18,9 +18,17 @@
 #include "object_detection.h"
 #include "iface_support.h"
 #include "range.h"
+#include "scratch_arena.h"
+#include "object_tracker.h"
+#include "result_packet.h"
+#include "result_change.h"
+#include "cpu.h"
 
 // Macro magic to simplify buffer allocation
-#define SEND_DATA(data) memcpy(&ctxt->outputI2C[index], (uint8_t*)&data, sizeof(data)); index += sizeof(data);
+#define SEND_DATA(data) memcpy(&output[index], (uint8_t*)&data, sizeof(data)); index += sizeof(data);
+
+// One more output buffer than FW Core queues, so that one is always free
+#define OUTPUT_BUFFER_NB (APP_TX_QUEUE_DEPTH + 1)
 
 // TODO: This needs to NOT be hardcoded
 const int32_dim_t NETWORK_INPUT_DIM =
@@ -36,6 +44,23 @@ const pixel_box_t SOURCE_IMAGE_ROI =
 #define OBJECT_DETECTION_CAP 500
 const fp_t OBJECT_DETECTION_CONFIDENCE_THRESHOLD = FloatToFP( 0.6, 10 );
 const fp_t OBJECT_DETECTION_IOU_THRESHOLD = FloatToFP( 0.4, 10 );
+const fp_t OBJECT_TRACKING_IOU_THRESHOLD = FloatToFP( 0.3, 10 );
+#define OBJECT_TRACKING_MAX_MISSES 5
+
+// With SUPPRESS_UNCHANGED_RESULTS, the results are only sent when an object
+// appears, disappears or changes class, or when its box IoU with the sent one
+// falls below RESULT_CHANGE_IOU_THRESHOLD or its confidence moves by more than
+// RESULT_CHANGE_MAX_CONFIDENCE_DELTA. Every RESULT_CHANGE_HEARTBEAT_FRAMES
+// unchanged frames, a heartbeat is sent: an unchanged record with the compact
+// result packet, the results again with the legacy one.
+const fp_t RESULT_CHANGE_IOU_THRESHOLD = FloatToFP( 0.8, 10 );
+#define RESULT_CHANGE_MAX_CONFIDENCE_DELTA 102 // 0.1, Q10
+#define RESULT_CHANGE_HEARTBEAT_FRAMES 30
+
+// Sends the track ID of each object after the objects, as RT_DATA version 2.
+// Off by default, hosts parsing version 1 only would reject the data. The
+// compact result packet, see RESULT_PACKET_COMPACT, always carries them.
+// #define MOD_SEND_TRACK_IDS
 
 
 /**
@@ -69,13 +94,22 @@ struct app_module_context {
 	struct networks    *p_networks;
 
     struct ObjectDetectionPostprocessingConfig config;
-    fp_t confidences[OBJECT_DETECTION_CAP];
-    geometric_box_t boxes[OBJECT_DETECTION_CAP];
-    ObjectClass classes[OBJECT_DETECTION_CAP];
+    int16_t confidences[OBJECT_DETECTION_CAP];
+    int16_t lefts[OBJECT_DETECTION_CAP];
+    int16_t tops[OBJECT_DETECTION_CAP];
+    int16_t rights[OBJECT_DETECTION_CAP];
+    int16_t bottoms[OBJECT_DETECTION_CAP];
+    uint8_t classes[OBJECT_DETECTION_CAP];
+    uint16_t order[OBJECT_DETECTION_CAP];
     struct ObjectDetectionOutput results;
-	unsigned char outputI2C[0x22 + 0x10 * OBJECT_DETECTION_CAP + 0x01];
-	uint8_t streamComplete;
-	uint32_t skipOutputNb;
+    object_tracker_t tracker;
+    uint16_t trackIds[OBJECT_DETECTION_CAP];
+    result_change_t resultChange;
+	unsigned char outputI2C[OUTPUT_BUFFER_NB][0x22 + 0x10 * OBJECT_DETECTION_CAP + 0x01];
+	uint8_t streamComplete[OUTPUT_BUFFER_NB];
+	uint32_t outputIdx;
+	uint32_t frameSequence;
+	uint32_t frameTimestampMs;
 };
 
 /* app_ctxt is the variable holding App Module Context contents. */
@@ -84,6 +118,22 @@ struct app_module_context app_ctxt = {
 	.p_networks = &app_networks,
 };
 
+/* Returns a box coordinate of the results with ML_ENGINE_OUTPUT_FRAC_BITS. */
+static inline fp_t BoxCoordinateToFP(int16_t coordinate)
+{
+	return InterpretIntAsFP(coordinate * (1 << (ML_ENGINE_OUTPUT_FRAC_BITS - OBJECT_DETECTION_BOX_FRAC_BITS)),
+							ML_ENGINE_OUTPUT_FRAC_BITS);
+}
+
+#ifdef RESULT_PACKET_COMPACT
+/* Returns the capture start time of the image of the ML run just done, in ms
+ * since boot, wrapping at 2^32. */
+static inline uint32_t GetCaptureTimestampMs(void)
+{
+	return (uint32_t)(get_frame_capture_time() / (CLINT_TIMEBASE_FREQ / 1000U));
+}
+#endif
+
 /**
  * app_preinit() is called by the FW Core before it has initialized all of its
  * data structures and hardware blocks.
@@ -133,12 +183,30 @@ app_handle_t app_init(app_handle_t app_context)
 	ctxt->config.confidenceThreshold = OBJECT_DETECTION_CONFIDENCE_THRESHOLD;
 	ctxt->config.IoUThreshold = OBJECT_DETECTION_IOU_THRESHOLD;
 
-	ctxt->results.boxes = ctxt->boxes;
-	ctxt->results.classes = ctxt->classes;
 	ctxt->results.confidences = ctxt->confidences;
-
-	ctxt->streamComplete = true;
-	ctxt->skipOutputNb = 0;
+	ctxt->results.lefts = ctxt->lefts;
+	ctxt->results.tops = ctxt->tops;
+	ctxt->results.rights = ctxt->rights;
+	ctxt->results.bottoms = ctxt->bottoms;
+	ctxt->results.classes = ctxt->classes;
+	ctxt->results.order = ctxt->order;
+
+	// The tracked boxes are the network boxes, with OBJECT_DETECTION_BOX_FRAC_BITS
+	InitObjectTracker(
+		&ctxt->tracker,
+		NETWORK_INPUT_DIM.width << OBJECT_DETECTION_BOX_FRAC_BITS,
+		NETWORK_INPUT_DIM.height << OBJECT_DETECTION_BOX_FRAC_BITS,
+		OBJECT_TRACKING_IOU_THRESHOLD, OBJECT_TRACKING_MAX_MISSES);
+
+	InitResultChange(
+		&ctxt->resultChange, RESULT_CHANGE_IOU_THRESHOLD,
+		RESULT_CHANGE_MAX_CONFIDENCE_DELTA, RESULT_CHANGE_HEARTBEAT_FRAMES);
+
+	for( uint32_t i = 0; i < OUTPUT_BUFFER_NB; ++i )
+	{
+		ctxt->streamComplete[i] = true;
+	}
+	ctxt->outputIdx = 0;
 
 	/**
 	 * Set the first network to be run by ML engine when image capture is done.
@@ -150,6 +218,16 @@ app_handle_t app_init(app_handle_t app_context)
 	(void)start_camera_streaming();
 #endif
 
+	/**
+	 * Let the capture free-run so that the ML engine is given the newest image
+	 * as soon as it is done with the previous one. Failing that, let FW Core
+	 * capture the next image while the ML engine runs on this one and
+	 * app_ml_done() processes its results.
+	 */
+	if (!set_continuous_capture(true, FRAME_RING_POLICY__LATEST_WINS)) {
+		set_capture_ahead(true);
+	}
+
 	/**
 	 * Start capture of the first image from the camera. Subsequent image
 	 * captures should happen ideally in the routines app_ml_done() or
@@ -228,12 +306,20 @@ enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
         CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS),
         CreateFPInt(NETWORK_INPUT_DIM.height, ML_ENGINE_OUTPUT_FRAC_BITS));
 
+    fp_affine_map_t sourceToEndUserX = CreateFPAffineMap(
+        &sourceCoordinateXRange, &endUserCoordinateXRange );
+    fp_affine_map_t sourceToEndUserY = CreateFPAffineMap(
+        &sourceCoordinateYRange, &endUserCoordinateYRange );
+
 	/**
 	 * The App Module can process the results from the ML engine here. This
 	 * processing happens in a state machine to act properly on the results
 	 * from the ML engine.
 	 */
 
+	// The post-processing work arrays of the previous frame are all released
+	ScratchReset();
+
 	uint32_t nbObjects = 0;
 	nbObjects = nbObjects;
 	switch (ctxt->state_var) {
@@ -248,21 +334,96 @@ enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
 		nbObjects = PostprocessObjectDetection(
             &ctxt->config, &ctxt->results);
 
+		object_tracker_detections_t detections = {
+			ctxt->results.lefts, ctxt->results.tops,
+			ctxt->results.rights, ctxt->results.bottoms,
+			ctxt->results.classes, ctxt->results.order, nbObjects };
+		UpdateObjectTracker(&ctxt->tracker, &detections, ctxt->trackIds);
+
+		// Read before the next capture moves on to another image
+		ctxt->frameSequence = get_frame_sequence();
+#ifdef RESULT_PACKET_COMPACT
+		ctxt->frameTimestampMs = GetCaptureTimestampMs();
+#endif
+
 		/* Start image capture -> rescale -> ml sequence again */
 		capture_image_async();
 
+		// Buffers are sent in order, so the next one is free unless FW Core
+		// is holding more of them than it queues.
+		if( !ctxt->streamComplete[ctxt->outputIdx] )
+		{
+			break;
+		}
+
+#ifdef SUPPRESS_UNCHANGED_RESULTS
+		result_change_decision_t decision = CheckObjectsChange(
+			&ctxt->resultChange, ctxt->results.lefts, ctxt->results.tops,
+			ctxt->results.rights, ctxt->results.bottoms,
+			ctxt->results.classes, ctxt->results.confidences,
+			ctxt->results.order, nbObjects);
+		if( decision == RESULT_CHANGE_SKIP )
+		{
+			break;
+		}
+#endif
+
+		unsigned char *output = ctxt->outputI2C[ctxt->outputIdx];
+		uint8_t *streamComplete = &ctxt->streamComplete[ctxt->outputIdx];
+
+#ifdef RESULT_PACKET_COMPACT
+		// All the objects that fit the buffer are sent, greatest confidence
+		// first, in source image coordinates
+		struct result_packet_writer writer;
+		result_packet_begin(&writer, output, sizeof(ctxt->outputI2C[0]),
+							ctxt->frameSequence, ctxt->frameTimestampMs,
+							SOURCE_IMAGE_ROI.left, SOURCE_IMAGE_ROI.top,
+							SOURCE_IMAGE_ROI.dimensions.width,
+							SOURCE_IMAGE_ROI.dimensions.height);
+		bool heartbeat = false;
+#ifdef SUPPRESS_UNCHANGED_RESULTS
+		heartbeat = decision == RESULT_CHANGE_HEARTBEAT;
+#endif
+		if( heartbeat )
+		{
+			result_packet_add_unchanged(&writer);
+		}
+		for( uint32_t i = 0; i < nbObjects && !heartbeat; ++i )
+		{
+			uint16_t p = ctxt->results.order[i];
+			int32_t left = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.lefts[p] ), &sourceToEndUserX ) );
+			int32_t top = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.tops[p] ), &sourceToEndUserY ) );
+			int32_t right = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.rights[p] ), &sourceToEndUserX ) );
+			int32_t bottom = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.bottoms[p] ), &sourceToEndUserY ) );
+
+			if( !result_packet_add_object(&writer,
+					RESULT_FIELD_CLASS | RESULT_FIELD_CONFIDENCE | RESULT_FIELD_TRACK_ID,
+					SOURCE_IMAGE_ROI.left + left, SOURCE_IMAGE_ROI.top + top,
+					SOURCE_IMAGE_ROI.left + right, SOURCE_IMAGE_ROI.top + bottom,
+					ctxt->results.classes[p], ctxt->results.confidences[p],
+					ctxt->trackIds[p]) )
+			{
+				break;
+			}
+		}
+		size_t index = result_packet_end(&writer);
+#else
 		struct ObjectDetectionData data;
 
 		size_t index = 0;
-		ctxt->outputI2C[index] = 0x7e; // start flag
+		output[index] = 0x7e; // start flag
 		index++;
 
 		int dataLengthIndex = index;
 		index += sizeof(uint16_t);
 
-		ctxt->outputI2C[index] = 1; // RT_DATA
+		output[index] = 1; // RT_DATA
 		index++;
-		ctxt->outputI2C[index] = 1; // RT_DATA version
+#ifdef MOD_SEND_TRACK_IDS
+		output[index] = 2; // RT_DATA version
+#else
+		output[index] = 1; // RT_DATA version
+#endif
 		index++;
 
 		SEND_DATA(SOURCE_IMAGE_ROI.dimensions.width);
@@ -276,36 +437,40 @@ enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
 		SEND_DATA(zero);
 
 		SEND_DATA(nbObjects);
+		// The objects of greatest confidence are sent first
 		for( int32_t i = 0; i < nbObjects && i < 16; ++i )
 		{
-			data.objectClass = ctxt->results.classes[i];
-			data.confidence = ctxt->results.confidences[i].n;
-			data.left = FPRound( FPMap( ctxt->results.boxes[i].left, &sourceCoordinateXRange, &endUserCoordinateXRange ) );
-			data.top = FPRound( FPMap( ctxt->results.boxes[i].top, &sourceCoordinateYRange, &endUserCoordinateYRange ) );
-			data.right = FPRound( FPMap( ctxt->results.boxes[i].right, &sourceCoordinateXRange, &endUserCoordinateXRange ) );
-			data.bottom = FPRound( FPMap( ctxt->results.boxes[i].bottom, &sourceCoordinateYRange, &endUserCoordinateYRange ) );
+			uint16_t p = ctxt->results.order[i];
+			data.objectClass = ctxt->results.classes[p];
+			data.confidence = ctxt->results.confidences[p];
+			data.left = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.lefts[p] ), &sourceToEndUserX ) );
+			data.top = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.tops[p] ), &sourceToEndUserY ) );
+			data.right = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.rights[p] ), &sourceToEndUserX ) );
+			data.bottom = FPRound( FPApplyAffine( BoxCoordinateToFP( ctxt->results.bottoms[p] ), &sourceToEndUserY ) );
 
 			SEND_DATA(data);
 		}
+#ifdef MOD_SEND_TRACK_IDS
+		for( int32_t i = 0; i < nbObjects && i < 16; ++i )
+		{
+			SEND_DATA(ctxt->trackIds[ctxt->results.order[i]]);
+		}
+#endif
 		uint32_t dataLength = index-dataLengthIndex-2;
-		memcpy( &ctxt->outputI2C[dataLengthIndex], &dataLength, sizeof(uint16_t));
-		
-		// Just testing streamComplete apparently block the output. I suspect this might
-		// have to do with HUB not hooking to GARD before GARD send a "data available",
-		// signal, leading to HUB waiting for GARD data and GARD waiting for HUB to read
-		// data. By setting a maximum number of outputs to skip because streamComplete is
-		// false, we make sure they don't get interblocked forever.
-		// Another option would be to test elapsed time since last output, but we don't
-		// have a time API available.
-		if( ctxt->streamComplete || ctxt->skipOutputNb > 9)
+		memcpy( &output[dataLengthIndex], &dataLength, sizeof(uint16_t));
+#endif
+
+		// A buffer the queue has no room for stays free for the next output.
+		*streamComplete = false;
+		if( stream_data_to_host_async(output, index, 10, streamComplete) )
 		{
-			ctxt->streamComplete = false;
-			ctxt->skipOutputNb = 0;
-			stream_data_to_host_async(ctxt->outputI2C, index, 10, &ctxt->streamComplete);
+			ctxt->outputIdx = (ctxt->outputIdx + 1) % OUTPUT_BUFFER_NB;
 		}
 		else
 		{
-			ctxt->skipOutputNb += 1;
+			*streamComplete = true;
+			// Compare the next results with the last ones actually sent
+			InvalidateResultChange(&ctxt->resultChange);
 		}
 
  		break;
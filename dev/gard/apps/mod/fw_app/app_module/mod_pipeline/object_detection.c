@@ -7,9 +7,11 @@
 
 #include "object_detection.h"
 
-#include "preprocessing/bounding_box.h"
-#include "postprocessing/postprocessing_filters.h"
-#include "postprocessing/postprocessing_anchor_based_detection.h"
+#include "postprocessing/postprocessing_fixed_point.h"
+#include "int16_kernels.h"
+#include "ml_io.h"
+#include "quick_select.h"
+#include "scratch_arena.h"
 #include "utils.h"
 
 const int32_t ML_ENGINE_OUTPUT_FRAC_BITS = 10;
@@ -22,227 +24,258 @@ const int32_dim_t OBJECT_DETECTION_NETWORK_GRID_DIM[] = {
     CreateLiteralInt32Dim( 24, 18 ),
     CreateLiteralInt32Dim( 48, 36 ) };
 
-anchor_t ObjectDetectionGridCoordinateToAnchor(
-    const anchor_grid_coords_t *coords,
-    const int32_dim_t *gridDim )
-{
-    // Transform relative results from the NN to absolute values coordinates in
-    // the input image
-    fp_t strideX =
-        CreateFPInt( OBJECT_DETECTION_NETWORK_INPUT_DIM.width /
-            gridDim->width, ML_ENGINE_OUTPUT_FRAC_BITS );
-    fp_t strideY =
-        CreateFPInt( OBJECT_DETECTION_NETWORK_INPUT_DIM.height /
-            gridDim->height, ML_ENGINE_OUTPUT_FRAC_BITS );
-
-    fp_t centerX = CreateFPInt( coords->col, ML_ENGINE_OUTPUT_FRAC_BITS );
-    fp_t centerY = CreateFPInt( coords->row, ML_ENGINE_OUTPUT_FRAC_BITS );
-
-    fp_t half = CreateFP( 1, 2, ML_ENGINE_OUTPUT_FRAC_BITS );
-    centerX = FPAdd( FPMul( strideX, half), FPMul( strideX, centerX));
-    centerY = FPAdd( FPMul( strideY, half), FPMul( strideY, centerY));
-
-    anchor_t anchor = {
-        .center = CreateGeometricPoint( centerX, centerY ),
-        .dimensions = { // set to 0x0 (unused with anchor free detection)
-            .width = CreateLiteralFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS ),
-            .height = CreateLiteralFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS )
-        }
-    };
-    return anchor;
-}
-
-anchor_t ObjectDetectionGridCoordinateToAnchor_64x36( const anchor_grid_coords_t *coords )
-{
-    return ObjectDetectionGridCoordinateToAnchor( coords,
-        &OBJECT_DETECTION_NETWORK_GRID_DIM[2]);
-}
-
-anchor_t ObjectDetectionGridCoordinateToAnchor_32x18( const anchor_grid_coords_t *coords )
-{
-    return ObjectDetectionGridCoordinateToAnchor( coords,
-        &OBJECT_DETECTION_NETWORK_GRID_DIM[1]);
-}
-
-anchor_t ObjectDetectionGridCoordinateToAnchor_16x9( const anchor_grid_coords_t *coords )
+// Input image pixels per grid cell of each resolution layer, the same along
+// both axes
+static const int32_t OBJECT_DETECTION_NETWORK_STRIDE[] = { 32, 16, 8 };
+
+// Scale of the raw box deltas to input image pixels
+#define OBJECT_DETECTION_DELTA_SCALE ( 384 / 32 )
+
+// Decodes the box of the grid cell at index of a resolution layer to position
+// of the results. The raw deltas are the distances from the cell center to
+// the left, top, right and bottom sides, in OBJECT_DETECTION_DELTA_SCALE
+// pixels, with ML_ENGINE_OUTPUT_FRAC_BITS fractional bits.
+static void DecodeObjectDetectionBox(
+    const int16_t *coordsData,
+    size_t offset,
+    int32_t gridWidth,
+    int32_t stride,
+    size_t index,
+    struct ObjectDetectionOutput *results,
+    size_t position )
 {
-    return ObjectDetectionGridCoordinateToAnchor( coords,
-        &OBJECT_DETECTION_NETWORK_GRID_DIM[0]);
-}
+    const int32_t shift = ML_ENGINE_OUTPUT_FRAC_BITS - OBJECT_DETECTION_BOX_FRAC_BITS;
+    int32_t col = index % gridWidth;
+    int32_t row = index / gridWidth;
 
-geometric_box_t ObjectDetectionRawToBoundingBox(
-    fp_t rawDeltaLeft, fp_t rawDeltaTop, fp_t rawDeltaRight, fp_t rawDeltaBottom,
-    const anchor_t *anchor )
-{
-    int32_t fracBits = rawDeltaLeft.fracBits;
-    fp_t deltaScale =
-        CreateFPInt( OBJECT_DETECTION_NETWORK_INPUT_DIM.width / 32, fracBits );
+    // Cell center, ( col + 1 / 2 ) * stride
+    int32_t centerX = ( ( 2 * col + 1 ) * stride ) << ( ML_ENGINE_OUTPUT_FRAC_BITS - 1 );
+    int32_t centerY = ( ( 2 * row + 1 ) * stride ) << ( ML_ENGINE_OUTPUT_FRAC_BITS - 1 );
 
-    // Compute the box top left and bottom right coordinates from center
-    fp_t left = FPSub( anchor->center.x, FPMul(rawDeltaLeft, deltaScale) );
-    fp_t right = FPAdd( anchor->center.x, FPMul(rawDeltaRight, deltaScale) );
+    int32_t left = centerX - coordsData[index] * OBJECT_DETECTION_DELTA_SCALE;
+    int32_t top = centerY - coordsData[offset + index] * OBJECT_DETECTION_DELTA_SCALE;
+    int32_t right = centerX + coordsData[offset * 2 + index] * OBJECT_DETECTION_DELTA_SCALE;
+    int32_t bottom = centerY + coordsData[offset * 3 + index] * OBJECT_DETECTION_DELTA_SCALE;
 
-    if( FPGt( left, right  ) )
+    if( left > right )
     {
-        fp_t tmp = right;
+        int32_t tmp = right;
         right = left;
         left = tmp;
     }
-
-    fp_t top = FPSub( anchor->center.y, FPMul(rawDeltaTop, deltaScale) );
-    fp_t bottom = FPAdd( anchor->center.y, FPMul(rawDeltaBottom, deltaScale) );
-
-    if( FPGt( top, bottom  ) )
+    if( top > bottom )
     {
-        fp_t tmp = bottom;
+        int32_t tmp = bottom;
         bottom = top;
         top = tmp;
     }
 
-    return CreateGeometricBox( left, top, right, bottom );
+    results->lefts[position] = ( int16_t )( left >> shift );
+    results->tops[position] = ( int16_t )( top >> shift );
+    results->rights[position] = ( int16_t )( right >> shift );
+    results->bottoms[position] = ( int16_t )( bottom >> shift );
 }
 
-int32_t PostprocessObjectDetectionOutput(
-    uint32_t networkOutputCoordsAddr,
-    uint32_t networkOutputConfidenceAddr,
-    int32_dim_t gridDim,
-    anchor_t (*gridCoordinatesToAnchor)( const anchor_grid_coords_t * ),
-    int32_t maxBoxes,
-    fp_t confidenceThreshold,
-    size_t *indices,
-    fp_t *confidences,
-    geometric_box_t *boxes)
+// Returns the class with the greatest raw score at index, the sigmoid being
+// increasing it is the one with the greatest score.
+static ObjectClass GetClass(
+    const int16_t *classScoresData,
+    size_t offset,
+    int32_t classesNb,
+    size_t index )
 {
-    size_t offset = gridDim.width * gridDim.height;
-    const int16_t *confidencePtr = &(((int16_t *) networkOutputConfidenceAddr)[offset * 0]);
-
-    const int16_t *deltaXPtr = &(((int16_t *) networkOutputCoordsAddr)[offset * 0]);
-    const int16_t *deltaYPtr = &(((int16_t *) networkOutputCoordsAddr)[offset * 1]);
-    const int16_t *deltaWPtr = &(((int16_t *) networkOutputCoordsAddr)[offset * 2]);
-    const int16_t *deltaHPtr = &(((int16_t *) networkOutputCoordsAddr)[offset * 3]);
-
-    fp_postprocessing_config_t objectDetectionConfidenceConfig =
-        CreateFPPostprocessingConfig(
-            confidencePtr,
-            ML_ENGINE_OUTPUT_FRAC_BITS,
-            FPSigmoid );
+    return Int16ArgMax( &classScoresData[index], offset, classesNb );
+}
 
-    bounding_boxes_postprocessing_config_t objectDetectionBoundingBoxesConfig = {
-        .deltaXPtr = deltaXPtr,
-        .deltaYPtr = deltaYPtr,
-        .deltaWPtr = deltaWPtr,
-        .deltaHPtr = deltaHPtr,
-        .fracBits = ML_ENGINE_OUTPUT_FRAC_BITS,
-        .gridDim = gridDim,
-        .gridCoordinatesToAnchor = gridCoordinatesToAnchor,
-        .rawToBoundingBox = ObjectDetectionRawToBoundingBox
-    };
-
-    int32_t nbPersons = PostprocessAnchorBasedDetection(
-            offset,
-            &objectDetectionConfidenceConfig,
-            &objectDetectionBoundingBoxesConfig,
-            maxBoxes,
-            confidenceThreshold,
-            CreateFPInt( 1, ML_ENGINE_OUTPUT_FRAC_BITS ), // skip NMS for now
-            indices,
-            confidences,
-            boxes );
+// Tells if the result at position1 goes before the one at position2, by class
+// first if byClass, then by decreasing confidence.
+static inline bool IsBeforeInResultOrder(
+    const struct ObjectDetectionOutput *results,
+    uint16_t position1,
+    uint16_t position2,
+    bool byClass )
+{
+    if( byClass && results->classes[position1] != results->classes[position2] )
+    {
+        return results->classes[position1] < results->classes[position2];
+    }
+    return results->confidences[position1] > results->confidences[position2];
+}
 
-    return nbPersons;
+// Insertion sort of the positions of order, the lists are short once
+// thresholded.
+static void SortResultOrder(
+    const struct ObjectDetectionOutput *results,
+    uint16_t *order,
+    size_t size,
+    bool byClass )
+{
+    for( size_t i = 1; i < size; ++i )
+    {
+        uint16_t position = order[i];
+        size_t j = i;
+        while( j > 0 && IsBeforeInResultOrder( results, position, order[j - 1], byClass ) )
+        {
+            order[j] = order[j - 1];
+            j -= 1;
+        }
+        order[j] = position;
+    }
 }
 
-ObjectClass GetClass(
-    uint32_t networkOutputConfidenceAddr,
-    int32_dim_t gridDim,
-    int32_t classesNb,
-    size_t index,
-    fp_t *confidence
-)
+// Greedy NMS of the results of the same class, see
+// FilterOutBelowIoUThresholdWithClassSwitch(), on the positions only. Returns
+// the number of remaining results, whose positions are at the start of
+// results->order by decreasing confidence.
+static int32_t FilterOutSameClassOverlaps(
+    fp_t iouThreshold,
+    size_t size,
+    struct ObjectDetectionOutput *results )
 {
-    size_t offset = gridDim.width * gridDim.height;
-    int16_t *classScoresData = &(((int16_t *) networkOutputConfidenceAddr)[offset]);
+    q21_10_t q10IoUThreshold = FPToQ10( iouThreshold );
+    uint16_t *order = results->order;
 
-    fp_t sum = CreateFPInt( 0, ML_ENGINE_OUTPUT_FRAC_BITS );
-    fp_t maxScore = CreateFPInt(0, ML_ENGINE_OUTPUT_FRAC_BITS );
-    int32_t maxIndex = 0;
+    scratch_mark_t mark = ScratchMark();
+    int64_t *areas = ScratchAllocArray( int64_t, size );
+    bool *suppressed = ScratchAllocArray( bool, size );
 
-    for( int32_t i = 0; i < classesNb; ++i)
+    for( size_t i = 0; i < size; ++i )
     {
-        fp_t logit = InterpretIntAsFP( classScoresData[offset * i + index], ML_ENGINE_OUTPUT_FRAC_BITS );
-        fp_t score = FPSigmoid( logit );
-        sum = FPAdd( sum, score );
+        order[i] = ( uint16_t ) i;
+        areas[i] = ( int64_t )( results->rights[i] - results->lefts[i] ) *
+            ( results->bottoms[i] - results->tops[i] );
+        suppressed[i] = false;
+    }
+    SortResultOrder( results, order, size, true );
 
-        if( FPGt( score, maxScore ) )
+    // IoU >= t is tested as intersection * (1 + t) >= t * (area1 + area2)
+    for( size_t i = 0; i < size; ++i )
+    {
+        uint16_t p1 = order[i];
+        if( suppressed[p1] )
         {
-            maxScore = score;
-            maxIndex = i;
+            continue;
+        }
+
+        for( size_t j = i + 1; j < size; ++j )
+        {
+            uint16_t p2 = order[j];
+            if( results->classes[p2] != results->classes[p1] )
+            {
+                // The remaining results belong to other classes
+                break;
+            }
+            if( suppressed[p2] )
+            {
+                continue;
+            }
+
+            int32_t left = MAX( results->lefts[p1], results->lefts[p2] );
+            int32_t top = MAX( results->tops[p1], results->tops[p2] );
+            int32_t right = MIN( results->rights[p1], results->rights[p2] );
+            int32_t bottom = MIN( results->bottoms[p1], results->bottoms[p2] );
+            int64_t interArea = ( right > left && bottom > top )
+                ? ( int64_t )( right - left ) * ( bottom - top )
+                : 0;
+            int64_t areaSum = areas[p1] + areas[p2];
+            if( areaSum - interArea > 0 &&
+                interArea * ( Q10_ONE + q10IoUThreshold ) >=
+                    areaSum * q10IoUThreshold )
+            {
+                suppressed[p2] = true;
+            }
         }
     }
 
-    *confidence = FPDiv(maxScore, sum);
-    return maxIndex;
+    size_t kept = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        if( !suppressed[order[i]] )
+        {
+            order[kept++] = order[i];
+        }
+    }
+    SortResultOrder( results, order, kept, false );
+
+    ScratchRelease( mark );
+    return kept;
 }
 
 int32_t PostprocessObjectDetection(
     struct ObjectDetectionPostprocessingConfig *config,
     struct ObjectDetectionOutput *results )
 {
-    anchor_t (*ObjectDetectionGridCoordinateToAnchor[])( const anchor_grid_coords_t *) = {
-        ObjectDetectionGridCoordinateToAnchor_16x9,
-        ObjectDetectionGridCoordinateToAnchor_32x18,
-        ObjectDetectionGridCoordinateToAnchor_64x36
-    };
-
-    size_t indices[config->maxBoxes];
-
     int32_t totalBoxes = 0;
     int32_t remainingBoxes = config->maxBoxes;
 
+    // The confidence is the sigmoid of the raw confidence, the threshold is
+    // compared to the raw data of all the resolution layers
+    fp_postprocessing_config_t confidenceConfig =
+        CreateFPPostprocessingConfig(
+            NULL,
+            ML_ENGINE_OUTPUT_FRAC_BITS,
+            FPSigmoid );
+    int32_t rawThreshold =
+        FPToRawThreshold( &confidenceConfig, config->confidenceThreshold );
+
+    scratch_mark_t mark = ScratchMark();
+    size_t *indices =
+        ScratchAllocArray( size_t, config->maxBoxes > 0 ? config->maxBoxes : 0 );
+
     for( size_t j = 0; j < RESOLUTION_LAYERS_NB; ++j )
     {
-        int32_t nbOutputs =
-            OBJECT_DETECTION_NETWORK_GRID_DIM[j].height *
-            OBJECT_DETECTION_NETWORK_GRID_DIM[j].width;
+        int32_t gridWidth = OBJECT_DETECTION_NETWORK_GRID_DIM[j].width;
+        int32_t nbOutputs = gridWidth * OBJECT_DETECTION_NETWORK_GRID_DIM[j].height;
+        size_t offset = nbOutputs;
 
         int32_t maxBoxes =
             nbOutputs < remainingBoxes / (RESOLUTION_LAYERS_NB - j)
             ? nbOutputs
             : remainingBoxes / (RESOLUTION_LAYERS_NB - j);
 
-        int32_t nbBoxes = PostprocessObjectDetectionOutput(
-            RAW_DATA_OUTPUT_COORDS_ADDRESSES[j],
-            RAW_DATA_OUTPUT_CONFIDENCE_ADDRESSES[j],
-            OBJECT_DETECTION_NETWORK_GRID_DIM[j],
-            ObjectDetectionGridCoordinateToAnchor[j],
-            maxBoxes,
-            config->confidenceThreshold,
-            &indices[totalBoxes], &results->confidences[totalBoxes],
-            &results->boxes[totalBoxes]);
-
-        remainingBoxes -= nbBoxes;
+        const int16_t *coordsData =
+            (const int16_t *) MLIOPointer( RAW_DATA_OUTPUT_COORDS_ADDRESSES[j] );
+        const int16_t *confidenceData =
+            (const int16_t *) MLIOPointer( RAW_DATA_OUTPUT_CONFIDENCE_ADDRESSES[j] );
+
+        // The confidences of all the cells are scanned, from a copy in the
+        // scratch arena; the class scores and boxes are read at the kept
+        // cells only
+        scratch_mark_t layerMark = ScratchMark();
+        const int16_t *confidences = MLIOCopyPlanes(
+            RAW_DATA_OUTPUT_CONFIDENCE_ADDRESSES[j], nbOutputs, offset, 1 );
+
+        // Keep the cells of greatest confidence above the threshold, then
+        // decode only those
+        int32_t nbBoxes = HeapSelectAboveThreshold(
+            indices,
+            nbOutputs,
+            confidences,
+            rawThreshold,
+            maxBoxes > 0 ? maxBoxes : 0 );
 
-        for( size_t i = 0; i < nbBoxes; ++i)
+        for( int32_t i = 0; i < nbBoxes; ++i)
         {
-            fp_t confidence;
-            (&results->classes[totalBoxes])[i] = (int32_t) GetClass(
-                RAW_DATA_OUTPUT_CONFIDENCE_ADDRESSES[j],
-                OBJECT_DETECTION_NETWORK_GRID_DIM[j],
+            size_t index = indices[i];
+            size_t position = totalBoxes + i;
+            results->confidences[position] = ( int16_t ) FPSigmoid(
+                InterpretIntAsFP( confidences[index], ML_ENGINE_OUTPUT_FRAC_BITS ) ).n;
+            DecodeObjectDetectionBox(
+                coordsData, offset, gridWidth, OBJECT_DETECTION_NETWORK_STRIDE[j],
+                index, results, position );
+            results->classes[position] = ( uint8_t ) GetClass(
+                &confidenceData[offset],
+                offset,
                 OBJECT_DETECTION_CLASSES_NB,
-                (&indices[totalBoxes])[i],
-                &confidence);
+                index );
         }
+        ScratchRelease( layerMark );
 
+        remainingBoxes -= nbBoxes;
         totalBoxes += nbBoxes;
     }
+    ScratchRelease( mark );
 
-    int32_t nbBoxes = FilterOutSameClassBelowIoUThreshold (
-        config->IoUThreshold,  // Threshold value
-        totalBoxes,     // Size of the input lists
-        indices,
-        results->confidences,
-        results->boxes,
-        (int32_t *) results->classes );
-
-    return nbBoxes;
+    // The candidates of all the resolution layers go through a single NMS
+    return FilterOutSameClassOverlaps( config->IoUThreshold, totalBoxes, results );
 }
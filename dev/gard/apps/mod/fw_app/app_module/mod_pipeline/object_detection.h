@@ -53,10 +53,23 @@ struct ObjectDetectionPostprocessingConfig {
     fp_t IoUThreshold; // IoU value above which two objects will be deemed the same
 };
 
+// Fractional bits of the bounding box coordinates of the results, which are in
+// network input pixels
+#define OBJECT_DETECTION_BOX_FRAC_BITS 4
+
+// Detected objects, as arrays of maxBoxes elements. The candidates are stored
+// at successive positions, filtering and sorting them only moves positions in
+// order.
 struct ObjectDetectionOutput{
-    fp_t *confidences;      // Detected objects confidence
-    geometric_box_t *boxes; // Detected objects bounding boxes
-    ObjectClass *classes;   // Detected object classes
+    int16_t *confidences;   // Confidence, with ML_ENGINE_OUTPUT_FRAC_BITS
+                            // fractional bits
+    int16_t *lefts;         // Bounding boxes, with
+    int16_t *tops;          // OBJECT_DETECTION_BOX_FRAC_BITS fractional bits
+    int16_t *rights;
+    int16_t *bottoms;
+    uint8_t *classes;       // ObjectClass
+    uint16_t *order;        // Positions of the detected objects, by
+                            // decreasing confidence
 };
 
 struct ObjectDetectionData
@@ -69,7 +82,8 @@ struct ObjectDetectionData
     int16_t bottom;
 };
 
-// Postprocess object detection network output
+// Postprocess object detection network output, returns the number of detected
+// objects in results->order
 int32_t PostprocessObjectDetection(
     struct ObjectDetectionPostprocessingConfig *config,
     struct ObjectDetectionOutput *results );
@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "assert.h"
+#include "fw_core.h"
+#include "app_module.h"
+#include "utils.h"
+#include "primitives_bench.h"
+
+/**
+ * Micro-benchmarks of the common primitives on GARD: app_init() runs them,
+ * timed with mcycle, and streams their results to the Host once, as text.
+ * No network is registered and no image is captured, so that nothing runs
+ * alongside the benchmarks. The same benchmarks are built for the host by
+ * `make run_primitives_bench` in apps/host_sim.
+ */
+
+/* Size of the text table of the results. */
+#define PRIMITIVES_BENCH_REPORT_SIZE (2048U)
+
+struct app_module_context {
+	char    report[PRIMITIVES_BENCH_REPORT_SIZE];
+	uint8_t report_sent;
+};
+
+static struct app_module_context app_ctxt;
+
+/**
+ * app_preinit() is called by the FW Core before it has initialized all of its
+ * data structures and hardware blocks.
+ *
+ * @return pointer to the App Module's context.
+ */
+app_handle_t app_preinit(void)
+{
+	return (app_handle_t)&app_ctxt;
+}
+
+/**
+ * app_init() is called by the FW Core to initialize the App Module. The
+ * benchmarks are run here, before the FW Core main loop starts.
+ *
+ * @param app_context is the handle returned by app_preinit() or NULL.
+ *
+ * @return pointer to the App Module's context.
+ */
+app_handle_t app_init(app_handle_t app_context)
+{
+	struct app_module_context *ctxt = &app_ctxt;
+	size_t                     size;
+
+	GARD__DBG_ASSERT((NULL == app_context) || (app_context == &app_ctxt),
+					 "Invalid app_context");
+
+	size = FormatPrimitivesBench(ctxt->report, sizeof(ctxt->report));
+
+	ctxt->report_sent = false;
+	(void)stream_data_to_host_async((uint8_t *)ctxt->report, (uint32_t)size,
+									100U, &ctxt->report_sent);
+
+	return (app_handle_t)ctxt;
+}
+
+/**
+ * app_preprocess() is not called, no image being captured.
+ *
+ * @param app_context is the handle returned by app_init() or NULL.
+ * @param image_data is a pointer to the captured image data.
+ *
+ * @return APP_CODE__SUCCESS.
+ */
+enum app_ret_code app_preprocess(app_handle_t app_context, void *image_data)
+{
+	return APP_CODE__SUCCESS;
+}
+
+/**
+ * app_ml_done() is not called, no network being registered.
+ *
+ * @param app_context is the handle returned by app_init() or NULL.
+ * @param ml_results is a pointer to the results from the ML engine.
+ *
+ * @return APP_CODE__SUCCESS.
+ */
+enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
+{
+	return APP_CODE__SUCCESS;
+}
+
+/**
+ * app_image_processing_done() is not called, no image being captured.
+ *
+ * @param app_context is the handle returned by app_init() or NULL.
+ *
+ * @return APP_CODE__SUCCESS.
+ */
+enum app_ret_code app_image_processing_done(app_handle_t app_context)
+{
+	return APP_CODE__SUCCESS;
+}
+
+/**
+ * app_rescale_done() is not called, no image being captured.
+ *
+ * @param app_context is the handle returned by app_init() or NULL.
+ *
+ * @return APP_CODE__SUCCESS.
+ */
+enum app_ret_code app_rescale_done(app_handle_t app_context)
+{
+	return APP_CODE__SUCCESS;
+}
+
+/**
+ * This is where we let the FW Core know about the App Module's callbacks.
+ */
+DEFINE_APP_MODULE_CALLBACKS(app_preinit,
+							app_init,
+							app_preprocess,
+							app_ml_done,
+							app_image_processing_done,
+							app_rescale_done);
@@ -0,0 +1,895 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include "primitives_bench.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined( __riscv ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <x86intrin.h>
+#elif !defined( __riscv )
+#include <time.h>
+#endif
+
+#include "box.h"
+#include "fixed_point.h"
+#include "isqrt.h"
+#include "landmarks.h"
+#include "matrix.h"
+#include "quick_select.h"
+
+//=============================================================================
+// C O N S T A N T S
+
+// Operations per timed run of the scalar primitives
+#define BENCH_OPS_NB 128
+
+// Timed runs of each benchmark, the fastest is kept
+#define BENCH_RUNS_NB 8
+
+// Fractional bits of the scalar primitives inputs and results, those of the
+// ML engine outputs
+#define BENCH_FRAC_BITS 10
+
+// Fractional bits of the matrices, those of the tracking filters
+#define BENCH_MAT_FRAC_BITS 16
+
+// Matrices per timed run
+#define BENCH_MAT_NB 16
+
+// Scores of the selection benchmarks, the cells of the finest MOD layer
+// (48x36), of which BENCH_SELECT_K are selected
+#define BENCH_SELECT_SIZE ( 48 * 36 )
+#define BENCH_SELECT_K 100
+
+// Selections per timed run
+#define BENCH_SELECT_CALLS_NB 4
+
+// Raw threshold of HeapSelectAboveThreshold(), the logit of a 0.6 confidence
+#define BENCH_SELECT_THRESHOLD 415
+
+// Landmarks post-processing runs per timed run
+#define BENCH_LANDMARKS_CALLS_NB 16
+
+// Candidates of each box matching, those of the tracked users
+#define BENCH_MATCH_CANDIDATES_NB 8
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Buffers of the benchmarks, one at a time
+typedef union
+{
+    struct
+    {
+        fp_t op1[BENCH_OPS_NB];
+        fp_t op2[BENCH_OPS_NB];
+        int32_t res[BENCH_OPS_NB];
+    } scalar;
+    struct
+    {
+        geometric_box_t box1[BENCH_OPS_NB];
+        geometric_box_t box2[BENCH_OPS_NB];
+        int32_t res[BENCH_OPS_NB];
+    } iou;
+    struct
+    {
+        int32_t op1[BENCH_MAT_NB][36];
+        int32_t op2[BENCH_MAT_NB][36];
+        int32_t res[BENCH_MAT_NB][36];
+    } mat;
+    struct
+    {
+        int16_t scores[BENCH_SELECT_SIZE];
+        int16_t sorted[BENCH_SELECT_SIZE];
+        size_t indices[BENCH_SELECT_SIZE];
+        quick_select_key_t keys[BENCH_SELECT_SIZE];
+    } select;
+    struct
+    {
+        landmarks_2d_facefit_t landmarks;
+        landmarks_2d_facefit_t fused;
+        uint8_t indices[DEFAULT_LANDMARKS_NB];
+    } landmarks;
+    struct
+    {
+        uint64_t op[BENCH_OPS_NB];
+        uint32_t res[BENCH_OPS_NB];
+    } isqrt;
+} bench_buffers_t;
+
+typedef struct
+{
+    char *buffer;
+    size_t bufferSize;
+    size_t size;
+} bench_format_context_t;
+
+//=============================================================================
+// V A R I A B L E S
+
+static bench_buffers_t benchBuffers;
+
+static uint32_t benchRandomState;
+
+//=============================================================================
+// M A C R O S
+
+// Times BENCH_RUNS_NB runs of statement, run for i from 0 to opsNb, and keeps
+// the ticks of the fastest run in bestTicks
+#define TIME_BENCH_RUNS( bestTicks, opsNb, statement )        \
+    do                                                        \
+    {                                                         \
+        bestTicks = UINT64_MAX;                               \
+        for( uint32_t run = 0; run < BENCH_RUNS_NB; ++run )   \
+        {                                                     \
+            uint64_t start = BenchCounter();                  \
+            for( uint32_t i = 0; i < ( opsNb ); ++i )         \
+            {                                                 \
+                statement;                                    \
+            }                                                 \
+            uint64_t ticks = BenchCounter() - start;          \
+            if( ticks < bestTicks )                           \
+            {                                                 \
+                bestTicks = ticks;                            \
+            }                                                 \
+        }                                                     \
+    } while( 0 )
+
+//=============================================================================
+// F U N C T I O N S   C O D E   S E C T I O N
+
+//-----------------------------------------------------------------------------
+// Returns the counter the benchmarks are timed with.
+static inline uint64_t BenchCounter( void )
+{
+#if defined( __riscv )
+    uint32_t hi;
+    uint32_t lo;
+    uint32_t hi2;
+    do
+    {
+        __asm__ volatile( "csrr %0, mcycleh" : "=r"( hi ) );
+        __asm__ volatile( "csrr %0, mcycle" : "=r"( lo ) );
+        __asm__ volatile( "csrr %0, mcycleh" : "=r"( hi2 ) );
+    } while( hi != hi2 );
+    return ( ( uint64_t )hi << 32 ) | lo;
+#elif defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( uint64_t )ts.tv_sec * 1000000000u + ( uint64_t )ts.tv_nsec;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//
+const char *PrimitivesBenchCounterUnit( void )
+{
+#if defined( __riscv )
+    return "cycles";
+#elif defined( __x86_64__ ) || defined( __i386__ )
+    return "TSC ticks";
+#else
+    return "ns";
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Returns the next pseudo-random number, xorshift32.
+static uint32_t BenchRandom( void )
+{
+    uint32_t x = benchRandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    benchRandomState = x;
+    return x;
+}
+
+//-----------------------------------------------------------------------------
+// Returns a pseudo-random number in [min, max).
+static int32_t BenchRandomRange( int32_t min, int32_t max )
+{
+    return min + ( int32_t )( BenchRandom() % ( uint32_t )( max - min ) );
+}
+
+//-----------------------------------------------------------------------------
+// Returns a pseudo-random number of roughly normal distribution, the sum of 4
+// uniform ones, of mean mean and standard deviation about stdDev.
+static int32_t BenchRandomNormal( int32_t mean, int32_t stdDev )
+{
+    int32_t sum = 0;
+    for( int32_t i = 0; i < 4; ++i )
+    {
+        sum += BenchRandomRange( -stdDev * 1732 / 1000, stdDev * 1732 / 1000 + 1 );
+    }
+    return mean + sum / 2;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the error of a fixed point result against its real reference, in
+// units of the result.
+static uint32_t LsbError( int32_t n, double reference, uint8_t fracBits )
+{
+    double error = fabs( ( double )n - reference * ( double )( 1 << fracBits ) );
+    return ( uint32_t )llround( error );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the real value of a fixed point number.
+static double FPToDouble( fp_t x )
+{
+    return ( double )x.n / ( double )( 1 << x.fracBits );
+}
+
+//-----------------------------------------------------------------------------
+//
+static void ReportBench(
+    primitives_bench_report_t report,
+    void *context,
+    const char *name,
+    uint32_t opsNb,
+    uint64_t bestTicks,
+    uint32_t maxError,
+    const char *errorUnit )
+{
+    primitives_bench_result_t result = {
+        .name = name,
+        .opsNb = opsNb,
+        .cyclesPerOpX10 = ( uint32_t )( bestTicks * 10 / opsNb ),
+        .maxError = maxError,
+        .errorUnit = errorUnit };
+    report( &result, context );
+}
+
+//-----------------------------------------------------------------------------
+// Fills the scalar operands with Q10 numbers in [min1, max1) and [min2, max2).
+static void FillScalarOperands( int32_t min1, int32_t max1, int32_t min2, int32_t max2 )
+{
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        benchBuffers.scalar.op1[i] = InterpretIntAsFP(
+            BenchRandomRange( min1 << BENCH_FRAC_BITS, max1 << BENCH_FRAC_BITS ), BENCH_FRAC_BITS );
+        benchBuffers.scalar.op2[i] = InterpretIntAsFP(
+            BenchRandomRange( min2 << BENCH_FRAC_BITS, max2 << BENCH_FRAC_BITS ), BENCH_FRAC_BITS );
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+static void BenchScalarPrimitives( primitives_bench_report_t report, void *context )
+{
+    fp_t *op1 = benchBuffers.scalar.op1;
+    fp_t *op2 = benchBuffers.scalar.op2;
+    int32_t *res = benchBuffers.scalar.res;
+    uint64_t bestTicks;
+    uint32_t maxError;
+
+    FillScalarOperands( -16, 16, -16, 16 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPMul( op1[i], op2[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], FPToDouble( op1[i] ) * FPToDouble( op2[i] ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPMul Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    // Divisors of at least 1/4 in magnitude, the quotients fit Q21.10
+    FillScalarOperands( -16, 16, 1, 16 );
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        op2[i].n = ( op2[i].n >> 2 ) * ( BenchRandom() & 1 ? 1 : -1 );
+    }
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPDiv( op1[i], op2[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], FPToDouble( op1[i] ) / FPToDouble( op2[i] ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPDiv Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    FillScalarOperands( 0, 1024, 0, 1 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPSqrt( op1[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], sqrt( FPToDouble( op1[i] ) ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPSqrt Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    FillScalarOperands( -8, 8, 0, 1 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPSigmoid( op1[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], 1.0 / ( 1.0 + exp( -FPToDouble( op1[i] ) ) ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPSigmoid Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    FillScalarOperands( -16, 16, 0, 1 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPAtan( op1[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], atan( FPToDouble( op1[i] ) ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPAtan Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    FillScalarOperands( -16, 16, -16, 16 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPAtan2( op1[i], op2[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], atan2( FPToDouble( op1[i] ), FPToDouble( op2[i] ) ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPAtan2 Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    FillScalarOperands( -1, 1, 0, 1 );
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPAsin( op1[i] ).n );
+    maxError = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], asin( FPToDouble( op1[i] ) ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "FPAsin Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the IoU of two boxes, computed with doubles.
+static double ReferenceIoU( const geometric_box_t *box1, const geometric_box_t *box2 )
+{
+    double left = fmax( FPToDouble( box1->left ), FPToDouble( box2->left ) );
+    double top = fmax( FPToDouble( box1->top ), FPToDouble( box2->top ) );
+    double right = fmin( FPToDouble( box1->right ), FPToDouble( box2->right ) );
+    double bottom = fmin( FPToDouble( box1->bottom ), FPToDouble( box2->bottom ) );
+    double inter = fmax( right - left, 0.0 ) * fmax( bottom - top, 0.0 );
+    double area1 = ( FPToDouble( box1->right ) - FPToDouble( box1->left ) ) *
+        ( FPToDouble( box1->bottom ) - FPToDouble( box1->top ) );
+    double area2 = ( FPToDouble( box2->right ) - FPToDouble( box2->left ) ) *
+        ( FPToDouble( box2->bottom ) - FPToDouble( box2->top ) );
+    return inter / ( area1 + area2 - inter );
+}
+
+//-----------------------------------------------------------------------------
+// The boxes are pairs of NMS candidates: boxes of the MOD network input, the
+// second one a jittered copy of the first.
+static void BenchIoU( primitives_bench_report_t report, void *context )
+{
+    geometric_box_t *box1 = benchBuffers.iou.box1;
+    geometric_box_t *box2 = benchBuffers.iou.box2;
+    int32_t *res = benchBuffers.iou.res;
+    uint64_t bestTicks;
+    uint32_t maxError = 0;
+
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        int32_t width = BenchRandomRange( 8, 128 );
+        int32_t height = BenchRandomRange( 8, 128 );
+        int32_t left = BenchRandomRange( 0, 384 - 128 );
+        int32_t top = BenchRandomRange( 0, 288 - 128 );
+        int32_t jitter = width / 2;
+
+        box1[i] = CreateGeometricBox(
+            CreateFPInt( left, BENCH_FRAC_BITS ), CreateFPInt( top, BENCH_FRAC_BITS ),
+            CreateFPInt( left + width, BENCH_FRAC_BITS ), CreateFPInt( top + height, BENCH_FRAC_BITS ) );
+        left += BenchRandomRange( -jitter, jitter + 1 );
+        top += BenchRandomRange( -jitter, jitter + 1 );
+        box2[i] = CreateGeometricBox(
+            CreateFPInt( left, BENCH_FRAC_BITS ), CreateFPInt( top, BENCH_FRAC_BITS ),
+            CreateFPInt( left + width, BENCH_FRAC_BITS ), CreateFPInt( top + height, BENCH_FRAC_BITS ) );
+    }
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = ComputeGeometricIoU( box1[i], box2[i] ).n );
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint32_t error = LsbError( res[i], ReferenceIoU( &box1[i], &box2[i] ), BENCH_FRAC_BITS );
+        maxError = error > maxError ? error : maxError;
+    }
+    ReportBench( report, context, "ComputeGeometricIoU Q10", BENCH_OPS_NB, bestTicks, maxError, "lsb" );
+
+    fp_t threshold = CreateFP( 1, 2, BENCH_FRAC_BITS );
+    uint32_t mismatches = 0;
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = IoUExceeds( &box1[i], &box2[i], threshold ) );
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        mismatches += ( res[i] != 0 ) != ( ReferenceIoU( &box1[i], &box2[i] ) > 0.5 );
+    }
+    ReportBench( report, context, "IoUExceeds 0.5 Q10", BENCH_OPS_NB, bestTicks, mismatches, "mismatches" );
+
+    // The same test with the IoU divided out, as it used to be done
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = FPGt( ComputeGeometricIoU( box1[i], box2[i] ), threshold ) );
+    mismatches = 0;
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        mismatches += ( res[i] != 0 ) != ( ReferenceIoU( &box1[i], &box2[i] ) > 0.5 );
+    }
+    ReportBench( report, context, "ComputeGeometricIoU > 0.5 Q10", BENCH_OPS_NB, bestTicks, mismatches, "mismatches" );
+
+    // Each box against its jittered copy and the next boxes, with the
+    // greatest double IoU above the threshold as the reference
+    const uint32_t matchesNb = BENCH_OPS_NB - BENCH_MATCH_CANDIDATES_NB;
+    TIME_BENCH_RUNS( bestTicks, matchesNb,
+        res[i] = ( int32_t )MatchGeometricBox( &box1[i], threshold, &box2[i], BENCH_MATCH_CANDIDATES_NB ) );
+    mismatches = 0;
+    for( uint32_t i = 0; i < matchesNb; ++i )
+    {
+        int32_t expected = BENCH_MATCH_CANDIDATES_NB;
+        double bestIoU = 0.5;
+        for( int32_t c = 0; c < BENCH_MATCH_CANDIDATES_NB; ++c )
+        {
+            double iou = ReferenceIoU( &box1[i], &box2[i + c] );
+            if( iou > bestIoU )
+            {
+                bestIoU = iou;
+                expected = c;
+            }
+        }
+        mismatches += res[i] != expected;
+    }
+    ReportBench( report, context, "MatchGeometricBox 0.5 Q10 x8", matchesNb, bestTicks, mismatches, "mismatches" );
+}
+
+//-----------------------------------------------------------------------------
+// Fills the matrices with Q16 numbers in [-4, 4), then times kernel over them.
+// Returns the greatest error of the products.
+#define BENCH_MAT_KERNEL( bestTicks, maxError, kernel, size )                              \
+    do                                                                                     \
+    {                                                                                      \
+        for( uint32_t m = 0; m < BENCH_MAT_NB; ++m )                                       \
+        {                                                                                  \
+            for( uint32_t e = 0; e < ( size ) * ( size ); ++e )                            \
+            {                                                                              \
+                benchBuffers.mat.op1[m][e] = BenchRandomRange( -4 << 16, 4 << 16 );        \
+                benchBuffers.mat.op2[m][e] = BenchRandomRange( -4 << 16, 4 << 16 );        \
+            }                                                                              \
+        }                                                                                  \
+        TIME_BENCH_RUNS( bestTicks, BENCH_MAT_NB,                                          \
+            kernel( benchBuffers.mat.op1[i], benchBuffers.mat.op2[i],                      \
+                    benchBuffers.mat.res[i], BENCH_MAT_FRAC_BITS ) );                      \
+        maxError = 0;                                                                      \
+        for( uint32_t m = 0; m < BENCH_MAT_NB; ++m )                                       \
+        {                                                                                  \
+            for( uint32_t r = 0; r < ( size ); ++r )                                       \
+            {                                                                              \
+                for( uint32_t c = 0; c < ( size ); ++c )                                   \
+                {                                                                          \
+                    double sum = 0.0;                                                      \
+                    for( uint32_t k = 0; k < ( size ); ++k )                               \
+                    {                                                                      \
+                        sum += ( double )benchBuffers.mat.op1[m][r * ( size ) + k] *       \
+                            ( double )benchBuffers.mat.op2[m][k * ( size ) + c];           \
+                    }                                                                      \
+                    uint32_t error = LsbError( benchBuffers.mat.res[m][r * ( size ) + c],  \
+                        sum / 4294967296.0, BENCH_MAT_FRAC_BITS );                         \
+                    maxError = error > maxError ? error : maxError;                        \
+                }                                                                          \
+            }                                                                              \
+        }                                                                                  \
+    } while( 0 )
+
+//-----------------------------------------------------------------------------
+//
+static void BenchMatrices( primitives_bench_report_t report, void *context )
+{
+    uint64_t bestTicks;
+    uint32_t maxError;
+
+    BENCH_MAT_KERNEL( bestTicks, maxError, MatMul3x3, 3 );
+    ReportBench( report, context, "MatMul3x3 Q16", BENCH_MAT_NB, bestTicks, maxError, "lsb" );
+
+    BENCH_MAT_KERNEL( bestTicks, maxError, MatMul6x6, 6 );
+    ReportBench( report, context, "MatMul6x6 Q16", BENCH_MAT_NB, bestTicks, maxError, "lsb" );
+}
+
+//-----------------------------------------------------------------------------
+// Returns a dense matrix over data, with BENCH_MAT_FRAC_BITS.
+static fp_mat_t BenchMat( int32_t *data, size_t rows, size_t cols )
+{
+    fp_mat_t mat = {
+        .rows = rows,
+        .cols = cols,
+        .rowStride = cols,
+        .colStride = 1,
+        .fracBits = BENCH_MAT_FRAC_BITS,
+        .data = ( uint32_t * )data,
+        .rowsFilter = 0,
+        .colsFilter = 0,
+        .recyclable = false };
+    return mat;
+}
+
+//-----------------------------------------------------------------------------
+// Solves the system of matrix m and right-hand side m + 36, as filled by
+// BenchSolve(), with doubles.
+static void ReferenceSolve6x6( uint32_t m, double *sol )
+{
+    double a[6][7];
+    for( uint32_t r = 0; r < 6; ++r )
+    {
+        for( uint32_t c = 0; c < 6; ++c )
+        {
+            a[r][c] = benchBuffers.mat.op1[m][r * 6 + c] / 65536.0;
+        }
+        a[r][6] = benchBuffers.mat.op2[m][r] / 65536.0;
+    }
+    for( uint32_t p = 0; p < 6; ++p )
+    {
+        for( uint32_t r = p + 1; r < 6; ++r )
+        {
+            double factor = a[r][p] / a[p][p];
+            for( uint32_t c = p; c < 7; ++c )
+            {
+                a[r][c] -= factor * a[p][c];
+            }
+        }
+    }
+    for( uint32_t r = 6; r-- > 0; )
+    {
+        double sum = a[r][6];
+        for( uint32_t c = r + 1; c < 6; ++c )
+        {
+            sum -= a[r][c] * sol[c];
+        }
+        sol[r] = sum / a[r][r];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// The systems are symmetric positive definite, I + M * M^T / 6 with M in
+// [-1, 1), as the normal equations of a fit. Returns the greatest error of the
+// solutions, in res.
+static uint32_t BenchSolveError( void )
+{
+    uint32_t maxError = 0;
+    for( uint32_t m = 0; m < BENCH_MAT_NB; ++m )
+    {
+        double ref[6];
+        ReferenceSolve6x6( m, ref );
+        for( uint32_t r = 0; r < 6; ++r )
+        {
+            uint32_t error = LsbError( benchBuffers.mat.res[m][r], ref[r], BENCH_MAT_FRAC_BITS );
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+    return maxError;
+}
+
+//-----------------------------------------------------------------------------
+//
+static void BenchSolve( primitives_bench_report_t report, void *context )
+{
+    uint64_t bestTicks;
+    int32_t factors[36];
+
+    for( uint32_t m = 0; m < BENCH_MAT_NB; ++m )
+    {
+        for( uint32_t e = 0; e < 36; ++e )
+        {
+            factors[e] = BenchRandomRange( -1 << 16, 1 << 16 );
+        }
+        for( uint32_t r = 0; r < 6; ++r )
+        {
+            for( uint32_t c = 0; c < 6; ++c )
+            {
+                int64_t sum = 0;
+                for( uint32_t k = 0; k < 6; ++k )
+                {
+                    sum += ( int64_t )factors[r * 6 + k] * factors[c * 6 + k];
+                }
+                benchBuffers.mat.op1[m][r * 6 + c] = ( int32_t )( sum / ( 6 << 16 ) ) + ( r == c ? 1 << 16 : 0 );
+            }
+            benchBuffers.mat.op2[m][r] = BenchRandomRange( -1 << 16, 1 << 16 );
+        }
+    }
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_MAT_NB,
+        SolveSym6x6( BenchMat( benchBuffers.mat.op1[i], 6, 6 ),
+                     BenchMat( benchBuffers.mat.op2[i], 6, 1 ),
+                     BenchMat( benchBuffers.mat.res[i], 6, 1 ) ) );
+    ReportBench( report, context, "SolveSym6x6 Q16", BENCH_MAT_NB, bestTicks, BenchSolveError(), "lsb" );
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_MAT_NB,
+        CreateFPMat( inv, 6, 6, BENCH_MAT_FRAC_BITS );
+        InvertSquareMatrix6x6( BenchMat( benchBuffers.mat.op1[i], 6, 6 ), inv );
+        MatMul( inv, BenchMat( benchBuffers.mat.op2[i], 6, 1 ), BenchMat( benchBuffers.mat.res[i], 6, 1 ) ) );
+    ReportBench( report, context, "Invert6x6 and MatMul Q16", BENCH_MAT_NB, bestTicks, BenchSolveError(), "lsb" );
+}
+
+//-----------------------------------------------------------------------------
+// Sorts scores by decreasing value.
+static int CompareScoresDescending( const void *score1, const void *score2 )
+{
+    return *( const int16_t * )score2 - *( const int16_t * )score1;
+}
+
+//-----------------------------------------------------------------------------
+// Fills the scores as the raw confidences of a detection layer: background
+// cells around a logit of -6, and 2% of object cells around 2, with
+// ML_ENGINE_OUTPUT_FRAC_BITS. The scores are also sorted in sorted.
+static void FillDetectionScores( void )
+{
+    for( uint32_t i = 0; i < BENCH_SELECT_SIZE; ++i )
+    {
+        bool object = BenchRandom() % 100 < 2;
+        benchBuffers.select.scores[i] = ( int16_t )( object
+            ? BenchRandomNormal( 2 << BENCH_FRAC_BITS, 3 << ( BENCH_FRAC_BITS - 1 ) )
+            : BenchRandomNormal( -6 << BENCH_FRAC_BITS, 3 << ( BENCH_FRAC_BITS - 1 ) ) );
+        benchBuffers.select.sorted[i] = benchBuffers.select.scores[i];
+    }
+    qsort( benchBuffers.select.sorted, BENCH_SELECT_SIZE, sizeof( int16_t ), CompareScoresDescending );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the count of selected indices that are not among the selectedNb
+// greatest scores.
+static uint32_t CountWrongSelections( size_t selectedNb )
+{
+    uint32_t wrong = 0;
+    if( selectedNb == 0 )
+    {
+        return 0;
+    }
+    for( size_t i = 0; i < selectedNb; ++i )
+    {
+        if( benchBuffers.select.scores[benchBuffers.select.indices[i]] <
+            benchBuffers.select.sorted[selectedNb - 1] )
+        {
+            ++wrong;
+        }
+    }
+    return wrong;
+}
+
+//-----------------------------------------------------------------------------
+// Fills the scores as the raw confidences PostprocessCompactModel() selects
+// from: 0 for the background cells, and 2% of face cells around a logit of 2.
+// The scores are also sorted in sorted.
+static void FillDuplicateScores( void )
+{
+    for( uint32_t i = 0; i < BENCH_SELECT_SIZE; ++i )
+    {
+        bool face = BenchRandom() % 100 < 2;
+        benchBuffers.select.scores[i] = ( int16_t )( face
+            ? BenchRandomNormal( 2 << BENCH_FRAC_BITS, 3 << ( BENCH_FRAC_BITS - 1 ) )
+            : 0 );
+        benchBuffers.select.sorted[i] = benchBuffers.select.scores[i];
+    }
+    qsort( benchBuffers.select.sorted, BENCH_SELECT_SIZE, sizeof( int16_t ), CompareScoresDescending );
+}
+
+//-----------------------------------------------------------------------------
+// Times QuickSelect(), or QuickSelectKeyed() if keyed, on the scores. Both
+// reorder their indices, they are reset out of the timing before each call.
+static void BenchQuickSelect( primitives_bench_report_t report, void *context,
+                              const char *name, bool keyed )
+{
+    uint64_t bestTicks = UINT64_MAX;
+
+    for( uint32_t run = 0; run < BENCH_RUNS_NB; ++run )
+    {
+        uint64_t ticks = 0;
+        for( uint32_t call = 0; call < BENCH_SELECT_CALLS_NB; ++call )
+        {
+            for( size_t i = 0; i < BENCH_SELECT_SIZE; ++i )
+            {
+                benchBuffers.select.indices[i] = i;
+            }
+            uint64_t start = BenchCounter();
+            if( keyed )
+            {
+                QuickSelectKeyed( benchBuffers.select.indices, BENCH_SELECT_SIZE,
+                                  benchBuffers.select.scores, BENCH_SELECT_K,
+                                  benchBuffers.select.keys );
+            }
+            else
+            {
+                QuickSelect( benchBuffers.select.indices, BENCH_SELECT_SIZE,
+                             benchBuffers.select.scores, BENCH_SELECT_K );
+            }
+            ticks += BenchCounter() - start;
+        }
+        bestTicks = ticks < bestTicks ? ticks : bestTicks;
+    }
+    ReportBench( report, context, name, BENCH_SELECT_CALLS_NB, bestTicks,
+                 CountWrongSelections( BENCH_SELECT_K ), "wrong" );
+}
+
+//-----------------------------------------------------------------------------
+// The selections are timed on the scores of a detection layer, then on those
+// of the compact model, mostly equal.
+static void BenchSelection( primitives_bench_report_t report, void *context )
+{
+    uint64_t bestTicks;
+    uint32_t wrong = 0;
+
+    FillDetectionScores();
+    BenchQuickSelect( report, context, "QuickSelect 1728 k=100", false );
+    BenchQuickSelect( report, context, "QuickSelectKeyed 1728 k=100", true );
+
+    size_t selectedNb = 0;
+    TIME_BENCH_RUNS( bestTicks, BENCH_SELECT_CALLS_NB,
+        selectedNb = HeapSelectAboveThreshold(
+            benchBuffers.select.indices, BENCH_SELECT_SIZE, benchBuffers.select.scores,
+            BENCH_SELECT_THRESHOLD, BENCH_SELECT_K ) );
+    size_t aboveNb = 0;
+    while( aboveNb < BENCH_SELECT_SIZE && benchBuffers.select.sorted[aboveNb] > BENCH_SELECT_THRESHOLD )
+    {
+        ++aboveNb;
+    }
+    size_t expectedNb = aboveNb < BENCH_SELECT_K ? aboveNb : BENCH_SELECT_K;
+    wrong = CountWrongSelections( selectedNb ) +
+        ( uint32_t )( selectedNb > expectedNb ? selectedNb - expectedNb : expectedNb - selectedNb );
+    ReportBench( report, context, "HeapSelectAboveThreshold 1728", BENCH_SELECT_CALLS_NB, bestTicks, wrong, "wrong" );
+
+    FillDuplicateScores();
+    BenchQuickSelect( report, context, "QuickSelect 1728 98% equal", false );
+    BenchQuickSelect( report, context, "QuickSelectKeyed 1728 98% equal", true );
+}
+
+//-----------------------------------------------------------------------------
+// Returns the number of fields of the fused landmarks results that differ from
+// those of the separate passes.
+static uint32_t CountLandmarksMismatches(
+    const landmarks_2d_stats_t *stats,
+    geometric_point_2d_t mean,
+    const geometric_box_t *box )
+{
+    const landmarks_2d_facefit_t *landmarks = &benchBuffers.landmarks.landmarks;
+    const landmarks_2d_facefit_t *fused = &benchBuffers.landmarks.fused;
+    uint32_t mismatches = 0;
+
+    for( size_t i = 0; i < DEFAULT_LANDMARKS_NB; ++i )
+    {
+        mismatches += landmarks->x[i] != fused->x[i] ? 1 : 0;
+        mismatches += landmarks->y[i] != fused->y[i] ? 1 : 0;
+    }
+    mismatches += stats->mean.x.n != mean.x.n ? 1 : 0;
+    mismatches += stats->mean.y.n != mean.y.n ? 1 : 0;
+    mismatches += stats->box.left.n != box->left.n ? 1 : 0;
+    mismatches += stats->box.top.n != box->top.n ? 1 : 0;
+    mismatches += stats->box.right.n != box->right.n ? 1 : 0;
+    mismatches += stats->box.bottom.n != box->bottom.n ? 1 : 0;
+    return mismatches;
+}
+
+//-----------------------------------------------------------------------------
+// The landmarks are those of a face of about 200 pixels in a VGA image. The
+// translation alternates sign so that they stay in place over the runs.
+static void BenchLandmarks( primitives_bench_report_t report, void *context )
+{
+    landmarks_2d_facefit_t *landmarks = &benchBuffers.landmarks.landmarks;
+    landmarks_2d_facefit_t *fused = &benchBuffers.landmarks.fused;
+    uint8_t *indices = benchBuffers.landmarks.indices;
+    uint64_t bestTicks;
+
+    landmarks->fracBits = BENCH_FRAC_BITS;
+    for( size_t i = 0; i < DEFAULT_LANDMARKS_NB; ++i )
+    {
+        landmarks->x[i] = BenchRandomRange( 220 << BENCH_FRAC_BITS, 420 << BENCH_FRAC_BITS );
+        landmarks->y[i] = BenchRandomRange( 140 << BENCH_FRAC_BITS, 340 << BENCH_FRAC_BITS );
+        indices[i] = ( uint8_t )i;
+    }
+    *fused = *landmarks;
+
+    geometric_vector_2d_t translations[2] = {
+        { .x = CreateFPInt( -12, BENCH_FRAC_BITS ), .y = CreateFPInt( 7, BENCH_FRAC_BITS ) },
+        { .x = CreateFPInt( 12, BENCH_FRAC_BITS ), .y = CreateFPInt( -7, BENCH_FRAC_BITS ) } };
+    geometric_point_2d_t mean;
+    geometric_box_t box;
+    landmarks_2d_stats_t stats;
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_LANDMARKS_CALLS_NB,
+        TranslateLandmarks2dFaceFit( landmarks, DEFAULT_LANDMARKS_NB, translations[i & 1] );
+        mean = LandmarksMean2dFaceFit( landmarks, indices, DEFAULT_LANDMARKS_NB );
+        box = BoxFromLandmarks( landmarks, DEFAULT_LANDMARKS_NB ) );
+    ReportBench( report, context, "Translate+Mean+Box 68 landmarks", BENCH_LANDMARKS_CALLS_NB, bestTicks, 0, "mismatches" );
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_LANDMARKS_CALLS_NB,
+        stats = Landmarks2dStatsFaceFit( fused, DEFAULT_LANDMARKS_NB, &translations[i & 1] ) );
+    ReportBench( report, context, "Landmarks2dStatsFaceFit 68 landmarks", BENCH_LANDMARKS_CALLS_NB, bestTicks,
+                 CountLandmarksMismatches( &stats, mean, &box ), "mismatches" );
+}
+
+//-----------------------------------------------------------------------------
+// The operands are spread over all magnitudes, from 0 to 2^64 - 1.
+static void BenchISqrt64( primitives_bench_report_t report, void *context )
+{
+    uint64_t *op = benchBuffers.isqrt.op;
+    uint32_t *res = benchBuffers.isqrt.res;
+    uint64_t bestTicks;
+    uint32_t wrong = 0;
+
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint64_t n = ( ( uint64_t )BenchRandom() << 32 ) | BenchRandom();
+        op[i] = n >> ( BenchRandom() % 64 );
+    }
+
+    TIME_BENCH_RUNS( bestTicks, BENCH_OPS_NB, res[i] = ISqrt64( op[i] ) );
+    for( uint32_t i = 0; i < BENCH_OPS_NB; ++i )
+    {
+        uint64_t r = res[i];
+        bool tooLarge = r * r > op[i];
+        bool tooSmall = r < UINT32_MAX && ( r + 1 ) * ( r + 1 ) <= op[i];
+        wrong += tooLarge || tooSmall ? 1 : 0;
+    }
+    ReportBench( report, context, "ISqrt64", BENCH_OPS_NB, bestTicks, wrong, "wrong" );
+}
+
+//-----------------------------------------------------------------------------
+//
+void RunPrimitivesBench( primitives_bench_report_t report, void *context )
+{
+    benchRandomState = 0x2545F491u;
+
+    BenchScalarPrimitives( report, context );
+    BenchIoU( report, context );
+    BenchSelection( report, context );
+    BenchMatrices( report, context );
+    BenchSolve( report, context );
+    BenchLandmarks( report, context );
+    BenchISqrt64( report, context );
+}
+
+//-----------------------------------------------------------------------------
+//
+static void FormatBenchResult( const primitives_bench_result_t *result, void *context )
+{
+    bench_format_context_t *format = ( bench_format_context_t * )context;
+    if( format->size >= format->bufferSize )
+    {
+        return;
+    }
+
+    int written = snprintf(
+        &format->buffer[format->size], format->bufferSize - format->size,
+        "%-30s %6" PRIu32 " %10" PRIu32 ".%" PRIu32 " %8" PRIu32 " %s\n",
+        result->name, result->opsNb, result->cyclesPerOpX10 / 10,
+        result->cyclesPerOpX10 % 10, result->maxError, result->errorUnit );
+    if( written > 0 )
+    {
+        format->size += ( size_t )written;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+size_t FormatPrimitivesBench( char *buffer, size_t bufferSize )
+{
+    bench_format_context_t format = { buffer, bufferSize, 0 };
+
+    int written = snprintf( buffer, bufferSize, "%-30s %6s %12s %8s\n%-30s %6s %12s\n",
+        "primitive", "ops", "per op", "max err", "", "", PrimitivesBenchCounterUnit() );
+    if( written > 0 )
+    {
+        format.size = ( size_t )written;
+    }
+
+    RunPrimitivesBench( FormatBenchResult, &format );
+
+    return format.size < bufferSize ? format.size : bufferSize - 1;
+}
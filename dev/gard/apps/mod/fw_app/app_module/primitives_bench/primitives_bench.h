@@ -0,0 +1,59 @@
+//=============================================================================
+//
+// Copyright(c) 2025 Mirametrix Inc. All rights reserved.
+//
+// These coded instructions, statements, and computer programs contain
+// unpublished proprietary information written by MMX and
+// are protected by copyright law. They may not be disclosed
+// to third parties or copied or duplicated in any form, in whole or
+// in part, without the prior written consent of MMX.
+//
+//=============================================================================
+
+#ifndef PRIMITIVES_BENCH_H
+#define PRIMITIVES_BENCH_H
+
+//=============================================================================
+// I N C L U D E   F I L E S   A N D   F O R W A R D   D E C L A R A T I O N S
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=============================================================================
+// S T R U C T   D E C L A R A T I O N S
+
+// Result of the benchmark of a primitive
+typedef struct
+{
+    const char *name;
+    uint32_t opsNb;            // Operations per timed run
+    uint32_t cyclesPerOpX10;   // Counter ticks per operation of the fastest
+                               // run, times 10
+    uint32_t maxError;         // Greatest error against the float reference
+    const char *errorUnit;     // "lsb": in units of the fixed point result,
+                               // "wrong": count of wrong results
+} primitives_bench_result_t;
+
+// Called with the result of each benchmark
+typedef void ( *primitives_bench_report_t )(
+    const primitives_bench_result_t *result,
+    void *context );
+
+//=============================================================================
+// F U N C T I O N S   D E C L A R A T I O N S
+
+// Returns the unit of the counter the benchmarks are timed with: the CPU
+// cycles (mcycle) on GARD, the TSC or ns on the host.
+const char *PrimitivesBenchCounterUnit( void );
+
+// Runs the benchmarks of the common fixed point, box, selection, matrix and
+// integer square root primitives, and calls report with the result of each.
+// The inputs are pseudo-random, the same on every run and target, so the
+// results of two builds can be compared.
+void RunPrimitivesBench( primitives_bench_report_t report, void *context );
+
+// Writes the results as a text table to buffer, returns the written size,
+// without the terminating 0.
+size_t FormatPrimitivesBench( char *buffer, size_t bufferSize );
+
+#endif
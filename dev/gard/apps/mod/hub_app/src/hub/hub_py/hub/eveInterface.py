@@ -23,7 +23,7 @@
 # 8.  configure() - Configures EVE features (local pipeline -- not available for EVE Light)
 # 9.  configureFpga() - Configures FPGA features
 # 10. get_frame_id() - Returns the current frame ID
-# 11. get_json() - Returns the latest JSON metadata as a dictionary
+# 11. get_json() - Returns the latest JSON metadata as a dictionary, decoded on first use
 # 12. get_json_str() - Returns the latest JSON metadata as a string
 # 13. get_image_jpg() - Returns the latest processed image as a JPG byte array
 # 14. get_image() - Returns the latest processed image
@@ -35,6 +35,7 @@
 # 20. stop() - Stops EVE processing
 # 21. send_manual_buffer() - Sends a manual FPGA data buffer to EVE
 # 22. isManualMetadataEnabled() - Returns whether or not we are drawing metadata on the image
+# 23. get_fpga_data() - Returns the latest FPGA metadata as a numpy structured array, without JSON
 #
 # -----------------------------------------------------------------------------
 
@@ -67,6 +68,8 @@ class EVEInterface():
         self._imageClone = None
         self._json = None
         self._jsonStr = ""
+        # (metadata string, its decoded dictionary), decoded by get_json() on first use
+        self._jsonCache = ("", None)
         self._frame_id = 0
         self._fpga_enabled = False
         self._comport = comport
@@ -80,6 +83,8 @@ class EVEInterface():
         self._copyImage = copyImage
         self._maxWidth = maxWidth
         self._fpgaState = {}
+        # Last value of each (pipeline, setting) known to the FPGA, so that only changes are sent
+        self._sentSettings = {}
         self._fpgaCameraId = -1
         self._metaDataFpgaCameraId = -1
         self._usedCameraId = -1
@@ -267,6 +272,24 @@ class EVEInterface():
         if options.error != sdk.structs.EveError.EVE_ERROR_NO_ERROR:
             raise RuntimeError(f"Could't configure FPGA {options.error}")
             
+    def __sendSetting(self, featureType, settingType, value, force=False):
+        key = (int(featureType), int(settingType))
+        if not force and self._sentSettings.get(key) == value:
+            return True
+
+        command = sdk.structs.pipeline_config_t(type=featureType,
+            setting=sdk.structs.pipeline_setting_t(
+                settingType=settingType,
+                value=value))
+        err = eve_sdk.SendSetSetting(command)
+        if err != sdk.structs.EveError.EVE_ERROR_NO_ERROR:
+            print(f"SendSetSetting error code: {err}")
+            self._sentSettings.pop(key, None)
+            return False
+
+        self._sentSettings[key] = value
+        return True
+
     def registerFaceID(self):
         if not eve_sdk:
             raise RuntimeError(f"Eve SDK not initialized")
@@ -326,7 +349,9 @@ class EVEInterface():
                     eve_sdk.EveConfigureObjectDetection(sdk.structs.EveObjectDetectionOptions(enabled=enabled))
 
         return True
-    def configureFpga(self, feats):
+    # Only the settings which differ from the ones last sent, or reported by the FPGA, go over I2C.
+    # force sends them all, e.g. once the FPGA was reset.
+    def configureFpga(self, feats, force=False):
         if not eve_sdk:
             raise RuntimeError(f"Eve SDK not initialized")
         for featureName in feats:
@@ -349,13 +374,7 @@ class EVEInterface():
                 if "enabled" in f:
                     enabled = 1 if f["enabled"] else 0
                     print(f"{featureName}: {enabled}")
-                    
-                    # TODO: Not for all features all the time, only the ones that changed.
-                    command = sdk.structs.pipeline_config_t(type=featureType, 
-                        setting=sdk.structs.pipeline_setting_t(
-                            settingType=FACE_ID_SECONDARY_USERS,
-                            value=1 if enabled else 0))
-                    eve_sdk.SendSetSetting(command)
+                    self.__sendSetting(featureType, FACE_ID_SECONDARY_USERS, enabled, force)
                 continue
             else:
                 print(f"Unknown feature name: '{featureName}'")
@@ -365,22 +384,11 @@ class EVEInterface():
             if "enabled" in f:
                 enabled = 1 if f["enabled"] else 0
                 print(f"{featureName}: {enabled}")
-                
-                # TODO: Not for all features all the time, only the ones that changed.
-                command = sdk.structs.pipeline_config_t(type=featureType, 
-                    setting=sdk.structs.pipeline_setting_t(
-                        settingType=sdk.structs.setting_type_t.CS_ENABLED,
-                        value=1 if enabled else 0))
-                eve_sdk.SendSetSetting(command)
+                self.__sendSetting(featureType, sdk.structs.setting_type_t.CS_ENABLED, enabled, force)
             if "max_ips" in f:
                 ips = int(f["max_ips"])
                 print(f"{featureName} IPS: {ips}")
-                
-                command = sdk.structs.pipeline_config_t(type=featureType, 
-                    setting=sdk.structs.pipeline_setting_t(
-                        settingType=sdk.structs.setting_type_t.CS_IPS,
-                        value=ips))
-                eve_sdk.SendSetSetting(command)
+                self.__sendSetting(featureType, sdk.structs.setting_type_t.CS_IPS, ips, force)
                 
         return True        
 
@@ -388,11 +396,28 @@ class EVEInterface():
         return self._frame_id
         
     def get_json(self):
-        return self._json
+        jsonStr = self._jsonStr
+        cachedStr, dataJson = self._jsonCache
+        if cachedStr is not jsonStr:
+            dataJson = json.loads(jsonStr) if jsonStr else None
+            self._jsonCache = (jsonStr, dataJson)
+            self._json = dataJson
+        return dataJson
         
     def get_json_str(self):
         return self._jsonStr
         
+    # Binary path to the FPGA metadata, for consumers which do not need the JSON.
+    # Returns a one element numpy structured array with the CFpgaData fields, None if there is none.
+    def get_fpga_data(self):
+        if not eve_sdk:
+            raise RuntimeError(f"Eve SDK not initialized")
+        fpgaData = eve_sdk.EveGetFpgaData()
+        if fpgaData.error != sdk.structs.EveError.EVE_ERROR_NO_ERROR or not fpgaData.data:
+            return None
+        # Copied out, EVE reuses its buffer for the next frame
+        return np.ctypeslib.as_array(fpgaData.data, shape=(1,)).copy()
+
     def get_image_jpg(self):
         return self._image
         
@@ -472,6 +497,8 @@ class EVEInterface():
             #if not setting.setting in feature:
             if setting.setting < sdk.structs.setting_type_t.CS_MAX:
                 feature[sdk.structs.setting_type_t(setting.setting)] = setting.value
+            # What the FPGA reports is what it has, whatever was sent before
+            self._sentSettings[(int(setting.type), int(setting.setting))] = setting.value
             setting = self.poll_setting()
         
     def readJson(self):
@@ -479,10 +506,10 @@ class EVEInterface():
             raise RuntimeError(f"Eve SDK not initialized")
         fpgaJson = eve_sdk.FpgaReadJson()
         if fpgaJson.textStart:
+            # Decoded only when someone asks for it, see get_json()
             jsonStr = ctypes.string_at(fpgaJson.textStart, fpgaJson.textSize)
-            self._jsonStr = jsonStr
-            dataJson = json.loads(jsonStr)
-            self._json = dataJson
+            if jsonStr != self._jsonStr:
+                self._jsonStr = jsonStr
 
     def stop(self):
         if not eve_sdk:
@@ -496,7 +523,7 @@ class EVEInterface():
 
     def send_manual_buffer(self, buf):
         if buf:            
-            c_array = (ctypes.c_ubyte * len(buf))(*buf)
+            c_array = (ctypes.c_ubyte * len(buf)).from_buffer_copy(buf)
             if self._fpga_enabled:
                 fpgaManualData = sdk.structs.EveFpgaManualData(c_array, len(buf))
                 error = eve_sdk.EveSendFpgaDataManually(fpgaManualData)                
@@ -3,32 +3,23 @@
 
 #include <iostream>
 
-extern "C" {
-#include "hub.h"
-}
+#include "hub.hpp"
 
 using namespace std;
 
 int main()
 {
-	hub_handle_t      hub;
-	enum hub_ret_code ret;
-
 	cout << "HUB version is " << hub_get_version_string() << endl;
 
-	char host_cfg_file[] = "/opt/hub/config/host_config.json";
-	char gard_path[]     = "/opt/hub/config";
-
-	ret                  = hub_preinit(host_cfg_file, gard_path, &hub);
-	cout << "ret for hub_preinit = " << ret << endl;
+	/* hub_preinit(), hub_discover_gards() and hub_init(), hub_fini() on exit */
+	auto hub = hub::Hub::open("/opt/hub/config/host_config.json",
+							  "/opt/hub/config");
+	if (!hub) {
+		cout << "HUB open failed: " << hub.error() << endl;
+		return 1;
+	}
 
-	ret = hub_discover_gards(hub);
-	cout << "ret for hub_discover_gards = " << ret << endl;
-
-	ret = hub_init(hub);
-	cout << "ret for hub_init = " << ret << endl;
-
-	hub_fini(hub);
+	cout << "GARDs discovered: " << hub->num_gards() << endl;
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,516 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB benchmark application
+ *
+ * For every GARD discovered, this application measures:
+ * 1. Register read and write round trip latency, on the control bus.
+ * 2. hub_send_data_to_gard() / hub_recv_data_from_gard() throughput and
+ *    latency over a range of payload sizes, on the data bus.
+ * 3. Snapshot capture latency: the capture command alone, and with the
+ *    transfer of the image.
+ * 4. App data latency, from the GPIO edge GARD raised to the callback, if
+ *    the GPIO line of the GARD is given. GARD has to be streaming app data.
+ *
+ * The results are written as JSON, to stdout or to a file, so that runs can
+ * be compared from one build to the next.
+ *
+ * Note:
+ * * 1. The data transfers overwrite GARD memory at the scratch address,
+ *      BENCH_SCRATCH_ADDR by default. Pick one that is free on the GARD FW
+ *      under test.
+ * * 2. The app data callback cannot be removed, so the app data benchmark is
+ *      run last on each GARD.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hub.h"
+
+/* GARD memory the data transfers go to, same as app.c */
+#define BENCH_SCRATCH_ADDR (0x0C000000)
+
+#define BENCH_REG_ITERATIONS      (1000)
+#define BENCH_CAPTURE_ITERATIONS  (20)
+#define BENCH_DATA_MAX_ITERATIONS (100)
+/* Bytes moved per payload size, so that large sizes do not run for ever */
+#define BENCH_DATA_BYTES_PER_SIZE (4 * 1024 * 1024)
+#define BENCH_DATA_MIN_ITERATIONS (4)
+
+#define BENCH_APPDATA_SECONDS     (10)
+#define BENCH_APPDATA_MAX_SAMPLES (4096)
+#define BENCH_APPDATA_BUFFER_SIZE (4096)
+
+#define BENCH_CAMERA_ID (0)
+
+static const uint32_t bench_data_sizes[] = {
+	256, 1024, 4 * 1024, 16 * 1024, 64 * 1024, 256 * 1024,
+};
+
+static const char *bench_bus_names[] = {FOR_EACH_BUS(GEN_BUS_STRING)};
+
+/* Latency summary of a set of samples, in nanoseconds */
+struct bench_latency {
+	uint32_t count;
+	uint64_t min_ns;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+	uint64_t max_ns;
+	uint64_t mean_ns;
+};
+
+/**
+ * App data samples of a GARD, filled by the callback. The callback stays
+ * registered until hub_fini(), so there is one per GARD, kept until then.
+ */
+struct bench_appdata_ctx {
+	pthread_mutex_t lock;
+	gard_handle_t   grd;
+	int             line_offset;
+	bool            is_open;
+	uint32_t        num_events;
+	uint32_t        num_samples;
+	uint64_t        edge_to_cb_ns[BENCH_APPDATA_MAX_SAMPLES];
+	uint64_t        edge_to_worker_ns[BENCH_APPDATA_MAX_SAMPLES];
+	uint8_t         buffer[BENCH_APPDATA_BUFFER_SIZE];
+};
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp_u64(const void *p_a, const void *p_b)
+{
+	uint64_t a = *(const uint64_t *)p_a;
+	uint64_t b = *(const uint64_t *)p_b;
+
+	return (a > b) - (a < b);
+}
+
+/* Summarise samples, which get sorted */
+static struct bench_latency bench_summarise(uint64_t *p_samples,
+											uint32_t  count)
+{
+	struct bench_latency latency = {0};
+	uint64_t             total   = 0;
+	uint32_t             i;
+
+	if (0 == count) {
+		return latency;
+	}
+
+	qsort(p_samples, count, sizeof(p_samples[0]), bench_cmp_u64);
+	for (i = 0; i < count; i++) {
+		total += p_samples[i];
+	}
+
+	latency.count   = count;
+	latency.min_ns  = p_samples[0];
+	latency.p50_ns  = p_samples[(count - 1) / 2];
+	latency.p99_ns  = p_samples[((uint64_t)(count - 1) * 99) / 100];
+	latency.max_ns  = p_samples[count - 1];
+	latency.mean_ns = total / count;
+
+	return latency;
+}
+
+static void bench_print_latency(FILE *fp, const char *name,
+								const struct bench_latency *p_latency)
+{
+	fprintf(fp,
+			"\"%s\": {\"count\": %u, \"min_us\": %.3f, \"p50_us\": %.3f, "
+			"\"p99_us\": %.3f, \"max_us\": %.3f, \"mean_us\": %.3f}",
+			name, p_latency->count, p_latency->min_ns / 1000.0,
+			p_latency->p50_ns / 1000.0, p_latency->p99_ns / 1000.0,
+			p_latency->max_ns / 1000.0, p_latency->mean_ns / 1000.0);
+}
+
+/* Register read and write round trips */
+static void bench_registers(FILE *fp, gard_handle_t grd, uint64_t *p_samples)
+{
+	struct bench_latency latency;
+	uint32_t             value  = 0;
+	uint32_t             errors = 0;
+	uint32_t             count  = 0;
+	uint64_t             start_ns;
+	uint32_t             i;
+
+	for (i = 0; i < BENCH_REG_ITERATIONS; i++) {
+		start_ns = bench_now_ns();
+		if (HUB_SUCCESS != hub_write_gard_reg(grd, BENCH_SCRATCH_ADDR, i)) {
+			errors++;
+			continue;
+		}
+		p_samples[count++] = bench_now_ns() - start_ns;
+	}
+	latency = bench_summarise(p_samples, count);
+	fprintf(fp, "      \"reg_write\": {\"errors\": %u, ", errors);
+	bench_print_latency(fp, "latency", &latency);
+	fprintf(fp, "},\n");
+
+	errors = 0;
+	count  = 0;
+	for (i = 0; i < BENCH_REG_ITERATIONS; i++) {
+		start_ns = bench_now_ns();
+		if (HUB_SUCCESS != hub_read_gard_reg(grd, BENCH_SCRATCH_ADDR, &value)) {
+			errors++;
+			continue;
+		}
+		p_samples[count++] = bench_now_ns() - start_ns;
+	}
+	latency = bench_summarise(p_samples, count);
+	fprintf(fp, "      \"reg_read\": {\"errors\": %u, ", errors);
+	bench_print_latency(fp, "latency", &latency);
+	fprintf(fp, "},\n");
+}
+
+/* Data transfers of one direction over all payload sizes */
+static void bench_data(FILE *fp, gard_handle_t grd, bool is_send,
+					   uint8_t *p_buffer, uint64_t *p_samples)
+{
+	struct bench_latency latency;
+	enum hub_ret_code    ret;
+	uint32_t             iterations;
+	uint32_t             errors;
+	uint32_t             count;
+	uint64_t             total_ns;
+	uint64_t             start_ns;
+	uint32_t             size;
+	uint32_t             s;
+	uint32_t             i;
+
+	fprintf(fp, "      \"%s\": [\n", is_send ? "send_data" : "recv_data");
+
+	for (s = 0; s < sizeof(bench_data_sizes) / sizeof(bench_data_sizes[0]);
+		 s++) {
+		size       = bench_data_sizes[s];
+		iterations = BENCH_DATA_BYTES_PER_SIZE / size;
+		if (iterations > BENCH_DATA_MAX_ITERATIONS) {
+			iterations = BENCH_DATA_MAX_ITERATIONS;
+		} else if (iterations < BENCH_DATA_MIN_ITERATIONS) {
+			iterations = BENCH_DATA_MIN_ITERATIONS;
+		}
+
+		errors   = 0;
+		count    = 0;
+		total_ns = 0;
+		for (i = 0; i < iterations; i++) {
+			start_ns = bench_now_ns();
+			if (is_send) {
+				ret = hub_send_data_to_gard(grd, p_buffer, BENCH_SCRATCH_ADDR,
+											size);
+			} else {
+				ret = hub_recv_data_from_gard(grd, p_buffer,
+											  BENCH_SCRATCH_ADDR, size);
+			}
+			if (HUB_SUCCESS != ret) {
+				errors++;
+				continue;
+			}
+			p_samples[count] = bench_now_ns() - start_ns;
+			total_ns += p_samples[count];
+			count++;
+		}
+
+		latency = bench_summarise(p_samples, count);
+		fprintf(fp,
+				"        {\"size\": %u, \"errors\": %u, \"throughput_mbps\": "
+				"%.3f, ",
+				size, errors,
+				total_ns ? ((double)size * count * 8.0 * 1000.0) / total_ns
+						 : 0.0);
+		bench_print_latency(fp, "latency", &latency);
+		fprintf(fp, "}%s\n",
+				(s + 1 < sizeof(bench_data_sizes) / sizeof(bench_data_sizes[0]))
+					? ","
+					: "");
+	}
+
+	fprintf(fp, "      ],\n");
+}
+
+/* Snapshot captures, the command alone and with the image transfer */
+static void bench_capture(FILE *fp, gard_handle_t grd, uint64_t *p_samples)
+{
+	struct hub_img_ops_ctx img_ops_ctx;
+	struct bench_latency   latency;
+	uint64_t              *p_total_samples = p_samples + BENCH_REG_ITERATIONS;
+	uint32_t               errors          = 0;
+	uint32_t               count           = 0;
+	uint32_t               image_size      = 0;
+	uint64_t               start_ns;
+	uint64_t               captured_ns;
+	uint32_t               i;
+
+	for (i = 0; i < BENCH_CAPTURE_ITERATIONS; i++) {
+		memset(&img_ops_ctx, 0, sizeof(img_ops_ctx));
+		img_ops_ctx.camera_id = BENCH_CAMERA_ID;
+		img_ops_ctx.no_pause  = 1;
+
+		start_ns = bench_now_ns();
+		if (HUB_SUCCESS !=
+			hub_capture_rescaled_image_from_gard(grd, &img_ops_ctx)) {
+			errors++;
+			continue;
+		}
+		captured_ns = bench_now_ns();
+
+		img_ops_ctx.p_image_buffer = malloc(img_ops_ctx.image_buffer_size);
+		if ((NULL == img_ops_ctx.p_image_buffer) ||
+			(HUB_SUCCESS !=
+			 hub_recv_data_from_gard(grd, img_ops_ctx.p_image_buffer,
+									 img_ops_ctx.image_buffer_address,
+									 img_ops_ctx.image_buffer_size))) {
+			errors++;
+		} else {
+			p_samples[count]       = captured_ns - start_ns;
+			p_total_samples[count] = bench_now_ns() - start_ns;
+			image_size             = img_ops_ctx.image_buffer_size;
+			count++;
+		}
+		free(img_ops_ctx.p_image_buffer);
+
+		/* Resume the pipelines in GARD, if they were paused for the image */
+		if (img_ops_ctx.pipeline_paused) {
+			(void)hub_send_resume_pipeline(grd, img_ops_ctx.camera_id);
+		}
+	}
+
+	fprintf(fp, "      \"capture\": {\"errors\": %u, \"image_size\": %u, ",
+			errors, image_size);
+	latency = bench_summarise(p_samples, count);
+	bench_print_latency(fp, "command", &latency);
+	fprintf(fp, ", ");
+	latency = bench_summarise(p_total_samples, count);
+	bench_print_latency(fp, "with_transfer", &latency);
+	fprintf(fp, "}");
+}
+
+/* App data callback: time from the GPIO edge to here */
+static void *bench_appdata_cb(void *params, void *p_buffer, uint32_t size)
+{
+	struct bench_appdata_ctx      *p_ctx  = (struct bench_appdata_ctx *)params;
+	uint64_t                       now_ns = bench_now_ns();
+	struct hub_appdata_event_times times;
+
+	(void)p_buffer;
+
+	if ((0 == size) ||
+		(HUB_SUCCESS != hub_get_appdata_event_times(p_ctx->grd,
+													p_ctx->line_offset,
+													&times)) ||
+		(0 == times.edge_ns) || (times.edge_ns > now_ns)) {
+		times.edge_ns = 0;
+	}
+
+	pthread_mutex_lock(&p_ctx->lock);
+	if (p_ctx->is_open) {
+		p_ctx->num_events++;
+		if ((0 != times.edge_ns) &&
+			(p_ctx->num_samples < BENCH_APPDATA_MAX_SAMPLES)) {
+			p_ctx->edge_to_cb_ns[p_ctx->num_samples] = now_ns - times.edge_ns;
+			p_ctx->edge_to_worker_ns[p_ctx->num_samples] =
+				times.worker_wake_ns - times.edge_ns;
+			p_ctx->num_samples++;
+		}
+	}
+	pthread_mutex_unlock(&p_ctx->lock);
+
+	return NULL;
+}
+
+/* App data events over BENCH_APPDATA_SECONDS */
+static void bench_appdata(FILE *fp, gard_handle_t grd, int line_offset,
+						  struct bench_appdata_ctx *p_ctx)
+{
+	struct bench_latency latency;
+	struct timespec      duration = {.tv_sec = BENCH_APPDATA_SECONDS};
+
+	pthread_mutex_init(&p_ctx->lock, NULL);
+	p_ctx->grd         = grd;
+	p_ctx->line_offset = line_offset;
+	p_ctx->is_open     = true;
+
+	if (HUB_SUCCESS != hub_setup_appdata_cb(grd, bench_appdata_cb, p_ctx,
+											p_ctx->buffer,
+											sizeof(p_ctx->buffer))) {
+		fprintf(fp, ",\n      \"appdata\": {\"error\": \"setup failed\"}");
+		return;
+	}
+
+	while (0 != nanosleep(&duration, &duration)) {
+	}
+
+	/* Late events are not counted, the samples are ours from here */
+	pthread_mutex_lock(&p_ctx->lock);
+	p_ctx->is_open = false;
+	pthread_mutex_unlock(&p_ctx->lock);
+
+	fprintf(fp,
+			",\n      \"appdata\": {\"seconds\": %d, \"events\": %u, "
+			"\"line_offset\": %d, ",
+			BENCH_APPDATA_SECONDS, p_ctx->num_events, line_offset);
+	latency = bench_summarise(p_ctx->edge_to_worker_ns, p_ctx->num_samples);
+	bench_print_latency(fp, "edge_to_worker", &latency);
+	fprintf(fp, ", ");
+	latency = bench_summarise(p_ctx->edge_to_cb_ns, p_ctx->num_samples);
+	bench_print_latency(fp, "edge_to_callback", &latency);
+	fprintf(fp, "}");
+}
+
+int main(int argc, char *argv[])
+{
+	enum hub_ret_code         ret;
+	hub_handle_t              hub            = NULL;
+	gard_handle_t             grd            = NULL;
+	struct hub_gard_stats    *p_stats        = NULL;
+	struct bench_appdata_ctx *p_appdata_ctx  = NULL;
+	uint8_t                  *p_buffer       = NULL;
+	uint64_t                 *p_samples      = NULL;
+	FILE                     *fp             = stdout;
+	int                       line_offset    = -1;
+	uint32_t                  num_gards;
+	uint32_t                  gard_num;
+	uint32_t                  i;
+
+	if (argc < 3) {
+		printf("Usage: %s <host_cfg_json_file> <directory of GARD jsons> "
+			   "[output JSON file, - for stdout] [app data GPIO line]\n",
+			   argv[0]);
+		return -1;
+	}
+
+	if ((argc > 3) && (0 != strcmp(argv[3], "-"))) {
+		fp = fopen(argv[3], "w");
+		if (NULL == fp) {
+			printf("Cannot open %s\n", argv[3]);
+			return -1;
+		}
+	}
+	if (argc > 4) {
+		line_offset = atoi(argv[4]);
+	}
+
+	p_buffer  = (uint8_t *)malloc(
+		 bench_data_sizes[sizeof(bench_data_sizes) / sizeof(bench_data_sizes[0]) -
+						  1]);
+	p_samples = (uint64_t *)calloc(2 * BENCH_REG_ITERATIONS, sizeof(uint64_t));
+	p_stats   = (struct hub_gard_stats *)calloc(1, sizeof(*p_stats));
+	if ((NULL == p_buffer) || (NULL == p_samples) || (NULL == p_stats)) {
+		printf("Cannot allocate memory for the benchmark\n");
+		goto err_app_1;
+	}
+	for (i = 0; i < bench_data_sizes[sizeof(bench_data_sizes) /
+										 sizeof(bench_data_sizes[0]) -
+									 1];
+		 i++) {
+		p_buffer[i] = (uint8_t)rand();
+	}
+
+	ret = hub_preinit(argv[1], argv[2], &hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub preinit!\n");
+		goto err_app_1;
+	}
+
+	ret = hub_discover_gards(hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub_discover_gards!\n");
+		goto err_app_2;
+	}
+
+	ret = hub_init(hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub_init!\n");
+		goto err_app_2;
+	}
+
+	num_gards = hub_get_num_gards(hub);
+
+	p_appdata_ctx = (struct bench_appdata_ctx *)calloc(
+		num_gards ? num_gards : 1, sizeof(*p_appdata_ctx));
+	if (NULL == p_appdata_ctx) {
+		printf("Cannot allocate memory for the benchmark\n");
+		goto err_app_2;
+	}
+
+	fprintf(fp, "{\n  \"hub_version\": \"%s\",\n  \"gards\": [\n",
+			hub_get_version_string());
+
+	for (gard_num = 0; gard_num < num_gards; gard_num++) {
+		grd = hub_get_gard_handle(hub, gard_num);
+		if (NULL == grd) {
+			printf("Could not get GARD handle for GARD index %d\n", gard_num);
+			goto err_app_2;
+		}
+
+		memset(p_stats, 0, sizeof(*p_stats));
+		(void)hub_get_stats(grd, p_stats);
+
+		fprintf(fp,
+				"    {\n      \"gard_num\": %u,\n      \"control_bus\": "
+				"\"%s\",\n      \"data_bus\": \"%s\",\n",
+				gard_num,
+				(p_stats->control_bus < HUB_GARD_NR_BUSSES)
+					? bench_bus_names[p_stats->control_bus]
+					: "unknown",
+				(p_stats->data_bus < HUB_GARD_NR_BUSSES)
+					? bench_bus_names[p_stats->data_bus]
+					: "unknown");
+
+		bench_registers(fp, grd, p_samples);
+		bench_data(fp, grd, true, p_buffer, p_samples);
+		bench_data(fp, grd, false, p_buffer, p_samples);
+		bench_capture(fp, grd, p_samples);
+		if (line_offset >= 0) {
+			bench_appdata(fp, grd, line_offset, &p_appdata_ctx[gard_num]);
+		}
+
+		fprintf(fp, "\n    }%s\n", (gard_num + 1 < num_gards) ? "," : "");
+	}
+
+	fprintf(fp, "  ]\n}\n");
+
+	/* The app data callback still uses these until hub_fini() */
+	ret = hub_fini(hub);
+	if (HUB_SUCCESS != ret) {
+		printf("HUB fini failed!!\n");
+	}
+
+	if (stdout != fp) {
+		fclose(fp);
+	}
+	free(p_appdata_ctx);
+	free(p_stats);
+	free(p_samples);
+	free(p_buffer);
+
+	return (HUB_SUCCESS == ret) ? 0 : -1;
+
+err_app_2:
+	printf("App error - running hub_fini()!\n");
+	(void)hub_fini(hub);
+err_app_1:
+	if (stdout != fp) {
+		fclose(fp);
+	}
+	free(p_appdata_ctx);
+	free(p_stats);
+	free(p_samples);
+	free(p_buffer);
+	return -1;
+}
@@ -0,0 +1,584 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB bus replay application
+ *
+ * Works on the bus captures written by hub_bus_capture_start():
+ * 1. Prints, for each bus of a capture, the transactions, bytes, busy time
+ *    and throughput of each HUB command, and how busy the bus was.
+ * 2. With -g, plays the GARD side of a UART bus of the capture on a pty:
+ *    HUB, with its host_config.json UART "bus_dev" set to the pty printed,
+ *    runs the workload against it. Each GARD response is sent as long after
+ *    the HUB command it answers as it was in the capture, so protocol and
+ *    threading changes of HUB can be timed on real workloads without a GARD.
+ *
+ * Note:
+ * * 1. The replay answers what GARD answered in the capture, in its order: the
+ *      workload has to send the same commands. The HUB writes that differ from
+ *      the capture are counted, not answered differently.
+ * * 2. Only UART busses can be replayed, and only from a capture taken with
+ *      all the data, max_data_bytes 0. The GPIO lines are not replayed.
+ */
+
+/* For posix_openpt() and ptsname_r() */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gard_hub_iface.h"
+#include "hub.h"
+
+/* How long the replay waits for a HUB write before giving up */
+#define REPLAY_WRITE_TIMEOUT_MS (10000)
+
+static const char *replay_bus_names[] = {FOR_EACH_BUS(GEN_BUS_STRING)};
+
+/* A record of the capture and its data, in the capture buffer */
+struct replay_record {
+	struct hub_bus_capture_record rec;
+	const uint8_t                *p_data;
+};
+
+struct replay_capture {
+	uint8_t                      *p_file;
+	struct hub_bus_capture_header header;
+	struct hub_bus_capture_bus   *p_busses;
+	struct replay_record         *p_records;
+	uint32_t                      num_records;
+};
+
+/* Totals of one HUB command on one bus */
+struct replay_cmd_stats {
+	uint32_t exchanges;
+	uint32_t writes;
+	uint32_t reads;
+	uint32_t failed;
+	uint64_t bytes_written;
+	uint64_t bytes_read;
+	uint64_t busy_ns;
+};
+
+static uint64_t replay_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void replay_sleep_until(uint64_t deadline_ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec  = (time_t)(deadline_ns / 1000000000ULL);
+	ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+	while (EINTR ==
+		   clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+	}
+}
+
+static const char *replay_cmd_name(uint8_t cmd_id)
+{
+	switch (cmd_id) {
+	case GARD_DISCOVERY:
+		return "GARD_DISCOVERY";
+	case SEND_DATA_TO_GARD_FOR_OFFSET:
+		return "SEND_DATA";
+	case RECV_DATA_FROM_GARD_AT_OFFSET:
+		return "RECV_DATA";
+	case READ_REG_VALUE_FROM_GARD_AT_OFFSET:
+		return "READ_REG";
+	case WRITE_REG_VALUE_TO_GARD_AT_OFFSET:
+		return "WRITE_REG";
+	case CAPTURE_RESCALED_IMAGE:
+		return "CAPTURE_RESCALED_IMAGE";
+	case RESUME_PIPELINE:
+		return "RESUME_PIPELINE";
+	case SET_UART_PARAMETERS:
+		return "SET_UART_PARAMETERS";
+	case READ_REGS_FROM_GARD:
+		return "READ_REGS";
+	case WRITE_REGS_TO_GARD:
+		return "WRITE_REGS";
+	case SUBSCRIBE_APP_DATA:
+		return "SUBSCRIBE_APP_DATA";
+	case GET_PIPELINE_STATS:
+		return "GET_PIPELINE_STATS";
+	case GET_NETWORK_RESIDENCY:
+		return "GET_NETWORK_RESIDENCY";
+	case INFERENCE_RATE:
+		return "INFERENCE_RATE";
+	case SCALER_CONFIG:
+		return "SCALER_CONFIG";
+	case GET_IMAGE_STATS:
+		return "GET_IMAGE_STATS";
+	case GET_GARD_TIME:
+		return "GET_GARD_TIME";
+	case RUN_INFERENCE_ON_BUFFER:
+		return "RUN_INFERENCE_ON_BUFFER";
+	case SWAP_NETWORK:
+		return "SWAP_NETWORK";
+	case APP_DATA_COALESCING:
+		return "APP_DATA_COALESCING";
+	case UPGRADE_FIRMWARE:
+		return "UPGRADE_FIRMWARE";
+	case HUB_BUS_CAPTURE_CMD_UNKNOWN:
+		return "-";
+	default:
+		if ((cmd_id >= APP_COMMAND_ID_FIRST) &&
+			(cmd_id <= APP_COMMAND_ID_LAST)) {
+			return "APP_COMMAND";
+		}
+		return "?";
+	}
+}
+
+/**
+ * Read a capture file and index its records.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int replay_load(const char *p_path, struct replay_capture *p_capture)
+{
+	FILE    *fp;
+	long     size;
+	size_t   offset, busses_size;
+	uint32_t capacity = 0;
+
+	memset(p_capture, 0, sizeof(*p_capture));
+
+	fp = fopen(p_path, "rb");
+	if (NULL == fp) {
+		printf("Failed to open %s: %s\n", p_path, strerror(errno));
+		goto err_replay_load_1;
+	}
+	if ((0 != fseek(fp, 0, SEEK_END)) || ((size = ftell(fp)) < 0) ||
+		(0 != fseek(fp, 0, SEEK_SET))) {
+		printf("Failed to size %s\n", p_path);
+		goto err_replay_load_2;
+	}
+	p_capture->p_file = malloc((size_t)size + 1);
+	if ((NULL == p_capture->p_file) ||
+		(fread(p_capture->p_file, 1, (size_t)size, fp) != (size_t)size)) {
+		printf("Failed to read %s\n", p_path);
+		goto err_replay_load_3;
+	}
+	fclose(fp);
+	fp = NULL;
+
+	if ((size_t)size < sizeof(p_capture->header)) {
+		printf("%s is not a bus capture\n", p_path);
+		goto err_replay_load_3;
+	}
+	memcpy(&p_capture->header, p_capture->p_file, sizeof(p_capture->header));
+	if ((HUB_BUS_CAPTURE_MAGIC != p_capture->header.magic) ||
+		(HUB_BUS_CAPTURE_VERSION != p_capture->header.version)) {
+		printf("%s is not a version %u bus capture\n", p_path,
+			   HUB_BUS_CAPTURE_VERSION);
+		goto err_replay_load_3;
+	}
+
+	offset      = sizeof(p_capture->header);
+	busses_size = p_capture->header.num_busses *
+				  sizeof(struct hub_bus_capture_bus);
+	if ((size_t)size - offset < busses_size) {
+		printf("%s is truncated\n", p_path);
+		goto err_replay_load_3;
+	}
+	p_capture->p_busses = malloc(busses_size + 1);
+	if (NULL == p_capture->p_busses) {
+		goto err_replay_load_3;
+	}
+	memcpy(p_capture->p_busses, &p_capture->p_file[offset], busses_size);
+	offset += busses_size;
+
+	/* A record cut by a crash of the captured app ends the capture */
+	while ((size_t)size - offset >= sizeof(struct hub_bus_capture_record)) {
+		struct replay_record *p_record;
+
+		if (p_capture->num_records == capacity) {
+			struct replay_record *p_records;
+
+			capacity  = capacity ? capacity * 2 : 4096;
+			p_records = realloc(p_capture->p_records,
+								capacity * sizeof(struct replay_record));
+			if (NULL == p_records) {
+				printf("Failed to allocate %u records\n", capacity);
+				goto err_replay_load_4;
+			}
+			p_capture->p_records = p_records;
+		}
+
+		p_record = &p_capture->p_records[p_capture->num_records];
+		memcpy(&p_record->rec, &p_capture->p_file[offset],
+			   sizeof(p_record->rec));
+		offset += sizeof(p_record->rec);
+		if (((size_t)size - offset < p_record->rec.data_len) ||
+			(p_record->rec.bus >= p_capture->header.num_busses)) {
+			break;
+		}
+		p_record->p_data = &p_capture->p_file[offset];
+		offset += p_record->rec.data_len;
+		p_capture->num_records++;
+	}
+
+	return 0;
+
+err_replay_load_4:
+	free(p_capture->p_records);
+	free(p_capture->p_busses);
+err_replay_load_3:
+	free(p_capture->p_file);
+err_replay_load_2:
+	if (NULL != fp) {
+		fclose(fp);
+	}
+err_replay_load_1:
+	return -1;
+}
+
+static void replay_free(struct replay_capture *p_capture)
+{
+	free(p_capture->p_records);
+	free(p_capture->p_busses);
+	free(p_capture->p_file);
+}
+
+/**
+ * Print the totals of each HUB command of each bus of a capture.
+ */
+static void replay_print_summary(const struct replay_capture *p_capture)
+{
+	struct replay_cmd_stats *p_stats;
+	uint64_t                 span_ns = 0;
+	uint32_t                 bus, i;
+
+	p_stats = calloc(256, sizeof(struct replay_cmd_stats));
+	if (NULL == p_stats) {
+		return;
+	}
+
+	if (p_capture->num_records) {
+		const struct hub_bus_capture_record *p_last =
+			&p_capture->p_records[p_capture->num_records - 1].rec;
+
+		span_ns = p_last->start_ns + p_last->duration_ns;
+	}
+	printf("%u transactions over %.3f s\n", p_capture->num_records,
+		   (double)span_ns / 1e9);
+
+	for (bus = 0; bus < p_capture->header.num_busses; bus++) {
+		const struct hub_bus_capture_bus *p_bus = &p_capture->p_busses[bus];
+		uint64_t                          busy_ns = 0;
+		bool                              in_write = false;
+
+		memset(p_stats, 0, 256 * sizeof(struct replay_cmd_stats));
+		for (i = 0; i < p_capture->num_records; i++) {
+			const struct hub_bus_capture_record *p_rec =
+				&p_capture->p_records[i].rec;
+			struct replay_cmd_stats *p_cmd = &p_stats[p_rec->cmd_id];
+
+			if (p_rec->bus != bus) {
+				continue;
+			}
+			if (HUB_BUS_CAPTURE_DIR_WRITE == p_rec->dir) {
+				p_cmd->exchanges += in_write ? 0 : 1;
+				p_cmd->writes++;
+				p_cmd->bytes_written += p_rec->len;
+			} else {
+				p_cmd->reads++;
+				p_cmd->bytes_read += p_rec->len;
+			}
+			in_write = (HUB_BUS_CAPTURE_DIR_WRITE == p_rec->dir);
+			p_cmd->failed += (p_rec->flags & HUB_BUS_CAPTURE_FLAG_FAILED) ? 1
+																		   : 0;
+			p_cmd->busy_ns += p_rec->duration_ns;
+			busy_ns += p_rec->duration_ns;
+		}
+
+		printf("\nBus %u: %s, GARD %u, speed %u, busy %.1f%%\n", bus,
+			   (p_bus->type < HUB_GARD_NR_BUSSES)
+				   ? replay_bus_names[p_bus->type]
+				   : "?",
+			   p_bus->gard_index, p_bus->speed,
+			   span_ns ? (100.0 * (double)busy_ns / (double)span_ns) : 0.0);
+		printf("%-24s %10s %8s %8s %6s %12s %12s %10s %10s\n", "command",
+			   "exchanges", "writes", "reads", "failed", "bytes out",
+			   "bytes in", "busy ms", "MB/s");
+		for (i = 0; i < 256; i++) {
+			const struct replay_cmd_stats *p_cmd = &p_stats[i];
+			uint64_t                       bytes;
+
+			if (!p_cmd->writes && !p_cmd->reads) {
+				continue;
+			}
+			bytes = p_cmd->bytes_written + p_cmd->bytes_read;
+			printf("0x%02x %-19s %10u %8u %8u %6u %12llu %12llu %10.3f "
+				   "%10.3f\n",
+				   i, replay_cmd_name((uint8_t)i), p_cmd->exchanges,
+				   p_cmd->writes, p_cmd->reads, p_cmd->failed,
+				   (unsigned long long)p_cmd->bytes_written,
+				   (unsigned long long)p_cmd->bytes_read,
+				   (double)p_cmd->busy_ns / 1e6,
+				   p_cmd->busy_ns
+					   ? ((double)bytes * 1e3 / (double)p_cmd->busy_ns)
+					   : 0.0);
+		}
+	}
+
+	free(p_stats);
+}
+
+/**
+ * Open a pty in raw mode, the mock GARD end. The HUB end is kept open too, so
+ * that the pty stays up while HUB opens and closes it.
+ *
+ * @return: the mock GARD end, -1 on failure
+ */
+static int replay_open_pty(int *p_hub_fd, char *p_name, size_t name_size)
+{
+	struct termios tio;
+	int            fd;
+
+	fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((fd < 0) || (0 != grantpt(fd)) || (0 != unlockpt(fd)) ||
+		(0 != ptsname_r(fd, p_name, name_size))) {
+		printf("Failed to open a pty: %s\n", strerror(errno));
+		goto err_replay_open_pty_1;
+	}
+
+	*p_hub_fd = open(p_name, O_RDWR | O_NOCTTY);
+	if ((*p_hub_fd < 0) || (0 != tcgetattr(*p_hub_fd, &tio))) {
+		printf("Failed to open %s: %s\n", p_name, strerror(errno));
+		goto err_replay_open_pty_1;
+	}
+	cfmakeraw(&tio);
+	if (0 != tcsetattr(*p_hub_fd, TCSANOW, &tio)) {
+		printf("Failed to set up %s: %s\n", p_name, strerror(errno));
+		goto err_replay_open_pty_2;
+	}
+
+	return fd;
+
+err_replay_open_pty_2:
+	close(*p_hub_fd);
+err_replay_open_pty_1:
+	if (fd >= 0) {
+		close(fd);
+	}
+	return -1;
+}
+
+/**
+ * Read count bytes HUB wrote.
+ *
+ * @return: 0 on success, -1 on a timeout or failure
+ */
+static int replay_read_exact(int fd, uint8_t *p_buffer, uint32_t count)
+{
+	struct pollfd pfd = {.fd = fd, .events = POLLIN};
+	uint32_t      done = 0;
+	ssize_t       nread;
+
+	while (done < count) {
+		if (poll(&pfd, 1, REPLAY_WRITE_TIMEOUT_MS) <= 0) {
+			return -1;
+		}
+		nread = read(fd, &p_buffer[done], count - done);
+		if ((nread < 0) && (EINTR != errno) && (EAGAIN != errno)) {
+			return -1;
+		}
+		done += (nread > 0) ? (uint32_t)nread : 0;
+	}
+
+	return 0;
+}
+
+static int replay_write_all(int fd, const uint8_t *p_buffer, uint32_t count)
+{
+	uint32_t done = 0;
+	ssize_t  nwrite;
+
+	while (done < count) {
+		nwrite = write(fd, &p_buffer[done], count - done);
+		if ((nwrite < 0) && (EINTR != errno) && (EAGAIN != errno)) {
+			return -1;
+		}
+		done += (nwrite > 0) ? (uint32_t)nwrite : 0;
+	}
+
+	return 0;
+}
+
+/**
+ * Play the GARD side of a bus of the capture on a pty.
+ *
+ * A response is sent at the same time after the last HUB write as in the
+ * capture, scaled by time_scale. Before the first HUB write, the reads are
+ * timed from the start of the replay, e.g. app data pushed by GARD.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int replay_mock_gard(const struct replay_capture *p_capture,
+							uint32_t                     bus,
+							double                       time_scale)
+{
+	char      pty_name[64];
+	uint8_t  *p_buffer = NULL;
+	uint32_t  max_len  = 0, replayed = 0, mismatches = 0, i;
+	uint64_t  anchor_ns, anchor_rec_ns, start_ns;
+	int       fd, hub_fd, ret = -1;
+
+	if ((bus >= p_capture->header.num_busses) ||
+		(HUB_GARD_BUS_UART != p_capture->p_busses[bus].type)) {
+		printf("Bus %u is not a UART bus of the capture\n", bus);
+		goto err_replay_mock_1;
+	}
+	for (i = 0; i < p_capture->num_records; i++) {
+		const struct hub_bus_capture_record *p_rec =
+			&p_capture->p_records[i].rec;
+
+		if (p_rec->bus != bus) {
+			continue;
+		}
+		if (p_rec->data_len != p_rec->len) {
+			printf("The capture was taken without all the data, it cannot "
+				   "be replayed\n");
+			goto err_replay_mock_1;
+		}
+		max_len = (p_rec->len > max_len) ? p_rec->len : max_len;
+	}
+
+	p_buffer = malloc(max_len + 1);
+	if (NULL == p_buffer) {
+		goto err_replay_mock_1;
+	}
+
+	fd = replay_open_pty(&hub_fd, pty_name, sizeof(pty_name));
+	if (fd < 0) {
+		goto err_replay_mock_2;
+	}
+	printf("Mock GARD of bus %u on %s, start the HUB workload\n", bus,
+		   pty_name);
+	fflush(stdout);
+
+	start_ns      = replay_now_ns();
+	anchor_ns     = start_ns;
+	anchor_rec_ns = 0;
+	for (i = 0; i < p_capture->num_records; i++) {
+		const struct replay_record          *p_record = &p_capture->p_records[i];
+		const struct hub_bus_capture_record *p_rec    = &p_record->rec;
+		uint64_t rec_end_ns = p_rec->start_ns + p_rec->duration_ns;
+
+		if ((p_rec->bus != bus) || !p_rec->len) {
+			continue;
+		}
+
+		if (HUB_BUS_CAPTURE_DIR_WRITE == p_rec->dir) {
+			if (0 != replay_read_exact(fd, p_buffer, p_rec->len)) {
+				printf("HUB did not write the %u bytes of %s after %u "
+					   "transactions\n",
+					   p_rec->len, replay_cmd_name(p_rec->cmd_id), replayed);
+				goto err_replay_mock_3;
+			}
+			if (0 != memcmp(p_buffer, p_record->p_data, p_rec->len)) {
+				mismatches++;
+			}
+			if (1 == ++replayed) {
+				/* The workload starts with its first write */
+				start_ns = replay_now_ns();
+			}
+			anchor_ns     = replay_now_ns();
+			anchor_rec_ns = rec_end_ns;
+		} else {
+			if (time_scale > 0.0) {
+				replay_sleep_until(
+					anchor_ns +
+					(uint64_t)((double)(rec_end_ns - anchor_rec_ns) *
+							   time_scale));
+			}
+			if (0 != replay_write_all(fd, p_record->p_data, p_rec->len)) {
+				printf("Failed to write to %s: %s\n", pty_name,
+					   strerror(errno));
+				goto err_replay_mock_3;
+			}
+			replayed++;
+		}
+	}
+
+	printf("Replayed %u transactions in %.3f s, %u HUB writes differed from "
+		   "the capture\n",
+		   replayed, (double)(replay_now_ns() - start_ns) / 1e9, mismatches);
+	ret = 0;
+
+err_replay_mock_3:
+	close(hub_fd);
+	close(fd);
+err_replay_mock_2:
+	free(p_buffer);
+err_replay_mock_1:
+	return ret;
+}
+
+static void print_usage(const char *p_name)
+{
+	printf("Usage: %s [options] <bus capture>\n", p_name);
+	printf("  Prints the traffic of each bus of the capture by HUB command\n");
+	printf("  -g <bus>    plays the GARD side of a UART bus on a pty\n");
+	printf("  -x <scale>  scales the GARD response times, 1 by default, 0 to "
+		   "respond at once\n");
+}
+
+int main(int argc, char *argv[])
+{
+	struct replay_capture capture;
+	double                time_scale = 1.0;
+	int                   mock_bus   = -1;
+	int                   opt, ret;
+
+	while ((opt = getopt(argc, argv, "g:x:h")) != -1) {
+		switch (opt) {
+		case 'g':
+			mock_bus = atoi(optarg);
+			break;
+		case 'x':
+			time_scale = atof(optarg);
+			break;
+		default:
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+	if (optind != argc - 1) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	if (0 != replay_load(argv[optind], &capture)) {
+		return -1;
+	}
+
+	if (mock_bus < 0) {
+		replay_print_summary(&capture);
+		ret = 0;
+	} else {
+		ret = replay_mock_gard(&capture, (uint32_t)mock_bus, time_scale);
+	}
+
+	replay_free(&capture);
+
+	return ret;
+}
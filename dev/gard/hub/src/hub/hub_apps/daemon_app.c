@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB daemon application
+ *
+ * This application does the following:
+ * 1. Pre-initializes HUB with host config JSON file and directory of GARD
+ *    JSON files.
+ * 2. Discovers GARDs in the system.
+ * 3. Initializes HUB.
+ * 4. Serves the register and data transfers of HUB client apps, see
+ *    hub_client_connect(), on a Unix socket, holding the bus sessions open.
+ *    If a capture file is given, the bus traffic of all the clients is
+ *    captured to it, see hub_bus_capture_start() and bus_replay_app.c.
+ * 5. Cleans up and exits on Ctrl+C or SIGTERM.
+ */
+
+/* For signal handler */
+#include <signal.h>
+
+#include "hub.h"
+
+/* Socket served when none is given on the command line */
+#define DAEMON_APP_DEFAULT_SOCKET "/tmp/hub.sock"
+
+/* Set by the signal handler to stop serving */
+static volatile int g_stop = 0;
+
+static void stop_handler(int sig)
+{
+	(void)sig;
+	g_stop = 1;
+}
+
+int main(int argc, char *argv[])
+{
+	enum hub_ret_code ret;
+	hub_handle_t      hub;
+	const char       *p_socket_path = DAEMON_APP_DEFAULT_SOCKET;
+	const char       *p_capture_path = NULL;
+
+	printf("Welcome to H.U.B. v%s\n", hub_get_version_string());
+	if (argc < 3) {
+		printf("Usage: %s <host_cfg_json_file> <directory of GARD jsons> "
+			   "[socket path] [bus capture file]\n",
+			   argv[0]);
+		return -1;
+	}
+	if (argc > 3) {
+		p_socket_path = argv[3];
+	}
+	if (argc > 4) {
+		p_capture_path = argv[4];
+	}
+
+	if ((signal(SIGINT, stop_handler) == SIG_ERR) ||
+		(signal(SIGTERM, stop_handler) == SIG_ERR)) {
+		printf("Failed to set up signal handler\n");
+		return -1;
+	}
+
+	ret = hub_preinit(argv[1], argv[2], &hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub preinit!\n");
+		return -1;
+	}
+
+	ret = hub_discover_gards(hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub_discover_gards!\n");
+		goto err_daemon_app_1;
+	}
+	printf("%d GARD(s) discovered\n", hub_get_num_gards(hub));
+
+	ret = hub_init(hub);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub_init!\n");
+		goto err_daemon_app_1;
+	}
+
+	/* All the data, so that the capture can be replayed */
+	if (NULL != p_capture_path) {
+		ret = hub_bus_capture_start(hub, p_capture_path, 0);
+		if (HUB_SUCCESS != ret) {
+			printf("Error in hub_bus_capture_start!\n");
+			goto err_daemon_app_1;
+		}
+	}
+
+	printf("Serving HUB clients on %s, Ctrl+C to stop\n", p_socket_path);
+	ret = hub_daemon_serve(hub, p_socket_path, &g_stop);
+	if (HUB_SUCCESS != ret) {
+		printf("Error in hub_daemon_serve!\n");
+	}
+
+	if (HUB_SUCCESS != hub_bus_capture_stop(hub)) {
+		printf("Error in hub_bus_capture_stop!\n");
+	}
+
+err_daemon_app_1:
+	if (HUB_SUCCESS != hub_fini(hub)) {
+		printf("Error in hub_fini!\n");
+		return -1;
+	}
+
+	return (HUB_SUCCESS == ret) ? 0 : -1;
+}
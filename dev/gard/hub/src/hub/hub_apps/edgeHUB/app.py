@@ -12,7 +12,7 @@ import time
 import signal
 import atexit
 import traceback
-import subprocess
+import threading
 import base64
 from datetime import datetime
 from flask import Flask, render_template, jsonify, Response, request, send_file
@@ -72,7 +72,8 @@ try:
             USB_CAMERA_ID, 
             width=usb_camera_config.get('width', 1920), 
             height=usb_camera_config.get('height', 1080), 
-            camera_type=usb_camera_config.get('type', 'usb')
+            camera_type=usb_camera_config.get('type', 'usb'),
+            max_fps=usb_camera_config.get('max_fps')
         )
     except Exception as e:
         error_msg = CONFIG.get('errors', {}).get('usb_camera_setup_failed', 'USB Camera setup failed: {error}').format(error=e)
@@ -85,7 +86,9 @@ try:
             PI_CAMERA_ID, 
             width=pi_camera_config.get('width', 3280), 
             height=pi_camera_config.get('height', 2464), 
-            camera_type=pi_camera_config.get('type', 'picamera2')
+            camera_type=pi_camera_config.get('type', 'picamera2'),
+            hw_encode=pi_camera_config.get('hw_encode', True),
+            max_fps=pi_camera_config.get('max_fps')
         )
     except Exception as e:
         error_msg = CONFIG.get('errors', {}).get('pi_camera_setup_failed', 'Pi Camera setup failed: {error}').format(error=e)
@@ -107,6 +110,7 @@ def cleanup_resources():
     global shutdown_in_progress
     
     shutdown_in_progress = True
+    telemetry_sampler.stop()
     cam_instance.cleanup_resources()
 
 
@@ -172,58 +176,190 @@ def get_config():
     return jsonify(frontend_config)
 
 
-@app.route("/get_live_data")
-def get_live_data():
+@app.route("/metrics")
+def metrics():
     """
-    API endpoint to fetch live sensor data (temperature, voltage, current, power).
-    Returns JSON with sensor readings and timestamp.
+    Expose the per-GARD HUB statistics in the Prometheus text format.
+
+    Counters are labelled by GARD, operation and bus. Latencies are exported
+    as a histogram whose bucket upper bounds are the floors of the next HUB
+    latency bucket, so that no HUB bucket is split across two le buckets.
     """
-    sensor_config = CONFIG.get('sensors', {})
-    temp_config = sensor_config.get('temperature', {})
-    energy_config = sensor_config.get('energy', {})
-    
-    TEMP_SENSOR_1_ID = temp_config.get('sensor_1_id', 1)
-    TEMP_SENSOR_2_ID = temp_config.get('sensor_2_id', 2)
-    ENERGY_SENSOR_1_ID = energy_config.get('sensor_1_id', 1)
-    ENERGY_SENSOR_2_ID = energy_config.get('sensor_2_id', 2)
+    lines = [
+        "# TYPE hub_transactions_total counter",
+        "# TYPE hub_errors_total counter",
+        "# TYPE hub_bytes_total counter",
+        "# TYPE hub_latency_max_seconds gauge",
+        "# TYPE hub_latency_seconds histogram",
+    ]
 
-    temp_data = hub_instance.get_temperature_data([TEMP_SENSOR_1_ID, TEMP_SENSOR_2_ID])
-    energy_data = hub_instance.get_energy_data([ENERGY_SENSOR_1_ID, ENERGY_SENSOR_2_ID])
+    try:
+        gards = list(hub_instance.gards.values())
+    except (NameError, AttributeError):
+        gards = []
+
+    for gard in gards:
+        ret, stats = gard.get_stats()
+        if ret != 0:
+            continue
+        floors = [
+            gard.hub_obj.hub_lib.hub_stats_bucket_floor_us(b)
+            for b in range(hub.hub.HUB_STATS_LATENCY_BUCKETS)
+        ]
+        for op_name, op in stats.items():
+            labels = 'gard="{}",op="{}",bus="{}"'.format(gard.gard_num, op_name, op["bus"])
+            lines.append("hub_transactions_total{{{}}} {}".format(labels, op["transactions"]))
+            lines.append("hub_errors_total{{{}}} {}".format(labels, op["errors"]))
+            lines.append("hub_bytes_total{{{}}} {}".format(labels, op["bytes"]))
+            lines.append("hub_latency_max_seconds{{{}}} {}".format(labels, op["latency_max_ns"] / 1e9))
+
+            counts = dict(op["latency_hist"])
+            cumulative = 0
+            for b in range(len(floors) - 1):
+                cumulative += counts.get(floors[b], 0)
+                lines.append('hub_latency_seconds_bucket{{{},le="{}"}} {}'.format(
+                    labels, floors[b + 1] / 1e6, cumulative))
+            lines.append('hub_latency_seconds_bucket{{{},le="+Inf"}} {}'.format(
+                labels, op["transactions"]))
+            lines.append("hub_latency_seconds_sum{{{}}} {}".format(labels, op["latency_total_ns"] / 1e9))
+            lines.append("hub_latency_seconds_count{{{}}} {}".format(labels, op["transactions"]))
+
+    return Response("\n".join(lines) + "\n", mimetype="text/plain; version=0.0.4")
+
+
+class TelemetrySampler:
+    """
+    Samples the sensors in one background thread and keeps the latest
+    snapshot, so that any number of dashboard clients cost one set of I2C
+    reads per interval. The system temperature is read from sysfs.
+    """
 
-    command_to_run = sensor_config.get('system_temp_command', ['vcgencmd', 'measure_temp'])
+    def __init__(self, interval):
+        self.interval = interval
+        self.cond = threading.Condition()
+        self.snapshot = None
+        self.seq = 0
+        self.thread = None
+        self.stop_event = threading.Event()
+
+        sensor_config = CONFIG.get('sensors', {})
+        temp_config = sensor_config.get('temperature', {})
+        energy_config = sensor_config.get('energy', {})
+        self.temp_sensor_ids = [temp_config.get('sensor_1_id', 1), temp_config.get('sensor_2_id', 2)]
+        self.energy_sensor_ids = [energy_config.get('sensor_1_id', 1), energy_config.get('sensor_2_id', 2)]
+        self.system_temp_path = sensor_config.get('system_temp_path', '/sys/class/thermal/thermal_zone0/temp')
+
+    def start(self):
+        """Start sampling, on the first client."""
+        with self.cond:
+            if self.thread is None:
+                self.thread = threading.Thread(target=self._run, name="Telemetry Sampler", daemon=True)
+                self.thread.start()
+
+    def stop(self):
+        """Stop sampling and wake the waiting clients."""
+        self.stop_event.set()
+        with self.cond:
+            self.cond.notify_all()
+
+    def _read_system_temp(self):
+        try:
+            with open(self.system_temp_path, 'r') as f:
+                return int(f.read().strip()) / 1000.0
+        except (OSError, ValueError):
+            return None
+
+    def _sample(self):
+        # All the SOM sensors in one libhub call, then picked by sensor ID
+        telemetry = hub_instance.get_som_telemetry() or {}
+        temperatures = telemetry.get("temperature", [])
+        energies = telemetry.get("energy", [])
+        temp_data = [
+            temperatures[i - 1] if 0 < i <= len(temperatures) else None
+            for i in self.temp_sensor_ids
+        ]
+        energy_data = [
+            energies[i - 1] if 0 < i <= len(energies) else {}
+            for i in self.energy_sensor_ids
+        ]
+
+        return {
+            "timestamp": time.time() * 1000,
+            "temp1": round(temp_data[0], 2) if temp_data[0] else temp_data[0],
+            "temp2": round(temp_data[1], 2) if temp_data[1] else temp_data[1],
+            "temp3": self._read_system_temp(),
+            "voltage1": energy_data[0].get("voltage"),
+            "current1": energy_data[0].get("current"),
+            "power1": energy_data[0].get("power"),
+            "voltage2": energy_data[1].get("voltage"),
+            "current2": energy_data[1].get("current"),
+            "power2": energy_data[1].get("power"),
+        }
 
-    result = subprocess.run(
-        command_to_run,
-        capture_output=True,
-        text=True,
-    )
+    def _run(self):
+        while not self.stop_event.is_set():
+            start = time.monotonic()
+            try:
+                snapshot = self._sample()
+                with self.cond:
+                    self.snapshot = snapshot
+                    self.seq += 1
+                    self.cond.notify_all()
+            except Exception as e:
+                hub_instance.logger.error(f"Sensor sampling failed: {e}")
+            self.stop_event.wait(max(0.0, self.interval - (time.monotonic() - start)))
 
-    res = result.stdout
+    def wait_newer(self, seq, timeout):
+        """
+        Wait for a snapshot newer than seq.
 
-    if temp_data[0]:
-        t1 = round(temp_data[0], 2)
-    else:
-        t1 = temp_data[0]
+        Returns:
+            tuple: (seq, snapshot) of the latest snapshot, None snapshot if none yet
+        """
+        self.start()
+        with self.cond:
+            self.cond.wait_for(lambda: self.seq != seq or self.stop_event.is_set(), timeout=timeout)
+            return self.seq, self.snapshot
 
-    if temp_data[1]:
-        t2 = round(temp_data[1], 2)
-    else:
-        t2 = temp_data[1]
-
-    live_data = {
-        "timestamp": time.time() * 1000,
-        "temp1": t1,
-        "temp2": t2,
-        "temp3": float(res[5:-3]),
-        "voltage1": energy_data[0]["voltage"],
-        "current1": energy_data[0]["current"],
-        "power1": energy_data[0]["power"],
-        "voltage2": energy_data[1]["voltage"],
-        "current2": energy_data[1]["current"],
-        "power2": energy_data[1]["power"],
-    }
 
-    return jsonify(live_data)
+telemetry_sampler = TelemetrySampler(
+    CONFIG.get('delays', {}).get('data_update_interval', 1000) / 1000.0
+)
+
+
+@app.route("/get_live_data")
+def get_live_data():
+    """
+    API endpoint to fetch live sensor data (temperature, voltage, current, power).
+    Returns JSON with the latest sensor readings and their timestamp, as
+    sampled by the telemetry sampler.
+    """
+    _, snapshot = telemetry_sampler.wait_newer(0, telemetry_sampler.interval * 2)
+    if snapshot is None:
+        return Response(status=CONFIG.get('http_status_codes', {}).get('no_content', 204))
+
+    return jsonify(snapshot)
+
+
+@app.route("/live_data/stream")
+def live_data_stream():
+    """
+    Server-Sent-Events stream of live sensor data: one event with the same
+    JSON as /get_live_data per sample. A comment line keeps idle connections
+    open.
+    """
+    def generate():
+        seq = 0
+        while not telemetry_sampler.stop_event.is_set():
+            new_seq, snapshot = telemetry_sampler.wait_newer(seq, 15.0)
+            if new_seq == seq or snapshot is None:
+                yield ": keepalive\n\n"
+                continue
+            seq = new_seq
+            yield f"data: {json.dumps(snapshot)}\n\n"
+
+    return Response(generate(), mimetype="text/event-stream",
+                    headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"})
 
 
 @app.route("/video_feed")
@@ -143,6 +143,7 @@ document.addEventListener('DOMContentLoaded', async () => {
     
     // Data update interval control
     let dataUpdateInterval = null;
+    let liveDataSource = null;
     
     // Image operations state
     let currentImageData = null;
@@ -310,13 +311,18 @@ document.addEventListener('DOMContentLoaded', async () => {
      * and refreshes the Plotly graphs if the sensor dashboard is currently visible. The function
      * also manages threshold comparisons for visual feedback (color changes) and maintains
      * sliding windows of data points for each sensor metric.
+     * 
+     * @param {Object} [liveData] - Sensor data pushed by the server; fetched when omitted
      */
-    const updateDashboard = async () => {
+    const updateDashboard = async (liveData) => {
         try {
-            const response = await fetch(CONFIG.api_endpoints.get_live_data || '/get_live_data');
-            if (!response.ok) return;
-            
-            const data = await response.json();
+            let data = liveData;
+            if (data === undefined) {
+                const response = await fetch(CONFIG.api_endpoints.get_live_data || '/get_live_data');
+                if (!response.ok || response.status === 204) return;
+                
+                data = await response.json();
+            }
             const timestamp = new Date();
             
             document.querySelectorAll('.metric-card[data-metric]').forEach(card => {
@@ -447,11 +453,24 @@ document.addEventListener('DOMContentLoaded', async () => {
     };
     
     /**
-     * Starts the periodic data update interval.
+     * Starts the data updates: the server pushes each sensor sample over a
+     * Server-Sent-Events stream, or, without EventSource, the data is polled
+     * at a fixed interval.
      * Only updates when sensor dashboard or live streaming is active.
      */
     function startDataUpdates() {
-        if (dataUpdateInterval) return; // Already running
+        if (dataUpdateInterval || liveDataSource) return; // Already running
+        
+        if (window.EventSource) {
+            liveDataSource = new EventSource(CONFIG.api_endpoints.live_data_stream || '/live_data/stream');
+            liveDataSource.onmessage = (event) => {
+                if (dashboardContainer.classList.contains('sensor-view-active') || 
+                    dashboardContainer.classList.contains('live-streaming-active')) {
+                    updateDashboard(JSON.parse(event.data));
+                }
+            };
+            return;
+        }
         
         updateDashboard().then(() => {
             const updateInterval = CONFIG.delays?.data_update_interval || 1000;
@@ -465,14 +484,18 @@ document.addEventListener('DOMContentLoaded', async () => {
     }
     
     /**
-     * Stops the periodic data update interval.
+     * Stops the data updates.
      * 
-     * This function clears the interval timer that was started by startDataUpdates(),
-     * effectively stopping automatic sensor data updates. It checks if an interval
-     * is active before attempting to clear it, and resets the dataUpdateInterval
-     * variable to null after clearing.
+     * This function closes the event stream or clears the interval timer that was
+     * started by startDataUpdates(), effectively stopping automatic sensor data
+     * updates. It checks if either is active before attempting to stop it, and
+     * resets the liveDataSource and dataUpdateInterval variables to null after.
      */
     function stopDataUpdates() {
+        if (liveDataSource) {
+            liveDataSource.close();
+            liveDataSource = null;
+        }
         if (dataUpdateInterval) {
             clearInterval(dataUpdateInterval);
             dataUpdateInterval = null;
@@ -237,6 +237,7 @@ int main(int argc, char *argv[])
 	printf("Performing operations on GARD %d...\n\n", gard_num);
 
 	img_ops_ctx.camera_id = GARD_CAMERA_ID;
+	img_ops_ctx.no_pause  = 1;
 
 	/**
 	 * Initiate a rescaled image capture and get the properties of the rescaled
@@ -272,11 +273,13 @@ int main(int argc, char *argv[])
 		goto err_app_2;
 	}
 
-	/* Resume the pipelines in GARD */
-	ret = hub_send_resume_pipeline(grd, img_ops_ctx.camera_id);
-	if (HUB_SUCCESS != ret) {
-		printf("Error in hub_send_resume_pipeline!\n");
-		goto err_app_2;
+	/* Resume the pipelines in GARD, if they were paused for the image */
+	if (img_ops_ctx.pipeline_paused) {
+		ret = hub_send_resume_pipeline(grd, img_ops_ctx.camera_id);
+		if (HUB_SUCCESS != ret) {
+			printf("Error in hub_send_resume_pipeline!\n");
+			goto err_app_2;
+		}
 	}
 
 	/* Construct the BMP file name */
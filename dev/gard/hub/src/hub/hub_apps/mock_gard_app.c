@@ -0,0 +1,1856 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Mock GARD application
+ *
+ * Emulates GARD boards in user space, for load testing HUB without them:
+ * 1. Serves, for each virtual GARD, the host commands of GARD FW host_cmds.c -
+ *    discovery, data and register transfers, capture rescaled image, resume
+ *    pipeline, app data subscription, tagged commands - on a pty, or on a TCP
+ *    port. HUB, with its host_config.json UART "bus_dev" set to the pty (or to
+ *    the link given with -l), discovers and drives it as a GARD on UART.
+ * 2. Produces App Module results at a given rate, raising the app data GPIO
+ *    line of the GARD through gpio-sim, or pushing them to a subscribed HUB.
+ * 3. Delays every response by a given latency, and sends at the pace of the
+ *    UART baud rate if asked to, so that HUB sees the timing of a real bus.
+ * 4. Prints the traffic of each virtual GARD on Ctrl+C or SIGTERM.
+ * 5. With -R, produces the results of a recording, see hub_record_appdata(),
+ *    instead: each one with its recorded data, at its recorded time scaled
+ *    by -x, so that edgeHUB or any HUB app runs on real results without a
+ *    GARD.
+ *
+ * Note:
+ * * 1. GARD memory is emulated sparsely, up to -m MB per GARD: data sent to
+ *      GARD reads back, memory never written reads as 0. The registers are
+ *      plain memory too.
+ * * 2. App Module commands, camera control and the pipeline statistics are
+ *      not emulated: the App Module commands are dropped as GARD FW drops
+ *      unregistered ones, the statistics are answered empty.
+ * * 3. For gpio-sim, -e takes the path of the "pull" attribute of the line of
+ *      each GARD, %u standing for the GARD index, e.g.
+ *      /sys/devices/platform/gpio-sim.0/gpiochip1/sim_gpio%u/pull
+ * * 4. -R takes the path of a recording the same way, one per GARD, or the
+ *      same for all of them without %u. A GARD produces no more results once
+ *      its recording is over.
+ */
+
+/* For posix_openpt() and ptsname_r() */
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gard_hub_iface.h"
+#include "hub.h"
+
+/* Most virtual GARDs served by one mock */
+#define MOCK_GARD_MAX_GARDS (64)
+
+/* How often the blocked reads look at the stop flag */
+#define MOCK_GARD_POLL_MS (100)
+
+/* Bytes sent at once when the baud rate is paced */
+#define MOCK_GARD_TX_CHUNK (1024)
+
+/* Emulated GARD memory comes in pages of this size */
+#define MOCK_GARD_PAGE_SHIFT (16)
+#define MOCK_GARD_PAGE_SIZE  (1U << MOCK_GARD_PAGE_SHIFT)
+
+/* App Module results queued while HUB does not read them, as GARD FW */
+#define MOCK_GARD_MAX_RESULTS (16)
+
+/* GARD memory the captured image is written to */
+#define MOCK_GARD_IMAGE_ADDR (0x30000000U)
+
+/* GARD memory the images of RUN_INFERENCE_ON_BUFFER are written to */
+#define MOCK_GARD_HOST_INPUT_ADDR (0x30100000U)
+#define MOCK_GARD_HOST_INPUT_SIZE (3U * 384U * 288U)
+
+/* GARD memory the networks of SWAP_NETWORK are staged in */
+#define MOCK_GARD_NETWORK_STAGING_ADDR (0x30200000U)
+#define MOCK_GARD_NETWORK_STAGING_SIZE (6U * 1024U * 1024U)
+
+/* As the profile of GARD FW built without GARD_PROFILE_ID */
+#define MOCK_GARD_PROFILE_ID (12345U)
+
+/* Ticks per second of the GARD CPU timer, as on GARD */
+#define MOCK_GARD_TIMER_FREQ (32000U)
+
+/* Set by the signal handler to stop serving */
+static volatile int g_stop = 0;
+
+struct mock_gard_cfg {
+	uint32_t    num_gards;
+	const char *p_link_prefix;  /* Links <prefix><index> to each pty */
+	uint16_t    tcp_port;       /* First TCP port, 0 for ptys */
+	uint32_t    latency_us;     /* Delay of every response */
+	uint32_t    baud_rate;      /* Pace of the responses, 0 for none */
+	double      results_per_s;  /* App Module results, 0 for none */
+	uint32_t    result_size;    /* Bytes of each result */
+	const char *p_gpio_fmt;     /* gpio-sim pull attribute of each line */
+	uint16_t    image_width;
+	uint16_t    image_height;
+	uint32_t    mem_pages;      /* Most memory pages of each GARD */
+	const char *p_recording_fmt; /* Recording of each GARD, NULL for none */
+	double      time_scale;      /* Of the recorded result times */
+};
+
+struct mock_gard_page {
+	uint32_t base;  /* Address of the page, valid with p_data */
+	uint8_t *p_data;
+};
+
+struct mock_gard_stats {
+	uint64_t cmds;
+	uint64_t tagged_cmds;
+	uint64_t bytes_rx;
+	uint64_t bytes_tx;
+	uint64_t results;
+	uint64_t results_dropped;
+	uint64_t results_read;
+	uint64_t results_pushed;
+	uint64_t gpio_events;
+	uint64_t protocol_errors;
+	uint64_t mem_exhausted;
+};
+
+struct mock_gard {
+	const struct mock_gard_cfg *p_cfg;
+	uint32_t                    index;
+	pthread_t                   thread;
+	int                         fd;         /* GARD end of the bus */
+	int                         hub_fd;     /* HUB end of the pty, kept open */
+	int                         listen_fd;  /* TCP mode */
+	char                        name[256];
+	uint32_t                    baud_rate;
+	uint64_t                    tx_free_ns;  /* When the paced TX is idle */
+
+	struct mock_gard_page *p_pages;  /* Open addressing, by page base */
+	uint32_t               num_slots;
+	uint32_t               num_pages;
+
+	/* App Module results: seq numbers, data and sizes of the queued ones */
+	uint32_t    result_seq[MOCK_GARD_MAX_RESULTS];
+	const void *result_data[MOCK_GARD_MAX_RESULTS]; /* NULL for the ramp */
+	uint32_t    result_len[MOCK_GARD_MAX_RESULTS];
+	uint32_t result_head;
+	uint32_t result_count;
+	uint32_t next_seq;
+	uint32_t push_seq;
+	uint64_t next_result_ns;
+	uint64_t result_period_ns;
+	bool     subscribed;
+
+	/* Replayed results, see -R */
+	hub_recording_t            recording;
+	struct hub_recording_entry next_entry;
+	bool                       replaying;  /* next_entry is to be produced */
+	uint64_t                   replay_start_ns;
+	uint64_t                   first_entry_ns;
+
+	uint32_t frame_seq;
+	bool     pipeline_paused;
+	uint8_t  inference_mode;
+	uint32_t inference_param;
+	uint32_t device_id[2];
+	bool     host_inference;  /* Runs on the images of RUN_INFERENCE_ON_BUFFER */
+	struct _swap_network_response swap; /* Last swap of SWAP_NETWORK */
+	struct _app_data_coalescing_response coalescing; /* APP_DATA_COALESCING */
+
+	struct _scaler_config_response scaler;
+	struct mock_gard_stats         stats;
+};
+
+static uint32_t mock_gard_crc32_table[256];
+
+static void stop_handler(int sig)
+{
+	(void)sig;
+	g_stop = 1;
+}
+
+static uint64_t mock_gard_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* The GARD CPU timer, from the host clock */
+static uint64_t mock_gard_now_ticks(void)
+{
+	uint64_t now_ns = mock_gard_now_ns();
+
+	return ((now_ns / 1000000000ULL) * MOCK_GARD_TIMER_FREQ) +
+		   (((now_ns % 1000000000ULL) * MOCK_GARD_TIMER_FREQ) / 1000000000ULL);
+}
+
+static void mock_gard_sleep_until(uint64_t deadline_ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec  = (time_t)(deadline_ns / 1000000000ULL);
+	ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+	while (EINTR ==
+		   clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+	}
+}
+
+static void mock_gard_crc32_init(void)
+{
+	uint32_t crc, i, j;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+		}
+		mock_gard_crc32_table[i] = crc;
+	}
+}
+
+/**
+ * Extend a CRC-32, as zlib's crc32(), over a buffer.
+ */
+static uint32_t mock_gard_crc32(uint32_t crc, const uint8_t *p_data,
+								uint32_t len)
+{
+	crc = ~crc;
+	while (len--) {
+		crc = (crc >> 8) ^ mock_gard_crc32_table[(crc ^ *p_data++) & 0xFF];
+	}
+	return ~crc;
+}
+
+/**
+ * Find the page of GARD memory holding addr.
+ *
+ * @return: the page, NULL if it was never written and create is false, or if
+ *          the memory of the GARD is used up
+ */
+static uint8_t *mock_gard_page(struct mock_gard *p_gard, uint32_t addr,
+							   bool create)
+{
+	uint32_t base = addr & ~(MOCK_GARD_PAGE_SIZE - 1);
+	uint32_t slot = (base >> MOCK_GARD_PAGE_SHIFT) * 2654435761U;
+	struct mock_gard_page *p_page;
+
+	for (slot &= p_gard->num_slots - 1;; slot = (slot + 1) &
+										 (p_gard->num_slots - 1)) {
+		p_page = &p_gard->p_pages[slot];
+		if (NULL == p_page->p_data) {
+			break;
+		}
+		if (p_page->base == base) {
+			return p_page->p_data;
+		}
+	}
+
+	if (!create) {
+		return NULL;
+	}
+	if (p_gard->num_pages >= p_gard->p_cfg->mem_pages) {
+		p_gard->stats.mem_exhausted++;
+		return NULL;
+	}
+	p_page->p_data = calloc(1, MOCK_GARD_PAGE_SIZE);
+	if (NULL == p_page->p_data) {
+		p_gard->stats.mem_exhausted++;
+		return NULL;
+	}
+	p_page->base = base;
+	p_gard->num_pages++;
+
+	return p_page->p_data;
+}
+
+static void mock_gard_mem_write(struct mock_gard *p_gard, uint32_t addr,
+								const uint8_t *p_data, uint32_t len)
+{
+	uint32_t offset, chunk;
+	uint8_t *p_page;
+
+	while (len > 0) {
+		offset = addr & (MOCK_GARD_PAGE_SIZE - 1);
+		chunk  = MOCK_GARD_PAGE_SIZE - offset;
+		chunk  = (chunk < len) ? chunk : len;
+		p_page = mock_gard_page(p_gard, addr, true);
+		if (NULL != p_page) {
+			memcpy(&p_page[offset], p_data, chunk);
+		}
+		addr   += chunk;
+		p_data += chunk;
+		len    -= chunk;
+	}
+}
+
+static void mock_gard_mem_read(struct mock_gard *p_gard, uint32_t addr,
+							   uint8_t *p_data, uint32_t len)
+{
+	uint32_t offset, chunk;
+	uint8_t *p_page;
+
+	while (len > 0) {
+		offset = addr & (MOCK_GARD_PAGE_SIZE - 1);
+		chunk  = MOCK_GARD_PAGE_SIZE - offset;
+		chunk  = (chunk < len) ? chunk : len;
+		p_page = mock_gard_page(p_gard, addr, false);
+		if (NULL != p_page) {
+			memcpy(p_data, &p_page[offset], chunk);
+		} else {
+			memset(p_data, 0, chunk);
+		}
+		addr   += chunk;
+		p_data += chunk;
+		len    -= chunk;
+	}
+}
+
+static uint32_t mock_gard_mem_read32(struct mock_gard *p_gard, uint32_t addr)
+{
+	uint32_t value;
+
+	mock_gard_mem_read(p_gard, addr, (uint8_t *)&value, sizeof(value));
+	return value;
+}
+
+/**
+ * Read count bytes HUB sent, waiting for them as long as the mock runs.
+ *
+ * @return: 0 on success, -1 if stopped, on EOF or on failure
+ */
+static int mock_gard_read_exact(struct mock_gard *p_gard, void *p_buffer,
+								uint32_t count)
+{
+	struct pollfd pfd    = {.fd = p_gard->fd, .events = POLLIN};
+	uint8_t      *p_byte = (uint8_t *)p_buffer;
+	uint32_t      done   = 0;
+	ssize_t       nread;
+	int           ready;
+
+	while (done < count) {
+		if (g_stop) {
+			return -1;
+		}
+		ready = poll(&pfd, 1, MOCK_GARD_POLL_MS);
+		if ((ready < 0) && (EINTR != errno)) {
+			return -1;
+		}
+		if (ready <= 0) {
+			continue;
+		}
+		nread = read(p_gard->fd, &p_byte[done], count - done);
+		if (0 == nread) {
+			return -1;
+		}
+		if (nread < 0) {
+			if ((EINTR == errno) || (EAGAIN == errno)) {
+				continue;
+			}
+			return -1;
+		}
+		done += (uint32_t)nread;
+	}
+
+	p_gard->stats.bytes_rx += count;
+	return 0;
+}
+
+/**
+ * Send count bytes to HUB, at the pace of the baud rate if there is one: each
+ * chunk goes out once the time to send it on the wire has passed.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_write_all(struct mock_gard *p_gard, const void *p_buffer,
+							   uint32_t count)
+{
+	const uint8_t *p_byte = (const uint8_t *)p_buffer;
+	uint32_t       done   = 0, chunk;
+	uint64_t       now_ns;
+	ssize_t        nwrite;
+
+	while (done < count) {
+		chunk = count - done;
+		if (0 != p_gard->baud_rate) {
+			chunk  = (chunk < MOCK_GARD_TX_CHUNK) ? chunk : MOCK_GARD_TX_CHUNK;
+			/* 10 bits a byte, 8N1 */
+			now_ns = mock_gard_now_ns();
+			p_gard->tx_free_ns =
+				((p_gard->tx_free_ns > now_ns) ? p_gard->tx_free_ns : now_ns) +
+				(((uint64_t)chunk * 10U * 1000000000ULL) / p_gard->baud_rate);
+			mock_gard_sleep_until(p_gard->tx_free_ns);
+		}
+
+		nwrite = write(p_gard->fd, &p_byte[done], chunk);
+		if (nwrite < 0) {
+			if ((EINTR == errno) || (EAGAIN == errno)) {
+				continue;
+			}
+			return -1;
+		}
+		done += (uint32_t)nwrite;
+	}
+
+	p_gard->stats.bytes_tx += count;
+	return 0;
+}
+
+/**
+ * Send the App Module data of result seq, cut to len bytes: its recorded
+ * data if it has some, else the seq number and then a ramp from it, so that
+ * HUB can tell results apart.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_write_result(struct mock_gard *p_gard, uint32_t seq,
+								  const void *p_data, uint32_t len,
+								  uint32_t *p_crc)
+{
+	uint8_t  buffer[MOCK_GARD_TX_CHUNK];
+	uint32_t done = 0, chunk, i;
+
+	if (NULL != p_data) {
+		if (NULL != p_crc) {
+			*p_crc = mock_gard_crc32(*p_crc, (const uint8_t *)p_data, len);
+		}
+		return mock_gard_write_all(p_gard, p_data, len);
+	}
+
+	while (done < len) {
+		chunk = len - done;
+		chunk = (chunk < sizeof(buffer)) ? chunk : sizeof(buffer);
+		for (i = 0; i < chunk; i++) {
+			buffer[i] = (uint8_t)(seq + done + i);
+		}
+		if (0 == done) {
+			memcpy(buffer, &seq, (chunk < sizeof(seq)) ? chunk : sizeof(seq));
+		}
+		if (NULL != p_crc) {
+			*p_crc = mock_gard_crc32(*p_crc, buffer, chunk);
+		}
+		if (0 != mock_gard_write_all(p_gard, buffer, chunk)) {
+			return -1;
+		}
+		done += chunk;
+	}
+
+	return 0;
+}
+
+/**
+ * Raise the app data GPIO line of the GARD, a rising edge on gpio-sim.
+ */
+static void mock_gard_raise_gpio(struct mock_gard *p_gard)
+{
+	char path[256];
+	int  fd;
+
+	if (NULL == p_gard->p_cfg->p_gpio_fmt) {
+		return;
+	}
+
+	snprintf(path, sizeof(path), p_gard->p_cfg->p_gpio_fmt, p_gard->index);
+	fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		return;
+	}
+	if ((write(fd, "pull-up", strlen("pull-up")) > 0) &&
+		(lseek(fd, 0, SEEK_SET) == 0) &&
+		(write(fd, "pull-down", strlen("pull-down")) > 0)) {
+		p_gard->stats.gpio_events++;
+	}
+	close(fd);
+}
+
+/**
+ * Tell HUB of results by the GPIO line, as counted by APP_DATA_COALESCING.
+ */
+static void mock_gard_notify_results(struct mock_gard *p_gard)
+{
+	mock_gard_raise_gpio(p_gard);
+	p_gard->coalescing.irqs_raised++;
+}
+
+/**
+ * Tell if the GARD has results to produce, at next_result_ns.
+ */
+static bool mock_gard_producing(const struct mock_gard *p_gard)
+{
+	return (NULL != p_gard->recording) ? p_gard->replaying
+									   : (0 != p_gard->result_period_ns);
+}
+
+/**
+ * Move a replaying GARD to its next recorded result, due at its time since
+ * the first result, scaled.
+ */
+static void mock_gard_next_replayed(struct mock_gard *p_gard)
+{
+	p_gard->replaying = (HUB_SUCCESS == hub_recording_next(p_gard->recording,
+														   &p_gard->next_entry));
+	if (p_gard->replaying) {
+		p_gard->next_result_ns =
+			p_gard->replay_start_ns +
+			(uint64_t)((double)(p_gard->next_entry.timestamp_ns -
+								p_gard->first_entry_ns) *
+					   p_gard->p_cfg->time_scale);
+	}
+}
+
+/**
+ * Queue the App Module results that are due, dropping the oldest ones as GARD
+ * FW does once its queue is full. HUB is told of a result by the GPIO line
+ * unless it is subscribed, or unless it is coalescing and results are left
+ * unread.
+ */
+static void mock_gard_produce_results(struct mock_gard *p_gard)
+{
+	uint64_t now_ns = mock_gard_now_ns();
+	uint32_t tail;
+	bool     unread_before;
+
+	while (mock_gard_producing(p_gard) && (now_ns >= p_gard->next_result_ns)) {
+		unread_before = (0 != p_gard->result_count);
+		if (MOCK_GARD_MAX_RESULTS == p_gard->result_count) {
+			p_gard->result_head = (p_gard->result_head + 1) %
+								  MOCK_GARD_MAX_RESULTS;
+			p_gard->result_count--;
+			p_gard->stats.results_dropped++;
+			p_gard->coalescing.results_dropped++;
+		}
+		tail = (p_gard->result_head + p_gard->result_count) %
+			   MOCK_GARD_MAX_RESULTS;
+		p_gard->result_seq[tail] = p_gard->next_seq++;
+		p_gard->result_count++;
+		p_gard->stats.results++;
+		if (NULL != p_gard->recording) {
+			/* The data stays mapped until the recording is closed */
+			p_gard->result_data[tail] = p_gard->next_entry.p_data;
+			p_gard->result_len[tail]  = p_gard->next_entry.size;
+			mock_gard_next_replayed(p_gard);
+		} else {
+			p_gard->result_data[tail] = NULL;
+			p_gard->result_len[tail]  = p_gard->p_cfg->result_size;
+			p_gard->next_result_ns   += p_gard->result_period_ns;
+		}
+
+		if (p_gard->subscribed) {
+			continue;
+		}
+		if (p_gard->coalescing.enabled && unread_before) {
+			p_gard->coalescing.results_coalesced++;
+		} else {
+			mock_gard_notify_results(p_gard);
+		}
+	}
+}
+
+static void mock_gard_complete_results(struct mock_gard *p_gard,
+									   uint32_t          count)
+{
+	p_gard->result_head  = (p_gard->result_head + count) %
+						   MOCK_GARD_MAX_RESULTS;
+	p_gard->result_count -= count;
+
+	/* Results that came during the fetch make the next batch */
+	if (p_gard->coalescing.enabled && !p_gard->subscribed &&
+		(0 != p_gard->result_count)) {
+		mock_gard_notify_results(p_gard);
+	}
+}
+
+/**
+ * Push the queued results to a subscribed HUB, between two commands.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_push_results(struct mock_gard *p_gard)
+{
+	struct _app_data_push_header hdr;
+	uint32_t                     eod = END_OF_DATA_MARKER;
+
+	while (p_gard->subscribed && (p_gard->result_count > 0)) {
+		hdr.push_marker = APP_DATA_PUSH_MARKER;
+		hdr.seq_num     = p_gard->push_seq++;
+		hdr.data_size   = p_gard->result_len[p_gard->result_head];
+		if ((0 != mock_gard_write_all(p_gard, &hdr, sizeof(hdr))) ||
+			(0 != mock_gard_write_result(
+					  p_gard, p_gard->result_seq[p_gard->result_head],
+					  p_gard->result_data[p_gard->result_head], hdr.data_size,
+					  NULL)) ||
+			(0 != mock_gard_write_all(p_gard, &eod, sizeof(eod)))) {
+			return -1;
+		}
+		mock_gard_complete_results(p_gard, 1);
+		p_gard->stats.results_pushed++;
+	}
+
+	return 0;
+}
+
+/**
+ * Send RECV_DATA_FROM_GARD_AT_OFFSET payload of App Module results, one
+ * result or, with CC_APP_DATA_BATCH, as many as fit, as GARD FW.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_send_app_data(
+	struct mock_gard                                  *p_gard,
+	const struct _recv_data_from_gard_at_offset_request *p_req)
+{
+	struct {
+		uint32_t end_of_data_marker;
+		uint32_t opt_crc;
+	} eod = {END_OF_DATA_MARKER, 0};
+	uint32_t  hdr[2]      = {START_OF_DATA_MARKER, 0};
+	uint32_t  num_results = 0, record_size, slot, i;
+	uint32_t *p_crc       = NULL;
+	bool      batch       = (0 != (p_req->control_code & CC_APP_DATA_BATCH));
+
+	if (p_req->control_code & CC_CHECKSUM_PRESENT) {
+		p_crc = &eod.opt_crc;
+	}
+
+	/* Skipped while subscribed, the results are pushed */
+	if (!p_gard->subscribed && (p_gard->result_count > 0)) {
+		if (!batch) {
+			record_size = p_gard->result_len[p_gard->result_head];
+			hdr[1] = (p_req->data_size < record_size) ? p_req->data_size
+													  : record_size;
+			num_results = (hdr[1] > 0) ? 1 : 0;
+		} else {
+			while (num_results < p_gard->result_count) {
+				slot = (p_gard->result_head + num_results) %
+					   MOCK_GARD_MAX_RESULTS;
+				if (hdr[1] + sizeof(uint32_t) + p_gard->result_len[slot] >
+					p_req->data_size) {
+					break;
+				}
+				hdr[1] += sizeof(uint32_t) + p_gard->result_len[slot];
+				num_results++;
+			}
+			if ((0 == num_results) && (p_req->data_size > sizeof(uint32_t))) {
+				hdr[1]      = p_req->data_size;
+				num_results = 1;
+			}
+		}
+	}
+
+	if (0 != mock_gard_write_all(p_gard, hdr, sizeof(hdr))) {
+		return -1;
+	}
+	for (i = 0; i < num_results; i++) {
+		slot        = (p_gard->result_head + i) % MOCK_GARD_MAX_RESULTS;
+		record_size = p_gard->result_len[slot];
+		if (batch) {
+			if (hdr[1] < sizeof(uint32_t) + record_size) {
+				/* The oldest result, cut down to fit */
+				record_size = hdr[1] - sizeof(uint32_t);
+			}
+			if (NULL != p_crc) {
+				*p_crc = mock_gard_crc32(*p_crc, (uint8_t *)&record_size,
+										 sizeof(record_size));
+			}
+			if (0 != mock_gard_write_all(p_gard, &record_size,
+										 sizeof(record_size))) {
+				return -1;
+			}
+		} else {
+			record_size = hdr[1];
+		}
+		if (0 != mock_gard_write_result(p_gard, p_gard->result_seq[slot],
+										p_gard->result_data[slot], record_size,
+										p_crc)) {
+			return -1;
+		}
+	}
+	if (0 != mock_gard_write_all(p_gard, &eod,
+								 (NULL != p_crc) ? sizeof(eod)
+												 : sizeof(eod.end_of_data_marker))) {
+		return -1;
+	}
+
+	mock_gard_complete_results(p_gard, num_results);
+	p_gard->stats.results_read += num_results;
+
+	return 0;
+}
+
+/**
+ * Send the RECV_DATA_FROM_GARD_AT_OFFSET response of GARD memory.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_send_mem_data(
+	struct mock_gard                                  *p_gard,
+	const struct _recv_data_from_gard_at_offset_request *p_req)
+{
+	struct {
+		uint32_t end_of_data_marker;
+		uint32_t opt_crc;
+	} eod = {END_OF_DATA_MARKER, 0};
+	uint8_t  buffer[MOCK_GARD_TX_CHUNK];
+	uint32_t hdr[2] = {START_OF_DATA_MARKER, p_req->data_size};
+	uint32_t done = 0, chunk;
+
+	if (0 != mock_gard_write_all(p_gard, hdr, sizeof(hdr))) {
+		return -1;
+	}
+	while (done < p_req->data_size) {
+		chunk = p_req->data_size - done;
+		chunk = (chunk < sizeof(buffer)) ? chunk : sizeof(buffer);
+		mock_gard_mem_read(p_gard, p_req->offset_address + done, buffer,
+						   chunk);
+		if (p_req->control_code & CC_CHECKSUM_PRESENT) {
+			eod.opt_crc = mock_gard_crc32(eod.opt_crc, buffer, chunk);
+		}
+		if (0 != mock_gard_write_all(p_gard, buffer, chunk)) {
+			return -1;
+		}
+		done += chunk;
+	}
+
+	return mock_gard_write_all(p_gard, &eod,
+							   (p_req->control_code & CC_CHECKSUM_PRESENT)
+								   ? sizeof(eod)
+								   : sizeof(eod.end_of_data_marker));
+}
+
+/**
+ * Take a SEND_DATA_TO_GARD_FOR_OFFSET payload sent in packets, see
+ * CC_USE_MTU_SIZE, answering each one as GARD FW.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_recv_frames(
+	struct mock_gard                                           *p_gard,
+	const struct _send_data_to_gard_for_offset_request *p_req)
+{
+	struct _data_frame_header   frame_hdr;
+	struct _data_frame_trailer  frame_trl;
+	struct _data_frame_response frame_resp = {0};
+	uint8_t                    *p_frame;
+	uint32_t mtu_size = p_req->cmd.mtu_size, data_size = p_req->cmd.data_size;
+	uint32_t num_frames, frame_offset;
+	int      ret = -1;
+
+	if ((0 == mtu_size) || (0 == data_size)) {
+		p_gard->stats.protocol_errors++;
+		return 0;
+	}
+	num_frames = ((data_size - 1) / mtu_size) + 1;
+	if (num_frames >= GARD_HUB_FRAME_NUM_ABORT) {
+		p_gard->stats.protocol_errors++;
+		return 0;
+	}
+
+	p_frame = malloc(mtu_size);
+	if (NULL == p_frame) {
+		return -1;
+	}
+
+	while ((frame_resp.next_frame_num != num_frames) &&
+		   (frame_resp.next_frame_num != GARD_HUB_FRAME_NUM_ABORT)) {
+		if (0 != mock_gard_read_exact(p_gard, &frame_hdr, sizeof(frame_hdr))) {
+			goto err_mock_gard_recv_frames_1;
+		}
+
+		frame_offset = (uint32_t)frame_hdr.frame_num * mtu_size;
+		if ((frame_hdr.frame_num < frame_resp.next_frame_num) ||
+			(0 == frame_hdr.frame_size) || (frame_hdr.frame_size > mtu_size) ||
+			(frame_offset >= data_size) ||
+			(frame_hdr.frame_size > (data_size - frame_offset))) {
+			/* Nothing that follows can be trusted, give up */
+			frame_resp.ack_or_nak     = 0;
+			frame_resp.next_frame_num = GARD_HUB_FRAME_NUM_ABORT;
+			p_gard->stats.protocol_errors++;
+		} else {
+			if ((0 != mock_gard_read_exact(p_gard, p_frame,
+										   frame_hdr.frame_size)) ||
+				(0 != mock_gard_read_exact(p_gard, &frame_trl,
+										   sizeof(frame_trl)))) {
+				goto err_mock_gard_recv_frames_1;
+			}
+
+			if ((frame_hdr.frame_num == frame_resp.next_frame_num) &&
+				(frame_hdr.frame_size ==
+				 (((data_size - frame_offset) < mtu_size)
+					  ? (data_size - frame_offset)
+					  : mtu_size)) &&
+				(frame_trl.crc ==
+				 mock_gard_crc32(0, p_frame, frame_hdr.frame_size))) {
+				mock_gard_mem_write(p_gard,
+									p_req->cmd.offset_address + frame_offset,
+									p_frame, frame_hdr.frame_size);
+				frame_resp.ack_or_nak = ACK_BYTE;
+				frame_resp.next_frame_num++;
+			} else {
+				frame_resp.ack_or_nak = 0;
+			}
+		}
+
+		if (0 != mock_gard_write_all(p_gard, &frame_resp,
+									 sizeof(frame_resp))) {
+			goto err_mock_gard_recv_frames_1;
+		}
+	}
+
+	ret = 0;
+
+err_mock_gard_recv_frames_1:
+	free(p_frame);
+	return ret;
+}
+
+/**
+ * Take a SEND_DATA_TO_GARD_FOR_OFFSET payload into GARD memory.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_recv_data(
+	struct mock_gard                                    *p_gard,
+	const struct _send_data_to_gard_for_offset_request *p_req)
+{
+	uint8_t  buffer[MOCK_GARD_TX_CHUNK];
+	uint32_t done = 0, chunk, crc = 0;
+	uint32_t eod[2];
+	uint8_t  ack = ACK_BYTE;
+	bool     has_crc = (0 != (p_req->cmd.control_code & CC_CHECKSUM_PRESENT));
+
+	if (p_req->cmd.control_code & CC_USE_MTU_SIZE) {
+		return mock_gard_recv_frames(p_gard, p_req);
+	}
+
+	while (done < p_req->cmd.data_size) {
+		chunk = p_req->cmd.data_size - done;
+		chunk = (chunk < sizeof(buffer)) ? chunk : sizeof(buffer);
+		if (0 != mock_gard_read_exact(p_gard, buffer, chunk)) {
+			return -1;
+		}
+		mock_gard_mem_write(p_gard, p_req->cmd.offset_address + done, buffer,
+							chunk);
+		if (has_crc) {
+			crc = mock_gard_crc32(crc, buffer, chunk);
+		}
+		done += chunk;
+	}
+
+	if (0 != mock_gard_read_exact(p_gard, eod,
+								  has_crc ? sizeof(eod) : sizeof(eod[0]))) {
+		return -1;
+	}
+	if (END_OF_DATA_MARKER != eod[0]) {
+		p_gard->stats.protocol_errors++;
+		return 0;
+	}
+	if (has_crc && (crc != eod[1])) {
+		ack = 0;
+	}
+
+	if (p_req->cmd.control_code & CC_SEND_ACK_AFTER_XFER) {
+		return mock_gard_write_all(p_gard, &ack, sizeof(ack));
+	}
+
+	return 0;
+}
+
+/**
+ * Compose the image of a CAPTURE_RESCALED_IMAGE in GARD memory, RGB planar
+ * bands moving by one line each image, and its response.
+ */
+static void mock_gard_capture_image(
+	struct mock_gard                               *p_gard,
+	const struct _capture_rescaled_image_request   *p_req,
+	struct _capture_rescaled_image_response        *p_resp)
+{
+	uint32_t width  = p_gard->p_cfg->image_width;
+	uint32_t height = p_gard->p_cfg->image_height;
+	uint32_t plane  = width * height;
+	uint64_t capture_ticks;
+	uint8_t *p_line;
+	uint32_t y, c;
+
+	memset(p_resp, 0, sizeof(*p_resp));
+	p_resp->start_of_data_marker   = START_OF_DATA_MARKER;
+	p_resp->eod.end_of_data_marker = END_OF_DATA_MARKER;
+	p_resp->codec                  = IMAGE_CODEC__NONE;
+	p_resp->image_format           = IMAGE_FORMAT__RGB_PLANAR;
+
+	/* A single camera, an unknown one gets an empty image as on GARD */
+	if (0 != p_req->camera_id) {
+		return;
+	}
+
+	p_line = malloc(width);
+	if (NULL == p_line) {
+		return;
+	}
+	for (c = 0; c < 3; c++) {
+		for (y = 0; y < height; y++) {
+			memset(p_line, (int)(((y + p_gard->frame_seq) * (c + 1)) & 0xFF),
+				   width);
+			mock_gard_mem_write(p_gard,
+								MOCK_GARD_IMAGE_ADDR + (c * plane) + (y * width),
+								p_line, width);
+		}
+	}
+	free(p_line);
+	capture_ticks           = mock_gard_now_ticks();
+	p_resp->frame_seq       = p_gard->frame_seq;
+	p_resp->capture_time_lo = (uint32_t)capture_ticks;
+	p_resp->capture_time_hi = (uint32_t)(capture_ticks >> 32);
+	p_gard->frame_seq++;
+
+	p_resp->image_buffer_address = MOCK_GARD_IMAGE_ADDR;
+	p_resp->image_buffer_size    = 3 * plane;
+	p_resp->h_size               = (uint16_t)width;
+	p_resp->v_size               = (uint16_t)height;
+
+	/* Snapshots are always supported, the pipeline is paused otherwise */
+	p_gard->pipeline_paused =
+		(0 == (p_req->flags & CAPTURE_RESCALED_IMAGE__NO_PAUSE));
+	p_resp->pipeline_paused = p_gard->pipeline_paused;
+}
+
+/**
+ * Serve a host command whose command id, and tag, are received: receive its
+ * body, send the tag header, and execute it.
+ *
+ * @return: 0 on success, -1 if the bus failed
+ */
+static int mock_gard_serve_cmd(struct mock_gard *p_gard, uint8_t command_id,
+							   bool is_tagged, uint8_t tag)
+{
+	struct _host_requests       req;
+	struct _host_responses      resp;
+	struct _response_tag_header tag_hdr = {RESPONSE_TAG_MARKER, tag};
+	uint32_t                    body_size, resp_size = 0, i;
+	uint32_t                    regs[(2 * GARD_HUB_MAX_REGS_PER_CMD) + 1];
+	uint8_t                     ack;
+
+	switch (command_id) {
+	case GARD_DISCOVERY:
+		body_size = sizeof(req.gard_discovery_request);
+		break;
+	case SEND_DATA_TO_GARD_FOR_OFFSET:
+		body_size = sizeof(req.send_data_to_gard_for_offset_request.cmd);
+		break;
+	case RECV_DATA_FROM_GARD_AT_OFFSET:
+		body_size = sizeof(req.recv_data_from_gard_at_offset_request);
+		break;
+	case READ_REG_VALUE_FROM_GARD_AT_OFFSET:
+		body_size = sizeof(req.read_reg_value_from_gard_at_offset_request);
+		break;
+	case WRITE_REG_VALUE_TO_GARD_AT_OFFSET:
+		body_size = sizeof(req.write_reg_value_to_gard_at_offset_request);
+		break;
+	case GET_ML_ENGINE_STATUS:
+		body_size = sizeof(req.get_ml_engine_status_request);
+		break;
+	case CAPTURE_RESCALED_IMAGE:
+		body_size = sizeof(req.capture_rescaled_image_request);
+		break;
+	case RESUME_PIPELINE:
+		body_size = sizeof(req.resume_pipeline_request);
+		break;
+	case SET_UART_PARAMETERS:
+		body_size = sizeof(req.set_uart_parameters_request);
+		break;
+	case READ_REGS_FROM_GARD:
+		body_size = sizeof(req.read_regs_from_gard_request.cmd);
+		break;
+	case WRITE_REGS_TO_GARD:
+		body_size = sizeof(req.write_regs_to_gard_request.cmd);
+		break;
+	case SUBSCRIBE_APP_DATA:
+		body_size = sizeof(req.subscribe_app_data_request);
+		break;
+	case GET_PIPELINE_STATS:
+		body_size = sizeof(req.get_pipeline_stats_request);
+		break;
+	case GET_NETWORK_RESIDENCY:
+		body_size = sizeof(req.get_network_residency_request);
+		break;
+	case INFERENCE_RATE:
+		body_size = sizeof(req.inference_rate_request);
+		break;
+	case SCALER_CONFIG:
+		body_size = sizeof(req.scaler_config_request);
+		break;
+	case GET_IMAGE_STATS:
+		body_size = sizeof(req.get_image_stats_request);
+		break;
+	case GET_GARD_TIME:
+		body_size = sizeof(req.get_gard_time_request);
+		break;
+	case RUN_INFERENCE_ON_BUFFER:
+		body_size = sizeof(req.run_inference_on_buffer_request);
+		break;
+	case SWAP_NETWORK:
+		body_size = sizeof(req.swap_network_request);
+		break;
+	case APP_DATA_COALESCING:
+		body_size = sizeof(req.app_data_coalescing_request);
+		break;
+	default:
+		/* Unknown, or an App Module command: dropped as by GARD FW */
+		p_gard->stats.protocol_errors++;
+		return 0;
+	}
+
+	if ((body_size > 0) &&
+		(0 != mock_gard_read_exact(p_gard, req.command_body, body_size))) {
+		return -1;
+	}
+
+	p_gard->stats.cmds++;
+	if (0 != p_gard->p_cfg->latency_us) {
+		mock_gard_sleep_until(mock_gard_now_ns() +
+							  ((uint64_t)p_gard->p_cfg->latency_us * 1000U));
+	}
+	if (is_tagged) {
+		p_gard->stats.tagged_cmds++;
+		if (0 != mock_gard_write_all(p_gard, &tag_hdr, sizeof(tag_hdr))) {
+			return -1;
+		}
+	}
+
+	memset(&resp, 0, sizeof(resp));
+	switch (command_id) {
+	case GARD_DISCOVERY: {
+		struct _gard_discovery_response *p_disc =
+			&resp.gard_discovery_response;
+
+		p_disc->start_of_data_marker = START_OF_DATA_MARKER;
+		memcpy(p_disc->signature, HUB_GARD_DISCOVER_SIGNATURE,
+			   sizeof(HUB_GARD_DISCOVER_SIGNATURE));
+		p_disc->device_id[0]       = p_gard->device_id[0];
+		p_disc->device_id[1]       = p_gard->device_id[1];
+		p_disc->profile_id         = MOCK_GARD_PROFILE_ID;
+		p_disc->capabilities       = GARD_CAP_BUS_UART | GARD_CAP_DATA_CRC |
+									 GARD_CAP_APP_DATA_STREAM;
+		p_disc->max_mtu_size       = UINT16_MAX;
+		p_disc->end_of_data_marker = END_OF_DATA_MARKER;
+		resp_size                  = sizeof(*p_disc);
+		break;
+	}
+
+	case SEND_DATA_TO_GARD_FOR_OFFSET:
+		return mock_gard_recv_data(p_gard,
+								   &req.send_data_to_gard_for_offset_request);
+
+	case RECV_DATA_FROM_GARD_AT_OFFSET:
+		if (req.recv_data_from_gard_at_offset_request.control_code &
+			CC_APP_DATA) {
+			return mock_gard_send_app_data(
+				p_gard, &req.recv_data_from_gard_at_offset_request);
+		}
+		return mock_gard_send_mem_data(
+			p_gard, &req.recv_data_from_gard_at_offset_request);
+
+	case READ_REG_VALUE_FROM_GARD_AT_OFFSET:
+		if (END_OF_DATA_MARKER != req.read_reg_value_from_gard_at_offset_request
+									  .end_of_data_marker) {
+			break;
+		}
+		resp.read_reg_value_from_gard_at_offset_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.read_reg_value_from_gard_at_offset_response.reg_value =
+			mock_gard_mem_read32(
+				p_gard, req.read_reg_value_from_gard_at_offset_request
+							.offset_address);
+		resp.read_reg_value_from_gard_at_offset_response.end_of_data_marker =
+			END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.read_reg_value_from_gard_at_offset_response);
+		break;
+
+	case WRITE_REG_VALUE_TO_GARD_AT_OFFSET:
+		if (END_OF_DATA_MARKER != req.write_reg_value_to_gard_at_offset_request
+									  .end_of_data_marker) {
+			break;
+		}
+		mock_gard_mem_write(
+			p_gard,
+			req.write_reg_value_to_gard_at_offset_request.offset_address,
+			(const uint8_t *)&req.write_reg_value_to_gard_at_offset_request
+				.data,
+			sizeof(uint32_t));
+		resp.write_reg_value_to_gard_at_offset_response.ack = ACK_BYTE;
+		resp_size = sizeof(resp.write_reg_value_to_gard_at_offset_response);
+		break;
+
+	case GET_ML_ENGINE_STATUS:
+		if (END_OF_DATA_MARKER !=
+			req.get_ml_engine_status_request.end_of_data_marker) {
+			break;
+		}
+		resp.get_ml_engine_status_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.get_ml_engine_status_response.end_of_data_marker =
+			END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.get_ml_engine_status_response);
+		break;
+
+	case CAPTURE_RESCALED_IMAGE:
+		if (END_OF_DATA_MARKER !=
+			req.capture_rescaled_image_request.end_of_data_marker) {
+			break;
+		}
+		mock_gard_capture_image(p_gard, &req.capture_rescaled_image_request,
+								&resp.capture_rescaled_image_response);
+		resp_size = sizeof(resp.capture_rescaled_image_response);
+		break;
+
+	case RESUME_PIPELINE:
+		if (END_OF_DATA_MARKER !=
+			req.resume_pipeline_request.end_of_data_marker) {
+			break;
+		}
+		if (0 == req.resume_pipeline_request.camera_id) {
+			p_gard->pipeline_paused                   = false;
+			resp.resume_pipeline_response.ack_or_nak = ACK_BYTE;
+		}
+		resp_size = sizeof(resp.resume_pipeline_response);
+		break;
+
+	case SET_UART_PARAMETERS:
+		if (END_OF_DATA_MARKER !=
+			req.set_uart_parameters_request.end_of_data_marker) {
+			break;
+		}
+		/* ACKed at the current rate, paced at the new one after */
+		resp.set_uart_parameters_response.ack_or_nak = ACK_BYTE;
+		if (0 != mock_gard_write_all(
+					 p_gard, &resp, sizeof(resp.set_uart_parameters_response))) {
+			return -1;
+		}
+		if (0 != p_gard->baud_rate) {
+			p_gard->baud_rate = req.set_uart_parameters_request.baud_rate;
+		}
+		return 0;
+
+	case READ_REGS_FROM_GARD:
+	case WRITE_REGS_TO_GARD: {
+		uint16_t num_regs = (READ_REGS_FROM_GARD == command_id)
+								? req.read_regs_from_gard_request.cmd.num_regs
+								: req.write_regs_to_gard_request.cmd.num_regs;
+		uint32_t words    = (READ_REGS_FROM_GARD == command_id)
+								? num_regs
+								: (2U * num_regs);
+
+		if ((0 == num_regs) || (num_regs > GARD_HUB_MAX_REGS_PER_CMD)) {
+			p_gard->stats.protocol_errors++;
+			return 0;
+		}
+		if (0 != mock_gard_read_exact(p_gard, regs,
+									  (words + 1) * sizeof(uint32_t))) {
+			return -1;
+		}
+		if (END_OF_DATA_MARKER != regs[words]) {
+			break;
+		}
+
+		if (WRITE_REGS_TO_GARD == command_id) {
+			for (i = 0; i < num_regs; i++) {
+				mock_gard_mem_write(p_gard, regs[2 * i],
+									(const uint8_t *)&regs[(2 * i) + 1],
+									sizeof(uint32_t));
+			}
+			ack = ACK_BYTE;
+			return mock_gard_write_all(p_gard, &ack, sizeof(ack));
+		}
+
+		/* sod, num_regs, the values and the eod marker in one go */
+		for (i = num_regs; i > 0; i--) {
+			regs[i + 1] = mock_gard_mem_read32(p_gard, regs[i - 1]);
+		}
+		regs[0]            = START_OF_DATA_MARKER;
+		regs[1]            = num_regs;
+		regs[num_regs + 2] = END_OF_DATA_MARKER;
+		return mock_gard_write_all(p_gard, regs,
+								   (num_regs + 3) * sizeof(uint32_t));
+	}
+
+	case SUBSCRIBE_APP_DATA:
+		if (END_OF_DATA_MARKER !=
+			req.subscribe_app_data_request.end_of_data_marker) {
+			break;
+		}
+		/* The results already queued are pushed numbered from 0 */
+		if (req.subscribe_app_data_request.enable && !p_gard->subscribed) {
+			p_gard->push_seq = 0;
+		}
+		p_gard->subscribed = (0 != req.subscribe_app_data_request.enable);
+		resp.subscribe_app_data_response.ack_or_nak = ACK_BYTE;
+		resp_size = sizeof(resp.subscribe_app_data_response);
+		break;
+
+	case GET_PIPELINE_STATS:
+		resp.get_pipeline_stats_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.get_pipeline_stats_response.cycles_per_us = 1;
+		resp.get_pipeline_stats_response.num_stages = PIPELINE_STATS__NUM_STAGES;
+		resp.get_pipeline_stats_response.eod.end_of_data_marker =
+			END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.get_pipeline_stats_response);
+		break;
+
+	case GET_NETWORK_RESIDENCY:
+		resp.get_network_residency_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.get_network_residency_response.end_of_data_marker =
+			END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.get_network_residency_response);
+		break;
+
+	case INFERENCE_RATE:
+		if (req.inference_rate_request.set) {
+			p_gard->inference_mode  = req.inference_rate_request.mode;
+			p_gard->inference_param = req.inference_rate_request.param;
+		}
+		resp.inference_rate_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.inference_rate_response.ack_or_nak = ACK_BYTE;
+		resp.inference_rate_response.mode       = p_gard->inference_mode;
+		resp.inference_rate_response.param      = p_gard->inference_param;
+		resp.inference_rate_response.run_interval = 1;
+		resp.inference_rate_response.end_of_data_marker = END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.inference_rate_response);
+		break;
+
+	case SCALER_CONFIG:
+		if (req.scaler_config_request.set) {
+			/* The windows and sizes have the same layout in both */
+			p_gard->scaler.box_factor_x = req.scaler_config_request.box_factor_x;
+			p_gard->scaler.box_factor_y = req.scaler_config_request.box_factor_y;
+			memcpy(&p_gard->scaler.precrop_left,
+				   &req.scaler_config_request.precrop_left,
+				   offsetof(struct _scaler_config_response,
+							end_of_data_marker) -
+					   offsetof(struct _scaler_config_response, precrop_left));
+			p_gard->scaler.applied = 1;
+		}
+		resp.scaler_config_response = p_gard->scaler;
+		resp.scaler_config_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.scaler_config_response.ack_or_nak = ACK_BYTE;
+		resp.scaler_config_response.end_of_data_marker = END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.scaler_config_response);
+		break;
+
+	case GET_IMAGE_STATS:
+		resp.get_image_stats_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.get_image_stats_response.images_recorded = p_gard->frame_seq;
+		resp.get_image_stats_response.end_of_data_marker = END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.get_image_stats_response);
+		break;
+
+	case GET_GARD_TIME: {
+		uint64_t now_ticks = mock_gard_now_ticks();
+
+		if (END_OF_DATA_MARKER != req.get_gard_time_request.end_of_data_marker) {
+			break;
+		}
+		resp.get_gard_time_response.start_of_data_marker = START_OF_DATA_MARKER;
+		resp.get_gard_time_response.time_lo    = (uint32_t)now_ticks;
+		resp.get_gard_time_response.time_hi    = (uint32_t)(now_ticks >> 32);
+		resp.get_gard_time_response.timer_freq = MOCK_GARD_TIMER_FREQ;
+		resp.get_gard_time_response.end_of_data_marker = END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.get_gard_time_response);
+		break;
+	}
+
+	case RUN_INFERENCE_ON_BUFFER: {
+		uint32_t idx;
+
+		if (END_OF_DATA_MARKER !=
+			req.run_inference_on_buffer_request.end_of_data_marker) {
+			break;
+		}
+		resp.run_inference_on_buffer_response.ack_or_nak = ACK_BYTE;
+		switch (req.run_inference_on_buffer_request.op) {
+		case HOST_INFERENCE__QUERY:
+			break;
+		case HOST_INFERENCE__SUBMIT:
+			/* The image is taken at once, its slot is free again */
+			if (req.run_inference_on_buffer_request.slot >=
+				HOST_INFERENCE__SLOTS) {
+				resp.run_inference_on_buffer_response.ack_or_nak = 0;
+				break;
+			}
+			p_gard->host_inference = true;
+			break;
+		case HOST_INFERENCE__STOP:
+			p_gard->host_inference = false;
+			break;
+		default:
+			resp.run_inference_on_buffer_response.ack_or_nak = 0;
+			break;
+		}
+		resp.run_inference_on_buffer_response.start_of_data_marker =
+			START_OF_DATA_MARKER;
+		resp.run_inference_on_buffer_response.active =
+			p_gard->host_inference ? 1 : 0;
+		resp.run_inference_on_buffer_response.free_slots =
+			(1U << HOST_INFERENCE__SLOTS) - 1U;
+		for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+			resp.run_inference_on_buffer_response.slot_address[idx] =
+				MOCK_GARD_HOST_INPUT_ADDR + (idx * MOCK_GARD_HOST_INPUT_SIZE);
+		}
+		resp.run_inference_on_buffer_response.slot_size =
+			MOCK_GARD_HOST_INPUT_SIZE;
+		resp.run_inference_on_buffer_response.end_of_data_marker =
+			END_OF_DATA_MARKER;
+		resp_size = sizeof(resp.run_inference_on_buffer_response);
+		break;
+	}
+
+	case SWAP_NETWORK: {
+		struct _swap_network_response *p_swap = &p_gard->swap;
+
+		if (END_OF_DATA_MARKER !=
+			req.swap_network_request.end_of_data_marker) {
+			break;
+		}
+		p_swap->ack_or_nak = ACK_BYTE;
+		switch (req.swap_network_request.op) {
+		case NETWORK_SWAP__STATUS:
+			break;
+		case NETWORK_SWAP__STAGE:
+			if ((0 == req.swap_network_request.size) ||
+				(req.swap_network_request.size >
+				 MOCK_GARD_NETWORK_STAGING_SIZE)) {
+				p_swap->ack_or_nak = 0;
+				break;
+			}
+			p_swap->status          = NETWORK_SWAP__STAGED;
+			p_swap->network         = req.swap_network_request.network;
+			p_swap->staging_address = MOCK_GARD_NETWORK_STAGING_ADDR;
+			p_swap->staging_size    = req.swap_network_request.size;
+			p_swap->bytes_persisted = 0;
+			break;
+		case NETWORK_SWAP__COMMIT:
+			/* The network is switched to, and persisted, at once */
+			if ((NETWORK_SWAP__STAGED != p_swap->status) ||
+				(req.swap_network_request.network != p_swap->network) ||
+				(req.swap_network_request.size != p_swap->staging_size)) {
+				p_swap->ack_or_nak = 0;
+				break;
+			}
+			if (req.swap_network_request.flags & NETWORK_SWAP__PERSIST) {
+				p_swap->status          = NETWORK_SWAP__PERSISTED;
+				p_swap->bytes_persisted = p_swap->staging_size;
+			} else {
+				p_swap->status = NETWORK_SWAP__SWAPPED;
+			}
+			p_swap->staging_address = 0;
+			p_swap->staging_size    = 0;
+			break;
+		case NETWORK_SWAP__ABORT:
+			memset(p_swap, 0, sizeof(*p_swap));
+			p_swap->ack_or_nak = ACK_BYTE;
+			break;
+		default:
+			p_swap->ack_or_nak = 0;
+			break;
+		}
+		p_swap->start_of_data_marker = START_OF_DATA_MARKER;
+		p_swap->end_of_data_marker   = END_OF_DATA_MARKER;
+		resp.swap_network_response   = *p_swap;
+		resp_size = sizeof(resp.swap_network_response);
+		break;
+	}
+
+	case APP_DATA_COALESCING: {
+		struct _app_data_coalescing_response *p_coal = &p_gard->coalescing;
+
+		if (END_OF_DATA_MARKER !=
+			req.app_data_coalescing_request.end_of_data_marker) {
+			break;
+		}
+		p_coal->ack_or_nak = ACK_BYTE;
+		if (req.app_data_coalescing_request.set) {
+			if (req.app_data_coalescing_request.enable &&
+				p_gard->subscribed) {
+				p_coal->ack_or_nak = 0;
+			} else {
+				p_coal->enabled = req.app_data_coalescing_request.enable;
+				p_coal->max_latency_ms =
+					req.app_data_coalescing_request.max_latency_ms;
+				if (0 == p_coal->max_latency_ms) {
+					p_coal->max_latency_ms =
+						APP_DATA_COALESCE__DEFAULT_LATENCY_MS;
+				}
+			}
+		}
+		p_coal->start_of_data_marker     = START_OF_DATA_MARKER;
+		p_coal->end_of_data_marker       = END_OF_DATA_MARKER;
+		resp.app_data_coalescing_response = *p_coal;
+		resp_size = sizeof(resp.app_data_coalescing_response);
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	if (0 == resp_size) {
+		/* A bad end of data marker, GARD FW does not answer either */
+		p_gard->stats.protocol_errors++;
+		return 0;
+	}
+
+	return mock_gard_write_all(p_gard, &resp, resp_size);
+}
+
+/**
+ * Open a pty in raw mode, the GARD end. The HUB end is kept open too, so
+ * that the pty stays up while HUB opens and closes it.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_open_pty(struct mock_gard *p_gard)
+{
+	struct termios tio;
+	char           link[256];
+
+	p_gard->fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((p_gard->fd < 0) || (0 != grantpt(p_gard->fd)) ||
+		(0 != unlockpt(p_gard->fd)) ||
+		(0 != ptsname_r(p_gard->fd, p_gard->name, sizeof(p_gard->name)))) {
+		printf("Failed to open a pty: %s\n", strerror(errno));
+		goto err_mock_gard_open_pty_1;
+	}
+
+	p_gard->hub_fd = open(p_gard->name, O_RDWR | O_NOCTTY);
+	if ((p_gard->hub_fd < 0) || (0 != tcgetattr(p_gard->hub_fd, &tio))) {
+		printf("Failed to open %s: %s\n", p_gard->name, strerror(errno));
+		goto err_mock_gard_open_pty_1;
+	}
+	cfmakeraw(&tio);
+	if (0 != tcsetattr(p_gard->hub_fd, TCSANOW, &tio)) {
+		printf("Failed to set up %s: %s\n", p_gard->name, strerror(errno));
+		goto err_mock_gard_open_pty_2;
+	}
+
+	if (NULL != p_gard->p_cfg->p_link_prefix) {
+		snprintf(link, sizeof(link), "%s%u", p_gard->p_cfg->p_link_prefix,
+				 p_gard->index);
+		(void)unlink(link);
+		if (0 != symlink(p_gard->name, link)) {
+			printf("Failed to link %s: %s\n", link, strerror(errno));
+			goto err_mock_gard_open_pty_2;
+		}
+		snprintf(p_gard->name, sizeof(p_gard->name), "%s", link);
+	}
+
+	return 0;
+
+err_mock_gard_open_pty_2:
+	close(p_gard->hub_fd);
+	p_gard->hub_fd = -1;
+err_mock_gard_open_pty_1:
+	if (p_gard->fd >= 0) {
+		close(p_gard->fd);
+		p_gard->fd = -1;
+	}
+	return -1;
+}
+
+/**
+ * Listen on the TCP port of the GARD, on the loopback interface.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int mock_gard_listen(struct mock_gard *p_gard)
+{
+	struct sockaddr_in addr = {0};
+	int                one  = 1;
+	uint16_t           port = (uint16_t)(p_gard->p_cfg->tcp_port + p_gard->index);
+
+	p_gard->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (p_gard->listen_fd < 0) {
+		printf("Failed to open a socket: %s\n", strerror(errno));
+		return -1;
+	}
+	(void)setsockopt(p_gard->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one,
+					 sizeof(one));
+
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if ((0 != bind(p_gard->listen_fd, (struct sockaddr *)&addr,
+				   sizeof(addr))) ||
+		(0 != listen(p_gard->listen_fd, 1))) {
+		printf("Failed to listen on port %u: %s\n", port, strerror(errno));
+		close(p_gard->listen_fd);
+		p_gard->listen_fd = -1;
+		return -1;
+	}
+	snprintf(p_gard->name, sizeof(p_gard->name), "tcp:127.0.0.1:%u", port);
+
+	return 0;
+}
+
+/**
+ * Wait for HUB to connect to the TCP port of the GARD.
+ *
+ * @return: 0 once connected, -1 if stopped or on failure
+ */
+static int mock_gard_accept(struct mock_gard *p_gard)
+{
+	struct pollfd pfd = {.fd = p_gard->listen_fd, .events = POLLIN};
+	int           one = 1;
+
+	while (!g_stop) {
+		if (poll(&pfd, 1, MOCK_GARD_POLL_MS) <= 0) {
+			continue;
+		}
+		p_gard->fd = accept(p_gard->listen_fd, NULL, NULL);
+		if (p_gard->fd >= 0) {
+			(void)setsockopt(p_gard->fd, IPPROTO_TCP, TCP_NODELAY, &one,
+							 sizeof(one));
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Serve the host commands of one virtual GARD until the mock is stopped,
+ * producing the App Module results as they fall due in between.
+ */
+static void *mock_gard_thread(void *p_arg)
+{
+	struct mock_gard *p_gard = (struct mock_gard *)p_arg;
+	struct pollfd     pfd;
+	uint64_t          now_ns;
+	uint8_t           command_id, tag;
+	int               timeout_ms, ready;
+
+	if (NULL != p_gard->recording) {
+		p_gard->replay_start_ns = mock_gard_now_ns();
+		mock_gard_next_replayed(p_gard);
+		p_gard->first_entry_ns = p_gard->next_entry.timestamp_ns;
+		p_gard->next_result_ns = p_gard->replay_start_ns;
+	} else {
+		p_gard->next_result_ns = mock_gard_now_ns() + p_gard->result_period_ns;
+	}
+
+	while (!g_stop) {
+		if ((p_gard->listen_fd >= 0) && (p_gard->fd < 0) &&
+			(0 != mock_gard_accept(p_gard))) {
+			break;
+		}
+
+		mock_gard_produce_results(p_gard);
+		if (0 != mock_gard_push_results(p_gard)) {
+			goto err_mock_gard_thread_1;
+		}
+
+		timeout_ms = MOCK_GARD_POLL_MS;
+		if (mock_gard_producing(p_gard)) {
+			now_ns = mock_gard_now_ns();
+			if (p_gard->next_result_ns <= now_ns) {
+				timeout_ms = 0;
+			} else if ((p_gard->next_result_ns - now_ns) <
+					   ((uint64_t)timeout_ms * 1000000U)) {
+				timeout_ms =
+					(int)((p_gard->next_result_ns - now_ns) / 1000000U) + 1;
+			}
+		}
+
+		pfd.fd     = p_gard->fd;
+		pfd.events = POLLIN;
+		ready      = poll(&pfd, 1, timeout_ms);
+		if ((ready <= 0) || !(pfd.revents & (POLLIN | POLLHUP | POLLERR))) {
+			continue;
+		}
+
+		if (0 != mock_gard_read_exact(p_gard, &command_id,
+									  sizeof(command_id))) {
+			goto err_mock_gard_thread_1;
+		}
+		tag = 0;
+		if ((command_id & CMD_ID_TAGGED) &&
+			(0 != mock_gard_read_exact(p_gard, &tag, sizeof(tag)))) {
+			goto err_mock_gard_thread_1;
+		}
+		if (0 != mock_gard_serve_cmd(p_gard,
+									 command_id & (uint8_t)~CMD_ID_TAGGED,
+									 (0 != (command_id & CMD_ID_TAGGED)),
+									 tag)) {
+			goto err_mock_gard_thread_1;
+		}
+		continue;
+
+	err_mock_gard_thread_1:
+		/* A TCP HUB may come back, a pty does not go away */
+		if (p_gard->listen_fd < 0) {
+			break;
+		}
+		close(p_gard->fd);
+		p_gard->fd         = -1;
+		p_gard->subscribed = false;
+	}
+
+	return NULL;
+}
+
+static void mock_gard_print_stats(const struct mock_gard *p_gards,
+								  uint32_t num_gards, double elapsed_s)
+{
+	const struct mock_gard_stats *p_stats;
+	uint32_t                      i;
+
+	printf("\n%-5s %10s %8s %12s %12s %8s %8s %8s %8s %8s %6s\n", "GARD",
+		   "cmds", "tagged", "bytes_rx", "bytes_tx", "results", "dropped",
+		   "read", "pushed", "gpio", "errors");
+	for (i = 0; i < num_gards; i++) {
+		p_stats = &p_gards[i].stats;
+		printf("%-5u %10llu %8llu %12llu %12llu %8llu %8llu %8llu %8llu %8llu "
+			   "%6llu\n",
+			   i, (unsigned long long)p_stats->cmds,
+			   (unsigned long long)p_stats->tagged_cmds,
+			   (unsigned long long)p_stats->bytes_rx,
+			   (unsigned long long)p_stats->bytes_tx,
+			   (unsigned long long)p_stats->results,
+			   (unsigned long long)p_stats->results_dropped,
+			   (unsigned long long)p_stats->results_read,
+			   (unsigned long long)p_stats->results_pushed,
+			   (unsigned long long)p_stats->gpio_events,
+			   (unsigned long long)p_stats->protocol_errors);
+		if (0 != p_stats->mem_exhausted) {
+			printf("      %llu writes beyond the memory of the GARD were "
+				   "dropped\n",
+				   (unsigned long long)p_stats->mem_exhausted);
+		}
+	}
+	printf("Served for %.1f s\n", elapsed_s);
+}
+
+static void print_usage(const char *p_name)
+{
+	printf("Usage: %s [options]\n", p_name);
+	printf("  Emulates GARDs on ptys for HUB, until Ctrl+C\n");
+	printf("  -n <count>   virtual GARDs, 1 by default, at most %d\n",
+		   MOCK_GARD_MAX_GARDS);
+	printf("  -l <prefix>  links <prefix><index> to the pty of each GARD\n");
+	printf("  -t <port>    serves GARD <index> on TCP port <port> + <index> "
+		   "instead of a pty\n");
+	printf("  -d <us>      delays each response by <us> microseconds\n");
+	printf("  -b <baud>    sends at the pace of a UART at <baud>, 8N1\n");
+	printf("  -r <rate>    App Module results per second of each GARD\n");
+	printf("  -s <bytes>   bytes of each result, 64 by default\n");
+	printf("  -e <path>    gpio-sim pull attribute of the app data line, %%u "
+		   "for the GARD index\n");
+	printf("  -i <w>x<h>   size of the captured image, 320x240 by default\n");
+	printf("  -m <MB>      memory of each GARD, 64 MB by default\n");
+	printf("  -R <path>    replays the results of a recording, %%u for the "
+		   "GARD index\n");
+	printf("  -x <scale>   scales the recorded result times, 1 by default, "
+		   "0 for all at once\n");
+}
+
+int main(int argc, char *argv[])
+{
+	struct mock_gard_cfg cfg = {
+		.num_gards    = 1,
+		.result_size  = 64,
+		.image_width  = 320,
+		.image_height = 240,
+		.mem_pages    = (64U << 20) >> MOCK_GARD_PAGE_SHIFT,
+		.time_scale   = 1.0,
+	};
+	struct mock_gard *p_gards;
+	uint64_t          start_ns;
+	uint32_t          i, num_started = 0;
+	unsigned int      width, height;
+	int               opt, ret = -1;
+
+	while ((opt = getopt(argc, argv, "n:l:t:d:b:r:s:e:i:m:R:x:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			cfg.num_gards = (uint32_t)atoi(optarg);
+			break;
+		case 'l':
+			cfg.p_link_prefix = optarg;
+			break;
+		case 't':
+			cfg.tcp_port = (uint16_t)atoi(optarg);
+			break;
+		case 'd':
+			cfg.latency_us = (uint32_t)atoi(optarg);
+			break;
+		case 'b':
+			cfg.baud_rate = (uint32_t)atoi(optarg);
+			break;
+		case 'r':
+			cfg.results_per_s = atof(optarg);
+			break;
+		case 's':
+			cfg.result_size = (uint32_t)atoi(optarg);
+			break;
+		case 'e':
+			cfg.p_gpio_fmt = optarg;
+			break;
+		case 'i':
+			if ((2 != sscanf(optarg, "%ux%u", &width, &height)) ||
+				(0 == width) || (0 == height) || (width > UINT16_MAX) ||
+				(height > UINT16_MAX)) {
+				print_usage(argv[0]);
+				return -1;
+			}
+			cfg.image_width  = (uint16_t)width;
+			cfg.image_height = (uint16_t)height;
+			break;
+		case 'm':
+			cfg.mem_pages = ((uint32_t)atoi(optarg) << 20) >>
+							MOCK_GARD_PAGE_SHIFT;
+			break;
+		case 'R':
+			cfg.p_recording_fmt = optarg;
+			break;
+		case 'x':
+			cfg.time_scale = atof(optarg);
+			break;
+		default:
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+	if ((optind != argc) || (0 == cfg.num_gards) ||
+		(cfg.num_gards > MOCK_GARD_MAX_GARDS) || (0 == cfg.mem_pages) ||
+		(cfg.results_per_s < 0.0) || (cfg.time_scale < 0.0)) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	if ((signal(SIGINT, stop_handler) == SIG_ERR) ||
+		(signal(SIGTERM, stop_handler) == SIG_ERR) ||
+		(signal(SIGPIPE, SIG_IGN) == SIG_ERR)) {
+		printf("Failed to set up signal handler\n");
+		return -1;
+	}
+
+	mock_gard_crc32_init();
+
+	p_gards = calloc(cfg.num_gards, sizeof(*p_gards));
+	if (NULL == p_gards) {
+		return -1;
+	}
+
+	start_ns = mock_gard_now_ns();
+	for (i = 0; i < cfg.num_gards; i++) {
+		struct mock_gard *p_gard = &p_gards[i];
+
+		p_gard->p_cfg     = &cfg;
+		p_gard->index     = i;
+		p_gard->fd        = -1;
+		p_gard->hub_fd    = -1;
+		p_gard->listen_fd = -1;
+		p_gard->baud_rate = cfg.baud_rate;
+		p_gard->result_period_ns =
+			(cfg.results_per_s > 0.0)
+				? (uint64_t)(1e9 / cfg.results_per_s)
+				: 0;
+		p_gard->coalescing.max_latency_ms =
+			APP_DATA_COALESCE__DEFAULT_LATENCY_MS;
+		/* Distinct across GARDs and mock runs, as drawn by GARD FW */
+		p_gard->device_id[0] = (uint32_t)start_ns ^ (i * 2654435761U);
+		p_gard->device_id[1] = (uint32_t)getpid() | 1U;
+
+		/* Twice the pages the GARD may have, so that probing stays short */
+		for (p_gard->num_slots = 1; p_gard->num_slots < 2 * cfg.mem_pages;
+			 p_gard->num_slots <<= 1) {
+		}
+		p_gard->p_pages = calloc(p_gard->num_slots, sizeof(*p_gard->p_pages));
+		if (NULL == p_gard->p_pages) {
+			goto err_mock_gard_app_1;
+		}
+
+		if (NULL != cfg.p_recording_fmt) {
+			char path[256];
+
+			snprintf(path, sizeof(path), cfg.p_recording_fmt, i);
+			if (HUB_SUCCESS != hub_recording_open(path, &p_gard->recording)) {
+				printf("Failed to open the recording %s\n", path);
+				goto err_mock_gard_app_1;
+			}
+		}
+
+		if (0 != ((0 != cfg.tcp_port) ? mock_gard_listen(p_gard)
+									  : mock_gard_open_pty(p_gard))) {
+			goto err_mock_gard_app_1;
+		}
+		if (0 != pthread_create(&p_gard->thread, NULL, mock_gard_thread,
+								p_gard)) {
+			printf("Failed to start GARD %u\n", i);
+			goto err_mock_gard_app_1;
+		}
+		num_started++;
+		printf("Mock GARD %u on %s\n", i, p_gard->name);
+	}
+	printf("Serving %u mock GARD(s), Ctrl+C to stop\n", cfg.num_gards);
+	fflush(stdout);
+
+	while (!g_stop) {
+		pause();
+	}
+	ret = 0;
+
+err_mock_gard_app_1:
+	g_stop = 1;
+	for (i = 0; i < num_started; i++) {
+		pthread_join(p_gards[i].thread, NULL);
+	}
+	if (0 == ret) {
+		mock_gard_print_stats(p_gards, cfg.num_gards,
+							  (double)(mock_gard_now_ns() - start_ns) / 1e9);
+	}
+	for (i = 0; i < cfg.num_gards; i++) {
+		struct mock_gard *p_gard = &p_gards[i];
+		uint32_t          slot;
+
+		if (p_gard->fd >= 0) {
+			close(p_gard->fd);
+		}
+		if (p_gard->hub_fd >= 0) {
+			close(p_gard->hub_fd);
+		}
+		if (p_gard->listen_fd >= 0) {
+			close(p_gard->listen_fd);
+		}
+		for (slot = 0; slot < p_gard->num_slots; slot++) {
+			free(p_gard->p_pages[slot].p_data);
+		}
+		free(p_gard->p_pages);
+		hub_recording_close(p_gard->recording);
+	}
+	free(p_gards);
+
+	return ret;
+}
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB recording replay application
+ *
+ * Works on the app data recordings written by hub_record_appdata():
+ * 1. Prints the segments, records, span, rate and result sizes of a
+ *    recording, and the sequence numbers missing from it.
+ * 2. With -p, prints each record from the time given with -s, at the pace it
+ *    was recorded at scaled by -x.
+ * 3. With -o, writes the records from the time given with -s to a stream
+ *    file of the App Module host simulation, a record of the frame index and
+ *    the count of bytes (32 bits each) then the data, see
+ *    apps/host_sim/fw_core_sim.c, so that a recording on GARD is compared
+ *    with a simulation run with "make check_host_sim EXPECTED=<file>".
+ *
+ * Note:
+ * * 1. To replay a recording into edgeHUB, or any HUB app, serve it from a
+ *      mock GARD: hub_app_mock_gard.elf -R <recording> -x <scale>.
+ * * 2. The frame index of the stream file is the sequence number of the
+ *      record from 0: the results of frames that produced none are not in a
+ *      recording, so it only matches a simulation that streams every frame.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hub.h"
+
+static uint64_t replay_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void replay_sleep_until(uint64_t deadline_ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec  = (time_t)(deadline_ns / 1000000000ULL);
+	ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+	while (EINTR ==
+		   clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+	}
+}
+
+/**
+ * Print the totals of a recording, reading it all.
+ */
+static void replay_print_summary(hub_recording_t recording)
+{
+	struct hub_recording_info  info;
+	struct hub_recording_entry entry;
+	uint64_t                   bytes = 0, missing = 0, last_seq = 0;
+	uint32_t                   min_size = UINT32_MAX, max_size = 0;
+	uint64_t                   num_read = 0;
+	double                     span_s;
+	time_t                     start_s;
+	char                       date[64] = "?";
+
+	while (HUB_SUCCESS == hub_recording_next(recording, &entry)) {
+		bytes    += entry.size;
+		min_size  = (entry.size < min_size) ? entry.size : min_size;
+		max_size  = (entry.size > max_size) ? entry.size : max_size;
+		missing  += entry.seq - last_seq - 1;
+		last_seq  = entry.seq;
+		num_read++;
+	}
+	hub_recording_get_info(recording, &info);
+
+	start_s = (time_t)(info.start_realtime_ns / 1000000000ULL);
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&start_s));
+	span_s = (double)(info.last_ns - info.first_ns) / 1e9;
+
+	printf("GARD %u, recorded from %s, %u segment(s)\n", info.gard_index,
+		   date, info.num_segments);
+	printf("%llu records over %.3f s, %.1f results/s\n",
+		   (unsigned long long)num_read, span_s,
+		   (span_s > 0.0) ? ((double)num_read - 1.0) / span_s : 0.0);
+	if (num_read) {
+		printf("Result sizes: min %u, mean %.1f, max %u bytes, %llu bytes "
+			   "in all\n",
+			   min_size, (double)bytes / (double)num_read, max_size,
+			   (unsigned long long)bytes);
+	}
+	printf("%llu records missing, %u corrupt, %u segment(s) not closed\n",
+		   (unsigned long long)missing, info.corrupt_records,
+		   info.rebuilt_indexes);
+}
+
+/**
+ * Print and / or stream the records from a time, at their recorded pace
+ * scaled by time_scale.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int replay_records(hub_recording_t recording,
+						  uint64_t        from_ns,
+						  double          time_scale,
+						  bool            print,
+						  FILE           *p_stream)
+{
+	struct hub_recording_entry entry;
+	uint64_t                   start_ns, first_ns = 0;
+	uint32_t                   frame, count = 0;
+
+	if (HUB_SUCCESS != hub_recording_seek(recording, from_ns)) {
+		printf("No record at or after %.3f s\n", (double)from_ns / 1e9);
+		return -1;
+	}
+
+	start_ns = replay_now_ns();
+	while (HUB_SUCCESS == hub_recording_next(recording, &entry)) {
+		if (0 == count) {
+			first_ns = entry.timestamp_ns;
+		}
+		if (time_scale > 0.0) {
+			replay_sleep_until(
+				start_ns +
+				(uint64_t)((double)(entry.timestamp_ns - first_ns) *
+						   time_scale));
+		}
+
+		if (print) {
+			printf("%10.3f s  seq %8llu  %6u bytes\n",
+				   (double)entry.timestamp_ns / 1e9,
+				   (unsigned long long)entry.seq, entry.size);
+		}
+		if (NULL != p_stream) {
+			frame = (uint32_t)(entry.seq - 1);
+			if ((1 != fwrite(&frame, sizeof(frame), 1, p_stream)) ||
+				(1 != fwrite(&entry.size, sizeof(entry.size), 1, p_stream)) ||
+				(entry.size != fwrite(entry.p_data, 1, entry.size, p_stream))) {
+				printf("Failed to write the stream file: %s\n",
+					   strerror(errno));
+				return -1;
+			}
+		}
+		count++;
+	}
+
+	printf("Replayed %u records in %.3f s\n", count,
+		   (double)(replay_now_ns() - start_ns) / 1e9);
+
+	return 0;
+}
+
+static void print_usage(const char *p_name)
+{
+	printf("Usage: %s [options] <recording>\n", p_name);
+	printf("  Prints the totals of an app data recording\n");
+	printf("  -s <ms>     replays from this time of the recording, 0 by "
+		   "default\n");
+	printf("  -p          prints each record replayed\n");
+	printf("  -o <file>   writes the records replayed to a host simulation "
+		   "stream file\n");
+	printf("  -x <scale>  scales the recorded times, 1 by default, 0 to "
+		   "replay at once\n");
+}
+
+int main(int argc, char *argv[])
+{
+	hub_recording_t recording;
+	const char     *p_stream_path = NULL;
+	FILE           *p_stream      = NULL;
+	double          time_scale    = 1.0;
+	uint64_t        from_ns       = 0;
+	bool            print         = false;
+	int             opt, ret;
+
+	while ((opt = getopt(argc, argv, "s:po:x:h")) != -1) {
+		switch (opt) {
+		case 's':
+			from_ns = (uint64_t)strtoull(optarg, NULL, 0) * 1000000ULL;
+			break;
+		case 'p':
+			print = true;
+			break;
+		case 'o':
+			p_stream_path = optarg;
+			break;
+		case 'x':
+			time_scale = atof(optarg);
+			break;
+		default:
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+	if ((optind != argc - 1) || (time_scale < 0.0)) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	if (HUB_SUCCESS != hub_recording_open(argv[optind], &recording)) {
+		printf("Failed to open the recording %s\n", argv[optind]);
+		return -1;
+	}
+
+	if (!print && (NULL == p_stream_path)) {
+		replay_print_summary(recording);
+		ret = 0;
+	} else {
+		if (NULL != p_stream_path) {
+			p_stream = fopen(p_stream_path, "wb");
+			if (NULL == p_stream) {
+				printf("Failed to open %s: %s\n", p_stream_path,
+					   strerror(errno));
+				hub_recording_close(recording);
+				return -1;
+			}
+		}
+		ret = replay_records(recording, from_ns, time_scale, print, p_stream);
+		if ((NULL != p_stream) && (0 != fclose(p_stream))) {
+			ret = -1;
+		}
+	}
+
+	hub_recording_close(recording);
+
+	return ret;
+}
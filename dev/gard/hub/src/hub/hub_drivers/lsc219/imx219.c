@@ -109,6 +109,9 @@
 #define IMX219_BINNING_X2                          0x01
 #define IMX219_BINNING_X2_ANALOG                   0x03
 
+/* Binning selection, see imx219_binning_menu */
+#define IMX219_CID_BINNING                         (V4L2_CID_USER_BASE | 0x1090)
+
 #define IMX219_REG_CSI_DATA_FORMAT_A               CCI_REG16(0x018c)
 
 /* PLL Settings */
@@ -267,6 +270,20 @@ static const int imx219_test_pattern_val[] = {
 	IMX219_TEST_PATTERN_PN9,
 };
 
+/* Binning selection, in the order of imx219_binning_menu */
+enum imx219_binning_ctrl {
+	/* Analog for 8-bit formats, digital for 10-bit ones */
+	IMX219_BINNING_CTRL_AUTO,
+	/* Centred crop of the output size */
+	IMX219_BINNING_CTRL_DISABLED,
+	IMX219_BINNING_CTRL_DIGITAL,
+	/* Reads two rows per line time, doubling the frame rate */
+	IMX219_BINNING_CTRL_ANALOG,
+};
+
+static const char *const imx219_binning_menu[] = {
+	"Auto", "Disabled", "2x2", "2x2 Analog"};
+
 /* regulator supplies */
 static const char *const imx219_supply_name[] = {
 	/* Supplies can be enabled in any order */
@@ -342,7 +359,10 @@ static const struct imx219_mode supported_modes[] = {
 	.vts_def = 1763,
 	},
 	{
-	/* 640x480 30fps mode */
+	/*
+	 * 640x480 30fps mode, 60fps when analog binned. With analog binning
+	 * the minimum vblank gives ~200fps on 2 lanes.
+	 */
 	.width   = 640,
 	.height  = 480,
 	.vts_def = 1763,
@@ -369,6 +389,7 @@ struct imx219 {
 	struct v4l2_ctrl *hflip;
 	struct v4l2_ctrl *vblank;
 	struct v4l2_ctrl *hblank;
+	struct v4l2_ctrl *binning;
 
 	/* Two or Four lanes */
 	u8 lanes;
@@ -399,6 +420,95 @@ static u32 imx219_get_format_code(struct imx219 *imx219, u32 code)
 	return imx219_mbus_formats[i];
 }
 
+static unsigned int imx219_get_bpp(u32 code)
+{
+	switch (code) {
+	case MEDIA_BUS_FMT_SRGGB8_1X8:
+	case MEDIA_BUS_FMT_SGRBG8_1X8:
+	case MEDIA_BUS_FMT_SGBRG8_1X8:
+	case MEDIA_BUS_FMT_SBGGR8_1X8:
+		return 8;
+
+	case MEDIA_BUS_FMT_SRGGB10_1X10:
+	case MEDIA_BUS_FMT_SGRBG10_1X10:
+	case MEDIA_BUS_FMT_SGBRG10_1X10:
+	case MEDIA_BUS_FMT_SBGGR10_1X10:
+	default:
+		return 10;
+	}
+}
+
+/* Binning register value for a crop to output size ratio */
+static u8 imx219_get_binning_mode(struct imx219 *imx219, u32 code,
+								  unsigned int ratio)
+{
+	if (ratio != 2) {
+		return IMX219_BINNING_NONE;
+	}
+
+	switch (imx219->binning->val) {
+	case IMX219_BINNING_CTRL_DIGITAL:
+		return IMX219_BINNING_X2;
+	case IMX219_BINNING_CTRL_ANALOG:
+		return IMX219_BINNING_X2_ANALOG;
+	case IMX219_BINNING_CTRL_AUTO:
+	default:
+		return (imx219_get_bpp(code) == 8) ? IMX219_BINNING_X2_ANALOG
+										   : IMX219_BINNING_X2;
+	}
+}
+
+/*
+ * Analog vertical binning reads two rows per line time, so lines come out
+ * at twice the rate of the unbinned modes.
+ */
+static unsigned int imx219_get_rate_factor(struct imx219            *imx219,
+										   struct v4l2_subdev_state *state)
+{
+	const struct v4l2_mbus_framefmt *format;
+	const struct v4l2_rect          *crop;
+
+	format = v4l2_subdev_state_get_format(state, 0);
+	crop   = v4l2_subdev_state_get_crop(state, 0);
+
+	return (imx219_get_binning_mode(imx219, format->code,
+									crop->height / format->height) ==
+			IMX219_BINNING_X2_ANALOG)
+			   ? 2
+			   : 1;
+}
+
+/*
+ * Use binning to maximize the crop rectangle size, unless disabled by the
+ * binning control, and centre it in the sensor.
+ */
+static void imx219_update_crop(struct imx219            *imx219,
+							   struct v4l2_subdev_state *state)
+{
+	const struct v4l2_mbus_framefmt *format;
+	struct v4l2_rect                *crop;
+	unsigned int                     bin_h, bin_v, binning;
+
+	format  = v4l2_subdev_state_get_format(state, 0);
+
+	bin_h   = min(IMX219_PIXEL_ARRAY_WIDTH / format->width, 2U);
+	bin_v   = min(IMX219_PIXEL_ARRAY_HEIGHT / format->height, 2U);
+	binning = min(bin_h, bin_v);
+	if (imx219->binning->val == IMX219_BINNING_CTRL_DISABLED) {
+		binning = 1;
+	}
+
+	crop         = v4l2_subdev_state_get_crop(state, 0);
+	crop->width  = format->width * binning;
+	crop->height = format->height * binning;
+	crop->left   = (IMX219_NATIVE_WIDTH - crop->width) / 2;
+	crop->top    = (IMX219_NATIVE_HEIGHT - crop->height) / 2;
+}
+
+static void imx219_update_mode_limits(struct imx219            *imx219,
+									  struct v4l2_subdev_state *state,
+									  const struct imx219_mode *mode);
+
 /* -----------------------------------------------------------------------------
  * Controls
  */
@@ -428,6 +538,18 @@ static int imx219_set_ctrl(struct v4l2_ctrl *ctrl)
 								 exposure_def);
 	}
 
+	/* Not on the handler setup at stream start, not to reset vblank */
+	if (ctrl->id == IMX219_CID_BINNING && ctrl->val != ctrl->cur.val) {
+		const struct imx219_mode *mode;
+
+		/* Binning changes the crop and so the readout timings */
+		mode = v4l2_find_nearest_size(
+			supported_modes, ARRAY_SIZE(supported_modes), width, height,
+			format->width, format->height);
+		imx219_update_crop(imx219, state);
+		imx219_update_mode_limits(imx219, state, mode);
+	}
+
 	/*
 	 * Applying V4L2 control value only happens
 	 * when power is up for streaming
@@ -458,6 +580,8 @@ static int imx219_set_ctrl(struct v4l2_ctrl *ctrl)
 		break;
 	case V4L2_CID_TEST_PATTERN_GREENB:
 		break;
+	case IMX219_CID_BINNING:
+		break;
 	default:
 		dev_info(&client->dev, "ctrl(id:0x%x,val:0x%x) is not handled\n",
 				 ctrl->id, ctrl->val);
@@ -474,11 +598,59 @@ static const struct v4l2_ctrl_ops imx219_ctrl_ops = {
 	.s_ctrl = imx219_set_ctrl,
 };
 
+static const struct v4l2_ctrl_config imx219_binning_ctrl = {
+	.ops  = &imx219_ctrl_ops,
+	.id   = IMX219_CID_BINNING,
+	.name = "Binning",
+	.type = V4L2_CTRL_TYPE_MENU,
+	.max  = ARRAY_SIZE(imx219_binning_menu) - 1,
+	.def  = IMX219_BINNING_CTRL_AUTO,
+	.qmenu = imx219_binning_menu,
+};
+
+/* Pixel rate of the unbinned modes, see imx219_get_rate_factor() */
 static unsigned long imx219_get_pixel_rate(struct imx219 *imx219)
 {
 	return (imx219->lanes == 2) ? IMX219_PIXEL_RATE : IMX219_PIXEL_RATE_4LANE;
 }
 
+/* Update the timing controls for a new mode, crop or binning */
+static void imx219_update_mode_limits(struct imx219            *imx219,
+									  struct v4l2_subdev_state *state,
+									  const struct imx219_mode *mode)
+{
+	unsigned long pixel_rate;
+	int           exposure_max;
+	int           exposure_def;
+	int           hblank;
+
+	/* Update limits and set FPS to default */
+	__v4l2_ctrl_modify_range(imx219->vblank, IMX219_VBLANK_MIN,
+							 IMX219_VTS_MAX - mode->height, 1,
+							 mode->vts_def - mode->height);
+	__v4l2_ctrl_s_ctrl(imx219->vblank, mode->vts_def - mode->height);
+	/* Update max exposure while meeting expected vblanking */
+	exposure_max = mode->vts_def - 4;
+	exposure_def = (exposure_max < IMX219_EXPOSURE_DEFAULT)
+					   ? exposure_max
+					   : IMX219_EXPOSURE_DEFAULT;
+	__v4l2_ctrl_modify_range(imx219->exposure, imx219->exposure->minimum,
+							 exposure_max, imx219->exposure->step,
+							 exposure_def);
+	/*
+	 * Currently PPL is fixed to IMX219_PPL_DEFAULT, so hblank
+	 * depends on mode->width only, and is not changeble in any
+	 * way other than changing the mode.
+	 */
+	hblank = IMX219_PPL_DEFAULT - mode->width;
+	__v4l2_ctrl_modify_range(imx219->hblank, hblank, hblank, 1, hblank);
+
+	pixel_rate = imx219_get_pixel_rate(imx219) *
+				 imx219_get_rate_factor(imx219, state);
+	__v4l2_ctrl_modify_range(imx219->pixel_rate, pixel_rate, pixel_rate, 1,
+							 pixel_rate);
+}
+
 /* Initialize control handlers */
 static int imx219_init_controls(struct imx219 *imx219)
 {
@@ -490,7 +662,7 @@ static int imx219_init_controls(struct imx219 *imx219)
 	int                                  i, ret;
 
 	ctrl_hdlr = &imx219->ctrl_handler;
-	ret       = v4l2_ctrl_handler_init(ctrl_hdlr, 12);
+	ret       = v4l2_ctrl_handler_init(ctrl_hdlr, 13);
 	if (ret) {
 		return ret;
 	}
@@ -567,6 +739,9 @@ static int imx219_init_controls(struct imx219 *imx219)
 		/* The "Solid color" pattern is white by default */
 	}
 
+	imx219->binning = v4l2_ctrl_new_custom(ctrl_hdlr, &imx219_binning_ctrl,
+										   NULL);
+
 	if (ctrl_hdlr->error) {
 		ret = ctrl_hdlr->error;
 		dev_err_probe(&client->dev, ret, "Control init failed\n");
@@ -607,49 +782,16 @@ static int imx219_set_framefmt(struct imx219            *imx219,
 {
 	const struct v4l2_mbus_framefmt *format;
 	const struct v4l2_rect          *crop;
-	unsigned int                     bpp;
 	u64                              bin_h, bin_v;
 	int                              ret = 0;
 
 	format = v4l2_subdev_state_get_format(state, 0);
 	crop   = v4l2_subdev_state_get_crop(state, 0);
 
-	switch (format->code) {
-	case MEDIA_BUS_FMT_SRGGB8_1X8:
-	case MEDIA_BUS_FMT_SGRBG8_1X8:
-	case MEDIA_BUS_FMT_SGBRG8_1X8:
-	case MEDIA_BUS_FMT_SBGGR8_1X8:
-		bpp = 8;
-		break;
-
-	case MEDIA_BUS_FMT_SRGGB10_1X10:
-	case MEDIA_BUS_FMT_SGRBG10_1X10:
-	case MEDIA_BUS_FMT_SGBRG10_1X10:
-	case MEDIA_BUS_FMT_SBGGR10_1X10:
-	default:
-		bpp = 10;
-		break;
-	}
-
-	switch (crop->width / format->width) {
-	case 1:
-	default:
-		bin_h = IMX219_BINNING_NONE;
-		break;
-	case 2:
-		bin_h = bpp == 8 ? IMX219_BINNING_X2_ANALOG : IMX219_BINNING_X2;
-		break;
-	}
-
-	switch (crop->height / format->height) {
-	case 1:
-	default:
-		bin_v = IMX219_BINNING_NONE;
-		break;
-	case 2:
-		bin_v = bpp == 8 ? IMX219_BINNING_X2_ANALOG : IMX219_BINNING_X2;
-		break;
-	}
+	bin_h  = imx219_get_binning_mode(imx219, format->code,
+									 crop->width / format->width);
+	bin_v  = imx219_get_binning_mode(imx219, format->code,
+									 crop->height / format->height);
 
 	return ret;
 }
@@ -692,9 +834,10 @@ static int imx219_start_streaming(struct imx219            *imx219,
 		goto err_rpm_put;
 	}
 
-	/* vflip and hflip cannot change during streaming */
+	/* vflip, hflip and binning cannot change during streaming */
 	__v4l2_ctrl_grab(imx219->vflip, true);
 	__v4l2_ctrl_grab(imx219->hflip, true);
+	__v4l2_ctrl_grab(imx219->binning, true);
 
 	return 0;
 
@@ -709,6 +852,7 @@ static void imx219_stop_streaming(struct imx219 *imx219)
 
 	__v4l2_ctrl_grab(imx219->vflip, false);
 	__v4l2_ctrl_grab(imx219->hflip, false);
+	__v4l2_ctrl_grab(imx219->binning, false);
 
 	pm_runtime_put(&client->dev);
 }
@@ -829,8 +973,6 @@ static int imx219_set_pad_format(struct v4l2_subdev        *sd,
 	struct imx219             *imx219 = to_imx219(sd);
 	const struct imx219_mode  *mode;
 	struct v4l2_mbus_framefmt *format;
-	struct v4l2_rect          *crop;
-	unsigned int               bin_h, bin_v, binning;
 
 	if(fmt->pad == IMX219_PAD_META)
 	{
@@ -847,45 +989,10 @@ static int imx219_set_pad_format(struct v4l2_subdev        *sd,
 	format       = v4l2_subdev_state_get_format(state, 0);
 	*format      = fmt->format;
 
-	/*
-	 * Use binning to maximize the crop rectangle size, and centre it in the
-	 * sensor.
-	 */
-	bin_h        = min(IMX219_PIXEL_ARRAY_WIDTH / format->width, 2U);
-	bin_v        = min(IMX219_PIXEL_ARRAY_HEIGHT / format->height, 2U);
-	binning      = min(bin_h, bin_v);
-
-	crop         = v4l2_subdev_state_get_crop(state, 0);
-	crop->width  = format->width * binning;
-	crop->height = format->height * binning;
-	crop->left   = (IMX219_NATIVE_WIDTH - crop->width) / 2;
-	crop->top    = (IMX219_NATIVE_HEIGHT - crop->height) / 2;
+	imx219_update_crop(imx219, state);
 
 	if (fmt->which == V4L2_SUBDEV_FORMAT_ACTIVE) {
-		int exposure_max;
-		int exposure_def;
-		int hblank;
-
-		/* Update limits and set FPS to default */
-		__v4l2_ctrl_modify_range(imx219->vblank, IMX219_VBLANK_MIN,
-								 IMX219_VTS_MAX - mode->height, 1,
-								 mode->vts_def - mode->height);
-		__v4l2_ctrl_s_ctrl(imx219->vblank, mode->vts_def - mode->height);
-		/* Update max exposure while meeting expected vblanking */
-		exposure_max = mode->vts_def - 4;
-		exposure_def = (exposure_max < IMX219_EXPOSURE_DEFAULT)
-						   ? exposure_max
-						   : IMX219_EXPOSURE_DEFAULT;
-		__v4l2_ctrl_modify_range(imx219->exposure, imx219->exposure->minimum,
-								 exposure_max, imx219->exposure->step,
-								 exposure_def);
-		/*
-		 * Currently PPL is fixed to IMX219_PPL_DEFAULT, so hblank
-		 * depends on mode->width only, and is not changeble in any
-		 * way other than changing the mode.
-		 */
-		hblank = IMX219_PPL_DEFAULT - mode->width;
-		__v4l2_ctrl_modify_range(imx219->hblank, hblank, hblank, 1, hblank);
+		imx219_update_mode_limits(imx219, state, mode);
 	}
 
 	return 0;
@@ -46,6 +46,32 @@ enum hub_ret_code {
 	HUB_FAILURE_SETUP_APPDATA_CB,
 	HUB_FAILURE_CAPTURE_RESCALED_IMAGE,
 	HUB_FAILURE_SEND_RESUME_PIPELINE,
+	HUB_FAILURE_ASYNC_XFER,
+	HUB_FAILURE_GPIO_EVENT_STATS,
+	HUB_FAILURE_CONDVAR_TIMEDOUT,
+	HUB_FAILURE_STATS,
+	HUB_FAILURE_TRACE,
+	HUB_FAILURE_SUBSCRIBE_APPDATA,
+	HUB_FAILURE_PIPELINE_STATS,
+	HUB_FAILURE_APP_COMMAND,
+	HUB_FAILURE_NETWORK_RESIDENCY,
+	HUB_FAILURE_INFERENCE_RATE,
+	HUB_FAILURE_SCALER_CONFIG,
+	HUB_FAILURE_IMAGE_STATS,
+	HUB_FAILURE_DAEMON,
+	HUB_FAILURE_SHM_RING,
+	HUB_FAILURE_BUS_CAPTURE,
+	HUB_FAILURE_GOVERNOR,
+	HUB_FAILURE_UPGRADE_FIRMWARE,
+	HUB_FAILURE_GARD_TIME,
+	HUB_FAILURE_POOL,
+	HUB_FAILURE_WAIT_ANY,
+	HUB_FAILURE_HOST_INFERENCE,
+	HUB_FAILURE_NETWORK_SWAP,
+	HUB_FAILURE_APP_DATA_COALESCING,
+	HUB_FAILURE_LOG,
+	HUB_FAILURE_RECORDING,
+	HUB_FAILURE_RELOAD_CONFIG,
 };
 
 /**
@@ -82,6 +108,14 @@ typedef void *(*hub_cb_handler_t)(void    *p_cb_params,
 								  void    *p_buffer,
 								  uint32_t size);
 
+/**
+ * Prototype of the completion callback for asynchronous data transfers.
+ *
+ * ret is HUB_SUCCESS when the transfer completed successfully, else the
+ * failure code of the corresponding synchronous call.
+ */
+typedef void (*hub_xfer_done_cb_t)(void *p_cb_ctx, enum hub_ret_code ret);
+
 /**
  * The following enum captures all the possible image formats. The binary image
  * data captured from the camera and sent to HUB is crafted in one of these
@@ -116,16 +150,61 @@ enum hub_image_formats {
 };
 
 /**
- * Context for image operations
+ * The following enum captures the encodings of the image data sent to HUB by
+ * GARD. Each row of each plane of the image is encoded on its own, the planes
+ * one after the other. hub_decode_rescaled_image() decodes them.
+ *
+ * The enum is a copy of enum image_codecs in gard_hub_iface.h and needs to be
+ * kept in sync.
+ */
+enum hub_image_codecs {
+	/* The samples as they are. */
+	HUB_IMAGE_CODEC__NONE      = 0x0u,
+
+	/* PackBits run-length of the samples. */
+	HUB_IMAGE_CODEC__RLE       = 0x1u,
+
+	/* PackBits of the difference of each sample to the one on its left. */
+	HUB_IMAGE_CODEC__DELTA_RLE = 0x2u,
+
+	/* The 4 MSBs of each sample, 2 samples a byte, the first in the MSBs. */
+	HUB_IMAGE_CODEC__PACK4     = 0x3u,
+};
+
+/**
+ * Context for image operations. no_pause is set by the caller to have GARD
+ * copy the image out instead of pausing its pipeline, pipeline_paused is set
+ * by HUB if GARD paused it anyway.
+ *
+ * With no_pause, the caller can also ask for only the part of the image at
+ * roi_x, roi_y of roi_width x roi_height pixels (0 for the whole width or
+ * height), one pixel in decimation kept in both directions (0 or 1 for all),
+ * and encoded with codec. h_size and v_size are then the ones of that part,
+ * image_buffer_size the one of the encoded image, and codec is set to the
+ * encoding GARD actually used.
+ *
+ * frame_seq and capture_time are set by HUB to the sequence number of the
+ * image and the GARD time its capture started at, in GARD timer ticks; see
+ * hub_sync_gard_clock to map it to the host clock.
  */
 struct hub_img_ops_ctx {
 	uint8_t                camera_id;
+	uint8_t                no_pause;
+	uint8_t                pipeline_paused;
 	void                  *p_image_buffer;
 	uint32_t               image_buffer_size;
 	uint32_t               image_buffer_address;
 	uint16_t               h_size;
 	uint16_t               v_size;
 	enum hub_image_formats image_format;
+	uint16_t               roi_x;
+	uint16_t               roi_y;
+	uint16_t               roi_width;
+	uint16_t               roi_height;
+	uint8_t                decimation;
+	enum hub_image_codecs  codec;
+	uint32_t               frame_seq;
+	uint64_t               capture_time;
 };
 
 /******************************************************************************
@@ -155,6 +234,20 @@ enum hub_ret_code
  */
 enum hub_ret_code hub_discover_gards(hub_handle_t hub);
 
+/* Execution models of the GPIO app data path */
+enum hub_gpio_exec_model {
+	/* A monitor thread plus one worker thread per GPIO line (default) */
+	HUB_GPIO_EXEC_THREAD_PER_LINE = 0,
+	/* A single epoll reactor thread plus a fixed pool of workers */
+	HUB_GPIO_EXEC_REACTOR,
+};
+
+/* Options for hub_init_with_options() */
+struct hub_init_options {
+	enum hub_gpio_exec_model gpio_exec_model;
+	uint32_t                 gpio_pool_size; /* Reactor only, 0 for default */
+};
+
 /**
  * hub_init is a HUB initialization function.
  *
@@ -170,12 +263,65 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub);
  */
 enum hub_ret_code hub_init(hub_handle_t hub);
 
+/**
+ * hub_init_with_options is hub_init with the GPIO execution model given by
+ * the caller instead of "gpio_exec_model" / "gpio_pool_size" in
+ * host_config.json.
+ *
+ * @param: hub is a HUB handle
+ * @param: p_options are the init options, NULL for the host_config ones
+ *
+ * @return: hub_ret_code
+		HUB_SUCCESS on success
+		HUB_FAILURE_INIT on failure
+ */
+enum hub_ret_code
+	hub_init_with_options(hub_handle_t                   hub,
+						  const struct hub_init_options *p_options);
+
 /* Get the number of GARDS discovered, given a HUB handle */
 uint32_t hub_get_num_gards(hub_handle_t hub);
 
 /* Given a HUB handle, get the GARD handle corresponding to gard_num */
 gard_handle_t hub_get_gard_handle(hub_handle_t hub, uint8_t gard_num);
 
+/* GARD link events, see hub_set_gard_event_cb() */
+enum hub_gard_event {
+	/* GARD stopped answering, or its USB device left */
+	HUB_GARD_EVENT_LOST = 0,
+	/* GARD is back on the same busses, its GARD handle still valid */
+	HUB_GARD_EVENT_REATTACHED,
+};
+
+typedef void (*hub_gard_event_cb_t)(void               *p_cb_ctx,
+									gard_handle_t       gard,
+									enum hub_gard_event event);
+
+/**
+ * hub_set_gard_event_cb sets the callback told when a GARD is lost and
+ * re-attached. Must be called before hub_init().
+ *
+ * From hub_init() to hub_fini(), a health monitor thread watches the GARDs:
+ * USB device departures (where libusb has hotplug support) and, every
+ * "health_probe_ms" of host_config.json (0 or absent: never), a
+ * GARD_DISCOVERY round trip on the command bus. A lost GARD is discovered
+ * again on its busses until it answers with the same device ID, e.g. once
+ * its firmware has reset or its USB device has re-enumerated. App data
+ * callbacks and subscriptions are kept across; transfers fail meanwhile.
+ *
+ * The callback runs in the health monitor thread.
+ *
+ * @param: hub is the HUB handle
+ * @param: cb is the callback, NULL for none
+ * @param: p_cb_ctx is an opaque callback context
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INIT if called after hub_init()
+ */
+enum hub_ret_code hub_set_gard_event_cb(hub_handle_t        hub,
+										hub_gard_event_cb_t cb,
+										void               *p_cb_ctx);
+
 /**
  * De-initialize the HUB library
  *
@@ -185,6 +331,50 @@ gard_handle_t hub_get_gard_handle(hub_handle_t hub, uint8_t gard_num);
  */
 enum hub_ret_code hub_fini(hub_handle_t hub);
 
+/* Room for the names of the fields hub_reload_config() could not change */
+#define HUB_RELOAD_RESTART_FIELDS_LEN (512)
+
+/* Outcome of hub_reload_config() */
+struct hub_reload_report {
+	uint32_t num_applied; /* Changed fields now in use */
+	uint32_t num_restart; /* Changed fields kept as they were */
+	/* Names of the latter, e.g. "busses[1].uart_rx_ring_size, gpio_pool_size",
+	 * truncated if they do not fit */
+	char     restart_fields[HUB_RELOAD_RESTART_FIELDS_LEN];
+};
+
+/**
+ * hub_reload_config parses a host config file again and applies what
+ * changed from the running configuration without restarting the session:
+ * * per bus: xfer_chunk_size, mtu_size, mtu_window, data_crc,
+ *   app_data_batch, cmd_pipelining, uart_flush_policy, uart_read_timeout_ms
+ *   and uart_probe_timeout_ms, taken by the next transaction on the bus,
+ * * per bus: uart_target_baudrate, switched to at once with
+ *   SET_UART_PARAMETERS, as after discovery (0 switches back to
+ *   uart_baudrate), GARD staying at the current rate if it NAKs,
+ * * health_probe_ms and clock_sync_ms, from the next health monitor tick,
+ * * log_level ("err", "warn", "info" or "dbg"), see hub_log_set_level(),
+ * * thread_props, applied to the running threads of each class except for
+ *   stack_size, which only applies to threads created from now on.
+ * Any other change, e.g. a bus added or pointing at another device,
+ * uart_baudrate, uart_rx_ring_size, usb_burst_size or gpio_exec_model, is
+ * logged and reported, and only takes effect after hub_fini() and a new
+ * hub_preinit(). GARD json files are not reloaded.
+ *
+ * Not to be called concurrently with itself or hub_fini().
+ *
+ * @param: hub is the HUB handle, from hub_preinit() on
+ * @param: p_config is the path to the host config file
+ * @param: p_report is filled with the outcome, may be NULL
+ *
+ * @return: HUB_SUCCESS on success, even if some fields need a restart
+ *			HUB_FAILURE_RELOAD_CONFIG if the file cannot be parsed, or a
+ *			GARD is lost switching its baud rate
+ */
+enum hub_ret_code hub_reload_config(hub_handle_t              hub,
+									const char               *p_config,
+									struct hub_reload_report *p_report);
+
 /******************************************************************************
  * HUB data movement APIs
  ******************************************************************************/
@@ -204,6 +394,26 @@ enum hub_ret_code hub_read_gard_reg(gard_handle_t p_gard_handle,
 									uint32_t      reg_addr,
 									uint32_t     *p_value);
 
+/**
+ * Write a list of 32-bit values to register addresses in GARD memory
+ * represented by the gard handle, in the order listed. Up to
+ * GARD_HUB_MAX_REGS_PER_CMD registers go in one bus round-trip.
+ */
+enum hub_ret_code hub_write_gard_regs(gard_handle_t   p_gard_handle,
+									  const uint32_t *p_reg_addrs,
+									  const uint32_t *p_values,
+									  uint32_t        num_regs);
+
+/**
+ * Read the 32-bit values of a list of register addresses in GARD memory
+ * represented by the gard handle. Up to GARD_HUB_MAX_REGS_PER_CMD
+ * registers go in one bus round-trip.
+ */
+enum hub_ret_code hub_read_gard_regs(gard_handle_t   p_gard_handle,
+									 const uint32_t *p_reg_addrs,
+									 uint32_t       *p_values,
+									 uint32_t        num_regs);
+
 /**
  * Send a data buffer of a specified size from HUB to an
  * address in the GARD memory map represented by the gard handle.
@@ -222,13 +432,84 @@ enum hub_ret_code hub_send_data_to_gard(gard_handle_t p_gard_handle,
  * say, after hub_capture_rescaled_image_from_gard() is called, then
  * HUB / Host Applicaiton should also call hub_send_resume_pipeline() after
  * receiving the image content to signal GARD FW to resume the paused AI
- * workload.
+ * workload, unless the image was captured with no_pause, see
+ * hub_capture_rescaled_image_from_gard().
  */
 enum hub_ret_code hub_recv_data_from_gard(gard_handle_t p_gard_handle,
 										  void         *p_buffer,
 										  uint32_t      addr,
 										  uint32_t      count);
 
+/**
+ * Queue a send of a data buffer of a specified size from HUB to an address in
+ * the GARD memory map represented by the gard handle, and return without
+ * waiting for the transfer to complete.
+ *
+ * cb_handler is called from HUB's USB event thread, or from the worker thread
+ * of an I2C / UART data bus, once the transfer is done. The buffer must remain
+ * valid until then. I2C / UART transfers run one after the other, in chunks of
+ * the bus's xfer_chunk_size, so that register accesses and commands on the
+ * same bus are not held up behind a large upload.
+ */
+enum hub_ret_code hub_send_data_to_gard_async(gard_handle_t      p_gard_handle,
+											  const void        *p_buffer,
+											  uint32_t           addr,
+											  uint32_t           count,
+											  hub_xfer_done_cb_t cb_handler,
+											  void              *p_cb_ctx);
+
+/**
+ * Queue a receive of data of a specified size from an address in the GARD
+ * memory map represented by the gard handle, and return without waiting for
+ * the transfer to complete.
+ *
+ * cb_handler is called from HUB's USB event thread, or from the worker thread
+ * of an I2C / UART data bus, once the buffer is filled. The callback may queue
+ * further asynchronous transfers, but must not issue blocking HUB calls on the
+ * same GARD.
+ */
+enum hub_ret_code hub_recv_data_from_gard_async(gard_handle_t      p_gard_handle,
+												void              *p_buffer,
+												uint32_t           addr,
+												uint32_t           count,
+												hub_xfer_done_cb_t cb_handler,
+												void              *p_cb_ctx);
+
+/**
+ * Prototype of the callback of hub_recv_data_from_gard_progressive(), called
+ * with the offset and length in the buffer of each chunk received.
+ */
+typedef void (*hub_recv_chunk_cb_t)(void    *p_cb_ctx,
+									uint32_t offset,
+									uint32_t length);
+
+/**
+ * Receive data of a specified size from an address in the GARD memory map
+ * represented by the gard handle, in chunks of chunk_size bytes (0 for a
+ * default of 64 KiB), and call cb_handler for each chunk as soon as it is in
+ * the buffer, e.g. to convert or ship the rows of an image received after
+ * hub_capture_rescaled_image_from_gard() while the next ones come in.
+ *
+ * cb_handler is called from the calling thread, in order of the chunks,
+ * while the next chunks are received in the background. It must not call
+ * hub_wait_for_async_xfers() on the same GARD. The call returns once the
+ * last chunk is handed over, or on the first chunk that cannot be received.
+ */
+enum hub_ret_code
+	hub_recv_data_from_gard_progressive(gard_handle_t       p_gard_handle,
+										void               *p_buffer,
+										uint32_t            addr,
+										uint32_t            count,
+										uint32_t            chunk_size,
+										hub_recv_chunk_cb_t cb_handler,
+										void               *p_cb_ctx);
+
+/**
+ * Wait until all asynchronous transfers queued on the data bus of the GARD
+ * represented by the gard handle have completed.
+ */
+enum hub_ret_code hub_wait_for_async_xfers(gard_handle_t p_gard_handle);
+
 /******************************************************************************
  * HUB sensor data collection APIs
  * Currently, only the LSCC_SOM on the Carrier board is supported
@@ -262,6 +543,288 @@ uint32_t hub_get_energy_from_onboard_sensors(
 	struct hub_energy_sensor_values *p_values,
 	uint8_t                          num_sensors);
 
+/* Sensors of each kind on the SOM, with sensor IDs 1 to HUB_SOM_NUM_SENSORS */
+#define HUB_SOM_NUM_SENSORS (2)
+
+/* All the SOM sensors, read together by the sampler */
+struct hub_som_sensor_sample {
+	uint64_t                        timestamp_ns; /* CLOCK_MONOTONIC */
+	/* Indexed by sensor ID - 1 */
+	float                           temperature[HUB_SOM_NUM_SENSORS];
+	struct hub_energy_sensor_values energy[HUB_SOM_NUM_SENSORS];
+	/* Bit (sensor ID - 1) is set if the sensor was read */
+	uint8_t                         temperature_valid;
+	uint8_t                         energy_valid;
+};
+
+/**
+ * hub_som_sampler_start starts a thread reading all the SOM sensors every
+ * period_ms, and keeping the latest 256 samples. While it runs,
+ * hub_get_temperature_from_onboard_sensors() and
+ * hub_get_energy_from_onboard_sensors() return the latest sample and do not
+ * go on the bus, so polling them does not hold up the GARD transfers on the
+ * I2C bus. Each sensor is read in one I2C transaction, holding the bus for
+ * as short as it can.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: period_ms is the time between samples, 10 ms at least
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SENSOR_ERROR if there is no I2C bus, the sampler
+ *			already runs or it could not be started
+ */
+enum hub_ret_code hub_som_sampler_start(hub_handle_t hub, uint32_t period_ms);
+
+/**
+ * hub_som_sampler_stop stops the sampler; the sensor reads go on the bus
+ * again. hub_fini() stops a sampler left running. Not to be called while
+ * other threads read the sensors.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success, or if no sampler runs
+ *			HUB_FAILURE_SENSOR_ERROR on an invalid handle
+ */
+enum hub_ret_code hub_som_sampler_stop(hub_handle_t hub);
+
+/**
+ * hub_get_som_sensor_history copies the latest samples of the sampler,
+ * oldest first. It does not wait for the bus or the sampler.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_samples is filled with the samples
+ * @param: max_samples is the most samples to copy
+ *
+ * @return: number of samples copied, 0 if no sampler runs
+ */
+uint32_t hub_get_som_sensor_history(hub_handle_t                  hub,
+									struct hub_som_sensor_sample *p_samples,
+									uint32_t                      max_samples);
+
+/**
+ * hub_get_som_telemetry reads every temperature, voltage, current and power
+ * of the SOM sensors in one call, instead of one
+ * hub_get_temperature_from_onboard_sensors() and one
+ * hub_get_energy_from_onboard_sensors() call. Each sensor is read in one I2C
+ * transaction. While the sampler runs, its latest sample is returned without
+ * going on the bus. Sensors which could not be read have
+ * HUB_INVALID_SENSOR_VALUE values and their valid bit cleared.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_sample is filled with the sample
+ *
+ * @return: HUB_SUCCESS if at least one sensor was read
+ *			HUB_FAILURE_SENSOR_ERROR if there is no I2C bus or no sensor
+ *			could be read
+ */
+enum hub_ret_code hub_get_som_telemetry(hub_handle_t                  hub,
+										struct hub_som_sensor_sample *p_sample);
+
+/**
+ * Limits of the thermal and power governor. Temperatures are of the hottest
+ * SOM sensor, power is the sum of the SOM energy sensors. Rates are in images
+ * per 1000 s, as with HUB_INFERENCE_RATE_TARGET_FPS.
+ */
+struct hub_governor_cfg {
+	float    temp_high_c;  /* Throttle above this */
+	float    temp_low_c;   /* Step back up below this */
+	float    power_high_w; /* Throttle above this, 0 to not look at power */
+	float    power_low_w;  /* Step back up below this */
+	uint32_t max_mfps;     /* Throttling ends once back up to this rate */
+	uint32_t min_mfps;     /* Lowest rate throttled down to */
+	uint32_t step_percent; /* Rate change of a step */
+	uint32_t step_ms;      /* Time between two steps, 100 ms at least */
+};
+
+/* What the governor does, see hub_governor_get_state() */
+struct hub_governor_state {
+	uint8_t  is_throttled;
+	uint32_t target_mfps;      /* Rate the GARDs are held to, if throttled */
+	float    temperature_c;    /* Of the latest sample */
+	float    power_w;          /* Of the latest sample */
+	uint32_t num_steps_down;
+	uint32_t num_steps_up;
+	uint32_t num_set_failures; /* INFERENCE_RATE a GARD did not take */
+};
+
+/**
+ * hub_governor_start starts a thread keeping the SOM within thermal and
+ * power limits by throttling the inference rate of all the GARDs, so that
+ * their throughput goes down in steps instead of the hardware hitting its
+ * thermal limits. It looks at the samples of hub_som_sampler_start(), which
+ * must run.
+ *
+ * Every step_ms, above a high limit the rate the GARDs run their ML engine at
+ * is lowered by step_percent, down to min_mfps, with
+ * HUB_INFERENCE_RATE_TARGET_FPS; throttling starts from the rate the GARDs
+ * run at. Below both low limits the rate is raised by step_percent; once it
+ * is back up to max_mfps, the GARDs are given back the policy they had when
+ * the governor started. In between, the rate is held.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_cfg are the limits
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GOVERNOR if the limits are invalid, the sampler does
+ *			not run, the governor already runs or it could not be started
+ */
+enum hub_ret_code hub_governor_start(hub_handle_t                   hub,
+									 const struct hub_governor_cfg *p_cfg);
+
+/**
+ * hub_governor_stop stops the governor and gives the GARDs back the policy
+ * they had when it started. hub_fini() stops a governor left running.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success, or if no governor runs
+ *			HUB_FAILURE_GOVERNOR on an invalid handle, or if the policy of a
+ *			GARD could not be set back
+ */
+enum hub_ret_code hub_governor_stop(hub_handle_t hub);
+
+/**
+ * hub_governor_get_state reads what the governor does.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_state is filled with the state
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GOVERNOR if no governor runs
+ */
+enum hub_ret_code hub_governor_get_state(hub_handle_t               hub,
+										 struct hub_governor_state *p_state);
+
+/******************************************************************************
+ * Multi-GARD dispatch APIs
+ ******************************************************************************/
+/* Opaque handle to a pool of GARDs, see hub_pool_create() */
+typedef void *hub_pool_handle_t;
+
+struct hub_pool_cfg {
+	uint32_t gard_mask;         /* Bit n for GARD n, 0 for all the GARDs */
+	uint32_t result_size;       /* Largest App Module result of an input */
+	uint32_t max_in_flight;     /* Inputs a GARD is given at once, 1 at least */
+	uint32_t submit_timeout_ms; /* Longest wait of hub_pool_submit() for room */
+};
+
+/* An input to run on one GARD of a pool */
+struct hub_pool_input {
+	const void *p_data;            /* Sent to GARD first, NULL for nothing */
+	uint32_t    size;              /* Bytes of p_data */
+	uint32_t    gard_addr;         /* Where p_data goes in GARD memory */
+	uint8_t     command_id;        /* App Module command then sent, 0: none */
+	const void *p_command_body;    /* Its body, see hub_send_app_command() */
+	uint32_t    command_body_size;
+};
+
+/**
+ * Prototype of the completion callback of an input submitted to a pool.
+ *
+ * ret is HUB_SUCCESS with the App Module result of the input, of result_size
+ * bytes at p_result, valid for the time of the call. Otherwise the input
+ * could not be run and no result comes.
+ */
+typedef void (*hub_pool_done_cb_t)(void             *p_cb_ctx,
+								   uint64_t          seq,
+								   gard_handle_t     gard,
+								   enum hub_ret_code ret,
+								   const void       *p_result,
+								   uint32_t          result_size);
+
+/* What a pool does with one of its GARDs, see hub_pool_get_gard_state() */
+struct hub_pool_gard_state {
+	uint8_t  in_pool;
+	uint8_t  is_available;   /* Neither lost nor failing to take inputs */
+	uint32_t num_in_flight;  /* Inputs given and not completed */
+	uint64_t avg_latency_ns; /* From submission to result, moving average */
+	uint64_t num_submitted;
+	uint64_t num_completed;
+	uint64_t num_failed;
+	uint64_t num_unmatched;  /* Results that came with no input in flight */
+};
+
+/**
+ * hub_pool_create makes a pool of the GARDs of a HUB, to share host-fed
+ * inference between them, see hub_pool_submit(). There is one pool per HUB,
+ * from its creation to hub_fini().
+ *
+ * The pool sets up the app data callback of each of its GARDs, see
+ * hub_setup_appdata_cb(): an App Module result from a GARD completes the
+ * oldest input in flight on it. The app must not set up app data callbacks
+ * of its own on them, nor run their camera pipeline meanwhile.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_cfg is the configuration of the pool
+ * @param: p_pool is filled with the pool handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_POOL if the configuration is invalid, the HUB has a
+ *			pool already or the app data callbacks could not be set up
+ */
+enum hub_ret_code hub_pool_create(hub_handle_t               hub,
+								  const struct hub_pool_cfg *p_cfg,
+								  hub_pool_handle_t         *p_pool);
+
+/**
+ * hub_pool_submit runs an input on the least loaded GARD of a pool: of the
+ * GARDs neither lost nor failing to take inputs, the one with the fewest
+ * inputs in flight, then with the shortest latency. The input is sent from
+ * the calling thread, then cb is called once its result has come, from an
+ * app data thread.
+ *
+ * Callbacks are called one at a time and in the order of the submissions,
+ * whatever the GARD that ran an input, so a result waits for those of the
+ * inputs submitted before it.
+ *
+ * Waits up to submit_timeout_ms for a GARD to have fewer than max_in_flight
+ * inputs, and for fewer than HUB_POOL_MAX_JOBS inputs to be in the pool.
+ *
+ * @param: pool is the pool handle
+ * @param: p_input is the input
+ * @param: cb is the completion callback
+ * @param: p_cb_ctx is an opaque callback context
+ * @param: p_seq is filled with the sequence number of the input, NULL if
+ *         not needed
+ *
+ * @return: HUB_SUCCESS if the input was submitted, cb is then always called
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if no GARD had room in time
+ *			HUB_FAILURE_POOL on invalid arguments
+ */
+enum hub_ret_code hub_pool_submit(hub_pool_handle_t            pool,
+								  const struct hub_pool_input *p_input,
+								  hub_pool_done_cb_t           cb,
+								  void                        *p_cb_ctx,
+								  uint64_t                    *p_seq);
+
+/**
+ * hub_pool_drain waits for the callbacks of all the inputs submitted to a
+ * pool to have been called.
+ *
+ * @param: pool is the pool handle
+ * @param: timeout_ms is the longest wait
+ *
+ * @return: HUB_SUCCESS once drained
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if inputs are still in flight
+ *			HUB_FAILURE_POOL on an invalid handle
+ */
+enum hub_ret_code hub_pool_drain(hub_pool_handle_t pool, uint32_t timeout_ms);
+
+/**
+ * hub_pool_get_gard_state reads what a pool does with one of the GARDs.
+ *
+ * @param: pool is the pool handle
+ * @param: gard_num is the GARD number, as for hub_get_gard_handle()
+ * @param: p_state is filled with the state
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_POOL on invalid arguments
+ */
+enum hub_ret_code
+	hub_pool_get_gard_state(hub_pool_handle_t           pool,
+							uint32_t                    gard_num,
+							struct hub_pool_gard_state *p_state);
+
 /******************************************************************************
  * App Metadata Streaming Feature related APIs
  ******************************************************************************/
@@ -311,6 +874,159 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 									   void            *p_buffer,
 									   uint32_t         size);
 
+/* Most buffers in a ring given to hub_setup_appdata_ring_cb() */
+#define HUB_APPDATA_RING_MAX_BUFFERS (16)
+
+/**
+ * hub_setup_appdata_ring_cb is a zero-copy variant of hub_setup_appdata_cb
+ * with a ring of num_buffers user buffers of size bytes each.
+ *
+ * Notes:
+ * 1. The buffer passed to a callback with a non-zero size is held by the
+ * user until it is handed back with hub_release_appdata_buffer(). It is not
+ * written by HUB in the meantime, so the callback need not copy it out.
+ * 2. HUB fills the buffers in order while the user holds earlier ones. If
+ * every buffer is held, HUB waits for a release. GPIO events that arrive in
+ * the meantime stay pending (see hub_get_gpio_event_stats()).
+ * 3. A callback with size 0 reports an error, and its buffer is not held.
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: cb_handler is a callback function to be called, the API for this
+ * function is defined as a hub_cb_handler_t datatype
+ * @param: p_cb_ctx is an opaque callback context (can be used by the user-app)
+ * @param: pp_buffers is an array of num_buffers user-allocated buffers
+ * @param: num_buffers is 1 to HUB_APPDATA_RING_MAX_BUFFERS
+ * @param: size is the size of each buffer, in bytes
+ *
+ * @return: HUB_SUCCESS on successful registration
+ *			HUB_FAILURE_SETUP_APPDATA_CB on failure
+ */
+enum hub_ret_code hub_setup_appdata_ring_cb(gard_handle_t    gard,
+											hub_cb_handler_t cb_handler,
+											void            *p_cb_ctx,
+											void *const     *pp_buffers,
+											uint32_t         num_buffers,
+											uint32_t         size);
+
+/**
+ * hub_release_appdata_buffer hands a buffer received in an appdata ring
+ * callback back to HUB, to be filled again.
+ *
+ * @param: gard is the GARD handle the ring was set up on
+ * @param: p_buffer is the buffer passed to the callback
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SETUP_APPDATA_CB if p_buffer is not a held ring buffer
+ */
+enum hub_ret_code hub_release_appdata_buffer(gard_handle_t gard,
+											 void         *p_buffer);
+
+/**
+ * hub_setup_appdata_wait_any sets up an appdata ring on a GARD, as
+ * hub_setup_appdata_ring_cb() does, whose results are queued for
+ * hub_wait_any() instead of being handed to a callback. With every GARD set
+ * up so, a single app thread serves all of them.
+ *
+ * Notes:
+ * 1. Results of all the GARDs of a HUB go to the same queue, in the order
+ * they were received.
+ * 2. A buffer returned by hub_wait_any() is held until it is handed back
+ * with hub_release_appdata_buffer(), as with hub_setup_appdata_ring_cb().
+ * 3. Failed app data fetches are not queued, see hub_get_stats().
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: pp_buffers is an array of num_buffers user-allocated buffers
+ * @param: num_buffers is 1 to HUB_APPDATA_RING_MAX_BUFFERS
+ * @param: size is the size of each buffer, in bytes
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SETUP_APPDATA_CB on failure
+ */
+enum hub_ret_code hub_setup_appdata_wait_any(gard_handle_t gard,
+											 void *const  *pp_buffers,
+											 uint32_t      num_buffers,
+											 uint32_t      size);
+
+/**
+ * hub_wait_any takes the oldest result queued by any GARD set up with
+ * hub_setup_appdata_wait_any(), waiting up to timeout_ms for one.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: timeout_ms is how long to wait, 0 not to wait
+ * @param: p_gard is filled with the GARD the result is from
+ * @param: pp_buffer is filled with the ring buffer holding the result
+ * @param: p_size is filled with the size of the result, NULL if not needed
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if no result came in time
+ *			HUB_FAILURE_WAIT_ANY on invalid arguments, or if no GARD is set up
+ */
+enum hub_ret_code hub_wait_any(hub_handle_t   hub,
+							   uint32_t       timeout_ms,
+							   gard_handle_t *p_gard,
+							   void         **pp_buffer,
+							   uint32_t      *p_size);
+
+/**
+ * hub_get_wait_any_fd gets a file descriptor that polls readable as long as
+ * hub_wait_any() has a result queued, to wait for results from an event loop
+ * with poll(), select() or epoll. The fd is owned by HUB, do not read it or
+ * close it.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_fd is filled with the file descriptor
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_WAIT_ANY if no GARD is set up with
+ *			hub_setup_appdata_wait_any()
+ */
+enum hub_ret_code hub_get_wait_any_fd(hub_handle_t hub, int *p_fd);
+
+/**
+ * hub_subscribe_appdata subscribes to the App Module data of a GARD. GARD
+ * then pushes every result to HUB on its own as soon as it is ready, instead
+ * of raising a GPIO line and waiting for HUB to fetch it, which saves a
+ * command round-trip per result.
+ *
+ * Notes:
+ * 1. Only GARDs with a UART data bus, or a UART control bus next to a USB
+ * data bus, can push. A background receive ring ("uart_rx_ring_size" in
+ * host_config.json) is recommended.
+ * 2. cb_handler is called from a HUB thread with p_buffer and the size of
+ * each result, as for hub_setup_appdata_cb(). p_buffer is not written again
+ * until the callback returns.
+ * 3. HUB queues a few results while the callback runs. Results that find
+ * the queue full, or that are larger than size, are dropped.
+ * 4. Do not use it together with hub_setup_appdata_cb() on the same GARD.
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: cb_handler is a callback function to be called, the API for this
+ * function is defined as a hub_cb_handler_t datatype
+ * @param: p_cb_ctx is an opaque callback context (can be used by the user-app)
+ * @param: p_buffer is a user-allocated buffer of size bytes
+ * @param: size is the largest result to take, in bytes
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+enum hub_ret_code hub_subscribe_appdata(gard_handle_t    gard,
+										hub_cb_handler_t cb_handler,
+										void            *p_cb_ctx,
+										void            *p_buffer,
+										uint32_t         size);
+
+/**
+ * hub_unsubscribe_appdata ends a subscription made with
+ * hub_subscribe_appdata(). The callback is not called anymore once it has
+ * returned. hub_fini() ends any subscription left.
+ *
+ * @param: gard is the GARD handle the subscription was made on
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+enum hub_ret_code hub_unsubscribe_appdata(gard_handle_t gard);
+
 /**
  * hub_get_appdata_on_event_handler monitors GPIO event and
  * gets application data from GARD on event occurence.
@@ -360,6 +1076,80 @@ int64_t hub_get_appdata_on_event_handler(gard_handle_t p_gard_handle,
  */
 int32_t hub_setup_appdata_cb_for_pyhub(gard_handle_t gard);
 
+/**
+ * Counters of GPIO events seen on a line monitored for app data.
+ *
+ * - events: rising edges seen by the GPIO monitor
+ * - delivered: events handed to the app data worker
+ * - coalesced: events that came while an earlier one was still pending;
+ *   these are queued, not lost
+ * - dropped: events discarded because HUB_GPIO_MAX_PENDING_EVENTS were
+ *   already pending
+ * - pending: events queued and not yet handed to the worker
+ * - last_event_ns: kernel timestamp of the last event, in nanoseconds
+ */
+struct hub_gpio_event_stats {
+	uint64_t events;
+	uint64_t delivered;
+	uint64_t coalesced;
+	uint64_t dropped;
+	uint32_t pending;
+	uint64_t last_event_ns;
+};
+
+/**
+ * hub_get_gpio_event_stats gets a snapshot of the event counters of a GPIO
+ * line set up with hub_setup_appdata_cb() or
+ * hub_setup_appdata_cb_for_pyhub().
+ *
+ * @param: gard is the GARD handle
+ * @param: line_offset is the GPIO line offset
+ * @param: p_stats is filled with the counters
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GPIO_EVENT_STATS on failure
+ */
+enum hub_ret_code
+	hub_get_gpio_event_stats(gard_handle_t                gard,
+							 int                          line_offset,
+							 struct hub_gpio_event_stats *p_stats);
+
+/**
+ * Timestamps along the way of one GPIO event from GARD to the app, all in
+ * CLOCK_MONOTONIC nanoseconds so that they compare with clock_gettime():
+ *
+ * - edge_ns: kernel timestamp of the edge GARD raised on the GPIO line
+ * - monitor_wake_ns: the GPIO monitor woke up and read the edge
+ * - worker_wake_ns: the app data worker took the event
+ * - xfer_start_ns / xfer_end_ns: receive of the app data from GARD
+ *
+ * NOTE: Kernels before 5.7 stamp GPIO edges with CLOCK_REALTIME instead.
+ */
+struct hub_appdata_event_times {
+	uint64_t edge_ns;
+	uint64_t monitor_wake_ns;
+	uint64_t worker_wake_ns;
+	uint64_t xfer_start_ns;
+	uint64_t xfer_end_ns;
+};
+
+/**
+ * hub_get_appdata_event_times gets the timestamps of the last GPIO event
+ * whose app data was fetched on a line. Called from the app data callback,
+ * these are the ones of the data the callback was given.
+ *
+ * @param: gard is the GARD handle
+ * @param: line_offset is the GPIO line offset
+ * @param: p_times is filled with the timestamps
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GPIO_EVENT_STATS on failure
+ */
+enum hub_ret_code
+	hub_get_appdata_event_times(gard_handle_t                   gard,
+								int                             line_offset,
+								struct hub_appdata_event_times *p_times);
+
 /******************************************************************************
  * Image Operations related APIs
  ******************************************************************************/
@@ -378,11 +1168,37 @@ int32_t hub_setup_appdata_cb_for_pyhub(gard_handle_t gard);
  * - HUB / Host Applicaiton should also call hub_send_resume_pipeline() after
  *   receiving the image content to signal GARD FW to resume the paused AI
  *   workload.
+ * - With no_pause set in struct hub_img_ops_ctx, GARD FW copies the rescaled
+ *   image to a snapshot buffer instead and keeps its pipelines running. No
+ *   hub_send_resume_pipeline() is needed then, unless GARD FW does not support
+ *   it and paused them anyway, as told by pipeline_paused.
+ * - With a USB data bus, the command goes on the I2C / UART control bus of
+ *   the GARD, and hub_recv_data_from_gard() reads the image over USB, from
+ *   image_buffer_address in HRAM. A GARD on USB alone cannot take it.
  */
 enum hub_ret_code
 	hub_capture_rescaled_image_from_gard(gard_handle_t           p_gard_handle,
 										 struct hub_img_ops_ctx *p_img_ops_ctx);
 
+/**
+ * Decode the image received from GARD after
+ * hub_capture_rescaled_image_from_gard(), as encoded with the codec of
+ * struct hub_img_ops_ctx, into raw samples.
+ *
+ * @param: p_img_ops_ctx is the HUB image operations context, whose
+ *         p_image_buffer holds the image_buffer_size bytes received
+ * @param: p_out is filled with the decoded image
+ * @param: out_size is the size of p_out, at least h_size x v_size bytes per
+ *         plane of the image
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CAPTURE_RESCALED_IMAGE on failure
+ */
+enum hub_ret_code
+	hub_decode_rescaled_image(const struct hub_img_ops_ctx *p_img_ops_ctx,
+							  void                         *p_out,
+							  uint32_t                      out_size);
+
 /******************************************************************************
  * HUB <-> GARD Control Command related APIs
  ******************************************************************************/
@@ -392,4 +1208,1280 @@ enum hub_ret_code
 enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 										   uint8_t       camera_id);
 
+/* Pipeline stages GARD keeps timing statistics for */
+enum hub_pipeline_stage {
+	HUB_PIPELINE_STAGE_CAPTURE = 0,     /* capture start to capture done */
+	HUB_PIPELINE_STAGE_RESCALE,         /* rescale start to rescale done */
+	HUB_PIPELINE_STAGE_ML,              /* ML engine start to ML done */
+	HUB_PIPELINE_STAGE_POST_PROCESSING, /* app_ml_done() of one ML result */
+	HUB_PIPELINE_STAGE_HOST_TX,         /* app data queued to sent to Host */
+	HUB_PIPELINE_STAGE_FRAME,           /* capture start to next capture */
+	HUB_PIPELINE_STAGE_MAX,
+};
+
+/**
+ * Timing of one pipeline stage as measured by GARD, in nanoseconds. min_ns,
+ * avg_ns and max_ns are 0 while count is 0.
+ */
+struct hub_pipeline_stage_stats {
+	uint32_t count;
+	uint64_t min_ns;
+	uint64_t avg_ns;
+	uint64_t max_ns;
+};
+
+/**
+ * Timing statistics of the pipeline stages of one GARD, since it booted or
+ * the last reset. cycles_per_us is the GARD CPU clock they were converted
+ * with.
+ */
+struct hub_pipeline_stats {
+	uint32_t                        cycles_per_us;
+	struct hub_pipeline_stage_stats stages[HUB_PIPELINE_STAGE_MAX];
+};
+
+/**
+ * hub_get_pipeline_stats reads the pipeline timing statistics of a GARD with
+ * GET_PIPELINE_STATS, and clears them on GARD if reset is set.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: reset is 1 to clear the statistics once read, 0 otherwise
+ * @param: p_stats is filled with the statistics
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_PIPELINE_STATS on failure
+ */
+enum hub_ret_code
+	hub_get_pipeline_stats(gard_handle_t              p_gard_handle,
+						   uint8_t                    reset,
+						   struct hub_pipeline_stats *p_stats);
+
+/**
+ * hub_pipeline_stage_name gives a short name of a pipeline stage, e.g.
+ * "capture", or NULL for an invalid one.
+ */
+const char *hub_pipeline_stage_name(enum hub_pipeline_stage stage);
+
+/* Most ML networks reported by hub_get_network_residency */
+#define HUB_NETWORK_RESIDENCY_MAX_NETWORKS (8)
+
+/**
+ * Where one ML network of a GARD is. flags are NETWORK_RESIDENCY__* of
+ * gard_hub_iface.h, priority is its residency priority. runs_since_last_run
+ * is the count of ML runs of the other networks since it last ran,
+ * UINT32_MAX if it never ran.
+ */
+struct hub_network_residency_entry {
+	uint32_t network;
+	uint32_t addr_in_ram;
+	uint32_t size;
+	uint32_t flags;
+	uint32_t priority;
+	uint32_t loads;
+	uint32_t runs_since_last_run;
+};
+
+/**
+ * Residency of the ML networks of one GARD in its HRAM, and the free HRAM
+ * left for networks.
+ */
+struct hub_network_residency {
+	uint32_t                           num_networks;
+	uint32_t                           free_bytes;
+	uint32_t                           largest_free_bytes;
+	struct hub_network_residency_entry networks
+		[HUB_NETWORK_RESIDENCY_MAX_NETWORKS];
+};
+
+/**
+ * hub_get_network_residency reads where the ML networks of a GARD are in its
+ * HRAM with GET_NETWORK_RESIDENCY.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_residency is filled with the residency of the networks
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_NETWORK_RESIDENCY on failure
+ */
+enum hub_ret_code
+	hub_get_network_residency(gard_handle_t                 p_gard_handle,
+							  struct hub_network_residency *p_residency);
+
+/* Policies picking the images a GARD runs its ML engine on */
+enum hub_inference_rate_mode {
+	HUB_INFERENCE_RATE_ALL_FRAMES = 0, /* every image, param is unused */
+	HUB_INFERENCE_RATE_EVERY_NTH,      /* one image in param */
+	HUB_INFERENCE_RATE_TARGET_FPS,     /* at most param images per 1000 s */
+	HUB_INFERENCE_RATE_ADAPTIVE,       /* backs off above param % ML busy */
+	HUB_INFERENCE_RATE_DUTY_CYCLE,     /* one image every param ms, camera in
+										  standby and GARD idle in between */
+};
+
+/**
+ * Inference rate policy of one GARD and the rates it gives. Rates are in
+ * images per 1000 s, measured by GARD over the last second. run_interval is
+ * the one image in how many run now, as adapted by
+ * HUB_INFERENCE_RATE_ADAPTIVE. wake_us is the time the camera takes from
+ * standby to a captured image, as measured with
+ * HUB_INFERENCE_RATE_DUTY_CYCLE, 0 until measured.
+ */
+struct hub_inference_rate {
+	enum hub_inference_rate_mode mode;
+	uint32_t                     param;
+	uint32_t                     frames_offered;
+	uint32_t                     frames_run;
+	uint32_t                     offered_mfps;
+	uint32_t                     run_mfps;
+	uint32_t                     run_interval;
+	uint32_t                     wake_us;
+};
+
+/**
+ * hub_set_inference_rate sets the policy picking the images a GARD runs its
+ * ML engine on with INFERENCE_RATE, the other images being dropped.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: mode is the policy
+ * @param: param is the parameter of the policy, see enum
+ *         hub_inference_rate_mode
+ * @param: p_rate is filled with the policy now in use and its rates, can be
+ *         NULL
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INFERENCE_RATE on failure, or if GARD refused param
+ */
+enum hub_ret_code
+	hub_set_inference_rate(gard_handle_t                p_gard_handle,
+						   enum hub_inference_rate_mode mode,
+						   uint32_t                     param,
+						   struct hub_inference_rate   *p_rate);
+
+/**
+ * hub_get_inference_rate reads the inference rate policy of a GARD and the
+ * rates it gives with INFERENCE_RATE.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_rate is filled with the policy in use and its rates
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INFERENCE_RATE on failure
+ */
+enum hub_ret_code hub_get_inference_rate(gard_handle_t              p_gard_handle,
+										 struct hub_inference_rate *p_rate);
+
+/**
+ * Scaler engine configuration of the captures of one GARD. The box scaler
+ * takes the precrop window of the sensor image and divides it by the
+ * factors, the bilinear scaler then crops its output, of crop_in size, and
+ * scales the crop to out size. Windows are left/upper inclusive and
+ * right/bottom exclusive. GARD rescales the captured image to the input size
+ * of its networks.
+ */
+struct hub_scaler_config {
+	uint16_t precrop_left;
+	uint16_t precrop_right;
+	uint16_t precrop_upper;
+	uint16_t precrop_bottom;
+	uint8_t  box_factor_x;
+	uint8_t  box_factor_y;
+	uint16_t crop_left;
+	uint16_t crop_right;
+	uint16_t crop_upper;
+	uint16_t crop_bottom;
+	uint16_t crop_in_width;
+	uint16_t crop_in_height;
+	uint16_t out_width;
+	uint16_t out_height;
+};
+
+/**
+ * hub_set_scaler_config sets the scaler engine configuration of the captures
+ * of a GARD with SCALER_CONFIG. GARD applies it at a frame boundary.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_config is the configuration to set
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SCALER_CONFIG on failure, or if GARD refused p_config
+ */
+enum hub_ret_code
+	hub_set_scaler_config(gard_handle_t                   p_gard_handle,
+						  const struct hub_scaler_config *p_config);
+
+/**
+ * hub_get_scaler_config reads the scaler engine configuration last set on a
+ * GARD with SCALER_CONFIG.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_config is filled with the configuration
+ * @param: p_applied is filled with 1 once the captures use it, can be NULL
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SCALER_CONFIG on failure
+ */
+enum hub_ret_code hub_get_scaler_config(gard_handle_t             p_gard_handle,
+										struct hub_scaler_config *p_config,
+										uint8_t                  *p_applied);
+
+/* Most images reported by hub_get_image_stats */
+#define HUB_IMAGE_STATS_HISTORY (8)
+
+/**
+ * ISP statistics of one image captured by a GARD, computed over the captured
+ * image. frame_seq numbers the captured images from the boot of GARD on.
+ */
+struct hub_image_stats_entry {
+	uint32_t frame_seq;
+	uint8_t  gray_avg;
+	uint8_t  gray_min;
+	uint8_t  gray_max;
+};
+
+/**
+ * ISP statistics of the last images captured by one GARD, the newest first.
+ * images_recorded counts the images captured since its boot, so that two
+ * reads tell how many images were missed in between.
+ */
+struct hub_image_stats {
+	uint32_t                     num_stats;
+	uint32_t                     images_recorded;
+	struct hub_image_stats_entry stats[HUB_IMAGE_STATS_HISTORY];
+};
+
+/**
+ * hub_get_image_stats reads the ISP statistics of the last images captured by
+ * a GARD with GET_IMAGE_STATS, to judge the scene without reading images.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_stats is filled with the statistics
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_IMAGE_STATS on failure
+ */
+enum hub_ret_code hub_get_image_stats(gard_handle_t           p_gard_handle,
+									  struct hub_image_stats *p_stats);
+
+/**
+ * Mapping of the GARD timer, which time stamps the images and the results of
+ * a GARD, to the CLOCK_MONOTONIC clock of the host, in nanoseconds.
+ *
+ * gard_ticks was read by GARD at host_ns, the middle of the quickest of the
+ * round trips sampled, which took round_trip_ns; the mapping is no better
+ * than half of it. offset_ns is host_ns less gard_ticks in nanoseconds.
+ * drift_ppb is how much faster the GARD timer runs than the host clock, in
+ * parts per billion, measured from the previous synchronization; it is 0
+ * until there is one.
+ */
+struct hub_gard_clock_sync {
+	uint64_t gard_ticks;
+	uint32_t gard_freq_hz;
+	uint64_t host_ns;
+	uint64_t round_trip_ns;
+	int64_t  offset_ns;
+	int32_t  drift_ppb;
+};
+
+/**
+ * hub_sync_gard_clock maps the GARD timer of a GARD to the host clock, from
+ * num_samples GET_GARD_TIME round trips, the quickest one being kept.
+ *
+ * Notes:
+ * 1. p_sync is zeroed by the caller before the first call. It is then passed
+ *    back as is to each later call, which measures the drift from it, a few
+ *    seconds or more apart for a meaningful one.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: num_samples is the count of round trips, at least 1
+ * @param: p_sync is the previous synchronization, updated with the new one
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GARD_TIME on failure, p_sync being left as is
+ */
+enum hub_ret_code hub_sync_gard_clock(gard_handle_t               p_gard_handle,
+									  uint32_t                    num_samples,
+									  struct hub_gard_clock_sync *p_sync);
+
+/**
+ * hub_gard_ticks_to_host_ns maps a GARD time, such as the capture time of an
+ * image, to the host CLOCK_MONOTONIC clock in nanoseconds, correcting for the
+ * drift since the synchronization.
+ *
+ * @param: p_sync is a synchronization made by hub_sync_gard_clock
+ * @param: gard_ticks is the GARD time, in GARD timer ticks
+ *
+ * @return: The host time, 0 if p_sync holds no synchronization
+ */
+uint64_t hub_gard_ticks_to_host_ns(const struct hub_gard_clock_sync *p_sync,
+								   uint64_t                          gard_ticks);
+
+/**
+ * hub_get_gard_clock gets the last mapping of the timer of a GARD to the host
+ * clock, made by the health monitor thread every "clock_sync_ms" of
+ * host_config.json (0 or absent: never), see hub_sync_gard_clock. It is
+ * dropped when the GARD is lost, its timer restarting with its firmware.
+ *
+ * @param: gard is the GARD handle
+ * @param: p_sync is filled with the mapping
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GARD_TIME if the GARD is not synchronized yet
+ */
+enum hub_ret_code hub_get_gard_clock(gard_handle_t               gard,
+									 struct hub_gard_clock_sync *p_sync);
+
+/**
+ * hub_gard_time_to_host_ns maps a time of the timer of a GARD, such as the
+ * capture_time of struct hub_img_ops_ctx, to the host CLOCK_MONOTONIC clock
+ * in nanoseconds, with the mapping of hub_get_gard_clock.
+ *
+ * @param: gard is the GARD handle
+ * @param: gard_ticks is the GARD time
+ *
+ * @return: The host time, 0 if the GARD is not synchronized yet
+ */
+uint64_t hub_gard_time_to_host_ns(gard_handle_t gard, uint64_t gard_ticks);
+
+/**
+ * hub_gard_ms_to_host_ns maps the timestamp_ms of a result packet of a GARD
+ * to the host CLOCK_MONOTONIC clock in nanoseconds, with the mapping of
+ * hub_get_gard_clock, so that the results of several GARDs can be paired by
+ * the capture time of their frames.
+ *
+ * @param: gard is the GARD handle
+ * @param: gard_ms is the time stamp of the result packet
+ *
+ * @return: The host time, 0 if the GARD is not synchronized yet
+ */
+uint64_t hub_gard_ms_to_host_ns(gard_handle_t gard, uint32_t gard_ms);
+
+/**
+ * hub_upgrade_gard_firmware programs a new image in the flash of a GARD with
+ * UPGRADE_FIRMWARE. The image is sent in chunks to the staging buffers of
+ * GARD, each chunk being programmed by GARD while the next one is sent.
+ *
+ * Notes:
+ * 1. The new image runs from the next boot of GARD on. An image without the
+ *    bitstream is programmed in the firmware slot of GARD not running; GARD
+ *    boots the previous slot again if the new firmware does not confirm it
+ *    runs well within a few boots.
+ * 2. An upgrade that failed, or was interrupted, is resumed from the bytes
+ *    GARD has programmed by calling again with resume set and the same image.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_image is the image to program
+ * @param: size is the size of p_image in bytes
+ * @param: is_bitstream_included is 1 if the image starts with the bitstream,
+ *         0 if it only holds the RFS
+ * @param: resume is 1 to keep the bytes programmed by the last upgrade of the
+ *         same image, 0 to program it all
+ * @param: p_bytes_programmed is filled with the bytes of the image programmed
+ *         and verified, from its start, can be NULL
+ *
+ * @return: HUB_SUCCESS once the whole image is programmed
+ *			HUB_FAILURE_UPGRADE_FIRMWARE on failure, or if GARD refused it
+ */
+enum hub_ret_code hub_upgrade_gard_firmware(gard_handle_t p_gard_handle,
+											const void   *p_image,
+											uint32_t      size,
+											uint8_t       is_bitstream_included,
+											uint8_t       resume,
+											uint32_t     *p_bytes_programmed);
+
+/* Input slots a GARD takes the images of hub_run_inference_on_buffer in */
+#define HUB_HOST_INFERENCE_SLOTS (2)
+
+/**
+ * Input slots of the images a GARD runs its networks on in place of its
+ * camera images, see hub_run_inference_on_buffer. free_slots has bit n set if
+ * slot n can be written. active is 1 while GARD runs on host images.
+ */
+struct hub_host_inference_info {
+	uint8_t  active;
+	uint8_t  free_slots;
+	uint32_t slot_address[HUB_HOST_INFERENCE_SLOTS];
+	uint32_t slot_size;
+};
+
+/**
+ * hub_get_host_inference_info reads the input slots of a GARD with
+ * RUN_INFERENCE_ON_BUFFER.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_info is filled with the slots
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_HOST_INFERENCE on failure
+ */
+enum hub_ret_code
+	hub_get_host_inference_info(gard_handle_t                   p_gard_handle,
+								struct hub_host_inference_info *p_info);
+
+/**
+ * hub_run_inference_on_buffer has a GARD run its networks on an image of the
+ * host, such as a frame of a recorded video, in place of its camera images.
+ * The image is sent to a free input slot of GARD over the data bus, then
+ * submitted with RUN_INFERENCE_ON_BUFFER; GARD scales it to the network input
+ * and its results come as app data, with frame_id as their frame sequence
+ * number. GARD has two input slots, so the next image is sent while the
+ * networks run on the previous one. The first image stops the camera images,
+ * until hub_stop_host_inference.
+ *
+ * Notes:
+ * 1. The image is planar, in the format the networks of GARD take.
+ * 2. The call waits up to 2 s for a free slot.
+ * 3. GARD does not take images while its capture free-runs.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_image is the image, width by height pixels a plane
+ * @param: format is HUB_IMAGE_FORMAT__RGB_PLANAR or HUB_IMAGE_FORMAT__GRAYSCALE
+ * @param: width is the width of the image in pixels
+ * @param: height is the height of the image in pixels
+ * @param: frame_id is the frame sequence number of the results
+ *
+ * @return: HUB_SUCCESS once GARD has queued the image
+ *			HUB_FAILURE_HOST_INFERENCE on failure, or if GARD refused it
+ */
+enum hub_ret_code hub_run_inference_on_buffer(gard_handle_t          p_gard_handle,
+											  const void            *p_image,
+											  enum hub_image_formats format,
+											  uint16_t               width,
+											  uint16_t               height,
+											  uint32_t               frame_id);
+
+/**
+ * hub_stop_host_inference drops the host images a GARD has not run yet and
+ * has it go back to its camera images.
+ *
+ * @param: p_gard_handle is the GARD handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_HOST_INFERENCE on failure
+ */
+enum hub_ret_code hub_stop_host_inference(gard_handle_t p_gard_handle);
+
+/* Steps of the swap of an ML network of a GARD, see hub_swap_gard_network */
+enum hub_network_swap_status {
+	HUB_NETWORK_SWAP_IDLE = 0,   /* no swap */
+	HUB_NETWORK_SWAP_STAGED,     /* HRAM set aside for the new network */
+	HUB_NETWORK_SWAP_CHECKING,   /* CRC of the new network */
+	HUB_NETWORK_SWAP_PENDING,    /* waits for the network to be idle */
+	HUB_NETWORK_SWAP_SWAPPED,    /* switched to, not in the RFS */
+	HUB_NETWORK_SWAP_PERSISTING, /* switched to, RFS copy being updated */
+	HUB_NETWORK_SWAP_PERSISTED,  /* switched to, RFS copy updated */
+	HUB_NETWORK_SWAP_FAILED,     /* CRC mismatch or flash failure */
+};
+
+/**
+ * The swap of an ML network of one GARD. staging_address is the HRAM of GARD
+ * set aside for the new network until it is switched to, 0 otherwise.
+ * bytes_persisted is the bytes of its RFS copy updated and verified.
+ */
+struct hub_network_swap_info {
+	enum hub_network_swap_status status;
+	uint32_t                     network;
+	uint32_t                     staging_address;
+	uint32_t                     staging_size;
+	uint32_t                     bytes_persisted;
+};
+
+/**
+ * hub_get_network_swap_info reads the swap of an ML network of a GARD with
+ * SWAP_NETWORK.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_info is filled with the swap
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_NETWORK_SWAP on failure
+ */
+enum hub_ret_code
+	hub_get_network_swap_info(gard_handle_t                 p_gard_handle,
+							  struct hub_network_swap_info *p_info);
+
+/**
+ * hub_swap_gard_network replaces an ML network of a GARD without restarting
+ * it, e.g. to roll out a new model or run an A/B test. The new network is
+ * sent to HRAM GARD sets aside with SWAP_NETWORK, then committed with its
+ * CRC; GARD checks it and switches to it between two ML runs, so no frame is
+ * dropped, and optionally updates its RFS copy in the background.
+ *
+ * Notes:
+ * 1. GARD may evict other networks from HRAM to stage the new one, they are
+ *    loaded again from flash when next run.
+ * 2. To persist, the new network must be the size of the one in the RFS.
+ *    Otherwise, or without persist, GARD runs the new network until its next
+ *    restart, which loads the RFS one again.
+ * 3. The call waits up to 60 s for the swap, and the RFS update, to be done.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: network is the UID of the network registered on GARD to replace
+ * @param: p_network is the new network
+ * @param: size is the size of p_network in bytes
+ * @param: persist is 1 to update the RFS copy of the network too, 0 not to
+ * @param: p_info is filled with the swap once done, can be NULL
+ *
+ * @return: HUB_SUCCESS once GARD runs the new network, and has it in its RFS
+ *          if persist is set
+ *			HUB_FAILURE_NETWORK_SWAP on failure, or if GARD refused it
+ */
+enum hub_ret_code hub_swap_gard_network(gard_handle_t                 p_gard_handle,
+										uint32_t                      network,
+										const void                   *p_network,
+										uint32_t                      size,
+										uint8_t                       persist,
+										struct hub_network_swap_info *p_info);
+
+/**
+ * Coalescing of the app data IRQs of one GARD, see
+ * hub_set_app_data_coalescing. Counts are since GARD started.
+ */
+struct hub_app_data_coalescing {
+	uint8_t  enabled;
+	uint32_t max_latency_ms;    /* IRQ raised again this often while unread */
+	uint32_t irqs_raised;       /* app data IRQs raised */
+	uint32_t results_coalesced; /* results taken with an earlier IRQ */
+	uint32_t results_copied;    /* results copied in the batch buffer */
+	uint32_t results_dropped;   /* results GARD had no room for */
+};
+
+/**
+ * hub_set_app_data_coalescing turns on or off the coalescing of the app data
+ * IRQs of a GARD with APP_DATA_COALESCING. While the app has results left
+ * unread, GARD raises no IRQ for further results, which are taken with the
+ * same fetch, and copies those its queue has no room for instead of dropping
+ * them. The IRQ is raised again every max_latency_ms while results are
+ * unread.
+ *
+ * Notes:
+ * 1. The GARD must fetch its app data in batches, see app_data_batch of the
+ *    bus config, and not with hub_setup_appdata_ring_cb().
+ * 2. The buffer given to hub_setup_appdata_cb() must hold
+ *    APP_DATA_COALESCE__MAX_BYTES, the most GARD copies in one batch.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: enable is 1 to coalesce, 0 to raise one IRQ per result
+ * @param: max_latency_ms is how often the IRQ is raised again, 0 for
+ *         APP_DATA_COALESCE__DEFAULT_LATENCY_MS
+ * @param: p_info is filled with the coalescing now in use, can be NULL
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_APP_DATA_COALESCING on failure, or if GARD refused it
+ */
+enum hub_ret_code
+	hub_set_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								uint8_t                         enable,
+								uint32_t                        max_latency_ms,
+								struct hub_app_data_coalescing *p_info);
+
+/**
+ * hub_get_app_data_coalescing reads the coalescing of the app data IRQs of a
+ * GARD and its counts with APP_DATA_COALESCING.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_info is filled with the coalescing in use
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_APP_DATA_COALESCING on failure
+ */
+enum hub_ret_code
+	hub_get_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								struct hub_app_data_coalescing *p_info);
+
+/**
+ * hub_send_app_command sends a command of the App Module to a GARD, one of
+ * the commands it registered on GARD, and returns the status its handler
+ * returned.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: command_id is the App Module command id, from APP_COMMAND_ID_FIRST
+ *         to APP_COMMAND_ID_LAST
+ * @param: p_body is the command body, of the size registered on GARD
+ * @param: body_size is the size of p_body, 0 if the command has none
+ * @param: p_status is filled with the status returned by the App Module
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_APP_COMMAND on failure, or if the command is not
+ *			registered on GARD
+ */
+enum hub_ret_code hub_send_app_command(gard_handle_t p_gard_handle,
+									   uint8_t       command_id,
+									   const void   *p_body,
+									   uint32_t      body_size,
+									   uint32_t     *p_status);
+
+/******************************************************************************
+ * HUB statistics APIs
+ ******************************************************************************/
+/* Operations HUB keeps statistics for, per GARD */
+enum hub_stats_op {
+	HUB_STATS_OP_READ_REG = 0,  /* hub_read_gard_reg[s](), control bus */
+	HUB_STATS_OP_WRITE_REG,     /* hub_write_gard_reg[s](), control bus */
+	HUB_STATS_OP_SEND_DATA,     /* hub_send_data_to_gard(), data bus */
+	HUB_STATS_OP_RECV_DATA,     /* hub_recv_data_from_gard(), data bus */
+	HUB_STATS_OP_RECV_APP_DATA, /* app data fetched on a GPIO event */
+	HUB_STATS_OP_APPDATA_CB,    /* user callback run on a GPIO event */
+	HUB_STATS_OP_MAX,
+};
+
+/**
+ * Latency histograms have HUB_STATS_LATENCY_SUB_BUCKETS linear buckets per
+ * power of two of microseconds (HDR-style): bucket b < 4 counts latencies of
+ * b us, and bucket b >= 4 those from (4 + b % 4) << (b / 4 - 1) us up to the
+ * next bucket. Use hub_stats_bucket_floor_us() rather than the formula. The
+ * last bucket also counts everything above it.
+ */
+#define HUB_STATS_LATENCY_SUB_BUCKETS 4
+#define HUB_STATS_LATENCY_BUCKETS     96
+
+/**
+ * Counters of one operation:
+ *
+ * - transactions: calls, successful or not
+ * - errors: calls that failed
+ * - bytes: payload bytes moved by successful calls
+ * - latency_total_ns / latency_max_ns: over all calls
+ * - latency_hist: calls per latency bucket
+ */
+struct hub_op_stats {
+	uint64_t transactions;
+	uint64_t errors;
+	uint64_t bytes;
+	uint64_t latency_total_ns;
+	uint64_t latency_max_ns;
+	uint64_t latency_hist[HUB_STATS_LATENCY_BUCKETS];
+};
+
+/**
+ * Statistics of one GARD, with the busses the operations go over.
+ */
+struct hub_gard_stats {
+	enum hub_gard_bus_types control_bus;
+	enum hub_gard_bus_types data_bus;
+	struct hub_op_stats     ops[HUB_STATS_OP_MAX];
+};
+
+/**
+ * hub_get_stats gets a snapshot of the statistics HUB keeps for a GARD
+ * since hub_init() or the last hub_reset_stats().
+ *
+ * @param: gard is the GARD handle
+ * @param: p_stats is filled with the statistics
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_STATS on failure
+ */
+enum hub_ret_code hub_get_stats(gard_handle_t          gard,
+								struct hub_gard_stats *p_stats);
+
+/**
+ * hub_reset_stats clears the statistics HUB keeps for a GARD.
+ *
+ * @param: gard is the GARD handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_STATS on failure
+ */
+enum hub_ret_code hub_reset_stats(gard_handle_t gard);
+
+/**
+ * hub_stats_op_name gives a short name of a statistics operation, e.g.
+ * "read_reg", or NULL for an invalid one.
+ */
+const char *hub_stats_op_name(enum hub_stats_op op);
+
+/**
+ * hub_stats_bucket_floor_us gives the lowest latency, in microseconds,
+ * counted by a latency histogram bucket.
+ */
+uint64_t hub_stats_bucket_floor_us(uint32_t bucket);
+
+/******************************************************************************
+ * HUB tracing APIs
+ ******************************************************************************/
+/**
+ * hub_trace_start starts recording every GPIO app data event, from the GARD
+ * edge to the return of the user callback, in a ring of num_records trace
+ * records. The oldest records are overwritten once the ring is full.
+ * Restarting an active trace clears it.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: num_records is the size of the ring
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_start(hub_handle_t hub, uint32_t num_records);
+
+/**
+ * hub_trace_stop stops recording and drops the trace records.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_stop(hub_handle_t hub);
+
+/**
+ * hub_trace_export_json writes the trace records in the Chrome trace event
+ * JSON format, which chrome://tracing and ui.perfetto.dev open. Each event
+ * is an async slice on the track of its GARD and GPIO line, split into the
+ * edge to monitor, monitor to worker, receive and callback stages.
+ * Recording goes on during the export.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_path is the file to write
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_export_json(hub_handle_t hub, const char *p_path);
+
+/******************************************************************************
+ * HUB bus capture APIs
+ ******************************************************************************/
+/**
+ * A bus capture file is a struct hub_bus_capture_header, a struct
+ * hub_bus_capture_bus per bus of the HUB, then a struct hub_bus_capture_record
+ * per bus transaction, each followed by its data_len bytes of data. All fields
+ * are in the byte order of the host that captured them.
+ */
+#define HUB_BUS_CAPTURE_MAGIC   (0x54434248U) /* "HBCT" */
+#define HUB_BUS_CAPTURE_VERSION (1U)
+
+/* Most busses of a HUB a capture covers */
+#define HUB_BUS_CAPTURE_MAX_BUSSES (8U)
+
+/* cmd_id of a transaction not in a HUB command exchange, e.g. a USB blob */
+#define HUB_BUS_CAPTURE_CMD_UNKNOWN (0xFFU)
+
+enum hub_bus_capture_dir {
+	HUB_BUS_CAPTURE_DIR_WRITE = 0, /* HUB to GARD */
+	HUB_BUS_CAPTURE_DIR_READ,      /* GARD to HUB */
+};
+
+enum hub_bus_capture_flags {
+	HUB_BUS_CAPTURE_FLAG_TAGGED   = (1U << 0), /* Command has CMD_ID_TAGGED */
+	HUB_BUS_CAPTURE_FLAG_FAILED   = (1U << 1), /* Transaction failed, len 0 */
+	HUB_BUS_CAPTURE_FLAG_USB_BLOB = (1U << 2), /* addr is the GARD address */
+};
+
+struct hub_bus_capture_header {
+	uint32_t magic;      /* HUB_BUS_CAPTURE_MAGIC */
+	uint16_t version;    /* HUB_BUS_CAPTURE_VERSION */
+	uint16_t num_busses; /* struct hub_bus_capture_bus that follow */
+	uint64_t start_ns;   /* CLOCK_MONOTONIC time of the start of the capture */
+};
+
+struct hub_bus_capture_bus {
+	uint8_t  type;       /* enum hub_gard_bus_types */
+	uint8_t  gard_index; /* GARD the bus is wired to */
+	uint16_t reserved;
+	uint32_t speed;      /* UART baud rate or I2C speed, 0 for USB */
+};
+
+struct hub_bus_capture_record {
+	uint64_t start_ns;    /* Since the start of the capture */
+	uint32_t duration_ns; /* Saturated at UINT32_MAX */
+	uint32_t len;         /* Bytes moved */
+	uint32_t data_len;    /* Bytes of data that follow, at most len */
+	uint32_t addr;        /* GARD address of a USB blob, else 0 */
+	uint8_t  bus;         /* Index of the bus in the capture */
+	uint8_t  dir;         /* enum hub_bus_capture_dir */
+	uint8_t  cmd_id;      /* Command of the exchange, without CMD_ID_TAGGED */
+	uint8_t  flags;       /* enum hub_bus_capture_flags */
+	uint32_t reserved;
+};
+
+/**
+ * hub_bus_capture_start logs every transaction on the busses of a HUB to a
+ * capture file: its direction, size, start time and duration, the HUB
+ * command it belongs to and its data, so that the traffic of a workload can
+ * be analysed and replayed offline, see hub_apps/bus_replay_app.c. Only one
+ * capture runs at a time in a process.
+ *
+ * The records are buffered and written by the thread doing the transaction,
+ * each one after its transaction is over.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_path is the capture file to write
+ * @param: max_data_bytes is the most data logged per transaction, 0 for all
+ *         of it, which a replay needs
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_BUS_CAPTURE on failure
+ */
+enum hub_ret_code hub_bus_capture_start(hub_handle_t hub,
+										const char  *p_path,
+										uint32_t     max_data_bytes);
+
+/**
+ * hub_bus_capture_stop stops the capture and writes the rest of the capture
+ * file. hub_fini() stops a capture left running.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success, or if no capture runs
+ *			HUB_FAILURE_BUS_CAPTURE on failure, e.g. the file could not be
+ *			written
+ */
+enum hub_ret_code hub_bus_capture_stop(hub_handle_t hub);
+
+/******************************************************************************
+ * HUB app data recording APIs
+ ******************************************************************************/
+/**
+ * A recording is a series of segment files, <path>.0000, <path>.0001 and so
+ * on. A segment is a struct hub_recording_header, then a struct
+ * hub_recording_record per app data result, each followed by its size bytes
+ * of data. A segment that was closed ends with its time index: a struct
+ * hub_recording_index_entry per index_interval_ns of results, then a struct
+ * hub_recording_footer. All fields are in the byte order of the host that
+ * recorded them.
+ */
+#define HUB_RECORDING_MAGIC        (0x43455248U) /* "HREC" */
+#define HUB_RECORDING_FOOTER_MAGIC (0x58445248U) /* "HRDX" */
+#define HUB_RECORDING_VERSION      (1U)
+
+/* Size of a segment when none is given to hub_record_appdata() */
+#define HUB_RECORDING_DEFAULT_SEGMENT_SIZE (64U * 1024U * 1024U)
+
+/* Time between two entries of the index of a segment */
+#define HUB_RECORDING_INDEX_INTERVAL_NS (100000000ULL)
+
+struct hub_recording_header {
+	uint32_t magic;             /* HUB_RECORDING_MAGIC */
+	uint16_t version;           /* HUB_RECORDING_VERSION */
+	uint16_t header_size;       /* sizeof(struct hub_recording_header) */
+	uint32_t gard_index;        /* GARD the results came from */
+	uint32_t segment;           /* Index of the segment, from 0 */
+	uint64_t start_ns;          /* CLOCK_MONOTONIC at the start of recording */
+	uint64_t start_realtime_ns; /* CLOCK_REALTIME at the same time */
+	uint64_t index_interval_ns; /* Time between two index entries */
+};
+
+struct hub_recording_record {
+	uint32_t crc;          /* CRC-32 of the rest of the record and its data */
+	uint32_t size;         /* Bytes of data that follow */
+	uint64_t seq;          /* From 1, across the segments of the recording */
+	uint64_t timestamp_ns; /* Since start_ns, when HUB got the result */
+};
+
+struct hub_recording_index_entry {
+	uint64_t timestamp_ns; /* Of the first record at or after the entry time */
+	uint64_t offset;       /* Of that record in the segment */
+};
+
+struct hub_recording_footer {
+	uint64_t index_offset; /* Of the first struct hub_recording_index_entry */
+	uint64_t last_ns;      /* Timestamp of the last record of the segment */
+	uint32_t num_entries;  /* Index entries */
+	uint32_t num_records;  /* Records of the segment */
+	uint32_t crc;          /* CRC-32 of the index and the fields above */
+	uint32_t magic;        /* HUB_RECORDING_FOOTER_MAGIC */
+};
+
+/**
+ * hub_record_appdata appends every app data result of a GARD, as given to
+ * the callbacks of hub_setup_appdata_cb(), hub_setup_appdata_ring_cb() and
+ * hub_subscribe_appdata(), to a recording, with its sequence number and the
+ * time HUB got it. Each result is written by the thread delivering it,
+ * before its callback, straight from the buffer of the callback with one
+ * writev(): nothing is copied or buffered in user space, and a crash loses
+ * at most the index of the last segment, which the reader rebuilds.
+ *
+ * @param: gard is the GARD handle
+ * @param: p_path is the path of the recording, its segments get a suffix
+ * @param: segment_size is the size a segment is closed at, 0 for
+ *         HUB_RECORDING_DEFAULT_SEGMENT_SIZE
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_RECORDING on failure, e.g. the GARD already records
+ */
+enum hub_ret_code hub_record_appdata(gard_handle_t gard,
+									 const char   *p_path,
+									 uint32_t      segment_size);
+
+/**
+ * hub_stop_recording closes the recording of a GARD, writing the index of
+ * its last segment. It may run while app data is delivered; hub_fini()
+ * stops a recording left running.
+ *
+ * @param: gard is the GARD handle
+ *
+ * @return: HUB_SUCCESS on success, or if the GARD does not record
+ *			HUB_FAILURE_RECORDING if a write failed during the recording
+ */
+enum hub_ret_code hub_stop_recording(gard_handle_t gard);
+
+/* Opaque handle to a recording open for reading */
+typedef void *hub_recording_t;
+
+/**
+ * One record of a recording. p_data points into the mapped segment, it is
+ * valid until hub_recording_close().
+ */
+struct hub_recording_entry {
+	uint64_t    seq;
+	uint64_t    timestamp_ns; /* Since the start of the recording */
+	uint32_t    size;
+	const void *p_data;
+};
+
+struct hub_recording_info {
+	uint32_t gard_index;
+	uint32_t num_segments;
+	uint64_t num_records;
+	uint64_t start_realtime_ns; /* CLOCK_REALTIME at the start of recording */
+	uint64_t first_ns;          /* Timestamp of the first record */
+	uint64_t last_ns;           /* Timestamp of the last record */
+	uint32_t rebuilt_indexes;   /* Segments not closed, indexed on open */
+	uint32_t corrupt_records;   /* Records whose CRC failed, skipped */
+};
+
+/**
+ * hub_recording_open maps the segments of a recording read-only and places
+ * the reader on its first record. A segment not closed, e.g. by a crash, is
+ * read up to its last whole record and indexed by a scan. Needs no HUB
+ * handle.
+ *
+ * @param: p_path is the path given to hub_record_appdata()
+ * @param: p_recording is filled with the recording handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_RECORDING on failure
+ */
+enum hub_ret_code hub_recording_open(const char      *p_path,
+									 hub_recording_t *p_recording);
+
+/**
+ * hub_recording_get_info reads the totals of a recording.
+ */
+void hub_recording_get_info(hub_recording_t            recording,
+							struct hub_recording_info *p_info);
+
+/**
+ * hub_recording_seek places the reader on the first record at or after a
+ * time, with a binary search of the segments and of the index of the
+ * segment, then a walk of at most one index interval of records.
+ *
+ * @param: recording is the recording handle
+ * @param: timestamp_ns is the time since the start of the recording
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_RECORDING if no record is at or after the time
+ */
+enum hub_ret_code hub_recording_seek(hub_recording_t recording,
+									 uint64_t        timestamp_ns);
+
+/**
+ * hub_recording_next gives the record the reader is on and moves it to the
+ * next one. Records whose CRC fails are skipped and counted.
+ *
+ * @param: recording is the recording handle
+ * @param: p_entry is filled with the record
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_RECORDING at the end of the recording
+ */
+enum hub_ret_code hub_recording_next(hub_recording_t             recording,
+									 struct hub_recording_entry *p_entry);
+
+/**
+ * hub_recording_close unmaps the segments and frees the recording handle.
+ */
+void hub_recording_close(hub_recording_t recording);
+
+/******************************************************************************
+ * HUB daemon and client APIs
+ ******************************************************************************/
+/**
+ * hub_daemon_serve makes the calling process a HUB daemon: it serves the
+ * register and data transfers of HUB clients, see hub_client_connect(), on
+ * a Unix socket until *p_stop is non-zero, e.g. set by a signal handler. Each
+ * client is served by a thread of its own. The bus sessions and GPIO lines
+ * of the HUB stay set up for as long as the daemon runs, so clients attach
+ * and restart without going through discovery and bus setup again.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_socket_path is the path of the socket to create
+ * @param: p_stop is polled to stop serving
+ *
+ * @return: HUB_SUCCESS once stopped
+ *			HUB_FAILURE_DAEMON if the socket cannot be set up
+ */
+enum hub_ret_code hub_daemon_serve(hub_handle_t   hub,
+								   const char    *p_socket_path,
+								   volatile int  *p_stop);
+
+/* Opaque handle to a connection to a HUB daemon */
+typedef void *hub_client_handle_t;
+
+/**
+ * hub_client_connect attaches to the HUB daemon serving a socket. The GARDs
+ * of the daemon are then used by their gard_num, as with
+ * hub_get_gard_handle(). A client handle may be used by several threads.
+ *
+ * @param: p_socket_path is the socket of the daemon
+ * @param: p_client is filled with the client handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_DAEMON on failure
+ */
+enum hub_ret_code hub_client_connect(const char          *p_socket_path,
+									 hub_client_handle_t *p_client);
+
+/**
+ * hub_client_disconnect detaches from the HUB daemon and frees the client
+ * handle.
+ */
+void hub_client_disconnect(hub_client_handle_t client);
+
+/**
+ * hub_client_get_num_gards gives the number of GARDs of the HUB daemon.
+ */
+uint32_t hub_client_get_num_gards(hub_client_handle_t client);
+
+/**
+ * Register and data transfers through the HUB daemon: same as
+ * hub_read_gard_reg(), hub_write_gard_reg(), hub_send_data_to_gard() and
+ * hub_recv_data_from_gard() on GARD gard_num of the daemon. Data transfers
+ * are of at most 16 MiB.
+ */
+enum hub_ret_code hub_client_read_gard_reg(hub_client_handle_t client,
+										   uint32_t            gard_num,
+										   uint32_t            reg_addr,
+										   uint32_t           *p_value);
+
+enum hub_ret_code hub_client_write_gard_reg(hub_client_handle_t client,
+											uint32_t            gard_num,
+											uint32_t            reg_addr,
+											uint32_t            value);
+
+enum hub_ret_code hub_client_send_data_to_gard(hub_client_handle_t client,
+											   uint32_t            gard_num,
+											   const void         *p_buffer,
+											   uint32_t            addr,
+											   uint32_t            count);
+
+enum hub_ret_code hub_client_recv_data_from_gard(hub_client_handle_t client,
+												 uint32_t            gard_num,
+												 void               *p_buffer,
+												 uint32_t            addr,
+												 uint32_t            count);
+
+/******************************************************************************
+ * HUB shared memory publishing APIs
+ ******************************************************************************/
+enum hub_shm_record_type {
+	HUB_SHM_RECORD_APPDATA = 0, /* An app data result, as given to callbacks */
+	HUB_SHM_RECORD_SNAPSHOT,    /* Given to hub_publish_snapshot() */
+};
+
+/**
+ * One record of a shared memory ring. p_data points into the ring, it is
+ * valid until the publisher writes num_slots more records.
+ */
+struct hub_shm_record {
+	uint64_t    seq; /* From 1, in publishing order */
+	uint64_t    timestamp_ns; /* CLOCK_MONOTONIC when published */
+	uint32_t    type; /* enum hub_shm_record_type */
+	uint32_t    gard_index;
+	uint32_t    size;
+	const void *p_data;
+};
+
+/**
+ * hub_publish_appdata makes every app data result of a GARD, as given to
+ * the callbacks of hub_setup_appdata_cb(), hub_setup_appdata_ring_cb() and
+ * hub_subscribe_appdata(), also go to a ring of num_slots records in the
+ * POSIX shared memory object p_shm_name. Other processes on the host read
+ * them with hub_shm_reader_attach(), without owning the GARD. Results larger
+ * than slot_size are not published.
+ *
+ * @param: gard is the GARD handle
+ * @param: p_shm_name is the name of the shared memory object, e.g. "/gard0"
+ * @param: num_slots is the number of records the ring holds
+ * @param: slot_size is the size of the largest record
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SHM_RING on failure
+ */
+enum hub_ret_code hub_publish_appdata(gard_handle_t gard,
+									  const char   *p_shm_name,
+									  uint32_t      num_slots,
+									  uint32_t      slot_size);
+
+/**
+ * hub_unpublish_appdata removes the ring of a GARD. Readers then get
+ * HUB_FAILURE_SHM_RING once they have read the records left. Must not run
+ * while app data is delivered; hub_fini() calls it for every GARD.
+ *
+ * @param: gard is the GARD handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SHM_RING on failure
+ */
+enum hub_ret_code hub_unpublish_appdata(gard_handle_t gard);
+
+/**
+ * hub_publish_snapshot adds a record of type HUB_SHM_RECORD_SNAPSHOT, e.g.
+ * an image from hub_capture_rescaled_image_from_gard(), to the ring of a
+ * GARD.
+ *
+ * @param: gard is the GARD handle
+ * @param: p_buffer is the snapshot
+ * @param: size is the size of the snapshot, at most the slot size
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SHM_RING if the GARD does not publish or the
+ *			snapshot is too large
+ */
+enum hub_ret_code hub_publish_snapshot(gard_handle_t gard,
+									   const void   *p_buffer,
+									   uint32_t      size);
+
+/* Opaque handle to a reader of a shared memory ring */
+typedef void *hub_shm_reader_t;
+
+/**
+ * hub_shm_reader_attach maps the ring p_shm_name read-only. The reader
+ * starts with the records published after it attaches. Needs no HUB handle.
+ *
+ * @param: p_shm_name is the name given to hub_publish_appdata()
+ * @param: p_reader is filled with the reader handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SHM_RING on failure
+ */
+enum hub_ret_code hub_shm_reader_attach(const char       *p_shm_name,
+										hub_shm_reader_t *p_reader);
+
+/**
+ * hub_shm_reader_next gives the next record of the ring, waiting up to
+ * timeout_ms for one to be published. The record is read in place: check it
+ * with hub_shm_reader_done() once done with its data.
+ *
+ * @param: reader is the reader handle
+ * @param: p_record is filled with the record
+ * @param: timeout_ms is how long to wait, 0 not to wait
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if no record came in time
+ *			HUB_FAILURE_SHM_RING if the ring was removed
+ */
+enum hub_ret_code hub_shm_reader_next(hub_shm_reader_t       reader,
+									  struct hub_shm_record *p_record,
+									  uint32_t               timeout_ms);
+
+/**
+ * hub_shm_reader_done tells if the data of a record stayed intact while it
+ * was read. A reader that falls behind by the ring size sees its record
+ * written over: the data read is then to be dropped.
+ *
+ * @return: HUB_SUCCESS if the data read is valid
+ *			HUB_FAILURE_SHM_RING if the record was written over
+ */
+enum hub_ret_code hub_shm_reader_done(hub_shm_reader_t             reader,
+									  const struct hub_shm_record *p_record);
+
+/**
+ * hub_shm_reader_lost gives the number of records the reader missed by
+ * falling behind.
+ */
+uint64_t hub_shm_reader_lost(hub_shm_reader_t reader);
+
+/**
+ * hub_shm_reader_detach unmaps the ring and frees the reader handle.
+ */
+void hub_shm_reader_detach(hub_shm_reader_t reader);
+
+/* Levels of the HUB log, a level logs the ones before it too */
+enum hub_log_level {
+	HUB_LOG_LEVEL_ERR = 0,
+	HUB_LOG_LEVEL_WARN,
+	HUB_LOG_LEVEL_INFO,
+	HUB_LOG_LEVEL_DBG, /* Debug prints are built with HUB_DEBUG only */
+};
+
+/* Formats of the lines the log writer thread writes */
+enum hub_log_format {
+	HUB_LOG_FORMAT_TEXT = 0,
+	HUB_LOG_FORMAT_BINARY, /* struct hub_log_bin_record, then its strings */
+};
+
+/**
+ * A record of HUB_LOG_FORMAT_BINARY. It is followed by file_len bytes of the
+ * source file, func_len of the function and msg_len of the message, none of
+ * them NUL terminated. Fields are in the byte order of the Host.
+ */
+struct hub_log_bin_record {
+	uint32_t magic; /* HUB_LOG_BIN_MAGIC */
+	uint8_t  level; /* enum hub_log_level */
+	uint8_t  rsvd1[3];
+	uint64_t time_ns; /* CLOCK_MONOTONIC, when logged */
+	uint32_t thread_id;
+	uint32_t line;
+	uint32_t suppressed; /* Records of the call site not logged before it */
+	uint16_t file_len;
+	uint16_t func_len;
+	uint32_t msg_len;
+	uint32_t rsvd2;
+};
+
+#define HUB_LOG_BIN_MAGIC (0x474f4c48u) /* "HLOG" */
+
+/**
+ * Settings of the log writer thread, see hub_log_start(). 0 in a field takes
+ * its default.
+ */
+struct hub_log_cfg {
+	enum hub_log_format format;
+	/* Records a thread can have waiting for the writer, 256 by default */
+	uint32_t ring_records;
+	/* Records a call site logs per second, the others only counted; 0 logs
+	 * them all */
+	uint32_t rate_limit;
+	/* File the records are appended to, NULL for stdout and stderr */
+	const char *p_path;
+};
+
+/* Counts of the HUB log since the process started */
+struct hub_log_stats {
+	uint64_t records_logged;
+	uint64_t records_dropped;    /* The ring of the thread was full */
+	uint64_t records_suppressed; /* Over the rate limit of the call site */
+};
+
+/**
+ * hub_log_start moves the HUB log to a writer thread. The threads logging
+ * then only format their record into a ring of their own, without a lock or
+ * a write to stdout / stderr, so that a log never holds up a bus transfer;
+ * records that find the ring full are dropped and counted. Until started,
+ * and once stopped, records are written by the thread logging them. The log
+ * is of the process, not of a HUB handle.
+ *
+ * @param: p_cfg is the settings, NULL for the defaults
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_LOG if already started, or it could not be started
+ */
+enum hub_ret_code hub_log_start(const struct hub_log_cfg *p_cfg);
+
+/**
+ * hub_log_stop writes the records left and stops the writer thread.
+ */
+void hub_log_stop(void);
+
+/**
+ * hub_log_set_level sets the most verbose level logged from now on,
+ * HUB_LOG_LEVEL_DBG by default.
+ */
+void hub_log_set_level(enum hub_log_level level);
+
+/**
+ * hub_log_get_stats reads the counts of the HUB log.
+ */
+void hub_log_get_stats(struct hub_log_stats *p_stats);
+
 #endif /* __HUB_H__ */
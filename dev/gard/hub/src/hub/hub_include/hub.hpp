@@ -0,0 +1,430 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_HPP__
+#define __HUB_HPP__
+
+/**
+ * Header-only C++20 wrapper of hub.h.
+ *
+ * hub::Hub owns a HUB instance from hub_preinit() to hub_fini(), and
+ * hub::Gard is a view of one of its GARDs, valid as long as the Hub. The
+ * calls return hub::expected, holding the value or the hub_ret_code of the
+ * failure, std::expected where the standard library has it.
+ *
+ * Data moves between GARD and the caller's memory as std::span, without
+ * copies. The results of an appdata ring are handed over as
+ * hub::ResultBuffer, a move-only view of a ring buffer which goes back to
+ * HUB when destroyed. They must be destroyed before the Hub.
+ *
+ *	auto hub = hub::Hub::open("/opt/hub/config/host_config.json",
+ *							  "/opt/hub/config");
+ *	if (!hub) {
+ *		return hub.error();
+ *	}
+ *	auto gard = hub->gard(0);
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+#ifdef __cpp_lib_expected
+#include <expected>
+#endif
+
+extern "C" {
+#include "hub.h"
+}
+
+namespace hub
+{
+
+#ifdef __cpp_lib_expected
+
+template <class T> using expected = std::expected<T, hub_ret_code>;
+
+inline std::unexpected<hub_ret_code> unexpected(hub_ret_code ret)
+{
+	return std::unexpected<hub_ret_code>(ret);
+}
+
+#else
+
+/* Failure of an expected, see hub::unexpected() */
+struct unexpected_ret {
+	hub_ret_code ret;
+};
+
+inline unexpected_ret unexpected(hub_ret_code ret)
+{
+	return unexpected_ret{ret};
+}
+
+/**
+ * The subset of std::expected<T, hub_ret_code> used here, for standard
+ * libraries without it.
+ */
+template <class T> class expected
+{
+  public:
+	expected(T value) : m_value(std::move(value)), m_ret(HUB_SUCCESS) {}
+	expected(unexpected_ret failure) : m_ret(failure.ret) {}
+
+	bool has_value() const noexcept { return m_ret == HUB_SUCCESS; }
+	explicit operator bool() const noexcept { return has_value(); }
+	hub_ret_code error() const noexcept { return m_ret; }
+
+	T       &value() & { return *m_value; }
+	const T &value() const & { return *m_value; }
+	T      &&value() && { return std::move(*m_value); }
+	T       &operator*() & { return *m_value; }
+	const T &operator*() const & { return *m_value; }
+	T      &&operator*() && { return std::move(*m_value); }
+	T       *operator->() { return &*m_value; }
+	const T *operator->() const { return &*m_value; }
+
+  private:
+	std::optional<T> m_value;
+	hub_ret_code     m_ret;
+};
+
+template <> class expected<void>
+{
+  public:
+	expected() : m_ret(HUB_SUCCESS) {}
+	expected(unexpected_ret failure) : m_ret(failure.ret) {}
+
+	bool has_value() const noexcept { return m_ret == HUB_SUCCESS; }
+	explicit operator bool() const noexcept { return has_value(); }
+	hub_ret_code error() const noexcept { return m_ret; }
+
+  private:
+	hub_ret_code m_ret;
+};
+
+#endif
+
+namespace detail
+{
+
+inline expected<void> check(hub_ret_code ret)
+{
+	if (ret != HUB_SUCCESS) {
+		return unexpected(ret);
+	}
+	return {};
+}
+
+/* Ranges whose elements can be moved to and from GARD as bytes */
+template <class R>
+concept byte_range =
+	std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+	std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+/* State of an appdata ring, kept by the Hub until hub_fini() */
+struct appdata_ring;
+
+/* State of a Hub, at a fixed address for the GARD views and callbacks */
+struct hub_state {
+	hub_handle_t                               handle = nullptr;
+	std::vector<std::unique_ptr<appdata_ring>> rings;
+};
+
+} // namespace detail
+
+/**
+ * A result of an appdata ring, held until destroyed or release()d. It is not
+ * written by HUB meanwhile.
+ */
+class ResultBuffer
+{
+  public:
+	ResultBuffer() = default;
+	ResultBuffer(gard_handle_t gard, std::byte *p_data, std::size_t size)
+		: m_gard(gard), m_data(p_data, size)
+	{
+	}
+
+	ResultBuffer(const ResultBuffer &)            = delete;
+	ResultBuffer &operator=(const ResultBuffer &) = delete;
+
+	ResultBuffer(ResultBuffer &&other) noexcept
+		: m_gard(std::exchange(other.m_gard, nullptr)),
+		  m_data(std::exchange(other.m_data, {}))
+	{
+	}
+
+	ResultBuffer &operator=(ResultBuffer &&other) noexcept
+	{
+		if (this != &other) {
+			release();
+			m_gard = std::exchange(other.m_gard, nullptr);
+			m_data = std::exchange(other.m_data, {});
+		}
+		return *this;
+	}
+
+	~ResultBuffer() { release(); }
+
+	std::span<const std::byte> data() const noexcept { return m_data; }
+	std::size_t                size() const noexcept { return m_data.size(); }
+
+	/* Hands the buffer back to HUB, to be filled again */
+	void release() noexcept
+	{
+		if (m_gard != nullptr) {
+			(void)hub_release_appdata_buffer(m_gard, m_data.data());
+			m_gard = nullptr;
+			m_data = {};
+		}
+	}
+
+  private:
+	gard_handle_t        m_gard = nullptr;
+	std::span<std::byte> m_data;
+};
+
+/**
+ * Handler of the results of an appdata ring, called from a HUB thread. A
+ * failed fetch is passed as an error.
+ */
+using ResultHandler = std::function<void(expected<ResultBuffer>)>;
+
+namespace detail
+{
+
+struct appdata_ring {
+	gard_handle_t                             gard;
+	ResultHandler                             handler;
+	std::vector<std::unique_ptr<std::byte[]>> buffers;
+
+	static void *callback(void *p_ctx, void *p_buffer, uint32_t size)
+	{
+		auto *p_ring = static_cast<appdata_ring *>(p_ctx);
+
+		if (size == 0) {
+			p_ring->handler(unexpected(HUB_FAILURE_RECV_APP_DATA));
+		} else {
+			p_ring->handler(ResultBuffer(
+				p_ring->gard, static_cast<std::byte *>(p_buffer), size));
+		}
+		return nullptr;
+	}
+};
+
+} // namespace detail
+
+/**
+ * A GARD of a Hub. It is a plain view, copied freely, and valid as long as
+ * the Hub it came from.
+ */
+class Gard
+{
+  public:
+	Gard(gard_handle_t handle, detail::hub_state *p_hub)
+		: m_handle(handle), m_hub(p_hub)
+	{
+	}
+
+	gard_handle_t handle() const noexcept { return m_handle; }
+
+	expected<uint32_t> read_reg(uint32_t addr) const
+	{
+		uint32_t value = 0;
+
+		if (auto ret = hub_read_gard_reg(m_handle, addr, &value);
+			ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+		return value;
+	}
+
+	expected<void> write_reg(uint32_t addr, uint32_t value) const
+	{
+		return detail::check(hub_write_gard_reg(m_handle, addr, value));
+	}
+
+	/* Sends the bytes of data to addr in the GARD memory map */
+	template <detail::byte_range R>
+	expected<void> send(uint32_t addr, const R &data) const
+	{
+		auto bytes = std::as_bytes(std::span(data));
+
+		if (bytes.size() > UINT32_MAX) {
+			return unexpected(HUB_FAILURE_SEND_DATA);
+		}
+		return detail::check(hub_send_data_to_gard(
+			m_handle, bytes.data(), addr, static_cast<uint32_t>(bytes.size())));
+	}
+
+	/* Fills the bytes of data from addr in the GARD memory map */
+	template <detail::byte_range R>
+	expected<void> recv(uint32_t addr, R &&data) const
+	{
+		auto bytes = std::as_writable_bytes(std::span(data));
+
+		if (bytes.size() > UINT32_MAX) {
+			return unexpected(HUB_FAILURE_RECV_DATA);
+		}
+		return detail::check(hub_recv_data_from_gard(
+			m_handle, bytes.data(), addr, static_cast<uint32_t>(bytes.size())));
+	}
+
+	/**
+	 * Sends an App Module command, see hub_send_app_command(), and returns
+	 * the status its handler on GARD returned.
+	 */
+	template <detail::byte_range R>
+	expected<uint32_t> send_app_command(uint8_t command_id, const R &body) const
+	{
+		auto     bytes  = std::as_bytes(std::span(body));
+		uint32_t status = 0;
+
+		if (auto ret = hub_send_app_command(
+				m_handle, command_id, bytes.empty() ? nullptr : bytes.data(),
+				static_cast<uint32_t>(bytes.size()), &status);
+			ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+		return status;
+	}
+
+	expected<uint32_t> send_app_command(uint8_t command_id) const
+	{
+		return send_app_command(command_id, std::span<const std::byte>());
+	}
+
+	/**
+	 * Sets up a ring of num_buffers buffers of size bytes for the App Module
+	 * data, see hub_setup_appdata_ring_cb(). The buffers are allocated here
+	 * and kept by the Hub until it is destroyed.
+	 */
+	expected<void> setup_appdata_ring(uint32_t      num_buffers,
+									  uint32_t      size,
+									  ResultHandler handler) const
+	{
+		auto                p_ring = std::make_unique<detail::appdata_ring>();
+		std::vector<void *> buffers;
+
+		p_ring->gard    = m_handle;
+		p_ring->handler = std::move(handler);
+		for (uint32_t i = 0; i < num_buffers; i++) {
+			p_ring->buffers.push_back(std::make_unique<std::byte[]>(size));
+			buffers.push_back(p_ring->buffers.back().get());
+		}
+
+		if (auto ret = hub_setup_appdata_ring_cb(
+				m_handle, detail::appdata_ring::callback, p_ring.get(),
+				buffers.data(), num_buffers, size);
+			ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+
+		m_hub->rings.push_back(std::move(p_ring));
+		return {};
+	}
+
+  private:
+	gard_handle_t      m_handle;
+	detail::hub_state *m_hub;
+};
+
+/**
+ * A HUB instance, from hub_preinit() to hub_fini(). Move-only.
+ */
+class Hub
+{
+  public:
+	/**
+	 * Pre-initializes HUB, discovers the GARDs and initializes HUB, see
+	 * hub_preinit(), hub_discover_gards() and hub_init_with_options().
+	 * p_options NULL takes the options of host_config.json.
+	 */
+	static expected<Hub> open(const char                    *p_host_config,
+							  const char                    *p_gard_json_dir,
+							  const struct hub_init_options *p_options = nullptr)
+	{
+		Hub          hub;
+		hub_handle_t handle = nullptr;
+
+		/* hub_preinit() does not write the paths */
+		if (auto ret = hub_preinit(const_cast<char *>(p_host_config),
+								   const_cast<char *>(p_gard_json_dir), &handle);
+			ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+		hub.m_state->handle = handle;
+
+		if (auto ret = hub_discover_gards(handle); ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+
+		if (auto ret = hub_init_with_options(handle, p_options);
+			ret != HUB_SUCCESS) {
+			return unexpected(ret);
+		}
+
+		return hub;
+	}
+
+	Hub(const Hub &)            = delete;
+	Hub &operator=(const Hub &) = delete;
+	Hub(Hub &&) noexcept        = default;
+
+	Hub &operator=(Hub &&other) noexcept
+	{
+		if (this != &other) {
+			close();
+			m_state = std::move(other.m_state);
+		}
+		return *this;
+	}
+
+	~Hub() { close(); }
+
+	hub_handle_t handle() const noexcept { return m_state->handle; }
+
+	uint32_t num_gards() const { return hub_get_num_gards(m_state->handle); }
+
+	expected<Gard> gard(uint8_t gard_num) const
+	{
+		gard_handle_t handle = hub_get_gard_handle(m_state->handle, gard_num);
+
+		if (handle == nullptr) {
+			return unexpected(HUB_FAILURE_GARD_PROBE);
+		}
+		return Gard(handle, m_state.get());
+	}
+
+  private:
+	Hub() : m_state(std::make_unique<detail::hub_state>()) {}
+
+	/* The rings go after hub_fini(), which stops their callbacks */
+	void close() noexcept
+	{
+		if (m_state && m_state->handle != nullptr) {
+			(void)hub_fini(m_state->handle);
+			m_state->handle = nullptr;
+		}
+		m_state.reset();
+	}
+
+	std::unique_ptr<detail::hub_state> m_state;
+};
+
+} // namespace hub
+
+#endif /* __HUB_HPP__ */
@@ -8,13 +8,16 @@
 #ifndef __GARD_INFO_H__
 #define __GARD_INFO_H__
 
+#include <sys/uio.h>
+
 #include "hub.h"
 #include "gard_hub_iface.h"
 #include "types.h"
 #include "hub_threading.h"
+#include "hub_log.h"
 
 /**
- * MIN MAX functions for uint32_t and int32_t
+ * MIN MAX functions for uint32_t, int32_t and uint64_t
  */
 static inline uint32_t hub_min_uint32(uint32_t a, uint32_t b)
 {
@@ -36,6 +39,16 @@ static inline int32_t hub_max_int32(int32_t a, int32_t b)
 	return (a > b) ? a : b;
 }
 
+static inline uint64_t hub_min_uint64(uint64_t a, uint64_t b)
+{
+	return (a < b) ? a : b;
+}
+
+static inline uint64_t hub_max_uint64(uint64_t a, uint64_t b)
+{
+	return (a > b) ? a : b;
+}
+
 /* HUB handle / context states */
 enum hub_ctx_state {
 	HUB_IN_ERROR = -1,
@@ -53,31 +66,23 @@ enum hub_gard_probe_method {
 	NR_HUB_GARD_PROBE_METHODS,
 };
 
-/* HUB info prints */
-#define hub_pr_info(fmt, args...)                                              \
-	fprintf(stdout, "HUB_INFO: %s:%d:%s(): " fmt, __FILE__, __LINE__,          \
-			__func__, ##args)
+/* HUB info prints, see hub_log.h for where they go */
+#define hub_pr_info(fmt, args...) hub_log(HUB_LOG_LEVEL_INFO, fmt, ##args)
 
 /**
  * HUB debug prints: #define HUB_DEBUG for debug prints in HUB's Makefile.vars
  */
 #if defined(HUB_DEBUG)
-#define hub_pr_dbg(fmt, args...)                                               \
-	fprintf(stdout, "HUB_DBG: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, \
-			##args)
+#define hub_pr_dbg(fmt, args...) hub_log(HUB_LOG_LEVEL_DBG, fmt, ##args)
 #else
 #define hub_pr_dbg(fmt, args...) /* Don't do anything in non-debug builds */
 #endif
 
 /* HUB error prints */
-#define hub_pr_err(fmt, args...)                                               \
-	fprintf(stderr, "HUB_ERR: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, \
-			##args)
+#define hub_pr_err(fmt, args...) hub_log(HUB_LOG_LEVEL_ERR, fmt, ##args)
 
 /* HUB warn prints */
-#define hub_pr_warn(fmt, args...)                                              \
-	fprintf(stdout, "HUB_WARN: %s:%d:%s(): " fmt, __FILE__, __LINE__,          \
-			__func__, ##args)
+#define hub_pr_warn(fmt, args...) hub_log(HUB_LOG_LEVEL_WARN, fmt, ##args)
 
 /* Properties of an I2C bus on HUB */
 struct hub_gard_bus_i2c_props {
@@ -86,22 +91,74 @@ struct hub_gard_bus_i2c_props {
 	uint32_t num;
 	uint32_t slave_id;
 	uint32_t speed;
+	uint32_t adapter_speed; /* Read back at open, 0 if unknown */
 };
 
 /* Properties of a UART bus on HUB */
+/**
+ * When the UART output queue is drained (tcdrain) on writes:
+ * 1. NEVER: never, the kernel drains the queue in the background
+ * 2. PER_XFER: once at the end of each vectored (whole command) write
+ * 3. PER_WRITE: after every write, the legacy behaviour
+ */
+enum hub_uart_flush_policy {
+	HUB_UART_FLUSH_NEVER = 0,
+	HUB_UART_FLUSH_PER_XFER,
+	HUB_UART_FLUSH_PER_WRITE,
+};
+
+/**
+ * UART bus properties.
+ *
+ * baudrate is the rate the bus is opened at (and GARD discovered at).
+ * If target_baudrate is non-zero, HUB asks GARD to step up to it after
+ * discovery (SET_UART_PARAMETERS) and then follows on the host side.
+ * The bus is opened without RTS/CTS: hw_flow_control is asked for the same
+ * way, and only turned on on the host side once GARD has ACKed it.
+ * Reads time out after read_timeout_ms, or after probe_timeout_ms while
+ * is_probing is set, during discovery, so that a bus with no GARD on it
+ * does not hold up hub_discover_gards().
+ */
 struct hub_gard_bus_uart_props {
-	int      bus_hdl;
-	bool     is_open;
-	char     bus_dev[PATH_MAX];
-	uint32_t baudrate;
+	int                        bus_hdl;
+	bool                       is_open;
+	char                       bus_dev[PATH_MAX];
+	uint32_t                   baudrate;
+	enum hub_uart_flush_policy flush_policy;
+	bool                       hw_flow_control;
+	bool                       hw_flow_control_on; /* Once GARD has ACKed */
+	uint32_t                   target_baudrate;
+	uint32_t                   base_baudrate; /* Before step up, 0 if none */
+	uint32_t                   read_timeout_ms;
+	uint32_t                   probe_timeout_ms;
+	bool                       is_probing;
+	uint32_t                   rx_ring_size;
 };
 
-/* Properties of a USB bus on HUB */
+/* Sizes of the strings selecting one of several identical USB devices */
+#define HUB_USB_PORT_PATH_LEN 32
+#define HUB_USB_SERIAL_LEN    64
+
+/* Libusb state of an open USB bus, private to hub_usb.c */
+struct usb_bus_hdl_map;
+
+/**
+ * Properties of a USB bus on HUB
+ *
+ * port_path ("<bus>-<port>[.<port>...]") and serial_number are optional;
+ * when set, they pick the device among those with matching vendor_id and
+ * product_id.
+ */
 struct hub_gard_bus_usb_props {
-	int      bus_hdl;
-	bool     is_open;
-	uint32_t vendor_id;
-	uint32_t product_id;
+	int                     bus_hdl;
+	bool                    is_open;
+	uint32_t                vendor_id;
+	uint32_t                product_id;
+	char                    port_path[HUB_USB_PORT_PATH_LEN];
+	char                    serial_number[HUB_USB_SERIAL_LEN];
+	uint32_t                burst_size;
+	uint32_t                async_depth;
+	struct usb_bus_hdl_map *p_hdl_map;
 };
 
 /**
@@ -115,26 +172,97 @@ struct hub_usb_ops_map {
 	uint32_t addr;
 };
 
+/**
+ * Max number of buffers a single device_writev / device_readv call takes.
+ * A HUB command is at most cmd id + body + payload + eod.
+ */
+#define HUB_GARD_BUS_MAX_IOVCNT (8)
+
 /**
  * The file operations structure for a HUB bus.
  * Functions for all busses need to adhere to this API.
+ *
+ * device_writev / device_readv move a whole HUB command (or response)
+ * scattered over several buffers in one bus transaction. They return the
+ * total number of bytes moved, like device_write / device_read.
+ * They are NULL for USB, whose data path goes through the blob ops.
  */
 struct hub_gard_bus_fops {
 	int32_t (*device_open)(void *params);
 	int32_t (*device_read)(int bus_hdl, void *p_buffer, uint32_t count);
 	int32_t (*device_write)(int bus_hdl, const void *p_buffer, uint32_t count);
+	int32_t (*device_readv)(int bus_hdl, const struct iovec *p_iov, int iovcnt);
+	int32_t (*device_writev)(int                 bus_hdl,
+							 const struct iovec *p_iov,
+							 int                 iovcnt);
 	int32_t (*device_close)(int bus_hdl);
 };
 
+/**
+ * Total number of bytes described by an iovec array
+ */
+static inline uint32_t hub_iov_len(const struct iovec *p_iov, int iovcnt)
+{
+	uint32_t len = 0;
+	int      i;
+
+	for (i = 0; i < iovcnt; i++) {
+		len += p_iov[i].iov_len;
+	}
+
+	return len;
+}
+
+/**
+ * What a GARD tells about itself in its GARD_DISCOVERY response, see struct
+ * _gard_discovery_response. is_valid is set once the bus has been discovered.
+ */
+struct hub_gard_identity {
+	bool     is_valid;
+	uint64_t device_id;    /* The same on all the buses of a GARD */
+	uint32_t profile_id;   /* gard_<profile_id>.json describes the GARD */
+	uint32_t fw_version;   /* Major << 16 | minor << 8 | bug fix */
+	uint32_t capabilities; /* enum gard_capabilities bits */
+	uint32_t max_mtu_size; /* Largest mtu_size GARD takes */
+};
+
+/**
+ * Queue of the asynchronous data blob transfers of an I2C / UART bus, run in
+ * turn by a worker thread started on the first one, see
+ * hub_write_data_blob_to_gard_async(). USB buses queue on their own engine.
+ */
+#define HUB_BUS_ASYNC_DEPTH (8)
+
+struct hub_bus_async_req;
+
+struct hub_bus_async {
+	hub_mutex_t               lock;
+	hub_cond_var_t            work_cond_var; /* Request queued or stop */
+	hub_cond_var_t            idle_cond_var; /* Queue emptied */
+	hub_thread_hdl_t          worker_thread;
+	struct hub_bus_async_req *p_head;
+	struct hub_bus_async_req *p_tail;
+	uint32_t                  num_queued; /* Incl. the one running */
+	uint32_t                  num_waiters; /* Waiting on idle_cond_var */
+	bool                      is_running;
+	bool                      terminate_flag;
+};
+
 /**
  * Structure for holding details and context of a HUB bus
  *
  * Note that we define an anon union for the exact bus, since
  * the bus can be only 1 of all possible types defined
  * in HUB.
+ *
+ * gard_index tells which GARD the bus is wired to when several GARD boards
+ * hang off the same host ("gard_index" in host_config.json, 0 by default).
+ * Discovery corrects it from the device ID GARD reports on each bus it
+ * answers on.
  */
 struct hub_gard_bus {
 	enum hub_gard_bus_types types;
+	uint32_t                gard_index;
 
 	union {
 		struct hub_gard_bus_i2c_props  i2c;
@@ -143,8 +271,181 @@ struct hub_gard_bus {
 	};
 	struct hub_gard_bus_fops fops;
 	hub_mutex_t              bus_mutex;
+
+	/* Filled in by discovery */
+	struct hub_gard_identity identity;
+	uint64_t                 bench_latency_ns; /* 0: not measured */
+
+	/* Last failed data transfer, 0 if none, see hub_gard_data_route() */
+	volatile uint64_t        failed_at_ns;
+
+	/* Arbitration between control and data transactions, see hub_bus_yield */
+	hub_cond_var_t           bus_yield_cond;
+	volatile uint32_t        num_ctrl_waiters;
+	uint32_t                 xfer_chunk_size; /* 0: no chunking */
+
+	/* Packetized send data, see hub_send_data_frames */
+	uint32_t                 mtu_size;   /* 0: payload sent in one go */
+	uint32_t                 mtu_window; /* Packets in flight, at least 1 */
+
+	/* CRC-32 checked send / recv data, see CC_CHECKSUM_PRESENT */
+	bool                     data_crc;
+
+	/* GPIO app data events drain all queued results, see CC_APP_DATA_BATCH */
+	bool                     app_data_batch;
+
+	/* Tagged commands sent during a data transfer, see hub_bus_pipeline_* */
+	bool                     cmd_pipelining;
+	hub_mutex_t              pipe_mutex;
+	hub_cond_var_t           pipe_cond;
+	bool                     pipe_open;     /* A data response is being read */
+	uint32_t                 num_pipelined; /* Tagged responses left to read */
+	uint8_t                  next_tag;
+	bool                     recv_segments; /* CC_SEGMENTED, GARD supports it */
+
+	/* Asynchronous data blob transfers, I2C / UART only */
+	struct hub_bus_async     async;
 };
 
+/**
+ * Limits for the packetized send data of a bus. Packet numbers are 16 bits,
+ * and a window is kept small so that a NAK does not resend a lot of data.
+ */
+#define HUB_MTU_SIZE_MAX    (0xFFFFU)
+#define HUB_MTU_WINDOW_MAX  (8)
+#define HUB_MTU_MAX_RETRIES (4)
+
+/**
+ * Short control transactions (register reads / writes, commands) take the
+ * bus with hub_bus_lock_ctrl() instead of locking bus_mutex directly. That
+ * lets a long data transfer on the same bus, split into commands of
+ * xfer_chunk_size, hand the bus over to them between two chunks with
+ * hub_bus_yield().
+ */
+static inline void hub_bus_lock_ctrl(struct hub_gard_bus *p_bus)
+{
+	__atomic_add_fetch(&p_bus->num_ctrl_waiters, 1, __ATOMIC_SEQ_CST);
+	hub_mutex_lock(&p_bus->bus_mutex);
+	__atomic_sub_fetch(&p_bus->num_ctrl_waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline void hub_bus_unlock_ctrl(struct hub_gard_bus *p_bus)
+{
+	/* The last waiting control transaction gives the bus back to data */
+	if (0 == __atomic_load_n(&p_bus->num_ctrl_waiters, __ATOMIC_SEQ_CST)) {
+		hub_cond_var_broadcast(&p_bus->bus_yield_cond);
+	}
+	hub_mutex_unlock(&p_bus->bus_mutex);
+}
+
+/**
+ * Called with bus_mutex held by a data transfer between two chunks. Returns
+ * at once unless control transactions are waiting for the bus, else lets
+ * them all run first.
+ */
+static inline void hub_bus_yield(struct hub_gard_bus *p_bus)
+{
+	while (__atomic_load_n(&p_bus->num_ctrl_waiters, __ATOMIC_SEQ_CST)) {
+		hub_cond_var_wait(&p_bus->bus_yield_cond, &p_bus->bus_mutex);
+	}
+}
+
+/**
+ * Tagged commands (see CMD_ID_TAGGED) on a bus with cmd_pipelining.
+ *
+ * While a data transfer holding bus_mutex reads a long response, it keeps
+ * the pipe open. A control transaction can then join the pipe instead of
+ * waiting for bus_mutex: it sends its tagged command right away, as GARD
+ * takes it in while still sending, and reads its tagged response once the
+ * pipe is closed. The data transfer keeps bus_mutex until then, so that
+ * nothing else goes on the bus in between. With recv_segments, GARD answers
+ * between two segments of the data and the data transfer closes the pipe
+ * there for a while, see hub_recv_data_segments().
+ *
+ * Only HUB_PIPELINE_DEPTH commands are sent ahead, which is what GARD takes.
+ */
+#define HUB_PIPELINE_DEPTH (1)
+
+static inline void hub_bus_pipeline_open(struct hub_gard_bus *p_bus)
+{
+	if (!p_bus->cmd_pipelining) {
+		return;
+	}
+
+	hub_mutex_lock(&p_bus->pipe_mutex);
+	p_bus->pipe_open = true;
+	hub_mutex_unlock(&p_bus->pipe_mutex);
+}
+
+/**
+ * Called by the data transfer once its response is read. Returns when the
+ * tagged responses sent meanwhile have been read too.
+ */
+static inline void hub_bus_pipeline_close(struct hub_gard_bus *p_bus)
+{
+	if (!p_bus->cmd_pipelining) {
+		return;
+	}
+
+	hub_mutex_lock(&p_bus->pipe_mutex);
+	p_bus->pipe_open = false;
+	hub_cond_var_broadcast(&p_bus->pipe_cond);
+	while (p_bus->num_pipelined) {
+		hub_cond_var_wait(&p_bus->pipe_cond, &p_bus->pipe_mutex);
+	}
+	hub_mutex_unlock(&p_bus->pipe_mutex);
+}
+
+/**
+ * Called by a control transaction instead of hub_bus_lock_ctrl(). Returns
+ * true with the tag to send if it joined the pipe, false if it has to take
+ * the bus as usual.
+ */
+static inline bool hub_bus_pipeline_join(struct hub_gard_bus *p_bus,
+										 uint8_t             *p_tag)
+{
+	bool joined = false;
+
+	if (!p_bus->cmd_pipelining) {
+		return false;
+	}
+
+	hub_mutex_lock(&p_bus->pipe_mutex);
+	if (p_bus->pipe_open && (p_bus->num_pipelined < HUB_PIPELINE_DEPTH)) {
+		*p_tag = p_bus->next_tag++;
+		p_bus->num_pipelined++;
+		joined = true;
+	}
+	hub_mutex_unlock(&p_bus->pipe_mutex);
+
+	return joined;
+}
+
+/**
+ * Called by a control transaction that joined the pipe, once its command is
+ * sent. Returns when its tagged response is next on the bus.
+ */
+static inline void hub_bus_pipeline_wait(struct hub_gard_bus *p_bus)
+{
+	hub_mutex_lock(&p_bus->pipe_mutex);
+	while (p_bus->pipe_open) {
+		hub_cond_var_wait(&p_bus->pipe_cond, &p_bus->pipe_mutex);
+	}
+	hub_mutex_unlock(&p_bus->pipe_mutex);
+}
+
+/**
+ * Called by a control transaction that joined the pipe, once its tagged
+ * response is read, or failed to be.
+ */
+static inline void hub_bus_pipeline_leave(struct hub_gard_bus *p_bus)
+{
+	hub_mutex_lock(&p_bus->pipe_mutex);
+	p_bus->num_pipelined--;
+	hub_cond_var_broadcast(&p_bus->pipe_cond);
+	hub_mutex_unlock(&p_bus->pipe_mutex);
+}
+
 /**
  * This is the back-end of the gard_handle_t.
  * Used internally for GARD operations.
@@ -153,15 +454,19 @@ struct hub_gard_bus {
  * 1. A control bus for register reads/writes
  * 2. A data bus for buffer reads/writes
  *
+ * Which bus to use for what is defined by the GARD's .json file parsed by
+ * HUB, or, if the file does not say, picked by HUB among the buses wired to
+ * the GARD: the fastest one the GARD can use for data, and the fastest
+ * other discovered one for control.
+ *
  * TBD-DPN:
- * Presently, which bus to use for what is defined by the
- * GARD's .json file parsed by HUB.
  * In future, HUB routines will maintain a state of bus state
  * and bus load, and switch from one bus to the other
  * in a transparent manner.
  */
 struct hub_gard_info {
 	hub_handle_t         hub;
+	uint32_t             gard_index;
 	uint32_t             gard_id;
 	char                 gard_name[PATH_MAX];
 	char                 gpio_chip[PATH_MAX];
@@ -171,6 +476,30 @@ struct hub_gard_info {
 	uint32_t            *gpio_outputs;
 	struct hub_gard_bus *control_bus;
 	struct hub_gard_bus *data_bus;
+
+	/**
+	 * The I2C / UART bus the GARD commands and app data go over: the data
+	 * bus, or the control bus if the data bus is USB
+	 */
+	struct hub_gard_bus *cmd_bus;
+
+	/* Data transfers go over it while the data bus fails, NULL if none */
+	struct hub_gard_bus *fallback_data_bus;
+
+	/* As reported on the bus the GARD was first discovered on */
+	struct hub_gard_identity identity;
+
+	/* Updated atomically, see hub_stats.c */
+	struct hub_gard_stats stats;
+
+	/* App Module data pushes, NULL unless subscribed, see hub_subscribe.c */
+	struct hub_subscribe_ctx *p_subscribe_ctx;
+
+	/* App data fan-out, NULL unless published, see hub_shm_ring.c */
+	struct hub_shm_ring *p_publish_ring;
+
+	/* App data recording, NULL until recorded, see hub_recorder.c */
+	struct hub_recorder *p_recorder;
 };
 
 /**
@@ -192,11 +521,38 @@ struct hub_ctx {
 	uint32_t                   num_busses;
 	uint32_t                   num_gards;
 	uint32_t                   num_gpio_threads;
+	enum hub_gpio_exec_model   gpio_exec_model;
+	uint32_t                   gpio_pool_size;
 	char                       gard_json_dir[PATH_MAX];
 	struct hub_gard_bus       *p_bus_props;
 	struct hub_gard_info      *p_gards;
 	struct hub_gpio_mon_ctx   *p_gpio_mon_ctx;
 	struct hub_gpio_event_ctx *p_gpio_event_ctx;
+
+	/* From hub_preinit() to the end of discovery, see hub_config_cache.c */
+	struct hub_config_cache   *p_config_cache;
+
+	/* GARD link monitoring, see hub_health.c */
+	uint32_t                   health_probe_ms; /* 0: no probes */
+	hub_gard_event_cb_t        gard_event_cb;
+	void                      *p_gard_event_ctx;
+	struct hub_health_ctx     *p_health_ctx;
+	uint32_t                   clock_sync_ms; /* 0: no clock syncs */
+
+	/* enum hub_log_level of host_config.json, -1 if it sets none */
+	int32_t                    log_level;
+
+	/* SoM sensor sampler, see hub_som_sensors.c */
+	struct hub_som_sampler_ctx *p_som_sampler_ctx;
+
+	/* Thermal and power governor, see hub_governor.c */
+	struct hub_governor_ctx    *p_governor_ctx;
+
+	/* Multi-GARD dispatch, see hub_pool.c */
+	struct hub_pool_ctx        *p_pool_ctx;
+
+	/* App data of all the GARDs for hub_wait_any(), see hub_wait_any.c */
+	struct hub_wait_any_ctx    *p_wait_any_ctx;
 };
 
 #endif /* __GARD_INFO_H__ */
\ No newline at end of file
@@ -5,12 +5,82 @@
  *
  ******************************************************************************/
 
+#include <stdlib.h>
+
 #include "hub_bulk_ops.h"
+#include "hub_data_ops.h"
+#include "hub_usb.h"
+
+/**
+ * Move a data blob over the locked USB data bus of a GARD, in AXI bursts.
+ *
+ * If the data bus has an "xfer_chunk_size", the blob goes in slices of at
+ * most that size, and register accesses and commands waiting for the bus,
+ * as well as queued asynchronous transfers, get it between two slices.
+ *
+ * @param: p_bus is the USB data bus, its bus_mutex held
+ * @param: is_read true for a read, false for a write
+ * @param: p_buffer is the buffer to read into / write from
+ * @param: addr is the address in HRAM to read from / write to
+ * @param: count is the number of bytes to transfer
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_xfer_data_blob_on_usb(struct hub_gard_bus *p_bus,
+									 bool                 is_read,
+									 void                *p_buffer,
+									 uint32_t             addr,
+									 uint32_t             count)
+{
+	ssize_t                nxfer;
+	uint32_t               offset, chunk_size;
+	struct hub_usb_ops_map usb_ops;
+
+	offset = 0;
+	do {
+		chunk_size = count - offset;
+		if (p_bus->xfer_chunk_size) {
+			chunk_size = hub_min_uint32(chunk_size, p_bus->xfer_chunk_size);
+		}
+
+		if (offset) {
+			hub_bus_yield(p_bus);
+		}
+
+		/* Note the opaque bundling of p_buffer and addr for USB */
+		usb_ops.p_buffer = (uint8_t *)p_buffer + offset;
+		usb_ops.addr     = addr + offset;
+		if (is_read) {
+			nxfer = p_bus->fops.device_read(p_bus->usb.bus_hdl,
+											(void *)&usb_ops, chunk_size);
+		} else {
+			nxfer = p_bus->fops.device_write(
+				p_bus->usb.bus_hdl, (const void *)&usb_ops, chunk_size);
+		}
+
+		if ((ssize_t)chunk_size != nxfer) {
+			hub_pr_err("%s_blob moved %u of %u bytes @ 0x%x\n",
+					   is_read ? "read" : "write",
+					   offset + ((nxfer > 0) ? (uint32_t)nxfer : 0), count,
+					   addr);
+			return -1;
+		}
+
+		offset += chunk_size;
+	} while (offset < count);
+
+	return 0;
+}
 
 /**
  * Write a data blob of a specified size from a given buffer
  * to an address in the SOM's HRAM represented by the gard handle.
  *
+ * On USB the blob goes out in AXI bursts, see hub_xfer_data_blob_on_usb().
+ * On I2C / UART it goes out in SEND_DATA_TO_GARD_FOR_OFFSET commands,
+ * chunked and packetized as set for the data bus, see
+ * hub_send_data_on_bus().
+ *
  * @param: p_gard_handle is the GARD handle to use for write blob
  * @param: p_buffer is a buffer containing data to write
  * @param: addr is the address in HRAM to write to
@@ -24,8 +94,6 @@ enum hub_ret_code hub_write_data_blob_to_gard(gard_handle_t p_gard_handle,
 											  uint32_t      addr,
 											  uint32_t      count)
 {
-	enum hub_ret_code       ret;
-	int                     bus_hdl;
 	enum hub_gard_bus_types bus_type;
 
 	struct hub_gard_info   *gard = NULL;
@@ -34,10 +102,13 @@ enum hub_ret_code hub_write_data_blob_to_gard(gard_handle_t p_gard_handle,
 
 	bus_type                     = gard->data_bus->types;
 	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+	case HUB_GARD_BUS_UART:
+		return hub_send_data_on_bus(gard, gard->data_bus, p_buffer, addr,
+									count);
 	case HUB_GARD_BUS_USB:
 		/* Lock the data bus mutex before bus operations */
 		hub_mutex_lock(&gard->data_bus->bus_mutex);
-		bus_hdl = gard->data_bus->fops.device_open(&gard->data_bus->usb);
 		break;
 	default:
 		hub_pr_err("%s: Bus not supported for write_data_blob!\n",
@@ -45,22 +116,14 @@ enum hub_ret_code hub_write_data_blob_to_gard(gard_handle_t p_gard_handle,
 		goto err_write_blob_1;
 	}
 
-	if (bus_hdl < 0) {
-		hub_pr_err("Error opening USB bus for write_blob\n");
+	/* Opened once by hub_discover_gards(), for all the transfers */
+	if (!gard->data_bus->usb.is_open) {
+		hub_pr_err("USB bus not open for write_blob\n");
 		goto err_write_blob_2;
 	}
 
-	struct hub_usb_ops_map usb_ops = {
-		.p_buffer = (void *)p_buffer,
-		.addr     = addr,
-	};
-
-	/* Note the opaque bundling of p_buffer and addr for USB */
-	ssize_t nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, (const void *)&usb_ops, count);
-	/* Also note we check for 1 to adhere to Python code */
-	/* if (count != nwrite) { code commented for try-out */
-	if (1 != nwrite) {
+	if (hub_xfer_data_blob_on_usb(gard->data_bus, false, (void *)p_buffer,
+								  addr, count)) {
 		hub_pr_err("Error sending write_blob data\n");
 		goto err_write_blob_2;
 	}
@@ -74,10 +137,7 @@ enum hub_ret_code hub_write_data_blob_to_gard(gard_handle_t p_gard_handle,
 	return HUB_SUCCESS;
 
 err_write_blob_2:
-	if (bus_hdl >= 0) {
-		ret = gard->data_bus->fops.device_close(bus_hdl);
-		(void)ret;
-	}
+	/* The bus session outlives a failed transfer */
 	hub_mutex_unlock(&gard->data_bus->bus_mutex);
 err_write_blob_1:
 	return HUB_FAILURE_SEND_DATA;
@@ -87,6 +147,10 @@ err_write_blob_1:
  * Read a data blob of a specified size from a given buffer
  * from an address in the SOM's HRAM represented by the gard handle.
  *
+ * On USB the blob comes in AXI bursts, see hub_xfer_data_blob_on_usb().
+ * On I2C / UART it comes in RECV_DATA_FROM_GARD_AT_OFFSET commands, chunked
+ * as set for the data bus, see hub_recv_data_on_bus().
+ *
  * @param: p_gard_handle is the GARD handle for preforming the read blo
  * @param: p_buffer is a buffer to be filled on successful rea
  * @param: addr is the address in HRAM to read fro
@@ -101,8 +165,6 @@ enum hub_ret_code hub_read_data_blob_from_gard(gard_handle_t p_gard_handle,
 											   uint32_t      addr,
 											   uint32_t      count)
 {
-	enum hub_ret_code       ret;
-	int                     bus_hdl;
 	enum hub_gard_bus_types bus_type;
 
 	struct hub_gard_info   *gard = NULL;
@@ -111,10 +173,13 @@ enum hub_ret_code hub_read_data_blob_from_gard(gard_handle_t p_gard_handle,
 
 	bus_type                     = gard->data_bus->types;
 	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+	case HUB_GARD_BUS_UART:
+		return hub_recv_data_on_bus(gard, gard->data_bus, p_buffer, addr,
+									count);
 	case HUB_GARD_BUS_USB:
 		/* Lock the data bus mutex before bus operations */
 		hub_mutex_lock(&gard->data_bus->bus_mutex);
-		bus_hdl = gard->data_bus->usb.bus_hdl;
 		break;
 	default:
 		hub_pr_err("%s: Bus not supported for read_data_blob!\n",
@@ -122,22 +187,14 @@ enum hub_ret_code hub_read_data_blob_from_gard(gard_handle_t p_gard_handle,
 		goto err_read_blob_1;
 	}
 
-	if (bus_hdl < 0) {
-		hub_pr_err("Error opening USB bus for read_blob\n");
+	/* Opened once by hub_discover_gards(), for all the transfers */
+	if (!gard->data_bus->usb.is_open) {
+		hub_pr_err("USB bus not open for read_blob\n");
 		goto err_read_blob_2;
 	}
 
-	struct hub_usb_ops_map usb_ops = {
-		.p_buffer = (void *)p_buffer,
-		.addr     = addr,
-	};
-
-	/* Note the opaque bundling of p_buffer and addr for USB */
-	ssize_t nread =
-		gard->data_bus->fops.device_read(bus_hdl, (void *)&usb_ops, count);
-	/* Also note we check for 1 to adhere to Python code */
-	/* if (count != nwrite) { code commented for try-out */
-	if (1 != nread) {
+	if (hub_xfer_data_blob_on_usb(gard->data_bus, true, p_buffer, addr,
+								  count)) {
 		hub_pr_err("Error getting read_blob data\n");
 		goto err_read_blob_2;
 	}
@@ -151,9 +208,446 @@ enum hub_ret_code hub_read_data_blob_from_gard(gard_handle_t p_gard_handle,
 	return HUB_SUCCESS;
 
 err_read_blob_2:
-	ret = gard->data_bus->fops.device_close(bus_hdl);
-	(void)ret;
+	/* The bus session outlives a failed transfer */
 	hub_mutex_unlock(&gard->data_bus->bus_mutex);
 err_read_blob_1:
 	return HUB_FAILURE_RECV_DATA;
-}
\ No newline at end of file
+}
+
+/**
+ * An asynchronous data blob transfer queued on an I2C / UART bus.
+ */
+struct hub_bus_async_req {
+	struct hub_bus_async_req *p_next;
+	struct hub_gard_info     *gard;
+	bool                      is_read;
+	void                     *p_buffer;
+	uint32_t                  addr;
+	uint32_t                  count;
+	enum hub_ret_code         fail_code;
+	hub_xfer_done_cb_t        cb_handler;
+	void                     *p_cb_ctx;
+};
+
+/**
+ * The worker thread of the asynchronous data blob transfers of an I2C / UART
+ * bus. It runs the queued requests in turn, each with the chunking of the
+ * synchronous transfers, so that register accesses and commands get the bus
+ * between two chunks, and calls back once each is done.
+ *
+ * The queue is left to hub_bus_async_fini() once termination is requested.
+ */
+static void *hub_bus_async_worker_thread(void *p_args)
+{
+	enum hub_ret_code         ret;
+	struct hub_bus_async_req *p_req;
+	struct hub_gard_bus      *p_bus   = (struct hub_gard_bus *)p_args;
+	struct hub_bus_async     *p_async = &p_bus->async;
+
+	hub_mutex_lock(&p_async->lock);
+	for (;;) {
+		while (!p_async->terminate_flag && (NULL == p_async->p_head)) {
+			hub_cond_var_wait(&p_async->work_cond_var, &p_async->lock);
+		}
+		if (p_async->terminate_flag) {
+			break;
+		}
+
+		/* The request stays queued, and counted, until it has called back */
+		p_req = p_async->p_head;
+		hub_mutex_unlock(&p_async->lock);
+
+		if (p_req->is_read) {
+			ret = hub_recv_data_on_bus(p_req->gard, p_bus, p_req->p_buffer,
+									   p_req->addr, p_req->count);
+		} else {
+			ret = hub_send_data_on_bus(p_req->gard, p_bus, p_req->p_buffer,
+									   p_req->addr, p_req->count);
+		}
+		if (HUB_SUCCESS != ret) {
+			ret = p_req->fail_code;
+		}
+
+		if (p_req->cb_handler) {
+			p_req->cb_handler(p_req->p_cb_ctx, ret);
+		}
+
+		hub_mutex_lock(&p_async->lock);
+		p_async->p_head = p_req->p_next;
+		if (NULL == p_async->p_head) {
+			p_async->p_tail = NULL;
+		}
+		p_async->num_queued--;
+		if (0 == p_async->num_queued) {
+			hub_cond_var_broadcast(&p_async->idle_cond_var);
+		}
+		free(p_req);
+	}
+	hub_mutex_unlock(&p_async->lock);
+
+	return NULL;
+}
+
+/**
+ * Queue an asynchronous data blob transfer on an I2C / UART bus, starting
+ * the worker thread of the bus on the first one.
+ *
+ * @param: p_bus is the data bus of the GARD
+ * @param: p_req is the request, freed by the worker once done
+ *
+ * @return: 0 on success, -1 on failure; p_req is not freed on failure
+ */
+static int hub_bus_async_submit(struct hub_gard_bus      *p_bus,
+								struct hub_bus_async_req *p_req)
+{
+	struct hub_bus_async *p_async = &p_bus->async;
+
+	hub_mutex_lock(&p_async->lock);
+
+	if (p_async->terminate_flag) {
+		hub_pr_err("Async data_blob worker stopped\n");
+		goto err_bus_async_submit_1;
+	}
+
+	if (p_async->num_queued >= HUB_BUS_ASYNC_DEPTH) {
+		hub_pr_err("Async data_blob queue full (%u)\n", p_async->num_queued);
+		goto err_bus_async_submit_1;
+	}
+
+	if (!p_async->is_running) {
+		if (HUB_SUCCESS != hub_thread_create(&p_async->worker_thread, NULL,
+											 HUB_THREAD_CLASS_BUS_IO,
+											 "hub_bus_async",
+											 hub_bus_async_worker_thread,
+											 p_bus)) {
+			hub_pr_err("Error starting async data_blob worker\n");
+			goto err_bus_async_submit_1;
+		}
+		p_async->is_running = true;
+	}
+
+	if (NULL == p_async->p_tail) {
+		p_async->p_head = p_req;
+	} else {
+		p_async->p_tail->p_next = p_req;
+	}
+	p_async->p_tail = p_req;
+	p_async->num_queued++;
+
+	hub_cond_var_signal(&p_async->work_cond_var);
+	hub_mutex_unlock(&p_async->lock);
+
+	return 0;
+
+err_bus_async_submit_1:
+	hub_mutex_unlock(&p_async->lock);
+	return -1;
+}
+
+/**
+ * Initialize the asynchronous data blob transfer queue of a bus. The worker
+ * thread is only started by the first transfer queued.
+ *
+ * @param: p_bus is the bus to initialize the queue of
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		failure code of the threading call on failure
+ */
+enum hub_ret_code hub_bus_async_init(struct hub_gard_bus *p_bus)
+{
+	enum hub_ret_code     ret;
+	struct hub_bus_async *p_async = &p_bus->async;
+
+	p_async->p_head         = NULL;
+	p_async->p_tail         = NULL;
+	p_async->num_queued     = 0;
+	p_async->num_waiters    = 0;
+	p_async->is_running     = false;
+	p_async->terminate_flag = false;
+
+	ret                     = hub_mutex_init(&p_async->lock);
+	if (HUB_SUCCESS != ret) {
+		goto err_bus_async_init_1;
+	}
+
+	ret = hub_cond_var_init(&p_async->work_cond_var);
+	if (HUB_SUCCESS != ret) {
+		goto err_bus_async_init_2;
+	}
+
+	ret = hub_cond_var_init(&p_async->idle_cond_var);
+	if (HUB_SUCCESS != ret) {
+		goto err_bus_async_init_3;
+	}
+
+	return HUB_SUCCESS;
+
+err_bus_async_init_3:
+	hub_cond_var_destroy(&p_async->work_cond_var);
+err_bus_async_init_2:
+	hub_mutex_destroy(&p_async->lock);
+err_bus_async_init_1:
+	return ret;
+}
+
+/**
+ * Stop the asynchronous data blob transfers of a bus and free its queue.
+ *
+ * The transfer running, if any, is let complete. The requests queued behind
+ * it are completed with their failure code, from the calling thread. Threads
+ * waiting for the queue to empty are woken and let go before the queue's
+ * primitives are destroyed.
+ *
+ * @param: p_bus is the bus to stop the transfers of
+ */
+void hub_bus_async_fini(struct hub_gard_bus *p_bus)
+{
+	struct hub_bus_async_req *p_req;
+	struct hub_bus_async     *p_async = &p_bus->async;
+
+	hub_mutex_lock(&p_async->lock);
+	p_async->terminate_flag = true;
+	hub_cond_var_signal(&p_async->work_cond_var);
+	hub_mutex_unlock(&p_async->lock);
+
+	if (p_async->is_running) {
+		hub_thread_join(p_async->worker_thread, NULL);
+		p_async->is_running = false;
+	}
+
+	while (NULL != p_async->p_head) {
+		p_req           = p_async->p_head;
+		p_async->p_head = p_req->p_next;
+		if (p_req->cb_handler) {
+			p_req->cb_handler(p_req->p_cb_ctx, p_req->fail_code);
+		}
+		free(p_req);
+	}
+
+	hub_mutex_lock(&p_async->lock);
+	p_async->p_tail     = NULL;
+	p_async->num_queued = 0;
+	hub_cond_var_broadcast(&p_async->idle_cond_var);
+	while (0 != p_async->num_waiters) {
+		hub_cond_var_wait(&p_async->idle_cond_var, &p_async->lock);
+	}
+	hub_mutex_unlock(&p_async->lock);
+
+	hub_cond_var_destroy(&p_async->idle_cond_var);
+	hub_cond_var_destroy(&p_async->work_cond_var);
+	hub_mutex_destroy(&p_async->lock);
+}
+
+/**
+ * Queue a data blob read / write on the data bus of a GARD.
+ *
+ * USB transfers go to the asynchronous engine of the USB device. I2C / UART
+ * transfers go to the worker thread of the bus, see
+ * hub_bus_async_worker_thread().
+ *
+ * @param: p_gard_handle is the GARD handle to queue the transfer on
+ * @param: is_read true for a read, false for a write
+ * @param: p_buffer is the buffer to read into / write from
+ * @param: addr is the address in HRAM to read from / write to
+ * @param: count is the number of bytes to transfer
+ * @param: cb_handler is called once the transfer completes
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ * @param: fail_code is the return code for failures
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on successful submission
+ * 		fail_code on failure
+ */
+static enum hub_ret_code
+	hub_submit_data_blob_xfer_async(gard_handle_t      p_gard_handle,
+									bool               is_read,
+									void              *p_buffer,
+									uint32_t           addr,
+									uint32_t           count,
+									hub_xfer_done_cb_t cb_handler,
+									void              *p_cb_ctx,
+									enum hub_ret_code  fail_code)
+{
+	int32_t                   ret;
+	int                       bus_hdl;
+	enum hub_gard_bus_types   bus_type;
+	struct hub_bus_async_req *p_req;
+
+	struct hub_gard_info     *gard = (struct hub_gard_info *)p_gard_handle;
+
+	bus_type                       = gard->data_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+	case HUB_GARD_BUS_UART:
+		if (0 == count) {
+			hub_pr_err("Nothing to transfer\n");
+			return fail_code;
+		}
+
+		p_req = calloc(1, sizeof(struct hub_bus_async_req));
+		if (NULL == p_req) {
+			hub_pr_err("Error allocating async data_blob request\n");
+			return fail_code;
+		}
+
+		p_req->gard       = gard;
+		p_req->is_read    = is_read;
+		p_req->p_buffer   = p_buffer;
+		p_req->addr       = addr;
+		p_req->count      = count;
+		p_req->fail_code  = fail_code;
+		p_req->cb_handler = cb_handler;
+		p_req->p_cb_ctx   = p_cb_ctx;
+
+		if (hub_bus_async_submit(gard->data_bus, p_req)) {
+			free(p_req);
+			return fail_code;
+		}
+
+		hub_pr_dbg("Queued %s of %d bytes @ 0x%x\n",
+				   is_read ? "read" : "write", count, addr);
+
+		return HUB_SUCCESS;
+	case HUB_GARD_BUS_USB:
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for async data_blob!\n",
+				   hub_gard_bus_strings[bus_type]);
+		return fail_code;
+	}
+
+	/**
+	 * The bus mutex is not taken here: the USB async engine serializes the
+	 * AXI window on its own, and completion callbacks are free to queue
+	 * further transfers while a synchronous transfer waits on the engine.
+	 */
+	bus_hdl = gard->data_bus->usb.bus_hdl;
+	if (bus_hdl < 0) {
+		hub_pr_err("USB bus not open for async data_blob\n");
+		return fail_code;
+	}
+
+	struct hub_usb_ops_map usb_ops = {
+		.p_buffer = p_buffer,
+		.addr     = addr,
+	};
+
+	ret = hub_usb_device_submit_async(bus_hdl, is_read, &usb_ops, count,
+									  cb_handler, p_cb_ctx, fail_code);
+	if (1 != ret) {
+		hub_pr_err("Error queueing async data_blob @ 0x%x\n", addr);
+		return fail_code;
+	}
+
+	hub_pr_dbg("Queued %s of %d bytes @ 0x%x\n", is_read ? "read" : "write",
+			   count, addr);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Queue a write of a data blob of a specified size from a given buffer
+ * to an address in the SOM's HRAM represented by the gard handle.
+ *
+ * The buffer must stay valid until cb_handler is called.
+ *
+ * @param: p_gard_handle is the GARD handle to use for write blob
+ * @param: p_buffer is a buffer containing data to write
+ * @param: addr is the address in HRAM to write to
+ * @param: count is the number of bytes to write
+ * @param: cb_handler is called from the USB event thread, or the worker
+ * 		thread of an I2C / UART bus, on completion
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on successful submission
+ * 		HUB_FAILURE_SEND_DATA on failure
+ */
+enum hub_ret_code
+	hub_write_data_blob_to_gard_async(gard_handle_t      p_gard_handle,
+									  const void        *p_buffer,
+									  uint32_t           addr,
+									  uint32_t           count,
+									  hub_xfer_done_cb_t cb_handler,
+									  void              *p_cb_ctx)
+{
+	return hub_submit_data_blob_xfer_async(p_gard_handle, false,
+										   (void *)p_buffer, addr, count,
+										   cb_handler, p_cb_ctx,
+										   HUB_FAILURE_SEND_DATA);
+}
+
+/**
+ * Queue a read of a data blob of a specified size into a given buffer
+ * from an address in the SOM's HRAM represented by the gard handle.
+ *
+ * @param: p_gard_handle is the GARD handle for performing the read blob
+ * @param: p_buffer is a buffer to be filled on successful read
+ * @param: addr is the address in HRAM to read from
+ * @param: count is the number of bytes to read
+ * @param: cb_handler is called from the USB event thread, or the worker
+ * 		thread of an I2C / UART bus, on completion
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on successful submission
+ * 		HUB_FAILURE_RECV_DATA on failure
+ */
+enum hub_ret_code
+	hub_read_data_blob_from_gard_async(gard_handle_t      p_gard_handle,
+									   void              *p_buffer,
+									   uint32_t           addr,
+									   uint32_t           count,
+									   hub_xfer_done_cb_t cb_handler,
+									   void              *p_cb_ctx)
+{
+	return hub_submit_data_blob_xfer_async(p_gard_handle, true, p_buffer, addr,
+										   count, cb_handler, p_cb_ctx,
+										   HUB_FAILURE_RECV_DATA);
+}
+
+/**
+ * Wait until all data blob writes / reads queued on the GARD represented by
+ * the gard handle have completed.
+ *
+ * Must not be called from a completion callback.
+ *
+ * @param: p_gard_handle is the GARD handle to wait on
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_ASYNC_XFER on failure
+ */
+enum hub_ret_code hub_wait_for_data_blob_xfers(gard_handle_t p_gard_handle)
+{
+	int32_t               ret;
+	struct hub_bus_async *p_async;
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	switch (gard->data_bus->types) {
+	case HUB_GARD_BUS_I2C:
+	case HUB_GARD_BUS_UART:
+		p_async = &gard->data_bus->async;
+		hub_mutex_lock(&p_async->lock);
+		p_async->num_waiters++;
+		while (p_async->num_queued) {
+			hub_cond_var_wait(&p_async->idle_cond_var, &p_async->lock);
+		}
+		/* hub_bus_async_fini() waits for the last waiter to leave */
+		if ((0 == --p_async->num_waiters) && p_async->terminate_flag) {
+			hub_cond_var_broadcast(&p_async->idle_cond_var);
+		}
+		hub_mutex_unlock(&p_async->lock);
+		return HUB_SUCCESS;
+	case HUB_GARD_BUS_USB:
+		break;
+	default:
+		/* Nothing can be queued on other busses */
+		return HUB_SUCCESS;
+	}
+
+	ret = hub_usb_device_wait_async(gard->data_bus->usb.bus_hdl);
+
+	return (1 == ret) ? HUB_SUCCESS : HUB_FAILURE_ASYNC_XFER;
+}
@@ -31,5 +31,49 @@ enum hub_ret_code hub_read_data_blob_from_gard(gard_handle_t p_gard_handle,
 											   uint32_t      addr,
 											   uint32_t      count);
 
+/**
+ * Queue a write of a data blob of a specified size from a given buffer
+ * to an address in the SOM's HRAM represented by the gard handle.
+ * cb_handler is called once the write completes.
+ */
+enum hub_ret_code
+	hub_write_data_blob_to_gard_async(gard_handle_t      p_gard_handle,
+									  const void        *p_buffer,
+									  uint32_t           addr,
+									  uint32_t           count,
+									  hub_xfer_done_cb_t cb_handler,
+									  void              *p_cb_ctx);
+
+/**
+ * Queue a read of a data blob of a specified size into a given buffer
+ * from an address in the SOM's HRAM represented by the gard handle.
+ * cb_handler is called once the read completes.
+ */
+enum hub_ret_code
+	hub_read_data_blob_from_gard_async(gard_handle_t      p_gard_handle,
+									   void              *p_buffer,
+									   uint32_t           addr,
+									   uint32_t           count,
+									   hub_xfer_done_cb_t cb_handler,
+									   void              *p_cb_ctx);
+
+/**
+ * Wait until all data blob writes / reads queued on the GARD represented by
+ * the gard handle have completed.
+ */
+enum hub_ret_code hub_wait_for_data_blob_xfers(gard_handle_t p_gard_handle);
+
+/**
+ * Initialize the asynchronous data blob transfer queue of a bus, see
+ * struct hub_bus_async.
+ */
+enum hub_ret_code hub_bus_async_init(struct hub_gard_bus *p_bus);
+
+/**
+ * Stop the asynchronous data blob transfers of a bus, failing those still
+ * queued, and free its queue.
+ */
+void hub_bus_async_fini(struct hub_gard_bus *p_bus);
+
 #endif /* __HUB_BULK_OPS_H__ */
 
@@ -0,0 +1,471 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Capture of the bus traffic of a HUB.
+ *
+ * While a capture runs, the file operations of each bus are wrapped: the
+ * wrapper calls the bus op, then logs the transaction. The wrappers of a bus
+ * are generated for its slot in the capture, so that they know which bus
+ * they log for without looking the bus handle up.
+ *
+ * The ops of a bus are swapped under its bus_mutex, which every transaction
+ * holds, so a transaction runs either wrapped or not. Lock order is
+ * control_mutex, bus_mutex, file_mutex: start / stop hold control_mutex while
+ * they swap the ops, a wrapper only ever takes file_mutex.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "gard_hub_iface.h"
+#include "gard_info.h"
+#include "hub.h"
+#include "hub_stats.h"
+#include "hub_threading.h"
+
+/* stdio buffer of the capture file, so that most records cost a memcpy */
+#define HUB_BUS_CAPTURE_FILE_BUF_SIZE (1024U * 1024U)
+
+/* A bus of the capture */
+struct hub_bus_capture_slot {
+	struct hub_gard_bus     *p_bus;
+	struct hub_gard_bus_fops fops;      /* The ops wrapped */
+	uint8_t                  cmd_id;    /* Command of the current exchange */
+	uint8_t                  cmd_flags; /* HUB_BUS_CAPTURE_FLAG_TAGGED */
+	bool                     in_write;  /* Last transaction was a write */
+};
+
+static struct {
+	hub_mutex_t                 control_mutex;
+	hub_mutex_t                 file_mutex;
+	struct hub_ctx             *p_hub;
+	FILE                       *fp; /* NULL while no capture runs */
+	uint64_t                    start_ns;
+	uint32_t                    max_data_bytes;
+	uint32_t                    num_slots;
+	struct hub_bus_capture_slot slots[HUB_BUS_CAPTURE_MAX_BUSSES];
+} hub_bus_capture = {
+	.control_mutex = HUB_MUTEX_INITIALIZER,
+	.file_mutex    = HUB_MUTEX_INITIALIZER,
+};
+
+/**
+ * Log one transaction of a bus, if the capture runs.
+ *
+ * @param: slot is the slot of the bus
+ * @param: dir is the direction of the transaction
+ * @param: start_ns is when it started
+ * @param: len is the number of bytes moved, negative if it failed
+ * @param: p_iov / iovcnt is the data moved
+ * @param: addr is the GARD address of a USB blob, 0 otherwise
+ * @param: flags are HUB_BUS_CAPTURE_FLAG_USB_BLOB or 0
+ */
+static void hub_bus_capture_log(uint32_t                 slot,
+								enum hub_bus_capture_dir dir,
+								uint64_t                 start_ns,
+								int32_t                  len,
+								const struct iovec      *p_iov,
+								int                      iovcnt,
+								uint32_t                 addr,
+								uint8_t                  flags)
+{
+	struct hub_bus_capture_slot  *p_slot = &hub_bus_capture.slots[slot];
+	struct hub_bus_capture_record rec;
+	uint64_t                      end_ns = hub_stats_now_ns();
+	uint32_t                      left;
+	int                           i;
+
+	/* Unlocked peek so that the wrappers cost nothing once stopped */
+	if (NULL == __atomic_load_n(&hub_bus_capture.fp, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	memset(&rec, 0, sizeof(rec));
+	rec.duration_ns = (uint32_t)hub_min_uint64(end_ns - start_ns, UINT32_MAX);
+	rec.len         = (len > 0) ? (uint32_t)len : 0;
+	rec.addr        = addr;
+	rec.bus         = (uint8_t)slot;
+	rec.dir         = (uint8_t)dir;
+	rec.flags       = flags;
+	if (len < 0) {
+		rec.flags |= HUB_BUS_CAPTURE_FLAG_FAILED;
+	}
+
+	hub_mutex_lock(&hub_bus_capture.file_mutex);
+	if (NULL == hub_bus_capture.fp) {
+		hub_mutex_unlock(&hub_bus_capture.file_mutex);
+		return;
+	}
+
+	/**
+	 * A write after a read starts a HUB command exchange: its first byte is
+	 * the command id. The rest of the exchange, the payload written and the
+	 * response read, is logged with it.
+	 */
+	if (flags & HUB_BUS_CAPTURE_FLAG_USB_BLOB) {
+		p_slot->cmd_id    = HUB_BUS_CAPTURE_CMD_UNKNOWN;
+		p_slot->cmd_flags = 0;
+	} else if ((HUB_BUS_CAPTURE_DIR_WRITE == dir) && !p_slot->in_write &&
+			   (rec.len > 0) && (iovcnt > 0) && (p_iov[0].iov_len > 0)) {
+		uint8_t cmd_id = *(const uint8_t *)p_iov[0].iov_base;
+
+		p_slot->cmd_id    = cmd_id & (uint8_t)~CMD_ID_TAGGED;
+		p_slot->cmd_flags = (cmd_id & CMD_ID_TAGGED)
+								? HUB_BUS_CAPTURE_FLAG_TAGGED
+								: 0;
+	}
+	p_slot->in_write = (HUB_BUS_CAPTURE_DIR_WRITE == dir);
+
+	rec.start_ns = start_ns - hub_bus_capture.start_ns;
+	rec.cmd_id   = p_slot->cmd_id;
+	rec.flags |= p_slot->cmd_flags;
+	rec.data_len = rec.len;
+	if (hub_bus_capture.max_data_bytes &&
+		(rec.data_len > hub_bus_capture.max_data_bytes)) {
+		rec.data_len = hub_bus_capture.max_data_bytes;
+	}
+
+	fwrite(&rec, sizeof(rec), 1, hub_bus_capture.fp);
+	left = rec.data_len;
+	for (i = 0; (i < iovcnt) && left; i++) {
+		uint32_t chunk = hub_min_uint64(p_iov[i].iov_len, left);
+
+		fwrite(p_iov[i].iov_base, 1, chunk, hub_bus_capture.fp);
+		left -= chunk;
+	}
+	hub_mutex_unlock(&hub_bus_capture.file_mutex);
+}
+
+/**
+ * The USB read / write ops move a blob at a GARD address, bundled in a
+ * struct hub_usb_ops_map, and return the bytes moved.
+ */
+static int32_t hub_bus_capture_read(uint32_t slot,
+									int      bus_hdl,
+									void    *p_buffer,
+									uint32_t count)
+{
+	struct hub_bus_capture_slot *p_slot   = &hub_bus_capture.slots[slot];
+	uint64_t                     start_ns = hub_stats_now_ns();
+	int32_t                      ret;
+	struct iovec                 iov;
+
+	ret = p_slot->fops.device_read(bus_hdl, p_buffer, count);
+
+	if (HUB_GARD_BUS_USB == p_slot->p_bus->types) {
+		struct hub_usb_ops_map *p_map = (struct hub_usb_ops_map *)p_buffer;
+
+		iov.iov_base = p_map->p_buffer;
+		iov.iov_len  = (ret > 0) ? (size_t)ret : 0;
+		hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_READ, start_ns, ret,
+							&iov, 1, p_map->addr,
+							HUB_BUS_CAPTURE_FLAG_USB_BLOB);
+	} else {
+		iov.iov_base = p_buffer;
+		iov.iov_len  = (ret > 0) ? (size_t)ret : 0;
+		hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_READ, start_ns, ret,
+							&iov, 1, 0, 0);
+	}
+
+	return ret;
+}
+
+static int32_t hub_bus_capture_write(uint32_t    slot,
+									 int         bus_hdl,
+									 const void *p_buffer,
+									 uint32_t    count)
+{
+	struct hub_bus_capture_slot *p_slot   = &hub_bus_capture.slots[slot];
+	uint64_t                     start_ns = hub_stats_now_ns();
+	int32_t                      ret;
+	struct iovec                 iov;
+
+	ret = p_slot->fops.device_write(bus_hdl, p_buffer, count);
+
+	if (HUB_GARD_BUS_USB == p_slot->p_bus->types) {
+		const struct hub_usb_ops_map *p_map =
+			(const struct hub_usb_ops_map *)p_buffer;
+
+		iov.iov_base = p_map->p_buffer;
+		iov.iov_len  = (ret > 0) ? (size_t)ret : 0;
+		hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_WRITE, start_ns, ret,
+							&iov, 1, p_map->addr,
+							HUB_BUS_CAPTURE_FLAG_USB_BLOB);
+	} else {
+		iov.iov_base = (void *)p_buffer;
+		iov.iov_len  = (ret > 0) ? (size_t)ret : 0;
+		hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_WRITE, start_ns, ret,
+							&iov, 1, 0, 0);
+	}
+
+	return ret;
+}
+
+static int32_t hub_bus_capture_readv(uint32_t            slot,
+									 int                 bus_hdl,
+									 const struct iovec *p_iov,
+									 int                 iovcnt)
+{
+	struct hub_bus_capture_slot *p_slot   = &hub_bus_capture.slots[slot];
+	uint64_t                     start_ns = hub_stats_now_ns();
+	int32_t                      ret;
+
+	ret = p_slot->fops.device_readv(bus_hdl, p_iov, iovcnt);
+	hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_READ, start_ns, ret, p_iov,
+						iovcnt, 0, 0);
+
+	return ret;
+}
+
+static int32_t hub_bus_capture_writev(uint32_t            slot,
+									  int                 bus_hdl,
+									  const struct iovec *p_iov,
+									  int                 iovcnt)
+{
+	struct hub_bus_capture_slot *p_slot   = &hub_bus_capture.slots[slot];
+	uint64_t                     start_ns = hub_stats_now_ns();
+	int32_t                      ret;
+
+	ret = p_slot->fops.device_writev(bus_hdl, p_iov, iovcnt);
+	hub_bus_capture_log(slot, HUB_BUS_CAPTURE_DIR_WRITE, start_ns, ret, p_iov,
+						iovcnt, 0, 0);
+
+	return ret;
+}
+
+/* The ops of the bus in slot n */
+#define HUB_BUS_CAPTURE_SLOT_OPS(n)                                            \
+	static int32_t hub_bus_capture_read_##n(int bus_hdl, void *p_buffer,       \
+											uint32_t count)                    \
+	{                                                                          \
+		return hub_bus_capture_read(n, bus_hdl, p_buffer, count);              \
+	}                                                                          \
+	static int32_t hub_bus_capture_write_##n(int bus_hdl, const void *p_buffer,\
+											 uint32_t count)                   \
+	{                                                                          \
+		return hub_bus_capture_write(n, bus_hdl, p_buffer, count);             \
+	}                                                                          \
+	static int32_t hub_bus_capture_readv_##n(int                 bus_hdl,      \
+											 const struct iovec *p_iov,        \
+											 int                 iovcnt)       \
+	{                                                                          \
+		return hub_bus_capture_readv(n, bus_hdl, p_iov, iovcnt);               \
+	}                                                                          \
+	static int32_t hub_bus_capture_writev_##n(int                 bus_hdl,     \
+											  const struct iovec *p_iov,       \
+											  int                 iovcnt)      \
+	{                                                                          \
+		return hub_bus_capture_writev(n, bus_hdl, p_iov, iovcnt);              \
+	}
+
+HUB_BUS_CAPTURE_SLOT_OPS(0)
+HUB_BUS_CAPTURE_SLOT_OPS(1)
+HUB_BUS_CAPTURE_SLOT_OPS(2)
+HUB_BUS_CAPTURE_SLOT_OPS(3)
+HUB_BUS_CAPTURE_SLOT_OPS(4)
+HUB_BUS_CAPTURE_SLOT_OPS(5)
+HUB_BUS_CAPTURE_SLOT_OPS(6)
+HUB_BUS_CAPTURE_SLOT_OPS(7)
+
+#define HUB_BUS_CAPTURE_SLOT_FOPS(n)                                           \
+	{                                                                          \
+		.device_read   = hub_bus_capture_read_##n,                             \
+		.device_write  = hub_bus_capture_write_##n,                            \
+		.device_readv  = hub_bus_capture_readv_##n,                            \
+		.device_writev = hub_bus_capture_writev_##n,                           \
+	}
+
+static const struct hub_gard_bus_fops
+	hub_bus_capture_fops[HUB_BUS_CAPTURE_MAX_BUSSES] = {
+		HUB_BUS_CAPTURE_SLOT_FOPS(0), HUB_BUS_CAPTURE_SLOT_FOPS(1),
+		HUB_BUS_CAPTURE_SLOT_FOPS(2), HUB_BUS_CAPTURE_SLOT_FOPS(3),
+		HUB_BUS_CAPTURE_SLOT_FOPS(4), HUB_BUS_CAPTURE_SLOT_FOPS(5),
+		HUB_BUS_CAPTURE_SLOT_FOPS(6), HUB_BUS_CAPTURE_SLOT_FOPS(7),
+};
+
+/**
+ * Speed of a bus, as logged in the capture file.
+ */
+static uint32_t hub_bus_capture_speed(const struct hub_gard_bus *p_bus)
+{
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		return p_bus->i2c.speed;
+	case HUB_GARD_BUS_UART:
+		return p_bus->uart.baudrate;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Swap the ops of a bus with the ones of its capture slot, or back. Called
+ * with control_mutex held.
+ *
+ * @param: slot is the capture slot of the bus
+ * @param: wrap is true to wrap the ops, false to restore them
+ */
+static void hub_bus_capture_wrap(uint32_t slot, bool wrap)
+{
+	struct hub_bus_capture_slot *p_slot = &hub_bus_capture.slots[slot];
+	struct hub_gard_bus         *p_bus  = p_slot->p_bus;
+
+	hub_mutex_lock(&p_bus->bus_mutex);
+	if (wrap) {
+		p_slot->fops              = p_bus->fops;
+		p_slot->in_write          = false;
+		p_slot->cmd_id            = HUB_BUS_CAPTURE_CMD_UNKNOWN;
+		p_slot->cmd_flags         = 0;
+		p_bus->fops.device_read   = hub_bus_capture_fops[slot].device_read;
+		p_bus->fops.device_write  = hub_bus_capture_fops[slot].device_write;
+		/* USB has no vectored ops */
+		if (NULL != p_slot->fops.device_readv) {
+			p_bus->fops.device_readv = hub_bus_capture_fops[slot].device_readv;
+		}
+		if (NULL != p_slot->fops.device_writev) {
+			p_bus->fops.device_writev =
+				hub_bus_capture_fops[slot].device_writev;
+		}
+	} else {
+		p_bus->fops = p_slot->fops;
+	}
+	hub_mutex_unlock(&p_bus->bus_mutex);
+}
+
+/**
+ * hub_bus_capture_start logs every transaction on the busses of a HUB to a
+ * capture file.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_path is the capture file to write
+ * @param: max_data_bytes is the most data logged per transaction, 0 for all
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_BUS_CAPTURE on failure
+ */
+enum hub_ret_code hub_bus_capture_start(hub_handle_t hub,
+										const char  *p_path,
+										uint32_t     max_data_bytes)
+{
+	struct hub_ctx               *p_hub = (struct hub_ctx *)hub;
+	struct hub_bus_capture_header header;
+	struct hub_bus_capture_bus    bus;
+	FILE                         *fp;
+	uint32_t                      i;
+
+	if ((NULL == p_hub) || (NULL == p_hub->p_bus_props) || (NULL == p_path)) {
+		hub_pr_err("Invalid arguments for hub_bus_capture_start\n");
+		goto hub_bus_capture_start_err_1;
+	}
+	if (p_hub->num_busses > HUB_BUS_CAPTURE_MAX_BUSSES) {
+		hub_pr_err("%u busses, a capture covers at most %u\n",
+				   p_hub->num_busses, HUB_BUS_CAPTURE_MAX_BUSSES);
+		goto hub_bus_capture_start_err_1;
+	}
+
+	hub_mutex_lock(&hub_bus_capture.control_mutex);
+	if (NULL != hub_bus_capture.p_hub) {
+		hub_pr_err("A bus capture is already running\n");
+		goto hub_bus_capture_start_err_2;
+	}
+
+	fp = fopen(p_path, "wb");
+	if (NULL == fp) {
+		hub_pr_err("Failed to open %s: %s\n", p_path, strerror(errno));
+		goto hub_bus_capture_start_err_2;
+	}
+	setvbuf(fp, NULL, _IOFBF, HUB_BUS_CAPTURE_FILE_BUF_SIZE);
+
+	header.magic      = HUB_BUS_CAPTURE_MAGIC;
+	header.version    = HUB_BUS_CAPTURE_VERSION;
+	header.num_busses = (uint16_t)p_hub->num_busses;
+	header.start_ns   = hub_stats_now_ns();
+	if (1 != fwrite(&header, sizeof(header), 1, fp)) {
+		goto hub_bus_capture_start_err_3;
+	}
+	for (i = 0; i < p_hub->num_busses; i++) {
+		memset(&bus, 0, sizeof(bus));
+		bus.type       = (uint8_t)p_hub->p_bus_props[i].types;
+		bus.gard_index = (uint8_t)p_hub->p_bus_props[i].gard_index;
+		bus.speed      = hub_bus_capture_speed(&p_hub->p_bus_props[i]);
+		if (1 != fwrite(&bus, sizeof(bus), 1, fp)) {
+			goto hub_bus_capture_start_err_3;
+		}
+	}
+
+	/* Wrapped first, the records start once the file is set */
+	hub_bus_capture.p_hub          = p_hub;
+	hub_bus_capture.num_slots      = p_hub->num_busses;
+	hub_bus_capture.max_data_bytes = max_data_bytes;
+	hub_bus_capture.start_ns       = header.start_ns;
+	for (i = 0; i < hub_bus_capture.num_slots; i++) {
+		hub_bus_capture.slots[i].p_bus = &p_hub->p_bus_props[i];
+		hub_bus_capture_wrap(i, true);
+	}
+
+	hub_mutex_lock(&hub_bus_capture.file_mutex);
+	__atomic_store_n(&hub_bus_capture.fp, fp, __ATOMIC_RELAXED);
+	hub_mutex_unlock(&hub_bus_capture.file_mutex);
+
+	hub_mutex_unlock(&hub_bus_capture.control_mutex);
+
+	return HUB_SUCCESS;
+
+hub_bus_capture_start_err_3:
+	hub_pr_err("Failed to write %s: %s\n", p_path, strerror(errno));
+	fclose(fp);
+hub_bus_capture_start_err_2:
+	hub_mutex_unlock(&hub_bus_capture.control_mutex);
+hub_bus_capture_start_err_1:
+	return HUB_FAILURE_BUS_CAPTURE;
+}
+
+/**
+ * hub_bus_capture_stop stops the capture and writes the rest of the capture
+ * file.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success, or if no capture runs
+ *			HUB_FAILURE_BUS_CAPTURE on failure
+ */
+enum hub_ret_code hub_bus_capture_stop(hub_handle_t hub)
+{
+	enum hub_ret_code ret = HUB_SUCCESS;
+	FILE             *fp;
+	bool              failed;
+	uint32_t          i;
+
+	hub_mutex_lock(&hub_bus_capture.control_mutex);
+	if ((NULL == hub) || (hub_bus_capture.p_hub != (struct hub_ctx *)hub)) {
+		hub_mutex_unlock(&hub_bus_capture.control_mutex);
+		return HUB_SUCCESS;
+	}
+
+	hub_mutex_lock(&hub_bus_capture.file_mutex);
+	fp = hub_bus_capture.fp;
+	__atomic_store_n(&hub_bus_capture.fp, NULL, __ATOMIC_RELAXED);
+	hub_mutex_unlock(&hub_bus_capture.file_mutex);
+
+	for (i = 0; i < hub_bus_capture.num_slots; i++) {
+		hub_bus_capture_wrap(i, false);
+	}
+	hub_bus_capture.p_hub = NULL;
+
+	failed = ferror(fp);
+	if (fclose(fp) || failed) {
+		hub_pr_err("Failed to write the bus capture: %s\n", strerror(errno));
+		ret = HUB_FAILURE_BUS_CAPTURE;
+	}
+
+	hub_mutex_unlock(&hub_bus_capture.control_mutex);
+
+	return ret;
+}
@@ -0,0 +1,252 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB client: the register and data transfers of an app, run by a HUB
+ * daemon, see hub_daemon.c, instead of a HUB of its own.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "hub_daemon.h"
+
+/* Back-end of a hub_client_handle_t */
+struct hub_client_ctx {
+	int         fd;
+	uint32_t    num_gards;
+	/* One request in flight at a time, for apps with several threads */
+	hub_mutex_t lock;
+};
+
+/**
+ * Run one request on the daemon.
+ *
+ * @param: p_client is the client
+ * @param: p_req is the request
+ * @param: p_send is the payload of the request, NULL if none
+ * @param: p_recv is filled with the payload of the response, NULL if none
+ * @param: p_resp is filled with the response
+ *
+ * @return: 0 on success, -1 if the daemon could not be reached
+ */
+static int hub_client_request(struct hub_client_ctx       *p_client,
+							  const struct hub_daemon_req *p_req,
+							  const void                  *p_send,
+							  void                        *p_recv,
+							  struct hub_daemon_resp      *p_resp)
+{
+	int err = -1;
+
+	hub_mutex_lock(&p_client->lock);
+
+	if (hub_daemon_write_full(p_client->fd, p_req, sizeof(*p_req)) ||
+		(p_send && hub_daemon_write_full(p_client->fd, p_send, p_req->count)) ||
+		hub_daemon_read_full(p_client->fd, p_resp, sizeof(*p_resp))) {
+		hub_pr_err("Lost the HUB daemon\n");
+		goto hub_client_request_exit;
+	}
+
+	if (p_resp->count) {
+		if ((NULL == p_recv) || (p_resp->count != p_req->count) ||
+			hub_daemon_read_full(p_client->fd, p_recv, p_resp->count)) {
+			hub_pr_err("Bad payload of %u bytes from the HUB daemon\n",
+					   p_resp->count);
+			goto hub_client_request_exit;
+		}
+	}
+
+	err = 0;
+
+hub_client_request_exit:
+	hub_mutex_unlock(&p_client->lock);
+	return err;
+}
+
+enum hub_ret_code hub_client_connect(const char          *p_socket_path,
+									 hub_client_handle_t *p_client_handle)
+{
+	struct hub_client_ctx *p_client;
+	struct sockaddr_un     addr = {0};
+	struct hub_daemon_req  req  = {0};
+	struct hub_daemon_resp resp;
+
+	if ((NULL == p_socket_path) || (NULL == p_client_handle) ||
+		(strlen(p_socket_path) >= sizeof(addr.sun_path))) {
+		hub_pr_err("Invalid HUB daemon socket path\n");
+		return HUB_FAILURE_DAEMON;
+	}
+
+	p_client = (struct hub_client_ctx *)calloc(1, sizeof(*p_client));
+	if (NULL == p_client) {
+		hub_pr_err("Failed to allocate HUB client\n");
+		return HUB_FAILURE_DAEMON;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_client->lock)) {
+		hub_pr_err("Failed to initialize HUB client lock\n");
+		goto err_client_connect_1;
+	}
+
+	p_client->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (p_client->fd < 0) {
+		hub_pr_err("Failed to create HUB client socket\n");
+		goto err_client_connect_2;
+	}
+
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, p_socket_path);
+	if (connect(p_client->fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		hub_pr_err("No HUB daemon on %s\n", p_socket_path);
+		goto err_client_connect_3;
+	}
+
+	req.op    = HUB_DAEMON_OP_HELLO;
+	req.value = HUB_DAEMON_PROTO_VERSION;
+	if (hub_client_request(p_client, &req, NULL, NULL, &resp) ||
+		(HUB_SUCCESS != resp.ret)) {
+		hub_pr_err("HUB daemon on %s refused the client\n", p_socket_path);
+		goto err_client_connect_3;
+	}
+
+	p_client->num_gards = resp.value;
+	*p_client_handle    = (hub_client_handle_t)p_client;
+
+	return HUB_SUCCESS;
+
+err_client_connect_3:
+	close(p_client->fd);
+err_client_connect_2:
+	hub_mutex_destroy(&p_client->lock);
+err_client_connect_1:
+	free(p_client);
+	return HUB_FAILURE_DAEMON;
+}
+
+void hub_client_disconnect(hub_client_handle_t client)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+
+	if (NULL == p_client) {
+		return;
+	}
+
+	close(p_client->fd);
+	hub_mutex_destroy(&p_client->lock);
+	free(p_client);
+}
+
+uint32_t hub_client_get_num_gards(hub_client_handle_t client)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+
+	return (NULL == p_client) ? 0 : p_client->num_gards;
+}
+
+enum hub_ret_code hub_client_read_gard_reg(hub_client_handle_t client,
+										   uint32_t            gard_num,
+										   uint32_t            reg_addr,
+										   uint32_t           *p_value)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+	struct hub_daemon_req  req      = {0};
+	struct hub_daemon_resp resp;
+
+	if ((NULL == p_client) || (NULL == p_value)) {
+		return HUB_FAILURE_READ_REG;
+	}
+
+	req.op       = HUB_DAEMON_OP_READ_REG;
+	req.gard_num = gard_num;
+	req.addr     = reg_addr;
+	if (hub_client_request(p_client, &req, NULL, NULL, &resp)) {
+		return HUB_FAILURE_READ_REG;
+	}
+
+	*p_value = resp.value;
+
+	return (enum hub_ret_code)resp.ret;
+}
+
+enum hub_ret_code hub_client_write_gard_reg(hub_client_handle_t client,
+											uint32_t            gard_num,
+											uint32_t            reg_addr,
+											uint32_t            value)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+	struct hub_daemon_req  req      = {0};
+	struct hub_daemon_resp resp;
+
+	if (NULL == p_client) {
+		return HUB_FAILURE_WRITE_REG;
+	}
+
+	req.op       = HUB_DAEMON_OP_WRITE_REG;
+	req.gard_num = gard_num;
+	req.addr     = reg_addr;
+	req.value    = value;
+	if (hub_client_request(p_client, &req, NULL, NULL, &resp)) {
+		return HUB_FAILURE_WRITE_REG;
+	}
+
+	return (enum hub_ret_code)resp.ret;
+}
+
+enum hub_ret_code hub_client_send_data_to_gard(hub_client_handle_t client,
+											   uint32_t            gard_num,
+											   const void         *p_buffer,
+											   uint32_t            addr,
+											   uint32_t            count)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+	struct hub_daemon_req  req      = {0};
+	struct hub_daemon_resp resp;
+
+	if ((NULL == p_client) || (NULL == p_buffer) ||
+		(count > HUB_DAEMON_MAX_XFER_SIZE)) {
+		return HUB_FAILURE_SEND_DATA;
+	}
+
+	req.op       = HUB_DAEMON_OP_SEND_DATA;
+	req.gard_num = gard_num;
+	req.addr     = addr;
+	req.count    = count;
+	if (hub_client_request(p_client, &req, p_buffer, NULL, &resp)) {
+		return HUB_FAILURE_SEND_DATA;
+	}
+
+	return (enum hub_ret_code)resp.ret;
+}
+
+enum hub_ret_code hub_client_recv_data_from_gard(hub_client_handle_t client,
+												 uint32_t            gard_num,
+												 void               *p_buffer,
+												 uint32_t            addr,
+												 uint32_t            count)
+{
+	struct hub_client_ctx *p_client = (struct hub_client_ctx *)client;
+	struct hub_daemon_req  req      = {0};
+	struct hub_daemon_resp resp;
+
+	if ((NULL == p_client) || (NULL == p_buffer) ||
+		(count > HUB_DAEMON_MAX_XFER_SIZE)) {
+		return HUB_FAILURE_RECV_DATA;
+	}
+
+	req.op       = HUB_DAEMON_OP_RECV_DATA;
+	req.gard_num = gard_num;
+	req.addr     = addr;
+	req.count    = count;
+	if (hub_client_request(p_client, &req, NULL, p_buffer, &resp)) {
+		return HUB_FAILURE_RECV_DATA;
+	}
+
+	return (enum hub_ret_code)resp.ret;
+}
@@ -0,0 +1,609 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Binary cache of the parsed host_config.json and GARD jsons.
+ *
+ * hub_preinit() and hub_discover_gards() take the configuration from the
+ * cache when it matches the jsons, with one mmap() of the cache instead of
+ * reading and parsing each json. A json is known to match by its
+ * modification time, size and inode, so a cached json is not read at all.
+ * The cache itself is checked with a hash of its contents, so that a torn
+ * or corrupt cache is parsed again from the jsons instead of being used.
+ *
+ * The cache is written next to host_config.json after discovery when a json
+ * had to be parsed, see hub_config_cache_save().
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hub_config_cache.h"
+
+/* Busses a cache may hold, to bound a corrupt count */
+#define HUB_CONFIG_CACHE_MAX_BUSSES (256)
+#define HUB_CONFIG_CACHE_MAX_GARDS  (256)
+
+/**
+ * Layout of the cache file: this header, then num_busses struct
+ * hub_config_cache_bus and num_gards struct hub_config_cache_gard, in host
+ * byte order.
+ */
+struct hub_config_cache_hdr {
+	uint32_t                    magic;
+	uint32_t                    version;
+	uint32_t                    bus_size;  /* Record sizes, to catch a */
+	uint32_t                    gard_size; /* cache of another build */
+	uint32_t                    num_busses;
+	uint32_t                    num_gards;
+	uint32_t                    gpio_exec_model;
+	uint32_t                    gpio_pool_size;
+	uint32_t                    health_probe_ms;
+	uint32_t                    clock_sync_ms;
+	int32_t                     log_level;
+	uint64_t                    hash; /* Of the file with this field 0 */
+	struct hub_config_cache_key host_key;
+	struct hub_thread_props     thread_props[HUB_THREAD_CLASS_MAX];
+};
+
+/* FNV-1a, continuing from hash */
+static uint64_t hub_config_cache_hash(uint64_t hash, const void *p_data,
+									  size_t size)
+{
+	const uint8_t *p_bytes = (const uint8_t *)p_data;
+
+	while (size--) {
+		hash ^= *p_bytes++;
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+static uint64_t
+	hub_config_cache_hash_file(const struct hub_config_cache_hdr *p_hdr,
+							   size_t                             file_size)
+{
+	struct hub_config_cache_hdr hdr = *p_hdr;
+	uint64_t                    hash;
+
+	hdr.hash = 0;
+	hash = hub_config_cache_hash(0xCBF29CE484222325ULL, &hdr, sizeof(hdr));
+
+	return hub_config_cache_hash(hash, p_hdr + 1, file_size - sizeof(hdr));
+}
+
+/**
+ * Get the key of a json file.
+ *
+ * @return: 0 on success, -1 if the file cannot be looked at
+ */
+static int hub_config_cache_key_of(const char                  *p_file,
+								   struct hub_config_cache_key *p_key)
+{
+	struct stat st;
+
+	if (stat(p_file, &st)) {
+		return -1;
+	}
+
+	memset(p_key, 0, sizeof(*p_key));
+	p_key->mtime_ns = ((uint64_t)st.st_mtim.tv_sec * 1000000000ULL) +
+					  (uint64_t)st.st_mtim.tv_nsec;
+	p_key->size     = (uint64_t)st.st_size;
+	p_key->ino      = (uint64_t)st.st_ino;
+
+	return 0;
+}
+
+/* Copy a string into a cache record, -1 if it does not fit */
+static int hub_config_cache_put_str(char *p_dst, const char *p_src)
+{
+	size_t len = strlen(p_src);
+
+	if (len >= HUB_CONFIG_CACHE_STR_LEN) {
+		return -1;
+	}
+
+	memset(p_dst, 0, HUB_CONFIG_CACHE_STR_LEN);
+	memcpy(p_dst, p_src, len);
+
+	return 0;
+}
+
+/**
+ * Take the contents of a mapped cache file, if it is sound and matches
+ * host_config.json.
+ */
+static void hub_config_cache_take(struct hub_config_cache *p_cache,
+								  const uint8_t           *p_map,
+								  size_t                   map_size)
+{
+	const struct hub_config_cache_hdr *p_hdr =
+		(const struct hub_config_cache_hdr *)p_map;
+	size_t                             busses_size, gards_size;
+	uint32_t                           i;
+
+	if ((map_size < sizeof(*p_hdr)) ||
+		(HUB_CONFIG_CACHE_MAGIC != p_hdr->magic) ||
+		(HUB_CONFIG_CACHE_VERSION != p_hdr->version) ||
+		(sizeof(struct hub_config_cache_bus) != p_hdr->bus_size) ||
+		(sizeof(struct hub_config_cache_gard) != p_hdr->gard_size) ||
+		(p_hdr->num_busses > HUB_CONFIG_CACHE_MAX_BUSSES) ||
+		(p_hdr->num_gards > HUB_CONFIG_CACHE_MAX_GARDS)) {
+		hub_pr_dbg("Config cache %s is of another HUB\n", p_cache->path);
+		return;
+	}
+
+	busses_size = (size_t)p_hdr->num_busses * p_hdr->bus_size;
+	gards_size  = (size_t)p_hdr->num_gards * p_hdr->gard_size;
+	if ((sizeof(*p_hdr) + busses_size + gards_size != map_size) ||
+		(hub_config_cache_hash_file(p_hdr, map_size) != p_hdr->hash)) {
+		hub_pr_warn("Config cache %s is corrupt, parsing the jsons\n",
+					p_cache->path);
+		return;
+	}
+
+	if (memcmp(&p_hdr->host_key, &p_cache->host_key,
+			   sizeof(p_cache->host_key))) {
+		hub_pr_dbg("Config cache %s is stale\n", p_cache->path);
+		return;
+	}
+
+	p_cache->p_busses =
+		(struct hub_config_cache_bus *)malloc(busses_size ? busses_size : 1);
+	p_cache->p_gards  =
+		(struct hub_config_cache_gard *)malloc(gards_size ? gards_size : 1);
+	if ((NULL == p_cache->p_busses) || (NULL == p_cache->p_gards)) {
+		free(p_cache->p_busses);
+		free(p_cache->p_gards);
+		p_cache->p_busses = NULL;
+		p_cache->p_gards  = NULL;
+		return;
+	}
+
+	memcpy(p_cache->p_busses, p_hdr + 1, busses_size);
+	memcpy(p_cache->p_gards, (const uint8_t *)(p_hdr + 1) + busses_size,
+		   gards_size);
+	memcpy(p_cache->thread_props, p_hdr->thread_props,
+		   sizeof(p_cache->thread_props));
+	p_cache->num_busses      = p_hdr->num_busses;
+	p_cache->num_gards       = p_hdr->num_gards;
+	p_cache->gpio_exec_model = p_hdr->gpio_exec_model;
+	p_cache->gpio_pool_size  = p_hdr->gpio_pool_size;
+	p_cache->health_probe_ms = p_hdr->health_probe_ms;
+	p_cache->clock_sync_ms   = p_hdr->clock_sync_ms;
+	p_cache->log_level       = p_hdr->log_level;
+
+	/* Hashed, but strings are used as such: keep them terminated */
+	for (i = 0; i < p_cache->num_busses; i++) {
+		p_cache->p_busses[i].uart_bus_dev[HUB_CONFIG_CACHE_STR_LEN - 1] = '\0';
+		p_cache->p_busses[i].usb_port_path[HUB_USB_PORT_PATH_LEN - 1]   = '\0';
+		p_cache->p_busses[i].usb_serial_number[HUB_USB_SERIAL_LEN - 1]  = '\0';
+	}
+	for (i = 0; i < p_cache->num_gards; i++) {
+		p_cache->p_gards[i].gard_name[HUB_CONFIG_CACHE_STR_LEN - 1] = '\0';
+		p_cache->p_gards[i].gpio_chip[HUB_CONFIG_CACHE_STR_LEN - 1] = '\0';
+	}
+
+	p_cache->is_host_valid = true;
+}
+
+struct hub_config_cache *hub_config_cache_load(const char *p_host_config_file)
+{
+	struct hub_config_cache *p_cache;
+	struct stat              st;
+	void                    *p_map;
+	int                      fd;
+
+	p_cache = (struct hub_config_cache *)calloc(1, sizeof(*p_cache));
+	if (NULL == p_cache) {
+		hub_pr_err("Failed to allocate config cache\n");
+		return NULL;
+	}
+
+	/* Without a usable path, the cache is neither read nor written */
+	if ((strlen(p_host_config_file) + sizeof(HUB_CONFIG_CACHE_SUFFIX) >
+		 sizeof(p_cache->path)) ||
+		hub_config_cache_key_of(p_host_config_file, &p_cache->host_key)) {
+		return p_cache;
+	}
+	snprintf(p_cache->path, sizeof(p_cache->path), "%s%s",
+			 p_host_config_file, HUB_CONFIG_CACHE_SUFFIX);
+
+	fd = open(p_cache->path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		hub_pr_dbg("No config cache %s\n", p_cache->path);
+		return p_cache;
+	}
+
+	if (fstat(fd, &st) || (0 == st.st_size)) {
+		close(fd);
+		return p_cache;
+	}
+
+	p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (MAP_FAILED == p_map) {
+		return p_cache;
+	}
+
+	hub_config_cache_take(p_cache, (const uint8_t *)p_map,
+						  (size_t)st.st_size);
+	munmap(p_map, (size_t)st.st_size);
+
+	return p_cache;
+}
+
+void hub_config_cache_save(struct hub_config_cache *p_cache)
+{
+	struct hub_config_cache_hdr *p_hdr;
+	char                         tmp_path[PATH_MAX + 8];
+	size_t                       busses_size, gards_size, file_size;
+	ssize_t                      nwrite;
+	int                          fd;
+
+	if ((NULL == p_cache) || !p_cache->is_dirty || !p_cache->is_host_valid ||
+		('\0' == p_cache->path[0])) {
+		return;
+	}
+
+	busses_size = (size_t)p_cache->num_busses * sizeof(*p_cache->p_busses);
+	gards_size  = (size_t)p_cache->num_gards * sizeof(*p_cache->p_gards);
+	file_size   = sizeof(*p_hdr) + busses_size + gards_size;
+
+	p_hdr = (struct hub_config_cache_hdr *)calloc(1, file_size);
+	if (NULL == p_hdr) {
+		return;
+	}
+
+	p_hdr->magic           = HUB_CONFIG_CACHE_MAGIC;
+	p_hdr->version         = HUB_CONFIG_CACHE_VERSION;
+	p_hdr->bus_size        = sizeof(*p_cache->p_busses);
+	p_hdr->gard_size       = sizeof(*p_cache->p_gards);
+	p_hdr->num_busses      = p_cache->num_busses;
+	p_hdr->num_gards       = p_cache->num_gards;
+	p_hdr->gpio_exec_model = p_cache->gpio_exec_model;
+	p_hdr->gpio_pool_size  = p_cache->gpio_pool_size;
+	p_hdr->health_probe_ms = p_cache->health_probe_ms;
+	p_hdr->clock_sync_ms   = p_cache->clock_sync_ms;
+	p_hdr->log_level       = p_cache->log_level;
+	p_hdr->host_key        = p_cache->host_key;
+	memcpy(p_hdr->thread_props, p_cache->thread_props,
+		   sizeof(p_hdr->thread_props));
+	memcpy(p_hdr + 1, p_cache->p_busses, busses_size);
+	memcpy((uint8_t *)(p_hdr + 1) + busses_size, p_cache->p_gards,
+		   gards_size);
+	p_hdr->hash = hub_config_cache_hash_file(p_hdr, file_size);
+
+	/* Readers see the former cache or this one, never part of it */
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", p_cache->path);
+	fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		hub_pr_dbg("Cannot write config cache %s\n", tmp_path);
+		goto config_cache_save_exit;
+	}
+
+	nwrite = write(fd, p_hdr, file_size);
+	close(fd);
+	if ((nwrite != (ssize_t)file_size) || rename(tmp_path, p_cache->path)) {
+		hub_pr_dbg("Cannot write config cache %s\n", p_cache->path);
+		(void)unlink(tmp_path);
+		goto config_cache_save_exit;
+	}
+
+	p_cache->is_dirty = false;
+	hub_pr_dbg("Config cache %s written\n", p_cache->path);
+
+config_cache_save_exit:
+	free(p_hdr);
+}
+
+void hub_config_cache_free(struct hub_config_cache *p_cache)
+{
+	if (NULL == p_cache) {
+		return;
+	}
+
+	free(p_cache->p_busses);
+	free(p_cache->p_gards);
+	free(p_cache);
+}
+
+enum hub_ret_code hub_config_cache_get_host(struct hub_config_cache *p_cache,
+											struct hub_ctx          *p_hub)
+{
+	struct hub_gard_bus         *p_bus;
+	struct hub_config_cache_bus *p_rec;
+	uint32_t                     i;
+
+	if (!p_cache->is_host_valid) {
+		return HUB_FAILURE_PREINIT;
+	}
+
+	p_hub->p_bus_props = (struct hub_gard_bus *)calloc(
+		hub_max_int32(p_cache->num_busses, 1), sizeof(struct hub_gard_bus));
+	if (NULL == p_hub->p_bus_props) {
+		hub_pr_err("Error allocating memory for bus props\n");
+		return HUB_FAILURE_PREINIT;
+	}
+
+	for (i = 0; i < p_cache->num_busses; i++) {
+		p_bus = &p_hub->p_bus_props[i];
+		p_rec = &p_cache->p_busses[i];
+
+		p_bus->types           = (enum hub_gard_bus_types)p_rec->types;
+		p_bus->gard_index      = p_rec->gard_index;
+		p_bus->xfer_chunk_size = p_rec->xfer_chunk_size;
+		p_bus->mtu_size        = p_rec->mtu_size;
+		p_bus->mtu_window      = p_rec->mtu_window;
+		p_bus->data_crc        = p_rec->data_crc;
+		p_bus->app_data_batch  = p_rec->app_data_batch;
+		p_bus->cmd_pipelining  = p_rec->cmd_pipelining;
+
+		switch (p_bus->types) {
+		case HUB_GARD_BUS_I2C:
+			p_bus->i2c.num      = p_rec->i2c_num;
+			p_bus->i2c.slave_id = p_rec->i2c_slave_id;
+			p_bus->i2c.speed    = p_rec->i2c_speed;
+			break;
+		case HUB_GARD_BUS_UART:
+			snprintf(p_bus->uart.bus_dev, sizeof(p_bus->uart.bus_dev), "%s",
+					 p_rec->uart_bus_dev);
+			p_bus->uart.baudrate         = p_rec->uart_baudrate;
+			p_bus->uart.flush_policy     =
+				(enum hub_uart_flush_policy)p_rec->uart_flush_policy;
+			p_bus->uart.hw_flow_control  = p_rec->uart_hw_flow_control;
+			p_bus->uart.target_baudrate  = p_rec->uart_target_baudrate;
+			p_bus->uart.read_timeout_ms  = p_rec->uart_read_timeout_ms;
+			p_bus->uart.probe_timeout_ms = p_rec->uart_probe_timeout_ms;
+			p_bus->uart.rx_ring_size     = p_rec->uart_rx_ring_size;
+			break;
+		case HUB_GARD_BUS_USB:
+			p_bus->usb.vendor_id  = p_rec->usb_vendor_id;
+			p_bus->usb.product_id = p_rec->usb_product_id;
+			snprintf(p_bus->usb.port_path, sizeof(p_bus->usb.port_path),
+					 "%s", p_rec->usb_port_path);
+			snprintf(p_bus->usb.serial_number,
+					 sizeof(p_bus->usb.serial_number), "%s",
+					 p_rec->usb_serial_number);
+			p_bus->usb.burst_size  = p_rec->usb_burst_size;
+			p_bus->usb.async_depth = p_rec->usb_async_depth;
+			break;
+		default:
+			break;
+		}
+	}
+
+	p_hub->num_busses      = p_cache->num_busses;
+	p_hub->gpio_exec_model = (enum hub_gpio_exec_model)p_cache->gpio_exec_model;
+	p_hub->gpio_pool_size  = p_cache->gpio_pool_size;
+	p_hub->health_probe_ms = p_cache->health_probe_ms;
+	p_hub->clock_sync_ms   = p_cache->clock_sync_ms;
+	p_hub->log_level       = p_cache->log_level;
+	for (i = 0; i < HUB_THREAD_CLASS_MAX; i++) {
+		hub_thread_set_props((enum hub_thread_class)i,
+							 &p_cache->thread_props[i]);
+	}
+
+	return HUB_SUCCESS;
+}
+
+void hub_config_cache_put_host(struct hub_config_cache *p_cache,
+							   const struct hub_ctx    *p_hub)
+{
+	const struct hub_gard_bus   *p_bus;
+	struct hub_config_cache_bus *p_rec;
+	uint32_t                     i;
+
+	free(p_cache->p_busses);
+	free(p_cache->p_gards);
+	p_cache->p_busses      = NULL;
+	p_cache->p_gards       = NULL;
+	p_cache->num_busses    = 0;
+	p_cache->num_gards     = 0;
+	p_cache->is_host_valid = false;
+
+	p_cache->p_busses = (struct hub_config_cache_bus *)calloc(
+		hub_max_int32(p_hub->num_busses, 1), sizeof(*p_cache->p_busses));
+	if (NULL == p_cache->p_busses) {
+		return;
+	}
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		p_bus = &p_hub->p_bus_props[i];
+		p_rec = &p_cache->p_busses[i];
+
+		p_rec->types           = p_bus->types;
+		p_rec->gard_index      = p_bus->gard_index;
+		p_rec->xfer_chunk_size = p_bus->xfer_chunk_size;
+		p_rec->mtu_size        = p_bus->mtu_size;
+		p_rec->mtu_window      = p_bus->mtu_window;
+		p_rec->data_crc        = p_bus->data_crc;
+		p_rec->app_data_batch  = p_bus->app_data_batch;
+		p_rec->cmd_pipelining  = p_bus->cmd_pipelining;
+
+		switch (p_bus->types) {
+		case HUB_GARD_BUS_I2C:
+			p_rec->i2c_num      = p_bus->i2c.num;
+			p_rec->i2c_slave_id = p_bus->i2c.slave_id;
+			p_rec->i2c_speed    = p_bus->i2c.speed;
+			break;
+		case HUB_GARD_BUS_UART:
+			if (hub_config_cache_put_str(p_rec->uart_bus_dev,
+										 p_bus->uart.bus_dev)) {
+				hub_pr_dbg("%s is too long to cache\n", p_bus->uart.bus_dev);
+				return;
+			}
+			p_rec->uart_baudrate         = p_bus->uart.baudrate;
+			p_rec->uart_flush_policy     = p_bus->uart.flush_policy;
+			p_rec->uart_hw_flow_control  = p_bus->uart.hw_flow_control;
+			p_rec->uart_target_baudrate  = p_bus->uart.target_baudrate;
+			p_rec->uart_read_timeout_ms  = p_bus->uart.read_timeout_ms;
+			p_rec->uart_probe_timeout_ms = p_bus->uart.probe_timeout_ms;
+			p_rec->uart_rx_ring_size     = p_bus->uart.rx_ring_size;
+			break;
+		case HUB_GARD_BUS_USB:
+			p_rec->usb_vendor_id  = p_bus->usb.vendor_id;
+			p_rec->usb_product_id = p_bus->usb.product_id;
+			memcpy(p_rec->usb_port_path, p_bus->usb.port_path,
+				   sizeof(p_rec->usb_port_path));
+			memcpy(p_rec->usb_serial_number, p_bus->usb.serial_number,
+				   sizeof(p_rec->usb_serial_number));
+			p_rec->usb_burst_size  = p_bus->usb.burst_size;
+			p_rec->usb_async_depth = p_bus->usb.async_depth;
+			break;
+		default:
+			break;
+		}
+	}
+
+	p_cache->num_busses      = p_hub->num_busses;
+	p_cache->gpio_exec_model = p_hub->gpio_exec_model;
+	p_cache->gpio_pool_size  = p_hub->gpio_pool_size;
+	p_cache->health_probe_ms = p_hub->health_probe_ms;
+	p_cache->clock_sync_ms   = p_hub->clock_sync_ms;
+	p_cache->log_level       = p_hub->log_level;
+	for (i = 0; i < HUB_THREAD_CLASS_MAX; i++) {
+		hub_thread_get_props((enum hub_thread_class)i,
+							 &p_cache->thread_props[i]);
+	}
+
+	p_cache->is_host_valid = true;
+	p_cache->is_dirty      = true;
+}
+
+enum hub_ret_code hub_config_cache_get_gard(struct hub_config_cache *p_cache,
+											struct hub_ctx          *p_hub,
+											int32_t                  profile_id,
+											const char              *p_json_file,
+											struct hub_gard_info    *p_gard)
+{
+	struct hub_config_cache_key   key;
+	struct hub_config_cache_gard *p_rec = NULL;
+	uint32_t                      i;
+
+	if ((NULL == p_cache) || !p_cache->is_host_valid ||
+		hub_config_cache_key_of(p_json_file, &key)) {
+		return HUB_FAILURE_GARD_PROBE;
+	}
+
+	for (i = 0; i < p_cache->num_gards; i++) {
+		if ((profile_id == p_cache->p_gards[i].profile_id) &&
+			!memcmp(&key, &p_cache->p_gards[i].key, sizeof(key))) {
+			p_rec = &p_cache->p_gards[i];
+			break;
+		}
+	}
+
+	if ((NULL == p_rec) ||
+		(p_rec->num_gpio_inputs > HUB_CONFIG_CACHE_MAX_GPIOS) ||
+		(p_rec->num_gpio_outputs > HUB_CONFIG_CACHE_MAX_GPIOS)) {
+		return HUB_FAILURE_GARD_PROBE;
+	}
+
+	if (p_rec->num_gpio_inputs) {
+		p_gard->gpio_inputs =
+			(uint32_t *)calloc(p_rec->num_gpio_inputs, sizeof(uint32_t));
+	}
+	if (p_rec->num_gpio_outputs) {
+		p_gard->gpio_outputs =
+			(uint32_t *)calloc(p_rec->num_gpio_outputs, sizeof(uint32_t));
+	}
+	if ((p_rec->num_gpio_inputs && (NULL == p_gard->gpio_inputs)) ||
+		(p_rec->num_gpio_outputs && (NULL == p_gard->gpio_outputs))) {
+		free(p_gard->gpio_inputs);
+		free(p_gard->gpio_outputs);
+		p_gard->gpio_inputs  = NULL;
+		p_gard->gpio_outputs = NULL;
+		return HUB_FAILURE_GARD_PROBE;
+	}
+
+	p_gard->gard_id = p_rec->gard_id;
+	snprintf(p_gard->gard_name, sizeof(p_gard->gard_name), "%s",
+			 p_rec->gard_name);
+	snprintf(p_gard->gpio_chip, sizeof(p_gard->gpio_chip), "%s",
+			 p_rec->gpio_chip);
+
+	p_gard->control_bus =
+		((p_rec->control_bus >= 0) && (p_rec->control_bus < p_hub->num_busses))
+			? &p_hub->p_bus_props[p_rec->control_bus]
+			: NULL;
+	p_gard->data_bus =
+		((p_rec->data_bus >= 0) && (p_rec->data_bus < p_hub->num_busses))
+			? &p_hub->p_bus_props[p_rec->data_bus]
+			: NULL;
+
+	p_gard->num_gpio_inputs  = p_rec->num_gpio_inputs;
+	p_gard->num_gpio_outputs = p_rec->num_gpio_outputs;
+	memcpy(p_gard->gpio_inputs, p_rec->gpio_inputs,
+		   p_rec->num_gpio_inputs * sizeof(uint32_t));
+	memcpy(p_gard->gpio_outputs, p_rec->gpio_outputs,
+		   p_rec->num_gpio_outputs * sizeof(uint32_t));
+
+	return HUB_SUCCESS;
+}
+
+void hub_config_cache_put_gard(struct hub_config_cache    *p_cache,
+							   const struct hub_ctx       *p_hub,
+							   int32_t                     profile_id,
+							   const char                 *p_json_file,
+							   const struct hub_gard_info *p_gard)
+{
+	struct hub_config_cache_gard  rec = {0};
+	struct hub_config_cache_gard *p_gards;
+	uint32_t                      i;
+
+	if ((NULL == p_cache) || !p_cache->is_host_valid ||
+		(p_gard->num_gpio_inputs > HUB_CONFIG_CACHE_MAX_GPIOS) ||
+		(p_gard->num_gpio_outputs > HUB_CONFIG_CACHE_MAX_GPIOS) ||
+		hub_config_cache_put_str(rec.gard_name, p_gard->gard_name) ||
+		hub_config_cache_put_str(rec.gpio_chip, p_gard->gpio_chip) ||
+		hub_config_cache_key_of(p_json_file, &rec.key)) {
+		return;
+	}
+
+	rec.profile_id       = profile_id;
+	rec.gard_id          = p_gard->gard_id;
+	rec.control_bus      = p_gard->control_bus
+							   ? (int32_t)(p_gard->control_bus -
+										   p_hub->p_bus_props)
+							   : -1;
+	rec.data_bus         = p_gard->data_bus
+							   ? (int32_t)(p_gard->data_bus - p_hub->p_bus_props)
+							   : -1;
+	rec.num_gpio_inputs  = p_gard->num_gpio_inputs;
+	rec.num_gpio_outputs = p_gard->num_gpio_outputs;
+	memcpy(rec.gpio_inputs, p_gard->gpio_inputs,
+		   p_gard->num_gpio_inputs * sizeof(uint32_t));
+	memcpy(rec.gpio_outputs, p_gard->gpio_outputs,
+		   p_gard->num_gpio_outputs * sizeof(uint32_t));
+
+	for (i = 0; i < p_cache->num_gards; i++) {
+		if (profile_id == p_cache->p_gards[i].profile_id) {
+			break;
+		}
+	}
+
+	if (i == p_cache->num_gards) {
+		if (HUB_CONFIG_CACHE_MAX_GARDS == p_cache->num_gards) {
+			return;
+		}
+		p_gards = (struct hub_config_cache_gard *)realloc(
+			p_cache->p_gards, (i + 1) * sizeof(*p_gards));
+		if (NULL == p_gards) {
+			return;
+		}
+		p_cache->p_gards = p_gards;
+		p_cache->num_gards++;
+	}
+
+	p_cache->p_gards[i] = rec;
+	p_cache->is_dirty   = true;
+}
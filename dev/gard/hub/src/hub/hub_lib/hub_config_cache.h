@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_CONFIG_CACHE_H__
+#define __HUB_CONFIG_CACHE_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+#define HUB_CONFIG_CACHE_MAGIC   (0x48434647U) /* "HCFG" */
+#define HUB_CONFIG_CACHE_VERSION (3U)
+
+/* The cache of host_config.json <file> is <file>.cache */
+#define HUB_CONFIG_CACHE_SUFFIX ".cache"
+
+/* Limits of a cached GARD json; GARD jsons beyond them are not cached */
+#define HUB_CONFIG_CACHE_STR_LEN   (64)
+#define HUB_CONFIG_CACHE_MAX_GPIOS (16)
+
+/**
+ * Identifies the contents of a json file without reading it: a json whose
+ * key differs from the cached one is parsed again.
+ */
+struct hub_config_cache_key {
+	uint64_t mtime_ns;
+	uint64_t size;
+	uint64_t ino;
+};
+
+/* The host_config.json properties of a bus */
+struct hub_config_cache_bus {
+	uint32_t types; /* enum hub_gard_bus_types */
+	uint32_t gard_index;
+	uint32_t xfer_chunk_size;
+	uint32_t mtu_size;
+	uint32_t mtu_window;
+	uint8_t  data_crc;
+	uint8_t  app_data_batch;
+	uint8_t  cmd_pipelining;
+	uint8_t  uart_hw_flow_control;
+	uint32_t i2c_num;
+	uint32_t i2c_slave_id;
+	uint32_t i2c_speed;
+	char     uart_bus_dev[HUB_CONFIG_CACHE_STR_LEN];
+	uint32_t uart_baudrate;
+	uint32_t uart_flush_policy; /* enum hub_uart_flush_policy */
+	uint32_t uart_target_baudrate;
+	uint32_t uart_read_timeout_ms;
+	uint32_t uart_probe_timeout_ms;
+	uint32_t uart_rx_ring_size;
+	uint32_t usb_vendor_id;
+	uint32_t usb_product_id;
+	char     usb_port_path[HUB_USB_PORT_PATH_LEN];
+	char     usb_serial_number[HUB_USB_SERIAL_LEN];
+	uint32_t usb_burst_size;
+	uint32_t usb_async_depth;
+};
+
+/* The gard_<profile id>.json properties of a GARD */
+struct hub_config_cache_gard {
+	int32_t                     profile_id;
+	uint32_t                    gard_id;
+	struct hub_config_cache_key key;
+	int32_t                     control_bus; /* Bus index, -1 if none */
+	int32_t                     data_bus;    /* Bus index, -1 if none */
+	char                        gard_name[HUB_CONFIG_CACHE_STR_LEN];
+	char                        gpio_chip[HUB_CONFIG_CACHE_STR_LEN];
+	uint32_t                    num_gpio_inputs;
+	uint32_t                    num_gpio_outputs;
+	uint32_t                    gpio_inputs[HUB_CONFIG_CACHE_MAX_GPIOS];
+	uint32_t                    gpio_outputs[HUB_CONFIG_CACHE_MAX_GPIOS];
+};
+
+/**
+ * The parsed configuration, from the cache file or from the jsons, from
+ * hub_preinit() to the end of hub_discover_gards().
+ */
+struct hub_config_cache {
+	char                          path[PATH_MAX];
+	struct hub_config_cache_key   host_key;
+	bool                          is_host_valid; /* Host part loaded */
+	bool                          is_dirty;      /* To be written back */
+
+	uint32_t                      num_busses;
+	struct hub_config_cache_bus  *p_busses;
+	uint32_t                      gpio_exec_model;
+	uint32_t                      gpio_pool_size;
+	uint32_t                      health_probe_ms;
+	uint32_t                      clock_sync_ms;
+	int32_t                       log_level;
+	struct hub_thread_props       thread_props[HUB_THREAD_CLASS_MAX];
+
+	uint32_t                      num_gards;
+	struct hub_config_cache_gard *p_gards;
+};
+
+/**
+ * hub_config_cache_load maps the cache of a host config file and takes the
+ * part of it still matching the jsons. A missing, stale or corrupt cache is
+ * not an error: its host part is then left invalid.
+ *
+ * @return: the cache, NULL if out of memory
+ */
+struct hub_config_cache *hub_config_cache_load(const char *p_host_config_file);
+
+/**
+ * hub_config_cache_save writes the cache back if it changed. Failing to is
+ * not an error, the next start parses the jsons again.
+ */
+void hub_config_cache_save(struct hub_config_cache *p_cache);
+
+void hub_config_cache_free(struct hub_config_cache *p_cache);
+
+/**
+ * hub_config_cache_get_host fills the busses and HUB properties from the
+ * host part of the cache. The bus fops are left to the caller.
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_PREINIT if the host part is invalid
+ */
+enum hub_ret_code hub_config_cache_get_host(struct hub_config_cache *p_cache,
+											struct hub_ctx          *p_hub);
+
+/**
+ * hub_config_cache_put_host replaces the host part of the cache with the
+ * busses and HUB properties parsed from host_config.json, and drops the
+ * GARDs of the former host part.
+ */
+void hub_config_cache_put_host(struct hub_config_cache *p_cache,
+							   const struct hub_ctx    *p_hub);
+
+/**
+ * hub_config_cache_get_gard fills a GARD from the cache, if the cache holds
+ * its json as it is now.
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GARD_PROBE if the GARD json is to be parsed
+ */
+enum hub_ret_code hub_config_cache_get_gard(struct hub_config_cache *p_cache,
+											struct hub_ctx          *p_hub,
+											int32_t                  profile_id,
+											const char              *p_json_file,
+											struct hub_gard_info    *p_gard);
+
+/**
+ * hub_config_cache_put_gard adds or replaces a GARD parsed from its json.
+ */
+void hub_config_cache_put_gard(struct hub_config_cache    *p_cache,
+							   const struct hub_ctx       *p_hub,
+							   int32_t                     profile_id,
+							   const char                 *p_json_file,
+							   const struct hub_gard_info *p_gard);
+
+#endif /* __HUB_CONFIG_CACHE_H__ */
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB daemon: one process holds the HUB, its bus sessions and GPIO lines
+ * from hub_init() to hub_fini(), and serves the register and data transfers
+ * of client apps over a Unix socket, see hub_daemon.h.
+ *
+ * Apps attach with hub_client_connect() without going through libusb init,
+ * kernel driver detach, discovery or GPIO line setup again, and several apps
+ * share the same GARDs: their requests are run by one thread per client,
+ * with the bus locking of the in-process APIs.
+ */
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "hub_daemon.h"
+
+/* How often the listener checks the stop flag, in ms */
+#define HUB_DAEMON_POLL_MS (200)
+
+/* One client connection, served by its own thread */
+struct hub_daemon_client {
+	hub_handle_t     hub;
+	int              fd;
+	hub_thread_hdl_t thread;
+	bool             is_used;
+	volatile bool    is_done; /* Set by the client thread as it exits */
+	uint8_t         *p_buffer;
+	uint32_t         buffer_size;
+};
+
+int hub_daemon_read_full(int fd, void *p_buffer, size_t count)
+{
+	ssize_t  nread;
+	uint8_t *p_bytes = (uint8_t *)p_buffer;
+
+	while (count) {
+		nread = read(fd, p_bytes, count);
+		if (nread < 0) {
+			if (EINTR == errno) {
+				continue;
+			}
+			return -1;
+		}
+		if (0 == nread) {
+			return -1;
+		}
+		p_bytes += nread;
+		count   -= (size_t)nread;
+	}
+
+	return 0;
+}
+
+int hub_daemon_write_full(int fd, const void *p_buffer, size_t count)
+{
+	ssize_t        nwrite;
+	const uint8_t *p_bytes = (const uint8_t *)p_buffer;
+
+	while (count) {
+		nwrite = send(fd, p_bytes, count, MSG_NOSIGNAL);
+		if (nwrite < 0) {
+			if (EINTR == errno) {
+				continue;
+			}
+			return -1;
+		}
+		p_bytes += nwrite;
+		count   -= (size_t)nwrite;
+	}
+
+	return 0;
+}
+
+/**
+ * Make the payload buffer of a client hold at least size bytes.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_daemon_client_reserve(struct hub_daemon_client *p_client,
+									 uint32_t                  size)
+{
+	uint8_t *p_buffer;
+
+	if (size <= p_client->buffer_size) {
+		return 0;
+	}
+
+	p_buffer = (uint8_t *)realloc(p_client->p_buffer, size);
+	if (NULL == p_buffer) {
+		hub_pr_err("Failed to allocate %u bytes client buffer\n", size);
+		return -1;
+	}
+
+	p_client->p_buffer    = p_buffer;
+	p_client->buffer_size = size;
+
+	return 0;
+}
+
+/**
+ * Run one request of a client.
+ *
+ * @param: p_client is the client
+ * @param: p_req is the request, its payload is read from the socket here
+ * @param: p_resp is filled with the response
+ *
+ * @return: 0 if the client can go on, -1 if its connection is to be closed
+ */
+static int hub_daemon_run_request(struct hub_daemon_client    *p_client,
+								  const struct hub_daemon_req *p_req,
+								  struct hub_daemon_resp      *p_resp)
+{
+	gard_handle_t gard = NULL;
+
+	p_resp->ret   = HUB_SUCCESS;
+	p_resp->value = 0;
+	p_resp->count = 0;
+
+	if (((HUB_DAEMON_OP_SEND_DATA == p_req->op) ||
+		 (HUB_DAEMON_OP_RECV_DATA == p_req->op)) &&
+		(p_req->count > HUB_DAEMON_MAX_XFER_SIZE)) {
+		hub_pr_err("Client transfer of %u bytes is too large\n",
+				   p_req->count);
+		return -1;
+	}
+
+	if (HUB_DAEMON_OP_HELLO != p_req->op) {
+		if (p_req->gard_num < hub_get_num_gards(p_client->hub)) {
+			gard =
+				hub_get_gard_handle(p_client->hub, (uint8_t)p_req->gard_num);
+		}
+	}
+
+	switch (p_req->op) {
+	case HUB_DAEMON_OP_HELLO:
+		if (HUB_DAEMON_PROTO_VERSION != p_req->value) {
+			hub_pr_err("Client protocol version %u, expected %u\n",
+					   p_req->value, HUB_DAEMON_PROTO_VERSION);
+			p_resp->ret = HUB_FAILURE_DAEMON;
+			break;
+		}
+		p_resp->value = hub_get_num_gards(p_client->hub);
+		break;
+	case HUB_DAEMON_OP_READ_REG:
+		p_resp->ret = (NULL == gard) ? HUB_FAILURE_READ_REG
+									 : hub_read_gard_reg(gard, p_req->addr,
+														 &p_resp->value);
+		break;
+	case HUB_DAEMON_OP_WRITE_REG:
+		p_resp->ret = (NULL == gard) ? HUB_FAILURE_WRITE_REG
+									 : hub_write_gard_reg(gard, p_req->addr,
+														  p_req->value);
+		break;
+	case HUB_DAEMON_OP_SEND_DATA:
+		/* The payload is read even for a bad GARD, to stay in sync */
+		if (hub_daemon_client_reserve(p_client, p_req->count) ||
+			hub_daemon_read_full(p_client->fd, p_client->p_buffer,
+								 p_req->count)) {
+			return -1;
+		}
+		p_resp->ret = (NULL == gard)
+						  ? HUB_FAILURE_SEND_DATA
+						  : hub_send_data_to_gard(gard, p_client->p_buffer,
+												  p_req->addr, p_req->count);
+		break;
+	case HUB_DAEMON_OP_RECV_DATA:
+		if (hub_daemon_client_reserve(p_client, p_req->count)) {
+			return -1;
+		}
+		p_resp->ret = (NULL == gard)
+						  ? HUB_FAILURE_RECV_DATA
+						  : hub_recv_data_from_gard(gard, p_client->p_buffer,
+													p_req->addr, p_req->count);
+		if (HUB_SUCCESS == p_resp->ret) {
+			p_resp->count = p_req->count;
+		}
+		break;
+	default:
+		hub_pr_err("Unknown client request %u\n", p_req->op);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Thread function of a client connection: runs its requests until it
+ * disconnects, sends a bad request, or the daemon stops.
+ *
+ * @param: p_params is the struct hub_daemon_client
+ *
+ * @return: NULL
+ */
+static void *hub_daemon_client_func(void *p_params)
+{
+	struct hub_daemon_client *p_client = (struct hub_daemon_client *)p_params;
+	struct hub_daemon_req     req;
+	struct hub_daemon_resp    resp;
+
+	while (0 == hub_daemon_read_full(p_client->fd, &req, sizeof(req))) {
+		if (hub_daemon_run_request(p_client, &req, &resp)) {
+			break;
+		}
+
+		if (hub_daemon_write_full(p_client->fd, &resp, sizeof(resp)) ||
+			(resp.count && hub_daemon_write_full(p_client->fd,
+												 p_client->p_buffer,
+												 resp.count))) {
+			break;
+		}
+	}
+
+	hub_pr_dbg("Client on fd %d gone\n", p_client->fd);
+	__atomic_store_n(&p_client->is_done, true, __ATOMIC_SEQ_CST);
+
+	return NULL;
+}
+
+/**
+ * Join the thread of a client and free its slot.
+ */
+static void hub_daemon_client_reap(struct hub_daemon_client *p_client)
+{
+	(void)hub_thread_join(p_client->thread, NULL);
+	close(p_client->fd);
+	free(p_client->p_buffer);
+	memset(p_client, 0, sizeof(*p_client));
+}
+
+/**
+ * hub_daemon_serve serves the register and data transfers of HUB clients
+ * over a Unix socket, see hub.h.
+ */
+enum hub_ret_code hub_daemon_serve(hub_handle_t   hub,
+								   const char    *p_socket_path,
+								   volatile int  *p_stop)
+{
+	struct hub_daemon_client *p_clients;
+	struct sockaddr_un        addr = {0};
+	struct pollfd             pfd;
+	int                       listen_fd, fd, ret;
+	uint32_t                  i;
+
+	if ((NULL == hub) || (NULL == p_socket_path) || (NULL == p_stop) ||
+		(strlen(p_socket_path) >= sizeof(addr.sun_path))) {
+		hub_pr_err("Invalid HUB handle or daemon socket path\n");
+		return HUB_FAILURE_DAEMON;
+	}
+
+	p_clients = (struct hub_daemon_client *)calloc(HUB_DAEMON_MAX_CLIENTS,
+												   sizeof(*p_clients));
+	if (NULL == p_clients) {
+		hub_pr_err("Failed to allocate daemon clients\n");
+		return HUB_FAILURE_DAEMON;
+	}
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listen_fd < 0) {
+		hub_pr_err("Failed to create daemon socket\n");
+		goto err_daemon_serve_1;
+	}
+
+	/* A socket left over by a daemon that did not stop cleanly */
+	(void)unlink(p_socket_path);
+
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, p_socket_path);
+	if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+		listen(listen_fd, HUB_DAEMON_MAX_CLIENTS)) {
+		hub_pr_err("Failed to listen on %s\n", p_socket_path);
+		goto err_daemon_serve_2;
+	}
+
+	hub_pr_dbg("HUB daemon listening on %s\n", p_socket_path);
+
+	pfd.fd     = listen_fd;
+	pfd.events = POLLIN;
+	while (!*p_stop) {
+		/* Free the slots of the clients that are gone */
+		for (i = 0; i < HUB_DAEMON_MAX_CLIENTS; i++) {
+			if (p_clients[i].is_used &&
+				__atomic_load_n(&p_clients[i].is_done, __ATOMIC_SEQ_CST)) {
+				hub_daemon_client_reap(&p_clients[i]);
+			}
+		}
+
+		ret = poll(&pfd, 1, HUB_DAEMON_POLL_MS);
+		if (ret <= 0) {
+			continue;
+		}
+
+		fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0) {
+			continue;
+		}
+
+		for (i = 0; i < HUB_DAEMON_MAX_CLIENTS; i++) {
+			if (!p_clients[i].is_used) {
+				break;
+			}
+		}
+		if (HUB_DAEMON_MAX_CLIENTS == i) {
+			hub_pr_warn("Too many HUB clients, turning one away\n");
+			close(fd);
+			continue;
+		}
+
+		p_clients[i].hub     = hub;
+		p_clients[i].fd      = fd;
+		p_clients[i].is_done = false;
+		if (HUB_SUCCESS != hub_thread_create(&p_clients[i].thread, NULL,
+											 HUB_THREAD_CLASS_CLIENT,
+											 "hub_client",
+											 hub_daemon_client_func,
+											 &p_clients[i])) {
+			hub_pr_err("Failed to create HUB client thread\n");
+			close(fd);
+			continue;
+		}
+		p_clients[i].is_used = true;
+	}
+
+	/* Unblock the client threads, and wait for them */
+	for (i = 0; i < HUB_DAEMON_MAX_CLIENTS; i++) {
+		if (p_clients[i].is_used) {
+			(void)shutdown(p_clients[i].fd, SHUT_RDWR);
+			hub_daemon_client_reap(&p_clients[i]);
+		}
+	}
+
+	close(listen_fd);
+	(void)unlink(p_socket_path);
+	free(p_clients);
+
+	return HUB_SUCCESS;
+
+err_daemon_serve_2:
+	close(listen_fd);
+err_daemon_serve_1:
+	free(p_clients);
+	return HUB_FAILURE_DAEMON;
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_DAEMON_H__
+#define __HUB_DAEMON_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+/**
+ * Protocol between the HUB daemon, see hub_daemon_serve(), and its clients,
+ * see hub_client_connect(), over a Unix stream socket. Both ends run on the
+ * same host, so the messages are in its byte order.
+ *
+ * A client sends a request, followed by count bytes of payload for
+ * HUB_DAEMON_OP_SEND_DATA, and waits for the response, followed by count
+ * bytes of payload for a successful HUB_DAEMON_OP_RECV_DATA. The first
+ * request of a client is HUB_DAEMON_OP_HELLO.
+ */
+#define HUB_DAEMON_PROTO_VERSION (1U)
+
+/* Largest payload of a request or a response */
+#define HUB_DAEMON_MAX_XFER_SIZE (16U * 1024U * 1024U)
+
+/* Most clients served at once, more are turned away */
+#define HUB_DAEMON_MAX_CLIENTS (16)
+
+enum hub_daemon_op {
+	HUB_DAEMON_OP_HELLO = 0, /* value: protocol version; resp value: GARDs */
+	HUB_DAEMON_OP_READ_REG,  /* addr; resp value: register value */
+	HUB_DAEMON_OP_WRITE_REG, /* addr, value */
+	HUB_DAEMON_OP_SEND_DATA, /* addr, count, payload */
+	HUB_DAEMON_OP_RECV_DATA, /* addr, count; resp payload */
+	HUB_DAEMON_OP_MAX,
+};
+
+struct hub_daemon_req {
+	uint32_t op; /* enum hub_daemon_op */
+	uint32_t gard_num;
+	uint32_t addr;
+	uint32_t value;
+	uint32_t count;
+};
+
+struct hub_daemon_resp {
+	int32_t  ret; /* enum hub_ret_code */
+	uint32_t value;
+	uint32_t count;
+};
+
+/**
+ * hub_daemon_read_full / hub_daemon_write_full move count bytes on a socket,
+ * across short reads / writes and signals.
+ *
+ * @return: 0 on success, -1 on error or if the peer closed the socket
+ */
+int hub_daemon_read_full(int fd, void *p_buffer, size_t count);
+int hub_daemon_write_full(int fd, const void *p_buffer, size_t count);
+
+#endif /* __HUB_DAEMON_H__ */
@@ -5,14 +5,17 @@
  *
  ******************************************************************************/
 
+#include <stdlib.h>
+
 #include "hub_data_ops.h"
 #include "hub_bulk_ops.h"
+#include "hub_utils.h"
 
 /**
  * TBD-DPN: The code for send_data and recv_data corresponds to features that
  * are presently supported by the GARD FW for non-USB data bus:
- * 1. No checksum support
- * 2. No MTU size support
+ * 1. CRC-32 support only when the bus has "data_crc" set
+ * 2. MTU size support for send_data only, see hub_send_data_frames
  * 3. Truncated packet write/read if checksum is not supported
  *    - not the full eod structure
  *
@@ -21,36 +24,129 @@
  */
 
 /**
- * Send a data buffer of a specified size from HUB to an
- * address in the GARD memory map represented by the gard handle.
+ * A data bus that failed a transfer is left for the fallback data bus of
+ * its GARD for that long, then tried again.
+ */
+#define HUB_BUS_FAILBACK_NS (2000000000ULL)
+
+/**
+ * Chunk size of hub_recv_data_from_gard_progressive() when the caller gives
+ * none, and count of its chunks queued at once.
+ */
+#define HUB_RECV_PROGRESSIVE_CHUNK_SIZE (64 * 1024)
+#define HUB_RECV_PROGRESSIVE_DEPTH      (4)
+
+/**
+ * State of a progressive receive, see hub_recv_data_from_gard_progressive().
+ */
+struct hub_recv_progressive {
+	hub_mutex_t    lock;
+	hub_cond_var_t done_cond_var;
+};
+
+/**
+ * A chunk of a progressive receive, queued as an asynchronous receive.
+ */
+struct hub_recv_chunk {
+	struct hub_recv_progressive *p_recv;
+	bool                         is_done;
+	enum hub_ret_code            ret;
+};
+
+/**
+ * Bus the next data transfer of a GARD goes over: its data bus, unless that
+ * failed less than HUB_BUS_FAILBACK_NS ago and there is a fallback data bus.
  *
- * @param: p_gard_handle is the GARD handle to use for sending data to
+ * @param: gard is the GARD to transfer data with
+ *
+ * @return: the data bus or the fallback data bus of the GARD
+ */
+static struct hub_gard_bus *hub_gard_data_route(struct hub_gard_info *gard)
+{
+	uint64_t failed_at_ns;
+
+	if (NULL == gard->fallback_data_bus) {
+		return gard->data_bus;
+	}
+
+	failed_at_ns =
+		__atomic_load_n(&gard->data_bus->failed_at_ns, __ATOMIC_SEQ_CST);
+	if (failed_at_ns &&
+		((hub_stats_now_ns() - failed_at_ns) < HUB_BUS_FAILBACK_NS)) {
+		return gard->fallback_data_bus;
+	}
+
+	return gard->data_bus;
+}
+
+/**
+ * Account for the outcome of a data transfer on the bus hub_gard_data_route()
+ * gave. A failure on the data bus fails the GARD over to its fallback data
+ * bus, a success on it fails the GARD back.
+ *
+ * @param: gard is the GARD data was transferred with
+ * @param: p_bus is the bus the transfer went over
+ * @param: ret is the outcome of the transfer
+ *
+ * @return: true if the transfer is to be run again on the fallback data bus
+ */
+static bool hub_gard_data_failover(struct hub_gard_info *gard,
+								   struct hub_gard_bus  *p_bus,
+								   enum hub_ret_code     ret)
+{
+	if (p_bus != gard->data_bus) {
+		return false;
+	}
+
+	if (HUB_SUCCESS == ret) {
+		if (__atomic_exchange_n(&p_bus->failed_at_ns, 0, __ATOMIC_SEQ_CST)) {
+			hub_pr_warn("GARD %u: back on data bus %s\n", gard->gard_index,
+						hub_gard_bus_strings[p_bus->types]);
+		}
+		return false;
+	}
+
+	if (NULL == gard->fallback_data_bus) {
+		return false;
+	}
+
+	__atomic_store_n(&p_bus->failed_at_ns, hub_stats_now_ns(),
+					 __ATOMIC_SEQ_CST);
+	hub_pr_warn("GARD %u: data bus %s failed, failing over to %s\n",
+				gard->gard_index, hub_gard_bus_strings[p_bus->types],
+				hub_gard_bus_strings[gard->fallback_data_bus->types]);
+
+	return true;
+}
+
+/**
+ * Run one SEND_DATA_TO_GARD_FOR_OFFSET exchange on a locked I2C / UART bus.
+ *
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
  * @param: p_buffer is a buffer containing data to write
  * @param: addr is an address in GARD's memory map to write to
  * @param: count is the number of bytes to write
  *
- * @return: hub_ret_code return code indicating success/failure
- * 		 HUB_SUCCESS for success
- * 		 HUB_FAILURE_SEND_DATA for failure
+ * @return: 0 on success, -1 on failure
  */
-enum hub_ret_code hub_send_data_to_gard(gard_handle_t p_gard_handle,
-										const void   *p_buffer,
-										uint32_t      addr,
-										uint32_t      count)
+static int hub_send_data_chunk(struct hub_gard_bus  *p_bus,
+							   int                   bus_hdl,
+							   const void           *p_buffer,
+							   uint32_t              addr,
+							   uint32_t              count)
 {
-	enum hub_ret_code       ret;
-	int                     bus_hdl;
-	ssize_t                 nread, nwrite;
-	enum hub_gard_bus_types bus_type;
-
-	struct hub_gard_info   *gard = (struct hub_gard_info *)p_gard_handle;
-
-	struct _host_requests   send_data_cmd      = {0};
-	struct _host_responses  send_data_response = {0};
-	enum control_codes      cc;
+	ssize_t                nread, nwrite;
+	struct iovec           iov[4];
+	struct _host_requests  send_data_cmd      = {0};
+	struct _host_responses send_data_response = {0};
+	enum control_codes     cc;
 
 	send_data_cmd.command_id = SEND_DATA_TO_GARD_FOR_OFFSET;
 	cc                       = CC_SEND_ACK_AFTER_XFER;
+	if (p_bus->data_crc) {
+		cc |= CC_CHECKSUM_PRESENT;
+	}
 	send_data_cmd.send_data_to_gard_for_offset_request.cmd.offset_address =
 		addr;
 	send_data_cmd.send_data_to_gard_for_offset_request.cmd.data_size    = count;
@@ -59,234 +155,571 @@ enum hub_ret_code hub_send_data_to_gard(gard_handle_t p_gard_handle,
 
 	send_data_cmd.send_data_to_gard_for_offset_request.eod.end_of_data_marker =
 		END_OF_DATA_MARKER;
-	send_data_cmd.send_data_to_gard_for_offset_request.eod.opt_crc = 0;
-
-	bus_type = gard->data_bus->types;
-	switch (bus_type) {
-	case HUB_GARD_BUS_I2C:
-		bus_hdl = gard->data_bus->i2c.bus_hdl;
-		break;
-	case HUB_GARD_BUS_UART:
-		bus_hdl = gard->data_bus->uart.bus_hdl;
-		break;
-	case HUB_GARD_BUS_USB:
-		ret = hub_write_data_blob_to_gard(p_gard_handle, p_buffer, addr, count);
-		return ret;
-		break;
-	default:
-		hub_pr_err("%s: Bus not supported for send_data!\n",
-				   hub_gard_bus_strings[bus_type]);
-		goto err_send_data_1;
-	}
-
-	/* Lock the data bus mutex before bus operations */
-	hub_mutex_lock(&gard->data_bus->bus_mutex);
-
-	/* We now assume that the bus is open! */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &send_data_cmd.command_id, sizeof(send_data_cmd.command_id));
-	if (sizeof(send_data_cmd.command_id) != nwrite) {
-		hub_pr_err("Error sending send_data cmd id\n");
-		goto err_send_data_2;
-	}
-
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &send_data_cmd.command_body,
-		sizeof(send_data_cmd.send_data_to_gard_for_offset_request.cmd));
-	if (sizeof(send_data_cmd.send_data_to_gard_for_offset_request.cmd) !=
-		nwrite) {
-		hub_pr_err("Error sending send_data cmd\n");
-		goto err_send_data_2;
-	}
-
-	nwrite = gard->data_bus->fops.device_write(bus_hdl, p_buffer, count);
-	if (count != nwrite) {
-		printf("Error sending send_data buffer\n");
-		goto err_send_data_2;
-	}
+	send_data_cmd.send_data_to_gard_for_offset_request.eod.opt_crc =
+		(cc & CC_CHECKSUM_PRESENT) ? hub_crc32(0, p_buffer, count) : 0;
 
 	/**
 	 * Note: HUB writes a "truncated" packet (not the full eod) as
 	 * part of send_data since that is what GARD FW expects
 	 * when CRC is not enabled.
+	 *
+	 * The cmd id, cmd, payload and eod marker go out in one bus
+	 * transaction.
 	 */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl,
-		&(send_data_cmd.send_data_to_gard_for_offset_request.eod
-			  .end_of_data_marker),
-		sizeof(send_data_cmd.send_data_to_gard_for_offset_request.eod
-				   .end_of_data_marker));
-	if (sizeof(send_data_cmd.send_data_to_gard_for_offset_request.eod
-				   .end_of_data_marker) != nwrite) {
-		hub_pr_err("Error sending send_data eod\n");
-		goto err_send_data_2;
+	iov[0].iov_base = &send_data_cmd.command_id;
+	iov[0].iov_len  = sizeof(send_data_cmd.command_id);
+	iov[1].iov_base = &send_data_cmd.command_body;
+	iov[1].iov_len =
+		sizeof(send_data_cmd.send_data_to_gard_for_offset_request.cmd);
+	iov[2].iov_base = (void *)p_buffer;
+	iov[2].iov_len  = count;
+	iov[3].iov_base = &send_data_cmd.send_data_to_gard_for_offset_request.eod
+						   .end_of_data_marker;
+	iov[3].iov_len  = sizeof(send_data_cmd.send_data_to_gard_for_offset_request
+								 .eod.end_of_data_marker);
+	if (cc & CC_CHECKSUM_PRESENT) {
+		iov[3].iov_len +=
+			sizeof(send_data_cmd.send_data_to_gard_for_offset_request.eod
+					   .opt_crc);
+	}
+
+	/* We now assume that the bus is open! */
+	nwrite = p_bus->fops.device_writev(bus_hdl, iov, 4);
+	if (hub_iov_len(iov, 4) != nwrite) {
+		hub_pr_err("Error sending send_data cmd\n");
+		return -1;
 	}
 
 	/* Bus response collect */
-	nread = gard->data_bus->fops.device_read(
+	nread = p_bus->fops.device_read(
 		bus_hdl,
 		(void *)&send_data_response.send_data_to_gard_for_offset_response,
 		sizeof(send_data_response.send_data_to_gard_for_offset_response));
 	if (sizeof(send_data_response.send_data_to_gard_for_offset_response) !=
 		nread) {
 		hub_pr_err("Error getting send_data response\n");
-		goto err_send_data_2;
+		return -1;
 	}
 
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
-
+	/* With CC_CHECKSUM_PRESENT, GARD NAKs a payload with a bad CRC */
 	if (ACK_BYTE !=
 		send_data_response.send_data_to_gard_for_offset_response.opt_ack) {
 		hub_pr_err("Error in send_data ack\n");
-		goto err_send_data_2;
+		return -1;
 	}
 
-	hub_pr_dbg("SUCCESS!\n");
+	return 0;
+}
 
-	return HUB_SUCCESS;
+/**
+ * Send one packet of a SEND_DATA_TO_GARD_FOR_OFFSET command sent with
+ * CC_USE_MTU_SIZE.
+ *
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
+ * @param: p_buffer is the whole buffer of the command
+ * @param: count is the number of bytes of the command
+ * @param: frame_num is the packet to send
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_send_data_frame(struct hub_gard_bus  *p_bus,
+							   int                   bus_hdl,
+							   const uint8_t        *p_buffer,
+							   uint32_t              count,
+							   uint32_t              frame_num)
+{
+	ssize_t                    nwrite;
+	struct iovec               iov[3];
+	struct _data_frame_header  hdr;
+	struct _data_frame_trailer trl;
+	const uint8_t             *p_data;
+	uint32_t                   offset;
 
-err_send_data_2:
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
-err_send_data_1:
-	return HUB_FAILURE_SEND_DATA;
+	offset         = frame_num * p_bus->mtu_size;
+	p_data         = p_buffer + offset;
+
+	hdr.frame_num  = frame_num;
+	hdr.frame_size = hub_min_uint32(p_bus->mtu_size, count - offset);
+
+	trl.crc        = hub_crc32(0, p_data, hdr.frame_size);
+
+	iov[0].iov_base = &hdr;
+	iov[0].iov_len  = sizeof(hdr);
+	iov[1].iov_base = (void *)p_data;
+	iov[1].iov_len  = hdr.frame_size;
+	iov[2].iov_base = &trl;
+	iov[2].iov_len  = sizeof(trl);
+
+	nwrite          = p_bus->fops.device_writev(bus_hdl, iov, 3);
+	if (hub_iov_len(iov, 3) != nwrite) {
+		hub_pr_err("Error sending send_data packet %u\n", frame_num);
+		return -1;
+	}
+
+	return 0;
 }
 
 /**
- * Receive data of specified size from an address in the
- * GARD memory map represented	by the GARD handle, into a HUB
- * data buffer.
+ * Collect the response to one packet of a SEND_DATA_TO_GARD_FOR_OFFSET
+ * command sent with CC_USE_MTU_SIZE.
  *
- * Note: If this function is called to receive image data from GARD,
- * say, after hub_capture_rescaled_image_from_gard() is called, then
- * HUB / Host Applicaiton should also call hub_send_resume_pipeline() after
- * receiving the image content to signal GARD FW to resume the paused AI
- * workload.
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
+ * @param: frame_num is the packet the response is for
+ * @param: p_frame_resp is filled with the response
  *
- * @param: p_gard_handle is the GARD handle for preforming the read blob
- * @param: p_buffer is the buffer to be filled on successful read
- * @param: addr is an address in GARD's memory map to read from
- * @param: count is the number of bytes to read
+ * @return: 0 on success, -1 on failure or if GARD aborted the transfer
+ */
+static int hub_recv_data_frame_response(
+	struct hub_gard_bus         *p_bus,
+	int                          bus_hdl,
+	uint32_t                     frame_num,
+	struct _data_frame_response *p_frame_resp)
+{
+	ssize_t nread;
+
+	nread = p_bus->fops.device_read(bus_hdl, (void *)p_frame_resp,
+											 sizeof(*p_frame_resp));
+	if (sizeof(*p_frame_resp) != nread) {
+		hub_pr_err("Error getting response for send_data packet %u\n",
+				   frame_num);
+		return -1;
+	}
+
+	if (GARD_HUB_FRAME_NUM_ABORT == p_frame_resp->next_frame_num) {
+		hub_pr_err("GARD aborted send_data at packet %u\n", frame_num);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Run one SEND_DATA_TO_GARD_FOR_OFFSET exchange with CC_USE_MTU_SIZE on a
+ * locked I2C / UART bus.
  *
- * @return: hub_ret_code
- * 		HUB_SUCCESS on success
- * 		HUB_FAILURE_RECV_DATA on failure
+ * The payload goes out in packets of the bus mtu_size, with up to
+ * mtu_window of them sent ahead of their response. GARD answers every
+ * packet in order. On a NAK, GARD drops the packets still in flight
+ * (answering each of them with the same NAK) and HUB resends from the
+ * packet GARD asks for.
+ *
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
+ * @param: p_buffer is a buffer containing data to write
+ * @param: addr is an address in GARD's memory map to write to
+ * @param: count is the number of bytes to write, not 0
+ *
+ * @return: 0 on success, -1 on failure
  */
-enum hub_ret_code hub_recv_data_from_gard(gard_handle_t p_gard_handle,
-										  void         *p_buffer,
-										  uint32_t      addr,
-										  uint32_t      count)
+static int hub_send_data_frames(struct hub_gard_bus  *p_bus,
+								int                   bus_hdl,
+								const void           *p_buffer,
+								uint32_t              addr,
+								uint32_t              count)
 {
-	enum hub_ret_code       ret;
-	int                     bus_hdl;
-	ssize_t                 nread, nwrite;
-	enum hub_gard_bus_types bus_type;
-	uint32_t                data_size = 0;
+	ssize_t                     nwrite;
+	struct iovec                iov[2];
+	struct _host_requests       send_data_cmd = {0};
+	struct _data_frame_response frame_resp;
+	uint32_t                    num_frames, next_to_send, next_to_ack, i;
+	uint32_t                    num_retries = 0;
 
-	struct hub_gard_info   *gard      = (struct hub_gard_info *)p_gard_handle;
+	num_frames = ((count - 1) / p_bus->mtu_size) + 1;
+	if (num_frames >= GARD_HUB_FRAME_NUM_ABORT) {
+		hub_pr_err("Too many packets (%u) for send_data\n", num_frames);
+		return -1;
+	}
 
-	struct _host_requests   recv_data_cmd      = {0};
-	struct _host_responses  recv_data_response = {0};
-	enum control_codes      cc;
+	send_data_cmd.command_id = SEND_DATA_TO_GARD_FOR_OFFSET;
+	send_data_cmd.send_data_to_gard_for_offset_request.cmd.offset_address =
+		addr;
+	send_data_cmd.send_data_to_gard_for_offset_request.cmd.data_size = count;
+	send_data_cmd.send_data_to_gard_for_offset_request.cmd.control_code =
+		CC_USE_MTU_SIZE;
+	send_data_cmd.send_data_to_gard_for_offset_request.cmd.mtu_size =
+		p_bus->mtu_size;
 
-	recv_data_cmd.command_id = RECV_DATA_FROM_GARD_AT_OFFSET;
-	cc                       = 0;
+	iov[0].iov_base = &send_data_cmd.command_id;
+	iov[0].iov_len  = sizeof(send_data_cmd.command_id);
+	iov[1].iov_base = &send_data_cmd.command_body;
+	iov[1].iov_len =
+		sizeof(send_data_cmd.send_data_to_gard_for_offset_request.cmd);
 
-	recv_data_cmd.recv_data_from_gard_at_offset_request.offset_address = addr;
-	recv_data_cmd.recv_data_from_gard_at_offset_request.data_size      = count;
-	recv_data_cmd.recv_data_from_gard_at_offset_request.control_code   = cc;
-	recv_data_cmd.recv_data_from_gard_at_offset_request.mtu_size       = 0;
+	/* We now assume that the bus is open! */
+	nwrite = p_bus->fops.device_writev(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
+		hub_pr_err("Error sending send_data cmd\n");
+		return -1;
+	}
+
+	next_to_send = 0;
+	next_to_ack  = 0;
+	while (next_to_ack < num_frames) {
+		/* Keep the window full */
+		while ((next_to_send < num_frames) &&
+			   ((next_to_send - next_to_ack) < p_bus->mtu_window)) {
+			if (hub_send_data_frame(p_bus, bus_hdl, p_buffer, count,
+									next_to_send)) {
+				return -1;
+			}
+			next_to_send++;
+		}
 
-	bus_type = gard->data_bus->types;
+		/* Response to the oldest packet in flight */
+		if (hub_recv_data_frame_response(p_bus, bus_hdl, next_to_ack,
+										 &frame_resp)) {
+			return -1;
+		}
+
+		if (ACK_BYTE == frame_resp.ack_or_nak) {
+			if (frame_resp.next_frame_num != (next_to_ack + 1)) {
+				hub_pr_err("Unexpected ACK for send_data packet %u\n",
+						   next_to_ack);
+				return -1;
+			}
+			next_to_ack++;
+			num_retries = 0;
+			continue;
+		}
+
+		if (frame_resp.next_frame_num != next_to_ack) {
+			hub_pr_err("Unexpected NAK for send_data packet %u\n",
+					   next_to_ack);
+			return -1;
+		}
+
+		/* GARD drops the packets sent after the NAKed one, NAKing each */
+		for (i = next_to_ack + 1; i < next_to_send; i++) {
+			if (hub_recv_data_frame_response(p_bus, bus_hdl, i, &frame_resp)) {
+				return -1;
+			}
+
+			if ((ACK_BYTE == frame_resp.ack_or_nak) ||
+				(frame_resp.next_frame_num != next_to_ack)) {
+				hub_pr_err("Unexpected response for send_data packet %u\n",
+						   i);
+				return -1;
+			}
+		}
+
+		if (++num_retries > HUB_MTU_MAX_RETRIES) {
+			hub_pr_err("Giving up send_data packet %u after %u retries\n",
+					   next_to_ack, HUB_MTU_MAX_RETRIES);
+			return -1;
+		}
+
+		hub_pr_dbg("Resending send_data from packet %u\n", next_to_ack);
+		next_to_send = next_to_ack;
+	}
+
+	return 0;
+}
+
+/**
+ * Send a data buffer to GARD on one of its I2C / UART / USB buses, see
+ * hub_send_data_to_gard(). I2C / UART data blobs go out this way too, see
+ * hub_write_data_blob_to_gard().
+ *
+ * @param: gard is the GARD to send data to
+ * @param: p_bus is the data bus or the fallback data bus of the GARD
+ * @param: p_buffer is a buffer containing data to write
+ * @param: addr is an address in GARD's memory map to write to
+ * @param: count is the number of bytes to write
+ *
+ * @return: hub_ret_code return code indicating success/failure
+ * 		 HUB_SUCCESS for success
+ * 		 HUB_FAILURE_SEND_DATA for failure
+ */
+enum hub_ret_code hub_send_data_on_bus(struct hub_gard_info *gard,
+									   struct hub_gard_bus  *p_bus,
+									   const void           *p_buffer,
+									   uint32_t              addr,
+									   uint32_t              count)
+{
+	int                     bus_hdl, xfer_err;
+	enum hub_gard_bus_types bus_type;
+	uint32_t                offset, chunk_size;
+
+	bus_type = p_bus->types;
 	switch (bus_type) {
 	case HUB_GARD_BUS_I2C:
-		bus_hdl = gard->data_bus->i2c.bus_hdl;
+		bus_hdl = p_bus->i2c.bus_hdl;
 		break;
 	case HUB_GARD_BUS_UART:
-		bus_hdl = gard->data_bus->uart.bus_hdl;
+		bus_hdl = p_bus->uart.bus_hdl;
 		break;
 	case HUB_GARD_BUS_USB:
-		ret =
-			hub_read_data_blob_from_gard(p_gard_handle, p_buffer, addr, count);
-		return ret;
+		return hub_write_data_blob_to_gard((gard_handle_t)gard, p_buffer, addr,
+										   count);
 		break;
 	default:
-		hub_pr_err("%s: Bus not supported for recv_data!\n",
+		hub_pr_err("%s: Bus not supported for send_data!\n",
 				   hub_gard_bus_strings[bus_type]);
-		goto err_recv_data_1;
+		goto err_send_data_1;
 	}
 
 	/* Lock the data bus mutex before bus operations */
-	hub_mutex_lock(&gard->data_bus->bus_mutex);
+	hub_mutex_lock(&p_bus->bus_mutex);
 
-	/* We now assume that the bus is open! */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &recv_data_cmd.command_id, sizeof(recv_data_cmd.command_id));
-	if (sizeof(recv_data_cmd.command_id) != nwrite) {
-		hub_pr_err("Error sending recv_data cmd\n");
-		goto err_recv_data_2;
+	offset = 0;
+	do {
+		chunk_size = count - offset;
+		if (p_bus->xfer_chunk_size) {
+			chunk_size = hub_min_uint32(chunk_size, p_bus->xfer_chunk_size);
+		}
+
+		if (offset) {
+			hub_bus_yield(p_bus);
+		}
+
+		if (p_bus->mtu_size && chunk_size) {
+			xfer_err = hub_send_data_frames(p_bus, bus_hdl,
+											(const uint8_t *)p_buffer + offset,
+											addr + offset, chunk_size);
+		} else {
+			xfer_err = hub_send_data_chunk(p_bus, bus_hdl,
+										   (const uint8_t *)p_buffer + offset,
+										   addr + offset, chunk_size);
+		}
+		if (xfer_err) {
+			goto err_send_data_2;
+		}
+
+		offset += chunk_size;
+	} while (offset < count);
+
+	hub_mutex_unlock(&p_bus->bus_mutex);
+
+	hub_pr_dbg("SUCCESS!\n");
+
+	return HUB_SUCCESS;
+
+err_send_data_2:
+	hub_mutex_unlock(&p_bus->bus_mutex);
+err_send_data_1:
+	return HUB_FAILURE_SEND_DATA;
+}
+
+/**
+ * Send a data buffer of a specified size from HUB to an
+ * address in the GARD memory map represented by the gard handle.
+ *
+ * If the data bus has an "xfer_chunk_size", the buffer goes out in
+ * commands of at most that size, and register accesses and commands
+ * waiting for the same bus get it between two chunks. If it has an
+ * "mtu_size", each command sends its payload in ACKed packets.
+ *
+ * If the transfer fails on the data bus, it is sent again on the fallback
+ * data bus of the GARD, see hub_gard_data_failover().
+ *
+ * @param: p_gard_handle is the GARD handle to use for sending data to
+ * @param: p_buffer is a buffer containing data to write
+ * @param: addr is an address in GARD's memory map to write to
+ * @param: count is the number of bytes to write
+ *
+ * @return: hub_ret_code return code indicating success/failure
+ * 		 HUB_SUCCESS for success
+ * 		 HUB_FAILURE_SEND_DATA for failure
+ */
+enum hub_ret_code hub_send_data_to_gard(gard_handle_t p_gard_handle,
+										const void   *p_buffer,
+										uint32_t      addr,
+										uint32_t      count)
+{
+	enum hub_ret_code     ret;
+	struct hub_gard_bus  *p_bus;
+	uint64_t              start_ns;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	start_ns                   = hub_stats_now_ns();
+
+	p_bus                      = hub_gard_data_route(gard);
+	ret = hub_send_data_on_bus(gard, p_bus, p_buffer, addr, count);
+	if (hub_gard_data_failover(gard, p_bus, ret)) {
+		ret = hub_send_data_on_bus(gard, gard->fallback_data_bus, p_buffer,
+								   addr, count);
 	}
 
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &recv_data_cmd.command_body,
-		sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request));
-	if (sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request) != nwrite) {
-		hub_pr_err("Error sending recv_data request\n");
-		goto err_recv_data_2;
+	hub_stats_record(gard, HUB_STATS_OP_SEND_DATA, start_ns,
+					 (HUB_SUCCESS == ret) ? count : 0, HUB_SUCCESS != ret);
+
+	return ret;
+}
+
+/**
+ * Read the segments of a CC_SEGMENTED recv_data payload. An empty segment
+ * announces the response of a tagged command sent meanwhile: the pipe is
+ * closed for it to be read, see hub_bus_pipeline_close(), and opened again.
+ *
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
+ * @param: p_buffer is the buffer to be filled with the payload
+ * @param: data_size is the size of the payload
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_recv_data_segments(struct hub_gard_bus *p_bus,
+								  int                  bus_hdl,
+								  uint8_t             *p_buffer,
+								  uint32_t             data_size)
+{
+	ssize_t                     nread;
+	uint32_t                    bytes_done = 0;
+	struct _data_segment_header seg_hdr;
+
+	while (bytes_done < data_size) {
+		nread = p_bus->fops.device_read(bus_hdl, &seg_hdr, sizeof(seg_hdr));
+		if (sizeof(seg_hdr) != nread) {
+			hub_pr_err("Error getting recv_data segment header\n");
+			return -1;
+		}
+
+		if ((DATA_SEGMENT_MARKER != seg_hdr.segment_marker) ||
+			(seg_hdr.segment_size > (data_size - bytes_done))) {
+			hub_pr_err("Error in recv_data segment header\n");
+			return -1;
+		}
+
+		/* A tagged response is next, let its command read it */
+		if (0 == seg_hdr.segment_size) {
+			hub_bus_pipeline_close(p_bus);
+			hub_bus_pipeline_open(p_bus);
+			continue;
+		}
+
+		nread = p_bus->fops.device_read(bus_hdl, p_buffer + bytes_done,
+										seg_hdr.segment_size);
+		if (seg_hdr.segment_size != nread) {
+			hub_pr_err("Error getting recv_data segment\n");
+			return -1;
+		}
+
+		bytes_done += seg_hdr.segment_size;
 	}
 
-	/* Bus response collect */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response
-			.start_of_data_marker,
-		sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .start_of_data_marker));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .start_of_data_marker) != nread) {
-		hub_pr_err("Error getting recv_data response sod\n");
-		goto err_recv_data_2;
+	return 0;
+}
+
+/**
+ * Run one RECV_DATA_FROM_GARD_AT_OFFSET exchange on a locked I2C / UART
+ * bus. With cmd_pipelining, tagged commands sent meanwhile on the bus are
+ * answered before this returns, see hub_bus_pipeline_open().
+ *
+ * @param: p_bus is the data bus
+ * @param: bus_hdl is the handle of p_bus, open
+ * @param: p_buffer is the buffer to be filled on successful read
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_recv_data_chunk(struct hub_gard_bus  *p_bus,
+							   int                   bus_hdl,
+							   void                 *p_buffer,
+							   uint32_t              addr,
+							   uint32_t              count)
+{
+	ssize_t                nread, nwrite;
+	uint32_t               data_size          = 0;
+	struct iovec           iov[2];
+	int                    iovcnt;
+	struct _host_requests  recv_data_cmd      = {0};
+	struct _host_responses recv_data_response = {0};
+	enum control_codes     cc;
+
+	recv_data_cmd.command_id = RECV_DATA_FROM_GARD_AT_OFFSET;
+	cc                       = 0;
+	if (p_bus->data_crc) {
+		cc |= CC_CHECKSUM_PRESENT;
+	}
+	if (p_bus->recv_segments) {
+		cc |= CC_SEGMENTED;
 	}
 
-	/* Read data_size from response */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response
-			.data_size,
+	recv_data_cmd.recv_data_from_gard_at_offset_request.offset_address = addr;
+	recv_data_cmd.recv_data_from_gard_at_offset_request.data_size      = count;
+	recv_data_cmd.recv_data_from_gard_at_offset_request.control_code   = cc;
+	recv_data_cmd.recv_data_from_gard_at_offset_request.mtu_size       = 0;
+
+	/* We now assume that the bus is open! */
+	iov[0].iov_base = &recv_data_cmd.command_id;
+	iov[0].iov_len  = sizeof(recv_data_cmd.command_id);
+	iov[1].iov_base = &recv_data_cmd.command_body;
+	iov[1].iov_len =
+		sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request);
+
+	nwrite = p_bus->fops.device_writev(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
+		hub_pr_err("Error sending recv_data request\n");
+		return -1;
+	}
+
+	/* Register accesses may go out as tagged commands until it is all in */
+	hub_bus_pipeline_open(p_bus);
+
+	/* Bus response collect: sod and data_size come together */
+	iov[0].iov_base = &recv_data_response.recv_data_from_gard_at_offset_response
+						   .start_of_data_marker;
+	iov[0].iov_len =
 		sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .data_size));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .data_size) != nread) {
-		hub_pr_err("Error getting recv_data response data_size\n");
-		goto err_recv_data_2;
+				   .start_of_data_marker);
+	iov[1].iov_base =
+		&recv_data_response.recv_data_from_gard_at_offset_response.data_size;
+	iov[1].iov_len = sizeof(
+		recv_data_response.recv_data_from_gard_at_offset_response.data_size);
+
+	nread = p_bus->fops.device_readv(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nread) {
+		hub_pr_err("Error getting recv_data response header\n");
+		goto err_recv_data_chunk_1;
 	}
 
 	data_size =
 		recv_data_response.recv_data_from_gard_at_offset_response.data_size;
-
-	nread = gard->data_bus->fops.device_read(bus_hdl, p_buffer, data_size);
-	if (data_size != nread) {
-		hub_pr_err("Error getting recv_data buffer\n");
-		goto err_recv_data_2;
+	if (data_size > count) {
+		hub_pr_err("recv_data response of %u bytes for %u requested\n",
+				   data_size, count);
+		goto err_recv_data_chunk_1;
 	}
 
 	/**
 	 * Note: HUB reads a "truncated" packet (not the full eod) as
 	 * part of send_data since that is what GARD FW expects
 	 * when CRC is not enabled.
+	 *
+	 * The data and the eod marker are read in one bus transaction, unless
+	 * the data comes in segments.
 	 */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response.eod
-			.end_of_data_marker,
+	iovcnt = 0;
+	if (cc & CC_SEGMENTED) {
+		if (0 != hub_recv_data_segments(p_bus, bus_hdl, p_buffer, data_size)) {
+			goto err_recv_data_chunk_1;
+		}
+	} else {
+		iov[iovcnt].iov_base  = p_buffer;
+		iov[iovcnt++].iov_len = data_size;
+	}
+	iov[iovcnt].iov_base =
+		&recv_data_response.recv_data_from_gard_at_offset_response.eod
+			 .end_of_data_marker;
+	iov[iovcnt].iov_len =
 		sizeof(recv_data_response.recv_data_from_gard_at_offset_response.eod
-				   .end_of_data_marker));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response.eod
-				   .end_of_data_marker) != nread) {
-		hub_pr_err("Error getting recv_data response eod\n");
-		goto err_recv_data_2;
+				   .end_of_data_marker);
+	if (cc & CC_CHECKSUM_PRESENT) {
+		iov[iovcnt].iov_len +=
+			sizeof(recv_data_response.recv_data_from_gard_at_offset_response
+					   .eod.opt_crc);
 	}
+	iovcnt++;
 
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	nread = p_bus->fops.device_readv(bus_hdl, iov, iovcnt);
+	if (hub_iov_len(iov, iovcnt) != nread) {
+		hub_pr_err("Error getting recv_data buffer\n");
+		goto err_recv_data_chunk_1;
+	}
 
 	if ((START_OF_DATA_MARKER !=
 		 recv_data_response.recv_data_from_gard_at_offset_response
@@ -295,30 +728,120 @@ enum hub_ret_code hub_recv_data_from_gard(gard_handle_t p_gard_handle,
 		 recv_data_response.recv_data_from_gard_at_offset_response.eod
 			 .end_of_data_marker)) {
 		hub_pr_err("Error in recv_data markers\n");
-		goto err_recv_data_2;
+		goto err_recv_data_chunk_1;
 	}
 
+	if ((cc & CC_CHECKSUM_PRESENT) &&
+		(hub_crc32(0, p_buffer, data_size) !=
+		 recv_data_response.recv_data_from_gard_at_offset_response.eod
+			 .opt_crc)) {
+		hub_pr_err("CRC mismatch in recv_data of %u bytes\n", data_size);
+		goto err_recv_data_chunk_1;
+	}
+
+	hub_bus_pipeline_close(p_bus);
+
+	return 0;
+
+err_recv_data_chunk_1:
+	hub_bus_pipeline_close(p_bus);
+	return -1;
+}
+
+/**
+ * Receive data from GARD on one of its I2C / UART / USB buses, see
+ * hub_recv_data_from_gard(). I2C / UART data blobs come in this way too, see
+ * hub_read_data_blob_from_gard().
+ *
+ * @param: gard is the GARD to receive data from
+ * @param: p_bus is the data bus or the fallback data bus of the GARD
+ * @param: p_buffer is the buffer to be filled on successful read
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_RECV_DATA on failure
+ */
+enum hub_ret_code hub_recv_data_on_bus(struct hub_gard_info *gard,
+									   struct hub_gard_bus  *p_bus,
+									   void                 *p_buffer,
+									   uint32_t              addr,
+									   uint32_t              count)
+{
+	int                     bus_hdl;
+	enum hub_gard_bus_types bus_type;
+	uint32_t                offset, chunk_size;
+
+	bus_type = p_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = p_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = p_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		return hub_read_data_blob_from_gard((gard_handle_t)gard, p_buffer, addr,
+											count);
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for recv_data!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_recv_data_1;
+	}
+
+	/* Lock the data bus mutex before bus operations */
+	hub_mutex_lock(&p_bus->bus_mutex);
+
+	offset = 0;
+	do {
+		chunk_size = count - offset;
+		if (p_bus->xfer_chunk_size) {
+			chunk_size = hub_min_uint32(chunk_size, p_bus->xfer_chunk_size);
+		}
+
+		if (offset) {
+			hub_bus_yield(p_bus);
+		}
+
+		if (hub_recv_data_chunk(p_bus, bus_hdl, (uint8_t *)p_buffer + offset,
+								addr + offset, chunk_size)) {
+			goto err_recv_data_2;
+		}
+
+		offset += chunk_size;
+	} while (offset < count);
+
+	hub_mutex_unlock(&p_bus->bus_mutex);
+
 	hub_pr_dbg("SUCCESS!\n");
 
 	return HUB_SUCCESS;
 
 err_recv_data_2:
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_mutex_unlock(&p_bus->bus_mutex);
 err_recv_data_1:
 	return HUB_FAILURE_RECV_DATA;
 }
 
 /**
+ * Receive data of specified size from an address in the
+ * GARD memory map represented	by the GARD handle, into a HUB
+ * data buffer.
  *
- * TBD-DPN: Temporary function for getting app_data from GARD FW
- * We will revisit this approach and explore if recv_* functions
- * can be merged into a single function.
+ * If the data bus has an "xfer_chunk_size", the data comes in commands of
+ * at most that size, and register accesses and commands waiting for the
+ * same bus get it between two chunks.
  *
- * Receive data of specified size in the GARD memory map
- * represented by the GARD handle, into a HUB data buffer.
+ * If the transfer fails on the data bus, it is run again on the fallback
+ * data bus of the GARD, see hub_gard_data_failover().
  *
- * Note that the addr variable here is ignored by GARD_FW.
- * It has APP_DATA control code set to receive application data.
+ * Note: If this function is called to receive image data from GARD,
+ * say, after hub_capture_rescaled_image_from_gard() is called, then
+ * HUB / Host Applicaiton should also call hub_send_resume_pipeline() after
+ * receiving the image content to signal GARD FW to resume the paused AI
+ * workload.
  *
  * @param: p_gard_handle is the GARD handle for preforming the read blob
  * @param: p_buffer is the buffer to be filled on successful read
@@ -327,18 +850,65 @@ err_recv_data_1:
  *
  * @return: hub_ret_code
  * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_RECV_DATA on failure
+ */
+enum hub_ret_code hub_recv_data_from_gard(gard_handle_t p_gard_handle,
+										  void         *p_buffer,
+										  uint32_t      addr,
+										  uint32_t      count)
+{
+	enum hub_ret_code     ret;
+	struct hub_gard_bus  *p_bus;
+	uint64_t              start_ns;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	start_ns                   = hub_stats_now_ns();
+
+	p_bus                      = hub_gard_data_route(gard);
+	ret = hub_recv_data_on_bus(gard, p_bus, p_buffer, addr, count);
+	if (hub_gard_data_failover(gard, p_bus, ret)) {
+		ret = hub_recv_data_on_bus(gard, gard->fallback_data_bus, p_buffer,
+								   addr, count);
+	}
+
+	hub_stats_record(gard, HUB_STATS_OP_RECV_DATA, start_ns,
+					 (HUB_SUCCESS == ret) ? count : 0, HUB_SUCCESS != ret);
+
+	return ret;
+}
+
+/**
+ *
+ * TBD-DPN: Temporary function for getting app_data from GARD FW
+ * We will revisit this approach and explore if recv_* functions
+ * can be merged into a single function.
+ *
+ * Receive app data of at most count bytes from GARD FW, with CC_APP_DATA
+ * and the control codes in extra_cc set.
+ *
+ * @param: p_gard_handle is the GARD handle for preforming the read blob
+ * @param: p_buffer is the buffer to be filled on successful read
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ * @param: extra_cc are control codes added to CC_APP_DATA
+ *
+ * @return: data_size (>= 0) on success
  * 		HUB_FAILURE_RECV_APP_DATA on failure
  */
-int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
-									void         *p_buffer,
-									uint32_t      addr,
-									uint32_t      count)
+static int64_t hub_recv_app_data(gard_handle_t p_gard_handle,
+								 void         *p_buffer,
+								 uint32_t      addr,
+								 uint32_t      count,
+								 uint32_t      extra_cc)
 {
 	enum hub_ret_code       ret;
 	int                     bus_hdl;
 	ssize_t                 nread, nwrite;
 	enum hub_gard_bus_types bus_type;
 	uint32_t                data_size = 0;
+	uint64_t                start_ns;
+	struct iovec            iov[2];
 
 	struct hub_gard_info   *gard      = (struct hub_gard_info *)p_gard_handle;
 
@@ -346,28 +916,40 @@ int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
 	struct _host_responses  recv_data_response = {0};
 	enum control_codes      cc;
 
+	start_ns                  = hub_stats_now_ns();
+
 	recv_data_cmd.command_id  = RECV_DATA_FROM_GARD_AT_OFFSET;
 	cc                        = 0;
 
 	/* We set CC_APP_DATA flag to receive app data from unspecified address */
-	cc                       |= CC_APP_DATA;
+	cc                       |= CC_APP_DATA | extra_cc;
+	if (gard->cmd_bus->data_crc) {
+		cc |= CC_CHECKSUM_PRESENT;
+	}
 
 	recv_data_cmd.recv_data_from_gard_at_offset_request.offset_address = addr;
 	recv_data_cmd.recv_data_from_gard_at_offset_request.data_size      = count;
 	recv_data_cmd.recv_data_from_gard_at_offset_request.control_code   = cc;
 	recv_data_cmd.recv_data_from_gard_at_offset_request.mtu_size       = 0;
 
-	bus_type = gard->data_bus->types;
+	bus_type = gard->cmd_bus->types;
 	switch (bus_type) {
 	case HUB_GARD_BUS_I2C:
-		bus_hdl = gard->data_bus->i2c.bus_hdl;
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
 		break;
 	case HUB_GARD_BUS_UART:
-		bus_hdl = gard->data_bus->uart.bus_hdl;
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
 		break;
 	case HUB_GARD_BUS_USB:
+		if (extra_cc) {
+			hub_pr_err("USB: app data control codes 0x%x not supported\n",
+					   extra_cc);
+			goto err_recv_app_data_1;
+		}
 		ret =
 			hub_read_data_blob_from_gard(p_gard_handle, p_buffer, addr, count);
+		hub_stats_record(gard, HUB_STATS_OP_RECV_APP_DATA, start_ns, count,
+						 HUB_SUCCESS != ret);
 		/* For USB, return count on success, error code on failure */
 		return (ret == HUB_SUCCESS) ? (int64_t)count : (int64_t)ret;
 		break;
@@ -378,77 +960,68 @@ int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
 	}
 
 	/* Lock the data bus mutex before bus operations */
-	hub_mutex_lock(&gard->data_bus->bus_mutex);
+	hub_mutex_lock(&gard->cmd_bus->bus_mutex);
 
 	/* We now assume that the bus is open! */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &recv_data_cmd.command_id, sizeof(recv_data_cmd.command_id));
-	if (sizeof(recv_data_cmd.command_id) != nwrite) {
-		hub_pr_err("Error sending recv_data cmd\n");
-		goto err_recv_app_data_2;
-	}
+	iov[0].iov_base = &recv_data_cmd.command_id;
+	iov[0].iov_len  = sizeof(recv_data_cmd.command_id);
+	iov[1].iov_base = &recv_data_cmd.command_body;
+	iov[1].iov_len =
+		sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request);
 
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &recv_data_cmd.command_body,
-		sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request));
-	if (sizeof(recv_data_cmd.recv_data_from_gard_at_offset_request) != nwrite) {
+	nwrite = gard->cmd_bus->fops.device_writev(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
 		hub_pr_err("Error sending recv_data request\n");
 		goto err_recv_app_data_2;
 	}
 
-	/* Bus response collect */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response
-			.start_of_data_marker,
+	/* Bus response collect: sod and data_size come together */
+	iov[0].iov_base = &recv_data_response.recv_data_from_gard_at_offset_response
+						   .start_of_data_marker;
+	iov[0].iov_len =
 		sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .start_of_data_marker));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .start_of_data_marker) != nread) {
-		hub_pr_err("Error getting recv_data response sod\n");
-		goto err_recv_app_data_2;
-	}
+				   .start_of_data_marker);
+	iov[1].iov_base =
+		&recv_data_response.recv_data_from_gard_at_offset_response.data_size;
+	iov[1].iov_len = sizeof(
+		recv_data_response.recv_data_from_gard_at_offset_response.data_size);
 
-	/* Read data_size from response */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response
-			.data_size,
-		sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .data_size));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response
-				   .data_size) != nread) {
-		hub_pr_err("Error getting recv_data response data_size\n");
+	nread = gard->cmd_bus->fops.device_readv(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nread) {
+		hub_pr_err("Error getting recv_data response header\n");
 		goto err_recv_app_data_2;
 	}
 
 	data_size =
 		recv_data_response.recv_data_from_gard_at_offset_response.data_size;
 
-	nread = gard->data_bus->fops.device_read(bus_hdl, p_buffer, data_size);
-	if (0 == nread) {
-		hub_pr_err("Error getting recv_data buffer\n");
-		goto err_recv_app_data_2;
-	}
-
 	/**
 	 * Note: HUB reads a "truncated" packet (not the full eod) as
 	 * part of send_data since that is what GARD FW expects
 	 * when CRC is not enabled.
+	 *
+	 * The data and the eod marker are read in one bus transaction.
 	 */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl,
-		(void *)&recv_data_response.recv_data_from_gard_at_offset_response.eod
-			.end_of_data_marker,
+	iov[0].iov_base = p_buffer;
+	iov[0].iov_len  = data_size;
+	iov[1].iov_base = &recv_data_response.recv_data_from_gard_at_offset_response
+						   .eod.end_of_data_marker;
+	iov[1].iov_len =
 		sizeof(recv_data_response.recv_data_from_gard_at_offset_response.eod
-				   .end_of_data_marker));
-	if (sizeof(recv_data_response.recv_data_from_gard_at_offset_response.eod
-				   .end_of_data_marker) != nread) {
-		hub_pr_err("Error getting recv_data response eod\n");
+				   .end_of_data_marker);
+	if (cc & CC_CHECKSUM_PRESENT) {
+		iov[1].iov_len +=
+			sizeof(recv_data_response.recv_data_from_gard_at_offset_response
+					   .eod.opt_crc);
+	}
+
+	nread = gard->cmd_bus->fops.device_readv(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nread) {
+		hub_pr_err("Error getting recv_data buffer\n");
 		goto err_recv_app_data_2;
 	}
 
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_mutex_unlock(&gard->cmd_bus->bus_mutex);
 
 	if ((START_OF_DATA_MARKER !=
 		 recv_data_response.recv_data_from_gard_at_offset_response
@@ -457,16 +1030,301 @@ int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
 		 recv_data_response.recv_data_from_gard_at_offset_response.eod
 			 .end_of_data_marker)) {
 		hub_pr_err("Error in recv_data markers\n");
-		goto err_recv_app_data_2;
+		goto err_recv_app_data_1;
+	}
+
+	if ((cc & CC_CHECKSUM_PRESENT) &&
+		(hub_crc32(0, p_buffer, data_size) !=
+		 recv_data_response.recv_data_from_gard_at_offset_response.eod
+			 .opt_crc)) {
+		hub_pr_err("CRC mismatch in recv app data of %u bytes\n", data_size);
+		goto err_recv_app_data_1;
 	}
 
+	hub_stats_record(gard, HUB_STATS_OP_RECV_APP_DATA, start_ns, data_size,
+					 false);
+
 	hub_pr_dbg("SUCCESS!\n");
 
 	return (int64_t)data_size;
 
 err_recv_app_data_2:
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_mutex_unlock(&gard->cmd_bus->bus_mutex);
 err_recv_app_data_1:
+	hub_stats_record(gard, HUB_STATS_OP_RECV_APP_DATA, start_ns, 0, true);
 	return (int64_t)HUB_FAILURE_RECV_APP_DATA;
 }
 
+/**
+ * Receive data of specified size in the GARD memory map
+ * represented by the GARD handle, into a HUB data buffer.
+ *
+ * Note that the addr variable here is ignored by GARD_FW.
+ * It has APP_DATA control code set to receive application data.
+ *
+ * @param: p_gard_handle is the GARD handle for preforming the read blob
+ * @param: p_buffer is the buffer to be filled on successful read
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ *
+ * @return: data_size (> 0) on success
+ * 		error code (<= 0) on failure (HUB_FAILURE_RECV_APP_DATA)
+ */
+int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
+									void         *p_buffer,
+									uint32_t      addr,
+									uint32_t      count)
+{
+	return hub_recv_app_data(p_gard_handle, p_buffer, addr, count, 0);
+}
+
+/**
+ * Receive all App Module results queued in GARD FW that fit in count bytes,
+ * in one command with CC_APP_DATA_BATCH. p_buffer is filled with records of
+ * a uint32_t size followed by that many bytes of a result.
+ *
+ * Only for I2C and UART busses, see app_data_batch in host_config.json.
+ *
+ * @param: p_gard_handle is the GARD handle for preforming the read blob
+ * @param: p_buffer is the buffer to be filled on successful read
+ * @param: count is the size of p_buffer
+ *
+ * @return: size of the records (>= 0, 0 with no result queued) on success
+ * 		HUB_FAILURE_RECV_APP_DATA on failure
+ */
+int64_t hub_recv_app_data_batch_from_gard(gard_handle_t p_gard_handle,
+										  void         *p_buffer,
+										  uint32_t      count)
+{
+	return hub_recv_app_data(p_gard_handle, p_buffer, 0xDEADBEEF, count,
+							 CC_APP_DATA_BATCH);
+}
+
+
+/**
+ * Queue a send of a data buffer of a specified size from HUB to an
+ * address in the GARD memory map represented by the gard handle.
+ *
+ * @param: p_gard_handle is the GARD handle to use for sending data to
+ * @param: p_buffer is a buffer containing data to write
+ * @param: addr is an address in GARD's memory map to write to
+ * @param: count is the number of bytes to write
+ * @param: cb_handler is called once the data is sent
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ *
+ * @return: hub_ret_code return code indicating success/failure
+ * 		 HUB_SUCCESS for successful submission
+ * 		 HUB_FAILURE_SEND_DATA for failure
+ */
+enum hub_ret_code hub_send_data_to_gard_async(gard_handle_t      p_gard_handle,
+											  const void        *p_buffer,
+											  uint32_t           addr,
+											  uint32_t           count,
+											  hub_xfer_done_cb_t cb_handler,
+											  void              *p_cb_ctx)
+{
+	return hub_write_data_blob_to_gard_async(p_gard_handle, p_buffer, addr,
+											 count, cb_handler, p_cb_ctx);
+}
+
+/**
+ * Queue a receive of data of a specified size from an address in the
+ * GARD memory map represented by the gard handle, into a HUB data buffer.
+ *
+ * @param: p_gard_handle is the GARD handle to receive data from
+ * @param: p_buffer is a buffer to be filled with the data
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ * @param: cb_handler is called once the buffer is filled
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ *
+ * @return: hub_ret_code return code indicating success/failure
+ * 		 HUB_SUCCESS for successful submission
+ * 		 HUB_FAILURE_RECV_DATA for failure
+ */
+enum hub_ret_code hub_recv_data_from_gard_async(gard_handle_t      p_gard_handle,
+												void              *p_buffer,
+												uint32_t           addr,
+												uint32_t           count,
+												hub_xfer_done_cb_t cb_handler,
+												void              *p_cb_ctx)
+{
+	return hub_read_data_blob_from_gard_async(p_gard_handle, p_buffer, addr,
+											  count, cb_handler, p_cb_ctx);
+}
+
+/**
+ * Completion callback of the asynchronous receive of a chunk of
+ * hub_recv_data_from_gard_progressive(), wakes up its caller.
+ *
+ * @param: p_cb_ctx is the struct hub_recv_chunk of the chunk
+ * @param: ret is the result of the receive
+ *
+ * @return: None
+ */
+static void hub_recv_chunk_done(void *p_cb_ctx, enum hub_ret_code ret)
+{
+	struct hub_recv_chunk *p_chunk = (struct hub_recv_chunk *)p_cb_ctx;
+
+	hub_mutex_lock(&p_chunk->p_recv->lock);
+	p_chunk->ret     = ret;
+	p_chunk->is_done = true;
+	hub_cond_var_broadcast(&p_chunk->p_recv->done_cond_var);
+	hub_mutex_unlock(&p_chunk->p_recv->lock);
+}
+
+/**
+ * Wait for the asynchronous receive of a chunk to complete.
+ *
+ * @param: p_recv is the progressive receive of the chunk
+ * @param: p_chunk is the chunk to wait for
+ *
+ * @return: the result of the receive
+ */
+static enum hub_ret_code
+	hub_wait_for_recv_chunk(struct hub_recv_progressive *p_recv,
+							struct hub_recv_chunk       *p_chunk)
+{
+	enum hub_ret_code ret;
+
+	hub_mutex_lock(&p_recv->lock);
+	while (!p_chunk->is_done) {
+		hub_cond_var_wait(&p_recv->done_cond_var, &p_recv->lock);
+	}
+	ret = p_chunk->ret;
+	hub_mutex_unlock(&p_recv->lock);
+
+	return ret;
+}
+
+/**
+ * Receive data from an address in the GARD memory map into a HUB data buffer
+ * in chunks, and hand each chunk to the caller as soon as it is received.
+ *
+ * Up to HUB_RECV_PROGRESSIVE_DEPTH chunks are queued as asynchronous
+ * receives, so that the next chunks are transferred while cb_handler works
+ * on the current one. cb_handler is called from the calling thread, once per
+ * chunk, in order. A chunk whose asynchronous receive fails is received again
+ * with hub_recv_data_from_gard(), on the fallback data bus if need be.
+ *
+ * @param: p_gard_handle is the GARD handle to receive data from
+ * @param: p_buffer is the buffer to be filled with the data
+ * @param: addr is an address in GARD's memory map to read from
+ * @param: count is the number of bytes to read
+ * @param: chunk_size is the size of the chunks, 0 for
+ * 		HUB_RECV_PROGRESSIVE_CHUNK_SIZE
+ * @param: cb_handler is called with the offset and length in p_buffer of
+ * 		each chunk received
+ * @param: p_cb_ctx is an opaque context passed to cb_handler
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_RECV_DATA on failure
+ */
+enum hub_ret_code
+	hub_recv_data_from_gard_progressive(gard_handle_t       p_gard_handle,
+										void               *p_buffer,
+										uint32_t            addr,
+										uint32_t            count,
+										uint32_t            chunk_size,
+										hub_recv_chunk_cb_t cb_handler,
+										void               *p_cb_ctx)
+{
+	enum hub_ret_code           ret = HUB_FAILURE_RECV_DATA;
+	struct hub_recv_progressive recv;
+	struct hub_recv_chunk      *p_chunks;
+	uint32_t                    num_chunks, num_queued, idx;
+	uint32_t                    offset, length;
+	uint64_t                    start_ns;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_buffer) ||
+		(NULL == cb_handler) || (0 == count)) {
+		hub_pr_err("Error: invalid progressive recv_data arguments\n");
+		goto err_recv_progressive_1;
+	}
+
+	start_ns = hub_stats_now_ns();
+
+	if (0 == chunk_size) {
+		chunk_size = HUB_RECV_PROGRESSIVE_CHUNK_SIZE;
+	}
+	num_chunks = (uint32_t)(((uint64_t)count + chunk_size - 1) / chunk_size);
+
+	p_chunks = calloc(num_chunks, sizeof(struct hub_recv_chunk));
+	if (NULL == p_chunks) {
+		hub_pr_err("Error allocating progressive recv_data chunks\n");
+		goto err_recv_progressive_1;
+	}
+
+	hub_mutex_init(&recv.lock);
+	hub_cond_var_init(&recv.done_cond_var);
+
+	num_queued = 0;
+	for (idx = 0; idx < num_chunks; idx++) {
+		/* Keep the next chunks coming while this one is handed over */
+		while ((num_queued < num_chunks) &&
+			   (num_queued < idx + HUB_RECV_PROGRESSIVE_DEPTH)) {
+			offset = num_queued * chunk_size;
+			length = hub_min_uint32(count - offset, chunk_size);
+			p_chunks[num_queued].p_recv = &recv;
+			if (HUB_SUCCESS !=
+				hub_recv_data_from_gard_async(
+					p_gard_handle, (uint8_t *)p_buffer + offset,
+					addr + offset, length, hub_recv_chunk_done,
+					&p_chunks[num_queued])) {
+				/* Received synchronously below */
+				p_chunks[num_queued].ret     = HUB_FAILURE_RECV_DATA;
+				p_chunks[num_queued].is_done = true;
+			}
+			num_queued++;
+		}
+
+		offset = idx * chunk_size;
+		length = hub_min_uint32(count - offset, chunk_size);
+		if ((HUB_SUCCESS != hub_wait_for_recv_chunk(&recv, &p_chunks[idx])) &&
+			(HUB_SUCCESS !=
+			 hub_recv_data_from_gard(p_gard_handle,
+									 (uint8_t *)p_buffer + offset,
+									 addr + offset, length))) {
+			hub_pr_err("Error receiving %u bytes @ 0x%x\n", length,
+					   addr + offset);
+			goto err_recv_progressive_2;
+		}
+
+		cb_handler(p_cb_ctx, offset, length);
+	}
+
+	ret = HUB_SUCCESS;
+
+err_recv_progressive_2:
+	/* The queued chunks still write to p_buffer and p_chunks */
+	for (idx++; idx < num_queued; idx++) {
+		(void)hub_wait_for_recv_chunk(&recv, &p_chunks[idx]);
+	}
+	hub_cond_var_destroy(&recv.done_cond_var);
+	hub_mutex_destroy(&recv.lock);
+	free(p_chunks);
+
+	hub_stats_record(gard, HUB_STATS_OP_RECV_DATA, start_ns,
+					 (HUB_SUCCESS == ret) ? count : 0, HUB_SUCCESS != ret);
+err_recv_progressive_1:
+	return ret;
+}
+
+/**
+ * Wait until all asynchronous transfers queued on the data bus of the GARD
+ * represented by the gard handle have completed.
+ *
+ * @param: p_gard_handle is the GARD handle to wait on
+ *
+ * @return: hub_ret_code
+ * 		 HUB_SUCCESS on success
+ * 		 HUB_FAILURE_ASYNC_XFER on failure
+ */
+enum hub_ret_code hub_wait_for_async_xfers(gard_handle_t p_gard_handle)
+{
+	return hub_wait_for_data_blob_xfers(p_gard_handle);
+}
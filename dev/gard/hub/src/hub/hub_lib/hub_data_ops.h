@@ -12,6 +12,7 @@
 #include "gard_info.h"
 #include "gard_hub_iface.h"
 #include "hub_globals.h"
+#include "hub_stats.h"
 
 /**
  * Send a data buffer of a specified size from HUB to an
@@ -56,4 +57,32 @@ int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
 									 uint32_t      addr,
 									 uint32_t      count);
 
+/**
+ * Receive all App Module results queued in GARD FW that fit in a HUB data
+ * buffer, each as a uint32_t size followed by the result.
+ */
+int64_t hub_recv_app_data_batch_from_gard(gard_handle_t p_gard_handle,
+										  void         *p_buffer,
+										  uint32_t      count);
+
+/**
+ * Send a data buffer to GARD on the given bus of it, with the chunking and
+ * packets set for that bus, without failing over to another bus.
+ */
+enum hub_ret_code hub_send_data_on_bus(struct hub_gard_info *gard,
+									   struct hub_gard_bus  *p_bus,
+									   const void           *p_buffer,
+									   uint32_t              addr,
+									   uint32_t              count);
+
+/**
+ * Receive data from GARD on the given bus of it, with the chunking set for
+ * that bus, without failing over to another bus.
+ */
+enum hub_ret_code hub_recv_data_on_bus(struct hub_gard_info *gard,
+									   struct hub_gard_bus  *p_bus,
+									   void                 *p_buffer,
+									   uint32_t              addr,
+									   uint32_t              count);
+
 #endif /* __HUB_REG_OPS_H__ */
\ No newline at end of file
@@ -5,7 +5,65 @@
  *
  ******************************************************************************/
 
+#include <unistd.h>
+
 #include "hub_gard_cmds.h"
+#include "hub_utils.h"
+#include "hub_stats.h"
+#include "hub_health.h"
+
+/* A short command cut short is sent again this often once resynchronized */
+#define HUB_GARD_CMD_RETRIES (1)
+
+/**
+ * Send a short command to the GARD and receive its response, with the bus
+ * locked for control.
+ *
+ * A transfer cut short leaves HUB and GARD out of step: the bus is then
+ * resynchronized, see hub_resync_gard_bus(), and a command that does the
+ * same when sent twice is sent again. The bus is closed if GARD cannot be
+ * resynchronized, as it used to be on any failure.
+ *
+ * @param: gard is the GARD
+ * @param: bus_hdl is the handle of its command bus
+ * @param: iov holds the command id and the request
+ * @param: iovcnt is the number of entries of iov
+ * @param: p_resp is filled with the response
+ * @param: resp_size is the size of the response
+ * @param: retries is how often the command may be sent again
+ *
+ * @return: true if the response has been received, false otherwise
+ */
+static bool hub_gard_cmd_xfer(struct hub_gard_info *gard,
+							  int                   bus_hdl,
+							  const struct iovec   *iov,
+							  int                   iovcnt,
+							  void                 *p_resp,
+							  size_t                resp_size,
+							  uint32_t              retries)
+{
+	ssize_t nread, nwrite;
+
+	for (;;) {
+		nwrite = gard->cmd_bus->fops.device_writev(bus_hdl, iov, iovcnt);
+		if (hub_iov_len(iov, iovcnt) == nwrite) {
+			nread = gard->cmd_bus->fops.device_read(bus_hdl, p_resp,
+													resp_size);
+			if ((ssize_t)resp_size == nread) {
+				return true;
+			}
+		}
+
+		if (HUB_SUCCESS != hub_resync_gard_bus(gard->cmd_bus, bus_hdl)) {
+			(void)gard->cmd_bus->fops.device_close(bus_hdl);
+			return false;
+		}
+
+		if (0 == retries--) {
+			return false;
+		}
+	}
+}
 
 /**
  * Send the resume pipeline command to the GARD
@@ -19,10 +77,9 @@
 enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 										   uint8_t       camera_id)
 {
-	enum hub_ret_code       ret;
 	int                     bus_hdl;
-	ssize_t                 nread, nwrite;
 	enum hub_gard_bus_types bus_type;
+	struct iovec            iov[2];
 
 	struct hub_gard_info   *gard = (struct hub_gard_info *)p_gard_handle;
 
@@ -43,13 +100,13 @@ enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 	/**
 	 * Send the resume pipeline command to the GARD
 	 */
-	bus_type = gard->data_bus->types;
+	bus_type = gard->cmd_bus->types;
 	switch (bus_type) {
 	case HUB_GARD_BUS_I2C:
-		bus_hdl = gard->data_bus->i2c.bus_hdl;
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
 		break;
 	case HUB_GARD_BUS_UART:
-		bus_hdl = gard->data_bus->uart.bus_hdl;
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
 		break;
 	case HUB_GARD_BUS_USB:
 		hub_pr_err("Bus not supported for resume_pipeline!\n");
@@ -61,39 +118,27 @@ enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 		goto err_send_resume_pipeline_1;
 	}
 
-	/* Lock the data bus mutex before bus operations */
-	hub_mutex_lock(&gard->data_bus->bus_mutex);
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
 
 	/* We now assume that the bus is open! */
 
-	/* Send the command to the GARD */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &resume_pipeline_cmd.command_id,
-		sizeof(resume_pipeline_cmd.command_id));
-	if (sizeof(resume_pipeline_cmd.command_id) != nwrite) {
-		hub_pr_err("Error sending resume_pipeline cmd\n");
-		goto err_send_resume_pipeline_2;
-	}
-
-	nread = gard->data_bus->fops.device_write(
-		bus_hdl, &resume_pipeline_cmd.command_body,
-		sizeof(resume_pipeline_cmd.resume_pipeline_request));
-	if (sizeof(resume_pipeline_cmd.resume_pipeline_request) != nread) {
-		hub_pr_err("Error sending resume_pipeline request\n");
-		goto err_send_resume_pipeline_2;
-	}
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &resume_pipeline_cmd.command_id;
+	iov[0].iov_len  = sizeof(resume_pipeline_cmd.command_id);
+	iov[1].iov_base = &resume_pipeline_cmd.command_body;
+	iov[1].iov_len  = sizeof(resume_pipeline_cmd.resume_pipeline_request);
 
-	/* Receive the response from the GARD */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl, &resume_pipeline_response.resume_pipeline_response,
-		sizeof(resume_pipeline_response.resume_pipeline_response));
-	if (sizeof(resume_pipeline_response.resume_pipeline_response) != nread) {
-		hub_pr_err("Error receiving resume_pipeline response\n");
+	if (!hub_gard_cmd_xfer(
+			gard, bus_hdl, iov, 2,
+			&resume_pipeline_response.resume_pipeline_response,
+			sizeof(resume_pipeline_response.resume_pipeline_response),
+			HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging resume_pipeline request\n");
 		goto err_send_resume_pipeline_2;
 	}
 
-	/* Unlock the data bus mutex after bus operations */
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_bus_unlock_ctrl(gard->cmd_bus);
 
 	if (ACK_BYTE !=
 		resume_pipeline_response.resume_pipeline_response.ack_or_nak) {
@@ -104,9 +149,1935 @@ enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 	return HUB_SUCCESS;
 
 err_send_resume_pipeline_2:
-	ret = gard->data_bus->fops.device_close(bus_hdl);
-	(void)ret;
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_bus_unlock_ctrl(gard->cmd_bus);
 err_send_resume_pipeline_1:
 	return HUB_FAILURE_SEND_RESUME_PIPELINE;
-}
\ No newline at end of file
+}
+
+/* Short names of the pipeline stages, see enum hub_pipeline_stage */
+static const char *hub_pipeline_stage_names[HUB_PIPELINE_STAGE_MAX] = {
+	[HUB_PIPELINE_STAGE_CAPTURE]         = "capture",
+	[HUB_PIPELINE_STAGE_RESCALE]         = "rescale",
+	[HUB_PIPELINE_STAGE_ML]              = "ml",
+	[HUB_PIPELINE_STAGE_POST_PROCESSING] = "post_processing",
+	[HUB_PIPELINE_STAGE_HOST_TX]         = "host_tx",
+	[HUB_PIPELINE_STAGE_FRAME]           = "frame",
+};
+
+_Static_assert((int)HUB_PIPELINE_STAGE_MAX == (int)PIPELINE_STATS__NUM_STAGES,
+			   "enum hub_pipeline_stage is out of sync with the interface");
+
+/**
+ * hub_pipeline_stage_name gives a short name of a pipeline stage.
+ *
+ * @param: stage is the pipeline stage
+ *
+ * @return: name of the stage, NULL if stage is invalid
+ */
+const char *hub_pipeline_stage_name(enum hub_pipeline_stage stage)
+{
+	if ((stage < 0) || (stage >= HUB_PIPELINE_STAGE_MAX)) {
+		return NULL;
+	}
+
+	return hub_pipeline_stage_names[stage];
+}
+
+/**
+ * Convert a number of GARD CPU cycles to nanoseconds.
+ *
+ * @param: cycles is the number of cycles
+ * @param: cycles_per_us is the GARD CPU clock
+ *
+ * @return: the time in nanoseconds
+ */
+static uint64_t hub_gard_cycles_to_ns(uint64_t cycles, uint32_t cycles_per_us)
+{
+	return (cycles / cycles_per_us) * 1000 +
+		   ((cycles % cycles_per_us) * 1000) / cycles_per_us;
+}
+
+/**
+ * Read the pipeline timing statistics of the GARD with GET_PIPELINE_STATS.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: reset is 1 to have GARD clear the statistics once sent
+ * @param: p_stats is filled with the statistics, in nanoseconds
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_PIPELINE_STATS if failed
+ */
+enum hub_ret_code
+	hub_get_pipeline_stats(gard_handle_t              p_gard_handle,
+						   uint8_t                    reset,
+						   struct hub_pipeline_stats *p_stats)
+{
+	int                                  bus_hdl;
+	enum hub_gard_bus_types              bus_type;
+	struct iovec                         iov[2];
+	struct _get_pipeline_stats_response *p_resp;
+	struct _pipeline_stage_stats        *p_stage;
+	struct hub_pipeline_stage_stats     *p_out;
+	uint32_t                             stage, cycles_per_us;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  stats_cmd      = {0};
+	struct _host_responses stats_response = {0};
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_stats)) {
+		hub_pr_err("Error: p_gard_handle or p_stats is NULL\n");
+		goto err_get_pipeline_stats_1;
+	}
+
+	stats_cmd.command_id                       = GET_PIPELINE_STATS;
+	stats_cmd.get_pipeline_stats_request.reset = reset ? 1 : 0;
+	stats_cmd.get_pipeline_stats_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for get_pipeline_stats!\n");
+		goto err_get_pipeline_stats_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for get_pipeline_stats!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_get_pipeline_stats_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &stats_cmd.command_id;
+	iov[0].iov_len  = sizeof(stats_cmd.command_id);
+	iov[1].iov_base = &stats_cmd.command_body;
+	iov[1].iov_len  = sizeof(stats_cmd.get_pipeline_stats_request);
+
+	/* Statistics already cleared are not asked for again */
+	p_resp = &stats_response.get_pipeline_stats_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   reset ? 0 : HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging get_pipeline_stats request\n");
+		goto err_get_pipeline_stats_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->eod.end_of_data_marker) ||
+		(PIPELINE_STATS__NUM_STAGES != p_resp->num_stages) ||
+		(0 == p_resp->cycles_per_us)) {
+		hub_pr_err("Error in get_pipeline_stats response\n");
+		goto err_get_pipeline_stats_1;
+	}
+
+	cycles_per_us          = p_resp->cycles_per_us;
+	p_stats->cycles_per_us = cycles_per_us;
+	for (stage = 0; stage < HUB_PIPELINE_STAGE_MAX; stage++) {
+		p_stage = &p_resp->stages[stage];
+		p_out   = &p_stats->stages[stage];
+
+		p_out->count  = p_stage->count;
+		p_out->min_ns = hub_gard_cycles_to_ns(p_stage->min_cycles,
+											  cycles_per_us);
+		p_out->max_ns = hub_gard_cycles_to_ns(p_stage->max_cycles,
+											  cycles_per_us);
+		p_out->avg_ns = 0;
+		if (p_stage->count) {
+			p_out->avg_ns = hub_gard_cycles_to_ns(
+				p_stage->total_cycles / p_stage->count, cycles_per_us);
+		}
+	}
+
+	return HUB_SUCCESS;
+
+err_get_pipeline_stats_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_get_pipeline_stats_1:
+	return HUB_FAILURE_PIPELINE_STATS;
+}
+
+_Static_assert(HUB_NETWORK_RESIDENCY_MAX_NETWORKS ==
+				   NETWORK_RESIDENCY__MAX_NETWORKS,
+			   "HUB_NETWORK_RESIDENCY_MAX_NETWORKS is out of sync with the "
+			   "interface");
+
+/**
+ * Read the residency of the ML networks of the GARD in its HRAM with
+ * GET_NETWORK_RESIDENCY.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_residency is filled with the residency of the networks
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_NETWORK_RESIDENCY if failed
+ */
+enum hub_ret_code
+	hub_get_network_residency(gard_handle_t                 p_gard_handle,
+							  struct hub_network_residency *p_residency)
+{
+	int                                     bus_hdl;
+	enum hub_gard_bus_types                 bus_type;
+	struct iovec                            iov[2];
+	struct _get_network_residency_response *p_resp;
+	struct _network_residency              *p_in;
+	struct hub_network_residency_entry     *p_out;
+	uint32_t                                idx;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  res_cmd      = {0};
+	struct _host_responses res_response = {0};
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_residency)) {
+		hub_pr_err("Error: p_gard_handle or p_residency is NULL\n");
+		goto err_get_network_residency_1;
+	}
+
+	res_cmd.command_id = GET_NETWORK_RESIDENCY;
+	res_cmd.get_network_residency_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for get_network_residency!\n");
+		goto err_get_network_residency_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for get_network_residency!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_get_network_residency_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &res_cmd.command_id;
+	iov[0].iov_len  = sizeof(res_cmd.command_id);
+	iov[1].iov_base = &res_cmd.command_body;
+	iov[1].iov_len  = sizeof(res_cmd.get_network_residency_request);
+
+	p_resp = &res_response.get_network_residency_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging get_network_residency request\n");
+		goto err_get_network_residency_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker) ||
+		(NETWORK_RESIDENCY__MAX_NETWORKS < p_resp->num_networks)) {
+		hub_pr_err("Error in get_network_residency response\n");
+		goto err_get_network_residency_1;
+	}
+
+	p_residency->num_networks       = p_resp->num_networks;
+	p_residency->free_bytes         = p_resp->free_bytes;
+	p_residency->largest_free_bytes = p_resp->largest_free_bytes;
+	for (idx = 0; idx < p_resp->num_networks; idx++) {
+		p_in  = &p_resp->networks[idx];
+		p_out = &p_residency->networks[idx];
+
+		p_out->network             = p_in->network;
+		p_out->addr_in_ram         = p_in->addr_in_ram;
+		p_out->size                = p_in->size;
+		p_out->flags               = p_in->flags;
+		p_out->priority            = p_in->priority;
+		p_out->loads               = p_in->loads;
+		p_out->runs_since_last_run = p_in->runs_since_last_run;
+	}
+
+	return HUB_SUCCESS;
+
+err_get_network_residency_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_get_network_residency_1:
+	return HUB_FAILURE_NETWORK_RESIDENCY;
+}
+
+_Static_assert((int)HUB_INFERENCE_RATE_ALL_FRAMES ==
+					   (int)INFERENCE_RATE__ALL_FRAMES &&
+				   (int)HUB_INFERENCE_RATE_EVERY_NTH ==
+					   (int)INFERENCE_RATE__EVERY_NTH &&
+				   (int)HUB_INFERENCE_RATE_TARGET_FPS ==
+					   (int)INFERENCE_RATE__TARGET_FPS &&
+				   (int)HUB_INFERENCE_RATE_ADAPTIVE ==
+					   (int)INFERENCE_RATE__ADAPTIVE &&
+				   (int)HUB_INFERENCE_RATE_DUTY_CYCLE ==
+					   (int)INFERENCE_RATE__DUTY_CYCLE,
+			   "enum hub_inference_rate_mode is out of sync with the interface");
+
+/**
+ * Send INFERENCE_RATE to the GARD, setting its inference rate policy if set
+ * is 1, and read back the policy in use and its rates.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: set is 1 to set mode and param, 0 to only read
+ * @param: mode is the policy to set
+ * @param: param is the parameter of the policy to set
+ * @param: p_rate is filled with the policy in use and its rates, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_INFERENCE_RATE if failed
+ */
+static enum hub_ret_code
+	hub_inference_rate_cmd(gard_handle_t                p_gard_handle,
+						   uint8_t                      set,
+						   enum hub_inference_rate_mode mode,
+						   uint32_t                     param,
+						   struct hub_inference_rate   *p_rate)
+{
+	int                              bus_hdl;
+	enum hub_gard_bus_types          bus_type;
+	struct iovec                     iov[2];
+	struct _inference_rate_response *p_resp;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  rate_cmd      = {0};
+	struct _host_responses rate_response = {0};
+
+	/* Pathological cases */
+	if (NULL == p_gard_handle) {
+		hub_pr_err("Error: p_gard_handle is NULL\n");
+		goto err_inference_rate_1;
+	}
+
+	rate_cmd.command_id                                = INFERENCE_RATE;
+	rate_cmd.inference_rate_request.set                = set;
+	rate_cmd.inference_rate_request.mode               = (uint8_t)mode;
+	rate_cmd.inference_rate_request.param              = param;
+	rate_cmd.inference_rate_request.end_of_data_marker = END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for inference_rate!\n");
+		goto err_inference_rate_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for inference_rate!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_inference_rate_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &rate_cmd.command_id;
+	iov[0].iov_len  = sizeof(rate_cmd.command_id);
+	iov[1].iov_base = &rate_cmd.command_body;
+	iov[1].iov_len  = sizeof(rate_cmd.inference_rate_request);
+
+	p_resp = &rate_response.inference_rate_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging inference_rate request\n");
+		goto err_inference_rate_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in inference_rate response\n");
+		goto err_inference_rate_1;
+	}
+
+	if (NULL != p_rate) {
+		p_rate->mode           = (enum hub_inference_rate_mode)p_resp->mode;
+		p_rate->param          = p_resp->param;
+		p_rate->frames_offered = p_resp->frames_offered;
+		p_rate->frames_run     = p_resp->frames_run;
+		p_rate->offered_mfps   = p_resp->offered_mfps;
+		p_rate->run_mfps       = p_resp->run_mfps;
+		p_rate->run_interval   = p_resp->run_interval;
+		p_rate->wake_us        = p_resp->wake_us;
+	}
+
+	if (ACK_BYTE != p_resp->ack_or_nak) {
+		hub_pr_err("GARD refused inference rate mode %u param %u\n",
+				   (unsigned int)mode, param);
+		goto err_inference_rate_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_inference_rate_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_inference_rate_1:
+	return HUB_FAILURE_INFERENCE_RATE;
+}
+
+/**
+ * Set the inference rate policy of the GARD with INFERENCE_RATE.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: mode is the policy
+ * @param: param is the parameter of the policy
+ * @param: p_rate is filled with the policy now in use and its rates, can be
+ *         NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_INFERENCE_RATE if failed
+ */
+enum hub_ret_code
+	hub_set_inference_rate(gard_handle_t                p_gard_handle,
+						   enum hub_inference_rate_mode mode,
+						   uint32_t                     param,
+						   struct hub_inference_rate   *p_rate)
+{
+	return hub_inference_rate_cmd(p_gard_handle, 1, mode, param, p_rate);
+}
+
+/**
+ * Read the inference rate policy of the GARD and the rates it gives with
+ * INFERENCE_RATE.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_rate is filled with the policy in use and its rates
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_INFERENCE_RATE if failed
+ */
+enum hub_ret_code hub_get_inference_rate(gard_handle_t              p_gard_handle,
+										 struct hub_inference_rate *p_rate)
+{
+	if (NULL == p_rate) {
+		hub_pr_err("Error: p_rate is NULL\n");
+		return HUB_FAILURE_INFERENCE_RATE;
+	}
+
+	return hub_inference_rate_cmd(p_gard_handle, 0,
+								  HUB_INFERENCE_RATE_ALL_FRAMES, 0, p_rate);
+}
+
+/**
+ * Send SCALER_CONFIG to the GARD, setting the scaler engine configuration of
+ * its captures if p_set is not NULL, and read back the configuration last
+ * set.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_set is the configuration to set, NULL to only read
+ * @param: p_config is filled with the configuration last set, can be NULL
+ * @param: p_applied is filled with 1 once the captures use it, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_SCALER_CONFIG if failed
+ */
+static enum hub_ret_code
+	hub_scaler_config_cmd(gard_handle_t                   p_gard_handle,
+						  const struct hub_scaler_config *p_set,
+						  struct hub_scaler_config       *p_config,
+						  uint8_t                        *p_applied)
+{
+	int                             bus_hdl;
+	enum hub_gard_bus_types         bus_type;
+	struct iovec                    iov[2];
+	struct _scaler_config_request  *p_req;
+	struct _scaler_config_response *p_resp;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  scaler_cmd      = {0};
+	struct _host_responses scaler_response = {0};
+
+	/* Pathological cases */
+	if (NULL == p_gard_handle) {
+		hub_pr_err("Error: p_gard_handle is NULL\n");
+		goto err_scaler_config_1;
+	}
+
+	scaler_cmd.command_id = SCALER_CONFIG;
+	p_req                 = &scaler_cmd.scaler_config_request;
+	if (NULL != p_set) {
+		p_req->set            = 1;
+		p_req->box_factor_x   = p_set->box_factor_x;
+		p_req->box_factor_y   = p_set->box_factor_y;
+		p_req->precrop_left   = p_set->precrop_left;
+		p_req->precrop_right  = p_set->precrop_right;
+		p_req->precrop_upper  = p_set->precrop_upper;
+		p_req->precrop_bottom = p_set->precrop_bottom;
+		p_req->crop_left      = p_set->crop_left;
+		p_req->crop_right     = p_set->crop_right;
+		p_req->crop_upper     = p_set->crop_upper;
+		p_req->crop_bottom    = p_set->crop_bottom;
+		p_req->crop_in_width  = p_set->crop_in_width;
+		p_req->crop_in_height = p_set->crop_in_height;
+		p_req->out_width      = p_set->out_width;
+		p_req->out_height     = p_set->out_height;
+	}
+	p_req->end_of_data_marker = END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for scaler_config!\n");
+		goto err_scaler_config_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for scaler_config!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_scaler_config_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &scaler_cmd.command_id;
+	iov[0].iov_len  = sizeof(scaler_cmd.command_id);
+	iov[1].iov_base = &scaler_cmd.command_body;
+	iov[1].iov_len  = sizeof(scaler_cmd.scaler_config_request);
+
+	p_resp = &scaler_response.scaler_config_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging scaler_config request\n");
+		goto err_scaler_config_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in scaler_config response\n");
+		goto err_scaler_config_1;
+	}
+
+	if (NULL != p_config) {
+		p_config->box_factor_x   = p_resp->box_factor_x;
+		p_config->box_factor_y   = p_resp->box_factor_y;
+		p_config->precrop_left   = p_resp->precrop_left;
+		p_config->precrop_right  = p_resp->precrop_right;
+		p_config->precrop_upper  = p_resp->precrop_upper;
+		p_config->precrop_bottom = p_resp->precrop_bottom;
+		p_config->crop_left      = p_resp->crop_left;
+		p_config->crop_right     = p_resp->crop_right;
+		p_config->crop_upper     = p_resp->crop_upper;
+		p_config->crop_bottom    = p_resp->crop_bottom;
+		p_config->crop_in_width  = p_resp->crop_in_width;
+		p_config->crop_in_height = p_resp->crop_in_height;
+		p_config->out_width      = p_resp->out_width;
+		p_config->out_height     = p_resp->out_height;
+	}
+
+	if (NULL != p_applied) {
+		*p_applied = p_resp->applied;
+	}
+
+	if (ACK_BYTE != p_resp->ack_or_nak) {
+		hub_pr_err("GARD refused the scaler configuration\n");
+		goto err_scaler_config_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_scaler_config_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_scaler_config_1:
+	return HUB_FAILURE_SCALER_CONFIG;
+}
+
+/**
+ * Set the scaler engine configuration of the captures of the GARD with
+ * SCALER_CONFIG.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_config is the configuration to set
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_SCALER_CONFIG if failed
+ */
+enum hub_ret_code
+	hub_set_scaler_config(gard_handle_t                   p_gard_handle,
+						  const struct hub_scaler_config *p_config)
+{
+	if (NULL == p_config) {
+		hub_pr_err("Error: p_config is NULL\n");
+		return HUB_FAILURE_SCALER_CONFIG;
+	}
+
+	return hub_scaler_config_cmd(p_gard_handle, p_config, NULL, NULL);
+}
+
+/**
+ * Read the scaler engine configuration last set on the GARD with
+ * SCALER_CONFIG.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_config is filled with the configuration
+ * @param: p_applied is filled with 1 once the captures use it, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_SCALER_CONFIG if failed
+ */
+enum hub_ret_code hub_get_scaler_config(gard_handle_t             p_gard_handle,
+										struct hub_scaler_config *p_config,
+										uint8_t                  *p_applied)
+{
+	if (NULL == p_config) {
+		hub_pr_err("Error: p_config is NULL\n");
+		return HUB_FAILURE_SCALER_CONFIG;
+	}
+
+	return hub_scaler_config_cmd(p_gard_handle, NULL, p_config, p_applied);
+}
+
+_Static_assert(HUB_IMAGE_STATS_HISTORY == IMAGE_STATS__HISTORY,
+			   "HUB_IMAGE_STATS_HISTORY is out of sync with the interface");
+
+/**
+ * Read the ISP statistics of the last images captured by the GARD with
+ * GET_IMAGE_STATS.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_stats is filled with the statistics, the newest first
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_IMAGE_STATS if failed
+ */
+enum hub_ret_code hub_get_image_stats(gard_handle_t           p_gard_handle,
+									  struct hub_image_stats *p_stats)
+{
+	int                               bus_hdl;
+	enum hub_gard_bus_types           bus_type;
+	struct iovec                      iov[2];
+	struct _get_image_stats_response *p_resp;
+	struct _image_stats              *p_in;
+	struct hub_image_stats_entry     *p_out;
+	uint32_t                          idx;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  stats_cmd      = {0};
+	struct _host_responses stats_response = {0};
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_stats)) {
+		hub_pr_err("Error: p_gard_handle or p_stats is NULL\n");
+		goto err_get_image_stats_1;
+	}
+
+	stats_cmd.command_id = GET_IMAGE_STATS;
+	stats_cmd.get_image_stats_request.end_of_data_marker = END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for get_image_stats!\n");
+		goto err_get_image_stats_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for get_image_stats!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_get_image_stats_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &stats_cmd.command_id;
+	iov[0].iov_len  = sizeof(stats_cmd.command_id);
+	iov[1].iov_base = &stats_cmd.command_body;
+	iov[1].iov_len  = sizeof(stats_cmd.get_image_stats_request);
+
+	p_resp = &stats_response.get_image_stats_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging get_image_stats request\n");
+		goto err_get_image_stats_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker) ||
+		(IMAGE_STATS__HISTORY < p_resp->num_stats)) {
+		hub_pr_err("Error in get_image_stats response\n");
+		goto err_get_image_stats_1;
+	}
+
+	p_stats->num_stats       = p_resp->num_stats;
+	p_stats->images_recorded = p_resp->images_recorded;
+	for (idx = 0; idx < p_resp->num_stats; idx++) {
+		p_in  = &p_resp->stats[idx];
+		p_out = &p_stats->stats[idx];
+
+		p_out->frame_seq = p_in->frame_seq;
+		p_out->gray_avg  = p_in->gray_avg;
+		p_out->gray_min  = p_in->gray_min;
+		p_out->gray_max  = p_in->gray_max;
+	}
+
+	return HUB_SUCCESS;
+
+err_get_image_stats_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_get_image_stats_1:
+	return HUB_FAILURE_IMAGE_STATS;
+}
+
+/**
+ * Convert GARD timer ticks to nanoseconds.
+ *
+ * @param: ticks is the GARD time
+ * @param: freq_hz is the GARD timer frequency, not 0
+ *
+ * @return: The GARD time in nanoseconds
+ */
+static uint64_t hub_gard_ticks_to_ns(uint64_t ticks, uint32_t freq_hz)
+{
+	return ((ticks / freq_hz) * 1000000000ULL) +
+		   (((ticks % freq_hz) * 1000000000ULL) / freq_hz);
+}
+
+/**
+ * Read the GARD time with GET_GARD_TIME, and the host time of the round trip.
+ *
+ * @param: gard is the GARD
+ * @param: bus_hdl is the handle of its command bus
+ * @param: p_sync is filled with the GARD time, its frequency, the middle of
+ *         the round trip and the round trip time
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_GARD_TIME if failed
+ */
+static enum hub_ret_code hub_get_gard_time(struct hub_gard_info       *gard,
+										   int                         bus_hdl,
+										   struct hub_gard_clock_sync *p_sync)
+{
+	struct iovec                    iov[2];
+	struct _get_gard_time_response *p_resp;
+	uint64_t                        sent_ns, recv_ns;
+
+	struct _host_requests  time_cmd      = {0};
+	struct _host_responses time_response = {0};
+
+	time_cmd.command_id = GET_GARD_TIME;
+	time_cmd.get_gard_time_request.end_of_data_marker = END_OF_DATA_MARKER;
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &time_cmd.command_id;
+	iov[0].iov_len  = sizeof(time_cmd.command_id);
+	iov[1].iov_base = &time_cmd.command_body;
+	iov[1].iov_len  = sizeof(time_cmd.get_gard_time_request);
+
+	p_resp  = &time_response.get_gard_time_response;
+	sent_ns = hub_stats_now_ns();
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   0)) {
+		hub_pr_err("Error exchanging get_gard_time request\n");
+		goto err_get_gard_time_2;
+	}
+	recv_ns = hub_stats_now_ns();
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker) ||
+		(0 == p_resp->timer_freq)) {
+		hub_pr_err("Error in get_gard_time response\n");
+		goto err_get_gard_time_1;
+	}
+
+	p_sync->gard_ticks    = ((uint64_t)p_resp->time_hi << 32) | p_resp->time_lo;
+	p_sync->gard_freq_hz  = p_resp->timer_freq;
+	p_sync->host_ns       = sent_ns + ((recv_ns - sent_ns) / 2);
+	p_sync->round_trip_ns = recv_ns - sent_ns;
+
+	return HUB_SUCCESS;
+
+err_get_gard_time_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_get_gard_time_1:
+	return HUB_FAILURE_GARD_TIME;
+}
+
+/**
+ * Map the GARD timer to the host clock from num_samples GET_GARD_TIME round
+ * trips, keeping the quickest one, and measure its drift from the previous
+ * synchronization in p_sync, if any.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: num_samples is the count of round trips
+ * @param: p_sync is the previous synchronization, updated with the new one
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_GARD_TIME if failed
+ */
+enum hub_ret_code hub_sync_gard_clock(gard_handle_t               p_gard_handle,
+									  uint32_t                    num_samples,
+									  struct hub_gard_clock_sync *p_sync)
+{
+	int                        bus_hdl;
+	enum hub_gard_bus_types    bus_type;
+	struct hub_gard_clock_sync best   = {0};
+	struct hub_gard_clock_sync sample = {0};
+	uint64_t                   gard_elapsed_ns, host_elapsed_ns;
+	double                     drift_ppb;
+	uint32_t                   idx;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_sync) || (0 == num_samples)) {
+		hub_pr_err("Error: p_gard_handle or p_sync is NULL, or no samples\n");
+		return HUB_FAILURE_GARD_TIME;
+	}
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for sync_gard_clock!\n");
+		return HUB_FAILURE_GARD_TIME;
+	default:
+		hub_pr_err("%s: Bus not supported for sync_gard_clock!\n",
+				   hub_gard_bus_strings[bus_type]);
+		return HUB_FAILURE_GARD_TIME;
+	}
+
+	/* The quickest round trip bounds the error of the mapping the most */
+	for (idx = 0; idx < num_samples; idx++) {
+		if (HUB_SUCCESS != hub_get_gard_time(gard, bus_hdl, &sample)) {
+			return HUB_FAILURE_GARD_TIME;
+		}
+		if ((0 == idx) || (sample.round_trip_ns < best.round_trip_ns)) {
+			best = sample;
+		}
+	}
+
+	best.offset_ns =
+		(int64_t)best.host_ns -
+		(int64_t)hub_gard_ticks_to_ns(best.gard_ticks, best.gard_freq_hz);
+	best.drift_ppb = 0;
+
+	/* The drift is measured from the previous synchronization, if any */
+	if ((0 != p_sync->gard_freq_hz) && (best.host_ns > p_sync->host_ns) &&
+		(best.gard_ticks > p_sync->gard_ticks)) {
+		gard_elapsed_ns =
+			hub_gard_ticks_to_ns(best.gard_ticks - p_sync->gard_ticks,
+								 best.gard_freq_hz);
+		host_elapsed_ns = best.host_ns - p_sync->host_ns;
+		drift_ppb = (((double)gard_elapsed_ns - (double)host_elapsed_ns) *
+					 1e9) /
+					(double)host_elapsed_ns;
+		if (drift_ppb > INT32_MAX) {
+			drift_ppb = INT32_MAX;
+		} else if (drift_ppb < INT32_MIN) {
+			drift_ppb = INT32_MIN;
+		}
+		best.drift_ppb = (int32_t)drift_ppb;
+	}
+
+	*p_sync = best;
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Map a GARD time to the host clock, correcting for the drift since the
+ * synchronization.
+ *
+ * @param: p_sync is a synchronization made by hub_sync_gard_clock
+ * @param: gard_ticks is the GARD time
+ *
+ * @return: The host CLOCK_MONOTONIC time in nanoseconds, 0 if p_sync holds no
+ *          synchronization
+ */
+uint64_t hub_gard_ticks_to_host_ns(const struct hub_gard_clock_sync *p_sync,
+								   uint64_t                          gard_ticks)
+{
+	int64_t elapsed_ns;
+
+	if ((NULL == p_sync) || (0 == p_sync->gard_freq_hz)) {
+		return 0;
+	}
+
+	/* Signed: the GARD time can be before the synchronization */
+	if (gard_ticks >= p_sync->gard_ticks) {
+		elapsed_ns = (int64_t)hub_gard_ticks_to_ns(
+			gard_ticks - p_sync->gard_ticks, p_sync->gard_freq_hz);
+	} else {
+		elapsed_ns = -(int64_t)hub_gard_ticks_to_ns(
+			p_sync->gard_ticks - gard_ticks, p_sync->gard_freq_hz);
+	}
+
+	/* A GARD timer running fast counts more than the host clock elapsed */
+	elapsed_ns -= (int64_t)(((double)elapsed_ns * p_sync->drift_ppb) / 1e9);
+
+	return (uint64_t)((int64_t)p_sync->host_ns + elapsed_ns);
+}
+
+/**
+ * Send an UPGRADE_FIRMWARE sub-command to the GARD and read back its response,
+ * of the size of the part of the sub-command.
+ *
+ * @param: gard is the GARD
+ * @param: p_cmd is the request, its sub-command filled in
+ * @param: p_resp is filled with the response
+ * @param: resp_size is the size of the response of the sub-command
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_UPGRADE_FIRMWARE if failed
+ */
+static enum hub_ret_code
+	hub_upgrade_firmware_cmd(struct hub_gard_info   *gard,
+							 struct _host_requests  *p_cmd,
+							 struct _host_responses *p_resp,
+							 size_t                  resp_size)
+{
+	int                     bus_hdl;
+	enum hub_gard_bus_types bus_type;
+	struct iovec            iov[2];
+
+	p_cmd->command_id = UPGRADE_FIRMWARE;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for upgrade_firmware!\n");
+		goto err_upgrade_firmware_cmd_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for upgrade_firmware!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_upgrade_firmware_cmd_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &p_cmd->command_id;
+	iov[0].iov_len  = sizeof(p_cmd->command_id);
+	iov[1].iov_base = &p_cmd->command_body;
+	iov[1].iov_len  = sizeof(p_cmd->upgrade_firmware_request);
+
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, resp_size, 0)) {
+		hub_pr_err("Error exchanging upgrade_firmware request\n");
+		goto err_upgrade_firmware_cmd_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	return HUB_SUCCESS;
+
+err_upgrade_firmware_cmd_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_upgrade_firmware_cmd_1:
+	return HUB_FAILURE_UPGRADE_FIRMWARE;
+}
+
+/**
+ * Wait for the GARD to have programmed the image up to a given byte, polling
+ * IS_OPERATION_COMPLETE.
+ *
+ * @param: gard is the GARD
+ * @param: bytes is the end of the last chunk to wait for, 0 to only read the
+ *         progress
+ * @param: p_bytes_programmed is filled with the bytes GARD has programmed
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_UPGRADE_FIRMWARE if GARD failed to program a chunk, or
+ *          on a timeout
+ */
+static enum hub_ret_code
+	hub_upgrade_firmware_wait(struct hub_gard_info *gard,
+							  uint32_t              bytes,
+							  uint32_t             *p_bytes_programmed)
+{
+	uint32_t               waited_us = 0;
+	struct _host_requests  cmd       = {0};
+	struct _host_responses response  = {0};
+
+	cmd.upgrade_firmware_request.sub_command_id = USCID__IS_OPERATION_COMPLETE;
+
+	while (1) {
+		if (HUB_SUCCESS !=
+			hub_upgrade_firmware_cmd(
+				gard, &cmd, &response,
+				sizeof(response.upgrade_firmware_response
+						   .is_operation_complete_response))) {
+			return HUB_FAILURE_UPGRADE_FIRMWARE;
+		}
+
+		*p_bytes_programmed = response.upgrade_firmware_response
+								  .is_operation_complete_response
+								  .bytes_programmed;
+
+		if (FIRMWARE_UPGRADE__FAILED ==
+			response.upgrade_firmware_response.is_operation_complete_response
+				.operation_status) {
+			hub_pr_err("GARD failed to program the firmware after %u bytes\n",
+					   *p_bytes_programmed);
+			return HUB_FAILURE_UPGRADE_FIRMWARE;
+		}
+
+		if (*p_bytes_programmed >= bytes) {
+			return HUB_SUCCESS;
+		}
+
+		if (waited_us >= HUB_UPGRADE_FIRMWARE_TIMEOUT_US) {
+			hub_pr_err("Timeout waiting for the firmware to be programmed\n");
+			return HUB_FAILURE_UPGRADE_FIRMWARE;
+		}
+
+		usleep(HUB_UPGRADE_FIRMWARE_POLL_US);
+		waited_us += HUB_UPGRADE_FIRMWARE_POLL_US;
+	}
+}
+
+/**
+ * Program a new image in the flash of the GARD. The chunks of the image go
+ * round the staging buffers of GARD: a buffer is reused once the chunk sent
+ * to it is programmed, so that the next chunks are sent while GARD programs.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_image is the image to program
+ * @param: size is the size of p_image in bytes
+ * @param: is_bitstream_included is 1 if the image starts with the bitstream
+ * @param: resume is 1 to keep the bytes programmed by the last upgrade
+ * @param: p_bytes_programmed is filled with the bytes programmed, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_UPGRADE_FIRMWARE if failed
+ */
+enum hub_ret_code hub_upgrade_gard_firmware(gard_handle_t p_gard_handle,
+											const void   *p_image,
+											uint32_t      size,
+											uint8_t       is_bitstream_included,
+											uint8_t       resume,
+											uint32_t     *p_bytes_programmed)
+{
+	enum hub_ret_code ret = HUB_FAILURE_UPGRADE_FIRMWARE;
+	uint32_t          bytes_programmed = 0;
+	uint32_t          offset, chunk_size, buffer_addr, idx;
+	uint32_t          first_buffer, buffer_size, num_buffers, flash_address;
+	uint32_t         *p_buffer_ends = NULL;
+	const uint8_t    *p_bytes       = (const uint8_t *)p_image;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  cmd      = {0};
+	struct _host_responses response = {0};
+
+	struct _upgrade_firmware_request *p_req = &cmd.upgrade_firmware_request;
+	struct _upgrade_firmware_response *p_resp =
+		&response.upgrade_firmware_response;
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_image) || (0 == size)) {
+		hub_pr_err("Error: p_gard_handle or p_image is NULL, or size is 0\n");
+		goto err_upgrade_gard_firmware_1;
+	}
+
+	p_req->sub_command_id = USCID__GET_XFER_INFORMATION;
+	p_req->get_xfer_information.is_bitstream_included =
+		(0 != is_bitstream_included);
+	p_req->get_xfer_information.resume        = (0 != resume);
+	p_req->get_xfer_information.firmware_size = size;
+
+	if (HUB_SUCCESS !=
+		hub_upgrade_firmware_cmd(
+			gard, &cmd, &response,
+			sizeof(p_resp->get_xfer_information_response))) {
+		goto err_upgrade_gard_firmware_1;
+	}
+
+	if ((START_OF_DATA_MARKER !=
+		 p_resp->get_xfer_information_response.start_of_data_marker) ||
+		(END_OF_DATA_MARKER !=
+		 p_resp->get_xfer_information_response.eod.end_of_data_marker)) {
+		hub_pr_err("Error in upgrade_firmware response\n");
+		goto err_upgrade_gard_firmware_1;
+	}
+
+	if ((0 == p_resp->get_xfer_information_response.buffer_size) ||
+		(0 == p_resp->get_xfer_information_response.num_buffers) ||
+		(0 != (p_resp->get_xfer_information_response.buffer_size %
+			   FIRMWARE_UPGRADE_ALIGN))) {
+		hub_pr_err("GARD refused the firmware upgrade\n");
+		goto err_upgrade_gard_firmware_1;
+	}
+
+	/* Each chunk is the size of a buffer, but for the last one */
+	buffer_size   = p_resp->get_xfer_information_response.buffer_size;
+	num_buffers   = p_resp->get_xfer_information_response.num_buffers;
+	first_buffer  = p_resp->get_xfer_information_response.buffer_address;
+	flash_address = p_resp->get_xfer_information_response.flash_address;
+
+	/* End of the chunk last sent to each buffer, 0 while free */
+	p_buffer_ends = calloc(num_buffers, sizeof(*p_buffer_ends));
+	if (NULL == p_buffer_ends) {
+		hub_pr_err("Error allocating the upgrade buffer list\n");
+		goto err_upgrade_gard_firmware_1;
+	}
+
+	/* Resume where GARD is, 0 unless resumed */
+	if (HUB_SUCCESS != hub_upgrade_firmware_wait(gard, 0, &bytes_programmed)) {
+		goto err_upgrade_gard_firmware_2;
+	}
+
+	for (offset = bytes_programmed, idx = 0; offset < size; idx++) {
+		chunk_size  = hub_min_uint32(buffer_size, size - offset);
+		buffer_addr = first_buffer +
+					  ((idx % num_buffers) * buffer_size);
+
+		/* The buffer is free once its last chunk is programmed */
+		if (HUB_SUCCESS !=
+			hub_upgrade_firmware_wait(gard,
+									  p_buffer_ends[idx % num_buffers],
+									  &bytes_programmed)) {
+			goto err_upgrade_gard_firmware_2;
+		}
+
+		if (HUB_SUCCESS != hub_send_data_to_gard(p_gard_handle,
+												 &p_bytes[offset], buffer_addr,
+												 chunk_size)) {
+			hub_pr_err("Error sending firmware chunk at %u\n", offset);
+			goto err_upgrade_gard_firmware_2;
+		}
+
+		memset(&cmd, 0, sizeof(cmd));
+		p_req->sub_command_id = USCID__WRITE_FIRMWARE_TO_FLASH;
+		p_req->write_firmware_to_flash.buffer_address = buffer_addr;
+		p_req->write_firmware_to_flash.bytes_to_write = chunk_size;
+		p_req->write_firmware_to_flash.flash_address =
+			flash_address + offset;
+		p_req->write_firmware_to_flash.crc =
+			hub_crc32(0, &p_bytes[offset], chunk_size);
+
+		if (HUB_SUCCESS !=
+			hub_upgrade_firmware_cmd(
+				gard, &cmd, &response,
+				sizeof(p_resp->write_firmware_to_flash_response))) {
+			goto err_upgrade_gard_firmware_2;
+		}
+
+		if (ACK_BYTE != p_resp->write_firmware_to_flash_response.ack) {
+			hub_pr_err("GARD refused firmware chunk at %u\n", offset);
+			goto err_upgrade_gard_firmware_2;
+		}
+
+		offset                                 += chunk_size;
+		p_buffer_ends[idx % num_buffers]   = offset;
+	}
+
+	/* Wait for the last chunks to be programmed */
+	if (HUB_SUCCESS != hub_upgrade_firmware_wait(gard, size, &bytes_programmed)) {
+		goto err_upgrade_gard_firmware_2;
+	}
+
+	ret = HUB_SUCCESS;
+
+err_upgrade_gard_firmware_2:
+	free(p_buffer_ends);
+err_upgrade_gard_firmware_1:
+	if (NULL != p_bytes_programmed) {
+		*p_bytes_programmed = bytes_programmed;
+	}
+
+	return ret;
+}
+
+/**
+ * Send an App Module command to the GARD and read back the status returned by
+ * the App Module handler.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: command_id is the App Module command id
+ * @param: p_body is the command body, of the size registered on GARD
+ * @param: body_size is the size of p_body, 0 if the command has none
+ * @param: p_status is filled with the status returned by the App Module
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_APP_COMMAND if failed
+ */
+enum hub_ret_code hub_send_app_command(gard_handle_t p_gard_handle,
+									   uint8_t       command_id,
+									   const void   *p_body,
+									   uint32_t      body_size,
+									   uint32_t     *p_status)
+{
+	int                           bus_hdl, iovcnt = 0;
+	enum hub_gard_bus_types       bus_type;
+	struct iovec                  iov[3];
+	struct _app_command_response *p_resp;
+	uint32_t                      eod_marker = END_OF_DATA_MARKER;
+
+	struct hub_gard_info         *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests         app_cmd      = {0};
+	struct _host_responses        app_response = {0};
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_status) ||
+		((NULL == p_body) && (body_size > 0)) ||
+		(command_id < APP_COMMAND_ID_FIRST) ||
+		(command_id > APP_COMMAND_ID_LAST)) {
+		hub_pr_err("Error: invalid arguments for app command 0x%x\n",
+				   command_id);
+		goto err_send_app_command_1;
+	}
+
+	app_cmd.command_id = command_id;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for app command!\n");
+		goto err_send_app_command_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for app command!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_send_app_command_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id, body and end of data marker in one go */
+	iov[iovcnt].iov_base  = &app_cmd.command_id;
+	iov[iovcnt++].iov_len = sizeof(app_cmd.command_id);
+	if (body_size > 0) {
+		iov[iovcnt].iov_base  = (void *)p_body;
+		iov[iovcnt++].iov_len = body_size;
+	}
+	iov[iovcnt].iov_base  = &eod_marker;
+	iov[iovcnt++].iov_len = sizeof(eod_marker);
+
+	p_resp = &app_response.app_command_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, iovcnt, p_resp, sizeof(*p_resp),
+						   0)) {
+		hub_pr_err("Error exchanging app command 0x%x\n", command_id);
+		goto err_send_app_command_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in app command 0x%x response\n", command_id);
+		goto err_send_app_command_1;
+	}
+
+	if (APP_COMMAND_STATUS_NOT_REGISTERED == p_resp->status) {
+		hub_pr_err("App command 0x%x is not registered on GARD\n", command_id);
+		goto err_send_app_command_1;
+	}
+
+	*p_status = p_resp->status;
+
+	return HUB_SUCCESS;
+
+err_send_app_command_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_send_app_command_1:
+	return HUB_FAILURE_APP_COMMAND;
+}
+
+_Static_assert(HUB_HOST_INFERENCE_SLOTS == HOST_INFERENCE__SLOTS,
+			   "HUB_HOST_INFERENCE_SLOTS is out of sync with the interface");
+
+/**
+ * Send RUN_INFERENCE_ON_BUFFER to the GARD and read back its input slots.
+ *
+ * @param: gard is the GARD
+ * @param: p_req is the request, its end_of_data_marker is set here
+ * @param: p_info is filled with the input slots
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_HOST_INFERENCE if failed, or if GARD refused the
+ *          request
+ */
+static enum hub_ret_code
+	hub_host_inference_cmd(struct hub_gard_info                    *gard,
+						   struct _run_inference_on_buffer_request *p_req,
+						   struct hub_host_inference_info          *p_info)
+{
+	int                                        bus_hdl;
+	enum hub_gard_bus_types                    bus_type;
+	struct iovec                               iov[2];
+	struct _run_inference_on_buffer_response  *p_resp;
+	uint32_t                                   idx;
+
+	struct _host_requests  run_cmd      = {0};
+	struct _host_responses run_response = {0};
+
+	run_cmd.command_id                      = RUN_INFERENCE_ON_BUFFER;
+	run_cmd.run_inference_on_buffer_request = *p_req;
+	run_cmd.run_inference_on_buffer_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for run_inference_on_buffer!\n");
+		goto err_host_inference_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for run_inference_on_buffer!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_host_inference_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &run_cmd.command_id;
+	iov[0].iov_len  = sizeof(run_cmd.command_id);
+	iov[1].iov_base = &run_cmd.command_body;
+	iov[1].iov_len  = sizeof(run_cmd.run_inference_on_buffer_request);
+
+	p_resp = &run_response.run_inference_on_buffer_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp), 0)) {
+		hub_pr_err("Error exchanging run_inference_on_buffer request\n");
+		goto err_host_inference_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in run_inference_on_buffer response\n");
+		goto err_host_inference_1;
+	}
+
+	p_info->active     = p_resp->active;
+	p_info->free_slots = p_resp->free_slots;
+	p_info->slot_size  = p_resp->slot_size;
+	for (idx = 0; idx < HUB_HOST_INFERENCE_SLOTS; idx++) {
+		p_info->slot_address[idx] = p_resp->slot_address[idx];
+	}
+
+	if (ACK_BYTE != p_resp->ack_or_nak) {
+		hub_pr_err("GARD refused the run_inference_on_buffer request\n");
+		goto err_host_inference_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_host_inference_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_host_inference_1:
+	return HUB_FAILURE_HOST_INFERENCE;
+}
+
+/**
+ * Read the input slots of the images the GARD runs its networks on, with
+ * RUN_INFERENCE_ON_BUFFER.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_info is filled with the slots
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_HOST_INFERENCE if failed
+ */
+enum hub_ret_code
+	hub_get_host_inference_info(gard_handle_t                   p_gard_handle,
+								struct hub_host_inference_info *p_info)
+{
+	struct _run_inference_on_buffer_request req = {0};
+
+	if ((NULL == p_gard_handle) || (NULL == p_info)) {
+		hub_pr_err("Error: p_gard_handle or p_info is NULL\n");
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	req.op = HOST_INFERENCE__QUERY;
+
+	return hub_host_inference_cmd((struct hub_gard_info *)p_gard_handle, &req,
+								  p_info);
+}
+
+/**
+ * Run the networks of the GARD on an image of the host: wait for a free input
+ * slot, send the image to it and submit it with RUN_INFERENCE_ON_BUFFER. The
+ * slot the networks run on is freed once the next image is scaled, so the
+ * image is sent while the networks run on the previous one.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_image is the image, width by height pixels a plane
+ * @param: format is HUB_IMAGE_FORMAT__RGB_PLANAR or HUB_IMAGE_FORMAT__GRAYSCALE
+ * @param: width is the width of the image in pixels
+ * @param: height is the height of the image in pixels
+ * @param: frame_id is the frame sequence number of the results
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_HOST_INFERENCE if failed
+ */
+enum hub_ret_code hub_run_inference_on_buffer(gard_handle_t          p_gard_handle,
+											  const void            *p_image,
+											  enum hub_image_formats format,
+											  uint16_t               width,
+											  uint16_t               height,
+											  uint32_t               frame_id)
+{
+	struct hub_host_inference_info          info;
+	struct _run_inference_on_buffer_request req       = {0};
+	uint32_t                                waited_us = 0;
+	uint32_t                                size, slot;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	if ((NULL == p_gard_handle) || (NULL == p_image)) {
+		hub_pr_err("Error: p_gard_handle or p_image is NULL\n");
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	switch (format) {
+	case HUB_IMAGE_FORMAT__RGB_PLANAR:
+		size = 3U * width * height;
+		break;
+	case HUB_IMAGE_FORMAT__GRAYSCALE:
+		size = (uint32_t)width * height;
+		break;
+	default:
+		hub_pr_err("Image format %d not supported\n", format);
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	/* Wait for GARD to be done with the image sent to a slot */
+	req.op = HOST_INFERENCE__QUERY;
+	while (1) {
+		if (HUB_SUCCESS != hub_host_inference_cmd(gard, &req, &info)) {
+			return HUB_FAILURE_HOST_INFERENCE;
+		}
+
+		if (0 != info.free_slots) {
+			break;
+		}
+
+		if (waited_us >= HUB_HOST_INFERENCE_TIMEOUT_US) {
+			hub_pr_err("Timeout waiting for a free input slot\n");
+			return HUB_FAILURE_HOST_INFERENCE;
+		}
+
+		usleep(HUB_HOST_INFERENCE_POLL_US);
+		waited_us += HUB_HOST_INFERENCE_POLL_US;
+	}
+
+	if ((0 == size) || (size > info.slot_size)) {
+		hub_pr_err("Image of %u bytes does not fit a slot of %u bytes\n",
+				   size, info.slot_size);
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	/* The lowest free slot */
+	slot = 0;
+	while (0 == (info.free_slots & (1U << slot))) {
+		slot++;
+	}
+
+	if (HUB_SUCCESS != hub_send_data_to_gard(p_gard_handle, p_image,
+											 info.slot_address[slot], size)) {
+		hub_pr_err("Error sending the image to slot %u\n", slot);
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	req.op       = HOST_INFERENCE__SUBMIT;
+	req.slot     = (uint8_t)slot;
+	req.format   = (uint8_t)format;
+	req.width    = width;
+	req.height   = height;
+	req.frame_id = frame_id;
+
+	return hub_host_inference_cmd(gard, &req, &info);
+}
+
+/**
+ * Have the GARD drop the host images it has not run yet and go back to its
+ * camera images, with RUN_INFERENCE_ON_BUFFER.
+ *
+ * @param: p_gard_handle GARD handle
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_HOST_INFERENCE if failed
+ */
+enum hub_ret_code hub_stop_host_inference(gard_handle_t p_gard_handle)
+{
+	struct hub_host_inference_info          info;
+	struct _run_inference_on_buffer_request req = {0};
+
+	if (NULL == p_gard_handle) {
+		hub_pr_err("Error: p_gard_handle is NULL\n");
+		return HUB_FAILURE_HOST_INFERENCE;
+	}
+
+	req.op = HOST_INFERENCE__STOP;
+
+	return hub_host_inference_cmd((struct hub_gard_info *)p_gard_handle, &req,
+								  &info);
+}
+
+_Static_assert(((int)HUB_NETWORK_SWAP_IDLE == (int)NETWORK_SWAP__IDLE) &&
+				   ((int)HUB_NETWORK_SWAP_FAILED == (int)NETWORK_SWAP__FAILED),
+			   "enum hub_network_swap_status is out of sync with the interface");
+
+/**
+ * Send SWAP_NETWORK to the GARD and read back the swap.
+ *
+ * @param: gard is the GARD
+ * @param: p_req is the request, its end_of_data_marker is set here
+ * @param: p_info is filled with the swap
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_NETWORK_SWAP if failed, or if GARD refused the request
+ */
+static enum hub_ret_code
+	hub_network_swap_cmd(struct hub_gard_info         *gard,
+						 struct _swap_network_request *p_req,
+						 struct hub_network_swap_info *p_info)
+{
+	int                            bus_hdl;
+	enum hub_gard_bus_types        bus_type;
+	struct iovec                   iov[2];
+	struct _swap_network_response *p_resp;
+
+	struct _host_requests  swap_cmd      = {0};
+	struct _host_responses swap_response = {0};
+
+	swap_cmd.command_id           = SWAP_NETWORK;
+	swap_cmd.swap_network_request = *p_req;
+	swap_cmd.swap_network_request.end_of_data_marker = END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for swap_network!\n");
+		goto err_network_swap_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for swap_network!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_network_swap_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &swap_cmd.command_id;
+	iov[0].iov_len  = sizeof(swap_cmd.command_id);
+	iov[1].iov_base = &swap_cmd.command_body;
+	iov[1].iov_len  = sizeof(swap_cmd.swap_network_request);
+
+	p_resp = &swap_response.swap_network_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp), 0)) {
+		hub_pr_err("Error exchanging swap_network request\n");
+		goto err_network_swap_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in swap_network response\n");
+		goto err_network_swap_1;
+	}
+
+	p_info->status          = (enum hub_network_swap_status)p_resp->status;
+	p_info->network         = p_resp->network;
+	p_info->staging_address = p_resp->staging_address;
+	p_info->staging_size    = p_resp->staging_size;
+	p_info->bytes_persisted = p_resp->bytes_persisted;
+
+	if (ACK_BYTE != p_resp->ack_or_nak) {
+		hub_pr_err("GARD refused the swap_network request\n");
+		goto err_network_swap_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_network_swap_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_network_swap_1:
+	return HUB_FAILURE_NETWORK_SWAP;
+}
+
+/**
+ * Read the swap of an ML network of the GARD, with SWAP_NETWORK.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_info is filled with the swap
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_NETWORK_SWAP if failed
+ */
+enum hub_ret_code
+	hub_get_network_swap_info(gard_handle_t                 p_gard_handle,
+							  struct hub_network_swap_info *p_info)
+{
+	struct _swap_network_request req = {0};
+
+	if ((NULL == p_gard_handle) || (NULL == p_info)) {
+		hub_pr_err("Error: p_gard_handle or p_info is NULL\n");
+		return HUB_FAILURE_NETWORK_SWAP;
+	}
+
+	req.op = NETWORK_SWAP__STATUS;
+
+	return hub_network_swap_cmd((struct hub_gard_info *)p_gard_handle, &req,
+								p_info);
+}
+
+/**
+ * Replace an ML network of the GARD without restarting it: stage HRAM for the
+ * new network with SWAP_NETWORK, send the network there, commit it with its
+ * CRC and wait for GARD to switch to it, and to update its RFS copy if
+ * persist is set. A swap that fails before GARD switches is aborted, so that
+ * GARD gives the staged HRAM back.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: network is the UID of the network to replace
+ * @param: p_network is the new network
+ * @param: size is the size of p_network in bytes
+ * @param: persist is 1 to update the RFS copy of the network too
+ * @param: p_info is filled with the swap once done, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_NETWORK_SWAP if failed
+ */
+enum hub_ret_code hub_swap_gard_network(gard_handle_t                 p_gard_handle,
+										uint32_t                      network,
+										const void                   *p_network,
+										uint32_t                      size,
+										uint8_t                       persist,
+										struct hub_network_swap_info *p_info)
+{
+	struct hub_network_swap_info info      = {0};
+	struct _swap_network_request req       = {0};
+	uint32_t                     waited_us = 0;
+	enum hub_network_swap_status done;
+
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	/* Pathological cases */
+	if ((NULL == p_gard_handle) || (NULL == p_network) || (0 == size)) {
+		hub_pr_err("Error: p_gard_handle or p_network is NULL, or size is 0\n");
+		goto err_swap_gard_network_1;
+	}
+
+	req.op      = NETWORK_SWAP__STAGE;
+	req.network = network;
+	req.size    = size;
+	if (HUB_SUCCESS != hub_network_swap_cmd(gard, &req, &info)) {
+		hub_pr_err("GARD has no HRAM to stage network 0x%x\n", network);
+		goto err_swap_gard_network_1;
+	}
+
+	if (HUB_SUCCESS != hub_send_data_to_gard(p_gard_handle, p_network,
+											 info.staging_address, size)) {
+		hub_pr_err("Error sending network 0x%x\n", network);
+		goto err_swap_gard_network_2;
+	}
+
+	req.op    = NETWORK_SWAP__COMMIT;
+	req.flags = (0 != persist) ? NETWORK_SWAP__PERSIST : 0;
+	req.crc   = hub_crc32(0, p_network, size);
+	if (HUB_SUCCESS != hub_network_swap_cmd(gard, &req, &info)) {
+		goto err_swap_gard_network_2;
+	}
+
+	/* Wait for GARD to be done with the network */
+	done   = (0 != persist) ? HUB_NETWORK_SWAP_PERSISTED
+							: HUB_NETWORK_SWAP_SWAPPED;
+	req.op = NETWORK_SWAP__STATUS;
+	while ((done != info.status) && (HUB_NETWORK_SWAP_FAILED != info.status)) {
+		if (waited_us >= HUB_NETWORK_SWAP_TIMEOUT_US) {
+			hub_pr_err("Timeout waiting for the swap of network 0x%x\n",
+					   network);
+			goto err_swap_gard_network_1;
+		}
+
+		usleep(HUB_NETWORK_SWAP_POLL_US);
+		waited_us += HUB_NETWORK_SWAP_POLL_US;
+
+		if (HUB_SUCCESS != hub_network_swap_cmd(gard, &req, &info)) {
+			goto err_swap_gard_network_1;
+		}
+	}
+
+	if (HUB_NETWORK_SWAP_FAILED == info.status) {
+		hub_pr_err("GARD failed the swap of network 0x%x after %u bytes "
+				   "persisted\n",
+				   network, info.bytes_persisted);
+		goto err_swap_gard_network_1;
+	}
+
+	if (NULL != p_info) {
+		*p_info = info;
+	}
+
+	return HUB_SUCCESS;
+
+err_swap_gard_network_2:
+	/* Give the staged HRAM back */
+	req.op = NETWORK_SWAP__ABORT;
+	(void)hub_network_swap_cmd(gard, &req, &info);
+err_swap_gard_network_1:
+	if (NULL != p_info) {
+		*p_info = info;
+	}
+
+	return HUB_FAILURE_NETWORK_SWAP;
+}
+
+/**
+ * Send APP_DATA_COALESCING to the GARD, turning the coalescing of its app
+ * data IRQs on or off if set is 1, and read back the coalescing in use.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: set is 1 to set enable and max_latency_ms, 0 to only read
+ * @param: enable is 1 to coalesce
+ * @param: max_latency_ms is how often the IRQ is raised again while results
+ *         are unread
+ * @param: p_info is filled with the coalescing in use, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_APP_DATA_COALESCING if failed
+ */
+static enum hub_ret_code
+	hub_app_data_coalescing_cmd(gard_handle_t                   p_gard_handle,
+								uint8_t                         set,
+								uint8_t                         enable,
+								uint32_t                        max_latency_ms,
+								struct hub_app_data_coalescing *p_info)
+{
+	int                                   bus_hdl;
+	enum hub_gard_bus_types               bus_type;
+	struct iovec                          iov[2];
+	struct _app_data_coalescing_response *p_resp;
+
+	struct hub_gard_info  *gard = (struct hub_gard_info *)p_gard_handle;
+
+	struct _host_requests  coal_cmd      = {0};
+	struct _host_responses coal_response = {0};
+
+	/* Pathological cases */
+	if (NULL == p_gard_handle) {
+		hub_pr_err("Error: p_gard_handle is NULL\n");
+		goto err_app_data_coalescing_1;
+	}
+
+	coal_cmd.command_id                                 = APP_DATA_COALESCING;
+	coal_cmd.app_data_coalescing_request.set            = set;
+	coal_cmd.app_data_coalescing_request.enable         = enable;
+	coal_cmd.app_data_coalescing_request.max_latency_ms = max_latency_ms;
+	coal_cmd.app_data_coalescing_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	bus_type = gard->cmd_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->cmd_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->cmd_bus->uart.bus_hdl;
+		break;
+	case HUB_GARD_BUS_USB:
+		hub_pr_err("Bus not supported for app_data_coalescing!\n");
+		goto err_app_data_coalescing_1;
+		break;
+	default:
+		hub_pr_err("%s: Bus not supported for app_data_coalescing!\n",
+				   hub_gard_bus_strings[bus_type]);
+		goto err_app_data_coalescing_1;
+	}
+
+	/* Short command: let it go ahead of chunked data transfers */
+	hub_bus_lock_ctrl(gard->cmd_bus);
+
+	/* We now assume that the bus is open! */
+
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &coal_cmd.command_id;
+	iov[0].iov_len  = sizeof(coal_cmd.command_id);
+	iov[1].iov_base = &coal_cmd.command_body;
+	iov[1].iov_len  = sizeof(coal_cmd.app_data_coalescing_request);
+
+	p_resp = &coal_response.app_data_coalescing_response;
+	if (!hub_gard_cmd_xfer(gard, bus_hdl, iov, 2, p_resp, sizeof(*p_resp),
+						   HUB_GARD_CMD_RETRIES)) {
+		hub_pr_err("Error exchanging app_data_coalescing request\n");
+		goto err_app_data_coalescing_2;
+	}
+
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in app_data_coalescing response\n");
+		goto err_app_data_coalescing_1;
+	}
+
+	if (NULL != p_info) {
+		p_info->enabled           = p_resp->enabled;
+		p_info->max_latency_ms    = p_resp->max_latency_ms;
+		p_info->irqs_raised       = p_resp->irqs_raised;
+		p_info->results_coalesced = p_resp->results_coalesced;
+		p_info->results_copied    = p_resp->results_copied;
+		p_info->results_dropped   = p_resp->results_dropped;
+	}
+
+	if (ACK_BYTE != p_resp->ack_or_nak) {
+		hub_pr_err("GARD refused app data coalescing %u\n",
+				   (unsigned int)enable);
+		goto err_app_data_coalescing_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_app_data_coalescing_2:
+	hub_bus_unlock_ctrl(gard->cmd_bus);
+err_app_data_coalescing_1:
+	return HUB_FAILURE_APP_DATA_COALESCING;
+}
+
+/**
+ * Turn on or off the coalescing of the app data IRQs of the GARD with
+ * APP_DATA_COALESCING. Coalesced results come as records, so the GARD has
+ * to be on a bus fetching its app data in batches.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: enable is 1 to coalesce, 0 not to
+ * @param: max_latency_ms is how often the IRQ is raised again while results
+ *         are unread, 0 for the GARD default
+ * @param: p_info is filled with the coalescing now in use, can be NULL
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_APP_DATA_COALESCING if failed
+ */
+enum hub_ret_code
+	hub_set_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								uint8_t                         enable,
+								uint32_t                        max_latency_ms,
+								struct hub_app_data_coalescing *p_info)
+{
+	struct hub_gard_info *gard = (struct hub_gard_info *)p_gard_handle;
+
+	if ((NULL != gard) && (0 != enable) && !gard->cmd_bus->app_data_batch) {
+		hub_pr_err("App data coalescing needs app_data_batch on the bus\n");
+		return HUB_FAILURE_APP_DATA_COALESCING;
+	}
+
+	return hub_app_data_coalescing_cmd(p_gard_handle, 1, enable,
+									   max_latency_ms, p_info);
+}
+
+/**
+ * Read the coalescing of the app data IRQs of the GARD and its counts with
+ * APP_DATA_COALESCING.
+ *
+ * @param: p_gard_handle GARD handle
+ * @param: p_info is filled with the coalescing in use
+ *
+ * @return: HUB_SUCCESS if successful,
+ *          HUB_FAILURE_APP_DATA_COALESCING if failed
+ */
+enum hub_ret_code
+	hub_get_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								struct hub_app_data_coalescing *p_info)
+{
+	if (NULL == p_info) {
+		hub_pr_err("Error: p_info is NULL\n");
+		return HUB_FAILURE_APP_DATA_COALESCING;
+	}
+
+	return hub_app_data_coalescing_cmd(p_gard_handle, 0, 0, 0, p_info);
+}
@@ -23,4 +23,153 @@
 enum hub_ret_code hub_send_resume_pipeline(gard_handle_t p_gard_handle,
 										   uint8_t       camera_id);
 
+/**
+ * Read the pipeline timing statistics of the GARD
+ */
+enum hub_ret_code
+	hub_get_pipeline_stats(gard_handle_t              p_gard_handle,
+						   uint8_t                    reset,
+						   struct hub_pipeline_stats *p_stats);
+
+/**
+ * Read the residency of the ML networks of the GARD in its HRAM
+ */
+enum hub_ret_code
+	hub_get_network_residency(gard_handle_t                 p_gard_handle,
+							  struct hub_network_residency *p_residency);
+
+/**
+ * Set the inference rate policy of the GARD
+ */
+enum hub_ret_code
+	hub_set_inference_rate(gard_handle_t                p_gard_handle,
+						   enum hub_inference_rate_mode mode,
+						   uint32_t                     param,
+						   struct hub_inference_rate   *p_rate);
+
+/**
+ * Read the inference rate policy of the GARD and the rates it gives
+ */
+enum hub_ret_code hub_get_inference_rate(gard_handle_t              p_gard_handle,
+										 struct hub_inference_rate *p_rate);
+
+/**
+ * Set the scaler engine configuration of the captures of the GARD
+ */
+enum hub_ret_code
+	hub_set_scaler_config(gard_handle_t                   p_gard_handle,
+						  const struct hub_scaler_config *p_config);
+
+/**
+ * Read the scaler engine configuration last set on the GARD
+ */
+enum hub_ret_code hub_get_scaler_config(gard_handle_t             p_gard_handle,
+										struct hub_scaler_config *p_config,
+										uint8_t                  *p_applied);
+
+/**
+ * Read the ISP statistics of the last images captured by the GARD
+ */
+enum hub_ret_code hub_get_image_stats(gard_handle_t           p_gard_handle,
+									  struct hub_image_stats *p_stats);
+
+/**
+ * Map the GARD timer of the GARD to the host clock
+ */
+enum hub_ret_code hub_sync_gard_clock(gard_handle_t               p_gard_handle,
+									  uint32_t                    num_samples,
+									  struct hub_gard_clock_sync *p_sync);
+
+/**
+ * Map a GARD time to the host clock
+ */
+uint64_t hub_gard_ticks_to_host_ns(const struct hub_gard_clock_sync *p_sync,
+								   uint64_t                          gard_ticks);
+
+/**
+ * Polling of IS_OPERATION_COMPLETE while GARD programs the chunks of a
+ * firmware upgrade, for at most HUB_UPGRADE_FIRMWARE_TIMEOUT_US per chunk.
+ */
+#define HUB_UPGRADE_FIRMWARE_POLL_US    (2000)
+#define HUB_UPGRADE_FIRMWARE_TIMEOUT_US (10000000)
+
+/**
+ * Program a new image in the flash of the GARD
+ */
+enum hub_ret_code hub_upgrade_gard_firmware(gard_handle_t p_gard_handle,
+											const void   *p_image,
+											uint32_t      size,
+											uint8_t       is_bitstream_included,
+											uint8_t       resume,
+											uint32_t     *p_bytes_programmed);
+
+/**
+ * Polling of RUN_INFERENCE_ON_BUFFER for a free input slot, for at most
+ * HUB_HOST_INFERENCE_TIMEOUT_US per image.
+ */
+#define HUB_HOST_INFERENCE_POLL_US    (500)
+#define HUB_HOST_INFERENCE_TIMEOUT_US (2000000)
+
+/**
+ * Read the input slots of the images the GARD runs its networks on
+ */
+enum hub_ret_code
+	hub_get_host_inference_info(gard_handle_t                   p_gard_handle,
+								struct hub_host_inference_info *p_info);
+
+/**
+ * Run the networks of the GARD on an image of the host
+ */
+enum hub_ret_code hub_run_inference_on_buffer(gard_handle_t          p_gard_handle,
+											  const void            *p_image,
+											  enum hub_image_formats format,
+											  uint16_t               width,
+											  uint16_t               height,
+											  uint32_t               frame_id);
+
+/**
+ * Have the GARD go back to its camera images
+ */
+enum hub_ret_code hub_stop_host_inference(gard_handle_t p_gard_handle);
+
+/**
+ * Polling of SWAP_NETWORK for the check, switch and RFS update of the new
+ * network, for at most HUB_NETWORK_SWAP_TIMEOUT_US.
+ */
+#define HUB_NETWORK_SWAP_POLL_US    (2000)
+#define HUB_NETWORK_SWAP_TIMEOUT_US (60000000)
+
+/**
+ * Read the swap of an ML network of the GARD
+ */
+enum hub_ret_code
+	hub_get_network_swap_info(gard_handle_t                 p_gard_handle,
+							  struct hub_network_swap_info *p_info);
+
+/**
+ * Replace an ML network of the GARD without restarting it
+ */
+enum hub_ret_code hub_swap_gard_network(gard_handle_t                 p_gard_handle,
+										uint32_t                      network,
+										const void                   *p_network,
+										uint32_t                      size,
+										uint8_t                       persist,
+										struct hub_network_swap_info *p_info);
+
+/**
+ * Turn on or off the coalescing of the app data IRQs of the GARD
+ */
+enum hub_ret_code
+	hub_set_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								uint8_t                         enable,
+								uint32_t                        max_latency_ms,
+								struct hub_app_data_coalescing *p_info);
+
+/**
+ * Read the coalescing of the app data IRQs of the GARD
+ */
+enum hub_ret_code
+	hub_get_app_data_coalescing(gard_handle_t                   p_gard_handle,
+								struct hub_app_data_coalescing *p_info);
+
 #endif /* __HUB_GARD_CMDS_H__ */
\ No newline at end of file
@@ -0,0 +1,447 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "hub_governor.h"
+#include "hub_globals.h"
+
+/**
+ * Thermal and power governor
+ *
+ * One thread per HUB, from hub_governor_start() to hub_governor_stop(). Every
+ * step_ms it looks at the latest sample of the SOM sensor sampler and steps
+ * the rate all the GARDs run their ML engine at, with INFERENCE_RATE:
+ * 1. Above temp_high_c or power_high_w, the rate goes down by step_percent,
+ *    to no less than min_mfps.
+ * 2. Below temp_low_c and power_low_w, the rate goes up by step_percent. Back
+ *    up to max_mfps, the GARDs are given back the policy they had.
+ * 3. In between, or without a sample, the rate is held.
+ *
+ * The gap between the limits and the time between the steps keep the rate
+ * from swinging each time the temperature crosses a limit.
+ */
+
+/* Listing of static functions defined in this file */
+static bool  hub_governor_read_sensors(struct hub_governor_ctx *p_ctx,
+									   float                   *p_temp,
+									   float                   *p_power);
+static void  hub_governor_set_rate(struct hub_governor_ctx *p_ctx,
+								   uint32_t                 mfps);
+static void  hub_governor_restore(struct hub_governor_ctx *p_ctx);
+static void  hub_governor_step(struct hub_governor_ctx *p_ctx);
+static void *hub_governor_thread_func(void *p_args);
+
+/**
+ * Read the hottest temperature and the total power of the latest sample.
+ *
+ * @param: p_ctx is the governor context
+ * @param: p_temp is filled with the temperature
+ * @param: p_power is filled with the power
+ *
+ * @return: true if a temperature was sampled
+ */
+static bool hub_governor_read_sensors(struct hub_governor_ctx *p_ctx,
+									  float                   *p_temp,
+									  float                   *p_power)
+{
+	struct hub_som_sensor_sample sample;
+	bool                         has_temp = false;
+	uint32_t                     i;
+
+	if (1 != hub_get_som_sensor_history((hub_handle_t)p_ctx->p_hub, &sample,
+										1)) {
+		return false;
+	}
+
+	*p_temp  = 0.0f;
+	*p_power = 0.0f;
+	for (i = 0; i < HUB_SOM_NUM_SENSORS; i++) {
+		if (sample.temperature_valid & (1U << i)) {
+			if (!has_temp || (sample.temperature[i] > *p_temp)) {
+				*p_temp = sample.temperature[i];
+			}
+			has_temp = true;
+		}
+		if (sample.energy_valid & (1U << i)) {
+			*p_power += sample.energy[i].power;
+		}
+	}
+
+	return has_temp;
+}
+
+/**
+ * Hold all the GARDs to a rate.
+ *
+ * @param: p_ctx is the governor context
+ * @param: mfps is the rate in images per 1000 s
+ */
+static void hub_governor_set_rate(struct hub_governor_ctx *p_ctx,
+								  uint32_t                 mfps)
+{
+	struct hub_ctx *p_hub = p_ctx->p_hub;
+	uint32_t        num_failures = 0;
+	uint32_t        i;
+
+	for (i = 0; i < p_hub->num_gards; i++) {
+		if (HUB_SUCCESS !=
+			hub_set_inference_rate((gard_handle_t)&p_hub->p_gards[i],
+								   HUB_INFERENCE_RATE_TARGET_FPS, mfps,
+								   NULL)) {
+			hub_pr_warn("GARD %u did not take the rate of %u images/1000 s\n",
+						i, mfps);
+			num_failures++;
+		}
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->state.num_set_failures += num_failures;
+	hub_mutex_unlock(&p_ctx->lock);
+}
+
+/**
+ * Give all the GARDs back the policy they had when the governor started.
+ *
+ * @param: p_ctx is the governor context
+ */
+static void hub_governor_restore(struct hub_governor_ctx *p_ctx)
+{
+	struct hub_ctx *p_hub = p_ctx->p_hub;
+	uint32_t        num_failures = 0;
+	uint32_t        i;
+
+	for (i = 0; i < p_hub->num_gards; i++) {
+		if (HUB_SUCCESS !=
+			hub_set_inference_rate((gard_handle_t)&p_hub->p_gards[i],
+								   p_ctx->p_gards[i].mode,
+								   p_ctx->p_gards[i].param, NULL)) {
+			hub_pr_warn("GARD %u did not take its inference rate back\n", i);
+			num_failures++;
+		}
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->state.num_set_failures += num_failures;
+	hub_mutex_unlock(&p_ctx->lock);
+}
+
+/**
+ * Take one step, looking at the latest sample.
+ *
+ * @param: p_ctx is the governor context
+ */
+static void hub_governor_step(struct hub_governor_ctx *p_ctx)
+{
+	const struct hub_governor_cfg *p_cfg = &p_ctx->cfg;
+	struct hub_inference_rate      rate;
+	struct hub_governor_state      state;
+	float                          temp, power;
+	bool                           is_hot, is_cool;
+	uint32_t                       mfps, delta;
+	uint32_t                       i;
+
+	if (!hub_governor_read_sensors(p_ctx, &temp, &power)) {
+		return;
+	}
+
+	is_hot  = (temp > p_cfg->temp_high_c) ||
+			  ((p_cfg->power_high_w > 0.0f) && (power > p_cfg->power_high_w));
+	is_cool = (temp < p_cfg->temp_low_c) &&
+			  ((p_cfg->power_high_w <= 0.0f) || (power < p_cfg->power_low_w));
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->state.temperature_c = temp;
+	p_ctx->state.power_w       = power;
+	state                      = p_ctx->state;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	if (is_hot) {
+		/* Start from what the GARDs run at, not from a rate they never do */
+		if (!state.is_throttled) {
+			state.target_mfps = 0;
+			for (i = 0; i < p_ctx->p_hub->num_gards; i++) {
+				if ((HUB_SUCCESS ==
+					 hub_get_inference_rate(
+						 (gard_handle_t)&p_ctx->p_hub->p_gards[i], &rate)) &&
+					(rate.run_mfps > state.target_mfps)) {
+					state.target_mfps = rate.run_mfps;
+				}
+			}
+			if ((0 == state.target_mfps) ||
+				(state.target_mfps > p_cfg->max_mfps)) {
+				state.target_mfps = p_cfg->max_mfps;
+			}
+		}
+
+		delta = (uint32_t)(((uint64_t)state.target_mfps *
+							p_cfg->step_percent) / 100U);
+		mfps  = (state.target_mfps > p_cfg->min_mfps + delta)
+					? state.target_mfps - delta
+					: p_cfg->min_mfps;
+		if (state.is_throttled && (mfps == state.target_mfps)) {
+			return;
+		}
+
+		hub_governor_set_rate(p_ctx, mfps);
+
+		hub_mutex_lock(&p_ctx->lock);
+		p_ctx->state.is_throttled = 1;
+		p_ctx->state.target_mfps  = mfps;
+		p_ctx->state.num_steps_down++;
+		hub_mutex_unlock(&p_ctx->lock);
+
+		hub_pr_dbg("SOM at %.1f C %.2f W, rate down to %u images/1000 s\n",
+				   temp, power, mfps);
+		return;
+	}
+
+	if (!is_cool || !state.is_throttled) {
+		return;
+	}
+
+	delta = (uint32_t)(((uint64_t)state.target_mfps * p_cfg->step_percent) /
+					   100U);
+	mfps  = state.target_mfps + (delta ? delta : 1U);
+	if (mfps >= p_cfg->max_mfps) {
+		hub_governor_restore(p_ctx);
+
+		hub_mutex_lock(&p_ctx->lock);
+		p_ctx->state.is_throttled = 0;
+		p_ctx->state.target_mfps  = 0;
+		p_ctx->state.num_steps_up++;
+		hub_mutex_unlock(&p_ctx->lock);
+
+		hub_pr_dbg("SOM at %.1f C %.2f W, throttling ended\n", temp, power);
+		return;
+	}
+
+	hub_governor_set_rate(p_ctx, mfps);
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->state.target_mfps = mfps;
+	p_ctx->state.num_steps_up++;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_pr_dbg("SOM at %.1f C %.2f W, rate up to %u images/1000 s\n", temp,
+			   power, mfps);
+}
+
+/**
+ * Governor thread.
+ *
+ * @param: p_args is the struct hub_governor_ctx
+ *
+ * @return: NULL
+ */
+static void *hub_governor_thread_func(void *p_args)
+{
+	struct hub_governor_ctx *p_ctx = (struct hub_governor_ctx *)p_args;
+	struct timespec          deadline;
+
+	hub_mutex_lock(&p_ctx->lock);
+	while (!p_ctx->terminate_flag) {
+		hub_deadline_from_now(&deadline, p_ctx->cfg.step_ms);
+		(void)hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+		if (p_ctx->terminate_flag) {
+			break;
+		}
+		hub_mutex_unlock(&p_ctx->lock);
+
+		hub_governor_step(p_ctx);
+
+		hub_mutex_lock(&p_ctx->lock);
+	}
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return NULL;
+}
+
+/**
+ * hub_governor_start starts the thermal and power governor of a HUB, see
+ * hub.h.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_cfg are the limits
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GOVERNOR on failure
+ */
+enum hub_ret_code hub_governor_start(hub_handle_t                   hub,
+									 const struct hub_governor_cfg *p_cfg)
+{
+	struct hub_ctx            *p_hub = (struct hub_ctx *)hub;
+	struct hub_governor_ctx   *p_ctx;
+	struct hub_inference_rate  rate;
+	uint32_t                   i;
+
+	if ((NULL == p_hub) || (NULL == p_cfg)) {
+		hub_pr_err("Invalid arguments\n");
+		goto err_governor_start_1;
+	}
+
+	if ((p_cfg->temp_low_c > p_cfg->temp_high_c) ||
+		((p_cfg->power_high_w > 0.0f) &&
+		 (p_cfg->power_low_w > p_cfg->power_high_w)) ||
+		(0 == p_cfg->min_mfps) || (p_cfg->min_mfps > p_cfg->max_mfps) ||
+		(0 == p_cfg->step_percent) || (p_cfg->step_percent >= 100) ||
+		(p_cfg->step_ms < HUB_GOVERNOR_MIN_STEP_MS)) {
+		hub_pr_err("Invalid governor limits\n");
+		goto err_governor_start_1;
+	}
+
+	if (NULL == p_hub->p_som_sampler_ctx) {
+		hub_pr_err("The governor needs the SOM sensor sampler to run\n");
+		goto err_governor_start_1;
+	}
+
+	if (NULL != p_hub->p_governor_ctx) {
+		hub_pr_err("Governor already runs\n");
+		goto err_governor_start_1;
+	}
+
+	p_ctx = (struct hub_governor_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate governor context\n");
+		goto err_governor_start_1;
+	}
+
+	p_ctx->p_hub   = p_hub;
+	p_ctx->cfg     = *p_cfg;
+	p_ctx->p_gards = (struct hub_governor_gard *)calloc(
+		p_hub->num_gards ? p_hub->num_gards : 1, sizeof(*p_ctx->p_gards));
+	if (NULL == p_ctx->p_gards) {
+		hub_pr_err("Failed to allocate GARD policies\n");
+		goto err_governor_start_2;
+	}
+
+	/* A GARD that cannot tell is given back every image */
+	for (i = 0; i < p_hub->num_gards; i++) {
+		if (HUB_SUCCESS ==
+			hub_get_inference_rate((gard_handle_t)&p_hub->p_gards[i], &rate)) {
+			p_ctx->p_gards[i].mode  = rate.mode;
+			p_ctx->p_gards[i].param = rate.param;
+		} else {
+			hub_pr_warn("GARD %u inference rate unknown, all frames assumed\n",
+						i);
+			p_ctx->p_gards[i].mode = HUB_INFERENCE_RATE_ALL_FRAMES;
+		}
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ctx->lock)) {
+		goto err_governor_start_3;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ctx->cond_var)) {
+		goto err_governor_start_4;
+	}
+
+	if (HUB_SUCCESS != hub_thread_create(&p_ctx->thread_hdl, NULL,
+										 HUB_THREAD_CLASS_BUS_IO,
+										 "hub_governor",
+										 hub_governor_thread_func, p_ctx)) {
+		hub_pr_err("Failed to create governor thread\n");
+		goto err_governor_start_5;
+	}
+
+	p_hub->p_governor_ctx = p_ctx;
+
+	return HUB_SUCCESS;
+
+err_governor_start_5:
+	hub_cond_var_destroy(&p_ctx->cond_var);
+err_governor_start_4:
+	hub_mutex_destroy(&p_ctx->lock);
+err_governor_start_3:
+	free(p_ctx->p_gards);
+err_governor_start_2:
+	free(p_ctx);
+err_governor_start_1:
+	return HUB_FAILURE_GOVERNOR;
+}
+
+/**
+ * hub_governor_stop stops the governor of a HUB, if running, and gives the
+ * GARDs back their policy.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GOVERNOR on failure
+ */
+enum hub_ret_code hub_governor_stop(hub_handle_t hub)
+{
+	struct hub_ctx          *p_hub = (struct hub_ctx *)hub;
+	struct hub_governor_ctx *p_ctx;
+	enum hub_ret_code        ret = HUB_SUCCESS;
+	uint32_t                 num_failures;
+
+	if (NULL == p_hub) {
+		hub_pr_err("Invalid HUB handle\n");
+		return HUB_FAILURE_GOVERNOR;
+	}
+
+	p_ctx = p_hub->p_governor_ctx;
+	if (NULL == p_ctx) {
+		return HUB_SUCCESS;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->terminate_flag = true;
+	hub_cond_var_signal(&p_ctx->cond_var);
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_thread_join(p_ctx->thread_hdl, NULL);
+
+	if (p_ctx->state.is_throttled) {
+		num_failures = p_ctx->state.num_set_failures;
+		hub_governor_restore(p_ctx);
+		if (num_failures != p_ctx->state.num_set_failures) {
+			ret = HUB_FAILURE_GOVERNOR;
+		}
+	}
+
+	hub_cond_var_destroy(&p_ctx->cond_var);
+	hub_mutex_destroy(&p_ctx->lock);
+	free(p_ctx->p_gards);
+	free(p_ctx);
+
+	p_hub->p_governor_ctx = NULL;
+
+	return ret;
+}
+
+/**
+ * hub_governor_get_state reads what the governor of a HUB does.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_state is filled with the state
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GOVERNOR on failure
+ */
+enum hub_ret_code hub_governor_get_state(hub_handle_t               hub,
+										 struct hub_governor_state *p_state)
+{
+	struct hub_ctx          *p_hub = (struct hub_ctx *)hub;
+	struct hub_governor_ctx *p_ctx;
+
+	if ((NULL == p_hub) || (NULL == p_state)) {
+		hub_pr_err("Invalid arguments\n");
+		return HUB_FAILURE_GOVERNOR;
+	}
+
+	p_ctx = p_hub->p_governor_ctx;
+	if (NULL == p_ctx) {
+		return HUB_FAILURE_GOVERNOR;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	*p_state = p_ctx->state;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return HUB_SUCCESS;
+}
@@ -0,0 +1,35 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_GOVERNOR_H__
+#define __HUB_GOVERNOR_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+/* Fewest ms between two steps of the governor */
+#define HUB_GOVERNOR_MIN_STEP_MS (100)
+
+/* Policy a GARD had before the governor throttled it */
+struct hub_governor_gard {
+	enum hub_inference_rate_mode mode;
+	uint32_t                     param;
+};
+
+struct hub_governor_ctx {
+	struct hub_ctx           *p_hub;
+	struct hub_governor_cfg   cfg;
+	struct hub_governor_gard *p_gards;
+	struct hub_governor_state state; /* Under lock */
+	hub_mutex_t               lock;
+	hub_cond_var_t            cond_var;
+	bool                      terminate_flag;
+	hub_thread_hdl_t          thread_hdl;
+};
+
+#endif /* __HUB_GOVERNOR_H__ */
@@ -5,53 +5,358 @@
  *
  ******************************************************************************/
 
+#include <poll.h>
+
 #include "hub_gpio.h"
 #include "hub_threading.h"
+#include "hub_gpio_reactor.h"
+#include "hub_recorder.h"
+#include "hub_shm_ring.h"
 
 /* Static functions listing */
-static inline void gpiod_line_bulk_remove(struct gpiod_line_bulk *bulk,
-										  int                     num_line);
-static void       *hub_gpio_worker_thread_func(void *hub_worker_params);
-static int64_t
-	hub_get_appdata_on_event(gard_handle_t              p_gard_handle,
-							 struct hub_gpio_event_ctx *p_hub_gpio_event_ctx,
-							 void                      *buffer,
-							 uint32_t                   size);
+static void *hub_gpio_worker_thread_func(void *hub_worker_params);
+static int hub_gpio_ring_get_free_buffer(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx);
+static void hub_gpio_ring_hand_over_buffer(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx);
+static void
+	hub_gpio_queue_event(struct hub_gpio_event_ctx         *p_hub_gpio_event_ctx,
+						 const struct hub_gpiod_edge_event *p_event,
+						 uint64_t                           wake_ns);
+static enum hub_ret_code
+	hub_gpio_mon_bulk_update(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx,
+							 unsigned int             line_offset,
+							 bool                     add);
+static int64_t hub_get_appdata_on_event(
+	gard_handle_t                   p_gard_handle,
+	struct hub_gpio_event_ctx      *p_hub_gpio_event_ctx,
+	void                           *buffer,
+	uint32_t                        size,
+	bool                            batch,
+	struct hub_appdata_event_times *p_times);
+
+/**
+ * hub_gpio_mon_bulk_update adds a line to / removes a line from the set of
+ * lines monitored by the monitor thread.
+ *
+ * The monitor thread keeps its lines requested across events and only
+ * re-requests them when it sees mon_bulk_gen change.
+ *
+ * @param p_hub_gpio_mon_ctx The GPIO monitor context.
+ * @param line_offset The offset of the line to add or remove.
+ * @param add true to add the line, false to remove it.
+ *
+ * @return HUB_SUCCESS on success
+ *		   HUB_FAILURE_SETUP_APPDATA_CB if the monitored set is full
+ */
+static enum hub_ret_code
+	hub_gpio_mon_bulk_update(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx,
+							 unsigned int             line_offset,
+							 bool                     add)
+{
+	enum hub_ret_code ret = HUB_SUCCESS;
+	uint32_t          i;
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
+
+	if (add) {
+		if (p_hub_gpio_mon_ctx->num_mon_lines < HUB_GPIOD_MAX_LINES) {
+			p_hub_gpio_mon_ctx
+				->mon_offsets[p_hub_gpio_mon_ctx->num_mon_lines++] =
+				line_offset;
+			p_hub_gpio_mon_ctx->mon_bulk_gen++;
+		} else {
+			ret = HUB_FAILURE_SETUP_APPDATA_CB;
+		}
+	} else {
+		/* Shift subsequent offsets to fill the gap */
+		for (i = 0; i < p_hub_gpio_mon_ctx->num_mon_lines; i++) {
+			if (p_hub_gpio_mon_ctx->mon_offsets[i] == line_offset) {
+				for (; i + 1 < p_hub_gpio_mon_ctx->num_mon_lines; i++) {
+					p_hub_gpio_mon_ctx->mon_offsets[i] =
+						p_hub_gpio_mon_ctx->mon_offsets[i + 1];
+				}
+				p_hub_gpio_mon_ctx->num_mon_lines--;
+				p_hub_gpio_mon_ctx->mon_bulk_gen++;
+				break;
+			}
+		}
+	}
+
+	hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+
+	return ret;
+}
+
+/**
+ * hub_gpio_queue_event counts a rising edge as pending for the worker of
+ * its line, along with its timestamps. Must be called with event_mutex held.
+ *
+ * @param p_hub_gpio_event_ctx The GPIO event context of the line.
+ * @param p_event The event read from the line.
+ * @param wake_ns When the monitor woke up for the event.
+ */
+static void
+	hub_gpio_queue_event(struct hub_gpio_event_ctx         *p_hub_gpio_event_ctx,
+						 const struct hub_gpiod_edge_event *p_event,
+						 uint64_t                           wake_ns)
+{
+	struct hub_gpio_event_stats *p_stats = &p_hub_gpio_event_ctx->stats;
+	uint32_t                     tail;
+
+	p_stats->events++;
+	p_stats->last_event_ns = p_event->ts_ns;
+
+	if (p_hub_gpio_event_ctx->pending_events >= HUB_GPIO_MAX_PENDING_EVENTS) {
+		p_stats->dropped++;
+		return;
+	}
+
+	if (p_hub_gpio_event_ctx->pending_events) {
+		p_stats->coalesced++;
+	}
+
+	tail = (p_hub_gpio_event_ctx->pending_head +
+			p_hub_gpio_event_ctx->pending_events) %
+		   HUB_GPIO_MAX_PENDING_EVENTS;
+	p_hub_gpio_event_ctx->pending_edge_ns[tail] = p_stats->last_event_ns;
+	p_hub_gpio_event_ctx->pending_wake_ns[tail] = wake_ns;
+	p_hub_gpio_event_ctx->pending_events++;
+}
+
+/**
+ * hub_gpio_ring_get_free_buffer waits until the next buffer of an appdata
+ * ring is not held by the app, and makes it the buffer to fill.
+ *
+ * @param p_hub_gpio_worker_ctx The worker context owning the ring.
+ *
+ * @return 0 with the buffer set up, -1 if HUB is shutting down
+ */
+static int hub_gpio_ring_get_free_buffer(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx)
+{
+	struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx =
+		p_hub_gpio_worker_ctx->p_hub_gpio_mon_ctx;
+	uint32_t next = p_hub_gpio_worker_ctx->next_buffer;
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_worker_ctx->ring_mutex);
+	while (p_hub_gpio_worker_ctx->is_held[next] &&
+		   !p_hub_gpio_mon_ctx->terminate_flag) {
+		hub_cond_var_wait(&p_hub_gpio_worker_ctx->ring_cond_var,
+						  &p_hub_gpio_worker_ctx->ring_mutex);
+	}
+	hub_mutex_unlock(&p_hub_gpio_worker_ctx->ring_mutex);
+
+	if (p_hub_gpio_mon_ctx->terminate_flag) {
+		return -1;
+	}
+
+	p_hub_gpio_worker_ctx->buffer = p_hub_gpio_worker_ctx->p_buffers[next];
+
+	return 0;
+}
 
 /**
- * gpiod_line_bulk_remove is a helper function to remove a
- * line from a gpiod_line_bulk.
- * This is a utility to aid in error handling during setup.
+ * hub_gpio_ring_hand_over_buffer marks the filled buffer of an appdata ring
+ * as held by the app and moves on to the next one.
  *
- * @param bulk The bulk object to modify.
- * @param num_line The offset of the line to remove.
+ * @param p_hub_gpio_worker_ctx The worker context owning the ring.
  */
-static inline void gpiod_line_bulk_remove(struct gpiod_line_bulk *bulk,
-										  int                     num_line)
+static void hub_gpio_ring_hand_over_buffer(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx)
 {
-	int i, found_idx = -1;
+	uint32_t next = p_hub_gpio_worker_ctx->next_buffer;
 
-	/* Find the index of the line to remove */
-	for (i = 0; i < bulk->num_lines; i++) {
-		if (gpiod_line_offset(bulk->lines[i]) == num_line) {
-			found_idx = i;
+	hub_mutex_lock(&p_hub_gpio_worker_ctx->ring_mutex);
+	p_hub_gpio_worker_ctx->is_held[next] = true;
+	hub_mutex_unlock(&p_hub_gpio_worker_ctx->ring_mutex);
+
+	p_hub_gpio_worker_ctx->next_buffer =
+		(next + 1) % p_hub_gpio_worker_ctx->num_buffers;
+}
+
+/**
+ * hub_gpio_deliver_batch publishes, see hub_shm_ring.c, and calls the user
+ * callback once per record of a batch received with
+ * hub_recv_app_data_batch_from_gard(), oldest first. Each result is moved to
+ * the start of the buffer before its callback, so that callbacks see the
+ * same buffer as without batching.
+ *
+ * @param: p_hub_gpio_worker_ctx is the worker context of the line
+ * @param: batch_size is the size of the records received
+ * @param: p_cb_start_ns / p_cb_end_ns are set to bound all the callbacks
+ */
+static void
+	hub_gpio_deliver_batch(struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx,
+						   uint32_t                    batch_size,
+						   uint64_t                   *p_cb_start_ns,
+						   uint64_t                   *p_cb_end_ns)
+{
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx;
+	struct hub_gard_info      *p_gard;
+	uint8_t                   *p_buffer;
+	uint32_t                   offset = 0;
+	uint32_t                   record_size;
+	enum hub_ret_code          user_cb_ret;
+	uint64_t                   start_ns;
+
+	p_hub_gpio_event_ctx = p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx;
+	p_gard   = (struct hub_gard_info *)p_hub_gpio_worker_ctx->p_gard_handle;
+	p_buffer = (uint8_t *)p_hub_gpio_worker_ctx->buffer;
+
+	*p_cb_start_ns = hub_stats_now_ns();
+	while (offset + sizeof(record_size) <= batch_size) {
+		memcpy(&record_size, p_buffer + offset, sizeof(record_size));
+		offset += sizeof(record_size);
+		if (record_size > batch_size - offset) {
+			hub_pr_err("Bad app data record of %u bytes at %u of %u\n",
+					   record_size, offset, batch_size);
 			break;
 		}
+
+		/* Records before this one have been handed out already */
+		memmove(p_buffer, p_buffer + offset, record_size);
+		offset   += record_size;
+
+		hub_shm_ring_publish_appdata(p_gard, p_buffer, record_size);
+		hub_recorder_write_appdata(p_gard, p_buffer, record_size);
+		if (NULL == p_hub_gpio_event_ctx->user_cb) {
+			continue;
+		}
+
+		start_ns    = hub_stats_now_ns();
+		user_cb_ret = (enum hub_ret_code)p_hub_gpio_event_ctx->user_cb(
+			p_hub_gpio_event_ctx->p_user_cb_ctx, p_buffer, record_size);
+		hub_stats_record(p_gard, HUB_STATS_OP_APPDATA_CB, start_ns,
+						 record_size, HUB_SUCCESS != user_cb_ret);
 	}
+	*p_cb_end_ns = hub_stats_now_ns();
+}
 
-	/* If the line was found, shift subsequent lines to fill the gap */
-	if (found_idx != -1) {
-		for (i = found_idx; i < bulk->num_lines - 1; i++) {
-			bulk->lines[i] = bulk->lines[i + 1];
+/**
+ * hub_gpio_handle_one_event takes one pending GPIO event of a line set up
+ * with hub_setup_appdata_cb() / hub_setup_appdata_ring_cb(), fetches the app
+ * data from GARD and calls the user callback with it.
+ *
+ * Without a ring, on a bus with app_data_batch, all results queued in GARD
+ * are taken at once and the callback is called for each. An event finding
+ * none queued (taken with an earlier one) is then not an error.
+ *
+ * Waits for an event if none is pending. Used by the per-line worker threads
+ * and by the worker pool of the reactor execution model.
+ *
+ * @param: p_hub_gpio_worker_ctx is the worker context of the line
+ *
+ * @return: false if HUB is shutting down, true otherwise
+ */
+bool hub_gpio_handle_one_event(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx)
+{
+	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = NULL;
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+	struct hub_gard_info      *p_gard               = NULL;
+	struct hub_ctx            *p_hub                = NULL;
+	int64_t                    ret;
+	enum hub_ret_code          user_cb_ret;
+	uint64_t                   cb_start_ns          = 0;
+	uint64_t                   cb_end_ns            = 0;
+	bool                       batch;
+
+	struct hub_appdata_event_times times = {0};
+
+	p_hub_gpio_mon_ctx   = p_hub_gpio_worker_ctx->p_hub_gpio_mon_ctx;
+	p_hub_gpio_event_ctx = p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx;
+	p_gard = (struct hub_gard_info *)p_hub_gpio_worker_ctx->p_gard_handle;
+	p_hub  = (struct hub_ctx *)p_gard->hub;
+
+	/* With a ring, fill the next buffer once the app has released it */
+	if (p_hub_gpio_worker_ctx->is_ring &&
+		hub_gpio_ring_get_free_buffer(p_hub_gpio_worker_ctx)) {
+		return false;
+	}
+
+	/* Rings hand out whole buffers, so they take one result per event */
+	batch = !p_hub_gpio_worker_ctx->is_ring && p_gard->cmd_bus->app_data_batch;
+
+	ret = hub_get_appdata_on_event(
+		p_hub_gpio_worker_ctx->p_gard_handle, p_hub_gpio_event_ctx,
+		p_hub_gpio_worker_ctx->buffer, p_hub_gpio_worker_ctx->size, batch,
+		&times);
+
+	if (p_hub_gpio_mon_ctx->terminate_flag) {
+		return false;
+	}
+
+	if (batch && (ret >= 0)) {
+		if ((ret > 0) && p_hub_gpio_event_ctx->event_callback_setup) {
+			hub_gpio_deliver_batch(p_hub_gpio_worker_ctx, (uint32_t)ret,
+								   &cb_start_ns, &cb_end_ns);
 		}
-		bulk->num_lines--;
-		/**
-		 * TBD-SSP:
-		 * Null out the last element to avoid dangling pointers
-		 * if not managed carefully elsewhere
-		 * bulk->lines[bulk->num_lines] = NULL;
-		 */
+
+		hub_trace_record(&p_hub_gpio_mon_ctx->trace,
+						 (uint32_t)(p_gard - p_hub->p_gards),
+						 p_hub_gpio_event_ctx->gpio_pin, &times, cb_start_ns,
+						 cb_end_ns);
+
+		return true;
+	}
+
+	if (ret <= 0) {
+		hub_pr_err("Failed to monitor and receive streaming app data from "
+				   "GARD: %ld\n",
+				   ret);
 	}
+
+	/* Handle occured event now */
+	if (p_hub_gpio_event_ctx->event_callback_setup) {
+		if (ret <= 0) {
+			/**
+			 * NOTE : Call user callback with 0 size to indicate error
+			 */
+			cb_start_ns = hub_stats_now_ns();
+			user_cb_ret = (enum hub_ret_code)p_hub_gpio_event_ctx->user_cb(
+				p_hub_gpio_event_ctx->p_user_cb_ctx,
+				p_hub_gpio_worker_ctx->buffer, 0);
+			cb_end_ns   = hub_stats_now_ns();
+			hub_stats_record(p_gard, HUB_STATS_OP_APPDATA_CB, cb_start_ns, 0,
+							 HUB_SUCCESS != user_cb_ret);
+		} else {
+			hub_shm_ring_publish_appdata(p_gard, p_hub_gpio_worker_ctx->buffer,
+										 (uint32_t)ret);
+			hub_recorder_write_appdata(p_gard, p_hub_gpio_worker_ctx->buffer,
+									   (uint32_t)ret);
+
+			if (p_hub_gpio_worker_ctx->is_ring) {
+				/* The app holds this buffer until it releases it */
+				hub_gpio_ring_hand_over_buffer(p_hub_gpio_worker_ctx);
+			}
+
+			if (p_hub_gpio_event_ctx->user_cb) {
+				/* Call the user callback function with actual data size */
+				cb_start_ns = hub_stats_now_ns();
+				user_cb_ret = (enum hub_ret_code)p_hub_gpio_event_ctx->user_cb(
+					p_hub_gpio_event_ctx->p_user_cb_ctx,
+					p_hub_gpio_worker_ctx->buffer, (uint32_t)ret);
+				cb_end_ns   = hub_stats_now_ns();
+				hub_stats_record(p_gard, HUB_STATS_OP_APPDATA_CB, cb_start_ns,
+								 (uint64_t)ret, HUB_SUCCESS != user_cb_ret);
+			}
+		}
+	} else {
+		/* callback function is not setup, ignore the event */
+		hub_pr_dbg("User callback not setup. Ignoring events on GPIO %d.\n",
+				   p_hub_gpio_event_ctx->gpio_pin);
+		p_hub_gpio_event_ctx->event_callback_setup = false;
+	}
+
+	hub_trace_record(&p_hub_gpio_mon_ctx->trace,
+					 (uint32_t)(p_gard - p_hub->p_gards),
+					 p_hub_gpio_event_ctx->gpio_pin, &times, cb_start_ns,
+					 cb_end_ns);
+
+	return true;
 }
 
 /**
@@ -69,65 +374,17 @@ static inline void gpiod_line_bulk_remove(struct gpiod_line_bulk *bulk,
 static void *hub_gpio_worker_thread_func(void *hub_worker_params)
 {
 	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx = NULL;
-	struct hub_gpio_mon_ctx    *p_hub_gpio_mon_ctx    = NULL;
-	struct hub_gpio_event_ctx  *p_hub_gpio_event_ctx  = NULL;
-	int64_t                     ret;
-	enum hub_ret_code           user_cb_ret;
 
 	p_hub_gpio_worker_ctx = (struct hub_gpio_worker_ctx *)hub_worker_params;
 
-	p_hub_gpio_mon_ctx    = p_hub_gpio_worker_ctx->p_hub_gpio_mon_ctx;
-	p_hub_gpio_event_ctx  = p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx;
-
 	hub_pr_dbg("Starting worker thread for GPIO %d.\n",
-			   p_hub_gpio_event_ctx->gpio_pin);
-
-	while (1) {
-		ret = hub_get_appdata_on_event(
-			p_hub_gpio_worker_ctx->p_gard_handle, p_hub_gpio_event_ctx,
-			p_hub_gpio_worker_ctx->buffer, p_hub_gpio_worker_ctx->size);
-
-		if (p_hub_gpio_mon_ctx->terminate_flag) {
-			break;
-		}
+			   p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx->gpio_pin);
 
-		if (ret <= 0) {
-			hub_pr_err("Failed to monitor and receive streaming app data from "
-					   "GARD: %ld\n",
-					   ret);
-		}
-
-		/* Handle occured event now */
-		if (p_hub_gpio_event_ctx->event_callback_setup) {
-			if (ret <= 0) {
-				/**
-				 * NOTE : Call user callback with 0 size to indicate error
-				 */
-				user_cb_ret = (enum hub_ret_code)p_hub_gpio_event_ctx->user_cb(
-					p_hub_gpio_event_ctx->p_user_cb_ctx,
-					p_hub_gpio_worker_ctx->buffer, 0);
-				(void)user_cb_ret;
-			} else {
-				if (p_hub_gpio_event_ctx->user_cb) {
-					/* Call the user callback function with actual data size */
-					user_cb_ret =
-						(enum hub_ret_code)p_hub_gpio_event_ctx->user_cb(
-							p_hub_gpio_event_ctx->p_user_cb_ctx,
-							p_hub_gpio_worker_ctx->buffer,
-							(uint32_t)ret);
-					(void)user_cb_ret;
-				}
-			}
-		} else {
-			/* callback function is not setup, ignore the event */
-			hub_pr_dbg("User callback not setup. Ignoring events on GPIO %d.\n",
-					   p_hub_gpio_event_ctx->gpio_pin);
-			p_hub_gpio_event_ctx->event_callback_setup = false;
-		}
+	while (hub_gpio_handle_one_event(p_hub_gpio_worker_ctx)) {
 	}
 
 	hub_pr_dbg("Shutting down worker thread of GPIO %d.\n",
-			   p_hub_gpio_event_ctx->gpio_pin);
+			   p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx->gpio_pin);
 
 	return NULL;
 }
@@ -140,17 +397,25 @@ static void *hub_gpio_worker_thread_func(void *hub_worker_params)
  * @param: p_hub_gpio_event_ctx is the GPIO event context pointer
  * @param: buffer is a user-allocated buffer of the proper size
  * @param: size is the number of bytes to fetch from the GARD FW
+ * @param: batch fetches all results queued in GARD FW as records, see
+ * hub_recv_app_data_batch_from_gard()
+ * @param: p_times is filled with the timestamps of the event; they are also
+ * kept as the last_times of the line, for hub_get_appdata_event_times()
  *
  * @return: HUB_SUCCESS on success
  * 			HUB_FAILURE_* on failure
  */
-static int64_t
-	hub_get_appdata_on_event(gard_handle_t              p_gard_handle,
-							 struct hub_gpio_event_ctx *p_hub_gpio_event_ctx,
-							 void                      *buffer,
-							 uint32_t                   size)
+static int64_t hub_get_appdata_on_event(
+	gard_handle_t                   p_gard_handle,
+	struct hub_gpio_event_ctx      *p_hub_gpio_event_ctx,
+	void                           *buffer,
+	uint32_t                        size,
+	bool                            batch,
+	struct hub_appdata_event_times *p_times)
 {
 	enum hub_ret_code        ret;
+	int64_t                  received_size;
+	uint32_t                 head;
 	struct hub_ctx          *p_hub              = NULL;
 	struct hub_gard_info    *p_gard             = NULL;
 	struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx = NULL;
@@ -163,10 +428,31 @@ static int64_t
 	hub_pr_dbg("Waiting for event in worker thread on GPIO %d.\n",
 			   p_hub_gpio_event_ctx->gpio_pin);
 
-	/* TBD-SSP: handle locking failures */
+	/**
+	 * Take one pending event, waiting for the monitor thread if there is
+	 * none. Events that came while we were busy with the previous one are
+	 * already counted in pending_events.
+	 *
+	 * TBD-SSP: handle locking failures
+	 */
+	ret = HUB_SUCCESS;
 	hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
-	ret = hub_cond_var_wait(&p_hub_gpio_event_ctx->event_cond_var,
-							&p_hub_gpio_event_ctx->event_mutex);
+	while (!p_hub_gpio_event_ctx->pending_events &&
+		   !p_hub_gpio_mon_ctx->terminate_flag && (HUB_SUCCESS == ret)) {
+		ret = hub_cond_var_wait(&p_hub_gpio_event_ctx->event_cond_var,
+								&p_hub_gpio_event_ctx->event_mutex);
+	}
+	if ((HUB_SUCCESS == ret) && p_hub_gpio_event_ctx->pending_events) {
+		head                     = p_hub_gpio_event_ctx->pending_head;
+		p_times->edge_ns         = p_hub_gpio_event_ctx->pending_edge_ns[head];
+		p_times->monitor_wake_ns = p_hub_gpio_event_ctx->pending_wake_ns[head];
+		p_times->worker_wake_ns  = hub_stats_now_ns();
+
+		p_hub_gpio_event_ctx->pending_head =
+			(head + 1) % HUB_GPIO_MAX_PENDING_EVENTS;
+		p_hub_gpio_event_ctx->pending_events--;
+		p_hub_gpio_event_ctx->stats.delivered++;
+	}
 	hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
 
 	if (HUB_SUCCESS != ret) {
@@ -181,9 +467,7 @@ static int64_t
 
 	hub_pr_dbg("Event - GPIO : %d, Type : %s edge\n",
 			   p_hub_gpio_event_ctx->gpio_pin,
-			   p_hub_gpio_event_ctx->event_type == GPIOD_LINE_EVENT_RISING_EDGE
-				   ? "rising"
-				   : "falling");
+			   p_hub_gpio_event_ctx->rising_edge ? "rising" : "falling");
 
 	hub_pr_dbg("Gathering data from GARD.\n");
 
@@ -194,15 +478,165 @@ static int64_t
 	 * hub_recv_app_data_from_gard() returns the actual data size received.
 	 * Returns data_size (> 0) on success, or error code (< 0) on failure.
 	 */
-	int64_t received_size = hub_recv_app_data_from_gard(
-		p_gard_handle, buffer,
-		0xDEADBEEF, /* give random address, GARD doesn't care */
-		size);
+	p_times->xfer_start_ns = hub_stats_now_ns();
+	if (batch) {
+		received_size =
+			hub_recv_app_data_batch_from_gard(p_gard_handle, buffer, size);
+	} else {
+		received_size = hub_recv_app_data_from_gard(
+			p_gard_handle, buffer,
+			0xDEADBEEF, /* give random address, GARD doesn't care */
+			size);
+	}
+	p_times->xfer_end_ns = hub_stats_now_ns();
+
+	hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
+	p_hub_gpio_event_ctx->last_times = *p_times;
+	hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
 
 	/* Return the data size directly (positive on success, negative on failure) */
 	return received_size;
 }
 
+/**
+ * hub_gpio_dispatch_event hands an event read from a monitored GPIO line to
+ * whoever handles app data on that line.
+ *
+ * Rising edges are counted as pending for the line and its waiter is
+ * signalled. In the reactor execution model the line is also put on the
+ * run queue of the worker pool.
+ *
+ * @param: p_hub is the HUB context
+ * @param: p_event is the edge event read from the line
+ * @param: wake_ns is when the monitor woke up for the event
+ */
+void hub_gpio_dispatch_event(struct hub_ctx                    *p_hub,
+							 const struct hub_gpiod_edge_event *p_event,
+							 uint64_t                           wake_ns)
+{
+	enum hub_ret_code          ret;
+	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = p_hub->p_gpio_mon_ctx;
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+	unsigned int               line_offset          = p_event->offset;
+
+	if (line_offset >= p_hub_gpio_mon_ctx->num_chip_lines) {
+		/* should never reach here, if reached it's corruption */
+		hub_pr_err("Received event for unused line offset %u\n", line_offset);
+		return;
+	}
+
+	p_hub_gpio_event_ctx = &p_hub->p_gpio_event_ctx[line_offset];
+	if (!p_hub_gpio_event_ctx->in_use) {
+		hub_pr_dbg("Received event for line offset %u which is not in use\n",
+				   line_offset);
+		return;
+	}
+
+	hub_pr_dbg("Invoking worker of GPIO %u, %s edge.\n", line_offset,
+			   p_event->rising ? "rising" : "falling");
+	p_hub_gpio_event_ctx->rising_edge = p_event->rising;
+
+	/* Signal only for rising edges per usecase */
+	if (!p_event->rising) {
+		return;
+	}
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
+
+	hub_gpio_queue_event(p_hub_gpio_event_ctx, p_event, wake_ns);
+
+	if ((HUB_GPIO_EXEC_REACTOR == p_hub_gpio_mon_ctx->exec_model) &&
+		(NULL != p_hub_gpio_event_ctx->p_worker_ctx)) {
+		hub_gpio_pool_schedule(p_hub_gpio_mon_ctx, p_hub_gpio_event_ctx);
+	}
+
+	ret = hub_cond_var_signal(&p_hub_gpio_event_ctx->event_cond_var);
+	if (HUB_SUCCESS != ret) {
+		hub_pr_err("Failed to signal event_cond_var: %d\n", ret);
+		/* TBD-SSP: decide what to do here */
+	}
+
+	hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
+}
+
+/**
+ * hub_gpio_mon_wake wakes the GPIO monitor / reactor thread, e.g. after the
+ * set of monitored lines has changed or on shutdown.
+ *
+ * @param: p_hub_gpio_mon_ctx is the GPIO monitor context
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CONDVAR_SIGNAL on failure
+ */
+enum hub_ret_code
+	hub_gpio_mon_wake(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx)
+{
+	enum hub_ret_code ret;
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
+	ret = hub_cond_var_signal(&p_hub_gpio_mon_ctx->mon_cond_var);
+	hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+
+	/* While lines are monitored, the thread sleeps in poll() / epoll_wait() */
+	if (p_hub_gpio_mon_ctx->wake_fd >= 0) {
+		hub_wake_fd_signal(p_hub_gpio_mon_ctx->wake_fd);
+	}
+
+	return ret;
+}
+
+/**
+ * Wait with no timeout for events on the requested lines or for a wakeup
+ * through wake_fd, with the wake fd added to the poll set so that the
+ * monitor does not have to time out to notice changes of the monitored set
+ * or shutdown.
+ *
+ * @param: p_req are the lines requested for events
+ * @param: wake_fd is the wake fd of the monitor, see hub_gpio_mon_wake()
+ * @param: p_ready is filled with the indexes of the event fds having events,
+ * see hub_gpiod_get_fds()
+ *
+ * @return: >0 number of event fds with events
+ *			0 when only woken through wake_fd
+ *			<0 on error, errno is set
+ */
+static int hub_gpio_mon_wait_bulk(struct hub_gpiod_request *p_req,
+								  int                       wake_fd,
+								  unsigned int             *p_ready)
+{
+	struct pollfd pfds[HUB_GPIOD_MAX_LINES + 1];
+	int           fds[HUB_GPIOD_MAX_LINES];
+	unsigned int  i, num_fds, num_ready = 0;
+	int           ret;
+
+	num_fds = hub_gpiod_get_fds(p_req, fds, HUB_GPIOD_MAX_LINES);
+	for (i = 0; i < num_fds; i++) {
+		pfds[i].fd     = fds[i];
+		pfds[i].events = POLLIN | POLLPRI;
+	}
+	pfds[num_fds].fd     = wake_fd;
+	pfds[num_fds].events = POLLIN;
+
+	ret = poll(pfds, num_fds + 1, -1);
+	if (ret <= 0) {
+		return ((ret < 0) && (EINTR == errno)) ? 0 : ret;
+	}
+
+	if (pfds[num_fds].revents & POLLIN) {
+		hub_wake_fd_drain(wake_fd);
+	}
+
+	for (i = 0; i < num_fds; i++) {
+		if (pfds[i].revents) {
+			p_ready[num_ready++] = i;
+		}
+	}
+
+	return (int)num_ready;
+}
+
 /******************************************************************************
  * Publicly exposed functions
  ******************************************************************************/
@@ -220,15 +654,16 @@ static int64_t
  */
 void *hub_gpio_monitor_thread_func(void *hub_mon_params)
 {
-	int                        ret, i, line_offset;
-	unsigned int               num_events;
-	struct gpiod_line_event    event;
-	struct gpiod_line_bulk     event_bulk;
-	struct gpiod_line         *line                 = NULL;
+	int                         ret, i, j, num_events;
+	unsigned int                ready[HUB_GPIOD_MAX_LINES];
+	struct hub_gpiod_edge_event events[HUB_GPIOD_MAX_EVENTS];
+	struct hub_gpiod_request    req;
+	uint32_t                    req_bulk_gen    = 0;
+	uint64_t                    wake_ns;
+	bool                        lines_requested = false;
 
-	struct hub_ctx            *p_hub                = NULL;
-	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = NULL;
-	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+	struct hub_ctx          *p_hub              = NULL;
+	struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx = NULL;
 
 	p_hub              = (struct hub_ctx *)hub_mon_params;
 
@@ -241,15 +676,24 @@ void *hub_gpio_monitor_thread_func(void *hub_mon_params)
 			break;
 		}
 
-		if (!p_hub_gpio_mon_ctx->mon_bulk.num_lines) {
+		if (!p_hub_gpio_mon_ctx->num_mon_lines) {
 			/* waiting for app to set up monitoring on some GPIO lines */
 			/* TBD-SSP: handle locking failures */
 			hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
 			hub_pr_info("Waiting for monitoring getting enabled via callback "
 						"setup function.\n");
 
-			ret = hub_cond_var_wait(&p_hub_gpio_mon_ctx->mon_cond_var,
-									&p_hub_gpio_mon_ctx->mon_mutex);
+			/**
+			 * Re-check under mon_mutex: hub_gpio_mon_wake() signals with it
+			 * held, so a setup or shutdown racing with us is not missed.
+			 */
+			ret = HUB_SUCCESS;
+			while (!p_hub_gpio_mon_ctx->num_mon_lines &&
+				   !p_hub_gpio_mon_ctx->terminate_flag &&
+				   (HUB_SUCCESS == ret)) {
+				ret = hub_cond_var_wait(&p_hub_gpio_mon_ctx->mon_cond_var,
+										&p_hub_gpio_mon_ctx->mon_mutex);
+			}
 
 			hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
 			if (HUB_SUCCESS != ret) {
@@ -266,49 +710,60 @@ void *hub_gpio_monitor_thread_func(void *hub_mon_params)
 
 			continue;
 		}
-		/* no error checks required */
-		gpiod_line_bulk_init(&event_bulk);
-
 		/**
-		 * Release previously requested events. This is required as
-		 * gpiod_line_request_bulk() fails if any lines used in mon_bulk
-		 * are not free.
+		 * (Re-)request events only when the monitored set has changed since
+		 * the last request. The lines stay requested across waits, so that
+		 * edges arriving between two waits are queued by the kernel rather
+		 * than lost.
 		 *
-		 * TBD-SSP: Need to handle setup appdata where mon bulk is changed in
-		 * real time. So request the changes as required for falling / rising
-		 * edge. Compare old and new bulks, release bulk and request again.
+		 * The request fails if any lines of mon_offsets are not free, so the
+		 * previously requested set is released first.
 		 */
-		gpiod_line_release_bulk(&p_hub_gpio_mon_ctx->mon_bulk);
+		hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
+		if (!lines_requested ||
+			(req_bulk_gen != p_hub_gpio_mon_ctx->mon_bulk_gen)) {
+			if (lines_requested) {
+				hub_gpiod_release(&req);
+				lines_requested = false;
+			}
 
-		/**
-		 * Monitors events of rising and falling edge on mon_bulk
-		 * TBD-SSP:
-		 * Currently monitor thread is raising for rising edge only. In
-		 * future, it's worker thread's responsibility to filter out and act
-		 * on the required event type.
-		 */
-		ret = gpiod_line_request_bulk_both_edges_events(
-			&p_hub_gpio_mon_ctx->mon_bulk, HUB_GPIO_MONITOR_STRING);
-		if (ret < 0) {
-			hub_pr_err("Failed to request events on monitoring lines : %s\n",
-					   strerror(errno));
-			break;
+			req_bulk_gen = p_hub_gpio_mon_ctx->mon_bulk_gen;
+
+			/**
+			 * Monitors events of rising and falling edge on mon_offsets
+			 * TBD-SSP:
+			 * Currently monitor thread is raising for rising edge only. In
+			 * future, it's worker thread's responsibility to filter out and
+			 * act on the required event type.
+			 */
+			ret = hub_gpiod_request_edges(p_hub_gpio_mon_ctx->p_chip,
+										  p_hub_gpio_mon_ctx->mon_offsets,
+										  p_hub_gpio_mon_ctx->num_mon_lines,
+										  &req);
+			if (ret < 0) {
+				hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+				hub_pr_err(
+					"Failed to request events on monitoring lines : %s\n",
+					strerror(errno));
+				break;
+			}
+			lines_requested = true;
 		}
+		hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
 
 		/**
-		 * Monitoring wait for event to occur on any of the lines in mon_bulk
-		 * with a timeout of 5 seconds.
+		 * Monitoring wait for event to occur on any of the requested lines,
+		 * with no timeout.
 		 * Return Codes :
-		 * 0 - timeout
-		 * >0 - number of lines with events
+		 * 0 - woken by hub_gpio_mon_wake()
+		 * >0 - number of event fds with events
 		 * <0 - error
-		 * ERRNO is updated by gpiod_line_event_wait_bulk()
+		 * ERRNO is updated by poll()
 		 */
-		ret = gpiod_line_event_wait_bulk(&p_hub_gpio_mon_ctx->mon_bulk,
-										 &p_hub_gpio_mon_ctx->mon_timeout,
-										 &event_bulk);
+		ret = hub_gpio_mon_wait_bulk(&req, p_hub_gpio_mon_ctx->wake_fd, ready);
+		wake_ns = hub_stats_now_ns();
 		if (!ret) {
-			/* Timeout occurred - not an error */
+			/* Set changed or shutting down - not an error */
 			continue;
 		} else if (ret < 0) {
 			hub_pr_err(
@@ -328,78 +783,31 @@ void *hub_gpio_monitor_thread_func(void *hub_mon_params)
 			break;
 		}
 
-		/* We got an event - parsing the event_bulk */
-		num_events = gpiod_line_bulk_num_lines(&event_bulk);
-		if (num_events) {
-			hub_pr_dbg("Received %d GPIO event(s).\n", num_events);
-			for (i = 0; i < num_events; i++) {
-				line = gpiod_line_bulk_get_line(&event_bulk, i);
-				if (NULL == line) {
-					hub_pr_err("Failed to get line from event bulk [%d]\n", i);
-					continue;
-				}
-
-				line_offset = gpiod_line_offset(line);
-				hub_pr_dbg("Processing event occured on line offset %d\n",
-						   line_offset);
-
-				ret = gpiod_line_event_read(line, &event);
-				if (ret) {
-					hub_pr_err("Failed to read event for line %d: %s\n",
-							   line_offset, strerror(errno));
-					continue;
-				}
-
-				/**
-				 * Signal event conditional variable of corresponding
-				 *  GPIO event line
-				 */
-				if ((line_offset >= 0) &&
-					(line_offset < p_hub_gpio_mon_ctx->num_chip_lines)) {
-					p_hub_gpio_event_ctx =
-						&p_hub->p_gpio_event_ctx[line_offset];
-					if (p_hub_gpio_event_ctx->in_use) {
-						hub_pr_dbg("Invoking worker thread of GPIO %d, event "
-								   "type : %d.\n",
-								   line_offset, event.event_type);
-						p_hub_gpio_event_ctx->event_type = event.event_type;
-
-						/* Signal only for rising edges per usecase */
-						if (event.event_type == GPIOD_LINE_EVENT_RISING_EDGE) {
-							/* TBD-SSP: handle locking failures */
-							hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
-							ret = hub_cond_var_signal(
-								&p_hub_gpio_event_ctx->event_cond_var);
-							if (HUB_SUCCESS != ret) {
-								hub_pr_err(
-									"Failed to signal event_cond_var: %d\n",
-									ret);
-								/* TBD-SSP: decide what to do here */
-							}
-							hub_mutex_unlock(
-								&p_hub_gpio_event_ctx->event_mutex);
-						}
-					} else {
-						hub_pr_dbg("Received event for line offset %d which is "
-								   "not in use\n",
-								   line_offset);
-					}
-				} else {
-					/* should never reach here, if reached it's corruption */
-					hub_pr_err("Received event for unused line offset %d\n",
-							   line_offset);
-				}
+		/**
+		 * We got events - draining each ready event fd. A read gets all the
+		 * edges queued on it up to HUB_GPIOD_MAX_EVENTS, the rest is left
+		 * for the next poll().
+		 */
+		for (i = 0; i < ret; i++) {
+			num_events = hub_gpiod_read_events(&req, ready[i], events,
+											   HUB_GPIOD_MAX_EVENTS);
+			if (num_events < 0) {
+				hub_pr_err("Failed to read GPIO events : %s\n",
+						   strerror(errno));
+				continue;
 			}
 
-			/**
-			 * Required to clear the events for populating anew.
-			 * not putting outside of num_events check, as
-			 * if num_events is 0, event_bulk is empty in itself
-			 */
-			gpiod_line_release_bulk(&event_bulk);
+			hub_pr_dbg("Received %d GPIO event(s).\n", num_events);
+			for (j = 0; j < num_events; j++) {
+				hub_gpio_dispatch_event(p_hub, &events[j], wake_ns);
+			}
 		}
 	}
 
+	if (lines_requested) {
+		hub_gpiod_release(&req);
+	}
+
 	hub_pr_dbg("Shutting down monitoring thread.\n");
 
 	return NULL;
@@ -430,41 +838,49 @@ int64_t hub_get_appdata_on_event_handler(gard_handle_t p_gard_handle,
 	struct hub_ctx            *p_hub                = NULL;
 	struct hub_gard_info      *p_gard               = NULL;
 
+	struct hub_appdata_event_times times = {0};
+
 	p_gard               = (struct hub_gard_info *)p_gard_handle;
 	p_hub                = (struct hub_ctx *)p_gard->hub;
 
 	p_hub_gpio_event_ctx = &p_hub->p_gpio_event_ctx[line_offset];
 
 	int64_t data_size = hub_get_appdata_on_event(p_gard_handle, p_hub_gpio_event_ctx,
-												  buffer, size);
+												  buffer, size, false, &times);
 
 	/* Return data size on success, error code on failure */
 	return data_size;
 }
 
 /**
- * hub_setup_appdata_cb registers a user callback function for application data
- * retrieval from GARD on GPIO event
+ * hub_setup_appdata_worker registers a user callback function for application
+ * data retrieval from GARD on GPIO event, and launches its worker thread.
  *
  * @param: gard is a GARD handle returned from hub_get_gard_handle()
  * @param: cb_handler is a callback function to be called, the API for this
  * function is defined as a hub_cb_handler_t datatype
  * @param: p_cb_ctx is an opaque callback context (can be used by the user-app)
- * @param: p_buffer is a user-allocated buffer of the proper size
+ * @param: pp_buffers is an array of user-allocated buffers of the proper size
+ * @param: num_buffers is the number of buffers in pp_buffers
  * @param: size is the number of bytes to fetch from the GARD FW
+ * @param: is_ring is true if the buffers are held by the app until released
  *
  * @return: HUB_SUCCESS on successful registration
  *			HUB_FAILURE_SETUP_APPDATA_CB on failure
  */
-enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
-									   hub_cb_handler_t cb_handler,
-									   void            *p_cb_ctx,
-									   void            *p_buffer,
-									   uint32_t         size)
+static enum hub_ret_code hub_setup_appdata_worker(gard_handle_t    gard,
+												  hub_cb_handler_t cb_handler,
+												  void            *p_cb_ctx,
+												  void *const     *pp_buffers,
+												  uint32_t         num_buffers,
+												  uint32_t         size,
+												  bool             is_ring)
 {
 	enum hub_ret_code           ret;
 	int                         i, num_gpio_inputs, pin_to_check;
 	int                         current_gpio_pin      = HUB_INVALID_GPIO_PIN;
+	uint32_t                    j;
+	char                        thread_name[HUB_THREAD_NAME_LEN];
 
 	struct hub_gard_info       *p_gard                = NULL;
 	struct hub_ctx             *p_hub                 = NULL;
@@ -493,9 +909,11 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 		/* not returning error, as cb_ctx can be NULL */
 	}
 
-	if (NULL == p_buffer) {
-		hub_pr_err("Invalid user buffer handle.\n");
-		goto hub_setup_appdata_cb_err_1;
+	for (j = 0; j < num_buffers; j++) {
+		if (NULL == pp_buffers[j]) {
+			hub_pr_err("Invalid user buffer handle [%u].\n", j);
+			goto hub_setup_appdata_cb_err_1;
+		}
 	}
 
 	if (!size) {
@@ -552,18 +970,12 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 		goto hub_setup_appdata_cb_err_1;
 	}
 
-	/* Acquire the GPIO line for the chosen pin */
-	p_hub_gpio_event_ctx->p_line =
-		gpiod_chip_get_line(p_hub_gpio_mon_ctx->p_chip, current_gpio_pin);
-	if (!p_hub_gpio_event_ctx->p_line) {
-		hub_pr_err("Failed to acquire GPIO line for pin %d : %s\n",
-				   current_gpio_pin, strerror(errno));
-		goto hub_setup_appdata_cb_err_1;
-	}
-
 	/* Set up all the variables of the current GPIO event ctx */
-	p_hub_gpio_event_ctx->gpio_pin      = current_gpio_pin;
-	p_hub_gpio_event_ctx->event_type    = 0;
+	p_hub_gpio_event_ctx->gpio_pin       = current_gpio_pin;
+	p_hub_gpio_event_ctx->rising_edge    = false;
+	p_hub_gpio_event_ctx->pending_events = 0;
+	memset(&p_hub_gpio_event_ctx->stats, 0,
+		   sizeof(p_hub_gpio_event_ctx->stats));
 	p_hub_gpio_event_ctx->in_use        = true;
 	p_hub_gpio_event_ctx->p_user_cb_ctx = p_cb_ctx;
 	/* Always setup a function pointer after filling it's variables
@@ -589,8 +1001,14 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 	p_hub_gpio_worker_ctx->p_gard_handle        = gard;
 	p_hub_gpio_worker_ctx->p_hub_gpio_mon_ctx   = p_hub->p_gpio_mon_ctx;
 	p_hub_gpio_worker_ctx->p_hub_gpio_event_ctx = p_hub_gpio_event_ctx;
-	p_hub_gpio_worker_ctx->buffer               = p_buffer;
+	p_hub_gpio_worker_ctx->buffer               = pp_buffers[0];
 	p_hub_gpio_worker_ctx->size                 = size;
+	p_hub_gpio_worker_ctx->is_ring              = is_ring;
+	p_hub_gpio_worker_ctx->num_buffers          = num_buffers;
+	p_hub_gpio_worker_ctx->next_buffer          = 0;
+	for (j = 0; j < num_buffers; j++) {
+		p_hub_gpio_worker_ctx->p_buffers[j] = pp_buffers[j];
+	}
 
 	ret = hub_mutex_init(&p_hub_gpio_event_ctx->event_mutex);
 	if (HUB_SUCCESS != ret) {
@@ -606,47 +1024,78 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 		goto hub_setup_appdata_cb_err_4;
 	}
 
-	/* Updating the mon_bulk with new monitoring line */
-	gpiod_line_bulk_add(&p_hub_gpio_mon_ctx->mon_bulk,
-						p_hub_gpio_event_ctx->p_line);
-
-	/* Launch the worker thread for this GPIO pin */
-	ret = hub_thread_create(&p_hub_gpio_event_ctx->event_thread_hdl,
-							&p_hub_gpio_event_ctx->event_thread_attr,
-							hub_gpio_worker_thread_func,
-							(void *)p_hub_gpio_worker_ctx);
+	ret = hub_mutex_init(&p_hub_gpio_worker_ctx->ring_mutex);
 	if (HUB_SUCCESS != ret) {
-		hub_pr_err("Failed to create thread for GPIO line of pin %d.\n",
+		hub_pr_err("Failed to initialize ring_mutex for pin %d.\n",
 				   p_hub_gpio_event_ctx->gpio_pin);
 		goto hub_setup_appdata_cb_err_5;
 	}
-	hub_pr_dbg("Creating worker thread for GPIO pin %d. Handle - %ld\n",
-			   p_hub_gpio_event_ctx->gpio_pin,
-			   p_hub_gpio_event_ctx->event_thread_hdl);
+
+	ret = hub_cond_var_init(&p_hub_gpio_worker_ctx->ring_cond_var);
+	if (HUB_SUCCESS != ret) {
+		hub_pr_err("Failed to initialize ring_cond_var for pin %d.\n",
+				   p_hub_gpio_event_ctx->gpio_pin);
+		goto hub_setup_appdata_cb_err_6;
+	}
+
+	/* Updating the monitored set with new monitoring line */
+	ret = hub_gpio_mon_bulk_update(p_hub_gpio_mon_ctx, current_gpio_pin, true);
+	if (HUB_SUCCESS != ret) {
+		hub_pr_err("Too many monitored GPIO lines for pin %d.\n",
+				   current_gpio_pin);
+		goto hub_setup_appdata_cb_err_7;
+	}
+
+	/* hub_release_appdata_buffer() and hub_fini() find the worker from here */
+	p_hub_gpio_event_ctx->p_worker_ctx = p_hub_gpio_worker_ctx;
 
 	/* Signal the monitor thread to start monitoring on added lines */
-	/* TBD-SSP: handle locking failures */
-	hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
-	ret = hub_cond_var_signal(&p_hub_gpio_mon_ctx->mon_cond_var);
-	hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+	ret = hub_gpio_mon_wake(p_hub_gpio_mon_ctx);
 	if (HUB_SUCCESS != ret) {
 		hub_pr_err("Failed to signal mon_cond_var: %d\n", ret);
-		goto hub_setup_appdata_cb_err_6;
+		goto hub_setup_appdata_cb_err_8;
+	}
+
+	/**
+	 * Launch the worker thread for this GPIO pin. In the reactor execution
+	 * model the events of this line are handled by the worker pool instead.
+	 * Events arriving before the worker runs wait in pending_events, so the
+	 * thread is started last: no error path has to stop it again.
+	 */
+	if (HUB_GPIO_EXEC_THREAD_PER_LINE == p_hub_gpio_mon_ctx->exec_model) {
+		snprintf(thread_name, sizeof(thread_name), "hub_gpio_%u",
+				 (uint16_t)p_hub_gpio_event_ctx->gpio_pin);
+		ret = hub_thread_create(&p_hub_gpio_event_ctx->event_thread_hdl,
+								&p_hub_gpio_event_ctx->event_thread_attr,
+								HUB_THREAD_CLASS_GPIO_WORKER, thread_name,
+								hub_gpio_worker_thread_func,
+								(void *)p_hub_gpio_worker_ctx);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to create thread for GPIO line of pin %d.\n",
+					   p_hub_gpio_event_ctx->gpio_pin);
+			goto hub_setup_appdata_cb_err_8;
+		}
+		hub_pr_dbg("Creating worker thread for GPIO pin %d. Handle - %ld\n",
+				   p_hub_gpio_event_ctx->gpio_pin,
+				   p_hub_gpio_event_ctx->event_thread_hdl);
 	}
 
 	hub_pr_dbg("Launched worker thread for GPIO %d.\n", current_gpio_pin);
 
 	return HUB_SUCCESS;
 
-hub_setup_appdata_cb_err_6:
-	hub_thread_cancel(p_hub_gpio_event_ctx->event_thread_hdl);
-	hub_thread_join(p_hub_gpio_event_ctx->event_thread_hdl, NULL);
+hub_setup_appdata_cb_err_8:
 	p_hub_gpio_event_ctx->event_thread_hdl = 0;
+	p_hub_gpio_event_ctx->p_worker_ctx     = NULL;
+	hub_gpio_mon_bulk_update(p_hub_gpio_mon_ctx, current_gpio_pin, false);
+	/* Have the monitor drop the line from its requested set */
+	hub_gpio_mon_wake(p_hub_gpio_mon_ctx);
+hub_setup_appdata_cb_err_7:
+	hub_cond_var_destroy(&p_hub_gpio_worker_ctx->ring_cond_var);
+hub_setup_appdata_cb_err_6:
+	hub_mutex_destroy(&p_hub_gpio_worker_ctx->ring_mutex);
 hub_setup_appdata_cb_err_5:
 	hub_cond_var_destroy(&p_hub_gpio_event_ctx->event_cond_var);
-	gpiod_line_bulk_remove(&p_hub_gpio_mon_ctx->mon_bulk, current_gpio_pin);
-	/* TBD-SSP: can we just release just this line */
-	p_hub_gpio_event_ctx->p_line = NULL;
 hub_setup_appdata_cb_err_4:
 	hub_mutex_destroy(&p_hub_gpio_event_ctx->event_mutex);
 hub_setup_appdata_cb_err_3:
@@ -659,6 +1108,222 @@ hub_setup_appdata_cb_err_1:
 	return HUB_FAILURE_SETUP_APPDATA_CB;
 }
 
+/**
+ * hub_setup_appdata_cb registers a user callback function for application data
+ * retrieval from GARD on GPIO event
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: cb_handler is a callback function to be called, the API for this
+ * function is defined as a hub_cb_handler_t datatype
+ * @param: p_cb_ctx is an opaque callback context (can be used by the user-app)
+ * @param: p_buffer is a user-allocated buffer of the proper size
+ * @param: size is the number of bytes to fetch from the GARD FW
+ *
+ * @return: HUB_SUCCESS on successful registration
+ *			HUB_FAILURE_SETUP_APPDATA_CB on failure
+ */
+enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
+									   hub_cb_handler_t cb_handler,
+									   void            *p_cb_ctx,
+									   void            *p_buffer,
+									   uint32_t         size)
+{
+	return hub_setup_appdata_worker(gard, cb_handler, p_cb_ctx, &p_buffer, 1,
+									size, false);
+}
+
+/**
+ * hub_setup_appdata_ring_cb registers a user callback function for
+ * application data retrieval from GARD on GPIO event, with a ring of user
+ * buffers.
+ *
+ * Each callback hands one buffer of the ring to the app, which holds it
+ * until it calls hub_release_appdata_buffer(). Meanwhile, HUB fills the next
+ * buffer. If every buffer is held, HUB waits for a release; GPIO events that
+ * come in the meantime stay pending.
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: cb_handler is a callback function to be called, the API for this
+ * function is defined as a hub_cb_handler_t datatype
+ * @param: p_cb_ctx is an opaque callback context (can be used by the user-app)
+ * @param: pp_buffers is an array of num_buffers user-allocated buffers
+ * @param: num_buffers is 1 to HUB_APPDATA_RING_MAX_BUFFERS
+ * @param: size is the size of each buffer, in bytes
+ *
+ * @return: HUB_SUCCESS on successful registration
+ *			HUB_FAILURE_SETUP_APPDATA_CB on failure
+ */
+enum hub_ret_code hub_setup_appdata_ring_cb(gard_handle_t    gard,
+											hub_cb_handler_t cb_handler,
+											void            *p_cb_ctx,
+											void *const     *pp_buffers,
+											uint32_t         num_buffers,
+											uint32_t         size)
+{
+	if ((NULL == pp_buffers) || (0 == num_buffers) ||
+		(num_buffers > HUB_APPDATA_RING_MAX_BUFFERS)) {
+		hub_pr_err("Invalid appdata ring of %u buffers.\n", num_buffers);
+		return HUB_FAILURE_SETUP_APPDATA_CB;
+	}
+
+	return hub_setup_appdata_worker(gard, cb_handler, p_cb_ctx, pp_buffers,
+									num_buffers, size, true);
+}
+
+/**
+ * hub_release_appdata_buffer gives a buffer handed to the app by an appdata
+ * ring callback back to HUB, to be filled again.
+ *
+ * @param: gard is the GARD handle the ring was set up on
+ * @param: p_buffer is the buffer passed to the callback
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SETUP_APPDATA_CB if p_buffer is not a held ring buffer
+ */
+enum hub_ret_code hub_release_appdata_buffer(gard_handle_t gard,
+											 void         *p_buffer)
+{
+	int                         i;
+	uint32_t                    j;
+	struct hub_ctx             *p_hub                 = NULL;
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx = NULL;
+
+	if ((NULL == gard) || (NULL == p_buffer)) {
+		hub_pr_err("Invalid GARD handle or buffer.\n");
+		return HUB_FAILURE_SETUP_APPDATA_CB;
+	}
+
+	p_hub = (struct hub_ctx *)((struct hub_gard_info *)gard)->hub;
+	if (NULL == p_hub->p_gpio_event_ctx) {
+		hub_pr_err("GPIO monitoring is not set up.\n");
+		return HUB_FAILURE_SETUP_APPDATA_CB;
+	}
+
+	for (i = 0; i < p_hub->p_gpio_mon_ctx->num_chip_lines; i++) {
+		p_hub_gpio_worker_ctx = p_hub->p_gpio_event_ctx[i].p_worker_ctx;
+		if ((NULL == p_hub_gpio_worker_ctx) ||
+			!p_hub_gpio_worker_ctx->is_ring ||
+			(gard != p_hub_gpio_worker_ctx->p_gard_handle)) {
+			continue;
+		}
+
+		/* TBD-SSP: handle locking failures */
+		hub_mutex_lock(&p_hub_gpio_worker_ctx->ring_mutex);
+		for (j = 0; j < p_hub_gpio_worker_ctx->num_buffers; j++) {
+			if ((p_buffer == p_hub_gpio_worker_ctx->p_buffers[j]) &&
+				p_hub_gpio_worker_ctx->is_held[j]) {
+				p_hub_gpio_worker_ctx->is_held[j] = false;
+				hub_cond_var_signal(&p_hub_gpio_worker_ctx->ring_cond_var);
+				hub_mutex_unlock(&p_hub_gpio_worker_ctx->ring_mutex);
+				return HUB_SUCCESS;
+			}
+		}
+		hub_mutex_unlock(&p_hub_gpio_worker_ctx->ring_mutex);
+	}
+
+	hub_pr_err("Buffer %p is not a held appdata ring buffer.\n", p_buffer);
+
+	return HUB_FAILURE_SETUP_APPDATA_CB;
+}
+
+/**
+ * hub_get_gpio_event_stats gets a snapshot of the event counters of a GPIO
+ * line set up with hub_setup_appdata_cb() or
+ * hub_setup_appdata_cb_for_pyhub().
+ *
+ * @param: gard is the GARD handle
+ * @param: line_offset is the GPIO line offset
+ * @param: p_stats is filled with the counters
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GPIO_EVENT_STATS on failure
+ */
+enum hub_ret_code
+	hub_get_gpio_event_stats(gard_handle_t                gard,
+							 int                          line_offset,
+							 struct hub_gpio_event_stats *p_stats)
+{
+	struct hub_gard_info      *p_gard               = NULL;
+	struct hub_ctx            *p_hub                = NULL;
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+
+	if ((NULL == gard) || (NULL == p_stats)) {
+		hub_pr_err("Invalid GARD handle or stats pointer.\n");
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	p_gard = (struct hub_gard_info *)gard;
+	p_hub  = (struct hub_ctx *)p_gard->hub;
+
+	if ((NULL == p_hub->p_gpio_event_ctx) || (line_offset < 0) ||
+		(line_offset >= p_hub->p_gpio_mon_ctx->num_chip_lines)) {
+		hub_pr_err("Invalid GPIO line offset %d.\n", line_offset);
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	p_hub_gpio_event_ctx = &p_hub->p_gpio_event_ctx[line_offset];
+	if (!p_hub_gpio_event_ctx->in_use) {
+		hub_pr_err("GPIO line %d is not monitored.\n", line_offset);
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
+	*p_stats         = p_hub_gpio_event_ctx->stats;
+	p_stats->pending = p_hub_gpio_event_ctx->pending_events;
+	hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_get_appdata_event_times gets the timestamps of the last GPIO event
+ * whose app data was fetched on a line.
+ *
+ * @param: gard is the GARD handle
+ * @param: line_offset is the GPIO line offset
+ * @param: p_times is filled with the timestamps
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GPIO_EVENT_STATS on failure
+ */
+enum hub_ret_code
+	hub_get_appdata_event_times(gard_handle_t                   gard,
+								int                             line_offset,
+								struct hub_appdata_event_times *p_times)
+{
+	struct hub_gard_info      *p_gard               = NULL;
+	struct hub_ctx            *p_hub                = NULL;
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+
+	if ((NULL == gard) || (NULL == p_times)) {
+		hub_pr_err("Invalid GARD handle or times pointer.\n");
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	p_gard = (struct hub_gard_info *)gard;
+	p_hub  = (struct hub_ctx *)p_gard->hub;
+
+	if ((NULL == p_hub->p_gpio_event_ctx) || (line_offset < 0) ||
+		(line_offset >= p_hub->p_gpio_mon_ctx->num_chip_lines)) {
+		hub_pr_err("Invalid GPIO line offset %d.\n", line_offset);
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	p_hub_gpio_event_ctx = &p_hub->p_gpio_event_ctx[line_offset];
+	if (!p_hub_gpio_event_ctx->in_use) {
+		hub_pr_err("GPIO line %d is not monitored.\n", line_offset);
+		return HUB_FAILURE_GPIO_EVENT_STATS;
+	}
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
+	*p_times = p_hub_gpio_event_ctx->last_times;
+	hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
+
+	return HUB_SUCCESS;
+}
+
 /**
  * hub_setup_appdata_cb_for_pyhub is an alternate version of
  * hub_setup_appdata_cb which doesn't take user callback function and context.
@@ -748,18 +1413,12 @@ int32_t hub_setup_appdata_cb_for_pyhub(gard_handle_t gard)
 		goto hub_setup_appdata_cb_py_err_1;
 	}
 
-	/* Acquire the GPIO line for the chosen pin */
-	p_hub_gpio_event_ctx->p_line =
-		gpiod_chip_get_line(p_hub_gpio_mon_ctx->p_chip, current_gpio_pin);
-	if (!p_hub_gpio_event_ctx->p_line) {
-		hub_pr_err("Failed to acquire GPIO line for pin %d : %s\n",
-				   current_gpio_pin, strerror(errno));
-		goto hub_setup_appdata_cb_py_err_1;
-	}
-
 	/* Set up all the variables of the current GPIO event ctx */
-	p_hub_gpio_event_ctx->gpio_pin      = current_gpio_pin;
-	p_hub_gpio_event_ctx->event_type    = 0;
+	p_hub_gpio_event_ctx->gpio_pin       = current_gpio_pin;
+	p_hub_gpio_event_ctx->rising_edge    = false;
+	p_hub_gpio_event_ctx->pending_events = 0;
+	memset(&p_hub_gpio_event_ctx->stats, 0,
+		   sizeof(p_hub_gpio_event_ctx->stats));
 	p_hub_gpio_event_ctx->in_use        = true;
 	p_hub_gpio_event_ctx->p_user_cb_ctx = NULL;
 
@@ -791,30 +1450,30 @@ int32_t hub_setup_appdata_cb_for_pyhub(gard_handle_t gard)
 		goto hub_setup_appdata_cb_py_err_2;
 	}
 
-	/* Updating the mon_bulk with new monitoring line */
-	gpiod_line_bulk_add(&p_hub_gpio_mon_ctx->mon_bulk,
-						p_hub_gpio_event_ctx->p_line);
+	/* Updating the monitored set with new monitoring line */
+	ret = hub_gpio_mon_bulk_update(p_hub_gpio_mon_ctx, current_gpio_pin, true);
+	if (HUB_SUCCESS != ret) {
+		hub_pr_err("Too many monitored GPIO lines for pin %d.\n",
+				   current_gpio_pin);
+		goto hub_setup_appdata_cb_py_err_3;
+	}
 
 	/* Signal the monitor thread to start monitoring on added lines */
-	/* TBD-SSP: handle locking failures */
-	hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
-	ret = hub_cond_var_signal(&p_hub_gpio_mon_ctx->mon_cond_var);
-	hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+	ret = hub_gpio_mon_wake(p_hub_gpio_mon_ctx);
 	if (HUB_SUCCESS != ret) {
 		hub_pr_err("Failed to signal mon_cond_var: %d\n", ret);
-		goto hub_setup_appdata_cb_py_err_3;
+		goto hub_setup_appdata_cb_py_err_4;
 	}
 
 	hub_pr_dbg("Launched worker thread for GPIO %d.\n", current_gpio_pin);
 
 	return pin_to_check;
 
+hub_setup_appdata_cb_py_err_4:
+	hub_gpio_mon_bulk_update(p_hub_gpio_mon_ctx, current_gpio_pin, false);
 hub_setup_appdata_cb_py_err_3:
 	p_hub_gpio_event_ctx->event_thread_hdl = 0;
 	hub_cond_var_destroy(&p_hub_gpio_event_ctx->event_cond_var);
-	gpiod_line_bulk_remove(&p_hub_gpio_mon_ctx->mon_bulk, current_gpio_pin);
-	/* TBD-SSP: can we just release just this line */
-	p_hub_gpio_event_ctx->p_line = NULL;
 hub_setup_appdata_cb_py_err_2:
 	hub_mutex_destroy(&p_hub_gpio_event_ctx->event_mutex);
 	p_hub_gpio_event_ctx->in_use        = false;
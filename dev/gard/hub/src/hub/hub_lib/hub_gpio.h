@@ -9,59 +9,88 @@
 #define __HUB_GPIO_H__
 
 #include "gard_info.h"
+#include "hub_stats.h"
+#include "hub_trace.h"
 
-/**
- * Note:
- * 1. types.h included from gard_info.h already defines a bool.
- * 2. gpiod.h also includes stdbool.h leading to a define clash.
- * 3. We make sure that stdbool.h is not included by the following #define
- *
- * stdbool.h for CM5 Raspbian OS is at:
- * /usr/lib/gcc/aarch64-linux-gnu/12/include/stdbool.h
- *
- * Other libgpiod function headers and defines are obtained from a regular
- * include of gpiod.h
- */
-#define _STDBOOL_H
-#include <gpiod.h>
+#include "hub_gpiod.h"
 
 /* For sleep */
 #include <unistd.h>
 
-#define HUB_GPIO_MONITOR_STRING           "HUB_GPIO_EVENT_MONITOR"
+#define HUB_GPIO_MONITOR_STRING "HUB_GPIO_EVENT_MONITOR"
+
+#define HUB_INVALID_GPIO_PIN    (-1)
 
-#define HUB_GPIO_MON_THREAD_TIMEOUT_SECS  (1)  // seconds
-#define HUB_GPIO_MON_THREAD_TIMEOUT_NSECS (0)  // nanoseconds
+/**
+ * Most events queued per line for the app data worker. Further events are
+ * counted as dropped rather than letting a stalled worker fall ever behind.
+ */
+#define HUB_GPIO_MAX_PENDING_EVENTS       (64)
+
+/* Most worker threads in the pool of the reactor execution model */
+#define HUB_GPIO_POOL_MAX_SIZE            (8)
+#define HUB_GPIO_POOL_DEFAULT_SIZE        (2)
 
-#define HUB_INVALID_GPIO_PIN              (-1)
+struct hub_gpio_event_ctx;
+
+/**
+ * Worker pool of the reactor execution model.
+ * Lines with pending events wait in a FIFO run queue; a line is in the queue
+ * or being handled by at most one worker at a time (is_scheduled).
+ */
+struct hub_gpio_pool_ctx {
+	uint32_t                   num_workers;
+	hub_thread_hdl_t           worker_hdls[HUB_GPIO_POOL_MAX_SIZE];
+	hub_mutex_t                pool_mutex;
+	hub_cond_var_t             pool_cond_var;
+	struct hub_gpio_event_ctx *p_run_head;
+	struct hub_gpio_event_ctx *p_run_tail;
+};
 
 /* Context of a HUB GPIO monitor */
 struct hub_gpio_mon_ctx {
-	volatile bool          terminate_flag;
-	volatile bool          mon_thread_initialized;
-	struct timespec        mon_timeout;
-	struct gpiod_chip     *p_chip;
-	uint32_t               num_chip_lines;
-	struct gpiod_line_bulk mon_bulk;
-	hub_thread_hdl_t       mon_thread_hdl;
-	hub_thread_attr_t      mon_thread_attr;
-	hub_mutex_t            mon_mutex;
-	hub_cond_var_t         mon_cond_var;
+	volatile bool            terminate_flag;
+	volatile bool            mon_thread_initialized;
+	struct gpiod_chip       *p_chip;
+	uint32_t                 num_chip_lines;
+	/* Offsets of the monitored lines, see hub_gpio_mon_bulk_update() */
+	unsigned int             mon_offsets[HUB_GPIOD_MAX_LINES];
+	uint32_t                 num_mon_lines;
+	uint32_t                 mon_bulk_gen; /* Bumped when mon_offsets change */
+	hub_thread_hdl_t         mon_thread_hdl;
+	hub_thread_attr_t        mon_thread_attr;
+	hub_mutex_t              mon_mutex;
+	hub_cond_var_t           mon_cond_var;
+	enum hub_gpio_exec_model exec_model;
+	int                      wake_fd; /* Wakes the monitor / reactor thread */
+	struct hub_gpio_pool_ctx pool;    /* Reactor worker pool */
+	struct hub_trace_ctx     trace;   /* GPIO app data event trace */
 };
 
+struct hub_gpio_worker_ctx;
+
 /* Context of a HUB GPIO event */
 struct hub_gpio_event_ctx {
-	int                gpio_pin;
-	struct gpiod_line *p_line;
-	hub_thread_hdl_t   event_thread_hdl;
-	hub_thread_attr_t  event_thread_attr;
-	hub_mutex_t        event_mutex;
-	hub_cond_var_t     event_cond_var;
-	int                event_type;
-	bool               in_use;
-	hub_cb_handler_t   user_cb;
-	void              *p_user_cb_ctx;
-	bool               event_callback_setup;
+	int                            gpio_pin;
+	hub_thread_hdl_t               event_thread_hdl;
+	hub_thread_attr_t              event_thread_attr;
+	hub_mutex_t                    event_mutex;
+	hub_cond_var_t                 event_cond_var;
+	bool                           rising_edge;      /* Of the last event */
+	uint32_t                       pending_events;   /* Under event_mutex */
+	struct hub_gpio_event_stats    stats;            /* Under event_mutex */
+	/* Edge / monitor wake up times of pending events, FIFO from pending_head */
+	uint64_t                       pending_edge_ns[HUB_GPIO_MAX_PENDING_EVENTS];
+	uint64_t                       pending_wake_ns[HUB_GPIO_MAX_PENDING_EVENTS];
+	uint32_t                       pending_head;     /* Under event_mutex */
+	struct hub_appdata_event_times last_times;       /* Under event_mutex */
+	bool                           in_use;
+	hub_cb_handler_t               user_cb;
+	void                          *p_user_cb_ctx;
+	bool                           event_callback_setup;
+	struct hub_gpio_worker_ctx    *p_worker_ctx;
+	bool                           is_scheduled;     /* Under pool_mutex */
+	struct hub_gpio_event_ctx     *p_run_next;       /* Under pool_mutex */
 };
 
 /* Context of a HUB GPIO worker */
@@ -69,8 +98,16 @@ struct hub_gpio_worker_ctx {
 	gard_handle_t              p_gard_handle;
 	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx;
 	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx;
-	void                      *buffer;
+	void                      *buffer; /* Buffer being filled */
 	uint32_t                   size;
+	/* Ring of user buffers, set up by hub_setup_appdata_ring_cb() */
+	bool                       is_ring;
+	uint32_t                   num_buffers;
+	uint32_t                   next_buffer;
+	void                      *p_buffers[HUB_APPDATA_RING_MAX_BUFFERS];
+	bool                       is_held[HUB_APPDATA_RING_MAX_BUFFERS];
+	hub_mutex_t                ring_mutex;
+	hub_cond_var_t             ring_cond_var;
 };
 
 /**
@@ -85,6 +122,28 @@ struct hub_gpio_worker_ctx {
  */
 void *hub_gpio_monitor_thread_func(void *hub_mon_params);
 
+/**
+ * hub_gpio_dispatch_event hands an edge event read from a monitored GPIO line
+ * to whoever handles app data on that line. wake_ns is when the monitor woke up
+ * for it, see struct hub_appdata_event_times.
+ */
+void hub_gpio_dispatch_event(struct hub_ctx                    *p_hub,
+							 const struct hub_gpiod_edge_event *p_event,
+							 uint64_t                           wake_ns);
+
+/**
+ * hub_gpio_handle_one_event takes one pending GPIO event of a line, fetches
+ * the app data from GARD and calls the user callback with it.
+ */
+bool hub_gpio_handle_one_event(
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx);
+
+/**
+ * hub_gpio_mon_wake wakes the GPIO monitor / reactor thread.
+ */
+enum hub_ret_code
+	hub_gpio_mon_wake(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx);
+
 /**
  * hub_setup_appdata_cb is a function will be called by HUB whenever GARD FW
  * signals that it has application data available to be shipped across to the
@@ -131,6 +190,24 @@ enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
 									   void            *p_buffer,
 									   uint32_t         size);
 
+/**
+ * hub_setup_appdata_ring_cb registers a user callback function for
+ * application data retrieval from GARD on GPIO event, with a ring of user
+ * buffers that the app holds until hub_release_appdata_buffer().
+ */
+enum hub_ret_code hub_setup_appdata_ring_cb(gard_handle_t    gard,
+											hub_cb_handler_t cb_handler,
+											void            *p_cb_ctx,
+											void *const     *pp_buffers,
+											uint32_t         num_buffers,
+											uint32_t         size);
+
+/**
+ * hub_release_appdata_buffer gives a buffer handed to the app by an appdata
+ * ring callback back to HUB, to be filled again.
+ */
+enum hub_ret_code hub_release_appdata_buffer(gard_handle_t gard,
+											 void         *p_buffer);
 
 /**
  * hub_recv_app_data_from_gard is a function that receives application data
@@ -149,6 +226,22 @@ int64_t hub_recv_app_data_from_gard(gard_handle_t p_gard_handle,
 									  uint32_t      addr,
 									  uint32_t      count);
 
+/**
+ * hub_recv_app_data_batch_from_gard is a function that receives all results
+ * queued in the GARD FW that fit in the user buffer, as records of a uint32_t
+ * size followed by that many bytes.
+ *
+ * @param: p_gard_handle is the GARD handle
+ * @param: p_buffer is the user buffer pointer to be filled with the records
+ * @param: count is the size of the user buffer
+ *
+ * @return: size of the records (>= 0) on success
+ * 			error code (< 0) on failure (HUB_FAILURE_RECV_APP_DATA)
+ */
+int64_t hub_recv_app_data_batch_from_gard(gard_handle_t p_gard_handle,
+										  void         *p_buffer,
+										  uint32_t      count);
+
 /**
  * hub_get_appdata_on_event_handler monitors GPIO event and
  * gets application data from GARD on event occurence.
@@ -170,6 +263,15 @@ int64_t hub_get_appdata_on_event_handler(gard_handle_t p_gard_handle,
 										 void         *buffer,
 										 uint32_t      size);
 
+/**
+ * hub_get_gpio_event_stats gets a snapshot of the event counters of a GPIO
+ * line set up for app data.
+ */
+enum hub_ret_code
+	hub_get_gpio_event_stats(gard_handle_t                gard,
+							 int                          line_offset,
+							 struct hub_gpio_event_stats *p_stats);
+
 /**
  * hub_setup_appdata_cb_for_pyhub is an alternate version of
  * hub_setup_appdata_cb which doesn't take user callback function and context.
@@ -0,0 +1,374 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Reactor execution model of the GPIO app data path.
+ *
+ * Instead of a monitor thread plus one worker thread per GPIO line, a single
+ * reactor thread waits in epoll_wait() on the event fds of the monitored
+ * lines, and a small fixed pool of workers fetches the app data. It is
+ * selected with "gpio_exec_model": "reactor" in host_config.json or with
+ * hub_init_with_options().
+ *
+ * Bus fds are not part of the epoll set: every bus transfer is a synchronous
+ * request / response made by the worker that handles the event.
+ */
+
+#include "hub_gpio_reactor.h"
+#include "hub_threading.h"
+
+/**
+ * Append a line to the run queue and wake a worker.
+ * Called with pool_mutex held.
+ *
+ * @param: p_pool is the worker pool
+ * @param: p_hub_gpio_event_ctx is the GPIO event context of the line
+ */
+static void
+	hub_gpio_pool_enqueue(struct hub_gpio_pool_ctx  *p_pool,
+						  struct hub_gpio_event_ctx *p_hub_gpio_event_ctx)
+{
+	p_hub_gpio_event_ctx->is_scheduled = true;
+	p_hub_gpio_event_ctx->p_run_next   = NULL;
+
+	if (NULL == p_pool->p_run_tail) {
+		p_pool->p_run_head = p_hub_gpio_event_ctx;
+	} else {
+		p_pool->p_run_tail->p_run_next = p_hub_gpio_event_ctx;
+	}
+	p_pool->p_run_tail = p_hub_gpio_event_ctx;
+
+	hub_cond_var_signal(&p_pool->pool_cond_var);
+}
+
+/**
+ * hub_gpio_pool_worker_func is the thread function of a pool worker.
+ *
+ * It takes the line at the head of the run queue and handles one of its
+ * events. A line that still has events pending goes back to the tail of the
+ * queue, so that a busy line does not starve the others.
+ *
+ * @param: p_params is the GPIO monitor context
+ *
+ * @return: NULL
+ */
+static void *hub_gpio_pool_worker_func(void *p_params)
+{
+	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = NULL;
+	struct hub_gpio_pool_ctx  *p_pool               = NULL;
+	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+
+	p_hub_gpio_mon_ctx = (struct hub_gpio_mon_ctx *)p_params;
+	p_pool             = &p_hub_gpio_mon_ctx->pool;
+
+	while (1) {
+		/* TBD-SSP: handle locking failures */
+		hub_mutex_lock(&p_pool->pool_mutex);
+		while ((NULL == p_pool->p_run_head) &&
+			   !p_hub_gpio_mon_ctx->terminate_flag) {
+			hub_cond_var_wait(&p_pool->pool_cond_var, &p_pool->pool_mutex);
+		}
+
+		if (p_hub_gpio_mon_ctx->terminate_flag) {
+			hub_mutex_unlock(&p_pool->pool_mutex);
+			break;
+		}
+
+		p_hub_gpio_event_ctx = p_pool->p_run_head;
+		p_pool->p_run_head   = p_hub_gpio_event_ctx->p_run_next;
+		if (NULL == p_pool->p_run_head) {
+			p_pool->p_run_tail = NULL;
+		}
+		hub_mutex_unlock(&p_pool->pool_mutex);
+
+		if (!hub_gpio_handle_one_event(p_hub_gpio_event_ctx->p_worker_ctx)) {
+			break;
+		}
+
+		/**
+		 * Same lock order as hub_gpio_dispatch_event(), so that an event
+		 * queued right now either sees is_scheduled or is seen here.
+		 */
+		hub_mutex_lock(&p_hub_gpio_event_ctx->event_mutex);
+		hub_mutex_lock(&p_pool->pool_mutex);
+		p_hub_gpio_event_ctx->is_scheduled = false;
+		if (p_hub_gpio_event_ctx->pending_events) {
+			hub_gpio_pool_enqueue(p_pool, p_hub_gpio_event_ctx);
+		}
+		hub_mutex_unlock(&p_pool->pool_mutex);
+		hub_mutex_unlock(&p_hub_gpio_event_ctx->event_mutex);
+	}
+
+	return NULL;
+}
+
+/**
+ * Start the worker pool of the reactor execution model.
+ *
+ * @param: p_hub_gpio_mon_ctx is the GPIO monitor context owning the pool
+ * @param: num_workers is 1 to HUB_GPIO_POOL_MAX_SIZE
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_THREAD_CREATE etc. on failure
+ */
+enum hub_ret_code
+	hub_gpio_pool_start(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx,
+						uint32_t                 num_workers)
+{
+	enum hub_ret_code         ret;
+	char                      thread_name[HUB_THREAD_NAME_LEN];
+	struct hub_gpio_pool_ctx *p_pool = &p_hub_gpio_mon_ctx->pool;
+
+	p_pool->num_workers = 0;
+	p_pool->p_run_head  = NULL;
+	p_pool->p_run_tail  = NULL;
+
+	ret = hub_mutex_init(&p_pool->pool_mutex);
+	if (HUB_SUCCESS != ret) {
+		goto err_pool_start_1;
+	}
+
+	ret = hub_cond_var_init(&p_pool->pool_cond_var);
+	if (HUB_SUCCESS != ret) {
+		goto err_pool_start_2;
+	}
+
+	while (p_pool->num_workers < num_workers) {
+		snprintf(thread_name, sizeof(thread_name), "hub_pool%u",
+				 (uint8_t)p_pool->num_workers);
+		ret = hub_thread_create(&p_pool->worker_hdls[p_pool->num_workers],
+								NULL, HUB_THREAD_CLASS_GPIO_WORKER, thread_name,
+								hub_gpio_pool_worker_func,
+								(void *)p_hub_gpio_mon_ctx);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to create GPIO pool worker %u.\n",
+					   p_pool->num_workers);
+			goto err_pool_start_3;
+		}
+		p_pool->num_workers++;
+	}
+
+	hub_pr_dbg("Started GPIO worker pool of %u threads.\n",
+			   p_pool->num_workers);
+
+	return HUB_SUCCESS;
+
+err_pool_start_3:
+	/* Stops the workers started so far and destroys the sync objects */
+	hub_gpio_pool_stop(p_hub_gpio_mon_ctx);
+	return ret;
+err_pool_start_2:
+	hub_mutex_destroy(&p_pool->pool_mutex);
+err_pool_start_1:
+	return ret;
+}
+
+/**
+ * Stop and join the worker pool of the reactor execution model.
+ * Sets the terminate_flag of the monitor context.
+ *
+ * @param: p_hub_gpio_mon_ctx is the GPIO monitor context owning the pool
+ */
+void hub_gpio_pool_stop(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx)
+{
+	uint32_t                  i;
+	struct hub_gpio_pool_ctx *p_pool = &p_hub_gpio_mon_ctx->pool;
+
+	hub_mutex_lock(&p_pool->pool_mutex);
+	p_hub_gpio_mon_ctx->terminate_flag = true;
+	hub_cond_var_broadcast(&p_pool->pool_cond_var);
+	hub_mutex_unlock(&p_pool->pool_mutex);
+
+	for (i = 0; i < p_pool->num_workers; i++) {
+		hub_thread_join(p_pool->worker_hdls[i], NULL);
+	}
+	hub_pr_dbg("Joined GPIO worker pool of %u threads.\n",
+			   p_pool->num_workers);
+	p_pool->num_workers = 0;
+
+	hub_cond_var_destroy(&p_pool->pool_cond_var);
+	hub_mutex_destroy(&p_pool->pool_mutex);
+}
+
+/**
+ * Put a line with pending events on the run queue of the worker pool, unless
+ * it is already queued or being handled. Called with event_mutex held.
+ *
+ * @param: p_hub_gpio_mon_ctx is the GPIO monitor context owning the pool
+ * @param: p_hub_gpio_event_ctx is the GPIO event context of the line
+ */
+void hub_gpio_pool_schedule(struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx,
+							struct hub_gpio_event_ctx *p_hub_gpio_event_ctx)
+{
+	struct hub_gpio_pool_ctx *p_pool = &p_hub_gpio_mon_ctx->pool;
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_pool->pool_mutex);
+	if (!p_hub_gpio_event_ctx->is_scheduled) {
+		hub_gpio_pool_enqueue(p_pool, p_hub_gpio_event_ctx);
+	}
+	hub_mutex_unlock(&p_pool->pool_mutex);
+}
+
+/**
+ * Request both-edge events on a set of lines and add their event fds to the
+ * epoll set, tagged with their index in hub_gpiod_get_fds(). The fds leave
+ * the epoll set on their own when the lines are released, as they get
+ * closed.
+ *
+ * @param: epoll_fd is the epoll set of the reactor
+ * @param: p_hub_gpio_mon_ctx is the GPIO monitor context, with the lines to
+ * watch
+ * @param: p_req is filled with the request
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_gpio_reactor_watch(int                      epoll_fd,
+								  struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx,
+								  struct hub_gpiod_request *p_req)
+{
+	struct epoll_event ev;
+	int                fds[HUB_GPIOD_MAX_LINES];
+	unsigned int       i, num_fds;
+
+	if (hub_gpiod_request_edges(p_hub_gpio_mon_ctx->p_chip,
+								p_hub_gpio_mon_ctx->mon_offsets,
+								p_hub_gpio_mon_ctx->num_mon_lines, p_req)) {
+		hub_pr_err("Failed to request events on monitoring lines : %s\n",
+				   strerror(errno));
+		return -1;
+	}
+
+	num_fds = hub_gpiod_get_fds(p_req, fds, HUB_GPIOD_MAX_LINES);
+	for (i = 0; i < num_fds; i++) {
+		ev.events   = EPOLLIN | EPOLLPRI;
+		ev.data.u32 = i;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[i], &ev)) {
+			hub_pr_err("Failed to watch GPIO event fd %d : %s\n", fds[i],
+					   strerror(errno));
+			hub_gpiod_release(p_req);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * hub_gpio_reactor_thread_func is the GPIO thread of the reactor execution
+ * model.
+ *
+ * It waits in epoll_wait() on the event fds of the monitored lines and on
+ * wake_fd, with no timeout: hub_gpio_mon_wake() writes to wake_fd when the
+ * monitored set changes or HUB shuts down. The events of a ready fd are read
+ * in one go and handed to hub_gpio_dispatch_event(), which queues them for
+ * the pool.
+ *
+ * @param: hub_mon_params is the hub handle passed in
+ *
+ * @return: NULL
+ */
+void *hub_gpio_reactor_thread_func(void *hub_mon_params)
+{
+	int                         epoll_fd, num_ready, num_events, i, j;
+	struct epoll_event          ev, events[HUB_GPIO_REACTOR_MAX_EVENTS];
+	struct hub_gpiod_edge_event edge_events[HUB_GPIOD_MAX_EVENTS];
+	struct hub_gpiod_request    req;
+	uint32_t                    req_bulk_gen    = 0;
+	bool                        lines_requested = false;
+	uint64_t                    wake_ns;
+
+	struct hub_ctx          *p_hub              = NULL;
+	struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx = NULL;
+
+	p_hub              = (struct hub_ctx *)hub_mon_params;
+	p_hub_gpio_mon_ctx = p_hub->p_gpio_mon_ctx;
+
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0) {
+		hub_pr_err("Failed to create GPIO reactor epoll : %s\n",
+				   strerror(errno));
+		return NULL;
+	}
+
+	ev.events   = EPOLLIN;
+	ev.data.u32 = HUB_GPIO_REACTOR_WAKE_TAG;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, p_hub_gpio_mon_ctx->wake_fd, &ev)) {
+		hub_pr_err("Failed to watch GPIO reactor wake_fd : %s\n",
+				   strerror(errno));
+		close(epoll_fd);
+		return NULL;
+	}
+
+	p_hub_gpio_mon_ctx->mon_thread_initialized = true;
+
+	hub_pr_dbg("Launched GPIO reactor thread.\n");
+
+	while (!p_hub_gpio_mon_ctx->terminate_flag) {
+		/* Pick up changes of the monitored set, see hub_gpio_mon_bulk_update */
+		hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
+		if (req_bulk_gen != p_hub_gpio_mon_ctx->mon_bulk_gen) {
+			if (lines_requested) {
+				hub_gpiod_release(&req);
+				lines_requested = false;
+			}
+
+			req_bulk_gen = p_hub_gpio_mon_ctx->mon_bulk_gen;
+
+			if (p_hub_gpio_mon_ctx->num_mon_lines) {
+				if (hub_gpio_reactor_watch(epoll_fd, p_hub_gpio_mon_ctx,
+										   &req)) {
+					hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+					break;
+				}
+				lines_requested = true;
+			}
+		}
+		hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+
+		num_ready = epoll_wait(epoll_fd, events, HUB_GPIO_REACTOR_MAX_EVENTS,
+							   -1);
+		wake_ns   = hub_stats_now_ns();
+		if (num_ready < 0) {
+			if (EINTR == errno) {
+				continue;
+			}
+			hub_pr_err("Failed to wait in GPIO reactor : %s\n",
+					   strerror(errno));
+			break;
+		}
+
+		for (i = 0; i < num_ready; i++) {
+			if (HUB_GPIO_REACTOR_WAKE_TAG == events[i].data.u32) {
+				hub_wake_fd_drain(p_hub_gpio_mon_ctx->wake_fd);
+				continue;
+			}
+
+			num_events = hub_gpiod_read_events(&req, events[i].data.u32,
+											   edge_events,
+											   HUB_GPIOD_MAX_EVENTS);
+			if (num_events < 0) {
+				hub_pr_err("Failed to read GPIO events : %s\n",
+						   strerror(errno));
+				continue;
+			}
+
+			for (j = 0; j < num_events; j++) {
+				hub_gpio_dispatch_event(p_hub, &edge_events[j], wake_ns);
+			}
+		}
+	}
+
+	if (lines_requested) {
+		hub_gpiod_release(&req);
+	}
+	close(epoll_fd);
+
+	hub_pr_dbg("Shutting down GPIO reactor thread.\n");
+
+	return NULL;
+}
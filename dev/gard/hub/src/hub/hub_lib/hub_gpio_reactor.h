@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_GPIO_REACTOR_H__
+#define __HUB_GPIO_REACTOR_H__
+
+#include <sys/epoll.h>
+
+#include "hub_gpio.h"
+
+/* Most epoll events handled per wakeup of the reactor */
+#define HUB_GPIO_REACTOR_MAX_EVENTS (16)
+
+/* epoll data of the wake_fd, the event fds are tagged with their index */
+#define HUB_GPIO_REACTOR_WAKE_TAG   (0xFFFFFFFFU)
+
+/**
+ * hub_gpio_reactor_thread_func is the GPIO thread of the reactor execution
+ * model: a single epoll loop over the event fds of all monitored lines,
+ * which hands rising edges to the worker pool.
+ */
+void *hub_gpio_reactor_thread_func(void *hub_mon_params);
+
+/**
+ * Start the worker pool of the reactor execution model.
+ */
+enum hub_ret_code
+	hub_gpio_pool_start(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx,
+						uint32_t                 num_workers);
+
+/**
+ * Stop and join the worker pool of the reactor execution model.
+ */
+void hub_gpio_pool_stop(struct hub_gpio_mon_ctx *p_hub_gpio_mon_ctx);
+
+/**
+ * Put a line with pending events on the run queue of the worker pool, unless
+ * it is already queued or being handled. Called with event_mutex held.
+ */
+void hub_gpio_pool_schedule(struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx,
+							struct hub_gpio_event_ctx *p_hub_gpio_event_ctx);
+
+#endif /* __HUB_GPIO_REACTOR_H__ */
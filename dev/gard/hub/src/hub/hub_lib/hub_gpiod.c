@@ -0,0 +1,387 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+
+#include "hub_gpio.h"
+#include "hub_gpiod.h"
+
+#if defined(HUB_GPIOD_V2)
+
+/**
+ * hub_gpiod_chip_open opens a GPIO chip given its name in /dev, e.g.
+ * "gpiochip0", or its path.
+ *
+ * @param: p_name is the name or path of the chip
+ *
+ * @return: the chip on success, NULL on failure
+ */
+struct gpiod_chip *hub_gpiod_chip_open(const char *p_name)
+{
+	char path[64];
+
+	if ('/' == p_name[0]) {
+		return gpiod_chip_open(p_name);
+	}
+
+	snprintf(path, sizeof(path), "/dev/%s", p_name);
+
+	return gpiod_chip_open(path);
+}
+
+/**
+ * hub_gpiod_chip_num_lines gets the number of lines of a GPIO chip.
+ *
+ * @param: p_chip is the chip
+ *
+ * @return: number of lines on success, -1 on failure
+ */
+int hub_gpiod_chip_num_lines(struct gpiod_chip *p_chip)
+{
+	struct gpiod_chip_info *p_info;
+	int                     num_lines;
+
+	p_info = gpiod_chip_get_info(p_chip);
+	if (NULL == p_info) {
+		return -1;
+	}
+
+	num_lines = (int)gpiod_chip_info_get_num_lines(p_info);
+	gpiod_chip_info_free(p_info);
+
+	return num_lines;
+}
+
+/**
+ * hub_gpiod_chip_close closes a GPIO chip.
+ *
+ * @param: p_chip is the chip
+ */
+void hub_gpiod_chip_close(struct gpiod_chip *p_chip)
+{
+	gpiod_chip_close(p_chip);
+}
+
+/**
+ * hub_gpiod_request_edges requests both-edge events on a set of lines, as a
+ * single line request. Debouncing and the event clock are set up in the
+ * kernel, see HUB_GPIO_DEBOUNCE_US and HUB_GPIO_EVENT_CLOCK.
+ *
+ * @param: p_chip is the chip of the lines
+ * @param: p_offsets are the offsets of the lines
+ * @param: num_lines is the number of lines
+ * @param: p_req is filled with the request
+ *
+ * @return: 0 on success, -1 on failure with errno set
+ */
+int hub_gpiod_request_edges(struct gpiod_chip        *p_chip,
+							const unsigned int       *p_offsets,
+							unsigned int              num_lines,
+							struct hub_gpiod_request *p_req)
+{
+	struct gpiod_line_settings  *p_settings = NULL;
+	struct gpiod_line_config    *p_line_cfg = NULL;
+	struct gpiod_request_config *p_req_cfg  = NULL;
+	int                          ret        = -1;
+
+	p_req->num_lines      = 0;
+	p_req->p_request      = NULL;
+	p_req->p_event_buffer = NULL;
+
+	p_settings = gpiod_line_settings_new();
+	p_line_cfg = gpiod_line_config_new();
+	p_req_cfg  = gpiod_request_config_new();
+	if ((NULL == p_settings) || (NULL == p_line_cfg) || (NULL == p_req_cfg)) {
+		goto err_hub_gpiod_request_edges_1;
+	}
+
+	if (gpiod_line_settings_set_direction(p_settings,
+										  GPIOD_LINE_DIRECTION_INPUT) ||
+		gpiod_line_settings_set_edge_detection(p_settings,
+											   GPIOD_LINE_EDGE_BOTH) ||
+		gpiod_line_settings_set_event_clock(p_settings, HUB_GPIO_EVENT_CLOCK)) {
+		goto err_hub_gpiod_request_edges_1;
+	}
+	gpiod_line_settings_set_debounce_period_us(p_settings,
+											   HUB_GPIO_DEBOUNCE_US);
+
+	if (gpiod_line_config_add_line_settings(p_line_cfg, p_offsets, num_lines,
+											p_settings)) {
+		goto err_hub_gpiod_request_edges_1;
+	}
+
+	gpiod_request_config_set_consumer(p_req_cfg, HUB_GPIO_MONITOR_STRING);
+	gpiod_request_config_set_event_buffer_size(p_req_cfg,
+											   HUB_GPIO_MAX_PENDING_EVENTS);
+
+	p_req->p_event_buffer = gpiod_edge_event_buffer_new(HUB_GPIOD_MAX_EVENTS);
+	if (NULL == p_req->p_event_buffer) {
+		goto err_hub_gpiod_request_edges_1;
+	}
+
+	p_req->p_request = gpiod_chip_request_lines(p_chip, p_req_cfg, p_line_cfg);
+	if (NULL == p_req->p_request) {
+		gpiod_edge_event_buffer_free(p_req->p_event_buffer);
+		p_req->p_event_buffer = NULL;
+		goto err_hub_gpiod_request_edges_1;
+	}
+
+	p_req->num_lines = num_lines;
+	ret              = 0;
+
+err_hub_gpiod_request_edges_1:
+	/* All NULL safe */
+	gpiod_request_config_free(p_req_cfg);
+	gpiod_line_config_free(p_line_cfg);
+	gpiod_line_settings_free(p_settings);
+
+	return ret;
+}
+
+/**
+ * hub_gpiod_release releases the lines of a request.
+ *
+ * @param: p_req is the request
+ */
+void hub_gpiod_release(struct hub_gpiod_request *p_req)
+{
+	if (NULL != p_req->p_request) {
+		gpiod_line_request_release(p_req->p_request);
+		p_req->p_request = NULL;
+	}
+
+	if (NULL != p_req->p_event_buffer) {
+		gpiod_edge_event_buffer_free(p_req->p_event_buffer);
+		p_req->p_event_buffer = NULL;
+	}
+
+	p_req->num_lines = 0;
+}
+
+/**
+ * hub_gpiod_get_fds gets the event fd of a request, shared by all its lines.
+ *
+ * @param: p_req is the request
+ * @param: p_fds is filled with the fd
+ * @param: max_fds is the size of p_fds
+ *
+ * @return: number of fds, 1 or 0 with nothing requested
+ */
+unsigned int hub_gpiod_get_fds(struct hub_gpiod_request *p_req,
+							   int                      *p_fds,
+							   unsigned int              max_fds)
+{
+	if ((NULL == p_req->p_request) || (0 == max_fds)) {
+		return 0;
+	}
+
+	p_fds[0] = gpiod_line_request_get_fd(p_req->p_request);
+
+	return 1;
+}
+
+/**
+ * hub_gpiod_read_events reads the pending edge events of all the lines of a
+ * request, up to max_events, in a single read.
+ *
+ * @param: p_req is the request
+ * @param: fd_index is unused, there is a single fd
+ * @param: p_events is filled with the events
+ * @param: max_events is the size of p_events
+ *
+ * @return: number of events read, -1 on failure with errno set
+ */
+int hub_gpiod_read_events(struct hub_gpiod_request    *p_req,
+						  unsigned int                 fd_index,
+						  struct hub_gpiod_edge_event *p_events,
+						  unsigned int                 max_events)
+{
+	struct gpiod_edge_event *p_event;
+	int                      num_events, i;
+
+	(void)fd_index;
+
+	if (max_events > HUB_GPIOD_MAX_EVENTS) {
+		max_events = HUB_GPIOD_MAX_EVENTS;
+	}
+
+	num_events = gpiod_line_request_read_edge_events(
+		p_req->p_request, p_req->p_event_buffer, max_events);
+	if (num_events < 0) {
+		return -1;
+	}
+
+	for (i = 0; i < num_events; i++) {
+		p_event = gpiod_edge_event_buffer_get_event(p_req->p_event_buffer, i);
+
+		p_events[i].offset = gpiod_edge_event_get_line_offset(p_event);
+		p_events[i].rising = (GPIOD_EDGE_EVENT_RISING_EDGE ==
+							  gpiod_edge_event_get_event_type(p_event));
+		p_events[i].ts_ns  = gpiod_edge_event_get_timestamp_ns(p_event);
+	}
+
+	return num_events;
+}
+
+#else /* libgpiod v1 */
+
+/**
+ * hub_gpiod_chip_open opens a GPIO chip given its name in /dev, e.g.
+ * "gpiochip0", or its path.
+ *
+ * @param: p_name is the name or path of the chip
+ *
+ * @return: the chip on success, NULL on failure
+ */
+struct gpiod_chip *hub_gpiod_chip_open(const char *p_name)
+{
+	return gpiod_chip_open_lookup(p_name);
+}
+
+/**
+ * hub_gpiod_chip_num_lines gets the number of lines of a GPIO chip.
+ *
+ * @param: p_chip is the chip
+ *
+ * @return: number of lines
+ */
+int hub_gpiod_chip_num_lines(struct gpiod_chip *p_chip)
+{
+	return (int)gpiod_chip_num_lines(p_chip);
+}
+
+/**
+ * hub_gpiod_chip_close closes a GPIO chip.
+ *
+ * @param: p_chip is the chip
+ */
+void hub_gpiod_chip_close(struct gpiod_chip *p_chip)
+{
+	gpiod_chip_close(p_chip);
+}
+
+/**
+ * hub_gpiod_request_edges requests both-edge events on a set of lines, as a
+ * bulk request. Debouncing is not supported by libgpiod v1.
+ *
+ * @param: p_chip is the chip of the lines
+ * @param: p_offsets are the offsets of the lines
+ * @param: num_lines is the number of lines
+ * @param: p_req is filled with the request
+ *
+ * @return: 0 on success, -1 on failure with errno set
+ */
+int hub_gpiod_request_edges(struct gpiod_chip        *p_chip,
+							const unsigned int       *p_offsets,
+							unsigned int              num_lines,
+							struct hub_gpiod_request *p_req)
+{
+	p_req->num_lines = 0;
+	gpiod_line_bulk_init(&p_req->bulk);
+
+	if (gpiod_chip_get_lines(p_chip, (unsigned int *)p_offsets, num_lines,
+							 &p_req->bulk)) {
+		return -1;
+	}
+
+	if (gpiod_line_request_bulk_both_edges_events(&p_req->bulk,
+												  HUB_GPIO_MONITOR_STRING)) {
+		gpiod_line_bulk_init(&p_req->bulk);
+		return -1;
+	}
+
+	p_req->num_lines = num_lines;
+
+	return 0;
+}
+
+/**
+ * hub_gpiod_release releases the lines of a request.
+ *
+ * @param: p_req is the request
+ */
+void hub_gpiod_release(struct hub_gpiod_request *p_req)
+{
+	if (p_req->num_lines) {
+		gpiod_line_release_bulk(&p_req->bulk);
+	}
+
+	gpiod_line_bulk_init(&p_req->bulk);
+	p_req->num_lines = 0;
+}
+
+/**
+ * hub_gpiod_get_fds gets the event fds of the lines of a request, in the
+ * order of the offsets they were requested with.
+ *
+ * @param: p_req is the request
+ * @param: p_fds is filled with the fds
+ * @param: max_fds is the size of p_fds
+ *
+ * @return: number of fds
+ */
+unsigned int hub_gpiod_get_fds(struct hub_gpiod_request *p_req,
+							   int                      *p_fds,
+							   unsigned int              max_fds)
+{
+	unsigned int i;
+
+	for (i = 0; (i < p_req->num_lines) && (i < max_fds); i++) {
+		p_fds[i] =
+			gpiod_line_event_get_fd(gpiod_line_bulk_get_line(&p_req->bulk, i));
+	}
+
+	return i;
+}
+
+/**
+ * hub_gpiod_read_events reads the pending edge events of a line of a request,
+ * up to max_events, in a single read.
+ *
+ * @param: p_req is the request
+ * @param: fd_index is the index of the line in hub_gpiod_get_fds()
+ * @param: p_events is filled with the events
+ * @param: max_events is the size of p_events
+ *
+ * @return: number of events read, -1 on failure with errno set
+ */
+int hub_gpiod_read_events(struct hub_gpiod_request    *p_req,
+						  unsigned int                 fd_index,
+						  struct hub_gpiod_edge_event *p_events,
+						  unsigned int                 max_events)
+{
+	struct gpiod_line_event events[HUB_GPIOD_MAX_EVENTS];
+	struct gpiod_line      *line;
+	int                     num_events, i;
+
+	if (fd_index >= p_req->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (max_events > HUB_GPIOD_MAX_EVENTS) {
+		max_events = HUB_GPIOD_MAX_EVENTS;
+	}
+
+	line       = gpiod_line_bulk_get_line(&p_req->bulk, fd_index);
+	num_events = gpiod_line_event_read_multiple(line, events, max_events);
+	if (num_events < 0) {
+		return -1;
+	}
+
+	for (i = 0; i < num_events; i++) {
+		p_events[i].offset = gpiod_line_offset(line);
+		p_events[i].rising =
+			(GPIOD_LINE_EVENT_RISING_EDGE == events[i].event_type);
+		p_events[i].ts_ns  = (uint64_t)events[i].ts.tv_sec * 1000000000ULL +
+							(uint64_t)events[i].ts.tv_nsec;
+	}
+
+	return num_events;
+}
+
+#endif /* HUB_GPIOD_V2 */
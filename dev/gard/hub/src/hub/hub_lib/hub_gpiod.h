@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_GPIOD_H__
+#define __HUB_GPIOD_H__
+
+#include "gard_info.h"
+
+/**
+ * Note:
+ * 1. types.h included from gard_info.h already defines a bool.
+ * 2. gpiod.h also includes stdbool.h leading to a define clash.
+ * 3. We make sure that stdbool.h is not included by the following #define
+ *
+ * stdbool.h for CM5 Raspbian OS is at:
+ * /usr/lib/gcc/aarch64-linux-gnu/12/include/stdbool.h
+ *
+ * Other libgpiod function headers and defines are obtained from a regular
+ * include of gpiod.h
+ */
+#define _STDBOOL_H
+#include <gpiod.h>
+
+/**
+ * This file is the libgpiod backend of the GPIO app data path: opening the
+ * chip, requesting edge events on a set of lines and reading them.
+ *
+ * Two backends are built from the same calls, selected at build time from
+ * the version of libgpiod found by pkg-config, see hub_lib/Makefile:
+ * - libgpiod v1 (HUB_GPIOD_V2 not defined): a gpiod_line_bulk, with an event
+ *   fd per line.
+ * - libgpiod v2 (HUB_GPIOD_V2 defined): a single gpiod_line_request for all
+ *   the lines, with one event fd and an edge event buffer, so that a burst of
+ *   edges on any of the lines is drained in one read.
+ */
+
+/* Most lines requested at once, the limit of the GPIO uAPI */
+#define HUB_GPIOD_MAX_LINES            (64)
+
+/* Most edge events read from an event fd at once */
+#define HUB_GPIOD_MAX_EVENTS           (16)
+
+/**
+ * Debounce period of the monitored lines in microseconds, done by the
+ * kernel. 0 disables it. Only supported by the libgpiod v2 backend.
+ */
+#ifndef HUB_GPIO_DEBOUNCE_US
+#define HUB_GPIO_DEBOUNCE_US           (0)
+#endif
+
+/**
+ * Clock of the edge event timestamps of the libgpiod v2 backend. Set it to
+ * GPIOD_LINE_CLOCK_HTE on a GPIO controller with a hardware timestamp engine.
+ * The app data latencies are measured against CLOCK_MONOTONIC, see
+ * struct hub_appdata_event_times, so they are only meaningful with the
+ * default.
+ */
+#ifndef HUB_GPIO_EVENT_CLOCK
+#define HUB_GPIO_EVENT_CLOCK           GPIOD_LINE_CLOCK_MONOTONIC
+#endif
+
+/* An edge event read from a requested line */
+struct hub_gpiod_edge_event {
+	unsigned int offset;  /* Offset of the line on the chip */
+	bool         rising;  /* Rising edge, falling edge otherwise */
+	uint64_t     ts_ns;   /* Timestamp of the edge */
+};
+
+/* Edge events requested on a set of lines */
+struct hub_gpiod_request {
+	unsigned int                    num_lines;
+#if defined(HUB_GPIOD_V2)
+	struct gpiod_line_request      *p_request;
+	struct gpiod_edge_event_buffer *p_event_buffer;
+#else
+	struct gpiod_line_bulk          bulk;
+#endif
+};
+
+/**
+ * hub_gpiod_chip_open opens a GPIO chip given its name in /dev, e.g.
+ * "gpiochip0", or its path.
+ */
+struct gpiod_chip *hub_gpiod_chip_open(const char *p_name);
+
+/**
+ * hub_gpiod_chip_num_lines returns the number of lines of a GPIO chip, or -1
+ * on failure.
+ */
+int hub_gpiod_chip_num_lines(struct gpiod_chip *p_chip);
+
+/**
+ * hub_gpiod_chip_close closes a GPIO chip opened by hub_gpiod_chip_open().
+ */
+void hub_gpiod_chip_close(struct gpiod_chip *p_chip);
+
+/**
+ * hub_gpiod_request_edges requests both-edge events on a set of lines of a
+ * chip. It returns 0 on success, -1 on failure with errno set.
+ */
+int hub_gpiod_request_edges(struct gpiod_chip        *p_chip,
+							const unsigned int       *p_offsets,
+							unsigned int              num_lines,
+							struct hub_gpiod_request *p_req);
+
+/**
+ * hub_gpiod_release releases the lines requested by hub_gpiod_request_edges().
+ */
+void hub_gpiod_release(struct hub_gpiod_request *p_req);
+
+/**
+ * hub_gpiod_get_fds fills p_fds with the event fds of a request: one per line
+ * with libgpiod v1, one for all lines with v2. It returns the number of fds.
+ */
+unsigned int hub_gpiod_get_fds(struct hub_gpiod_request *p_req,
+							   int                      *p_fds,
+							   unsigned int              max_fds);
+
+/**
+ * hub_gpiod_read_events reads the pending edge events of the event fd of
+ * index fd_index in hub_gpiod_get_fds(). It returns the number of events
+ * read, -1 on failure with errno set.
+ */
+int hub_gpiod_read_events(struct hub_gpiod_request    *p_req,
+						  unsigned int                 fd_index,
+						  struct hub_gpiod_edge_event *p_events,
+						  unsigned int                 max_events);
+
+#endif /* __HUB_GPIOD_H__ */
@@ -0,0 +1,501 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "hub_health.h"
+#include "hub_gard_cmds.h"
+#include "hub_globals.h"
+#include "hub_stats.h"
+#include "hub_usb.h"
+#include "hub_pool.h"
+
+/**
+ * GARD health monitor
+ *
+ * One thread per HUB, from hub_init() to hub_fini(). Every
+ * HUB_HEALTH_TICK_MS it looks at the GARDs:
+ * 1. A GARD whose USB bus lost its device, or that did not answer the last
+ *    probe on its command bus, is lost: the app is told HUB_GARD_EVENT_LOST.
+ * 2. A lost GARD is discovered again every HUB_HEALTH_REBIND_MS. Once it
+ *    answers with the same identity, its app data subscription is set up on
+ *    GARD again and the app is told HUB_GARD_EVENT_REATTACHED.
+ *
+ * The GARD handle, its busses and the GPIO app data path stay in place
+ * throughout, so the app callbacks need not be registered again.
+ *
+ * Every "clock_sync_ms" it also maps the timer of each GARD attached to the
+ * host clock, see hub_sync_gard_clock(), so that the time stamps of results
+ * from several GARDs can be compared, see hub_gard_ms_to_host_ns(). A GARD
+ * restarts its timer when it resets, so a lost GARD is synchronized again
+ * from scratch.
+ */
+
+/* Listing of static functions defined in this file */
+static bool  hub_health_usb_is_gone(const struct hub_gard_info *p_gard);
+static void  hub_health_notify(struct hub_ctx       *p_hub,
+							   struct hub_gard_info *p_gard,
+							   enum hub_gard_event   event);
+static void  hub_health_sync_clock(struct hub_health_ctx *p_ctx,
+								   uint32_t               gard_index,
+								   uint64_t               now_ns);
+static void  hub_health_check_gard(struct hub_health_ctx *p_ctx,
+								   uint32_t               gard_index,
+								   uint64_t               now_ns);
+static void *hub_health_thread_func(void *p_args);
+
+/**
+ * Tell if an open USB bus of a GARD lost its device.
+ *
+ * @param: p_gard is the GARD
+ *
+ * @return: true if a USB bus of the GARD has left
+ */
+static bool hub_health_usb_is_gone(const struct hub_gard_info *p_gard)
+{
+	const struct hub_gard_bus *busses[] = {p_gard->control_bus,
+										   p_gard->data_bus};
+	uint32_t                   i;
+
+	for (i = 0; i < sizeof(busses) / sizeof(busses[0]); i++) {
+		if ((NULL != busses[i]) && (HUB_GARD_BUS_USB == busses[i]->types) &&
+			busses[i]->usb.is_open &&
+			hub_usb_device_is_gone(busses[i]->usb.bus_hdl)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Tell the app about a GARD link event, if it asked to be.
+ */
+static void hub_health_notify(struct hub_ctx       *p_hub,
+							  struct hub_gard_info *p_gard,
+							  enum hub_gard_event   event)
+{
+	if (NULL != p_hub->gard_event_cb) {
+		p_hub->gard_event_cb(p_hub->p_gard_event_ctx, (gard_handle_t)p_gard,
+							 event);
+	}
+}
+
+/**
+ * Synchronize the clock of one GARD, if due. The drift is measured from a
+ * synchronization at least HUB_CLOCK_SYNC_DRIFT_MIN_MS old, the last drift
+ * being kept until there is one, and at most HUB_CLOCK_SYNC_REBASE_MS old,
+ * to follow the temperature of the oscillators.
+ *
+ * @param: p_ctx is the health monitor context
+ * @param: gard_index is the index of the GARD
+ * @param: now_ns is the time of this check
+ */
+static void hub_health_sync_clock(struct hub_health_ctx *p_ctx,
+								  uint32_t               gard_index,
+								  uint64_t               now_ns)
+{
+	struct hub_ctx             *p_hub   = p_ctx->p_hub;
+	struct hub_gard_info       *p_gard  = &p_hub->p_gards[gard_index];
+	struct hub_health_gard     *p_state = &p_ctx->p_gards[gard_index];
+	struct hub_gard_clock_sync  sync;
+	uint64_t                    base_age_ns;
+
+	if ((0 == p_hub->clock_sync_ms) || (now_ns < p_state->next_sync_ns)) {
+		return;
+	}
+	p_state->next_sync_ns = now_ns + (uint64_t)p_hub->clock_sync_ms * 1000000ULL;
+
+	sync = p_state->clock_base;
+	if (HUB_SUCCESS != hub_sync_gard_clock((gard_handle_t)p_gard,
+										   HUB_CLOCK_SYNC_SAMPLES, &sync)) {
+		hub_pr_dbg("GARD %u clock not synchronized\n", p_gard->gard_index);
+		return;
+	}
+
+	/* A GARD reset went unnoticed if its timer went back */
+	if ((0 == p_state->clock_base.gard_freq_hz) ||
+		(sync.gard_ticks <= p_state->clock_base.gard_ticks)) {
+		p_state->clock_base = sync;
+	}
+
+	base_age_ns = sync.host_ns - p_state->clock_base.host_ns;
+	if (base_age_ns < HUB_CLOCK_SYNC_DRIFT_MIN_MS * 1000000ULL) {
+		sync.drift_ppb = p_state->clock_sync.drift_ppb;
+	}
+	if (base_age_ns >= HUB_CLOCK_SYNC_REBASE_MS * 1000000ULL) {
+		p_state->clock_base = sync;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_state->clock_sync = sync;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_pr_dbg("GARD %u clock offset %lld ns, drift %d ppb, rtt %llu ns\n",
+			   p_gard->gard_index, (long long)sync.offset_ns, sync.drift_ppb,
+			   (unsigned long long)sync.round_trip_ns);
+}
+
+/**
+ * Check one GARD, and re-attach it if it is lost and due for an attempt.
+ *
+ * @param: p_ctx is the health monitor context
+ * @param: gard_index is the index of the GARD
+ * @param: now_ns is the time of this check
+ */
+static void hub_health_check_gard(struct hub_health_ctx *p_ctx,
+								  uint32_t               gard_index,
+								  uint64_t               now_ns)
+{
+	struct hub_ctx           *p_hub   = p_ctx->p_hub;
+	struct hub_gard_info     *p_gard  = &p_hub->p_gards[gard_index];
+	struct hub_health_gard   *p_state = &p_ctx->p_gards[gard_index];
+	struct hub_gard_identity  identity;
+	uint64_t                  probe_ns;
+
+	probe_ns = (uint64_t)p_hub->health_probe_ms * 1000000ULL;
+
+	if (!p_state->is_lost) {
+		if (hub_health_usb_is_gone(p_gard)) {
+			__atomic_store_n(&p_state->is_lost, true, __ATOMIC_SEQ_CST);
+		} else if (probe_ns && (now_ns >= p_state->next_check_ns)) {
+			p_state->next_check_ns = now_ns + probe_ns;
+			if ((HUB_SUCCESS != hub_probe_gard(p_gard, &identity)) ||
+				(identity.device_id != p_gard->identity.device_id)) {
+				__atomic_store_n(&p_state->is_lost, true, __ATOMIC_SEQ_CST);
+			}
+		}
+
+		if (!p_state->is_lost) {
+			hub_health_sync_clock(p_ctx, gard_index, now_ns);
+			return;
+		}
+
+		hub_pr_warn("GARD %u lost, re-attaching\n", p_gard->gard_index);
+		hub_health_notify(p_hub, p_gard, HUB_GARD_EVENT_LOST);
+
+		/* Its results in flight are not coming */
+		hub_pool_gard_lost(p_hub, gard_index);
+
+		/* Its timer restarts with its firmware */
+		hub_mutex_lock(&p_ctx->lock);
+		memset(&p_state->clock_sync, 0, sizeof(p_state->clock_sync));
+		hub_mutex_unlock(&p_ctx->lock);
+		memset(&p_state->clock_base, 0, sizeof(p_state->clock_base));
+
+		/* Firmware resets take a while, let it boot before trying */
+		p_state->next_check_ns = now_ns +
+								 HUB_HEALTH_REBIND_MS * 1000000ULL;
+		return;
+	}
+
+	if (now_ns < p_state->next_check_ns) {
+		return;
+	}
+	p_state->next_check_ns = now_ns + HUB_HEALTH_REBIND_MS * 1000000ULL;
+
+	if (HUB_SUCCESS != hub_rebind_gard(p_gard)) {
+		hub_pr_dbg("GARD %u not back yet\n", p_gard->gard_index);
+		return;
+	}
+
+	/* GARD forgot the subscription when it reset */
+	if ((NULL != p_gard->p_subscribe_ctx) &&
+		(HUB_SUCCESS != hub_subscribe_rearm(p_gard))) {
+		hub_pr_warn("GARD %u app data not subscribed again, retrying\n",
+					p_gard->gard_index);
+		return;
+	}
+
+	__atomic_store_n(&p_state->is_lost, false, __ATOMIC_SEQ_CST);
+	p_state->next_check_ns = now_ns + probe_ns;
+	p_state->next_sync_ns  = now_ns;
+
+	hub_pr_warn("GARD %u re-attached\n", p_gard->gard_index);
+	hub_health_notify(p_hub, p_gard, HUB_GARD_EVENT_REATTACHED);
+}
+
+/**
+ * Health monitor thread.
+ *
+ * @param: p_args is the struct hub_health_ctx
+ *
+ * @return: NULL
+ */
+static void *hub_health_thread_func(void *p_args)
+{
+	struct hub_health_ctx *p_ctx = (struct hub_health_ctx *)p_args;
+	struct timespec        deadline;
+	uint32_t               i;
+
+	hub_mutex_lock(&p_ctx->lock);
+	while (!p_ctx->terminate_flag) {
+		hub_deadline_from_now(&deadline, HUB_HEALTH_TICK_MS);
+		(void)hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+		if (p_ctx->terminate_flag) {
+			break;
+		}
+		hub_mutex_unlock(&p_ctx->lock);
+
+		for (i = 0; i < p_ctx->p_hub->num_gards; i++) {
+			hub_health_check_gard(p_ctx, i, hub_stats_now_ns());
+		}
+
+		hub_mutex_lock(&p_ctx->lock);
+	}
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return NULL;
+}
+
+/**
+ * hub_health_start starts the health monitor thread of a HUB.
+ *
+ * @param: p_hub is the HUB context, with its GARDs discovered
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INIT on failure
+ */
+enum hub_ret_code hub_health_start(struct hub_ctx *p_hub)
+{
+	struct hub_health_ctx *p_ctx;
+	uint64_t               now_ns = hub_stats_now_ns();
+	uint32_t               i;
+
+	p_ctx = (struct hub_health_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate health monitor context\n");
+		goto err_health_start_1;
+	}
+
+	p_ctx->p_hub   = p_hub;
+	p_ctx->p_gards = (struct hub_health_gard *)calloc(
+		p_hub->num_gards ? p_hub->num_gards : 1, sizeof(*p_ctx->p_gards));
+	if (NULL == p_ctx->p_gards) {
+		hub_pr_err("Failed to allocate GARD link states\n");
+		goto err_health_start_2;
+	}
+
+	for (i = 0; i < p_hub->num_gards; i++) {
+		p_ctx->p_gards[i].next_check_ns =
+			now_ns + (uint64_t)p_hub->health_probe_ms * 1000000ULL;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ctx->lock)) {
+		goto err_health_start_3;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ctx->cond_var)) {
+		goto err_health_start_4;
+	}
+
+	if (HUB_SUCCESS != hub_thread_create(&p_ctx->thread_hdl, NULL,
+										 HUB_THREAD_CLASS_BUS_IO,
+										 "hub_health", hub_health_thread_func,
+										 p_ctx)) {
+		hub_pr_err("Failed to create health monitor thread\n");
+		goto err_health_start_5;
+	}
+
+	p_hub->p_health_ctx = p_ctx;
+
+	return HUB_SUCCESS;
+
+err_health_start_5:
+	hub_cond_var_destroy(&p_ctx->cond_var);
+err_health_start_4:
+	hub_mutex_destroy(&p_ctx->lock);
+err_health_start_3:
+	free(p_ctx->p_gards);
+err_health_start_2:
+	free(p_ctx);
+err_health_start_1:
+	return HUB_FAILURE_INIT;
+}
+
+/**
+ * hub_health_stop stops the health monitor thread of a HUB, if running.
+ *
+ * @param: p_hub is the HUB context
+ */
+void hub_health_stop(struct hub_ctx *p_hub)
+{
+	struct hub_health_ctx *p_ctx = p_hub->p_health_ctx;
+
+	if (NULL == p_ctx) {
+		return;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->terminate_flag = true;
+	hub_cond_var_signal(&p_ctx->cond_var);
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_thread_join(p_ctx->thread_hdl, NULL);
+
+	hub_cond_var_destroy(&p_ctx->cond_var);
+	hub_mutex_destroy(&p_ctx->lock);
+	free(p_ctx->p_gards);
+	free(p_ctx);
+
+	p_hub->p_health_ctx = NULL;
+}
+
+/**
+ * hub_set_gard_event_cb sets the callback told when a GARD is lost and
+ * re-attached.
+ *
+ * @param: hub is the HUB handle
+ * @param: cb is the callback, NULL for none
+ * @param: p_cb_ctx is an opaque callback context
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INIT if called after hub_init()
+ */
+enum hub_ret_code hub_set_gard_event_cb(hub_handle_t        hub,
+										hub_gard_event_cb_t cb,
+										void               *p_cb_ctx)
+{
+	struct hub_ctx *p_hub = (struct hub_ctx *)hub;
+
+	if ((NULL == p_hub) || (HUB_INIT_DONE == p_hub->hub_state)) {
+		hub_pr_err("Invalid HUB handle or hub_init() already done\n");
+		return HUB_FAILURE_INIT;
+	}
+
+	p_hub->gard_event_cb    = cb;
+	p_hub->p_gard_event_ctx = p_cb_ctx;
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Get the health monitor state of a GARD.
+ *
+ * @param: p_gard is the GARD
+ *
+ * @return: The state, NULL if no health monitor runs
+ */
+static struct hub_health_gard *hub_health_gard_state(
+	const struct hub_gard_info *p_gard)
+{
+	struct hub_ctx *p_hub = (struct hub_ctx *)p_gard->hub;
+
+	/* The states are indexed as the GARD handles */
+	if ((NULL == p_hub) || (NULL == p_hub->p_health_ctx) ||
+		(p_gard < p_hub->p_gards) ||
+		(p_gard >= &p_hub->p_gards[p_hub->num_gards])) {
+		return NULL;
+	}
+
+	return &p_hub->p_health_ctx->p_gards[p_gard - p_hub->p_gards];
+}
+
+/**
+ * hub_health_gard_is_lost tells if the health monitor lost a GARD and has not
+ * re-attached it yet.
+ *
+ * @param: p_hub is the HUB
+ * @param: gard_index is the index of the GARD
+ *
+ * @return: true if the GARD is lost, false if not or if no monitor runs
+ */
+bool hub_health_gard_is_lost(struct hub_ctx *p_hub, uint32_t gard_index)
+{
+	if ((NULL == p_hub->p_health_ctx) || (gard_index >= p_hub->num_gards)) {
+		return false;
+	}
+
+	return __atomic_load_n(&p_hub->p_health_ctx->p_gards[gard_index].is_lost,
+						   __ATOMIC_SEQ_CST);
+}
+
+/**
+ * hub_get_gard_clock gets the last mapping of the timer of a GARD to the host
+ * clock, kept up to date every "clock_sync_ms".
+ *
+ * @param: gard is the GARD handle
+ * @param: p_sync is filled with the mapping
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_GARD_TIME if the GARD is not synchronized yet
+ */
+enum hub_ret_code hub_get_gard_clock(gard_handle_t               gard,
+									 struct hub_gard_clock_sync *p_sync)
+{
+	struct hub_gard_info   *p_gard = (struct hub_gard_info *)gard;
+	struct hub_health_gard *p_state;
+	struct hub_health_ctx  *p_ctx;
+
+	if ((NULL == p_gard) || (NULL == p_sync) ||
+		(NULL == (p_state = hub_health_gard_state(p_gard)))) {
+		return HUB_FAILURE_GARD_TIME;
+	}
+
+	p_ctx = ((struct hub_ctx *)p_gard->hub)->p_health_ctx;
+	hub_mutex_lock(&p_ctx->lock);
+	*p_sync = p_state->clock_sync;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return (0 != p_sync->gard_freq_hz) ? HUB_SUCCESS : HUB_FAILURE_GARD_TIME;
+}
+
+/**
+ * hub_gard_time_to_host_ns maps a time of the timer of a GARD, such as the
+ * capture time of an image, to the host clock.
+ *
+ * @param: gard is the GARD handle
+ * @param: gard_ticks is the GARD time
+ *
+ * @return: The host CLOCK_MONOTONIC time in nanoseconds, 0 if the GARD is not
+ *          synchronized yet
+ */
+uint64_t hub_gard_time_to_host_ns(gard_handle_t gard, uint64_t gard_ticks)
+{
+	struct hub_gard_clock_sync sync;
+
+	if (HUB_SUCCESS != hub_get_gard_clock(gard, &sync)) {
+		return 0;
+	}
+
+	return hub_gard_ticks_to_host_ns(&sync, gard_ticks);
+}
+
+/**
+ * hub_gard_ms_to_host_ns maps the time stamp of a result packet of a GARD, the
+ * low 32 bits of its time in milliseconds, to the host clock. It is taken as
+ * the one closest to the last synchronization, so it wraps around properly.
+ *
+ * @param: gard is the GARD handle
+ * @param: gard_ms is the time stamp
+ *
+ * @return: The host CLOCK_MONOTONIC time in nanoseconds, 0 if the GARD is not
+ *          synchronized yet
+ */
+uint64_t hub_gard_ms_to_host_ns(gard_handle_t gard, uint32_t gard_ms)
+{
+	struct hub_gard_clock_sync sync;
+	uint32_t                   ticks_per_ms;
+	int64_t                    sync_ms, full_ms;
+
+	if (HUB_SUCCESS != hub_get_gard_clock(gard, &sync)) {
+		return 0;
+	}
+
+	/* As GARD converts its timer to milliseconds */
+	ticks_per_ms = sync.gard_freq_hz / 1000U;
+	if (0 == ticks_per_ms) {
+		return 0;
+	}
+
+	sync_ms = (int64_t)(sync.gard_ticks / ticks_per_ms);
+	full_ms = sync_ms + (int32_t)(gard_ms - (uint32_t)sync_ms);
+	if (full_ms < 0) {
+		full_ms = 0;
+	}
+
+	return hub_gard_ticks_to_host_ns(&sync, (uint64_t)full_ms * ticks_per_ms);
+}
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_HEALTH_H__
+#define __HUB_HEALTH_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+/* The monitor looks at USB departures this often */
+#define HUB_HEALTH_TICK_MS (200)
+
+/* A lost GARD is discovered again this often */
+#define HUB_HEALTH_REBIND_MS (1000)
+
+/* GET_GARD_TIME round trips per clock synchronization */
+#define HUB_CLOCK_SYNC_SAMPLES (8)
+
+/* The drift is only measured over at least this long */
+#define HUB_CLOCK_SYNC_DRIFT_MIN_MS (10000)
+
+/* The drift is measured from a synchronization at most this old */
+#define HUB_CLOCK_SYNC_REBASE_MS (600000)
+
+/* Link state of a GARD */
+struct hub_health_gard {
+	bool     is_lost;
+	uint64_t next_check_ns; /* Next probe, or rebind attempt once lost */
+
+	/* Mapping of its timer to the host clock, gard_freq_hz 0 until synced */
+	uint64_t                   next_sync_ns;
+	struct hub_gard_clock_sync clock_sync; /* Under the lock of the monitor */
+	struct hub_gard_clock_sync clock_base; /* Drift measured from it */
+};
+
+struct hub_health_ctx {
+	struct hub_ctx         *p_hub;
+	struct hub_health_gard *p_gards;
+	hub_mutex_t             lock;
+	hub_cond_var_t          cond_var;
+	bool                    terminate_flag;
+	hub_thread_hdl_t        thread_hdl;
+};
+
+/**
+ * hub_health_start starts the health monitor thread of a HUB, see
+ * hub_set_gard_event_cb().
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_INIT on failure
+ */
+enum hub_ret_code hub_health_start(struct hub_ctx *p_hub);
+
+/**
+ * hub_health_stop stops the health monitor thread, if running. A GARD
+ * being re-attached is left as it is.
+ */
+void hub_health_stop(struct hub_ctx *p_hub);
+
+/* Bytes read at most for the acknowledgement of a bus resynchronization */
+#define HUB_RESYNC_MAX_SKIP (65536)
+
+/* Defined in hub_init.c, next to discovery */
+enum hub_ret_code hub_probe_gard(struct hub_gard_info     *p_gard,
+								 struct hub_gard_identity *p_identity);
+enum hub_ret_code hub_rebind_gard(struct hub_gard_info *p_gard);
+enum hub_ret_code hub_resync_gard_bus(struct hub_gard_bus *p_bus, int bus_hdl);
+enum hub_ret_code hub_step_up_uart_baudrate(struct hub_gard_bus *p_bus);
+
+/* Defined in hub_subscribe.c */
+enum hub_ret_code hub_subscribe_rearm(struct hub_gard_info *p_gard);
+
+#endif /* __HUB_HEALTH_H__ */
@@ -19,6 +19,68 @@
  */
 static struct hub_gard_bus_i2c_props *p_i2c_ctx = NULL;
 
+/**
+ * Check the configured bus speed against the clock the adapter runs at.
+ *
+ * i2c-dev has no call to change the SCL rate; it is fixed by the
+ * "clock-frequency" property of the adapter's device tree node (e.g.
+ * dtparam=i2c_arm_baudrate=1000000 for Fast-mode Plus on a Raspberry Pi).
+ * We read it back and warn if it differs from "i2c_speed", so that a slow
+ * bus does not go unnoticed, or if it is faster than the GARD I2C target
+ * supports. The rate read back is kept in adapter_speed, as the transfer
+ * rate of the bus.
+ *
+ * @param: p_i2c is the I2C bus being opened
+ */
+static void hub_i2c_check_speed(struct hub_gard_bus_i2c_props *p_i2c)
+{
+	char     clk_path[PATH_MAX] = {0};
+	uint8_t  clk_be[4];
+	uint32_t adapter_speed;
+	int      fd;
+	ssize_t  nread;
+
+	p_i2c->adapter_speed = 0;
+
+	snprintf(clk_path, sizeof(clk_path), I2C_ADAPTER_CLOCK_PATH_FMT,
+			 p_i2c->num);
+
+	fd = open(clk_path, O_RDONLY);
+	if (fd < 0) {
+		hub_pr_dbg("No adapter clock at %s, assuming %u Hz\n", clk_path,
+				   p_i2c->speed);
+		return;
+	}
+
+	nread = read(fd, clk_be, sizeof(clk_be));
+	close(fd);
+
+	if (sizeof(clk_be) != (size_t)nread) {
+		return;
+	}
+
+	/* Device tree cells are big endian */
+	adapter_speed = ((uint32_t)clk_be[0] << 24) | ((uint32_t)clk_be[1] << 16) |
+					((uint32_t)clk_be[2] << 8) | (uint32_t)clk_be[3];
+
+	if (0 == adapter_speed) {
+		return;
+	}
+
+	if ((p_i2c->speed > 0) && (adapter_speed != p_i2c->speed)) {
+		hub_pr_warn("i2c-%u runs at %u Hz, i2c_speed asks for %u Hz. "
+					"Set the adapter clock-frequency in the device tree\n",
+					p_i2c->num, adapter_speed, p_i2c->speed);
+	}
+
+	if (adapter_speed > I2C_MAX_SPEED_HZ) {
+		hub_pr_warn("i2c-%u runs at %u Hz, above the %u Hz of GARD\n",
+					p_i2c->num, adapter_speed, I2C_MAX_SPEED_HZ);
+	}
+
+	p_i2c->adapter_speed = adapter_speed;
+}
+
 /**
  * Open an I2C bus given an opaque pointer representing the bus's properties.
  * Returns a bus handle on success.
@@ -57,6 +119,8 @@ int32_t hub_i2c_device_open(void *param)
 		goto err_i2c_open_2;
 	}
 
+	hub_i2c_check_speed(p_i2c_ctx);
+
 	hub_pr_dbg("Opened bus:%d slave:%d speed:%d with bus_hdl:%d\n",
 			   p_i2c_ctx->num, p_i2c_ctx->slave_id, p_i2c_ctx->speed, bus_hdl);
 
@@ -104,6 +168,141 @@ err_write:
 	return nwrite;
 }
 
+/**
+ * Send the messages queued in an I2C_RDWR ioctl.
+ *
+ * @param: i2c_bus_hdl is the handle to the I2C bus
+ * @param: p_rdwr holds the queued messages
+ * @param: num_msgs is the number of queued messages
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int32_t hub_i2c_rdwr_flush(int                         i2c_bus_hdl,
+								  struct i2c_rdwr_ioctl_data *p_rdwr,
+								  int                         num_msgs)
+{
+	p_rdwr->nmsgs = num_msgs;
+	if (ioctl(i2c_bus_hdl, I2C_RDWR, p_rdwr) != num_msgs) {
+		hub_pr_err("Error in I2C_RDWR on %d, msgs:%d\n", i2c_bus_hdl,
+				   num_msgs);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Move an iovec array over the I2C bus with I2C_RDWR ioctls. Each buffer is
+ * cut into messages of at most max_msg_sz bytes and up to
+ * I2C_RDWR_IOCTL_MAX_MSGS messages go down in one ioctl.
+ *
+ * @param: i2c_bus_hdl is the handle to the I2C bus
+ * @param: p_iov is an array of buffers to write from / read into
+ * @param: iovcnt is the number of buffers in p_iov
+ * @param: flags is 0 for writes, I2C_M_RD for reads
+ * @param: max_msg_sz is the largest single message for this direction
+ *
+ * @return: Number of bytes transferred.
+ */
+static int32_t hub_i2c_device_rdwr(int                 i2c_bus_hdl,
+								   const struct iovec *p_iov,
+								   int                 iovcnt,
+								   uint16_t            flags,
+								   uint32_t            max_msg_sz)
+{
+	struct i2c_msg             msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	struct i2c_rdwr_ioctl_data rdwr;
+	uint32_t                   msg_len, offset, batch_len;
+	int                        num_msgs = 0;
+	int                        i;
+	ssize_t                    ntotal = 0;
+
+	if ((NULL == p_i2c_ctx) || (iovcnt <= 0) ||
+		(iovcnt > HUB_GARD_BUS_MAX_IOVCNT)) {
+		hub_pr_err("Invalid I2C vector op on %d\n", i2c_bus_hdl);
+		goto err_rdwr;
+	}
+
+	rdwr.msgs = msgs;
+	batch_len = 0;
+
+	for (i = 0; i < iovcnt; i++) {
+		offset = 0;
+		while (offset < p_iov[i].iov_len) {
+			msg_len = hub_min_uint32(p_iov[i].iov_len - offset, max_msg_sz);
+
+			msgs[num_msgs].addr  = p_i2c_ctx->slave_id;
+			msgs[num_msgs].flags = flags;
+			msgs[num_msgs].len   = msg_len;
+			msgs[num_msgs].buf   = (uint8_t *)p_iov[i].iov_base + offset;
+			num_msgs++;
+
+			offset    += msg_len;
+			batch_len += msg_len;
+
+			/* Flush when the ioctl is full */
+			if (I2C_RDWR_IOCTL_MAX_MSGS == num_msgs) {
+				if (0 != hub_i2c_rdwr_flush(i2c_bus_hdl, &rdwr, num_msgs)) {
+					goto err_rdwr;
+				}
+				ntotal    += batch_len;
+				batch_len  = 0;
+				num_msgs   = 0;
+			}
+		}
+	}
+
+	/* Flush the messages left, whatever the length of the last buffer */
+	if (0 != num_msgs) {
+		if (0 != hub_i2c_rdwr_flush(i2c_bus_hdl, &rdwr, num_msgs)) {
+			goto err_rdwr;
+		}
+		ntotal += batch_len;
+	}
+
+	hub_pr_dbg("Moved %ld bytes\n", ntotal);
+
+err_rdwr:
+	return (int32_t)ntotal;
+}
+
+/**
+ * Perform a gathered write of several buffers on the I2C bus represented
+ * by the given bus handle using a single I2C_RDWR ioctl per
+ * I2C_RDWR_IOCTL_MAX_MSGS messages.
+ *
+ * @param: i2c_bus_hdl is the handle to the I2C bus
+ * @param: p_iov is an array of buffers with data to write
+ * @param: iovcnt is the number of buffers in p_iov
+ *
+ * @return: Number of bytes written.
+ */
+int32_t hub_i2c_device_writev(int                 i2c_bus_hdl,
+							  const struct iovec *p_iov,
+							  int                 iovcnt)
+{
+	return hub_i2c_device_rdwr(i2c_bus_hdl, p_iov, iovcnt, 0,
+							   MAX_I2C_SEND_DATA_SZ);
+}
+
+/**
+ * Perform a scattered read into several buffers on the I2C bus represented
+ * by the given bus handle, in chunks of MAX_I2C_RECV_DATA_SZ.
+ *
+ * @param: i2c_bus_hdl is the handle to the I2C bus
+ * @param: p_iov is an array of buffers to be filled by the read
+ * @param: iovcnt is the number of buffers in p_iov
+ *
+ * @return: Number of bytes read.
+ */
+int32_t hub_i2c_device_readv(int                 i2c_bus_hdl,
+							 const struct iovec *p_iov,
+							 int                 iovcnt)
+{
+	return hub_i2c_device_rdwr(i2c_bus_hdl, p_iov, iovcnt, I2C_M_RD,
+							   MAX_I2C_RECV_DATA_SZ);
+}
+
 /**
  * TBD-DPN: Revisit the error behaviour of this call
  * Also, change the bus_hdl to a bus context for supporting multiple
@@ -111,6 +310,10 @@ err_write:
  *
  *  Perform a read operation on the I2C bus represented by the given bus handle.
  *
+ * The read is cut into MAX_I2C_RECV_DATA_SZ messages that go down in as few
+ * I2C_RDWR ioctls as possible, with a repeated START between them instead of
+ * a full START/STOP transaction per chunk.
+ *
  * @param: i2c_bus_hdl is the handle to the I2C bus
  * @param: p_buffer is a pointer to a buffer to be filled by the read
  * @param: count is the number of bytes to be read
@@ -120,39 +323,13 @@ err_write:
  */
 int32_t hub_i2c_device_read(int i2c_bus_hdl, void *p_buffer, uint32_t count)
 {
-	/* We read the given size in bytes in chunks of MAX_I2C_RECV_DATA_SZ */
-	ssize_t  nread, ntotal = 0;
-	uint32_t chunk_index = 0;
-	uint32_t num_chunks  = count / MAX_I2C_RECV_DATA_SZ;
-	uint32_t left_over   = count % MAX_I2C_RECV_DATA_SZ;
-
-	/* Read the data in chunks of MAX_I2C_RECV_DATA_SZ */
-	while (chunk_index < num_chunks) {
-		/* Read the next chunk of data */
-		nread = read(i2c_bus_hdl, p_buffer + chunk_index * MAX_I2C_RECV_DATA_SZ,
-					 MAX_I2C_RECV_DATA_SZ);
-		if (MAX_I2C_RECV_DATA_SZ != (size_t)nread) {
-			hub_pr_err("Error reading from %d, chunk_index:%d, nread:%ld\n",
-					   i2c_bus_hdl, chunk_index, nread);
-			goto err_read;
-		}
-		ntotal += nread;
-		chunk_index++;
-	}
+	struct iovec iov = {.iov_base = p_buffer, .iov_len = count};
 
-	if (left_over > 0) {
-		nread = read(i2c_bus_hdl, p_buffer + num_chunks * MAX_I2C_RECV_DATA_SZ,
-					 left_over);
-		if (nread != left_over) {
-			hub_pr_err("Error reading from %d, left_over:%d, nread:%ld\n",
-					   i2c_bus_hdl, left_over, nread);
-			goto err_read;
-		}
-		ntotal += nread;
+	if (0 == count) {
+		return 0;
 	}
 
-err_read:
-	return (int32_t)ntotal;
+	return hub_i2c_device_readv(i2c_bus_hdl, &iov, 1);
 }
 
 /**
@@ -11,6 +11,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
 #include "gard_info.h"
@@ -18,6 +20,22 @@
 /* Starting preamble of I2C bus string in Linux */
 #define I2C_BUS_STRING_PREAMBLE "/dev/i2c-"
 
+/**
+ * Device tree clock of an I2C adapter, a single big endian cell in Hz
+ */
+#define I2C_ADAPTER_CLOCK_PATH_FMT                                             \
+	"/sys/class/i2c-adapter/i2c-%u/of_node/clock-frequency"
+
+/* Bus speed assumed when host_config.json has no "i2c_speed" */
+#define I2C_DEFAULT_SPEED_HZ    (100000)
+
+/**
+ * Fastest bus speed the GARD I2C target supports, Fast-mode Plus. It needs
+ * GARD built with the target clock stretching, see GARD_I2C_CLK_STRETCH in
+ * the firmware Makefile.vars.
+ */
+#define I2C_MAX_SPEED_HZ        (1000000)
+
 /**
  * Maximum size of I2C data for reading from GARD in a single
  * bulk read transaction
@@ -28,6 +46,12 @@
  */
 #define MAX_I2C_RECV_DATA_SZ    (3 * 1024)
 
+/**
+ * Maximum size of a single I2C message written to GARD.
+ * i2c-dev rejects I2C_RDWR messages larger than this.
+ */
+#define MAX_I2C_SEND_DATA_SZ    (8 * 1024)
+
 /**
  * Open an I2C bus given an opaque pointer representing the bus's properties.
  * Returns a bus handle on success.
@@ -41,6 +65,7 @@ int32_t hub_i2c_device_open(void *param);
  * instances of the same bus.
  *
  *  Perform a read operation on the I2C bus represented by the given bus handle.
+ *  Chunks are packed into I2C_RDWR ioctls.
  */
 int32_t hub_i2c_device_read(int i2c_bus_hdl, void *p_buffer, uint32_t count);
 
@@ -55,6 +80,22 @@ int32_t hub_i2c_device_read(int i2c_bus_hdl, void *p_buffer, uint32_t count);
 int32_t
 	hub_i2c_device_write(int i2c_bus_hdl, const void *p_buffer, uint32_t count);
 
+/**
+ * Perform a gathered write of several buffers on the I2C bus represented
+ * by the given bus handle with I2C_RDWR.
+ */
+int32_t hub_i2c_device_writev(int                 i2c_bus_hdl,
+							  const struct iovec *p_iov,
+							  int                 iovcnt);
+
+/**
+ * Perform a scattered read into several buffers on the I2C bus represented
+ * by the given bus handle with I2C_RDWR.
+ */
+int32_t hub_i2c_device_readv(int                 i2c_bus_hdl,
+							 const struct iovec *p_iov,
+							 int                 iovcnt);
+
 /**
  * TBD-DPN: Revisit the return code for this call.
  * Also, change the bus_hdl to a bus context for supporting mutiple
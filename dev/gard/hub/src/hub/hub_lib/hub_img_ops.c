@@ -7,6 +7,52 @@
 
 #include "hub_img_ops.h"
 
+/**
+ * Wait on I2C until GARD FW has queued the capture_rescaled_image response.
+ *
+ * GARD FW only queues the response once its pipeline has paused after the
+ * rescale stage. Until then, reads from the I2C slave return idle bytes.
+ * We read one byte at a time with a growing backoff until it is the first
+ * byte of the START_OF_DATA_MARKER. That byte is already consumed from the
+ * response and is stored in p_first_byte.
+ *
+ * @param: p_cmd_bus is the I2C bus the request was sent on
+ * @param: bus_hdl is the handle to the open I2C command bus
+ * @param: p_first_byte is filled with the first byte of the response
+ *
+ * @return: 0 when the response is ready, -1 on timeout or bus error
+ */
+static int hub_wait_for_rescaled_image_i2c(struct hub_gard_bus *p_cmd_bus,
+										   int                  bus_hdl,
+										   uint8_t             *p_first_byte)
+{
+	const uint32_t sod_marker = START_OF_DATA_MARKER;
+	uint32_t       poll_us    = HUB_RESCALED_IMAGE_READY_POLL_MIN_US;
+	uint32_t       waited_us  = 0;
+
+	while (waited_us < HUB_RESCALED_IMAGE_READY_TIMEOUT_US) {
+		if (1 != p_cmd_bus->fops.device_read(bus_hdl, p_first_byte, 1)) {
+			hub_pr_err("Error polling capture_rescaled_image response\n");
+			return -1;
+		}
+
+		/* The response starts with the marker, in little endian */
+		if (*p_first_byte == (uint8_t)(sod_marker & 0xFF)) {
+			hub_pr_dbg("Rescaled image ready after %u usecs\n", waited_us);
+			return 0;
+		}
+
+		usleep(poll_us);
+		waited_us += poll_us;
+		poll_us    = hub_min_uint32(poll_us * 2,
+									HUB_RESCALED_IMAGE_READY_POLL_MAX_US);
+	}
+
+	hub_pr_err("Timeout waiting for capture_rescaled_image response\n");
+
+	return -1;
+}
+
 /**
  * Capture a rescaled image from the connected GARD
  * and get the properties of the image.
@@ -22,6 +68,15 @@
  * - HUB / Host Applicaiton should also call hub_send_resume_pipeline() after
  *   receiving the image content to signal GARD FW to resume the paused AI
  *   workload.
+ * - With no_pause set in struct hub_img_ops_ctx, GARD FW copies the rescaled
+ *   image to a snapshot buffer instead and keeps its pipelines running. No
+ *   hub_send_resume_pipeline() is needed then, unless GARD FW does not support
+ *   it and paused them anyway, as told by pipeline_paused.
+ * - With a USB data bus, the command goes on the I2C / UART control bus of
+ *   the GARD, and hub_recv_data_from_gard() reads the image over USB, from
+ *   image_buffer_address in HRAM. A GARD on USB alone cannot take it.
+ * - The snapshot can be a part of the image, decimated and encoded, see
+ *   struct hub_img_ops_ctx. hub_decode_rescaled_image() decodes it.
  *
  * @param p_gard_handle GARD handle
  * @param p_img_ops_ctx HUB image operations context
@@ -38,6 +93,10 @@ enum hub_ret_code
 	int                     bus_hdl;
 	ssize_t                 nread, nwrite;
 	enum hub_gard_bus_types bus_type;
+	struct iovec            iov[2];
+	uint8_t                *p_resp;
+	uint32_t                resp_len;
+	struct hub_gard_bus    *p_cmd_bus;
 
 	struct hub_gard_info   *gard = (struct hub_gard_info *)p_gard_handle;
 
@@ -58,23 +117,45 @@ enum hub_ret_code
 	img_props_cmd.command_id = CAPTURE_RESCALED_IMAGE;
 	img_props_cmd.capture_rescaled_image_request.camera_id =
 		p_img_ops_ctx->camera_id;
-	img_props_cmd.capture_rescaled_image_request.rsvd1 = 0;
+	img_props_cmd.capture_rescaled_image_request.flags =
+		p_img_ops_ctx->no_pause ? CAPTURE_RESCALED_IMAGE__NO_PAUSE : 0;
+	img_props_cmd.capture_rescaled_image_request.decimation =
+		p_img_ops_ctx->decimation;
+	img_props_cmd.capture_rescaled_image_request.roi_x = p_img_ops_ctx->roi_x;
+	img_props_cmd.capture_rescaled_image_request.roi_y = p_img_ops_ctx->roi_y;
+	img_props_cmd.capture_rescaled_image_request.roi_width =
+		p_img_ops_ctx->roi_width;
+	img_props_cmd.capture_rescaled_image_request.roi_height =
+		p_img_ops_ctx->roi_height;
+	img_props_cmd.capture_rescaled_image_request.codec =
+		(uint8_t)p_img_ops_ctx->codec;
 	img_props_cmd.capture_rescaled_image_request.end_of_data_marker =
 		END_OF_DATA_MARKER;
 
+	/**
+	 * The USB data bus only reaches GARD memory: the command goes on the
+	 * control bus of the GARD, and the image is read over USB by
+	 * hub_recv_data_from_gard().
+	 */
+	p_cmd_bus = gard->cmd_bus;
+	if ((HUB_GARD_BUS_USB == p_cmd_bus->types) &&
+		(NULL != gard->control_bus)) {
+		p_cmd_bus = gard->control_bus;
+	}
+
 	/**
 	 * Send the get image props command to the GARD
 	 */
-	bus_type = gard->data_bus->types;
+	bus_type = p_cmd_bus->types;
 	switch (bus_type) {
 	case HUB_GARD_BUS_I2C:
-		bus_hdl = gard->data_bus->i2c.bus_hdl;
+		bus_hdl = p_cmd_bus->i2c.bus_hdl;
 		break;
 	case HUB_GARD_BUS_UART:
-		bus_hdl = gard->data_bus->uart.bus_hdl;
+		bus_hdl = p_cmd_bus->uart.bus_hdl;
 		break;
 	case HUB_GARD_BUS_USB:
-		hub_pr_err("Bus not supported for capture_rescaled_image!\n");
+		hub_pr_err("No I2C / UART control bus for capture_rescaled_image!\n");
 		goto err_capture_rescaled_image_1;
 		break;
 	default:
@@ -83,46 +164,47 @@ enum hub_ret_code
 		goto err_capture_rescaled_image_1;
 	}
 
-	/* Lock the data bus mutex before bus operations */
-	hub_mutex_lock(&gard->data_bus->bus_mutex);
+	/* Lock the command bus mutex before bus operations */
+	hub_mutex_lock(&p_cmd_bus->bus_mutex);
 
 	/* We now assume that the bus is open! */
 
-	/* Send the command to the GARD */
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &img_props_cmd.command_id, sizeof(img_props_cmd.command_id));
-	if (sizeof(img_props_cmd.command_id) != nwrite) {
-		hub_pr_err("Error sending capture_rescaled_image cmd\n");
-		goto err_capture_rescaled_image_2;
-	}
+	/* Send the command id and request to the GARD in one go */
+	iov[0].iov_base = &img_props_cmd.command_id;
+	iov[0].iov_len  = sizeof(img_props_cmd.command_id);
+	iov[1].iov_base = &img_props_cmd.command_body;
+	iov[1].iov_len  = sizeof(img_props_cmd.capture_rescaled_image_request);
 
-	nwrite = gard->data_bus->fops.device_write(
-		bus_hdl, &img_props_cmd.command_body,
-		sizeof(img_props_cmd.capture_rescaled_image_request));
-	if (sizeof(img_props_cmd.capture_rescaled_image_request) != nwrite) {
+	nwrite = p_cmd_bus->fops.device_writev(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
 		hub_pr_err("Error sending capture_rescaled_image request\n");
 		goto err_capture_rescaled_image_2;
 	}
 
+	p_resp   = (uint8_t *)&img_props_response.capture_rescaled_image_response;
+	resp_len = sizeof(img_props_response.capture_rescaled_image_response);
+
 	/**
-	 * If the bus_type is I2C, introduce a sleep of 1 second to give GARD FW
-	 * some time to pause its pipelines and return with image props.
+	 * On I2C, wait until GARD FW has paused its pipelines and queued the
+	 * image props. On UART the read simply blocks until they arrive.
 	 */
 	if (HUB_GARD_BUS_I2C == bus_type) {
-		sleep(1);
+		if (hub_wait_for_rescaled_image_i2c(p_cmd_bus, bus_hdl, p_resp)) {
+			goto err_capture_rescaled_image_2;
+		}
+		p_resp++;
+		resp_len--;
 	}
 
-	/* Receive the command response from the GARD */
-	nread = gard->data_bus->fops.device_read(
-		bus_hdl, (void *)&img_props_response.capture_rescaled_image_response,
-		sizeof(img_props_response.capture_rescaled_image_response));
-	if (sizeof(img_props_response.capture_rescaled_image_response) != nread) {
+	/* Receive the (rest of the) command response from the GARD */
+	nread = p_cmd_bus->fops.device_read(bus_hdl, p_resp, resp_len);
+	if (resp_len != nread) {
 		hub_pr_err("Error receiving capture_rescaled_image response\n");
 		goto err_capture_rescaled_image_2;
 	}
 
-	/* Unlock the data bus mutex after bus operations */
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	/* Unlock the command bus mutex after bus operations */
+	hub_mutex_unlock(&p_cmd_bus->bus_mutex);
 
 	if ((START_OF_DATA_MARKER !=
 		 img_props_response.capture_rescaled_image_response
@@ -152,15 +234,175 @@ enum hub_ret_code
 		img_props_response.capture_rescaled_image_response.image_buffer_address;
 	p_img_ops_ctx->image_format =
 		img_props_response.capture_rescaled_image_response.image_format;
+	p_img_ops_ctx->pipeline_paused =
+		img_props_response.capture_rescaled_image_response.pipeline_paused;
+	p_img_ops_ctx->codec = (enum hub_image_codecs)
+		img_props_response.capture_rescaled_image_response.codec;
+	p_img_ops_ctx->frame_seq =
+		img_props_response.capture_rescaled_image_response.frame_seq;
+	p_img_ops_ctx->capture_time =
+		((uint64_t)img_props_response.capture_rescaled_image_response
+			 .capture_time_hi
+		 << 32) |
+		img_props_response.capture_rescaled_image_response.capture_time_lo;
 
 	hub_pr_dbg("CAPTURE RESCALED IMAGE SUCCESS!\n");
 
 	return HUB_SUCCESS;
 
 err_capture_rescaled_image_2:
-	ret = gard->data_bus->fops.device_close(bus_hdl);
+	ret = p_cmd_bus->fops.device_close(bus_hdl);
 	(void)ret;
-	hub_mutex_unlock(&gard->data_bus->bus_mutex);
+	hub_mutex_unlock(&p_cmd_bus->bus_mutex);
 err_capture_rescaled_image_1:
 	return HUB_FAILURE_CAPTURE_RESCALED_IMAGE;
-}
\ No newline at end of file
+}
+
+_Static_assert((int)HUB_IMAGE_CODEC__NONE == (int)IMAGE_CODEC__NONE &&
+				   (int)HUB_IMAGE_CODEC__RLE == (int)IMAGE_CODEC__RLE &&
+				   (int)HUB_IMAGE_CODEC__DELTA_RLE ==
+					   (int)IMAGE_CODEC__DELTA_RLE &&
+				   (int)HUB_IMAGE_CODEC__PACK4 == (int)IMAGE_CODEC__PACK4,
+			   "enum hub_image_codecs is out of sync with the interface");
+
+/**
+ * Decode PackBits bytes into the samples of one row.
+ *
+ * @param: p_in is the encoded bytes
+ * @param: in_len is the count of bytes left at p_in
+ * @param: p_row is filled with the samples
+ * @param: width is the count of samples of the row
+ *
+ * @return: the count of bytes of p_in used, 0 if they are not valid
+ */
+static uint32_t hub_unpackbits_row(const uint8_t *p_in, uint32_t in_len,
+								   uint8_t *p_row, uint32_t width)
+{
+	uint32_t in = 0, out = 0, count;
+	uint8_t  hdr;
+
+	while (out < width) {
+		if (in >= in_len) {
+			return 0;
+		}
+
+		hdr = p_in[in++];
+		if (hdr < 128) {
+			/* hdr + 1 literal bytes */
+			count = hdr + 1U;
+			if ((count > (width - out)) || (count > (in_len - in))) {
+				return 0;
+			}
+			memcpy(&p_row[out], &p_in[in], count);
+			in += count;
+		} else if (hdr > 128) {
+			/* One byte repeated 257 - hdr times */
+			count = 257U - hdr;
+			if ((count > (width - out)) || (in >= in_len)) {
+				return 0;
+			}
+			memset(&p_row[out], p_in[in++], count);
+		} else {
+			continue;
+		}
+		out += count;
+	}
+
+	return in;
+}
+
+/**
+ * Decode the image received from GARD after
+ * hub_capture_rescaled_image_from_gard() into raw samples.
+ *
+ * @param p_img_ops_ctx HUB image operations context
+ * @param p_out is filled with the decoded image
+ * @param out_size is the size of p_out
+ *
+ * @return enum hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_CAPTURE_RESCALED_IMAGE on failure
+ */
+enum hub_ret_code
+	hub_decode_rescaled_image(const struct hub_img_ops_ctx *p_img_ops_ctx,
+							  void                         *p_out,
+							  uint32_t                      out_size)
+{
+	const uint8_t *p_in;
+	uint8_t       *p_row;
+	uint32_t       planes, rows, width, row, idx, in = 0, used;
+	uint8_t        prev;
+
+	if ((NULL == p_img_ops_ctx) || (NULL == p_img_ops_ctx->p_image_buffer) ||
+		(NULL == p_out)) {
+		hub_pr_err("Error: p_img_ops_ctx or a buffer is NULL\n");
+		return HUB_FAILURE_CAPTURE_RESCALED_IMAGE;
+	}
+
+	planes = (HUB_IMAGE_FORMAT__GRAYSCALE == p_img_ops_ctx->image_format) ? 1
+																		   : 3;
+	width  = p_img_ops_ctx->h_size;
+	rows   = planes * p_img_ops_ctx->v_size;
+	if (out_size < (rows * width)) {
+		hub_pr_err("Error: %u bytes too small for the decoded image\n",
+				   out_size);
+		return HUB_FAILURE_CAPTURE_RESCALED_IMAGE;
+	}
+
+	p_in = (const uint8_t *)p_img_ops_ctx->p_image_buffer;
+	for (row = 0; row < rows; row++) {
+		p_row = (uint8_t *)p_out + (row * width);
+
+		switch (p_img_ops_ctx->codec) {
+		case HUB_IMAGE_CODEC__NONE:
+			used = (width <= (p_img_ops_ctx->image_buffer_size - in)) ? width
+																	  : 0;
+			if (0 != used) {
+				memcpy(p_row, &p_in[in], width);
+			}
+			break;
+
+		case HUB_IMAGE_CODEC__RLE:
+		case HUB_IMAGE_CODEC__DELTA_RLE:
+			used = hub_unpackbits_row(&p_in[in],
+									  p_img_ops_ctx->image_buffer_size - in,
+									  p_row, width);
+			if ((0 != used) &&
+				(HUB_IMAGE_CODEC__DELTA_RLE == p_img_ops_ctx->codec)) {
+				for (idx = 0, prev = 0; idx < width; idx++) {
+					p_row[idx] = (uint8_t)(p_row[idx] + prev);
+					prev       = p_row[idx];
+				}
+			}
+			break;
+
+		case HUB_IMAGE_CODEC__PACK4:
+			used = (width + 1) / 2;
+			if (used > (p_img_ops_ctx->image_buffer_size - in)) {
+				used = 0;
+				break;
+			}
+			/* Spread the 4 bits over the 8 of the sample. */
+			for (idx = 0; idx < width; idx++) {
+				prev = (0 == (idx & 1)) ? (p_in[in + (idx / 2)] >> 4)
+										: (p_in[in + (idx / 2)] & 0x0F);
+				p_row[idx] = (uint8_t)((prev << 4) | prev);
+			}
+			break;
+
+		default:
+			hub_pr_err("Error: unknown image codec %u\n",
+					   (unsigned int)p_img_ops_ctx->codec);
+			return HUB_FAILURE_CAPTURE_RESCALED_IMAGE;
+		}
+
+		if (0 == used) {
+			hub_pr_err("Error: image data ends or is not valid at row %u\n",
+					   row);
+			return HUB_FAILURE_CAPTURE_RESCALED_IMAGE;
+		}
+		in += used;
+	}
+
+	return HUB_SUCCESS;
+}
@@ -15,6 +15,17 @@
 #include "gard_hub_iface.h"
 #include "hub_globals.h"
 
+/**
+ * Readiness polling of the capture_rescaled_image response on I2C.
+ * GARD's I2C slave does not stretch the clock, so reads made before the
+ * response is queued return idle bytes. HUB polls for the first byte of the
+ * START_OF_DATA_MARKER, backing off from the min to the max poll period,
+ * for at most HUB_RESCALED_IMAGE_READY_TIMEOUT_US.
+ */
+#define HUB_RESCALED_IMAGE_READY_POLL_MIN_US (500)
+#define HUB_RESCALED_IMAGE_READY_POLL_MAX_US (16000)
+#define HUB_RESCALED_IMAGE_READY_TIMEOUT_US  (2000000)
+
 /**
  * Capture a rescaled image from the connected GARD
  * and get the properties of the image.
@@ -35,4 +46,14 @@ enum hub_ret_code
 	hub_capture_rescaled_image_from_gard(gard_handle_t           p_gard_handle,
 										 struct hub_img_ops_ctx *p_img_ops_ctx);
 
+/**
+ * Decode the image received from GARD after
+ * hub_capture_rescaled_image_from_gard(), as encoded with the codec of
+ * struct hub_img_ops_ctx, into raw samples.
+ */
+enum hub_ret_code
+	hub_decode_rescaled_image(const struct hub_img_ops_ctx *p_img_ops_ctx,
+							  void                         *p_out,
+							  uint32_t                      out_size);
+
 #endif /* __HUB_IMG_OPS_H__ */
\ No newline at end of file
@@ -23,14 +23,112 @@
 
 #include "hub_threading.h"
 #include "hub_gpio.h"
+#include "hub_gpio_reactor.h"
+#include "hub_uart.h"
+#include "hub_bulk_ops.h"
+#include "hub_stats.h"
+#include "hub_config_cache.h"
+#include "hub_health.h"
+#include "hub_pool.h"
+#include "hub_recorder.h"
+#include "hub_wait_any.h"
+
+/* Most threads probing the buses at once in hub_discover_gards() */
+#define HUB_DISCOVER_MAX_PROBE_THREADS (4)
+
+/**
+ * Bus benchmark of hub_discover_gards(): the latency of a bus is the best of
+ * HUB_BUS_BENCH_ROUNDS GARD_DISCOVERY round trips, and its bulk rate that of
+ * a HUB_BUS_BENCH_BULK_SIZE bytes transfer, one latency plus the payload at
+ * the bit rate of the bus.
+ */
+#define HUB_BUS_BENCH_ROUNDS    (4)
+#define HUB_BUS_BENCH_BULK_SIZE (4096ULL)
+
+/* Busses of a GARD: command, control, data and fallback data */
+#define HUB_GARD_NUM_BUS_ROLES (4)
+
+/* Discovery probe of one bus, and its outcome */
+struct hub_discover_probe {
+	struct hub_gard_bus *p_bus;
+	enum hub_ret_code    ret;
+};
+
+/* Buses to probe, shared by the discovery probe threads */
+struct hub_discover_pool {
+	struct hub_discover_probe *p_probes;
+	uint32_t                   num_probes;
+	uint32_t                   next_probe; /* Next one to take, under lock */
+	hub_mutex_t                lock;
+	/**
+	 * The I2C and UART drivers keep a single open bus context each, so
+	 * two buses of the same type are never probed at the same time.
+	 */
+	hub_mutex_t                bus_type_mutex[HUB_GARD_NR_BUSSES];
+};
 
 /* Static functions listing */
+static enum hub_ret_code
+	hub_parse_discover_response(const struct _gard_discovery_response *p_resp,
+								struct hub_gard_identity *p_identity);
 static enum hub_ret_code hub_send_discover_command(struct hub_gard_bus *p_bus);
 static enum hub_ret_code hub_parse_gard_json(char *p_gard_json_filename,
 											 struct hub_ctx       *p_hub,
 											 struct hub_gard_info *p_gard_hdl);
-static enum hub_ret_code hub_get_gard_profile_id(struct hub_ctx *p_hub,
+static enum hub_ret_code hub_get_gard_profile_id(struct hub_gard_bus *p_bus,
 												 int32_t *gard_profile_id);
+static void hub_select_gard_busses(struct hub_ctx       *p_hub,
+								   struct hub_gard_info *p_gard);
+static void hub_bench_bus_latency(struct hub_gard_bus *p_bus);
+
+/**
+ * HUB INIT internal function
+ *
+ * Check a discovery response and take the GARD identity from it.
+ *
+ * @param: p_resp is the discovery response read off the bus
+ * @param: p_identity is filled with the GARD identity
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_GARD_DISCOVER if the response is not from a GARD
+ */
+static enum hub_ret_code
+	hub_parse_discover_response(const struct _gard_discovery_response *p_resp,
+								struct hub_gard_identity *p_identity)
+{
+	if ((START_OF_DATA_MARKER != p_resp->start_of_data_marker) ||
+		(END_OF_DATA_MARKER != p_resp->end_of_data_marker)) {
+		hub_pr_err("Error in discover response\n");
+		return HUB_FAILURE_GARD_DISCOVER;
+	}
+
+	hub_pr_dbg("Read result -> %s\n", p_resp->signature);
+
+	if (0 != strncmp(HUB_GARD_DISCOVER_SIGNATURE,
+					 (const char *)p_resp->signature,
+					 sizeof(HUB_GARD_DISCOVER_SIGNATURE))) {
+		hub_pr_err("Error in discovery signature\n");
+		return HUB_FAILURE_GARD_DISCOVER;
+	}
+
+	p_identity->device_id =
+		((uint64_t)p_resp->device_id[1] << 32) | p_resp->device_id[0];
+	p_identity->profile_id   = p_resp->profile_id;
+	p_identity->fw_version   = p_resp->fw_version;
+	p_identity->capabilities = p_resp->capabilities;
+	p_identity->max_mtu_size = p_resp->max_mtu_size;
+	p_identity->is_valid     = true;
+
+	hub_pr_dbg("GARD device ID 0x%016llx, profile ID %u, FW %u.%u.%u, "
+			   "capabilities 0x%x\n",
+			   (unsigned long long)p_identity->device_id,
+			   p_identity->profile_id, (p_identity->fw_version >> 16) & 0xFFU,
+			   (p_identity->fw_version >> 8) & 0xFFU,
+			   p_identity->fw_version & 0xFFU, p_identity->capabilities);
+
+	return HUB_SUCCESS;
+}
 
 /**
  * HUB INIT internal function
@@ -92,10 +190,16 @@ static enum hub_ret_code hub_send_discover_command(struct hub_gard_bus *p_bus)
 		goto err_gard_discover_2;
 	}
 
-	/* Bus response collect */
+	/* Bus response collect, with the short probe timeout on UART */
+	if (HUB_GARD_BUS_UART == bus_type) {
+		p_bus->uart.is_probing = true;
+	}
 	nread = p_bus->fops.device_read(
 		bus_hdl, (void *)&discover_response.gard_discovery_response,
 		sizeof(discover_response.gard_discovery_response));
+	if (HUB_GARD_BUS_UART == bus_type) {
+		p_bus->uart.is_probing = false;
+	}
 	if (sizeof(discover_response.gard_discovery_response) != nread) {
 		hub_pr_err("Error getting discover response\n");
 		goto err_gard_discover_3;
@@ -107,24 +211,9 @@ static enum hub_ret_code hub_send_discover_command(struct hub_gard_bus *p_bus)
 	/* Unlock after successful discovery transaction (bus stays open) */
 	hub_mutex_unlock(&p_bus->bus_mutex);
 
-	/* Parse discovery response */
-	if ((START_OF_DATA_MARKER !=
-		 discover_response.gard_discovery_response.start_of_data_marker) ||
-		(END_OF_DATA_MARKER !=
-		 discover_response.gard_discovery_response.end_of_data_marker)) {
-		hub_pr_err("Error in discover response\n");
-		goto err_gard_discover_1;
-	}
-
-	hub_pr_dbg("Read result -> %s\n",
-			   discover_response.gard_discovery_response.signature);
-
-	if (0 !=
-		strncmp(
-			HUB_GARD_DISCOVER_SIGNATURE,
-			(const char *)discover_response.gard_discovery_response.signature,
-			sizeof(HUB_GARD_DISCOVER_SIGNATURE))) {
-		hub_pr_err("Error in discovery signature\n");
+	if (HUB_SUCCESS !=
+		hub_parse_discover_response(
+			&discover_response.gard_discovery_response, &p_bus->identity)) {
 		goto err_gard_discover_1;
 	}
 
@@ -142,25 +231,562 @@ err_gard_discover_1:
 /**
  * HUB INIT internal function
  *
- * This is a dummy function, pending implementation in GARD FW
- * Right now it returns a canned profile ID 12345 *
+ * Move a discovered UART bus to its target_baudrate and hw_flow_control.
+ *
+ * GARD is asked to switch with SET_UART_PARAMETERS at the current rate. Once
+ * it has ACKed, HUB moves its own side to the new rate and flow control and
+ * re-runs discovery to make sure both ends agree. A NAK leaves the bus as it
+ * is, RTS/CTS included.
+ * Also used by hub_reload_config() to switch a running bus.
+ *
+ * @param: p_bus is the discovered (and open) HUB-GARD bus
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success or if there is nothing to change
+ * 		HUB_FAILURE_GARD_DISCOVER if GARD is lost at the new rate
+ */
+enum hub_ret_code hub_step_up_uart_baudrate(struct hub_gard_bus *p_bus)
+{
+	int                    bus_hdl;
+	ssize_t                nread, nwrite;
+	uint32_t               old_baudrate, new_baudrate;
+	struct iovec           iov[2];
+
+	struct _host_requests  set_uart_cmd      = {0};
+	struct _host_responses set_uart_response = {0};
+
+	if (HUB_GARD_BUS_UART != p_bus->types) {
+		return HUB_SUCCESS;
+	}
+
+	bus_hdl      = p_bus->uart.bus_hdl;
+	old_baudrate = p_bus->uart.baudrate;
+	new_baudrate = p_bus->uart.target_baudrate ? p_bus->uart.target_baudrate
+											   : old_baudrate;
+
+	if ((new_baudrate == old_baudrate) &&
+		(p_bus->uart.hw_flow_control == p_bus->uart.hw_flow_control_on)) {
+		return HUB_SUCCESS;
+	}
+
+	set_uart_cmd.command_id  = SET_UART_PARAMETERS;
+	set_uart_cmd.set_uart_parameters_request.baud_rate = new_baudrate;
+	set_uart_cmd.set_uart_parameters_request.hw_flow_control =
+		p_bus->uart.hw_flow_control ? 1 : 0;
+	set_uart_cmd.set_uart_parameters_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	iov[0].iov_base = &set_uart_cmd.command_id;
+	iov[0].iov_len  = sizeof(set_uart_cmd.command_id);
+	iov[1].iov_base = &set_uart_cmd.command_body;
+	iov[1].iov_len  = sizeof(set_uart_cmd.set_uart_parameters_request);
+
+	hub_mutex_lock(&p_bus->bus_mutex);
+
+	nwrite = p_bus->fops.device_writev(bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
+		hub_pr_err("Error sending set_uart_parameters request\n");
+		goto err_step_up_uart_1;
+	}
+
+	nread = p_bus->fops.device_read(
+		bus_hdl, &set_uart_response.set_uart_parameters_response,
+		sizeof(set_uart_response.set_uart_parameters_response));
+	if (sizeof(set_uart_response.set_uart_parameters_response) != nread) {
+		hub_pr_err("Error getting set_uart_parameters response\n");
+		goto err_step_up_uart_1;
+	}
+
+	if (ACK_BYTE !=
+		set_uart_response.set_uart_parameters_response.ack_or_nak) {
+		hub_pr_warn("GARD NAKed %u baud, RTS/CTS %s, staying at %u\n",
+					new_baudrate, p_bus->uart.hw_flow_control ? "on" : "off",
+					old_baudrate);
+		hub_mutex_unlock(&p_bus->bus_mutex);
+		return HUB_SUCCESS;
+	}
+
+	if ((new_baudrate != old_baudrate) &&
+		hub_uart_device_set_baudrate(bus_hdl, new_baudrate)) {
+		goto err_step_up_uart_1;
+	}
+
+	if ((p_bus->uart.hw_flow_control != p_bus->uart.hw_flow_control_on) &&
+		hub_uart_device_set_flow_control(bus_hdl,
+										 p_bus->uart.hw_flow_control)) {
+		goto err_step_up_uart_1;
+	}
+
+	/* GARD is back at this rate once it resets, see hub_rebind_gard() */
+	if ((new_baudrate != old_baudrate) && (0 == p_bus->uart.base_baudrate)) {
+		p_bus->uart.base_baudrate = old_baudrate;
+	}
+
+	hub_mutex_unlock(&p_bus->bus_mutex);
+
+	/* GARD must answer at the new rate */
+	if (HUB_SUCCESS != hub_send_discover_command(p_bus)) {
+		hub_pr_err("GARD lost after switching to %u baud\n", new_baudrate);
+		goto err_step_up_uart_2;
+	}
+
+	hub_pr_dbg("UART bus stepped up from %u to %u baud\n", old_baudrate,
+			   p_bus->uart.baudrate);
+
+	return HUB_SUCCESS;
+
+err_step_up_uart_1:
+	hub_mutex_unlock(&p_bus->bus_mutex);
+err_step_up_uart_2:
+	return HUB_FAILURE_GARD_DISCOVER;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Get the handle of a bus, whatever its type.
+ *
+ * @param: p_bus is the HUB-GARD bus
+ *
+ * @return: bus handle, negative if the bus type is not known
+ */
+static int hub_gard_bus_hdl(const struct hub_gard_bus *p_bus)
+{
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		return p_bus->i2c.bus_hdl;
+	case HUB_GARD_BUS_UART:
+		return p_bus->uart.bus_hdl;
+	case HUB_GARD_BUS_USB:
+		return p_bus->usb.bus_hdl;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * hub_probe_gard checks that a GARD still answers on its command bus, with
+ * a GARD_DISCOVERY round trip at the usual read timeout. The bus is taken
+ * like a control transaction and stays open whatever the outcome.
+ *
+ * @param: p_gard is the GARD
+ * @param: p_identity is filled with the identity the GARD answered with
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_GARD_DISCOVER if the GARD did not answer
+ */
+enum hub_ret_code hub_probe_gard(struct hub_gard_info     *p_gard,
+								 struct hub_gard_identity *p_identity)
+{
+	struct hub_gard_bus   *p_bus = p_gard->cmd_bus;
+	int                    bus_hdl;
+	ssize_t                nread, nwrite;
+
+	struct _host_requests  discover_cmd      = {0};
+	struct _host_responses discover_response = {0};
+
+	discover_cmd.command_id = GARD_DISCOVERY;
+
+	hub_bus_lock_ctrl(p_bus);
+
+	bus_hdl = hub_gard_bus_hdl(p_bus);
+	nwrite  = p_bus->fops.device_write(bus_hdl, &discover_cmd.command_id,
+									   sizeof(discover_cmd.command_id));
+	if (sizeof(discover_cmd.command_id) != nwrite) {
+		goto err_probe_gard_1;
+	}
+
+	nread = p_bus->fops.device_read(
+		bus_hdl, (void *)&discover_response.gard_discovery_response,
+		sizeof(discover_response.gard_discovery_response));
+	if (sizeof(discover_response.gard_discovery_response) != nread) {
+		goto err_probe_gard_1;
+	}
+
+	hub_bus_unlock_ctrl(p_bus);
+
+	return hub_parse_discover_response(
+		&discover_response.gard_discovery_response, p_identity);
+
+err_probe_gard_1:
+	hub_bus_unlock_ctrl(p_bus);
+	return HUB_FAILURE_GARD_DISCOVER;
+}
+
+/**
+ * hub_resync_gard_bus brings HUB and GARD back in step on a command bus once
+ * a transfer has been cut short, without discovering GARD again: it sends
+ * GARD_HUB_RESYNC_SEQUENCE and skips what it reads up to the RESYNC_ACK_MARKER
+ * of struct _resync_ack, the rest of a response GARD had started. The next
+ * command can then be sent. The bus is to be locked by the caller.
+ *
+ * @param: p_bus is the command bus, open
+ * @param: bus_hdl is its handle
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_GARD_DISCOVER if GARD lacks GARD_CAP_RESYNC or did not
+ * 		acknowledge
+ */
+enum hub_ret_code hub_resync_gard_bus(struct hub_gard_bus *p_bus, int bus_hdl)
+{
+	static const uint8_t resync_sequence[] = GARD_HUB_RESYNC_SEQUENCE;
+	struct _resync_ack   resync_ack        = {0};
+	uint32_t             window            = 0;
+	uint32_t             skipped;
+	uint8_t              byte;
+	ssize_t              nread, nwrite;
+
+	if (!(p_bus->identity.capabilities & GARD_CAP_RESYNC)) {
+		return HUB_FAILURE_GARD_DISCOVER;
+	}
+
+	nwrite = p_bus->fops.device_write(bus_hdl, resync_sequence,
+									  sizeof(resync_sequence));
+	if (sizeof(resync_sequence) != nwrite) {
+		goto err_resync_gard_bus_1;
+	}
+
+	/* The marker is little-endian on the bus, like the rest of the fields */
+	for (skipped = 0; RESYNC_ACK_MARKER != window; skipped++) {
+		if (skipped >= HUB_RESYNC_MAX_SKIP) {
+			goto err_resync_gard_bus_1;
+		}
+
+		nread = p_bus->fops.device_read(bus_hdl, &byte, sizeof(byte));
+		if (sizeof(byte) != nread) {
+			goto err_resync_gard_bus_1;
+		}
+		window = (window >> 8) | ((uint32_t)byte << 24);
+	}
+
+	nread = p_bus->fops.device_read(
+		bus_hdl, &resync_ack.resync_count,
+		sizeof(resync_ack) - sizeof(resync_ack.resync_ack_marker));
+	if ((ssize_t)(sizeof(resync_ack) - sizeof(resync_ack.resync_ack_marker)) !=
+			nread ||
+		(END_OF_DATA_MARKER != resync_ack.end_of_data_marker)) {
+		goto err_resync_gard_bus_1;
+	}
+
+	hub_pr_warn("GARD bus resynchronized, %u bytes skipped, %u since boot\n",
+				skipped - (uint32_t)sizeof(resync_ack.resync_ack_marker),
+				resync_ack.resync_count);
+
+	return HUB_SUCCESS;
+
+err_resync_gard_bus_1:
+	hub_pr_err("GARD bus could not be resynchronized\n");
+	return HUB_FAILURE_GARD_DISCOVER;
+}
+
+/**
+ * hub_rebind_gard re-attaches a GARD that was lost, e.g. after a firmware
+ * reset or a USB re-enumeration: its busses are closed, the command bus is
+ * discovered again from the rate GARD comes out of reset at, and the other
+ * busses are opened again. The bus handles may change, the busses and the
+ * GARD handle stay the same.
+ *
+ * A GARD answering with another device or profile ID is not taken for the
+ * lost one.
+ *
+ * @param: p_gard is the GARD
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_GARD_DISCOVER on failure, the busses may be left closed
+ */
+enum hub_ret_code hub_rebind_gard(struct hub_gard_info *p_gard)
+{
+	struct hub_gard_bus *busses[HUB_GARD_NUM_BUS_ROLES] = {
+		p_gard->cmd_bus, p_gard->control_bus, p_gard->data_bus,
+		p_gard->fallback_data_bus};
+	struct hub_gard_bus *p_bus;
+	uint32_t             i, j;
+	int                  bus_hdl;
+
+	/* Busses may be shared between the roles, only handle them once */
+	for (i = 1; i < HUB_GARD_NUM_BUS_ROLES; i++) {
+		for (j = 0; j < i; j++) {
+			if (busses[i] == busses[j]) {
+				busses[i] = NULL;
+			}
+		}
+	}
+
+	for (i = 0; i < HUB_GARD_NUM_BUS_ROLES; i++) {
+		p_bus = busses[i];
+		if (NULL == p_bus) {
+			continue;
+		}
+
+		hub_mutex_lock(&p_bus->bus_mutex);
+		(void)p_bus->fops.device_close(hub_gard_bus_hdl(p_bus));
+		if ((HUB_GARD_BUS_UART == p_bus->types) && p_bus->uart.base_baudrate) {
+			p_bus->uart.baudrate = p_bus->uart.base_baudrate;
+		}
+		p_bus->failed_at_ns = 0;
+		hub_mutex_unlock(&p_bus->bus_mutex);
+	}
+
+	for (i = 0; i < HUB_GARD_NUM_BUS_ROLES; i++) {
+		p_bus = busses[i];
+		if (NULL == p_bus) {
+			continue;
+		}
+
+		if (HUB_GARD_BUS_USB == p_bus->types) {
+			hub_mutex_lock(&p_bus->bus_mutex);
+			bus_hdl = p_bus->fops.device_open((void *)&p_bus->usb);
+			hub_mutex_unlock(&p_bus->bus_mutex);
+			if (bus_hdl < 0) {
+				return HUB_FAILURE_GARD_DISCOVER;
+			}
+			continue;
+		}
+
+		if (HUB_SUCCESS != hub_send_discover_command(p_bus)) {
+			return HUB_FAILURE_GARD_DISCOVER;
+		}
+
+		if ((p_bus->identity.device_id != p_gard->identity.device_id) ||
+			(p_bus->identity.profile_id != p_gard->identity.profile_id)) {
+			hub_pr_err("%s: GARD 0x%016llx instead of GARD %u\n",
+					   hub_gard_bus_strings[p_bus->types],
+					   (unsigned long long)p_bus->identity.device_id,
+					   p_gard->gard_index);
+			return HUB_FAILURE_GARD_DISCOVER;
+		}
+
+		if (HUB_SUCCESS != hub_step_up_uart_baudrate(p_bus)) {
+			return HUB_FAILURE_GARD_DISCOVER;
+		}
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Measure the latency of a discovered bus, at its final baud rate, with
+ * GARD_DISCOVERY round trips. The bus is left with bench_latency_ns set to
+ * the best of them, or 0 if none went through.
+ *
+ * @param: p_bus is the discovered HUB-GARD bus
+ */
+static void hub_bench_bus_latency(struct hub_gard_bus *p_bus)
+{
+	uint64_t start_ns, elapsed_ns;
+	uint32_t i;
+
+	p_bus->bench_latency_ns = 0;
+
+	for (i = 0; i < HUB_BUS_BENCH_ROUNDS; i++) {
+		start_ns = hub_stats_now_ns();
+		if (HUB_SUCCESS != hub_send_discover_command(p_bus)) {
+			hub_pr_warn("%s: benchmark round trip %u failed\n",
+						hub_gard_bus_strings[p_bus->types], i);
+			continue;
+		}
+		elapsed_ns = hub_stats_now_ns() - start_ns;
+
+		if ((0 == p_bus->bench_latency_ns) ||
+			(elapsed_ns < p_bus->bench_latency_ns)) {
+			p_bus->bench_latency_ns = elapsed_ns;
+		}
+	}
+
+	hub_pr_dbg("%s: latency %llu usecs\n", hub_gard_bus_strings[p_bus->types],
+			   (unsigned long long)(p_bus->bench_latency_ns / 1000));
+}
+
+/**
+ * HUB INIT internal function
  *
- * Get a profile ID from the attached GARD.
+ * Get the profile ID of the GARD attached to a discovered bus, as it
+ * reported it in its GARD_DISCOVERY response.
  *
- * @param: TBD
+ * @param: p_bus is the discovered HUB-GARD bus
+ * @param: gard_profile_id is filled with the profile ID
  *
  * @return: hub_ret_code
  * 		HUB_SUCCESS on success
- * 		TBD on failure
+ * 		HUB_FAILURE_GARD_DISCOVER if the bus has not been discovered
  */
-static enum hub_ret_code hub_get_gard_profile_id(struct hub_ctx *p_hub,
+static enum hub_ret_code hub_get_gard_profile_id(struct hub_gard_bus *p_bus,
 												 int32_t *gard_profile_id)
 {
-	*gard_profile_id = 12345;
+	if (!p_bus->identity.is_valid) {
+		return HUB_FAILURE_GARD_DISCOVER;
+	}
+
+	*gard_profile_id = (int32_t)p_bus->identity.profile_id;
 
 	return HUB_SUCCESS;
 }
 
+/**
+ * HUB INIT internal function
+ *
+ * A gard_index no bus of the HUB is wired to.
+ *
+ * @param: p_hub is the hub_ctx
+ *
+ * @return: one more than the greatest gard_index of the busses
+ */
+static uint32_t hub_free_gard_index(const struct hub_ctx *p_hub)
+{
+	uint32_t i;
+	uint32_t gard_index = 0;
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		if (p_hub->p_bus_props[i].gard_index >= gard_index) {
+			gard_index = p_hub->p_bus_props[i].gard_index + 1;
+		}
+	}
+
+	return gard_index;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Bulk rate of a bus, to compare buses for the data transfers: the rate of a
+ * HUB_BUS_BENCH_BULK_SIZE bytes transfer, from the measured latency of the
+ * bus and its nominal bit rate. USB is taken as high speed, with no latency
+ * as it is not probed.
+ *
+ * @param: p_bus is the HUB-GARD bus
+ *
+ * @return: bytes/sec, 0 for the buses HUB cannot transfer data on
+ */
+static uint64_t hub_bus_bulk_rate(const struct hub_gard_bus *p_bus)
+{
+	uint64_t bitrate, bits_per_byte, xfer_ns;
+
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		/* The clock the adapter was found to run at, if known */
+		bitrate       = p_bus->i2c.adapter_speed ? p_bus->i2c.adapter_speed
+												 : p_bus->i2c.speed;
+		bits_per_byte = 9; /* With the ACK bit */
+		break;
+	case HUB_GARD_BUS_UART:
+		bitrate       = p_bus->uart.baudrate;
+		bits_per_byte = 10; /* With the start and stop bits */
+		break;
+	case HUB_GARD_BUS_USB:
+		bitrate       = 480000000ULL;
+		bits_per_byte = 8;
+		break;
+	default:
+		return 0;
+	}
+
+	if (0 == bitrate) {
+		return 0;
+	}
+
+	xfer_ns = p_bus->bench_latency_ns +
+			  (HUB_BUS_BENCH_BULK_SIZE * bits_per_byte * 1000000000ULL) /
+				  bitrate;
+
+	return (HUB_BUS_BENCH_BULK_SIZE * 1000000000ULL) / xfer_ns;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Pick the busses of a GARD among the busses wired to it (same gard_index),
+ * from their benchmark. The data bus and the control bus are only picked if
+ * the json file of the GARD does not name them:
+ * 1. data_bus, the one with the best bulk rate GARD reports as usable: a
+ *    discovered bus, or a USB bus if GARD has the USB bridge
+ *    (GARD_CAP_BUS_USB)
+ * 2. control_bus, the discovered one with the lowest latency other than the
+ *    data bus, or the data bus if there is no other
+ * 3. fallback_data_bus, the discovered one with the best bulk rate other
+ *    than the data bus, for the data transfers while the data bus fails
+ * 4. cmd_bus, the data bus, or the control bus if the data bus is USB
+ *
+ * @param: p_hub is the hub_ctx
+ * @param: p_gard is the GARD handle, with gard_index and identity set
+ */
+static void hub_select_gard_busses(struct hub_ctx       *p_hub,
+								   struct hub_gard_info *p_gard)
+{
+	struct hub_gard_bus *p_bus;
+	struct hub_gard_bus *p_data_bus     = NULL;
+	struct hub_gard_bus *p_control_bus  = NULL;
+	struct hub_gard_bus *p_fallback_bus = NULL;
+	uint32_t             i;
+	bool                 is_usable;
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		p_bus = &p_hub->p_bus_props[i];
+		if (p_bus->gard_index != p_gard->gard_index) {
+			continue;
+		}
+
+		is_usable = p_bus->identity.is_valid ||
+					((HUB_GARD_BUS_USB == p_bus->types) &&
+					 (p_gard->identity.capabilities & GARD_CAP_BUS_USB));
+		if (is_usable &&
+			((NULL == p_data_bus) ||
+			 (hub_bus_bulk_rate(p_bus) > hub_bus_bulk_rate(p_data_bus)))) {
+			p_data_bus = p_bus;
+		}
+	}
+
+	if (NULL == p_gard->data_bus) {
+		p_gard->data_bus = p_data_bus;
+	}
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		p_bus = &p_hub->p_bus_props[i];
+		if ((p_bus->gard_index != p_gard->gard_index) ||
+			!p_bus->identity.is_valid || (p_bus == p_gard->data_bus)) {
+			continue;
+		}
+
+		if ((NULL == p_control_bus) ||
+			(p_bus->bench_latency_ns < p_control_bus->bench_latency_ns)) {
+			p_control_bus = p_bus;
+		}
+		if ((NULL == p_fallback_bus) ||
+			(hub_bus_bulk_rate(p_bus) > hub_bus_bulk_rate(p_fallback_bus))) {
+			p_fallback_bus = p_bus;
+		}
+	}
+	if ((NULL == p_control_bus) && (NULL != p_gard->data_bus) &&
+		p_gard->data_bus->identity.is_valid) {
+		p_control_bus = p_gard->data_bus;
+	}
+
+	if (NULL == p_gard->control_bus) {
+		p_gard->control_bus = p_control_bus;
+	}
+	p_gard->fallback_data_bus = p_fallback_bus;
+
+	p_gard->cmd_bus           = p_gard->data_bus;
+	if ((NULL != p_gard->data_bus) &&
+		(HUB_GARD_BUS_USB == p_gard->data_bus->types)) {
+		p_gard->cmd_bus = p_gard->control_bus;
+	}
+
+	hub_pr_dbg("GARD %u: control bus %s, data bus %s, fallback %s\n",
+			   p_gard->gard_index,
+			   p_gard->control_bus
+				   ? hub_gard_bus_strings[p_gard->control_bus->types]
+				   : "none",
+			   p_gard->data_bus ? hub_gard_bus_strings[p_gard->data_bus->types]
+								: "none",
+			   p_fallback_bus ? hub_gard_bus_strings[p_fallback_bus->types]
+							  : "none");
+}
+
 /**
  * HUB INIT internal function
  *
@@ -220,12 +846,14 @@ static enum hub_ret_code hub_parse_gard_json(char *p_gard_json_filename,
 	 * uses for what purpose:
 	 * 1. control_bus for reg-read-write
 	 * 2. data_bus for send_data, recv_data
+	 * Both are optional, see hub_select_gard_busses().
 	 *
 	 * Get the values for these keys from the GARD json
 	 *
 	 * Then, depending on the bus type detected, point the control_bus /
 	 * data_bus to the appropriate entry in the bus_props[] array already
-	 * populated during hub_preinit()
+	 * populated during hub_preinit(), among the busses wired to this GARD
+	 * (same gard_index)
 	 */
 	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_gard_json, "gard_id");
 	p_gard_hdl->gard_id = p_json_obj->valueint;
@@ -234,11 +862,12 @@ static enum hub_ret_code hub_parse_gard_json(char *p_gard_json_filename,
 			 p_json_obj->valuestring);
 
 	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_gard_json, "control_bus");
-	for (i = 0; i < HUB_GARD_NR_BUSSES; i++) {
+	for (i = 0; cJSON_IsString(p_json_obj) && (i < HUB_GARD_NR_BUSSES); i++) {
 		if (!strncmp(p_json_obj->valuestring, hub_gard_bus_strings[i],
 					 strlen(p_json_obj->valuestring))) {
 			for (j = 0; j < p_hub->num_busses; j++) {
-				if (i == p_gard_busses[j].types) {
+				if ((i == p_gard_busses[j].types) &&
+					(p_gard_hdl->gard_index == p_gard_busses[j].gard_index)) {
 					p_gard_hdl->control_bus = &p_gard_busses[j];
 					break;
 				}
@@ -246,11 +875,12 @@ static enum hub_ret_code hub_parse_gard_json(char *p_gard_json_filename,
 		}
 	}
 	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_gard_json, "data_bus");
-	for (i = 0; i < HUB_GARD_NR_BUSSES; i++) {
+	for (i = 0; cJSON_IsString(p_json_obj) && (i < HUB_GARD_NR_BUSSES); i++) {
 		if (!strncmp(p_json_obj->valuestring, hub_gard_bus_strings[i],
 					 strlen(p_json_obj->valuestring))) {
 			for (j = 0; j < p_hub->num_busses; j++) {
-				if (i == p_gard_busses[j].types) {
+				if ((i == p_gard_busses[j].types) &&
+					(p_gard_hdl->gard_index == p_gard_busses[j].gard_index)) {
 					p_gard_hdl->data_bus = &p_gard_busses[j];
 					break;
 				}
@@ -330,6 +960,128 @@ gard_parse_err_1:
 /******************************************************************************
 	HUB publicly exposed APIs
  ******************************************************************************/
+/**
+ * HUB INIT internal function
+ *
+ * Thread function of the discovery probe threads.
+ *
+ * Takes the buses of the pool one by one and probes each: discovery, the
+ * UART baud rate step up, then the latency benchmark. The outcome is left in
+ * the probe.
+ *
+ * @param: p_params is the struct hub_discover_pool to take buses from
+ *
+ * @return: NULL
+ */
+static void *hub_discover_probe_func(void *p_params)
+{
+	struct hub_discover_pool  *p_pool = (struct hub_discover_pool *)p_params;
+	struct hub_discover_probe *p_probe;
+	enum hub_gard_bus_types    bus_type;
+
+	while (true) {
+		hub_mutex_lock(&p_pool->lock);
+		p_probe = NULL;
+		if (p_pool->next_probe < p_pool->num_probes) {
+			p_probe = &p_pool->p_probes[p_pool->next_probe++];
+		}
+		hub_mutex_unlock(&p_pool->lock);
+
+		if (NULL == p_probe) {
+			break;
+		}
+
+		bus_type = p_probe->p_bus->types;
+		if (bus_type >= HUB_GARD_NR_BUSSES) {
+			bus_type = HUB_GARD_BUS_UNKNOWN;
+		}
+
+		hub_mutex_lock(&p_pool->bus_type_mutex[bus_type]);
+		p_probe->ret = hub_send_discover_command(p_probe->p_bus);
+		if (HUB_SUCCESS == p_probe->ret) {
+			p_probe->ret = hub_step_up_uart_baudrate(p_probe->p_bus);
+		}
+		if (HUB_SUCCESS == p_probe->ret) {
+			hub_bench_bus_latency(p_probe->p_bus);
+		}
+		hub_mutex_unlock(&p_pool->bus_type_mutex[bus_type]);
+	}
+
+	return NULL;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Probe all the buses of the HUB for a GARD concurrently.
+ *
+ * Up to HUB_DISCOVER_MAX_PROBE_THREADS threads, the calling one included,
+ * share the buses, so that the probe timeouts of buses with no GARD on
+ * them overlap instead of adding up. If no thread can be created, the
+ * calling thread probes all the buses itself.
+ *
+ * @param: p_hub is the hub_ctx, with the bus mutexes initialized
+ * @param: p_probes is filled with the outcome of each bus probe, in the
+ *         order of p_hub->p_bus_props
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success, whatever the outcome of the probes
+ * 		HUB_FAILURE_GARD_DISCOVER if the pool cannot be set up
+ */
+static enum hub_ret_code
+	hub_discover_probe_busses(struct hub_ctx            *p_hub,
+							  struct hub_discover_probe *p_probes)
+{
+	struct hub_discover_pool pool;
+	hub_thread_hdl_t         probe_threads[HUB_DISCOVER_MAX_PROBE_THREADS - 1];
+	uint32_t                 num_threads = 0;
+	uint32_t                 i;
+
+	pool.p_probes   = p_probes;
+	pool.num_probes = p_hub->num_busses;
+	pool.next_probe = 0;
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		p_probes[i].p_bus = &p_hub->p_bus_props[i];
+		p_probes[i].ret   = HUB_FAILURE_GARD_DISCOVER;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&pool.lock)) {
+		hub_pr_err("Failed to initialize discovery pool mutex\n");
+		return HUB_FAILURE_GARD_DISCOVER;
+	}
+	for (i = 0; i < HUB_GARD_NR_BUSSES; i++) {
+		(void)hub_mutex_init(&pool.bus_type_mutex[i]);
+	}
+
+	/* The calling thread is one of the probing threads */
+	while ((num_threads + 1 < HUB_DISCOVER_MAX_PROBE_THREADS) &&
+		   (num_threads + 1 < p_hub->num_busses)) {
+		if (HUB_SUCCESS != hub_thread_create(&probe_threads[num_threads], NULL,
+											 HUB_THREAD_CLASS_BUS_IO,
+											 "hub_discover",
+											 hub_discover_probe_func, &pool)) {
+			hub_pr_warn("Probing the remaining buses with %u threads\n",
+						num_threads + 1);
+			break;
+		}
+		num_threads++;
+	}
+
+	(void)hub_discover_probe_func(&pool);
+
+	for (i = 0; i < num_threads; i++) {
+		(void)hub_thread_join(probe_threads[i], NULL);
+	}
+
+	for (i = 0; i < HUB_GARD_NR_BUSSES; i++) {
+		(void)hub_mutex_destroy(&pool.bus_type_mutex[i]);
+	}
+	(void)hub_mutex_destroy(&pool.lock);
+
+	return HUB_SUCCESS;
+}
+
 /**
  * Given a HUB handle, run GARD discovery commands and discover GARDs,
  * fill up the HUB context internals accordingly.
@@ -356,6 +1108,9 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 		bool                 is_unique;
 	} *discovered_busses = NULL;
 
+	/* Outcome of the discovery probe of each bus */
+	struct hub_discover_probe *probes = NULL;
+
 	struct hub_ctx *p_hub = (struct hub_ctx *)hub;
 	if ((NULL == p_hub) || (p_hub->hub_state != HUB_PREINIT_DONE)) {
 		hub_pr_err("Invalid HUB handle passed in or hub_preinit() not done!\n");
@@ -371,11 +1126,54 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 	/* Allocate temporary array to track discovered buses */
 	discovered_busses = (struct discovered_bus *)calloc(
 		p_hub->num_busses, sizeof(struct discovered_bus));
-	if (NULL == discovered_busses) {
+	probes = (struct hub_discover_probe *)calloc(
+		p_hub->num_busses, sizeof(struct hub_discover_probe));
+	if ((NULL == discovered_busses) || (NULL == probes)) {
 		hub_pr_err("Error allocating memory for discovered buses\n");
+		free(discovered_busses);
+		free(probes);
 		goto hub_discover_err_1;
 	}
 
+	/* Initialize the bus mutexes before any bus is probed */
+	for (i = 0; i < p_hub->num_busses; i++) {
+		ret = hub_mutex_init(&p_hub->p_bus_props[i].bus_mutex);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to initialize bus mutex\n");
+			goto hub_discover_err_2;
+		}
+
+		ret = hub_cond_var_init(&p_hub->p_bus_props[i].bus_yield_cond);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to initialize bus yield condvar\n");
+			goto hub_discover_err_2;
+		}
+
+		ret = hub_mutex_init(&p_hub->p_bus_props[i].pipe_mutex);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to initialize bus pipe mutex\n");
+			goto hub_discover_err_2;
+		}
+
+		ret = hub_cond_var_init(&p_hub->p_bus_props[i].pipe_cond);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to initialize bus pipe condvar\n");
+			goto hub_discover_err_2;
+		}
+
+		ret = hub_bus_async_init(&p_hub->p_bus_props[i]);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to initialize bus async queue\n");
+			goto hub_discover_err_2;
+		}
+	}
+
+	/* First pass: Discover GARDs on all buses concurrently */
+	ret = hub_discover_probe_busses(p_hub, probes);
+	if (HUB_SUCCESS != ret) {
+		goto hub_discover_err_2;
+	}
+
 	/**
 	 * Fail count keeps track of how many buses couldn't be discovered
 	 * for given GARD. If fail count matches the number of buses, then means
@@ -383,21 +1181,13 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 	 * with that GARD. Then ONLY fail the discovery.
 	 */
 	uint32_t fail_count = 0;
-	/* First pass: Discover GARDs on all buses and get their profile IDs */
+	/* Get the profile IDs of the discovered GARDs, in bus order */
 	for (i = 0; i < p_hub->num_busses; i++) {
-		/* Initialize the bus mutex */
-		ret = hub_mutex_init(&p_hub->p_bus_props[i].bus_mutex);
-		if (HUB_SUCCESS != ret) {
-			hub_pr_err("Failed to initialize bus mutex\n");
-			goto hub_discover_err_2;
-		}
-
-		ret = hub_send_discover_command(&p_hub->p_bus_props[i]);
-		if (HUB_SUCCESS == ret) {
+		if (HUB_SUCCESS == probes[i].ret) {
 			int32_t profile_id;
 
-			/* Get profile ID using stub function (same for all buses) */
-			ret = hub_get_gard_profile_id(p_hub, &profile_id);
+			/* Get profile ID GARD reported in its discovery response */
+			ret = hub_get_gard_profile_id(&p_hub->p_bus_props[i], &profile_id);
 			if (HUB_SUCCESS != ret) {
 				hub_pr_err("Failed to get profile ID from bus %d\n", i);
 				fail_count++;
@@ -411,18 +1201,38 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 			hub_pr_dbg("Discovered GARD on bus %d with profile ID = %d\n", i,
 					   profile_id);
 
-			/* Check if this profile ID was already seen on a previous bus */
+			/**
+			 * Buses answering with the device ID seen on a previous bus are
+			 * wired to the same GARD: pair them by giving them the same
+			 * gard_index. A GARD found on a gard_index already taken by
+			 * another GARD is moved to a free one.
+			 */
 			for (j = 0; j < i; j++) {
 				/* Only check buses that had successful discoveries */
-				if (discovered_busses[j].p_bus != NULL &&
-					discovered_busses[j].profile_id == profile_id) {
-					/* Duplicate profile ID found - mark as not unique */
+				if (discovered_busses[j].p_bus == NULL) {
+					continue;
+				}
+
+				if (discovered_busses[j].p_bus->identity.device_id ==
+					p_hub->p_bus_props[i].identity.device_id) {
+					/* Same GARD - mark as not unique */
 					discovered_busses[i].is_unique = false;
-					hub_pr_dbg("Profile ID %d already seen on bus %d, skipping "
-							   "duplicate on bus %d\n",
-							   profile_id, j, i);
+					p_hub->p_bus_props[i].gard_index =
+						discovered_busses[j].p_bus->gard_index;
+					hub_pr_dbg("Device ID of bus %d already seen on bus %d, "
+							   "skipping duplicate\n",
+							   i, j);
 					break;
 				}
+
+				if (discovered_busses[j].is_unique &&
+					(discovered_busses[j].p_bus->gard_index ==
+					 p_hub->p_bus_props[i].gard_index)) {
+					p_hub->p_bus_props[i].gard_index = hub_free_gard_index(p_hub);
+					hub_pr_warn("Another GARD on bus %d, moved to gard_index "
+								"%u\n",
+								i, p_hub->p_bus_props[i].gard_index);
+				}
 			}
 
 			/* Count unique GARDs */
@@ -466,19 +1276,63 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 		p_gard = &p_hub->p_gards[j++];
 
 		/* Every GARD handle has a pointer to the HUB handle */
-		p_gard->hub = hub;
+		p_gard->hub        = hub;
+		p_gard->gard_index = discovered_busses[i].p_bus->gard_index;
+		p_gard->identity   = discovered_busses[i].p_bus->identity;
 
 		hub_pr_dbg("Processing GARD with profile id = %d\n", gard_profile_id);
 
 		sprintf(gard_json_file, "%s/gard_%d.json", p_gard_json_dir,
 				gard_profile_id);
 
-		ret = hub_parse_gard_json(gard_json_file, p_hub, p_gard);
-		if (HUB_SUCCESS != ret) {
-			hub_pr_err("Error parsing %s\n", gard_json_file);
+		/**
+		 * A GARD json unchanged since it went to the config cache is not
+		 * read again. Without a json file for its profile, the GARD gets its
+		 * profile ID as gard_id, no GPIOs and the busses picked by HUB.
+		 */
+		if (HUB_SUCCESS ==
+			hub_config_cache_get_gard(p_hub->p_config_cache, p_hub,
+									  gard_profile_id, gard_json_file,
+									  p_gard)) {
+			hub_pr_dbg("%s taken from the config cache\n", gard_json_file);
+		} else if (0 != access(gard_json_file, R_OK)) {
+			hub_pr_warn("No %s, using the defaults\n", gard_json_file);
+			p_gard->gard_id = gard_profile_id;
+			snprintf(p_gard->gard_name, sizeof(p_gard->gard_name), "GARD %d",
+					 gard_profile_id);
+		} else {
+			ret = hub_parse_gard_json(gard_json_file, p_hub, p_gard);
+			if (HUB_SUCCESS != ret) {
+				hub_pr_err("Error parsing %s\n", gard_json_file);
+				continue;
+			}
+			hub_config_cache_put_gard(p_hub->p_config_cache, p_hub,
+									  gard_profile_id, gard_json_file, p_gard);
+		}
+
+		hub_select_gard_busses(p_hub, p_gard);
+		if ((NULL == p_gard->control_bus) || (NULL == p_gard->data_bus) ||
+			(NULL == p_gard->cmd_bus)) {
+			hub_pr_err("No usable busses for GARD %u\n", p_gard->gard_index);
 			continue;
 		}
 
+		/* Use no more of the data bus than GARD supports */
+		if (p_gard->data_bus->mtu_size > p_gard->identity.max_mtu_size) {
+			p_gard->data_bus->mtu_size = p_gard->identity.max_mtu_size;
+		}
+		if (p_gard->data_bus->data_crc &&
+			!(p_gard->identity.capabilities & GARD_CAP_DATA_CRC)) {
+			hub_pr_warn("GARD %u has no data CRC, not using it\n",
+						p_gard->gard_index);
+			p_gard->data_bus->data_crc = false;
+		}
+
+		/* Tagged responses between the segments of a recv_data */
+		p_gard->data_bus->recv_segments =
+			p_gard->data_bus->cmd_pipelining &&
+			(p_gard->identity.capabilities & GARD_CAP_SEGMENTED_RECV);
+
 		/**
 		 * TBD-DPN: Need to make this code more elegant.
 		 *
@@ -532,11 +1386,35 @@ enum hub_ret_code hub_discover_gards(hub_handle_t hub)
 			/* Ignoring for now; in future, we will flag it as a dead bus */
 			hub_pr_err("Bus not supported for open!\n");
 		};
+
+		/* The data transfers fail over to it, see hub_gard_data_route() */
+		if ((NULL != p_gard->fallback_data_bus) &&
+			(p_gard->fallback_data_bus != p_gard->control_bus)) {
+			bus_type = p_gard->fallback_data_bus->types;
+			switch (bus_type) {
+			case HUB_GARD_BUS_I2C:
+				bus_hdl = p_gard->fallback_data_bus->fops.device_open(
+					(void *)&p_gard->fallback_data_bus->i2c);
+				break;
+			case HUB_GARD_BUS_UART:
+				bus_hdl = p_gard->fallback_data_bus->fops.device_open(
+					(void *)&p_gard->fallback_data_bus->uart);
+				break;
+			default:
+				hub_pr_err("Bus not supported for open!\n");
+			};
+		}
 	}
 	(void)bus_hdl;
 
-	/* Free temporary array */
+	/* Free temporary arrays */
 	free(discovered_busses);
+	free(probes);
+
+	/* Write back what was parsed from the jsons, for the next start */
+	hub_config_cache_save(p_hub->p_config_cache);
+	hub_config_cache_free(p_hub->p_config_cache);
+	p_hub->p_config_cache = NULL;
 
 	p_hub->hub_state = HUB_DISCOVER_DONE;
 	return HUB_SUCCESS;
@@ -548,8 +1426,13 @@ hub_discover_err_2:
 		(void)hub_mutex_try_unlock(&p_hub->p_bus_props[i].bus_mutex);
 		/* Destroy the mutex */
 		(void)hub_mutex_destroy(&p_hub->p_bus_props[i].bus_mutex);
+		(void)hub_cond_var_destroy(&p_hub->p_bus_props[i].bus_yield_cond);
+		(void)hub_mutex_destroy(&p_hub->p_bus_props[i].pipe_mutex);
+		(void)hub_cond_var_destroy(&p_hub->p_bus_props[i].pipe_cond);
+		hub_bus_async_fini(&p_hub->p_bus_props[i]);
 	}
 	free(discovered_busses);
+	free(probes);
 hub_discover_err_1:
 	return HUB_FAILURE_GARD_DISCOVER;
 }
@@ -569,8 +1452,31 @@ hub_discover_err_1:
  */
 enum hub_ret_code hub_init(hub_handle_t hub)
 {
-	int               num_gpio_inputs;
+	return hub_init_with_options(hub, NULL);
+}
+
+/**
+ * hub_init_with_options is hub_init with the GPIO execution model given by
+ * the caller instead of "gpio_exec_model" / "gpio_pool_size" in
+ * host_config.json.
+ *
+ * In the reactor model, the monitoring thread is an epoll reactor and the
+ * worker pool is started here, see hub_gpio_reactor.c.
+ *
+ * @param: hub is a HUB handle
+ * @param: p_options are the init options, NULL for the host_config ones
+ *
+ * @return: hub_ret_code
+		HUB_SUCCESS on success
+		HUB_FAILURE_INIT on failure
+ */
+enum hub_ret_code
+	hub_init_with_options(hub_handle_t                   hub,
+						  const struct hub_init_options *p_options)
+{
+	int               num_gpio_inputs, num_chip_lines;
 	enum hub_ret_code ret;
+	void *(*p_mon_thread_func)(void *) = hub_gpio_monitor_thread_func;
 
 	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = NULL;
 	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
@@ -582,11 +1488,29 @@ enum hub_ret_code hub_init(hub_handle_t hub)
 		goto hub_init_err_1;
 	}
 
+	if (NULL != p_options) {
+		p_hub->gpio_exec_model = p_options->gpio_exec_model;
+		if (p_options->gpio_pool_size) {
+			p_hub->gpio_pool_size = p_options->gpio_pool_size;
+		}
+	}
+
+	if ((HUB_GPIO_EXEC_REACTOR == p_hub->gpio_exec_model) &&
+		((0 == p_hub->gpio_pool_size) ||
+		 (p_hub->gpio_pool_size > HUB_GPIO_POOL_MAX_SIZE))) {
+		hub_pr_err("Invalid GPIO pool size %u, should be 1 to %d\n",
+				   p_hub->gpio_pool_size, HUB_GPIO_POOL_MAX_SIZE);
+		goto hub_init_err_1;
+	}
+
 	num_gpio_inputs = p_hub->p_gards->num_gpio_inputs;
 	if (!num_gpio_inputs) {
 		/* TBD-SSP: Handle if GPIO pins are not given in GARD JSON
 		 * currently setting init done and returning */
 		hub_pr_err("GARD configuration doesn't have GPIO inputs.\n");
+		if (HUB_SUCCESS != hub_health_start(p_hub)) {
+			goto hub_init_err_1;
+		}
 		p_hub->hub_state = HUB_INIT_DONE;
 		return HUB_SUCCESS;
 	}
@@ -602,24 +1526,23 @@ enum hub_ret_code hub_init(hub_handle_t hub)
 
 	/* Open the GPIO chip */
 	p_hub_gpio_mon_ctx->p_chip =
-		gpiod_chip_open_by_name(p_hub->p_gards->gpio_chip);
+		hub_gpiod_chip_open(p_hub->p_gards->gpio_chip);
 	if (NULL == p_hub_gpio_mon_ctx->p_chip) {
 		hub_pr_err("Failed to open %s GPIO chip.\n", p_hub->p_gards->gpio_chip);
 		goto hub_init_err_2;
 	}
 
 	/* Get the chip's max nmumber of GPIO lines */
-	p_hub_gpio_mon_ctx->num_chip_lines =
-		gpiod_chip_num_lines(p_hub_gpio_mon_ctx->p_chip);
-	if (p_hub_gpio_mon_ctx->num_chip_lines < 0) {
+	num_chip_lines = hub_gpiod_chip_num_lines(p_hub_gpio_mon_ctx->p_chip);
+	if (num_chip_lines < 0) {
 		hub_pr_err("Failed to get lines of %s GPIO chip.\n",
 				   p_hub->p_gards->gpio_chip);
 		goto hub_init_err_3;
-	} else if (p_hub_gpio_mon_ctx->num_chip_lines == 0) {
+	} else if (num_chip_lines == 0) {
 		hub_pr_err("No lines on %s GPIO chip.\n", p_hub->p_gards->gpio_chip);
-		gpiod_chip_close(p_hub_gpio_mon_ctx->p_chip);
 		goto hub_init_err_3;
 	}
+	p_hub_gpio_mon_ctx->num_chip_lines = (uint32_t)num_chip_lines;
 
 	hub_pr_dbg("GPIO chip %s has %d lines.\n", p_hub->p_gards->gpio_chip,
 			   p_hub_gpio_mon_ctx->num_chip_lines);
@@ -630,13 +1553,12 @@ enum hub_ret_code hub_init(hub_handle_t hub)
 	/* Monitor thread will not act unless initialized */
 	p_hub_gpio_mon_ctx->mon_thread_initialized = false;
 
-	/* Timeout wait for monitor thread */
-	p_hub_gpio_mon_ctx->mon_timeout.tv_sec  = HUB_GPIO_MON_THREAD_TIMEOUT_SECS;
-	p_hub_gpio_mon_ctx->mon_timeout.tv_nsec = HUB_GPIO_MON_THREAD_TIMEOUT_NSECS;
+	/* No line monitored until an appdata callback is set up */
+	p_hub_gpio_mon_ctx->num_mon_lines = 0;
+	p_hub_gpio_mon_ctx->mon_bulk_gen  = 0;
 
-	/* doesn't return any error code */
-	/* this just sets bulk->num_lines to 0 */
-	gpiod_line_bulk_init(&p_hub_gpio_mon_ctx->mon_bulk);
+	p_hub_gpio_mon_ctx->exec_model   = p_hub->gpio_exec_model;
+	p_hub_gpio_mon_ctx->wake_fd      = -1;
 
 	ret = hub_mutex_init(&p_hub_gpio_mon_ctx->mon_mutex);
 	if (HUB_SUCCESS != ret) {
@@ -650,15 +1572,38 @@ enum hub_ret_code hub_init(hub_handle_t hub)
 		goto hub_init_err_4;
 	}
 
+	ret = hub_trace_init(&p_hub_gpio_mon_ctx->trace);
+	if (HUB_SUCCESS != ret) {
+		goto hub_init_err_5;
+	}
+
 	p_hub->p_gpio_mon_ctx = p_hub_gpio_mon_ctx;
 
+	/* The monitor thread sleeps on it with no timeout, see hub_gpio_mon_wake */
+	p_hub_gpio_mon_ctx->wake_fd = hub_wake_fd_open();
+	if (p_hub_gpio_mon_ctx->wake_fd < 0) {
+		hub_pr_err("Failed to create GPIO monitor wake fd.\n");
+		goto hub_init_err_6;
+	}
+
+	if (HUB_GPIO_EXEC_REACTOR == p_hub_gpio_mon_ctx->exec_model) {
+		ret = hub_gpio_pool_start(p_hub_gpio_mon_ctx, p_hub->gpio_pool_size);
+		if (HUB_SUCCESS != ret) {
+			hub_pr_err("Failed to start GPIO worker pool.\n");
+			goto hub_init_err_7;
+		}
+
+		p_mon_thread_func = hub_gpio_reactor_thread_func;
+	}
+
 	/* Start the monitoring thread */
 	ret = hub_thread_create(&p_hub->p_gpio_mon_ctx->mon_thread_hdl,
 							&p_hub->p_gpio_mon_ctx->mon_thread_attr,
-							hub_gpio_monitor_thread_func, (void *)p_hub);
+							HUB_THREAD_CLASS_GPIO_MON, "hub_gpio_mon",
+							p_mon_thread_func, (void *)p_hub);
 	if (HUB_SUCCESS != ret) {
 		hub_pr_err("Failed to create monitor thread.\n");
-		goto hub_init_err_5;
+		goto hub_init_err_8;
 	}
 	hub_pr_dbg("Creating monitoring thread. Handle - %ld\n",
 			   p_hub->p_gpio_mon_ctx->mon_thread_hdl);
@@ -669,32 +1614,48 @@ enum hub_ret_code hub_init(hub_handle_t hub)
 		p_hub_gpio_mon_ctx->num_chip_lines, sizeof(struct hub_gpio_event_ctx));
 	if (NULL == p_hub_gpio_event_ctx) {
 		hub_pr_err("Failed to allocate memory for p_hub_gpio_event_ctx.\n");
-		goto hub_init_err_6;
+		goto hub_init_err_9;
 	}
 
 	p_hub->p_gpio_event_ctx = p_hub_gpio_event_ctx;
 
+	/* Re-attaches lost GARDs until hub_fini() */
+	ret = hub_health_start(p_hub);
+	if (HUB_SUCCESS != ret) {
+		goto hub_init_err_10;
+	}
+
 	p_hub->hub_state = HUB_INIT_DONE;
 	return HUB_SUCCESS;
 
-hub_init_err_6:
-	/* Gracefully shut down monitor thread */
-	hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
-	hub_cond_var_signal(&p_hub_gpio_mon_ctx->mon_cond_var);
-	hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
+hub_init_err_10:
+	free(p_hub_gpio_event_ctx);
+	p_hub->p_gpio_event_ctx = NULL;
+hub_init_err_9:
+	/* Gracefully shut down monitor thread, it exits on terminate_flag */
+	p_hub_gpio_mon_ctx->terminate_flag = true;
+	hub_gpio_mon_wake(p_hub_gpio_mon_ctx);
 
-	hub_thread_cancel(p_hub_gpio_mon_ctx->mon_thread_hdl);
 	hub_thread_join(p_hub_gpio_mon_ctx->mon_thread_hdl, NULL);
+hub_init_err_8:
+	if (HUB_GPIO_EXEC_REACTOR == p_hub_gpio_mon_ctx->exec_model) {
+		hub_gpio_pool_stop(p_hub_gpio_mon_ctx);
+	}
+hub_init_err_7:
+	hub_wake_fd_close(p_hub_gpio_mon_ctx->wake_fd);
+hub_init_err_6:
+	hub_trace_fini(&p_hub_gpio_mon_ctx->trace);
 hub_init_err_5:
 	hub_cond_var_destroy(&p_hub_gpio_mon_ctx->mon_cond_var);
 hub_init_err_4:
 	hub_mutex_destroy(&p_hub_gpio_mon_ctx->mon_mutex);
 hub_init_err_3:
-	gpiod_chip_close(p_hub_gpio_mon_ctx->p_chip);
+	hub_gpiod_chip_close(p_hub_gpio_mon_ctx->p_chip);
 	p_hub_gpio_mon_ctx->p_chip = NULL;
 hub_init_err_2:
 	free(p_hub_gpio_mon_ctx);
-	p_hub_gpio_mon_ctx = NULL;
+	p_hub_gpio_mon_ctx    = NULL;
+	p_hub->p_gpio_mon_ctx = NULL;
 hub_init_err_1:
 	return HUB_FAILURE_INIT;
 }
@@ -776,9 +1737,10 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 	enum hub_gard_bus_types bus_type;
 	uint32_t                num_busses;
 
-	struct hub_ctx            *p_hub                = NULL;
-	struct hub_gpio_mon_ctx   *p_hub_gpio_mon_ctx   = NULL;
-	struct hub_gpio_event_ctx *p_hub_gpio_event_ctx = NULL;
+	struct hub_ctx             *p_hub                 = NULL;
+	struct hub_gpio_mon_ctx    *p_hub_gpio_mon_ctx    = NULL;
+	struct hub_gpio_event_ctx  *p_hub_gpio_event_ctx  = NULL;
+	struct hub_gpio_worker_ctx *p_hub_gpio_worker_ctx = NULL;
 
 	/* Handle pathological case */
 	if (NULL == hub) {
@@ -787,6 +1749,29 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 
 	p_hub = (struct hub_ctx *)hub;
 
+	/* Left by a hub_discover_gards() that failed or was not called */
+	hub_config_cache_free(p_hub->p_config_cache);
+	p_hub->p_config_cache = NULL;
+
+	/* Gives the GARDs back their inference rate, while they can be told */
+	(void)hub_governor_stop(hub);
+
+	/* Nothing closes or opens the busses behind the rest of the clean up */
+	hub_health_stop(p_hub);
+	(void)hub_som_sampler_stop(hub);
+
+	/* The busses go away with the HUB, and so do the ops a capture wraps */
+	(void)hub_bus_capture_stop(hub);
+
+	/* App data subscriptions talk on the busses, end them while they work */
+	if (NULL != p_hub->p_gards) {
+		for (i = 0; i < p_hub->num_gards; i++) {
+			if (NULL != p_hub->p_gards[i].p_subscribe_ctx) {
+				(void)hub_unsubscribe_appdata(&p_hub->p_gards[i]);
+			}
+		}
+	}
+
 	/* 1. INITIAL NULL CHECKS AND POINTER SETUP */
 
 	if (!p_hub || !p_hub->p_gpio_mon_ctx) {
@@ -802,16 +1787,43 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 	/* Set the termination flag to signal threads to exit gracefully. */
 	p_hub_gpio_mon_ctx->terminate_flag = true;
 
-	/* 2. STOP AND JOIN GPIO EVENT THREADS */
+	/**
+	 * 2. STOP AND JOIN GPIO MONITOR THREAD
+	 * First, so that it dispatches no more events to the event threads or
+	 * the pool workers torn down below.
+	 */
+
+	if (p_hub_gpio_mon_ctx->mon_thread_hdl) {
+		/* Unblock the monitor thread if it is waiting */
+		hub_gpio_mon_wake(p_hub_gpio_mon_ctx);
+
+		/* Wait for the thread to exit (JOIN) */
+		hub_thread_join(p_hub_gpio_mon_ctx->mon_thread_hdl, NULL);
+		hub_pr_dbg("Monitor thread joined.\n");
+	}
+
+	/* 3. STOP AND JOIN GPIO EVENT THREADS */
 
 	if (p_hub_gpio_event_ctx) {
 		for (i = 0; i < p_hub_gpio_mon_ctx->num_chip_lines; i++) {
-			if (p_hub_gpio_event_ctx[i].event_thread_hdl) {
-				/* Unblock the thread from waiting on the condition variable */
-				hub_mutex_lock(&p_hub_gpio_event_ctx[i].event_mutex);
-				hub_cond_var_signal(&p_hub_gpio_event_ctx[i].event_cond_var);
-				hub_mutex_unlock(&p_hub_gpio_event_ctx[i].event_mutex);
+			if (!p_hub_gpio_event_ctx[i].in_use) {
+				continue;
+			}
 
+			/* Unblock the thread from waiting on the condition variable */
+			hub_mutex_lock(&p_hub_gpio_event_ctx[i].event_mutex);
+			hub_cond_var_signal(&p_hub_gpio_event_ctx[i].event_cond_var);
+			hub_mutex_unlock(&p_hub_gpio_event_ctx[i].event_mutex);
+
+			/* ... or from waiting for a free appdata ring buffer */
+			p_hub_gpio_worker_ctx = p_hub_gpio_event_ctx[i].p_worker_ctx;
+			if (p_hub_gpio_worker_ctx) {
+				hub_mutex_lock(&p_hub_gpio_worker_ctx->ring_mutex);
+				hub_cond_var_signal(&p_hub_gpio_worker_ctx->ring_cond_var);
+				hub_mutex_unlock(&p_hub_gpio_worker_ctx->ring_mutex);
+			}
+
+			if (p_hub_gpio_event_ctx[i].event_thread_hdl) {
 				/* Wait for the thread to exit (JOIN) */
 				hub_thread_join(p_hub_gpio_event_ctx[i].event_thread_hdl, NULL);
 				hub_pr_dbg("Event thread %d joined.\n", i);
@@ -819,46 +1831,38 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 		}
 	}
 
-	/* 3. STOP AND JOIN GPIO MONITOR THREAD */
-
-	if (p_hub_gpio_mon_ctx->mon_thread_hdl) {
-		/* Unblock the monitor thread if it is waiting */
-		if (!p_hub_gpio_mon_ctx->mon_thread_initialized) {
-			hub_mutex_lock(&p_hub_gpio_mon_ctx->mon_mutex);
-			hub_cond_var_signal(&p_hub_gpio_mon_ctx->mon_cond_var);
-			hub_mutex_unlock(&p_hub_gpio_mon_ctx->mon_mutex);
-		}
-
-		/* Wait for the thread to exit (JOIN) */
-		hub_thread_join(p_hub_gpio_mon_ctx->mon_thread_hdl, NULL);
-		hub_pr_dbg("Monitor thread joined.\n");
+	/* Reactor model: the pool workers run the worker contexts */
+	if (HUB_GPIO_EXEC_REACTOR == p_hub_gpio_mon_ctx->exec_model) {
+		hub_gpio_pool_stop(p_hub_gpio_mon_ctx);
 	}
 
-	/* 4. RELEASE GPIO RESOURCES */
-
-	if (p_hub_gpio_mon_ctx->p_chip) {
-		/* Release bulk lines */
-		if (gpiod_line_bulk_num_lines(&p_hub_gpio_mon_ctx->mon_bulk)) {
-			gpiod_line_release_bulk(&p_hub_gpio_mon_ctx->mon_bulk);
-		}
-
-		/* Release individual lines for event threads */
-		if (p_hub_gpio_event_ctx) {
-			for (i = 0; i < p_hub_gpio_mon_ctx->num_chip_lines; i++) {
-				if (p_hub_gpio_event_ctx[i].p_line) {
-					gpiod_line_release(p_hub_gpio_event_ctx[i].p_line);
-					p_hub_gpio_event_ctx[i].p_line = NULL;
-				}
+	if (p_hub_gpio_event_ctx) {
+		for (i = 0; i < p_hub_gpio_mon_ctx->num_chip_lines; i++) {
+			p_hub_gpio_worker_ctx = p_hub_gpio_event_ctx[i].p_worker_ctx;
+			if (p_hub_gpio_worker_ctx) {
+				hub_cond_var_destroy(&p_hub_gpio_worker_ctx->ring_cond_var);
+				hub_mutex_destroy(&p_hub_gpio_worker_ctx->ring_mutex);
+				free(p_hub_gpio_worker_ctx);
+				p_hub_gpio_event_ctx[i].p_worker_ctx = NULL;
 			}
 		}
 	}
 
+	hub_wake_fd_close(p_hub_gpio_mon_ctx->wake_fd);
+	p_hub_gpio_mon_ctx->wake_fd = -1;
+
+	/**
+	 * 4. RELEASE GPIO RESOURCES
+	 * The monitor / reactor thread released the lines it requested on exit.
+	 */
+	p_hub_gpio_mon_ctx->num_mon_lines = 0;
+
 	/* 5. DESTROY SYNCHRONIZATION PRIMITIVES */
 
 	/* Destroy Event thread sync objects */
 	if (p_hub_gpio_event_ctx) {
 		for (i = 0; i < p_hub_gpio_mon_ctx->num_chip_lines; i++) {
-			if (p_hub_gpio_event_ctx[i].event_thread_hdl) {
+			if (p_hub_gpio_event_ctx[i].in_use) {
 				hub_cond_var_destroy(&p_hub_gpio_event_ctx[i].event_cond_var);
 				hub_mutex_destroy(&p_hub_gpio_event_ctx[i].event_mutex);
 				hub_pr_dbg("Event thread %d's cond_var and mutex destroyed\n",
@@ -868,6 +1872,7 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 	}
 
 	if (p_hub_gpio_mon_ctx->mon_thread_hdl) {
+		hub_trace_fini(&p_hub_gpio_mon_ctx->trace);
 		hub_cond_var_destroy(&p_hub_gpio_mon_ctx->mon_cond_var);
 		hub_mutex_destroy(&p_hub_gpio_mon_ctx->mon_mutex);
 		hub_pr_dbg("Monitor thread's cond_var and mutex destroyed\n");
@@ -876,7 +1881,7 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 	/* 6. CLOSE CHIP AND FREE MEMORY */
 
 	if (p_hub_gpio_mon_ctx->p_chip) {
-		gpiod_chip_close(p_hub_gpio_mon_ctx->p_chip);
+		hub_gpiod_chip_close(p_hub_gpio_mon_ctx->p_chip);
 		p_hub_gpio_mon_ctx->p_chip = NULL;
 	}
 
@@ -893,7 +1898,17 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 	num_busses = p_hub->num_busses;
 
 	/**
-	 * First, unlock all bus mutexes to allow cleanup to proceed
+	 * Let the asynchronous data blob transfers running finish, and fail the
+	 * queued ones, while the busses are still open
+	 */
+	if (p_hub->hub_state >= HUB_DISCOVER_DONE) {
+		for (i = 0; i < num_busses; i++) {
+			hub_bus_async_fini(&p_hub->p_bus_props[i]);
+		}
+	}
+
+	/**
+	 * Then, unlock all bus mutexes to allow cleanup to proceed
 	 * This is critical if the app was interrupted during a bus operation
 	 */
 	if (p_hub->hub_state >= HUB_DISCOVER_DONE) {
@@ -943,6 +1958,9 @@ enum hub_ret_code hub_fini(hub_handle_t hub)
 			/* Ignore errors - if mutex is still locked, OS will clean up on
 			 * process exit */
 			(void)hub_mutex_destroy(&p_hub->p_bus_props[i].bus_mutex);
+			(void)hub_cond_var_destroy(&p_hub->p_bus_props[i].bus_yield_cond);
+			(void)hub_mutex_destroy(&p_hub->p_bus_props[i].pipe_mutex);
+			(void)hub_cond_var_destroy(&p_hub->p_bus_props[i].pipe_cond);
 		}
 	}
 	/* If discovery failed (state < HUB_DISCOVER_DONE), mutexes were already
@@ -953,6 +1971,16 @@ final_hub_cleanup:
 	/* Free up all allocated memory for the main hub structure */
 	if (p_hub) {
 		if (p_hub->p_gards) {
+			/* Nothing delivers app data any more, so nothing publishes or records */
+			for (i = 0; i < p_hub->num_gards; i++) {
+				(void)hub_unpublish_appdata(&p_hub->p_gards[i]);
+				hub_recorder_fini(&p_hub->p_gards[i]);
+			}
+
+			/* Nor completes an input of the pool */
+			hub_pool_fini(p_hub);
+			hub_wait_any_fini(p_hub);
+
 			if (p_hub->p_gards->num_gpio_inputs) {
 				free(p_hub->p_gards->gpio_inputs);
 			}
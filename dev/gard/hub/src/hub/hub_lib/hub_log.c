@@ -0,0 +1,570 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * HUB log.
+ *
+ * Until hub_log_start(), a record is written by the thread logging it, as a
+ * plain fprintf() would. Once started, each logging thread formats its
+ * records into a ring of its own, single producer / single consumer, and a
+ * writer thread drains the rings to the output: logging then takes no lock
+ * and makes no system call but for waking the writer, so a record logged
+ * with bus_mutex held does not hold the bus any longer than the formatting.
+ *
+ * A ring is claimed by a thread on its first record and given back when the
+ * thread exits, for the next thread to reuse once drained. Rings are never
+ * freed, as a thread may still be writing its record when the log is
+ * stopped: there are at most as many as threads that logged at once.
+ */
+
+/* syscall() is a GNU extension */
+#define _GNU_SOURCE
+
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "gard_info.h"
+#include "hub_stats.h"
+#include "hub_log.h"
+
+/* Longest message of a record, longer ones are cut */
+#define HUB_LOG_MSG_LEN              (256)
+#define HUB_LOG_DEFAULT_RING_RECORDS (256)
+#define HUB_LOG_RATE_WINDOW_NS       (1000000000ULL)
+
+/* A record waiting in a ring */
+struct hub_log_entry {
+	const struct hub_log_site *p_site;
+	uint64_t                   time_ns;
+	uint32_t                   suppressed;
+	uint8_t                    level;
+	char                       msg[HUB_LOG_MSG_LEN];
+};
+
+/**
+ * Ring of a logging thread. head is written by the thread only, tail by the
+ * writer thread only.
+ */
+struct hub_log_ring {
+	struct hub_log_ring *p_next; /* Rings are only ever added at the front */
+	bool                 in_use; /* Claimed by a live thread */
+	uint32_t             thread_id;
+	uint32_t             num_entries;
+	uint64_t             head;
+	uint64_t             tail;
+	uint64_t             drain_head; /* head taken by the drain in progress */
+	struct hub_log_entry entries[];
+};
+
+static const char *const hub_log_level_names[] = {
+	[HUB_LOG_LEVEL_ERR]  = "HUB_ERR",
+	[HUB_LOG_LEVEL_WARN] = "HUB_WARN",
+	[HUB_LOG_LEVEL_INFO] = "HUB_INFO",
+	[HUB_LOG_LEVEL_DBG]  = "HUB_DBG",
+};
+
+int hub_log_level = HUB_LOG_LEVEL_DBG;
+
+/**
+ * State of the log. is_started is read by the logging threads, the rest of
+ * the settings only change under ctl_mutex while the writer does not run.
+ */
+static struct {
+	hub_mutex_t          ctl_mutex;
+	bool                 is_started;
+	bool                 terminate_flag;
+	enum hub_log_format  format;
+	uint32_t             ring_records;
+	uint32_t             rate_limit;
+	FILE                *p_out; /* NULL for stdout and stderr */
+	hub_thread_hdl_t     thread_hdl;
+	sem_t                wake;
+	bool                 wake_pending; /* wake posted, not handled yet */
+	uint32_t             num_writers;  /* In hub_log_write(), see there */
+	struct hub_log_ring *p_rings;
+	pthread_key_t        ring_key; /* Gives a ring back on thread exit */
+	pthread_once_t       ring_key_once;
+	uint64_t             records_logged;
+	uint64_t             records_dropped;
+	uint64_t             records_suppressed;
+	uint64_t             dropped_reported;
+} hub_log = {
+	.ctl_mutex     = HUB_MUTEX_INITIALIZER,
+	.ring_key_once = PTHREAD_ONCE_INIT,
+};
+
+/* Ring of the calling thread, NULL until it logs while started */
+static __thread struct hub_log_ring *p_hub_log_thread_ring;
+
+/**
+ * Give the ring of an exiting thread back, see hub_log_ring_key_create().
+ *
+ * @param: p_arg is the ring
+ */
+static void hub_log_ring_release(void *p_arg)
+{
+	struct hub_log_ring *p_ring = (struct hub_log_ring *)p_arg;
+
+	__atomic_store_n(&p_ring->in_use, false, __ATOMIC_RELEASE);
+}
+
+static void hub_log_ring_key_create(void)
+{
+	pthread_key_create(&hub_log.ring_key, hub_log_ring_release);
+}
+
+/**
+ * Get the ring of the calling thread, claiming a drained ring given back by
+ * an exited thread or adding a new one.
+ *
+ * @return: the ring, NULL if none could be allocated
+ */
+static struct hub_log_ring *hub_log_thread_ring(void)
+{
+	struct hub_log_ring *p_ring = p_hub_log_thread_ring;
+	uint32_t             num_entries;
+	bool                 expected;
+
+	if (NULL != p_ring) {
+		return p_ring;
+	}
+
+	num_entries = hub_log.ring_records;
+
+	for (p_ring = __atomic_load_n(&hub_log.p_rings, __ATOMIC_ACQUIRE);
+		 NULL != p_ring; p_ring = p_ring->p_next) {
+		expected = false;
+		if ((p_ring->num_entries != num_entries) ||
+			!__atomic_compare_exchange_n(&p_ring->in_use, &expected, true,
+										 false, __ATOMIC_ACQ_REL,
+										 __ATOMIC_RELAXED)) {
+			continue;
+		}
+
+		/* Records left by the thread before are not to be written over */
+		if (__atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE) == p_ring->head) {
+			break;
+		}
+		__atomic_store_n(&p_ring->in_use, false, __ATOMIC_RELEASE);
+	}
+
+	if (NULL == p_ring) {
+		p_ring = (struct hub_log_ring *)calloc(
+			1, sizeof(*p_ring) + (num_entries * sizeof(p_ring->entries[0])));
+		if (NULL == p_ring) {
+			return NULL;
+		}
+
+		p_ring->in_use      = true;
+		p_ring->num_entries = num_entries;
+		p_ring->p_next = __atomic_load_n(&hub_log.p_rings, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&hub_log.p_rings, &p_ring->p_next,
+											p_ring, true, __ATOMIC_RELEASE,
+											__ATOMIC_RELAXED)) {
+		}
+	}
+
+	p_ring->thread_id = (uint32_t)syscall(SYS_gettid);
+	pthread_setspecific(hub_log.ring_key, p_ring);
+	p_hub_log_thread_ring = p_ring;
+
+	return p_ring;
+}
+
+/**
+ * Apply the rate limit of a call site.
+ *
+ * @param: p_site is the call site
+ * @param: now_ns is the time of the record
+ *
+ * @return: true if the record is to be logged
+ */
+static bool hub_log_rate_ok(struct hub_log_site *p_site, uint64_t now_ns)
+{
+	uint32_t rate_limit = __atomic_load_n(&hub_log.rate_limit, __ATOMIC_RELAXED);
+	uint64_t start_ns;
+
+	if (0 == rate_limit) {
+		return true;
+	}
+
+	/* Call sites are updated without a lock: a race only miscounts */
+	start_ns = __atomic_load_n(&p_site->window_start_ns, __ATOMIC_RELAXED);
+	if ((now_ns - start_ns) >= HUB_LOG_RATE_WINDOW_NS) {
+		__atomic_store_n(&p_site->window_start_ns, now_ns, __ATOMIC_RELAXED);
+		__atomic_store_n(&p_site->window_records, 0, __ATOMIC_RELAXED);
+	}
+
+	if (__atomic_add_fetch(&p_site->window_records, 1, __ATOMIC_RELAXED) >
+		rate_limit) {
+		__atomic_add_fetch(&p_site->suppressed, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&hub_log.records_suppressed, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Write a record to the output, as text or binary.
+ *
+ * @param: p_out is the output, NULL for stdout / stderr by level
+ * @param: p_entry is the record
+ * @param: thread_id is the thread that logged it, 0 if written by it
+ */
+static void hub_log_output(FILE                       *p_out,
+						   const struct hub_log_entry *p_entry,
+						   uint32_t                    thread_id)
+{
+	const struct hub_log_site *p_site = p_entry->p_site;
+	struct hub_log_bin_record  rec    = {0};
+	char                       suppressed[32] = "";
+
+	if (NULL == p_out) {
+		p_out = (HUB_LOG_LEVEL_ERR == p_entry->level) ? stderr : stdout;
+	}
+
+	if (HUB_LOG_FORMAT_BINARY == hub_log.format) {
+		rec.magic      = HUB_LOG_BIN_MAGIC;
+		rec.level      = p_entry->level;
+		rec.time_ns    = p_entry->time_ns;
+		rec.thread_id  = thread_id;
+		rec.line       = (uint32_t)p_site->line;
+		rec.suppressed = p_entry->suppressed;
+		rec.file_len   = (uint16_t)strlen(p_site->p_file);
+		rec.func_len   = (uint16_t)strlen(p_site->p_func);
+		rec.msg_len    = (uint32_t)strlen(p_entry->msg);
+
+		fwrite(&rec, sizeof(rec), 1, p_out);
+		fwrite(p_site->p_file, rec.file_len, 1, p_out);
+		fwrite(p_site->p_func, rec.func_len, 1, p_out);
+		fwrite(p_entry->msg, rec.msg_len, 1, p_out);
+		return;
+	}
+
+	if (0 != p_entry->suppressed) {
+		snprintf(suppressed, sizeof(suppressed), " [%u suppressed]",
+				 p_entry->suppressed);
+	}
+
+	if (0 == thread_id) {
+		fprintf(p_out, "%s: %s:%d:%s()%s: %s",
+				hub_log_level_names[p_entry->level], p_site->p_file,
+				p_site->line, p_site->p_func, suppressed, p_entry->msg);
+	} else {
+		fprintf(p_out, "[%llu.%06llu %u] %s: %s:%d:%s()%s: %s",
+				(unsigned long long)(p_entry->time_ns / 1000000000ULL),
+				(unsigned long long)((p_entry->time_ns / 1000ULL) % 1000000ULL),
+				thread_id, hub_log_level_names[p_entry->level],
+				p_site->p_file, p_site->line, p_site->p_func, suppressed,
+				p_entry->msg);
+	}
+}
+
+/**
+ * Write the records waiting in all the rings, merged by their time stamps:
+ * the record written next is the oldest at the tail of a ring. Records of a
+ * thread keep their order. Records logged while draining wait for the next
+ * drain, so only those of one drain are ordered against each other.
+ */
+static void hub_log_drain(void)
+{
+	struct hub_log_ring  *p_rings;
+	struct hub_log_ring  *p_ring;
+	struct hub_log_ring  *p_oldest;
+	struct hub_log_entry *p_entry;
+	struct hub_log_entry *p_oldest_entry = NULL;
+	uint64_t              dropped;
+
+	/* Rings added from now on are empty for this drain */
+	p_rings = __atomic_load_n(&hub_log.p_rings, __ATOMIC_ACQUIRE);
+	for (p_ring = p_rings; NULL != p_ring; p_ring = p_ring->p_next) {
+		p_ring->drain_head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+	}
+
+	for (;;) {
+		p_oldest = NULL;
+		for (p_ring = p_rings; NULL != p_ring; p_ring = p_ring->p_next) {
+			if (p_ring->tail == p_ring->drain_head) {
+				continue;
+			}
+
+			p_entry = &p_ring->entries[p_ring->tail % p_ring->num_entries];
+			if ((NULL == p_oldest) ||
+				(p_entry->time_ns < p_oldest_entry->time_ns)) {
+				p_oldest       = p_ring;
+				p_oldest_entry = p_entry;
+			}
+		}
+
+		if (NULL == p_oldest) {
+			break;
+		}
+
+		hub_log_output(hub_log.p_out, p_oldest_entry, p_oldest->thread_id);
+		__atomic_store_n(&p_oldest->tail, p_oldest->tail + 1,
+						 __ATOMIC_RELEASE);
+	}
+
+	dropped = __atomic_load_n(&hub_log.records_dropped, __ATOMIC_RELAXED);
+	if ((dropped != hub_log.dropped_reported) &&
+		(HUB_LOG_FORMAT_TEXT == hub_log.format)) {
+		fprintf((NULL != hub_log.p_out) ? hub_log.p_out : stderr,
+				"HUB_WARN: %llu log records dropped, rings full\n",
+				(unsigned long long)(dropped - hub_log.dropped_reported));
+	}
+	hub_log.dropped_reported = dropped;
+
+	fflush((NULL != hub_log.p_out) ? hub_log.p_out : stdout);
+}
+
+/**
+ * Writer thread: drains the rings each time a logging thread wakes it up.
+ *
+ * @param: p_arg is unused
+ *
+ * @return: NULL
+ */
+static void *hub_log_thread_func(void *p_arg)
+{
+	(void)p_arg;
+
+	while (!__atomic_load_n(&hub_log.terminate_flag, __ATOMIC_ACQUIRE)) {
+		while ((0 != sem_wait(&hub_log.wake)) && (EINTR == errno)) {
+		}
+
+		/* Cleared first, so that a record logged from now on wakes it again */
+		__atomic_store_n(&hub_log.wake_pending, false, __ATOMIC_SEQ_CST);
+		hub_log_drain();
+	}
+
+	hub_log_drain();
+
+	return NULL;
+}
+
+/**
+ * Log a record of a call site: into the ring of the calling thread once the
+ * log is started, else straight to the output.
+ *
+ * @param: p_site is the call site
+ * @param: level is the level of the record
+ * @param: fmt is the printf() format of the message
+ */
+void hub_log_write(struct hub_log_site *p_site,
+				   enum hub_log_level   level,
+				   const char          *fmt,
+				   ...)
+{
+	struct hub_log_entry  entry;
+	struct hub_log_entry *p_entry = &entry;
+	struct hub_log_ring  *p_ring  = NULL;
+	uint64_t              now_ns  = hub_stats_now_ns();
+	uint64_t              head    = 0;
+	va_list               args;
+	int                   len;
+
+	if (!hub_log_rate_ok(p_site, now_ns)) {
+		return;
+	}
+
+	/**
+	 * Counted before is_started is read, so that hub_log_stop() waits for
+	 * the record to be in the ring and the writer woken before it stops.
+	 */
+	__atomic_add_fetch(&hub_log.num_writers, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&hub_log.is_started, __ATOMIC_SEQ_CST)) {
+		p_ring = hub_log_thread_ring();
+		if (NULL == p_ring) {
+			__atomic_add_fetch(&hub_log.records_dropped, 1, __ATOMIC_RELAXED);
+			goto hub_log_write_done;
+		}
+
+		head = p_ring->head;
+		if ((head - __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE)) >=
+			p_ring->num_entries) {
+			__atomic_add_fetch(&hub_log.records_dropped, 1, __ATOMIC_RELAXED);
+			goto hub_log_write_done;
+		}
+		p_entry = &p_ring->entries[head % p_ring->num_entries];
+	}
+
+	p_entry->p_site  = p_site;
+	p_entry->time_ns = now_ns;
+	p_entry->level   = (uint8_t)level;
+	p_entry->suppressed =
+		__atomic_exchange_n(&p_site->suppressed, 0, __ATOMIC_RELAXED);
+
+	va_start(args, fmt);
+	len = vsnprintf(p_entry->msg, sizeof(p_entry->msg), fmt, args);
+	va_end(args);
+
+	/* A message cut short still ends the line */
+	if (len >= (int)sizeof(p_entry->msg)) {
+		memcpy(&p_entry->msg[sizeof(p_entry->msg) - 5], "...\n", 5);
+	}
+
+	__atomic_add_fetch(&hub_log.records_logged, 1, __ATOMIC_RELAXED);
+
+	if (NULL == p_ring) {
+		hub_log_output(NULL, p_entry, 0);
+		goto hub_log_write_done;
+	}
+
+	__atomic_store_n(&p_ring->head, head + 1, __ATOMIC_RELEASE);
+	if (!__atomic_exchange_n(&hub_log.wake_pending, true, __ATOMIC_SEQ_CST)) {
+		sem_post(&hub_log.wake);
+	}
+
+hub_log_write_done:
+	__atomic_sub_fetch(&hub_log.num_writers, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Move the HUB log to a writer thread.
+ *
+ * @param: p_cfg is the settings, NULL for the defaults
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_LOG on failure
+ */
+enum hub_ret_code hub_log_start(const struct hub_log_cfg *p_cfg)
+{
+	struct hub_log_cfg cfg = {0};
+
+	if (NULL != p_cfg) {
+		cfg = *p_cfg;
+	}
+
+	if ((HUB_LOG_FORMAT_BINARY == cfg.format) && (NULL == cfg.p_path)) {
+		hub_pr_err("A binary log needs a file\n");
+		return HUB_FAILURE_LOG;
+	}
+
+	pthread_once(&hub_log.ring_key_once, hub_log_ring_key_create);
+
+	hub_mutex_lock(&hub_log.ctl_mutex);
+
+	if (hub_log.is_started) {
+		hub_pr_err("HUB log already started\n");
+		goto err_log_start_1;
+	}
+
+	hub_log.format       = cfg.format;
+	hub_log.ring_records = (0 != cfg.ring_records)
+							   ? cfg.ring_records
+							   : HUB_LOG_DEFAULT_RING_RECORDS;
+	hub_log.p_out        = NULL;
+
+	if (NULL != cfg.p_path) {
+		hub_log.p_out = fopen(cfg.p_path,
+							  (HUB_LOG_FORMAT_BINARY == cfg.format) ? "ab" : "a");
+		if (NULL == hub_log.p_out) {
+			hub_pr_err("Failed to open %s\n", cfg.p_path);
+			goto err_log_start_1;
+		}
+	}
+
+	if (0 != sem_init(&hub_log.wake, 0, 0)) {
+		hub_pr_err("Failed to initialize the log wake semaphore\n");
+		goto err_log_start_2;
+	}
+
+	hub_log.terminate_flag = false;
+	hub_log.wake_pending   = false;
+
+	if (HUB_SUCCESS != hub_thread_create(&hub_log.thread_hdl, NULL,
+										 HUB_THREAD_CLASS_BUS_IO, "hub_log",
+										 hub_log_thread_func, NULL)) {
+		hub_pr_err("Failed to create log writer thread\n");
+		goto err_log_start_3;
+	}
+
+	__atomic_store_n(&hub_log.rate_limit, cfg.rate_limit, __ATOMIC_RELAXED);
+	__atomic_store_n(&hub_log.is_started, true, __ATOMIC_RELEASE);
+
+	hub_mutex_unlock(&hub_log.ctl_mutex);
+
+	return HUB_SUCCESS;
+
+err_log_start_3:
+	sem_destroy(&hub_log.wake);
+err_log_start_2:
+	if (NULL != hub_log.p_out) {
+		fclose(hub_log.p_out);
+		hub_log.p_out = NULL;
+	}
+err_log_start_1:
+	hub_mutex_unlock(&hub_log.ctl_mutex);
+	return HUB_FAILURE_LOG;
+}
+
+/**
+ * Write the records left and stop the writer thread. Records are written by
+ * the threads logging them from now on.
+ */
+void hub_log_stop(void)
+{
+	hub_mutex_lock(&hub_log.ctl_mutex);
+
+	if (!hub_log.is_started) {
+		hub_mutex_unlock(&hub_log.ctl_mutex);
+		return;
+	}
+
+	__atomic_store_n(&hub_log.is_started, false, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&hub_log.rate_limit, 0, __ATOMIC_RELAXED);
+
+	/* Records being logged into the rings still go out, and post the wake */
+	while (0 != __atomic_load_n(&hub_log.num_writers, __ATOMIC_SEQ_CST)) {
+		sched_yield();
+	}
+
+	__atomic_store_n(&hub_log.terminate_flag, true, __ATOMIC_RELEASE);
+	sem_post(&hub_log.wake);
+	hub_thread_join(hub_log.thread_hdl, NULL);
+
+	sem_destroy(&hub_log.wake);
+	if (NULL != hub_log.p_out) {
+		fclose(hub_log.p_out);
+		hub_log.p_out = NULL;
+	}
+	hub_log.format = HUB_LOG_FORMAT_TEXT;
+
+	hub_mutex_unlock(&hub_log.ctl_mutex);
+}
+
+/**
+ * Set the most verbose level logged.
+ *
+ * @param: level is the level
+ */
+void hub_log_set_level(enum hub_log_level level)
+{
+	__atomic_store_n(&hub_log_level, (int)level, __ATOMIC_RELAXED);
+}
+
+/**
+ * Read the counts of the HUB log.
+ *
+ * @param: p_stats is filled with the counts
+ */
+void hub_log_get_stats(struct hub_log_stats *p_stats)
+{
+	p_stats->records_logged =
+		__atomic_load_n(&hub_log.records_logged, __ATOMIC_RELAXED);
+	p_stats->records_dropped =
+		__atomic_load_n(&hub_log.records_dropped, __ATOMIC_RELAXED);
+	p_stats->records_suppressed =
+		__atomic_load_n(&hub_log.records_suppressed, __ATOMIC_RELAXED);
+}
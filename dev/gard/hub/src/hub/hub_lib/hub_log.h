@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_LOG_H__
+#define __HUB_LOG_H__
+
+#include "hub.h"
+#include "types.h"
+
+/**
+ * A call site of the HUB log, one static instance per hub_pr_*() call. The
+ * rate limit of hub_log_start() is kept per call site, so that an error
+ * repeated by a flaky bus does not hide the others.
+ */
+struct hub_log_site {
+	const char *p_file;
+	const char *p_func;
+	int         line;
+	uint64_t    window_start_ns; /* Start of the current rate limit window */
+	uint32_t    window_records;  /* Records in the current window */
+	uint32_t    suppressed;      /* Records not logged since the last one */
+};
+
+/* Most verbose enum hub_log_level logged, see hub_log_set_level() */
+extern int hub_log_level;
+
+/**
+ * hub_log_write logs a record of a call site, by the writer thread if
+ * started, see hub_log_start(), else by the calling thread.
+ */
+void hub_log_write(struct hub_log_site *p_site,
+				   enum hub_log_level   level,
+				   const char          *fmt,
+				   ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * hub_log logs a printf() style record at a level. Records above the level
+ * set cost a load and a compare.
+ */
+#define hub_log(level, fmt, args...)                                           \
+	do {                                                                       \
+		static struct hub_log_site hub_log_site_ = {                           \
+			.p_file = __FILE__, .p_func = __func__, .line = __LINE__};         \
+		if ((int)(level) <= __atomic_load_n(&hub_log_level, __ATOMIC_RELAXED)) \
+			hub_log_write(&hub_log_site_, (level), fmt, ##args);               \
+	} while (0)
+
+#endif /* __HUB_LOG_H__ */
@@ -0,0 +1,667 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "hub_pool.h"
+#include "hub_globals.h"
+#include "hub_stats.h"
+
+/**
+ * Multi-GARD dispatch
+ *
+ * One pool per HUB, from hub_pool_create() to hub_fini(). Each input
+ * submitted is given a sequence number and a job slot, jobs[seq modulo
+ * HUB_POOL_MAX_JOBS], and goes to one GARD:
+ * 1. The GARD is picked under lock, counted in its num_in_flight at once so
+ *    that concurrent submissions spread over the GARDs.
+ * 2. With the send_lock of the GARD held, the input joins the fifo of the
+ *    GARD and is sent, so that the fifo is in the order GARD got the inputs.
+ * 3. An App Module result of the GARD, from its app data callback, completes
+ *    the input at the head of its fifo.
+ * 4. Completed jobs are handed back from next_done_seq on, as long as they
+ *    are done, by one thread at a time with the lock released around each
+ *    callback. A slot is reused once its callback has returned.
+ *
+ * A GARD that fails to take an input, or that the health monitor loses, has
+ * its inputs failed and is left out for HUB_POOL_RETRY_MS, or until it is
+ * re-attached.
+ */
+
+/* Listing of static functions defined in this file */
+static bool  hub_pool_gard_is_available(struct hub_pool_ctx *p_ctx,
+										uint32_t             gard_index,
+										uint64_t             now_ns);
+static int   hub_pool_pick_gard(struct hub_pool_ctx *p_ctx, uint64_t now_ns);
+static void  hub_pool_complete(struct hub_pool_ctx *p_ctx,
+							   uint64_t             seq,
+							   enum hub_ret_code    ret);
+static void  hub_pool_deliver(struct hub_pool_ctx *p_ctx);
+static void  hub_pool_fail_in_flight(struct hub_pool_ctx  *p_ctx,
+									 struct hub_pool_gard *p_pg);
+static void *hub_pool_appdata_cb(void *p_cb_params, void *p_buffer,
+								 uint32_t size);
+static enum hub_ret_code hub_pool_send(struct hub_pool_ctx         *p_ctx,
+									   uint32_t                     gard_index,
+									   const struct hub_pool_input *p_input);
+
+/**
+ * Tell if a GARD of the pool may be given inputs. Called with the lock held.
+ *
+ * @param: p_ctx is the pool context
+ * @param: gard_index is the index of the GARD
+ * @param: now_ns is the current time
+ *
+ * @return: true if the GARD is neither lost nor failing
+ */
+static bool hub_pool_gard_is_available(struct hub_pool_ctx *p_ctx,
+									   uint32_t             gard_index,
+									   uint64_t             now_ns)
+{
+	struct hub_pool_gard *p_pg = &p_ctx->p_gards[gard_index];
+
+	return p_pg->in_pool && (now_ns >= p_pg->retry_ns) &&
+		   !hub_health_gard_is_lost(p_ctx->p_hub, gard_index);
+}
+
+/**
+ * Pick the GARD to give the next input to: of the available GARDs with room,
+ * the one with the fewest inputs in flight, then with the shortest latency.
+ * Ties go round-robin. Called with the lock held.
+ *
+ * @param: p_ctx is the pool context
+ * @param: now_ns is the current time
+ *
+ * @return: the index of the GARD, -1 if none has room
+ */
+static int hub_pool_pick_gard(struct hub_pool_ctx *p_ctx, uint64_t now_ns)
+{
+	struct hub_pool_gard *p_pg, *p_best = NULL;
+	uint32_t              num_gards     = p_ctx->p_hub->num_gards;
+	uint32_t              i, gard_index;
+
+	for (i = 0; i < num_gards; i++) {
+		gard_index = (p_ctx->next_gard + i) % num_gards;
+		p_pg       = &p_ctx->p_gards[gard_index];
+
+		if ((p_pg->num_in_flight >= p_ctx->cfg.max_in_flight) ||
+			!hub_pool_gard_is_available(p_ctx, gard_index, now_ns)) {
+			continue;
+		}
+
+		if ((NULL == p_best) ||
+			(p_pg->num_in_flight < p_best->num_in_flight) ||
+			((p_pg->num_in_flight == p_best->num_in_flight) &&
+			 (p_pg->avg_latency_ns < p_best->avg_latency_ns))) {
+			p_best = p_pg;
+		}
+	}
+
+	if (NULL == p_best) {
+		return -1;
+	}
+
+	p_ctx->next_gard = (p_best->gard_index + 1) % num_gards;
+
+	return (int)p_best->gard_index;
+}
+
+/**
+ * Mark a job done and hand back the jobs done in order. Called with the lock
+ * held.
+ *
+ * @param: p_ctx is the pool context
+ * @param: seq is the sequence number of the job
+ * @param: ret is the outcome of the job
+ */
+static void hub_pool_complete(struct hub_pool_ctx *p_ctx,
+							  uint64_t             seq,
+							  enum hub_ret_code    ret)
+{
+	struct hub_pool_job  *p_job = &p_ctx->jobs[seq % HUB_POOL_MAX_JOBS];
+	struct hub_pool_gard *p_pg  = &p_ctx->p_gards[p_job->gard_index];
+	uint64_t              latency_ns;
+
+	p_job->is_done = true;
+	p_job->ret     = ret;
+
+	p_pg->num_in_flight--;
+	if (HUB_SUCCESS == ret) {
+		p_pg->num_completed++;
+
+		latency_ns = hub_stats_now_ns() - p_job->submit_ns;
+		if (0 == p_pg->avg_latency_ns) {
+			p_pg->avg_latency_ns = latency_ns;
+		} else {
+			p_pg->avg_latency_ns = p_pg->avg_latency_ns -
+								   (p_pg->avg_latency_ns >>
+									HUB_POOL_LATENCY_SHIFT) +
+								   (latency_ns >> HUB_POOL_LATENCY_SHIFT);
+		}
+	} else {
+		p_pg->num_failed++;
+	}
+
+	/* Room for another input */
+	hub_cond_var_broadcast(&p_ctx->cond_var);
+
+	hub_pool_deliver(p_ctx);
+}
+
+/**
+ * Call the callbacks of the jobs done, in the order of their submission,
+ * from next_done_seq on. Only one thread does at a time: a job completed
+ * meanwhile is handed back by the thread already at it. Called with the lock
+ * held, released around each callback.
+ *
+ * @param: p_ctx is the pool context
+ */
+static void hub_pool_deliver(struct hub_pool_ctx *p_ctx)
+{
+	struct hub_pool_job job;
+	uint64_t            seq;
+
+	if (p_ctx->is_delivering) {
+		return;
+	}
+	p_ctx->is_delivering = true;
+
+	while (p_ctx->next_done_seq != p_ctx->next_seq) {
+		seq = p_ctx->next_done_seq;
+		job = p_ctx->jobs[seq % HUB_POOL_MAX_JOBS];
+		if (!job.is_done) {
+			break;
+		}
+
+		/* The slot is not reused before next_done_seq moves past it */
+		hub_mutex_unlock(&p_ctx->lock);
+		job.cb(job.p_cb_ctx, seq,
+			   (gard_handle_t)&p_ctx->p_hub->p_gards[job.gard_index], job.ret,
+			   (HUB_SUCCESS == job.ret) ? job.p_result : NULL,
+			   (HUB_SUCCESS == job.ret) ? job.result_size : 0);
+		hub_mutex_lock(&p_ctx->lock);
+
+		p_ctx->next_done_seq++;
+		hub_cond_var_broadcast(&p_ctx->cond_var);
+	}
+
+	p_ctx->is_delivering = false;
+}
+
+/**
+ * Fail the inputs in flight on a GARD. Called with the lock held.
+ *
+ * @param: p_ctx is the pool context
+ * @param: p_pg is the GARD
+ */
+static void hub_pool_fail_in_flight(struct hub_pool_ctx  *p_ctx,
+									struct hub_pool_gard *p_pg)
+{
+	uint64_t seq;
+
+	while (p_pg->fifo_count) {
+		seq             = p_pg->fifo[p_pg->fifo_head];
+		p_pg->fifo_head = (p_pg->fifo_head + 1) % HUB_POOL_MAX_JOBS;
+		p_pg->fifo_count--;
+
+		hub_pool_complete(p_ctx, seq, HUB_FAILURE_POOL);
+	}
+}
+
+/**
+ * App data callback of the GARDs of the pool: the result completes the
+ * oldest input in flight on the GARD.
+ *
+ * @param: p_cb_params is the pool GARD
+ * @param: p_buffer is the App Module result
+ * @param: size is the size of the result
+ *
+ * @return: HUB_SUCCESS
+ */
+static void *hub_pool_appdata_cb(void *p_cb_params, void *p_buffer,
+								 uint32_t size)
+{
+	struct hub_pool_gard *p_pg  = (struct hub_pool_gard *)p_cb_params;
+	struct hub_pool_ctx  *p_ctx = p_pg->p_ctx;
+	struct hub_pool_job  *p_job;
+	uint64_t              seq;
+
+	hub_mutex_lock(&p_ctx->lock);
+
+	if (0 == p_pg->fifo_count) {
+		p_pg->num_unmatched++;
+		hub_mutex_unlock(&p_ctx->lock);
+		hub_pr_dbg("GARD %u result with no input in flight\n",
+				   p_pg->gard_index);
+		return (void *)(intptr_t)HUB_SUCCESS;
+	}
+
+	seq             = p_pg->fifo[p_pg->fifo_head];
+	p_pg->fifo_head = (p_pg->fifo_head + 1) % HUB_POOL_MAX_JOBS;
+	p_pg->fifo_count--;
+
+	p_job              = &p_ctx->jobs[seq % HUB_POOL_MAX_JOBS];
+	p_job->result_size = hub_min_uint32(size, p_ctx->cfg.result_size);
+	memcpy(p_job->p_result, p_buffer, p_job->result_size);
+
+	hub_pool_complete(p_ctx, seq, HUB_SUCCESS);
+
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return (void *)(intptr_t)HUB_SUCCESS;
+}
+
+/**
+ * Send an input to a GARD, and the App Module command starting it if any.
+ * Called with the send_lock of the GARD held.
+ *
+ * @param: p_ctx is the pool context
+ * @param: gard_index is the index of the GARD
+ * @param: p_input is the input
+ *
+ * @return: HUB_SUCCESS on success, the failure code of the transfer otherwise
+ */
+static enum hub_ret_code hub_pool_send(struct hub_pool_ctx         *p_ctx,
+									   uint32_t                     gard_index,
+									   const struct hub_pool_input *p_input)
+{
+	gard_handle_t     gard = (gard_handle_t)&p_ctx->p_hub->p_gards[gard_index];
+	enum hub_ret_code ret;
+	uint32_t          status;
+
+	if ((NULL != p_input->p_data) && p_input->size) {
+		ret = hub_send_data_to_gard(gard, (void *)p_input->p_data,
+									p_input->gard_addr, p_input->size);
+		if (HUB_SUCCESS != ret) {
+			return ret;
+		}
+	}
+
+	if (p_input->command_id) {
+		ret = hub_send_app_command(gard, p_input->command_id,
+								   p_input->p_command_body,
+								   p_input->command_body_size, &status);
+		if (HUB_SUCCESS != ret) {
+			return ret;
+		}
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_pool_create makes the pool of a HUB.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_cfg is the configuration of the pool
+ * @param: p_pool is filled with the pool handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_POOL on failure
+ */
+enum hub_ret_code hub_pool_create(hub_handle_t               hub,
+								  const struct hub_pool_cfg *p_cfg,
+								  hub_pool_handle_t         *p_pool)
+{
+	struct hub_ctx       *p_hub = (struct hub_ctx *)hub;
+	struct hub_pool_ctx  *p_ctx;
+	struct hub_pool_gard *p_pg;
+	uint32_t              i, num_in_pool = 0;
+
+	if ((NULL == p_hub) || (NULL == p_cfg) || (NULL == p_pool)) {
+		hub_pr_err("Invalid arguments\n");
+		goto err_pool_create_1;
+	}
+
+	if ((0 == p_cfg->result_size) || (0 == p_cfg->max_in_flight)) {
+		hub_pr_err("Invalid pool configuration\n");
+		goto err_pool_create_1;
+	}
+
+	if (NULL != p_hub->p_pool_ctx) {
+		hub_pr_err("HUB has a pool already\n");
+		goto err_pool_create_1;
+	}
+
+	p_ctx = (struct hub_pool_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate pool context\n");
+		goto err_pool_create_1;
+	}
+
+	p_ctx->p_hub = p_hub;
+	p_ctx->cfg   = *p_cfg;
+	if (p_ctx->cfg.max_in_flight > HUB_POOL_MAX_JOBS) {
+		p_ctx->cfg.max_in_flight = HUB_POOL_MAX_JOBS;
+	}
+
+	p_ctx->p_gards = (struct hub_pool_gard *)calloc(
+		p_hub->num_gards ? p_hub->num_gards : 1, sizeof(*p_ctx->p_gards));
+	if (NULL == p_ctx->p_gards) {
+		hub_pr_err("Failed to allocate pool GARDs\n");
+		goto err_pool_create_2;
+	}
+
+	/* A result buffer per job, and one per GARD for the app data path */
+	p_ctx->p_results = (uint8_t *)calloc(HUB_POOL_MAX_JOBS + p_hub->num_gards,
+										 p_cfg->result_size);
+	if (NULL == p_ctx->p_results) {
+		hub_pr_err("Failed to allocate pool result buffers\n");
+		goto err_pool_create_3;
+	}
+
+	for (i = 0; i < HUB_POOL_MAX_JOBS; i++) {
+		p_ctx->jobs[i].p_result = p_ctx->p_results + i * p_cfg->result_size;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ctx->lock)) {
+		goto err_pool_create_4;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ctx->cond_var)) {
+		goto err_pool_create_5;
+	}
+
+	for (i = 0; i < p_hub->num_gards; i++) {
+		p_pg             = &p_ctx->p_gards[i];
+		p_pg->p_ctx      = p_ctx;
+		p_pg->gard_index = i;
+		p_pg->p_appdata  = p_ctx->p_results +
+						  (HUB_POOL_MAX_JOBS + i) * p_cfg->result_size;
+
+		if (p_cfg->gard_mask && !(p_cfg->gard_mask & (1U << i))) {
+			continue;
+		}
+
+		if (HUB_SUCCESS != hub_mutex_init(&p_pg->send_lock)) {
+			continue;
+		}
+
+		/* Results come in from now on, the pool is not used before */
+		if (HUB_SUCCESS != hub_setup_appdata_cb((gard_handle_t)&p_hub
+													->p_gards[i],
+												hub_pool_appdata_cb, p_pg,
+												p_pg->p_appdata,
+												p_cfg->result_size)) {
+			hub_pr_warn("GARD %u left out of the pool, no app data path\n",
+						i);
+			hub_mutex_destroy(&p_pg->send_lock);
+			continue;
+		}
+
+		p_pg->in_pool = true;
+		num_in_pool++;
+	}
+
+	/**
+	 * The app data callbacks of GARDs in the pool cannot be taken back, so
+	 * from here on the pool lives until hub_fini().
+	 */
+	p_hub->p_pool_ctx = p_ctx;
+	if (0 == num_in_pool) {
+		hub_pr_err("No GARD in the pool\n");
+		return HUB_FAILURE_POOL;
+	}
+
+	*p_pool = (hub_pool_handle_t)p_ctx;
+
+	return HUB_SUCCESS;
+
+err_pool_create_5:
+	hub_mutex_destroy(&p_ctx->lock);
+err_pool_create_4:
+	free(p_ctx->p_results);
+err_pool_create_3:
+	free(p_ctx->p_gards);
+err_pool_create_2:
+	free(p_ctx);
+err_pool_create_1:
+	return HUB_FAILURE_POOL;
+}
+
+/**
+ * hub_pool_submit runs an input on the least loaded GARD of a pool.
+ *
+ * @param: pool is the pool handle
+ * @param: p_input is the input
+ * @param: cb is the completion callback
+ * @param: p_cb_ctx is an opaque callback context
+ * @param: p_seq is filled with the sequence number of the input, if not NULL
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if no GARD had room in time
+ *			HUB_FAILURE_POOL on failure
+ */
+enum hub_ret_code hub_pool_submit(hub_pool_handle_t            pool,
+								  const struct hub_pool_input *p_input,
+								  hub_pool_done_cb_t           cb,
+								  void                        *p_cb_ctx,
+								  uint64_t                    *p_seq)
+{
+	struct hub_pool_ctx  *p_ctx = (struct hub_pool_ctx *)pool;
+	struct hub_pool_gard *p_pg;
+	struct hub_pool_job  *p_job;
+	struct timespec       deadline;
+	enum hub_ret_code     ret = HUB_SUCCESS;
+	uint64_t              seq;
+	uint32_t              tail;
+	int                   gard_index;
+
+	if ((NULL == p_ctx) || (NULL == p_input) || (NULL == cb)) {
+		hub_pr_err("Invalid arguments\n");
+		return HUB_FAILURE_POOL;
+	}
+
+	hub_deadline_from_now(&deadline, p_ctx->cfg.submit_timeout_ms);
+
+	/* Wait for a free job slot and a GARD with room */
+	hub_mutex_lock(&p_ctx->lock);
+	for (;;) {
+		if (p_ctx->is_stopping) {
+			hub_mutex_unlock(&p_ctx->lock);
+			return HUB_FAILURE_POOL;
+		}
+
+		gard_index = -1;
+		if ((p_ctx->next_seq - p_ctx->next_done_seq) < HUB_POOL_MAX_JOBS) {
+			gard_index = hub_pool_pick_gard(p_ctx, hub_stats_now_ns());
+		}
+		if (gard_index >= 0) {
+			break;
+		}
+
+		if (HUB_SUCCESS != ret) {
+			hub_mutex_unlock(&p_ctx->lock);
+			return HUB_FAILURE_CONDVAR_TIMEDOUT;
+		}
+
+		/* A GARD out for a failure may be back by the deadline */
+		ret = hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+	}
+
+	seq   = p_ctx->next_seq++;
+	p_job = &p_ctx->jobs[seq % HUB_POOL_MAX_JOBS];
+	p_pg  = &p_ctx->p_gards[gard_index];
+
+	p_job->cb          = cb;
+	p_job->p_cb_ctx    = p_cb_ctx;
+	p_job->gard_index  = (uint32_t)gard_index;
+	p_job->submit_ns   = hub_stats_now_ns();
+	p_job->is_done     = false;
+	p_job->ret         = HUB_SUCCESS;
+	p_job->result_size = 0;
+
+	p_pg->num_in_flight++;
+	p_pg->num_submitted++;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	if (NULL != p_seq) {
+		*p_seq = seq;
+	}
+
+	/* Inputs reach GARD in the order of its fifo */
+	hub_mutex_lock(&p_pg->send_lock);
+
+	hub_mutex_lock(&p_ctx->lock);
+	tail             = (p_pg->fifo_head + p_pg->fifo_count) % HUB_POOL_MAX_JOBS;
+	p_pg->fifo[tail] = seq;
+	p_pg->fifo_count++;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	ret = hub_pool_send(p_ctx, (uint32_t)gard_index, p_input);
+
+	hub_mutex_lock(&p_ctx->lock);
+	if ((HUB_SUCCESS != ret) && p_pg->fifo_count &&
+		(seq == p_pg->fifo[tail])) {
+		/* Still last in the fifo, as the send_lock is held */
+		p_pg->fifo_count--;
+		p_pg->retry_ns = hub_stats_now_ns() +
+						 (uint64_t)HUB_POOL_RETRY_MS * 1000000ULL;
+		hub_pr_warn("GARD %u failed to take input %llu: %d\n", gard_index,
+					(unsigned long long)seq, ret);
+		hub_pool_complete(p_ctx, seq, ret);
+	}
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_mutex_unlock(&p_pg->send_lock);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_pool_drain waits for all the inputs submitted to a pool to be handed
+ * back.
+ *
+ * @param: pool is the pool handle
+ * @param: timeout_ms is the longest wait
+ *
+ * @return: HUB_SUCCESS once drained
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT on timeout
+ *			HUB_FAILURE_POOL on an invalid handle
+ */
+enum hub_ret_code hub_pool_drain(hub_pool_handle_t pool, uint32_t timeout_ms)
+{
+	struct hub_pool_ctx *p_ctx = (struct hub_pool_ctx *)pool;
+	struct timespec      deadline;
+	enum hub_ret_code    ret   = HUB_SUCCESS;
+
+	if (NULL == p_ctx) {
+		hub_pr_err("Invalid pool handle\n");
+		return HUB_FAILURE_POOL;
+	}
+
+	hub_deadline_from_now(&deadline, timeout_ms);
+
+	hub_mutex_lock(&p_ctx->lock);
+	while ((p_ctx->next_done_seq != p_ctx->next_seq) &&
+		   (HUB_SUCCESS == ret)) {
+		ret = hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+	}
+	if (p_ctx->next_done_seq == p_ctx->next_seq) {
+		ret = HUB_SUCCESS;
+	}
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return (HUB_SUCCESS == ret) ? HUB_SUCCESS : HUB_FAILURE_CONDVAR_TIMEDOUT;
+}
+
+/**
+ * hub_pool_get_gard_state reads what a pool does with one of the GARDs.
+ *
+ * @param: pool is the pool handle
+ * @param: gard_num is the GARD number
+ * @param: p_state is filled with the state
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_POOL on invalid arguments
+ */
+enum hub_ret_code
+	hub_pool_get_gard_state(hub_pool_handle_t           pool,
+							uint32_t                    gard_num,
+							struct hub_pool_gard_state *p_state)
+{
+	struct hub_pool_ctx  *p_ctx = (struct hub_pool_ctx *)pool;
+	struct hub_pool_gard *p_pg;
+
+	if ((NULL == p_ctx) || (NULL == p_state) ||
+		(gard_num >= p_ctx->p_hub->num_gards)) {
+		hub_pr_err("Invalid arguments\n");
+		return HUB_FAILURE_POOL;
+	}
+
+	p_pg = &p_ctx->p_gards[gard_num];
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_state->in_pool        = p_pg->in_pool;
+	p_state->is_available   =
+		hub_pool_gard_is_available(p_ctx, gard_num, hub_stats_now_ns());
+	p_state->num_in_flight  = p_pg->num_in_flight;
+	p_state->avg_latency_ns = p_pg->avg_latency_ns;
+	p_state->num_submitted  = p_pg->num_submitted;
+	p_state->num_completed  = p_pg->num_completed;
+	p_state->num_failed     = p_pg->num_failed;
+	p_state->num_unmatched  = p_pg->num_unmatched;
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_pool_gard_lost fails the inputs in flight on a lost GARD.
+ *
+ * @param: p_hub is the HUB
+ * @param: gard_index is the index of the GARD lost
+ */
+void hub_pool_gard_lost(struct hub_ctx *p_hub, uint32_t gard_index)
+{
+	struct hub_pool_ctx *p_ctx = p_hub->p_pool_ctx;
+
+	if ((NULL == p_ctx) || !p_ctx->p_gards[gard_index].in_pool) {
+		return;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	hub_pool_fail_in_flight(p_ctx, &p_ctx->p_gards[gard_index]);
+	hub_mutex_unlock(&p_ctx->lock);
+}
+
+/**
+ * hub_pool_fini fails the inputs left in flight and frees the pool of a HUB.
+ *
+ * @param: p_hub is the HUB
+ */
+void hub_pool_fini(struct hub_ctx *p_hub)
+{
+	struct hub_pool_ctx *p_ctx = p_hub->p_pool_ctx;
+	uint32_t             i;
+
+	if (NULL == p_ctx) {
+		return;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->is_stopping = true;
+	for (i = 0; i < p_hub->num_gards; i++) {
+		hub_pool_fail_in_flight(p_ctx, &p_ctx->p_gards[i]);
+	}
+	hub_cond_var_broadcast(&p_ctx->cond_var);
+	hub_mutex_unlock(&p_ctx->lock);
+
+	for (i = 0; i < p_hub->num_gards; i++) {
+		if (p_ctx->p_gards[i].in_pool) {
+			hub_mutex_destroy(&p_ctx->p_gards[i].send_lock);
+		}
+	}
+
+	hub_cond_var_destroy(&p_ctx->cond_var);
+	hub_mutex_destroy(&p_ctx->lock);
+	free(p_ctx->p_results);
+	free(p_ctx->p_gards);
+	free(p_ctx);
+
+	p_hub->p_pool_ctx = NULL;
+}
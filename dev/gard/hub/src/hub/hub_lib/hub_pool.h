@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_POOL_H__
+#define __HUB_POOL_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+/* Inputs submitted to a pool and not yet handed back, at most */
+#define HUB_POOL_MAX_JOBS (64)
+
+/* A GARD that failed to take an input is not given another for this long */
+#define HUB_POOL_RETRY_MS (1000)
+
+/* Weight of the last latency in the average of a GARD, as 1 / 2^n */
+#define HUB_POOL_LATENCY_SHIFT (3)
+
+/* An input submitted to a pool, from hub_pool_submit() to its callback */
+struct hub_pool_job {
+	hub_pool_done_cb_t cb;
+	void              *p_cb_ctx;
+	uint32_t           gard_index;
+	uint64_t           submit_ns;
+	bool               is_done;
+	enum hub_ret_code  ret;
+	uint32_t           result_size;
+	uint8_t           *p_result; /* cfg.result_size bytes */
+};
+
+/* A GARD of a pool */
+struct hub_pool_gard {
+	struct hub_pool_ctx *p_ctx;       /* App data callback context */
+	uint32_t             gard_index;
+	bool                 in_pool;
+
+	/* Keeps the inputs going to GARD in the order of fifo */
+	hub_mutex_t          send_lock;
+
+	/**
+	 * Sequence numbers of the inputs given to GARD and not completed yet,
+	 * oldest first: GARD hands its results back in the order of its inputs.
+	 * num_in_flight also counts an input picked for GARD and not yet in fifo.
+	 */
+	uint64_t             fifo[HUB_POOL_MAX_JOBS];
+	uint32_t             fifo_head;
+	uint32_t             fifo_count;
+	uint32_t             num_in_flight;
+
+	uint64_t             retry_ns;       /* Given no input before */
+	uint64_t             avg_latency_ns; /* From submission to result */
+	uint64_t             num_submitted;
+	uint64_t             num_completed;
+	uint64_t             num_failed;
+	uint64_t             num_unmatched;  /* Results with no input in flight */
+
+	uint8_t             *p_appdata;      /* Filled by the app data path */
+};
+
+struct hub_pool_ctx {
+	struct hub_ctx       *p_hub;
+	struct hub_pool_cfg   cfg;
+	struct hub_pool_gard *p_gards;
+	uint8_t              *p_results;  /* Result buffers of the jobs */
+
+	/* Jobs by sequence number modulo HUB_POOL_MAX_JOBS, under lock */
+	struct hub_pool_job   jobs[HUB_POOL_MAX_JOBS];
+	uint64_t              next_seq;      /* Of the next submission */
+	uint64_t              next_done_seq; /* Next to be handed back */
+	bool                  is_delivering; /* A thread runs the callbacks */
+	bool                  is_stopping;
+	uint32_t              next_gard;     /* Where the next pick starts */
+
+	hub_mutex_t           lock;
+	hub_cond_var_t        cond_var;
+};
+
+/**
+ * hub_pool_gard_lost fails the inputs in flight on a GARD the health monitor
+ * lost, as their results will not come. Called by the health monitor thread.
+ */
+void hub_pool_gard_lost(struct hub_ctx *p_hub, uint32_t gard_index);
+
+/**
+ * hub_pool_fini fails the inputs left in flight and frees the pool of a HUB,
+ * if any. Called by hub_fini() once the app data path has stopped.
+ */
+void hub_pool_fini(struct hub_ctx *p_hub);
+
+/* Defined in hub_health.c */
+bool hub_health_gard_is_lost(struct hub_ctx *p_hub, uint32_t gard_index);
+
+#endif /* __HUB_POOL_H__ */
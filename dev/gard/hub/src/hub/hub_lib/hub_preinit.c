@@ -23,11 +23,24 @@
 #include "hub_usb.h"
 
 #include "gard_info.h"
+#include "hub_gpio.h"
+#include "hub_config_cache.h"
+#include "hub_health.h"
 
 /* Static function listing */
 static enum hub_ret_code hub_print_bus_details(struct hub_gard_bus *p_bus);
+static enum hub_ret_code hub_setup_bus_ops(struct hub_gard_bus *p_bus);
 static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 											   struct hub_ctx *p_hub);
+static enum hub_ret_code hub_load_host_config(char *p_host_config_file,
+											  struct hub_ctx *p_hub);
+static enum hub_uart_flush_policy
+	hub_parse_uart_flush_policy(const cJSON *p_field);
+static enum hub_gpio_exec_model
+	hub_parse_gpio_exec_model(const cJSON *p_field);
+static void hub_parse_thread_props(const cJSON          *p_thread_props,
+								   const char           *p_key,
+								   enum hub_thread_class thread_class);
 
 /**
  * HUB INIT internal function
@@ -50,6 +63,13 @@ static enum hub_ret_code hub_print_bus_details(struct hub_gard_bus *p_bus)
 	}
 
 	bus_type = p_bus->types;
+	hub_pr_dbg("\tgard_index: %u\n", p_bus->gard_index);
+	hub_pr_dbg("\txfer_chunk_size: %u\n", p_bus->xfer_chunk_size);
+	hub_pr_dbg("\tmtu_size: %u\n", p_bus->mtu_size);
+	hub_pr_dbg("\tmtu_window: %u\n", p_bus->mtu_window);
+	hub_pr_dbg("\tdata_crc: %u\n", p_bus->data_crc);
+	hub_pr_dbg("\tapp_data_batch: %u\n", p_bus->app_data_batch);
+	hub_pr_dbg("\tcmd_pipelining: %u\n", p_bus->cmd_pipelining);
 	switch (bus_type) {
 	case HUB_GARD_BUS_I2C:
 		hub_pr_dbg("\tbus_type: %s\n", hub_gard_bus_strings[bus_type]);
@@ -61,11 +81,21 @@ static enum hub_ret_code hub_print_bus_details(struct hub_gard_bus *p_bus)
 		hub_pr_dbg("\tbus_type: %s\n", hub_gard_bus_strings[bus_type]);
 		hub_pr_dbg("\t\tbus_dev: %s\n", p_bus->uart.bus_dev);
 		hub_pr_dbg("\t\tbaudrate: %u\n", p_bus->uart.baudrate);
+		hub_pr_dbg("\t\tflush_policy: %d\n", p_bus->uart.flush_policy);
+		hub_pr_dbg("\t\thw_flow_control: %d\n", p_bus->uart.hw_flow_control);
+		hub_pr_dbg("\t\ttarget_baudrate: %u\n", p_bus->uart.target_baudrate);
+		hub_pr_dbg("\t\tread_timeout_ms: %u\n", p_bus->uart.read_timeout_ms);
+		hub_pr_dbg("\t\tprobe_timeout_ms: %u\n", p_bus->uart.probe_timeout_ms);
+		hub_pr_dbg("\t\trx_ring_size: %u\n", p_bus->uart.rx_ring_size);
 		break;
 	case HUB_GARD_BUS_USB:
 		hub_pr_dbg("\tbus_type: %s\n", hub_gard_bus_strings[bus_type]);
 		hub_pr_dbg("\t\tvendor_id: 0x%x\n", p_bus->usb.vendor_id);
 		hub_pr_dbg("\t\tproduct_id: 0x%x\n", p_bus->usb.product_id);
+		hub_pr_dbg("\t\tport_path: %s\n", p_bus->usb.port_path);
+		hub_pr_dbg("\t\tserial_number: %s\n", p_bus->usb.serial_number);
+		hub_pr_dbg("\t\tburst_size: %u\n", p_bus->usb.burst_size);
+		hub_pr_dbg("\t\tasync_depth: %u\n", p_bus->usb.async_depth);
 		break;
 	default:
 		hub_pr_err("Unknown bus\n");
@@ -75,6 +105,232 @@ static enum hub_ret_code hub_print_bus_details(struct hub_gard_bus *p_bus)
 	return HUB_SUCCESS;
 }
 
+/**
+ * HUB INIT internal function
+ *
+ * Map the optional "uart_flush_policy" host config value to a flush policy.
+ * Accepted values are "never", "per_xfer" and "per_write".
+ *
+ * @param: p_field is the JSON item for the key, may be NULL
+ *
+ * @return: hub_uart_flush_policy, HUB_UART_FLUSH_PER_XFER if absent/unknown
+ */
+static enum hub_uart_flush_policy
+	hub_parse_uart_flush_policy(const cJSON *p_field)
+{
+	if (!cJSON_IsString(p_field)) {
+		return HUB_UART_FLUSH_PER_XFER;
+	}
+
+	if (0 == strcmp(p_field->valuestring, "never")) {
+		return HUB_UART_FLUSH_NEVER;
+	}
+
+	if (0 == strcmp(p_field->valuestring, "per_write")) {
+		return HUB_UART_FLUSH_PER_WRITE;
+	}
+
+	if (0 != strcmp(p_field->valuestring, "per_xfer")) {
+		hub_pr_warn("Invalid uart_flush_policy %s, using per_xfer\n",
+					p_field->valuestring);
+	}
+
+	return HUB_UART_FLUSH_PER_XFER;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Map the optional "gpio_exec_model" host config value to a GPIO execution
+ * model. Accepted values are "thread_per_line" and "reactor".
+ *
+ * @param: p_field is the JSON item for the key, may be NULL
+ *
+ * @return: hub_gpio_exec_model, HUB_GPIO_EXEC_THREAD_PER_LINE if
+ *			absent/unknown
+ */
+static enum hub_gpio_exec_model
+	hub_parse_gpio_exec_model(const cJSON *p_field)
+{
+	if (!cJSON_IsString(p_field)) {
+		return HUB_GPIO_EXEC_THREAD_PER_LINE;
+	}
+
+	if (0 == strcmp(p_field->valuestring, "reactor")) {
+		return HUB_GPIO_EXEC_REACTOR;
+	}
+
+	if (0 != strcmp(p_field->valuestring, "thread_per_line")) {
+		hub_pr_warn("Invalid gpio_exec_model %s, using thread_per_line\n",
+					p_field->valuestring);
+	}
+
+	return HUB_GPIO_EXEC_THREAD_PER_LINE;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Parse the optional "log_level" of the host config, one of "err", "warn",
+ * "info" and "dbg".
+ *
+ * @param: p_field is the JSON field, may be NULL
+ *
+ * @return: enum hub_log_level, -1 if absent or invalid
+ */
+static int32_t hub_parse_log_level(const cJSON *p_field)
+{
+	static const char *const names[] = {
+		[HUB_LOG_LEVEL_ERR]  = "err",
+		[HUB_LOG_LEVEL_WARN] = "warn",
+		[HUB_LOG_LEVEL_INFO] = "info",
+		[HUB_LOG_LEVEL_DBG]  = "dbg",
+	};
+	int32_t level;
+
+	if (!cJSON_IsString(p_field)) {
+		return -1;
+	}
+
+	for (level = HUB_LOG_LEVEL_ERR; level <= HUB_LOG_LEVEL_DBG; level++) {
+		if (0 == strcmp(p_field->valuestring, names[level])) {
+			return level;
+		}
+	}
+
+	hub_pr_warn("Invalid log_level %s, ignoring\n", p_field->valuestring);
+
+	return -1;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Parse the scheduling properties of a class of HUB threads from the
+ * optional "thread_props" host config object, e.g.
+ *	"gpio_worker": { "cpu_affinity": [3], "sched_policy": "fifo",
+ *					 "sched_priority": 50, "stack_size": 0 }
+ * sched_policy is one of "other", "fifo" and "rr". Absent keys keep their
+ * defaults.
+ *
+ * @param: p_thread_props is the "thread_props" JSON object, may be NULL
+ * @param: p_key is the name of the thread class in p_thread_props
+ * @param: thread_class is the class of HUB threads to set up
+ */
+static void hub_parse_thread_props(const cJSON          *p_thread_props,
+								   const char           *p_key,
+								   enum hub_thread_class thread_class)
+{
+	struct hub_thread_props props = { 0 };
+	const cJSON            *p_class_json;
+	const cJSON            *p_field;
+	const cJSON            *p_cpu;
+
+	props.sched_policy = SCHED_OTHER;
+
+	p_class_json = cJSON_GetObjectItemCaseSensitive(p_thread_props, p_key);
+	if (!cJSON_IsObject(p_class_json)) {
+		hub_thread_set_props(thread_class, &props);
+		return;
+	}
+
+	p_field = cJSON_GetObjectItemCaseSensitive(p_class_json, "cpu_affinity");
+	cJSON_ArrayForEach(p_cpu, p_field)
+	{
+		if (cJSON_IsNumber(p_cpu) && (p_cpu->valueint >= 0) &&
+			(p_cpu->valueint < 64)) {
+			props.cpu_mask |= 1ULL << p_cpu->valueint;
+		} else {
+			hub_pr_warn("Invalid %s cpu_affinity entry, ignoring\n", p_key);
+		}
+	}
+
+	p_field = cJSON_GetObjectItemCaseSensitive(p_class_json, "sched_policy");
+	if (cJSON_IsString(p_field)) {
+		if (0 == strcmp(p_field->valuestring, "fifo")) {
+			props.sched_policy = SCHED_FIFO;
+		} else if (0 == strcmp(p_field->valuestring, "rr")) {
+			props.sched_policy = SCHED_RR;
+		} else if (0 != strcmp(p_field->valuestring, "other")) {
+			hub_pr_warn("Invalid %s sched_policy %s, using other\n", p_key,
+						p_field->valuestring);
+		}
+	}
+
+	p_field = cJSON_GetObjectItemCaseSensitive(p_class_json, "sched_priority");
+	if (cJSON_IsNumber(p_field)) {
+		props.sched_priority = p_field->valueint;
+	}
+
+	p_field = cJSON_GetObjectItemCaseSensitive(p_class_json, "stack_size");
+	if (cJSON_IsNumber(p_field) && (p_field->valuedouble > 0)) {
+		props.stack_size = (size_t)p_field->valuedouble;
+	}
+
+	hub_pr_dbg("%s: cpu_mask: 0x%llx, sched_policy: %d, sched_priority: %d, "
+			   "stack_size: %zu\n",
+			   p_key, (unsigned long long)props.cpu_mask, props.sched_policy,
+			   props.sched_priority, props.stack_size);
+
+	hub_thread_set_props(thread_class, &props);
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Set up a bus, from host_config.json or from the config cache, for use:
+ * assign invalid (-1) value to the bus_hdl variable, negate/falsify the
+ * is_open variable, and update the function pointers for open, write, read,
+ * close per the bus type.
+ *
+ * @param: p_bus is the bus
+ *
+ * @return: hub_ret_code
+ *		HUB_SUCCESS on success
+ *		HUB_FAILURE_PARSE_JSON for an unknown bus type
+ */
+static enum hub_ret_code hub_setup_bus_ops(struct hub_gard_bus *p_bus)
+{
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		p_bus->i2c.bus_hdl        = -1;
+		p_bus->i2c.is_open        = false;
+		p_bus->fops.device_open   = hub_i2c_device_open;
+		p_bus->fops.device_read   = hub_i2c_device_read;
+		p_bus->fops.device_write  = hub_i2c_device_write;
+		p_bus->fops.device_readv  = hub_i2c_device_readv;
+		p_bus->fops.device_writev = hub_i2c_device_writev;
+		p_bus->fops.device_close  = hub_i2c_device_close;
+		break;
+	case HUB_GARD_BUS_UART:
+		p_bus->uart.bus_hdl       = -1;
+		p_bus->uart.is_open       = false;
+		p_bus->uart.is_probing    = false;
+		p_bus->fops.device_open   = hub_uart_device_open;
+		p_bus->fops.device_read   = hub_uart_device_read;
+		p_bus->fops.device_write  = hub_uart_device_write;
+		p_bus->fops.device_readv  = hub_uart_device_readv;
+		p_bus->fops.device_writev = hub_uart_device_writev;
+		p_bus->fops.device_close  = hub_uart_device_close;
+		break;
+	case HUB_GARD_BUS_USB:
+		p_bus->usb.bus_hdl        = -1;
+		p_bus->usb.is_open        = false;
+		p_bus->fops.device_open   = hub_usb_device_open;
+		p_bus->fops.device_read   = hub_usb_device_read;
+		p_bus->fops.device_write  = hub_usb_device_write;
+		p_bus->fops.device_readv  = NULL;
+		p_bus->fops.device_writev = NULL;
+		p_bus->fops.device_close  = hub_usb_device_close;
+		break;
+	default:
+		hub_pr_err("Unknown bus\n");
+		return HUB_FAILURE_PARSE_JSON;
+	}
+
+	return HUB_SUCCESS;
+}
+
 /**
  * HUB INIT internal function
  *
@@ -126,16 +382,20 @@ static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 	 * This information is read into a bus_props variable, which
 	 * will be later attached to the HUB context.
 	 */
-	bus_props = (struct hub_gard_bus *)calloc(HUB_GARD_NR_BUSSES,
-											  sizeof(struct hub_gard_bus));
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json, "busses");
+	num_busses = cJSON_GetArraySize(p_json_obj);
+
+	/**
+	 * One entry per bus listed: several busses of the same type (e.g. one
+	 * USB bus per GARD board) can be present.
+	 */
+	bus_props  = (struct hub_gard_bus *)calloc(hub_max_int32(num_busses, 1),
+											   sizeof(struct hub_gard_bus));
 	if (NULL == bus_props) {
 		hub_pr_err("Error allocating memory for bus props\n");
 		goto parse_err_3;
 	}
 
-	p_json_obj        = cJSON_GetObjectItemCaseSensitive(p_host_json, "busses");
-	num_busses        = cJSON_GetArraySize(p_json_obj);
-
 	/* We found these many number of busses in the host_config.json file */
 	p_hub->num_busses = num_busses;
 
@@ -163,20 +423,89 @@ static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 			}
 		}
 
+		/* Optional: which GARD the bus is wired to, when there are several */
+		p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "gard_index");
+		bus_props[i].gard_index =
+			cJSON_IsNumber(p_bus_field) ? p_bus_field->valueint : 0;
+
+		/**
+		 * Optional: split send / recv data transfers on this bus into
+		 * commands of at most these many bytes, so that register accesses
+		 * and short commands sharing the bus do not wait for the whole
+		 * transfer. 0 or absent sends each transfer as a single command.
+		 */
+		p_bus_field =
+			cJSON_GetObjectItemCaseSensitive(p_bus, "xfer_chunk_size");
+		bus_props[i].xfer_chunk_size =
+			cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)
+				? p_bus_field->valueint
+				: 0;
+
+		/**
+		 * Optional: send data on this bus in packets of at most mtu_size
+		 * bytes, each ACKed by GARD, keeping up to mtu_window packets in
+		 * flight. 0 or absent mtu_size sends the payload in one go.
+		 */
+		p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "mtu_size");
+		bus_props[i].mtu_size =
+			cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)
+				? hub_min_uint32(p_bus_field->valueint, HUB_MTU_SIZE_MAX)
+				: 0;
+
+		p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "mtu_window");
+		bus_props[i].mtu_window =
+			cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)
+				? hub_min_uint32(p_bus_field->valueint, HUB_MTU_WINDOW_MAX)
+				: 1;
+
+		/**
+		 * Optional: protect send / recv data payloads on this bus with a
+		 * CRC-32, which GARD checks (and computes) while the payload is on
+		 * the bus. Packets sent with mtu_size always carry one.
+		 */
+		p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "data_crc");
+		bus_props[i].data_crc = cJSON_IsTrue(p_bus_field);
+
+		/**
+		 * Optional: on a GPIO app data event, receive all App Module results
+		 * queued in GARD in one command rather than one per event. Not for
+		 * USB, whose app data is read as a blob.
+		 */
+		p_bus_field =
+			cJSON_GetObjectItemCaseSensitive(p_bus, "app_data_batch");
+		bus_props[i].app_data_batch =
+			cJSON_IsTrue(p_bus_field) &&
+			(HUB_GARD_BUS_USB != bus_props[i].types);
+
+		/**
+		 * Optional: let register accesses sharing this bus with receive data
+		 * transfers be sent as tagged commands while the data is still
+		 * coming in, see CMD_ID_TAGGED. Not for USB.
+		 */
+		p_bus_field =
+			cJSON_GetObjectItemCaseSensitive(p_bus, "cmd_pipelining");
+		bus_props[i].cmd_pipelining =
+			cJSON_IsTrue(p_bus_field) &&
+			(HUB_GARD_BUS_USB != bus_props[i].types);
+
 		/**
 		 * TBD-DPN: Check for (expected) busses not found in json and for which
 		 * the function pointers would be NULL
 		 *
 		 * Fill in other properties of the current bus_props:
 		 * 1. For I2C, we get bus_num, device_num, and speed
-		 * 2. For UART, we get bus_dev and uart_baudrate
-		 * 3. For USB, we get the vendor and product IDs
-		 *
-		 * Assign invalid (-1) value to the bus_hdl variable, and
-		 * negate/falsify the is_open variable.
+		 * 2. For UART, we get bus_dev, uart_baudrate and the optional
+		 *    uart_flush_policy, uart_hw_flow_control,
+		 *    uart_target_baudrate to step up to after discovery,
+		 *    uart_read_timeout_ms, uart_probe_timeout_ms for discovery
+		 *    and uart_rx_ring_size for the background reader
+		 * 3. For USB, we get the vendor and product IDs, the optional port
+		 *    path and serial number picking one of several identical
+		 *    devices, the optional burst size used for splitting bulk
+		 *    transfers and the optional depth of the asynchronous transfer
+		 *    queue
 		 *
-		 * Also, update the function pointers for open, write, read, close
-		 * for each bus_props per the bus_type found.
+		 * Then hub_setup_bus_ops() sets up the bus handle and functions.
 		 */
 		switch (bus_props[i].types) {
 		case HUB_GARD_BUS_I2C:
@@ -185,15 +514,16 @@ static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 			p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "device_num");
 			bus_props[i].i2c.slave_id = p_bus_field->valueint;
 			p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "i2c_speed");
-			bus_props[i].i2c.speed         = p_bus_field->valueint;
-
-			bus_props[i].i2c.bus_hdl       = -1;
-			bus_props[i].i2c.is_open       = false;
-			bus_props[i].fops.device_open  = hub_i2c_device_open;
-			bus_props[i].fops.device_read  = hub_i2c_device_read;
-			bus_props[i].fops.device_write = hub_i2c_device_write;
-			bus_props[i].fops.device_close = hub_i2c_device_close;
-
+			bus_props[i].i2c.speed = I2C_DEFAULT_SPEED_HZ;
+			if (cJSON_IsNumber(p_bus_field)) {
+				if ((p_bus_field->valueint > 0) &&
+					(p_bus_field->valueint <= I2C_MAX_SPEED_HZ)) {
+					bus_props[i].i2c.speed = p_bus_field->valueint;
+				} else {
+					hub_pr_warn("Invalid i2c_speed %d, using %u\n",
+								p_bus_field->valueint, I2C_DEFAULT_SPEED_HZ);
+				}
+			}
 			break;
 		case HUB_GARD_BUS_UART:
 			p_bus_field = cJSON_GetObjectItemCaseSensitive(p_bus, "bus_dev");
@@ -202,15 +532,38 @@ static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 					 p_bus_field->valuestring);
 			p_bus_field =
 				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_baudrate");
-			bus_props[i].uart.baudrate     = p_bus_field->valueint;
-
-			bus_props[i].uart.bus_hdl      = -1;
-			bus_props[i].uart.is_open      = false;
-			bus_props[i].fops.device_open  = hub_uart_device_open;
-			bus_props[i].fops.device_read  = hub_uart_device_read;
-			bus_props[i].fops.device_write = hub_uart_device_write;
-			bus_props[i].fops.device_close = hub_uart_device_close;
-
+			bus_props[i].uart.baudrate = p_bus_field->valueint;
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_flush_policy");
+			bus_props[i].uart.flush_policy =
+				hub_parse_uart_flush_policy(p_bus_field);
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_hw_flow_control");
+			bus_props[i].uart.hw_flow_control = cJSON_IsTrue(p_bus_field);
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_target_baudrate");
+			bus_props[i].uart.target_baudrate = 0;
+			if (cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)) {
+				bus_props[i].uart.target_baudrate = p_bus_field->valueint;
+			}
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_read_timeout_ms");
+			bus_props[i].uart.read_timeout_ms = HUB_GARD_UART_READ_TIMEOUT_MS;
+			if (cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)) {
+				bus_props[i].uart.read_timeout_ms = p_bus_field->valueint;
+			}
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_probe_timeout_ms");
+			bus_props[i].uart.probe_timeout_ms = HUB_GARD_UART_PROBE_TIMEOUT_MS;
+			if (cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)) {
+				bus_props[i].uart.probe_timeout_ms = p_bus_field->valueint;
+			}
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "uart_rx_ring_size");
+			bus_props[i].uart.rx_ring_size = 0;
+			if (cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)) {
+				bus_props[i].uart.rx_ring_size = p_bus_field->valueint;
+			}
 			break;
 		case HUB_GARD_BUS_USB:
 			p_bus_field =
@@ -221,21 +574,100 @@ static enum hub_ret_code hub_parse_host_config(char *p_host_config_file,
 				cJSON_GetObjectItemCaseSensitive(p_bus, "usb_product_id");
 			bus_props[i].usb.product_id =
 				(uint32_t)strtol(p_bus_field->valuestring, NULL, 0);
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "usb_port_path");
+			if (cJSON_IsString(p_bus_field)) {
+				snprintf(bus_props[i].usb.port_path,
+						 sizeof(bus_props[i].usb.port_path), "%s",
+						 p_bus_field->valuestring);
+			}
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "usb_serial_number");
+			if (cJSON_IsString(p_bus_field)) {
+				snprintf(bus_props[i].usb.serial_number,
+						 sizeof(bus_props[i].usb.serial_number), "%s",
+						 p_bus_field->valuestring);
+			}
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "usb_burst_size");
+			bus_props[i].usb.burst_size = HUB_USB_DEFAULT_BURST_SZ;
+			if (cJSON_IsNumber(p_bus_field)) {
+				if ((p_bus_field->valueint > 0) &&
+					(0 == (p_bus_field->valueint % HUB_USB_BURST_ALIGN))) {
+					bus_props[i].usb.burst_size = p_bus_field->valueint;
+				} else {
+					hub_pr_warn("Invalid usb_burst_size %d, using %u\n",
+								p_bus_field->valueint,
+								HUB_USB_DEFAULT_BURST_SZ);
+				}
+			}
 
-			bus_props[i].usb.bus_hdl       = -1;
-			bus_props[i].usb.is_open       = false;
-			bus_props[i].fops.device_open  = hub_usb_device_open;
-			bus_props[i].fops.device_read  = hub_usb_device_read;
-			bus_props[i].fops.device_write = hub_usb_device_write;
-			bus_props[i].fops.device_close = hub_usb_device_close;
-
+			p_bus_field =
+				cJSON_GetObjectItemCaseSensitive(p_bus, "usb_async_depth");
+			bus_props[i].usb.async_depth = HUB_USB_ASYNC_DEFAULT_DEPTH;
+			if (cJSON_IsNumber(p_bus_field) && (p_bus_field->valueint > 0)) {
+				bus_props[i].usb.async_depth = p_bus_field->valueint;
+			}
 			break;
 		default:
-			hub_pr_err("Unknown bus\n");
+			break;
+		}
+
+		if (HUB_SUCCESS != hub_setup_bus_ops(&bus_props[i])) {
 			goto parse_err_3;
 		}
 	}
 
+	/* Optional GPIO execution model, see hub_init_with_options() */
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json,
+												  "gpio_exec_model");
+	p_hub->gpio_exec_model = hub_parse_gpio_exec_model(p_json_obj);
+
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json,
+												  "gpio_pool_size");
+	p_hub->gpio_pool_size = HUB_GPIO_POOL_DEFAULT_SIZE;
+	if (cJSON_IsNumber(p_json_obj)) {
+		if ((p_json_obj->valueint > 0) &&
+			(p_json_obj->valueint <= HUB_GPIO_POOL_MAX_SIZE)) {
+			p_hub->gpio_pool_size = p_json_obj->valueint;
+		} else {
+			hub_pr_warn("Invalid gpio_pool_size %d, using %d\n",
+						p_json_obj->valueint, HUB_GPIO_POOL_DEFAULT_SIZE);
+		}
+	}
+
+	hub_pr_dbg("gpio_exec_model: %d, gpio_pool_size: %u\n",
+			   p_hub->gpio_exec_model, p_hub->gpio_pool_size);
+
+	/* Optional GARD health probe period, see hub_set_gard_event_cb() */
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json,
+												  "health_probe_ms");
+	p_hub->health_probe_ms = 0;
+	if (cJSON_IsNumber(p_json_obj) && (p_json_obj->valueint > 0)) {
+		p_hub->health_probe_ms = p_json_obj->valueint;
+	}
+
+	/* Optional GARD clock sync period, see hub_gard_ms_to_host_ns() */
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json,
+												  "clock_sync_ms");
+	p_hub->clock_sync_ms = 0;
+	if (cJSON_IsNumber(p_json_obj) && (p_json_obj->valueint > 0)) {
+		p_hub->clock_sync_ms = p_json_obj->valueint;
+	}
+
+	/* Optional level of the HUB log, applied by hub_preinit() */
+	p_json_obj       = cJSON_GetObjectItemCaseSensitive(p_host_json, "log_level");
+	p_hub->log_level = hub_parse_log_level(p_json_obj);
+
+	/* Optional scheduling properties of HUB threads, per thread class */
+	p_json_obj = cJSON_GetObjectItemCaseSensitive(p_host_json, "thread_props");
+	hub_parse_thread_props(p_json_obj, "gpio_monitor",
+						   HUB_THREAD_CLASS_GPIO_MON);
+	hub_parse_thread_props(p_json_obj, "gpio_worker",
+						   HUB_THREAD_CLASS_GPIO_WORKER);
+	hub_parse_thread_props(p_json_obj, "bus_io", HUB_THREAD_CLASS_BUS_IO);
+	hub_parse_thread_props(p_json_obj, "client", HUB_THREAD_CLASS_CLIENT);
+
 	/* Free up the cJSON parsing variable created during the parse operation */
 	cJSON_Delete(p_host_json);
 	/* Free up the file buffer variable malloc'd */
@@ -254,6 +686,286 @@ parse_err_1:
 	return HUB_FAILURE_PARSE_JSON;
 }
 
+/**
+ * HUB INIT internal function
+ *
+ * Fill up HUB bus structures from the config cache when it matches the host
+ * config file, else from the host config file, which then goes to the
+ * cache.
+ *
+ * @param: p_host_config_file is the full path to the host config file
+ * @param: p_hub is the hub_ctx, with p_config_cache NULL if there is none
+ *
+ * @return: hub_ret_code
+ *		HUB_SUCCESS on success
+ *		HUB_FAILURE_PARSE_JSON on failure
+ */
+static enum hub_ret_code hub_load_host_config(char *p_host_config_file,
+											  struct hub_ctx *p_hub)
+{
+	enum hub_ret_code        ret;
+	uint32_t                 i;
+	struct hub_config_cache *p_cache = p_hub->p_config_cache;
+
+	if ((NULL != p_cache) &&
+		(HUB_SUCCESS == hub_config_cache_get_host(p_cache, p_hub))) {
+		for (i = 0; i < p_hub->num_busses; i++) {
+			if (HUB_SUCCESS != hub_setup_bus_ops(&p_hub->p_bus_props[i])) {
+				break;
+			}
+		}
+		if (i == p_hub->num_busses) {
+			hub_pr_dbg("Host config taken from %s\n", p_cache->path);
+			return HUB_SUCCESS;
+		}
+
+		free(p_hub->p_bus_props);
+		p_hub->p_bus_props = NULL;
+	}
+
+	ret = hub_parse_host_config(p_host_config_file, p_hub);
+	if (HUB_SUCCESS != ret) {
+		return ret;
+	}
+
+	if (NULL != p_cache) {
+		hub_config_cache_put_host(p_cache, p_hub);
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Record a changed field of the host config that hub_reload_config() does
+ * not apply.
+ *
+ * @param: p_report is the reload report
+ * @param: bus_index is the index of the bus of the field, -1 if top-level
+ * @param: p_field is the name of the field, NULL for the whole bus
+ */
+static void hub_reload_needs_restart(struct hub_reload_report *p_report,
+									 int32_t                   bus_index,
+									 const char               *p_field)
+{
+	char   name[64];
+	size_t len;
+
+	if (bus_index < 0) {
+		snprintf(name, sizeof(name), "%s", p_field);
+	} else if (NULL == p_field) {
+		snprintf(name, sizeof(name), "busses[%d]", bus_index);
+	} else {
+		snprintf(name, sizeof(name), "busses[%d].%s", bus_index, p_field);
+	}
+
+	hub_pr_warn("%s changed, kept until the HUB is restarted\n", name);
+
+	p_report->num_restart++;
+	len = strlen(p_report->restart_fields);
+	if (len < sizeof(p_report->restart_fields)) {
+		snprintf(p_report->restart_fields + len,
+				 sizeof(p_report->restart_fields) - len, "%s%s",
+				 len ? ", " : "", name);
+	}
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Check that a reloaded bus is the running one, on the same device.
+ *
+ * @return: true if it is, false if it needs a restart
+ */
+static bool hub_reload_is_same_bus(const struct hub_gard_bus *p_bus,
+								   const struct hub_gard_bus *p_new)
+{
+	if ((p_bus->types != p_new->types) ||
+		(p_bus->gard_index != p_new->gard_index)) {
+		return false;
+	}
+
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		return (p_bus->i2c.num == p_new->i2c.num) &&
+			   (p_bus->i2c.slave_id == p_new->i2c.slave_id);
+	case HUB_GARD_BUS_UART:
+		return 0 == strcmp(p_bus->uart.bus_dev, p_new->uart.bus_dev);
+	case HUB_GARD_BUS_USB:
+		return (p_bus->usb.vendor_id == p_new->usb.vendor_id) &&
+			   (p_bus->usb.product_id == p_new->usb.product_id) &&
+			   (0 == strcmp(p_bus->usb.port_path, p_new->usb.port_path)) &&
+			   (0 == strcmp(p_bus->usb.serial_number,
+							p_new->usb.serial_number));
+	default:
+		return false;
+	}
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Apply the changed fields of a reloaded bus that can be changed while it
+ * is in use, under the bus lock once discovered, and report the others.
+ * Fields GARD has to support are limited as by hub_init(), so that a field
+ * limited there does not show up as changed.
+ *
+ * @param: p_bus is the running bus
+ * @param: p_new is the bus as reloaded
+ * @param: bus_index is the index of the bus in host_config.json
+ * @param: is_discovered is true once the bus lock is set up
+ * @param: p_report is the reload report
+ */
+static void hub_reload_bus(struct hub_gard_bus       *p_bus,
+						   const struct hub_gard_bus *p_new,
+						   int32_t                    bus_index,
+						   bool                       is_discovered,
+						   struct hub_reload_report  *p_report)
+{
+	uint32_t mtu_size       = p_new->mtu_size;
+	bool     data_crc       = p_new->data_crc;
+	bool     recv_segments  = p_bus->recv_segments;
+	uint32_t num_applied    = 0;
+
+	if (p_bus->identity.is_valid) {
+		mtu_size = hub_min_uint32(mtu_size, p_bus->identity.max_mtu_size);
+		data_crc = data_crc &&
+				   (p_bus->identity.capabilities & GARD_CAP_DATA_CRC);
+		recv_segments =
+			p_new->cmd_pipelining &&
+			(p_bus->identity.capabilities & GARD_CAP_SEGMENTED_RECV);
+	}
+
+	if (is_discovered) {
+		hub_bus_lock_ctrl(p_bus);
+	}
+
+	num_applied += (p_bus->xfer_chunk_size != p_new->xfer_chunk_size);
+	num_applied += (p_bus->mtu_size != mtu_size);
+	num_applied += (p_bus->mtu_window != p_new->mtu_window);
+	num_applied += (p_bus->data_crc != data_crc);
+	num_applied += (p_bus->app_data_batch != p_new->app_data_batch);
+	num_applied += (p_bus->cmd_pipelining != p_new->cmd_pipelining);
+
+	p_bus->xfer_chunk_size = p_new->xfer_chunk_size;
+	p_bus->mtu_size        = mtu_size;
+	p_bus->mtu_window      = p_new->mtu_window;
+	p_bus->data_crc        = data_crc;
+	p_bus->app_data_batch  = p_new->app_data_batch;
+	p_bus->cmd_pipelining  = p_new->cmd_pipelining;
+	p_bus->recv_segments   = recv_segments;
+
+	/* The UART driver reads these from the bus at each transfer */
+	if (HUB_GARD_BUS_UART == p_bus->types) {
+		num_applied +=
+			(p_bus->uart.flush_policy != p_new->uart.flush_policy);
+		num_applied +=
+			(p_bus->uart.read_timeout_ms != p_new->uart.read_timeout_ms);
+		num_applied +=
+			(p_bus->uart.probe_timeout_ms != p_new->uart.probe_timeout_ms);
+
+		p_bus->uart.flush_policy     = p_new->uart.flush_policy;
+		p_bus->uart.read_timeout_ms  = p_new->uart.read_timeout_ms;
+		p_bus->uart.probe_timeout_ms = p_new->uart.probe_timeout_ms;
+	}
+
+	if (is_discovered) {
+		hub_bus_unlock_ctrl(p_bus);
+	}
+
+	p_report->num_applied += num_applied;
+
+	switch (p_bus->types) {
+	case HUB_GARD_BUS_I2C:
+		if (p_bus->i2c.speed != p_new->i2c.speed) {
+			hub_reload_needs_restart(p_report, bus_index, "i2c_speed");
+		}
+		break;
+	case HUB_GARD_BUS_UART:
+		/* Once stepped up, baudrate is the current rate, not the one set */
+		if ((p_bus->uart.base_baudrate ? p_bus->uart.base_baudrate
+									   : p_bus->uart.baudrate) !=
+			p_new->uart.baudrate) {
+			hub_reload_needs_restart(p_report, bus_index, "uart_baudrate");
+		}
+		if (p_bus->uart.hw_flow_control != p_new->uart.hw_flow_control) {
+			hub_reload_needs_restart(p_report, bus_index,
+									 "uart_hw_flow_control");
+		}
+		if (p_bus->uart.rx_ring_size != p_new->uart.rx_ring_size) {
+			hub_reload_needs_restart(p_report, bus_index,
+									 "uart_rx_ring_size");
+		}
+		break;
+	case HUB_GARD_BUS_USB:
+		if (p_bus->usb.burst_size != p_new->usb.burst_size) {
+			hub_reload_needs_restart(p_report, bus_index, "usb_burst_size");
+		}
+		if (p_bus->usb.async_depth != p_new->usb.async_depth) {
+			hub_reload_needs_restart(p_report, bus_index, "usb_async_depth");
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * HUB INIT internal function
+ *
+ * Switch a running UART bus to the rate of its reloaded
+ * uart_target_baudrate, or back to uart_baudrate if it has none, with the
+ * coordinated switch of hub_step_up_uart_baudrate().
+ *
+ * @param: p_bus is the running bus
+ * @param: target_baudrate is the reloaded uart_target_baudrate, 0 if none
+ * @param: is_discovered is true once GARD was discovered on the bus
+ * @param: p_report is the reload report
+ *
+ * @return: hub_ret_code
+ *		HUB_SUCCESS on success, or if GARD NAKed the rate
+ *		HUB_FAILURE_GARD_DISCOVER if GARD is lost at the new rate
+ */
+static enum hub_ret_code
+	hub_reload_uart_baudrate(struct hub_gard_bus      *p_bus,
+							 uint32_t                  target_baudrate,
+							 bool                      is_discovered,
+							 struct hub_reload_report *p_report)
+{
+	enum hub_ret_code ret = HUB_SUCCESS;
+	uint32_t          baudrate;
+
+	if (p_bus->uart.target_baudrate == target_baudrate) {
+		return HUB_SUCCESS;
+	}
+
+	p_report->num_applied++;
+
+	/* Not open yet: discovery steps up to it */
+	if (!is_discovered || !p_bus->uart.is_open) {
+		p_bus->uart.target_baudrate = target_baudrate;
+		return HUB_SUCCESS;
+	}
+
+	baudrate = target_baudrate;
+	if (0 == baudrate) {
+		baudrate = p_bus->uart.base_baudrate ? p_bus->uart.base_baudrate
+											 : p_bus->uart.baudrate;
+	}
+
+	p_bus->uart.target_baudrate = baudrate;
+	ret                         = hub_step_up_uart_baudrate(p_bus);
+	p_bus->uart.target_baudrate = target_baudrate;
+
+	if (HUB_SUCCESS == ret) {
+		hub_pr_info("%s at %u baud\n", p_bus->uart.bus_dev,
+					p_bus->uart.baudrate);
+	}
+
+	return ret;
+}
+
 /******************************************************************************
 	HUB publicly exposed APIs
  ******************************************************************************/
@@ -305,11 +1017,18 @@ enum hub_ret_code
 		goto hub_preinit_err_1;
 	}
 
-	ret = hub_parse_host_config(p_host_config_file, p_hub);
+	/* Without a cache (out of memory), the jsons are parsed every time */
+	p_hub->p_config_cache = hub_config_cache_load(p_host_config_file);
+
+	ret = hub_load_host_config(p_host_config_file, p_hub);
 	if (HUB_SUCCESS != ret) {
 		goto hub_preinit_err_2;
 	}
 
+	if (p_hub->log_level >= 0) {
+		hub_log_set_level((enum hub_log_level)p_hub->log_level);
+	}
+
 	p_hub->hub_state = HUB_PREINIT_DONE;
 	*hub             = p_hub;
 
@@ -328,11 +1047,131 @@ enum hub_ret_code
 	return HUB_SUCCESS;
 
 hub_preinit_err_2:
+	hub_config_cache_free(p_hub->p_config_cache);
 	free(p_hub);
 hub_preinit_err_1:
 	return HUB_FAILURE_PREINIT;
 }
 
+/**
+ * Reload the host config of a HUB, applying what can change without a
+ * restart, see hub.h.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_config is the path to the host config file
+ * @param: p_report is filled with the outcome, may be NULL
+ *
+ * @return: hub_ret_code
+ *		HUB_SUCCESS on success
+ *		HUB_FAILURE_RELOAD_CONFIG on failure
+ */
+enum hub_ret_code hub_reload_config(hub_handle_t              hub,
+									const char               *p_config,
+									struct hub_reload_report *p_report)
+{
+	struct hub_ctx          *p_hub = (struct hub_ctx *)hub;
+	struct hub_ctx           new_cfg;
+	struct hub_reload_report report;
+	struct hub_thread_props  old_props[HUB_THREAD_CLASS_MAX];
+	struct hub_thread_props  new_props;
+	enum hub_ret_code        ret = HUB_SUCCESS;
+	bool                     is_discovered;
+	uint32_t                 i;
+
+	if ((NULL == p_hub) || (p_hub->hub_state < HUB_PREINIT_DONE) ||
+		(NULL == p_config)) {
+		hub_pr_err("Invalid HUB handle or config passed in\n");
+		return HUB_FAILURE_RELOAD_CONFIG;
+	}
+
+	memset(&report, 0, sizeof(report));
+	memset(&new_cfg, 0, sizeof(new_cfg));
+	is_discovered = (p_hub->hub_state >= HUB_DISCOVER_DONE);
+
+	/* Parsing sets the thread properties, for threads created from now on */
+	for (i = 0; i < HUB_THREAD_CLASS_MAX; i++) {
+		hub_thread_get_props((enum hub_thread_class)i, &old_props[i]);
+	}
+
+	if (HUB_SUCCESS != hub_parse_host_config((char *)p_config, &new_cfg)) {
+		hub_pr_err("Failed to parse %s, nothing reloaded\n", p_config);
+		return HUB_FAILURE_RELOAD_CONFIG;
+	}
+
+	if (new_cfg.num_busses != p_hub->num_busses) {
+		hub_reload_needs_restart(&report, -1, "busses");
+	}
+
+	for (i = 0; i < hub_min_uint32(new_cfg.num_busses, p_hub->num_busses);
+		 i++) {
+		struct hub_gard_bus *p_bus = &p_hub->p_bus_props[i];
+		struct hub_gard_bus *p_new = &new_cfg.p_bus_props[i];
+
+		if (!hub_reload_is_same_bus(p_bus, p_new)) {
+			hub_reload_needs_restart(&report, (int32_t)i, NULL);
+			continue;
+		}
+
+		hub_reload_bus(p_bus, p_new, (int32_t)i, is_discovered, &report);
+
+		if ((HUB_GARD_BUS_UART == p_bus->types) &&
+			(HUB_SUCCESS !=
+			 hub_reload_uart_baudrate(p_bus, p_new->uart.target_baudrate,
+									  is_discovered, &report))) {
+			hub_pr_err("GARD lost switching %s to %u baud\n",
+					   p_bus->uart.bus_dev, p_new->uart.target_baudrate);
+			ret = HUB_FAILURE_RELOAD_CONFIG;
+		}
+	}
+
+	if (new_cfg.gpio_exec_model != p_hub->gpio_exec_model) {
+		hub_reload_needs_restart(&report, -1, "gpio_exec_model");
+	}
+	if (new_cfg.gpio_pool_size != p_hub->gpio_pool_size) {
+		hub_reload_needs_restart(&report, -1, "gpio_pool_size");
+	}
+
+	/* Read by the health monitor at each tick */
+	if (new_cfg.health_probe_ms != p_hub->health_probe_ms) {
+		__atomic_store_n(&p_hub->health_probe_ms, new_cfg.health_probe_ms,
+						 __ATOMIC_RELAXED);
+		report.num_applied++;
+	}
+	if (new_cfg.clock_sync_ms != p_hub->clock_sync_ms) {
+		__atomic_store_n(&p_hub->clock_sync_ms, new_cfg.clock_sync_ms,
+						 __ATOMIC_RELAXED);
+		report.num_applied++;
+	}
+
+	if (new_cfg.log_level != p_hub->log_level) {
+		p_hub->log_level = new_cfg.log_level;
+		if (p_hub->log_level >= 0) {
+			hub_log_set_level((enum hub_log_level)p_hub->log_level);
+		}
+		report.num_applied++;
+	}
+
+	for (i = 0; i < HUB_THREAD_CLASS_MAX; i++) {
+		hub_thread_get_props((enum hub_thread_class)i, &new_props);
+		if (0 == memcmp(&new_props, &old_props[i], sizeof(new_props))) {
+			continue;
+		}
+		(void)hub_thread_reapply_props((enum hub_thread_class)i);
+		report.num_applied++;
+	}
+
+	free(new_cfg.p_bus_props);
+
+	hub_pr_info("Reloaded %s: %u field(s) applied, %u need a restart\n",
+				p_config, report.num_applied, report.num_restart);
+
+	if (NULL != p_report) {
+		*p_report = report;
+	}
+
+	return ret;
+}
+
 /**
  * Get a string containing the current version of HUB.
  * This string is a global variable defined in hub_globals.c.
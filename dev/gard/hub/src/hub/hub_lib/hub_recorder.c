@@ -0,0 +1,863 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * App data recording.
+ *
+ * The writer appends each result of a GARD to the current segment of its
+ * recording with one writev() of the record header and the callback buffer,
+ * under the mutex of the recorder. A segment is only ever appended to: its
+ * time index is kept in memory and written after its last record when the
+ * segment is closed, at the segment size or when the recording stops.
+ *
+ * The recorder of a GARD is allocated by its first recording and kept until
+ * hub_fini(), so that a recording is stopped while results are delivered
+ * without freeing what the delivering thread holds: a stopped recorder has
+ * no file and drops the results.
+ *
+ * The reader maps each segment read-only and reads the records in place.
+ * Seeking is a binary search of the segments by their last timestamp, then
+ * of the index of the segment, then a walk of at most one index interval.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hub_recorder.h"
+#include "hub_stats.h"
+#include "hub_threading.h"
+#include "hub_utils.h"
+
+/* Segment files are <path>.NNNN */
+#define HUB_RECORDING_SEGMENT_SUFFIX_LEN (8U)
+
+/* Index entries allocated at once */
+#define HUB_RECORDING_INDEX_CHUNK (256U)
+
+/* Writer of the recording of a GARD */
+struct hub_recorder {
+	hub_mutex_t                       mutex;
+	char                             *p_path;
+	int                               fd; /* -1 while not recording */
+	bool                              failed;
+	uint32_t                          gard_index;
+	uint32_t                          segment_size;
+	uint32_t                          segment;
+	uint64_t                          start_ns;
+	uint64_t                          start_realtime_ns;
+	uint64_t                          seq;
+	uint64_t                          offset; /* End of the segment */
+	uint64_t                          next_index_ns;
+	uint64_t                          last_ns;
+	uint32_t                          num_records;
+	uint32_t                          num_entries;
+	uint32_t                          index_capacity;
+	struct hub_recording_index_entry *p_index;
+};
+
+/* A segment of a recording open for reading */
+struct hub_recording_segment {
+	const uint8_t                    *p_map;
+	size_t                            map_size;
+	uint64_t                          end; /* End of the last whole record */
+	uint64_t                          first_ns;
+	uint64_t                          last_ns;
+	uint32_t                          num_records;
+	uint32_t                          num_entries;
+	struct hub_recording_index_entry *p_index;
+};
+
+/* Back-end of a hub_recording_t */
+struct hub_recording_ctx {
+	struct hub_recording_segment *p_segments;
+	uint32_t                      segment; /* Segment of the next record */
+	uint64_t                      offset;  /* Offset of the next record */
+	struct hub_recording_info     info;
+};
+
+static uint64_t hub_recorder_realtime_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * CRC-32 of a record: its header after the crc field, then its data.
+ */
+static uint32_t hub_recorder_record_crc(const struct hub_recording_record *p_rec,
+										const void                        *p_data)
+{
+	uint32_t crc;
+
+	crc = hub_crc32(0, &p_rec->size,
+					sizeof(*p_rec) - offsetof(struct hub_recording_record, size));
+	return hub_crc32(crc, p_data, p_rec->size);
+}
+
+/**
+ * CRC-32 of a footer: the index, then the footer up to its crc field.
+ */
+static uint32_t
+	hub_recorder_footer_crc(const struct hub_recording_footer      *p_footer,
+							const struct hub_recording_index_entry *p_index)
+{
+	uint32_t crc;
+
+	crc = hub_crc32(0, p_index, p_footer->num_entries * sizeof(*p_index));
+	return hub_crc32(crc, p_footer,
+					 offsetof(struct hub_recording_footer, crc));
+}
+
+/**
+ * Add an index entry for the record at offset, if one is due. An entry that
+ * cannot be allocated is left out: the index is then sparser, not wrong.
+ */
+static void hub_recorder_index(struct hub_recorder *p_rec,
+							   uint64_t             timestamp_ns,
+							   uint64_t             offset)
+{
+	struct hub_recording_index_entry *p_index;
+
+	if (timestamp_ns < p_rec->next_index_ns) {
+		return;
+	}
+
+	if (p_rec->num_entries == p_rec->index_capacity) {
+		p_index = realloc(p_rec->p_index,
+						  (p_rec->index_capacity + HUB_RECORDING_INDEX_CHUNK) *
+							  sizeof(*p_index));
+		if (NULL == p_index) {
+			return;
+		}
+		p_rec->p_index         = p_index;
+		p_rec->index_capacity += HUB_RECORDING_INDEX_CHUNK;
+	}
+
+	p_rec->p_index[p_rec->num_entries].timestamp_ns = timestamp_ns;
+	p_rec->p_index[p_rec->num_entries].offset       = offset;
+	p_rec->num_entries++;
+	p_rec->next_index_ns = timestamp_ns + HUB_RECORDING_INDEX_INTERVAL_NS;
+}
+
+/**
+ * Create segment p_rec->segment and write its header. Called with the mutex
+ * held.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_recorder_open_segment(struct hub_recorder *p_rec)
+{
+	struct hub_recording_header header;
+	char                       *p_name;
+	size_t                      name_size;
+
+	name_size = strlen(p_rec->p_path) + HUB_RECORDING_SEGMENT_SUFFIX_LEN;
+	p_name    = malloc(name_size);
+	if (NULL == p_name) {
+		return -1;
+	}
+	snprintf(p_name, name_size, "%s.%04u", p_rec->p_path, p_rec->segment);
+
+	p_rec->fd = open(p_name, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+					 0644);
+	if (p_rec->fd < 0) {
+		hub_pr_err("Failed to open %s: %s\n", p_name, strerror(errno));
+		goto err_hub_recorder_open_segment_1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic             = HUB_RECORDING_MAGIC;
+	header.version           = HUB_RECORDING_VERSION;
+	header.header_size       = sizeof(header);
+	header.gard_index        = p_rec->gard_index;
+	header.segment           = p_rec->segment;
+	header.start_ns          = p_rec->start_ns;
+	header.start_realtime_ns = p_rec->start_realtime_ns;
+	header.index_interval_ns = HUB_RECORDING_INDEX_INTERVAL_NS;
+	if (write(p_rec->fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+		hub_pr_err("Failed to write %s: %s\n", p_name, strerror(errno));
+		goto err_hub_recorder_open_segment_2;
+	}
+
+	p_rec->offset        = sizeof(header);
+	p_rec->next_index_ns = 0;
+	p_rec->last_ns       = 0;
+	p_rec->num_records   = 0;
+	p_rec->num_entries   = 0;
+	free(p_name);
+
+	return 0;
+
+err_hub_recorder_open_segment_2:
+	close(p_rec->fd);
+	p_rec->fd = -1;
+err_hub_recorder_open_segment_1:
+	free(p_name);
+	return -1;
+}
+
+/**
+ * Remove the segments of an earlier recording to the same path, so that
+ * none of them is taken as a segment of the new one. They are removed in
+ * order up to the first one missing.
+ *
+ * @return: 0 on success, -1 if a segment could not be removed
+ */
+static int hub_recorder_remove_segments(const char *p_path)
+{
+	char    *p_name;
+	size_t   name_size;
+	uint32_t n;
+	int      ret = 0;
+
+	name_size = strlen(p_path) + HUB_RECORDING_SEGMENT_SUFFIX_LEN;
+	p_name    = malloc(name_size);
+	if (NULL == p_name) {
+		return -1;
+	}
+	for (n = 0;; n++) {
+		snprintf(p_name, name_size, "%s.%04u", p_path, n);
+		if (0 != unlink(p_name)) {
+			if (ENOENT != errno) {
+				hub_pr_err("Failed to remove %s: %s\n", p_name,
+						   strerror(errno));
+				ret = -1;
+			}
+			break;
+		}
+	}
+	free(p_name);
+
+	return ret;
+}
+
+/**
+ * Write the index and footer of the current segment and close it. Called
+ * with the mutex held.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_recorder_close_segment(struct hub_recorder *p_rec)
+{
+	struct hub_recording_footer footer;
+	struct iovec                iov[2];
+	ssize_t                     len;
+	int                         ret = 0;
+
+	memset(&footer, 0, sizeof(footer));
+	footer.index_offset = p_rec->offset;
+	footer.last_ns      = p_rec->last_ns;
+	footer.num_entries  = p_rec->num_entries;
+	footer.num_records  = p_rec->num_records;
+	footer.crc          = hub_recorder_footer_crc(&footer, p_rec->p_index);
+	footer.magic        = HUB_RECORDING_FOOTER_MAGIC;
+
+	iov[0].iov_base = p_rec->p_index;
+	iov[0].iov_len  = p_rec->num_entries * sizeof(*p_rec->p_index);
+	iov[1].iov_base = &footer;
+	iov[1].iov_len  = sizeof(footer);
+	len = writev(p_rec->fd, iov, 2);
+	if ((len < 0) || ((size_t)len != iov[0].iov_len + iov[1].iov_len)) {
+		hub_pr_err("Failed to write the index of segment %u of %s: %s\n",
+				   p_rec->segment, p_rec->p_path, strerror(errno));
+		ret = -1;
+	}
+	if (0 != close(p_rec->fd)) {
+		ret = -1;
+	}
+	p_rec->fd = -1;
+
+	return ret;
+}
+
+/**
+ * hub_recorder_write_appdata appends one app data result to the recording
+ * of a GARD, see hub_recorder.h.
+ */
+void hub_recorder_write_appdata(struct hub_gard_info *p_gard,
+								const void           *p_data,
+								uint32_t              size)
+{
+	struct hub_recorder        *p_rec;
+	struct hub_recording_record rec;
+	struct iovec                iov[2];
+	uint64_t                    now_ns;
+	ssize_t                     len;
+
+	p_rec = __atomic_load_n(&p_gard->p_recorder, __ATOMIC_ACQUIRE);
+	if (NULL == p_rec) {
+		return;
+	}
+	now_ns = hub_stats_now_ns();
+
+	hub_mutex_lock(&p_rec->mutex);
+	if (p_rec->fd < 0) {
+		goto hub_recorder_write_appdata_done;
+	}
+
+	if (p_rec->num_records &&
+		(p_rec->offset + sizeof(rec) + size > p_rec->segment_size)) {
+		if (0 != hub_recorder_close_segment(p_rec)) {
+			goto hub_recorder_write_appdata_err;
+		}
+		p_rec->segment++;
+		if (0 != hub_recorder_open_segment(p_rec)) {
+			goto hub_recorder_write_appdata_err;
+		}
+	}
+
+	rec.size         = size;
+	rec.seq          = ++p_rec->seq;
+	rec.timestamp_ns = now_ns - p_rec->start_ns;
+	rec.crc          = hub_recorder_record_crc(&rec, p_data);
+
+	iov[0].iov_base = &rec;
+	iov[0].iov_len  = sizeof(rec);
+	iov[1].iov_base = (void *)p_data;
+	iov[1].iov_len  = size;
+	len = writev(p_rec->fd, iov, 2);
+	if ((len < 0) || ((size_t)len != sizeof(rec) + size)) {
+		hub_pr_err("Failed to record app data of GARD %u to %s: %s\n",
+				   p_rec->gard_index, p_rec->p_path, strerror(errno));
+		goto hub_recorder_write_appdata_err;
+	}
+
+	hub_recorder_index(p_rec, rec.timestamp_ns, p_rec->offset);
+	p_rec->offset  += (uint64_t)len;
+	p_rec->last_ns  = rec.timestamp_ns;
+	p_rec->num_records++;
+
+hub_recorder_write_appdata_done:
+	hub_mutex_unlock(&p_rec->mutex);
+	return;
+
+hub_recorder_write_appdata_err:
+	/* The recording ends at its last whole record */
+	if (p_rec->fd >= 0) {
+		close(p_rec->fd);
+		p_rec->fd = -1;
+	}
+	p_rec->failed = true;
+	hub_mutex_unlock(&p_rec->mutex);
+}
+
+/**
+ * hub_record_appdata records the app data results of a GARD, see hub.h.
+ */
+enum hub_ret_code hub_record_appdata(gard_handle_t gard,
+									 const char   *p_path,
+									 uint32_t      segment_size)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_recorder  *p_rec, *p_new, *p_expected = NULL;
+	char                 *p_path_copy;
+
+	if ((NULL == p_gard) || (NULL == p_path)) {
+		hub_pr_err("Invalid arguments for hub_record_appdata\n");
+		goto err_hub_record_appdata_1;
+	}
+
+	/* The first recording of the GARD allocates its recorder for good */
+	p_rec = __atomic_load_n(&p_gard->p_recorder, __ATOMIC_ACQUIRE);
+	if (NULL == p_rec) {
+		p_new = calloc(1, sizeof(*p_new));
+		if ((NULL == p_new) || (HUB_SUCCESS != hub_mutex_init(&p_new->mutex))) {
+			free(p_new);
+			goto err_hub_record_appdata_1;
+		}
+		p_new->fd = -1;
+		if (__atomic_compare_exchange_n(&p_gard->p_recorder, &p_expected,
+										p_new, false, __ATOMIC_ACQ_REL,
+										__ATOMIC_ACQUIRE)) {
+			p_rec = p_new;
+		} else {
+			hub_mutex_destroy(&p_new->mutex);
+			free(p_new);
+			p_rec = p_expected;
+		}
+	}
+
+	p_path_copy = strdup(p_path);
+	if (NULL == p_path_copy) {
+		goto err_hub_record_appdata_1;
+	}
+
+	hub_mutex_lock(&p_rec->mutex);
+	if (p_rec->fd >= 0) {
+		hub_pr_err("GARD %u already records to %s\n", p_gard->gard_index,
+				   p_rec->p_path);
+		goto err_hub_record_appdata_2;
+	}
+
+	free(p_rec->p_path);
+	p_rec->p_path            = p_path_copy;
+	p_path_copy              = NULL;
+	p_rec->failed            = false;
+	p_rec->gard_index        = p_gard->gard_index;
+	p_rec->segment_size      = segment_size ? segment_size
+											: HUB_RECORDING_DEFAULT_SEGMENT_SIZE;
+	p_rec->segment           = 0;
+	p_rec->seq               = 0;
+	p_rec->start_ns          = hub_stats_now_ns();
+	p_rec->start_realtime_ns = hub_recorder_realtime_ns();
+	if ((0 != hub_recorder_remove_segments(p_rec->p_path)) ||
+		(0 != hub_recorder_open_segment(p_rec))) {
+		goto err_hub_record_appdata_2;
+	}
+	hub_mutex_unlock(&p_rec->mutex);
+
+	return HUB_SUCCESS;
+
+err_hub_record_appdata_2:
+	hub_mutex_unlock(&p_rec->mutex);
+	free(p_path_copy);
+err_hub_record_appdata_1:
+	return HUB_FAILURE_RECORDING;
+}
+
+/**
+ * hub_stop_recording closes the recording of a GARD, see hub.h.
+ */
+enum hub_ret_code hub_stop_recording(gard_handle_t gard)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_recorder  *p_rec;
+	enum hub_ret_code     ret = HUB_SUCCESS;
+
+	if (NULL == p_gard) {
+		return HUB_FAILURE_RECORDING;
+	}
+	p_rec = __atomic_load_n(&p_gard->p_recorder, __ATOMIC_ACQUIRE);
+	if (NULL == p_rec) {
+		return HUB_SUCCESS;
+	}
+
+	hub_mutex_lock(&p_rec->mutex);
+	if ((p_rec->fd >= 0) && (0 != hub_recorder_close_segment(p_rec))) {
+		p_rec->failed = true;
+	}
+	if (p_rec->failed) {
+		ret           = HUB_FAILURE_RECORDING;
+		p_rec->failed = false;
+	}
+	hub_mutex_unlock(&p_rec->mutex);
+
+	return ret;
+}
+
+/**
+ * hub_recorder_fini stops the recording of a GARD and frees its recorder,
+ * see hub_recorder.h.
+ */
+void hub_recorder_fini(struct hub_gard_info *p_gard)
+{
+	struct hub_recorder *p_rec;
+
+	(void)hub_stop_recording(p_gard);
+
+	p_rec = __atomic_exchange_n(&p_gard->p_recorder, NULL, __ATOMIC_ACQ_REL);
+	if (NULL == p_rec) {
+		return;
+	}
+	hub_mutex_destroy(&p_rec->mutex);
+	free(p_rec->p_index);
+	free(p_rec->p_path);
+	free(p_rec);
+}
+
+/**
+ * Index a segment from its footer, or by a scan of its records if it was
+ * not closed.
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_recording_index_segment(struct hub_recording_segment *p_seg,
+									   struct hub_recording_info    *p_info)
+{
+	struct hub_recording_footer footer;
+	struct hub_recording_record rec;
+	size_t                      index_size;
+	uint64_t                    offset, next_index_ns = 0;
+	uint32_t                    capacity = 0;
+
+	if (p_seg->map_size >= sizeof(struct hub_recording_header) +
+							   sizeof(footer)) {
+		memcpy(&footer, &p_seg->p_map[p_seg->map_size - sizeof(footer)],
+			   sizeof(footer));
+		index_size = footer.num_entries *
+					 sizeof(struct hub_recording_index_entry);
+		if ((HUB_RECORDING_FOOTER_MAGIC == footer.magic) &&
+			(footer.index_offset >= sizeof(struct hub_recording_header)) &&
+			(footer.index_offset + index_size + sizeof(footer) ==
+			 p_seg->map_size)) {
+			/* Copied, as the index of the map may be unaligned */
+			p_seg->p_index = malloc(index_size + 1);
+			if (NULL == p_seg->p_index) {
+				return -1;
+			}
+			memcpy(p_seg->p_index, &p_seg->p_map[footer.index_offset],
+				   index_size);
+			if (hub_recorder_footer_crc(&footer, p_seg->p_index) ==
+				footer.crc) {
+				p_seg->end         = footer.index_offset;
+				p_seg->num_entries = footer.num_entries;
+				p_seg->num_records = footer.num_records;
+				p_seg->last_ns     = footer.last_ns;
+				p_seg->first_ns    = footer.num_entries
+										 ? p_seg->p_index[0].timestamp_ns
+										 : 0;
+				return 0;
+			}
+			free(p_seg->p_index);
+			p_seg->p_index = NULL;
+		}
+	}
+
+	/* Not closed: up to the last whole record, as the writer indexes it */
+	p_info->rebuilt_indexes++;
+	offset = sizeof(struct hub_recording_header);
+	while (p_seg->map_size - offset >= sizeof(rec)) {
+		memcpy(&rec, &p_seg->p_map[offset], sizeof(rec));
+		if (rec.size > p_seg->map_size - offset - sizeof(rec)) {
+			break;
+		}
+		if (rec.timestamp_ns >= next_index_ns) {
+			if (p_seg->num_entries == capacity) {
+				struct hub_recording_index_entry *p_index;
+
+				capacity += HUB_RECORDING_INDEX_CHUNK;
+				p_index   = realloc(p_seg->p_index,
+									capacity * sizeof(*p_index));
+				if (NULL == p_index) {
+					return -1;
+				}
+				p_seg->p_index = p_index;
+			}
+			p_seg->p_index[p_seg->num_entries].timestamp_ns = rec.timestamp_ns;
+			p_seg->p_index[p_seg->num_entries].offset       = offset;
+			p_seg->num_entries++;
+			next_index_ns = rec.timestamp_ns + HUB_RECORDING_INDEX_INTERVAL_NS;
+		}
+		if (0 == p_seg->num_records++) {
+			p_seg->first_ns = rec.timestamp_ns;
+		}
+		p_seg->last_ns = rec.timestamp_ns;
+		offset += sizeof(rec) + rec.size;
+	}
+	p_seg->end = offset;
+
+	return 0;
+}
+
+/**
+ * Map segment n of a recording and check its header.
+ *
+ * @return: 0 on success, 1 if the segment does not exist, -1 on failure
+ */
+static int hub_recording_map_segment(const char                   *p_path,
+									 uint32_t                      n,
+									 struct hub_recording_segment *p_seg,
+									 struct hub_recording_header  *p_header)
+{
+	char       *p_name;
+	size_t      name_size;
+	struct stat st;
+	void       *p_map;
+	int         fd, ret = -1;
+
+	name_size = strlen(p_path) + HUB_RECORDING_SEGMENT_SUFFIX_LEN;
+	p_name    = malloc(name_size);
+	if (NULL == p_name) {
+		return -1;
+	}
+	snprintf(p_name, name_size, "%s.%04u", p_path, n);
+
+	fd = open(p_name, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		if ((ENOENT == errno) && (n > 0)) {
+			ret = 1;
+		} else {
+			hub_pr_err("Failed to open %s: %s\n", p_name, strerror(errno));
+		}
+		goto err_hub_recording_map_segment_1;
+	}
+	if ((0 != fstat(fd, &st)) ||
+		((size_t)st.st_size < sizeof(struct hub_recording_header))) {
+		hub_pr_err("%s is not a recording segment\n", p_name);
+		goto err_hub_recording_map_segment_2;
+	}
+	p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == p_map) {
+		hub_pr_err("Failed to map %s: %s\n", p_name, strerror(errno));
+		goto err_hub_recording_map_segment_2;
+	}
+	p_seg->p_map    = (const uint8_t *)p_map;
+	p_seg->map_size = (size_t)st.st_size;
+
+	memcpy(p_header, p_seg->p_map, sizeof(*p_header));
+	if ((HUB_RECORDING_MAGIC != p_header->magic) ||
+		(HUB_RECORDING_VERSION != p_header->version) ||
+		(sizeof(*p_header) != p_header->header_size) ||
+		(n != p_header->segment)) {
+		hub_pr_err("%s is not segment %u of a version %u recording\n", p_name,
+				   n, HUB_RECORDING_VERSION);
+		goto err_hub_recording_map_segment_2;
+	}
+	ret = 0;
+
+err_hub_recording_map_segment_2:
+	close(fd);
+err_hub_recording_map_segment_1:
+	free(p_name);
+	return ret;
+}
+
+/**
+ * hub_recording_open maps the segments of a recording, see hub.h.
+ */
+enum hub_ret_code hub_recording_open(const char      *p_path,
+									 hub_recording_t *p_recording)
+{
+	struct hub_recording_ctx     *p_ctx;
+	struct hub_recording_segment *p_segments, *p_seg;
+	struct hub_recording_header   header, first_header;
+	uint32_t                      capacity = 0;
+	int                           ret;
+
+	if ((NULL == p_path) || (NULL == p_recording)) {
+		return HUB_FAILURE_RECORDING;
+	}
+
+	p_ctx = calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		return HUB_FAILURE_RECORDING;
+	}
+	memset(&first_header, 0, sizeof(first_header));
+
+	while (1) {
+		if (p_ctx->info.num_segments == capacity) {
+			capacity   = capacity ? capacity * 2 : 16;
+			p_segments = realloc(p_ctx->p_segments,
+								 capacity * sizeof(*p_segments));
+			if (NULL == p_segments) {
+				goto err_hub_recording_open_1;
+			}
+			p_ctx->p_segments = p_segments;
+		}
+
+		p_seg = &p_ctx->p_segments[p_ctx->info.num_segments];
+		memset(p_seg, 0, sizeof(*p_seg));
+		ret = hub_recording_map_segment(p_path, p_ctx->info.num_segments,
+										p_seg, &header);
+		if (ret > 0) {
+			break;
+		}
+		/* Counted first, so that a failed segment is unmapped too */
+		p_ctx->info.num_segments++;
+		if (ret < 0) {
+			goto err_hub_recording_open_1;
+		}
+
+		if (1 == p_ctx->info.num_segments) {
+			first_header = header;
+		} else if ((header.gard_index != first_header.gard_index) ||
+				   (header.start_ns != first_header.start_ns)) {
+			hub_pr_err("Segment %u of %s is of another recording\n",
+					   p_ctx->info.num_segments - 1, p_path);
+			goto err_hub_recording_open_1;
+		}
+		if (0 != hub_recording_index_segment(p_seg, &p_ctx->info)) {
+			goto err_hub_recording_open_1;
+		}
+
+		if (p_seg->num_records) {
+			if (0 == p_ctx->info.num_records) {
+				p_ctx->info.first_ns = p_seg->first_ns;
+			}
+			p_ctx->info.last_ns      = p_seg->last_ns;
+			p_ctx->info.num_records += p_seg->num_records;
+		}
+	}
+
+	p_ctx->info.gard_index        = first_header.gard_index;
+	p_ctx->info.start_realtime_ns = first_header.start_realtime_ns;
+	p_ctx->offset                 = sizeof(struct hub_recording_header);
+	*p_recording                  = (hub_recording_t)p_ctx;
+
+	return HUB_SUCCESS;
+
+err_hub_recording_open_1:
+	hub_recording_close((hub_recording_t)p_ctx);
+	return HUB_FAILURE_RECORDING;
+}
+
+/**
+ * hub_recording_get_info reads the totals of a recording, see hub.h.
+ */
+void hub_recording_get_info(hub_recording_t            recording,
+							struct hub_recording_info *p_info)
+{
+	struct hub_recording_ctx *p_ctx = (struct hub_recording_ctx *)recording;
+
+	if ((NULL != p_ctx) && (NULL != p_info)) {
+		*p_info = p_ctx->info;
+	}
+}
+
+/**
+ * hub_recording_seek places the reader on the first record at or after a
+ * time, see hub.h.
+ */
+enum hub_ret_code hub_recording_seek(hub_recording_t recording,
+									 uint64_t        timestamp_ns)
+{
+	struct hub_recording_ctx     *p_ctx = (struct hub_recording_ctx *)recording;
+	struct hub_recording_segment *p_seg;
+	struct hub_recording_record   rec;
+	uint32_t                      lo, hi, mid;
+	uint64_t                      offset;
+
+	if (NULL == p_ctx) {
+		return HUB_FAILURE_RECORDING;
+	}
+
+	/* First segment whose last record is at or after the time */
+	lo = 0;
+	hi = p_ctx->info.num_segments;
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2);
+		if (!p_ctx->p_segments[mid].num_records ||
+			(p_ctx->p_segments[mid].last_ns < timestamp_ns)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	/* Empty segments, only ever the last ones, are skipped */
+	while ((lo < p_ctx->info.num_segments) &&
+		   !p_ctx->p_segments[lo].num_records) {
+		lo++;
+	}
+	if (lo == p_ctx->info.num_segments) {
+		return HUB_FAILURE_RECORDING;
+	}
+	p_seg = &p_ctx->p_segments[lo];
+
+	/* Last index entry at or before the time, else the first record */
+	offset = sizeof(struct hub_recording_header);
+	if (p_seg->num_entries) {
+		uint32_t entry_lo = 0, entry_hi = p_seg->num_entries;
+
+		while (entry_lo < entry_hi) {
+			mid = entry_lo + ((entry_hi - entry_lo) / 2);
+			if (p_seg->p_index[mid].timestamp_ns <= timestamp_ns) {
+				entry_lo = mid + 1;
+			} else {
+				entry_hi = mid;
+			}
+		}
+		if (entry_lo > 0) {
+			offset = p_seg->p_index[entry_lo - 1].offset;
+		}
+	}
+
+	while (p_seg->end - offset >= sizeof(rec)) {
+		memcpy(&rec, &p_seg->p_map[offset], sizeof(rec));
+		if ((rec.timestamp_ns >= timestamp_ns) ||
+			(rec.size > p_seg->end - offset - sizeof(rec))) {
+			break;
+		}
+		offset += sizeof(rec) + rec.size;
+	}
+
+	p_ctx->segment = lo;
+	p_ctx->offset  = offset;
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_recording_next gives the next record of a recording, see hub.h.
+ */
+enum hub_ret_code hub_recording_next(hub_recording_t             recording,
+									 struct hub_recording_entry *p_entry)
+{
+	struct hub_recording_ctx     *p_ctx = (struct hub_recording_ctx *)recording;
+	struct hub_recording_segment *p_seg;
+	struct hub_recording_record   rec;
+	const uint8_t                *p_data;
+
+	if ((NULL == p_ctx) || (NULL == p_entry)) {
+		return HUB_FAILURE_RECORDING;
+	}
+
+	while (p_ctx->segment < p_ctx->info.num_segments) {
+		p_seg = &p_ctx->p_segments[p_ctx->segment];
+		if ((p_ctx->offset > p_seg->end) ||
+			(p_seg->end - p_ctx->offset < sizeof(rec))) {
+			p_ctx->segment++;
+			p_ctx->offset = sizeof(struct hub_recording_header);
+			continue;
+		}
+
+		memcpy(&rec, &p_seg->p_map[p_ctx->offset], sizeof(rec));
+		if (rec.size > p_seg->end - p_ctx->offset - sizeof(rec)) {
+			/* A size gone bad leaves no way to the next record */
+			p_ctx->info.corrupt_records++;
+			p_ctx->offset = p_seg->end;
+			continue;
+		}
+		p_data         = &p_seg->p_map[p_ctx->offset + sizeof(rec)];
+		p_ctx->offset += sizeof(rec) + rec.size;
+		if (hub_recorder_record_crc(&rec, p_data) != rec.crc) {
+			p_ctx->info.corrupt_records++;
+			continue;
+		}
+
+		p_entry->seq          = rec.seq;
+		p_entry->timestamp_ns = rec.timestamp_ns;
+		p_entry->size         = rec.size;
+		p_entry->p_data       = p_data;
+		return HUB_SUCCESS;
+	}
+
+	return HUB_FAILURE_RECORDING;
+}
+
+/**
+ * hub_recording_close unmaps a recording, see hub.h.
+ */
+void hub_recording_close(hub_recording_t recording)
+{
+	struct hub_recording_ctx *p_ctx = (struct hub_recording_ctx *)recording;
+	uint32_t                  i;
+
+	if (NULL == p_ctx) {
+		return;
+	}
+
+	for (i = 0; i < p_ctx->info.num_segments; i++) {
+		if (NULL != p_ctx->p_segments[i].p_map) {
+			munmap((void *)p_ctx->p_segments[i].p_map,
+				   p_ctx->p_segments[i].map_size);
+		}
+		free(p_ctx->p_segments[i].p_index);
+	}
+	free(p_ctx->p_segments);
+	free(p_ctx);
+}
@@ -0,0 +1,30 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_RECORDER_H__
+#define __HUB_RECORDER_H__
+
+#include "hub.h"
+#include "types.h"
+#include "gard_info.h"
+
+/**
+ * hub_recorder_write_appdata appends one app data result of a GARD to its
+ * recording, if it records, see hub_record_appdata(). Called before the
+ * result goes to the user callback, which may reuse the buffer.
+ */
+void hub_recorder_write_appdata(struct hub_gard_info *p_gard,
+								const void           *p_data,
+								uint32_t              size);
+
+/**
+ * hub_recorder_fini stops the recording of a GARD and frees its recorder.
+ * Must not run while app data is delivered.
+ */
+void hub_recorder_fini(struct hub_gard_info *p_gard);
+
+#endif /* __HUB_RECORDER_H__ */
@@ -7,6 +7,59 @@
 
 #include "hub_reg_ops.h"
 
+/**
+ * Take the control bus of a GARD for a single register access. While a
+ * receive data transfer goes on on the bus, the access joins its pipe, see
+ * hub_bus_pipeline_join(), else it locks the bus.
+ *
+ * @param: gard is the GARD to access
+ * @param: p_tag is filled with the tag to send the command with, if pipelined
+ *
+ * @return: true if pipelined, false if the bus is locked
+ */
+static bool hub_reg_bus_take(struct hub_gard_info *gard, uint8_t *p_tag)
+{
+	/* A push to a subscriber could come ahead of the tagged response */
+	if ((NULL == gard->p_subscribe_ctx) &&
+		hub_bus_pipeline_join(gard->control_bus, p_tag)) {
+		return true;
+	}
+
+	hub_bus_lock_ctrl(gard->control_bus);
+
+	return false;
+}
+
+/**
+ * Give back the control bus taken with hub_reg_bus_take().
+ *
+ * @param: gard is the GARD accessed
+ * @param: pipelined is what hub_reg_bus_take() returned
+ */
+static void hub_reg_bus_give(struct hub_gard_info *gard, bool pipelined)
+{
+	if (pipelined) {
+		hub_bus_pipeline_leave(gard->control_bus);
+	} else {
+		hub_bus_unlock_ctrl(gard->control_bus);
+	}
+}
+
+/**
+ * Check the header of a tagged response, see CMD_ID_TAGGED.
+ *
+ * @param: p_tag_hdr is the header read ahead of the response
+ * @param: tag is the tag the command was sent with
+ *
+ * @return: true if the response is the one for the command
+ */
+static bool hub_reg_tag_ok(const struct _response_tag_header *p_tag_hdr,
+						   uint8_t                            tag)
+{
+	return (RESPONSE_TAG_MARKER == p_tag_hdr->tag_marker) &&
+		   (tag == p_tag_hdr->tag);
+}
+
 /**
  * Write a given 32-bit value to a register address in GARD memory
  * represented by the gard handle.
@@ -23,13 +76,20 @@ enum hub_ret_code hub_write_gard_reg(gard_handle_t  p_gard_handle,
 									 uint32_t       reg_addr,
 									 const uint32_t value)
 {
-	int                     bus_hdl;
-	ssize_t                 nread, nwrite;
-	enum hub_gard_bus_types bus_type;
+	int                         bus_hdl, iovcnt;
+	ssize_t                     nread, nwrite;
+	enum hub_gard_bus_types     bus_type;
+	uint64_t                    start_ns;
+	struct iovec                iov[3];
+	bool                        pipelined;
+	uint8_t                     tag = 0;
+
+	struct hub_gard_info       *gard               = NULL;
+	struct _host_requests       write_reg_cmd      = {0};
+	struct _host_responses      write_reg_response = {0};
+	struct _response_tag_header tag_hdr            = {0};
 
-	struct hub_gard_info   *gard               = NULL;
-	struct _host_requests   write_reg_cmd      = {0};
-	struct _host_responses  write_reg_response = {0};
+	start_ns = hub_stats_now_ns();
 
 	gard                     = (struct hub_gard_info *)p_gard_handle;
 
@@ -53,52 +113,73 @@ enum hub_ret_code hub_write_gard_reg(gard_handle_t  p_gard_handle,
 		goto err_write_reg_1;
 	}
 
-	/* Lock the control bus mutex before bus operations */
-	hub_mutex_lock(&gard->control_bus->bus_mutex);
+	/* Lock the control bus mutex before bus operations, or pipeline */
+	pipelined = hub_reg_bus_take(gard, &tag);
+	if (pipelined) {
+		write_reg_cmd.command_id |= CMD_ID_TAGGED;
+	}
 
 	/* We now assume that the bus is open! */
-	nwrite = gard->control_bus->fops.device_write(
-		bus_hdl, &write_reg_cmd.command_id, sizeof(write_reg_cmd.command_id));
-	if (sizeof(write_reg_cmd.command_id) != nwrite) {
+	iovcnt                = 0;
+	iov[iovcnt].iov_base  = &write_reg_cmd.command_id;
+	iov[iovcnt++].iov_len = sizeof(write_reg_cmd.command_id);
+	if (pipelined) {
+		iov[iovcnt].iov_base  = &tag;
+		iov[iovcnt++].iov_len = sizeof(tag);
+	}
+	iov[iovcnt].iov_base = &write_reg_cmd.command_body;
+	iov[iovcnt++].iov_len =
+		sizeof(write_reg_cmd.write_reg_value_to_gard_at_offset_request);
+
+	nwrite = gard->control_bus->fops.device_writev(bus_hdl, iov, iovcnt);
+	if (hub_iov_len(iov, iovcnt) != nwrite) {
 		hub_pr_err("Error sending write_reg cmd\n");
 		goto err_write_reg_2;
 	}
 
-	nwrite = gard->control_bus->fops.device_write(
-		bus_hdl, &write_reg_cmd.command_body,
-		sizeof(write_reg_cmd.write_reg_value_to_gard_at_offset_request));
-	if (sizeof(write_reg_cmd.write_reg_value_to_gard_at_offset_request) !=
-		nwrite) {
-		hub_pr_err("Error sending write_reg data\n");
-		goto err_write_reg_2;
+	/* Bus response collect, after the data being received if pipelined */
+	iovcnt = 0;
+	if (pipelined) {
+		hub_bus_pipeline_wait(gard->control_bus);
+
+		iov[iovcnt].iov_base  = &tag_hdr;
+		iov[iovcnt++].iov_len = sizeof(tag_hdr);
 	}
+	iov[iovcnt].iov_base =
+		&write_reg_response.write_reg_value_to_gard_at_offset_response;
+	iov[iovcnt++].iov_len =
+		sizeof(write_reg_response.write_reg_value_to_gard_at_offset_response);
 
-	/* Bus response collect */
-	nread = gard->control_bus->fops.device_read(
-		bus_hdl,
-		(void *)&write_reg_response.write_reg_value_to_gard_at_offset_response,
-		sizeof(write_reg_response.write_reg_value_to_gard_at_offset_response));
-	if (sizeof(write_reg_response.write_reg_value_to_gard_at_offset_response) !=
-		nread) {
+	nread = gard->control_bus->fops.device_readv(bus_hdl, iov, iovcnt);
+	if (hub_iov_len(iov, iovcnt) != nread) {
 		hub_pr_err("Error getting write_reg response\n");
 		goto err_write_reg_2;
 	}
 
-	hub_mutex_unlock(&gard->control_bus->bus_mutex);
+	hub_reg_bus_give(gard, pipelined);
+
+	if (pipelined && !hub_reg_tag_ok(&tag_hdr, tag)) {
+		hub_pr_err("Error in write_reg response tag\n");
+		goto err_write_reg_1;
+	}
 
 	if (ACK_BYTE !=
 		write_reg_response.write_reg_value_to_gard_at_offset_response.ack) {
 		hub_pr_err("Error in write_reg ack\n");
-		goto err_write_reg_2;
+		goto err_write_reg_1;
 	}
 
+	hub_stats_record(gard, HUB_STATS_OP_WRITE_REG, start_ns, sizeof(value),
+					 false);
+
 	hub_pr_dbg("SUCCESS!\n");
 
 	return HUB_SUCCESS;
 
 err_write_reg_2:
-	hub_mutex_unlock(&gard->control_bus->bus_mutex);
+	hub_reg_bus_give(gard, pipelined);
 err_write_reg_1:
+	hub_stats_record(gard, HUB_STATS_OP_WRITE_REG, start_ns, 0, true);
 	return HUB_FAILURE_WRITE_REG;
 }
 
@@ -119,13 +200,20 @@ enum hub_ret_code hub_read_gard_reg(gard_handle_t p_gard_handle,
 									uint32_t     *p_value)
 
 {
-	int                     bus_hdl;
-	ssize_t                 nread, nwrite;
-	enum hub_gard_bus_types bus_type;
+	int                         bus_hdl, iovcnt;
+	ssize_t                     nread, nwrite;
+	enum hub_gard_bus_types     bus_type;
+	uint64_t                    start_ns;
+	struct iovec                iov[3];
+	bool                        pipelined;
+	uint8_t                     tag = 0;
+
+	struct hub_gard_info       *gard              = NULL;
+	struct _host_requests       read_reg_cmd      = {0};
+	struct _host_responses      read_reg_response = {0};
+	struct _response_tag_header tag_hdr           = {0};
 
-	struct hub_gard_info   *gard              = NULL;
-	struct _host_requests   read_reg_cmd      = {0};
-	struct _host_responses  read_reg_response = {0};
+	start_ns = hub_stats_now_ns();
 
 	gard                    = (struct hub_gard_info *)p_gard_handle;
 
@@ -148,38 +236,55 @@ enum hub_ret_code hub_read_gard_reg(gard_handle_t p_gard_handle,
 		goto err_read_reg_1;
 	}
 
-	/* Lock the control bus mutex before bus operations */
-	hub_mutex_lock(&gard->control_bus->bus_mutex);
+	/* Lock the control bus mutex before bus operations, or pipeline */
+	pipelined = hub_reg_bus_take(gard, &tag);
+	if (pipelined) {
+		read_reg_cmd.command_id |= CMD_ID_TAGGED;
+	}
 
 	/* We now assume that the bus is open! */
-	nwrite = gard->control_bus->fops.device_write(
-		bus_hdl, &read_reg_cmd.command_id, sizeof(read_reg_cmd.command_id));
-	if (sizeof(read_reg_cmd.command_id) != nwrite) {
+	iovcnt                = 0;
+	iov[iovcnt].iov_base  = &read_reg_cmd.command_id;
+	iov[iovcnt++].iov_len = sizeof(read_reg_cmd.command_id);
+	if (pipelined) {
+		iov[iovcnt].iov_base  = &tag;
+		iov[iovcnt++].iov_len = sizeof(tag);
+	}
+	iov[iovcnt].iov_base = &read_reg_cmd.command_body;
+	iov[iovcnt++].iov_len =
+		sizeof(read_reg_cmd.read_reg_value_from_gard_at_offset_request);
+
+	nwrite = gard->control_bus->fops.device_writev(bus_hdl, iov, iovcnt);
+	if (hub_iov_len(iov, iovcnt) != nwrite) {
 		hub_pr_err("Error sending read_reg cmd\n");
 		goto err_read_reg_2;
 	}
 
-	nwrite = gard->control_bus->fops.device_write(
-		bus_hdl, &read_reg_cmd.command_body,
-		sizeof(read_reg_cmd.read_reg_value_from_gard_at_offset_request));
-	if (sizeof(read_reg_cmd.read_reg_value_from_gard_at_offset_request) !=
-		nwrite) {
-		hub_pr_err("Error sending read_reg reg_addr\n");
-		goto err_read_reg_2;
+	/* Bus repsonse collect, after the data being received if pipelined */
+	iovcnt = 0;
+	if (pipelined) {
+		hub_bus_pipeline_wait(gard->control_bus);
+
+		iov[iovcnt].iov_base  = &tag_hdr;
+		iov[iovcnt++].iov_len = sizeof(tag_hdr);
 	}
+	iov[iovcnt].iov_base =
+		&read_reg_response.read_reg_value_from_gard_at_offset_response;
+	iov[iovcnt++].iov_len =
+		sizeof(read_reg_response.read_reg_value_from_gard_at_offset_response);
 
-	/* Bus repsonse collect */
-	nread = gard->control_bus->fops.device_read(
-		bus_hdl,
-		(void *)&read_reg_response.read_reg_value_from_gard_at_offset_response,
-		sizeof(read_reg_response.read_reg_value_from_gard_at_offset_response));
-	if (sizeof(read_reg_response.read_reg_value_from_gard_at_offset_response) !=
-		nread) {
+	nread = gard->control_bus->fops.device_readv(bus_hdl, iov, iovcnt);
+	if (hub_iov_len(iov, iovcnt) != nread) {
 		hub_pr_err("Error getting read_reg response\n");
 		goto err_read_reg_2;
 	}
 
-	hub_mutex_unlock(&gard->control_bus->bus_mutex);
+	hub_reg_bus_give(gard, pipelined);
+
+	if (pipelined && !hub_reg_tag_ok(&tag_hdr, tag)) {
+		hub_pr_err("Error in read_reg response tag\n");
+		goto err_read_reg_1;
+	}
 
 	if ((START_OF_DATA_MARKER !=
 		 read_reg_response.read_reg_value_from_gard_at_offset_response
@@ -188,18 +293,334 @@ enum hub_ret_code hub_read_gard_reg(gard_handle_t p_gard_handle,
 		 read_reg_response.read_reg_value_from_gard_at_offset_response
 			 .end_of_data_marker)) {
 		hub_pr_err("Error in read_reg response\n");
-		goto err_read_reg_2;
+		goto err_read_reg_1;
 	}
 
 	*p_value =
 		read_reg_response.read_reg_value_from_gard_at_offset_response.reg_value;
 
+	hub_stats_record(gard, HUB_STATS_OP_READ_REG, start_ns, sizeof(*p_value),
+					 false);
+
 	hub_pr_dbg("SUCCESS!\n");
 
 	return HUB_SUCCESS;
 
 err_read_reg_2:
-	hub_mutex_unlock(&gard->control_bus->bus_mutex);
+	hub_reg_bus_give(gard, pipelined);
 err_read_reg_1:
+	hub_stats_record(gard, HUB_STATS_OP_READ_REG, start_ns, 0, true);
+	return HUB_FAILURE_READ_REG;
+}
+
+/**
+ * Run one WRITE_REGS_TO_GARD exchange on a locked control bus.
+ *
+ * @param: gard is the GARD to write the registers of
+ * @param: bus_hdl is the handle of the open control bus
+ * @param: p_reg_addrs is the list of register addresses to write
+ * @param: p_values is the list of values to write, one per address
+ * @param: num_regs is the number of registers, at most
+ * 		GARD_HUB_MAX_REGS_PER_CMD
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_write_gard_regs_cmd(struct hub_gard_info *gard,
+								   int                   bus_hdl,
+								   const uint32_t       *p_reg_addrs,
+								   const uint32_t       *p_values,
+								   uint32_t              num_regs)
+{
+	uint32_t               i;
+	ssize_t                nread, nwrite;
+	struct iovec           iov[4];
+	uint32_t               regs[2 * GARD_HUB_MAX_REGS_PER_CMD];
+	struct _host_requests  write_regs_cmd      = {0};
+	struct _host_responses write_regs_response = {0};
+
+	write_regs_cmd.command_id                              = WRITE_REGS_TO_GARD;
+	write_regs_cmd.write_regs_to_gard_request.cmd.num_regs = num_regs;
+	write_regs_cmd.write_regs_to_gard_request.eod.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	/* GARD expects (address, value) pairs back to back */
+	for (i = 0; i < num_regs; i++) {
+		regs[2 * i]       = p_reg_addrs[i];
+		regs[(2 * i) + 1] = p_values[i];
+	}
+
+	/* The cmd id, cmd, pairs and eod marker go out in one bus transaction */
+	iov[0].iov_base = &write_regs_cmd.command_id;
+	iov[0].iov_len  = sizeof(write_regs_cmd.command_id);
+	iov[1].iov_base = &write_regs_cmd.command_body;
+	iov[1].iov_len  = sizeof(write_regs_cmd.write_regs_to_gard_request.cmd);
+	iov[2].iov_base = regs;
+	iov[2].iov_len  = 2 * num_regs * sizeof(uint32_t);
+	iov[3].iov_base =
+		&write_regs_cmd.write_regs_to_gard_request.eod.end_of_data_marker;
+	iov[3].iov_len  = sizeof(
+		write_regs_cmd.write_regs_to_gard_request.eod.end_of_data_marker);
+
+	/* We now assume that the bus is open! */
+	nwrite = gard->control_bus->fops.device_writev(bus_hdl, iov, 4);
+	if (hub_iov_len(iov, 4) != nwrite) {
+		hub_pr_err("Error sending write_regs cmd\n");
+		return -1;
+	}
+
+	/* Bus response collect */
+	nread = gard->control_bus->fops.device_read(
+		bus_hdl, (void *)&write_regs_response.write_regs_to_gard_response,
+		sizeof(write_regs_response.write_regs_to_gard_response));
+	if (sizeof(write_regs_response.write_regs_to_gard_response) != nread) {
+		hub_pr_err("Error getting write_regs response\n");
+		return -1;
+	}
+
+	if (ACK_BYTE != write_regs_response.write_regs_to_gard_response.ack) {
+		hub_pr_err("Error in write_regs ack\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Write a list of 32-bit values to register addresses in GARD memory
+ * represented by the gard handle, in the order listed.
+ *
+ * The list goes out in WRITE_REGS_TO_GARD commands of up to
+ * GARD_HUB_MAX_REGS_PER_CMD registers, i.e. one bus round-trip per batch
+ * instead of one per register.
+ *
+ * @param: p_gard_handle GARD handle for preforming the write
+ * @param: p_reg_addrs register addresses inside the GARD memory map
+ * @param: p_values values to be written, one per register address
+ * @param: num_regs number of entries in p_reg_addrs and p_values
+ *
+ * @return: hub_ret_code
+ * 		HUB_SUCCESS on success
+ * 		HUB_FAILURE_WRITE_REG on failure
+ */
+enum hub_ret_code hub_write_gard_regs(gard_handle_t   p_gard_handle,
+									  const uint32_t *p_reg_addrs,
+									  const uint32_t *p_values,
+									  uint32_t        num_regs)
+{
+	int                     bus_hdl;
+	enum hub_gard_bus_types bus_type;
+	uint64_t                start_ns;
+	uint32_t                done, batch;
+
+	struct hub_gard_info   *gard = NULL;
+
+	start_ns = hub_stats_now_ns();
+
+	gard                         = (struct hub_gard_info *)p_gard_handle;
+
+	if ((NULL == p_reg_addrs) || (NULL == p_values)) {
+		hub_pr_err("Invalid register list for write_regs\n");
+		goto err_write_regs_1;
+	}
+
+	bus_type = gard->control_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->control_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->control_bus->uart.bus_hdl;
+		break;
+	default:
+		hub_pr_err("Bus not supported for write_regs!\n");
+		goto err_write_regs_1;
+	}
+
+	/* Lock the control bus mutex before bus operations */
+	hub_bus_lock_ctrl(gard->control_bus);
+
+	for (done = 0; done < num_regs; done += batch) {
+		batch = hub_min_uint32(num_regs - done, GARD_HUB_MAX_REGS_PER_CMD);
+
+		if (hub_write_gard_regs_cmd(gard, bus_hdl, p_reg_addrs + done,
+									p_values + done, batch)) {
+			goto err_write_regs_2;
+		}
+	}
+
+	hub_bus_unlock_ctrl(gard->control_bus);
+
+	hub_stats_record(gard, HUB_STATS_OP_WRITE_REG, start_ns,
+					 num_regs * sizeof(uint32_t), false);
+
+	hub_pr_dbg("SUCCESS!\n");
+
+	return HUB_SUCCESS;
+
+err_write_regs_2:
+	hub_bus_unlock_ctrl(gard->control_bus);
+err_write_regs_1:
+	hub_stats_record(gard, HUB_STATS_OP_WRITE_REG, start_ns, 0, true);
+	return HUB_FAILURE_WRITE_REG;
+}
+
+/**
+ * Run one READ_REGS_FROM_GARD exchange on a locked control bus.
+ *
+ * @param: gard is the GARD to read the registers of
+ * @param: bus_hdl is the handle of the open control bus
+ * @param: p_reg_addrs is the list of register addresses to read
+ * @param: p_values is filled with the values read, one per address
+ * @param: num_regs is the number of registers, at most
+ * 		GARD_HUB_MAX_REGS_PER_CMD
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_read_gard_regs_cmd(struct hub_gard_info *gard,
+								  int                   bus_hdl,
+								  const uint32_t       *p_reg_addrs,
+								  uint32_t             *p_values,
+								  uint32_t              num_regs)
+{
+	ssize_t                nread, nwrite;
+	struct iovec           iov[4];
+	struct _host_requests  read_regs_cmd      = {0};
+	struct _host_responses read_regs_response = {0};
+
+	read_regs_cmd.command_id = READ_REGS_FROM_GARD;
+	read_regs_cmd.read_regs_from_gard_request.cmd.num_regs = num_regs;
+	read_regs_cmd.read_regs_from_gard_request.eod.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	/* The cmd id, cmd, addresses and eod marker go out in one transaction */
+	iov[0].iov_base = &read_regs_cmd.command_id;
+	iov[0].iov_len  = sizeof(read_regs_cmd.command_id);
+	iov[1].iov_base = &read_regs_cmd.command_body;
+	iov[1].iov_len  = sizeof(read_regs_cmd.read_regs_from_gard_request.cmd);
+	iov[2].iov_base = (void *)p_reg_addrs;
+	iov[2].iov_len  = num_regs * sizeof(uint32_t);
+	iov[3].iov_base =
+		&read_regs_cmd.read_regs_from_gard_request.eod.end_of_data_marker;
+	iov[3].iov_len  = sizeof(
+		read_regs_cmd.read_regs_from_gard_request.eod.end_of_data_marker);
+
+	/* We now assume that the bus is open! */
+	nwrite = gard->control_bus->fops.device_writev(bus_hdl, iov, 4);
+	if (hub_iov_len(iov, 4) != nwrite) {
+		hub_pr_err("Error sending read_regs cmd\n");
+		return -1;
+	}
+
+	/* Bus response collect: the values land straight in p_values */
+	iov[0].iov_base =
+		&read_regs_response.read_regs_from_gard_response.start_of_data_marker;
+	iov[0].iov_len = sizeof(
+		read_regs_response.read_regs_from_gard_response.start_of_data_marker);
+	iov[1].iov_base = &read_regs_response.read_regs_from_gard_response.num_regs;
+	iov[1].iov_len =
+		sizeof(read_regs_response.read_regs_from_gard_response.num_regs);
+	iov[2].iov_base = p_values;
+	iov[2].iov_len  = num_regs * sizeof(uint32_t);
+	iov[3].iov_base =
+		&read_regs_response.read_regs_from_gard_response.eod.end_of_data_marker;
+	iov[3].iov_len  = sizeof(read_regs_response.read_regs_from_gard_response
+								 .eod.end_of_data_marker);
+
+	nread = gard->control_bus->fops.device_readv(bus_hdl, iov, 4);
+	if (hub_iov_len(iov, 4) != nread) {
+		hub_pr_err("Error getting read_regs response\n");
+		return -1;
+	}
+
+	if ((START_OF_DATA_MARKER !=
+		 read_regs_response.read_regs_from_gard_response
+			 .start_of_data_marker) ||
+		(num_regs !=
+		 read_regs_response.read_regs_from_gard_response.num_regs) ||
+		(END_OF_DATA_MARKER != read_regs_response.read_regs_from_gard_response
+								   .eod.end_of_data_marker)) {
+		hub_pr_err("Error in read_regs response\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Read the 32-bit values of a list of register addresses in GARD memory
+ * represented by the gard handle.
+ *
+ * The list goes out in READ_REGS_FROM_GARD commands of up to
+ * GARD_HUB_MAX_REGS_PER_CMD registers, i.e. one bus round-trip per batch
+ * instead of one per register.
+ *
+ * @param: p_gard_handle GARD handle for preforming the read
+ * @param: p_reg_addrs register addresses inside the GARD memory map
+ * @param: p_values buffer of num_regs entries filled on successful read
+ * @param: num_regs number of entries in p_reg_addrs and p_values
+ *
+ * @return: hub_ret_code
+ * 			HUB_SUCCESS on success
+ * 			HUB_FAILURE_READ_REG on failure
+ */
+enum hub_ret_code hub_read_gard_regs(gard_handle_t   p_gard_handle,
+									 const uint32_t *p_reg_addrs,
+									 uint32_t       *p_values,
+									 uint32_t        num_regs)
+{
+	int                     bus_hdl;
+	enum hub_gard_bus_types bus_type;
+	uint64_t                start_ns;
+	uint32_t                done, batch;
+
+	struct hub_gard_info   *gard = NULL;
+
+	start_ns = hub_stats_now_ns();
+
+	gard                         = (struct hub_gard_info *)p_gard_handle;
+
+	if ((NULL == p_reg_addrs) || (NULL == p_values)) {
+		hub_pr_err("Invalid register list for read_regs\n");
+		goto err_read_regs_1;
+	}
+
+	bus_type = gard->control_bus->types;
+	switch (bus_type) {
+	case HUB_GARD_BUS_I2C:
+		bus_hdl = gard->control_bus->i2c.bus_hdl;
+		break;
+	case HUB_GARD_BUS_UART:
+		bus_hdl = gard->control_bus->uart.bus_hdl;
+		break;
+	default:
+		hub_pr_err("Bus not supported for read_regs!\n");
+		goto err_read_regs_1;
+	}
+
+	/* Lock the control bus mutex before bus operations */
+	hub_bus_lock_ctrl(gard->control_bus);
+
+	for (done = 0; done < num_regs; done += batch) {
+		batch = hub_min_uint32(num_regs - done, GARD_HUB_MAX_REGS_PER_CMD);
+
+		if (hub_read_gard_regs_cmd(gard, bus_hdl, p_reg_addrs + done,
+								   p_values + done, batch)) {
+			goto err_read_regs_2;
+		}
+	}
+
+	hub_bus_unlock_ctrl(gard->control_bus);
+
+	hub_stats_record(gard, HUB_STATS_OP_READ_REG, start_ns,
+					 num_regs * sizeof(uint32_t), false);
+
+	hub_pr_dbg("SUCCESS!\n");
+
+	return HUB_SUCCESS;
+
+err_read_regs_2:
+	hub_bus_unlock_ctrl(gard->control_bus);
+err_read_regs_1:
+	hub_stats_record(gard, HUB_STATS_OP_READ_REG, start_ns, 0, true);
 	return HUB_FAILURE_READ_REG;
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@
 #include "gard_info.h"
 #include "gard_hub_iface.h"
 #include "hub_globals.h"
+#include "hub_stats.h"
 
 /**
  * Write a given 32-bit value to a register address in GARD memory
@@ -29,4 +30,24 @@ enum hub_ret_code hub_read_gard_reg(gard_handle_t p_gard_handle,
 									uint32_t      reg_addr,
 									uint32_t     *p_value);
 
+/**
+ * Write a list of 32-bit values to register addresses in GARD memory
+ * represented by the gard handle, in the order listed. Up to
+ * GARD_HUB_MAX_REGS_PER_CMD registers go in one bus round-trip.
+ */
+enum hub_ret_code hub_write_gard_regs(gard_handle_t   p_gard_handle,
+									  const uint32_t *p_reg_addrs,
+									  const uint32_t *p_values,
+									  uint32_t        num_regs);
+
+/**
+ * Read the 32-bit values of a list of register addresses in GARD memory
+ * represented by the gard handle. Up to GARD_HUB_MAX_REGS_PER_CMD
+ * registers go in one bus round-trip.
+ */
+enum hub_ret_code hub_read_gard_regs(gard_handle_t   p_gard_handle,
+									 const uint32_t *p_reg_addrs,
+									 uint32_t       *p_values,
+									 uint32_t        num_regs);
+
 #endif /* __HUB_REG_OPS_H__ */
\ No newline at end of file
@@ -0,0 +1,474 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * App data fan-out over shared memory.
+ *
+ * Only the process holding the HUB owns the GPIO lines and busses of the
+ * GARDs. It publishes each app data result, and snapshots the app gives it,
+ * to a ring in a POSIX shared memory object, and any number of processes on
+ * the host attach to that ring and read the records in place: nothing is
+ * copied or serialized per reader, and a reader never blocks the publisher.
+ *
+ * A reader that falls more than the ring size behind loses the oldest
+ * records, see hub_shm_reader_lost().
+ */
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "hub_shm_ring.h"
+#include "hub_stats.h"
+
+/* Back-end of a hub_shm_reader_t */
+struct hub_shm_reader_ctx {
+	const struct hub_shm_ring_hdr *p_hdr;
+	size_t                         map_size;
+	uint64_t                       next_seq;
+	uint64_t                       lost;
+};
+
+static inline uint8_t *hub_shm_ring_slot(const struct hub_shm_ring_hdr *p_hdr,
+										 uint64_t                       seq)
+{
+	return (uint8_t *)p_hdr + sizeof(*p_hdr) +
+		   ((seq % p_hdr->num_slots) * p_hdr->slot_stride);
+}
+
+static size_t hub_shm_ring_map_size(uint32_t num_slots, uint32_t slot_stride)
+{
+	return sizeof(struct hub_shm_ring_hdr) + ((size_t)num_slots * slot_stride);
+}
+
+struct hub_shm_ring *hub_shm_ring_create(const char *p_name,
+										 uint32_t    num_slots,
+										 uint32_t    slot_size)
+{
+	struct hub_shm_ring *p_ring;
+	uint32_t             slot_stride;
+	int                  fd;
+
+	if ((NULL == p_name) || ('/' != p_name[0]) ||
+		(strlen(p_name) >= sizeof(p_ring->name)) || (0 == num_slots) ||
+		(0 == slot_size) ||
+		(slot_size > UINT32_MAX - sizeof(struct hub_shm_slot_hdr) -
+						 HUB_SHM_RING_ALIGN)) {
+		hub_pr_err("Invalid shared memory ring name or size\n");
+		return NULL;
+	}
+
+	slot_stride = (uint32_t)((sizeof(struct hub_shm_slot_hdr) + slot_size +
+							  HUB_SHM_RING_ALIGN - 1) &
+							 ~(HUB_SHM_RING_ALIGN - 1));
+
+	p_ring = (struct hub_shm_ring *)calloc(1, sizeof(*p_ring));
+	if (NULL == p_ring) {
+		hub_pr_err("Failed to allocate shared memory ring\n");
+		return NULL;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ring->publish_mutex)) {
+		hub_pr_err("Failed to initialize shared memory ring lock\n");
+		goto err_shm_ring_create_1;
+	}
+
+	strcpy(p_ring->name, p_name);
+	p_ring->map_size = hub_shm_ring_map_size(num_slots, slot_stride);
+	p_ring->next_seq = 1;
+
+	/* Readers of a ring left over by an earlier run keep their own copy */
+	(void)shm_unlink(p_name);
+	fd = shm_open(p_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) {
+		hub_pr_err("Failed to create shared memory %s\n", p_name);
+		goto err_shm_ring_create_2;
+	}
+
+	if (ftruncate(fd, (off_t)p_ring->map_size)) {
+		hub_pr_err("Failed to size shared memory %s to %zu bytes\n", p_name,
+				   p_ring->map_size);
+		goto err_shm_ring_create_3;
+	}
+
+	p_ring->p_hdr = (struct hub_shm_ring_hdr *)mmap(
+		NULL, p_ring->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == (void *)p_ring->p_hdr) {
+		hub_pr_err("Failed to map shared memory %s\n", p_name);
+		goto err_shm_ring_create_3;
+	}
+	close(fd);
+
+	/* ftruncate() zeroed the slots, so no slot holds a record yet */
+	p_ring->p_hdr->version     = HUB_SHM_RING_VERSION;
+	p_ring->p_hdr->num_slots   = num_slots;
+	p_ring->p_hdr->slot_size   = slot_size;
+	p_ring->p_hdr->slot_stride = slot_stride;
+	__atomic_store_n(&p_ring->p_hdr->magic, HUB_SHM_RING_MAGIC,
+					 __ATOMIC_RELEASE);
+
+	return p_ring;
+
+err_shm_ring_create_3:
+	close(fd);
+	(void)shm_unlink(p_name);
+err_shm_ring_create_2:
+	hub_mutex_destroy(&p_ring->publish_mutex);
+err_shm_ring_create_1:
+	free(p_ring);
+	return NULL;
+}
+
+void hub_shm_ring_destroy(struct hub_shm_ring *p_ring)
+{
+	if (NULL == p_ring) {
+		return;
+	}
+
+	__atomic_store_n(&p_ring->p_hdr->is_closed, 1U, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&p_ring->p_hdr->wake_seq, 1U, __ATOMIC_RELEASE);
+	(void)syscall(SYS_futex, &p_ring->p_hdr->wake_seq, FUTEX_WAKE, INT_MAX,
+				  NULL, NULL, 0);
+
+	munmap(p_ring->p_hdr, p_ring->map_size);
+	(void)shm_unlink(p_ring->name);
+	hub_mutex_destroy(&p_ring->publish_mutex);
+	free(p_ring);
+}
+
+int hub_shm_ring_publish(struct hub_shm_ring *p_ring,
+						 uint32_t             type,
+						 uint32_t             gard_index,
+						 const void          *p_data,
+						 uint32_t             size)
+{
+	struct hub_shm_ring_hdr *p_hdr = p_ring->p_hdr;
+	struct hub_shm_slot_hdr *p_slot;
+	uint64_t                 seq;
+
+	if (size > p_hdr->slot_size) {
+		hub_pr_dbg("Dropped %u bytes record, shared memory slots are %u\n",
+				   size, p_hdr->slot_size);
+		return -1;
+	}
+
+	hub_mutex_lock(&p_ring->publish_mutex);
+
+	seq    = p_ring->next_seq++;
+	p_slot = (struct hub_shm_slot_hdr *)hub_shm_ring_slot(p_hdr, seq);
+
+	/* Readers of the record this slot held see it go before it changes */
+	__atomic_store_n(&p_slot->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	p_slot->timestamp_ns = hub_stats_now_ns();
+	p_slot->type         = type;
+	p_slot->gard_index   = gard_index;
+	p_slot->size         = size;
+	memcpy((uint8_t *)(p_slot + 1), p_data, size);
+
+	__atomic_store_n(&p_slot->seq, seq, __ATOMIC_RELEASE);
+	__atomic_store_n(&p_hdr->head_seq, seq, __ATOMIC_RELEASE);
+
+	hub_mutex_unlock(&p_ring->publish_mutex);
+
+	/* The publisher cannot see the waiters of a read-only mapping */
+	__atomic_add_fetch(&p_hdr->wake_seq, 1U, __ATOMIC_RELEASE);
+	(void)syscall(SYS_futex, &p_hdr->wake_seq, FUTEX_WAKE, INT_MAX, NULL,
+				  NULL, 0);
+
+	return 0;
+}
+
+void hub_shm_ring_publish_appdata(struct hub_gard_info *p_gard,
+								  const void           *p_data,
+								  uint32_t              size)
+{
+	struct hub_shm_ring *p_ring;
+
+	p_ring = __atomic_load_n(&p_gard->p_publish_ring, __ATOMIC_ACQUIRE);
+	if (NULL != p_ring) {
+		(void)hub_shm_ring_publish(p_ring, HUB_SHM_RECORD_APPDATA,
+								   p_gard->gard_index, p_data, size);
+	}
+}
+
+/**
+ * hub_publish_appdata publishes the app data results of a GARD to a shared
+ * memory ring, see hub.h.
+ */
+enum hub_ret_code hub_publish_appdata(gard_handle_t gard,
+									  const char   *p_shm_name,
+									  uint32_t      num_slots,
+									  uint32_t      slot_size)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_shm_ring  *p_ring;
+
+	if (NULL == p_gard) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	if (NULL != p_gard->p_publish_ring) {
+		hub_pr_err("GARD %u already publishes to %s\n", p_gard->gard_index,
+				   p_gard->p_publish_ring->name);
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	p_ring = hub_shm_ring_create(p_shm_name, num_slots, slot_size);
+	if (NULL == p_ring) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	__atomic_store_n(&p_gard->p_publish_ring, p_ring, __ATOMIC_RELEASE);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_unpublish_appdata stops publishing the app data results of a GARD,
+ * see hub.h.
+ */
+enum hub_ret_code hub_unpublish_appdata(gard_handle_t gard)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_shm_ring  *p_ring;
+
+	if (NULL == p_gard) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	p_ring = __atomic_exchange_n(&p_gard->p_publish_ring, NULL,
+								 __ATOMIC_ACQ_REL);
+	hub_shm_ring_destroy(p_ring);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_publish_snapshot adds a snapshot to the ring of a GARD, see hub.h.
+ */
+enum hub_ret_code hub_publish_snapshot(gard_handle_t gard,
+									   const void   *p_buffer,
+									   uint32_t      size)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_shm_ring  *p_ring;
+
+	if ((NULL == p_gard) || (NULL == p_buffer)) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	p_ring = __atomic_load_n(&p_gard->p_publish_ring, __ATOMIC_ACQUIRE);
+	if ((NULL == p_ring) ||
+		hub_shm_ring_publish(p_ring, HUB_SHM_RECORD_SNAPSHOT,
+							 p_gard->gard_index, p_buffer, size)) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_shm_reader_attach maps a published ring for reading, see hub.h.
+ */
+enum hub_ret_code hub_shm_reader_attach(const char       *p_shm_name,
+										hub_shm_reader_t *p_reader)
+{
+	struct hub_shm_reader_ctx *p_ctx;
+	struct hub_shm_ring_hdr    hdr;
+	struct stat                st;
+	void                      *p_map;
+	int                        fd;
+
+	if ((NULL == p_shm_name) || (NULL == p_reader)) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	fd = shm_open(p_shm_name, O_RDONLY, 0);
+	if (fd < 0) {
+		hub_pr_err("No shared memory ring %s\n", p_shm_name);
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	if (fstat(fd, &st) || ((size_t)st.st_size < sizeof(hdr))) {
+		hub_pr_err("Shared memory ring %s is not set up\n", p_shm_name);
+		goto err_reader_attach_1;
+	}
+
+	p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == p_map) {
+		hub_pr_err("Failed to map shared memory ring %s\n", p_shm_name);
+		goto err_reader_attach_1;
+	}
+	close(fd);
+
+	if (HUB_SHM_RING_MAGIC !=
+		__atomic_load_n(&((struct hub_shm_ring_hdr *)p_map)->magic,
+						__ATOMIC_ACQUIRE)) {
+		hub_pr_err("Shared memory ring %s is not set up\n", p_shm_name);
+		goto err_reader_attach_2;
+	}
+
+	memcpy(&hdr, p_map, sizeof(hdr));
+	if ((HUB_SHM_RING_VERSION != hdr.version) || (0 == hdr.num_slots) ||
+		(hub_shm_ring_map_size(hdr.num_slots, hdr.slot_stride) >
+		 (size_t)st.st_size)) {
+		hub_pr_err("Shared memory ring %s has an unknown layout\n",
+				   p_shm_name);
+		goto err_reader_attach_2;
+	}
+
+	p_ctx = (struct hub_shm_reader_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate shared memory reader\n");
+		goto err_reader_attach_2;
+	}
+
+	p_ctx->p_hdr    = (const struct hub_shm_ring_hdr *)p_map;
+	p_ctx->map_size = (size_t)st.st_size;
+	/* Start with the records published from now on */
+	p_ctx->next_seq =
+		__atomic_load_n(&p_ctx->p_hdr->head_seq, __ATOMIC_ACQUIRE) + 1;
+
+	*p_reader = (hub_shm_reader_t)p_ctx;
+
+	return HUB_SUCCESS;
+
+err_reader_attach_2:
+	munmap(p_map, (size_t)st.st_size);
+	return HUB_FAILURE_SHM_RING;
+err_reader_attach_1:
+	close(fd);
+	return HUB_FAILURE_SHM_RING;
+}
+
+/**
+ * hub_shm_reader_next gives the next record of a ring, see hub.h.
+ */
+enum hub_ret_code hub_shm_reader_next(hub_shm_reader_t       reader,
+									  struct hub_shm_record *p_record,
+									  uint32_t               timeout_ms)
+{
+	struct hub_shm_reader_ctx     *p_ctx = (struct hub_shm_reader_ctx *)reader;
+	const struct hub_shm_ring_hdr *p_hdr;
+	const struct hub_shm_slot_hdr *p_slot;
+	struct timespec                timeout;
+	uint64_t                       head, seq, deadline_ns, now_ns;
+	uint32_t                       wake_seq;
+
+	if ((NULL == p_ctx) || (NULL == p_record)) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	p_hdr       = p_ctx->p_hdr;
+	deadline_ns = hub_stats_now_ns() + ((uint64_t)timeout_ms * 1000000ULL);
+
+	while (1) {
+		/* Read before head_seq, so a record published after is not missed */
+		wake_seq = __atomic_load_n(&p_hdr->wake_seq, __ATOMIC_ACQUIRE);
+		head     = __atomic_load_n(&p_hdr->head_seq, __ATOMIC_ACQUIRE);
+
+		if (head >= p_ctx->next_seq) {
+			/* Skip the records the publisher has written over */
+			if (head - p_ctx->next_seq >= p_hdr->num_slots) {
+				p_ctx->lost     += head - p_ctx->next_seq - p_hdr->num_slots + 1;
+				p_ctx->next_seq  = head - p_hdr->num_slots + 1;
+			}
+
+			p_slot = (const struct hub_shm_slot_hdr *)hub_shm_ring_slot(
+				p_hdr, p_ctx->next_seq);
+			seq    = __atomic_load_n(&p_slot->seq, __ATOMIC_ACQUIRE);
+			if (seq != p_ctx->next_seq) {
+				/* Being written over already, look at head_seq again */
+				continue;
+			}
+
+			p_record->seq          = seq;
+			p_record->timestamp_ns = p_slot->timestamp_ns;
+			p_record->type         = p_slot->type;
+			p_record->gard_index   = p_slot->gard_index;
+			p_record->size         = p_slot->size;
+			p_record->p_data       = (const void *)(p_slot + 1);
+			p_ctx->next_seq++;
+
+			if ((HUB_SUCCESS != hub_shm_reader_done(reader, p_record)) ||
+				(p_record->size > p_hdr->slot_size)) {
+				continue;
+			}
+
+			return HUB_SUCCESS;
+		}
+
+		if (__atomic_load_n(&p_hdr->is_closed, __ATOMIC_ACQUIRE)) {
+			return HUB_FAILURE_SHM_RING;
+		}
+
+		now_ns = hub_stats_now_ns();
+		if (now_ns >= deadline_ns) {
+			return HUB_FAILURE_CONDVAR_TIMEDOUT;
+		}
+
+		timeout.tv_sec  = (time_t)((deadline_ns - now_ns) / 1000000000ULL);
+		timeout.tv_nsec = (long)((deadline_ns - now_ns) % 1000000000ULL);
+		(void)syscall(SYS_futex, &p_hdr->wake_seq, FUTEX_WAIT, wake_seq,
+					  &timeout, NULL, 0);
+	}
+}
+
+/**
+ * hub_shm_reader_done tells if a record was intact while read, see hub.h.
+ */
+enum hub_ret_code hub_shm_reader_done(hub_shm_reader_t             reader,
+									  const struct hub_shm_record *p_record)
+{
+	struct hub_shm_reader_ctx     *p_ctx = (struct hub_shm_reader_ctx *)reader;
+	const struct hub_shm_slot_hdr *p_slot;
+
+	if ((NULL == p_ctx) || (NULL == p_record)) {
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	p_slot = (const struct hub_shm_slot_hdr *)p_record->p_data - 1;
+
+	/* Order the reads of the record before the check of its seq */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&p_slot->seq, __ATOMIC_RELAXED) != p_record->seq) {
+		p_ctx->lost++;
+		return HUB_FAILURE_SHM_RING;
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_shm_reader_lost gives the number of records a reader missed.
+ */
+uint64_t hub_shm_reader_lost(hub_shm_reader_t reader)
+{
+	struct hub_shm_reader_ctx *p_ctx = (struct hub_shm_reader_ctx *)reader;
+
+	return (NULL == p_ctx) ? 0 : p_ctx->lost;
+}
+
+/**
+ * hub_shm_reader_detach unmaps a ring and frees the reader.
+ */
+void hub_shm_reader_detach(hub_shm_reader_t reader)
+{
+	struct hub_shm_reader_ctx *p_ctx = (struct hub_shm_reader_ctx *)reader;
+
+	if (NULL == p_ctx) {
+		return;
+	}
+
+	munmap((void *)p_ctx->p_hdr, p_ctx->map_size);
+	free(p_ctx);
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_SHM_RING_H__
+#define __HUB_SHM_RING_H__
+
+#include "hub.h"
+#include "types.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+#define HUB_SHM_RING_MAGIC   (0x48534852U) /* "HSHR" */
+#define HUB_SHM_RING_VERSION (1U)
+
+/* Header and slots start on their own cache lines */
+#define HUB_SHM_RING_ALIGN (64U)
+
+/**
+ * Layout of the shared memory object: this header, then num_slots slots of
+ * slot_stride bytes, each a struct hub_shm_slot_hdr followed by up to
+ * slot_size bytes of data. Readers map it read-only.
+ *
+ * Record seq (from 1) goes to slot seq % num_slots. Its seq field is 0 while
+ * the publisher writes the slot, and seq once the record is complete.
+ * Readers check it again after reading, so a record overwritten while read
+ * is seen as lost, never as torn.
+ */
+struct hub_shm_ring_hdr {
+	uint32_t          magic; /* Written last, once the ring is set up */
+	uint32_t          version;
+	uint32_t          num_slots;
+	uint32_t          slot_size;
+	uint32_t          slot_stride;
+	volatile uint32_t is_closed;
+	volatile uint64_t head_seq; /* Last complete record, 0 if none */
+	volatile uint32_t wake_seq; /* Futex readers wait on, bumped per record */
+} __attribute__((aligned(HUB_SHM_RING_ALIGN)));
+
+struct hub_shm_slot_hdr {
+	volatile uint64_t seq;
+	uint64_t          timestamp_ns;
+	uint32_t          type; /* enum hub_shm_record_type */
+	uint32_t          gard_index;
+	uint32_t          size;
+	uint32_t          reserved;
+};
+
+/* Publishing end of a ring, owned by the HUB process */
+struct hub_shm_ring {
+	char                     name[NAME_MAX];
+	struct hub_shm_ring_hdr *p_hdr;
+	size_t                   map_size;
+	/* Pool workers of several GPIO lines may publish at once */
+	hub_mutex_t              publish_mutex;
+	uint64_t                 next_seq;
+};
+
+/**
+ * hub_shm_ring_create creates the shared memory object p_name, replacing any
+ * left over by an earlier run, and maps it for publishing.
+ *
+ * @return: ring on success, NULL on failure
+ */
+struct hub_shm_ring *hub_shm_ring_create(const char *p_name,
+										 uint32_t    num_slots,
+										 uint32_t    slot_size);
+
+/**
+ * hub_shm_ring_destroy marks the ring closed for its readers, unmaps and
+ * unlinks it. Readers still attached keep their mapping until they detach.
+ */
+void hub_shm_ring_destroy(struct hub_shm_ring *p_ring);
+
+/**
+ * hub_shm_ring_publish writes one record to the ring and wakes its readers.
+ * Records larger than the slot size are dropped.
+ *
+ * @return: 0 on success, -1 if the record was dropped
+ */
+int hub_shm_ring_publish(struct hub_shm_ring *p_ring,
+						 uint32_t             type,
+						 uint32_t             gard_index,
+						 const void          *p_data,
+						 uint32_t             size);
+
+/**
+ * hub_shm_ring_publish_appdata publishes one app data result of a GARD, if
+ * it is published, see hub_publish_appdata(). Called before the result goes
+ * to the user callback, which may reuse the buffer.
+ */
+void hub_shm_ring_publish_appdata(struct hub_gard_info *p_gard,
+								  const void           *p_data,
+								  uint32_t              size);
+
+#endif /* __HUB_SHM_RING_H__ */
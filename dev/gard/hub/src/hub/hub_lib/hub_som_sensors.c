@@ -6,6 +6,7 @@
  ******************************************************************************/
 
 #include "hub_som_sensors.h"
+#include "hub_stats.h"
 
 /**
  * HUB SENSORS internal function
@@ -63,6 +64,73 @@ static uint8_t hub_get_energy_sensor_i2c_slave_addr(uint8_t sensor_id)
 	return slave_id;
 }
 
+/**
+ * HUB SENSORS internal function
+ *
+ * Copy a sample out of the sampler ring, unless the sampler overwrites it
+ * meanwhile.
+ *
+ * @param: p_ctx is the sampler context
+ * @param: seq is the seq of the sample
+ * @param: p_sample is filled with the sample
+ *
+ * @return: true if the sample was copied intact
+ */
+static bool hub_som_sampler_copy(const struct hub_som_sampler_ctx *p_ctx,
+								 uint64_t                          seq,
+								 struct hub_som_sensor_sample     *p_sample)
+{
+	const struct hub_som_sampler_slot *p_slot =
+		&p_ctx->slots[seq % HUB_SOM_SAMPLER_DEPTH];
+
+	if (__atomic_load_n(&p_slot->seq, __ATOMIC_ACQUIRE) != seq) {
+		return false;
+	}
+
+	memcpy(p_sample, &p_slot->sample, sizeof(*p_sample));
+
+	/* Order the copy before the check of its seq */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&p_slot->seq, __ATOMIC_RELAXED) == seq;
+}
+
+/**
+ * HUB SENSORS internal function
+ *
+ * Get the latest sample of the sampler, if it runs.
+ *
+ * @param: p_hub is the HUB context
+ * @param: p_sample is filled with the sample
+ *
+ * @return: true if there is a sample, false if the sensors are to be read
+ *          on the bus
+ */
+static bool hub_som_sampler_latest(struct hub_ctx               *p_hub,
+								   struct hub_som_sensor_sample *p_sample)
+{
+	struct hub_som_sampler_ctx *p_ctx;
+	uint64_t                    head;
+	int                         i;
+
+	p_ctx = __atomic_load_n(&p_hub->p_som_sampler_ctx, __ATOMIC_ACQUIRE);
+	if (NULL == p_ctx) {
+		return false;
+	}
+
+	/* A slot is only written again HUB_SOM_SAMPLER_DEPTH samples later */
+	for (i = 0; i < HUB_SOM_SAMPLER_READ_TRIES; i++) {
+		head = __atomic_load_n(&p_ctx->head_seq, __ATOMIC_ACQUIRE);
+		if (0 == head) {
+			return false;
+		}
+		if (hub_som_sampler_copy(p_ctx, head, p_sample)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * Read the temperature from the sensor(s) with given sensor IDs.
  *
@@ -95,6 +163,9 @@ uint32_t hub_get_temperature_from_onboard_sensors(hub_handle_t hub,
 
 	struct hub_gard_bus *p_bus_ctx = NULL;
 
+	struct hub_som_sensor_sample sample;
+	uint32_t                     idx;
+
 	/* Handle pathological cases */
 	if (0 == num_sensors) {
 		printf("No sensors to read!\n");
@@ -118,6 +189,20 @@ uint32_t hub_get_temperature_from_onboard_sensors(hub_handle_t hub,
 
 	p_hub = (struct hub_ctx *)hub;
 
+	/* Served by the sampler without going on the bus, if it runs */
+	if (hub_som_sampler_latest(p_hub, &sample)) {
+		for (i = 0; i < num_sensors; i++) {
+			idx       = p_sensor_ids[i] - 1;
+			p_temp[i] = HUB_INVALID_SENSOR_VALUE;
+			if ((idx < HUB_SOM_NUM_SENSORS) &&
+				(sample.temperature_valid & (1U << idx))) {
+				p_temp[i] = sample.temperature[idx];
+				num_sensors_read++;
+			}
+		}
+		return num_sensors_read;
+	}
+
 	/* Get the I2C bus context from HUB handle - explicitly search for I2C bus only */
 	for (i = 0; i < p_hub->num_busses; i++) {
 		if (HUB_GARD_BUS_I2C == p_hub->p_bus_props[i].types) {
@@ -233,6 +318,9 @@ uint32_t hub_get_energy_from_onboard_sensors(
 
 	struct hub_gard_bus *p_bus_ctx = NULL;
 
+	struct hub_som_sensor_sample sample;
+	uint32_t                     idx;
+
 	/* Handle pathological cases */
 	if (0 == num_sensors) {
 		printf("No sensors to read!\n");
@@ -256,6 +344,24 @@ uint32_t hub_get_energy_from_onboard_sensors(
 
 	p_hub = (struct hub_ctx *)hub;
 
+	/* Served by the sampler without going on the bus, if it runs */
+	if (hub_som_sampler_latest(p_hub, &sample)) {
+		for (i = 0; i < num_sensors; i++) {
+			idx         = p_sensor_ids[i] - 1;
+			p_values[i] = (struct hub_energy_sensor_values){
+				.voltage = HUB_INVALID_SENSOR_VALUE,
+				.current = HUB_INVALID_SENSOR_VALUE,
+				.power   = HUB_INVALID_SENSOR_VALUE
+			};
+			if ((idx < HUB_SOM_NUM_SENSORS) &&
+				(sample.energy_valid & (1U << idx))) {
+				p_values[i] = sample.energy[idx];
+				num_sensors_read++;
+			}
+		}
+		return num_sensors_read;
+	}
+
 	/* Get the I2C bus context from HUB handle - explicitly search for I2C bus only */
 	for (i = 0; i < p_hub->num_busses; i++) {
 		if (HUB_GARD_BUS_I2C == p_hub->p_bus_props[i].types) {
@@ -401,3 +507,426 @@ uint32_t hub_get_energy_from_onboard_sensors(
 	hub_mutex_unlock(&p_bus_ctx->bus_mutex);
 	return num_sensors_read;
 }
+
+/**
+ * HUB SENSORS internal function
+ *
+ * Read registers of a sensor in one I2C_RDWR transaction: the bus is held
+ * once and the slave address of the bus is left as it is.
+ *
+ * @param: p_bus is the I2C bus of the sensor
+ * @param: slave_id is the I2C address of the sensor
+ * @param: p_calib is a 3 bytes register write done first, or NULL
+ * @param: p_regs are the registers to read
+ * @param: p_raw is filled with the big-endian 16-bit values of the registers
+ * @param: num_regs is the number of registers, HUB_SOM_MAX_BATCH_REGS at most
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_som_read_regs(struct hub_gard_bus *p_bus,
+							 uint8_t              slave_id,
+							 uint8_t             *p_calib,
+							 const uint8_t       *p_regs,
+							 uint16_t            *p_raw,
+							 uint32_t             num_regs)
+{
+	struct i2c_msg             msgs[1 + 2 * HUB_SOM_MAX_BATCH_REGS];
+	struct i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = 0};
+	uint8_t                    regs[HUB_SOM_MAX_BATCH_REGS];
+	uint8_t                    raw[HUB_SOM_MAX_BATCH_REGS][2];
+	uint32_t                   i;
+	int                        ret;
+
+	if (NULL != p_calib) {
+		msgs[xfer.nmsgs++] = (struct i2c_msg){
+			.addr = slave_id, .flags = 0, .len = 3, .buf = p_calib};
+	}
+
+	/* Register address, then the value after a repeated start */
+	for (i = 0; i < num_regs; i++) {
+		regs[i]            = p_regs[i];
+		msgs[xfer.nmsgs++] = (struct i2c_msg){
+			.addr = slave_id, .flags = 0, .len = 1, .buf = &regs[i]};
+		msgs[xfer.nmsgs++] = (struct i2c_msg){
+			.addr = slave_id, .flags = I2C_M_RD, .len = 2, .buf = raw[i]};
+	}
+
+	hub_mutex_lock(&p_bus->bus_mutex);
+	ret = ioctl(p_bus->i2c.bus_hdl, I2C_RDWR, &xfer);
+	hub_mutex_unlock(&p_bus->bus_mutex);
+
+	if (ret != (int)xfer.nmsgs) {
+		return -1;
+	}
+
+	for (i = 0; i < num_regs; i++) {
+		p_raw[i] = (uint16_t)((raw[i][0] << 8) | raw[i][1]);
+	}
+
+	return 0;
+}
+
+/**
+ * HUB SENSORS internal function
+ *
+ * Read all the SOM sensors into a sample, each sensor in one I2C
+ * transaction.
+ *
+ * @param: p_bus is the I2C bus of the sensors
+ * @param: p_is_calibrated tells, per energy sensor, if its calibration was
+ *         written already; updated on return
+ * @param: p_sample is filled with the sample
+ */
+static void hub_som_read_all(struct hub_gard_bus          *p_bus,
+							 bool                         *p_is_calibrated,
+							 struct hub_som_sensor_sample *p_sample)
+{
+	static const uint8_t temp_regs[]   = {TMP118_REG_TEMP};
+	static const uint8_t energy_regs[] = {INA236_REG_CURRENT,
+										  INA236_REG_BUS_VOLTAGE,
+										  INA236_REG_POWER};
+
+	float                current_lsb = SOM_MAX_CURRENT / INA236_CURRENT_DIV;
+	uint16_t             calibration_value =
+		(uint16_t)(INA236_CURRENT_MULTIPLIER / (current_lsb * SOM_SHUNT_REG));
+	uint8_t              calib_buffer[3];
+	uint16_t             raw[HUB_SOM_MAX_BATCH_REGS];
+	uint8_t              slave_id;
+	uint32_t             i;
+
+	memset(p_sample, 0, sizeof(*p_sample));
+	p_sample->timestamp_ns = hub_stats_now_ns();
+
+	for (i = 0; i < HUB_SOM_NUM_SENSORS; i++) {
+		p_sample->temperature[i] = HUB_INVALID_SENSOR_VALUE;
+		slave_id = hub_get_temperature_sensor_i2c_slave_addr(i + 1);
+		if (0 == hub_som_read_regs(p_bus, slave_id, NULL, temp_regs, raw,
+								   1)) {
+			p_sample->temperature[i] = (float)raw[0] * TMP118_MULTIPLIER;
+			p_sample->temperature_valid |= (uint8_t)(1U << i);
+		}
+
+		p_sample->energy[i] = (struct hub_energy_sensor_values){
+			.voltage = HUB_INVALID_SENSOR_VALUE,
+			.current = HUB_INVALID_SENSOR_VALUE,
+			.power   = HUB_INVALID_SENSOR_VALUE
+		};
+
+		/**
+		 * The calibration sticks in the INA236 until it powers down, so it
+		 * is only written again if a read failed, e.g. after a power cycle.
+		 */
+		calib_buffer[0] = INA236_REG_CALIB;
+		calib_buffer[1] = calibration_value >> 8;
+		calib_buffer[2] = calibration_value & 0xFF;
+
+		slave_id = hub_get_energy_sensor_i2c_slave_addr(i + 1);
+		if (0 != hub_som_read_regs(p_bus, slave_id,
+								   p_is_calibrated[i] ? NULL : calib_buffer,
+								   energy_regs, raw, sizeof(energy_regs))) {
+			p_is_calibrated[i] = false;
+			continue;
+		}
+		p_is_calibrated[i] = true;
+
+		p_sample->energy[i].current = raw[0] * current_lsb;
+		p_sample->energy[i].voltage = raw[1] * INA236_VOLTAGE_MULTIPLIER;
+		p_sample->energy[i].power =
+			raw[2] * INA236_POWER_MULTIPLIER * current_lsb;
+		p_sample->energy_valid |= (uint8_t)(1U << i);
+	}
+}
+
+/**
+ * HUB SENSORS internal function
+ *
+ * Put a sample in the sampler ring, for the readers to copy.
+ *
+ * @param: p_ctx is the sampler context
+ * @param: p_sample is the sample
+ */
+static void hub_som_sampler_publish(struct hub_som_sampler_ctx         *p_ctx,
+									const struct hub_som_sensor_sample *p_sample)
+{
+	uint64_t                     seq    = p_ctx->head_seq + 1;
+	struct hub_som_sampler_slot *p_slot =
+		&p_ctx->slots[seq % HUB_SOM_SAMPLER_DEPTH];
+
+	/* Readers of the sample this slot held see it go before it changes */
+	__atomic_store_n(&p_slot->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy(&p_slot->sample, p_sample, sizeof(*p_sample));
+
+	__atomic_store_n(&p_slot->seq, seq, __ATOMIC_RELEASE);
+	__atomic_store_n(&p_ctx->head_seq, seq, __ATOMIC_RELEASE);
+}
+
+/**
+ * HUB SENSORS internal function
+ *
+ * Sampler thread.
+ *
+ * @param: p_args is the struct hub_som_sampler_ctx
+ *
+ * @return: NULL
+ */
+static void *hub_som_sampler_thread_func(void *p_args)
+{
+	struct hub_som_sampler_ctx  *p_ctx = (struct hub_som_sampler_ctx *)p_args;
+	struct hub_som_sensor_sample sample;
+	struct timespec              deadline;
+	uint64_t                     elapsed_ms;
+	uint32_t                     wait_ms;
+
+	hub_mutex_lock(&p_ctx->lock);
+	while (!p_ctx->terminate_flag) {
+		hub_mutex_unlock(&p_ctx->lock);
+
+		hub_som_read_all(p_ctx->p_bus, p_ctx->is_calibrated, &sample);
+		hub_som_sampler_publish(p_ctx, &sample);
+
+		/* The period runs from the start of a sample to the next */
+		elapsed_ms = (hub_stats_now_ns() - sample.timestamp_ns) / 1000000ULL;
+		wait_ms    = (elapsed_ms < p_ctx->period_ms)
+						 ? (uint32_t)(p_ctx->period_ms - elapsed_ms)
+						 : 0;
+
+		hub_mutex_lock(&p_ctx->lock);
+		if (p_ctx->terminate_flag) {
+			break;
+		}
+		hub_deadline_from_now(&deadline, wait_ms);
+		(void)hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+	}
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return NULL;
+}
+
+/**
+ * hub_som_sampler_start starts the SOM sensor sampler of a HUB, see hub.h.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: period_ms is the time between samples
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SENSOR_ERROR on failure
+ */
+enum hub_ret_code hub_som_sampler_start(hub_handle_t hub, uint32_t period_ms)
+{
+	struct hub_ctx             *p_hub = (struct hub_ctx *)hub;
+	struct hub_som_sampler_ctx *p_ctx;
+	struct hub_gard_bus        *p_bus = NULL;
+	uint32_t                    i;
+
+	if (NULL == p_hub) {
+		hub_pr_err("Invalid HUB handle\n");
+		goto err_som_sampler_start_1;
+	}
+
+	if (period_ms < HUB_SOM_SAMPLER_MIN_PERIOD_MS) {
+		hub_pr_err("Sampler period %u ms is below %u ms\n", period_ms,
+				   HUB_SOM_SAMPLER_MIN_PERIOD_MS);
+		goto err_som_sampler_start_1;
+	}
+
+	if (NULL != p_hub->p_som_sampler_ctx) {
+		hub_pr_err("SOM sensor sampler already runs\n");
+		goto err_som_sampler_start_1;
+	}
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		if (HUB_GARD_BUS_I2C == p_hub->p_bus_props[i].types) {
+			p_bus = &p_hub->p_bus_props[i];
+			break;
+		}
+	}
+
+	if ((NULL == p_bus) || (p_bus->i2c.bus_hdl < 0) || !p_bus->i2c.is_open) {
+		hub_pr_err("No open I2C bus for the SOM sensors\n");
+		goto err_som_sampler_start_1;
+	}
+
+	p_ctx = (struct hub_som_sampler_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate SOM sensor sampler context\n");
+		goto err_som_sampler_start_1;
+	}
+
+	p_ctx->p_hub     = p_hub;
+	p_ctx->p_bus     = p_bus;
+	p_ctx->period_ms = period_ms;
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ctx->lock)) {
+		goto err_som_sampler_start_2;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ctx->cond_var)) {
+		goto err_som_sampler_start_3;
+	}
+
+	/* Published first, the thread is the only writer of the ring */
+	__atomic_store_n(&p_hub->p_som_sampler_ctx, p_ctx, __ATOMIC_RELEASE);
+
+	if (HUB_SUCCESS != hub_thread_create(&p_ctx->thread_hdl, NULL,
+										 HUB_THREAD_CLASS_BUS_IO,
+										 "hub_som_sampler",
+										 hub_som_sampler_thread_func,
+										 p_ctx)) {
+		hub_pr_err("Failed to create SOM sensor sampler thread\n");
+		goto err_som_sampler_start_4;
+	}
+
+	return HUB_SUCCESS;
+
+err_som_sampler_start_4:
+	__atomic_store_n(&p_hub->p_som_sampler_ctx, NULL, __ATOMIC_RELEASE);
+	hub_cond_var_destroy(&p_ctx->cond_var);
+err_som_sampler_start_3:
+	hub_mutex_destroy(&p_ctx->lock);
+err_som_sampler_start_2:
+	free(p_ctx);
+err_som_sampler_start_1:
+	return HUB_FAILURE_SENSOR_ERROR;
+}
+
+/**
+ * hub_som_sampler_stop stops the SOM sensor sampler of a HUB, if running.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SENSOR_ERROR on an invalid handle
+ */
+enum hub_ret_code hub_som_sampler_stop(hub_handle_t hub)
+{
+	struct hub_ctx             *p_hub = (struct hub_ctx *)hub;
+	struct hub_som_sampler_ctx *p_ctx;
+
+	if (NULL == p_hub) {
+		hub_pr_err("Invalid HUB handle\n");
+		return HUB_FAILURE_SENSOR_ERROR;
+	}
+
+	p_ctx = __atomic_exchange_n(&p_hub->p_som_sampler_ctx, NULL,
+								__ATOMIC_ACQ_REL);
+	if (NULL == p_ctx) {
+		return HUB_SUCCESS;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+	p_ctx->terminate_flag = true;
+	hub_cond_var_signal(&p_ctx->cond_var);
+	hub_mutex_unlock(&p_ctx->lock);
+
+	hub_thread_join(p_ctx->thread_hdl, NULL);
+
+	hub_cond_var_destroy(&p_ctx->cond_var);
+	hub_mutex_destroy(&p_ctx->lock);
+	free(p_ctx);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_get_som_sensor_history copies the latest samples of the SOM sensor
+ * sampler, oldest first.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_samples is filled with the samples
+ * @param: max_samples is the most samples to copy
+ *
+ * @return: number of samples copied
+ */
+uint32_t hub_get_som_sensor_history(hub_handle_t                  hub,
+									struct hub_som_sensor_sample *p_samples,
+									uint32_t                      max_samples)
+{
+	struct hub_ctx             *p_hub = (struct hub_ctx *)hub;
+	struct hub_som_sampler_ctx *p_ctx;
+	uint64_t                    head, seq, num;
+	uint32_t                    num_copied = 0;
+
+	if ((NULL == p_hub) || (NULL == p_samples)) {
+		hub_pr_err("Invalid arguments\n");
+		return 0;
+	}
+
+	p_ctx = __atomic_load_n(&p_hub->p_som_sampler_ctx, __ATOMIC_ACQUIRE);
+	if (NULL == p_ctx) {
+		return 0;
+	}
+
+	head = __atomic_load_n(&p_ctx->head_seq, __ATOMIC_ACQUIRE);
+	num  = head;
+	if (num > HUB_SOM_SAMPLER_DEPTH) {
+		num = HUB_SOM_SAMPLER_DEPTH;
+	}
+	if (num > max_samples) {
+		num = max_samples;
+	}
+
+	/* The oldest ones may be overwritten while copying, they are skipped */
+	for (seq = head - num + 1; seq <= head; seq++) {
+		if (hub_som_sampler_copy(p_ctx, seq, &p_samples[num_copied])) {
+			num_copied++;
+		}
+	}
+
+	return num_copied;
+}
+
+/**
+ * hub_get_som_telemetry reads all the SOM sensors at once, see hub.h.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_sample is filled with the sample
+ *
+ * @return: HUB_SUCCESS if at least one sensor was read
+ *			HUB_FAILURE_SENSOR_ERROR otherwise
+ */
+enum hub_ret_code hub_get_som_telemetry(hub_handle_t                  hub,
+										struct hub_som_sensor_sample *p_sample)
+{
+	struct hub_ctx      *p_hub = (struct hub_ctx *)hub;
+	struct hub_gard_bus *p_bus = NULL;
+	bool                 is_calibrated[HUB_SOM_NUM_SENSORS] = {false};
+	uint32_t             i;
+
+	if ((NULL == p_hub) || (NULL == p_sample)) {
+		hub_pr_err("Invalid arguments\n");
+		goto err_get_som_telemetry_1;
+	}
+
+	/* Served by the sampler without going on the bus, if it runs */
+	if (hub_som_sampler_latest(p_hub, p_sample)) {
+		return HUB_SUCCESS;
+	}
+
+	for (i = 0; i < p_hub->num_busses; i++) {
+		if (HUB_GARD_BUS_I2C == p_hub->p_bus_props[i].types) {
+			p_bus = &p_hub->p_bus_props[i];
+			break;
+		}
+	}
+
+	if ((NULL == p_bus) || (p_bus->i2c.bus_hdl < 0) || !p_bus->i2c.is_open) {
+		hub_pr_err("No open I2C bus for the SOM sensors\n");
+		goto err_get_som_telemetry_1;
+	}
+
+	/* Not knowing if the INA236 were powered down, they are calibrated */
+	hub_som_read_all(p_bus, is_calibrated, p_sample);
+
+	if ((0 == p_sample->temperature_valid) && (0 == p_sample->energy_valid)) {
+		hub_pr_err("Failed to read the SOM sensors\n");
+		goto err_get_som_telemetry_1;
+	}
+
+	return HUB_SUCCESS;
+
+err_get_som_telemetry_1:
+	return HUB_FAILURE_SENSOR_ERROR;
+}
@@ -8,12 +8,14 @@
 #ifndef __HUB_SENSORS_H__
 #define __HUB_SENSORS_H__
 
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <sys/ioctl.h>
 
 #include "hub.h"
 #include "hub_globals.h"
 #include "gard_info.h"
+#include "hub_threading.h"
 
 /* TBD-DPN: To handle 'invalid' sensor values if possible */
 /* Please refer the variable of the same name in hub.py, They need to be in sync. */
@@ -74,4 +76,42 @@
 #define INA236_VOLTAGE_MULTIPLIER        (0.00160f)
 #define INA236_POWER_MULTIPLIER          (32.0f)
 
+/**
+ * Background sampler, see hub_som_sampler_start().
+ *
+ * Samples are kept in a ring of HUB_SOM_SAMPLER_DEPTH slots. The sampler
+ * thread is the only writer; readers copy a slot and check its seq did not
+ * change meanwhile, so they never wait for the bus or the sampler.
+ */
+#define HUB_SOM_SAMPLER_DEPTH            (256)
+#define HUB_SOM_SAMPLER_MIN_PERIOD_MS    (10)
+
+/* Copies of the latest sample tried before a reader gives up */
+#define HUB_SOM_SAMPLER_READ_TRIES       (4)
+
+/* Registers read from a sensor in one I2C_RDWR transaction, at most */
+#define HUB_SOM_MAX_BATCH_REGS           (3)
+
+struct hub_som_sampler_slot {
+	uint64_t                     seq; /* 0 while being written */
+	struct hub_som_sensor_sample sample;
+};
+
+struct hub_som_sampler_ctx {
+	struct hub_ctx             *p_hub;
+	struct hub_gard_bus        *p_bus; /* I2C bus of the sensors */
+	uint32_t                    period_ms;
+
+	/* INA236 calibration is written again after a failed read */
+	bool                        is_calibrated[HUB_SOM_NUM_SENSORS];
+
+	uint64_t                    head_seq; /* Latest sample, 0: none yet */
+	struct hub_som_sampler_slot slots[HUB_SOM_SAMPLER_DEPTH];
+
+	hub_mutex_t                 lock;
+	hub_cond_var_t              cond_var;
+	bool                        terminate_flag;
+	hub_thread_hdl_t            thread_hdl;
+};
+
 #endif /* __HUB_SENSORS_H__ */
\ No newline at end of file
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Per-GARD operation statistics.
+ *
+ * Every counter is a uint64_t of struct hub_gard_stats inside the GARD's
+ * hub_gard_info, updated with relaxed atomic operations: register accesses,
+ * data transfers and GPIO workers of the same GARD run on different threads,
+ * and taking a lock around each update would itself show up in the
+ * latencies being measured. A snapshot is therefore consistent per counter,
+ * not across counters.
+ */
+
+#include <time.h>
+
+#include "hub_stats.h"
+
+static const char *hub_stats_op_names[HUB_STATS_OP_MAX] = {
+	[HUB_STATS_OP_READ_REG]      = "read_reg",
+	[HUB_STATS_OP_WRITE_REG]     = "write_reg",
+	[HUB_STATS_OP_SEND_DATA]     = "send_data",
+	[HUB_STATS_OP_RECV_DATA]     = "recv_data",
+	[HUB_STATS_OP_RECV_APP_DATA] = "recv_app_data",
+	[HUB_STATS_OP_APPDATA_CB]    = "appdata_cb",
+};
+
+/**
+ * Find the latency histogram bucket of a latency.
+ *
+ * @param: latency_ns is the latency in nanoseconds
+ *
+ * @return: bucket index, see HUB_STATS_LATENCY_SUB_BUCKETS
+ */
+static uint32_t hub_stats_bucket_of(uint64_t latency_ns)
+{
+	uint64_t latency_us = latency_ns / 1000;
+	uint32_t msb, sub, bucket;
+
+	if (latency_us < HUB_STATS_LATENCY_SUB_BUCKETS) {
+		return (uint32_t)latency_us;
+	}
+
+	/* Position of the top bit, and the bits right below it */
+	msb    = 63 - __builtin_clzll(latency_us);
+	sub    = (latency_us >> (msb - HUB_STATS_SUB_BUCKET_BITS)) &
+		  (HUB_STATS_LATENCY_SUB_BUCKETS - 1);
+	bucket = (HUB_STATS_LATENCY_SUB_BUCKETS *
+			  (msb - HUB_STATS_SUB_BUCKET_BITS + 1)) +
+			 sub;
+
+	return hub_min_uint32(bucket, HUB_STATS_LATENCY_BUCKETS - 1);
+}
+
+/**
+ * hub_stats_bucket_floor_us gives the lowest latency, in microseconds,
+ * counted by a latency histogram bucket.
+ *
+ * @param: bucket is the bucket index
+ *
+ * @return: lowest latency of the bucket in microseconds
+ */
+uint64_t hub_stats_bucket_floor_us(uint32_t bucket)
+{
+	if (bucket < HUB_STATS_LATENCY_SUB_BUCKETS) {
+		return bucket;
+	}
+
+	return (uint64_t)(HUB_STATS_LATENCY_SUB_BUCKETS +
+					  (bucket % HUB_STATS_LATENCY_SUB_BUCKETS))
+		   << ((bucket / HUB_STATS_LATENCY_SUB_BUCKETS) - 1);
+}
+
+/**
+ * hub_stats_op_name gives a short name of a statistics operation.
+ *
+ * @param: op is the operation
+ *
+ * @return: name of the operation, NULL if op is invalid
+ */
+const char *hub_stats_op_name(enum hub_stats_op op)
+{
+	if ((op < 0) || (op >= HUB_STATS_OP_MAX)) {
+		return NULL;
+	}
+
+	return hub_stats_op_names[op];
+}
+
+/**
+ * Current CLOCK_MONOTONIC time in nanoseconds.
+ *
+ * @return: time in nanoseconds
+ */
+uint64_t hub_stats_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Account one operation on a GARD.
+ *
+ * @param: p_gard is the GARD the operation was made on
+ * @param: op is the operation
+ * @param: start_ns is hub_stats_now_ns() when the operation started
+ * @param: bytes is the payload size, only counted if the operation succeeded
+ * @param: failed tells whether the operation failed
+ */
+void hub_stats_record(struct hub_gard_info *p_gard,
+					  enum hub_stats_op     op,
+					  uint64_t              start_ns,
+					  uint64_t              bytes,
+					  bool                  failed)
+{
+	struct hub_op_stats *p_op_stats = &p_gard->stats.ops[op];
+	uint64_t             latency_ns = hub_stats_now_ns() - start_ns;
+	uint64_t             max_ns;
+
+	__atomic_add_fetch(&p_op_stats->transactions, 1, __ATOMIC_RELAXED);
+	if (failed) {
+		__atomic_add_fetch(&p_op_stats->errors, 1, __ATOMIC_RELAXED);
+	} else {
+		__atomic_add_fetch(&p_op_stats->bytes, bytes, __ATOMIC_RELAXED);
+	}
+
+	__atomic_add_fetch(&p_op_stats->latency_total_ns, latency_ns,
+					   __ATOMIC_RELAXED);
+	__atomic_add_fetch(&p_op_stats->latency_hist[hub_stats_bucket_of(
+						   latency_ns)],
+					   1, __ATOMIC_RELAXED);
+
+	max_ns = __atomic_load_n(&p_op_stats->latency_max_ns, __ATOMIC_RELAXED);
+	while ((latency_ns > max_ns) &&
+		   !__atomic_compare_exchange_n(&p_op_stats->latency_max_ns, &max_ns,
+										latency_ns, true, __ATOMIC_RELAXED,
+										__ATOMIC_RELAXED)) {
+	}
+}
+
+/**
+ * hub_get_stats gets a snapshot of the statistics HUB keeps for a GARD.
+ *
+ * @param: gard is the GARD handle
+ * @param: p_stats is filled with the statistics
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_STATS on failure
+ */
+enum hub_ret_code hub_get_stats(gard_handle_t          gard,
+								struct hub_gard_stats *p_stats)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_op_stats  *p_src, *p_dst;
+	uint32_t              op, bucket;
+
+	if ((NULL == p_gard) || (NULL == p_stats)) {
+		hub_pr_err("Invalid arguments for hub_get_stats\n");
+		return HUB_FAILURE_STATS;
+	}
+
+	p_stats->control_bus = p_gard->control_bus ? p_gard->control_bus->types
+											   : HUB_GARD_BUS_UNKNOWN;
+	p_stats->data_bus    = p_gard->data_bus ? p_gard->data_bus->types
+											: HUB_GARD_BUS_UNKNOWN;
+
+	for (op = 0; op < HUB_STATS_OP_MAX; op++) {
+		p_src = &p_gard->stats.ops[op];
+		p_dst = &p_stats->ops[op];
+
+		p_dst->transactions =
+			__atomic_load_n(&p_src->transactions, __ATOMIC_RELAXED);
+		p_dst->errors = __atomic_load_n(&p_src->errors, __ATOMIC_RELAXED);
+		p_dst->bytes  = __atomic_load_n(&p_src->bytes, __ATOMIC_RELAXED);
+		p_dst->latency_total_ns =
+			__atomic_load_n(&p_src->latency_total_ns, __ATOMIC_RELAXED);
+		p_dst->latency_max_ns =
+			__atomic_load_n(&p_src->latency_max_ns, __ATOMIC_RELAXED);
+
+		for (bucket = 0; bucket < HUB_STATS_LATENCY_BUCKETS; bucket++) {
+			p_dst->latency_hist[bucket] = __atomic_load_n(
+				&p_src->latency_hist[bucket], __ATOMIC_RELAXED);
+		}
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_reset_stats clears the statistics HUB keeps for a GARD.
+ *
+ * Operations in flight while resetting may be accounted partly before and
+ * partly after the reset.
+ *
+ * @param: gard is the GARD handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_STATS on failure
+ */
+enum hub_ret_code hub_reset_stats(gard_handle_t gard)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+	struct hub_op_stats  *p_op_stats;
+	uint32_t              op, bucket;
+
+	if (NULL == p_gard) {
+		hub_pr_err("Invalid arguments for hub_reset_stats\n");
+		return HUB_FAILURE_STATS;
+	}
+
+	for (op = 0; op < HUB_STATS_OP_MAX; op++) {
+		p_op_stats = &p_gard->stats.ops[op];
+
+		__atomic_store_n(&p_op_stats->transactions, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&p_op_stats->errors, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&p_op_stats->bytes, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&p_op_stats->latency_total_ns, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&p_op_stats->latency_max_ns, 0, __ATOMIC_RELAXED);
+
+		for (bucket = 0; bucket < HUB_STATS_LATENCY_BUCKETS; bucket++) {
+			__atomic_store_n(&p_op_stats->latency_hist[bucket], 0,
+							 __ATOMIC_RELAXED);
+		}
+	}
+
+	return HUB_SUCCESS;
+}
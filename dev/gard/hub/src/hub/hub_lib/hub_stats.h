@@ -0,0 +1,33 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_STATS_H__
+#define __HUB_STATS_H__
+
+#include "hub.h"
+#include "gard_info.h"
+
+/* log2 of HUB_STATS_LATENCY_SUB_BUCKETS */
+#define HUB_STATS_SUB_BUCKET_BITS (2)
+
+/**
+ * Current CLOCK_MONOTONIC time in nanoseconds, used as the start time of an
+ * operation passed to hub_stats_record().
+ */
+uint64_t hub_stats_now_ns(void);
+
+/**
+ * Account one operation on a GARD that started at start_ns. Safe to call
+ * from any thread: the counters are updated with atomic operations.
+ */
+void hub_stats_record(struct hub_gard_info *p_gard,
+					  enum hub_stats_op     op,
+					  uint64_t              start_ns,
+					  uint64_t              bytes,
+					  bool                  failed);
+
+#endif /* __HUB_STATS_H__ */
@@ -0,0 +1,439 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * App Module data subscription.
+ *
+ * Once subscribed with SUBSCRIBE_APP_DATA, GARD pushes each App Module result
+ * on the bus as soon as it is ready instead of raising the GPIO line and
+ * waiting to be asked for it, which saves a RECV_DATA_FROM_GARD_AT_OFFSET
+ * round-trip per result. GARD pushes only between two commands (see
+ * struct _app_data_push_header), so pushes never split a response.
+ *
+ * Only UART can carry pushes: an I2C GARD is a slave and cannot send on its
+ * own, and USB data goes through the blob ops.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "hub_subscribe.h"
+#include "hub_recorder.h"
+#include "hub_shm_ring.h"
+#include "hub_health.h"
+
+/**
+ * Keeps a subscription from going away while the health monitor sets it up
+ * on a re-attached GARD, see hub_subscribe_rearm().
+ */
+static hub_mutex_t hub_subscribe_mutex = HUB_MUTEX_INITIALIZER;
+
+/**
+ * Push sink: give the tail slot for a push of size bytes.
+ *
+ * @param: p_ctx is the struct hub_subscribe_ctx
+ * @param: size is the size of the pushed data
+ *
+ * @return: buffer of the tail slot, NULL to drop the push
+ */
+static uint8_t *hub_subscribe_get_buffer(void *p_ctx, uint32_t size)
+{
+	struct hub_subscribe_ctx *p_sub = (struct hub_subscribe_ctx *)p_ctx;
+	uint8_t                  *p_buf = NULL;
+
+	/* Only the bus holder fills slots, so the tail stays free until put */
+	hub_mutex_lock(&p_sub->queue_mutex);
+	if ((size <= p_sub->size) && (p_sub->count < HUB_SUBSCRIBE_QUEUE_DEPTH)) {
+		p_buf = p_sub->slots[(p_sub->head + p_sub->count) %
+							 HUB_SUBSCRIBE_QUEUE_DEPTH]
+					.p_data;
+	} else {
+		p_sub->num_dropped++;
+	}
+	hub_mutex_unlock(&p_sub->queue_mutex);
+
+	return p_buf;
+}
+
+/**
+ * Push sink: queue the tail slot once filled.
+ *
+ * @param: p_ctx is the struct hub_subscribe_ctx
+ * @param: p_buf is the buffer given by hub_subscribe_get_buffer()
+ * @param: seq_num is the sequence number of the push
+ * @param: size is the size of the pushed data
+ * @param: is_valid is false if the push came in damaged
+ */
+static void hub_subscribe_put_buffer(void    *p_ctx,
+									 uint8_t *p_buf,
+									 uint32_t seq_num,
+									 uint32_t size,
+									 bool     is_valid)
+{
+	struct hub_subscribe_ctx  *p_sub = (struct hub_subscribe_ctx *)p_ctx;
+	struct hub_subscribe_slot *p_slot;
+
+	(void)p_buf;
+
+	hub_mutex_lock(&p_sub->queue_mutex);
+	if (!is_valid) {
+		p_sub->num_dropped++;
+	} else {
+		if (seq_num != p_sub->next_seq_num) {
+			p_sub->num_missed += seq_num - p_sub->next_seq_num;
+		}
+		p_sub->next_seq_num = seq_num + 1;
+
+		p_slot          = &p_sub->slots[(p_sub->head + p_sub->count) %
+										HUB_SUBSCRIBE_QUEUE_DEPTH];
+		p_slot->seq_num = seq_num;
+		p_slot->size    = size;
+		p_sub->count++;
+	}
+	hub_mutex_unlock(&p_sub->queue_mutex);
+}
+
+/**
+ * Send SUBSCRIBE_APP_DATA to GARD on its command bus, which the caller holds.
+ *
+ * @param: p_sub is the subscription
+ * @param: enable is true to subscribe, false to unsubscribe
+ *
+ * @return: HUB_SUCCESS if GARD ACKed
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+static enum hub_ret_code
+	hub_send_subscribe_app_data(struct hub_subscribe_ctx *p_sub, bool enable)
+{
+	struct hub_gard_bus   *p_bus = p_sub->gard->cmd_bus;
+	ssize_t                nread, nwrite;
+	struct iovec           iov[2];
+
+	struct _host_requests  subscribe_cmd      = {0};
+	struct _host_responses subscribe_response = {0};
+
+	subscribe_cmd.command_id                        = SUBSCRIBE_APP_DATA;
+	subscribe_cmd.subscribe_app_data_request.enable = enable ? 1 : 0;
+	subscribe_cmd.subscribe_app_data_request.end_of_data_marker =
+		END_OF_DATA_MARKER;
+
+	iov[0].iov_base = &subscribe_cmd.command_id;
+	iov[0].iov_len  = sizeof(subscribe_cmd.command_id);
+	iov[1].iov_base = &subscribe_cmd.command_body;
+	iov[1].iov_len  = sizeof(subscribe_cmd.subscribe_app_data_request);
+
+	nwrite          = p_bus->fops.device_writev(p_bus->uart.bus_hdl, iov, 2);
+	if (hub_iov_len(iov, 2) != nwrite) {
+		hub_pr_err("Error sending subscribe_app_data request\n");
+		return HUB_FAILURE_SUBSCRIBE_APPDATA;
+	}
+
+	nread = p_bus->fops.device_read(
+		p_bus->uart.bus_hdl, &subscribe_response.subscribe_app_data_response,
+		sizeof(subscribe_response.subscribe_app_data_response));
+	if (sizeof(subscribe_response.subscribe_app_data_response) != nread) {
+		hub_pr_err("Error receiving subscribe_app_data response\n");
+		return HUB_FAILURE_SUBSCRIBE_APPDATA;
+	}
+
+	if (ACK_BYTE != subscribe_response.subscribe_app_data_response.ack_or_nak) {
+		hub_pr_err("GARD NAKed subscribe_app_data\n");
+		return HUB_FAILURE_SUBSCRIBE_APPDATA;
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Give the queued pushes to the user callback, oldest first.
+ *
+ * @param: p_sub is the subscription
+ */
+static void hub_subscribe_deliver(struct hub_subscribe_ctx *p_sub)
+{
+	struct hub_subscribe_slot *p_slot;
+	uint32_t                   size;
+
+	while (1) {
+		hub_mutex_lock(&p_sub->queue_mutex);
+		if (0 == p_sub->count) {
+			hub_mutex_unlock(&p_sub->queue_mutex);
+			break;
+		}
+
+		/* The user buffer is only ever written here */
+		p_slot = &p_sub->slots[p_sub->head];
+		size   = p_slot->size;
+		memcpy(p_sub->p_buffer, p_slot->p_data, size);
+
+		p_sub->head = (p_sub->head + 1) % HUB_SUBSCRIBE_QUEUE_DEPTH;
+		p_sub->count--;
+		hub_mutex_unlock(&p_sub->queue_mutex);
+
+		hub_shm_ring_publish_appdata(p_sub->gard, p_sub->p_buffer, size);
+		hub_recorder_write_appdata(p_sub->gard, p_sub->p_buffer, size);
+		p_sub->cb_handler(p_sub->p_cb_ctx, p_sub->p_buffer, size);
+	}
+}
+
+/**
+ * Push reader of a subscription.
+ *
+ * Sleeps until bytes come in, reads the pushes among them once it gets the
+ * bus, and calls the user callback for every queued push. A bus error does
+ * not end it, the GARD may come back, see hub_health.c. Pushes read by a
+ * command come in on the same bytes, so they are delivered on that same
+ * wake-up, once the command gives the bus back.
+ *
+ * The bus is taken like a data transfer, not with hub_bus_lock_ctrl(), so
+ * that chunked transfers do not stop for it: pushes between two chunks are
+ * read by the next chunk anyway.
+ *
+ * @param: p_args is the struct hub_subscribe_ctx
+ *
+ * @return: NULL
+ */
+static void *hub_subscribe_reader_thread(void *p_args)
+{
+	struct hub_subscribe_ctx *p_sub = (struct hub_subscribe_ctx *)p_args;
+	struct hub_gard_bus      *p_bus = p_sub->gard->cmd_bus;
+	int32_t                   ret;
+
+	while (!p_sub->terminate_flag) {
+		ret = hub_uart_device_wait_rx(p_bus->uart.bus_hdl,
+									  HUB_SUBSCRIBE_POLL_MS);
+		if (ret < 0) {
+			/* The bus may be re-attached by the health monitor */
+			usleep(HUB_SUBSCRIBE_POLL_MS * 1000);
+			continue;
+		}
+
+		if (ret > 0) {
+			/* TBD-SSP: handle locking failures */
+			hub_mutex_lock(&p_bus->bus_mutex);
+			(void)hub_uart_device_drain_pushes(p_bus->uart.bus_hdl);
+			hub_mutex_unlock(&p_bus->bus_mutex);
+		}
+
+		hub_subscribe_deliver(p_sub);
+	}
+
+	return NULL;
+}
+
+/**
+ * Release a subscription whose reader is not running.
+ *
+ * @param: p_sub is the subscription
+ * @param: num_slots is the number of slot buffers allocated
+ */
+static void hub_subscribe_free(struct hub_subscribe_ctx *p_sub,
+							   uint32_t                  num_slots)
+{
+	uint32_t i;
+
+	for (i = 0; i < num_slots; i++) {
+		free(p_sub->slots[i].p_data);
+	}
+
+	free(p_sub);
+}
+
+/**
+ * hub_subscribe_appdata subscribes to the App Module data of a GARD.
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: cb_handler is called with every result GARD pushes
+ * @param: p_cb_ctx is an opaque callback context
+ * @param: p_buffer is a user-allocated buffer the results are copied into
+ * @param: size is the size of p_buffer, results larger than it are dropped
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+enum hub_ret_code hub_subscribe_appdata(gard_handle_t    gard,
+										hub_cb_handler_t cb_handler,
+										void            *p_cb_ctx,
+										void            *p_buffer,
+										uint32_t         size)
+{
+	struct hub_gard_info     *p_gard = (struct hub_gard_info *)gard;
+	struct hub_subscribe_ctx *p_sub;
+	struct hub_gard_bus      *p_bus;
+	uint32_t                  num_slots;
+	enum hub_ret_code         ret;
+
+	if ((NULL == p_gard) || (NULL == cb_handler) || (NULL == p_buffer) ||
+		(0 == size)) {
+		hub_pr_err("Invalid arguments for hub_subscribe_appdata\n");
+		goto hub_subscribe_appdata_err_1;
+	}
+
+	if (NULL != p_gard->p_subscribe_ctx) {
+		hub_pr_err("GARD %u app data is already subscribed\n",
+				   p_gard->gard_index);
+		goto hub_subscribe_appdata_err_1;
+	}
+
+	p_bus = p_gard->cmd_bus;
+	if (HUB_GARD_BUS_UART != p_bus->types) {
+		hub_pr_err("%s: Bus not supported for app data subscription!\n",
+				   hub_gard_bus_strings[p_bus->types]);
+		goto hub_subscribe_appdata_err_1;
+	}
+
+	p_sub = (struct hub_subscribe_ctx *)calloc(1, sizeof(*p_sub));
+	if (NULL == p_sub) {
+		hub_pr_err("Failed to allocate app data subscription\n");
+		goto hub_subscribe_appdata_err_1;
+	}
+
+	for (num_slots = 0; num_slots < HUB_SUBSCRIBE_QUEUE_DEPTH; num_slots++) {
+		p_sub->slots[num_slots].p_data = (uint8_t *)malloc(size);
+		if (NULL == p_sub->slots[num_slots].p_data) {
+			hub_pr_err("Failed to allocate %u bytes push slot\n", size);
+			goto hub_subscribe_appdata_err_2;
+		}
+	}
+
+	p_sub->gard             = p_gard;
+	p_sub->cb_handler       = cb_handler;
+	p_sub->p_cb_ctx         = p_cb_ctx;
+	p_sub->p_buffer         = p_buffer;
+	p_sub->size             = size;
+	p_sub->sink.p_ctx       = p_sub;
+	p_sub->sink.get_buffer  = hub_subscribe_get_buffer;
+	p_sub->sink.put_buffer  = hub_subscribe_put_buffer;
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_sub->queue_mutex)) {
+		hub_pr_err("Failed to initialize queue_mutex\n");
+		goto hub_subscribe_appdata_err_2;
+	}
+
+	/**
+	 * The sink must be in place before GARD may push. Pushes that come in
+	 * before the reader is up wait on the bus.
+	 */
+	hub_bus_lock_ctrl(p_bus);
+	if (0 != hub_uart_set_push_sink(&p_sub->sink)) {
+		goto hub_subscribe_appdata_err_3;
+	}
+	ret = hub_send_subscribe_app_data(p_sub, true);
+	if (HUB_SUCCESS != ret) {
+		goto hub_subscribe_appdata_err_4;
+	}
+	hub_bus_unlock_ctrl(p_bus);
+
+	if (HUB_SUCCESS != hub_thread_create(&p_sub->reader_thread, NULL,
+										 HUB_THREAD_CLASS_BUS_IO,
+										 "hub_subscribe",
+										 hub_subscribe_reader_thread, p_sub)) {
+		hub_pr_err("Error starting app data push reader\n");
+		hub_bus_lock_ctrl(p_bus);
+		(void)hub_send_subscribe_app_data(p_sub, false);
+		goto hub_subscribe_appdata_err_4;
+	}
+
+	hub_mutex_lock(&hub_subscribe_mutex);
+	p_gard->p_subscribe_ctx = p_sub;
+	hub_mutex_unlock(&hub_subscribe_mutex);
+
+	return HUB_SUCCESS;
+
+hub_subscribe_appdata_err_4:
+	hub_uart_clear_push_sink(&p_sub->sink);
+hub_subscribe_appdata_err_3:
+	hub_bus_unlock_ctrl(p_bus);
+
+	(void)hub_mutex_destroy(&p_sub->queue_mutex);
+hub_subscribe_appdata_err_2:
+	hub_subscribe_free(p_sub, num_slots);
+hub_subscribe_appdata_err_1:
+	return HUB_FAILURE_SUBSCRIBE_APPDATA;
+}
+
+/**
+ * hub_unsubscribe_appdata ends the App Module data subscription of a GARD.
+ * Results not yet given to the callback are dropped.
+ *
+ * The subscription is torn down even if GARD cannot be told, so that HUB
+ * can always be shut down.
+ *
+ * @param: gard is the GARD handle the subscription was made on
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+enum hub_ret_code hub_unsubscribe_appdata(gard_handle_t gard)
+{
+	struct hub_gard_info     *p_gard = (struct hub_gard_info *)gard;
+	struct hub_subscribe_ctx *p_sub;
+	enum hub_ret_code         ret;
+
+	if (NULL == p_gard) {
+		hub_pr_err("GARD app data is not subscribed\n");
+		return HUB_FAILURE_SUBSCRIBE_APPDATA;
+	}
+
+	hub_mutex_lock(&hub_subscribe_mutex);
+	p_sub = p_gard->p_subscribe_ctx;
+	p_gard->p_subscribe_ctx = NULL;
+	hub_mutex_unlock(&hub_subscribe_mutex);
+
+	if (NULL == p_sub) {
+		hub_pr_err("GARD app data is not subscribed\n");
+		return HUB_FAILURE_SUBSCRIBE_APPDATA;
+	}
+
+	p_sub->terminate_flag = true;
+	(void)hub_thread_join(p_sub->reader_thread, NULL);
+
+	/* Pushes ahead of the response still go to the sink, and are dropped */
+	hub_bus_lock_ctrl(p_gard->cmd_bus);
+	ret = hub_send_subscribe_app_data(p_sub, false);
+	hub_uart_clear_push_sink(&p_sub->sink);
+	hub_bus_unlock_ctrl(p_gard->cmd_bus);
+
+	if (p_sub->num_dropped || p_sub->num_missed) {
+		hub_pr_warn("GARD %u app data: %llu pushes dropped, %llu missed\n",
+					p_gard->gard_index,
+					(unsigned long long)p_sub->num_dropped,
+					(unsigned long long)p_sub->num_missed);
+	}
+
+	(void)hub_mutex_destroy(&p_sub->queue_mutex);
+	hub_subscribe_free(p_sub, HUB_SUBSCRIBE_QUEUE_DEPTH);
+
+	return ret;
+}
+
+/**
+ * hub_subscribe_rearm subscribes a re-attached GARD to its App Module data
+ * again: GARD forgets the subscription when it resets, while the HUB side of
+ * it, callback and reader, is kept throughout.
+ *
+ * @param: p_gard is the GARD
+ *
+ * @return: HUB_SUCCESS on success or if no longer subscribed
+ *			HUB_FAILURE_SUBSCRIBE_APPDATA on failure
+ */
+enum hub_ret_code hub_subscribe_rearm(struct hub_gard_info *p_gard)
+{
+	struct hub_subscribe_ctx *p_sub;
+	enum hub_ret_code         ret = HUB_SUCCESS;
+
+	hub_mutex_lock(&hub_subscribe_mutex);
+	p_sub = p_gard->p_subscribe_ctx;
+	if (NULL != p_sub) {
+		hub_bus_lock_ctrl(p_gard->cmd_bus);
+		ret = hub_send_subscribe_app_data(p_sub, true);
+		hub_bus_unlock_ctrl(p_gard->cmd_bus);
+	}
+	hub_mutex_unlock(&hub_subscribe_mutex);
+
+	return ret;
+}
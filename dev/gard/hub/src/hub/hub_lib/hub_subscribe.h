@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_SUBSCRIBE_H__
+#define __HUB_SUBSCRIBE_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_globals.h"
+#include "hub_threading.h"
+#include "hub_uart.h"
+
+/**
+ * Pushes read but not yet given to the user callback. A push that finds the
+ * queue full is dropped.
+ */
+#define HUB_SUBSCRIBE_QUEUE_DEPTH (4)
+
+/**
+ * Longest time the push reader sleeps without bytes coming in, which bounds
+ * how long hub_unsubscribe_appdata() waits for it.
+ */
+#define HUB_SUBSCRIBE_POLL_MS (50)
+
+/* One push read off the bus */
+struct hub_subscribe_slot {
+	uint8_t *p_data;
+	uint32_t seq_num;
+	uint32_t size;
+};
+
+/**
+ * App Module data subscription of a GARD.
+ *
+ * Pushes are read by whichever thread holds the bus: a command that finds
+ * them ahead of its response, or the push reader when the bus is idle. Both
+ * queue them in slots, and the push reader alone calls the user callback,
+ * without the bus. Slots and counters are under queue_mutex.
+ */
+struct hub_subscribe_ctx {
+	struct hub_gard_info     *gard;
+	hub_cb_handler_t          cb_handler;
+	void                     *p_cb_ctx;
+	void                     *p_buffer;
+	uint32_t                  size;
+
+	struct hub_uart_push_sink sink;
+	hub_mutex_t               queue_mutex;
+	struct hub_subscribe_slot slots[HUB_SUBSCRIBE_QUEUE_DEPTH];
+	uint32_t                  head;  /* Oldest queued slot */
+	uint32_t                  count; /* Slots queued */
+	uint32_t                  next_seq_num;
+	uint64_t                  num_dropped; /* Queue full or too large */
+	uint64_t                  num_missed;  /* Gaps in the sequence numbers */
+
+	volatile bool             terminate_flag;
+	hub_thread_hdl_t          reader_thread;
+};
+
+#endif /* __HUB_SUBSCRIBE_H__ */
@@ -5,37 +5,313 @@
  *
  ******************************************************************************/
 
+/* pthread_attr_setaffinity_np() and pthread_setname_np() are GNU extensions */
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include "gard_info.h"
 #include "hub_threading.h"
 
+/* Scheduling properties per thread class, set up by hub_preinit() */
+static struct hub_thread_props hub_thread_class_props[HUB_THREAD_CLASS_MAX];
+
+/**
+ * Running HUB threads, from hub_thread_create() to hub_thread_join(), so
+ * that hub_thread_reapply_props() finds them. A thread created while the
+ * table is full runs untracked and keeps its properties.
+ */
+#define HUB_THREAD_MAX_TRACKED (256)
+
+static struct {
+	hub_thread_hdl_t      thread_hdl;
+	enum hub_thread_class thread_class;
+	bool                  in_use;
+} hub_threads[HUB_THREAD_MAX_TRACKED];
+static hub_mutex_t hub_threads_lock = HUB_MUTEX_INITIALIZER;
+
+static void hub_thread_track(hub_thread_hdl_t      thread_hdl,
+							 enum hub_thread_class thread_class)
+{
+	uint32_t i;
+
+	pthread_mutex_lock(&hub_threads_lock);
+	for (i = 0; i < HUB_THREAD_MAX_TRACKED; i++) {
+		if (!hub_threads[i].in_use) {
+			hub_threads[i].thread_hdl   = thread_hdl;
+			hub_threads[i].thread_class = thread_class;
+			hub_threads[i].in_use       = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hub_threads_lock);
+}
+
+static void hub_thread_untrack(hub_thread_hdl_t thread_hdl)
+{
+	uint32_t i;
+
+	pthread_mutex_lock(&hub_threads_lock);
+	for (i = 0; i < HUB_THREAD_MAX_TRACKED; i++) {
+		if (hub_threads[i].in_use &&
+			pthread_equal(hub_threads[i].thread_hdl, thread_hdl)) {
+			hub_threads[i].in_use = false;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hub_threads_lock);
+}
+
+/**
+ * Set the scheduling properties used for threads of a class created from
+ * now on.
+ *
+ * @param: thread_class is the class of HUB threads
+ * @param: p_props are the properties, copied
+ */
+void hub_thread_set_props(enum hub_thread_class          thread_class,
+						  const struct hub_thread_props *p_props)
+{
+	if ((thread_class >= HUB_THREAD_CLASS_MAX) || (NULL == p_props)) {
+		return;
+	}
+
+	hub_thread_class_props[thread_class] = *p_props;
+}
+
+/**
+ * Get the scheduling properties of a thread class.
+ *
+ * @param: thread_class is the class of HUB threads
+ * @param: p_props is filled with the properties
+ */
+void hub_thread_get_props(enum hub_thread_class    thread_class,
+						  struct hub_thread_props *p_props)
+{
+	if ((thread_class >= HUB_THREAD_CLASS_MAX) || (NULL == p_props)) {
+		return;
+	}
+
+	*p_props = hub_thread_class_props[thread_class];
+}
+
+/**
+ * Apply the scheduling properties of a thread class to thread attributes.
+ * A property that cannot be applied is reported and left at its default.
+ *
+ * @param: p_thread_attr are the initialized thread attributes
+ * @param: p_props are the properties of the thread class
+ */
+static void hub_thread_apply_props(hub_thread_attr_t             *p_thread_attr,
+								   const struct hub_thread_props *p_props)
+{
+	int                ret, cpu, prio_min, prio_max;
+	cpu_set_t          cpu_set;
+	struct sched_param sched_param;
+
+	if (p_props->stack_size) {
+		ret = pthread_attr_setstacksize(
+			p_thread_attr, (p_props->stack_size < PTHREAD_STACK_MIN)
+							   ? PTHREAD_STACK_MIN
+							   : p_props->stack_size);
+		if (ret) {
+			hub_pr_warn("Cannot set thread stack size %zu: %d\n",
+						p_props->stack_size, ret);
+		}
+	}
+
+	if (p_props->cpu_mask) {
+		CPU_ZERO(&cpu_set);
+		for (cpu = 0; cpu < 64; cpu++) {
+			if (p_props->cpu_mask & (1ULL << cpu)) {
+				CPU_SET(cpu, &cpu_set);
+			}
+		}
+
+		ret = pthread_attr_setaffinity_np(p_thread_attr, sizeof(cpu_set),
+										  &cpu_set);
+		if (ret) {
+			hub_pr_warn("Cannot set thread CPU mask 0x%llx: %d\n",
+						(unsigned long long)p_props->cpu_mask, ret);
+		}
+	}
+
+	if ((SCHED_FIFO != p_props->sched_policy) &&
+		(SCHED_RR != p_props->sched_policy)) {
+		return;
+	}
+
+	/* Clamp to the range of the policy */
+	prio_min = sched_get_priority_min(p_props->sched_policy);
+	prio_max = sched_get_priority_max(p_props->sched_policy);
+
+	sched_param.sched_priority = hub_max_int32(
+		prio_min, hub_min_int32(p_props->sched_priority, prio_max));
+
+	if (pthread_attr_setinheritsched(p_thread_attr, PTHREAD_EXPLICIT_SCHED) ||
+		pthread_attr_setschedpolicy(p_thread_attr, p_props->sched_policy) ||
+		pthread_attr_setschedparam(p_thread_attr, &sched_param)) {
+		hub_pr_warn("Cannot set thread policy %d priority %d\n",
+					p_props->sched_policy, sched_param.sched_priority);
+		pthread_attr_setinheritsched(p_thread_attr, PTHREAD_INHERIT_SCHED);
+	}
+}
+
+/**
+ * Create a joinable HUB thread with the scheduling properties of its class
+ * and give it a name, which shows up in ps / top / gdb.
+ *
+ * Real-time scheduling needs CAP_SYS_NICE (or an RLIMIT_RTPRIO); without
+ * it the thread is created with the inherited policy instead and a warning.
+ *
+ * @param: p_thread_hdl is filled with the handle of the new thread
+ * @param: p_thread_attr are the thread attributes to use, may be NULL
+ * @param: thread_class is the class of the thread, see hub_thread_set_props
+ * @param: p_name is the thread name, truncated to HUB_THREAD_NAME_LEN - 1
+ * @param: worker_func is the thread function
+ * @param: p_thread_args is passed to worker_func
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_THREAD_CREATE on failure
+ */
 enum hub_ret_code hub_thread_create(hub_thread_hdl_t        *p_thread_hdl,
 									hub_thread_attr_t       *p_thread_attr,
+									enum hub_thread_class    thread_class,
+									const char              *p_name,
 									hub_thread_worker_func_t worker_func,
 									void                    *p_thread_args)
 {
-	int ret;
+	int                            ret;
+	hub_thread_attr_t              thread_attr;
+	char                           thread_name[HUB_THREAD_NAME_LEN];
+	const struct hub_thread_props *p_props;
+
+	if (thread_class >= HUB_THREAD_CLASS_MAX) {
+		hub_pr_err("Invalid thread class %d\n", thread_class);
+		return HUB_FAILURE_THREAD_CREATE;
+	}
+	p_props = &hub_thread_class_props[thread_class];
+
+	if (NULL == p_thread_attr) {
+		p_thread_attr = &thread_attr;
+	}
 
-	/* TBD-DPN: Put error checks for failures here */
 	ret = pthread_attr_init(p_thread_attr);
+	if (ret) {
+		hub_pr_err("Error initing thread attributes: %d\n", ret);
+		return HUB_FAILURE_THREAD_CREATE;
+	}
 
 	/* TBD-DPN: By default we create all HUB threads as joinable */
 	ret = pthread_attr_setdetachstate(p_thread_attr, PTHREAD_CREATE_JOINABLE);
 
+	hub_thread_apply_props(p_thread_attr, p_props);
+
 	ret = pthread_create(p_thread_hdl, (const hub_thread_attr_t *)p_thread_attr,
 						 worker_func, p_thread_args);
+	if ((EPERM == ret) && (SCHED_OTHER != p_props->sched_policy)) {
+		hub_pr_warn("No permission for real-time scheduling of thread %s, "
+					"using the inherited policy\n",
+					p_name ? p_name : "");
+		pthread_attr_setinheritsched(p_thread_attr, PTHREAD_INHERIT_SCHED);
+		ret = pthread_create(p_thread_hdl,
+							 (const hub_thread_attr_t *)p_thread_attr,
+							 worker_func, p_thread_args);
+	}
 
-	if (ret < 0) {
-		hub_pr_err("Error creating thread: %d", errno);
+	pthread_attr_destroy(p_thread_attr);
+
+	if (ret) {
+		hub_pr_err("Error creating thread: %d\n", ret);
 		return HUB_FAILURE_THREAD_CREATE;
 	}
 
+	hub_thread_track(*p_thread_hdl, thread_class);
+
+	if (NULL != p_name) {
+		snprintf(thread_name, sizeof(thread_name), "%s", p_name);
+		if (pthread_setname_np(*p_thread_hdl, thread_name)) {
+			hub_pr_warn("Cannot name thread %s\n", thread_name);
+		}
+	}
+
 	return HUB_SUCCESS;
 }
 
+/**
+ * Apply the current scheduling properties of a thread class, see
+ * hub_thread_set_props(), to its running threads: CPU mask, policy and
+ * priority. The stack size only applies to threads created from now on.
+ *
+ * @param: thread_class is the class of HUB threads
+ *
+ * @return: the number of threads the properties could not be applied to
+ */
+uint32_t hub_thread_reapply_props(enum hub_thread_class thread_class)
+{
+	const struct hub_thread_props *p_props;
+	struct sched_param             sched_param = {0};
+	cpu_set_t                      cpu_set;
+	int                            cpu, policy, prio_min, prio_max;
+	uint32_t                       i, num_failed = 0;
+
+	if (thread_class >= HUB_THREAD_CLASS_MAX) {
+		return 0;
+	}
+	p_props = &hub_thread_class_props[thread_class];
+
+	CPU_ZERO(&cpu_set);
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if ((0 == p_props->cpu_mask) ||
+			((cpu < 64) && (p_props->cpu_mask & (1ULL << cpu)))) {
+			CPU_SET(cpu, &cpu_set);
+		}
+	}
+
+	policy = SCHED_OTHER;
+	if ((SCHED_FIFO == p_props->sched_policy) ||
+		(SCHED_RR == p_props->sched_policy)) {
+		policy   = p_props->sched_policy;
+		prio_min = sched_get_priority_min(policy);
+		prio_max = sched_get_priority_max(policy);
+		sched_param.sched_priority = hub_max_int32(
+			prio_min, hub_min_int32(p_props->sched_priority, prio_max));
+	}
+
+	pthread_mutex_lock(&hub_threads_lock);
+	for (i = 0; i < HUB_THREAD_MAX_TRACKED; i++) {
+		if (!hub_threads[i].in_use ||
+			(hub_threads[i].thread_class != thread_class)) {
+			continue;
+		}
+
+		if (pthread_setaffinity_np(hub_threads[i].thread_hdl, sizeof(cpu_set),
+								   &cpu_set) ||
+			pthread_setschedparam(hub_threads[i].thread_hdl, policy,
+								  &sched_param)) {
+			num_failed++;
+		}
+	}
+	pthread_mutex_unlock(&hub_threads_lock);
+
+	if (num_failed) {
+		hub_pr_warn("Cannot apply policy %d priority %d to %u thread(s) of "
+					"class %d\n",
+					policy, sched_param.sched_priority, num_failed,
+					thread_class);
+	}
+
+	return num_failed;
+}
+
 enum hub_ret_code hub_thread_join(hub_thread_hdl_t thread_hdl, void **retval)
 {
 	int ret = pthread_join(thread_hdl, retval);
 
+	hub_thread_untrack(thread_hdl);
+
 	if (ret) {
 		hub_pr_err("Error joining thread: %d", errno);
 		return HUB_FAILURE_THREAD_JOIN;
@@ -129,12 +405,27 @@ enum hub_ret_code hub_mutex_destroy(hub_mutex_t *p_mutex)
 	return HUB_SUCCESS;
 }
 
+/**
+ * Condition variables time their waits on CLOCK_MONOTONIC, so that wall
+ * clock steps (NTP, RTC-less boards setting the time late) do not shorten or
+ * stretch hub_cond_var_timedwait().
+ */
 enum hub_ret_code hub_cond_var_init(hub_cond_var_t *p_cond_var)
 {
-	int ret = pthread_cond_init(p_cond_var, NULL);
+	int                ret;
+	pthread_condattr_t cond_attr;
+
+	ret = pthread_condattr_init(&cond_attr);
+	if (!ret) {
+		ret = pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+		if (!ret) {
+			ret = pthread_cond_init(p_cond_var, &cond_attr);
+		}
+		pthread_condattr_destroy(&cond_attr);
+	}
 
 	if (ret) {
-		hub_pr_err("Error initing cond_var: %d\n", errno);
+		hub_pr_err("Error initing cond_var: %d\n", ret);
 		return HUB_FAILURE_CONDVAR_INIT;
 	}
 
@@ -154,6 +445,32 @@ enum hub_ret_code hub_cond_var_wait(hub_cond_var_t *p_cond_var,
 	return HUB_SUCCESS;
 }
 
+/**
+ * Wait on a condition variable until signalled or until an absolute
+ * CLOCK_MONOTONIC deadline, see hub_deadline_from_now().
+ *
+ * @return: HUB_SUCCESS when signalled (or spuriously woken)
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT when the deadline has passed
+ *			HUB_FAILURE_CONDVAR_WAIT on failure
+ */
+enum hub_ret_code hub_cond_var_timedwait(hub_cond_var_t        *p_cond_var,
+										 hub_mutex_t           *p_mutex,
+										 const struct timespec *p_deadline)
+{
+	int ret = pthread_cond_timedwait(p_cond_var, p_mutex, p_deadline);
+
+	if (ETIMEDOUT == ret) {
+		return HUB_FAILURE_CONDVAR_TIMEDOUT;
+	}
+
+	if (ret) {
+		hub_pr_err("Error in cond_var timedwait: %d\n", ret);
+		return HUB_FAILURE_CONDVAR_WAIT;
+	}
+
+	return HUB_SUCCESS;
+}
+
 enum hub_ret_code hub_cond_var_signal(hub_cond_var_t *p_cond_var)
 {
 	int ret = pthread_cond_signal(p_cond_var);
@@ -166,6 +483,18 @@ enum hub_ret_code hub_cond_var_signal(hub_cond_var_t *p_cond_var)
 	return HUB_SUCCESS;
 }
 
+enum hub_ret_code hub_cond_var_broadcast(hub_cond_var_t *p_cond_var)
+{
+	int ret = pthread_cond_broadcast(p_cond_var);
+
+	if (ret) {
+		hub_pr_err("Error in cond_var broadcast: %d\n", errno);
+		return HUB_FAILURE_CONDVAR_SIGNAL;
+	}
+
+	return HUB_SUCCESS;
+}
+
 enum hub_ret_code hub_cond_var_destroy(hub_cond_var_t *p_cond_var)
 {
 	int ret = pthread_cond_destroy(p_cond_var);
@@ -176,4 +505,56 @@ enum hub_ret_code hub_cond_var_destroy(hub_cond_var_t *p_cond_var)
 	}
 
 	return HUB_SUCCESS;
+}
+
+void hub_deadline_from_now(struct timespec *p_deadline, uint32_t ms)
+{
+	clock_gettime(CLOCK_MONOTONIC, p_deadline);
+
+	p_deadline->tv_sec  += ms / 1000;
+	p_deadline->tv_nsec += (long)(ms % 1000) * 1000000;
+	if (p_deadline->tv_nsec >= 1000000000) {
+		p_deadline->tv_sec++;
+		p_deadline->tv_nsec -= 1000000000;
+	}
+}
+
+/**
+ * Open a wake fd.
+ *
+ * @return: the fd on success, -1 on failure
+ */
+int hub_wake_fd_open(void)
+{
+	int wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	if (wake_fd < 0) {
+		hub_pr_err("Error creating wake fd: %d\n", errno);
+	}
+
+	return wake_fd;
+}
+
+void hub_wake_fd_signal(int wake_fd)
+{
+	uint64_t one = 1;
+
+	if (sizeof(one) != write(wake_fd, &one, sizeof(one))) {
+		hub_pr_err("Error signalling wake fd: %d\n", errno);
+	}
+}
+
+/* Consume all pending wakeups, so that the fd stops polling readable */
+void hub_wake_fd_drain(int wake_fd)
+{
+	uint64_t num_wakeups;
+
+	(void)read(wake_fd, &num_wakeups, sizeof(num_wakeups));
+}
+
+void hub_wake_fd_close(int wake_fd)
+{
+	if (wake_fd >= 0) {
+		close(wake_fd);
+	}
 }
\ No newline at end of file
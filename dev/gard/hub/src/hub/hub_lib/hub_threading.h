@@ -9,6 +9,10 @@
 #define __HUB_THREADING_H__
 
 #include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
 #include <errno.h>
 
 typedef pthread_t       hub_thread_hdl_t;
@@ -17,12 +21,49 @@ typedef pthread_attr_t  hub_thread_attr_t;
 typedef pthread_cond_t  hub_cond_var_t;
 typedef pthread_mutex_t hub_mutex_t;
 
-typedef void           *(*hub_thread_worker_func_t)(void *);
+/* Static initializer for a hub_mutex_t */
+#define HUB_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
 
-enum hub_ret_code       hub_thread_create(hub_thread_hdl_t        *p_thread_hdl,
-										  hub_thread_attr_t       *p_thread_attr,
-										  hub_thread_worker_func_t worker_func,
-										  void                    *p_thread_args);
+/* Static initializer for a hub_cond_var_t */
+#define HUB_COND_VAR_INITIALIZER PTHREAD_COND_INITIALIZER
+
+typedef void *(*hub_thread_worker_func_t)(void *);
+
+/* Longest thread name, incl. the NUL, taken by pthread_setname_np() */
+#define HUB_THREAD_NAME_LEN (16)
+
+/**
+ * Classes of HUB threads. Each class gets its scheduling properties from
+ * the "thread_props" object of host_config.json.
+ */
+enum hub_thread_class {
+	HUB_THREAD_CLASS_GPIO_MON = 0, /* GPIO monitor / reactor thread */
+	HUB_THREAD_CLASS_GPIO_WORKER,  /* GPIO per-line and pool workers */
+	HUB_THREAD_CLASS_BUS_IO,       /* Bus I/O and HUB background threads */
+	HUB_THREAD_CLASS_CLIENT,       /* HUB daemon listener and client threads */
+	HUB_THREAD_CLASS_MAX,
+};
+
+/* Scheduling properties of a class of HUB threads; all 0 for the defaults */
+struct hub_thread_props {
+	uint64_t cpu_mask;       /* Bit n allows CPU n, 0 for any CPU */
+	int      sched_policy;   /* SCHED_OTHER, SCHED_FIFO or SCHED_RR */
+	int      sched_priority; /* SCHED_FIFO / SCHED_RR only */
+	size_t   stack_size;     /* Bytes, 0 for the default */
+};
+
+void hub_thread_set_props(enum hub_thread_class          thread_class,
+						  const struct hub_thread_props *p_props);
+void hub_thread_get_props(enum hub_thread_class    thread_class,
+						  struct hub_thread_props *p_props);
+uint32_t hub_thread_reapply_props(enum hub_thread_class thread_class);
+
+enum hub_ret_code hub_thread_create(hub_thread_hdl_t        *p_thread_hdl,
+									hub_thread_attr_t       *p_thread_attr,
+									enum hub_thread_class    thread_class,
+									const char              *p_name,
+									hub_thread_worker_func_t worker_func,
+									void                    *p_thread_args);
 
 enum hub_ret_code hub_thread_join(hub_thread_hdl_t thread_hdl, void **retval);
 
@@ -37,7 +78,24 @@ enum hub_ret_code hub_mutex_destroy(hub_mutex_t *p_mutex);
 enum hub_ret_code hub_cond_var_init(hub_cond_var_t *p_cond_var);
 enum hub_ret_code hub_cond_var_wait(hub_cond_var_t *p_cond_var,
 									hub_mutex_t    *p_mutex);
+enum hub_ret_code hub_cond_var_timedwait(hub_cond_var_t        *p_cond_var,
+										 hub_mutex_t           *p_mutex,
+										 const struct timespec *p_deadline);
 enum hub_ret_code hub_cond_var_signal(hub_cond_var_t *p_cond_var);
+enum hub_ret_code hub_cond_var_broadcast(hub_cond_var_t *p_cond_var);
 enum hub_ret_code hub_cond_var_destroy(hub_cond_var_t *p_cond_var);
 
+/* CLOCK_MONOTONIC deadline ms milliseconds from now */
+void hub_deadline_from_now(struct timespec *p_deadline, uint32_t ms);
+
+/**
+ * Wake fds let a thread sleeping in poll() / epoll_wait() on other fds be
+ * woken without a timeout, e.g. for shutdown. They are eventfds: wakeups
+ * are counted, so none is lost if the thread is not sleeping yet.
+ */
+int  hub_wake_fd_open(void);
+void hub_wake_fd_signal(int wake_fd);
+void hub_wake_fd_drain(int wake_fd);
+void hub_wake_fd_close(int wake_fd);
+
 #endif /* __HUB_THREADING_H__ */
\ No newline at end of file
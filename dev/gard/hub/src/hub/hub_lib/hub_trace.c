@@ -0,0 +1,341 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * Trace ring of GPIO app data events.
+ *
+ * A record is added once per event, after the user callback has returned,
+ * so keeping the trace does not add to any of the latencies it records.
+ * Records are exported as Chrome trace event JSON: one nestable async slice
+ * per event (ph "b" / "e", keyed by its sequence number) with a child slice
+ * per stage. Async slices are used because the stages of back-to-back
+ * events on a line overlap, which complete ("X") slices cannot express.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hub_gpio.h"
+#include "hub_trace.h"
+
+/**
+ * Initialize a trace ring, with recording off.
+ *
+ * @param: p_trace is the trace ring
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_init(struct hub_trace_ctx *p_trace)
+{
+	p_trace->p_records   = NULL;
+	p_trace->num_records = 0;
+	p_trace->next_seq    = 0;
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_trace->trace_mutex)) {
+		hub_pr_err("Failed to initialize trace_mutex\n");
+		return HUB_FAILURE_TRACE;
+	}
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Tear down a trace ring set up by hub_trace_init(). No thread may be
+ * recording into it anymore.
+ *
+ * @param: p_trace is the trace ring
+ */
+void hub_trace_fini(struct hub_trace_ctx *p_trace)
+{
+	free(p_trace->p_records);
+	p_trace->p_records   = NULL;
+	p_trace->num_records = 0;
+
+	hub_mutex_destroy(&p_trace->trace_mutex);
+}
+
+/**
+ * Add one GPIO app data event to a trace ring, if recording is on.
+ *
+ * @param: p_trace is the trace ring
+ * @param: gard_num is the GARD the event came from
+ * @param: gpio_pin is the GPIO line the event came on
+ * @param: p_times are the timestamps of the event up to the receive
+ * @param: cb_start_ns / cb_end_ns bound the user callback, 0 without one
+ */
+void hub_trace_record(struct hub_trace_ctx                 *p_trace,
+					  uint32_t                              gard_num,
+					  int                                   gpio_pin,
+					  const struct hub_appdata_event_times *p_times,
+					  uint64_t                              cb_start_ns,
+					  uint64_t                              cb_end_ns)
+{
+	struct hub_trace_record *p_rec;
+
+	/* Unlocked peek so that an idle trace costs nothing per event */
+	if (NULL == __atomic_load_n(&p_trace->p_records, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	/* TBD-SSP: handle locking failures */
+	hub_mutex_lock(&p_trace->trace_mutex);
+	if (NULL != p_trace->p_records) {
+		p_rec = &p_trace->p_records[p_trace->next_seq % p_trace->num_records];
+
+		p_rec->seq         = p_trace->next_seq++;
+		p_rec->gard_num    = gard_num;
+		p_rec->gpio_pin    = gpio_pin;
+		p_rec->times       = *p_times;
+		p_rec->cb_start_ns = cb_start_ns;
+		p_rec->cb_end_ns   = cb_end_ns;
+	}
+	hub_mutex_unlock(&p_trace->trace_mutex);
+}
+
+/**
+ * Get the trace ring of a HUB handle.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: the trace ring, NULL if HUB has no GPIO monitor
+ */
+static struct hub_trace_ctx *hub_trace_of(hub_handle_t hub)
+{
+	struct hub_ctx *p_hub = (struct hub_ctx *)hub;
+
+	if ((NULL == p_hub) || (NULL == p_hub->p_gpio_mon_ctx)) {
+		hub_pr_err("Invalid HUB handle or no GPIO monitoring for tracing\n");
+		return NULL;
+	}
+
+	return &p_hub->p_gpio_mon_ctx->trace;
+}
+
+/**
+ * hub_trace_start starts recording GPIO app data events in a ring of
+ * num_records trace records, clearing any previous trace.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: num_records is the size of the ring
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_start(hub_handle_t hub, uint32_t num_records)
+{
+	struct hub_trace_ctx    *p_trace = hub_trace_of(hub);
+	struct hub_trace_record *p_records, *p_old;
+
+	if ((NULL == p_trace) || (0 == num_records)) {
+		hub_pr_err("Invalid arguments for hub_trace_start\n");
+		return HUB_FAILURE_TRACE;
+	}
+
+	p_records = (struct hub_trace_record *)calloc(
+		num_records, sizeof(struct hub_trace_record));
+	if (NULL == p_records) {
+		hub_pr_err("Failed to allocate %u trace records\n", num_records);
+		return HUB_FAILURE_TRACE;
+	}
+
+	hub_mutex_lock(&p_trace->trace_mutex);
+	p_old                = p_trace->p_records;
+	p_trace->p_records   = p_records;
+	p_trace->num_records = num_records;
+	p_trace->next_seq    = 0;
+	hub_mutex_unlock(&p_trace->trace_mutex);
+
+	free(p_old);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_trace_stop stops recording and drops the trace records.
+ *
+ * @param: hub is the HUB handle
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_stop(hub_handle_t hub)
+{
+	struct hub_trace_ctx    *p_trace = hub_trace_of(hub);
+	struct hub_trace_record *p_old;
+
+	if (NULL == p_trace) {
+		return HUB_FAILURE_TRACE;
+	}
+
+	hub_mutex_lock(&p_trace->trace_mutex);
+	p_old                = p_trace->p_records;
+	p_trace->p_records   = NULL;
+	p_trace->num_records = 0;
+	hub_mutex_unlock(&p_trace->trace_mutex);
+
+	free(p_old);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * Write one begin or end of an async slice of a trace record.
+ *
+ * @param: fp is the JSON file
+ * @param: p_first is true until the first event has been written
+ * @param: p_rec is the trace record the slice belongs to
+ * @param: p_name is the name of the slice
+ * @param: ph is 'b' for begin, 'e' for end
+ * @param: ts_ns is the time of the begin / end
+ */
+static void hub_trace_write_event(FILE                          *fp,
+								  bool                          *p_first,
+								  const struct hub_trace_record *p_rec,
+								  const char                    *p_name,
+								  char                           ph,
+								  uint64_t                       ts_ns)
+{
+	/* Chrome trace timestamps are in microseconds */
+	fprintf(fp,
+			"%s\n{\"name\":\"%s\",\"cat\":\"hub\",\"ph\":\"%c\","
+			"\"id\":\"0x%llx\",\"pid\":%u,\"tid\":%d,\"ts\":%llu.%03llu}",
+			*p_first ? "" : ",", p_name, ph, (unsigned long long)p_rec->seq,
+			p_rec->gard_num, p_rec->gpio_pin,
+			(unsigned long long)(ts_ns / 1000),
+			(unsigned long long)(ts_ns % 1000));
+	*p_first = false;
+}
+
+/**
+ * Write one stage of a trace record as a child async slice, if both of its
+ * timestamps are known.
+ */
+static void hub_trace_write_stage(FILE                          *fp,
+								  bool                          *p_first,
+								  const struct hub_trace_record *p_rec,
+								  const char                    *p_name,
+								  uint64_t                       start_ns,
+								  uint64_t                       end_ns)
+{
+	if (!start_ns || (end_ns < start_ns)) {
+		return;
+	}
+
+	hub_trace_write_event(fp, p_first, p_rec, p_name, 'b', start_ns);
+	hub_trace_write_event(fp, p_first, p_rec, p_name, 'e', end_ns);
+}
+
+/**
+ * Write one trace record: a "gpio_event" slice over the whole event with
+ * its stages nested in it.
+ */
+static void hub_trace_write_record(FILE                          *fp,
+								   bool                          *p_first,
+								   const struct hub_trace_record *p_rec)
+{
+	const struct hub_appdata_event_times *p_times = &p_rec->times;
+	uint64_t                              start_ns, end_ns;
+
+	/**
+	 * An edge stamped with another clock (kernels before 5.7) or not
+	 * stamped at all would not nest; start the event at the monitor then.
+	 */
+	start_ns = p_times->edge_ns;
+	if (!start_ns || (start_ns > p_times->monitor_wake_ns)) {
+		start_ns = p_times->monitor_wake_ns;
+	}
+	end_ns = p_rec->cb_end_ns ? p_rec->cb_end_ns : p_times->xfer_end_ns;
+
+	hub_trace_write_event(fp, p_first, p_rec, "gpio_event", 'b', start_ns);
+	hub_trace_write_stage(fp, p_first, p_rec, "edge_to_monitor", start_ns,
+						  p_times->monitor_wake_ns);
+	hub_trace_write_stage(fp, p_first, p_rec, "monitor_to_worker",
+						  p_times->monitor_wake_ns, p_times->worker_wake_ns);
+	hub_trace_write_stage(fp, p_first, p_rec, "recv_app_data",
+						  p_times->xfer_start_ns, p_times->xfer_end_ns);
+	hub_trace_write_stage(fp, p_first, p_rec, "callback", p_rec->cb_start_ns,
+						  p_rec->cb_end_ns);
+	hub_trace_write_event(fp, p_first, p_rec, "gpio_event", 'e',
+						  hub_max_uint64(start_ns, end_ns));
+}
+
+/**
+ * hub_trace_export_json writes the trace records, oldest first, in the
+ * Chrome trace event JSON format.
+ *
+ * The ring is copied out under trace_mutex and written without it, so that
+ * the workers are not held up by file I/O.
+ *
+ * @param: hub is the HUB handle
+ * @param: p_path is the file to write
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_TRACE on failure
+ */
+enum hub_ret_code hub_trace_export_json(hub_handle_t hub, const char *p_path)
+{
+	struct hub_trace_ctx    *p_trace   = hub_trace_of(hub);
+	struct hub_trace_record *p_records = NULL;
+	uint64_t                 first_seq, num, i;
+	uint32_t                 num_records;
+	bool                     first     = true;
+	FILE                    *fp;
+
+	if ((NULL == p_trace) || (NULL == p_path)) {
+		hub_pr_err("Invalid arguments for hub_trace_export_json\n");
+		goto hub_trace_export_json_err_1;
+	}
+
+	hub_mutex_lock(&p_trace->trace_mutex);
+	num_records = p_trace->num_records;
+	if (NULL == p_trace->p_records) {
+		hub_mutex_unlock(&p_trace->trace_mutex);
+		hub_pr_err("Tracing is not started\n");
+		goto hub_trace_export_json_err_1;
+	}
+
+	p_records = (struct hub_trace_record *)malloc(
+		num_records * sizeof(struct hub_trace_record));
+	if (NULL == p_records) {
+		hub_mutex_unlock(&p_trace->trace_mutex);
+		hub_pr_err("Failed to allocate %u trace records\n", num_records);
+		goto hub_trace_export_json_err_1;
+	}
+
+	memcpy(p_records, p_trace->p_records,
+		   num_records * sizeof(struct hub_trace_record));
+	num       = hub_min_uint64(p_trace->next_seq, num_records);
+	first_seq = p_trace->next_seq - num;
+	hub_mutex_unlock(&p_trace->trace_mutex);
+
+	fp = fopen(p_path, "w");
+	if (NULL == fp) {
+		hub_pr_err("Failed to open %s: %s\n", p_path, strerror(errno));
+		goto hub_trace_export_json_err_2;
+	}
+
+	fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	for (i = first_seq; i < first_seq + num; i++) {
+		hub_trace_write_record(fp, &first, &p_records[i % num_records]);
+	}
+	fprintf(fp, "\n]}\n");
+
+	if (fclose(fp)) {
+		hub_pr_err("Failed to write %s: %s\n", p_path, strerror(errno));
+		goto hub_trace_export_json_err_2;
+	}
+
+	free(p_records);
+
+	return HUB_SUCCESS;
+
+hub_trace_export_json_err_2:
+	free(p_records);
+hub_trace_export_json_err_1:
+	return HUB_FAILURE_TRACE;
+}
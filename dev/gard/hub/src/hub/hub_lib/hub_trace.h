@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_TRACE_H__
+#define __HUB_TRACE_H__
+
+#include "hub.h"
+#include "types.h"
+#include "hub_threading.h"
+
+/* One GPIO app data event, from the GARD edge to the user callback return */
+struct hub_trace_record {
+	uint64_t                       seq;
+	uint32_t                       gard_num;
+	int                            gpio_pin;
+	struct hub_appdata_event_times times;
+	uint64_t                       cb_start_ns; /* 0 without a callback */
+	uint64_t                       cb_end_ns;
+};
+
+/**
+ * Trace ring of the GPIO monitor. Recording is off while p_records is NULL.
+ * All fields are under trace_mutex, which is held only to copy a record in
+ * or out, never across a bus transfer or a user callback.
+ */
+struct hub_trace_ctx {
+	hub_mutex_t              trace_mutex;
+	struct hub_trace_record *p_records;
+	uint32_t                 num_records;
+	uint64_t                 next_seq; /* Records written since start */
+};
+
+/**
+ * hub_trace_init / hub_trace_fini set up and tear down a trace ring, with
+ * recording off.
+ */
+enum hub_ret_code hub_trace_init(struct hub_trace_ctx *p_trace);
+void              hub_trace_fini(struct hub_trace_ctx *p_trace);
+
+/**
+ * hub_trace_record adds one event to the ring, if recording is on.
+ */
+void hub_trace_record(struct hub_trace_ctx                 *p_trace,
+					  uint32_t                              gard_num,
+					  int                                   gpio_pin,
+					  const struct hub_appdata_event_times *p_times,
+					  uint64_t                              cb_start_ns,
+					  uint64_t                              cb_end_ns);
+
+#endif /* __HUB_TRACE_H__ */
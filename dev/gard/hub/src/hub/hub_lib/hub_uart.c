@@ -19,6 +19,65 @@
  */
 static struct hub_gard_bus_uart_props *p_uart_ctx = NULL;
 
+/* Background receive ring of the UART, used if "uart_rx_ring_size" is set */
+static struct hub_uart_rx_ring uart_rx_ring;
+
+static int  hub_uart_rx_ring_start(struct hub_uart_rx_ring *p_ring,
+								   int                      uart_bus_hdl,
+								   uint32_t                 size);
+static void hub_uart_rx_ring_stop(struct hub_uart_rx_ring *p_ring);
+
+/**
+ * Receiver of pushes, NULL unless App Module data is subscribed. Pushes only
+ * come between two commands, so they are looked for at the start of the
+ * first read after a write, and by hub_uart_device_drain_pushes().
+ */
+static struct hub_uart_push_sink *p_uart_push_sink = NULL;
+static bool                       uart_resp_pending = false;
+
+/**
+ * Flush policy of the open UART bus.
+ * Falls back to flushing every write when no bus context is available.
+ */
+static inline enum hub_uart_flush_policy hub_uart_flush_policy(void)
+{
+	return (NULL != p_uart_ctx) ? p_uart_ctx->flush_policy
+								: HUB_UART_FLUSH_PER_WRITE;
+}
+
+/**
+ * Map a baud rate to its termios speed constant.
+ *
+ * @param: baudrate is the rate in bits/sec
+ * @param: p_speed is filled with the Bxxx constant if one exists
+ *
+ * @return: true if baudrate has a Bxxx constant, false otherwise
+ */
+static bool hub_uart_baud_to_speed(uint32_t baudrate, speed_t *p_speed)
+{
+	static const struct {
+		uint32_t baudrate;
+		speed_t  speed;
+	} std_rates[] = {
+		{9600, B9600},       {19200, B19200},     {38400, B38400},
+		{57600, B57600},     {115200, B115200},   {230400, B230400},
+		{460800, B460800},   {500000, B500000},   {576000, B576000},
+		{921600, B921600},   {1000000, B1000000}, {1152000, B1152000},
+		{1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000},
+		{3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000},
+	};
+	uint32_t i;
+
+	for (i = 0; i < sizeof(std_rates) / sizeof(std_rates[0]); i++) {
+		if (std_rates[i].baudrate == baudrate) {
+			*p_speed = std_rates[i].speed;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * Open a UART bus given an opaque pointer representing the bus's properties.
  * Returns a bus handle on success.
@@ -36,6 +95,7 @@ int32_t hub_uart_device_open(void *param)
 	struct termios uart_tty;
 	int            ret;
 	speed_t        bus_speed;
+	bool           is_std_rate;
 
 	p_uart_ctx       = (struct hub_gard_bus_uart_props *)param;
 
@@ -61,22 +121,20 @@ int32_t hub_uart_device_open(void *param)
 		}
 	}
 
-	/* TBD-DPN: Remove this restriction on baudrate */
-	switch (p_uart_ctx->baudrate) {
-	case 9600:
-		bus_speed = B9600;
-		break;
-	case 115200:
-		bus_speed = B115200;
-		break;
-	case 921600:
-		bus_speed = B921600;
-		break;
-	default:
-		hub_pr_err("Baudrate %d not supported\n", p_uart_ctx->baudrate);
+	if (0 == p_uart_ctx->baudrate) {
+		hub_pr_err("Baudrate 0 not supported\n");
 		goto err_uart_open_1;
 	}
 
+	/**
+	 * Rates without a Bxxx constant are opened at B38400 and then moved to
+	 * the real rate through termios2 / BOTHER below.
+	 */
+	is_std_rate = hub_uart_baud_to_speed(p_uart_ctx->baudrate, &bus_speed);
+	if (!is_std_rate) {
+		bus_speed = B38400;
+	}
+
 	bus_hdl = open(p_uart_bus, O_RDWR);
 	if (bus_hdl < 0) {
 		hub_pr_err("Error opening %s\n", p_uart_bus);
@@ -115,6 +173,11 @@ int32_t hub_uart_device_open(void *param)
 	uart_tty.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS | HUPCL);
 	/* Set 8 data bits */
 	uart_tty.c_cflag |= CS8;
+	/**
+	 * No RTS/CTS until GARD has agreed to it, see
+	 * hub_uart_device_set_flow_control(): a GARD without the lines wired
+	 * would otherwise stall the link on the first transfer.
+	 */
 	/* Note: minicom shows -cread -clocal when device is closed,
 	 * but typically enables CREAD when opened for reading.
 	 * We enable CREAD for receiver functionality. */
@@ -123,17 +186,32 @@ int32_t hub_uart_device_open(void *param)
 	uart_tty.c_lflag = 0x0;
 
 	/* VMIN=0, VTIME=0: Non-blocking mode (matches minicom) */
-	/* We use select() in the read function to wait for data with timeout,
-	 * matching minicom's approach */
+	/* Reads ask for the full remaining count and poll() only when nothing
+	 * is buffered, against one deadline for the whole read */
 	uart_tty.c_cc[VMIN] = 0;
 	uart_tty.c_cc[VTIME] = 0;
 	
-	tcsetattr(bus_hdl, TCSANOW, &uart_tty); 
+	if (tcsetattr(bus_hdl, TCSANOW, &uart_tty)) {
+		hub_pr_err("Error in tcsetattr\n");
+		goto err_uart_open_2;
+	}
+
+	if (!is_std_rate &&
+		hub_uart_termios2_set_baudrate(bus_hdl, p_uart_ctx->baudrate)) {
+		goto err_uart_open_2;
+	}
+
+	if ((p_uart_ctx->rx_ring_size > 0) &&
+		hub_uart_rx_ring_start(&uart_rx_ring, bus_hdl,
+							   p_uart_ctx->rx_ring_size)) {
+		goto err_uart_open_2;
+	}
 
 	hub_pr_dbg("Opened %s with bus_hdl:%d\n", p_uart_bus, bus_hdl);
 
-	p_uart_ctx->bus_hdl = bus_hdl;
-	p_uart_ctx->is_open = true;
+	p_uart_ctx->bus_hdl            = bus_hdl;
+	p_uart_ctx->is_open            = true;
+	p_uart_ctx->hw_flow_control_on = false;
 
 	return bus_hdl;
 
@@ -172,19 +250,554 @@ int32_t hub_uart_device_write(int         uart_bus_hdl,
 		goto err_write;
 	}
 
-	/* Ensure all data is transmitted before returning */
-	ret = tcdrain(uart_bus_hdl);
-	if (ret != 0) {
-		hub_pr_err("Error draining UART output\n");
-		goto err_write;
+	/* Drain here only if the bus asks for a flush after every write */
+	if (HUB_UART_FLUSH_PER_WRITE == hub_uart_flush_policy()) {
+		ret = tcdrain(uart_bus_hdl);
+		if (ret != 0) {
+			hub_pr_err("Error draining UART output\n");
+			goto err_write;
+		}
 	}
 
 	hub_pr_dbg("Wrote %ld bytes\n", nwrite);
 
+	uart_resp_pending = true;
+
 err_write:
 	return nwrite;
 }
 
+/**
+ * Copy an iovec array into a local array so that it can be advanced
+ * over partial transfers.
+ *
+ * @param: p_dst is the local iovec array of HUB_GARD_BUS_MAX_IOVCNT entries
+ * @param: p_src is the caller's iovec array
+ * @param: iovcnt is the number of entries in p_src
+ *
+ * @return: 0 on success, -1 if iovcnt is out of range
+ */
+static int hub_uart_iov_copy(struct iovec       *p_dst,
+							 const struct iovec *p_src,
+							 int                 iovcnt)
+{
+	if ((iovcnt <= 0) || (iovcnt > HUB_GARD_BUS_MAX_IOVCNT)) {
+		hub_pr_err("Invalid iovcnt %d\n", iovcnt);
+		return -1;
+	}
+
+	memcpy(p_dst, p_src, iovcnt * sizeof(*p_dst));
+
+	return 0;
+}
+
+/**
+ * Consume nbytes from the front of an iovec array.
+ *
+ * @param: pp_iov points to the current first entry, updated on return
+ * @param: p_iovcnt points to the number of entries left, updated on return
+ * @param: nbytes is the number of bytes transferred
+ */
+static void
+	hub_uart_iov_advance(struct iovec **pp_iov, int *p_iovcnt, size_t nbytes)
+{
+	while ((*p_iovcnt > 0) && (nbytes >= (*pp_iov)->iov_len)) {
+		nbytes -= (*pp_iov)->iov_len;
+		(*pp_iov)++;
+		(*p_iovcnt)--;
+	}
+
+	if (*p_iovcnt > 0) {
+		(*pp_iov)->iov_base  = (uint8_t *)(*pp_iov)->iov_base + nbytes;
+		(*pp_iov)->iov_len  -= nbytes;
+	}
+}
+
+/**
+ * Milliseconds left until a CLOCK_MONOTONIC deadline, 0 once it has passed.
+ */
+static int hub_uart_ms_left(const struct timespec *p_deadline)
+{
+	struct timespec now;
+	int64_t         ms;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	ms = (int64_t)(p_deadline->tv_sec - now.tv_sec) * 1000 +
+		 (p_deadline->tv_nsec - now.tv_nsec) / 1000000;
+
+	return (ms > 0) ? (int)ms : 0;
+}
+
+/**
+ * Deadline for a whole read on the open UART bus, from now, the shorter
+ * probe one while discovery probes the bus.
+ */
+static void hub_uart_read_deadline(struct timespec *p_deadline)
+{
+	uint32_t timeout_ms = HUB_GARD_UART_READ_TIMEOUT_MS;
+
+	if ((NULL != p_uart_ctx) && p_uart_ctx->is_probing &&
+		(p_uart_ctx->probe_timeout_ms > 0)) {
+		timeout_ms = p_uart_ctx->probe_timeout_ms;
+	} else if ((NULL != p_uart_ctx) && (p_uart_ctx->read_timeout_ms > 0)) {
+		timeout_ms = p_uart_ctx->read_timeout_ms;
+	}
+
+	hub_deadline_from_now(p_deadline, timeout_ms);
+}
+
+/**
+ * Fill an iovec array straight from the tty.
+ *
+ * Every readv() asks for everything that is still missing; the tty is in
+ * VMIN=0/VTIME=0 mode, so it returns whatever is buffered. poll() is only
+ * used when nothing is buffered, against a single deadline for the whole
+ * read.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: p_iov is a local, advanceable iovec array
+ * @param: iovcnt is the number of entries in p_iov
+ *
+ * @return: Number of bytes read
+ */
+static int32_t
+	hub_uart_readv_direct(int uart_bus_hdl, struct iovec *p_iov, int iovcnt)
+{
+	struct timespec deadline;
+	struct pollfd   pfd = {.fd = uart_bus_hdl, .events = POLLIN};
+	ssize_t         nread;
+	ssize_t         total_bytes = 0;
+	int             ms_left;
+
+	hub_uart_read_deadline(&deadline);
+
+	while (iovcnt > 0) {
+		nread = readv(uart_bus_hdl, p_iov, iovcnt);
+		if (nread > 0) {
+			total_bytes += nread;
+			hub_uart_iov_advance(&p_iov, &iovcnt, nread);
+			continue;
+		}
+
+		if ((nread < 0) && (EINTR != errno) && (EAGAIN != errno)) {
+			hub_pr_err("UART read error: %s\n", strerror(errno));
+			break;
+		}
+
+		ms_left = hub_uart_ms_left(&deadline);
+		if (0 == ms_left) {
+			hub_pr_err("UART read timeout, got %zd bytes\n", total_bytes);
+			break;
+		}
+
+		if ((poll(&pfd, 1, ms_left) < 0) && (EINTR != errno)) {
+			hub_pr_err("UART poll error: %s\n", strerror(errno));
+			break;
+		}
+	}
+
+	return total_bytes;
+}
+
+/**
+ * Background reader of the UART receive ring.
+ *
+ * Moves whatever the tty has into the ring as soon as it arrives. It sleeps
+ * in poll() with no timeout while the line is idle; shutdown wakes it
+ * through wake_fd.
+ *
+ * @param: p_args is the struct hub_uart_rx_ring to fill
+ *
+ * @return: NULL
+ */
+static void *hub_uart_rx_thread(void *p_args)
+{
+	struct hub_uart_rx_ring *p_ring = (struct hub_uart_rx_ring *)p_args;
+	struct pollfd            pfds[2];
+	struct pollfd           *p_pfd = &pfds[0];
+	uint32_t                 tail, space;
+	ssize_t                  nread;
+	int                      ret;
+
+	pfds[0].fd     = p_ring->bus_hdl;
+	pfds[0].events = POLLIN;
+	pfds[1].fd     = p_ring->wake_fd;
+	pfds[1].events = POLLIN;
+
+	while (!p_ring->terminate_flag) {
+		ret = poll(pfds, 2, -1);
+		if ((ret < 0) && (EINTR != errno)) {
+			hub_pr_err("UART rx poll error: %s\n", strerror(errno));
+			p_ring->has_error = true;
+			break;
+		}
+
+		hub_mutex_lock(&p_ring->lock);
+
+		/* Hold off while the app has not drained a full ring */
+		while ((p_ring->count == p_ring->size) && !p_ring->terminate_flag) {
+			hub_cond_var_wait(&p_ring->space_cond, &p_ring->lock);
+		}
+
+		if ((ret > 0) && (p_pfd->revents & (POLLERR | POLLHUP | POLLNVAL))) {
+			hub_pr_err("UART rx line error\n");
+			p_ring->has_error = true;
+		} else if ((ret > 0) && (p_pfd->revents & POLLIN) &&
+				   !p_ring->terminate_flag) {
+			/* Read into the contiguous free space after the tail */
+			tail  = (p_ring->head + p_ring->count) % p_ring->size;
+			space = hub_min_uint32(p_ring->size - p_ring->count,
+								   p_ring->size - tail);
+
+			nread = read(p_ring->bus_hdl, p_ring->p_buf + tail, space);
+			if (nread > 0) {
+				p_ring->count += nread;
+			}
+		}
+
+		/* Both a command and the push reader may be waiting */
+		hub_cond_var_broadcast(&p_ring->data_cond);
+		hub_mutex_unlock(&p_ring->lock);
+
+		if (p_ring->has_error) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Start the background reader on an open UART bus.
+ *
+ * @param: p_ring is the ring to set up
+ * @param: uart_bus_hdl is the handle to the open UART bus
+ * @param: size is the size of the ring in bytes
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int hub_uart_rx_ring_start(struct hub_uart_rx_ring *p_ring,
+								  int                      uart_bus_hdl,
+								  uint32_t                 size)
+{
+	p_ring->p_buf = (uint8_t *)malloc(size);
+	if (NULL == p_ring->p_buf) {
+		hub_pr_err("Error allocating %u bytes UART rx ring\n", size);
+		goto err_rx_ring_start_1;
+	}
+
+	p_ring->size           = size;
+	p_ring->head           = 0;
+	p_ring->count          = 0;
+	p_ring->bus_hdl        = uart_bus_hdl;
+	p_ring->has_error      = false;
+	p_ring->terminate_flag = false;
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ring->lock)) {
+		goto err_rx_ring_start_2;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ring->data_cond)) {
+		goto err_rx_ring_start_3;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ring->space_cond)) {
+		goto err_rx_ring_start_4;
+	}
+
+	p_ring->wake_fd = hub_wake_fd_open();
+	if (p_ring->wake_fd < 0) {
+		goto err_rx_ring_start_5;
+	}
+
+	if (HUB_SUCCESS != hub_thread_create(&p_ring->reader_thread, NULL,
+										 HUB_THREAD_CLASS_BUS_IO, "hub_uart_rx",
+										 hub_uart_rx_thread, p_ring)) {
+		hub_pr_err("Error starting UART rx thread\n");
+		goto err_rx_ring_start_6;
+	}
+
+	p_ring->is_running = true;
+
+	return 0;
+
+err_rx_ring_start_6:
+	hub_wake_fd_close(p_ring->wake_fd);
+	p_ring->wake_fd = -1;
+err_rx_ring_start_5:
+	(void)hub_cond_var_destroy(&p_ring->space_cond);
+err_rx_ring_start_4:
+	(void)hub_cond_var_destroy(&p_ring->data_cond);
+err_rx_ring_start_3:
+	(void)hub_mutex_destroy(&p_ring->lock);
+err_rx_ring_start_2:
+	free(p_ring->p_buf);
+	p_ring->p_buf = NULL;
+err_rx_ring_start_1:
+	return -1;
+}
+
+/**
+ * Stop the background reader and release the ring.
+ *
+ * @param: p_ring is the ring to tear down
+ */
+static void hub_uart_rx_ring_stop(struct hub_uart_rx_ring *p_ring)
+{
+	if (!p_ring->is_running) {
+		return;
+	}
+
+	hub_mutex_lock(&p_ring->lock);
+	p_ring->terminate_flag = true;
+	hub_cond_var_signal(&p_ring->space_cond);
+	hub_mutex_unlock(&p_ring->lock);
+	hub_wake_fd_signal(p_ring->wake_fd);
+
+	(void)hub_thread_join(p_ring->reader_thread, NULL);
+
+	p_ring->is_running = false;
+
+	hub_wake_fd_close(p_ring->wake_fd);
+	p_ring->wake_fd = -1;
+
+	(void)hub_cond_var_destroy(&p_ring->space_cond);
+	(void)hub_cond_var_destroy(&p_ring->data_cond);
+	(void)hub_mutex_destroy(&p_ring->lock);
+
+	free(p_ring->p_buf);
+	p_ring->p_buf = NULL;
+}
+
+/**
+ * Fill an iovec array from the receive ring, waiting for the background
+ * reader until the read deadline.
+ *
+ * @param: p_ring is the running receive ring
+ * @param: p_iov is a local, advanceable iovec array
+ * @param: iovcnt is the number of entries in p_iov
+ *
+ * @return: Number of bytes read
+ */
+static int32_t hub_uart_readv_ring(struct hub_uart_rx_ring *p_ring,
+								   struct iovec            *p_iov,
+								   int                      iovcnt)
+{
+	struct timespec deadline;
+	uint32_t        n;
+	ssize_t         total_bytes = 0;
+
+	hub_uart_read_deadline(&deadline);
+
+	hub_mutex_lock(&p_ring->lock);
+
+	while (iovcnt > 0) {
+		if (0 == p_ring->count) {
+			if (p_ring->has_error) {
+				hub_pr_err("UART rx ring stopped on error\n");
+				break;
+			}
+			if (HUB_FAILURE_CONDVAR_TIMEDOUT ==
+				hub_cond_var_timedwait(&p_ring->data_cond, &p_ring->lock,
+									   &deadline)) {
+				hub_pr_err("UART read timeout, got %zd bytes\n", total_bytes);
+				break;
+			}
+			continue;
+		}
+
+		n = hub_min_uint32(p_ring->count, p_iov->iov_len);
+		n = hub_min_uint32(n, p_ring->size - p_ring->head);
+
+		memcpy(p_iov->iov_base, p_ring->p_buf + p_ring->head, n);
+
+		p_ring->head   = (p_ring->head + n) % p_ring->size;
+		p_ring->count -= n;
+		total_bytes   += n;
+		hub_uart_iov_advance(&p_iov, &iovcnt, n);
+
+		hub_cond_var_signal(&p_ring->space_cond);
+	}
+
+	hub_mutex_unlock(&p_ring->lock);
+
+	return total_bytes;
+}
+
+/**
+ * Fill an iovec array from the receive ring or straight from the tty.
+ */
+static int32_t
+	hub_uart_readv_any(int uart_bus_hdl, struct iovec *p_iov, int iovcnt)
+{
+	if (uart_rx_ring.is_running) {
+		return hub_uart_readv_ring(&uart_rx_ring, p_iov, iovcnt);
+	}
+
+	return hub_uart_readv_direct(uart_bus_hdl, p_iov, iovcnt);
+}
+
+/**
+ * Read the rest of a push whose first byte has been read, and hand it to
+ * the push sink.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: first is the first byte of the push
+ *
+ * @return: 0 on success, -1 if the push is broken off or not a push at all
+ */
+static int hub_uart_read_push(int uart_bus_hdl, uint8_t first)
+{
+	struct _app_data_push_header push_hdr;
+	struct iovec                 iov;
+	uint8_t                      discard[64];
+	uint8_t                     *p_buf;
+	uint32_t                     eod_marker = 0;
+	uint32_t                     left;
+	bool                         is_valid;
+
+	*(uint8_t *)&push_hdr = first;
+
+	iov.iov_base          = (uint8_t *)&push_hdr + 1;
+	iov.iov_len           = sizeof(push_hdr) - 1;
+	if ((iov.iov_len != hub_uart_readv_any(uart_bus_hdl, &iov, 1)) ||
+		(APP_DATA_PUSH_MARKER != push_hdr.push_marker)) {
+		hub_pr_err("Error reading app data push header\n");
+		return -1;
+	}
+
+	/* Data the sink cannot take is read and thrown away */
+	p_buf    = p_uart_push_sink->get_buffer(p_uart_push_sink->p_ctx,
+											push_hdr.data_size);
+	is_valid = true;
+	if (NULL != p_buf) {
+		iov.iov_base = p_buf;
+		iov.iov_len  = push_hdr.data_size;
+		if (push_hdr.data_size &&
+			(iov.iov_len != hub_uart_readv_any(uart_bus_hdl, &iov, 1))) {
+			is_valid = false;
+		}
+	} else {
+		for (left = push_hdr.data_size; is_valid && left;
+			 left -= iov.iov_len) {
+			iov.iov_base = discard;
+			iov.iov_len  = hub_min_uint32(left, sizeof(discard));
+			is_valid     = (iov.iov_len ==
+							hub_uart_readv_any(uart_bus_hdl, &iov, 1));
+		}
+	}
+
+	if (is_valid) {
+		iov.iov_base = &eod_marker;
+		iov.iov_len  = sizeof(eod_marker);
+		is_valid     = (iov.iov_len ==
+						hub_uart_readv_any(uart_bus_hdl, &iov, 1)) &&
+					   (END_OF_DATA_MARKER == eod_marker);
+	}
+
+	if (NULL != p_buf) {
+		p_uart_push_sink->put_buffer(p_uart_push_sink->p_ctx, p_buf,
+									 push_hdr.seq_num, push_hdr.data_size,
+									 is_valid);
+	}
+
+	if (!is_valid) {
+		hub_pr_err("App data push %u broken off\n", push_hdr.seq_num);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Fill an iovec array with a response, reading any pushes that GARD has sent
+ * ahead of it. The first byte tells them apart (see APP_DATA_PUSH_MARKER).
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: p_iov is a local, advanceable iovec array
+ * @param: iovcnt is the number of entries in p_iov
+ *
+ * @return: Number of bytes of the response read
+ */
+static int32_t hub_uart_readv_after_pushes(int           uart_bus_hdl,
+										   struct iovec *p_iov,
+										   int           iovcnt)
+{
+	struct iovec first_iov;
+	uint8_t      first;
+
+	first_iov.iov_base = &first;
+	first_iov.iov_len  = sizeof(first);
+
+	while (1) {
+		if (sizeof(first) != hub_uart_readv_any(uart_bus_hdl, &first_iov, 1)) {
+			return 0;
+		}
+		if ((uint8_t)APP_DATA_PUSH_MARKER != first) {
+			break;
+		}
+		if (hub_uart_read_push(uart_bus_hdl, first)) {
+			return 0;
+		}
+	}
+
+	/* Skip empty buffers, then put the first byte in place */
+	hub_uart_iov_advance(&p_iov, &iovcnt, 0);
+	*(uint8_t *)p_iov->iov_base = first;
+	hub_uart_iov_advance(&p_iov, &iovcnt, sizeof(first));
+
+	if (0 == iovcnt) {
+		return sizeof(first);
+	}
+
+	return sizeof(first) + hub_uart_readv_any(uart_bus_hdl, p_iov, iovcnt);
+}
+
+/**
+ * Perform a scattered read into several buffers on the UART device on the
+ * given bus handle.
+ *
+ * Data comes from the background receive ring if "uart_rx_ring_size" is
+ * set, else straight from the tty. In both cases the whole read shares a
+ * single deadline.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: p_iov is an array of buffers to be filled by the read
+ * @param: iovcnt is the number of buffers in p_iov
+ *
+ * @return: Number of bytes read by the call.
+ * We also print a debug error if this number is not equal to the total
+ */
+int32_t hub_uart_device_readv(int                 uart_bus_hdl,
+							  const struct iovec *p_iov,
+							  int                 iovcnt)
+{
+	struct iovec iov[HUB_GARD_BUS_MAX_IOVCNT];
+	int32_t      total_bytes;
+
+	if (hub_uart_iov_copy(iov, p_iov, iovcnt)) {
+		return 0;
+	}
+
+	if (0 == hub_iov_len(iov, iovcnt)) {
+		return 0;
+	}
+
+	/* Pushes can only come ahead of the first bytes of a response */
+	if (uart_resp_pending && (NULL != p_uart_push_sink)) {
+		uart_resp_pending = false;
+		total_bytes = hub_uart_readv_after_pushes(uart_bus_hdl, iov, iovcnt);
+	} else {
+		uart_resp_pending = false;
+		total_bytes       = hub_uart_readv_any(uart_bus_hdl, iov, iovcnt);
+	}
+
+	hub_pr_dbg("Read %d bytes\n", total_bytes);
+
+	return total_bytes;
+}
+
 /**
  * TBD-DPN: Revisit the error behaviour of this call
  * Also, change the bus_hdl to a bus context for supporting multiple
@@ -202,81 +815,273 @@ err_write:
  */
 int32_t hub_uart_device_read(int uart_bus_hdl, void *p_buffer, uint32_t count)
 {
-	int ret;
+	struct iovec iov = {.iov_base = p_buffer, .iov_len = count};
 
-	uint32_t bytes_left = count;
-	ssize_t nread, to_read;
-	ssize_t total_bytes = 0;
-	
-	fd_set read_fds;
-	
-	struct timeval timeout;
-	const int timeout_seconds = 2;  /* 2 second timeout per select call */
-	
-	const int max_retries = 3;
-	int retry_count = 0;
-	
-	do {
-		to_read = hub_min_uint32(bytes_left, HUB_GARD_UART_READ_CHUNK_SZ);
-
-		/* Use select() to wait for data availability (matching minicom approach) */
-		FD_ZERO(&read_fds);
-		FD_SET(uart_bus_hdl, &read_fds);
-		timeout.tv_sec = timeout_seconds;
-		timeout.tv_usec = 0;
-		
-		ret = select(uart_bus_hdl + 1, &read_fds, NULL, NULL, &timeout);
-		
-		if (ret == -1) {
-			hub_pr_err("UART select error: %s\n", strerror(errno));
-			goto err_read;
-		}
-		
-		if (ret == 0) {
-			/* Timeout */
-			retry_count++;
-			if (retry_count >= max_retries) {
-				hub_pr_err("UART read timeout after %d retries (no data available)\n", max_retries);
-				goto err_read;
-			}
-			/* Retry the select */
-			continue;
-		}
-		
-		/* Data is available, perform the read */
-		if (FD_ISSET(uart_bus_hdl, &read_fds)) {
-			nread = read(uart_bus_hdl, p_buffer, to_read);
-			
-			if (nread == -1) {
-				hub_pr_err("UART read error: %s\n", strerror(errno));
-				goto err_read;
-			}
-			
-			if (nread == 0) {
-				/* EOF or no data (shouldn't happen after select, but handle it) */
-				retry_count++;
-				if (retry_count >= max_retries) {
-					hub_pr_err("UART read returned 0 after select (EOF)\n");
-					goto err_read;
-				}
+	return hub_uart_device_readv(uart_bus_hdl, &iov, 1);
+}
+
+/**
+ * Perform a gathered write of several buffers on the UART device on the
+ * given bus handle. All buffers go out with a single writev() and a
+ * single tcdrain() for the whole HUB command.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: p_iov is an array of buffers with data to write
+ * @param: iovcnt is the number of buffers in p_iov
+ *
+ * @return: Number of bytes written.
+ * We also print a debug error if this number is not equal to the total
+ */
+int32_t hub_uart_device_writev(int                 uart_bus_hdl,
+							   const struct iovec *p_iov,
+							   int                 iovcnt)
+{
+	struct iovec  iov[HUB_GARD_BUS_MAX_IOVCNT];
+	struct iovec *p_cur = iov;
+	ssize_t       nwrite;
+	ssize_t       total_bytes = 0;
+	int           ret;
+
+	if (hub_uart_iov_copy(iov, p_iov, iovcnt)) {
+		goto err_writev;
+	}
+
+	/* writev() on a tty may return early, so keep going until done */
+	while (iovcnt > 0) {
+		nwrite = writev(uart_bus_hdl, p_cur, iovcnt);
+		if (nwrite <= 0) {
+			if ((nwrite < 0) && (EINTR == errno)) {
 				continue;
 			}
-			
-			/* Reset retry count on successful read */
-			retry_count = 0;
-			
-			total_bytes += nread;
-			bytes_left -= nread;
-			p_buffer += nread;
+			hub_pr_err("Error writing to %d\n", uart_bus_hdl);
+			goto err_writev;
 		}
-	} while (total_bytes < count);
 
-	hub_pr_dbg("Read %zd bytes\n", total_bytes);
+		total_bytes += nwrite;
+		hub_uart_iov_advance(&p_cur, &iovcnt, nwrite);
+	}
+
+	/* A vectored write is a whole command, flush it unless told never to */
+	if (HUB_UART_FLUSH_NEVER != hub_uart_flush_policy()) {
+		ret = tcdrain(uart_bus_hdl);
+		if (ret != 0) {
+			hub_pr_err("Error draining UART output\n");
+			goto err_writev;
+		}
+	}
+
+	hub_pr_dbg("Wrote %zd bytes\n", total_bytes);
+
+	uart_resp_pending = true;
 
-err_read:
+err_writev:
 	return total_bytes;
 }
 
+/**
+ * Change the baud rate of an open UART bus.
+ *
+ * Output queued at the old rate is drained first so that it is not garbled,
+ * and any stale input is dropped once the new rate is in place.
+ *
+ * @param: uart_bus_hdl is the handle to the open UART bus
+ * @param: baudrate is the new rate in bits/sec
+ *
+ * @return: 0 on success, -1 on failure
+ */
+int32_t hub_uart_device_set_baudrate(int uart_bus_hdl, uint32_t baudrate)
+{
+	struct termios uart_tty;
+	speed_t        bus_speed;
+
+	if (tcdrain(uart_bus_hdl)) {
+		hub_pr_err("Error draining UART output\n");
+		return -1;
+	}
+
+	if (hub_uart_baud_to_speed(baudrate, &bus_speed)) {
+		if (tcgetattr(uart_bus_hdl, &uart_tty) ||
+			cfsetispeed(&uart_tty, bus_speed) ||
+			cfsetospeed(&uart_tty, bus_speed) ||
+			tcsetattr(uart_bus_hdl, TCSANOW, &uart_tty)) {
+			hub_pr_err("Error setting baudrate %u\n", baudrate);
+			return -1;
+		}
+	} else if (hub_uart_termios2_set_baudrate(uart_bus_hdl, baudrate)) {
+		return -1;
+	}
+
+	(void)tcflush(uart_bus_hdl, TCIFLUSH);
+	if (uart_rx_ring.is_running) {
+		hub_mutex_lock(&uart_rx_ring.lock);
+		uart_rx_ring.head  = 0;
+		uart_rx_ring.count = 0;
+		hub_cond_var_signal(&uart_rx_ring.space_cond);
+		hub_mutex_unlock(&uart_rx_ring.lock);
+	}
+
+	if (NULL != p_uart_ctx) {
+		p_uart_ctx->baudrate = baudrate;
+	}
+
+	hub_pr_dbg("bus_hdl %d now at %u baud\n", uart_bus_hdl, baudrate);
+
+	return 0;
+}
+
+/**
+ * Turn RTS/CTS hardware flow control on or off on an open UART bus, once
+ * GARD has agreed to it. Output queued so far is drained first.
+ *
+ * @param: uart_bus_hdl is the handle to the open UART bus
+ * @param: enable is true to turn RTS/CTS on
+ *
+ * @return: 0 on success, -1 on failure
+ */
+int32_t hub_uart_device_set_flow_control(int uart_bus_hdl, bool enable)
+{
+	struct termios uart_tty;
+
+	if (tcdrain(uart_bus_hdl) || tcgetattr(uart_bus_hdl, &uart_tty)) {
+		hub_pr_err("Error getting UART attributes\n");
+		return -1;
+	}
+
+	if (enable) {
+		uart_tty.c_cflag |= CRTSCTS;
+	} else {
+		uart_tty.c_cflag &= ~CRTSCTS;
+	}
+
+	if (tcsetattr(uart_bus_hdl, TCSANOW, &uart_tty)) {
+		hub_pr_err("Error setting UART flow control\n");
+		return -1;
+	}
+
+	if (NULL != p_uart_ctx) {
+		p_uart_ctx->hw_flow_control_on = enable;
+	}
+
+	hub_pr_dbg("bus_hdl %d RTS/CTS %s\n", uart_bus_hdl, enable ? "on" : "off");
+
+	return 0;
+}
+
+/**
+ * Set the receiver of the pushes GARD sends once App Module data is
+ * subscribed. Called with the bus held, so that no read is looking at the
+ * sink meanwhile.
+ *
+ * The UART bus has one receiver: a second one is refused rather than taking
+ * the pushes of the first.
+ *
+ * @param: p_sink is the push sink
+ *
+ * @return: 0 on success, -1 if another sink is set
+ */
+int32_t hub_uart_set_push_sink(struct hub_uart_push_sink *p_sink)
+{
+	if ((NULL != p_uart_push_sink) && (p_sink != p_uart_push_sink)) {
+		hub_pr_err("UART pushes already go to another subscriber\n");
+		return -1;
+	}
+
+	p_uart_push_sink = p_sink;
+
+	return 0;
+}
+
+/**
+ * Stop giving pushes to a receiver set by hub_uart_set_push_sink(). Called
+ * with the bus held. Another receiver than the one set is left in place.
+ *
+ * @param: p_sink is the push sink
+ */
+void hub_uart_clear_push_sink(struct hub_uart_push_sink *p_sink)
+{
+	if (p_sink == p_uart_push_sink) {
+		p_uart_push_sink = NULL;
+	}
+}
+
+/**
+ * Wait for bytes to come in on the UART device on the given bus handle,
+ * leaving them to be read. It is run without the bus, so that a command
+ * may take the bytes first.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ * @param: timeout_ms is the longest time to wait
+ *
+ * @return: 1 if bytes are in, 0 on timeout, -1 on error
+ */
+int32_t hub_uart_device_wait_rx(int uart_bus_hdl, uint32_t timeout_ms)
+{
+	struct timespec deadline;
+	struct pollfd   pfd = {.fd = uart_bus_hdl, .events = POLLIN};
+	int32_t         ret;
+
+	if (!uart_rx_ring.is_running) {
+		ret = poll(&pfd, 1, (int)timeout_ms);
+		if ((ret < 0) && (EINTR != errno)) {
+			hub_pr_err("UART poll error: %s\n", strerror(errno));
+			return -1;
+		}
+
+		return (ret > 0) ? 1 : 0;
+	}
+
+	hub_deadline_from_now(&deadline, timeout_ms);
+
+	hub_mutex_lock(&uart_rx_ring.lock);
+	if ((0 == uart_rx_ring.count) && !uart_rx_ring.has_error) {
+		(void)hub_cond_var_timedwait(&uart_rx_ring.data_cond,
+									 &uart_rx_ring.lock, &deadline);
+	}
+	ret = uart_rx_ring.count ? 1 : (uart_rx_ring.has_error ? -1 : 0);
+	hub_mutex_unlock(&uart_rx_ring.lock);
+
+	return ret;
+}
+
+/**
+ * Read all pushes that are already in on the UART device on the given bus
+ * handle. Any other byte is stale and dropped, so that the next response
+ * starts on a clean line.
+ *
+ * @param: uart_bus_hdl is the handle to the UART bus
+ *
+ * @return: Number of pushes read, -1 if a push was broken off
+ */
+int32_t hub_uart_device_drain_pushes(int uart_bus_hdl)
+{
+	struct iovec iov;
+	uint8_t      first;
+	int32_t      num_pushes = 0;
+
+	if (NULL == p_uart_push_sink) {
+		return 0;
+	}
+
+	iov.iov_base = &first;
+	iov.iov_len  = sizeof(first);
+
+	while (1 == hub_uart_device_wait_rx(uart_bus_hdl, 0)) {
+		if (sizeof(first) != hub_uart_readv_any(uart_bus_hdl, &iov, 1)) {
+			return -1;
+		}
+		if ((uint8_t)APP_DATA_PUSH_MARKER != first) {
+			hub_pr_err("Dropping stale UART byte 0x%02x\n", first);
+			continue;
+		}
+		if (hub_uart_read_push(uart_bus_hdl, first)) {
+			return -1;
+		}
+		num_pushes++;
+	}
+
+	return num_pushes;
+}
+
 /**
  * TBD-DPN: Revisit the return code for this call.
  * Also, change the bus_hdl to a bus context for supporting mutiple
@@ -290,6 +1095,9 @@ err_read:
  */
 int32_t hub_uart_device_close(int uart_bus_hdl)
 {
+	/* The reader must be gone before its fd is closed */
+	hub_uart_rx_ring_stop(&uart_rx_ring);
+
 	/* Always try to close the file descriptor, even if p_uart_ctx is NULL */
 	/* This handles cases where cleanup is called after an interrupt */
 	if (uart_bus_hdl >= 0) {
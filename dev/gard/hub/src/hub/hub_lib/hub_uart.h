@@ -12,15 +12,65 @@
 #include <unistd.h>
 #include <termios.h>
 #include <string.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/uio.h>
 
 #include "gard_info.h"
+#include "hub_uart_termios2.h"
 
 /**
- * Max chunk size in bytes to be read from GARD UART @ 921600.
- * Empirical value found via trial and error.
+ * Default time in ms a whole UART read may take before it gives up.
+ * Can be overridden per bus with "uart_read_timeout_ms".
  */
-#define HUB_GARD_UART_READ_CHUNK_SZ	(64)
+#define HUB_GARD_UART_READ_TIMEOUT_MS (6000)
+
+/**
+ * Default time in ms a UART read of a discovery probe may take before the
+ * bus is deemed to have no GARD on it.
+ * Can be overridden per bus with "uart_probe_timeout_ms".
+ */
+#define HUB_GARD_UART_PROBE_TIMEOUT_MS (500)
+
+/**
+ * Background receive ring of a UART bus.
+ *
+ * A reader thread moves bytes from the tty into the ring as they arrive, and
+ * device_read / device_readv copy out of it. It is enabled with
+ * "uart_rx_ring_size" in host_config.json.
+ */
+struct hub_uart_rx_ring {
+	uint8_t         *p_buf;
+	uint32_t         size;
+	uint32_t         head;  /* Offset of the oldest byte */
+	uint32_t         count; /* Bytes held */
+	int              bus_hdl;
+	int              wake_fd; /* Wakes the reader for shutdown */
+	bool             is_running;
+	bool             has_error;
+	volatile bool    terminate_flag;
+	hub_thread_hdl_t reader_thread;
+	hub_mutex_t      lock;
+	hub_cond_var_t   data_cond;
+	hub_cond_var_t   space_cond;
+};
+
+/**
+ * Receiver of the App Module results GARD pushes on the UART once subscribed
+ * (see SUBSCRIBE_APP_DATA). It is called on whichever thread holds the bus
+ * when a push is read: get_buffer gives a buffer of at least size bytes for
+ * the data, or NULL to drop it, and put_buffer hands it back, is_valid being
+ * false if the push came in damaged.
+ */
+struct hub_uart_push_sink {
+	void *p_ctx;
+	uint8_t *(*get_buffer)(void *p_ctx, uint32_t size);
+	void (*put_buffer)(void    *p_ctx,
+					   uint8_t *p_buf,
+					   uint32_t seq_num,
+					   uint32_t size,
+					   bool     is_valid);
+};
 
 /**
  * Open a UART bus given an opaque pointer representing the bus's properties.
@@ -52,6 +102,58 @@ int32_t hub_uart_device_write(int         uart_bus_hdl,
 							  const void *p_buffer,
 							  uint32_t    count);
 
+/**
+ * Perform a gathered write of several buffers on the UART device on the
+ * given bus handle, with a single drain at the end.
+ */
+int32_t hub_uart_device_writev(int                 uart_bus_hdl,
+							   const struct iovec *p_iov,
+							   int                 iovcnt);
+
+/**
+ * Perform a scattered read into several buffers on the UART device on the
+ * given bus handle.
+ */
+int32_t hub_uart_device_readv(int                 uart_bus_hdl,
+							  const struct iovec *p_iov,
+							  int                 iovcnt);
+
+/**
+ * Change the baud rate of an open UART bus, waiting for pending output to
+ * go out at the old rate first.
+ */
+int32_t hub_uart_device_set_baudrate(int uart_bus_hdl, uint32_t baudrate);
+
+/**
+ * Turn RTS/CTS hardware flow control on or off on an open UART bus, once
+ * GARD has agreed to it with SET_UART_PARAMETERS.
+ */
+int32_t hub_uart_device_set_flow_control(int uart_bus_hdl, bool enable);
+
+/**
+ * Set the receiver of pushes on the open UART bus, refused if another one
+ * is set. Called with the bus held.
+ */
+int32_t hub_uart_set_push_sink(struct hub_uart_push_sink *p_sink);
+
+/**
+ * Stop giving pushes to the receiver set on the open UART bus.
+ * Called with the bus held.
+ */
+void hub_uart_clear_push_sink(struct hub_uart_push_sink *p_sink);
+
+/**
+ * Wait up to timeout_ms for received bytes on the UART device on the given
+ * bus handle, without taking them.
+ */
+int32_t hub_uart_device_wait_rx(int uart_bus_hdl, uint32_t timeout_ms);
+
+/**
+ * Read the pushes that have come in on the UART device on the given bus
+ * handle while no command was running. Called with the bus held.
+ */
+int32_t hub_uart_device_drain_pushes(int uart_bus_hdl);
+
 /**
  * TBD-DPN: Revisit the return code for this call.
  * Also, change the bus_hdl to a bus context for supporting mutiple
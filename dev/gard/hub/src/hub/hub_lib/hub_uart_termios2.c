@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * The Linux termios2 interface lives in <asm/termbits.h>, which clashes with
+ * the glibc <termios.h> used by hub_uart.c. It is kept in its own translation
+ * unit so that the rest of the UART code can stay on the POSIX API.
+ */
+#include <sys/ioctl.h>
+#include <asm/termbits.h>
+
+#include "hub_uart_termios2.h"
+
+/**
+ * Program an arbitrary baud rate on an open UART using BOTHER.
+ * All other line settings are left as they are.
+ *
+ * @param: uart_bus_hdl is the handle to the open UART bus
+ * @param: baudrate is the rate in bits/sec for both directions
+ *
+ * @return: 0 on success, -1 on failure
+ */
+int32_t hub_uart_termios2_set_baudrate(int uart_bus_hdl, uint32_t baudrate)
+{
+	struct termios2 uart_tty2;
+
+	if (ioctl(uart_bus_hdl, TCGETS2, &uart_tty2)) {
+		hub_pr_err("Error in TCGETS2\n");
+		return -1;
+	}
+
+	uart_tty2.c_cflag &= ~CBAUD;
+	uart_tty2.c_cflag |= BOTHER;
+	uart_tty2.c_ispeed = baudrate;
+	uart_tty2.c_ospeed = baudrate;
+
+	if (ioctl(uart_bus_hdl, TCSETS2, &uart_tty2)) {
+		hub_pr_err("Error in TCSETS2 for baudrate %u\n", baudrate);
+		return -1;
+	}
+
+	return 0;
+}
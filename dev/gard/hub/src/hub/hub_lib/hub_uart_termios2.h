@@ -0,0 +1,19 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_UART_TERMIOS2_H__
+#define __HUB_UART_TERMIOS2_H__
+
+/* Must not pull in <termios.h>, see hub_uart_termios2.c */
+#include "gard_info.h"
+
+/**
+ * Program an arbitrary baud rate on an open UART using BOTHER.
+ */
+int32_t hub_uart_termios2_set_baudrate(int uart_bus_hdl, uint32_t baudrate);
+
+#endif /* __HUB_UART_TERMIOS2_H__ */
@@ -14,24 +14,22 @@
  */
 
 /**
- * TBD-DPN: We support only 1 USB device for now
- * This variable maps the int bus_hdl to its libusb counterpart
+ * This table maps the int bus_hdl of every open USB bus to its libusb
+ * counterpart: bus_hdl N is held in entry N-1, so that the first USB bus
+ * opened gets bus_hdl 1 as expected by the existing Python code.
  *
- * We initialize this structure to invalid / NULL entries
- * to indicate default condition on boot / bus close-disconnect.
+ * Entries are NULL for USB busses that are not open.
  */
-static struct usb_bus_hdl_map hdl_map = {
-	.bus_hdl    = HUB_USB_INVALID_BUS_HDL,
-	.libusb_hdl = NULL,
-};
+static struct usb_bus_hdl_map *usb_bus_hdl_maps[HUB_USB_MAX_BUSSES];
 
 /**
- * TBD-DPN: We support only 1 USB device for now
- * This variable indicates whether another kernel driver
- * attached to our device of interest had to be detached, so
- * that we remember to re-attach it when we are done.
+ * Protects usb_bus_hdl_maps[] and the num_users / is_closing of its entries
+ * against busses being opened / closed in parallel. Transfers on an open bus
+ * hold it only to take and drop their hold on the bus, see
+ * hub_usb_hold_dev(), then only take that bus's own locks.
  */
-static int kernelDriverDetached = 0;
+static hub_mutex_t    usb_bus_hdl_maps_mutex = HUB_MUTEX_INITIALIZER;
+static hub_cond_var_t usb_bus_hdl_maps_cond  = HUB_COND_VAR_INITIALIZER;
 
 /* Listing of static functions defined in this file */
 
@@ -48,29 +46,212 @@ static int kernelDriverDetached = 0;
  */
 static int32_t
 	hub_usb_device_reg_write(libusb_device_handle *hdl, int addr, int data);
+static inline struct usb_bus_hdl_map *hub_usb_get_dev(int usb_bus_hdl);
+static struct usb_bus_hdl_map        *hub_usb_hold_dev(int usb_bus_hdl);
+static void hub_usb_drop_dev(struct usb_bus_hdl_map *p_dev);
+static libusb_device_handle *
+	hub_usb_find_device(libusb_context                *p_libusb_ctx,
+						struct hub_gard_bus_usb_props *p_usb_ctx);
+static inline void hub_usb_pack_reg_value(uint8_t *buf, uint32_t data);
+static inline struct hub_usb_axi_window *
+	hub_usb_get_axi_window(struct usb_bus_hdl_map *p_dev, uint16_t base);
+static inline void
+	hub_usb_invalidate_axi_window(struct hub_usb_axi_window *p_win);
+static int32_t hub_usb_device_set_window(struct usb_bus_hdl_map *p_dev,
+										 uint16_t                base,
+										 uint32_t                addr);
 static int32_t hub_usb_device_burst_write(libusb_device_handle *hdl,
 										  unsigned char        *data,
-										  int                   length);
+										  int                  *length);
 static int32_t hub_usb_device_burst_read(libusb_device_handle *hdl,
 										 unsigned char        *data,
 										 int                  *length);
 
+/**
+ * The asynchronous engine follows the same 2 steps per burst, but the
+ * transfers are submitted from libusb completion callbacks running in the
+ * USB event thread.
+ */
+static enum hub_ret_code hub_usb_async_start(struct usb_bus_hdl_map *p_dev);
+static void              hub_usb_async_stop(struct usb_bus_hdl_map *p_dev);
+static void             *hub_usb_async_event_thread(void *p_args);
+static int  hub_usb_async_submit_step(struct usb_bus_hdl_map   *p_dev,
+									  struct hub_usb_async_req *p_req);
+static void hub_usb_async_finish(struct usb_bus_hdl_map *p_dev,
+								 enum hub_ret_code       ret);
+static void LIBUSB_CALL hub_usb_async_ctrl_cb(struct libusb_transfer *p_xfer);
+static void LIBUSB_CALL hub_usb_async_bulk_cb(struct libusb_transfer *p_xfer);
+static int32_t hub_usb_async_claim(struct usb_bus_hdl_map *p_dev);
+static void hub_usb_async_release(struct usb_bus_hdl_map *p_dev);
+static int LIBUSB_CALL hub_usb_hotplug_cb(libusb_context      *p_libusb_ctx,
+										  libusb_device       *p_device,
+										  libusb_hotplug_event event,
+										  void                *p_user_data);
+
+/**
+ * Get the libusb counterpart of a USB bus handle.
+ *
+ * Called with usb_bus_hdl_maps_mutex held.
+ *
+ * @param: usb_bus_hdl Handle to the USB bus
+ *
+ * @return: the bus's usb_bus_hdl_map, NULL if the handle is not valid
+ */
+static inline struct usb_bus_hdl_map *hub_usb_get_dev(int usb_bus_hdl)
+{
+	if ((usb_bus_hdl < 1) || (usb_bus_hdl > HUB_USB_MAX_BUSSES)) {
+		return NULL;
+	}
+
+	return usb_bus_hdl_maps[usb_bus_hdl - 1];
+}
+
+/**
+ * Get the libusb counterpart of a USB bus handle for a transfer call, and
+ * hold it: the bus is not closed until hub_usb_drop_dev() is called.
+ *
+ * @param: usb_bus_hdl Handle to the USB bus
+ *
+ * @return: the bus's usb_bus_hdl_map, NULL if the handle is not valid or
+ * 		 the bus is being closed
+ */
+static struct usb_bus_hdl_map *hub_usb_hold_dev(int usb_bus_hdl)
+{
+	struct usb_bus_hdl_map *p_dev;
+
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+	p_dev = hub_usb_get_dev(usb_bus_hdl);
+	if ((NULL != p_dev) && p_dev->is_closing) {
+		p_dev = NULL;
+	}
+	if (NULL != p_dev) {
+		p_dev->num_users++;
+	}
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+
+	return p_dev;
+}
+
+/**
+ * Drop the hold taken on a USB bus by hub_usb_hold_dev(), and wake a close
+ * waiting for the last one.
+ */
+static void hub_usb_drop_dev(struct usb_bus_hdl_map *p_dev)
+{
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+	if (0 == --p_dev->num_users) {
+		hub_cond_var_broadcast(&usb_bus_hdl_maps_cond);
+	}
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+}
+
+/**
+ * Find and open the USB device described by the bus's properties.
+ *
+ * A device has to match the vendor and product IDs. If a port path and / or
+ * a serial number is given for the bus, these have to match too, which is
+ * how one of several identical GARD boards on a host is picked.
+ *
+ * @param: p_libusb_ctx is the libusb context of the bus
+ * @param: p_usb_ctx holds the bus's properties
+ *
+ * @return: libusb device handle of the opened device, NULL if none found
+ */
+static libusb_device_handle *
+	hub_usb_find_device(libusb_context                *p_libusb_ctx,
+						struct hub_gard_bus_usb_props *p_usb_ctx)
+{
+	int                             i, j, ret, num_ports;
+	ssize_t                         num_devs;
+	libusb_device                 **p_devs = NULL;
+	libusb_device_handle           *hdl    = NULL;
+	struct libusb_device_descriptor desc;
+	uint8_t                         ports[HUB_USB_MAX_PORT_DEPTH];
+	char                            port_path[HUB_USB_PORT_PATH_LEN];
+	unsigned char                   serial[HUB_USB_SERIAL_LEN];
+	int                             len;
+
+	num_devs = libusb_get_device_list(p_libusb_ctx, &p_devs);
+	if (num_devs < 0) {
+		hub_pr_err("Error listing USB devices: %zd\n", num_devs);
+		return NULL;
+	}
+
+	for (i = 0; (i < num_devs) && (NULL == hdl); i++) {
+		ret = libusb_get_device_descriptor(p_devs[i], &desc);
+		if ((0 != ret) || (p_usb_ctx->vendor_id != desc.idVendor) ||
+			(p_usb_ctx->product_id != desc.idProduct)) {
+			continue;
+		}
+
+		/* Port path in the form used by sysfs: <bus>-<port>[.<port>...] */
+		if ('\0' != p_usb_ctx->port_path[0]) {
+			num_ports =
+				libusb_get_port_numbers(p_devs[i], ports, sizeof(ports));
+			if (num_ports <= 0) {
+				continue;
+			}
+
+			len = snprintf(port_path, sizeof(port_path), "%u-%u",
+						   libusb_get_bus_number(p_devs[i]), ports[0]);
+			for (j = 1; (j < num_ports) && (len < sizeof(port_path)); j++) {
+				len += snprintf(port_path + len, sizeof(port_path) - len,
+								".%u", ports[j]);
+			}
+
+			if (strcmp(port_path, p_usb_ctx->port_path)) {
+				continue;
+			}
+		}
+
+		ret = libusb_open(p_devs[i], &hdl);
+		if (0 != ret) {
+			hub_pr_dbg("Error opening USB device: %d\n", ret);
+			hdl = NULL;
+			continue;
+		}
+
+		if ('\0' != p_usb_ctx->serial_number[0]) {
+			ret = (0 == desc.iSerialNumber)
+					  ? LIBUSB_ERROR_NOT_FOUND
+					  : libusb_get_string_descriptor_ascii(
+							hdl, desc.iSerialNumber, serial, sizeof(serial));
+			if ((ret < 0) ||
+				strcmp((const char *)serial, p_usb_ctx->serial_number)) {
+				libusb_close(hdl);
+				hdl = NULL;
+				continue;
+			}
+		}
+	}
+
+	libusb_free_device_list(p_devs, 1);
+
+	return hdl;
+}
+
 /**
  * TBD-DPN: Revisit the return value for this call.
  *
  * Open an USB bus given an opaque pointer representing the bus's properties.
  * Returns a bus handle on success.
  *
+ * Every USB bus gets its own libusb context and device handle, so that
+ * several USB GARDs can be driven from one HUB instance.
+ *
  * Any further operation on the said USB bus has to use this bus handle.
  *
  * @param: param an opaque pointer containing the bus's properties.
  *
- * @return: 1 is the bus handle for success in accordance with Python
+ * @return: bus handle (>= 1) for success, the first bus opened gets 1 in
+ * 		 accordance with Python
  * 		 -1 for failure
  */
 int32_t hub_usb_device_open(void *param)
 {
 	int32_t                        ret;
+	int                            slot;
+	struct usb_bus_hdl_map        *p_dev = NULL;
 
 	struct hub_gard_bus_usb_props *p_usb_ctx =
 		(struct hub_gard_bus_usb_props *)param;
@@ -80,59 +261,127 @@ int32_t hub_usb_device_open(void *param)
 		return p_usb_ctx->bus_hdl;
 	}
 
-	ret = libusb_init(0);
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+
+	for (slot = 0; slot < HUB_USB_MAX_BUSSES; slot++) {
+		if (NULL == usb_bus_hdl_maps[slot]) {
+			break;
+		}
+	}
+
+	if (HUB_USB_MAX_BUSSES == slot) {
+		hub_pr_err("Too many USB busses open\n");
+		goto err_usb_open_1;
+	}
+
+	p_dev = calloc(1, sizeof(struct usb_bus_hdl_map));
+	if (NULL == p_dev) {
+		hub_pr_err("Error allocating USB bus context\n");
+		goto err_usb_open_1;
+	}
+
+	ret = libusb_init(&p_dev->p_libusb_ctx);
 	if (0 != ret) {
 		hub_pr_err("Error in libusb_init\n");
-		goto err_usb_open_1;
+		goto err_usb_open_2;
 	}
 
-	/* Open device using VID and PID */
-	hdl_map.libusb_hdl = libusb_open_device_with_vid_pid(
-		0, p_usb_ctx->vendor_id, p_usb_ctx->product_id);
-	if (NULL == hdl_map.libusb_hdl) {
+	/* Open device using VID and PID, and port path / serial if given */
+	p_dev->libusb_hdl = hub_usb_find_device(p_dev->p_libusb_ctx, p_usb_ctx);
+	if (NULL == p_dev->libusb_hdl) {
 		hub_pr_err("Error in libusb_open_device\n");
-		goto err_usb_open_2;
+		goto err_usb_open_3;
 	}
 
 	/* Detach device from kernel driver */
-	if (libusb_kernel_driver_active(hdl_map.libusb_hdl, 0)) {
-		ret = libusb_detach_kernel_driver(hdl_map.libusb_hdl, 0);
+	if (libusb_kernel_driver_active(p_dev->libusb_hdl, 0)) {
+		ret = libusb_detach_kernel_driver(p_dev->libusb_hdl, 0);
 
 		if (0 == ret) {
-			kernelDriverDetached = 1;
+			p_dev->kernel_driver_detached = true;
 		} else {
 			hub_pr_err("Error detaching kernel driver\n");
-			goto err_usb_open_3;
+			goto err_usb_open_4;
 		}
 	}
 
 	/* Claim interface */
-	ret = libusb_claim_interface(hdl_map.libusb_hdl, 0);
+	ret = libusb_claim_interface(p_dev->libusb_hdl, 0);
 	if (0 != ret) {
 		hub_pr_err("Error claiming interface\n");
-		goto err_usb_open_4;
+		goto err_usb_open_5;
+	}
+
+	/* Bursts are split as per the bus's configured burst size */
+	p_dev->burst_size  = p_usb_ctx->burst_size ? p_usb_ctx->burst_size
+											   : HUB_USB_DEFAULT_BURST_SZ;
+	p_dev->async_depth = p_usb_ctx->async_depth
+							 ? p_usb_ctx->async_depth
+							 : HUB_USB_ASYNC_DEFAULT_DEPTH;
+
+	/* Device state of the AXI windows is unknown until first written */
+	hub_usb_invalidate_axi_window(&p_dev->axi_wr_win);
+	hub_usb_invalidate_axi_window(&p_dev->axi_rd_win);
+
+	ret = hub_usb_async_start(p_dev);
+	if (HUB_SUCCESS != ret) {
+		hub_pr_err("Error starting USB async engine\n");
+		goto err_usb_open_6;
 	}
 
 	hub_pr_dbg("Opened USB device with VID:0x%x, PID:0x%x\n",
 			   p_usb_ctx->vendor_id, p_usb_ctx->product_id);
 
-	/* We return 1 to conform with the existing Python code */
-	hdl_map.bus_hdl    = 1;
-	p_usb_ctx->bus_hdl = hdl_map.bus_hdl;
-	p_usb_ctx->is_open = true;
-	return hdl_map.bus_hdl;
+	p_dev->bus_hdl          = slot + 1;
+	p_dev->p_props          = p_usb_ctx;
+	usb_bus_hdl_maps[slot]  = p_dev;
+
+	p_usb_ctx->p_hdl_map    = p_dev;
+	p_usb_ctx->bus_hdl      = p_dev->bus_hdl;
+	p_usb_ctx->is_open      = true;
+
+	/**
+	 * Departures are seen by the event thread of the async engine. Without
+	 * hotplug support, the health probe still finds a lost GARD.
+	 */
+	p_dev->is_gone     = false;
+	p_dev->has_hotplug = false;
+	if (libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+		ret = libusb_hotplug_register_callback(
+			p_dev->p_libusb_ctx, LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT, 0,
+			p_usb_ctx->vendor_id, p_usb_ctx->product_id,
+			LIBUSB_HOTPLUG_MATCH_ANY, hub_usb_hotplug_cb, p_dev,
+			&p_dev->hotplug_hdl);
+		if (LIBUSB_SUCCESS == ret) {
+			p_dev->has_hotplug = true;
+		} else {
+			hub_pr_warn("USB hotplug events not available: %s\n",
+						libusb_error_name(ret));
+		}
+	}
+
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+
+	return p_usb_ctx->bus_hdl;
 
+err_usb_open_6:
+	libusb_release_interface(p_dev->libusb_hdl, 0);
+err_usb_open_5:
+	if (p_dev->kernel_driver_detached) {
+		libusb_attach_kernel_driver(p_dev->libusb_hdl, 0);
+	}
 err_usb_open_4:
-	libusb_attach_kernel_driver(hdl_map.libusb_hdl, 0);
+	libusb_close(p_dev->libusb_hdl);
 err_usb_open_3:
-	libusb_close(hdl_map.libusb_hdl);
+	libusb_exit(p_dev->p_libusb_ctx);
 err_usb_open_2:
-	libusb_exit(0);
+	free(p_dev);
 err_usb_open_1:
-	hdl_map.bus_hdl    = -1;
-	p_usb_ctx->bus_hdl = hdl_map.bus_hdl;
-	p_usb_ctx->is_open = false;
-	return hdl_map.bus_hdl;
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+	p_usb_ctx->p_hdl_map = NULL;
+	p_usb_ctx->bus_hdl   = HUB_USB_INVALID_BUS_HDL;
+	p_usb_ctx->is_open   = false;
+	return p_usb_ctx->bus_hdl;
 }
 
 /**
@@ -147,51 +396,138 @@ err_usb_open_1:
  */
 int32_t hub_usb_device_close(int usb_bus_hdl)
 {
-	int32_t               ret;
-	libusb_device_handle *hdl = NULL;
+	int32_t                 ret;
+	libusb_device_handle   *hdl   = NULL;
+	struct usb_bus_hdl_map *p_dev = NULL;
 
 	if (HUB_USB_INVALID_BUS_HDL == usb_bus_hdl) {
 		hub_pr_dbg("Bus already closed / not open!\n");
 		return 1;
 	}
 
-	if (usb_bus_hdl != hdl_map.bus_hdl) {
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+
+	p_dev = hub_usb_get_dev(usb_bus_hdl);
+	if ((NULL == p_dev) || p_dev->is_closing) {
 		hub_pr_err("Invalid bus_hdl");
-		return -1;
+		goto err_usb_close_1;
 	}
 
-	hdl = hdl_map.libusb_hdl;
+	hdl = p_dev->libusb_hdl;
 	if (NULL == hdl) {
 		hub_pr_err("Invalid libusb_hdl\n");
-		return -1;
+		goto err_usb_close_1;
+	}
+
+	/* Let the transfer calls in progress finish, and no more start */
+	p_dev->is_closing = true;
+	while (0 != p_dev->num_users) {
+		hub_cond_var_wait(&usb_bus_hdl_maps_cond, &usb_bus_hdl_maps_mutex);
+	}
+
+	/*
+	 * The bus is ours now. Let go of the maps for the teardown: joining the
+	 * event thread runs completion callbacks, which may call back into this
+	 * file, and the other buses must not wait behind this one.
+	 */
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+
+	if (p_dev->has_hotplug) {
+		libusb_hotplug_deregister_callback(p_dev->p_libusb_ctx,
+										   p_dev->hotplug_hdl);
+		p_dev->has_hotplug = false;
 	}
 
-	/* Release interface */
+	/* Fail / drain pending asynchronous transfers before letting go */
+	hub_usb_async_stop(p_dev);
+
+	/* Release interface, already gone with a device that has left */
 	ret = libusb_release_interface(hdl, 0);
 
-	if (0 != ret) {
+	if ((0 != ret) && (LIBUSB_ERROR_NO_DEVICE != ret)) {
 		hub_pr_err("Error releasing interface\n");
-		return -1;
+		goto err_usb_close_2;
 	}
 
 	/* Attach interface to kernel driver back */
-	if (kernelDriverDetached) {
+	if (p_dev->kernel_driver_detached) {
 		libusb_attach_kernel_driver(hdl, 0);
 	}
 
 	libusb_close(hdl);
 
-	/* Shutdown libusb */
-	libusb_exit(0);
+	/* Shutdown this bus's libusb context */
+	libusb_exit(p_dev->p_libusb_ctx);
 
-	/* Reset our hdl_map variables */
-	hdl_map.bus_hdl    = HUB_USB_INVALID_BUS_HDL;
-	hdl_map.libusb_hdl = NULL;
+	/* Reset the bus's properties and free its usb_bus_hdl_map */
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+	p_dev->p_props->p_hdl_map        = NULL;
+	p_dev->p_props->bus_hdl          = HUB_USB_INVALID_BUS_HDL;
+	p_dev->p_props->is_open          = false;
+	usb_bus_hdl_maps[usb_bus_hdl - 1] = NULL;
+	free(p_dev);
+
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
 
 	hub_pr_dbg("Closed bus_hdl %d\n", usb_bus_hdl);
 
 	/* We return 1 here since that's expected by Python */
 	return 1;
+
+err_usb_close_2:
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+	p_dev->is_closing = false;
+err_usb_close_1:
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+	return -1;
+}
+
+/**
+ * Tell if the device of a USB bus has left.
+ *
+ * @param: usb_bus_hdl Handle to the USB bus
+ *
+ * @return: true if the device has left or the bus is not open
+ */
+bool hub_usb_device_is_gone(int usb_bus_hdl)
+{
+	struct usb_bus_hdl_map *p_dev;
+	bool                    is_gone = true;
+
+	hub_mutex_lock(&usb_bus_hdl_maps_mutex);
+	p_dev = hub_usb_get_dev(usb_bus_hdl);
+	if (NULL != p_dev) {
+		is_gone = p_dev->is_gone;
+	}
+	hub_mutex_unlock(&usb_bus_hdl_maps_mutex);
+
+	return is_gone;
+}
+
+/**
+ * libusb hotplug callback of a USB bus, run in its USB event thread. Only
+ * flags the departure: the bus is closed and opened again by the health
+ * monitor, not from within libusb event handling.
+ *
+ * @return: 0 to stay registered
+ */
+static int LIBUSB_CALL hub_usb_hotplug_cb(libusb_context      *p_libusb_ctx,
+										  libusb_device       *p_device,
+										  libusb_hotplug_event event,
+										  void                *p_user_data)
+{
+	struct usb_bus_hdl_map *p_dev = (struct usb_bus_hdl_map *)p_user_data;
+
+	(void)p_libusb_ctx;
+
+	if ((LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT == event) &&
+		(p_device == libusb_get_device(p_dev->libusb_hdl))) {
+		hub_pr_warn("USB device VID:0x%x, PID:0x%x has left\n",
+					p_dev->p_props->vendor_id, p_dev->p_props->product_id);
+		p_dev->is_gone = true;
+	}
+
+	return 0;
 }
 
 /* TBD-DPN: Revisit optimizations and changes in subsequent releases */
@@ -203,36 +539,128 @@ static int32_t
 
 	uint8_t buf[4];
 
-	buf[0] = (unsigned char)(data & 0xff);
-	buf[1] = (unsigned char)((data >> 8) & 0xff);
-	buf[2] = (unsigned char)((data >> 16) & 0xff);
-	buf[3] = (unsigned char)((data >> 24) & 0xff);
+	hub_usb_pack_reg_value(buf, (uint32_t)data);
 
-	ret    = libusb_control_transfer(
-        hdl,
-        LIBUSB_ENDPOINT_OUT | LIBUSB_REQUEST_TYPE_VENDOR |
-            LIBUSB_RECIPIENT_DEVICE,
-        LSCVIP_VX_WREG_WRITE, 0x00, (uint16_t)addr, buf, 4, ENDPOINT_TIMEOUT);
-
-	/* Register write needs 1 usec sleep in case of burst write */
-	usleep(1);
+	/**
+	 * The vendor request is complete once the device has acknowledged the
+	 * status stage, which is when libusb_control_transfer() returns. This
+	 * replaces the usleep(1) of lscVipUsb, which costs 50-100 usec on Linux
+	 * for every register write.
+	 */
+	ret = libusb_control_transfer(
+		hdl,
+		LIBUSB_ENDPOINT_OUT | LIBUSB_REQUEST_TYPE_VENDOR |
+			LIBUSB_RECIPIENT_DEVICE,
+		LSCVIP_VX_WREG_WRITE, 0x00, (uint16_t)addr, buf, 4, ENDPOINT_TIMEOUT);
 
 	return ret;
 }
 
+/**
+ * Pack a 32-bit AXI register value as the little-endian payload of a
+ * LSCVIP_VX_WREG_WRITE vendor request.
+ *
+ * @param: buf is the 4-byte payload to fill
+ * @param: data is the register value
+ */
+static inline void hub_usb_pack_reg_value(uint8_t *buf, uint32_t data)
+{
+	buf[0] = (uint8_t)(data & 0xff);
+	buf[1] = (uint8_t)((data >> 8) & 0xff);
+	buf[2] = (uint8_t)((data >> 16) & 0xff);
+	buf[3] = (uint8_t)((data >> 24) & 0xff);
+}
+
+/**
+ * Get the cached state of the AXI read / write window of the USB device.
+ *
+ * @param: base is AXIRBASE or AXIWBASE
+ *
+ * @return: pointer to the cached window state
+ */
+static inline struct hub_usb_axi_window *
+	hub_usb_get_axi_window(struct usb_bus_hdl_map *p_dev, uint16_t base)
+{
+	return (AXIRBASE == base) ? &p_dev->axi_rd_win : &p_dev->axi_wr_win;
+}
+
+/**
+ * Forget the cached state of an AXI window, so that the next transfer
+ * through it rewrites both AXI registers. Used whenever a transfer through
+ * the window fails and the device state is unknown.
+ *
+ * @param: p_win is the window to invalidate
+ */
+static inline void
+	hub_usb_invalidate_axi_window(struct hub_usb_axi_window *p_win)
+{
+	p_win->is_configured = false;
+	p_win->is_addr_valid = false;
+}
+
+/**
+ * Point the AXI read / write window of the USB device at a GARD address
+ * ahead of a burst.
+ *
+ * The AXI config and base registers are only written when they do not
+ * already hold the wanted values, so back to back transfers through the same
+ * window skip the config write, and repeated transfers at the same address
+ * skip both writes.
+ *
+ * @param: hdl is the libusb device handle
+ * @param: base is AXIRBASE or AXIWBASE
+ * @param: addr is the GARD address of the next burst
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int32_t hub_usb_device_set_window(struct usb_bus_hdl_map *p_dev,
+										 uint16_t                base,
+										 uint32_t                addr)
+{
+	int32_t                    ret;
+	struct hub_usb_axi_window *p_win = hub_usb_get_axi_window(p_dev, base);
+
+	if (!p_win->is_configured) {
+		ret = hub_usb_device_reg_write(p_dev->libusb_hdl, base + 1,
+									   HUB_USB_AXI_CONFIG);
+		if (4 != ret) {
+			goto err_set_window_1;
+		}
+		p_win->is_configured = true;
+	}
+
+	if (!p_win->is_addr_valid || (p_win->addr != addr)) {
+		ret = hub_usb_device_reg_write(p_dev->libusb_hdl, base, addr);
+		if (4 != ret) {
+			goto err_set_window_1;
+		}
+		p_win->addr          = addr;
+		p_win->is_addr_valid = true;
+	}
+
+	return 0;
+
+err_set_window_1:
+	hub_pr_err("USB AXI window write failed @ 0x%x: %d\n", addr, ret);
+	hub_usb_invalidate_axi_window(p_win);
+	return -1;
+}
+
 /* TBD-DPN: Revisit optimizations and changes in subsequent releases */
 /* Not commenting - This function is directly copied from lscVipUSB */
 static int32_t hub_usb_device_burst_write(libusb_device_handle *hdl,
 										  unsigned char        *data,
-										  int                   length)
+										  int                  *length)
 {
 	int32_t ret;
 	int     nwrite;
 	/* TBD-DPN: Can this be auto-determined ? */
 	unsigned char ep = 0x04;
 
-	ret =
-		libusb_bulk_transfer(hdl, ep, data, length, &nwrite, ENDPOINT_TIMEOUT);
+	nwrite           = *length;
+	*length          = 0;
+
+	ret = libusb_bulk_transfer(hdl, ep, data, nwrite, length, ENDPOINT_TIMEOUT);
 
 	return ret;
 }
@@ -243,61 +671,82 @@ static int32_t hub_usb_device_burst_write(libusb_device_handle *hdl,
  * Perform a write operation on the USB bus represented by the given bus
  * handle.
  *
+ * The write is split into bursts of the bus's configured burst size, with
+ * the last burst carrying whatever remains. Before each burst the AXI write
+ * base register is pointed at the GARD address the burst lands at.
+ *
  * @param: usb_bus_hdl Handle to the USB bus
  * @param: p_buffer Pointer to a buffer with data for writing
- * @param: count Number of bytes to write - SHOULD BE 4K ONLY
+ * @param: count Number of bytes to write
  *
- * TBD-DPN: Follows Python code assumptions; needs to change.
- * @return: 1 for success, -1 for error
+ * @return: count on success, the bytes written before the failing burst
+ * 		if any, -1 otherwise
  */
 int32_t
 	hub_usb_device_write(int usb_bus_hdl, const void *p_buffer, uint32_t count)
 {
-	int32_t                 ret, i;
-	int                     wconfig   = 255;
+	int32_t                 ret;
+	int                     nwrite;
+	uint32_t                burst_len, done = 0;
 	libusb_device_handle   *hdl       = NULL;
+	struct usb_bus_hdl_map *p_dev     = NULL;
 	struct hub_usb_ops_map *p_usb_ops = NULL;
 
 	p_usb_ops                         = (struct hub_usb_ops_map *)p_buffer;
 
-	/* This variable is typecast to int* to adhere to libusb call */
-	int     *data                     = (int *)(p_usb_ops->p_buffer);
+	uint8_t *data                     = (uint8_t *)(p_usb_ops->p_buffer);
 	uint32_t addr                     = p_usb_ops->addr;
 
-	if (usb_bus_hdl != hdl_map.bus_hdl) {
+	p_dev = hub_usb_hold_dev(usb_bus_hdl);
+	if (NULL == p_dev) {
 		hub_pr_err("Invalid bus_hdl\n");
 		return -1;
 	}
 
-	hdl = hdl_map.libusb_hdl;
+	hdl = p_dev->libusb_hdl;
 	if (NULL == hdl) {
 		hub_pr_err("Invalid libusb_hdl\n");
+		hub_usb_drop_dev(p_dev);
 		return -1;
 	}
 
-	ret = hub_usb_device_reg_write(hdl, AXIWBASE + 1, wconfig);
-	if (4 != ret) {
+	/* The AXI window is shared with any queued asynchronous transfers */
+	if (0 != hub_usb_async_claim(p_dev)) {
+		hub_pr_err("USB async engine stopping\n");
+		hub_usb_drop_dev(p_dev);
 		return -1;
 	}
 
-	for (i = 0; i < 2; i++) {
-		/* TBD-DPN: clean up the ret value checks*/
-		ret = hub_usb_device_reg_write(hdl, AXIWBASE, addr + 2048 * i);
-		if (4 != ret) {
-			return -1;
+	while (count > 0) {
+		burst_len = hub_min_uint32(count, p_dev->burst_size);
+
+		if (0 != hub_usb_device_set_window(p_dev, AXIWBASE, addr)) {
+			goto err_usb_write_1;
 		}
-		ret = hub_usb_device_burst_write(hdl, (unsigned char *)(data), 2048);
-		if (0 != ret) {
-			return -1;
+
+		nwrite = burst_len;
+		ret    = hub_usb_device_burst_write(hdl, data, &nwrite);
+		if ((0 != ret) || (burst_len != (uint32_t)nwrite)) {
+			hub_pr_err("USB burst write failed @ 0x%x: %d\n", addr, ret);
+			hub_usb_invalidate_axi_window(hub_usb_get_axi_window(p_dev, AXIWBASE));
+			goto err_usb_write_1;
 		}
 
-		data += 512;
+		data  += burst_len;
+		addr  += burst_len;
+		done  += burst_len;
+		count -= burst_len;
 	}
 
-	(void)ret;
+	hub_usb_async_release(p_dev);
+	hub_usb_drop_dev(p_dev);
 
-	/* TBD-DPN: we return 1 to keep Python code happy */
-	return 1;
+	return (int32_t)done;
+
+err_usb_write_1:
+	hub_usb_async_release(p_dev);
+	hub_usb_drop_dev(p_dev);
+	return done ? (int32_t)done : -1;
 }
 
 /* TBD-DPN: Revisit optimizations and changes in subsequent releases */
@@ -324,61 +773,599 @@ static int32_t hub_usb_device_burst_read(libusb_device_handle *hdl,
  *
  * Perform a read operation on the USB bus represented by the given bus handle.
  *
+ * The read is split into bursts of the bus's configured burst size, with
+ * the last burst carrying whatever remains. Before each burst the AXI read
+ * base register is pointed at the GARD address the burst is fetched from.
+ *
  * @param: usb_bus_hdl Handle to the USB bus
  * @param: p_buffer Pointer to a buffer to be filled by the read
- * @param: count Number of bytes to read - SHOULD BE 4K ONLY
+ * @param: count Number of bytes to read
  *
- * TBD-DPN: Follows Python code assumptions; needs to change.
- * @return: 1 for success, -1 for error
+ * @return: count on success, the bytes read before the failing burst
+ * 		if any, -1 otherwise
  */
 int32_t hub_usb_device_read(int usb_bus_hdl, void *p_buffer, uint32_t count)
 {
-	int32_t                 ret, i, nread;
-	int                     rconfig   = 255;
+	int32_t                 ret;
+	int                     nread;
+	uint32_t                burst_len, done = 0;
 	libusb_device_handle   *hdl       = NULL;
+	struct usb_bus_hdl_map *p_dev     = NULL;
 	struct hub_usb_ops_map *p_usb_ops = NULL;
 
 	p_usb_ops                         = (struct hub_usb_ops_map *)p_buffer;
 
-	/* This variable is typecast to int* to adhere to libusb call */
-	int     *data                     = (int *)(p_usb_ops->p_buffer);
+	uint8_t *data                     = (uint8_t *)(p_usb_ops->p_buffer);
 	uint32_t addr                     = p_usb_ops->addr;
 
-	if (usb_bus_hdl != hdl_map.bus_hdl) {
+	p_dev = hub_usb_hold_dev(usb_bus_hdl);
+	if (NULL == p_dev) {
 		hub_pr_err("Invalid bus_hdl\n");
 		return -1;
 	}
 
-	hdl = hdl_map.libusb_hdl;
+	hdl = p_dev->libusb_hdl;
 	if (NULL == hdl) {
 		hub_pr_err("Invalid libusb_hdl\n");
+		hub_usb_drop_dev(p_dev);
 		return -1;
 	}
 
-	ret = hub_usb_device_reg_write(hdl, AXIRBASE + 1, rconfig);
-	if (4 != ret) {
+	/* The AXI window is shared with any queued asynchronous transfers */
+	if (0 != hub_usb_async_claim(p_dev)) {
+		hub_pr_err("USB async engine stopping\n");
+		hub_usb_drop_dev(p_dev);
 		return -1;
 	}
 
-	for (i = 0; i < 2; i++) {
-		/* TBD-DPN: clean up the ret value checks*/
-		ret = hub_usb_device_reg_write(hdl, AXIRBASE, addr + 2048 * i);
-		if (4 != ret) {
-			return -1;
+	while (count > 0) {
+		burst_len = hub_min_uint32(count, p_dev->burst_size);
+
+		if (0 != hub_usb_device_set_window(p_dev, AXIRBASE, addr)) {
+			goto err_usb_read_1;
 		}
 
-		nread = 2048;
-		ret   = hub_usb_device_burst_read(hdl, (unsigned char *)(data), &nread);
-		if (2048 != nread) {
-			return -1;
+		nread = burst_len;
+		ret   = hub_usb_device_burst_read(hdl, data, &nread);
+		if ((0 != ret) || (burst_len != (uint32_t)nread)) {
+			hub_pr_err("USB burst read failed @ 0x%x: %d\n", addr, ret);
+			hub_usb_invalidate_axi_window(hub_usb_get_axi_window(p_dev, AXIRBASE));
+			goto err_usb_read_1;
 		}
 
-		data += 512;
-		ret   = (nread == 2048);
+		data  += burst_len;
+		addr  += burst_len;
+		done  += burst_len;
+		count -= burst_len;
 	}
 
-	(void)ret;
+	hub_usb_async_release(p_dev);
+	hub_usb_drop_dev(p_dev);
+
+	return (int32_t)done;
+
+err_usb_read_1:
+	hub_usb_async_release(p_dev);
+	hub_usb_drop_dev(p_dev);
+	return done ? (int32_t)done : -1;
+}
+
+/**
+ * Start the asynchronous transfer engine of the USB device: allocate the
+ * libusb transfers used by the engine and start the USB event thread.
+ *
+ * @return: HUB_SUCCESS on success
+ * 		 HUB_FAILURE_ASYNC_XFER on failure
+ */
+static enum hub_ret_code hub_usb_async_start(struct usb_bus_hdl_map *p_dev)
+{
+	enum hub_ret_code ret;
+
+	p_dev->async.p_ctrl_xfer = libusb_alloc_transfer(0);
+	p_dev->async.p_bulk_xfer = libusb_alloc_transfer(0);
+	if ((NULL == p_dev->async.p_ctrl_xfer) || (NULL == p_dev->async.p_bulk_xfer)) {
+		hub_pr_err("Error allocating libusb transfers\n");
+		goto err_async_start_1;
+	}
+
+	ret = hub_mutex_init(&p_dev->async.lock);
+	if (HUB_SUCCESS != ret) {
+		goto err_async_start_1;
+	}
+
+	ret = hub_cond_var_init(&p_dev->async.idle_cond_var);
+	if (HUB_SUCCESS != ret) {
+		goto err_async_start_2;
+	}
+
+	p_dev->async.is_busy         = false;
+	p_dev->async.terminate_flag  = false;
+	p_dev->async.p_inflight_xfer = NULL;
+	p_dev->async.num_waiters     = 0;
+	p_dev->async.num_queued      = 0;
+	p_dev->async.p_head          = NULL;
+	p_dev->async.p_tail          = NULL;
+
+	ret = hub_thread_create(&p_dev->async.event_thread,
+							&p_dev->async.event_thread_attr,
+							HUB_THREAD_CLASS_BUS_IO, "hub_usb_async",
+							hub_usb_async_event_thread, p_dev);
+	if (HUB_SUCCESS != ret) {
+		goto err_async_start_3;
+	}
+
+	p_dev->async.is_running = true;
+
+	return HUB_SUCCESS;
+
+err_async_start_3:
+	hub_cond_var_destroy(&p_dev->async.idle_cond_var);
+err_async_start_2:
+	hub_mutex_destroy(&p_dev->async.lock);
+err_async_start_1:
+	libusb_free_transfer(p_dev->async.p_ctrl_xfer);
+	libusb_free_transfer(p_dev->async.p_bulk_xfer);
+	p_dev->async.p_ctrl_xfer = NULL;
+	p_dev->async.p_bulk_xfer = NULL;
+	return HUB_FAILURE_ASYNC_XFER;
+}
+
+/**
+ * Stop the asynchronous transfer engine of the USB device.
+ *
+ * The transfer on the wire is cancelled, and it and all queued requests are
+ * completed with their failure code before the event thread exits. Threads
+ * still waiting for the engine to go idle are woken and let go before its
+ * primitives are destroyed.
+ */
+static void hub_usb_async_stop(struct usb_bus_hdl_map *p_dev)
+{
+	if (!p_dev->async.is_running) {
+		return;
+	}
+
+	hub_mutex_lock(&p_dev->async.lock);
+	p_dev->async.terminate_flag = true;
+	if (NULL != p_dev->async.p_inflight_xfer) {
+		libusb_cancel_transfer(p_dev->async.p_inflight_xfer);
+	}
+	hub_cond_var_broadcast(&p_dev->async.idle_cond_var);
+	hub_mutex_unlock(&p_dev->async.lock);
+	libusb_interrupt_event_handler(p_dev->p_libusb_ctx);
+
+	hub_thread_join(p_dev->async.event_thread, NULL);
+
+	/* Waiters see terminate_flag and leave; wait for the last one */
+	hub_mutex_lock(&p_dev->async.lock);
+	p_dev->async.is_busy = false;
+	hub_cond_var_broadcast(&p_dev->async.idle_cond_var);
+	while (0 != p_dev->async.num_waiters) {
+		hub_cond_var_wait(&p_dev->async.idle_cond_var, &p_dev->async.lock);
+	}
+	hub_mutex_unlock(&p_dev->async.lock);
+
+	libusb_free_transfer(p_dev->async.p_ctrl_xfer);
+	libusb_free_transfer(p_dev->async.p_bulk_xfer);
+	p_dev->async.p_ctrl_xfer = NULL;
+	p_dev->async.p_bulk_xfer = NULL;
+
+	hub_cond_var_destroy(&p_dev->async.idle_cond_var);
+	hub_mutex_destroy(&p_dev->async.lock);
+
+	p_dev->async.is_running = false;
+}
+
+/**
+ * The USB event thread. libusb runs the completion callbacks of the
+ * asynchronous engine from within this thread.
+ *
+ * The thread keeps handling events after termination is requested until
+ * the cancelled transfers have called back. It sleeps in libusb with no
+ * timeout of its own; hub_usb_async_stop() wakes it with
+ * libusb_interrupt_event_handler().
+ */
+static void *hub_usb_async_event_thread(void *p_args)
+{
+	struct usb_bus_hdl_map *p_dev = (struct usb_bus_hdl_map *)p_args;
+
+	while (!p_dev->async.terminate_flag || p_dev->async.is_busy) {
+		libusb_handle_events_completed(p_dev->p_libusb_ctx, NULL);
+	}
+
+	return NULL;
+}
+
+/**
+ * Submit the next transfer of a request.
+ *
+ * The AXI window is moved to the address of the next burst first, with an
+ * AXI register write for each of the config and base registers not already
+ * holding the wanted value. Once the window is in place the burst itself is
+ * submitted.
+ *
+ * Called with p_dev->async.lock held.
+ *
+ * @param: p_req is the request at the head of the queue
+ *
+ * @return: 0 on success, libusb error code on failure
+ */
+static int hub_usb_async_submit_step(struct usb_bus_hdl_map   *p_dev,
+									 struct hub_usb_async_req *p_req)
+{
+	int                        ret;
+	uint16_t                   base;
+	unsigned char              ep;
+	uint8_t                   *buf = p_dev->async.ctrl_buf;
+	struct hub_usb_axi_window *p_win;
+
+	base  = p_req->is_read ? AXIRBASE : AXIWBASE;
+	p_win = hub_usb_get_axi_window(p_dev, base);
+
+	if (!p_win->is_configured) {
+		p_dev->async.ctrl_is_config = true;
+		p_dev->async.ctrl_reg       = base + 1;
+		p_dev->async.ctrl_data      = HUB_USB_AXI_CONFIG;
+	} else if (!p_win->is_addr_valid || (p_win->addr != p_req->addr)) {
+		p_dev->async.ctrl_is_config = false;
+		p_dev->async.ctrl_reg       = base;
+		p_dev->async.ctrl_data      = p_req->addr;
+	} else {
+		/* Window is in place; straight to the burst */
+		/* TBD-DPN: Same fixed endpoints as the synchronous bursts */
+		ep               = p_req->is_read ? 0x81 : 0x04;
+		p_req->burst_len = hub_min_uint32(p_req->remaining, p_dev->burst_size);
+		libusb_fill_bulk_transfer(p_dev->async.p_bulk_xfer, p_dev->libusb_hdl,
+								  ep, p_req->data, p_req->burst_len,
+								  hub_usb_async_bulk_cb, p_dev,
+								  ENDPOINT_TIMEOUT);
+
+		ret = libusb_submit_transfer(p_dev->async.p_bulk_xfer);
+		if (0 == ret) {
+			p_dev->async.p_inflight_xfer = p_dev->async.p_bulk_xfer;
+		}
+
+		return ret;
+	}
+
+	libusb_fill_control_setup(buf,
+							  LIBUSB_ENDPOINT_OUT | LIBUSB_REQUEST_TYPE_VENDOR |
+								  LIBUSB_RECIPIENT_DEVICE,
+							  LSCVIP_VX_WREG_WRITE, 0x00, p_dev->async.ctrl_reg,
+							  sizeof(uint32_t));
+
+	hub_usb_pack_reg_value(buf + LIBUSB_CONTROL_SETUP_SIZE,
+						   p_dev->async.ctrl_data);
+
+	libusb_fill_control_transfer(p_dev->async.p_ctrl_xfer, p_dev->libusb_hdl,
+								 buf, hub_usb_async_ctrl_cb, p_dev,
+								 ENDPOINT_TIMEOUT);
+
+	ret = libusb_submit_transfer(p_dev->async.p_ctrl_xfer);
+	if (0 == ret) {
+		p_dev->async.p_inflight_xfer = p_dev->async.p_ctrl_xfer;
+	}
+
+	return ret;
+}
+
+/**
+ * Complete the request at the head of the queue with the given return code,
+ * call its completion callback and get the next request on the wire.
+ *
+ * Called with p_dev->async.lock held; the lock is dropped around the user
+ * callback. Going idle wakes every waiter on idle_cond_var, since both
+ * hub_usb_device_wait_async() and hub_usb_async_claim() wait on it.
+ *
+ * @param: ret is the return code to report for the head request
+ */
+static void hub_usb_async_finish(struct usb_bus_hdl_map *p_dev,
+								 enum hub_ret_code       ret)
+{
+	struct hub_usb_async_req *p_req;
+
+	while (NULL != (p_req = p_dev->async.p_head)) {
+		p_dev->async.p_head = p_req->p_next;
+		if (NULL == p_dev->async.p_head) {
+			p_dev->async.p_tail = NULL;
+		}
+		p_dev->async.num_queued--;
+
+		hub_mutex_unlock(&p_dev->async.lock);
+		if (NULL != p_req->cb_handler) {
+			p_req->cb_handler(p_req->p_cb_ctx, ret);
+		}
+		free(p_req);
+		hub_mutex_lock(&p_dev->async.lock);
+
+		p_req = p_dev->async.p_head;
+		if (NULL == p_req) {
+			break;
+		}
+
+		if (!p_dev->async.terminate_flag &&
+			(0 == hub_usb_async_submit_step(p_dev, p_req))) {
+			return;
+		}
+
+		ret = p_req->fail_code;
+	}
+
+	p_dev->async.is_busy = false;
+	hub_cond_var_broadcast(&p_dev->async.idle_cond_var);
+}
+
+/**
+ * Completion callback for the AXI register writes of the asynchronous engine.
+ * Records the new state of the AXI window and moves on to the next step.
+ */
+static void LIBUSB_CALL hub_usb_async_ctrl_cb(struct libusb_transfer *p_xfer)
+{
+	struct hub_usb_async_req  *p_req;
+	struct hub_usb_axi_window *p_win;
+	struct usb_bus_hdl_map    *p_dev = (struct usb_bus_hdl_map *)p_xfer->user_data;
+
+	hub_mutex_lock(&p_dev->async.lock);
+
+	p_req                     = p_dev->async.p_head;
+	p_win = hub_usb_get_axi_window(p_dev, p_req->is_read ? AXIRBASE : AXIWBASE);
+	p_dev->async.p_inflight_xfer = NULL;
+
+	if ((LIBUSB_TRANSFER_COMPLETED != p_xfer->status) ||
+		(sizeof(uint32_t) != (uint32_t)p_xfer->actual_length)) {
+		hub_pr_err("USB async AXI write failed @ 0x%x: %d\n", p_req->addr,
+				   p_xfer->status);
+		goto err_async_ctrl_cb;
+	}
+
+	if (p_dev->async.ctrl_is_config) {
+		p_win->is_configured = true;
+	} else {
+		p_win->addr          = p_dev->async.ctrl_data;
+		p_win->is_addr_valid = true;
+	}
+
+	if (0 != hub_usb_async_submit_step(p_dev, p_req)) {
+		hub_pr_err("Error submitting USB async transfer\n");
+		goto err_async_ctrl_cb;
+	}
+
+	hub_mutex_unlock(&p_dev->async.lock);
+	return;
+
+err_async_ctrl_cb:
+	hub_usb_invalidate_axi_window(p_win);
+	hub_usb_async_finish(p_dev, p_req->fail_code);
+	hub_mutex_unlock(&p_dev->async.lock);
+}
+
+/**
+ * Completion callback for the bursts of the asynchronous engine.
+ * Moves on to the next burst of the request, or completes it.
+ */
+static void LIBUSB_CALL hub_usb_async_bulk_cb(struct libusb_transfer *p_xfer)
+{
+	struct hub_usb_async_req  *p_req;
+	struct hub_usb_axi_window *p_win;
+	struct usb_bus_hdl_map    *p_dev = (struct usb_bus_hdl_map *)p_xfer->user_data;
+
+	hub_mutex_lock(&p_dev->async.lock);
+
+	p_req                     = p_dev->async.p_head;
+	p_win = hub_usb_get_axi_window(p_dev, p_req->is_read ? AXIRBASE : AXIWBASE);
+	p_dev->async.p_inflight_xfer = NULL;
+
+	if ((LIBUSB_TRANSFER_COMPLETED != p_xfer->status) ||
+		(p_req->burst_len != (uint32_t)p_xfer->actual_length)) {
+		hub_pr_err("USB async burst failed @ 0x%x: %d\n", p_req->addr,
+				   p_xfer->status);
+		goto err_async_bulk_cb;
+	}
+
+	p_req->data      += p_req->burst_len;
+	p_req->addr      += p_req->burst_len;
+	p_req->remaining -= p_req->burst_len;
+
+	if (0 == p_req->remaining) {
+		hub_usb_async_finish(p_dev, HUB_SUCCESS);
+	} else if (0 != hub_usb_async_submit_step(p_dev, p_req)) {
+		hub_pr_err("Error submitting USB async transfer\n");
+		goto err_async_bulk_cb;
+	}
+
+	hub_mutex_unlock(&p_dev->async.lock);
+	return;
+
+err_async_bulk_cb:
+	hub_usb_invalidate_axi_window(p_win);
+	hub_usb_async_finish(p_dev, p_req->fail_code);
+	hub_mutex_unlock(&p_dev->async.lock);
+}
+
+/**
+ * Queue an asynchronous read / write on the USB bus represented by the given
+ * bus handle.
+ *
+ * The request is put on the wire right away if the bus is idle, else it is
+ * started from the completion of the request ahead of it.
+ *
+ * @param: usb_bus_hdl Handle to the USB bus
+ * @param: is_read true for a read, false for a write
+ * @param: p_buffer Pointer to a struct hub_usb_ops_map for the transfer
+ * @param: count Number of bytes to transfer
+ * @param: cb_handler Completion callback
+ * @param: p_cb_ctx Opaque context passed to the completion callback
+ * @param: fail_code Return code passed to the completion callback on failure
+ *
+ * @return: 1 for success, -1 for error
+ */
+int32_t hub_usb_device_submit_async(int                usb_bus_hdl,
+									bool               is_read,
+									void              *p_buffer,
+									uint32_t           count,
+									hub_xfer_done_cb_t cb_handler,
+									void              *p_cb_ctx,
+									enum hub_ret_code  fail_code)
+{
+	struct hub_usb_async_req *p_req     = NULL;
+	struct usb_bus_hdl_map   *p_dev     = NULL;
+	struct hub_usb_ops_map   *p_usb_ops = (struct hub_usb_ops_map *)p_buffer;
+
+	p_dev = hub_usb_hold_dev(usb_bus_hdl);
+	if (NULL == p_dev) {
+		hub_pr_err("Invalid bus_hdl\n");
+		return -1;
+	}
+
+	if (NULL == p_dev->libusb_hdl) {
+		hub_pr_err("Invalid libusb_hdl\n");
+		goto err_submit_async_2;
+	}
+
+	if (!p_dev->async.is_running) {
+		hub_pr_err("USB async engine not running\n");
+		goto err_submit_async_2;
+	}
+
+	if (0 == count) {
+		hub_pr_err("Nothing to transfer\n");
+		goto err_submit_async_2;
+	}
+
+	p_req = calloc(1, sizeof(struct hub_usb_async_req));
+	if (NULL == p_req) {
+		hub_pr_err("Error allocating USB async request\n");
+		goto err_submit_async_2;
+	}
+
+	p_req->is_read    = is_read;
+	p_req->data       = (uint8_t *)p_usb_ops->p_buffer;
+	p_req->addr       = p_usb_ops->addr;
+	p_req->remaining  = count;
+	p_req->fail_code  = fail_code;
+	p_req->cb_handler = cb_handler;
+	p_req->p_cb_ctx   = p_cb_ctx;
+
+	hub_mutex_lock(&p_dev->async.lock);
+
+	if (p_dev->async.num_queued >= p_dev->async_depth) {
+		hub_pr_err("USB async queue full (%u)\n", p_dev->async.num_queued);
+		goto err_submit_async_1;
+	}
+
+	if (NULL == p_dev->async.p_tail) {
+		p_dev->async.p_head = p_req;
+	} else {
+		p_dev->async.p_tail->p_next = p_req;
+	}
+	p_dev->async.p_tail = p_req;
+	p_dev->async.num_queued++;
+
+	if (!p_dev->async.is_busy) {
+		if (0 != hub_usb_async_submit_step(p_dev, p_req)) {
+			hub_pr_err("Error submitting USB async transfer\n");
+			p_dev->async.p_head     = NULL;
+			p_dev->async.p_tail     = NULL;
+			p_dev->async.num_queued = 0;
+			goto err_submit_async_1;
+		}
+		p_dev->async.is_busy = true;
+	}
+
+	hub_mutex_unlock(&p_dev->async.lock);
+	hub_usb_drop_dev(p_dev);
+
+	return 1;
+
+err_submit_async_1:
+	hub_mutex_unlock(&p_dev->async.lock);
+	free(p_req);
+err_submit_async_2:
+	hub_usb_drop_dev(p_dev);
+	return -1;
+}
+
+/**
+ * Wait until all asynchronous transfers queued on the USB bus represented
+ * by the given bus handle have completed.
+ *
+ * Must not be called from a completion callback.
+ *
+ * @param: usb_bus_hdl Handle to the USB bus
+ *
+ * @return: 1 for success, -1 for error
+ */
+int32_t hub_usb_device_wait_async(int usb_bus_hdl)
+{
+	struct usb_bus_hdl_map *p_dev = NULL;
+
+	p_dev = hub_usb_hold_dev(usb_bus_hdl);
+	if (NULL == p_dev) {
+		hub_pr_err("Invalid bus_hdl\n");
+		return -1;
+	}
+
+	if (p_dev->async.is_running) {
+		hub_mutex_lock(&p_dev->async.lock);
+		p_dev->async.num_waiters++;
+		while (p_dev->async.is_busy && !p_dev->async.terminate_flag) {
+			hub_cond_var_wait(&p_dev->async.idle_cond_var, &p_dev->async.lock);
+		}
+		if ((0 == --p_dev->async.num_waiters) && p_dev->async.terminate_flag) {
+			hub_cond_var_broadcast(&p_dev->async.idle_cond_var);
+		}
+		hub_mutex_unlock(&p_dev->async.lock);
+	}
+
+	hub_usb_drop_dev(p_dev);
+
+	return 1;
+}
+
+/**
+ * Claim the AXI window of the USB device for a synchronous read / write.
+ *
+ * Waits for the asynchronous request on the wire, if any, and all requests
+ * queued behind it to complete. Requests queued while the window is claimed
+ * are started on release.
+ *
+ * @return: 0 on success, -1 if the engine is being stopped
+ */
+static int32_t hub_usb_async_claim(struct usb_bus_hdl_map *p_dev)
+{
+	int32_t ret = 0;
+
+	hub_mutex_lock(&p_dev->async.lock);
+	p_dev->async.num_waiters++;
+	while (p_dev->async.is_busy && !p_dev->async.terminate_flag) {
+		hub_cond_var_wait(&p_dev->async.idle_cond_var, &p_dev->async.lock);
+	}
+	p_dev->async.num_waiters--;
+	if (p_dev->async.terminate_flag) {
+		if (0 == p_dev->async.num_waiters) {
+			hub_cond_var_broadcast(&p_dev->async.idle_cond_var);
+		}
+		ret = -1;
+	} else {
+		p_dev->async.is_busy = true;
+	}
+	hub_mutex_unlock(&p_dev->async.lock);
 
-	/* TBD-DPN: does Python code assume 1 as success? */
 	return ret;
-}
\ No newline at end of file
+}
+
+/**
+ * Release the AXI window of the USB device claimed for a synchronous
+ * read / write, and start any requests queued in the meantime.
+ */
+static void hub_usb_async_release(struct usb_bus_hdl_map *p_dev)
+{
+	hub_mutex_lock(&p_dev->async.lock);
+	if ((NULL == p_dev->async.p_head) ||
+		(0 != hub_usb_async_submit_step(p_dev, p_dev->async.p_head))) {
+		/* Fails the queued requests, if any, and marks the engine idle */
+		hub_usb_async_finish(p_dev, (NULL != p_dev->async.p_head)
+								 ? p_dev->async.p_head->fail_code
+								 : HUB_SUCCESS);
+	}
+	hub_mutex_unlock(&p_dev->async.lock);
+}
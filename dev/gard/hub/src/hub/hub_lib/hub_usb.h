@@ -41,8 +41,28 @@
 #define AXIRBASE                0x110
 
 /**
- * TBD-DPN: Code assumes a single USB bus.
- *
+ * Value written to the AXI config register (AXI base + 1) ahead of a
+ * transfer. Inherited from lscVipUsb code.
+ */
+#define HUB_USB_AXI_CONFIG      255
+
+/**
+ * Default number of asynchronous transfers that can be queued on a USB bus.
+ * Can be overridden per bus by "usb_async_depth" in host_config.json.
+ */
+#define HUB_USB_ASYNC_DEFAULT_DEPTH 8
+
+/**
+ * Maximum number of USB busses (GARD boards on USB) open at a time.
+ */
+#define HUB_USB_MAX_BUSSES      8
+
+/**
+ * Maximum depth of a USB port path, as limited by the USB 3.0 spec.
+ */
+#define HUB_USB_MAX_PORT_DEPTH  7
+
+/**
  * Uninitialized value of a USB bus handle
  * This handle is used by the public calls
  * for the USB bus.
@@ -58,14 +78,115 @@
  */
 #define ENDPOINT_TIMEOUT        1000  // millisecs
 
+/**
+ * Default size of a single bulk burst on USB.
+ *
+ * Reads and writes of any size are split into bursts of this size, with the
+ * AXI base address stepped by the burst length before each burst. The burst
+ * size can be overridden per bus by "usb_burst_size" in host_config.json.
+ */
+#define HUB_USB_DEFAULT_BURST_SZ 2048
+
+/**
+ * A configured burst size has to be a multiple of this, since the AXI
+ * addresses written before each burst are word addresses in GARD memory.
+ */
+#define HUB_USB_BURST_ALIGN      4
+
+/**
+ * Cached state of an AXI read / write window of the USB device.
+ *
+ * The AXI config and base registers keep their values across transfers, so
+ * HUB tracks what it last wrote to them and skips writes that would not
+ * change anything.
+ */
+struct hub_usb_axi_window {
+	bool     is_configured;
+	bool     is_addr_valid;
+	uint32_t addr;
+};
+
+
+/**
+ * A single queued asynchronous read / write on the USB bus.
+ *
+ * Each request is carried out as a chain of libusb transfers submitted from
+ * the completion callbacks of the previous one:
+ * AXI config write -> (AXI base write -> bulk burst) x number of bursts
+ * where the AXI writes are skipped if the window is already in place.
+ */
+struct hub_usb_async_req {
+	struct hub_usb_async_req *p_next;
+	bool                      is_read;
+	uint8_t                  *data;
+	uint32_t                  addr;
+	uint32_t                  remaining;
+	uint32_t                  burst_len;
+	enum hub_ret_code         fail_code;
+	hub_xfer_done_cb_t        cb_handler;
+	void                     *p_cb_ctx;
+};
+
+/**
+ * Context of the asynchronous transfer engine of a USB bus.
+ *
+ * Only the request at the head of the queue is on the wire at any time since
+ * the AXI base registers form a single window into GARD memory. The queue
+ * lets the next request start from the completion callback of the previous
+ * one, without a round trip through the caller.
+ */
+struct hub_usb_async_ctx {
+	bool                      is_running;
+	bool                      is_busy;
+	bool                      terminate_flag;
+	hub_thread_hdl_t          event_thread;
+	hub_thread_attr_t         event_thread_attr;
+	hub_mutex_t               lock;
+	hub_cond_var_t            idle_cond_var;
+	uint32_t                  num_waiters;
+	uint32_t                  num_queued;
+	struct hub_usb_async_req *p_head;
+	struct hub_usb_async_req *p_tail;
+	struct libusb_transfer   *p_ctrl_xfer;
+	struct libusb_transfer   *p_bulk_xfer;
+	struct libusb_transfer   *p_inflight_xfer;
+	bool                      ctrl_is_config;
+	uint16_t                  ctrl_reg;
+	uint32_t                  ctrl_data;
+	uint8_t ctrl_buf[LIBUSB_CONTROL_SETUP_SIZE + sizeof(uint32_t)];
+};
+
 /**
  * Structure holding the mapping of USB bus handle
  * (for USB operations) and the internal bus handle
- * used by libusb stack.
+ * used by libusb stack, along with the rest of the bus's USB state.
+ *
+ * One of these is allocated for every open USB bus, each with its own
+ * libusb context, so that USB busses do not share any state.
  */
 struct usb_bus_hdl_map {
-	int                   bus_hdl;
-	libusb_device_handle *libusb_hdl;
+	int                            bus_hdl;
+	libusb_context                *p_libusb_ctx;
+	libusb_device_handle          *libusb_hdl;
+	struct hub_gard_bus_usb_props *p_props;
+	bool                           kernel_driver_detached;
+	uint32_t                       burst_size;
+	uint32_t                       async_depth;
+	struct hub_usb_axi_window      axi_wr_win;
+	struct hub_usb_axi_window      axi_rd_win;
+	struct hub_usb_async_ctx       async;
+
+	/* Device departure, from libusb hotplug events, see hub_health.c */
+	bool                           has_hotplug;
+	libusb_hotplug_callback_handle hotplug_hdl;
+	volatile bool                  is_gone;
+
+	/**
+	 * Transfer calls in progress on the bus, see hub_usb_hold_dev(). Closing
+	 * waits for them with is_closing set, so that no more start.
+	 */
+	uint32_t                       num_users;
+	bool                           is_closing;
 };
 
 /**
@@ -85,11 +206,21 @@ int32_t hub_usb_device_open(void *param);
  */
 int32_t hub_usb_device_close(int usb_bus_hdl);
 
+/**
+ * Tell if the device of a USB bus has left, e.g. to re-enumerate after a
+ * firmware reset. A bus that is not open counts as gone.
+ *
+ * Departures are only seen where libusb has hotplug support; elsewhere a
+ * lost device shows up as failing transfers only.
+ */
+bool hub_usb_device_is_gone(int usb_bus_hdl);
+
 /**
  * TBD-DPN: Revisit the error behaviour of this call
  *
  * Perform a write operation on the USB bus represented by the given bus
- * handle.
+ * handle. Any count is accepted and split into as many bursts as needed.
+ * Returns the bytes written, fewer than count if a burst fails.
  */
 int32_t
 	hub_usb_device_write(int usb_bus_hdl, const void *p_buffer, uint32_t count);
@@ -98,7 +229,30 @@ int32_t
  * TBD-DPN: Revisit the error behaviour of this call
  *
  * Perform a read operation on the USB bus represented by the given bus handle.
+ * Any count is accepted and split into as many bursts as needed.
+ * Returns the bytes read, fewer than count if a burst fails.
  */
 int32_t hub_usb_device_read(int usb_bus_hdl, void *p_buffer, uint32_t count);
 
+/**
+ * Queue an asynchronous read / write on the USB bus represented by the given
+ * bus handle. p_buffer is a struct hub_usb_ops_map as for read / write.
+ *
+ * cb_handler is called from the USB event thread on completion, with
+ * HUB_SUCCESS or fail_code.
+ */
+int32_t hub_usb_device_submit_async(int                usb_bus_hdl,
+									bool               is_read,
+									void              *p_buffer,
+									uint32_t           count,
+									hub_xfer_done_cb_t cb_handler,
+									void              *p_cb_ctx,
+									enum hub_ret_code  fail_code);
+
+/**
+ * Wait until all asynchronous transfers queued on the USB bus represented
+ * by the given bus handle have completed.
+ */
+int32_t hub_usb_device_wait_async(int usb_bus_hdl);
+
 #endif /* __HUB_USB_H__ */
\ No newline at end of file
@@ -103,4 +103,79 @@ enum hub_ret_code hub_parse_json(struct hub_file_ctx *p_file,
 	}
 
 	return HUB_SUCCESS;
-}
\ No newline at end of file
+}
+/**
+ * Slicing-by-8 tables of the reflected CRC-32 polynomial 0xEDB88320.
+ * hub_crc32_tables[0] is the classic byte table, hub_crc32_tables[k] the CRC
+ * of a byte followed by k zero bytes.
+ */
+static uint32_t       hub_crc32_tables[8][256];
+static pthread_once_t hub_crc32_once = PTHREAD_ONCE_INIT;
+
+static void hub_crc32_init_tables(void)
+{
+	uint32_t crc, i, j;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+		}
+		hub_crc32_tables[0][i] = crc;
+	}
+
+	for (i = 0; i < 256; i++) {
+		for (j = 1; j < 8; j++) {
+			hub_crc32_tables[j][i] =
+				(hub_crc32_tables[j - 1][i] >> 8) ^
+				hub_crc32_tables[0][hub_crc32_tables[j - 1][i] & 0xFF];
+		}
+	}
+}
+
+/* Little-endian 32-bit load, as the tables expect, on any host */
+static inline uint32_t hub_crc32_load_le32(const uint8_t *p_byte)
+{
+	return (uint32_t)p_byte[0] | ((uint32_t)p_byte[1] << 8) |
+		   ((uint32_t)p_byte[2] << 16) | ((uint32_t)p_byte[3] << 24);
+}
+
+/**
+ * Extend a CRC-32 (IEEE 802.3, the same as zlib's crc32() and GARD FW's
+ * crc32_update()) over a buffer, 8 bytes per step.
+ *
+ * @param: crc is the CRC of the data so far, 0 to start
+ * @param: p_data is the next piece of data
+ * @param: len is the size of the piece in bytes
+ *
+ * @return: the CRC of the data so far including this piece
+ */
+uint32_t hub_crc32(uint32_t crc, const void *p_data, size_t len)
+{
+	const uint8_t *p_byte = (const uint8_t *)p_data;
+	uint32_t       lo, hi;
+
+	pthread_once(&hub_crc32_once, hub_crc32_init_tables);
+
+	crc = ~crc;
+	while (len >= 8) {
+		lo  = crc ^ hub_crc32_load_le32(p_byte);
+		hi  = hub_crc32_load_le32(p_byte + 4);
+		crc = hub_crc32_tables[7][lo & 0xFF] ^
+			  hub_crc32_tables[6][(lo >> 8) & 0xFF] ^
+			  hub_crc32_tables[5][(lo >> 16) & 0xFF] ^
+			  hub_crc32_tables[4][lo >> 24] ^ hub_crc32_tables[3][hi & 0xFF] ^
+			  hub_crc32_tables[2][(hi >> 8) & 0xFF] ^
+			  hub_crc32_tables[1][(hi >> 16) & 0xFF] ^
+			  hub_crc32_tables[0][hi >> 24];
+
+		p_byte += 8;
+		len    -= 8;
+	}
+
+	while (len--) {
+		crc = (crc >> 8) ^ hub_crc32_tables[0][(crc ^ *p_byte++) & 0xFF];
+	}
+
+	return ~crc;
+}
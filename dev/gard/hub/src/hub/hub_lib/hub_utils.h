@@ -40,4 +40,7 @@ enum hub_ret_code hub_read_file_into_memory(struct hub_file_ctx *p_file);
 enum hub_ret_code hub_parse_json(struct hub_file_ctx *p_file,
 								 cJSON              **pp_json_parsed);
 
+/* CRC-32 of the data path, see CC_CHECKSUM_PRESENT */
+uint32_t hub_crc32(uint32_t crc, const void *p_data, size_t len);
+
 #endif /* __UTILS_H__ */
\ No newline at end of file
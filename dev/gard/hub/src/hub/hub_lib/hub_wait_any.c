@@ -0,0 +1,272 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "hub_wait_any.h"
+#include "hub_globals.h"
+
+/**
+ * Wait-any app data delivery
+ *
+ * GARDs set up with hub_setup_appdata_wait_any() get an appdata ring whose
+ * callback, run by the GPIO worker of the GARD, queues the filled buffer in
+ * a queue shared by all the GARDs of the HUB. hub_wait_any() takes from it,
+ * so one app thread, with one condition variable, serves every GARD. The
+ * ready_fd eventfd is signalled when the queue stops being empty and drained
+ * when it empties, for apps waiting in their own event loop.
+ *
+ * The ring buffers are held by the app from the callback until
+ * hub_release_appdata_buffer(), so the queue never holds more entries than
+ * there are ring buffers and the GPIO workers never wait on it.
+ */
+
+/* Listing of static functions defined in this file */
+static struct hub_wait_any_ctx *hub_wait_any_get_ctx(struct hub_ctx *p_hub);
+static void *hub_wait_any_cb(void *p_cb_params, void *p_buffer, uint32_t size);
+
+/**
+ * Get the wait-any queue of a HUB, making it on first use.
+ *
+ * @param: p_hub is the HUB
+ *
+ * @return: The queue, NULL on failure
+ */
+static struct hub_wait_any_ctx *hub_wait_any_get_ctx(struct hub_ctx *p_hub)
+{
+	struct hub_wait_any_ctx *p_ctx;
+
+	if (NULL != p_hub->p_wait_any_ctx) {
+		return p_hub->p_wait_any_ctx;
+	}
+
+	p_ctx = (struct hub_wait_any_ctx *)calloc(1, sizeof(*p_ctx));
+	if (NULL == p_ctx) {
+		hub_pr_err("Failed to allocate wait-any context\n");
+		goto err_wait_any_ctx_1;
+	}
+
+	p_ctx->num_entries = p_hub->num_gards * HUB_APPDATA_RING_MAX_BUFFERS;
+	p_ctx->p_entries   = (struct hub_wait_any_entry *)calloc(
+		p_ctx->num_entries, sizeof(*p_ctx->p_entries));
+	if (NULL == p_ctx->p_entries) {
+		hub_pr_err("Failed to allocate wait-any queue\n");
+		goto err_wait_any_ctx_2;
+	}
+
+	p_ctx->ready_fd = hub_wake_fd_open();
+	if (p_ctx->ready_fd < 0) {
+		goto err_wait_any_ctx_3;
+	}
+
+	if (HUB_SUCCESS != hub_mutex_init(&p_ctx->lock)) {
+		goto err_wait_any_ctx_4;
+	}
+
+	if (HUB_SUCCESS != hub_cond_var_init(&p_ctx->cond_var)) {
+		goto err_wait_any_ctx_5;
+	}
+
+	p_hub->p_wait_any_ctx = p_ctx;
+
+	return p_ctx;
+
+err_wait_any_ctx_5:
+	hub_mutex_destroy(&p_ctx->lock);
+err_wait_any_ctx_4:
+	hub_wake_fd_close(p_ctx->ready_fd);
+err_wait_any_ctx_3:
+	free(p_ctx->p_entries);
+err_wait_any_ctx_2:
+	free(p_ctx);
+err_wait_any_ctx_1:
+	return NULL;
+}
+
+/**
+ * Appdata ring callback of the GARDs set up for hub_wait_any(): queue the
+ * filled buffer.
+ *
+ * @param: p_cb_params is the GARD
+ * @param: p_buffer is the ring buffer filled
+ * @param: size is the size of the result, 0 on a failed fetch
+ *
+ * @return: HUB_SUCCESS
+ */
+static void *hub_wait_any_cb(void *p_cb_params, void *p_buffer, uint32_t size)
+{
+	struct hub_gard_info      *p_gard = (struct hub_gard_info *)p_cb_params;
+	struct hub_ctx            *p_hub  = (struct hub_ctx *)p_gard->hub;
+	struct hub_wait_any_ctx   *p_ctx  = p_hub->p_wait_any_ctx;
+	struct hub_wait_any_entry *p_entry;
+
+	/* Not held by the app, and already counted as a failure */
+	if (0 == size) {
+		return (void *)(intptr_t)HUB_SUCCESS;
+	}
+
+	hub_mutex_lock(&p_ctx->lock);
+
+	p_entry = &p_ctx->p_entries[(p_ctx->head + p_ctx->count) %
+								p_ctx->num_entries];
+	p_entry->p_gard   = p_gard;
+	p_entry->p_buffer = p_buffer;
+	p_entry->size     = size;
+
+	if (0 == p_ctx->count++) {
+		hub_wake_fd_signal(p_ctx->ready_fd);
+	}
+	hub_cond_var_signal(&p_ctx->cond_var);
+
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return (void *)(intptr_t)HUB_SUCCESS;
+}
+
+/**
+ * hub_setup_appdata_wait_any sets up an appdata ring on a GARD whose results
+ * are queued for hub_wait_any().
+ *
+ * @param: gard is a GARD handle returned from hub_get_gard_handle()
+ * @param: pp_buffers is an array of num_buffers user-allocated buffers
+ * @param: num_buffers is 1 to HUB_APPDATA_RING_MAX_BUFFERS
+ * @param: size is the size of each buffer, in bytes
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_SETUP_APPDATA_CB on failure
+ */
+enum hub_ret_code hub_setup_appdata_wait_any(gard_handle_t gard,
+											 void *const  *pp_buffers,
+											 uint32_t      num_buffers,
+											 uint32_t      size)
+{
+	struct hub_gard_info *p_gard = (struct hub_gard_info *)gard;
+
+	if (NULL == p_gard) {
+		hub_pr_err("Invalid GARD handle.\n");
+		return HUB_FAILURE_SETUP_APPDATA_CB;
+	}
+
+	if (NULL == hub_wait_any_get_ctx((struct hub_ctx *)p_gard->hub)) {
+		return HUB_FAILURE_SETUP_APPDATA_CB;
+	}
+
+	return hub_setup_appdata_ring_cb(gard, hub_wait_any_cb, p_gard,
+									 pp_buffers, num_buffers, size);
+}
+
+/**
+ * hub_wait_any takes the oldest result queued by any GARD, waiting up to
+ * timeout_ms for one.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: timeout_ms is how long to wait, 0 not to wait
+ * @param: p_gard is filled with the GARD the result is from
+ * @param: pp_buffer is filled with the ring buffer holding the result
+ * @param: p_size is filled with the size of the result, NULL if not needed
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_CONDVAR_TIMEDOUT if no result came in time
+ *			HUB_FAILURE_WAIT_ANY on invalid arguments, or if no GARD is set up
+ */
+enum hub_ret_code hub_wait_any(hub_handle_t   hub,
+							   uint32_t       timeout_ms,
+							   gard_handle_t *p_gard,
+							   void         **pp_buffer,
+							   uint32_t      *p_size)
+{
+	struct hub_ctx            *p_hub = (struct hub_ctx *)hub;
+	struct hub_wait_any_ctx   *p_ctx;
+	struct hub_wait_any_entry *p_entry;
+	struct timespec            deadline;
+	enum hub_ret_code          ret   = HUB_SUCCESS;
+
+	if ((NULL == p_hub) || (NULL == p_gard) || (NULL == pp_buffer)) {
+		hub_pr_err("Invalid arguments\n");
+		return HUB_FAILURE_WAIT_ANY;
+	}
+
+	p_ctx = p_hub->p_wait_any_ctx;
+	if (NULL == p_ctx) {
+		hub_pr_err("No GARD set up for hub_wait_any()\n");
+		return HUB_FAILURE_WAIT_ANY;
+	}
+
+	hub_deadline_from_now(&deadline, timeout_ms);
+
+	hub_mutex_lock(&p_ctx->lock);
+	while ((0 == p_ctx->count) && (HUB_SUCCESS == ret) && timeout_ms) {
+		ret = hub_cond_var_timedwait(&p_ctx->cond_var, &p_ctx->lock,
+									 &deadline);
+	}
+
+	if (0 == p_ctx->count) {
+		hub_mutex_unlock(&p_ctx->lock);
+		return HUB_FAILURE_CONDVAR_TIMEDOUT;
+	}
+
+	p_entry     = &p_ctx->p_entries[p_ctx->head];
+	*p_gard     = (gard_handle_t)p_entry->p_gard;
+	*pp_buffer  = p_entry->p_buffer;
+	if (NULL != p_size) {
+		*p_size = p_entry->size;
+	}
+
+	p_ctx->head = (p_ctx->head + 1) % p_ctx->num_entries;
+	if (0 == --p_ctx->count) {
+		hub_wake_fd_drain(p_ctx->ready_fd);
+	}
+
+	hub_mutex_unlock(&p_ctx->lock);
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_get_wait_any_fd gets a file descriptor that polls readable as long as
+ * hub_wait_any() has a result queued.
+ *
+ * @param: hub is the HUB handle initialized by hub_init()
+ * @param: p_fd is filled with the file descriptor
+ *
+ * @return: HUB_SUCCESS on success
+ *			HUB_FAILURE_WAIT_ANY if no GARD is set up
+ */
+enum hub_ret_code hub_get_wait_any_fd(hub_handle_t hub, int *p_fd)
+{
+	struct hub_ctx *p_hub = (struct hub_ctx *)hub;
+
+	if ((NULL == p_hub) || (NULL == p_fd) ||
+		(NULL == p_hub->p_wait_any_ctx)) {
+		hub_pr_err("No GARD set up for hub_wait_any()\n");
+		return HUB_FAILURE_WAIT_ANY;
+	}
+
+	*p_fd = p_hub->p_wait_any_ctx->ready_fd;
+
+	return HUB_SUCCESS;
+}
+
+/**
+ * hub_wait_any_fini frees the wait-any queue of a HUB.
+ *
+ * @param: p_hub is the HUB
+ */
+void hub_wait_any_fini(struct hub_ctx *p_hub)
+{
+	struct hub_wait_any_ctx *p_ctx = p_hub->p_wait_any_ctx;
+
+	if (NULL == p_ctx) {
+		return;
+	}
+
+	hub_cond_var_destroy(&p_ctx->cond_var);
+	hub_mutex_destroy(&p_ctx->lock);
+	hub_wake_fd_close(p_ctx->ready_fd);
+	free(p_ctx->p_entries);
+	free(p_ctx);
+
+	p_hub->p_wait_any_ctx = NULL;
+}
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef __HUB_WAIT_ANY_H__
+#define __HUB_WAIT_ANY_H__
+
+#include "hub.h"
+#include "gard_info.h"
+#include "hub_threading.h"
+
+/* A result queued for hub_wait_any() */
+struct hub_wait_any_entry {
+	struct hub_gard_info *p_gard;
+	void                 *p_buffer; /* A ring buffer held by the app */
+	uint32_t              size;
+};
+
+struct hub_wait_any_ctx {
+	/**
+	 * Results of all the GARDs, oldest first. Each holds a ring buffer, so
+	 * there is room for every buffer of every GARD.
+	 */
+	struct hub_wait_any_entry *p_entries;
+	uint32_t                   num_entries;
+	uint32_t                   head;
+	uint32_t                   count;
+
+	int                        ready_fd; /* Readable while count is not 0 */
+	hub_mutex_t                lock;
+	hub_cond_var_t             cond_var;
+};
+
+/**
+ * hub_wait_any_fini frees the hub_wait_any() queue of a HUB, if any. Called
+ * by hub_fini() once the app data path has stopped.
+ */
+void hub_wait_any_fini(struct hub_ctx *p_hub);
+
+#endif /* __HUB_WAIT_ANY_H__ */
@@ -13,6 +13,7 @@
 # This package provides:
 #    - HUB: Main interface for HUB operations and GARD management
 #    - GARD: Interface for GARD device operations (register access, data transfer, sensors)
+#    - AsyncGARD: asyncio interface to a GARD, for event loop based applications
 # 
 # The HUB.py is designed to provide python bindings to the
 # HUB C library functions, so that python applications can use HUB natively.
@@ -27,10 +28,12 @@ __license__ = "UNLICENSED"
 
 from .hub import HUB, GARD
 from .camInterface import CamInterface
+from .hub_async import AsyncGARD
 
-# Define public API - only HUB and GARD are exported
+# Define public API - only HUB, GARD and AsyncGARD are exported
 __all__ = [
     "HUB",
     "GARD",
+    "AsyncGARD",
     "__version__",
 ]
\ No newline at end of file
@@ -32,10 +32,15 @@
 # 1.  [CamInterface] get_camera_status() - Gets current status of a camera
 # 2.  [CamInterface] get_camera_stream() - Gets raw video capture stream
 # 3.  [CamInterface] generate_frames() - Generator function for MJPEG frame streaming
+#     All clients of a camera share one encoded stream: the Pi Camera is encoded
+#     by the hardware JPEG encoder (Picamera2 MJPEGEncoder, V4L2 M2M), others by
+#     one encode thread per camera. Clients slower than the camera skip frames.
 # 4.  [CamInterface] are_both_cameras_running() - Checks if both USB and Pi cameras are active
 #
 # Camera Frame Processing:
 # 1.  [CamInterface] _validate_and_encode_frame() - Validates and encodes frames to JPEG
+# 2.  [CamInterface] _publish_frame() - Hands an encoded frame to the stream clients
+# 3.  [CamInterface] _encode_worker() - Captures and encodes frames of a software encoded camera
 #
 # Image Operations:
 # 1.  [CamInterface] capture_image_from_gard() - Captures rescaled image from GARD system
@@ -45,6 +50,7 @@
 # 1.  [CamInterface] cleanup_resources() - Releases all camera resources and stops all streams
 # -----------------------------------------------------------------------------
 
+import io
 import os
 import cv2
 import threading
@@ -62,6 +68,13 @@ try:
 except ImportError:
     PICAMERA2_AVAILABLE = False
 
+try:
+    from picamera2.encoders import MJPEGEncoder
+    from picamera2.outputs import FileOutput
+    MJPEG_ENCODER_AVAILABLE = True
+except ImportError:
+    MJPEG_ENCODER_AVAILABLE = False
+
 
 class DummyLogger:
     """Logger replacement using print statements."""
@@ -82,15 +95,35 @@ class HubImgOpsCtx(ct.Structure):
     """ctypes structure corresponding to struct hub_img_ops_ctx in hub.h"""
     _fields_ = [
         ("camera_id", ct.c_uint8),
+        ("no_pause", ct.c_uint8),
+        ("pipeline_paused", ct.c_uint8),
         ("p_image_buffer", ct.c_void_p),
         ("image_buffer_size", ct.c_uint32),
         ("image_buffer_address", ct.c_uint32),
         ("h_size", ct.c_uint16),
         ("v_size", ct.c_uint16),
         ("image_format", ct.c_uint),
+        ("roi_x", ct.c_uint16),
+        ("roi_y", ct.c_uint16),
+        ("roi_width", ct.c_uint16),
+        ("roi_height", ct.c_uint16),
+        ("decimation", ct.c_uint8),
+        ("codec", ct.c_uint),
     ]
 
 
+class _SharedFrameOutput(io.BufferedIOBase):
+    """Picamera2 encoder output handing each JPEG to the stream clients."""
+
+    def __init__(self, cam_interface, camera_id):
+        self.cam_interface = cam_interface
+        self.camera_id = camera_id
+
+    def write(self, buf):
+        # Called from the encoder thread, once per frame
+        self.cam_interface._publish_frame(self.camera_id, bytes(buf))
+        return len(buf)
+
 
 class CamInterface:
     """Camera interface for managing camera operations."""
@@ -260,8 +293,14 @@ class CamInterface:
             return "Unknown"
     
 
-    def setup_camera(self, camera_id=0, width=1920, height=1080, camera_type=None):
-        """Setup camera with specified resolution and configuration."""
+    def setup_camera(self, camera_id=0, width=1920, height=1080, camera_type=None,
+                     hw_encode=True, max_fps=None):
+        """
+        Setup camera with specified resolution and configuration.
+        hw_encode selects the hardware JPEG encoder for the stream, where the
+        camera type and platform have one (Pi Camera with Picamera2).
+        max_fps caps the stream rate; None streams at the rate of the sensor.
+        """
         if camera_id is None:
             camera_id = self.get_CPNX_camera_id()
 
@@ -299,6 +338,13 @@ class CamInterface:
             self.camera_data_context[camera_id]["stop_flag"] = threading.Event()
             self.camera_data_context[camera_id]["active_generators"] = 0
             self.camera_data_context[camera_id]["camera_status"] = "Stopped"
+            self.camera_data_context[camera_id]["hw_encode"] = hw_encode
+            self.camera_data_context[camera_id]["max_fps"] = max_fps
+            self.camera_data_context[camera_id]["hw_encoder"] = None
+            self.camera_data_context[camera_id]["encode_worker"] = None
+            self.camera_data_context[camera_id]["frame_cond"] = threading.Condition()
+            self.camera_data_context[camera_id]["latest_frame"] = None
+            self.camera_data_context[camera_id]["frame_seq"] = 0
 
             self.logger.info(
                 f"Camera {camera_id} ({camera_type}) setup with resolution {width}x{height}."
@@ -409,12 +455,24 @@ class CamInterface:
                         time.sleep(0.5)
 
                         picam2 = Picamera2()
+                        controls = {}
+                        max_fps = self.camera_data_context[camera_id]["max_fps"]
+                        if max_fps:
+                            # The sensor itself runs no faster than the cap
+                            frame_duration_us = int(1000000 / max_fps)
+                            controls["FrameDurationLimits"] = (
+                                frame_duration_us, frame_duration_us
+                            )
                         video_config = picam2.create_video_configuration(
-                            main={"format": "RGB888", "size": (width, height)}
+                            main={"format": "RGB888", "size": (width, height)},
+                            controls=controls,
                         )
                         picam2.configure(video_config)
                         picam2.start()
 
+                        if self.camera_data_context[camera_id]["hw_encode"]:
+                            self._start_hw_encoder(camera_id, picam2)
+
                         time.sleep(0.5)
                         self.camera_data_context[camera_id]["camera_stream"] = picam2
 
@@ -453,6 +511,7 @@ class CamInterface:
             if stop_flag is not None:
                 self.logger.info(f"Setting stop flag for camera {camera_id}...")
                 stop_flag.set()
+                self._publish_frame(camera_id, None)
             
             if generator_lock is not None:
                 self.logger.info(f"Waiting for generators to finish for camera {camera_id}...")
@@ -475,6 +534,11 @@ class CamInterface:
                                 f"Timeout waiting for {active_count} generator(s) to finish for camera {camera_id}, proceeding with stop"
                             )
                             self.camera_data_context[camera_id]["active_generators"] = 0
+
+            # The encode thread reads the stream without the camera lock
+            encode_worker = self.camera_data_context[camera_id].get("encode_worker")
+            if encode_worker is not None:
+                encode_worker.join(timeout=2.0)
             
             with self.camera_data_context[camera_id]["camera_lock"]:
                 if self.camera_data_context[camera_id]["camera_stream"] is not None:
@@ -486,6 +550,13 @@ class CamInterface:
                         except Exception as e:
                             self.logger.warning(f"Error releasing USB camera {camera_id}: {e}")
                     elif camera_type == "picamera2":
+                        hw_encoder = self.camera_data_context[camera_id].get("hw_encoder")
+                        if hw_encoder is not None:
+                            try:
+                                self.camera_data_context[camera_id]["camera_stream"].stop_encoder(hw_encoder)
+                            except Exception as e:
+                                self.logger.debug(f"Error stopping encoder of Pi camera {camera_id}: {e}")
+                            self.camera_data_context[camera_id]["hw_encoder"] = None
                         try:
                             self.camera_data_context[camera_id]["camera_stream"].stop()
                         except Exception as e:
@@ -590,46 +661,95 @@ class CamInterface:
                 original_error=e
             ) from e
 
-    def generate_frames(self, camera_id):
+    def _start_hw_encoder(self, camera_id, picam2):
         """
-        Generator function that continuously yields JPEG frames for streaming.
-        Automatically adjusts FPS: ~30 FPS for single camera, ~10 FPS for dual cameras.
-        Frame capture and encoding happen outside locks to prevent blocking between cameras.
+        Start the hardware JPEG encoder on a running Pi camera. Its frames go
+        straight to the stream clients, the CPU does not touch the pixels.
+        Falls back to software encoding if the encoder cannot be started.
 
         Args:
-            camera_id: Camera device ID to generate frames from
-
-        Yields:
-            bytes: MJPEG formatted frame data
+            camera_id: Camera ID of the Pi camera
+            picam2: Started Picamera2 instance
         """
-        if camera_id not in self.camera_data_context:
+        if not MJPEG_ENCODER_AVAILABLE:
+            self.logger.info(f"No hardware encoder for camera {camera_id}, encoding in software")
             return
-        
-        stop_flag = self.camera_data_context[camera_id].get("stop_flag")
-        if stop_flag is None:
+
+        try:
+            encoder = MJPEGEncoder()
+            picam2.start_encoder(encoder, FileOutput(_SharedFrameOutput(self, camera_id)))
+            self.camera_data_context[camera_id]["hw_encoder"] = encoder
+            self.logger.info(f"Camera {camera_id} encoded by hardware JPEG encoder")
+        except Exception as e:
+            self.camera_data_context[camera_id]["hw_encoder"] = None
+            self.logger.warning(
+                f"Failed to start hardware encoder for camera {camera_id}: {e}, encoding in software"
+            )
+
+    def _publish_frame(self, camera_id, frame_bytes):
+        """
+        Make an encoded frame the latest of a camera and wake its stream
+        clients. Only the latest frame is kept, so clients that fall behind
+        skip frames instead of queueing them.
+
+        Args:
+            camera_id: Camera ID
+            frame_bytes: Encoded JPEG frame, None to end the stream
+        """
+        context = self.camera_data_context.get(camera_id)
+        if context is None:
             return
-        
-        with self.camera_data_context[camera_id]["generator_lock"]:
-            self.camera_data_context[camera_id]["active_generators"] += 1
-        
+
+        with context["frame_cond"]:
+            context["latest_frame"] = frame_bytes
+            context["frame_seq"] += 1
+            context["frame_cond"].notify_all()
+
+    def _encode_worker(self, camera_id):
+        """
+        Capture and encode frames of a software encoded camera for all of its
+        stream clients. Each capture blocks until the camera delivers a frame,
+        so frames go out at the sensor rate, capped by the max_fps of the
+        camera, and at ~5 FPS when both cameras are running. Runs while the
+        camera has clients, and ends their streams if the camera keeps failing.
+
+        Args:
+            camera_id: Camera device ID to encode frames from
+        """
+        context = self.camera_data_context[camera_id]
+        stop_flag = context["stop_flag"]
+
         consecutive_failures = 0
         max_consecutive_failures = 5
         last_error_log_time = {}
         error_log_interval = 5.0  # Only log same error once per 5 seconds
-        
+        max_fps = context.get("max_fps")
+        next_capture_time = time.monotonic()
+
         try:
             while True:
                 if stop_flag.is_set():
-                    self.logger.debug(f"Stop flag set for camera {camera_id}, exiting generator")
+                    self.logger.debug(f"Stop flag set for camera {camera_id}, exiting encode worker")
                     break
-                
-                sleep_time = 0
-                if self.are_both_cameras_running():
-                    sleep_time = 0.2  # 200ms total
-                else:
-                    sleep_time = 0.033  # 33ms total
 
-                time.sleep(sleep_time)
+                with context["generator_lock"]:
+                    if context["active_generators"] == 0:
+                        context["encode_worker"] = None
+                        return
+
+                frame_interval = (1.0 / max_fps) if max_fps else 0.0
+                if self.are_both_cameras_running():
+                    # Two cameras encoded in software share the CPU
+                    frame_interval = max(frame_interval, 0.2)
+
+                # Pace captures from their start, so the time the read and
+                # encode take counts toward the frame interval. Uncapped, the
+                # read below waits for the next frame of the camera.
+                if frame_interval:
+                    now = time.monotonic()
+                    if next_capture_time > now:
+                        time.sleep(next_capture_time - now)
+                    next_capture_time = max(now, next_capture_time) + frame_interval
 
                 if stop_flag.is_set():
                     break
@@ -638,15 +758,13 @@ class CamInterface:
                 camera_type = None
                 
                 try:
-                    with self.camera_data_context[camera_id]["camera_lock"]:
-                        camera_status = self.camera_data_context[camera_id]["camera_status"]
+                    with context["camera_lock"]:
+                        camera_status = context["camera_status"]
                         if camera_status != "Running":
                             break
                         
-                        stream = self.camera_data_context[camera_id]["camera_stream"]
-                        camera_type = self.camera_data_context[camera_id].get(
-                            "camera_type", "usb"
-                        )
+                        stream = context["camera_stream"]
+                        camera_type = context.get("camera_type", "usb")
                 except Exception as e:
                     self.logger.error(f"Error accessing camera context: {e}")
                     break
@@ -666,7 +784,7 @@ class CamInterface:
                                     consecutive_failures += 1
                                     if consecutive_failures >= max_consecutive_failures:
                                         self.logger.error(
-                                            f"Too many consecutive failures for USB camera {camera_id}, exiting generator to prevent OS crash"
+                                            f"Too many consecutive failures for USB camera {camera_id}, exiting encode worker to prevent OS crash"
                                         )
                                         break
                                     self.logger.warning(
@@ -683,7 +801,7 @@ class CamInterface:
                                 consecutive_failures += 1
                                 if consecutive_failures >= max_consecutive_failures:
                                     self.logger.error(
-                                        f"Too many consecutive exceptions for USB camera {camera_id}, exiting generator to prevent OS crash"
+                                        f"Too many consecutive exceptions for USB camera {camera_id}, exiting encode worker to prevent OS crash"
                                     )
                                     self.logger.error(traceback.format_exc())
                                     break
@@ -710,7 +828,7 @@ class CamInterface:
                             consecutive_failures += 1
                             if consecutive_failures >= max_consecutive_failures:
                                 self.logger.error(
-                                    f"Too many consecutive exceptions for Pi camera {camera_id}, exiting generator"
+                                    f"Too many consecutive exceptions for Pi camera {camera_id}, exiting encode worker"
                                 )
                                 self.logger.error(traceback.format_exc())
                                 break
@@ -724,7 +842,7 @@ class CamInterface:
                     consecutive_failures += 1
                     if consecutive_failures >= max_consecutive_failures:
                         self.logger.error(
-                            f"Too many consecutive errors for camera {camera_id}, exiting generator"
+                            f"Too many consecutive errors for camera {camera_id}, exiting encode worker"
                         )
                         self.logger.error(traceback.format_exc())
                         break
@@ -737,10 +855,8 @@ class CamInterface:
 
                 if success and frame is not None:
                     try:
-                        frame_bytes = self._validate_and_encode_frame(frame, camera_id)
-                        yield (
-                            b"--frame\r\n"
-                            b"Content-Type: image/jpeg\r\n\r\n" + frame_bytes + b"\r\n"
+                        self._publish_frame(
+                            camera_id, self._validate_and_encode_frame(frame, camera_id)
                         )
                     except FrameEncodingError as frame_error:
                         error_key = f"{frame_error.error_type}_{camera_id}"
@@ -759,6 +875,79 @@ class CamInterface:
                         self.logger.debug(f"Camera {camera_id} frame read was not successful, skipping")
                     elif frame is None:
                         self.logger.debug(f"Camera {camera_id} frame is None, skipping")
+        except Exception as e:
+            if stop_flag.is_set():
+                self.logger.debug(f"Camera {camera_id} stopped, exiting encode worker")
+            else:
+                self.logger.error(f"Error encoding frames for camera {camera_id}: {e}")
+                self.logger.error(traceback.format_exc())
+
+        # The camera is gone or stopped: end the streams of its clients
+        with context["generator_lock"]:
+            context["encode_worker"] = None
+        self._publish_frame(camera_id, None)
+
+    def generate_frames(self, camera_id):
+        """
+        Generator function that continuously yields JPEG frames for streaming.
+        Frames are encoded once per camera, by the hardware encoder or by the
+        encode thread started with the first client, and shared by all clients.
+        A client slower than the camera gets the latest frame and skips the rest.
+
+        Args:
+            camera_id: Camera device ID to generate frames from
+
+        Yields:
+            bytes: MJPEG formatted frame data
+        """
+        if camera_id not in self.camera_data_context:
+            return
+        
+        context = self.camera_data_context[camera_id]
+        stop_flag = context.get("stop_flag")
+        if stop_flag is None:
+            return
+
+        frame_cond = context["frame_cond"]
+        with frame_cond:
+            last_seq = context["frame_seq"]
+
+        with context["generator_lock"]:
+            context["active_generators"] += 1
+            if (context["hw_encoder"] is None) and (context["encode_worker"] is None):
+                context["encode_worker"] = threading.Thread(
+                    target=self._encode_worker,
+                    name=f"Camera {camera_id} Encoder",
+                    args=(camera_id,),
+                    daemon=True,
+                )
+                context["encode_worker"].start()
+        
+        try:
+            while not stop_flag.is_set():
+                with frame_cond:
+                    frame_cond.wait_for(
+                        lambda: context["frame_seq"] != last_seq or stop_flag.is_set(),
+                        timeout=1.0,
+                    )
+                    frame_seq = context["frame_seq"]
+                    frame_bytes = context["latest_frame"]
+
+                if context["camera_status"] != "Running":
+                    break
+
+                if frame_seq == last_seq:
+                    continue
+                last_seq = frame_seq
+
+                if frame_bytes is None:
+                    self.logger.debug(f"Stream of camera {camera_id} ended, exiting generator")
+                    break
+
+                yield (
+                    b"--frame\r\n"
+                    b"Content-Type: image/jpeg\r\n\r\n" + frame_bytes + b"\r\n"
+                )
         except Exception as e:
             if stop_flag.is_set():
                 self.logger.debug(f"Camera {camera_id} stopped, exiting generator")
@@ -766,9 +955,9 @@ class CamInterface:
                 self.logger.error(f"Error generating frames for camera {camera_id}: {e}")
                 self.logger.error(traceback.format_exc())
         finally:
-            with self.camera_data_context[camera_id]["generator_lock"]:
-                self.camera_data_context[camera_id]["active_generators"] = max(
-                    0, self.camera_data_context[camera_id]["active_generators"] - 1
+            with context["generator_lock"]:
+                context["active_generators"] = max(
+                    0, context["active_generators"] - 1
                 )
 
     def cleanup_resources(self):
@@ -814,7 +1003,8 @@ class CamInterface:
                 self.logger.warning(f"Warning during cleanup: {e}")
 
 
-    def capture_image_from_gard(self, hub_instance, gard, camera_id):
+    def capture_image_from_gard(self, hub_instance, gard, camera_id,
+                                roi=None, decimation=0, codec=0, out=None):
         """
         Capture a rescaled image from the connected GARD and get the properties of the image.
         
@@ -822,9 +1012,17 @@ class CamInterface:
             hub_instance: HUB instance
             gard_num: GARD number
             camera_id: Camera ID
+            roi: (x, y, width, height) part of the image to capture, None for all
+            decimation: Keep one pixel in this many in both directions, 0 for all
+            codec: enum hub_image_codecs GARD is to encode the image with, the
+                image data returned is always decoded
+            out: writable, C-contiguous buffer (e.g. a preallocated numpy
+                array) the decoded image is written into with no intermediate
+                copy, None to get the image as bytes
             
         Returns:
-            tuple: (dict, bytes) - Image info dictionary and image data, or None on failure
+            tuple: (dict, bytes-like) - Image info dictionary and image data, or None on
+                failure. With out given, the image data is out itself.
         """
         if not gard:
             self.logger.error(f"GARD handle is None")
@@ -833,6 +1031,13 @@ class CamInterface:
         # Initialize image operations context
         img_ops_ctx = HubImgOpsCtx()
         img_ops_ctx.camera_id = camera_id
+        # Keep the detections running while the image is read out
+        img_ops_ctx.no_pause = 1
+        if roi is not None:
+            (img_ops_ctx.roi_x, img_ops_ctx.roi_y,
+             img_ops_ctx.roi_width, img_ops_ctx.roi_height) = roi
+        img_ops_ctx.decimation = decimation
+        img_ops_ctx.codec = codec
         
         hub_instance.hub_lib.hub_capture_rescaled_image_from_gard.argtypes = [
             ct.c_void_p,  # gard_handle_t
@@ -855,31 +1060,80 @@ class CamInterface:
         self.logger.info(f"Image buffer size: {img_ops_ctx.image_buffer_size}")
         self.logger.info(f"Image buffer address: {img_ops_ctx.image_buffer_address}")
         
-        ret, image_data = gard.receive_data(
+        planes = 1 if img_ops_ctx.image_format == 3 else 3  # GRAYSCALE
+        image_size = planes * img_ops_ctx.h_size * img_ops_ctx.v_size
+        if img_ops_ctx.codec == 0:
+            image_size = img_ops_ctx.image_buffer_size
+
+        if out is not None and memoryview(out).nbytes < image_size:
+            self.logger.error(
+                f"Output buffer of {memoryview(out).nbytes} bytes is too small "
+                f"for {image_size} bytes"
+            )
+            return None
+
+        # An unencoded image goes straight into out, an encoded one into a
+        # buffer it is decoded from
+        if img_ops_ctx.codec == 0 and out is not None:
+            image_data = out
+        else:
+            image_data = bytearray(img_ops_ctx.image_buffer_size)
+
+        ret = gard.receive_data_into(
             img_ops_ctx.image_buffer_address,
+            image_data,
             img_ops_ctx.image_buffer_size
         )
         if ret != 0:  # HUB_SUCCESS = 0
             self.logger.error("Error in hub_recv_data_from_gard!")
             return None
         
-        self.logger.info(f"Received image data: {len(image_data)} bytes")
+        self.logger.info(f"Received image data: {img_ops_ctx.image_buffer_size} bytes")
+
+        # Decode the image if GARD encoded it
+        if img_ops_ctx.codec != 0:
+            decoded = (
+                ct.create_string_buffer(image_size) if out is None
+                else (ct.c_char * image_size).from_buffer(
+                    memoryview(out).cast("B")
+                )
+            )
+            encoded = (ct.c_char * len(image_data)).from_buffer(image_data)
+            img_ops_ctx.p_image_buffer = ct.cast(encoded, ct.c_void_p)
+
+            hub_instance.hub_lib.hub_decode_rescaled_image.argtypes = [
+                ct.POINTER(HubImgOpsCtx),  # const struct hub_img_ops_ctx *
+                ct.c_void_p,  # void *p_out
+                ct.c_uint32,  # uint32_t out_size
+            ]
+            hub_instance.hub_lib.hub_decode_rescaled_image.restype = ct.c_int
+
+            ret = hub_instance.hub_lib.hub_decode_rescaled_image(
+                ct.byref(img_ops_ctx), decoded, len(decoded)
+            )
+            if ret != 0:  # HUB_SUCCESS = 0
+                self.logger.error("Error in hub_decode_rescaled_image!")
+                return None
+
+            image_data = decoded.raw if out is None else out
+            self.logger.info(f"Decoded image data: {image_size} bytes")
         
-        hub_instance.hub_lib.hub_send_resume_pipeline.argtypes = [
-            ct.c_void_p,  # gard_handle_t
-            ct.c_uint8,   # uint8_t camera_id
-        ]
-        hub_instance.hub_lib.hub_send_resume_pipeline.restype = ct.c_int
+        if img_ops_ctx.pipeline_paused:
+            hub_instance.hub_lib.hub_send_resume_pipeline.argtypes = [
+                ct.c_void_p,  # gard_handle_t
+                ct.c_uint8,   # uint8_t camera_id
+            ]
+            hub_instance.hub_lib.hub_send_resume_pipeline.restype = ct.c_int
         
-        ret = hub_instance.hub_lib.hub_send_resume_pipeline(
-            gard.get_gard_handle(),
-            img_ops_ctx.camera_id
-        )
-        if ret != 0:  # HUB_SUCCESS = 0
-            self.logger.error("Error in hub_send_resume_pipeline!")
-            return None
+            ret = hub_instance.hub_lib.hub_send_resume_pipeline(
+                gard.get_gard_handle(),
+                img_ops_ctx.camera_id
+            )
+            if ret != 0:  # HUB_SUCCESS = 0
+                self.logger.error("Error in hub_send_resume_pipeline!")
+                return None
         
-        self.logger.info("Pipeline resumed successfully")
+            self.logger.info("Pipeline resumed successfully")
 
         image_info = {
             "camera_id": img_ops_ctx.camera_id,
@@ -30,6 +30,26 @@
 # 2.  [GARD] read_register() - Reads value from given address addr of a register
 # 3.  [GARD] send_data() - Sends data in bulk at address addr of size size over data bus
 # 4.  [GARD] receive_data() - Receives data in bulk from address addr of size size over data bus
+# 5.  [GARD] receive_data_into() - Receives data in bulk straight into a given writable buffer
+#
+# Bulk data goes between libhub and Python buffers (bytearray, memoryview,
+# numpy arrays) without intermediate copies, and libhub calls run without
+# the GIL held, so other Python threads keep running during bus I/O.
+#
+# HUB tracing:
+# 1.  [HUB] trace_start() - Starts recording GPIO app data events in a trace ring
+# 2.  [HUB] trace_stop() - Stops recording and drops the trace
+# 3.  [HUB] trace_export_json() - Writes the trace as Chrome trace / Perfetto JSON
+#
+# HUB app data of many GARDs from one thread:
+# 1.  [HUB] setup_appdata_wait_any() - Queues the app data of a GARD for wait_any()
+# 2.  [HUB] wait_any() - Gives the oldest app data queued by any GARD
+# 3.  [HUB] release_appdata_buffer() - Hands a buffer given by wait_any() back to libhub
+# 4.  [HUB] get_wait_any_fd() - Gives an fd readable while wait_any() has app data
+#
+# HUB statistics:
+# 1.  [GARD] get_stats() - Gives per operation counters and latency histograms of a GARD
+# 2.  [GARD] reset_stats() - Clears the statistics of a GARD
 #
 # HUB sensors:
 # 1.  [HUB] get_temperature_data() - Gives list of temperature values for given temperature sensor IDs
@@ -48,6 +68,93 @@ ERRCODE_EXCEPTION_FAILURE = -2147483648  # int min
 # the variable HUB_INVALID_SENSOR_VALUE in hub_sensors.h
 HUB_INVALID_SENSOR_VALUE = -1
 
+# Note: These Python variable values should reflect the values of
+# HUB_STATS_LATENCY_BUCKETS and HUB_STATS_OP_MAX in hub.h
+HUB_STATS_LATENCY_BUCKETS = 96
+HUB_STATS_OP_MAX = 6
+HUB_BUS_NAMES = ["unknown", "i2c", "uart", "usb", "mipi_csi2", "pcie"]
+
+# Note: This Python variable value should reflect the value of
+# HUB_SOM_NUM_SENSORS in hub.h
+HUB_SOM_NUM_SENSORS = 2
+
+# Note: This Python variable value should reflect the value of
+# HUB_RELOAD_RESTART_FIELDS_LEN in hub.h
+HUB_RELOAD_RESTART_FIELDS_LEN = 512
+
+# Mirrors hub_recv_chunk_cb_t of hub.h
+HUB_RECV_CHUNK_CB = ct.CFUNCTYPE(None, ct.c_void_p, ct.c_uint32, ct.c_uint32)
+
+
+# _writable_buffer maps a writable, C-contiguous Python buffer (bytearray,
+# memoryview, numpy array, ...) to a ctypes array over the same memory, to
+# pass to libhub without copying. The buffer cannot be resized while the
+# returned array is alive.
+#
+# @param:     buffer (writable buffer)
+#
+# @returns:   ctypes char array over the buffer's memory
+# @raises:    TypeError / ValueError if the buffer is read-only or not contiguous
+def _writable_buffer(buffer):
+    view = memoryview(buffer)
+    if view.readonly:
+        raise TypeError("buffer is read-only")
+    if not view.c_contiguous:
+        raise ValueError("buffer is not C-contiguous")
+
+    view = view.cast("B")
+    return (ct.c_char * view.nbytes).from_buffer(view)
+
+
+# Mirrors struct hub_op_stats of hub.h
+class HubOpStatsStruct(ct.Structure):
+    _fields_ = [
+        ("transactions", ct.c_uint64),
+        ("errors", ct.c_uint64),
+        ("bytes", ct.c_uint64),
+        ("latency_total_ns", ct.c_uint64),
+        ("latency_max_ns", ct.c_uint64),
+        ("latency_hist", ct.c_uint64 * HUB_STATS_LATENCY_BUCKETS),
+    ]
+
+
+# Mirrors struct hub_gard_stats of hub.h
+class HubGardStatsStruct(ct.Structure):
+    _fields_ = [
+        ("control_bus", ct.c_int),
+        ("data_bus", ct.c_int),
+        ("ops", HubOpStatsStruct * HUB_STATS_OP_MAX),
+    ]
+
+
+# Mirrors struct hub_reload_report of hub.h
+class HubReloadReportStruct(ct.Structure):
+    _fields_ = [
+        ("num_applied", ct.c_uint32),
+        ("num_restart", ct.c_uint32),
+        ("restart_fields", ct.c_char * HUB_RELOAD_RESTART_FIELDS_LEN),
+    ]
+
+
+# Mirrors struct hub_energy_sensor_values of hub.h
+class HubEnergySensorValuesStruct(ct.Structure):
+    _fields_ = [
+        ("voltage", ct.c_float),
+        ("current", ct.c_float),
+        ("power", ct.c_float),
+    ]
+
+
+# Mirrors struct hub_som_sensor_sample of hub.h
+class HubSomSensorSampleStruct(ct.Structure):
+    _fields_ = [
+        ("timestamp_ns", ct.c_uint64),
+        ("temperature", ct.c_float * HUB_SOM_NUM_SENSORS),
+        ("energy", HubEnergySensorValuesStruct * HUB_SOM_NUM_SENSORS),
+        ("temperature_valid", ct.c_uint8),
+        ("energy_valid", ct.c_uint8),
+    ]
+
 
 class HUB:
     # default variables
@@ -79,6 +186,9 @@ class HUB:
 
         # TBD-SSP: Handle errors per func changes
         self.gards: dict[int, GARD] = {}
+        # Buffers given to setup_appdata_wait_any(), by address
+        self._wait_any_buffers = {}
+        self.__tls = threading.local()
         self.__set_lib_args()
 
         # Throws Exception, handled in function
@@ -368,6 +478,104 @@ class HUB:
         ]
         self.hub_lib.hub_get_energy_from_onboard_sensors.restype = ct.c_int
 
+        # C function Prototype:
+        # enum hub_ret_code hub_get_som_telemetry(
+        #       hub_handle_t                  hub,
+        #       struct hub_som_sensor_sample *p_sample);
+        self.hub_lib.hub_get_som_telemetry.argtypes = [
+            ct.c_void_p,
+            ct.POINTER(HubSomSensorSampleStruct),
+        ]
+        self.hub_lib.hub_get_som_telemetry.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_reload_config(hub_handle_t              hub,
+        #                                     const char               *p_config,
+        #                                     struct hub_reload_report *p_report);
+        self.hub_lib.hub_reload_config.argtypes = [
+            ct.c_void_p,
+            ct.c_char_p,
+            ct.POINTER(HubReloadReportStruct),
+        ]
+        self.hub_lib.hub_reload_config.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_trace_start(hub_handle_t hub, uint32_t num_records);
+        self.hub_lib.hub_trace_start.argtypes = [ct.c_void_p, ct.c_uint32]
+        self.hub_lib.hub_trace_start.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_trace_stop(hub_handle_t hub);
+        self.hub_lib.hub_trace_stop.argtypes = [ct.c_void_p]
+        self.hub_lib.hub_trace_stop.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_trace_export_json(hub_handle_t hub, const char *p_path);
+        self.hub_lib.hub_trace_export_json.argtypes = [ct.c_void_p, ct.c_char_p]
+        self.hub_lib.hub_trace_export_json.restype = ct.c_int
+
+        # C function Prototype:
+        # int64_t hub_get_appdata_on_event_handler(gard_handle_t     p_gard_handle,
+        # 											int 				line_offset,
+        # 											void 				*buffer,
+        # 											uint32_t 			size)
+        # Returns: data_size (> 0) on success, error code (<= 0) on failure
+        self.hub_lib.hub_get_appdata_on_event_handler.argtypes = [
+            ct.c_void_p,
+            ct.c_int,
+            ct.c_void_p,
+            ct.c_uint32,
+        ]
+        self.hub_lib.hub_get_appdata_on_event_handler.restype = ct.c_int64
+
+        # C function Prototype:
+        # enum hub_ret_code hub_setup_appdata_cb_for_pyhub(
+        #                          gard_handle_t    gard)
+        self.hub_lib.hub_setup_appdata_cb_for_pyhub.argtypes = [ct.c_void_p]
+        self.hub_lib.hub_setup_appdata_cb_for_pyhub.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_setup_appdata_wait_any(gard_handle_t gard,
+        #                                              void *const  *pp_buffers,
+        #                                              uint32_t      num_buffers,
+        #                                              uint32_t      size);
+        self.hub_lib.hub_setup_appdata_wait_any.argtypes = [
+            ct.c_void_p,
+            ct.POINTER(ct.c_void_p),
+            ct.c_uint32,
+            ct.c_uint32,
+        ]
+        self.hub_lib.hub_setup_appdata_wait_any.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_wait_any(hub_handle_t   hub,
+        #                                uint32_t       timeout_ms,
+        #                                gard_handle_t *p_gard,
+        #                                void         **pp_buffer,
+        #                                uint32_t      *p_size);
+        self.hub_lib.hub_wait_any.argtypes = [
+            ct.c_void_p,
+            ct.c_uint32,
+            ct.POINTER(ct.c_void_p),
+            ct.POINTER(ct.c_void_p),
+            ct.POINTER(ct.c_uint32),
+        ]
+        self.hub_lib.hub_wait_any.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_release_appdata_buffer(gard_handle_t gard,
+        #                                              void         *p_buffer);
+        self.hub_lib.hub_release_appdata_buffer.argtypes = [ct.c_void_p, ct.c_void_p]
+        self.hub_lib.hub_release_appdata_buffer.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_get_wait_any_fd(hub_handle_t hub, int *p_fd);
+        self.hub_lib.hub_get_wait_any_fd.argtypes = [
+            ct.c_void_p,
+            ct.POINTER(ct.c_int),
+        ]
+        self.hub_lib.hub_get_wait_any_fd.restype = ct.c_int
+
     # __hub_preinit is libhub's Pre-Init interface.
     # Pre-initialize HUB given a host configuration file and a GARD
     # configuration directory. Host configuration file is a JSON listing
@@ -712,6 +920,64 @@ class HUB:
 
         return ret_energy_values
 
+    # get_som_telemetry reads every SOM sensor in one libhub call, instead of
+    # one get_temperature_data() and one get_energy_data() call. While the
+    # SOM sensor sampler runs, its latest sample is returned without going
+    # on the bus. Values of sensors which could not be read are None.
+    #
+    # example -
+    # Output:
+    # {'timestamp_ns': 1234567890,
+    #  'temperature': [48.5703125, 46.78125],
+    #  'energy': [{'voltage': 5.1392, 'current': 0.5795, 'power': 3.3789},
+    #             {'voltage': None, 'current': None, 'power': None}]}
+    #
+    # Sensor ID n is at index n - 1 of the lists.
+    #
+    # @returns:   telemetry (dict), None if no sensor could be read
+    # @raises:    None
+    def get_som_telemetry(self) -> dict:
+        # One sample per thread, reused from call to call
+        sample = getattr(self.__tls, "som_sample", None)
+        if sample is None:
+            sample = self.__tls.som_sample = HubSomSensorSampleStruct()
+
+        try:
+            ret = self.hub_lib.hub_get_som_telemetry(self.hub, ct.byref(sample))
+        except Exception as e:
+            self.logger.error(f"Exception occured while reading SOM telemetry: {e}")
+            return None
+
+        if ret != 0:
+            self.logger.error(f"Failed to read SOM telemetry, err: {ret}")
+            return None
+
+        temp_valid = sample.temperature_valid
+        energy_valid = sample.energy_valid
+        temperatures = list(sample.temperature)
+        energies = []
+        for i, values in enumerate(sample.energy):
+            if not (temp_valid >> i) & 1:
+                temperatures[i] = None
+            if (energy_valid >> i) & 1:
+                energies.append(
+                    {
+                        "voltage": values.voltage,
+                        "current": values.current,
+                        "power": values.power,
+                    }
+                )
+            else:
+                energies.append({"voltage": None, "current": None, "power": None})
+
+        self.logger.debug("SOM telemetry: %s %s", temperatures, energies)
+
+        return {
+            "timestamp_ns": sample.timestamp_ns,
+            "temperature": temperatures,
+            "energy": energies,
+        }
+
     # appdata_events_handler is worker thread function to monitor appdata events.
     # It runs in a loop until stop_event is set in the context.
     # For every iteration it calls libhub's hub_get_appdata_on_event_handler()
@@ -721,32 +987,26 @@ class HUB:
     def appdata_events_handler(self, hub_thread_appdata_context):
         self.logger.debug("Launched worker thread for monitoring.")
 
+        # libhub writes the app data straight into the user buffer, and the
+        # callback gets a view of it rather than a copy
+        try:
+            ctypes_buffer = _writable_buffer(hub_thread_appdata_context["buffer"])
+            buffer_view = memoryview(ctypes_buffer).cast("B")
+        except (TypeError, ValueError) as e:
+            self.logger.error(f"Invalid appdata buffer: {e}")
+            return False
+
+        # Everything passed to libhub is built once, not per event
+        get_appdata = self.hub_lib.hub_get_appdata_on_event_handler
+        gard_handle = hub_thread_appdata_context["gard_handle"]
+        line_offset = hub_thread_appdata_context["line_offset"]
+        buffer_ref = ct.byref(ctypes_buffer)
+        buffer_size = len(ctypes_buffer)
+
         while not hub_thread_appdata_context["stop_event"].is_set():
             try:
-                # C function Prototype:
-                # int64_t hub_get_appdata_on_event_handler(gard_handle_t     p_gard_handle,
-                # 											int 				line_offset,
-                # 											void 				*buffer,
-                # 											uint32_t 			size)
-                # Returns: data_size (> 0) on success, error code (<= 0) on failure
-                self.hub_lib.hub_get_appdata_on_event_handler.argtypes = [
-                    ct.c_void_p,
-                    ct.c_int,
-                    ct.c_void_p,
-                    ct.c_uint32,
-                ]
-                self.hub_lib.hub_get_appdata_on_event_handler.restype = ct.c_int64
-
-                BufferArrayType = ct.c_char * len(hub_thread_appdata_context["buffer"])
-                ctypes_buffer = BufferArrayType.from_buffer(
-                    hub_thread_appdata_context["buffer"]
-                )
-
-                app_callback_result = self.hub_lib.hub_get_appdata_on_event_handler(
-                    hub_thread_appdata_context["gard_handle"],
-                    hub_thread_appdata_context["line_offset"],
-                    ct.byref(ctypes_buffer),
-                    ct.c_uint32(len(hub_thread_appdata_context["buffer"])),
+                app_callback_result = get_appdata(
+                    gard_handle, line_offset, buffer_ref, buffer_size
                 )
 
                 if app_callback_result < 0:
@@ -761,7 +1021,7 @@ class HUB:
                     if app_callback_result > 0:
                         user_callback_result = hub_thread_appdata_context["cb_handler"](
                             hub_thread_appdata_context["cb_ctx"],
-                            hub_thread_appdata_context["buffer"][:app_callback_result],
+                            buffer_view[:app_callback_result],
                         )
 
                         if user_callback_result and user_callback_result != 0:
@@ -817,12 +1077,6 @@ class HUB:
         hub_thread_appdata_context["worker_thread"] = worker_thread
 
         try:
-            # C function Prototype:
-            # enum hub_ret_code hub_setup_appdata_cb_for_pyhub(
-            #                          gard_handle_t    gard)
-            self.hub_lib.hub_setup_appdata_cb_for_pyhub.argtypes = [ct.c_void_p]
-            self.hub_lib.hub_setup_appdata_cb_for_pyhub.restype = ct.c_int
-
             # Call the C function to register the callback.
             app_callback_result = self.hub_lib.hub_setup_appdata_cb_for_pyhub(
                 hub_thread_appdata_context["gard_handle"]
@@ -850,6 +1104,181 @@ class HUB:
 
         return True
 
+    # setup_appdata_wait_any queues the app data of a GARD for wait_any(), so
+    # that one thread serves many GARDs instead of a worker thread per GARD
+    # as with setup_appdata_callback(). libhub fills the given buffers in
+    # turn, each being held from wait_any() until release_appdata_buffer().
+    # Uses libhub's hub_setup_appdata_wait_any().
+    #
+    # @param:     gard_obj (GARD)
+    # @param:     buffers (list of writable buffers of the same size)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def setup_appdata_wait_any(self, gard_obj, buffers) -> int:
+        if (not gard_obj) or not isinstance(gard_obj, GARD):
+            self.logger.error("Invalid GARD object given")
+            return ERRCODE_EXCEPTION_FAILURE
+
+        try:
+            ctypes_buffers = [_writable_buffer(buffer) for buffer in buffers]
+        except (TypeError, ValueError) as e:
+            self.logger.error(f"Invalid appdata buffer: {e}")
+            return ERRCODE_EXCEPTION_FAILURE
+
+        if not ctypes_buffers or len({len(b) for b in ctypes_buffers}) != 1:
+            self.logger.error("Buffers must be given, all of the same size")
+            return ERRCODE_EXCEPTION_FAILURE
+
+        pointers = (ct.c_void_p * len(ctypes_buffers))(
+            *[ct.addressof(b) for b in ctypes_buffers]
+        )
+        ret = self.hub_lib.hub_setup_appdata_wait_any(
+            gard_obj.get_gard_handle(),
+            pointers,
+            len(ctypes_buffers),
+            len(ctypes_buffers[0]),
+        )
+        if ret != 0:
+            self.logger.error(f"HUB failed to set up wait-any app data: {ret}")
+            return ret
+
+        # libhub writes into the buffers until hub_fini(), keep them alive
+        for b in ctypes_buffers:
+            self._wait_any_buffers[ct.addressof(b)] = (gard_obj, b)
+
+        return ret
+
+    # wait_any waits up to timeout_ms for app data from any GARD set up with
+    # setup_appdata_wait_any(). The data is a view of the buffer libhub
+    # filled, held until it is handed to release_appdata_buffer().
+    # Uses libhub's hub_wait_any(), run without the GIL held.
+    #
+    # @param:     timeout_ms (int) - 0 not to wait
+    #
+    # @returns:   (Status Code, GARD object, memoryview of the data); the GARD
+    #             and the data are None on failure or timeout
+    # @raises:    None
+    def wait_any(self, timeout_ms: int) -> tuple[int, "GARD", memoryview]:
+        gard_handle = ct.c_void_p()
+        p_buffer = ct.c_void_p()
+        size = ct.c_uint32()
+
+        ret = self.hub_lib.hub_wait_any(
+            self.hub,
+            timeout_ms,
+            ct.byref(gard_handle),
+            ct.byref(p_buffer),
+            ct.byref(size),
+        )
+        if ret != 0:
+            return ret, None, None
+
+        gard_obj, ctypes_buffer = self._wait_any_buffers[p_buffer.value]
+        return ret, gard_obj, memoryview(ctypes_buffer).cast("B")[: size.value]
+
+    # release_appdata_buffer hands a buffer given by wait_any() back to
+    # libhub, to be filled again. Uses libhub's hub_release_appdata_buffer().
+    #
+    # @param:     gard_obj (GARD) - as given by wait_any()
+    # @param:     data (memoryview) - as given by wait_any()
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def release_appdata_buffer(self, gard_obj, data) -> int:
+        p_buffer = ct.addressof(ct.c_char.from_buffer(data))
+        ret = self.hub_lib.hub_release_appdata_buffer(
+            gard_obj.get_gard_handle(), p_buffer
+        )
+        if ret != 0:
+            self.logger.error(f"HUB failed to release appdata buffer: {ret}")
+        return ret
+
+    # get_wait_any_fd gives a file descriptor that polls readable while
+    # wait_any() has app data, to wait with select, selectors or asyncio.
+    # The fd is owned by libhub, do not read or close it.
+    # Uses libhub's hub_get_wait_any_fd().
+    #
+    # @returns:   (Status Code, fd)
+    # @raises:    None
+    def get_wait_any_fd(self) -> tuple[int, int]:
+        fd = ct.c_int(-1)
+        ret = self.hub_lib.hub_get_wait_any_fd(self.hub, ct.byref(fd))
+        if ret != 0:
+            self.logger.error(f"HUB failed to get the wait-any fd: {ret}")
+        return ret, fd.value
+
+    # reload_config applies a changed host config file to the running HUB,
+    # without re-discovering the GARDs: timeouts, transfer sizes, UART target
+    # baud rate, health periods, log level and thread properties. Other
+    # changes are kept until the HUB is created again.
+    # Uses libhub's hub_reload_config().
+    #
+    # @param:     host_config_file (str), the file given at creation if None
+    #
+    # @returns:   (Status Code, list of the fields that need a restart)
+    # @raises:    None
+    def reload_config(self, host_config_file: str = None) -> tuple[int, list]:
+        path = host_config_file or self.host_cfg_path
+        report = HubReloadReportStruct()
+
+        ret = self.hub_lib.hub_reload_config(
+            self.hub, path.encode("utf-8"), ct.byref(report)
+        )
+        if ret != 0:
+            self.logger.error(
+                "HUB failed to reload {}. Response : = {}".format(path, ret)
+            )
+
+        fields = report.restart_fields.decode("utf-8")
+        restart_fields = fields.split(", ") if fields else []
+        if restart_fields:
+            self.logger.warning(
+                "Needs a restart to change: {}".format(", ".join(restart_fields))
+            )
+        return ret, restart_fields
+
+    # trace_start starts recording every GPIO app data event, from the GARD
+    # edge to the return of the app data callback, in a ring of num_records
+    # records. Uses libhub's hub_trace_start().
+    #
+    # @param:     num_records (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def trace_start(self, num_records: int) -> int:
+        ret = self.hub_lib.hub_trace_start(self.hub, num_records)
+        if ret != 0:
+            self.logger.error("HUB failed to start tracing. Response : = {}".format(ret))
+        return ret
+
+    # trace_stop stops recording and drops the trace.
+    # Uses libhub's hub_trace_stop().
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def trace_stop(self) -> int:
+        ret = self.hub_lib.hub_trace_stop(self.hub)
+        if ret != 0:
+            self.logger.error("HUB failed to stop tracing. Response : = {}".format(ret))
+        return ret
+
+    # trace_export_json writes the trace in the Chrome trace event JSON
+    # format, to be opened in chrome://tracing or ui.perfetto.dev.
+    # Uses libhub's hub_trace_export_json().
+    #
+    # @param:     path (str)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def trace_export_json(self, path: str) -> int:
+        ret = self.hub_lib.hub_trace_export_json(self.hub, path.encode("utf-8"))
+        if ret != 0:
+            self.logger.error(
+                "HUB failed to export trace to {}. Response : = {}".format(path, ret)
+            )
+        return ret
+
 
 class GARD:
 
@@ -867,6 +1296,8 @@ class GARD:
         self.gard_num = gard_num
         self.hub_obj = HUB
         self.logger = HUB.logger
+        # Per-thread ctypes scratch of read_register, allocated once
+        self.__tls = threading.local()
         self.__set_lib_args()
 
     # __del__ is a GARD Destructor.
@@ -941,6 +1372,70 @@ class GARD:
         ]
         self.hub_obj.hub_lib.hub_recv_data_from_gard.restype = ct.c_int
 
+        # C function Prototype:
+        # enum hub_ret_code hub_recv_data_from_gard_progressive(
+        # 	gard_handle_t p_gard_handle, void *p_buffer, uint32_t addr,
+        # 	uint32_t count, uint32_t chunk_size,
+        # 	hub_recv_chunk_cb_t cb_handler, void *p_cb_ctx);
+        self.hub_obj.hub_lib.hub_recv_data_from_gard_progressive.argtypes = [
+            ct.c_void_p,
+            ct.c_void_p,
+            ct.c_uint32,
+            ct.c_uint32,
+            ct.c_uint32,
+            HUB_RECV_CHUNK_CB,
+            ct.c_void_p,
+        ]
+        self.hub_obj.hub_lib.hub_recv_data_from_gard_progressive.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_get_stats(gard_handle_t            gard,
+        # 								  struct hub_gard_stats   *p_stats);
+        self.hub_obj.hub_lib.hub_get_stats.argtypes = [
+            ct.c_void_p,
+            ct.POINTER(HubGardStatsStruct),
+        ]
+        self.hub_obj.hub_lib.hub_get_stats.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_reset_stats(gard_handle_t gard);
+        self.hub_obj.hub_lib.hub_reset_stats.argtypes = [ct.c_void_p]
+        self.hub_obj.hub_lib.hub_reset_stats.restype = ct.c_int
+
+        # C function Prototype:
+        # uint64_t hub_gard_ms_to_host_ns(gard_handle_t gard, uint32_t gard_ms);
+        self.hub_obj.hub_lib.hub_gard_ms_to_host_ns.argtypes = [
+            ct.c_void_p,
+            ct.c_uint32,
+        ]
+        self.hub_obj.hub_lib.hub_gard_ms_to_host_ns.restype = ct.c_uint64
+
+        # C function Prototype:
+        # const char *hub_stats_op_name(enum hub_stats_op op);
+        self.hub_obj.hub_lib.hub_stats_op_name.argtypes = [ct.c_int]
+        self.hub_obj.hub_lib.hub_stats_op_name.restype = ct.c_char_p
+
+        # C function Prototype:
+        # uint64_t hub_stats_bucket_floor_us(uint32_t bucket);
+        self.hub_obj.hub_lib.hub_stats_bucket_floor_us.argtypes = [ct.c_uint32]
+        self.hub_obj.hub_lib.hub_stats_bucket_floor_us.restype = ct.c_uint64
+
+        # C function Prototype:
+        # enum hub_ret_code hub_record_appdata(gard_handle_t gard,
+        #                                      const char   *p_path,
+        #                                      uint32_t      segment_size);
+        self.hub_obj.hub_lib.hub_record_appdata.argtypes = [
+            ct.c_void_p,
+            ct.c_char_p,
+            ct.c_uint32,
+        ]
+        self.hub_obj.hub_lib.hub_record_appdata.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_stop_recording(gard_handle_t gard);
+        self.hub_obj.hub_lib.hub_stop_recording.argtypes = [ct.c_void_p]
+        self.hub_obj.hub_lib.hub_stop_recording.restype = ct.c_int
+
     # write_register writes value to a register within GARD's AXI map.
     # Calls libhub's hub_write_gard_reg() which requires GARD handle,
     # address to which one should write, and a value to write.
@@ -958,14 +1453,13 @@ class GARD:
         reg_write_result = ERRCODE_EXCEPTION_FAILURE
         try:
             reg_write_result = self.hub_obj.hub_lib.hub_write_gard_reg(
-                self.__gard_handle, ct.c_int(addr), value
+                self.__gard_handle, addr, value
             )
 
             if reg_write_result == 0:
                 self.logger.debug(
-                    "Written data '{:#x}' over register at {:#x}. Response : = {}".format(
-                        value, addr, reg_write_result
-                    )
+                    "Written data '%#x' over register at %#x. Response : = %d",
+                    value, addr, reg_write_result,
                 )
             elif reg_write_result < 0:
                 self.logger.error(
@@ -996,19 +1490,21 @@ class GARD:
     # @returns:   read value (int)
     # @raises:    None
     def read_register(self, addr: int) -> tuple[int, int]:
-        value = ct.c_uint()
+        value = getattr(self.__tls, "reg_value", None)
+        if value is None:
+            value = self.__tls.reg_value = ct.c_uint()
+        value.value = 0
         reg_read_result = ERRCODE_EXCEPTION_FAILURE
 
         try:
             reg_read_result = self.hub_obj.hub_lib.hub_read_gard_reg(
-                self.__gard_handle, ct.c_int(addr), ct.byref(value)
+                self.__gard_handle, addr, value
             )
 
             if reg_read_result == 0:
                 self.logger.debug(
-                    "Read data '{:#x}' over register at {:#x}. Response : = {}".format(
-                        value.value, addr, reg_read_result
-                    )
+                    "Read data '%#x' over register at %#x. Response : = %d",
+                    value.value, addr, reg_read_result,
                 )
             elif reg_read_result < 0:
                 self.logger.error(
@@ -1031,8 +1527,11 @@ class GARD:
     # Uses libhub's hub_send_data_to_gard() to send data at given address
     # of given size. It returns the status code
     #
+    # bytes and writable, C-contiguous buffers (bytearray, memoryview, numpy
+    # arrays) are handed to libhub as they are; other data is copied first.
+    #
     # @param:     address (int)
-    # @param:     data (bytes, bytearray, array, list)
+    # @param:     data (bytes, bytearray, array, list, numpy array)
     # @param:     size (int)
     #
     # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
@@ -1041,23 +1540,29 @@ class GARD:
         reg_write_result = ERRCODE_EXCEPTION_FAILURE
 
         try:
-            if not isinstance(data, (bytes, bytearray, list)):
-                data = bytearray(data)
-
             if isinstance(data, bytes):
-                processed_data = ct.create_string_buffer(data)
+                processed_data = data
             else:
-                processed_data = ct.create_string_buffer(bytes(data))
+                try:
+                    processed_data = _writable_buffer(data)
+                except (TypeError, ValueError):
+                    processed_data = ct.create_string_buffer(bytes(data))
+
+            if size > len(processed_data):
+                self.logger.error(
+                    "Data of {} bytes is shorter than size {}".format(
+                        len(processed_data), size
+                    )
+                )
+                return reg_write_result
 
             reg_write_result = self.hub_obj.hub_lib.hub_send_data_to_gard(
-                self.__gard_handle, processed_data, ct.c_int(addr), ct.c_int(size)
+                self.__gard_handle, processed_data, addr, size
             )
 
             if reg_write_result == 0:
                 self.logger.debug(
-                    "Written data at {:#x}. Response : = {}".format(
-                        addr, reg_write_result
-                    )
+                    "Written data at %#x. Response : = %d", addr, reg_write_result
                 )
             elif reg_write_result < 0:
                 self.logger.error(
@@ -1083,30 +1588,276 @@ class GARD:
     # @returns:   data (bytes)
     # @raises:    None
     def receive_data(self, addr: int, size: int) -> tuple[int, bytes]:
+        data = bytearray(size)
+
+        reg_read_result = self.receive_data_into(addr, data)
+        if reg_read_result != 0:
+            return reg_read_result, b""
+
+        return reg_read_result, bytes(data)
+
+    # receive_data_into reads data over data bus straight into a given
+    # writable, C-contiguous buffer, e.g. a preallocated bytearray or numpy
+    # array, with no intermediate copy. Uses libhub's hub_recv_data_from_gard(),
+    # which runs without the GIL held.
+    #
+    # @param:     address (int)
+    # @param:     buffer (writable buffer)
+    # @param:     size (int) - bytes to read, None for the whole buffer
+    #
+    # @returns:   error code (int) - 0 on success, error code on failure
+    # @raises:    None
+    def receive_data_into(self, addr: int, buffer, size: int = None) -> int:
         reg_read_result = ERRCODE_EXCEPTION_FAILURE
 
         try:
-            data = ct.create_string_buffer(size)
+            data = _writable_buffer(buffer)
+            if size is None:
+                size = len(data)
+            elif size > len(data):
+                self.logger.error(
+                    "Buffer of {} bytes is too small for {} bytes".format(
+                        len(data), size
+                    )
+                )
+                return reg_read_result
+
             reg_read_result = self.hub_obj.hub_lib.hub_recv_data_from_gard(
-                self.__gard_handle, data, ct.c_int(addr), ct.c_int(size)
+                self.__gard_handle, data, addr, size
             )
 
             if reg_read_result == 0:
-                self.logger.debug(
-                    "Read data at {:#x}. Received size: {}".format(addr, reg_read_result)
-                )
-                return reg_read_result, data.raw
+                self.logger.debug("Read data at %#x. Received size: %d", addr, size)
             else:
                 self.logger.error(
                     "HUB failed to read data at {:#x}. Response : = {}".format(
                         addr, reg_read_result
                     )
                 )
-                return reg_read_result, b""
         except Exception as e:
             self.logger.error("Unable to read data at {:#x} , {}".format(addr, e))
 
-        return reg_read_result, b""
+        return reg_read_result
+
+    # receive_data_progressive reads data over data bus into a given
+    # writable, C-contiguous buffer, like receive_data_into, in chunks, and
+    # calls on_chunk(offset, length) for each chunk as soon as it is in the
+    # buffer, while the next chunks come in. Uses libhub's
+    # hub_recv_data_from_gard_progressive(); on_chunk is called from this
+    # thread, in order.
+    #
+    # @param:     address (int)
+    # @param:     buffer (writable buffer)
+    # @param:     on_chunk (callable taking offset and length)
+    # @param:     chunk_size (int) - bytes per chunk, 0 for libhub's default
+    # @param:     size (int) - bytes to read, None for the whole buffer
+    #
+    # @returns:   error code (int) - 0 on success, error code on failure
+    # @raises:    None
+    def receive_data_progressive(
+        self, addr: int, buffer, on_chunk, chunk_size: int = 0, size: int = None
+    ) -> int:
+        result = ERRCODE_EXCEPTION_FAILURE
+
+        try:
+            data = _writable_buffer(buffer)
+            if size is None:
+                size = len(data)
+            elif size > len(data):
+                self.logger.error(
+                    "Buffer of {} bytes is too small for {} bytes".format(
+                        len(data), size
+                    )
+                )
+                return result
+
+            errors = []
+
+            def chunk_done(_ctx, offset, length):
+                # Exceptions cannot cross libhub, keep the first one
+                if errors:
+                    return
+                try:
+                    on_chunk(offset, length)
+                except Exception as e:
+                    errors.append(e)
+
+            result = self.hub_obj.hub_lib.hub_recv_data_from_gard_progressive(
+                self.__gard_handle,
+                data,
+                addr,
+                size,
+                chunk_size,
+                HUB_RECV_CHUNK_CB(chunk_done),
+                None,
+            )
+
+            if errors:
+                raise errors[0]
+            if result != 0:
+                self.logger.error(
+                    "HUB failed to read data at {:#x}. Response : = {}".format(
+                        addr, result
+                    )
+                )
+        except Exception as e:
+            result = ERRCODE_EXCEPTION_FAILURE
+            self.logger.error("Unable to read data at {:#x} , {}".format(addr, e))
+
+        return result
+
+    # get_stats gives the statistics HUB keeps for this GARD.
+    # Uses libhub's hub_get_stats() and converts the snapshot into a
+    # dictionary keyed by operation name. Each operation carries its bus,
+    # counters and a latency histogram as a list of
+    # (bucket floor in microseconds, count) tuples of the non-empty buckets.
+    #
+    # @returns:   error code (int) - 0 on success, error code on failure
+    # @returns:   stats (dict)
+    # @raises:    None
+    def get_stats(self) -> tuple[int, dict]:
+        stats_result = ERRCODE_EXCEPTION_FAILURE
+        lib = self.hub_obj.hub_lib
+
+        try:
+            raw = HubGardStatsStruct()
+            stats_result = lib.hub_get_stats(self.__gard_handle, ct.byref(raw))
+            if stats_result != 0:
+                self.logger.error(
+                    "HUB failed to get GARD {} stats. Response : = {}".format(
+                        self.gard_num, stats_result
+                    )
+                )
+                return stats_result, {}
+
+            stats = {}
+            for op in range(HUB_STATS_OP_MAX):
+                op_stats = raw.ops[op]
+                op_name = lib.hub_stats_op_name(op).decode()
+                if op_name in ("read_reg", "write_reg"):
+                    bus = raw.control_bus
+                else:
+                    bus = raw.data_bus
+                stats[op_name] = {
+                    "bus": HUB_BUS_NAMES[bus] if bus < len(HUB_BUS_NAMES) else "unknown",
+                    "transactions": op_stats.transactions,
+                    "errors": op_stats.errors,
+                    "bytes": op_stats.bytes,
+                    "latency_total_ns": op_stats.latency_total_ns,
+                    "latency_max_ns": op_stats.latency_max_ns,
+                    "latency_hist": [
+                        (lib.hub_stats_bucket_floor_us(b), op_stats.latency_hist[b])
+                        for b in range(HUB_STATS_LATENCY_BUCKETS)
+                        if op_stats.latency_hist[b]
+                    ],
+                }
+
+            return stats_result, stats
+        except Exception as e:
+            self.logger.error(
+                "Unable to get GARD {} stats, {}".format(self.gard_num, e)
+            )
+
+        return stats_result, {}
+
+    # reset_stats clears the statistics HUB keeps for this GARD.
+    # Uses libhub's hub_reset_stats().
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def reset_stats(self) -> int:
+        stats_result = ERRCODE_EXCEPTION_FAILURE
+
+        try:
+            stats_result = self.hub_obj.hub_lib.hub_reset_stats(self.__gard_handle)
+            if stats_result != 0:
+                self.logger.error(
+                    "HUB failed to reset GARD {} stats. Response : = {}".format(
+                        self.gard_num, stats_result
+                    )
+                )
+        except Exception as e:
+            self.logger.error(
+                "Unable to reset GARD {} stats, {}".format(self.gard_num, e)
+            )
+
+        return stats_result
+
+    # start_recording appends every app data result of this GARD to a
+    # recording, segment files <path>.0000 and on, written by HUB before the
+    # result goes to the app data callback. Read it back with
+    # hub_app_record_replay.elf, or replay it with hub_app_mock_gard.elf -R.
+    # Calls libhub's hub_record_appdata().
+    #
+    # @param:     path (str) - path of the recording
+    # @param:     segment_size (int) - size of a segment, 0 for the default
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def start_recording(self, path: str, segment_size: int = 0) -> int:
+        ret = ERRCODE_EXCEPTION_FAILURE
+
+        try:
+            ret = self.hub_obj.hub_lib.hub_record_appdata(
+                self.__gard_handle, path.encode(), segment_size
+            )
+            if ret != 0:
+                self.logger.error(
+                    "HUB failed to record GARD {} to {}. Response : = {}".format(
+                        self.gard_num, path, ret
+                    )
+                )
+        except Exception as e:
+            self.logger.error(
+                "Unable to record GARD {}, {}".format(self.gard_num, e)
+            )
+
+        return ret
+
+    # stop_recording closes the recording of this GARD.
+    # Calls libhub's hub_stop_recording().
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @raises:    None
+    def stop_recording(self) -> int:
+        ret = ERRCODE_EXCEPTION_FAILURE
+
+        try:
+            ret = self.hub_obj.hub_lib.hub_stop_recording(self.__gard_handle)
+            if ret != 0:
+                self.logger.error(
+                    "HUB failed to stop the recording of GARD {}. "
+                    "Response : = {}".format(self.gard_num, ret)
+                )
+        except Exception as e:
+            self.logger.error(
+                "Unable to stop the recording of GARD {}, {}".format(
+                    self.gard_num, e
+                )
+            )
+
+        return ret
+
+    # result_time_to_host_ns maps the timestamp_ms of a result packet of this
+    # GARD to the host CLOCK_MONOTONIC clock (time.monotonic_ns()), so that
+    # the results of several GARDs can be paired by the capture time of their
+    # frames. Needs "clock_sync_ms" in host_config.json.
+    # Uses libhub's hub_gard_ms_to_host_ns().
+    #
+    # @param:     timestamp_ms (int) - time stamp of the result packet
+    # @returns:   host time in nanoseconds (int), None if not synchronized yet
+    # @raises:    None
+    def result_time_to_host_ns(self, timestamp_ms: int):
+        try:
+            host_ns = self.hub_obj.hub_lib.hub_gard_ms_to_host_ns(
+                self.__gard_handle, timestamp_ms & 0xFFFFFFFF
+            )
+        except Exception as e:
+            self.logger.error(
+                "Unable to map GARD {} time, {}".format(self.gard_num, e)
+            )
+            return None
+
+        return host_ns if host_ns else None
 
 
 # Exception Classes
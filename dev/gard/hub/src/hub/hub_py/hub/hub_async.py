@@ -0,0 +1,376 @@
+# -----------------------------------------------------------------------------
+# Copyright (c) 2025 Lattice Semiconductor Corporation
+#
+# SPDX-License-Identifier: UNLICENSED
+#
+# -----------------------------------------------------------------------------
+# HUB asyncio interface
+#
+# AsyncGARD wraps a GARD object with coroutines, so that a single asyncio
+# event loop can serve many clients and several GARDs at once, without a
+# thread per request.
+#
+# Interfaces of AsyncGARD class:
+#
+# 1.  read_register() / write_register() - Register access
+# 2.  receive_data() / receive_data_into() / send_data() - Bulk data. On a
+#     USB data bus these are queued on HUB's USB event thread with
+#     hub_recv_data_from_gard_async() / hub_send_data_to_gard_async(), and
+#     complete the awaiting coroutine from there.
+# 3.  capture_image_from_gard() - The whole capture, transfer and resume
+#     sequence of CamInterface.capture_image_from_gard()
+# 4.  appdata_events() - Async iterator over the app data GARD reports,
+#     delivered from HUB's GPIO worker threads via hub_setup_appdata_cb()
+#
+# Calls with no asynchronous counterpart in libhub run in the event loop's
+# default executor. libhub is called without the GIL held (ctypes releases
+# it), so these threads do not hold up the event loop either.
+# -----------------------------------------------------------------------------
+
+import asyncio
+import ctypes as ct
+import itertools
+import threading
+
+from .hub import (
+    ERRCODE_EXCEPTION_FAILURE,
+    HUB_BUS_NAMES,
+    HubGardStatsStruct,
+    _writable_buffer,
+)
+
+# Note: These Python types should reflect hub_xfer_done_cb_t and
+# hub_cb_handler_t in hub.h
+HUB_XFER_DONE_CB = ct.CFUNCTYPE(None, ct.c_void_p, ct.c_int)
+HUB_CB_HANDLER = ct.CFUNCTYPE(ct.c_void_p, ct.c_void_p, ct.c_void_p, ct.c_uint32)
+
+# App data results queued for a slow consumer before the oldest are dropped
+APPDATA_DEFAULT_QUEUE_SIZE = 16
+
+
+class AsyncGARD:
+
+    # __init__ is the AsyncGARD constructor.
+    # self.gard stores the GARD object wrapped.
+    # self.__is_usb_data tells if the data bus takes asynchronous transfers.
+    # self.__xfers maps the context of every transfer in flight to its
+    # future and buffer, which are kept alive until HUB calls back.
+    def __init__(self, gard) -> None:
+        self.gard = gard
+        self.logger = gard.logger
+        self.hub_lib = gard.hub_obj.hub_lib
+
+        self.__set_lib_args()
+
+        self.__xfers = {}
+        self.__xfers_lock = threading.Lock()
+        self.__xfer_ids = itertools.count(1)
+        self.__xfer_done_cb = HUB_XFER_DONE_CB(self.__on_xfer_done)
+
+        self.__appdata_cb = None
+        self.__appdata_buffer = None
+
+        raw = HubGardStatsStruct()
+        ret = self.hub_lib.hub_get_stats(gard.get_gard_handle(), ct.byref(raw))
+        self.__is_usb_data = (ret == 0) and (
+            raw.data_bus == HUB_BUS_NAMES.index("usb")
+        )
+
+    # __set_lib_args sets the arguments and return types of the
+    # asynchronous libhub functions, as per hub.h.
+    def __set_lib_args(self) -> None:
+        # C function Prototype:
+        # enum hub_ret_code hub_send_data_to_gard_async(gard_handle_t      p_gard_handle,
+        # 											  const void        *p_buffer,
+        # 											  uint32_t           addr,
+        # 											  uint32_t           count,
+        # 											  hub_xfer_done_cb_t cb_handler,
+        # 											  void              *p_cb_ctx);
+        self.hub_lib.hub_send_data_to_gard_async.argtypes = [
+            ct.c_void_p,
+            ct.c_void_p,
+            ct.c_uint32,
+            ct.c_uint32,
+            HUB_XFER_DONE_CB,
+            ct.c_void_p,
+        ]
+        self.hub_lib.hub_send_data_to_gard_async.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_recv_data_from_gard_async(gard_handle_t      p_gard_handle,
+        # 												void              *p_buffer,
+        # 												uint32_t           addr,
+        # 												uint32_t           count,
+        # 												hub_xfer_done_cb_t cb_handler,
+        # 												void              *p_cb_ctx);
+        self.hub_lib.hub_recv_data_from_gard_async.argtypes = [
+            ct.c_void_p,
+            ct.c_void_p,
+            ct.c_uint32,
+            ct.c_uint32,
+            HUB_XFER_DONE_CB,
+            ct.c_void_p,
+        ]
+        self.hub_lib.hub_recv_data_from_gard_async.restype = ct.c_int
+
+        # C function Prototype:
+        # enum hub_ret_code hub_setup_appdata_cb(gard_handle_t    gard,
+        # 									   hub_cb_handler_t cb_handler,
+        # 									   void            *p_cb_ctx,
+        # 									   void            *p_buffer,
+        # 									   uint32_t         size);
+        self.hub_lib.hub_setup_appdata_cb.argtypes = [
+            ct.c_void_p,
+            HUB_CB_HANDLER,
+            ct.c_void_p,
+            ct.c_void_p,
+            ct.c_uint32,
+        ]
+        self.hub_lib.hub_setup_appdata_cb.restype = ct.c_int
+
+    # __on_xfer_done is the completion callback of the asynchronous
+    # transfers, run in HUB's USB event thread. It only hands the outcome
+    # over to the event loop of the awaiting coroutine.
+    def __on_xfer_done(self, p_cb_ctx, ret) -> None:
+        with self.__xfers_lock:
+            xfer = self.__xfers.pop(p_cb_ctx, None)
+        if xfer is None:
+            return
+
+        loop, future, _ = xfer
+        loop.call_soon_threadsafe(self.__finish_xfer, future, ret)
+
+    @staticmethod
+    def __finish_xfer(future, ret) -> None:
+        # The awaiting coroutine may have been cancelled meanwhile
+        if not future.done():
+            future.set_result(ret)
+
+    # __submit_xfer queues an asynchronous transfer and waits for it.
+    #
+    # @param:     func - hub_send_data_to_gard_async / hub_recv_data_from_gard_async
+    # @param:     data (ctypes buffer) - kept alive until the transfer is done
+    # @param:     addr (int)
+    # @param:     size (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    async def __submit_xfer(self, func, data, addr: int, size: int) -> int:
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        xfer_id = next(self.__xfer_ids)
+
+        with self.__xfers_lock:
+            self.__xfers[xfer_id] = (loop, future, data)
+
+        ret = func(
+            self.gard.get_gard_handle(),
+            data,
+            addr,
+            size,
+            self.__xfer_done_cb,
+            xfer_id,
+        )
+        if ret != 0:
+            with self.__xfers_lock:
+                self.__xfers.pop(xfer_id, None)
+            return ret
+
+        # Cancelling the wait does not cancel the transfer, which keeps its
+        # buffer until HUB calls back
+        return await asyncio.shield(future)
+
+    # read_register reads a register, see GARD.read_register().
+    #
+    # @param:     address (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @returns:   value (int)
+    async def read_register(self, addr: int) -> tuple[int, int]:
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(None, self.gard.read_register, addr)
+
+    # write_register writes a register, see GARD.write_register().
+    #
+    # @param:     address (int)
+    # @param:     value (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    async def write_register(self, addr: int, value: int) -> int:
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(
+            None, self.gard.write_register, addr, value
+        )
+
+    # receive_data_into reads data over data bus straight into a writable,
+    # C-contiguous buffer, see GARD.receive_data_into(). The buffer must not
+    # be used until the coroutine returns.
+    #
+    # @param:     address (int)
+    # @param:     buffer (writable buffer)
+    # @param:     size (int) - bytes to read, None for the whole buffer
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    async def receive_data_into(self, addr: int, buffer, size: int = None) -> int:
+        if not self.__is_usb_data:
+            loop = asyncio.get_running_loop()
+            return await loop.run_in_executor(
+                None, self.gard.receive_data_into, addr, buffer, size
+            )
+
+        try:
+            data = _writable_buffer(buffer)
+        except (TypeError, ValueError) as e:
+            self.logger.error("Invalid receive buffer, {}".format(e))
+            return ERRCODE_EXCEPTION_FAILURE
+
+        if size is None:
+            size = len(data)
+        elif size > len(data):
+            self.logger.error(
+                "Buffer of {} bytes is too small for {} bytes".format(len(data), size)
+            )
+            return ERRCODE_EXCEPTION_FAILURE
+
+        ret = await self.__submit_xfer(
+            self.hub_lib.hub_recv_data_from_gard_async, data, addr, size
+        )
+        if ret != 0:
+            self.logger.error(
+                "HUB failed to read data at {:#x}. Response : = {}".format(addr, ret)
+            )
+        return ret
+
+    # receive_data reads data over data bus, see GARD.receive_data().
+    #
+    # @param:     address (int)
+    # @param:     size (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    # @returns:   data (bytes)
+    async def receive_data(self, addr: int, size: int) -> tuple[int, bytes]:
+        data = bytearray(size)
+
+        ret = await self.receive_data_into(addr, data)
+        if ret != 0:
+            return ret, b""
+
+        return ret, bytes(data)
+
+    # send_data writes data over data bus, see GARD.send_data(). The data
+    # must not be changed until the coroutine returns.
+    #
+    # @param:     address (int)
+    # @param:     data (bytes, bytearray, array, list, numpy array)
+    # @param:     size (int)
+    #
+    # @returns:   Status Code - 0: SUCCESS, Negetive: FAILURE code
+    async def send_data(self, addr: int, data, size: int) -> int:
+        if not self.__is_usb_data:
+            loop = asyncio.get_running_loop()
+            return await loop.run_in_executor(
+                None, self.gard.send_data, addr, data, size
+            )
+
+        try:
+            processed_data = _writable_buffer(data)
+        except (TypeError, ValueError):
+            processed_data = ct.create_string_buffer(bytes(data))
+
+        if size > len(processed_data):
+            self.logger.error(
+                "Data of {} bytes is shorter than size {}".format(
+                    len(processed_data), size
+                )
+            )
+            return ERRCODE_EXCEPTION_FAILURE
+
+        ret = await self.__submit_xfer(
+            self.hub_lib.hub_send_data_to_gard_async, processed_data, addr, size
+        )
+        if ret != 0:
+            self.logger.error(
+                "HUB failed to write data at {:#x}. Response : = {}".format(addr, ret)
+            )
+        return ret
+
+    # capture_image_from_gard captures an image from a GARD camera, see
+    # CamInterface.capture_image_from_gard(). The capture, transfer and
+    # pipeline resume run one after the other in an executor thread.
+    #
+    # @param:     cam_interface (CamInterface)
+    # @param:     camera_id (int)
+    # @param:     kwargs - roi, decimation, codec and out as for
+    #             CamInterface.capture_image_from_gard()
+    #
+    # @returns:   (image info dict, image data), None on failure
+    async def capture_image_from_gard(self, cam_interface, camera_id: int, **kwargs):
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(
+            None,
+            lambda: cam_interface.capture_image_from_gard(
+                self.gard.hub_obj, self.gard, camera_id, **kwargs
+            ),
+        )
+
+    # appdata_events gives the app data GARD reports, as an async iterator
+    # of bytes. It registers with libhub's hub_setup_appdata_cb(), whose
+    # callback runs in a HUB thread and queues each result for the loop.
+    # Results a slow consumer leaves queued beyond queue_size are dropped,
+    # oldest first. Only one iterator per GARD, not together with
+    # HUB.setup_appdata_callback() on the same GARD.
+    #
+    # @param:     size (int) - largest result, in bytes
+    # @param:     queue_size (int)
+    #
+    # @returns:   async iterator of bytes
+    # @raises:    RuntimeError if app data cannot be set up
+    async def appdata_events(self, size: int, queue_size: int = APPDATA_DEFAULT_QUEUE_SIZE):
+        if self.__appdata_cb is not None:
+            raise RuntimeError("App data events already set up for this GARD")
+
+        loop = asyncio.get_running_loop()
+        queue = asyncio.Queue(maxsize=queue_size)
+        state = {"is_open": True, "dropped": 0}
+
+        def put(data):
+            if queue.full():
+                queue.get_nowait()
+                state["dropped"] += 1
+            queue.put_nowait(data)
+
+        # Runs in a HUB thread: copy the result out before HUB reuses the buffer
+        def on_appdata(p_cb_ctx, p_buffer, data_size):
+            if state["is_open"] and data_size:
+                loop.call_soon_threadsafe(put, ct.string_at(p_buffer, data_size))
+            return None
+
+        self.__appdata_buffer = ct.create_string_buffer(size)
+        self.__appdata_cb = HUB_CB_HANDLER(on_appdata)
+
+        ret = self.hub_lib.hub_setup_appdata_cb(
+            self.gard.get_gard_handle(),
+            self.__appdata_cb,
+            None,
+            self.__appdata_buffer,
+            size,
+        )
+        if ret != 0:
+            self.__appdata_cb = None
+            self.__appdata_buffer = None
+            raise RuntimeError(
+                "HUB failed to set up app data callback. Response : = {}".format(ret)
+            )
+
+        # libhub keeps calling back until hub_fini(), so the callback and
+        # its buffer stay referenced once the iterator is closed
+        try:
+            while True:
+                yield await queue.get()
+        finally:
+            state["is_open"] = False
+            if state["dropped"]:
+                self.logger.warning(
+                    "GARD {} app data: {} results dropped".format(
+                        self.gard.gard_num, state["dropped"]
+                    )
+                )
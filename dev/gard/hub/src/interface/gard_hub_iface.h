@@ -17,6 +17,12 @@
 /* HUB GARD DISCOVERY CMD RESPONSE SIGNATURE */
 #define HUB_GARD_DISCOVER_SIGNATURE "I AM GARD"
 
+/**
+ * Maximum number of registers carried by a single READ_REGS_FROM_GARD or
+ * WRITE_REGS_TO_GARD command. GARD FW sizes its receive buffers on this.
+ */
+#define GARD_HUB_MAX_REGS_PER_CMD 32U
+
 enum special_markers {
 	/**
 	 * The following markers are used to indicate the start and end of data
@@ -27,6 +33,31 @@ enum special_markers {
 	END_OF_DATA_MARKER   = 0xE0DBE0DBU,
 	START_OF_DATA_MARKER = 0x50DB50DBU,
 	ACK_BYTE             = 0xAC,
+
+	/**
+	 * Starts a packet pushed by GARD to a subscribed Host. Its first byte on
+	 * the wire (0xA5) differs from the first byte of every response, so
+	 * that Host can tell a push from the response it is waiting for.
+	 */
+	APP_DATA_PUSH_MARKER = 0xDBA5DBA5U,
+
+	/**
+	 * Starts the response of a command sent with CMD_ID_TAGGED, see
+	 * struct _response_tag_header.
+	 */
+	RESPONSE_TAG_MARKER  = 0x7A,
+
+	/**
+	 * Starts each segment of a CC_SEGMENTED payload, see
+	 * struct _data_segment_header.
+	 */
+	DATA_SEGMENT_MARKER  = 0x5E,
+
+	/**
+	 * Starts the acknowledgement of GARD_HUB_RESYNC_SEQUENCE, see
+	 * struct _resync_ack.
+	 */
+	RESYNC_ACK_MARKER    = 0x5CDB5CDBU,
 };
 
 /**
@@ -52,8 +83,69 @@ enum host_request_command_ids {
 	GET_VIDEO_METADATA                 = 0xBu,
 	CAPTURE_RESCALED_IMAGE             = 0x21u,
 	RESUME_PIPELINE                    = 0x22u,
+	UPGRADE_FIRMWARE                   = 0x23u,
+	SET_UART_PARAMETERS                = 0x27u,
+	READ_REGS_FROM_GARD                = 0x28u,
+	WRITE_REGS_TO_GARD                 = 0x29u,
+	SUBSCRIBE_APP_DATA                 = 0x2Au,
+	GET_PIPELINE_STATS                 = 0x2Bu,
+	GET_NETWORK_RESIDENCY              = 0x2Cu,
+	INFERENCE_RATE                     = 0x2Du,
+	SCALER_CONFIG                      = 0x2Eu,
+	GET_IMAGE_STATS                    = 0x2Fu,
+	GET_GARD_TIME                      = 0x30u,
+	RUN_INFERENCE_ON_BUFFER            = 0x31u,
+	SWAP_NETWORK                       = 0x32u,
+	APP_DATA_COALESCING                = 0x33u,
 };
 
+/**
+ * A command_id with CMD_ID_TAGGED set is followed by a 1 byte tag and then by
+ * the command body as usual. GARD starts its response with a
+ * struct _response_tag_header echoing the tag.
+ *
+ * GARD takes the next command in while it is still sending the response of a
+ * data transfer or of a register access, and serves it right after, so a
+ * short command does not have to wait for a long response to be read before
+ * it can be sent. Only one command is taken in ahead like this and responses
+ * always come in the order of the commands; the tag lets Host check which
+ * one it is reading.
+ */
+#define CMD_ID_TAGGED (0x80u)
+
+/**
+ * The command ids from APP_COMMAND_ID_FIRST to APP_COMMAND_ID_LAST are left to
+ * the App Module, which registers the ones it handles along with the size of
+ * their body. An App Module command is sent as its command_id, the body and
+ * END_OF_DATA_MARKER, and is answered with a struct _app_command_response
+ * carrying the status returned by the App Module handler. GARD skips the
+ * body of an App Module command id that is not registered up to
+ * END_OF_DATA_MARKER, and answers it with APP_COMMAND_STATUS_NOT_REGISTERED,
+ * a status App Module handlers do not return.
+ */
+#define APP_COMMAND_ID_FIRST (0x60u)
+#define APP_COMMAND_ID_LAST  (0x7Fu)
+
+#define APP_COMMAND_STATUS_NOT_REGISTERED (0xFFFFFFFFu)
+
+/**
+ * Host resynchronizes with GARD, once a transfer has been cut short on the bus
+ * and the two no longer agree on where a command or a response starts, by
+ * sending GARD_HUB_RESYNC_SEQUENCE. GARD looks for it in all it receives,
+ * whatever it is in the middle of: it then drops the command being received
+ * or answered along with all received before the sequence, and answers with a
+ * struct _resync_ack. Host skips what it reads ahead of RESYNC_ACK_MARKER,
+ * the rest of a response GARD had started.
+ *
+ * The sequence is no command: it is taken for one wherever it shows up, be it
+ * in the payload of a data transfer. Its first byte is found nowhere else in
+ * it, so that GARD can look for it a byte at a time.
+ */
+#define GARD_HUB_RESYNC_SEQUENCE_SIZE (16U)
+#define GARD_HUB_RESYNC_SEQUENCE                                               \
+	{0xA7U, 'R', 'E', 'S', 'Y', 'N', 'C', '_',                                 \
+	 'G',   'A', 'R', 'D', '_', 'H', 'U', 'B'}
+
 /**
  * The following are the control codes that are used in the command body of
  * the host_requests structure. These control codes are used to
@@ -70,10 +162,10 @@ enum control_codes {
 	 * containing a packet number and the CRC calculated over the data contained
 	 * within that packet.
 	 * Sender:
-	 * The sender will wait for an ACK from the receiver for the previous packet
-	 * before sending the next packet. If ACK is not received within a certain
-	 * timeout, or if a NAK is received then the sender will re-send the packet
-	 * to the receiver.
+	 * The sender may have a window of packets in flight before it reads the
+	 * response to the oldest one. If a NAK is received then the sender reads
+	 * the responses to the packets still in flight, which are NAKed too, and
+	 * re-sends from the packet number embedded in the NAK.
 	 * Receiver:
 	 * The receiver will validate the CRC of each packet received and
 	 * will send an ACK if the packet is received successfully. If the packet
@@ -83,7 +175,12 @@ enum control_codes {
 	 * packet received is the next in sequence. If a packet is received out of
 	 * order then the receiver will send a NAK with the expected packet number
 	 * embedded in the NAK packet.
-	 * ***** Currently this is not implemented in the GARD firmware. *****
+	 *
+	 * Currently only SEND_DATA_TO_GARD_FOR_OFFSET supports it: the cmd is
+	 * followed by packets of struct _data_frame_header, frame_size bytes of
+	 * data and struct _data_frame_trailer, each answered with a struct
+	 * _data_frame_response. The transfer is done once the last packet is
+	 * ACKed; there is no end of data marker and no CC_SEND_ACK_AFTER_XFER.
 	 */
 	CC_USE_MTU_SIZE        = (1 << 0),
 
@@ -97,21 +194,51 @@ enum control_codes {
 	 */
 	CC_SEND_ACK_AFTER_XFER = (1 << 1),
 
-	/** When CC_CHECKSUM_PRESENT is set then a single 32-bit checksum follows
-	 * the data transfer. This field is redundant if CC_USE_MTU_SIZE field is
-	 * set. */
+	/**
+	 * When CC_CHECKSUM_PRESENT is set then the CRC-32 (as zlib crc32()) of
+	 * the payload follows the end of data marker in eod.opt_crc, in both
+	 * directions. With CC_SEND_ACK_AFTER_XFER, GARD NAKs a payload whose
+	 * CRC does not match. This field is redundant if CC_USE_MTU_SIZE field
+	 * is set, as every packet then carries its own CRC-32. */
 	CC_CHECKSUM_PRESENT    = (1 << 2),
 
 	/**
 	 * The CC_APP_DATA bit indicates that during the execution of
 	 * RECV_DATA_FROM_GARD_AT_OFFSET command, the data to be sent to the Host is
-	 * generated by the App Module and it should be read from the buffer pointed
-	 * by app_tx_buffer variable. The offset_address field in the command body
-	 * should be ignored.
+	 * generated by the App Module and it should be read from the oldest buffer
+	 * the App Module has queued. The offset_address field in the command body
+	 * should be ignored. data_size is 0 if no buffer is queued.
 	 */
 	CC_APP_DATA            = (1 << 3),
+
+	/**
+	 * With CC_APP_DATA, CC_APP_DATA_BATCH sends as many of the queued App
+	 * Module buffers as fit in data_size in one response. The payload is then
+	 * a sequence of records, each a uint32_t size followed by that many bytes
+	 * of one buffer, with no padding. A buffer larger than data_size is cut
+	 * down to fit only if it is the first one.
+	 */
+	CC_APP_DATA_BATCH      = (1 << 4),
+
+	/**
+	 * With CC_SEGMENTED, RECV_DATA_FROM_GARD_AT_OFFSET sends its payload as
+	 * segments of at most mtu_size bytes (DATA_SEGMENT_SIZE if 0), each
+	 * preceded by a struct _data_segment_header. Between two segments GARD
+	 * may answer a command sent meanwhile with CMD_ID_TAGGED: it then sends a
+	 * header of segment_size 0 followed by the whole tagged response, before
+	 * going on with the next segment. A control command thus waits for one
+	 * segment at most instead of the whole payload. The end of data marker
+	 * follows the last segment and the CRC covers the payload only. Not
+	 * supported with CC_APP_DATA, see GARD_CAP_SEGMENTED_RECV.
+	 */
+	CC_SEGMENTED           = (1 << 5),
 };
 
+/**
+ * Size of the CC_SEGMENTED segments when the command gives no mtu_size.
+ */
+#define DATA_SEGMENT_SIZE (1024U)
+
 /**
  * The following enum captures all the possible image formats. The binary image
  * data captured from the camera and sent to HUB is crafted in one of these
@@ -142,6 +269,238 @@ enum image_formats {
 	IMAGE_FORMAT__GRAYSCALE      = 0x3u,
 };
 
+/**
+ * The following are the stages GARD keeps timing statistics for, in the order
+ * of the stages array of GET_PIPELINE_STATS response. Each is timed from the
+ * CPU cycle counter, between the points the firmware starts and completes it.
+ */
+enum pipeline_stats_stages {
+	PIPELINE_STATS__CAPTURE = 0,      // Capture start to capture done
+	PIPELINE_STATS__RESCALE,          // Rescale start to rescale done
+	PIPELINE_STATS__ML,               // ML engine start to ML done
+	PIPELINE_STATS__POST_PROCESSING,  // app_ml_done() of one ML result
+	PIPELINE_STATS__HOST_TX,          // App Module buffer queued to sent
+	PIPELINE_STATS__FRAME,            // Capture start to next capture start
+	PIPELINE_STATS__NUM_STAGES,
+};
+
+/**
+ * Most networks GET_NETWORK_RESIDENCY reports on, in the order they were
+ * registered by the App Module.
+ */
+#define NETWORK_RESIDENCY__MAX_NETWORKS (8u)
+
+/**
+ * Most per-image ISP statistics GET_IMAGE_STATS returns, the newest first.
+ */
+#define IMAGE_STATS__HISTORY (8u)
+
+/**
+ * The following are the flags of a network in GET_NETWORK_RESIDENCY response.
+ */
+enum network_residency_flags {
+	NETWORK_RESIDENCY__HAS_RAM     = (1u << 0),  // HRAM is set aside for it
+	NETWORK_RESIDENCY__LOADED      = (1u << 1),  // Loaded in its HRAM
+	NETWORK_RESIDENCY__RUNNING     = (1u << 2),  // Running on the ML engine
+	NETWORK_RESIDENCY__PREFETCHING = (1u << 3),  // Being loaded in background
+	NETWORK_RESIDENCY__PINNED      = (1u << 4),  // Never evicted from HRAM
+	NETWORK_RESIDENCY__SWAPPED     = (1u << 5),  // Differs from its RFS copy
+};
+
+/**
+ * The following are the flags of CAPTURE_RESCALED_IMAGE request.
+ */
+enum capture_rescaled_image_flags {
+	// Copy the image to a buffer of its own instead of pausing the pipeline,
+	// so no RESUME_PIPELINE is needed. GARD may still pause if it does not
+	// support it, as told by pipeline_paused of the response.
+	CAPTURE_RESCALED_IMAGE__NO_PAUSE = (1u << 0),
+};
+
+/**
+ * The following are the encodings of the image of CAPTURE_RESCALED_IMAGE
+ * response. Each row of each plane of the image is encoded on its own, the
+ * planes one after the other.
+ */
+enum image_codecs {
+	IMAGE_CODEC__NONE      = 0x0u,  // The samples as they are
+	IMAGE_CODEC__RLE       = 0x1u,  // PackBits run-length of the samples
+	IMAGE_CODEC__DELTA_RLE = 0x2u,  // PackBits of the deltas to the left sample
+	IMAGE_CODEC__PACK4     = 0x3u,  // 4 MSBs of 2 samples a byte, first high
+};
+
+/**
+ * The following are the policies GARD uses to pick the captured images the ML
+ * engine is run on, set with INFERENCE_RATE command. The other images are
+ * dropped. The meaning of param of INFERENCE_RATE depends on the policy.
+ */
+enum inference_rate_modes {
+	INFERENCE_RATE__ALL_FRAMES = 0x0u,  // Every image, param is unused
+	INFERENCE_RATE__EVERY_NTH  = 0x1u,  // One image in param
+	INFERENCE_RATE__TARGET_FPS = 0x2u,  // At most param images per 1000 s
+	INFERENCE_RATE__ADAPTIVE   = 0x3u,  // Backs off above param % ML busy time
+										// or with the Host TX falling behind
+	INFERENCE_RATE__DUTY_CYCLE = 0x4u,  // One image every param ms, the camera
+										// in standby and GARD idle in between
+};
+
+/**
+ * Input buffers of RUN_INFERENCE_ON_BUFFER, so that Host sends an image while
+ * the ML engine runs on the previous one.
+ */
+#define HOST_INFERENCE__SLOTS (2u)
+
+/**
+ * The following are the operations of RUN_INFERENCE_ON_BUFFER. Host writes
+ * its image, of the format of the network input, to a free slot with
+ * SEND_DATA_TO_GARD_FOR_OFFSET, then submits it. GARD scales it to the
+ * network input and runs the ML engine on it in place of a camera image, its
+ * results coming as app data with frame_id as their frame sequence number.
+ * The first submit stops the camera images, until HOST_INFERENCE__STOP.
+ */
+enum host_inference_ops {
+	HOST_INFERENCE__QUERY  = 0x0u,  // Only report the slots
+	HOST_INFERENCE__SUBMIT = 0x1u,  // Run on the image written to slot
+	HOST_INFERENCE__STOP   = 0x2u,  // Go back to the camera images
+};
+
+/**
+ * The following are the operations of SWAP_NETWORK, which replaces a
+ * registered network without a restart:
+ * 1. NETWORK_SWAP__STAGE sets aside staging_size bytes of HRAM at
+ *    staging_address for the new network, evicting networks not needed right
+ *    away if HRAM is short. Host writes it there with
+ *    SEND_DATA_TO_GARD_FOR_OFFSET.
+ * 2. NETWORK_SWAP__COMMIT checks the CRC-32 of the staged network in the
+ *    background. The network is then switched to between two ML runs, once
+ *    it is neither running nor queued, and the next run of it uses the new
+ *    one. With NETWORK_SWAP__PERSIST, its RFS copy is then updated in the
+ *    background.
+ * 3. Host polls NETWORK_SWAP__STATUS until status is NETWORK_SWAP__SWAPPED
+ *    or NETWORK_SWAP__PERSISTED.
+ * A network swapped but not persisted is kept in HRAM until the next restart,
+ * which loads the one in the RFS again.
+ */
+enum network_swap_ops {
+	NETWORK_SWAP__STATUS = 0x0u,  // Only report the swap
+	NETWORK_SWAP__STAGE  = 0x1u,  // Set aside HRAM for network of size bytes
+	NETWORK_SWAP__COMMIT = 0x2u,  // Check crc and switch to the staged one
+	NETWORK_SWAP__ABORT  = 0x3u,  // Drop a swap not switched to yet
+};
+
+/**
+ * The following are the flags of SWAP_NETWORK request.
+ */
+enum network_swap_flags {
+	// Update the RFS copy once switched to. The new network must be of the
+	// size of the one in the RFS.
+	NETWORK_SWAP__PERSIST = (1u << 0),
+};
+
+/**
+ * The following are the states of a swap reported by SWAP_NETWORK.
+ */
+enum network_swap_status {
+	NETWORK_SWAP__IDLE       = 0x0u,  // No swap
+	NETWORK_SWAP__STAGED     = 0x1u,  // HRAM set aside, waits for COMMIT
+	NETWORK_SWAP__CHECKING   = 0x2u,  // CRC of the staged network
+	NETWORK_SWAP__PENDING    = 0x3u,  // Waits for the network to be idle
+	NETWORK_SWAP__SWAPPED    = 0x4u,  // Switched to, RFS copy not updated
+	NETWORK_SWAP__PERSISTING = 0x5u,  // Switched to, RFS copy being updated
+	NETWORK_SWAP__PERSISTED  = 0x6u,  // Switched to, RFS copy updated
+	NETWORK_SWAP__FAILED     = 0x7u,  // CRC mismatch or flash failure
+};
+
+/**
+ * With APP_DATA_COALESCING enabled, GARD raises the app data IRQ once per batch
+ * of results instead of once per result: when a result is queued while none
+ * is left unread, or when a fetch leaves results behind. Results queued while
+ * Host has not fetched the previous ones join the batch, which Host takes
+ * with one CC_APP_DATA_BATCH fetch. Results beyond the buffers of the App
+ * Module are copied, as records, in a batch buffer of
+ * APP_DATA_COALESCE__MAX_BYTES in GARD instead of being dropped; Host buffers
+ * for the fetch must hold that much. While results are left unread, the IRQ
+ * is raised again every max_latency_ms, so that a missed one does not hold
+ * them back. Host must fetch with CC_APP_DATA_BATCH, and not be subscribed
+ * with SUBSCRIBE_APP_DATA.
+ */
+#define APP_DATA_COALESCE__MAX_BYTES          (8192u)
+#define APP_DATA_COALESCE__DEFAULT_LATENCY_MS (20u)  // If max_latency_ms is 0
+
+/**
+ * The following are the sub-commands of UPGRADE_FIRMWARE. Host streams the
+ * image in chunks:
+ * 1. USCID__GET_XFER_INFORMATION gives the num_buffers staging buffers in
+ *    HRAM, of buffer_size bytes each and one after the other, and the flash
+ *    address the image starts at.
+ * 2. Host sends chunk n of the image to buffer n % num_buffers with
+ *    SEND_DATA_TO_GARD_FOR_OFFSET and queues it with
+ *    USCID__WRITE_FIRMWARE_TO_FLASH. GARD checks the CRC of the chunk, erases,
+ *    programs and verifies its flash range in the background, in the order
+ *    the chunks are queued, while Host sends the next chunk.
+ * 3. Host polls USCID__IS_OPERATION_COMPLETE before reusing a buffer: a chunk
+ *    is done once bytes_programmed is past its end. On a failure Host can
+ *    restart the transfer from bytes_programmed.
+ * USCID__GET_XFER_INFORMATION with resume set, for the same image, keeps
+ * bytes_programmed, so that an interrupted upgrade is resumed from there
+ * rather than restarted.
+ */
+enum firmware_upgrade_sub_command_ids {
+	/**
+	 * Invalid comand. We mark '0' as not a valid value.
+	 */
+	USCID__INVALID_SUB_COMMAND     = 0x0u,
+
+	/**
+	 * Return information about the resources to be used within GARD during
+	 * xfer of firmware binary.
+	 */
+	USCID__GET_XFER_INFORMATION    = 0x1u,
+
+	/**
+	 * Write the firmware binary (complete or partial) within GARD from volatile
+	 * to persistent storage.
+	 */
+	USCID__WRITE_FIRMWARE_TO_FLASH = 0x2u,
+
+	/**
+	 * Check if operation is complete.
+	 */
+	USCID__IS_OPERATION_COMPLETE   = 0x3u,
+};
+
+/**
+ * The status of the chunks queued with USCID__WRITE_FIRMWARE_TO_FLASH, see
+ * is_operation_complete_response.
+ */
+enum firmware_upgrade_status {
+	FIRMWARE_UPGRADE__IN_PROGRESS = 0x0u,  // Chunks left to program
+	FIRMWARE_UPGRADE__COMPLETE    = 0x1u,  // All queued chunks programmed
+	FIRMWARE_UPGRADE__FAILED      = 0x2u,  // A chunk failed, until the next
+										   // USCID__GET_XFER_INFORMATION
+};
+
+/**
+ * Chunks queued with USCID__WRITE_FIRMWARE_TO_FLASH start at a multiple of
+ * FIRMWARE_UPGRADE_ALIGN bytes of the image, the size of a flash sector.
+ */
+#define FIRMWARE_UPGRADE_ALIGN (4096U)
+
+/**
+ * Capabilities GARD reports in its GARD_DISCOVERY response, so that Host can
+ * pair the buses wired to the same GARD and pick the data bus without being
+ * told in its configuration.
+ */
+enum gard_capabilities {
+	GARD_CAP_BUS_I2C         = (1U << 0),  // Host commands over I2C
+	GARD_CAP_BUS_UART        = (1U << 1),  // Host commands over UART
+	GARD_CAP_BUS_USB         = (1U << 2),  // Data transfers over USB
+	GARD_CAP_DATA_CRC        = (1U << 3),  // CC_CHECKSUM_PRESENT and packets
+	GARD_CAP_APP_DATA_STREAM = (1U << 4),  // SUBSCRIBE_APP_DATA pushes
+	GARD_CAP_SEGMENTED_RECV  = (1U << 5),  // CC_SEGMENTED
+	GARD_CAP_RESYNC          = (1U << 6),  // GARD_HUB_RESYNC_SEQUENCE
+};
+
 /**
  * Ensure these structures are not padded as they are exchanged by code running
  * on different architectures.
@@ -151,6 +510,47 @@ enum image_formats {
 
 #pragma pack(1)
 
+/**
+ * Timing statistics of one pipeline stage, in CPU cycles. The average is
+ * total_cycles / count; min_cycles and max_cycles are 0 while count is 0.
+ */
+struct _pipeline_stage_stats {
+	uint32_t count;         // Number of times the stage completed
+	uint32_t rsvd1;         // Pad bytes.
+	uint64_t min_cycles;    // Shortest duration
+	uint64_t max_cycles;    // Longest duration
+	uint64_t total_cycles;  // Sum of all the durations
+};
+
+/**
+ * Residency of one ML network in the HRAM of GARD. runs_since_last_run is the
+ * count of ML runs of other networks since the network last ran, all ones if
+ * it never ran. Networks that are not pinned are evicted from HRAM lowest
+ * priority first, and least recently run first among those.
+ */
+struct _network_residency {
+	uint32_t network;              // UID of the network
+	uint32_t addr_in_ram;          // HRAM address, 0 without HRAM
+	uint32_t size;                 // Size of the network in bytes
+	uint32_t flags;                // enum network_residency_flags
+	uint32_t priority;             // Residency priority, 0 the lowest
+	uint32_t loads;                // Times it was loaded from flash
+	uint32_t runs_since_last_run;  // See above
+};
+
+/**
+ * ISP statistics of one captured image, computed by the capture stage over
+ * the image it writes. frame_seq numbers the captured images from boot on,
+ * as get_frame_sequence() does for the App Module.
+ */
+struct _image_stats {
+	uint32_t frame_seq;  // Sequence number of the image
+	uint8_t  gray_avg;   // Average gray level
+	uint8_t  gray_min;   // Darkest gray level
+	uint8_t  gray_max;   // Brightest gray level
+	uint8_t  rsvd1;      // Pad byte.
+};
+
 struct _host_requests {
 	uint8_t command_id;  // Command identifier having a value from enum
 						 // host_request_command_ids
@@ -216,7 +616,14 @@ struct _host_requests {
 		// command_id is CAPTURE_RESCALED_IMAGE.
 		struct _capture_rescaled_image_request {
 			uint8_t  camera_id;           // Camera to take the image.
-			uint16_t rsvd1;               // Pad bytes.
+			uint8_t  flags;               // enum capture_rescaled_image_flags
+			uint8_t  decimation;          // 1 pixel kept in this many, 0 = 1
+			uint16_t roi_x;               // Left of the image part to send
+			uint16_t roi_y;               // Top of the image part to send
+			uint16_t roi_width;           // Width to send, 0 for whole image
+			uint16_t roi_height;          // Height to send, 0 for whole image
+			uint8_t  codec;               // enum image_codecs wanted
+			uint8_t  rsvd1[3];            // Pad bytes.
 			uint32_t end_of_data_marker;  // END OF DATA marker
 		} capture_rescaled_image_request;
 
@@ -227,6 +634,198 @@ struct _host_requests {
 			uint16_t rsvd1;               // Pad bytes.
 			uint32_t end_of_data_marker;  // END OF DATA marker
 		} resume_pipeline_request;
+
+		// struct set_uart_parameters_request is to be used when
+		// command_id is SET_UART_PARAMETERS. GARD ACKs at the current
+		// rate and then switches its UART to the new parameters.
+		struct _set_uart_parameters_request {
+			uint32_t baud_rate;           // New baud rate in bits/sec.
+			uint8_t  hw_flow_control;     // 1 for RTS/CTS, 0 for none.
+			uint8_t  rsvd1[3];            // Pad bytes.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} set_uart_parameters_request;
+
+		// struct read_regs_from_gard_request is to be used when
+		// command_id is READ_REGS_FROM_GARD. The cmd is followed by
+		// num_regs register addresses and then the end of data marker.
+		struct _read_regs_from_gard_request {
+			struct {
+				uint16_t num_regs;  // 1 to GARD_HUB_MAX_REGS_PER_CMD
+				uint16_t rsvd1;     // Pad bytes.
+			} cmd;
+
+			uint32_t offset_address[0];  // Register addresses to read
+
+			struct {
+				uint32_t end_of_data_marker;  // END OF DATA marker
+			} eod;
+		} read_regs_from_gard_request;
+
+		// struct write_regs_to_gard_request is to be used when
+		// command_id is WRITE_REGS_TO_GARD. The cmd is followed by
+		// num_regs (address, value) pairs and then the end of data marker.
+		// The registers are written in the order they are listed.
+		struct _write_regs_to_gard_request {
+			struct {
+				uint16_t num_regs;  // 1 to GARD_HUB_MAX_REGS_PER_CMD
+				uint16_t rsvd1;     // Pad bytes.
+			} cmd;
+
+			struct {
+				uint32_t offset_address;  // Register address to write
+				uint32_t data;            // 32-bit data to be written
+			} regs[0];
+
+			struct {
+				uint32_t end_of_data_marker;  // END OF DATA marker
+			} eod;
+		} write_regs_to_gard_request;
+
+		// struct subscribe_app_data_request is to be used when
+		// command_id is SUBSCRIBE_APP_DATA. Once it has ACKed enable = 1,
+		// GARD pushes every App Module result to Host on the same
+		// interface (see struct _app_data_push_header) instead of raising
+		// the host IRQ, until enable = 0 is sent.
+		struct _subscribe_app_data_request {
+			uint8_t  enable;              // 1 to subscribe, 0 to unsubscribe.
+			uint8_t  rsvd1[3];            // Pad bytes.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} subscribe_app_data_request;
+
+		// struct get_pipeline_stats_request is to be used when
+		// command_id is GET_PIPELINE_STATS.
+		struct _get_pipeline_stats_request {
+			uint8_t  reset;               // 1 to clear the stats once sent.
+			uint8_t  rsvd1[3];            // Pad bytes.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_pipeline_stats_request;
+
+		// struct get_network_residency_request is to be used when
+		// command_id is GET_NETWORK_RESIDENCY.
+		struct _get_network_residency_request {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_network_residency_request;
+
+		// struct get_image_stats_request is to be used when command_id is
+		// GET_IMAGE_STATS.
+		struct _get_image_stats_request {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_image_stats_request;
+
+		// struct get_gard_time_request is to be used when command_id is
+		// GET_GARD_TIME.
+		struct _get_gard_time_request {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_gard_time_request;
+
+		// struct run_inference_on_buffer_request is to be used when
+		// command_id is RUN_INFERENCE_ON_BUFFER. The image is planar, width
+		// by height pixels a plane.
+		struct _run_inference_on_buffer_request {
+			uint8_t  op;                  // enum host_inference_ops
+			uint8_t  slot;                // Slot the image was written to
+			uint8_t  format;              // enum image_formats of the image
+			uint8_t  rsvd1;               // Pad bytes.
+			uint16_t width;               // Image size, in pixels
+			uint16_t height;
+			uint32_t frame_id;            // Frame sequence number of results
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} run_inference_on_buffer_request;
+
+		// struct swap_network_request is to be used when command_id is
+		// SWAP_NETWORK.
+		struct _swap_network_request {
+			uint8_t  op;                  // enum network_swap_ops
+			uint8_t  flags;               // enum network_swap_flags
+			uint16_t rsvd1;               // Pad bytes.
+			uint32_t network;             // UID of the registered network
+			uint32_t size;                // Bytes of the new network
+			uint32_t crc;                 // CRC-32 of the new network
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} swap_network_request;
+
+		// struct app_data_coalescing_request is to be used when command_id is
+		// APP_DATA_COALESCING.
+		struct _app_data_coalescing_request {
+			uint8_t  set;                 // 1 to set enable and latency
+			uint8_t  enable;              // 1 to coalesce the app data IRQs
+			uint8_t  rsvd1[2];            // Pad bytes.
+			uint32_t max_latency_ms;      // IRQ raised again this often
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} app_data_coalescing_request;
+
+		// struct inference_rate_request is to be used when command_id is
+		// INFERENCE_RATE.
+		struct _inference_rate_request {
+			uint8_t  set;                 // 1 to set mode and param, 0 to read
+			uint8_t  mode;                // enum inference_rate_modes
+			uint8_t  rsvd1[2];            // Pad bytes.
+			uint32_t param;               // See enum inference_rate_modes
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} inference_rate_request;
+
+		// struct scaler_config_request is to be used when command_id is
+		// SCALER_CONFIG. The box scaler takes the precrop window of the
+		// sensor image and divides it by the factors, the bilinear scaler
+		// then crops the box scaler output, of crop_in size, and scales the
+		// crop to out size. Windows are left/upper inclusive and right/bottom
+		// exclusive.
+		struct _scaler_config_request {
+			uint8_t  set;                 // 1 to set the config, 0 to read
+			uint8_t  box_factor_x;        // Box scaler horizontal factor
+			uint8_t  box_factor_y;        // Box scaler vertical factor
+			uint8_t  rsvd1;               // Pad bytes.
+			uint16_t precrop_left;        // Box scaler input window
+			uint16_t precrop_right;
+			uint16_t precrop_upper;
+			uint16_t precrop_bottom;
+			uint16_t crop_left;           // Bilinear scaler crop window
+			uint16_t crop_right;
+			uint16_t crop_upper;
+			uint16_t crop_bottom;
+			uint16_t crop_in_width;       // Box scaler output size
+			uint16_t crop_in_height;
+			uint16_t out_width;           // Captured image size
+			uint16_t out_height;
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} scaler_config_request;
+
+		// struct app_command_request is to be used when command_id is an
+		// App Module command. Its body, of the size registered by the App
+		// Module, and END_OF_DATA_MARKER follow command_id.
+		struct _app_command_request {
+			uint32_t dummy[0];  // The body is received by GARD separately.
+		} app_command_request;
+
+		// struct upgrade_firmware_request is to be used when
+		// command_id is UPGRADE_FIRMWARE. See enum
+		// firmware_upgrade_sub_command_ids.
+		struct _upgrade_firmware_request {
+			uint8_t sub_command_id;  // Sub-command identifier
+
+			union {
+				struct {
+					uint16_t is_bitstream_included : 1;   // Bitstream in image.
+					uint16_t resume                : 1;   // Keep the bytes
+														  // programmed.
+					uint16_t rsvd1                 : 14;  // Pad bytes
+					uint32_t firmware_size;  // Size of the firmware
+					uint32_t rsvd2[3];       // Pad bytes
+				} get_xfer_information;
+
+				struct {
+					uint16_t rsvd1;           // Pad bytes
+					uint32_t buffer_address;  // Buffer address containing data
+					uint32_t bytes_to_write;  // Size of this data packet
+					uint32_t flash_address;   // Flash address to write to
+					uint32_t crc;             // CRC-32 of this data packet
+				} write_firmware_to_flash;
+
+				struct {
+					uint8_t rsvd1[18];  // Pad bytes
+				} is_operation_complete;
+			};
+		} upgrade_firmware_request;
 	};
 };
 
@@ -281,8 +880,13 @@ struct _host_responses {
 		struct _gard_discovery_response {
 			uint32_t start_of_data_marker;  // START OF DATA marker
 			uint8_t  signature[10];         // Signature for discovery response
+			uint32_t device_id[2];  // Unique id of the GARD, low word first,
+									// the same on all its buses
+			uint32_t profile_id;    // GARD profile, for gard_<id>.json
+			uint32_t fw_version;    // Major << 16 | minor << 8 | bug fix
+			uint32_t capabilities;  // enum gard_capabilities bits
+			uint32_t max_mtu_size;  // Largest mtu_size GARD takes, in bytes
 			uint32_t end_of_data_marker;    // END OF DATA marker
-			// No data present in the discovery response body
 		} gard_discovery_response;
 
 		// struct capture_rescaled_image_response is to be used when
@@ -294,6 +898,12 @@ struct _host_responses {
 			uint16_t h_size;                // Horizontal size of the image.
 			uint16_t v_size;                // Vertical size of the image.
 			uint32_t image_format;  // Definition from enum image_formats
+			uint8_t  pipeline_paused;  // 1 if RESUME_PIPELINE is to be sent
+			uint8_t  codec;            // enum image_codecs of the image
+			uint8_t  rsvd1[2];         // Pad bytes.
+			uint32_t frame_seq;        // Sequence number of the image
+			uint32_t capture_time_lo;  // GARD time its capture started at,
+			uint32_t capture_time_hi;  // see GET_GARD_TIME
 
 			struct {
 				uint32_t end_of_data_marker;  // END OF DATA marker
@@ -305,9 +915,283 @@ struct _host_responses {
 		struct _resume_pipeline_response {
 			uint8_t ack_or_nak;  // Pipeline resume status
 		} resume_pipeline_response;
+
+		// struct set_uart_parameters_response is to be used when
+		// command_id is SET_UART_PARAMETERS.
+		struct _set_uart_parameters_response {
+			uint8_t ack_or_nak;  // ACK_BYTE if the parameters are accepted
+		} set_uart_parameters_response;
+
+		// struct read_regs_from_gard_response is to be used when
+		// command_id is READ_REGS_FROM_GARD.
+		struct _read_regs_from_gard_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_regs;              // Number of values that follow
+			uint32_t reg_value[0];  // Values in the order of the request
+
+			struct {
+				uint32_t end_of_data_marker;  // END OF DATA marker
+			} eod;
+		} read_regs_from_gard_response;
+
+		// struct write_regs_to_gard_response is to be used when
+		// command_id is WRITE_REGS_TO_GARD.
+		struct _write_regs_to_gard_response {
+			uint8_t ack;  // ACK byte to send after all writes complete
+		} write_regs_to_gard_response;
+
+		// struct subscribe_app_data_response is to be used when
+		// command_id is SUBSCRIBE_APP_DATA.
+		struct _subscribe_app_data_response {
+			uint8_t ack_or_nak;  // ACK_BYTE if the subscription is changed
+		} subscribe_app_data_response;
+
+		// struct get_pipeline_stats_response is to be used when
+		// command_id is GET_PIPELINE_STATS.
+		struct _get_pipeline_stats_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t cycles_per_us;         // CPU clock, to convert cycles
+			uint32_t num_stages;            // PIPELINE_STATS__NUM_STAGES
+			uint32_t rsvd1;                 // Pad bytes.
+			struct _pipeline_stage_stats stages[PIPELINE_STATS__NUM_STAGES];
+
+			struct {
+				uint32_t rsvd2;               // Pad bytes.
+				uint32_t end_of_data_marker;  // END OF DATA marker
+			} eod;
+		} get_pipeline_stats_response;
+
+		// struct get_network_residency_response is to be used when
+		// command_id is GET_NETWORK_RESIDENCY.
+		struct _get_network_residency_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_networks;          // Valid entries of networks
+			uint32_t free_bytes;            // Free HRAM for networks
+			uint32_t largest_free_bytes;    // Largest free block of it
+			struct _network_residency
+				networks[NETWORK_RESIDENCY__MAX_NETWORKS];
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_network_residency_response;
+
+		// struct get_image_stats_response is to be used when command_id is
+		// GET_IMAGE_STATS. images_recorded counts the images captured since
+		// boot, so that Host can tell how many it has missed.
+		struct _get_image_stats_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_stats;             // Valid entries of stats
+			uint32_t images_recorded;       // Images captured since boot
+			struct _image_stats stats[IMAGE_STATS__HISTORY];
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_image_stats_response;
+
+		// struct get_gard_time_response is to be used when command_id is
+		// GET_GARD_TIME. The time is the GARD CPU timer, counting timer_freq
+		// ticks per second from boot on, read as the response is composed;
+		// the frames are time stamped with it. Host pairs it with the middle
+		// of the round trip of the command to map it to its own clock.
+		struct _get_gard_time_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t time_lo;               // Low 32 bits of the time
+			uint32_t time_hi;               // High 32 bits of the time
+			uint32_t timer_freq;            // Ticks per second
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} get_gard_time_response;
+
+		// struct run_inference_on_buffer_response is to be used when
+		// command_id is RUN_INFERENCE_ON_BUFFER. A slot is free once the
+		// image submitted in it has been scaled to the network input.
+		struct _run_inference_on_buffer_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless op is refused
+			uint8_t  active;                // 1 while running Host images
+			uint8_t  free_slots;            // Bit n set if slot n is free
+			uint8_t  rsvd1;                 // Pad bytes.
+			uint32_t slot_address[HOST_INFERENCE__SLOTS];  // In GARD HRAM
+			uint32_t slot_size;             // Bytes a slot holds
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} run_inference_on_buffer_response;
+
+		// struct swap_network_response is to be used when command_id is
+		// SWAP_NETWORK.
+		struct _swap_network_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless op is refused
+			uint8_t  status;                // enum network_swap_status
+			uint16_t rsvd1;                 // Pad bytes.
+			uint32_t network;               // UID of the network swapped
+			uint32_t staging_address;       // In GARD HRAM, 0 if none
+			uint32_t staging_size;          // Bytes set aside there
+			uint32_t bytes_persisted;       // Of the RFS copy, once PERSISTING
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} swap_network_response;
+
+		// struct app_data_coalescing_response is to be used when command_id is
+		// APP_DATA_COALESCING. Counts are since boot.
+		struct _app_data_coalescing_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  enabled;               // 1 if coalescing
+			uint8_t  rsvd1[2];              // Pad bytes.
+			uint32_t max_latency_ms;        // In use
+			uint32_t irqs_raised;           // App data IRQs raised
+			uint32_t results_coalesced;     // Results not raising the IRQ
+			uint32_t results_copied;        // Into the batch buffer
+			uint32_t results_dropped;       // No room in queue nor batch
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} app_data_coalescing_response;
+
+		// struct inference_rate_response is to be used when command_id is
+		// INFERENCE_RATE. Rates are in images per 1000 s, measured over the
+		// last second.
+		struct _inference_rate_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  mode;                  // enum inference_rate_modes in use
+			uint8_t  rsvd1[2];              // Pad bytes.
+			uint32_t param;                 // param in use
+			uint32_t frames_offered;        // Images ready for the ML engine
+			uint32_t frames_run;            // Images the ML engine was run on
+			uint32_t offered_mfps;          // Rate of the images offered
+			uint32_t run_mfps;              // Rate of the images run on
+			uint32_t run_interval;          // One image run in this many now
+			uint32_t wake_us;               // Camera wake-up, DUTY_CYCLE
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} inference_rate_response;
+
+		// struct scaler_config_response is to be used when command_id is
+		// SCALER_CONFIG. It holds the config last set, applied once applied
+		// is set.
+		struct _scaler_config_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  applied;               // 1 once captures use the config
+			uint8_t  box_factor_x;          // See scaler_config_request
+			uint8_t  box_factor_y;
+			uint16_t precrop_left;
+			uint16_t precrop_right;
+			uint16_t precrop_upper;
+			uint16_t precrop_bottom;
+			uint16_t crop_left;
+			uint16_t crop_right;
+			uint16_t crop_upper;
+			uint16_t crop_bottom;
+			uint16_t crop_in_width;
+			uint16_t crop_in_height;
+			uint16_t out_width;
+			uint16_t out_height;
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} scaler_config_response;
+
+		// struct app_command_response is to be used when command_id is an
+		// App Module command.
+		struct _app_command_response {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t status;                // Returned by the App Module
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} app_command_response;
+
+		// struct upgrade_firmware_response is to be used when
+		// command_id is UPGRADE_FIRMWARE.
+		struct _upgrade_firmware_response {
+			union {
+				struct {
+					uint32_t start_of_data_marker;  // START OF DATA marker
+					uint32_t buffer_address;        // First buffer address.
+					uint32_t buffer_size;           // Buffer size, 0 if the
+													// upgrade is refused.
+					uint32_t flash_address;         // Flash address.
+					uint32_t num_buffers;           // Count of buffers.
+
+					struct {
+						uint32_t end_of_data_marker;  // END OF DATA marker
+					} eod;
+				} get_xfer_information_response;
+
+				struct {
+					uint8_t ack;  // ACK if the chunk is queued, NAK otherwise
+				} write_firmware_to_flash_response;
+
+				struct {
+					uint8_t  operation_status;  // enum firmware_upgrade_status
+					uint8_t  rsvd1[3];          // Pad bytes
+					uint32_t bytes_programmed;  // Image bytes programmed and
+												// verified from its start
+				} is_operation_complete_response;
+			};
+		} upgrade_firmware_response;
 	};
 };
 
+/**
+ * Packets of a SEND_DATA_TO_GARD_FOR_OFFSET payload sent with
+ * CC_USE_MTU_SIZE. Packet frame_num carries the frame_size bytes at
+ * offset_address + frame_num * mtu_size; all packets but the last one are
+ * mtu_size bytes. crc is the CRC-32 (as zlib crc32()) of the packet data.
+ */
+struct _data_frame_header {
+	uint16_t frame_num;   // Packet number, from 0
+	uint16_t frame_size;  // Bytes of data that follow
+};
+
+struct _data_frame_trailer {
+	uint32_t crc;  // CRC-32 of the packet data
+};
+
+/**
+ * GARD answers every packet, in order, with struct _data_frame_response:
+ * ACK_BYTE and next_frame_num = frame_num + 1 if it took the packet, else a
+ * NAK (any other byte) with the packet number it expects. A next_frame_num of
+ * GARD_HUB_FRAME_NUM_ABORT means GARD gave up on the transfer.
+ */
+#define GARD_HUB_FRAME_NUM_ABORT 0xFFFFU
+
+struct _data_frame_response {
+	uint8_t  ack_or_nak;      // ACK_BYTE if the packet was taken
+	uint8_t  rsvd1;           // Pad byte.
+	uint16_t next_frame_num;  // Packet number GARD expects next
+};
+
+/**
+ * Packet GARD pushes to a subscribed Host, only ever between two command
+ * responses: this header, data_size bytes of App Module data and then
+ * END_OF_DATA_MARKER. seq_num counts the results produced since the
+ * subscription, so that Host can tell how many it has missed.
+ */
+struct _app_data_push_header {
+	uint32_t push_marker;  // APP_DATA_PUSH_MARKER
+	uint32_t seq_num;      // Result number, from 0
+	uint32_t data_size;    // Bytes of data that follow
+};
+
+/**
+ * Sent by GARD ahead of the response of a command sent with CMD_ID_TAGGED.
+ */
+struct _response_tag_header {
+	uint8_t tag_marker;  // RESPONSE_TAG_MARKER
+	uint8_t tag;         // Tag that followed the command_id
+};
+
+/**
+ * Sent by GARD ahead of each segment of a CC_SEGMENTED payload. A
+ * segment_size of 0 announces a tagged response instead of a segment.
+ */
+struct _data_segment_header {
+	uint8_t  segment_marker;  // DATA_SEGMENT_MARKER
+	uint8_t  rsvd1;           // Pad byte
+	uint16_t segment_size;    // Bytes of payload that follow
+};
+
+/**
+ * Sent by GARD once it has received GARD_HUB_RESYNC_SEQUENCE and dropped the
+ * command it was serving. resync_count counts the sequences received since
+ * boot, this one included.
+ */
+struct _resync_ack {
+	uint32_t resync_ack_marker;   // RESYNC_ACK_MARKER
+	uint32_t resync_count;        // Resynchronizations since boot
+	uint32_t end_of_data_marker;  // END OF DATA marker
+};
+
 #pragma pack()
 
 #endif  // GARD_HUB_IFACE_H
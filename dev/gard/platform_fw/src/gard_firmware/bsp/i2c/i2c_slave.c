@@ -157,6 +157,41 @@ uint8_t i2c_slave_init(struct i2c_slave_instance *this_i2cs,
 	return I2C_SLV_SUCCESS;
 }
 
+uint8_t i2c_slave_rx_int_enable(struct i2c_slave_instance *this_i2cs,
+								uint8_t                    enable)
+{
+	struct i2c_dev *dev;
+
+	GARD__DBG_ASSERT(NULL != this_i2cs, "i2c_slave_instance is NULL");
+
+	dev = (struct i2c_dev *)(this_i2cs->base_addr);
+
+	// The RX FIFO is drained when it is almost full and at the end of a write.
+	if (enable) {
+		dev->int_enable1 = I2C_SLAVE_RX_FIFO_AFULL_INT | I2C_SLAVE_STOP_DET_INT;
+	} else {
+		dev->int_enable1 = 0;
+	}
+
+	return I2C_SLV_SUCCESS;
+}
+
+uint32_t i2c_slave_clear_int(struct i2c_slave_instance *this_i2cs)
+{
+	struct i2c_dev *dev;
+	uint32_t        int_status;
+
+	GARD__DBG_ASSERT(NULL != this_i2cs, "i2c_slave_instance is NULL");
+
+	dev              = (struct i2c_dev *)(this_i2cs->base_addr);
+
+	// Status bits are cleared by writing them back.
+	int_status       = dev->int_status1;
+	dev->int_status1 = int_status;
+
+	return int_status;
+}
+
 uint8_t i2c_slave_config(struct i2c_slave_instance *this_i2cs)
 {
 	struct i2c_dev *dev;
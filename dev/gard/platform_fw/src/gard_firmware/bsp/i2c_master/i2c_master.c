@@ -46,6 +46,13 @@ uint8_t i2c_master_init(struct i2cm_instance *this_i2cm, uint32_t base_addr)
 	this_i2cm->interrupts_en = 0;
 	this_i2cm->rx_buff       = NULL;
 	this_i2cm->rcv_length    = 0;
+	this_i2cm->tx_buff       = NULL;
+	this_i2cm->tx_length     = 0;
+	this_i2cm->xfer_head     = NULL;
+	this_i2cm->xfer_tail     = NULL;
+	this_i2cm->msg_idx       = 0;
+	this_i2cm->msg_offset    = 0;
+	this_i2cm->chunk_end     = 0;
 
 	return 0;
 }
@@ -463,40 +470,358 @@ uint8_t i2c_master_write(struct i2cm_instance *this_i2cm,
 	return i2c_status;
 }
 
-void i2c_master_isr(void *ctx)
+uint8_t i2c_master_write_start(struct i2cm_instance *this_i2cm,
+							   uint16_t              address,
+							   uint8_t               data_size,
+							   uint8_t              *data_buffer)
 {
-	uint8_t                        i2c_int1  = 0;
-	uint8_t                        i2c_int2  = 0;
+	uint8_t status   = 0;
+	uint8_t i2c_int2 = 0;
 
-	volatile struct i2cm_instance *this_i2cm = (struct i2cm_instance *)ctx;
+	if (NULL == this_i2cm || NULL == data_buffer) {
+		return 1;
+	}
 
-	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &i2c_int1);
-	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS2, &i2c_int2);
+	if (this_i2cm->state != I2CM_STATE_IDLE) {
+		return 1;
+	}
 
-	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS1, i2c_int1);
+	// config the register before issue the transaction
+	reg_8b_write(this_i2cm->base_address | REG_BYTE_CNT, data_size);
+
+	reg_8b_write(this_i2cm->base_address | REG_SLAVE_ADDR_LOW, address & 0x7F);
+
+	if (this_i2cm->addr_mode == I2CM_ADDR_10BIT_MODE)  // 10-bit mode
+	{
+		reg_8b_write(this_i2cm->base_address | REG_SLAVE_ADDR_HIGH,
+					 (address >> 8) & 0x03);
+	}
+
+	// set to write mode
+	reg_8b_modify(this_i2cm->base_address | REG_MODE, I2C_TXRX_MODE, 0);
+
+	// clear status bits
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &status);
+	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS1, status);
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS2, &i2c_int2);
 	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS2, i2c_int2);
 
-	if (i2c_int1 & I2C_TRANSFER_COMP_MASK) {
-		this_i2cm->state = I2CM_STATE_IDLE;
+	while (data_size > 0) {
+		// stop loading once the tx fifo is full, i2c_master_write_poll()
+		// loads the rest
+		reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &status);
+		if ((status & TX_FIFO_FULL_MASK) != 0) {
+			break;
+		}
+
+		reg_8b_write(this_i2cm->base_address | REG_DATA_BUFFER, *data_buffer);
+		data_buffer++;
+		data_size--;
 	}
 
-	if (i2c_int1 & RX_FIFO_RDY_MASK) {
-		if ((this_i2cm->state == I2CM_STATE_READ) &&
-			(this_i2cm->rx_buff != NULL)) {
-			reg_8b_read(this_i2cm->base_address | REG_DATA_BUFFER,
-						this_i2cm->rx_buff);
+	this_i2cm->tx_buff   = data_buffer;
+	this_i2cm->tx_length = data_size;
+
+	// start the transaction
+	this_i2cm->state = I2CM_STATE_WRITE;
+	reg_8b_write(this_i2cm->base_address | REG_CONFIG, I2C_START);
+
+	return 0;
+}
 
-			this_i2cm->rx_buff++;
-			this_i2cm->rcv_length++;
+uint8_t i2c_master_write_poll(struct i2cm_instance *this_i2cm)
+{
+	uint8_t status      = 0;
+	uint8_t i2c_int2    = 0;
+	uint8_t fifo_status = 0;
+
+	if (this_i2cm->state != I2CM_STATE_WRITE) {
+		return this_i2cm->state;
+	}
+
+	// cycle completes when all bytes are transmitted or a NACK is received
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &status);
+	if (status & I2C_TRANSFER_COMP_MASK) {
+		this_i2cm->state = I2CM_STATE_IDLE;
+		return I2CM_STATE_IDLE;
+	}
+
+	// load any additional bytes into tx fifo when it becomes almost empty
+	if (this_i2cm->tx_length > 0) {
+		reg_8b_read(this_i2cm->base_address | FIFO_STATUS_REG, &fifo_status);
+		if (fifo_status & TX_FIFO_AEMPTY_MASK) {
+			reg_8b_write(this_i2cm->base_address | REG_DATA_BUFFER,
+						 *this_i2cm->tx_buff);
+			this_i2cm->tx_buff++;
+			this_i2cm->tx_length--;
 		}
 	}
 
+	// check for I2C errors including NACK
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS2, &i2c_int2);
 	if (i2c_int2 & I2C_ERR) {
 		// reset the i2c master
 		reg_8b_modify(this_i2cm->base_address | REG_CONFIG, I2C_MASTER_RESET,
 					  I2C_MASTER_RESET);
+		reg_8b_modify(this_i2cm->base_address | REG_CONFIG, I2C_MASTER_RESET,
+					  ~I2C_MASTER_RESET);
 
 		this_i2cm->state = I2CM_STATE_IDLE;
+		return I2CM_STATE_ERROR;
 	}
+
+	return I2CM_STATE_WRITE;
+}
+
+/*
+ * Largest part of a message the controller transfers at once, its byte count
+ * register being 8 bits wide.
+ */
+#define I2CM_MAX_CHUNK (0xFF)
+
+static void i2c_master_reset(struct i2cm_instance *this_i2cm)
+{
+	reg_8b_modify(this_i2cm->base_address | REG_CONFIG, I2C_MASTER_RESET,
+				  I2C_MASTER_RESET);
+	reg_8b_modify(this_i2cm->base_address | REG_CONFIG, I2C_MASTER_RESET,
+				  ~I2C_MASTER_RESET);
 }
 
+static void i2c_master_int_enable(struct i2cm_instance *this_i2cm,
+								  uint16_t              interrupts_en)
+{
+	reg_8b_write(this_i2cm->base_address | REG_INT_ENABLE1, interrupts_en);
+	reg_8b_write(this_i2cm->base_address | REG_INT_ENABLE2,
+				 interrupts_en >> 8);
+}
+
+/*
+ * Loads the tx fifo with the current part of the write message in flight,
+ * until the fifo is full. The almost empty interrupt is left enabled only
+ * while bytes of the part remain to load.
+ */
+static void i2c_master_xfer_load(struct i2cm_instance *this_i2cm)
+{
+	struct i2cm_msg *msg = &this_i2cm->xfer_head->msgs[this_i2cm->msg_idx];
+	uint8_t          status = 0;
+
+	while (this_i2cm->msg_offset < this_i2cm->chunk_end) {
+		reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &status);
+		if ((status & TX_FIFO_FULL_MASK) != 0) {
+			return;
+		}
+
+		reg_8b_write(this_i2cm->base_address | REG_DATA_BUFFER,
+					 msg->buffer[this_i2cm->msg_offset]);
+		this_i2cm->msg_offset++;
+	}
+
+	i2c_master_int_enable(this_i2cm,
+						  I2C_TRANSFER_COMP_MASK | (I2C_ERR << 8));
+}
+
+/*
+ * Moves the bytes received for the current part of the read message in
+ * flight from the rx fifo.
+ */
+static void i2c_master_xfer_unload(struct i2cm_instance *this_i2cm)
+{
+	struct i2cm_msg *msg = &this_i2cm->xfer_head->msgs[this_i2cm->msg_idx];
+	uint8_t          fifo_status = 0;
+
+	while (this_i2cm->msg_offset < this_i2cm->chunk_end) {
+		reg_8b_read(this_i2cm->base_address | FIFO_STATUS_REG, &fifo_status);
+		if ((fifo_status & RX_FIFO_EMPTY_MASK) != 0) {
+			return;
+		}
+
+		reg_8b_read(this_i2cm->base_address | REG_DATA_BUFFER,
+					&msg->buffer[this_i2cm->msg_offset]);
+		this_i2cm->msg_offset++;
+	}
+}
+
+/*
+ * Starts the next part, of at most I2CM_MAX_CHUNK bytes, of the message in
+ * flight. Every part but the last one of the transaction ends without a stop,
+ * so that the next one follows after a repeated start.
+ */
+static void i2c_master_xfer_start_chunk(struct i2cm_instance *this_i2cm)
+{
+	struct i2cm_xfer *p_xfer  = this_i2cm->xfer_head;
+	struct i2cm_msg  *msg     = &p_xfer->msgs[this_i2cm->msg_idx];
+	bool              is_read = (msg->flags & I2CM_MSG_READ) != 0;
+	uint16_t          count   = msg->length - this_i2cm->msg_offset;
+	uint8_t           status  = 0;
+	uint8_t           config  = I2C_START;
+
+	if (count > I2CM_MAX_CHUNK) {
+		count = I2CM_MAX_CHUNK;
+	}
+	this_i2cm->chunk_end = this_i2cm->msg_offset + count;
+
+	if ((this_i2cm->chunk_end < msg->length) ||
+		(this_i2cm->msg_idx + 1 < p_xfer->num_msgs)) {
+		config |= I2C_MASTER_REPEATED_START;
+	}
+
+	reg_8b_write(this_i2cm->base_address | REG_BYTE_CNT, count);
+	reg_8b_write(this_i2cm->base_address | REG_SLAVE_ADDR_LOW,
+				 p_xfer->address & 0x7F);
+	if (this_i2cm->addr_mode == I2CM_ADDR_10BIT_MODE) {
+		reg_8b_write(this_i2cm->base_address | REG_SLAVE_ADDR_HIGH,
+					 (p_xfer->address >> 7) & 0x03);
+	}
+	reg_8b_modify(this_i2cm->base_address | REG_MODE, I2C_TXRX_MODE,
+				  is_read ? I2C_TXRX_MODE : 0);
+
+	// clear status bits
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &status);
+	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS1, status);
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS2, &status);
+	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS2, status);
+
+	if (is_read) {
+		this_i2cm->state = I2CM_STATE_READ;
+		i2c_master_int_enable(this_i2cm, I2C_TRANSFER_COMP_MASK |
+											 RX_FIFO_AFULL_MASK |
+											 (I2C_ERR << 8));
+	} else {
+		this_i2cm->state = I2CM_STATE_WRITE;
+		i2c_master_int_enable(this_i2cm, I2C_TRANSFER_COMP_MASK |
+											 TX_FIFO_AEMPTY_MASK |
+											 (I2C_ERR << 8));
+		i2c_master_xfer_load(this_i2cm);
+	}
+
+	reg_8b_write(this_i2cm->base_address | REG_CONFIG, config);
+}
+
+/*
+ * Completes the transaction in flight with state, starts the next queued one
+ * and then calls the completion callback, which may queue another one.
+ */
+static void i2c_master_xfer_complete(struct i2cm_instance *this_i2cm,
+									 uint8_t               state)
+{
+	struct i2cm_xfer *p_xfer = this_i2cm->xfer_head;
+
+	this_i2cm->xfer_head     = p_xfer->next;
+	this_i2cm->msg_idx       = 0;
+	this_i2cm->msg_offset    = 0;
+	this_i2cm->state         = I2CM_STATE_IDLE;
+
+	if (NULL != this_i2cm->xfer_head) {
+		i2c_master_xfer_start_chunk(this_i2cm);
+	} else {
+		this_i2cm->xfer_tail = NULL;
+		i2c_master_int_enable(this_i2cm, this_i2cm->interrupts_en);
+	}
+
+	p_xfer->next  = NULL;
+	p_xfer->state = state;
+	if (NULL != p_xfer->done) {
+		p_xfer->done(p_xfer);
+	}
+}
+
+uint8_t i2c_master_xfer_submit(struct i2cm_instance *this_i2cm,
+							   struct i2cm_xfer     *p_xfer)
+{
+	uint8_t int_en1 = 0;
+	uint8_t int_en2 = 0;
+	uint8_t idx;
+
+	if (NULL == this_i2cm || NULL == p_xfer || 0 == p_xfer->num_msgs ||
+		NULL == p_xfer->msgs) {
+		return 1;
+	}
+
+	for (idx = 0; idx < p_xfer->num_msgs; idx++) {
+		if (0 == p_xfer->msgs[idx].length ||
+			NULL == p_xfer->msgs[idx].buffer) {
+			return 1;
+		}
+	}
+
+	// keep the isr off the queue meanwhile
+	reg_8b_read(this_i2cm->base_address | REG_INT_ENABLE1, &int_en1);
+	reg_8b_read(this_i2cm->base_address | REG_INT_ENABLE2, &int_en2);
+	i2c_master_int_enable(this_i2cm, 0);
+
+	if (NULL != this_i2cm->xfer_tail) {
+		p_xfer->state               = I2CM_STATE_QUEUED;
+		p_xfer->next                = NULL;
+		this_i2cm->xfer_tail->next  = p_xfer;
+		this_i2cm->xfer_tail        = p_xfer;
+	} else if (this_i2cm->state == I2CM_STATE_IDLE) {
+		p_xfer->state               = I2CM_STATE_QUEUED;
+		p_xfer->next                = NULL;
+		this_i2cm->xfer_head        = p_xfer;
+		this_i2cm->xfer_tail        = p_xfer;
+		this_i2cm->msg_idx          = 0;
+		this_i2cm->msg_offset       = 0;
+		i2c_master_xfer_start_chunk(this_i2cm);
+		return 0;
+	} else {
+		// a blocking operation is in progress
+		i2c_master_int_enable(this_i2cm, int_en1 | (int_en2 << 8));
+		return 1;
+	}
+
+	i2c_master_int_enable(this_i2cm, int_en1 | (int_en2 << 8));
+	return 0;
+}
+
+void i2c_master_isr(void *ctx)
+{
+	struct i2cm_instance *this_i2cm = (struct i2cm_instance *)ctx;
+	struct i2cm_msg      *msg;
+	uint8_t               i2c_int1 = 0;
+	uint8_t               i2c_int2 = 0;
+
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS1, &i2c_int1);
+	reg_8b_read(this_i2cm->base_address | REG_INT_STATUS2, &i2c_int2);
+
+	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS1, i2c_int1);
+	reg_8b_write(this_i2cm->base_address | REG_INT_STATUS2, i2c_int2);
+
+	if (NULL == this_i2cm->xfer_head) {
+		return;
+	}
+
+	if (i2c_int2 & I2C_ERR) {
+		i2c_master_reset(this_i2cm);
+		i2c_master_xfer_complete(this_i2cm, I2CM_STATE_ERROR);
+		return;
+	}
+
+	msg = &this_i2cm->xfer_head->msgs[this_i2cm->msg_idx];
+	if ((msg->flags & I2CM_MSG_READ) != 0) {
+		i2c_master_xfer_unload(this_i2cm);
+	} else {
+		i2c_master_xfer_load(this_i2cm);
+	}
+
+	if ((i2c_int1 & I2C_TRANSFER_COMP_MASK) == 0) {
+		return;
+	}
+
+	// a short read leaves bytes missing, reported as an error
+	if (this_i2cm->msg_offset < this_i2cm->chunk_end) {
+		i2c_master_reset(this_i2cm);
+		i2c_master_xfer_complete(this_i2cm, I2CM_STATE_ERROR);
+		return;
+	}
+
+	if (this_i2cm->msg_offset == msg->length) {
+		this_i2cm->msg_idx++;
+		this_i2cm->msg_offset = 0;
+		if (this_i2cm->msg_idx == this_i2cm->xfer_head->num_msgs) {
+			i2c_master_xfer_complete(this_i2cm, I2CM_STATE_IDLE);
+			return;
+		}
+	}
+
+	i2c_master_xfer_start_chunk(this_i2cm);
+}
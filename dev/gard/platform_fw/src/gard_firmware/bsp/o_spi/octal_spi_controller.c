@@ -1331,41 +1331,29 @@ unsigned char flash_erase(spix8_ctl_handle_t *handle, unsigned int reg_addr,
 }
 
 /**
- * @brief 	Private/Internal function to perform the read action.
+ * @brief 	Private/Internal function to queue the packets of a read command.
  *
- * This API is used to perform the read action in SPI flash.
+ * This API is used to push the command, address, dummy and read data packets
+ * of a flash read into the Tx FIFO. The transaction is not started.
  *
  * @param 	handle	         Handle of the spix8_ctl_handle_t structure
- * @param 	num_bytes	     Number of data (per 4 bytes) to read
- * @param 	*dat_buf	     Pointer to store the read back data
+ * @param 	byte_len	     Number of data bytes of the read data packet
  * @param 	start_addr	     Start address of data to read
- * @param 	pkt_fmt	         Packet format (for example, supported/generic command)
- * @param 	read_type	     Read type (for example, fast read and octal io fast read)
  * @param 	use_data_stb	 Data strobe enable
- * @return 	                 Returns 'SUCCESS' (0) on success,
- * 					         or 'FAILURE' (1) if input pointer is NULL.
+ * @return 	                 None
  */
-unsigned char flash_read(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf,
-					     unsigned int start_addr, unsigned int pkt_fmt, unsigned int use_data_stb)
+static void flash_read_queue_cmd(spix8_ctl_handle_t *handle, unsigned int byte_len,
+								 unsigned int start_addr, unsigned int use_data_stb)
 {
-	unsigned char status = SUCCESS;
 	unsigned int wdat = 0;
 	unsigned int adr_byte_swap = 0;
-	unsigned int byte_len = 0;
-	unsigned int dword_len = 0;
 	unsigned int adr_4bytes = 0;
 
-	if (!handle || handle->base_addr == ZERO)
-		return FAILURE;
-
 	spix8_ctl_reg_t *spix8_ctl = (spix8_ctl_reg_t *)(handle->base_addr);
 
 	if (handle->flash_addr_mode == FLASH_ADDR_MODE_32B)
 		adr_4bytes = 1;
 
-	byte_len  = (octal_spi_op_st.data_io_rate)? (num_bytes & 0x1FF) + ((num_bytes & 0x1) << 1): num_bytes;
-	dword_len = (byte_len >> 2) + ((byte_len & 0x3)?  1 : 0);
-
 	/* In Octal DDR, address must be even */
 	adr_byte_swap = (octal_spi_op_st.adr_io_rate)? start_addr & 0xFFFFFFFE : start_addr;
 	adr_byte_swap = (adr_4bytes)? DAT32B_SWAP_BYTES(start_addr) :
@@ -1420,6 +1408,39 @@ unsigned char flash_read(spix8_ctl_handle_t *handle, unsigned int num_bytes, uns
 			PUT_FIELD_VAL(byte_len, PKTHDR_XFERLEN_WID, PKTHDR_XFERLEN_IDX);
 
 	spix8_ctl->SPIX8_REG_TX_FIFO    = wdat;
+}
+
+/**
+ * @brief 	Private/Internal function to perform the read action.
+ *
+ * This API is used to perform the read action in SPI flash.
+ *
+ * @param 	handle	         Handle of the spix8_ctl_handle_t structure
+ * @param 	num_bytes	     Number of data (per 4 bytes) to read
+ * @param 	*dat_buf	     Pointer to store the read back data
+ * @param 	start_addr	     Start address of data to read
+ * @param 	pkt_fmt	         Packet format (for example, supported/generic command)
+ * @param 	read_type	     Read type (for example, fast read and octal io fast read)
+ * @param 	use_data_stb	 Data strobe enable
+ * @return 	                 Returns 'SUCCESS' (0) on success,
+ * 					         or 'FAILURE' (1) if input pointer is NULL.
+ */
+unsigned char flash_read(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf,
+					     unsigned int start_addr, unsigned int pkt_fmt, unsigned int use_data_stb)
+{
+	unsigned char status = SUCCESS;
+	unsigned int byte_len = 0;
+	unsigned int dword_len = 0;
+
+	if (!handle || handle->base_addr == ZERO)
+		return FAILURE;
+
+	spix8_ctl_reg_t *spix8_ctl = (spix8_ctl_reg_t *)(handle->base_addr);
+
+	byte_len  = (octal_spi_op_st.data_io_rate)? (num_bytes & 0x1FF) + ((num_bytes & 0x1) << 1): num_bytes;
+	dword_len = (byte_len >> 2) + ((byte_len & 0x3)?  1 : 0);
+
+	flash_read_queue_cmd(handle, byte_len, start_addr, use_data_stb);
 
 	/* start the transaction */
 	spix8_ctl->SPIX8_REG_START_XFER = 1;
@@ -1433,6 +1454,61 @@ unsigned char flash_read(spix8_ctl_handle_t *handle, unsigned int num_bytes, uns
 	return status;
 }
 
+/**
+ * @brief 	Function to read a large block of data in a single read command.
+ *
+ * This API is used to read up to FLASH_READ_BURST_MAX_SIZE bytes from SPI
+ * flash with one read command. Unlike flash_read(), which waits for the end
+ * of the transaction before emptying the Rx FIFO and so can only read as much
+ * as the Rx FIFO holds, the Rx FIFO is emptied while the data comes in. This
+ * relies on the blocking Rx FIFO reads (non_block_rxfifo = 0), a read of the
+ * empty FIFO waits for the next word.
+ *
+ * Only STR data transfers are supported, the data length of DTR packets is
+ * limited. The data is written in 4 bytes words, dat_buf must be word aligned
+ * and num_bytes a multiple of 4.
+ *
+ * @param 	handle	         Handle of the spix8_ctl_handle_t structure
+ * @param 	num_bytes	     Number of bytes to read, multiple of 4
+ * @param 	*dat_buf	     Pointer to store the read back data
+ * @param 	start_addr	     Start address of data to read
+ * @param 	use_data_stb	 Data strobe enable
+ * @return 	                 Returns 'SUCCESS' (1) on success,
+ * 					         or 'FAILURE' (0) on invalid parameters.
+ */
+unsigned char flash_read_burst(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf,
+							   unsigned int start_addr, unsigned int use_data_stb)
+{
+	unsigned int cnt;
+	unsigned int dword_len;
+
+	if (!handle || handle->base_addr == ZERO || handle->non_block_rxfifo ||
+		octal_spi_op_st.data_io_rate || (num_bytes == 0) ||
+		(num_bytes > FLASH_READ_BURST_MAX_SIZE) || (num_bytes & 0x3) ||
+		((uintptr_t)dat_buf & 0x3))
+		return FAILURE;
+
+	spix8_ctl_reg_t *spix8_ctl = (spix8_ctl_reg_t *)(handle->base_addr);
+
+	dword_len = num_bytes >> 2;
+
+	flash_read_queue_cmd(handle, num_bytes, start_addr, use_data_stb);
+
+	/* start the transaction */
+	spix8_ctl->SPIX8_REG_START_XFER = 1;
+
+	/* empty the Rx FIFO as the data comes in */
+	for(cnt = 0; cnt < dword_len; cnt++)
+	{
+		dat_buf[cnt] = spix8_ctl->SPIX8_REG_RX_FIFO;
+	}
+
+	/* wait to complete */
+	wait_spi_ctl_busy_status(handle,0,1);
+
+	return SUCCESS;
+}
+
 /**
  * @brief 	Private/Internal function to perform the program action.
  *
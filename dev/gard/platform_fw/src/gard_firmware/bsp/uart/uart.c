@@ -428,3 +428,70 @@ uint8_t uart_set_rate(struct uart_instance *this_uart, uint32_t baudrate)
 
 	return 0;
 }
+
+/*
+ ***************************************************************
+ * Enables or disables the RX data ready interrupt, for an ISR of
+ * the caller's own when the UART ISR above is compiled out.
+ * Reading the RX FIFO empty clears the interrupt.
+ ***************************************************************
+ */
+void uart_rx_int_enable(struct uart_instance *this_uart, bool enable)
+{
+	volatile struct uart_dev *dev;
+	if (NULL == this_uart) {
+		return;
+	}
+	dev = (volatile struct uart_dev *)(this_uart->base);
+
+	if (enable) {
+		this_uart->ier |= UART_IER_RX_INT_MASK;
+	} else {
+		this_uart->ier &= (~UART_IER_RX_INT_MASK);
+	}
+	dev->ier = this_uart->ier;
+}
+
+/*
+ ***************************************************************
+ * Enables or disables the TX holding register empty interrupt,
+ * for an ISR of the caller's own which refills the TX FIFO with
+ * uart_putchars(). Writing the TX FIFO clears the interrupt; it
+ * is raised again once the FIFO has drained, so it is to be
+ * disabled when there is nothing left to send.
+ ***************************************************************
+ */
+void uart_tx_int_enable(struct uart_instance *this_uart, bool enable)
+{
+	volatile struct uart_dev *dev;
+	if (NULL == this_uart) {
+		return;
+	}
+	dev = (volatile struct uart_dev *)(this_uart->base);
+
+	if (enable) {
+		this_uart->ier |= UART_IER_TX_INT_MASK;
+	} else {
+		this_uart->ier &= (~UART_IER_TX_INT_MASK);
+	}
+	dev->ier = this_uart->ier;
+}
+
+/*
+ ***************************************************************
+ * Returns true once the TX FIFO and the shift register are empty,
+ * i.e. the last byte handed to the UART is fully out on the line.
+ * Used before changing the line parameters so that a pending
+ * response is not corrupted.
+ ***************************************************************
+ */
+bool uart_is_tx_idle(struct uart_instance *this_uart)
+{
+	volatile struct uart_dev *dev;
+	if (NULL == this_uart) {
+		return true;
+	}
+	dev = (volatile struct uart_dev *)(this_uart->base);
+
+	return ((dev->lsr & UART_LSR_TX_FIFO_EMPTY) != 0);
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+/**
+ * This file contains the routines which pick the firmware slot to boot and
+ * keep its boot control record, shared by the firmware loader and the
+ * firmware. See fw_boot.h.
+ */
+
+#include <stddef.h>
+
+#include "gard_types.h"
+#include "assert.h"
+#include "ospi_support.h"
+#include "utils.h"
+#include "fw_boot.h"
+
+/**
+ * Count of copies of the boot control record, one per flash sector, just
+ * below the RFS configuration of slot A.
+ */
+#define FW_BOOT_CTRL_COPIES (2U)
+
+#define FW_BOOT_CTRL_ADDR(copy)                                                \
+	(RFS_CONFIG_START_ADDR -                                                   \
+	 ((FW_BOOT_CTRL_COPIES - (copy)) * OSPI_FLASH_SECTOR_SIZE))
+
+GARD__CASSERT(0U == (sizeof(struct fw_boot_ctrl) % sizeof(uint32_t)),
+			  "The boot control record is programmed in words.");
+GARD__CASSERT(FW_BOOT_MAX_ATTEMPTS < 32U,
+			  "The boot attempts are counted in a word.");
+
+/**
+ * fw_boot_wait_flash() waits for the flash to be done with an erase or a
+ * program.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return None
+ */
+static void fw_boot_wait_flash(void *ospi_handle)
+{
+	while (ospi_is_flash_busy(ospi_handle)) {
+	}
+}
+
+/**
+ * fw_boot_clear_bits() programs a word of the current boot control record.
+ * Only the bits cleared in value change, the flash cannot set bits back
+ * without an erase.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param copy is the copy of the record to program.
+ * @param offset is the offset of the word in struct fw_boot_ctrl.
+ * @param value is the new value of the word.
+ *
+ * @return true if the word is programmed, false otherwise.
+ */
+static bool fw_boot_clear_bits(void    *ospi_handle,
+							   uint32_t copy,
+							   uint32_t offset,
+							   uint32_t value)
+{
+	bool status;
+
+	status = ospi_program_page_async(ospi_handle, &value,
+									 FW_BOOT_CTRL_ADDR(copy) + offset,
+									 sizeof(value));
+	fw_boot_wait_flash(ospi_handle);
+
+	return status;
+}
+
+/**
+ * fw_boot_read_ctrl() reads the current boot control record, the valid copy
+ * with the higher sequence.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param ctrl is filled with the record.
+ * @param copy is filled with the copy the record was read from.
+ *
+ * @return true if a valid record is found, false if none was ever written.
+ */
+static bool fw_boot_read_ctrl(void                *ospi_handle,
+							  struct fw_boot_ctrl *ctrl,
+							  uint32_t            *copy)
+{
+	struct fw_boot_ctrl candidate;
+	bool                found = false;
+	uint32_t            idx;
+
+	for (idx = 0; idx < FW_BOOT_CTRL_COPIES; idx++) {
+		if (ospi_read_from_flash(ospi_handle, (uint8_t *)&candidate,
+								 FW_BOOT_CTRL_ADDR(idx), sizeof(candidate)) !=
+			sizeof(candidate)) {
+			continue;
+		}
+
+		if ((FW_BOOT_CTRL_SIGNATURE != candidate.signature) ||
+			(candidate.active_slot >= FW_BOOT_NUM_SLOTS)) {
+			continue;
+		}
+
+		if (!found || (candidate.sequence > ctrl->sequence)) {
+			*ctrl = candidate;
+			*copy = idx;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+/**
+ * fw_boot_attempts_used() counts the unconfirmed boots of the active slot, the
+ * bits cleared in fw_boot_ctrl.attempts.
+ */
+static uint32_t fw_boot_attempts_used(uint32_t attempts)
+{
+	uint32_t used = 0;
+
+	while (0U == (attempts & 0x1U) && used < 32U) {
+		attempts >>= 1;
+		used++;
+	}
+
+	return used;
+}
+
+/**
+ * fw_boot_select_slot() picks the slot the firmware loader boots. A flash
+ * without a boot control record boots slot A, as before the slots. An
+ * unconfirmed active slot is booted up to FW_BOOT_MAX_ATTEMPTS times, each
+ * boot being counted before the firmware runs, then the other slot is booted.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return The slot to boot.
+ */
+uint32_t fw_boot_select_slot(void *ospi_handle)
+{
+	struct fw_boot_ctrl ctrl;
+	uint32_t            copy;
+	uint32_t            used;
+
+	if (!fw_boot_read_ctrl(ospi_handle, &ctrl, &copy)) {
+		return FW_BOOT_SLOT_A;
+	}
+
+	if (0U == ctrl.confirmed) {
+		return ctrl.active_slot;
+	}
+
+	if (0U == ctrl.fell_back) {
+		return ctrl.active_slot ^ 1U;
+	}
+
+	used = fw_boot_attempts_used(ctrl.attempts);
+	if (used >= FW_BOOT_MAX_ATTEMPTS) {
+		/* The new firmware never confirmed, go back to the previous one. */
+		(void)fw_boot_clear_bits(ospi_handle, copy,
+								 offsetof(struct fw_boot_ctrl, fell_back), 0U);
+		return ctrl.active_slot ^ 1U;
+	}
+
+	/* Count this boot before the firmware gets a chance to hang. */
+	(void)fw_boot_clear_bits(ospi_handle, copy,
+							 offsetof(struct fw_boot_ctrl, attempts),
+							 ctrl.attempts << 1);
+
+	return ctrl.active_slot;
+}
+
+/**
+ * fw_boot_running_slot() tells the slot the firmware loader booted, by the
+ * same rules as fw_boot_select_slot() once the boot is counted.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return The slot the running firmware was booted from.
+ */
+uint32_t fw_boot_running_slot(void *ospi_handle)
+{
+	struct fw_boot_ctrl ctrl;
+	uint32_t            copy;
+
+	if (!fw_boot_read_ctrl(ospi_handle, &ctrl, &copy)) {
+		return FW_BOOT_SLOT_A;
+	}
+
+	if ((0U != ctrl.confirmed) && (0U == ctrl.fell_back)) {
+		return ctrl.active_slot ^ 1U;
+	}
+
+	return ctrl.active_slot;
+}
+
+/**
+ * fw_boot_confirm() marks the active slot as good. Nothing is to be done if it
+ * is confirmed already, if there is no record, or if the loader fell back to
+ * the other slot, which was confirmed when it was active.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return true if the running slot is confirmed, false otherwise.
+ */
+bool fw_boot_confirm(void *ospi_handle)
+{
+	struct fw_boot_ctrl ctrl;
+	uint32_t            copy;
+
+	if (!fw_boot_read_ctrl(ospi_handle, &ctrl, &copy) ||
+		(0U == ctrl.confirmed) || (0U == ctrl.fell_back)) {
+		return true;
+	}
+
+	return fw_boot_clear_bits(ospi_handle, copy,
+							  offsetof(struct fw_boot_ctrl, confirmed), 0U);
+}
+
+/**
+ * fw_boot_activate_slot() writes a new boot control record, slot being active
+ * and not confirmed, to the copy not holding the current record. The current
+ * record is left as is, so that it still holds if power is lost before the new
+ * one is written.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param slot is the slot to boot next.
+ *
+ * @return true if the record is written, false otherwise.
+ */
+bool fw_boot_activate_slot(void *ospi_handle, uint32_t slot)
+{
+	uint32_t            words[sizeof(struct fw_boot_ctrl) / sizeof(uint32_t)];
+	struct fw_boot_ctrl ctrl;
+	uint32_t            copy;
+
+	GARD__DBG_ASSERT(slot < FW_BOOT_NUM_SLOTS,
+					 "Invalid slot provided to fw_boot_activate_slot");
+
+	if (fw_boot_read_ctrl(ospi_handle, &ctrl, &copy)) {
+		copy          = (copy + 1U) % FW_BOOT_CTRL_COPIES;
+		ctrl.sequence = ctrl.sequence + 1U;
+	} else {
+		copy          = 0;
+		ctrl.sequence = 1U;
+	}
+
+	ctrl.signature   = FW_BOOT_CTRL_SIGNATURE;
+	ctrl.active_slot = slot;
+	ctrl.attempts    = 0xFFFFFFFFU;
+	ctrl.confirmed   = 0xFFFFFFFFU;
+	ctrl.fell_back   = 0xFFFFFFFFU;
+	memcpy(words, &ctrl, sizeof(words));
+
+	if (!ospi_erase_sector_async(ospi_handle, FW_BOOT_CTRL_ADDR(copy))) {
+		return false;
+	}
+	fw_boot_wait_flash(ospi_handle);
+
+	if (!ospi_program_page_async(ospi_handle, words, FW_BOOT_CTRL_ADDR(copy),
+								 sizeof(words))) {
+		return false;
+	}
+	fw_boot_wait_flash(ospi_handle);
+
+	return true;
+}
@@ -10,11 +10,28 @@
 #include "sys_platform.h"
 #include "gpio.h"
 #include "gpio_support.h"
+#include "gpio_mapper.h"
+#include "trace_pins.h"
 
 /* GPIO instances */
 struct gpio_instance gpio_0;
 struct gpio_instance gpio_3;
 
+/**
+ * A trace pin is to be a spare pin of GPIO 0, i.e. not one of gpio_mapper.h,
+ * or TRACE_PIN_NONE.
+ */
+#define IS_SPARE_TRACE_PIN(pin)                                   \
+	((TRACE_PIN_NONE == (pin)) ||                                 \
+	 (((pin) < GPIO0_INST_LINES_NUM) &&                           \
+	  ((pin) != GPIO_PIN_TO_CAMERA_POWER)))
+
+GARD__CASSERT(IS_SPARE_TRACE_PIN(TRACE_PIN_CAPTURE) &&
+				  IS_SPARE_TRACE_PIN(TRACE_PIN_RESCALE) &&
+				  IS_SPARE_TRACE_PIN(TRACE_PIN_ML_COPY) &&
+				  IS_SPARE_TRACE_PIN(TRACE_PIN_ML_RUN),
+			  "Trace pins must be spare pins of GPIO 0");
+
 /**
  * gpio_init() initializes all the GPIO instances used by the firmware.
  *
@@ -31,6 +48,26 @@ void gpio_init()
 	/* Configure GPIO 0 pin 0 as output to control camera power. */
 	gpio_pin_set_dir(&gpio_0, GPIO_PIN_0, GPIO_OUTPUT);
 
+#ifdef GARD_TRACE_PINS
+	/* The trace pins start low, as no stage has started. */
+	if (TRACE_PIN_NONE != TRACE_PIN_CAPTURE) {
+		gpio_pin_set_dir(&gpio_0, TRACE_PIN_CAPTURE, GPIO_OUTPUT);
+	}
+	if (TRACE_PIN_NONE != TRACE_PIN_RESCALE) {
+		gpio_pin_set_dir(&gpio_0, TRACE_PIN_RESCALE, GPIO_OUTPUT);
+	}
+	if (TRACE_PIN_NONE != TRACE_PIN_ML_COPY) {
+		gpio_pin_set_dir(&gpio_0, TRACE_PIN_ML_COPY, GPIO_OUTPUT);
+	}
+	if (TRACE_PIN_NONE != TRACE_PIN_ML_RUN) {
+		gpio_pin_set_dir(&gpio_0, TRACE_PIN_ML_RUN, GPIO_OUTPUT);
+	}
+	TRACE_END(CAPTURE);
+	TRACE_END(RESCALE);
+	TRACE_END(ML_COPY);
+	TRACE_END(ML_RUN);
+#endif
+
 	/* Initialize GPIO 3 instance. */
 	gpio_pins_init(&gpio_3, GPIO3_INST_GPIO_MEM_MAP_BASE_ADDR,
 				   GPIO3_INST_LINES_NUM, GPIO3_INST_GPIO_DIRS);
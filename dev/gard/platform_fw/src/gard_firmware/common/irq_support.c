@@ -0,0 +1,260 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "utils.h"
+#include "sys_platform.h"
+#include "irq_support.h"
+
+/**
+ * Register map of the PLIC, for the single (machine mode) context of hart 0.
+ */
+#define PLIC_PRIORITY(irq)  (RISCV_RX0_INST_PLIC_BASE_ADDR + 4U * (irq))
+#define PLIC_ENABLE         (RISCV_RX0_INST_PLIC_BASE_ADDR + 0x2000U)
+#define PLIC_THRESHOLD      (RISCV_RX0_INST_PLIC_BASE_ADDR + 0x200000U)
+#define PLIC_CLAIM_COMPLETE (RISCV_RX0_INST_PLIC_BASE_ADDR + 0x200004U)
+
+#define PLIC_REG(addr)      (*(volatile uint32_t *)(addr))
+
+/* Timer compare of hart 0 in the CLINT */
+#define CLINT_MTIMECMP_LO   (RISCV_RX0_INST_CLINT_BASE_ADDR + 0x4000U)
+#define CLINT_MTIMECMP_HI   (RISCV_RX0_INST_CLINT_BASE_ADDR + 0x4004U)
+
+/* mcause of a machine external / timer interrupt */
+#define MCAUSE_INTERRUPT    (1U << 31)
+#define MCAUSE_MEI          (11U)
+#define MCAUSE_MTI          (7U)
+
+/* mie / mstatus bits */
+#define MIE_MEIE_BIT        (1U << 11)
+#define MIE_MTIE_BIT        (1U << 7)
+#define MSTATUS_MIE_BIT     (1U << 3)
+
+static struct {
+	irq_isr_t isr;
+	void     *ctx;
+} isr_table[IRQ_MAX_SOURCES];
+
+/* Bumped on every interrupt handled, see irq_event_count() */
+static volatile uint32_t irq_events;
+
+/**
+ * Trap entry, set as mtvec in direct mode. Only the caller-saved registers are
+ * saved as irq_trap_handler() keeps the others as per the calling convention.
+ */
+__asm__("	.section .text_hot\n"
+		"	.align 2\n"
+		"	.global irq_trap_entry\n"
+		"irq_trap_entry:\n"
+		"	addi sp, sp, -64\n"
+		"	sw   ra,  0(sp)\n"
+		"	sw   t0,  4(sp)\n"
+		"	sw   t1,  8(sp)\n"
+		"	sw   t2, 12(sp)\n"
+		"	sw   a0, 16(sp)\n"
+		"	sw   a1, 20(sp)\n"
+		"	sw   a2, 24(sp)\n"
+		"	sw   a3, 28(sp)\n"
+		"	sw   a4, 32(sp)\n"
+		"	sw   a5, 36(sp)\n"
+		"	sw   a6, 40(sp)\n"
+		"	sw   a7, 44(sp)\n"
+		"	sw   t3, 48(sp)\n"
+		"	sw   t4, 52(sp)\n"
+		"	sw   t5, 56(sp)\n"
+		"	sw   t6, 60(sp)\n"
+		"	csrr a0, mcause\n"
+		"	csrr a1, mepc\n"
+		"	call irq_trap_handler\n"
+		"	lw   ra,  0(sp)\n"
+		"	lw   t0,  4(sp)\n"
+		"	lw   t1,  8(sp)\n"
+		"	lw   t2, 12(sp)\n"
+		"	lw   a0, 16(sp)\n"
+		"	lw   a1, 20(sp)\n"
+		"	lw   a2, 24(sp)\n"
+		"	lw   a3, 28(sp)\n"
+		"	lw   a4, 32(sp)\n"
+		"	lw   a5, 36(sp)\n"
+		"	lw   a6, 40(sp)\n"
+		"	lw   a7, 44(sp)\n"
+		"	lw   t3, 48(sp)\n"
+		"	lw   t4, 52(sp)\n"
+		"	lw   t5, 56(sp)\n"
+		"	lw   t6, 60(sp)\n"
+		"	addi sp, sp, 64\n"
+		"	mret\n");
+
+extern void irq_trap_entry(void);
+
+/* Only called from irq_trap_entry, kept for it with link time optimisation */
+GARD__HOT __attribute__((used)) void irq_trap_handler(uint32_t mcause,
+													  uint32_t mepc);
+
+/**
+ * irq_trap_handler is called from irq_trap_entry for every trap. External
+ * interrupts are claimed from the PLIC and handed to their ISR until none is
+ * pending; anything else is a fatal exception.
+ *
+ * @param mcause: Cause of the trap.
+ * @param mepc: Address of the instruction the trap came on.
+ *
+ * @return None
+ */
+void irq_trap_handler(uint32_t mcause, uint32_t mepc)
+{
+	uint32_t irq;
+
+	if (mcause == (MCAUSE_INTERRUPT | MCAUSE_MTI)) {
+		// One shot, irq_wake_at() arms it again.
+		__asm__ volatile("csrc mie, %0" : : "r"(MIE_MTIE_BIT));
+		irq_events = irq_events + 1U;
+		return;
+	}
+
+	if (mcause != (MCAUSE_INTERRUPT | MCAUSE_MEI)) {
+		GARD__DBG_ASSERT(false, "Unhandled trap, mcause: 0x%x, mepc: 0x%x",
+						 mcause, mepc);
+		while (true) {
+		}
+	}
+
+	while ((irq = PLIC_REG(PLIC_CLAIM_COMPLETE)) != 0U) {
+		if ((irq < IRQ_MAX_SOURCES) && (NULL != isr_table[irq].isr)) {
+			isr_table[irq].isr(isr_table[irq].ctx);
+		} else if (irq < 32U) {
+			// Nobody to clear it at the source, keep it from coming back.
+			irq_source_disable(irq);
+		}
+
+		PLIC_REG(PLIC_CLAIM_COMPLETE) = irq;
+	}
+
+	irq_events = irq_events + 1U;
+}
+
+/**
+ * irq_support_init installs the trap handler, masks all interrupt sources and
+ * enables the external interrupts of the CPU. It is to be called once, before
+ * any ISR is registered.
+ *
+ * @param None
+ *
+ * @return None
+ */
+GARD__COLD void irq_support_init(void)
+{
+	uint32_t irq;
+
+	PLIC_REG(PLIC_ENABLE)    = 0U;
+	PLIC_REG(PLIC_THRESHOLD) = 0U;
+	for (irq = 0; irq < IRQ_MAX_SOURCES; irq++) {
+		isr_table[irq].isr = NULL;
+		isr_table[irq].ctx = NULL;
+	}
+
+	__asm__ volatile("csrw mtvec, %0" : : "r"(irq_trap_entry));
+	__asm__ volatile("csrs mie, %0" : : "r"(MIE_MEIE_BIT));
+	__asm__ volatile("csrs mstatus, %0" : : "r"(MSTATUS_MIE_BIT) : "memory");
+}
+
+/**
+ * irq_register_isr registers the ISR of an interrupt source and enables the
+ * source. The ISR has to clear the interrupt at the peripheral.
+ *
+ * @param irq: Interrupt source, see the *_INST_IRQ defines.
+ * @param isr: ISR to be called when the source is pending.
+ * @param ctx: Context passed to the ISR.
+ *
+ * @return true if the ISR is registered, false if irq is out of range.
+ */
+bool irq_register_isr(uint32_t irq, irq_isr_t isr, void *ctx)
+{
+	uint32_t irq_state;
+
+	if ((0U == irq) || (irq >= IRQ_MAX_SOURCES) || (NULL == isr)) {
+		return false;
+	}
+
+	irq_state          = irq_save();
+	isr_table[irq].isr = isr;
+	isr_table[irq].ctx = ctx;
+	irq_restore(irq_state);
+
+	PLIC_REG(PLIC_PRIORITY(irq)) = 1U;
+	irq_source_enable(irq);
+
+	return true;
+}
+
+/**
+ * irq_source_enable unmasks an interrupt source.
+ *
+ * @param irq: Interrupt source, see the *_INST_IRQ defines.
+ *
+ * @return None
+ */
+void irq_source_enable(uint32_t irq)
+{
+	uint32_t irq_state = irq_save();
+
+	PLIC_REG(PLIC_ENABLE) |= (1U << irq);
+	irq_restore(irq_state);
+}
+
+/**
+ * irq_source_disable masks an interrupt source. Also safe to call from an
+ * ISR.
+ *
+ * @param irq: Interrupt source, see the *_INST_IRQ defines.
+ *
+ * @return None
+ */
+void irq_source_disable(uint32_t irq)
+{
+	uint32_t irq_state = irq_save();
+
+	PLIC_REG(PLIC_ENABLE) &= ~(1U << irq);
+	irq_restore(irq_state);
+}
+
+/**
+ * irq_event_count returns a count bumped every time interrupts are handled.
+ * The main loop compares it before and after a round of its tasks, with the
+ * interrupts disabled, to know that no ISR left work for it meanwhile.
+ *
+ * @param None
+ *
+ * @return The count of interrupts handled, wrapping around.
+ */
+uint32_t irq_event_count(void)
+{
+	return irq_events;
+}
+
+/**
+ * irq_wake_at arms the timer interrupt of the CLINT for the given time, so
+ * that irq_wait_for_interrupt() returns by then. It fires once; a later call
+ * replaces the time armed before.
+ *
+ * @param tsc: Time to wake at, in CPU TSC units, see get_cpu_tsc().
+ *
+ * @return None
+ */
+void irq_wake_at(uint64_t tsc)
+{
+	uint32_t irq_state = irq_save();
+
+	/* No spurious match while the two halves are written */
+	PLIC_REG(CLINT_MTIMECMP_HI) = 0xFFFFFFFFU;
+	PLIC_REG(CLINT_MTIMECMP_LO) = (uint32_t)tsc;
+	PLIC_REG(CLINT_MTIMECMP_HI) = (uint32_t)(tsc >> 32);
+
+	__asm__ volatile("csrs mie, %0" : : "r"(MIE_MTIE_BIT));
+	irq_restore(irq_state);
+}
@@ -7,6 +7,7 @@
 
 #include "gard_types.h"
 #include "assert.h"
+#include "utils.h"
 #include "ospi_support.h"
 #include "octal_spi_controller.h"
 
@@ -36,13 +37,21 @@ static void        spix8_param_init(void)
 	p_octal_spi_c0->lsb_first         = 0;
 	p_octal_spi_c0->spi_mode          = 0; /*{cpol,cpha}*/
 	p_octal_spi_c0->endianness        = 0;
+#ifdef OSPI_FLASH_MAP_BASE_ADDR
+	p_octal_spi_c0->en_tgtaddr_map    = 1;
+#else
 	p_octal_spi_c0->en_tgtaddr_map    = 0;
+#endif
 	p_octal_spi_c0->use_ds_in_ddr     = 1;
 	p_octal_spi_c0->non_block_txfifo  = 0;
 	p_octal_spi_c0->non_block_rxfifo  = 0;
 
 	p_octal_spi_c0->spi_dat_rate      = SPIX8_STR;
+#ifdef OSPI_FLASH_MAP_BASE_ADDR
+	p_octal_spi_c0->axi4_tgt_baddr    = OSPI_FLASH_MAP_BASE_ADDR;
+#else
 	p_octal_spi_c0->axi4_tgt_baddr    = 0x40006000U;
+#endif
 	p_octal_spi_c0->flash_addr_offset = 0x00U;
 
 	p_octal_spi_c0->interrupt_enable  = SPIX8_INT_BUS_ACCESS_ERROR |
@@ -89,15 +98,188 @@ void *ospi_init(void)
 		FLASH_CMD_FAST_READ, SPIX8_IO_X1, SPIX8_IO_X1, SPIX8_IO_X1, 0, 0, 0, 8};
 	set_op_param(&op_param);
 
+#ifdef OSPI_FLASH_MAP_BASE_ADDR
+	/**
+	 * Reads of the flash window on AXI are served by the controller with the
+	 * supported fast read command, the flash is not put in XIP (continuous
+	 * read) mode so that the generic commands keep working.
+	 *
+	 * TBD-SRP: Validate the window on hardware, no platform maps it yet.
+	 */
+	((spix8_ctl_reg_t *)octal_spi_c0.base_addr)->SPIX8_REG_TGT_AXI4BASE =
+		OSPI_FLASH_MAP_BASE_ADDR;
+	if (!config_supported_flash_cmd(&octal_spi_c0, FLASH_PAGE_PROG,
+									FLASH_FAST_READ, FLASH_XIP_MODE_OFF)) {
+		return NULL;
+	}
+#endif
+
 	return &octal_spi_c0;
 }
 
+/**
+ * ospi_map_flash returns the address at which the CPU can read num_bytes of
+ * the flash starting from flash_addr directly, through the flash window the
+ * OSPI controller maps on AXI. Nothing is copied, the flash is read as the
+ * data is accessed.
+ *
+ * The window is only there on platforms defining OSPI_FLASH_MAP_BASE_ADDR,
+ * callers have to fall back to ospi_read_from_flash() without it.
+ *
+ * @param handle is the OSPI controller handle.
+ * @param flash_addr is the starting address in the flash memory to map.
+ * @param num_bytes is the number of bytes to map.
+ *
+ * @return Returns the address of the data in the window, NULL if there is no
+ *         window or the data is not within it.
+ */
+const void *ospi_map_flash(void    *handle,
+						   uint32_t flash_addr,
+						   uint32_t num_bytes)
+{
+#ifdef OSPI_FLASH_MAP_BASE_ADDR
+	spix8_ctl_handle_t *p_handle = handle;
+
+	GARD__DBG_ASSERT(p_handle != NULL && num_bytes > 0,
+					 "Invalid parameters provided to ospi_map_flash");
+
+	if ((flash_addr < p_handle->flash_addr_offset) ||
+		(flash_addr - p_handle->flash_addr_offset >
+		 p_handle->tot_tgtaddr_size) ||
+		(num_bytes > p_handle->tot_tgtaddr_size -
+						 (flash_addr - p_handle->flash_addr_offset))) {
+		return NULL;
+	}
+
+	return (const void *)(OSPI_FLASH_MAP_BASE_ADDR +
+						  (flash_addr - p_handle->flash_addr_offset));
+#else
+	(void)handle;
+	(void)flash_addr;
+	(void)num_bytes;
+
+	return NULL;
+#endif
+}
+
+/**
+ * ospi_set_read_op puts back the fast read command set by ospi_init() for the
+ * generic operations, once an erase or a program has been issued with its
+ * own command.
+ *
+ * @return None
+ */
+static void ospi_set_read_op(void)
+{
+	op_param_t op_param = {
+		FLASH_CMD_FAST_READ, SPIX8_IO_X1, SPIX8_IO_X1, SPIX8_IO_X1, 0, 0, 0, 8};
+
+	set_op_param(&op_param);
+}
+
+/**
+ * ospi_erase_sector_async starts the erase of the OSPI_FLASH_SECTOR_SIZE bytes
+ * sector of the flash at flash_addr. It does not wait for the flash to be done,
+ * the caller polls ospi_is_flash_busy() instead, so that the CPU is free for
+ * other work for the duration of the erase.
+ *
+ * @param handle is the OSPI controller handle.
+ * @param flash_addr is the address of the sector, OSPI_FLASH_SECTOR_SIZE
+ * aligned.
+ *
+ * @return Returns true if the erase was issued, false otherwise.
+ */
+bool ospi_erase_sector_async(void *handle, uint32_t flash_addr)
+{
+	spix8_ctl_handle_t *p_handle = handle;
+	op_param_t          op_param = {
+		FLASH_CMD_SSE, SPIX8_IO_X1, SPIX8_IO_X1, SPIX8_IO_X1, 0, 0, 0, 0};
+	uint8_t             status;
+
+	GARD__DBG_ASSERT(p_handle != NULL &&
+						 0U == (flash_addr % OSPI_FLASH_SECTOR_SIZE),
+					 "Invalid parameters provided to ospi_erase_sector_async");
+
+	/* Any packet format but SPIX8_GEN_CMD skips the wait for the flash. */
+	set_op_param(&op_param);
+	status = flash_erase(p_handle, flash_addr, SPIX8_SUP_CMD, FLASH_ERASE_4KB);
+	ospi_set_read_op();
+
+	return status == SUCCESS;
+}
+
+/**
+ * ospi_program_page_async starts programming num_bytes of p_data in the flash
+ * at flash_addr. The data must not cross a OSPI_FLASH_PAGE_SIZE boundary of
+ * the flash. Like ospi_erase_sector_async(), it does not wait for the flash.
+ *
+ * @param handle is the OSPI controller handle.
+ * @param p_data is the data to program, word aligned.
+ * @param flash_addr is the address in the flash to program the data at.
+ * @param num_bytes is the number of bytes to program.
+ *
+ * @return Returns true if the program was issued, false otherwise.
+ */
+bool ospi_program_page_async(void           *handle,
+							 const uint32_t *p_data,
+							 uint32_t        flash_addr,
+							 uint32_t        num_bytes)
+{
+	spix8_ctl_handle_t *p_handle = handle;
+	op_param_t          op_param = {
+		FLASH_CMD_PP, SPIX8_IO_X1, SPIX8_IO_X1, SPIX8_IO_X1, 0, 0, 0, 0};
+	uint8_t             status;
+
+	GARD__DBG_ASSERT(p_handle != NULL && p_data != NULL && num_bytes > 0 &&
+						 (flash_addr % OSPI_FLASH_PAGE_SIZE) + num_bytes <=
+							 OSPI_FLASH_PAGE_SIZE,
+					 "Invalid parameters provided to ospi_program_page_async");
+
+	set_op_param(&op_param);
+	status = flash_program(p_handle, num_bytes, (unsigned int *)p_data,
+						   flash_addr, SPIX8_SUP_CMD);
+	ospi_set_read_op();
+
+	return status == SUCCESS;
+}
+
+/**
+ * ospi_is_flash_busy reads the status register of the flash to tell if an
+ * erase or a program started without waiting is still running.
+ *
+ * @param handle is the OSPI controller handle.
+ *
+ * @return Returns true while the flash is busy, false otherwise.
+ */
+bool ospi_is_flash_busy(void *handle)
+{
+	unsigned int status_reg = 0;
+
+	if (SUCCESS != gencmd_flash_rdsr(handle, &status_reg)) {
+		return false;
+	}
+
+	/* Write In Progress bit */
+	return 0U != (status_reg & 0x1U);
+}
+
+/**
+ * Size of the reads issued by ospi_read_from_flash(). A multiple of 4 bytes
+ * not larger than FLASH_READ_BURST_MAX_SIZE.
+ */
+#define OSPI_READ_BURST_SIZE (32U * 1024U)
+
 /**
  * ospi_read_from_flash reads num_bytes count of data from the flash starting
  * from flash_addr. The read data is stored in dat_buf. The function returns the
  * number of bytes that were successfully read from the flash and written to the
  * data buffer.
  *
+ * The data is read with burst reads of up to OSPI_READ_BURST_SIZE bytes. The
+ * last bytes short of a 4 bytes word, or all the data if dat_buf is not word
+ * aligned, are read one word at a time through a bounce word so that no byte
+ * past dat_buf + num_bytes is written.
+ *
  * @param handle is the OSPI controller handle.
  * @param dat_buf is the pointer to the data buffer where the read data will be
  * stored.
@@ -118,20 +300,29 @@ uint32_t ospi_read_from_flash(void    *handle,
 	uint8_t             status      = SUCCESS;
 	uint32_t            t_num_bytes = num_bytes;
 	uint32_t            bytes_to_read;
+	uint32_t            bounce_word;
 
 	GARD__DBG_ASSERT(p_handle != NULL && num_bytes > 0,
 					 "Invalid parameters provided to ospi_read_from_flash");
 
-	/**
-	 * Read the data in small chunks of 256 bytes as that is the one currently
-	 * working. Later we will debug this limitation to remove it.
-	 */
+	/* The flash cannot be read until an erase or a program started is done. */
+	while (ospi_is_flash_busy(p_handle)) {
+	}
+
 	do {
-		bytes_to_read = (t_num_bytes > FLASH_READ_CHUNK_SIZE)
-							? FLASH_READ_CHUNK_SIZE
-							: t_num_bytes;
-		status = flash_read(p_handle, bytes_to_read, (unsigned int *)dat_buf,
-							flash_addr, SPIX8_GEN_CMD, 0 /*no_ds*/);
+		if ((0U == ((uintptr_t)dat_buf & 0x3U)) && (t_num_bytes >= 4U)) {
+			bytes_to_read = (t_num_bytes > OSPI_READ_BURST_SIZE)
+								? OSPI_READ_BURST_SIZE
+								: (t_num_bytes & ~0x3U);
+			status = flash_read_burst(p_handle, bytes_to_read,
+									  (unsigned int *)dat_buf, flash_addr,
+									  0 /*no_ds*/);
+		} else {
+			bytes_to_read = (t_num_bytes > 4U) ? 4U : t_num_bytes;
+			status = flash_read_burst(p_handle, 4U, &bounce_word, flash_addr,
+									  0 /*no_ds*/);
+			memcpy(dat_buf, &bounce_word, bytes_to_read);
+		}
 		t_num_bytes -= bytes_to_read;
 		dat_buf     += bytes_to_read;
 		flash_addr  += bytes_to_read;
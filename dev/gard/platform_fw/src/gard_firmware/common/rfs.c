@@ -67,6 +67,60 @@
  */
 #define MAX_RFS_DIR_ENTRIES_TO_READ 5U
 
+/**
+ * Count of directory entries the RFS mount can cache in RAM. A directory with
+ * more entries is not cached and is searched in flash on every lookup.
+ */
+#ifndef RFS_INDEX_MAX_ENTRIES
+#define RFS_INDEX_MAX_ENTRIES 32U
+#endif
+
+/**
+ * struct rfs_index_entry is the cached form of a directory entry, with the
+ * absolute flash address of the module.
+ */
+struct rfs_index_entry {
+	uint32_t uid;
+	uint32_t absl_flash_addr;
+	uint32_t size;
+};
+
+/**
+ * rfs_mount_state holds the directory entries sorted by UID, as read by
+ * rfs_mount(). The directory is not written at run time so the cache never
+ * goes stale, write_module_to_rfs() only rewrites the data of a module. mount_tried is set once rfs_mount() ran, so that a failed mount is
+ * not retried on every lookup.
+ */
+static struct {
+	bool                   mount_tried;
+	bool                   mounted;
+	uint32_t               count_of_entries;
+	struct rfs_index_entry index[RFS_INDEX_MAX_ENTRIES];
+} rfs_mount_state;
+
+/**
+ * rfs_config_addr is the flash address of the configuration section of the
+ * RFS in use, that of the firmware slot booted, see rfs_set_config_addr().
+ */
+static uint32_t rfs_config_addr = RFS_CONFIG_START_ADDR;
+
+/**
+ * rfs_set_config_addr() selects the RFS the lookups are made in, by the flash
+ * address of its configuration section. It is to be called before the first
+ * lookup, the RFS mounted is not switched.
+ *
+ * @param config_addr is the flash address of the configuration section.
+ *
+ * @return None
+ */
+void rfs_set_config_addr(uint32_t config_addr)
+{
+	GARD__DBG_ASSERT(!rfs_mount_state.mount_tried,
+					 "The RFS is switched after it was mounted");
+
+	rfs_config_addr = config_addr;
+}
+
 /**
  * load_configuration_section() reads the configuration section from flash into
  * memory pointed by 'buffer'. Once the configuration section is read, the
@@ -103,7 +157,7 @@ bool load_configuration_section(void    *ospi_handle,
 		"Invalid parameters provided to load_configuration_section");
 
 	GARD__ASSERT(ospi_read_from_flash(
-					 ospi_handle, buffer, RFS_CONFIG_START_ADDR,
+					 ospi_handle, buffer, rfs_config_addr,
 					 sizeof(struct rfs_config)) == sizeof(struct rfs_config),
 				 "Failed to read configuration section from flash");
 
@@ -138,8 +192,8 @@ bool load_configuration_section(void    *ospi_handle,
 }
 
 /**
- * locate_module_id() locates the module in the directory stored in flash memory
- * and returns the start address and size of the module.
+ * search_module_id_in_flash() searches the module in the directory stored in
+ * flash memory and returns the start address and size of the module.
  *
  * @param ospi_handle is the OSPI controller handle.
  * @param module_uid is the unique identifier of the module to be located.
@@ -149,10 +203,10 @@ bool load_configuration_section(void    *ospi_handle,
  *
  * @return true if the module is located successfully, false otherwise.
  */
-bool locate_module_id(void     *ospi_handle,
-					  uint32_t  module_uid,
-					  uint32_t *module_absl_flash_addr,
-					  uint32_t *module_size)
+static bool search_module_id_in_flash(void     *ospi_handle,
+									  uint32_t  module_uid,
+									  uint32_t *module_absl_flash_addr,
+									  uint32_t *module_size)
 {
 	struct rfs_config     config;
 	struct rfs_dir_entry  dir_buffer[MAX_RFS_DIR_ENTRIES_TO_READ];
@@ -170,10 +224,6 @@ bool locate_module_id(void     *ospi_handle,
 	 * and the size of the module in the Flash.
 	 */
 
-	GARD__DBG_ASSERT(ospi_handle != NULL && module_absl_flash_addr != NULL &&
-						 module_size != NULL,
-					 "Invalid parameters provided to locate_module_id");
-
 	/* Load and validate configuration section to get directory details. */
 	if (!load_configuration_section(ospi_handle, &config, sizeof(config))) {
 		/* Failed to load configuration section. */
@@ -182,7 +232,7 @@ bool locate_module_id(void     *ospi_handle,
 
 	/* Set markers for directory boundaries. */
 	dir_entry_in_flash  = (struct rfs_dir_entry *)(config.start_of_directory +
-                                                  RFS_CONFIG_START_ADDR);
+                                                  rfs_config_addr);
 
 	dir_data_to_process = config.directory_size;
 
@@ -213,7 +263,7 @@ bool locate_module_id(void     *ospi_handle,
 				/* Module FOUND. Return the module information. */
 				*module_absl_flash_addr = dir_entry_in_buffer->start_addr +
 										  config.start_of_directory +
-										  RFS_CONFIG_START_ADDR;
+										  rfs_config_addr;
 				*module_size = dir_entry_in_buffer->size;
 
 				return true;
@@ -228,6 +278,153 @@ bool locate_module_id(void     *ospi_handle,
 	return false;
 }
 
+/**
+ * rfs_index_lower_bound() returns the position of the first cached directory
+ * entry with a UID not lower than module_uid.
+ *
+ * @param module_uid is the UID to look for.
+ *
+ * @return position in rfs_mount_state.index, count_of_entries if all the
+ * entries have a lower UID.
+ */
+static uint32_t rfs_index_lower_bound(uint32_t module_uid)
+{
+	uint32_t low  = 0;
+	uint32_t high = rfs_mount_state.count_of_entries;
+	uint32_t mid;
+
+	while (low < high) {
+		mid = low + (high - low) / 2U;
+		if (rfs_mount_state.index[mid].uid < module_uid) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/**
+ * rfs_mount() reads the configuration and the directory sections from flash
+ * once, and caches the configuration and the directory entries sorted by UID
+ * in RAM. Module lookups are then a binary search which does not touch the
+ * flash. Calling it again once mounted does nothing.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return true if the RFS is mounted, false if the configuration is invalid,
+ * the directory cannot be read or it has more than RFS_INDEX_MAX_ENTRIES
+ * entries. Lookups then keep searching the directory in flash.
+ */
+bool rfs_mount(void *ospi_handle)
+{
+	struct rfs_config    config;
+	struct rfs_dir_entry dir_entry;
+	uint32_t             dir_entry_in_flash;
+	uint32_t             count_of_entries;
+	uint32_t             pos;
+	uint32_t             idx;
+
+	GARD__DBG_ASSERT(ospi_handle != NULL,
+					 "Invalid parameters provided to rfs_mount");
+
+	if (rfs_mount_state.mount_tried) {
+		return rfs_mount_state.mounted;
+	}
+	rfs_mount_state.mount_tried = true;
+
+	if (!load_configuration_section(ospi_handle, &config, sizeof(config)) ||
+		config.directory_entry_size < sizeof(struct rfs_dir_entry)) {
+		return false;
+	}
+
+	count_of_entries = config.directory_size / config.directory_entry_size;
+	if (count_of_entries > RFS_INDEX_MAX_ENTRIES) {
+		return false;
+	}
+
+	dir_entry_in_flash = config.start_of_directory + rfs_config_addr;
+
+	for (idx = 0; idx < count_of_entries; idx++) {
+		/**
+		 * Only the fields known to this code are read, the entries can be
+		 * larger in newer directory formats.
+		 */
+		if (ospi_read_from_flash(ospi_handle, (uint8_t *)&dir_entry,
+								 dir_entry_in_flash, sizeof(dir_entry)) !=
+			sizeof(dir_entry)) {
+			return false;
+		}
+		dir_entry_in_flash += config.directory_entry_size;
+
+		/**
+		 * Insertion sort, the entry goes after the ones with the same UID so
+		 * that a lookup finds the first one in the directory like the search
+		 * in flash does.
+		 */
+		for (pos = idx;
+			 pos > 0 && rfs_mount_state.index[pos - 1U].uid > dir_entry.uid;
+			 pos--) {
+			rfs_mount_state.index[pos] = rfs_mount_state.index[pos - 1U];
+		}
+
+		rfs_mount_state.index[pos].uid             = dir_entry.uid;
+		rfs_mount_state.index[pos].absl_flash_addr = dir_entry.start_addr +
+													 config.start_of_directory +
+													 rfs_config_addr;
+		rfs_mount_state.index[pos].size            = dir_entry.size;
+	}
+
+	rfs_mount_state.count_of_entries = count_of_entries;
+	rfs_mount_state.mounted          = true;
+
+	return true;
+}
+
+/**
+ * locate_module_id() locates the module in the directory and returns the start
+ * address and size of the module. The directory cached by rfs_mount() is used,
+ * the RFS is mounted on the first lookup if it is not yet. Without a mounted
+ * RFS the directory is searched in flash.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param module_uid is the unique identifier of the module to be located.
+ * @param module_absl_flash_addr pointer to be filled with the flash address of
+ * the module. This is an absolute flash address from start of flash memory.
+ * @param module_size pointer to be filled with the size of the module.
+ *
+ * @return true if the module is located successfully, false otherwise.
+ */
+bool locate_module_id(void     *ospi_handle,
+					  uint32_t  module_uid,
+					  uint32_t *module_absl_flash_addr,
+					  uint32_t *module_size)
+{
+	uint32_t pos;
+
+	GARD__DBG_ASSERT(ospi_handle != NULL && module_absl_flash_addr != NULL &&
+						 module_size != NULL,
+					 "Invalid parameters provided to locate_module_id");
+
+	if (!rfs_mount(ospi_handle)) {
+		return search_module_id_in_flash(ospi_handle, module_uid,
+										 module_absl_flash_addr, module_size);
+	}
+
+	pos = rfs_index_lower_bound(module_uid);
+	if (pos == rfs_mount_state.count_of_entries ||
+		rfs_mount_state.index[pos].uid != module_uid) {
+		/* Module NOT FOUND. */
+		return false;
+	}
+
+	*module_absl_flash_addr = rfs_mount_state.index[pos].absl_flash_addr;
+	*module_size            = rfs_mount_state.index[pos].size;
+
+	return true;
+}
+
 /**
  * read_module_from_rfs() loads the module with the specified UID from Flash
  * memory into the provided buffer. If the read request will overflow the module
@@ -298,3 +495,196 @@ uint32_t read_module_from_rfs(void    *ospi_handle,
 
 	return read_bytes;
 }
+
+/**
+ * rfs_wait_flash() waits for the flash to be done with an erase or a program.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ *
+ * @return None
+ */
+static void rfs_wait_flash(void *ospi_handle)
+{
+	while (ospi_is_flash_busy(ospi_handle)) {
+	}
+}
+
+/**
+ * rfs_verify_flash() reads back the bytes just programmed and compares them
+ * with the data they were programmed from.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param flash_addr is the flash address the data was programmed at.
+ * @param p_data is the data programmed, 32-bit aligned.
+ * @param num_bytes is the count of bytes programmed, a multiple of 4.
+ *
+ * @return true if the flash holds the data, false otherwise.
+ */
+static bool rfs_verify_flash(void          *ospi_handle,
+							 uint32_t       flash_addr,
+							 const uint8_t *p_data,
+							 uint32_t       num_bytes)
+{
+	const uint32_t *p_words = (const uint32_t *)p_data;
+	uint32_t        read_back[16];
+	uint32_t        chunk;
+	uint32_t        idx;
+
+	while (num_bytes > 0) {
+		chunk = MIN(num_bytes, sizeof(read_back));
+		if (ospi_read_from_flash(ospi_handle, (uint8_t *)read_back, flash_addr,
+								 chunk) != chunk) {
+			return false;
+		}
+
+		for (idx = 0; idx < chunk / sizeof(uint32_t); idx++) {
+			if (read_back[idx] != *p_words++) {
+				return false;
+			}
+		}
+
+		flash_addr += chunk;
+		num_bytes  -= chunk;
+	}
+
+	return true;
+}
+
+/**
+ * write_module_to_rfs() replaces the data of the module with the specified UID
+ * in Flash memory, from module_write_offset on, with the contents of buffer.
+ * The module keeps its place and size in the directory, so the write is
+ * refused if it overflows the module. The sectors the write covers are erased
+ * first: the bytes of the module after the written ones, up to the end of the
+ * last sector, are erased too. RootImageBuilder places every module on an
+ * erase block boundary, so no other module shares the sectors erased.
+ *
+ * The flash is busy for the whole write, the call blocks until every page is
+ * programmed and verified.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param module_uid is the unique identifier of the module to be written.
+ * @param module_write_offset is the offset from the start of the module to be
+ * 							  written. module_write_offset should be aligned
+ * 							  to OSPI_FLASH_SECTOR_SIZE.
+ * @param write_bytes is the number of bytes to be written to the module.
+ * 					  write_bytes should be multiple of 4.
+ * @param buffer is the pointer to the data to write, 32-bit aligned.
+ *
+ * @return count of bytes written to the module. In case of error returns 0,
+ * 		   the written part of the module is then left erased or partly
+ * 		   programmed.
+ */
+uint32_t write_module_to_rfs(void       *ospi_handle,
+							 uint32_t    module_uid,
+							 uint32_t    module_write_offset,
+							 uint32_t    write_bytes,
+							 const void *buffer)
+{
+	const uint8_t *p_data = buffer;
+	uint32_t       module_flash_addr;
+	uint32_t       module_size;
+	uint32_t       write_addr;
+	uint32_t       erase_addr;
+	uint32_t       erase_end;
+	uint32_t       chunk;
+	uint32_t       idx;
+
+	GARD__DBG_ASSERT(ospi_handle != NULL && buffer != NULL && write_bytes != 0,
+					 "Invalid parameters provided to write_module_to_rfs");
+
+	GARD__DBG_ASSERT(module_write_offset % OSPI_FLASH_SECTOR_SIZE == 0 &&
+						 write_bytes % sizeof(uint32_t) == 0 &&
+						 (uint32_t)buffer % sizeof(uint32_t) == 0,
+					 "module_write_offset must be aligned to a sector, "
+					 "write_bytes and buffer to 4 bytes in "
+					 "write_module_to_rfs");
+
+	if (locate_module_id(ospi_handle, module_uid, &module_flash_addr,
+						 &module_size) == false) {
+		/* Module NOT FOUND. */
+		return 0U;
+	}
+
+	if (module_flash_addr % OSPI_FLASH_SECTOR_SIZE != 0 ||
+		module_write_offset >= module_size ||
+		write_bytes > module_size - module_write_offset) {
+		/* The sectors would be shared with another module, or overflow. */
+		return 0U;
+	}
+
+	write_addr = module_flash_addr + module_write_offset;
+	erase_end  = write_addr + write_bytes;
+
+	/* Another flash user, e.g. a firmware upgrade, may have left it busy. */
+	rfs_wait_flash(ospi_handle);
+
+	for (erase_addr = write_addr; erase_addr < erase_end;
+		 erase_addr += OSPI_FLASH_SECTOR_SIZE) {
+		if (!ospi_erase_sector_async(ospi_handle, erase_addr)) {
+			return 0U;
+		}
+		rfs_wait_flash(ospi_handle);
+	}
+
+	for (idx = 0; idx < write_bytes; idx += chunk) {
+		/* A program does not cross a page, the start is page aligned. */
+		chunk = MIN(write_bytes - idx, OSPI_FLASH_PAGE_SIZE);
+		if (!ospi_program_page_async(ospi_handle,
+									 (const uint32_t *)(p_data + idx),
+									 write_addr + idx, chunk)) {
+			return 0U;
+		}
+		rfs_wait_flash(ospi_handle);
+	}
+
+	if (!rfs_verify_flash(ospi_handle, write_addr, p_data, write_bytes)) {
+		return 0U;
+	}
+
+	return write_bytes;
+}
+
+/**
+ * map_module_from_rfs() returns the address at which the module with the
+ * specified UID can be read directly from the memory-mapped flash, starting
+ * from module_read_offset. This avoids copying read-only data to RAM.
+ *
+ * @param ospi_handle is the OSPI controller handle.
+ * @param module_uid is the unique identifier of the module to be mapped.
+ * @param module_read_offset is the offset from the start of the module to be
+ * 							 mapped.
+ * @param mapped_bytes pointer to be filled with the count of bytes of the
+ * 					   module available from the returned address.
+ *
+ * @return address of the module data, NULL if the module is not found or the
+ * 		   flash is not mapped. The module can still be read with
+ * 		   read_module_from_rfs() then.
+ */
+const void *map_module_from_rfs(void     *ospi_handle,
+								uint32_t  module_uid,
+								uint32_t  module_read_offset,
+								uint32_t *mapped_bytes)
+{
+	uint32_t    module_flash_addr;
+	uint32_t    module_size;
+	const void *p_data;
+
+	GARD__DBG_ASSERT(ospi_handle != NULL && mapped_bytes != NULL,
+					 "Invalid parameters provided to map_module_from_rfs");
+
+	if (locate_module_id(ospi_handle, module_uid, &module_flash_addr,
+						 &module_size) == false ||
+		module_read_offset >= module_size) {
+		/* Module NOT FOUND or nothing to map. */
+		return NULL;
+	}
+
+	p_data = ospi_map_flash(ospi_handle, module_flash_addr + module_read_offset,
+							module_size - module_read_offset);
+	if (p_data != NULL) {
+		*mapped_bytes = module_size - module_read_offset;
+	}
+
+	return p_data;
+}
@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "utils.h"
+#include "cpu.h"
+#include "irq_support.h"
+#include "sw_timer.h"
+
+/* Armed timers, earliest expiry first */
+static struct sw_timer *armed_timers;
+
+/**
+ * sw_timer_ms_to_ticks converts milliseconds to CPU TSC units.
+ *
+ * @param ms: Time in milliseconds.
+ *
+ * @return The time in CPU TSC units.
+ */
+static uint64_t sw_timer_ms_to_ticks(uint32_t ms)
+{
+	return ((uint64_t)CLINT_TIMEBASE_FREQ * ms) / 1000U;
+}
+
+/**
+ * sw_timer_unlink takes a timer off the armed list, if on it.
+ *
+ * @param p_timer: Timer to take off.
+ *
+ * @return None
+ */
+static void sw_timer_unlink(struct sw_timer *p_timer)
+{
+	struct sw_timer **pp_timer;
+
+	for (pp_timer = &armed_timers; NULL != *pp_timer;
+		 pp_timer = &(*pp_timer)->next) {
+		if (*pp_timer == p_timer) {
+			*pp_timer         = p_timer->next;
+			p_timer->next     = NULL;
+			p_timer->is_armed = false;
+			return;
+		}
+	}
+}
+
+/**
+ * sw_timer_link puts a timer on the armed list, after the timers due at the
+ * same time or before it.
+ *
+ * @param p_timer: Timer to put on, with its expiry set.
+ *
+ * @return None
+ */
+static void sw_timer_link(struct sw_timer *p_timer)
+{
+	struct sw_timer **pp_timer;
+
+	for (pp_timer = &armed_timers; NULL != *pp_timer;
+		 pp_timer = &(*pp_timer)->next) {
+		if ((int64_t)((*pp_timer)->expiry - p_timer->expiry) > 0) {
+			break;
+		}
+	}
+
+	p_timer->next     = *pp_timer;
+	p_timer->is_armed = true;
+	*pp_timer         = p_timer;
+}
+
+/**
+ * sw_timer_arm_wake arms the CLINT timer interrupt for the earliest timer,
+ * so that the main loop wakes from WFI for it. Left armed once no timer is,
+ * it only wakes the main loop once for nothing.
+ *
+ * @param None
+ *
+ * @return None
+ */
+static void sw_timer_arm_wake(void)
+{
+	if (NULL != armed_timers) {
+		irq_wake_at(armed_timers->expiry);
+	}
+}
+
+/**
+ * sw_timer_init sets up a timer, not armed.
+ *
+ * @param p_timer: Timer, statically allocated by the caller.
+ * @param name: Name of the timer, for debugging only.
+ * @param fn: Callback called when the timer fires.
+ * @param ctx: Context passed to fn.
+ *
+ * @return None
+ */
+void sw_timer_init(struct sw_timer *p_timer, const char *name,
+				   sw_timer_fn_t fn, void *ctx)
+{
+	GARD__DBG_ASSERT((NULL != p_timer) && (NULL != fn), "Invalid timer");
+
+	p_timer->name         = name;
+	p_timer->fn           = fn;
+	p_timer->ctx          = ctx;
+	p_timer->expiry       = 0;
+	p_timer->period_ticks = 0;
+	p_timer->is_armed     = false;
+	p_timer->next         = NULL;
+}
+
+/**
+ * sw_timer_start arms a timer to fire delay_ms from now, then every period_ms
+ * if period_ms is not 0. A timer already armed is re-armed.
+ *
+ * @param p_timer: Timer set up by sw_timer_init().
+ * @param delay_ms: Time until it fires first.
+ * @param period_ms: Time between the next firings, 0 to fire once.
+ *
+ * @return None
+ */
+void sw_timer_start(struct sw_timer *p_timer, uint32_t delay_ms,
+					uint32_t period_ms)
+{
+	GARD__DBG_ASSERT((NULL != p_timer) && (NULL != p_timer->fn),
+					 "Timer not set up");
+
+	if (p_timer->is_armed) {
+		sw_timer_unlink(p_timer);
+	}
+
+	p_timer->expiry       = get_cpu_tsc() + sw_timer_ms_to_ticks(delay_ms);
+	p_timer->period_ticks = (uint32_t)sw_timer_ms_to_ticks(period_ms);
+	sw_timer_link(p_timer);
+
+	if (armed_timers == p_timer) {
+		sw_timer_arm_wake();
+	}
+}
+
+/**
+ * sw_timer_stop disarms a timer, if armed. Its callback is not called.
+ *
+ * @param p_timer: Timer set up by sw_timer_init().
+ *
+ * @return None
+ */
+void sw_timer_stop(struct sw_timer *p_timer)
+{
+	if (p_timer->is_armed) {
+		sw_timer_unlink(p_timer);
+		sw_timer_arm_wake();
+	}
+}
+
+/**
+ * sw_timer_is_armed tells if a timer is yet to fire.
+ *
+ * @param p_timer: Timer set up by sw_timer_init().
+ *
+ * @return true if the timer is armed, false otherwise.
+ */
+bool sw_timer_is_armed(const struct sw_timer *p_timer)
+{
+	return p_timer->is_armed;
+}
+
+/**
+ * sw_timers_run calls the callbacks of the timers due. A periodic timer is
+ * re-armed before its callback is called, one period after it was due, or
+ * one period from now if it fell more than a period behind, so that it does
+ * not fire in a burst to catch up.
+ *
+ * @param None
+ *
+ * @return true if any timer fired, false otherwise.
+ */
+bool sw_timers_run(void)
+{
+	struct sw_timer *p_timer;
+	uint64_t         now      = get_cpu_tsc();
+	bool             did_work = false;
+
+	while ((NULL != (p_timer = armed_timers)) &&
+		   ((int64_t)(now - p_timer->expiry) >= 0)) {
+		armed_timers      = p_timer->next;
+		p_timer->next     = NULL;
+		p_timer->is_armed = false;
+
+		if (0U != p_timer->period_ticks) {
+			p_timer->expiry += p_timer->period_ticks;
+			if ((int64_t)(now - p_timer->expiry) >= 0) {
+				p_timer->expiry = now + p_timer->period_ticks;
+			}
+			sw_timer_link(p_timer);
+		}
+
+		p_timer->fn(p_timer->ctx);
+		did_work = true;
+	}
+
+	if (did_work) {
+		sw_timer_arm_wake();
+	}
+
+	return did_work;
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "utils.h"
+#include "task_sched.h"
+
+/* Registered tasks of every level, in the order they are run */
+static struct task *task_levels[TASK_PRIO_NB];
+
+/* Rounds in a row each level was skipped for higher priority work */
+static uint32_t skipped_rounds[TASK_PRIO_NB];
+
+/**
+ * task_register adds a task to its priority level, after the tasks already
+ * registered at that level. Tasks are registered once at init and are never
+ * removed.
+ *
+ * @param p_task: Task to register, statically allocated by the caller.
+ * @param name: Name of the task, used for reporting only.
+ * @param fn: Function running one slice of the task.
+ * @param ctx: Context passed to fn.
+ * @param prio: Priority level of the task.
+ *
+ * @return None
+ */
+void task_register(struct task *p_task, const char *name, task_fn_t fn,
+				   void *ctx, enum task_prio prio)
+{
+	struct task **pp_last;
+
+	GARD__DBG_ASSERT((NULL != p_task) && (NULL != fn) && (prio < TASK_PRIO_NB),
+					 "Invalid task");
+
+	p_task->name             = name;
+	p_task->fn               = fn;
+	p_task->ctx              = ctx;
+	p_task->prio             = prio;
+	p_task->stats.runs       = 0;
+	p_task->stats.busy_ticks = 0;
+	p_task->stats.max_ticks  = 0;
+	p_task->next             = NULL;
+
+	for (pp_last = &task_levels[prio]; NULL != *pp_last;
+		 pp_last = &(*pp_last)->next) {
+	}
+	*pp_last = p_task;
+}
+
+/**
+ * task_run_level runs one slice of every task of a level, and accounts the
+ * time of the slices that did work.
+ *
+ * @param prio: Priority level to run.
+ *
+ * @return true if any task of the level did some work, false otherwise.
+ */
+static bool task_run_level(enum task_prio prio)
+{
+	struct task *p_task;
+	uint64_t     start;
+	uint32_t     ticks;
+	bool         did_work = false;
+
+	for (p_task = task_levels[prio]; NULL != p_task; p_task = p_task->next) {
+		start = get_cpu_tsc();
+		if (!p_task->fn(p_task->ctx)) {
+			continue;
+		}
+
+		ticks = (uint32_t)(get_cpu_tsc() - start);
+		p_task->stats.runs++;
+		p_task->stats.busy_ticks += ticks;
+		if (ticks > p_task->stats.max_ticks) {
+			p_task->stats.max_ticks = ticks;
+		}
+		did_work = true;
+	}
+
+	return did_work;
+}
+
+/**
+ * task_sched_run runs one round of the scheduler: the levels are run from the
+ * highest priority down, and once a level did some work the levels below it
+ * are skipped for this round, unless they were already skipped for
+ * TASK_SCHED_MAX_SKIPPED_ROUNDS rounds in a row.
+ *
+ * @param None
+ *
+ * @return true if any task did some work, false if all tasks are idle.
+ */
+bool task_sched_run(void)
+{
+	uint32_t prio;
+	bool     did_work = false;
+
+	for (prio = 0; prio < TASK_PRIO_NB; prio++) {
+		if (did_work &&
+			(skipped_rounds[prio] < TASK_SCHED_MAX_SKIPPED_ROUNDS)) {
+			skipped_rounds[prio]++;
+			continue;
+		}
+
+		skipped_rounds[prio] = 0;
+		if (task_run_level((enum task_prio)prio)) {
+			did_work = true;
+		}
+	}
+
+	return did_work;
+}
+
+/**
+ * task_sched_for_each calls fn for every registered task, highest priority
+ * first.
+ *
+ * @param fn: Function called for each task.
+ * @param ctx: Context passed to fn.
+ *
+ * @return None
+ */
+void task_sched_for_each(void (*fn)(const struct task *p_task, void *ctx),
+						 void *ctx)
+{
+	const struct task *p_task;
+	uint32_t           prio;
+
+	for (prio = 0; prio < TASK_PRIO_NB; prio++) {
+		for (p_task = task_levels[prio]; NULL != p_task;
+			 p_task = p_task->next) {
+			fn(p_task, ctx);
+		}
+	}
+}
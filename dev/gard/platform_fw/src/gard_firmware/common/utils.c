@@ -9,7 +9,75 @@
 #include "utils.h"
 #include "cpu.h"
 
-static uint64_t timer_set_for_time = 0;
+#define UTILS_WORD_MASK (sizeof(uint32_t) - 1U)
+
+/**
+ * The memcpy(), memmove() and memset() loops must not be turned back into
+ * calls to the very routines they implement.
+ */
+#define UTILS_NO_LIBCALL                                                       \
+	__attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+/**
+ * Words summed in the 16-bit lanes of checksum_update() before they are
+ * folded into the sum, so that a lane cannot overflow: each word adds at
+ * most 2 * 0xFF to a lane.
+ */
+#define CHECKSUM_WORDS_PER_FOLD (128U)
+
+/**
+ * checksum_update() extends a checksum, the sum of all bytes, over the given
+ * data. The checksum of a buffer received in pieces is obtained by calling it
+ * for each piece in order, starting from 0.
+ *
+ * The bytes up to the first word boundary are added one at a time. The
+ * aligned words are then added two bytes at a time, the even and odd bytes
+ * of each word in the two 16-bit lanes of an accumulator, which is folded
+ * into the sum every CHECKSUM_WORDS_PER_FOLD words.
+ *
+ * @param checksum is the checksum of the data so far, 0 to start.
+ * @param data points to the next piece of data.
+ * @param size is the size of the piece in bytes.
+ *
+ * @return The checksum of the data so far including this piece.
+ */
+uint32_t checksum_update(uint32_t checksum, const uint8_t *data, uint32_t size)
+{
+	const uint32_t *words;
+	uint32_t        num_words;
+	uint32_t        batch;
+	uint32_t        lanes;
+	uint32_t        w;
+
+	while ((0U != ((uint32_t)data & UTILS_WORD_MASK)) && (size > 0U)) {
+		checksum += *data++;
+		size--;
+	}
+
+	words      = (const uint32_t *)data;
+	num_words  = size / sizeof(uint32_t);
+	size      -= num_words * sizeof(uint32_t);
+
+	while (num_words > 0U) {
+		batch = (num_words < CHECKSUM_WORDS_PER_FOLD) ? num_words
+													  : CHECKSUM_WORDS_PER_FOLD;
+		num_words -= batch;
+
+		lanes = 0;
+		while (batch-- > 0U) {
+			w      = *words++;
+			lanes += (w & 0x00FF00FFU) + ((w >> 8) & 0x00FF00FFU);
+		}
+		checksum += (lanes & 0xFFFFU) + (lanes >> 16);
+	}
+
+	data = (const uint8_t *)words;
+	while (size-- > 0U) {
+		checksum += *data++;
+	}
+
+	return checksum;
+}
 
 /**
  * calculate_checksum() computes the checksum of the given data. The checksum is
@@ -24,19 +92,48 @@ static uint64_t timer_set_for_time = 0;
  */
 uint32_t calculate_checksum(uint8_t *data, uint32_t size)
 {
-	uint32_t checksum = 0;
+	return checksum_update(0, data, size);
+}
+
+/**
+ * Nibble table of the reflected CRC-32 polynomial 0xEDB88320. It costs two
+ * lookups per byte, in 64 bytes instead of the 1 KiB of a byte table.
+ */
+static const uint32_t crc32_nibble_table[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+	0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+	0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/**
+ * crc32_update() extends a CRC-32 (IEEE 802.3, as computed by zlib's crc32())
+ * over the given data. The CRC of a buffer received in pieces is obtained by
+ * calling it for each piece in order, starting from 0.
+ *
+ * @param crc is the CRC of the data so far, 0 to start.
+ * @param data points to the next piece of data.
+ * @param size is the size of the piece in bytes.
+ *
+ * @return The CRC of the data so far including this piece.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t size)
+{
+	crc = ~crc;
 	for (uint32_t i = 0; i < size; i++) {
-		checksum += data[i];
+		crc ^= data[i];
+		crc  = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+		crc  = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
 	}
-	return checksum;
+	return ~crc;
 }
 
 /**
  * memcpy() copies a specified number of bytes from the source buffer to the
- * destination buffer. It performs a simple byte-by-byte copy.
- * The routine does not handle overlapping memory regions, so it is the
- * responsibility of the caller to ensure that the memory regions do not overlap
- * unless the overlap is intentional.
+ * destination buffer. When both buffers have the same alignment within a
+ * word, the bytes up to the first word boundary are copied one at a time,
+ * then whole words, four per iteration, then the bytes left. Otherwise, as
+ * RV32 traps on misaligned word accesses, it copies byte by byte.
+ * The routine does not handle overlapping memory regions, see memmove().
  *
  * @param dest points to the destination buffer where data will be copied.
  * @param src points to the source buffer from which data will be copied.
@@ -44,21 +141,100 @@ uint32_t calculate_checksum(uint8_t *data, uint32_t size)
  *
  * @return Pointer to the destination buffer after copying the data.
  */
-void *memcpy(void *dest, const void *src, uint32_t size)
+UTILS_NO_LIBCALL void *memcpy(void *dest, const void *src, uint32_t size)
 {
-	uint8_t *d = (uint8_t *)dest;
-	uint8_t *s = (uint8_t *)src;
+	uint8_t        *d = (uint8_t *)dest;
+	const uint8_t  *s = (const uint8_t *)src;
+	uint32_t       *dw;
+	const uint32_t *sw;
 
 	GARD__DBG_ASSERT((NULL != d) && (NULL != s),
 					 "Invalid parameters for memcpy");
 
-	for (uint32_t i = 0; i < size; i++) {
+	if (0U == (((uint32_t)d ^ (uint32_t)s) & UTILS_WORD_MASK)) {
+		while ((0U != ((uint32_t)d & UTILS_WORD_MASK)) && (size > 0U)) {
+			*d++ = *s++;
+			size--;
+		}
+
+		dw = (uint32_t *)d;
+		sw = (const uint32_t *)s;
+		while (size >= (4U * sizeof(uint32_t))) {
+			dw[0]  = sw[0];
+			dw[1]  = sw[1];
+			dw[2]  = sw[2];
+			dw[3]  = sw[3];
+			dw    += 4;
+			sw    += 4;
+			size  -= 4U * sizeof(uint32_t);
+		}
+		while (size >= sizeof(uint32_t)) {
+			*dw++  = *sw++;
+			size  -= sizeof(uint32_t);
+		}
+
+		d = (uint8_t *)dw;
+		s = (const uint8_t *)sw;
+	}
+
+	while (size-- > 0U) {
 		*d++ = *s++;
 	}
 
 	return dest;
 }
 
+/**
+ * memmove() copies a specified number of bytes from the source buffer to the
+ * destination buffer, which may overlap. A destination below the source, or
+ * not overlapping it, is copied forward by memcpy(). Otherwise the copy runs
+ * backward, by words when both buffers have the same alignment within a word.
+ *
+ * @param dest points to the destination buffer where data will be copied.
+ * @param src points to the source buffer from which data will be copied.
+ * @param size is the count of bytes to copy from source to destination.
+ *
+ * @return Pointer to the destination buffer after copying the data.
+ */
+UTILS_NO_LIBCALL void *memmove(void *dest, const void *src, uint32_t size)
+{
+	uint8_t        *d = (uint8_t *)dest + size;
+	const uint8_t  *s = (const uint8_t *)src + size;
+	uint32_t       *dw;
+	const uint32_t *sw;
+
+	GARD__DBG_ASSERT((NULL != dest) && (NULL != src),
+					 "Invalid parameters for memmove");
+
+	if (((uint32_t)dest <= (uint32_t)src) ||
+		((uint32_t)dest >= ((uint32_t)src + size))) {
+		return memcpy(dest, src, size);
+	}
+
+	if (0U == (((uint32_t)d ^ (uint32_t)s) & UTILS_WORD_MASK)) {
+		while ((0U != ((uint32_t)d & UTILS_WORD_MASK)) && (size > 0U)) {
+			*--d = *--s;
+			size--;
+		}
+
+		dw = (uint32_t *)d;
+		sw = (const uint32_t *)s;
+		while (size >= sizeof(uint32_t)) {
+			*--dw  = *--sw;
+			size  -= sizeof(uint32_t);
+		}
+
+		d = (uint8_t *)dw;
+		s = (const uint8_t *)sw;
+	}
+
+	while (size-- > 0U) {
+		*--d = *--s;
+	}
+
+	return dest;
+}
+
 /**
  * memcpy_w() copies a specified number of bytes from the source buffer to the
  * destination buffer. It performs a word-by-word copy. The word size is the
@@ -95,7 +271,9 @@ uint32_t *memcpy_w(uint32_t *dest, const uint32_t *src, uint32_t size)
 
 /**
  * memset() sets the memory pointed by buffer with byte character 'c' for
- * size number of bytes It performs a simple byte-copy operation.
+ * size number of bytes. The bytes up to the first word boundary are set one
+ * at a time, then whole words of the value repeated, four per iteration, then
+ * the bytes left.
  *
  * @param buffer points to the destination buffer where data will be set.
  * @param value is the value to set in each byte of the destination buffer.
@@ -103,14 +281,37 @@ uint32_t *memcpy_w(uint32_t *dest, const uint32_t *src, uint32_t size)
  *
  * @return Pointer to the destination buffer after setting the data.
  */
-void *memset(void *buffer, int32_t value, uint32_t size)
+UTILS_NO_LIBCALL void *memset(void *buffer, int32_t value, uint32_t size)
 {
-	uint8_t *ret = (uint8_t *)buffer;
+	uint8_t  *ret  = (uint8_t *)buffer;
+	uint8_t   byte = (uint8_t)value;
+	uint32_t  word = 0x01010101U * byte;
+	uint32_t *w;
 
 	GARD__DBG_ASSERT(NULL != ret, "Invalid buffer for memset");
 
-	while (size--) {
-		*ret++ = value;
+	while ((0U != ((uint32_t)ret & UTILS_WORD_MASK)) && (size > 0U)) {
+		*ret++ = byte;
+		size--;
+	}
+
+	w = (uint32_t *)ret;
+	while (size >= (4U * sizeof(uint32_t))) {
+		w[0]  = word;
+		w[1]  = word;
+		w[2]  = word;
+		w[3]  = word;
+		w    += 4;
+		size -= 4U * sizeof(uint32_t);
+	}
+	while (size >= sizeof(uint32_t)) {
+		*w++  = word;
+		size -= sizeof(uint32_t);
+	}
+
+	ret = (uint8_t *)w;
+	while (size-- > 0U) {
+		*ret++ = byte;
 	}
 
 	return buffer;
@@ -133,30 +334,6 @@ uint64_t get_cpu_tsc(void)
 	return tsc;
 }
 
-/**
- * set_timer_for_time() sets a timer to expire after the specified time in
- * milliseconds. It calculates the absolute time (in CPU TSC units) when the
- */
-uint64_t set_timer_for_time(uint32_t time_in_ms)
-{
-	GARD__DBG_ASSERT(timer_set_for_time == 0, "Previous timer not yet expired");
-	uint64_t timer_expiry_delay =
-		(uint64_t)((CLINT_TIMEBASE_FREQ * time_in_ms) / 1000U);
-
-	timer_set_for_time = get_cpu_tsc() + timer_expiry_delay;
-	return timer_set_for_time;
-}
-
-bool has_timer_expired(void)
-{
-	if (timer_set_for_time && get_cpu_tsc() >= timer_set_for_time) {
-		timer_set_for_time = 0;
-		return true;
-	}
-
-	return false;
-}
-
 /**
  * delay() creates a blocking delay for the specified number of milliseconds.
  * This delay is implemented as a simple busy-wait loop using the provided mtime
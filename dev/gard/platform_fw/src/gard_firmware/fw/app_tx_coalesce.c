@@ -0,0 +1,300 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "gpio_mapper.h"
+#include "utils.h"
+#include "fw_core.h"
+#include "fw_globals.h"
+#include "pipeline_stats.h"
+#include "sw_timer.h"
+#include "app_tx_coalesce.h"
+
+static void app_tx_latency_expired(void *ctx);
+
+/**
+ * The setting in use, see set_app_tx_coalescing(). latency_timer raises the
+ * IRQ again every latency_ms while results are left unread.
+ */
+static bool            coalescing    = false;
+static uint32_t        latency_ms    = APP_DATA_COALESCE__DEFAULT_LATENCY_MS;
+static struct sw_timer latency_timer = {.name = "app_tx_latency",
+										.fn   = app_tx_latency_expired};
+
+/**
+ * The batch buffer, of batch_size bytes of records framed as in a
+ * CC_APP_DATA_BATCH payload. It is queued in app_tx_queue once the queue has
+ * room, and added to as long as it is the newest entry and not sealed, i.e.
+ * not going out in a fetch.
+ */
+static uint8_t batch_buf[APP_DATA_COALESCE__MAX_BYTES]
+	__attribute__((aligned(4)));
+static uint32_t batch_size   = 0;
+static bool     batch_queued = false;
+static bool     batch_sealed = false;
+
+/* Counts since boot, see APP_DATA_COALESCING. */
+static uint32_t irqs_raised       = 0;
+static uint32_t results_coalesced = 0;
+static uint32_t results_copied    = 0;
+static uint32_t results_dropped   = 0;
+
+/**
+ * raise_app_data_irq() toggles the GPIO pin HUB is monitoring, see
+ * stream_spans_to_host_async(), and arms the latency timer while coalescing.
+ *
+ * @return None
+ */
+static void raise_app_data_irq(void)
+{
+	SET_GPIO_HIGH_TO_HOST_IRQ();
+	delay(1);
+	SET_GPIO_LOW_TO_HOST_IRQ();
+	irqs_raised++;
+
+	if (coalescing) {
+		sw_timer_start(&latency_timer, latency_ms, 0);
+	}
+}
+
+/**
+ * has_unread_results() tells if results are waiting for Host.
+ *
+ * @return true if the queue or the batch buffer holds results.
+ */
+static bool has_unread_results(void)
+{
+	return (0U != app_tx_queue_count) || (0U != batch_size);
+}
+
+/**
+ * app_tx_latency_expired() is the latency timer callback, raising the IRQ
+ * again for the results Host has left unread for latency_ms.
+ *
+ * @param ctx is unused.
+ *
+ * @return None
+ */
+static void app_tx_latency_expired(void *ctx)
+{
+	(void)ctx;
+
+	if (coalescing && has_unread_results() && (NULL == app_data_subscriber)) {
+		raise_app_data_irq();
+	}
+}
+
+/**
+ * queue_batch() queues the batch buffer, if it holds records and the queue
+ * has room.
+ *
+ * @return None
+ */
+static void queue_batch(void)
+{
+	struct app_tx_desc *p_desc;
+
+	if ((0U == batch_size) || batch_queued ||
+		(app_tx_queue_count >= APP_TX_QUEUE_DEPTH)) {
+		return;
+	}
+
+	p_desc = &app_tx_queue[(app_tx_queue_head + app_tx_queue_count) %
+						   APP_TX_QUEUE_DEPTH];
+
+	p_desc->spans[0].p_data = batch_buf;
+	p_desc->spans[0].size   = batch_size;
+	p_desc->num_spans       = 1;
+	p_desc->size            = batch_size;
+	p_desc->framed          = true;
+	p_desc->holds_ml_output = false;
+	p_desc->p_complete      = NULL;
+	p_desc->seq_num         = app_data_push_seq_num;
+	p_desc->queued_at       = pipeline_stats_now();
+	app_tx_queue_count++;
+
+	batch_queued = true;
+	batch_sealed = false;
+}
+
+/**
+ * set_app_tx_coalescing() turns the coalescing of the app data IRQs on or off.
+ * Turned off, the batch buffer still goes out once it has room in the queue.
+ *
+ * @param enable is true to coalesce.
+ * @param max_latency_ms is how often the IRQ is raised again while results
+ * are left unread, 0 for APP_DATA_COALESCE__DEFAULT_LATENCY_MS.
+ *
+ * @return Returns true if set, false if refused: a Host is subscribed with
+ * SUBSCRIBE_APP_DATA, which needs no IRQ.
+ */
+bool set_app_tx_coalescing(bool enable, uint32_t max_latency_ms)
+{
+	if (enable && (NULL != app_data_subscriber)) {
+		return false;
+	}
+
+	coalescing = enable;
+	latency_ms = (0U != max_latency_ms) ? max_latency_ms
+										: APP_DATA_COALESCE__DEFAULT_LATENCY_MS;
+
+	if (!coalescing) {
+		sw_timer_stop(&latency_timer);
+	} else if (has_unread_results()) {
+		sw_timer_start(&latency_timer, latency_ms, 0);
+	}
+
+	return true;
+}
+
+/**
+ * get_app_tx_coalescing_report() fills the setting in use and its counts in
+ * the APP_DATA_COALESCING response.
+ *
+ * @param p_resp is the response, its markers left to the caller.
+ *
+ * @return None
+ */
+void get_app_tx_coalescing_report(
+	struct _app_data_coalescing_response_unpked *p_resp)
+{
+	p_resp->enabled           = coalescing ? 1U : 0U;
+	p_resp->max_latency_ms    = latency_ms;
+	p_resp->irqs_raised       = irqs_raised;
+	p_resp->results_coalesced = results_coalesced;
+	p_resp->results_copied    = results_copied;
+	p_resp->results_dropped   = results_dropped;
+}
+
+/**
+ * app_tx_coalesce_result() copies a result the App Module queue has no room
+ * for in the batch buffer, as a record, while coalescing. The batch buffer
+ * must not be going out in a fetch already.
+ *
+ * @param p_spans points to the pieces of the result, in order.
+ * @param count_of_spans is the number of pieces.
+ *
+ * @return Returns true if copied, false if the result is to be dropped.
+ */
+bool app_tx_coalesce_result(const struct tx_span *p_spans,
+							uint32_t              count_of_spans)
+{
+	struct app_tx_desc *p_desc = NULL;
+	uint32_t            size   = 0;
+	uint32_t            idx;
+
+	if (!coalescing) {
+		return false;
+	}
+
+	if (batch_queued) {
+		// Only the newest entry can grow, results stay in order.
+		p_desc = &app_tx_queue[(app_tx_queue_head + app_tx_queue_count - 1U) %
+							   APP_TX_QUEUE_DEPTH];
+		if (batch_sealed || !p_desc->framed) {
+			return false;
+		}
+	}
+
+	for (idx = 0; idx < count_of_spans; idx++) {
+		size += p_spans[idx].size;
+	}
+	if ((sizeof(size) + size) > (sizeof(batch_buf) - batch_size)) {
+		return false;
+	}
+
+	memcpy(&batch_buf[batch_size], &size, sizeof(size));
+	batch_size += sizeof(size);
+	for (idx = 0; idx < count_of_spans; idx++) {
+		memcpy(&batch_buf[batch_size], p_spans[idx].p_data, p_spans[idx].size);
+		batch_size += p_spans[idx].size;
+	}
+
+	if (NULL != p_desc) {
+		p_desc->spans[0].size = batch_size;
+		p_desc->size          = batch_size;
+	}
+	results_copied++;
+
+	return true;
+}
+
+/**
+ * app_tx_notify_host() raises the app data IRQ for a result just queued or
+ * copied. While coalescing, it is not raised if results were left unread
+ * before: Host takes them all with the fetch of the IRQ raised for the first.
+ *
+ * @param unread_before is true if results were waiting for Host before.
+ *
+ * @return None
+ */
+void app_tx_notify_host(bool unread_before)
+{
+	if (coalescing && unread_before) {
+		results_coalesced++;
+		return;
+	}
+
+	/**
+	 * Without coalescing, the host IRQ is raised even if the queue is full: a
+	 * HUB that has missed the earlier ones (e.g. started late) then still
+	 * drains the queue.
+	 */
+	raise_app_data_irq();
+}
+
+/**
+ * app_tx_coalesce_dropped() counts a result neither queued nor copied.
+ *
+ * @return None
+ */
+void app_tx_coalesce_dropped(void)
+{
+	results_dropped++;
+}
+
+/**
+ * app_tx_coalesce_sealed() stops results from being added to the batch
+ * buffer queued, once it goes out in a fetch, so that its size is the one
+ * sent.
+ *
+ * @return None
+ */
+void app_tx_coalesce_sealed(void)
+{
+	batch_sealed = true;
+}
+
+/**
+ * app_tx_coalesce_fetched() is called once results are taken off the queue.
+ * The batch buffer is freed if it was among them, else queued if it waits
+ * for room, and the IRQ is raised again if results are left: they came while
+ * Host was fetching, and make the next batch.
+ *
+ * @param was_batch is true if the batch buffer was taken.
+ *
+ * @return None
+ */
+void app_tx_coalesce_fetched(bool was_batch)
+{
+	if (was_batch) {
+		batch_size   = 0;
+		batch_queued = false;
+		batch_sealed = false;
+	}
+	queue_batch();
+
+	if (!coalescing || (NULL != app_data_subscriber)) {
+		return;
+	}
+
+	if (has_unread_results()) {
+		raise_app_data_irq();
+	} else {
+		sw_timer_stop(&latency_timer);
+	}
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef APP_TX_COALESCE_H
+#define APP_TX_COALESCE_H
+
+#include "gard_types.h"
+#include "fw_core.h"
+#include "gard_hub_iface_unpacked.h"
+
+/**
+ * This file defines the coalescing of the app data IRQs set with
+ * APP_DATA_COALESCING. While Host has results left unread, further results
+ * raise no IRQ and are taken with the same batch fetch; those the App Module
+ * queue has no room for are copied in a batch buffer, queued as one entry of
+ * records already framed for CC_APP_DATA_BATCH, see app_tx_desc.framed.
+ */
+
+/**
+ * set_app_tx_coalescing() turns the coalescing on or off, see
+ * APP_DATA_COALESCING. It returns false if the setting is refused.
+ */
+bool set_app_tx_coalescing(bool enable, uint32_t max_latency_ms);
+
+/**
+ * get_app_tx_coalescing_report() fills the setting in use and its counts in
+ * the APP_DATA_COALESCING response, leaving the markers to the caller.
+ */
+void get_app_tx_coalescing_report(
+	struct _app_data_coalescing_response_unpked *p_resp);
+
+/**
+ * app_tx_coalesce_result() is called by stream_spans_to_host_async() with a
+ * result the queue has no room for. It returns true if the result is copied
+ * in the batch buffer, false if it is to be dropped.
+ */
+bool app_tx_coalesce_result(const struct tx_span *p_spans,
+							uint32_t              count_of_spans);
+
+/**
+ * app_tx_notify_host() raises the app data IRQ for a result just queued,
+ * unless coalescing and results queued before it are still unread.
+ */
+void app_tx_notify_host(bool unread_before);
+
+/**
+ * app_tx_coalesce_dropped() counts a result neither queued nor copied.
+ */
+void app_tx_coalesce_dropped(void);
+
+/**
+ * app_tx_coalesce_sealed() is called once the batch buffer queued goes out
+ * in a fetch; no result is added to it from then on.
+ */
+void app_tx_coalesce_sealed(void);
+
+/**
+ * app_tx_coalesce_fetched() is called once a fetch has taken results off the
+ * queue, with was_batch set if the batch buffer was among them. It queues the
+ * batch buffer waiting for room and raises the IRQ again for the results left.
+ */
+void app_tx_coalesce_fetched(bool was_batch);
+
+#endif /* APP_TX_COALESCE_H */
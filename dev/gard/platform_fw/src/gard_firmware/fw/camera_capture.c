@@ -17,6 +17,14 @@
 #include "app_module.h"
 #include "ml_ops.h"
 #include "pipeline_ops.h"
+#include "pipeline_stats.h"
+#include "trace_pins.h"
+#include "image_stats.h"
+#include "roi_batch.h"
+#include "utils.h"
+#include "snapshot_codec.h"
+#include "irq_support.h"
+#include "inference_rate.h"
 
 /**
  * TBD-SRP: Remove these values when they come from the camera configuration
@@ -34,7 +42,8 @@
 
 #ifdef ML_APP_MOD
 /**
- * Box scaler configuration parameters for ML_APP_MOD
+ * Default box scaler configuration parameters for ML_APP_MOD, see
+ * set_scaler_config().
  * Input 3280 x 2464 at 30fps with 4 lanes.
  * Output 384 x 288.
  */
@@ -46,7 +55,7 @@
 #define BOX_SCALER_FACTOR_X           2
 
 /**
- * Bilinear scaler capture configuration parameters for ML_APP_MOD
+ * Default bilinear scaler capture configuration parameters for ML_APP_MOD
  *
  */
 #define BL_SCALER_CROP_LEFT           0
@@ -63,46 +72,364 @@
 	(BL_SCALER_CROP_OUT_HEIGHT * BL_SCALER_CROP_OUT_WIDTH)
 
 /**
- * Bilinear scaler rescale configuration parameters for ML_APP_MOD
+ * Bilinear scaler rescale configuration parameters for ML_APP_MOD: the
+ * captured image is scaled to the network input size.
  *
  */
-#define BL_SCALER_RESCALE_CROP_LEFT      0
-#define BL_SCALER_RESCALE_CROP_RIGHT     384
-#define BL_SCALER_RESCALE_CROP_UPPER     0
-#define BL_SCALER_RESCALE_CROP_BOTTOM    288
-#define BL_SCALER_RESCALE_CROP_IN_HEIGHT 288
-#define BL_SCALER_RESCALE_CROP_IN_WIDTH  384
-#define BL_SCALER_RESCALE_CROP_IN_SIZE                                         \
-	(BL_SCALER_RESCALE_CROP_IN_HEIGHT * BL_SCALER_RESCALE_CROP_IN_WIDTH)
 #define BL_SCALER_RESCALE_CROP_OUT_HEIGHT 288
 #define BL_SCALER_RESCALE_CROP_OUT_WIDTH  384
 #define BL_SCALER_RESCALE_CROP_OUT_SIZE                                        \
 	(BL_SCALER_RESCALE_CROP_OUT_HEIGHT * BL_SCALER_RESCALE_CROP_OUT_WIDTH)
 
+/**
+ * The frame ring holds FRAME_RING_DEPTH captured images of
+ * FRAME_RING_SLOT_SIZE bytes each, RGB planar, from the pre-input buffer on.
+ * A grayscale image takes the first third of its buffer.
+ */
+#define FRAME_RING_SLOT_SIZE (3U * BL_SCALER_CROP_OUT_SIZE)
+
+#if (ML_APP_MOD_PREINPUT_START_ADDRESS_OFFSET +                               \
+	 (FRAME_RING_DEPTH * FRAME_RING_SLOT_SIZE)) > HRAM_ML_IO_SIZE
+#error "The frame ring does not fit in the ML IO region"
 #endif
 
 /**
- * capture_image_async() is used by the App Module to start capturing the image
- * from the connected camera. The function assumes that the camera is already
- * initialized and ready to capture images
- * Note: Capturing an image involves:
- * 1) Capturing and scaling the feed.
- * 2) If ML engine is the destination for holding the image then we move the
- * image to the buffer within ML engine.
+ * The snapshot buffer holds a copy of a rescaled image for Host, right after
+ * the frame ring, see snapshot_rescaled_image_async(). The whole image is
+ * copied SNAPSHOT_COPY_SLICE bytes per pass of the main loop, a part of it or
+ * an encoded one SNAPSHOT_ENCODE_ROWS rows per pass. SNAPSHOT_BUFFER_SIZE
+ * holds the image whatever the encoding.
+ */
+#define SNAPSHOT_SIZE        (capture_planes * BL_SCALER_RESCALE_CROP_OUT_SIZE)
+#define SNAPSHOT_BUFFER_SIZE                                                   \
+	(3U * BL_SCALER_RESCALE_CROP_OUT_HEIGHT *                                  \
+	 SNAPSHOT_CODEC_MAX_ROW_SIZE(BL_SCALER_RESCALE_CROP_OUT_WIDTH))
+#define SNAPSHOT_ADDRESS                                                       \
+	(ML_APP_1_PREINPUT_START_ADDRESS + (FRAME_RING_DEPTH * FRAME_RING_SLOT_SIZE))
+#define SNAPSHOT_COPY_SLICE  (16U * 1024U)
+#define SNAPSHOT_ENCODE_ROWS (8U)
+
+#if (ML_APP_MOD_PREINPUT_START_ADDRESS_OFFSET +                               \
+	 (FRAME_RING_DEPTH * FRAME_RING_SLOT_SIZE) + SNAPSHOT_BUFFER_SIZE) >      \
+	HRAM_ML_IO_SIZE
+#error "The snapshot buffer does not fit in the ML IO region"
+#endif
+
+/**
+ * The images Host runs the ML engine on are written to the frame ring buffers
+ * past the capture buffer, see submit_host_input(), so the continuous capture
+ * is not available meanwhile.
+ */
+#define HOST_INPUT_SLOT_ADDRESS(slot)                                          \
+	(ML_APP_1_PREINPUT_START_ADDRESS + (((slot) + 1U) * FRAME_RING_SLOT_SIZE))
+
+#if (HOST_INFERENCE__SLOTS + 1U) > FRAME_RING_DEPTH
+#error "The Host input slots do not fit in the frame ring"
+#endif
+
+#endif
+
+/**
+ * The state of a capture buffer of the frame ring, see
+ * set_continuous_capture().
+ */
+enum frame_slot_state {
+	FRAME_SLOT__FREE      = 0, // Can be captured into
+	FRAME_SLOT__CAPTURING = 1, // The capture in flight writes to it
+	FRAME_SLOT__READY     = 2, // Holds an image waiting to be rescaled
+	FRAME_SLOT__IN_USE    = 3, // Holds the image last rescaled, for the ROIs
+};
+
+struct frame_slot {
+	uint32_t              address;
+	uint32_t              seq;
+	uint64_t              capture_tsc;
+	enum frame_slot_state state;
+};
+
+/**
+ * The state of the copy of a rescaled image for Host, see
+ * snapshot_rescaled_image_async().
+ */
+enum snapshot_state {
+	SNAPSHOT__IDLE      = 0, // No snapshot requested
+	SNAPSHOT__REQUESTED = 1, // The next rescaled image is to be copied
+	SNAPSHOT__COPYING   = 2, // The ML engine input is being copied
+	SNAPSHOT__READY     = 3, // The snapshot buffer can be read by Host
+};
+
+/* Start the next capture right after the rescale, see set_capture_ahead(). */
+static bool capture_ahead = false;
+
+/* Let the capture free-run into the frame ring, see set_continuous_capture() */
+static bool continuous_capture = false;
+
+/**
+ * capture_format is the format of the captured and rescaled images and
+ * capture_planes their count of planes, see set_capture_format().
+ */
+static enum image_formats capture_format = IMAGE_FORMAT__RGB_PLANAR;
+static uint32_t           capture_planes = 3U;
+
+/**
+ * next_frame_seq numbers the next captured image, capturing_seq the one in
+ * flight and frame_seq the one last rescaled, see get_frame_sequence().
+ * capturing_tsc and frame_capture_tsc are the CPU TSC at which the capture of
+ * those two started, see get_frame_capture_time().
+ */
+static uint32_t next_frame_seq    = 0;
+static uint32_t capturing_seq     = 0;
+static uint32_t frame_seq         = 0;
+static uint64_t capturing_tsc     = 0;
+static uint64_t frame_capture_tsc = 0;
+
+#ifdef ML_APP_MOD
+static enum frame_ring_policy ring_policy = FRAME_RING_POLICY__LATEST_WINS;
+static struct frame_slot      frame_ring[FRAME_RING_DEPTH];
+
+/**
+ * capturing_slot is the frame_ring[] index the capture in flight writes to.
+ * capture_address is the buffer that capture writes to and captured_address
+ * the one holding the image last rescaled, where the ROIs are cropped from.
+ */
+static uint32_t capturing_slot   = 0;
+static uint32_t capture_address  = ML_APP_1_PREINPUT_START_ADDRESS;
+static uint32_t captured_address = ML_APP_1_PREINPUT_START_ADDRESS;
+
+/**
+ * capture_prearmed is set while the capture buffer holds an image captured
+ * with the pipeline paused, to be rescaled on resume, see
+ * prearm_capture_on_pause().
+ */
+static bool capture_prearmed = false;
+
+/**
+ * scaler_active is the scaler configuration the captures use and
+ * scaler_pending the one last set, applied by capture_next_image() when
+ * scaler_update_pending. captured_width and captured_height are the size of
+ * the image at captured_address.
+ */
+static struct scaler_config scaler_active = {
+	.precrop_left   = CAMERA_CAPTURE_PRECROP_LEFT,
+	.precrop_right  = CAMERA_CAPTURE_PRECROP_RIGHT,
+	.precrop_upper  = CAMERA_CAPTURE_PRECROP_UPPER,
+	.precrop_bottom = CAMERA_CAPTURE_PRECROP_BOTTOM,
+	.box_factor_x   = BOX_SCALER_FACTOR_X,
+	.box_factor_y   = BOX_SCALER_FACTOR_Y,
+	.crop_left      = BL_SCALER_CROP_LEFT,
+	.crop_right     = BL_SCALER_CROP_RIGHT,
+	.crop_upper     = BL_SCALER_CROP_UPPER,
+	.crop_bottom    = BL_SCALER_CROP_BOTTOM,
+	.crop_in_width  = BL_SCALER_CROP_IN_WIDTH,
+	.crop_in_height = BL_SCALER_CROP_IN_HEIGHT,
+	.out_width      = BL_SCALER_CROP_OUT_WIDTH,
+	.out_height     = BL_SCALER_CROP_OUT_HEIGHT,
+};
+static struct scaler_config scaler_pending;
+static bool                 scaler_update_pending = false;
+static uint16_t             captured_width        = BL_SCALER_CROP_OUT_WIDTH;
+static uint16_t             captured_height       = BL_SCALER_CROP_OUT_HEIGHT;
+
+/**
+ * The snapshot for Host: its part of the image, clipped to it, its width and
+ * height once decimated, the bytes of it written so far, the plane and row of
+ * the image encoded next, and the sequence number and capture start time of
+ * the image it is made from.
+ */
+static enum snapshot_state    snapshot_state = SNAPSHOT__IDLE;
+static struct snapshot_format snapshot_fmt;
+static uint32_t               snapshot_width  = 0;
+static uint32_t               snapshot_height = 0;
+static uint32_t               snapshot_copied = 0;
+static uint32_t               snapshot_plane  = 0;
+static uint32_t               snapshot_row    = 0;
+static uint32_t               snapshot_seq    = 0;
+static uint64_t               snapshot_tsc    = 0;
+
+/**
+ * A Host input slot, see submit_host_input(): FREE for Host to write, READY
+ * once submitted and IN_USE once rescaled, as the ROIs are cropped from it,
+ * until the next image is rescaled. order numbers the submissions, the oldest
+ * image is run first.
+ */
+struct host_input_slot {
+	uint16_t              width;
+	uint16_t              height;
+	uint32_t              seq;
+	uint32_t              order;
+	uint64_t              submit_tsc;
+	enum frame_slot_state state;
+};
+
+/**
+ * host_input_active is set while the ML engine runs on the images of Host
+ * instead of the camera ones, and host_input_wanted while the App Module
+ * waits for the next of them, see continue_host_input().
+ */
+static bool                   host_input_active  = false;
+static bool                   host_input_wanted  = false;
+static uint32_t               host_input_submits = 0;
+static struct host_input_slot host_input[HOST_INFERENCE__SLOTS];
+
+/**
+ * pick_capture_slot() picks the frame ring buffer the next capture writes to.
+ * A free buffer is taken first. With FRAME_RING_POLICY__LATEST_WINS the
+ * oldest image waiting to be rescaled is dropped when there is none.
  *
- * Note: The routine only starts the camera capture process. The completely
- * captured image will be available after some time, hence the name of the
- * routine has '_async' postfixed to indicate this.
+ * @param p_slot receives the frame_ring[] index of the buffer.
  *
- * @return Nothing
+ * @return true if a buffer was picked, false if the ring is full.
  */
-void capture_image_async(void)
+static bool pick_capture_slot(uint32_t *p_slot)
+{
+	bool     found = false;
+	uint32_t idx;
+
+	for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+		if (FRAME_SLOT__FREE == frame_ring[idx].state) {
+			*p_slot = idx;
+			return true;
+		}
+	}
+
+	if (FRAME_RING_POLICY__LATEST_WINS != ring_policy) {
+		return false;
+	}
+
+	for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+		if ((FRAME_SLOT__READY == frame_ring[idx].state) &&
+			(!found || ((int32_t)(frame_ring[idx].seq -
+								  frame_ring[*p_slot].seq) < 0))) {
+			*p_slot = idx;
+			found   = true;
+		}
+	}
+
+	return found;
+}
+
+/**
+ * pick_ready_slot() picks the image of the frame ring to be rescaled next,
+ * the newest or the oldest one waiting depending on the ring policy.
+ *
+ * @param p_slot receives the frame_ring[] index of the image.
+ *
+ * @return true if an image is waiting, false otherwise.
+ */
+static bool pick_ready_slot(uint32_t *p_slot)
+{
+	bool     found = false;
+	int32_t  age;
+	uint32_t idx;
+
+	for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+		if (FRAME_SLOT__READY != frame_ring[idx].state) {
+			continue;
+		}
+
+		if (found) {
+			age = (int32_t)(frame_ring[idx].seq - frame_ring[*p_slot].seq);
+			if ((FRAME_RING_POLICY__LATEST_WINS == ring_policy) ? (age < 0)
+																: (age > 0)) {
+				continue;
+			}
+		}
+
+		*p_slot = idx;
+		found   = true;
+	}
+
+	return found;
+}
+
+/**
+ * start_image_rescale() starts the rescale stage on a captured image, writing
+ * it to the ML engine input.
+ *
+ * @param address is the buffer holding the captured image.
+ * @param seq is the sequence number of the captured image.
+ * @param capture_tsc is the CPU TSC at which its capture started.
+ *
+ * @return None
+ */
+static void start_image_rescale(uint32_t address,
+								uint32_t seq,
+								uint64_t capture_tsc)
+{
+	setup_image_rescale_parameters();
+
+	GARD__SET_RESCALE_CONFIGS(address, ML_APP_1_INPUT_START_ADDRESS);
+
+	GARD__START_RESCALE_STAGE();
+	pipeline_stats_start(PIPELINE_STATS__RESCALE);
+
+	rescaling_started = true;
+	captured_address  = address;
+	captured_width    = scaler_active.out_width;
+	captured_height   = scaler_active.out_height;
+	frame_seq         = seq;
+	frame_capture_tsc = capture_tsc;
+}
+
+/**
+ * is_captured_image_waiting() tells if a captured image waits to be rescaled,
+ * with the scaler configuration it was captured with.
+ *
+ * @return true if an image waits in the frame ring or the capture buffer.
+ */
+static bool is_captured_image_waiting(void)
+{
+	uint32_t idx;
+
+	if (capture_prearmed) {
+		return true;
+	}
+
+	for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+		if (FRAME_SLOT__READY == frame_ring[idx].state) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+/**
+ * capture_next_image() starts the capture of the next image, into the frame
+ * ring buffer picked for it with the continuous capture.
+ *
+ * @return None
+ */
+static void capture_next_image(void)
 {
+#ifdef ML_APP_MOD
+	/* The next image comes from Host, see continue_host_input(). */
+	if (host_input_active) {
+		host_input_wanted = true;
+		return;
+	}
+#endif
+
 	if (!camera_started) {
 		/* Nothing to do if camera is not connected. */
 		return;
 	}
 
+	if (capture_started || rescaling_started) {
+		/* The capture of the next image is already in flight. */
+		return;
+	}
+
+	if (is_roi_batch_active()) {
+		/* The ROIs of the batch are cropped from the capture buffer. */
+		defer_capture_after_roi_batch();
+		return;
+	}
+
+	/* The sensor streams again, see INFERENCE_RATE__DUTY_CYCLE. */
+	inference_rate_wake_camera();
+
 	/**
 	 * First we setup the buffers to capture the image.
 	 * Next we start the camera capturing and rescaling process.
@@ -110,38 +437,144 @@ void capture_image_async(void)
 #ifdef ML_APP_HMI
 	GARD__SETUP_SCALER_ENGINE_BUFFERS();
 #elif defined(ML_APP_MOD)
+	if (continuous_capture) {
+		/* Nothing to do if all the frame ring images wait to be run. */
+		if (!pick_capture_slot(&capturing_slot)) {
+			return;
+		}
+
+		frame_ring[capturing_slot].state = FRAME_SLOT__CAPTURING;
+		capture_address                  = frame_ring[capturing_slot].address;
+	} else {
+		capture_address = ML_APP_1_PREINPUT_START_ADDRESS;
+	}
+
+	/**
+	 * A new scaler configuration is taken at a frame boundary, once the
+	 * images captured with the previous one have been rescaled.
+	 */
+	if (scaler_update_pending && !is_captured_image_waiting()) {
+		scaler_active         = scaler_pending;
+		scaler_update_pending = false;
+	}
+
 	/* Capture Config : capture buffer address for ML_APP_MOD, rgbs capture
 	 */
 	setup_camera_capture_parameters();
 
-	GARD__SET_CAPTURE_CONFIGS(ML_APP_1_PREINPUT_START_ADDRESS);
+	GARD__SET_CAPTURE_CONFIGS(capture_address);
 #endif
 
-	/* GPIO Index 1 tracks Camera Capture events
-	 * GPIO Index 2 tracks all events : Capture, Rescale, data movement to ML
-	 * engine and ML engine start/stop
-	 */
-	gpio_pin_write(&gpio_0, GPIO_PIN_1, GPIO_OUTPUT_HIGH);
+	capturing_seq = next_frame_seq++;
+	capturing_tsc = get_cpu_tsc();
+
+	TRACE_BEGIN(CAPTURE);
 
-	gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_HIGH);
+	/**
+	 * A frame is timed from one capture start to the next, or from one
+	 * rescale start to the next with the continuous capture.
+	 */
+	if (!continuous_capture) {
+		pipeline_stats_mark(PIPELINE_STATS__FRAME);
+	}
 
 	/**
 	 * Start Capture and rescaling process.
 	 */
 #ifdef ML_APP_HMI
+	/* The scaler engine captures and rescales in one go. */
 	GARD__START_SCALER_ENGINE();
+	pipeline_stats_start(PIPELINE_STATS__RESCALE);
 
-#ifdef NO_RESCALE_DONE_ISR
 	rescaling_started = true;
-#endif
 
 #elif defined(ML_APP_MOD)
 	GARD__START_CAPTURE_STAGE();
+	pipeline_stats_start(PIPELINE_STATS__CAPTURE);
 
 	capture_started = true;
 #endif
 }
 
+/**
+ * capture_image_async() is used by the App Module to start capturing the image
+ * from the connected camera. The function assumes that the camera is already
+ * initialized and ready to capture images
+ * Note: Capturing an image involves:
+ * 1) Capturing and scaling the feed.
+ * 2) If ML engine is the destination for holding the image then we move the
+ * image to the buffer within ML engine.
+ *
+ * Note: The routine only starts the camera capture process. The completely
+ * captured image will be available after some time, hence the name of the
+ * routine has '_async' postfixed to indicate this.
+ *
+ * @return Nothing
+ */
+void capture_image_async(void)
+{
+	/* The capture free-runs, see continue_continuous_capture(). */
+	if (continuous_capture) {
+		return;
+	}
+
+	/* The image is not due yet, see INFERENCE_RATE__DUTY_CYCLE. */
+	if (inference_rate_hold_capture()) {
+		return;
+	}
+
+	capture_next_image();
+}
+
+#ifdef ML_APP_MOD
+/**
+ * prearm_capture_on_pause() starts the capture of the next image as soon as
+ * the pipeline pauses on a rescaled image. The capture buffer is not the ML
+ * engine input Host reads, so the capture runs while Host reads the image and
+ * the pipeline resumes with the rescale of an image that is already captured,
+ * see start_prearmed_capture(). The resumed frame is as old as the pause.
+ *
+ * @return None
+ */
+static void prearm_capture_on_pause(void)
+{
+	if (continuous_capture || host_input_active ||
+		(PIPELINE_STAGE_RESCALE_DONE != ml_pipeline_paused_at)) {
+		return;
+	}
+
+	capture_next_image();
+}
+#endif
+
+/**
+ * start_prearmed_capture() rescales the image captured while the pipeline was
+ * paused, see prearm_capture_on_pause(), so that resuming does not wait for a
+ * whole capture.
+ *
+ * @return true if the rescale of the image was started, false if there is
+ *         none or the pipeline is busy.
+ */
+bool start_prearmed_capture(void)
+{
+#ifdef ML_APP_MOD
+	if (!capture_prearmed) {
+		return false;
+	}
+
+	capture_prearmed = false;
+	if (capture_started || rescaling_started || ml_engine_started ||
+		is_roi_batch_active()) {
+		return false;
+	}
+
+	start_image_rescale(capture_address, capturing_seq, capturing_tsc);
+	return true;
+#else
+	return false;
+#endif
+}
+
 /**
  * setup_camera_capture_parameters() sets up the camera capture parameters such
  * as input image dimensions, crop dimensions, and output image dimensions.
@@ -167,22 +600,29 @@ void setup_camera_capture_parameters(void)
 	GARD__STOP_CAPTURE_STAGE();
 	GARD__STOP_RESCALE_STAGE();
 
-	/* Box Scaler Config : input image 960x1080, crop 0,960,0,1080
-	 * output 480*270 grayscale
+	/* Mini-ISP Config : a single luminance plane in grayscale, see
+	 * set_capture_format().
+	 */
+	GARD__SET_MISP_GRAYSCALE(IMAGE_FORMAT__GRAYSCALE == capture_format);
+
+	/* Box Scaler Config : precrop window of the sensor image, divided by
+	 * the box factors, see set_scaler_config().
 	 */
 	GARD__SET_BOX_SCALER_CONFIGS(
-		CAMERA_CAPTURE_PRECROP_LEFT, CAMERA_CAPTURE_PRECROP_RIGHT,
-		CAMERA_CAPTURE_PRECROP_UPPER, CAMERA_CAPTURE_PRECROP_BOTTOM,
-		BOX_SCALER_FACTOR_Y, BOX_SCALER_FACTOR_X);
+		scaler_active.precrop_left, scaler_active.precrop_right,
+		scaler_active.precrop_upper, scaler_active.precrop_bottom,
+		scaler_active.box_factor_y, scaler_active.box_factor_x);
 
-	/* Bilinear Scaler Config : input image 480x270, scaled output 256*144
+	/* Bilinear Scaler Config : crop of the box scaler output, scaled to the
+	 * captured image size.
 	 */
 	GARD__SET_BILINEAR_SCALER_CONFIGS(
-		BL_SCALER_CROP_LEFT, BL_SCALER_CROP_RIGHT, BL_SCALER_CROP_UPPER,
-		BL_SCALER_CROP_BOTTOM, BL_SCALER_CROP_IN_HEIGHT,
-		BL_SCALER_CROP_IN_WIDTH, BL_SCALER_CROP_IN_SIZE,
-		BL_SCALER_CROP_OUT_HEIGHT, BL_SCALER_CROP_OUT_WIDTH,
-		BL_SCALER_CROP_OUT_SIZE);
+		scaler_active.crop_left, scaler_active.crop_right,
+		scaler_active.crop_upper, scaler_active.crop_bottom,
+		scaler_active.crop_in_height, scaler_active.crop_in_width,
+		(uint32_t)scaler_active.crop_in_height * scaler_active.crop_in_width,
+		scaler_active.out_height, scaler_active.out_width,
+		(uint32_t)scaler_active.out_height * scaler_active.out_width);
 
 #endif
 }
@@ -201,15 +641,98 @@ void setup_image_rescale_parameters(void)
 	 * image dimensions, crop dimensions, and output image dimensions.
 	 */
 #ifdef ML_APP_MOD
-	/* Bilinear Scaler Config : input image 256x144, scaled output 256*144
+	/* Bilinear Scaler Config : the whole captured image, scaled to the
+	 * network input size.
 	 */
 	GARD__SET_BILINEAR_SCALER_CONFIGS(
-		BL_SCALER_RESCALE_CROP_LEFT, BL_SCALER_RESCALE_CROP_RIGHT,
-		BL_SCALER_RESCALE_CROP_UPPER, BL_SCALER_RESCALE_CROP_BOTTOM,
-		BL_SCALER_RESCALE_CROP_IN_HEIGHT, BL_SCALER_RESCALE_CROP_IN_WIDTH,
-		BL_SCALER_RESCALE_CROP_IN_SIZE, BL_SCALER_RESCALE_CROP_OUT_HEIGHT,
-		BL_SCALER_RESCALE_CROP_OUT_WIDTH, BL_SCALER_RESCALE_CROP_OUT_SIZE);
+		0, scaler_active.out_width, 0, scaler_active.out_height,
+		scaler_active.out_height, scaler_active.out_width,
+		(uint32_t)scaler_active.out_height * scaler_active.out_width,
+		BL_SCALER_RESCALE_CROP_OUT_HEIGHT, BL_SCALER_RESCALE_CROP_OUT_WIDTH,
+		BL_SCALER_RESCALE_CROP_OUT_SIZE);
+
+#endif
+}
+
+/**
+ * set_scaler_config() validates a scaler configuration and has it applied by
+ * capture_next_image() from the first capture that starts with no image
+ * captured with the previous configuration waiting to be rescaled. The
+ * precrop window has to be within the default one, the windows not empty and
+ * the captured image has to fit a frame ring buffer. The captured image is
+ * always rescaled to the network input size.
+ *
+ * @param p_config is the configuration to apply.
+ *
+ * @return true if the configuration is taken, false if it is not valid or the
+ *         pipeline does not support it.
+ */
+bool set_scaler_config(const struct scaler_config *p_config)
+{
+#ifdef ML_APP_MOD
+	uint32_t irq_state;
+
+	if ((p_config->precrop_left >= p_config->precrop_right) ||
+		(p_config->precrop_upper >= p_config->precrop_bottom) ||
+		(p_config->precrop_left < CAMERA_CAPTURE_PRECROP_LEFT) ||
+		(p_config->precrop_right > CAMERA_CAPTURE_PRECROP_RIGHT) ||
+		(p_config->precrop_upper < CAMERA_CAPTURE_PRECROP_UPPER) ||
+		(p_config->precrop_bottom > CAMERA_CAPTURE_PRECROP_BOTTOM)) {
+		return false;
+	}
+
+	if ((0 == p_config->box_factor_x) || (0 == p_config->box_factor_y)) {
+		return false;
+	}
+
+	if ((p_config->crop_left >= p_config->crop_right) ||
+		(p_config->crop_upper >= p_config->crop_bottom) ||
+		(p_config->crop_right > p_config->crop_in_width) ||
+		(p_config->crop_bottom > p_config->crop_in_height)) {
+		return false;
+	}
+
+	if ((0 == p_config->out_width) || (0 == p_config->out_height) ||
+		((capture_planes * p_config->out_width * p_config->out_height) >
+		 FRAME_RING_SLOT_SIZE)) {
+		return false;
+	}
+
+	irq_state             = irq_save();
+	scaler_pending        = *p_config;
+	scaler_update_pending = true;
+	irq_restore(irq_state);
+
+	return true;
+#else
+	(void)p_config;
+
+	return false;
+#endif
+}
+
+/**
+ * get_scaler_config() returns the scaler configuration last set, and whether
+ * the captures use it yet.
+ *
+ * @param p_config receives the configuration.
+ * @param p_applied receives false while the configuration waits for a frame
+ *        boundary to be applied.
+ *
+ * @return None
+ */
+void get_scaler_config(struct scaler_config *p_config, bool *p_applied)
+{
+#ifdef ML_APP_MOD
+	uint32_t irq_state;
 
+	irq_state  = irq_save();
+	*p_applied = !scaler_update_pending;
+	*p_config  = scaler_update_pending ? scaler_pending : scaler_active;
+	irq_restore(irq_state);
+#else
+	memset(p_config, 0, sizeof(*p_config));
+	*p_applied = false;
 #endif
 }
 
@@ -226,6 +749,10 @@ void setup_image_rescale_parameters(void)
 void capture_done_isr(void *ctxt)
 {
 #if defined(ML_APP_MOD)
+	pipeline_stats_end(PIPELINE_STATS__CAPTURE);
+	image_stats_record(capturing_seq);
+	inference_rate_capture_done();
+
 	/* Clear capture and rescale stage done status bits
 	 */
 	GARD__STOP_CAPTURE_STAGE();
@@ -233,20 +760,75 @@ void capture_done_isr(void *ctxt)
 
 	/* Allow pause controller to halt the pipeline after capture if requested.
 	 */
+	/**
+	 * With the continuous capture the image waits in the frame ring, to be
+	 * rescaled by continue_continuous_capture().
+	 */
+	if (continuous_capture &&
+		(FRAME_SLOT__CAPTURING == frame_ring[capturing_slot].state)) {
+		frame_ring[capturing_slot].seq         = capturing_seq;
+		frame_ring[capturing_slot].capture_tsc = capturing_tsc;
+		frame_ring[capturing_slot].state       = FRAME_SLOT__READY;
+	}
+
 	pipeline_stage_completed(PIPELINE_STAGE_CAPTURE_DONE);
 	if (PIPELINE_PAUSED == ml_pipeline_state) {
+		/* Rescaled on resume, see start_prearmed_capture(). */
+		capture_prearmed = !continuous_capture;
+		return;
+	}
+
+	if (continuous_capture) {
 		return;
 	}
 
 	/* start rescale stage */
-	setup_image_rescale_parameters();
+	start_image_rescale(capture_address, capturing_seq, capturing_tsc);
+#endif
+}
 
-	GARD__SET_RESCALE_CONFIGS(ML_APP_1_PREINPUT_START_ADDRESS,
-							  ML_APP_1_INPUT_START_ADDRESS);
+/**
+ * start_roi_rescale() starts the rescale stage on an ROI of the image held in
+ * the capture buffer, see run_network_on_rois_async(). The rescale stage is
+ * set up again for the full image by the next capture.
+ *
+ * @param p_roi is the ROI to rescale, within the captured image.
+ * @param out_width is the width in pixels the ROI is rescaled to.
+ * @param out_height is the height in pixels the ROI is rescaled to.
+ * @param out_address is where the rescaled ROI is written.
+ *
+ * @return true if the rescale was started, false if the ROI is not within the
+ *         captured image or the pipeline does not support it.
+ */
+bool start_roi_rescale(const struct roi_box *p_roi,
+					   uint16_t              out_width,
+					   uint16_t              out_height,
+					   uint32_t              out_address)
+{
+#ifdef ML_APP_MOD
+	if ((p_roi->left >= p_roi->right) ||
+		(p_roi->right > captured_width) || (p_roi->upper >= p_roi->bottom) ||
+		(p_roi->bottom > captured_height)) {
+		return false;
+	}
+
+	GARD__STOP_RESCALE_STAGE();
+
+	GARD__SET_BILINEAR_SCALER_CONFIGS(
+		p_roi->left, p_roi->right, p_roi->upper, p_roi->bottom,
+		captured_height, captured_width,
+		(uint32_t)captured_height * captured_width, out_height, out_width,
+		(uint32_t)out_height * out_width);
+
+	GARD__SET_RESCALE_CONFIGS(captured_address, out_address);
 
 	GARD__START_RESCALE_STAGE();
 
 	rescaling_started = true;
+
+	return true;
+#else
+	return false;
 #endif
 }
 
@@ -263,9 +845,14 @@ void capture_done_isr(void *ctxt)
  */
 void rescaling_done_isr(void *ctxt)
 {
+	pipeline_stats_end(PIPELINE_STATS__RESCALE);
+
 #ifdef ML_APP_HMI
 	/* Clear capture start since process completed */
 	GARD__STOP_SCALER_ENGINE();
+	image_stats_record(capturing_seq);
+	frame_seq         = capturing_seq;
+	frame_capture_tsc = capturing_tsc;
 
 	/**
 	 * If rescaling is done, but the ML engine is still running then we cannot
@@ -287,7 +874,7 @@ void rescaling_done_isr(void *ctxt)
 	if (ml_engine_started) {
 		waiting_to_copy_image = true;
 	} else {
-		gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_HIGH);
+		TRACE_BEGIN(ML_COPY);
 
 		/**
 		 * Start the image movement from the rescaling engine to the ML engine.
@@ -307,8 +894,19 @@ void rescaling_done_isr(void *ctxt)
 	 */
 	pipeline_stage_completed(PIPELINE_STAGE_RESCALE_DONE);
 	if (PIPELINE_PAUSED == ml_pipeline_state) {
+		prearm_capture_on_pause();
 		return;
 	}
+
+	/* Copy the image out for Host, see snapshot_rescaled_image_async(). */
+	if (SNAPSHOT__REQUESTED == snapshot_state) {
+		snapshot_state  = SNAPSHOT__COPYING;
+		snapshot_copied = 0;
+		snapshot_plane  = 0;
+		snapshot_row    = 0;
+		snapshot_seq    = frame_seq;
+		snapshot_tsc    = frame_capture_tsc;
+	}
 #endif
 
 	if (auto_exposure_enabled) {
@@ -316,6 +914,362 @@ void rescaling_done_isr(void *ctxt)
 	}
 }
 
+/**
+ * set_capture_ahead() lets the FW Core start the capture of the next image as
+ * soon as the current one is rescaled, see fw_core.h.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, whose capture and rescale stages
+ * write to separate buffers, supports it. The captured image must not share
+ * the ML engine buffers with the results of the ML run it overlaps.
+ *
+ * @param enable is true to start the captures ahead, false to leave them to
+ *               the App Module.
+ *
+ * @return None
+ */
+void set_capture_ahead(bool enable)
+{
+#ifdef ML_APP_MOD
+	capture_ahead = enable;
+#endif
+}
+
+/**
+ * is_capture_ahead_enabled() tells if the next capture is to be started as
+ * soon as the current image is rescaled.
+ *
+ * @return true if captures are started ahead, false otherwise.
+ */
+bool is_capture_ahead_enabled(void)
+{
+	return capture_ahead;
+}
+
+/**
+ * set_continuous_capture() lets the capture free-run into the frame ring, see
+ * fw_core.h.
+ *
+ * @param enable is true to let the capture free-run, false to capture one
+ *               image per capture_image_async() call.
+ * @param policy tells which image of the frame ring is run next.
+ *
+ * @return true if the capture mode was set, false if a capture or rescale is
+ *         in flight, the ML engine runs on Host images or the pipeline does
+ *         not support it.
+ */
+bool set_continuous_capture(bool enable, enum frame_ring_policy policy)
+{
+#ifdef ML_APP_MOD
+	uint32_t idx;
+
+	if (capture_started || rescaling_started || host_input_active) {
+		return false;
+	}
+
+	for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+		frame_ring[idx].address = ML_APP_1_PREINPUT_START_ADDRESS +
+								  (idx * FRAME_RING_SLOT_SIZE);
+		frame_ring[idx].seq     = 0;
+		frame_ring[idx].state   = FRAME_SLOT__FREE;
+	}
+
+	continuous_capture = enable;
+	ring_policy        = policy;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * is_continuous_capture_enabled() tells if the capture free-runs into the
+ * frame ring.
+ *
+ * @return true if the capture free-runs, false otherwise.
+ */
+bool is_continuous_capture_enabled(void)
+{
+	return continuous_capture;
+}
+
+/**
+ * continue_continuous_capture() keeps the scaler busy when the capture
+ * free-runs. Once the capture in flight is done, the image picked from the
+ * frame ring is rescaled if the ML engine input is free, otherwise the next
+ * image is captured. The image rescaled before is kept until then, as the
+ * ROIs of run_network_on_rois_async() are cropped from it.
+ *
+ * @param ml_input_free is true if the ML engine is done with its input.
+ *
+ * @return true if a rescale or a capture was started, false otherwise.
+ */
+bool continue_continuous_capture(bool ml_input_free)
+{
+#ifdef ML_APP_MOD
+	uint32_t slot;
+	uint32_t idx;
+
+	if (!continuous_capture || !camera_started || capture_started ||
+		rescaling_started || is_roi_batch_active() ||
+		(PIPELINE_PAUSED == ml_pipeline_state)) {
+		return false;
+	}
+
+	if (ml_input_free && pick_ready_slot(&slot)) {
+		for (idx = 0; idx < FRAME_RING_DEPTH; idx++) {
+			if ((FRAME_SLOT__IN_USE == frame_ring[idx].state) ||
+				((FRAME_RING_POLICY__LATEST_WINS == ring_policy) &&
+				 (FRAME_SLOT__READY == frame_ring[idx].state))) {
+				/* The older images are dropped, the newest one wins. */
+				frame_ring[idx].state = FRAME_SLOT__FREE;
+			}
+		}
+		frame_ring[slot].state = FRAME_SLOT__IN_USE;
+
+		TRACE_BEGIN(RESCALE);
+		pipeline_stats_mark(PIPELINE_STATS__FRAME);
+
+		start_image_rescale(frame_ring[slot].address, frame_ring[slot].seq,
+							frame_ring[slot].capture_tsc);
+
+		return true;
+	}
+
+	capture_next_image();
+
+	return capture_started;
+#else
+	return false;
+#endif
+}
+
+/**
+ * submit_host_input() queues the image Host wrote to a Host input slot for
+ * the ML engine, see RUN_INFERENCE_ON_BUFFER. The first one stops the camera
+ * images: the images App Module asks for with capture_image_async() are then
+ * taken from the slots, the oldest submitted first, scaled to the network
+ * input, and numbered with the frame_id of Host.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, whose rescale stage reads the image
+ * from HRAM, supports it.
+ *
+ * @param slot is the Host input slot the image was written to.
+ * @param format is the format of the image, that of the captured images.
+ * @param width is the width of the image, in pixels.
+ * @param height is the height of the image, in pixels.
+ * @param frame_id is the frame sequence number of the results.
+ *
+ * @return true if the image is queued, false if the slot is not free, the
+ *         image does not fit it or is not in the capture format, or the
+ *         capture free-runs.
+ */
+bool submit_host_input(uint8_t            slot,
+					   enum image_formats format,
+					   uint16_t           width,
+					   uint16_t           height,
+					   uint32_t           frame_id)
+{
+#ifdef ML_APP_MOD
+	if ((slot >= HOST_INFERENCE__SLOTS) || (format != capture_format) ||
+		(0U == width) || (0U == height) ||
+		((capture_planes * width * height) > FRAME_RING_SLOT_SIZE) ||
+		(FRAME_SLOT__FREE != host_input[slot].state)) {
+		return false;
+	}
+
+	if (!host_input_active) {
+		if (continuous_capture) {
+			return false;
+		}
+
+		/* An idle pipeline waits for its next image. */
+		host_input_active = true;
+		host_input_wanted = !GARD__IS_PIPELINE_ACTIVE();
+	}
+
+	host_input[slot].width      = width;
+	host_input[slot].height     = height;
+	host_input[slot].seq        = frame_id;
+	host_input[slot].order      = host_input_submits++;
+	host_input[slot].submit_tsc = get_cpu_tsc();
+	host_input[slot].state      = FRAME_SLOT__READY;
+
+	return true;
+#else
+	(void)slot;
+	(void)format;
+	(void)width;
+	(void)height;
+	(void)frame_id;
+
+	return false;
+#endif
+}
+
+/**
+ * stop_host_input() drops the Host images waiting to be run and goes back to
+ * the camera images, see submit_host_input().
+ *
+ * @return None
+ */
+void stop_host_input(void)
+{
+#ifdef ML_APP_MOD
+	uint32_t idx;
+
+	if (!host_input_active) {
+		return;
+	}
+
+	/* The image last rescaled stays in use for the ROIs. */
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		if (FRAME_SLOT__READY == host_input[idx].state) {
+			host_input[idx].state = FRAME_SLOT__FREE;
+		}
+	}
+
+	host_input_active = false;
+	if (host_input_wanted) {
+		host_input_wanted = false;
+		capture_next_image();
+	}
+#endif
+}
+
+/**
+ * get_host_input_status() reports the Host input slots, see
+ * submit_host_input().
+ *
+ * @param p_status is filled with the slots and whether the ML engine runs on
+ *                 Host images.
+ *
+ * @return None
+ */
+void get_host_input_status(struct host_input_status *p_status)
+{
+	uint32_t idx;
+
+	memset(p_status, 0, sizeof(*p_status));
+
+#ifdef ML_APP_MOD
+	p_status->active    = host_input_active;
+	p_status->slot_size = FRAME_RING_SLOT_SIZE;
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		p_status->slot_address[idx] = HOST_INPUT_SLOT_ADDRESS(idx);
+		if (FRAME_SLOT__FREE == host_input[idx].state) {
+			p_status->free_slots |= (uint8_t)(1U << idx);
+		}
+	}
+#else
+	(void)idx;
+#endif
+}
+
+/**
+ * continue_host_input() rescales the oldest Host image submitted into the ML
+ * engine input, once the App Module asked for the next image and the ML
+ * engine is done with its input, see submit_host_input(). The slot of the
+ * image rescaled before is freed for Host.
+ *
+ * @param ml_input_free is true if the ML engine is done with its input.
+ *
+ * @return true if a rescale was started, false otherwise.
+ */
+bool continue_host_input(bool ml_input_free)
+{
+#ifdef ML_APP_MOD
+	struct host_input_slot *p_slot;
+	bool                    found = false;
+	uint32_t                slot  = 0;
+	uint32_t                idx;
+
+	if (!host_input_active || !host_input_wanted || !ml_input_free ||
+		capture_started || rescaling_started || is_roi_batch_active() ||
+		(PIPELINE_PAUSED == ml_pipeline_state)) {
+		return false;
+	}
+
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		if ((FRAME_SLOT__READY == host_input[idx].state) &&
+			(!found ||
+			 ((int32_t)(host_input[idx].order - host_input[slot].order) < 0))) {
+			slot  = idx;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		return false;
+	}
+
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		if (FRAME_SLOT__IN_USE == host_input[idx].state) {
+			host_input[idx].state = FRAME_SLOT__FREE;
+		}
+	}
+
+	p_slot            = &host_input[slot];
+	p_slot->state     = FRAME_SLOT__IN_USE;
+	host_input_wanted = false;
+
+	TRACE_BEGIN(RESCALE);
+	pipeline_stats_mark(PIPELINE_STATS__FRAME);
+
+	/* Bilinear Scaler Config : the whole Host image, scaled to the network
+	 * input size.
+	 */
+	GARD__STOP_RESCALE_STAGE();
+	GARD__SET_MISP_GRAYSCALE(IMAGE_FORMAT__GRAYSCALE == capture_format);
+	GARD__SET_BILINEAR_SCALER_CONFIGS(
+		0, p_slot->width, 0, p_slot->height, p_slot->height, p_slot->width,
+		(uint32_t)p_slot->height * p_slot->width,
+		BL_SCALER_RESCALE_CROP_OUT_HEIGHT, BL_SCALER_RESCALE_CROP_OUT_WIDTH,
+		BL_SCALER_RESCALE_CROP_OUT_SIZE);
+
+	GARD__SET_RESCALE_CONFIGS(HOST_INPUT_SLOT_ADDRESS(slot),
+							  ML_APP_1_INPUT_START_ADDRESS);
+
+	GARD__START_RESCALE_STAGE();
+	pipeline_stats_start(PIPELINE_STATS__RESCALE);
+
+	rescaling_started = true;
+	captured_address  = HOST_INPUT_SLOT_ADDRESS(slot);
+	captured_width    = p_slot->width;
+	captured_height   = p_slot->height;
+	frame_seq         = p_slot->seq;
+	frame_capture_tsc = p_slot->submit_tsc;
+
+	return true;
+#else
+	(void)ml_input_free;
+
+	return false;
+#endif
+}
+
+/**
+ * get_frame_sequence() returns the sequence number of the image last rescaled
+ * into the ML engine input, see fw_core.h.
+ *
+ * @return The sequence number of the image.
+ */
+uint32_t get_frame_sequence(void)
+{
+	return frame_seq;
+}
+
+/**
+ * get_frame_capture_time() returns the CPU TSC at which the capture of the
+ * image last rescaled into the ML engine input started, see fw_core.h.
+ *
+ * @return The capture start time of the image, in CPU TSC units.
+ */
+uint64_t get_frame_capture_time(void)
+{
+	return frame_capture_tsc;
+}
+
 /**
  * capture_rescaled_image_async() starts an asynchronous capture and rescale
  * operation to produce an image intended for transmission to HUB. Completion is
@@ -352,6 +1306,237 @@ void capture_rescaled_image_async(void)
 	}
 }
 
+/**
+ * snapshot_rescaled_image_async() starts an asynchronous capture of an image
+ * intended for transmission to HUB, without pausing the pipeline. The next
+ * rescaled image is copied out of the ML engine input into the snapshot
+ * buffer before the ML engine is started on it, and stays there for HUB to
+ * read until the next snapshot. The ML runs go on meanwhile, but for the time
+ * of the copy. A snapshot being copied is dropped for the new one.
+ *
+ * Only the part of the image in p_format is copied, one pixel in decimation
+ * in both directions, and encoded with its codec, for the image to go faster
+ * over slow Host links.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, which has room for the snapshot
+ * buffer in the ML IO region, supports it.
+ *
+ * @param p_format is the part of the image to copy and its encoding. It is
+ *                 clipped to the image. An unknown codec is taken as
+ *                 IMAGE_CODEC__NONE.
+ *
+ * @return true if the snapshot is started, false if it is not supported or
+ *         the pipeline is paused, in which case capture_rescaled_image_async()
+ *         is to be used.
+ */
+bool snapshot_rescaled_image_async(const struct snapshot_format *p_format)
+{
+#ifdef ML_APP_MOD
+	if (PIPELINE_RUNNING != ml_pipeline_state) {
+		return false;
+	}
+
+	snapshot_fmt = *p_format;
+	if (snapshot_fmt.roi_x >= BL_SCALER_RESCALE_CROP_OUT_WIDTH) {
+		snapshot_fmt.roi_x = 0;
+	}
+	if (snapshot_fmt.roi_y >= BL_SCALER_RESCALE_CROP_OUT_HEIGHT) {
+		snapshot_fmt.roi_y = 0;
+	}
+	if ((0U == snapshot_fmt.roi_width) ||
+		(snapshot_fmt.roi_width >
+		 (BL_SCALER_RESCALE_CROP_OUT_WIDTH - snapshot_fmt.roi_x))) {
+		snapshot_fmt.roi_width =
+			BL_SCALER_RESCALE_CROP_OUT_WIDTH - snapshot_fmt.roi_x;
+	}
+	if ((0U == snapshot_fmt.roi_height) ||
+		(snapshot_fmt.roi_height >
+		 (BL_SCALER_RESCALE_CROP_OUT_HEIGHT - snapshot_fmt.roi_y))) {
+		snapshot_fmt.roi_height =
+			BL_SCALER_RESCALE_CROP_OUT_HEIGHT - snapshot_fmt.roi_y;
+	}
+	if (0U == snapshot_fmt.decimation) {
+		snapshot_fmt.decimation = 1;
+	}
+	if (snapshot_fmt.codec > IMAGE_CODEC__PACK4) {
+		snapshot_fmt.codec = IMAGE_CODEC__NONE;
+	}
+
+	snapshot_width =
+		(snapshot_fmt.roi_width + snapshot_fmt.decimation - 1U) /
+		snapshot_fmt.decimation;
+	snapshot_height =
+		(snapshot_fmt.roi_height + snapshot_fmt.decimation - 1U) /
+		snapshot_fmt.decimation;
+
+	snapshot_state = SNAPSHOT__REQUESTED;
+
+	if (!GARD__IS_PIPELINE_ACTIVE()) {
+		capture_image_async();
+	}
+
+	return true;
+#else
+	(void)p_format;
+
+	return false;
+#endif
+}
+
+/**
+ * is_rescaled_image_snapshot_ready() reports whether the image requested with
+ * snapshot_rescaled_image_async() has been copied to the snapshot buffer.
+ *
+ * @return true if the snapshot can be read by HUB, false otherwise.
+ */
+bool is_rescaled_image_snapshot_ready(void)
+{
+#ifdef ML_APP_MOD
+	return (SNAPSHOT__READY == snapshot_state);
+#else
+	return false;
+#endif
+}
+
+/**
+ * is_snapshot_copy_in_progress() tells if the ML engine input is being copied
+ * to the snapshot buffer, so the ML engine must not be started on it yet.
+ *
+ * @return true if the copy is in progress, false otherwise.
+ */
+bool is_snapshot_copy_in_progress(void)
+{
+#ifdef ML_APP_MOD
+	return (SNAPSHOT__COPYING == snapshot_state);
+#else
+	return false;
+#endif
+}
+
+/**
+ * continue_snapshot_copy() copies the next slice of the ML engine input to the
+ * snapshot buffer. It is called by the main loop, the copy being sliced to
+ * keep servicing the Host requests meanwhile. The whole image is copied as it
+ * is, a part of it or an encoded one row by row, see
+ * snapshot_rescaled_image_async().
+ *
+ * @return true if a slice was copied, false if no copy is in progress.
+ */
+bool continue_snapshot_copy(void)
+{
+#ifdef ML_APP_MOD
+	const uint8_t *p_row;
+	uint32_t       len, rows;
+
+	if (SNAPSHOT__COPYING != snapshot_state) {
+		return false;
+	}
+
+	if ((snapshot_width == BL_SCALER_RESCALE_CROP_OUT_WIDTH) &&
+		(snapshot_height == BL_SCALER_RESCALE_CROP_OUT_HEIGHT) &&
+		(IMAGE_CODEC__NONE == snapshot_fmt.codec)) {
+		len = SNAPSHOT_SIZE - snapshot_copied;
+		if (len > SNAPSHOT_COPY_SLICE) {
+			len = SNAPSHOT_COPY_SLICE;
+		}
+
+		memcpy_w(
+			(uint32_t *)(SNAPSHOT_ADDRESS + snapshot_copied),
+			(const uint32_t *)(ML_APP_1_INPUT_START_ADDRESS + snapshot_copied),
+			len);
+
+		snapshot_copied += len;
+		if (SNAPSHOT_SIZE == snapshot_copied) {
+			snapshot_state = SNAPSHOT__READY;
+		}
+
+		return true;
+	}
+
+	for (rows = 0; rows < SNAPSHOT_ENCODE_ROWS; rows++) {
+		p_row = (const uint8_t *)(ML_APP_1_INPUT_START_ADDRESS +
+								  (snapshot_plane *
+								   BL_SCALER_RESCALE_CROP_OUT_SIZE) +
+								  ((snapshot_fmt.roi_y +
+									(snapshot_row * snapshot_fmt.decimation)) *
+								   BL_SCALER_RESCALE_CROP_OUT_WIDTH) +
+								  snapshot_fmt.roi_x);
+
+		snapshot_copied += snapshot_encode_row(
+			(enum image_codecs)snapshot_fmt.codec, p_row,
+			snapshot_fmt.decimation, snapshot_width,
+			(uint8_t *)(SNAPSHOT_ADDRESS + snapshot_copied));
+
+		if (++snapshot_row < snapshot_height) {
+			continue;
+		}
+
+		snapshot_row = 0;
+		if (++snapshot_plane == capture_planes) {
+			snapshot_state = SNAPSHOT__READY;
+			break;
+		}
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * get_rescaled_image_snapshot_info() fills the provided `image_info` structure
+ * with the location, geometry, format, and size of the image in the snapshot
+ * buffer. The size is the one of the encoded image. Callers should invoke
+ * this only after is_rescaled_image_snapshot_ready() returns true.
+ *
+ * @param rescaled_image Pointer to the structure that will receive the
+ *                       rescaled image metadata.
+ * @param p_codec is filled with the enum image_codecs of the image.
+ */
+void get_rescaled_image_snapshot_info(struct image_info *rescaled_image,
+									  uint8_t           *p_codec)
+{
+	get_rescaled_image_info(rescaled_image);
+	*p_codec = IMAGE_CODEC__NONE;
+
+#ifdef ML_APP_MOD
+	if (0U != rescaled_image->size) {
+		rescaled_image->image_data = (void *)SNAPSHOT_ADDRESS;
+		rescaled_image->width      = snapshot_width;
+		rescaled_image->height     = snapshot_height;
+		rescaled_image->size       = snapshot_copied;
+		*p_codec                   = snapshot_fmt.codec;
+	}
+#endif
+}
+
+/**
+ * get_rescaled_image_frame() tells which captured image the rescaled image
+ * for Host, or its snapshot, was made from.
+ *
+ * @param is_snapshot is true for the snapshot buffer, false for the rescaled
+ *                    image the pipeline is paused on.
+ * @param p_seq is filled with the sequence number of the image.
+ * @param p_capture_tsc is filled with the CPU TSC at which its capture
+ *                      started.
+ */
+void get_rescaled_image_frame(bool      is_snapshot,
+							  uint32_t *p_seq,
+							  uint64_t *p_capture_tsc)
+{
+#ifdef ML_APP_MOD
+	if (is_snapshot) {
+		*p_seq         = snapshot_seq;
+		*p_capture_tsc = snapshot_tsc;
+		return;
+	}
+#endif
+
+	*p_seq         = frame_seq;
+	*p_capture_tsc = frame_capture_tsc;
+}
+
 /**
  * is_rescaled_image_captured() reports whether the rescaled image requested
  * for HUB transmission is ready in the designated buffer. If true is returned,
@@ -389,11 +1574,53 @@ void get_rescaled_image_info(struct image_info *rescaled_image)
 		rescaled_image->image_data = (void *)ML_APP_1_INPUT_START_ADDRESS;
 		rescaled_image->width      = BL_SCALER_RESCALE_CROP_OUT_WIDTH;
 		rescaled_image->height     = BL_SCALER_RESCALE_CROP_OUT_HEIGHT;
-		rescaled_image->format     = IMAGE_FORMAT__RGB_PLANAR;
+		rescaled_image->format     = capture_format;
+		rescaled_image->size       =
+			capture_planes * BL_SCALER_RESCALE_CROP_OUT_SIZE;
+	}
+}
 
-		if (IMAGE_FORMAT__GRAYSCALE != rescaled_image->format) {
-			rescaled_image->size = 3U * BL_SCALER_RESCALE_CROP_OUT_SIZE;
-		}
+/**
+ * set_capture_format() sets the format the images are captured and rescaled
+ * in from the next capture on, see the input_format of struct network_info.
+ * In IMAGE_FORMAT__GRAYSCALE, the mini-ISP writes a single luminance plane,
+ * so the captured image, the ML engine input and the snapshots for Host are a
+ * third of their RGB planar size.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, whose mini-ISP has the grayscale
+ * capture, supports IMAGE_FORMAT__GRAYSCALE.
+ *
+ * @param format is IMAGE_FORMAT__RGB_PLANAR or IMAGE_FORMAT__GRAYSCALE.
+ *
+ * @return true if the format was set, false if it is not supported or an image
+ *         is being captured or waits to be rescaled.
+ */
+bool set_capture_format(enum image_formats format)
+{
+#ifdef ML_APP_MOD
+	if (((IMAGE_FORMAT__RGB_PLANAR != format) &&
+		 (IMAGE_FORMAT__GRAYSCALE != format)) ||
+		capture_started || rescaling_started || is_captured_image_waiting()) {
+		return false;
 	}
+
+	capture_format = format;
+	capture_planes = (IMAGE_FORMAT__GRAYSCALE == format) ? 1U : 3U;
+
+	return true;
+#else
+	return (IMAGE_FORMAT__RGB_PLANAR == format);
+#endif
+}
+
+/**
+ * get_capture_planes() returns the count of planes of the captured and
+ * rescaled images, see set_capture_format().
+ *
+ * @return 1 in grayscale, 3 in RGB planar.
+ */
+uint32_t get_capture_planes(void)
+{
+	return capture_planes;
 }
 
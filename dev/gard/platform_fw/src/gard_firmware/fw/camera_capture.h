@@ -11,6 +11,17 @@
 #include "gard_types.h"
 #include "image_info.h"
 
+/**
+ * GARD_CAMERA_COUNT is the number of cameras GARD can take images from, the
+ * camera_id of Host requests ranges from 0 to GARD_CAMERA_COUNT - 1.
+ *
+ * TBD-SRP: GARD has a single image sensor I2C master and a single capture and
+ * rescale path, so its pipeline state is single-instance. Serving more cameras
+ * needs per-camera pipeline contexts that take turns on the scaler and the ML
+ * engine.
+ */
+#define GARD_CAMERA_COUNT 1U
+
 /**
  * setup_camera_capture_parameters() sets up the camera capture parameters such
  * as input image dimensions, crop dimensions, and output image dimensions.
@@ -23,6 +34,54 @@ void setup_camera_capture_parameters(void);
  */
 void setup_image_rescale_parameters(void);
 
+/**
+ * The scaler engine configuration of the capture, see set_scaler_config().
+ * The box scaler takes the precrop window of the sensor image and divides it
+ * by the factors, the bilinear scaler then crops its output, of crop_in size,
+ * and scales the crop to out size. Windows are left/upper inclusive and
+ * right/bottom exclusive.
+ */
+struct scaler_config {
+	uint16_t precrop_left;
+	uint16_t precrop_right;
+	uint16_t precrop_upper;
+	uint16_t precrop_bottom;
+	uint8_t  box_factor_x;
+	uint8_t  box_factor_y;
+	uint16_t crop_left;
+	uint16_t crop_right;
+	uint16_t crop_upper;
+	uint16_t crop_bottom;
+	uint16_t crop_in_width;
+	uint16_t crop_in_height;
+	uint16_t out_width;
+	uint16_t out_height;
+};
+
+/**
+ * set_scaler_config() validates a scaler configuration and has it applied
+ * from the next capture on that starts with no captured image waiting.
+ */
+bool set_scaler_config(const struct scaler_config *p_config);
+
+/**
+ * get_scaler_config() returns the scaler configuration last set, and whether
+ * the captures use it yet.
+ */
+void get_scaler_config(struct scaler_config *p_config, bool *p_applied);
+
+/**
+ * set_capture_format() sets the format the images are captured and rescaled
+ * in, RGB planar or grayscale, see the input_format of struct network_info.
+ */
+bool set_capture_format(enum image_formats format);
+
+/**
+ * get_capture_planes() returns the count of planes of the captured and
+ * rescaled images, 1 in grayscale and 3 in RGB planar.
+ */
+uint32_t get_capture_planes(void);
+
 /**
  * capture_done_isr() is the ISR that is called when the 2 stage scaler engine
  * has completed the image capture process.
@@ -40,6 +99,70 @@ void capture_done_isr(void *ctxt);
  */
 void rescaling_done_isr(void *ctxt);
 
+/**
+ * start_roi_rescale() starts the rescale stage on an ROI of the captured
+ * image, writing the rescaled ROI at out_address.
+ */
+bool start_roi_rescale(const struct roi_box *p_roi,
+					   uint16_t              out_width,
+					   uint16_t              out_height,
+					   uint32_t              out_address);
+
+/**
+ * is_capture_ahead_enabled() tells if the next capture is to be started as
+ * soon as the current image is rescaled, see set_capture_ahead().
+ */
+bool is_capture_ahead_enabled(void);
+
+/**
+ * is_continuous_capture_enabled() tells if the capture free-runs into the
+ * frame ring, see set_continuous_capture().
+ */
+bool is_continuous_capture_enabled(void);
+
+/**
+ * continue_continuous_capture() starts the rescale of an image of the frame
+ * ring, if the ML engine input is free, or else the next capture.
+ */
+bool continue_continuous_capture(bool ml_input_free);
+
+/**
+ * The Host input slots, see submit_host_input(). free_slots has bit n set if
+ * slot n can be written by Host.
+ */
+struct host_input_status {
+	bool     active;
+	uint8_t  free_slots;
+	uint32_t slot_address[HOST_INFERENCE__SLOTS];
+	uint32_t slot_size;
+};
+
+/**
+ * submit_host_input() queues the image Host wrote to a Host input slot for
+ * the ML engine, in place of the camera images.
+ */
+bool submit_host_input(uint8_t            slot,
+					   enum image_formats format,
+					   uint16_t           width,
+					   uint16_t           height,
+					   uint32_t           frame_id);
+
+/**
+ * stop_host_input() goes back to the camera images, see submit_host_input().
+ */
+void stop_host_input(void);
+
+/**
+ * get_host_input_status() reports the Host input slots.
+ */
+void get_host_input_status(struct host_input_status *p_status);
+
+/**
+ * continue_host_input() rescales the next Host image submitted into the ML
+ * engine input, if the App Module waits for it and the input is free.
+ */
+bool continue_host_input(bool ml_input_free);
+
 /**
  * capture_rescaled_image_async() initiates capture of an image intended for
  * HUB consumption.
@@ -52,6 +175,66 @@ void capture_rescaled_image_async(void);
  */
 bool is_rescaled_image_captured(void);
 
+/**
+ * The part of the rescaled image a snapshot holds and its encoding, see
+ * snapshot_rescaled_image_async(). A width or height of 0 is the whole image,
+ * a decimation of 0 or 1 keeps every pixel, codec is an enum image_codecs.
+ */
+struct snapshot_format {
+	uint16_t roi_x;
+	uint16_t roi_y;
+	uint16_t roi_width;
+	uint16_t roi_height;
+	uint8_t  decimation;
+	uint8_t  codec;
+};
+
+/**
+ * snapshot_rescaled_image_async() initiates a copy of the next rescaled image
+ * for HUB consumption, without pausing the pipeline.
+ */
+bool snapshot_rescaled_image_async(const struct snapshot_format *p_format);
+
+/**
+ * is_rescaled_image_snapshot_ready() reports whether the snapshot buffer is
+ * ready for HUB access.
+ */
+bool is_rescaled_image_snapshot_ready(void);
+
+/**
+ * is_snapshot_copy_in_progress() tells if the ML engine input is being copied
+ * to the snapshot buffer.
+ */
+bool is_snapshot_copy_in_progress(void);
+
+/**
+ * continue_snapshot_copy() copies the next slice of the ML engine input to the
+ * snapshot buffer.
+ */
+bool continue_snapshot_copy(void);
+
+/**
+ * get_rescaled_image_snapshot_info() returns metadata describing the image in
+ * the snapshot buffer.
+ */
+void get_rescaled_image_snapshot_info(struct image_info *rescaled_image,
+									  uint8_t           *p_codec);
+
+/**
+ * get_rescaled_image_frame() returns the sequence number and the capture start
+ * time of the image the rescaled image for Host, or its snapshot, was made
+ * from.
+ */
+void get_rescaled_image_frame(bool      is_snapshot,
+							  uint32_t *p_seq,
+							  uint64_t *p_capture_tsc);
+
+/**
+ * start_prearmed_capture() rescales the image captured while the pipeline was
+ * paused, returning false if there is none.
+ */
+bool start_prearmed_capture(void);
+
 /**
  * get_rescaled_image_info() returns metadata describing the rescaled image.
  */
@@ -9,8 +9,8 @@
 #include "assert.h"
 #include "rfs.h"
 #include "utils.h"
-#include "camera_config.h"
 #include "ospi_support.h"
+#include "camera_config.h"
 #include "sys_platform.h"
 #include "i2c_master.h"
 #include "sony_camera_configs.h"
@@ -18,6 +18,7 @@
 #include "gpio_mapper.h"
 #include "hw_regs.h"
 #include "fw_globals.h"
+#include "irq_support.h"
 
 /**
  * The code in this file can parse the camera configuration of version
@@ -43,6 +44,31 @@
  */
 #define DELAY_COUNT_1_MS_50_MHZ      0x1000U
 
+/**
+ * Packets of CAMERA_REG_WRITE_GRANULARITY bytes carry a 16-bit register
+ * address (MSB first) followed by one data byte. configure_image_sensor()
+ * merges such packets to contiguous registers into a single I2C write of up to
+ * CAMERA_BURST_WRITE_SIZE bytes, relying on the sensor to auto-increment the
+ * register address.
+ */
+#define CAMERA_REG_ADDR_SIZE         2U
+#define CAMERA_REG_WRITE_GRANULARITY (CAMERA_REG_ADDR_SIZE + 1U)
+#define CAMERA_BURST_WRITE_SIZE      32U
+
+/**
+ * Software reset register of the image sensor. Writing it sets every other
+ * register back to its default, so a command writing it is always applied in
+ * full, see start_camera_streaming().
+ */
+#define CAMERA_SW_RESET_REG_ADDR     0x0103U
+
+/**
+ * Depth of the queue of writes of write_to_camera_async() and the largest
+ * write it takes.
+ */
+#define CAMERA_WRITE_QUEUE_DEPTH     4U
+#define CAMERA_QUEUED_WRITE_SIZE     8U
+
 /**
  * This structure image_sensor_cfg_data_record is used to hold all the variables
  * related to handling the image sensor configuration data transmission over
@@ -62,6 +88,175 @@ struct image_sensor_cfg_data_record {
  */
 struct i2cm_instance cam_i2cm;
 
+/**
+ * This structure camera_queued_write holds a write to the image sensor that
+ * write_to_camera_async() has queued for continue_camera_writes().
+ */
+struct camera_queued_write {
+	uint16_t         image_sensor_id;
+	uint8_t          byte_count;
+	uint8_t          data[CAMERA_QUEUED_WRITE_SIZE];
+	struct i2cm_msg  msg;   // the I2C transaction, once in flight
+	struct i2cm_xfer xfer;
+};
+
+static struct camera_queued_write camera_write_queue[CAMERA_WRITE_QUEUE_DEPTH];
+
+/**
+ * camera_write_queue_head is the oldest queued write and
+ * camera_write_queue_count the number of queued writes, including the one in
+ * flight on the I2C bus when camera_write_in_flight is set.
+ */
+static uint32_t camera_write_queue_head  = 0;
+static uint32_t camera_write_queue_count = 0;
+static bool     camera_write_in_flight   = false;
+
+/**
+ * The camera command last applied to the image sensor by
+ * start_camera_streaming(), and its CRC-32 as loaded from flash. The sensor
+ * keeps its registers while it is powered, which it stays once started, so a
+ * restart only writes the registers that the command changes.
+ * configure_image_sensor() rewrites the header of delay records in place, the
+ * copy is taken afterwards.
+ */
+static uint8_t  applied_camera_command[CAMERA_CONFIG_BUFFER_SIZE];
+static uint32_t applied_camera_command_size = 0U;
+static uint32_t applied_camera_command_crc  = 0U;
+
+/* cam_i2cm is set up once, by the first start_camera_streaming() */
+static bool     cam_i2cm_ready = false;
+
+#if defined(GARD_DEBUG)
+/**
+ * camera_writes_skipped counts the register writes that
+ * start_camera_streaming() left out as the sensor already had their value.
+ * Useful during debugging.
+ */
+uint32_t camera_writes_skipped = 0;
+
+/**
+ * camera_write_failures counts the queued writes that the image sensor did not
+ * acknowledge. Useful during debugging.
+ */
+uint32_t camera_write_failures = 0;
+#endif
+
+/**
+ * flush_camera_burst() writes the burst collected by configure_image_sensor()
+ * to the image sensor, if any.
+ *
+ * @param image_sensor_id I2C address for image sensor.
+ * @param p_burst is the buffer holding the register address and data bytes.
+ * @param p_burst_size is the size of the burst, reset to 0 on return.
+ *
+ * @return None
+ */
+static void flush_camera_burst(uint16_t  image_sensor_id,
+							   uint8_t  *p_burst,
+							   uint32_t *p_burst_size)
+{
+	if (0U != *p_burst_size) {
+		write_to_camera(image_sensor_id, *p_burst_size, p_burst);
+		*p_burst_size = 0U;
+	}
+}
+
+/**
+ * camera_reg_is_applied() tells if applied_camera_command left a register of
+ * the image sensor with a given value. Registers written more than once hold
+ * the last value written.
+ *
+ * @param p_packet is a packet of CAMERA_REG_WRITE_GRANULARITY bytes.
+ *
+ * @return true if the register already holds the value of the packet.
+ */
+static bool camera_reg_is_applied(const uint8_t *p_packet)
+{
+	struct image_sensor_cfg_data_record *p_record;
+	const uint8_t                       *p_data;
+	uint32_t                             record_idx = 0U;
+	uint32_t                             packet_count;
+	uint32_t                             idx;
+	bool                                 applied    = false;
+
+	while ((record_idx + sizeof(*p_record)) <= applied_camera_command_size) {
+		p_record =
+			(struct image_sensor_cfg_data_record *)(applied_camera_command +
+													record_idx);
+		record_idx += sizeof(*p_record);
+		p_data      = applied_camera_command + record_idx;
+
+		packet_count = (CONFIG_DELAY_RECORD_PACKET_COUNT ==
+						p_record->data_packet_count)
+						   ? 1U
+						   : p_record->data_packet_count;
+		record_idx  += packet_count * p_record->data_granularity;
+
+		if ((CAMERA_REG_WRITE_GRANULARITY != p_record->data_granularity) ||
+			(record_idx > applied_camera_command_size)) {
+			continue;
+		}
+
+		for (idx = 0U; idx < packet_count * CAMERA_REG_WRITE_GRANULARITY;
+			 idx += CAMERA_REG_WRITE_GRANULARITY) {
+			if ((p_data[idx] == p_packet[0]) &&
+				(p_data[idx + 1U] == p_packet[1])) {
+				applied = (p_data[idx + CAMERA_REG_ADDR_SIZE] ==
+						   p_packet[CAMERA_REG_ADDR_SIZE]);
+			}
+		}
+	}
+
+	return applied;
+}
+
+/**
+ * camera_command_resets_sensor() tells if a camera command writes the
+ * software reset register of the image sensor.
+ *
+ * @param byte_count is the size of p_data_buffer in bytes.
+ * @param p_data_buffer is the buffer holding the command.
+ *
+ * @return true if the command resets the sensor.
+ */
+static bool camera_command_resets_sensor(uint32_t       byte_count,
+										 const uint8_t *p_data_buffer)
+{
+	struct image_sensor_cfg_data_record *p_record;
+	const uint8_t                       *p_data;
+	uint32_t                             record_idx = 0U;
+	uint32_t                             idx;
+
+	while ((record_idx + sizeof(*p_record)) <= byte_count) {
+		p_record =
+			(struct image_sensor_cfg_data_record *)(p_data_buffer + record_idx);
+		record_idx += sizeof(*p_record);
+		p_data      = p_data_buffer + record_idx;
+
+		if (CONFIG_DELAY_RECORD_PACKET_COUNT == p_record->data_packet_count) {
+			record_idx += p_record->data_granularity;
+			continue;
+		}
+		record_idx += p_record->data_packet_count * p_record->data_granularity;
+
+		if ((CAMERA_REG_WRITE_GRANULARITY != p_record->data_granularity) ||
+			(record_idx > byte_count)) {
+			continue;
+		}
+
+		for (idx = 0U; idx < p_record->data_packet_count *
+								 CAMERA_REG_WRITE_GRANULARITY;
+			 idx += CAMERA_REG_WRITE_GRANULARITY) {
+			if (CAMERA_SW_RESET_REG_ADDR ==
+				(uint16_t)((p_data[idx] << 8) | p_data[idx + 1U])) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 /**
  * configure_image_sensor configures image sensor over I2C.
  * ==============================================================================
@@ -154,26 +349,44 @@ struct i2cm_instance cam_i2cm;
  * |                                                                         |
  * +=========================================================================+
  *
+ * Packets of CAMERA_REG_WRITE_GRANULARITY bytes to consecutive registers, like
+ * the two above, are sent as one burst (0x30 0x12 0x34 0x56 0x78 ...) which
+ * saves the start, device address and register address of all packets but the
+ * first.
+ *
+ * With only_changes, the sensor is known to hold applied_camera_command:
+ * packets of CAMERA_REG_WRITE_GRANULARITY bytes to registers that already
+ * hold their value are left out, and so are the delays that follow no write.
+ *
  * @param image_sensor_id I2C address for image sensor.
  * @param byte_count is the size of p_data_buffer in bytes.
  * @param p_data_buffer is the buffer holding configuration.
+ * @param only_changes is true to write only what applied_camera_command
+ * 		  did not.
  *
  * @return true if the configuration is successful, false otherwise.
  */
 static bool configure_image_sensor(uint16_t image_sensor_id,
 								   uint32_t byte_count,
-								   uint8_t *p_data_buffer)
+								   uint8_t *p_data_buffer,
+								   bool     only_changes)
 {
 	uint32_t                             config_data_idx;
 	uint32_t                             config_idx = 0;
 	struct image_sensor_cfg_data_record *p_config_record;
 	uint8_t                             *p_config_data;
 	uint32_t                             delay_counter;
+	uint8_t                              burst[CAMERA_BURST_WRITE_SIZE];
+	uint32_t                             burst_size = 0U;
+	uint16_t                             reg_addr;
+	uint16_t                             next_reg_addr = 0U;
+	bool                                 wrote_since_delay = true;
 
 	GARD__DBG_ASSERT((byte_count > 0U) && (NULL != p_data_buffer),
 					 "Invalid configuration parameters");
 
-	if (!detect_image_sensor(image_sensor_id, &cam_i2cm)) {
+	/* A sensor holding the last command was detected when it was applied */
+	if (!only_changes && !detect_image_sensor(image_sensor_id, &cam_i2cm)) {
 		return false;
 	}
 
@@ -190,7 +403,10 @@ static bool configure_image_sensor(uint16_t image_sensor_id,
 			if (CONFIG_DELAY_RECORD_PACKET_COUNT ==
 				p_config_record->data_packet_count) {
 				/* Setup a counter for delay equivalent in milliseconds */
-				delay_counter = (*p_config_data * DELAY_COUNT_1_MS_50_MHZ);
+				delay_counter = wrote_since_delay
+									? (*p_config_data * DELAY_COUNT_1_MS_50_MHZ)
+									: 0U;
+				wrote_since_delay = !only_changes;
 
 				while (0U != delay_counter) {
 					delay_counter--;
@@ -200,12 +416,40 @@ static bool configure_image_sensor(uint16_t image_sensor_id,
 				 * contains a single packet of sizeof(uint32_t) / 4 bytes with
 				 * delay count in milliseconds */
 				p_config_record->data_packet_count = 1U;
+			} else if (CAMERA_REG_WRITE_GRANULARITY ==
+					   p_config_record->data_granularity) {
+				if (only_changes &&
+					camera_reg_is_applied(p_config_data + config_data_idx)) {
+#if defined(GARD_DEBUG)
+					camera_writes_skipped++;
+#endif
+					continue;
+				}
+				wrote_since_delay = true;
+
+				reg_addr = (uint16_t)((p_config_data[config_data_idx] << 8) |
+									  p_config_data[config_data_idx + 1U]);
+
+				/* Extend the burst if this packet writes the next register. */
+				if ((0U != burst_size) && (reg_addr == next_reg_addr) &&
+					(burst_size < sizeof(burst))) {
+					burst[burst_size++] =
+						p_config_data[config_data_idx + CAMERA_REG_ADDR_SIZE];
+				} else {
+					flush_camera_burst(image_sensor_id, burst, &burst_size);
+					memcpy(burst, p_config_data + config_data_idx,
+						   CAMERA_REG_WRITE_GRANULARITY);
+					burst_size = CAMERA_REG_WRITE_GRANULARITY;
+				}
+				next_reg_addr = (uint16_t)(reg_addr + 1U);
 			} else {
+				wrote_since_delay = true;
 				write_to_camera(image_sensor_id,
 								p_config_record->data_granularity,
 								p_config_data + config_data_idx);
 			}
 		}
+		flush_camera_burst(image_sensor_id, burst, &burst_size);
 		config_idx += p_config_record->data_packet_count *
 					  p_config_record->data_granularity;
 	}
@@ -216,7 +460,7 @@ static bool configure_image_sensor(uint16_t image_sensor_id,
 /**
  * write_to_camera() writes the camera configuration to the image sensor over
  * I2C. This call can be made only after configure_image_sensor() has been
- * called.
+ * called. It waits for the writes queued by write_to_camera_async() first.
  *
  * @param image_sensor_id I2C address for image sensor.
  * @param byte_count is the size of p_data_buffer in bytes.
@@ -228,11 +472,138 @@ void write_to_camera(uint16_t image_sensor_id,
 					 uint32_t byte_count,
 					 uint8_t *p_data_buffer)
 {
+	/* Keep the writes in order with those queued earlier. */
+	while (0U != camera_write_queue_count) {
+		(void)continue_camera_writes();
+	}
+
 	GARD__DBG_ASSERT(0U == i2c_master_write(&cam_i2cm, image_sensor_id,
 											(uint8_t)byte_count, p_data_buffer),
 					 "I2C write failed for image sensor %u", image_sensor_id);
 }
 
+/**
+ * write_to_camera_async() queues a write to the image sensor which
+ * continue_camera_writes() sends over I2C from the main loop. It can be called
+ * from an ISR. A queued write that has not started yet and is to the same
+ * register as this one is replaced, as only the latest value matters.
+ *
+ * @param image_sensor_id I2C address for image sensor.
+ * @param byte_count is the size of p_data_buffer in bytes.
+ * @param p_data_buffer is the buffer holding the register address and data.
+ *
+ * @return true if the write was queued, false if the queue is full.
+ */
+bool write_to_camera_async(uint16_t       image_sensor_id,
+						   uint32_t       byte_count,
+						   const uint8_t *p_data_buffer)
+{
+	struct camera_queued_write *p_write;
+	uint32_t                    idx;
+	uint32_t                    first_pending;
+	uint32_t                    irq_state;
+	bool                        queued = true;
+
+	GARD__DBG_ASSERT((byte_count > CAMERA_REG_ADDR_SIZE) &&
+						 (byte_count <= CAMERA_QUEUED_WRITE_SIZE) &&
+						 (NULL != p_data_buffer),
+					 "Invalid camera write of %u bytes", byte_count);
+
+	irq_state = irq_save();
+
+	/* Look for a write to the same register which is still pending. */
+	p_write       = NULL;
+	first_pending = camera_write_in_flight ? 1U : 0U;
+	for (idx = first_pending; idx < camera_write_queue_count; idx++) {
+		p_write = &camera_write_queue[(camera_write_queue_head + idx) %
+									  CAMERA_WRITE_QUEUE_DEPTH];
+		if ((p_write->image_sensor_id == image_sensor_id) &&
+			(p_write->byte_count == byte_count) &&
+			(p_write->data[0] == p_data_buffer[0]) &&
+			(p_write->data[1] == p_data_buffer[1])) {
+			break;
+		}
+		p_write = NULL;
+	}
+
+	if (NULL == p_write) {
+		if (CAMERA_WRITE_QUEUE_DEPTH == camera_write_queue_count) {
+			queued = false;
+		} else {
+			p_write = &camera_write_queue[(camera_write_queue_head +
+										   camera_write_queue_count) %
+										  CAMERA_WRITE_QUEUE_DEPTH];
+			camera_write_queue_count++;
+		}
+	}
+
+	if (NULL != p_write) {
+		p_write->image_sensor_id = image_sensor_id;
+		p_write->byte_count      = (uint8_t)byte_count;
+		memcpy(p_write->data, p_data_buffer, byte_count);
+	}
+
+	irq_restore(irq_state);
+
+	return queued;
+}
+
+/**
+ * continue_camera_writes() progresses the writes queued by
+ * write_to_camera_async(). It never waits on the I2C bus: it submits the
+ * oldest queued write, which i2c_master_isr() sends, and retires it once the
+ * sensor has taken it.
+ *
+ * @return true if a write was submitted or retired, false otherwise.
+ */
+bool continue_camera_writes(void)
+{
+	struct camera_queued_write *p_write;
+	uint32_t                    irq_state;
+	uint8_t                     i2c_state;
+
+	if (0U == camera_write_queue_count) {
+		return false;
+	}
+
+	p_write = &camera_write_queue[camera_write_queue_head];
+
+	if (!camera_write_in_flight) {
+		p_write->msg.buffer    = p_write->data;
+		p_write->msg.length    = p_write->byte_count;
+		p_write->msg.flags     = 0;
+		p_write->xfer.address  = p_write->image_sensor_id;
+		p_write->xfer.msgs     = &p_write->msg;
+		p_write->xfer.num_msgs = 1;
+		p_write->xfer.done     = NULL;
+		if (0U == i2c_master_xfer_submit(&cam_i2cm, &p_write->xfer)) {
+			camera_write_in_flight = true;
+		}
+		return true;
+	}
+
+	/* The I2C interrupt wakes the main loop up once the write is done. */
+	i2c_state = p_write->xfer.state;
+	if (I2CM_STATE_QUEUED == i2c_state) {
+		return false;
+	}
+
+#if defined(GARD_DEBUG)
+	if (I2CM_STATE_ERROR == i2c_state) {
+		camera_write_failures++;
+	}
+#endif
+
+	irq_state               = irq_save();
+	camera_write_in_flight  = false;
+	camera_write_queue_head = (camera_write_queue_head + 1U) %
+							  CAMERA_WRITE_QUEUE_DEPTH;
+	camera_write_queue_count--;
+	irq_restore(irq_state);
+
+	return true;
+}
+
 /**
  * load_camera_command() loads the camera command configuration from the flash
  * memory based on the camera UID and action UID. The function first loads the
@@ -405,6 +776,10 @@ uint32_t load_camera_command(void    *ospi_handle,
  * function then loads the retrieved camera configuration by sending it to the
  * camera using I2C bus.
  *
+ * The first call applies the command in full. A later call applies nothing if
+ * the command is the one applied last, and otherwise only the registers it
+ * changes, unless it resets the sensor.
+ *
  * @param None
  * @return None
  */
@@ -412,15 +787,24 @@ void start_camera_streaming(void)
 {
 	uint8_t  cam_buffer[CAMERA_CONFIG_BUFFER_SIZE];
 	uint32_t camera_command_bytes_read;
+	uint32_t camera_command_crc;
+	bool     only_changes;
 
 	/* Set Output GPIO pin 0 for camera Power to ON */
 	SET_GPIO_HIGH_TO_CAMERA_POWER();
 
 	/* Initialize the I2C master instance for camera communication */
-	(void)i2c_master_init(&cam_i2cm,
-						  I2C_MST0_INST_I2C_CONTROLLER_MEM_MAP_BASE_ADDR);
-	(void)i2c_master_config(&cam_i2cm, I2CM_ADDR_7BIT_MODE, INT_MODE,
-							I2C_MST0_INST_PRESCALER);
+	if (!cam_i2cm_ready) {
+		(void)i2c_master_init(&cam_i2cm,
+							  I2C_MST0_INST_I2C_CONTROLLER_MEM_MAP_BASE_ADDR);
+		(void)i2c_master_config(&cam_i2cm, I2CM_ADDR_7BIT_MODE, INT_MODE,
+								I2C_MST0_INST_PRESCALER);
+		GARD__DBG_ASSERT(irq_register_isr(I2C_MST0_INST_IRQ, i2c_master_isr,
+										  &cam_i2cm),
+						 "Failed to register ISR for IRQ %u",
+						 I2C_MST0_INST_IRQ);
+		cam_i2cm_ready = true;
+	}
 
 	/* Retrieve camera configuration from flash */
 	camera_command_bytes_read = load_camera_command(
@@ -430,9 +814,30 @@ void start_camera_streaming(void)
 	GARD__ASSERT(camera_command_bytes_read > 0U,
 				 "Failed to load camera command");
 
+	camera_command_crc = crc32_update(0U, cam_buffer,
+									  camera_command_bytes_read);
+
+	/* The sensor already holds every register of this command */
+	if ((0U != applied_camera_command_size) &&
+		(camera_command_crc == applied_camera_command_crc)) {
+		return;
+	}
+
+	only_changes = (0U != applied_camera_command_size) &&
+				   !camera_command_resets_sensor(camera_command_bytes_read,
+												 cam_buffer);
+
 	/* Configure the image sensor using the retrieved camera command */
-	configure_image_sensor(IMAGE_SENSOR_SONY_IMX_219, camera_command_bytes_read,
-						   cam_buffer);
+	if (!configure_image_sensor(IMAGE_SENSOR_SONY_IMX_219,
+								camera_command_bytes_read, cam_buffer,
+								only_changes)) {
+		applied_camera_command_size = 0U;
+		return;
+	}
+
+	memcpy(applied_camera_command, cam_buffer, camera_command_bytes_read);
+	applied_camera_command_size = camera_command_bytes_read;
+	applied_camera_command_crc  = camera_command_crc;
 }
 
 /**
@@ -485,6 +890,29 @@ uint32_t get_image_gray_average(void)
 	return (uint32_t)gray_average;
 }
 
+/**
+ * ae_update_interval is the count of frames between two runs of the auto
+ * exposure, see set_auto_exposure_interval().
+ */
+static uint32_t ae_update_interval = DEFAULT_AE_UPDATE_INTERVAL;
+
+/**
+ * set_auto_exposure_interval() sets the count of frames between two runs of
+ * the auto exposure. Lower values track lighting changes faster at the cost of
+ * more sensor writes.
+ *
+ * @param frame_count is the count of frames, 0 is taken as 1.
+ *
+ * @return previous count of frames.
+ */
+uint32_t set_auto_exposure_interval(uint32_t frame_count)
+{
+	uint32_t previous_interval = ae_update_interval;
+	ae_update_interval         = MAX(frame_count, 1U);
+
+	return previous_interval;
+}
+
 #if defined(GARD_DEBUG)
 /**
  * auto_exposure_run_count keeps track of number of times auto exposure has
@@ -498,28 +926,56 @@ uint32_t auto_exposure_run_count = 0;
  * retrieving the brightness of the captured image and then calculating the new
  * exposure gain delta to be applied to the camera.
  *
+ * It is called once per frame but only runs every ae_update_interval frames,
+ * and not before the last exposure change had AE_SETTLE_FRAMES to take effect.
+ * Within the deadband around the target the exposure is left alone.
+ *
  * @return None
  */
 void run_auto_exposure(void)
 {
-	uint32_t img_gray_average;
-	uint32_t tgt_gray_average;
+	static uint32_t frames_to_skip  = 0;
+	static bool     within_deadband = false;
+	uint32_t        img_gray_average;
+	uint32_t        tgt_gray_average;
+	uint32_t        distance;
 
 	GARD__DBG_ASSERT(auto_exposure_enabled, "Auto Exposure is not enabled");
 
+	if (0U != frames_to_skip) {
+		frames_to_skip--;
+		return;
+	}
+	frames_to_skip = ae_update_interval - 1U;
+
 	/* Get the gray average of the image from the ISP. */
 	img_gray_average = get_image_gray_average();
 
 	/* Get the target gray average for comparison. */
 	tgt_gray_average = get_target_gray_average();
 
+	distance = (img_gray_average > tgt_gray_average)
+				   ? (img_gray_average - tgt_gray_average)
+				   : (tgt_gray_average - img_gray_average);
+
+	/* Hysteresis: a wider band to leave the deadband than to enter it. */
+	if (within_deadband) {
+		within_deadband = (distance <= AE_DEADBAND_LEAVE);
+	} else {
+		within_deadband = (distance <= AE_DEADBAND_ENTER);
+	}
+
+	if (within_deadband) {
+		return;
+	}
+
 	/* Set the camera sensor exposure based on current and target gray averages.
 	 */
-	if (img_gray_average != tgt_gray_average) {
 #if defined(GARD_DEBUG)
-		auto_exposure_run_count++;
+	auto_exposure_run_count++;
 #endif
-		set_exposure(tgt_gray_average);
+	if (set_exposure(tgt_gray_average)) {
+		frames_to_skip = MAX(frames_to_skip, AE_SETTLE_FRAMES);
 	}
 }
 
@@ -529,7 +985,7 @@ void run_auto_exposure(void)
  *
  * @return None
  */
-void setup_misp_config(void)
+GARD__COLD void setup_misp_config(void)
 {
 	/**
 	 * Configures the image capture system with frame buffer settings and
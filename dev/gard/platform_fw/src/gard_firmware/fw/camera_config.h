@@ -104,6 +104,25 @@ struct cc_dir_entry {
 /* Default Target gray average to begin with. */
 #define DEFAULT_TARGET_GRAY_AVERAGE        50U
 
+/**
+ * The auto exposure leaves the exposure alone once the gray average is within
+ * AE_DEADBAND_ENTER of the target and acts again only when it drifts more than
+ * AE_DEADBAND_LEAVE away, so that noise in the gray average does not keep the
+ * exposure toggling.
+ */
+#define AE_DEADBAND_ENTER                  3U
+#define AE_DEADBAND_LEAVE                  8U
+
+/* Default count of frames between two runs of the auto exposure. */
+#define DEFAULT_AE_UPDATE_INTERVAL         2U
+
+/**
+ * Frames the auto exposure waits after changing the exposure, as the sensor
+ * applies it to the frame after next and measuring earlier would see the old
+ * exposure.
+ */
+#define AE_SETTLE_FRAMES                   2U
+
 struct basic_camera_information {
 	/**
 	 * layout_version is the version of the layout of the basic camera
@@ -177,6 +196,12 @@ uint32_t get_image_gray_average(void);
  */
 uint32_t set_target_gray_average(uint32_t gray_average);
 
+/**
+ * set_auto_exposure_interval() sets the count of frames between two runs of
+ * the auto exposure.
+ */
+uint32_t set_auto_exposure_interval(uint32_t frame_count);
+
 /**
  * write_to_camera() writes the given data buffer to the camera over I2C bus.
  */
@@ -184,6 +209,20 @@ void write_to_camera(uint16_t image_sensor_id,
 					 uint32_t byte_count,
 					 uint8_t *p_data_buffer);
 
+/**
+ * write_to_camera_async() queues a write to the camera which
+ * continue_camera_writes() sends over I2C bus without blocking the caller.
+ */
+bool write_to_camera_async(uint16_t       image_sensor_id,
+						   uint32_t       byte_count,
+						   const uint8_t *p_data_buffer);
+
+/**
+ * continue_camera_writes() progresses the writes queued by
+ * write_to_camera_async(), returning true if it submitted or retired one.
+ */
+bool continue_camera_writes(void);
+
 /**
  * setup_misp_config() programs the MOD mini-ISP configuration.
  * This is invoked during initialization.
@@ -6,16 +6,17 @@
  ******************************************************************************/
 
 #include "gard_types.h"
+#include "ospi_support.h"
 #include "fw_core.h"
 #include "ml_ops.h"
 #include "hw_regs.h"
-#include "ospi_support.h"
 #include "rfs.h"
 #include "utils.h"
 #include "assert.h"
 #include "app_module.h"
 #include "fw_globals.h"
-#include "gpio_mapper.h"
+#include "pipeline_stats.h"
+#include "app_tx_coalesce.h"
 
 /**
  * schedule_image_processing_done_event() is used by the App Module to indicate
@@ -70,12 +71,15 @@ void *register_buffer_for_host_data(uint8_t     *buffer,
 /**
  * stream_data_to_host_async() is used by the App Module to send streaming data
  * to the Host. Since the data will be sent asynchronously, the App Module
- * should ideally have another buffer to accumulate new data while the previous
+ * should ideally have other buffers to accumulate new data while the previous
  * data is still being sent. The variable pointed by an optional p_send_complete
  * will be set to true once all the data from this buffer has been sent to the
  * Host. The App Module should have set this variable to false before calling
  * this function.
  *
+ * Buffers are sent in the order they are given, up to APP_TX_QUEUE_DEPTH of
+ * them waiting at any time.
+ *
  * @param data points to the data to be sent.
  * @param count_of_data_bytes is the number of bytes of data to be sent.
  * @param timeout_ms is the timeout in milliseconds for the operation.
@@ -84,37 +88,141 @@ void *register_buffer_for_host_data(uint8_t     *buffer,
  *                        and can be NULL if the App Module does not want to
  * know when the data has been sent.
  *
- * @return None.
+ * @return true if the buffer is queued, or copied with APP_DATA_COALESCING,
+ *         false if the queue is full.
  */
-void stream_data_to_host_async(uint8_t *data,
+bool stream_data_to_host_async(uint8_t *data,
 							   uint32_t count_of_data_bytes,
 							   uint32_t timeout_ms,
 							   uint8_t *p_send_complete)
 {
+	struct tx_span span = {.p_data = data, .size = count_of_data_bytes};
+
 	GARD__DBG_ASSERT((NULL != data) && (count_of_data_bytes > 0U),
 					 "Invalid data or count_of_data_bytes or p_send_complete");
+
+	return stream_spans_to_host_async(&span, 1, false, timeout_ms,
+									  p_send_complete);
+}
+
+/**
+ * stream_spans_to_host_async() is stream_data_to_host_async() for a buffer
+ * made of several pieces, sent back to back. The pieces are not copied, only
+ * the list of them is.
+ *
+ * @param p_spans points to the pieces of the buffer, in order.
+ * @param count_of_spans is the number of pieces, up to APP_TX_MAX_SPANS.
+ * @param hold_ml_output is true if a piece is in the ML engine buffers, which
+ *                       are then not written until the buffer is sent.
+ * @param timeout_ms is the timeout in milliseconds for the operation.
+ * @param p_send_complete points to a boolean that will be set to true when
+ *                        the buffer has been sent, can be NULL.
+ *
+ * @return true if the buffer is queued, or copied with APP_DATA_COALESCING,
+ *         false if the queue is full.
+ */
+bool stream_spans_to_host_async(const struct tx_span *p_spans,
+								uint32_t              count_of_spans,
+								bool                  hold_ml_output,
+								uint32_t              timeout_ms,
+								uint8_t              *p_send_complete)
+{
+	GARD__DBG_ASSERT((NULL != p_spans) && (count_of_spans > 0U) &&
+						 (count_of_spans <= APP_TX_MAX_SPANS),
+					 "Invalid p_spans or count_of_spans");
 	GARD__DBG_ASSERT(
 		(NULL == p_send_complete) || (!*p_send_complete),
 		"*p_send_complete should be set to false before calling this function");
 
+	struct app_tx_desc *p_desc;
+	bool                queued        = false;
+	bool                unread_before = (0U != app_tx_queue_count);
+	uint32_t            idx;
+
 	/**
-	 * The current implementation notes the buffer address and its size in
-	 * global variables so that FW Core can send this data to the Host in the
+	 * The current implementation queues the buffer pieces and their sizes in
+	 * app_tx_queue so that FW Core can send this data to the Host in the
 	 * background. The background sending of data is done by the
 	 * RECV_DATA_FROM_GARD_AT_OFFSET command handler that is part of the
 	 * interface support module. For this we need to let HUB know about the
 	 * availability of this data, we do this by toggling a GPIO pin that HUB is
 	 * monitoring.
+	 *
+	 * A Host subscribed with SUBSCRIBE_APP_DATA gets the data pushed by the
+	 * host_cmds module instead, as soon as its interface is between two
+	 * commands, without the GPIO toggle and the command round-trip.
+	 *
+	 * With APP_DATA_COALESCING, a buffer the queue has no room for is copied
+	 * in the batch buffer instead of being dropped, and is then sent already
+	 * as far as the App Module is concerned.
 	 */
-	app_tx_buffer      = data;
-	app_tx_buffer_size = count_of_data_bytes;
+	if (app_tx_queue_count < APP_TX_QUEUE_DEPTH) {
+		p_desc = &app_tx_queue[(app_tx_queue_head + app_tx_queue_count) %
+							   APP_TX_QUEUE_DEPTH];
+
+		p_desc->num_spans = 0;
+		p_desc->size      = 0;
+		for (idx = 0; idx < count_of_spans; idx++) {
+			// Empty pieces are left out, the send paths need not skip them.
+			if (0U != p_spans[idx].size) {
+				p_desc->spans[p_desc->num_spans++] = p_spans[idx];
+				p_desc->size += p_spans[idx].size;
+			}
+		}
+		GARD__DBG_ASSERT(p_desc->size > 0U, "Nothing to send in p_spans");
 
-	SET_GPIO_HIGH_TO_HOST_IRQ();
-	delay(1);
-	SET_GPIO_LOW_TO_HOST_IRQ();
+		p_desc->framed          = false;
+		p_desc->holds_ml_output = hold_ml_output;
+		p_desc->p_complete      = p_send_complete;
+		p_desc->seq_num         = app_data_push_seq_num;
+		p_desc->queued_at       = pipeline_stats_now();
+		app_tx_queue_count++;
+		if (hold_ml_output) {
+			app_tx_ml_output_holds++;
+		}
+		queued = true;
+	} else if ((NULL == app_data_subscriber) &&
+			   app_tx_coalesce_result(p_spans, count_of_spans)) {
+		if (NULL != p_send_complete) {
+			*p_send_complete = true;
+		}
+		queued = true;
+	} else {
+		app_tx_coalesce_dropped();
+	}
+
+	// A result the queue has no room for still counts, so that a subscribed
+	// Host sees it missing.
+	app_data_push_seq_num++;
+
+	if (NULL != app_data_subscriber) {
+		return queued;
+	}
+
+	app_tx_notify_host(unread_before);
 	/* TBD-SRP - Currently we ignore the timeout value. */
 
-	p_app_tx_complete = p_send_complete;
+	return queued;
+}
+
+/**
+ * register_app_task() registers a task of the App Module, run by the main loop
+ * at TASK_PRIO_BACKGROUND, i.e. only when all the other tasks are idle.
+ *
+ * @param p_task points to the task, statically allocated by the App Module.
+ * @param name is the name of the task, as reported in the task statistics.
+ * @param fn is the function running a slice of the work of the task.
+ * @param app_context is the handle passed to fn.
+ *
+ * @return None
+ */
+void register_app_task(struct task *p_task,
+					   const char  *name,
+					   task_fn_t    fn,
+					   app_handle_t app_context)
+{
+	task_register(p_task, name, fn, (void *)app_context,
+				  TASK_PRIO_BACKGROUND);
 }
 
 /**
@@ -143,3 +251,52 @@ uint32_t read_module_data(uint32_t module_uid,
 	return read_module_from_rfs(sd, module_uid, module_read_offset, read_bytes,
 								buffer);
 }
+
+/**
+ * write_module_data() replaces the data of the module, from the specified
+ * offset on, with the contents of the provided buffer. It is meant for the
+ * small modules the App Module owns, such as enrolled references, and blocks
+ * the main loop while the sectors are erased and programmed.
+ *
+ * @param module_uid parameter specifies the UID of the module to write.
+ * @param module_write_offset parameter specifies the offset from the start of
+ * 							the module to write the data at. module_write_offset
+ * 							should be aligned to a flash sector.
+ * @param write_bytes parameter specifies the number of bytes to write to the
+ * 							module. write_bytes should be multiple of 4.
+ * @param buffer parameter specifies the 32-bit aligned data to write.
+ *
+ * @return count of bytes written to the module. In case of error, or if the
+ * 		   data does not fit in the module, returns 0.
+ */
+uint32_t write_module_data(uint32_t       module_uid,
+						   uint32_t       module_write_offset,
+						   uint32_t       write_bytes,
+						   const uint8_t *buffer)
+{
+	return write_module_to_rfs(sd, module_uid, module_write_offset,
+							   write_bytes, buffer);
+}
+
+/**
+ * map_module_data() returns a read-only pointer to the data of the module in
+ * the memory-mapped flash, so that constant tables can be used in place
+ * without a RAM buffer and without the time to load them.
+ *
+ * @param module_uid parameter specifies the UID of the module to map.
+ * @param module_read_offset parameter specifies the offset from the start of
+ * 							the module to map the data from.
+ * @param mapped_bytes parameter is filled with the count of bytes of the module
+ * 							available from the returned pointer.
+ *
+ * @return pointer to the module data, NULL if the module is not found or the
+ * 		   flash is not mapped on this platform. read_module_data() has to be
+ * 		   used then.
+ */
+const void *map_module_data(uint32_t  module_uid,
+							uint32_t  module_read_offset,
+							uint32_t *mapped_bytes)
+{
+	return map_module_from_rfs(sd, module_uid, module_read_offset,
+							   mapped_bytes);
+}
@@ -73,30 +73,42 @@ bool auto_exposure_enabled = true;
  * by the App Module. Since the data is sent asynchronously, FW Core uses its
  * variables to send the data in the backgroud while the App Module continues to
  * generate new data to be sent.
+ *
+ * Buffers are queued oldest at the head. An entry stays queued until it has
+ * been sent, so that a burst of results is not lost while Host is catching
+ * up.
  */
-/* Buffer containing the data to be sent to Host. */
-uint8_t *app_tx_buffer;
+struct app_tx_desc app_tx_queue[APP_TX_QUEUE_DEPTH];
 
-/* Size of the above buffer. */
-uint32_t app_tx_buffer_size;
+/* Index of the oldest entry of app_tx_queue. */
+uint32_t app_tx_queue_head;
 
-/* Pointer to variable which should be set to true when tx completes. */
-uint8_t *p_app_tx_complete;
+/* Number of entries in app_tx_queue. */
+uint32_t app_tx_queue_count;
 
-#ifdef NO_CAPTURE_DONE_ISR
-/* TBD-KDB: To be removed when Capture done ISR becomes available. */
-bool capture_started = false;
-#endif
+/**
+ * Number of entries in app_tx_queue holding the ML engine output, see
+ * stream_spans_to_host_async(). The next image is not rescaled while it is
+ * not 0.
+ */
+uint32_t app_tx_ml_output_holds;
 
-#ifdef NO_ML_DONE_ISR
-/* TBD-SRP: To be removed when ML Done ISR becomes available. */
-bool ml_engine_started = false;
-#endif
+/**
+ * Interface of the Host subscribed with SUBSCRIBE_APP_DATA, NULL if none.
+ * App Module data is then pushed to it instead of raising the host IRQ.
+ */
+struct iface_instance *app_data_subscriber;
 
-#ifdef NO_RESCALE_DONE_ISR
-/* TBD-SRP: To be removed when ML Done ISR becomes available. */
+/* Results produced since the subscription, numbers the pushed packets. */
+uint32_t app_data_push_seq_num;
+
+/**
+ * A pipeline stage was started and its completion was not handled yet, be it
+ * polled or signalled by its done IRQ.
+ */
+bool capture_started   = false;
+bool ml_engine_started = false;
 bool rescaling_started = false;
-#endif
 
 #ifdef NO_BUFF_MOVE_DONE_ISR
 /* TBD-SRP: To be removed when Buffer move done ISR becomes available. */
@@ -107,7 +119,8 @@ uint32_t waiting_to_copy_image                        = false;
 
 /**
  * ml_pipeline_pause_request stores the trigger at which the pipeline should
- * transition into the paused state.
+ * transition into the paused state, that of the first owner still waiting to
+ * pause it, see pause_pipeline_for().
  */
 enum pipeline_pause_trigger ml_pipeline_pause_request = PIPELINE_PAUSE_NONE;
 
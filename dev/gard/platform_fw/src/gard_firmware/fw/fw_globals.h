@@ -11,6 +11,27 @@
 #include "gard_types.h"
 #include "iface_support.h"
 #include "pipeline_ops.h"
+#include "fw_core.h"
+#include "sw_timer.h"
+
+/**
+ * One App Module buffer queued by stream_data_to_host_async() or
+ * stream_spans_to_host_async(), of size bytes in num_spans pieces sent back to
+ * back. *p_complete, if given, is set to true once the buffer has been sent to
+ * Host.
+ */
+struct app_tx_desc {
+	struct tx_span spans[APP_TX_MAX_SPANS];
+	uint32_t       num_spans;
+	uint32_t       size;
+	bool           holds_ml_output;  // See stream_spans_to_host_async()
+	bool           framed;  // Batch buffer records, see app_tx_coalesce.h
+	uint8_t       *p_complete;
+	uint32_t       seq_num;  // Result number sent with a push, see
+							 // SUBSCRIBE_APP_DATA
+	// Cycle counter when queued, for PIPELINE_STATS__HOST_TX
+	uint64_t       queued_at;
+};
 
 /* iface_inst holds interface contexts to Host */
 extern struct iface_instance iface_inst[MAX_IFACES_SUPPORTED];
@@ -45,29 +66,31 @@ extern uint32_t app_rx_buffer_size;
 /* App Module provided callback to be called on receiving the data.*/
 extern rx_handler_t app_rx_handler;
 
-/* Buffer containing the data to be sent to Host. */
-extern uint8_t *app_tx_buffer;
+/* Ring of App Module buffers to be sent to Host, oldest at the head. */
+extern struct app_tx_desc app_tx_queue[APP_TX_QUEUE_DEPTH];
 
-/* Size of the above buffer. */
-extern uint32_t app_tx_buffer_size;
+/* Index of the oldest entry of app_tx_queue. */
+extern uint32_t app_tx_queue_head;
 
-/* Pointer to variable which should be set to true when tx completes. */
-extern uint8_t *p_app_tx_complete;
+/* Number of entries in app_tx_queue. */
+extern uint32_t app_tx_queue_count;
 
-#ifdef NO_CAPTURE_DONE_ISR
-/* TBD-KDB: To be removed when Capture done ISR becomes available. */
-extern bool capture_started;
-#endif
+/* Number of entries in app_tx_queue holding the ML engine output. */
+extern uint32_t app_tx_ml_output_holds;
 
-#ifdef NO_ML_DONE_ISR
-/* TBD-SRP: To be removed when ML Done ISR becomes available. */
-extern bool ml_engine_started;
-#endif
+/* Interface of the Host subscribed with SUBSCRIBE_APP_DATA, NULL if none. */
+extern struct iface_instance *app_data_subscriber;
+
+/* Results produced since the subscription, numbers the pushed packets. */
+extern uint32_t app_data_push_seq_num;
 
-#ifdef NO_RESCALE_DONE_ISR
-/* TBD-SRP: To be removed when ML Done ISR becomes available. */
+/**
+ * A pipeline stage was started and its completion was not handled yet, be it
+ * polled or signalled by its done IRQ.
+ */
+extern bool capture_started;
+extern bool ml_engine_started;
 extern bool rescaling_started;
-#endif
 
 #ifdef NO_BUFF_MOVE_DONE_ISR
 /* TBD-SRP: To be removed when Buffer move done ISR becomes available. */
@@ -78,7 +101,8 @@ extern uint32_t waiting_to_copy_image;
 
 /**
  * ml_pipeline_pause_request stores the trigger at which the pipeline should
- * transition into the paused state.
+ * transition into the paused state, that of the first owner still waiting to
+ * pause it, see pause_pipeline_for().
  */
 extern enum pipeline_pause_trigger ml_pipeline_pause_request;
 
@@ -100,4 +124,12 @@ extern enum pipeline_state ml_pipeline_state;
  */
 extern enum pipeline_stage_id ml_pipeline_last_completed_stage;
 
+#if defined(TEST_APP_MOD_DATA_XFER_TRIGGER)
+/**
+ * test_data_xfer_timer sends the dummy App Module data, started once the
+ * GARD_DISCOVERY response is sent.
+ */
+extern struct sw_timer test_data_xfer_timer;
+#endif
+
 #endif /* FW_GLOBALS_H */
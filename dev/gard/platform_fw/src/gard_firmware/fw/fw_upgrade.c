@@ -0,0 +1,411 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "memmap.h"
+#include "rfs.h"
+#include "ospi_support.h"
+#include "utils.h"
+#include "gard_hub_iface.h"
+#include "fw_globals.h"
+#include "fw_boot.h"
+#include "fw_upgrade.h"
+
+/**
+ * Frames run through post-processing by a freshly upgraded firmware before it
+ * confirms its slot, see fw_boot_confirm().
+ */
+#ifndef FW_UPGRADE_CONFIRM_FRAMES
+#define FW_UPGRADE_CONFIRM_FRAMES (100U)
+#endif
+
+/**
+ * Bytes of the staging buffer, or of the flash, the CRC of a chunk is
+ * computed over in a slice.
+ */
+#define FW_UPGRADE_CRC_SLICE (4U * 1024U)
+
+/**
+ * Bytes read back from the flash in a slice of the verification.
+ */
+#define FW_UPGRADE_VERIFY_SLICE (256U)
+
+GARD__CASSERT(0U == (HRAM_FW_UPGRADE_BUFFER_SIZE % FIRMWARE_UPGRADE_ALIGN),
+			  "Staging buffers must hold whole flash sectors.");
+GARD__CASSERT(FIRMWARE_UPGRADE_ALIGN == OSPI_FLASH_SECTOR_SIZE,
+			  "Chunks must start at a flash sector.");
+
+/**
+ * The steps a chunk goes through, one slice at a time.
+ */
+enum fw_upgrade_phase {
+	FW_UPGRADE_PHASE__CHECK_CRC = 0,  // CRC of the staging buffer
+	FW_UPGRADE_PHASE__ERASE,          // Erase of its flash sectors
+	FW_UPGRADE_PHASE__PROGRAM,        // Program of its flash pages
+	FW_UPGRADE_PHASE__VERIFY,         // CRC of the programmed flash
+};
+
+/**
+ * A chunk queued by Host, programmed in queue order.
+ */
+struct fw_upgrade_chunk {
+	uint32_t buffer_addr;
+	uint32_t size;
+	uint32_t flash_addr;
+	uint32_t crc;
+};
+
+/**
+ * The state of the upgrade. Chunks are programmed in queue order and each one
+ * starts where the previous one ends, so that bytes_programmed, the end of the
+ * last chunk verified, tells Host where to resume from.
+ */
+static struct {
+	uint32_t                flash_base;
+	uint32_t                target_slot;  // FW_BOOT_NUM_SLOTS for none
+	uint32_t                image_size;
+	uint32_t                bytes_queued;
+	uint32_t                bytes_programmed;
+	bool                    failed;
+	struct fw_upgrade_chunk queue[HRAM_FW_UPGRADE_NUM_BUFFERS];
+	uint32_t                queue_head;
+	uint32_t                queue_count;
+	enum fw_upgrade_phase   phase;
+	uint32_t                offset;  // Progress of the phase in the chunk
+	uint32_t                crc;     // CRC of the phase so far
+} fw_upgrade;
+
+static uint8_t verify_buf[FW_UPGRADE_VERIFY_SLICE] __attribute__((aligned(4)));
+
+/**
+ * Frames counted towards the confirmation of the running slot, and whether it
+ * is confirmed.
+ */
+static uint32_t healthy_frames = 0;
+static bool     slot_confirmed = false;
+
+/**
+ * fw_upgrade_start() opens an upgrade of an image of image_size bytes and
+ * tells Host where to send it. The bytes already programmed are kept when it
+ * resumes the last upgrade, a failure is cleared.
+ *
+ * An image of the RFS is programmed in the RFS of the slot not running, which
+ * is made active once the whole image is verified. An image with the
+ * bitstream spans slot A from the start of the flash and is not switched to,
+ * as the bitstream is only read from there.
+ *
+ * @param image_size is the size of the image in bytes.
+ * @param is_bitstream_included tells if the image starts with the bitstream,
+ * in which case it is programmed at the start of the flash, rather than at
+ * the RFS of the idle slot.
+ * @param resume tells to keep the bytes programmed by the last upgrade, if of
+ * an image of the same size and flash address.
+ * @param p_info is filled with the staging buffers and the flash address of
+ * the image, buffer_size 0 if the upgrade is refused.
+ *
+ * @return None
+ */
+void fw_upgrade_start(uint32_t                     image_size,
+					  bool                         is_bitstream_included,
+					  bool                         resume,
+					  struct fw_upgrade_xfer_info *p_info)
+{
+	uint32_t target_slot = FW_BOOT_NUM_SLOTS;
+	uint32_t flash_base  = 0U;
+	uint32_t flash_end   = FW_BOOT_SLOT_SIZE;
+
+	memset(p_info, 0, sizeof(*p_info));
+
+	if (0U != fw_upgrade.queue_count) {
+		return;
+	}
+
+	if (!is_bitstream_included) {
+		target_slot = fw_boot_running_slot(sd) ^ 1U;
+		flash_base  = FW_BOOT_SLOT_RFS_ADDR(target_slot);
+		flash_end   = (target_slot + 1U) * FW_BOOT_SLOT_SIZE;
+	}
+
+	if ((0U == image_size) || (image_size > (flash_end - flash_base))) {
+		return;
+	}
+
+	if (!resume || (image_size != fw_upgrade.image_size) ||
+		(flash_base != fw_upgrade.flash_base)) {
+		fw_upgrade.flash_base       = flash_base;
+		fw_upgrade.target_slot      = target_slot;
+		fw_upgrade.image_size       = image_size;
+		fw_upgrade.bytes_programmed = 0;
+	}
+	fw_upgrade.bytes_queued = fw_upgrade.bytes_programmed;
+	fw_upgrade.failed       = false;
+
+	p_info->buffer_address = HRAM_FW_UPGRADE_STAGING_ADDR;
+	p_info->buffer_size    = HRAM_FW_UPGRADE_BUFFER_SIZE;
+	p_info->num_buffers    = HRAM_FW_UPGRADE_NUM_BUFFERS;
+	p_info->flash_address  = flash_base;
+}
+
+/**
+ * fw_upgrade_is_buffer_free() tells if buffer_addr is a staging buffer not
+ * held by a queued chunk.
+ */
+static bool fw_upgrade_is_buffer_free(uint32_t buffer_addr)
+{
+	uint32_t idx;
+
+	if ((buffer_addr < HRAM_FW_UPGRADE_STAGING_ADDR) ||
+		(buffer_addr >=
+		 (HRAM_FW_UPGRADE_STAGING_ADDR + HRAM_FW_UPGRADE_STAGING_SIZE)) ||
+		(0U != ((buffer_addr - HRAM_FW_UPGRADE_STAGING_ADDR) %
+				HRAM_FW_UPGRADE_BUFFER_SIZE))) {
+		return false;
+	}
+
+	for (idx = 0; idx < fw_upgrade.queue_count; idx++) {
+		if (fw_upgrade
+				.queue[(fw_upgrade.queue_head + idx) %
+					   HRAM_FW_UPGRADE_NUM_BUFFERS]
+				.buffer_addr == buffer_addr) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * fw_upgrade_queue_chunk() queues the chunk Host sent to a staging buffer. The
+ * chunk has to start where the previous one ends and, but for the last one of
+ * the image, hold whole flash sectors.
+ *
+ * @param buffer_addr is the staging buffer holding the chunk.
+ * @param size is the size of the chunk in bytes.
+ * @param flash_addr is the flash address to program the chunk at.
+ * @param crc is the CRC-32 of the chunk.
+ *
+ * @return Returns true if the chunk is queued, false if it is refused.
+ */
+bool fw_upgrade_queue_chunk(uint32_t buffer_addr,
+							uint32_t size,
+							uint32_t flash_addr,
+							uint32_t crc)
+{
+	struct fw_upgrade_chunk *p_chunk;
+	uint32_t                 end;
+
+	if ((0U == fw_upgrade.image_size) || fw_upgrade.failed ||
+		(HRAM_FW_UPGRADE_NUM_BUFFERS == fw_upgrade.queue_count) ||
+		(0U == size) || (size > HRAM_FW_UPGRADE_BUFFER_SIZE) ||
+		(flash_addr != (fw_upgrade.flash_base + fw_upgrade.bytes_queued)) ||
+		!fw_upgrade_is_buffer_free(buffer_addr)) {
+		return false;
+	}
+
+	end = fw_upgrade.bytes_queued + size;
+	if ((end > fw_upgrade.image_size) ||
+		((end != fw_upgrade.image_size) &&
+		 (0U != (size % FIRMWARE_UPGRADE_ALIGN)))) {
+		return false;
+	}
+
+	p_chunk = &fw_upgrade.queue[(fw_upgrade.queue_head +
+								 fw_upgrade.queue_count) %
+								HRAM_FW_UPGRADE_NUM_BUFFERS];
+	p_chunk->buffer_addr = buffer_addr;
+	p_chunk->size        = size;
+	p_chunk->flash_addr  = flash_addr;
+	p_chunk->crc         = crc;
+
+	fw_upgrade.queue_count++;
+	fw_upgrade.bytes_queued = end;
+
+	return true;
+}
+
+/**
+ * fw_upgrade_get_status() reports the progress of the upgrade.
+ *
+ * @param p_bytes_programmed is filled with the image bytes programmed and
+ * verified from its start.
+ *
+ * @return The enum firmware_upgrade_status of the upgrade.
+ */
+uint8_t fw_upgrade_get_status(uint32_t *p_bytes_programmed)
+{
+	*p_bytes_programmed = fw_upgrade.bytes_programmed;
+
+	if (fw_upgrade.failed) {
+		return FIRMWARE_UPGRADE__FAILED;
+	}
+
+	return (0U != fw_upgrade.queue_count) ? FIRMWARE_UPGRADE__IN_PROGRESS
+										  : FIRMWARE_UPGRADE__COMPLETE;
+}
+
+/**
+ * fw_upgrade_fail() drops the queued chunks. The failure is reported until
+ * Host starts the upgrade again.
+ */
+static void fw_upgrade_fail(void)
+{
+	fw_upgrade.failed       = true;
+	fw_upgrade.queue_count  = 0;
+	fw_upgrade.bytes_queued = fw_upgrade.bytes_programmed;
+	fw_upgrade.phase        = FW_UPGRADE_PHASE__CHECK_CRC;
+	fw_upgrade.offset       = 0;
+	fw_upgrade.crc          = 0;
+}
+
+/**
+ * fw_upgrade_next_phase() moves the chunk being programmed to the given phase.
+ */
+static void fw_upgrade_next_phase(enum fw_upgrade_phase phase)
+{
+	fw_upgrade.phase  = phase;
+	fw_upgrade.offset = 0;
+	fw_upgrade.crc    = 0;
+}
+
+/**
+ * continue_fw_upgrade() runs a slice of the programming of the chunk at the
+ * head of the queue: the CRC of a slice of the staging buffer, the erase of a
+ * sector, the program of a page, or the CRC of a slice read back. While the
+ * flash is busy with an erase or a program, the slice only polls it.
+ *
+ * @return Returns true if it did some work, false if there was nothing to do.
+ */
+bool continue_fw_upgrade(void)
+{
+	struct fw_upgrade_chunk *p_chunk;
+	const uint8_t           *p_data;
+	uint32_t                 bytes;
+
+	if (0U == fw_upgrade.queue_count) {
+		return false;
+	}
+
+	p_chunk = &fw_upgrade.queue[fw_upgrade.queue_head];
+	p_data  = (const uint8_t *)(uintptr_t)p_chunk->buffer_addr;
+
+	if ((FW_UPGRADE_PHASE__CHECK_CRC != fw_upgrade.phase) &&
+		ospi_is_flash_busy(sd)) {
+		return true;
+	}
+
+	switch (fw_upgrade.phase) {
+	case FW_UPGRADE_PHASE__CHECK_CRC:
+		bytes = MIN(FW_UPGRADE_CRC_SLICE, p_chunk->size - fw_upgrade.offset);
+		fw_upgrade.crc = crc32_update(fw_upgrade.crc,
+									  &p_data[fw_upgrade.offset], bytes);
+		fw_upgrade.offset += bytes;
+
+		if (fw_upgrade.offset == p_chunk->size) {
+			if (fw_upgrade.crc != p_chunk->crc) {
+				fw_upgrade_fail();
+				break;
+			}
+			fw_upgrade_next_phase(FW_UPGRADE_PHASE__ERASE);
+		}
+		break;
+
+	case FW_UPGRADE_PHASE__ERASE:
+		if (fw_upgrade.offset >= p_chunk->size) {
+			fw_upgrade_next_phase(FW_UPGRADE_PHASE__PROGRAM);
+			break;
+		}
+
+		if (!ospi_erase_sector_async(sd,
+									 p_chunk->flash_addr + fw_upgrade.offset)) {
+			fw_upgrade_fail();
+			break;
+		}
+		fw_upgrade.offset += OSPI_FLASH_SECTOR_SIZE;
+		break;
+
+	case FW_UPGRADE_PHASE__PROGRAM:
+		if (fw_upgrade.offset == p_chunk->size) {
+			fw_upgrade_next_phase(FW_UPGRADE_PHASE__VERIFY);
+			break;
+		}
+
+		// Chunks start at a sector, their pages are aligned to the flash ones.
+		bytes = MIN(OSPI_FLASH_PAGE_SIZE, p_chunk->size - fw_upgrade.offset);
+		if (!ospi_program_page_async(
+				sd, (const uint32_t *)&p_data[fw_upgrade.offset],
+				p_chunk->flash_addr + fw_upgrade.offset, bytes)) {
+			fw_upgrade_fail();
+			break;
+		}
+		fw_upgrade.offset += bytes;
+		break;
+
+	case FW_UPGRADE_PHASE__VERIFY:
+		bytes = MIN(sizeof(verify_buf), p_chunk->size - fw_upgrade.offset);
+		if (ospi_read_from_flash(sd, verify_buf,
+								 p_chunk->flash_addr + fw_upgrade.offset,
+								 bytes) != bytes) {
+			fw_upgrade_fail();
+			break;
+		}
+		fw_upgrade.crc = crc32_update(fw_upgrade.crc, verify_buf, bytes);
+		fw_upgrade.offset += bytes;
+
+		if (fw_upgrade.offset == p_chunk->size) {
+			if (fw_upgrade.crc != p_chunk->crc) {
+				fw_upgrade_fail();
+				break;
+			}
+
+			// The whole RFS is in, boot it next, see fw_boot.h.
+			if (((p_chunk->flash_addr + p_chunk->size - fw_upgrade.flash_base) ==
+				 fw_upgrade.image_size) &&
+				(FW_BOOT_NUM_SLOTS != fw_upgrade.target_slot) &&
+				!fw_boot_activate_slot(sd, fw_upgrade.target_slot)) {
+				fw_upgrade_fail();
+				break;
+			}
+
+			// The chunk is done, its buffer is free for Host to reuse.
+			fw_upgrade.bytes_programmed =
+				p_chunk->flash_addr + p_chunk->size - fw_upgrade.flash_base;
+			fw_upgrade.queue_head =
+				(fw_upgrade.queue_head + 1U) % HRAM_FW_UPGRADE_NUM_BUFFERS;
+			fw_upgrade.queue_count--;
+			fw_upgrade_next_phase(FW_UPGRADE_PHASE__CHECK_CRC);
+		}
+		break;
+
+	default:
+		GARD__DBG_ASSERT(0, "Invalid firmware upgrade phase");
+		break;
+	}
+
+	return true;
+}
+
+/**
+ * fw_upgrade_frame_done() counts a frame run through to the end of its
+ * post-processing. Once FW_UPGRADE_CONFIRM_FRAMES are counted, the slot the
+ * firmware was booted from is confirmed, so that the loader stops counting
+ * its boots and no longer falls back to the other slot.
+ *
+ * @return None
+ */
+void fw_upgrade_frame_done(void)
+{
+	if (slot_confirmed) {
+		return;
+	}
+
+	healthy_frames++;
+	if (healthy_frames >= FW_UPGRADE_CONFIRM_FRAMES) {
+		slot_confirmed = fw_boot_confirm(sd);
+		healthy_frames = 0;
+	}
+}
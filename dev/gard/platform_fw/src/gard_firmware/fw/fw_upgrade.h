@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef FW_UPGRADE_H
+#define FW_UPGRADE_H
+
+#include "gard_types.h"
+
+/**
+ * This file defines the flash programming behind UPGRADE_FIRMWARE. The chunks
+ * of the image Host queues are checked, erased, programmed and verified by a
+ * main loop task, a slice at a time, so that Host commands, and the transfer
+ * of the next chunk, are served while the flash is busy.
+ */
+
+/**
+ * Where and how Host sends the image, see get_xfer_information_response.
+ */
+struct fw_upgrade_xfer_info {
+	uint32_t buffer_address;  // First staging buffer
+	uint32_t buffer_size;     // Size of each buffer, 0 if refused
+	uint32_t num_buffers;     // Count of buffers
+	uint32_t flash_address;   // Flash address of the start of the image
+};
+
+/**
+ * fw_upgrade_start() opens an upgrade of an image of image_size bytes. When
+ * resumed, an upgrade of the same image keeps the bytes already programmed.
+ * It is refused while queued chunks are left to program.
+ */
+void fw_upgrade_start(uint32_t                     image_size,
+					  bool                         is_bitstream_included,
+					  bool                         resume,
+					  struct fw_upgrade_xfer_info *p_info);
+
+/**
+ * fw_upgrade_queue_chunk() queues the chunk Host sent to a staging buffer for
+ * programming at flash_addr. It returns false if the chunk is refused.
+ */
+bool fw_upgrade_queue_chunk(uint32_t buffer_addr,
+							uint32_t size,
+							uint32_t flash_addr,
+							uint32_t crc);
+
+/**
+ * fw_upgrade_get_status() returns the enum firmware_upgrade_status of the
+ * upgrade and the image bytes programmed and verified from its start.
+ */
+uint8_t fw_upgrade_get_status(uint32_t *p_bytes_programmed);
+
+/**
+ * continue_fw_upgrade() runs a slice of the programming of the queued chunks.
+ * It returns true if it did some work, false if there was nothing to do.
+ */
+bool continue_fw_upgrade(void);
+
+/**
+ * fw_upgrade_frame_done() is called for each frame post-processed without an
+ * error. Enough of them confirm the firmware slot booted, see fw_boot.h.
+ */
+void fw_upgrade_frame_done(void);
+
+#endif /* FW_UPGRADE_H */
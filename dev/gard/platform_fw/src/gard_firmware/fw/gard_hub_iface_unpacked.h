@@ -15,11 +15,83 @@
  */
 
 #include "types.h"
+#include "gard_hub_iface.h"
 
 /**
  * The padded version of the structures defined in gard_hub_iface.h.
  */
 
+struct _data_frame_header_unpked {
+	uint16_t frame_num;   // Packet number, from 0
+	uint16_t frame_size;  // Bytes of data that follow
+};
+
+struct _data_frame_trailer_unpked {
+	uint32_t crc;  // CRC-32 of the packet data
+};
+
+// Firmware-only running CRC-32 of a payload, kept up while it is received or
+// sent.
+struct _data_crc_unpked {
+	uint32_t value;      // CRC-32 of the first num_bytes of the payload
+	uint32_t num_bytes;  // Bytes of the payload covered by value
+};
+
+struct _pipeline_stage_stats_unpked {
+	uint32_t count;         // Number of times the stage completed
+	uint32_t rsvd1;         // Pad bytes.
+	uint64_t min_cycles;    // Shortest duration
+	uint64_t max_cycles;    // Longest duration
+	uint64_t total_cycles;  // Sum of all the durations
+};
+
+struct _network_residency_unpked {
+	uint32_t network;              // UID of the network
+	uint32_t addr_in_ram;          // HRAM address, 0 without HRAM
+	uint32_t size;                 // Size of the network in bytes
+	uint32_t flags;                // enum network_residency_flags
+	uint32_t priority;             // Residency priority, 0 the lowest
+	uint32_t loads;                // Times it was loaded from flash
+	uint32_t runs_since_last_run;  // ML runs of others since its last run
+};
+
+struct _image_stats_unpked {
+	uint32_t frame_seq;  // Sequence number of the image
+	uint8_t  gray_avg;   // Average gray level
+	uint8_t  gray_min;   // Darkest gray level
+	uint8_t  gray_max;   // Brightest gray level
+	uint8_t  rsvd1;      // Pad byte.
+};
+
+struct _data_frame_response_unpked {
+	uint8_t  ack_or_nak;      // ACK_BYTE if the packet was taken
+	uint8_t  rsvd1;           // Pad byte.
+	uint16_t next_frame_num;  // Packet number GARD expects next
+};
+
+struct _app_data_push_header_unpked {
+	uint32_t push_marker;  // APP_DATA_PUSH_MARKER
+	uint32_t seq_num;      // Result number, from 0
+	uint32_t data_size;    // Bytes of data that follow
+};
+
+struct _response_tag_header_unpked {
+	uint8_t tag_marker;  // RESPONSE_TAG_MARKER
+	uint8_t tag;         // Tag that followed the command_id
+};
+
+struct _data_segment_header_unpked {
+	uint8_t  segment_marker;  // DATA_SEGMENT_MARKER
+	uint8_t  rsvd1;           // Pad byte
+	uint16_t segment_size;    // Bytes of payload that follow
+};
+
+struct _resync_ack_unpked {
+	uint32_t resync_ack_marker;   // RESYNC_ACK_MARKER
+	uint32_t resync_count;        // Resynchronizations since boot
+	uint32_t end_of_data_marker;  // END OF DATA marker
+};
+
 struct _host_requests_unpked {
 	uint8_t command_id;  // Command identifier having a value from enum
 						 // HostRequestCommandIdsOverUart
@@ -43,6 +115,19 @@ struct _host_requests_unpked {
 				uint32_t end_of_data_marker;  // END OF DATA marker
 				uint32_t opt_crc;             // CRC for data integrity
 			} eod;
+
+			// Firmware-only state of a payload received in packets, when
+			// CC_USE_MTU_SIZE is set.
+			struct {
+				struct _data_frame_header_unpked  hdr;
+				struct _data_frame_trailer_unpked trl;
+				uint32_t                          num_frames;
+				uint16_t                          next_frame_num;
+				uint8_t                           ack_or_nak;
+			} frame;
+
+			// Firmware-only CRC of the payload, or of the current packet.
+			struct _data_crc_unpked crc;
 		} send_data_to_gard_for_offset_request;
 
 		// struct recv_data_from_gard_at_offset_request is to be used when
@@ -84,6 +169,13 @@ struct _host_requests_unpked {
 		// command_id is CAPTURE_RESCALED_IMAGE.
 		struct _capture_rescaled_image_request_unpked {
 			uint8_t  camera_id;           // Camera to take the image.
+			uint8_t  flags;               // enum capture_rescaled_image_flags
+			uint8_t  decimation;          // 1 pixel kept in this many, 0 = 1
+			uint16_t roi_x;               // Left of the image part to send
+			uint16_t roi_y;               // Top of the image part to send
+			uint16_t roi_width;           // Width to send, 0 for whole image
+			uint16_t roi_height;          // Height to send, 0 for whole image
+			uint8_t  codec;               // enum image_codecs wanted
 			uint32_t end_of_data_marker;  // END OF DATA marker
 		} capture_rescaled_image_request_unpked;
 
@@ -93,6 +185,159 @@ struct _host_requests_unpked {
 			uint8_t  camera_id;           // Camera whose pipeline to resume.
 			uint32_t end_of_data_marker;  // END OF DATA marker
 		} resume_pipeline_request_unpked;
+
+		// struct set_uart_parameters is to be used when
+		// command_id is SET_UART_PARAMETERS.
+		struct _set_uart_parameters_request_unpked {
+			uint32_t baud_rate;           // New baud rate in bits/sec.
+			uint8_t  hw_flow_control;     // 1 for RTS/CTS, 0 for none.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} set_uart_parameters_request_unpked;
+
+		// struct read_regs_from_gard_request is to be used when
+		// command_id is READ_REGS_FROM_GARD. The register addresses and the
+		// end of data marker following them are received into payload.
+		struct _read_regs_from_gard_request_unpked {
+			struct {
+				uint16_t num_regs;  // Number of registers to read
+				uint16_t rsvd1;     // Pad bytes.
+			} cmd;
+
+			uint32_t payload[GARD_HUB_MAX_REGS_PER_CMD + 1];
+		} read_regs_from_gard_request_unpked;
+
+		// struct write_regs_to_gard_request is to be used when
+		// command_id is WRITE_REGS_TO_GARD. The (address, value) pairs and
+		// the end of data marker following them are received into payload.
+		struct _write_regs_to_gard_request_unpked {
+			struct {
+				uint16_t num_regs;  // Number of registers to write
+				uint16_t rsvd1;     // Pad bytes.
+			} cmd;
+
+			uint32_t payload[(2 * GARD_HUB_MAX_REGS_PER_CMD) + 1];
+		} write_regs_to_gard_request_unpked;
+
+		// struct subscribe_app_data_request is to be used when
+		// command_id is SUBSCRIBE_APP_DATA.
+		struct _subscribe_app_data_request_unpked {
+			uint8_t  enable;              // 1 to subscribe, 0 to unsubscribe.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} subscribe_app_data_request_unpked;
+
+		// struct get_pipeline_stats_request is to be used when
+		// command_id is GET_PIPELINE_STATS.
+		struct _get_pipeline_stats_request_unpked {
+			uint8_t  reset;               // 1 to clear the stats once sent.
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_pipeline_stats_request_unpked;
+
+		// struct get_network_residency_request is to be used when
+		// command_id is GET_NETWORK_RESIDENCY.
+		struct _get_network_residency_request_unpked {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_network_residency_request_unpked;
+
+		// struct get_image_stats_request is to be used when command_id is
+		// GET_IMAGE_STATS.
+		struct _get_image_stats_request_unpked {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_image_stats_request_unpked;
+
+		// struct get_gard_time_request is to be used when command_id is
+		// GET_GARD_TIME.
+		struct _get_gard_time_request_unpked {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_gard_time_request_unpked;
+
+		// struct run_inference_on_buffer_request is to be used when
+		// command_id is RUN_INFERENCE_ON_BUFFER. Its layout is the same as
+		// the packed one.
+		struct _run_inference_on_buffer_request_unpked {
+			uint8_t  op;                  // enum host_inference_ops
+			uint8_t  slot;                // Slot the image was written to
+			uint8_t  format;              // enum image_formats of the image
+			uint8_t  rsvd1;               // Pad bytes.
+			uint16_t width;               // Image size, in pixels
+			uint16_t height;
+			uint32_t frame_id;            // Frame sequence number of results
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} run_inference_on_buffer_request_unpked;
+
+		// struct swap_network_request is to be used when command_id is
+		// SWAP_NETWORK. Its layout is the same as the packed one.
+		struct _swap_network_request_unpked {
+			uint8_t  op;                  // enum network_swap_ops
+			uint8_t  flags;               // enum network_swap_flags
+			uint16_t rsvd1;               // Pad bytes.
+			uint32_t network;             // UID of the registered network
+			uint32_t size;                // Bytes of the new network
+			uint32_t crc;                 // CRC-32 of the new network
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} swap_network_request_unpked;
+
+		// struct app_data_coalescing_request is to be used when command_id is
+		// APP_DATA_COALESCING.
+		struct _app_data_coalescing_request_unpked {
+			uint8_t  set;                 // 1 to set enable and latency
+			uint8_t  enable;              // 1 to coalesce the app data IRQs
+			uint8_t  rsvd1[2];            // Pad bytes.
+			uint32_t max_latency_ms;      // IRQ raised again this often
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} app_data_coalescing_request_unpked;
+
+		// struct inference_rate_request is to be used when command_id is
+		// INFERENCE_RATE.
+		struct _inference_rate_request_unpked {
+			uint8_t  set;                 // 1 to set mode and param, 0 to read
+			uint8_t  mode;                // enum inference_rate_modes
+			uint32_t param;               // See enum inference_rate_modes
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} inference_rate_request_unpked;
+
+		// struct scaler_config_request is to be used when command_id is
+		// SCALER_CONFIG. Its layout is the same as the packed one, so it is
+		// copied as is.
+		struct _scaler_config_request_unpked {
+			uint8_t  set;                 // 1 to set the config, 0 to read
+			uint8_t  box_factor_x;        // Box scaler horizontal factor
+			uint8_t  box_factor_y;        // Box scaler vertical factor
+			uint8_t  rsvd1;               // Pad bytes.
+			uint16_t precrop_left;        // Box scaler input window
+			uint16_t precrop_right;
+			uint16_t precrop_upper;
+			uint16_t precrop_bottom;
+			uint16_t crop_left;           // Bilinear scaler crop window
+			uint16_t crop_right;
+			uint16_t crop_upper;
+			uint16_t crop_bottom;
+			uint16_t crop_in_width;       // Box scaler output size
+			uint16_t crop_in_height;
+			uint16_t out_width;           // Captured image size
+			uint16_t out_height;
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} scaler_config_request_unpked;
+
+		// struct app_command_request is to be used when command_id is an
+		// App Module command. The body goes to the buffer registered by the
+		// App Module.
+		struct _app_command_request_unpked {
+			uint32_t end_of_data_marker;  // END OF DATA marker
+			uint8_t  skipped_byte;        // Body of an unregistered command
+		} app_command_request_unpked;
+
+		// struct upgrade_firmware_request is to be used when command_id is
+		// UPGRADE_FIRMWARE. The fields of all the sub-commands are flattened.
+		struct _upgrade_firmware_request_unpked {
+			uint8_t  sub_command_id;         // Sub-command identifier
+			uint8_t  is_bitstream_included;  // Bitstream in image.
+			uint8_t  resume;                 // Keep the bytes programmed.
+			uint32_t firmware_size;          // Size of the firmware
+			uint32_t buffer_address;         // Buffer containing data
+			uint32_t bytes_to_write;         // Size of this data packet
+			uint32_t flash_address;          // Flash address to write to
+			uint32_t crc;                    // CRC-32 of this data packet
+		} upgrade_firmware_request_unpked;
 	};
 };
 
@@ -106,6 +351,10 @@ struct _host_responses_unpked {
 				opt_ack;  // Optional ACK byte to send after command execution
 		} send_data_to_gard_for_offset_response;
 
+		// struct data_frame_response is to be used for answering each packet
+		// of SEND_DATA_TO_GARD_FOR_OFFSET sent with CC_USE_MTU_SIZE.
+		struct _data_frame_response_unpked data_frame_response;
+
 		// struct recv_data_from_gard_at_offset_response is to be used when
 		// command_id is RECV_DATA_FROM_GARD_AT_OFFSET.
 		struct _recv_data_from_gard_at_offset_response_unpked {
@@ -117,6 +366,21 @@ struct _host_responses_unpked {
 				uint32_t end_of_data_marker;  // END OF DATA marker
 				uint32_t opt_crc;             // Optional CRC for data integrity
 			} eod;
+
+			// Firmware-only CRC of the payload, when CC_CHECKSUM_PRESENT is
+			// set.
+			struct _data_crc_unpked crc;
+
+			// Firmware-only progress of a CC_APP_DATA_BATCH payload.
+			uint32_t num_records;        // Queued buffers being sent
+			uint32_t record_idx;         // Buffer being sent
+			uint32_t record_phase;       // Its size or its data going out
+			uint32_t record_size;        // Bytes of it, sent ahead of them
+			uint32_t record_bytes_left;  // Payload bytes not yet sent
+
+			// Firmware-only progress of a CC_SEGMENTED payload.
+			struct _data_segment_header_unpked seg_hdr;
+			uint32_t seg_bytes_done;  // Payload bytes of the segments sent
 		} recv_data_from_gard_at_offset_response;
 
 		// struct read_reg_value_from_gard_at_offset_response is to be used when
@@ -147,8 +411,12 @@ struct _host_responses_unpked {
 		struct _gard_discovery_response_unpked {
 			uint32_t start_of_data_marker;  // START OF DATA marker
 			uint8_t  signature[10];         // Signature for discovery response
+			uint32_t device_id[2];  // Unique id of the GARD, low word first
+			uint32_t profile_id;    // GARD profile, for gard_<id>.json
+			uint32_t fw_version;    // Major << 16 | minor << 8 | bug fix
+			uint32_t capabilities;  // enum gard_capabilities bits
+			uint32_t max_mtu_size;  // Largest mtu_size GARD takes, in bytes
 			uint32_t end_of_data_marker;    // END OF DATA marker
-			// No data present in the discovery response body
 		} gard_discovery_response;
 
 		// struct capture_rescaled_image_response is to be used when
@@ -160,6 +428,12 @@ struct _host_responses_unpked {
 			uint16_t h_size;                // Horizontal size of the image.
 			uint16_t v_size;                // Vertical size of the image.
 			uint32_t image_format;  // Definition from enum image_formats
+			uint8_t  pipeline_paused;  // 1 if RESUME_PIPELINE is to be sent
+			uint8_t  codec;            // enum image_codecs of the image
+			uint8_t  rsvd1[2];         // Pad bytes.
+			uint32_t frame_seq;        // Sequence number of the image
+			uint32_t capture_time_lo;  // GARD time its capture started at,
+			uint32_t capture_time_hi;  // see GET_GARD_TIME
 
 			struct {
 				uint32_t end_of_data_marker;  // END OF DATA marker
@@ -171,6 +445,207 @@ struct _host_responses_unpked {
 		struct _resume_pipeline_response_unpked {
 			uint8_t ack_or_nak;  // Pipeline resume status
 		} resume_pipeline_response_unpked;
+
+		// struct set_uart_parameters_response is to be used when
+		// command_id is SET_UART_PARAMETERS.
+		struct _set_uart_parameters_response_unpked {
+			uint8_t ack_or_nak;  // Parameters accepted status
+		} set_uart_parameters_response_unpked;
+
+		// struct read_regs_from_gard_response is to be used when
+		// command_id is READ_REGS_FROM_GARD. The end of data marker is
+		// placed in reg_value right after the last value read.
+		struct _read_regs_from_gard_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_regs;              // Number of values that follow
+			uint32_t reg_value[GARD_HUB_MAX_REGS_PER_CMD + 1];
+		} read_regs_from_gard_response_unpked;
+
+		// struct write_regs_to_gard_response is to be used when
+		// command_id is WRITE_REGS_TO_GARD.
+		struct _write_regs_to_gard_response_unpked {
+			uint8_t ack;  // ACK byte to send after all writes complete
+		} write_regs_to_gard_response_unpked;
+
+		// struct subscribe_app_data_response is to be used when
+		// command_id is SUBSCRIBE_APP_DATA.
+		struct _subscribe_app_data_response_unpked {
+			uint8_t ack_or_nak;  // Subscription changed status
+		} subscribe_app_data_response_unpked;
+
+		// struct get_pipeline_stats_response is to be used when
+		// command_id is GET_PIPELINE_STATS. Its layout is the same as the
+		// packed one, so it is sent as is.
+		struct _get_pipeline_stats_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t cycles_per_us;         // CPU clock, to convert cycles
+			uint32_t num_stages;            // PIPELINE_STATS__NUM_STAGES
+			uint32_t rsvd1;                 // Pad bytes.
+			struct _pipeline_stage_stats_unpked
+				stages[PIPELINE_STATS__NUM_STAGES];
+
+			struct {
+				uint32_t rsvd2;               // Pad bytes.
+				uint32_t end_of_data_marker;  // END OF DATA marker
+			} eod;
+		} get_pipeline_stats_response_unpked;
+
+		// struct get_network_residency_response is to be used when
+		// command_id is GET_NETWORK_RESIDENCY. Its layout is the same as the
+		// packed one, so it is sent as is.
+		struct _get_network_residency_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_networks;          // Valid entries of networks
+			uint32_t free_bytes;            // Free HRAM for networks
+			uint32_t largest_free_bytes;    // Largest free block of it
+			struct _network_residency_unpked
+				networks[NETWORK_RESIDENCY__MAX_NETWORKS];
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_network_residency_response_unpked;
+
+		// struct get_image_stats_response is to be used when command_id is
+		// GET_IMAGE_STATS. Its layout is the same as the packed one, so it is
+		// sent as is.
+		struct _get_image_stats_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t num_stats;             // Valid entries of stats
+			uint32_t images_recorded;       // Images captured since boot
+			struct _image_stats_unpked stats[IMAGE_STATS__HISTORY];
+			uint32_t end_of_data_marker;  // END OF DATA marker
+		} get_image_stats_response_unpked;
+
+		// struct get_gard_time_response is to be used when command_id is
+		// GET_GARD_TIME. Its layout is the same as the packed one, so it is
+		// sent as is.
+		struct _get_gard_time_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t time_lo;               // Low 32 bits of the time
+			uint32_t time_hi;               // High 32 bits of the time
+			uint32_t timer_freq;            // Ticks per second
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} get_gard_time_response_unpked;
+
+		// struct run_inference_on_buffer_response is to be used when
+		// command_id is RUN_INFERENCE_ON_BUFFER. Its layout is the same as
+		// the packed one, so it is sent as is.
+		struct _run_inference_on_buffer_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless op is refused
+			uint8_t  active;                // 1 while running Host images
+			uint8_t  free_slots;            // Bit n set if slot n is free
+			uint8_t  rsvd1;                 // Pad bytes.
+			uint32_t slot_address[HOST_INFERENCE__SLOTS];  // In GARD HRAM
+			uint32_t slot_size;             // Bytes a slot holds
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} run_inference_on_buffer_response_unpked;
+
+		// struct swap_network_response is to be used when command_id is
+		// SWAP_NETWORK. Its layout is the same as the packed one, so it is
+		// sent as is.
+		struct _swap_network_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless op is refused
+			uint8_t  status;                // enum network_swap_status
+			uint16_t rsvd1;                 // Pad bytes.
+			uint32_t network;               // UID of the network swapped
+			uint32_t staging_address;       // In GARD HRAM, 0 if none
+			uint32_t staging_size;          // Bytes set aside there
+			uint32_t bytes_persisted;       // Of the RFS copy, once PERSISTING
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} swap_network_response_unpked;
+
+		// struct app_data_coalescing_response is to be used when command_id is
+		// APP_DATA_COALESCING. Its layout is the same as the packed one, so it
+		// is sent as is.
+		struct _app_data_coalescing_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  enabled;               // 1 if coalescing
+			uint8_t  rsvd1[2];              // Pad bytes.
+			uint32_t max_latency_ms;        // In use
+			uint32_t irqs_raised;           // App data IRQs raised
+			uint32_t results_coalesced;     // Results not raising the IRQ
+			uint32_t results_copied;        // Into the batch buffer
+			uint32_t results_dropped;       // No room in queue nor batch
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} app_data_coalescing_response_unpked;
+
+		// struct inference_rate_response is to be used when command_id is
+		// INFERENCE_RATE. Its layout is the same as the packed one, so it is
+		// sent as is.
+		struct _inference_rate_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  mode;                  // enum inference_rate_modes in use
+			uint8_t  rsvd1[2];              // Pad bytes.
+			uint32_t param;                 // param in use
+			uint32_t frames_offered;        // Images ready for the ML engine
+			uint32_t frames_run;            // Images the ML engine was run on
+			uint32_t offered_mfps;          // Rate of the images offered
+			uint32_t run_mfps;              // Rate of the images run on
+			uint32_t run_interval;          // One image run in this many now
+			uint32_t wake_us;               // Camera wake-up, DUTY_CYCLE
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} inference_rate_response_unpked;
+
+		// struct scaler_config_response is to be used when command_id is
+		// SCALER_CONFIG. Its layout is the same as the packed one, so it is
+		// sent as is.
+		struct _scaler_config_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint8_t  ack_or_nak;            // ACK_BYTE unless a set is refused
+			uint8_t  applied;               // 1 once captures use the config
+			uint8_t  box_factor_x;          // See scaler_config_request
+			uint8_t  box_factor_y;
+			uint16_t precrop_left;
+			uint16_t precrop_right;
+			uint16_t precrop_upper;
+			uint16_t precrop_bottom;
+			uint16_t crop_left;
+			uint16_t crop_right;
+			uint16_t crop_upper;
+			uint16_t crop_bottom;
+			uint16_t crop_in_width;
+			uint16_t crop_in_height;
+			uint16_t out_width;
+			uint16_t out_height;
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} scaler_config_response_unpked;
+
+		// struct app_command_response is to be used when command_id is an
+		// App Module command. Its layout is the same as the packed one, so it
+		// is sent as is.
+		struct _app_command_response_unpked {
+			uint32_t start_of_data_marker;  // START OF DATA marker
+			uint32_t status;                // Returned by the App Module
+			uint32_t end_of_data_marker;    // END OF DATA marker
+		} app_command_response_unpked;
+
+		// struct upgrade_firmware_response is to be used when command_id is
+		// UPGRADE_FIRMWARE. Its layout is the same as the packed one, so the
+		// part of the sub-command is sent as is.
+		struct _upgrade_firmware_response_unpked {
+			union {
+				struct {
+					uint32_t start_of_data_marker;  // START OF DATA marker
+					uint32_t buffer_address;        // First buffer address.
+					uint32_t buffer_size;           // Buffer size, 0 if refused
+					uint32_t flash_address;         // Flash address.
+					uint32_t num_buffers;           // Count of buffers.
+					uint32_t end_of_data_marker;    // END OF DATA marker
+				} get_xfer_information_response;
+
+				struct {
+					uint8_t ack;  // ACK if the chunk is queued, NAK otherwise
+				} write_firmware_to_flash_response;
+
+				struct {
+					uint8_t  operation_status;  // enum firmware_upgrade_status
+					uint8_t  rsvd1[3];          // Pad bytes
+					uint32_t bytes_programmed;  // Image bytes programmed
+				} is_operation_complete_response;
+			};
+		} upgrade_firmware_response_unpked;
 	};
 };
 
@@ -12,18 +12,34 @@
 #include "gard_hub_iface_unpacked.h"
 #include "iface_support.h"
 #include "utils.h"
+#include "cpu.h"
+#include "version.h"
 #include "fw_globals.h"
 #include "ml_ops.h"
 #include "camera_capture.h"
 #include "pipeline_ops.h"
+#include "pipeline_stats.h"
+#include "inference_rate.h"
+#include "image_stats.h"
+#include "fw_upgrade.h"
+#include "network_swap.h"
+#include "app_tx_coalesce.h"
+#include "fw_core.h"
+#include "synthetic_bench.h"
 
 enum host_request_service_state {
 	REQUEST_IFACE_TO_RECV_CMD_ID = 1,
 	IFACE_WAIT_FOR_CMD_ID,
+	IFACE_WAIT_FOR_CMD_TAG,
 	IFACE_CALCULATE_CMD_BODY_SIZE,
 	REQUEST_IFACE_TO_RECV_CMD_BODY,
 	IFACE_WAIT_FOR_CMD_BODY,
+	IFACE_WAIT_FOR_NEXT_CMD,
+	IFACE_SEND_RESPONSE_TAG,
+	IFACE_WAIT_FOR_RESPONSE_TAG_SEND,
 	EXECUTE_HOST_IFACE_CMD,
+	IFACE_SEND_RESYNC_ACK,
+	IFACE_WAIT_FOR_RESYNC_ACK_SEND,
 
 	// Following states are for SEND_DATA_TO_GARD_FOR_OFFSET command
 	EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__START_PROCESSING,
@@ -37,12 +53,31 @@ enum host_request_service_state {
 	EXEC_SEND_DATA_TO_GARD_FOR_OFFSET___WAIT_FOR_ACK_TO_SEND,
 	EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__END_PROCESSING,
 
+	// Following states are for SEND_DATA_TO_GARD_FOR_OFFSET command sent
+	// with CC_USE_MTU_SIZE
+	EXEC_SEND_DATA_FRAMES_TO_GARD__START_PROCESSING,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__VALIDATE_PARAMETERS,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_HEADER,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_HEADER,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_DATA,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_DATA,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_TRAILER,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_TRAILER,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__VALIDATE_FRAME,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__SEND_FRAME_RESPONSE,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_LAST_RESPONSE_SEND,
+	EXEC_SEND_DATA_FRAMES_TO_GARD__END_PROCESSING,
+
 	// Following states are for RECV_DATA_FROM_GARD_AT_OFFSET command
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__START_PROCESSING,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_START_OF_DATA_MARKER,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SOD_SEND,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_PAYLOAD,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_PAYLOAD_SEND,
+	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_SEGMENT_HEADER,
+	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_HEADER_SEND,
+	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_SEND,
+	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_YIELD_SEND,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_END_OF_DATA_MARKER,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_EOD_SEND,
 	EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__END_PROCESSING,
@@ -94,8 +129,215 @@ enum host_request_service_state {
 	EXECUTE_CMD_RESUME_PIPELINE__SEND_RESPONSE_TO_HOST,
 	EXECUTE_CMD_RESUME_PIPELINE__WAIT_FOR_RESPONSE_SEND,
 	EXECUTE_CMD_RESUME_PIPELINE__END_PROCESSING,
+
+	EXECUTE_CMD_SET_UART_PARAMETERS__START_PROCESSING,
+	EXECUTE_CMD_SET_UART_PARAMETERS__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_SET_UART_PARAMETERS__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_SET_UART_PARAMETERS__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_LINE_IDLE,
+	EXECUTE_CMD_SET_UART_PARAMETERS__APPLY_PARAMETERS,
+	EXECUTE_CMD_SET_UART_PARAMETERS__END_PROCESSING,
+
+	// Following states are for READ_REGS_FROM_GARD command
+	EXECUTE_CMD_READ_REGS_FROM_GARD__START_PROCESSING,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__REQ_PAYLOAD,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_PAYLOAD,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__VALIDATE_EOD_MARKER,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_READ_REGS_FROM_GARD__END_PROCESSING,
+
+	// Following states are for WRITE_REGS_TO_GARD command
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__START_PROCESSING,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__REQ_PAYLOAD,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_PAYLOAD,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__VALIDATE_EOD_MARKER,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__WRITE_REGS_TO_GARD,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_WRITE_REGS_TO_GARD__END_PROCESSING,
+
+	// Following states are for SUBSCRIBE_APP_DATA command
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__START_PROCESSING,
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_SUBSCRIBE_APP_DATA__END_PROCESSING,
+
+	// Following states are for GET_PIPELINE_STATS command
+	EXECUTE_CMD_GET_PIPELINE_STATS__START_PROCESSING,
+	EXECUTE_CMD_GET_PIPELINE_STATS__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_GET_PIPELINE_STATS__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_GET_PIPELINE_STATS__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_GET_PIPELINE_STATS__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_GET_PIPELINE_STATS__END_PROCESSING,
+
+	// Following states are for GET_NETWORK_RESIDENCY command
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__START_PROCESSING,
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_GET_NETWORK_RESIDENCY__END_PROCESSING,
+
+	// Following states are for INFERENCE_RATE command
+	EXECUTE_CMD_INFERENCE_RATE__START_PROCESSING,
+	EXECUTE_CMD_INFERENCE_RATE__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_INFERENCE_RATE__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_INFERENCE_RATE__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_INFERENCE_RATE__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_INFERENCE_RATE__END_PROCESSING,
+
+	// Following states are for SCALER_CONFIG command
+	EXECUTE_CMD_SCALER_CONFIG__START_PROCESSING,
+	EXECUTE_CMD_SCALER_CONFIG__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_SCALER_CONFIG__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_SCALER_CONFIG__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_SCALER_CONFIG__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_SCALER_CONFIG__END_PROCESSING,
+
+	// Following states are for GET_IMAGE_STATS command
+	EXECUTE_CMD_GET_IMAGE_STATS__START_PROCESSING,
+	EXECUTE_CMD_GET_IMAGE_STATS__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_GET_IMAGE_STATS__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_GET_IMAGE_STATS__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_GET_IMAGE_STATS__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_GET_IMAGE_STATS__END_PROCESSING,
+
+	// Following states are for GET_GARD_TIME command
+	EXECUTE_CMD_GET_GARD_TIME__START_PROCESSING,
+	EXECUTE_CMD_GET_GARD_TIME__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_GET_GARD_TIME__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_GET_GARD_TIME__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_GET_GARD_TIME__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_GET_GARD_TIME__END_PROCESSING,
+
+	// Following states are for RUN_INFERENCE_ON_BUFFER command
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__START_PROCESSING,
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__END_PROCESSING,
+
+	// Following states are for SWAP_NETWORK command
+	EXECUTE_CMD_SWAP_NETWORK__START_PROCESSING,
+	EXECUTE_CMD_SWAP_NETWORK__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_SWAP_NETWORK__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_SWAP_NETWORK__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_SWAP_NETWORK__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_SWAP_NETWORK__END_PROCESSING,
+
+	// Following states are for APP_DATA_COALESCING command
+	EXECUTE_CMD_APP_DATA_COALESCING__START_PROCESSING,
+	EXECUTE_CMD_APP_DATA_COALESCING__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_APP_DATA_COALESCING__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_APP_DATA_COALESCING__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_APP_DATA_COALESCING__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_APP_DATA_COALESCING__END_PROCESSING,
+
+	// Following states are for UPGRADE_FIRMWARE command
+	EXECUTE_CMD_UPGRADE_FIRMWARE__START_PROCESSING,
+	EXECUTE_CMD_UPGRADE_FIRMWARE__VALIDATE_PARAMETERS,
+	EXECUTE_CMD_UPGRADE_FIRMWARE__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_UPGRADE_FIRMWARE__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_UPGRADE_FIRMWARE__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_UPGRADE_FIRMWARE__END_PROCESSING,
+
+	// Following states are for the App Module commands
+	EXECUTE_CMD_APP_COMMAND__START_PROCESSING,
+	EXECUTE_CMD_APP_COMMAND__REQ_PAYLOAD,
+	EXECUTE_CMD_APP_COMMAND__WAIT_FOR_PAYLOAD,
+	EXECUTE_CMD_APP_COMMAND__WAIT_FOR_EOD_MARKER,
+	EXECUTE_CMD_APP_COMMAND__VALIDATE_EOD_MARKER,
+	EXECUTE_CMD_APP_COMMAND__COMPOSE_RESPONSE_TO_SEND,
+	EXECUTE_CMD_APP_COMMAND__SEND_RESPONSE_TO_HOST,
+	EXECUTE_CMD_APP_COMMAND__WAIT_FOR_RESPONSE_SEND,
+	EXECUTE_CMD_APP_COMMAND__SKIP_BODY,
+	EXECUTE_CMD_APP_COMMAND__WAIT_FOR_SKIPPED_BYTE,
+	EXECUTE_CMD_APP_COMMAND__END_PROCESSING,
+};
+
+/**
+ * States of the push of an App Module result to a subscribed Host. They are
+ * kept apart from host_request_service_state since a push runs while the
+ * interface waits for the next command id.
+ */
+enum app_data_push_state {
+	APP_DATA_PUSH__IDLE = 0,
+	APP_DATA_PUSH__WAIT_FOR_HEADER_SEND,
+	APP_DATA_PUSH__WAIT_FOR_PAYLOAD_SEND,
+	APP_DATA_PUSH__WAIT_FOR_EOD_SEND,
+};
+
+/**
+ * States of the next command taken in while the response of the current one
+ * is being sent, see receive_next_host_request().
+ */
+enum next_host_request_state {
+	NEXT_REQUEST__IDLE = 0,
+	NEXT_REQUEST__WAIT_FOR_CMD_ID,
+	NEXT_REQUEST__WAIT_FOR_CMD_TAG,
+	NEXT_REQUEST__WAIT_FOR_CMD_BODY,
+	NEXT_REQUEST__READY,
+};
+
+/**
+ * host_cmd_unpack_t unpacks the body of a command, received packed in
+ * iface_host_req, to host_req.
+ */
+typedef void (*host_cmd_unpack_t)(struct _host_requests_unpked *host_req,
+								  const struct _host_requests  *iface_host_req);
+
+/**
+ * host_cmd_exec_t runs one step of the state machine of a command, see the
+ * exec_*() functions.
+ */
+typedef bool (*host_cmd_exec_t)(struct iface_instance           *inst,
+								enum host_request_service_state *current_state,
+								struct _host_requests_unpked    *host_req,
+								struct _host_responses_unpked   *host_resp);
+
+/**
+ * struct host_cmd_desc tells how a command is handled: the size of its body
+ * following the command id, how to unpack it and the state machine running
+ * the command from first_state, all of its states being in first_state to
+ * last_state.
+ */
+struct host_cmd_desc {
+	uint32_t                        body_size;
+	host_cmd_unpack_t               unpack;  // NULL if nothing to unpack.
+	host_cmd_exec_t                 exec;    // NULL for an unknown command.
+	enum host_request_service_state first_state;
+	enum host_request_service_state last_state;
+};
+
+/**
+ * struct app_host_cmd is an App Module command registered with
+ * register_host_command().
+ */
+struct app_host_cmd {
+	uint8_t           *p_body;
+	uint32_t           body_size;
+	host_cmd_handler_t handler;  // NULL if the command is not registered.
+	app_handle_t       app_context;
 };
 
+static struct app_host_cmd
+	app_host_cmds[APP_COMMAND_ID_LAST - APP_COMMAND_ID_FIRST + 1U];
+
+/**
+ * Maximum error in percent between the requested baud rate and the rate
+ * the UART clock divisor can actually generate.
+ */
+#define UART_BAUD_RATE_MAX_ERROR_PERCENT 3U
+
 /**
  * host_request_init initializes the host request service module by initializing
  * all the variables that it needs for its operation. It initializes all the
@@ -121,11 +363,56 @@ bool host_request_init(void)
 		iface_inst[iface_idx].hc_data.tx_done = false;
 		iface_inst[iface_idx].hc_data.host_request_service_state =
 			REQUEST_IFACE_TO_RECV_CMD_ID;
+		iface_inst[iface_idx].hc_data.push_state     = APP_DATA_PUSH__IDLE;
+		iface_inst[iface_idx].hc_data.is_tagged      = false;
+		iface_inst[iface_idx].hc_data.next_req_state = NEXT_REQUEST__IDLE;
+		iface_inst[iface_idx].hc_data.bulk_lane.state = 0;
+		iface_inst[iface_idx].hc_data.resync_ack.resync_count = 0U;
 	}
 
+	app_data_subscriber = NULL;
+
 	return (valid_ifaces > 0);
 }
 
+/**
+ * register_host_command registers a command of the App Module, handled by
+ * FW Core as any of its own commands: the command body is received in body,
+ * app_cmd_handler is called and the status it returns is sent to Host.
+ * Registering a command id again replaces the previous registration.
+ *
+ * @param command_id: Command id, from APP_COMMAND_ID_FIRST to
+ *                    APP_COMMAND_ID_LAST.
+ * @param body: Buffer receiving the command body, of body_size bytes.
+ * @param body_size: Size of the command body, 0 if the command has none.
+ * @param app_cmd_handler: App Module function handling the command.
+ * @param app_context: App Module context passed to app_cmd_handler.
+ *
+ * @return true if the command is registered, false if a parameter is invalid.
+ */
+bool register_host_command(uint8_t            command_id,
+						   uint8_t           *body,
+						   uint32_t           body_size,
+						   host_cmd_handler_t app_cmd_handler,
+						   app_handle_t       app_context)
+{
+	struct app_host_cmd *p_app_cmd;
+
+	if ((command_id < APP_COMMAND_ID_FIRST) ||
+		(command_id > APP_COMMAND_ID_LAST) || (NULL == app_cmd_handler) ||
+		((NULL == body) && (body_size > 0U))) {
+		return false;
+	}
+
+	p_app_cmd              = &app_host_cmds[command_id - APP_COMMAND_ID_FIRST];
+	p_app_cmd->p_body      = body;
+	p_app_cmd->body_size   = body_size;
+	p_app_cmd->app_context = app_context;
+	p_app_cmd->handler     = app_cmd_handler;
+
+	return true;
+}
+
 /**
  * set_rx_done sets the flag rx_done to the value passed as parameter.
  *
@@ -149,6 +436,524 @@ void set_tx_done(struct iface_instance *inst)
 	inst->hc_data.tx_done = true;
 }
 
+/**
+ * crc_data_in_flight extends the running CRC of a payload over the bytes the
+ * interface has moved since the last call. Called on every poll while the
+ * payload is being received or sent, it spreads the CRC over the transfer
+ * instead of adding it after the last byte.
+ *
+ * @param p_crc: Pointer to the running CRC of the payload.
+ * @param p_data: Pointer to the start of the payload.
+ * @param num_bytes: Number of bytes of the payload moved so far.
+ */
+static void crc_data_in_flight(struct _data_crc_unpked *p_crc,
+							   const uint8_t           *p_data,
+							   uint32_t                 num_bytes)
+{
+	if (num_bytes > p_crc->num_bytes) {
+		p_crc->value     = crc32_update(p_crc->value, p_data + p_crc->num_bytes,
+										num_bytes - p_crc->num_bytes);
+		p_crc->num_bytes = num_bytes;
+	}
+}
+
+/**
+ * The queued App Module buffer idx entries after the oldest one.
+ */
+static inline struct app_tx_desc *app_tx_queue_entry(uint32_t idx)
+{
+	return &app_tx_queue[(app_tx_queue_head + idx) % APP_TX_QUEUE_DEPTH];
+}
+
+/**
+ * seal_app_tx is called once the oldest num_entries queued buffers start
+ * going out, so that the batch buffer among them, if any, keeps the size
+ * being sent, see app_tx_coalesce.h.
+ *
+ * @param num_entries: Number of buffers going out.
+ */
+static void seal_app_tx(uint32_t num_entries)
+{
+	uint32_t idx;
+
+	for (idx = 0; (idx < num_entries) && (idx < app_tx_queue_count); idx++) {
+		if (app_tx_queue_entry(idx)->framed) {
+			app_tx_coalesce_sealed();
+		}
+	}
+}
+
+/**
+ * complete_app_tx takes the oldest num_entries buffers off the App Module
+ * queue once they have been sent, flagging each one complete for the App
+ * Module.
+ *
+ * @param num_entries: Number of buffers sent.
+ */
+static void complete_app_tx(uint32_t num_entries)
+{
+	struct app_tx_desc *p_desc;
+	bool                was_batch = false;
+
+	while ((num_entries-- > 0U) && (app_tx_queue_count > 0U)) {
+		p_desc = app_tx_queue_entry(0);
+		was_batch |= p_desc->framed;
+		if (NULL != p_desc->p_complete) {
+			*p_desc->p_complete = true;
+		}
+		if (p_desc->holds_ml_output) {
+			app_tx_ml_output_holds--;
+		}
+		pipeline_stats_add(PIPELINE_STATS__HOST_TX,
+						   pipeline_stats_now() - p_desc->queued_at);
+
+		app_tx_queue_head = (app_tx_queue_head + 1U) % APP_TX_QUEUE_DEPTH;
+		app_tx_queue_count--;
+	}
+
+	app_tx_coalesce_fetched(was_batch);
+}
+
+/**
+ * start_app_tx_spans sets up the send of a queued App Module buffer by
+ * send_app_tx_spans().
+ *
+ * @param inst: Pointer to the interface instance structure.
+ */
+static inline void start_app_tx_spans(struct iface_instance *inst)
+{
+	inst->hc_data.app_tx.span_idx   = 0;
+	inst->hc_data.app_tx.span_size  = 0;
+	inst->hc_data.app_tx.bytes_done = 0;
+}
+
+/**
+ * send_app_tx_spans sends the first size bytes of a queued App Module buffer,
+ * one span after the other, keeping the payload CRC up with them if p_crc is
+ * given. It is called again until it returns true, after start_app_tx_spans().
+ *
+ * @param inst: Pointer to the interface instance structure.
+ * @param p_desc: The queued buffer.
+ * @param size: Bytes of the buffer to send, at most its size.
+ * @param p_crc: CRC of the payload the buffer is sent in, or NULL.
+ *
+ * @return true once the size bytes are sent, false while more are to be sent.
+ */
+static bool send_app_tx_spans(struct iface_instance    *inst,
+							  const struct app_tx_desc *p_desc,
+							  uint32_t                  size,
+							  struct _data_crc_unpked  *p_crc)
+{
+	const struct tx_span *p_span;
+	uint32_t              span_size;
+
+	while (true) {
+		p_span = &p_desc->spans[inst->hc_data.app_tx.span_idx];
+
+		if (0U != inst->hc_data.app_tx.span_size) {
+			span_size = inst->hc_data.app_tx.span_size;
+			if (!inst->hc_data.tx_done) {
+				if (NULL != p_crc) {
+					crc_data_in_flight(p_crc, (const uint8_t *)p_span->p_data,
+									   inst->bytes_sent);
+				}
+				return false;
+			}
+
+			if (NULL != p_crc) {
+				crc_data_in_flight(p_crc, (const uint8_t *)p_span->p_data,
+								   span_size);
+			}
+			inst->hc_data.app_tx.bytes_done += span_size;
+			inst->hc_data.app_tx.span_size   = 0;
+			inst->hc_data.app_tx.span_idx++;
+			p_span++;
+		}
+
+		if ((inst->hc_data.app_tx.bytes_done >= size) ||
+			(inst->hc_data.app_tx.span_idx >= p_desc->num_spans)) {
+			return true;
+		}
+
+		span_size = size - inst->hc_data.app_tx.bytes_done;
+		if (span_size > p_span->size) {
+			span_size = p_span->size;
+		}
+		inst->hc_data.app_tx.span_size = span_size;
+
+		if (NULL != p_crc) {
+			p_crc->num_bytes = 0;
+		}
+		inst->hc_data.tx_done = false;
+		inst->send_data_async_call(inst, span_size,
+								   (const uint8_t *)p_span->p_data);
+	}
+}
+
+// Phases of a record of a CC_APP_DATA_BATCH payload.
+enum app_data_record_phase {
+	APP_DATA_RECORD__SEND_SIZE = 0,
+	APP_DATA_RECORD__WAIT_FOR_SIZE_SEND,
+	APP_DATA_RECORD__WAIT_FOR_DATA_SEND,
+};
+
+/**
+ * plan_app_data_batch picks the queued App Module buffers that go out in one
+ * CC_APP_DATA_BATCH response of at most max_size payload bytes. The oldest
+ * buffer is cut down to fit if needed, so that a large buffer is never stuck.
+ *
+ * @param p_resp: Pointer to the response, whose batch fields are set up.
+ * @param max_size: Payload size asked for by Host.
+ *
+ * @return Payload size of the response.
+ */
+static uint32_t plan_app_data_batch(
+	struct _recv_data_from_gard_at_offset_response_unpked *p_resp,
+	uint32_t                                               max_size)
+{
+	uint32_t record_size = sizeof(p_resp->record_size);
+	uint32_t total_size  = 0;
+	uint32_t size;
+	uint32_t idx;
+
+	p_resp->num_records  = 0;
+	p_resp->record_idx   = 0;
+	p_resp->record_phase = APP_DATA_RECORD__SEND_SIZE;
+
+	// Skipped while subscribed, the data is pushed.
+	if (NULL != app_data_subscriber) {
+		return 0;
+	}
+
+	for (idx = 0; idx < app_tx_queue_count; idx++) {
+		// The batch buffer holds records already.
+		size = app_tx_queue_entry(idx)->size;
+		if (!app_tx_queue_entry(idx)->framed) {
+			size += record_size;
+		}
+
+		if (total_size + size > max_size) {
+			break;
+		}
+		total_size += size;
+	}
+
+	if ((0U == idx) && (app_tx_queue_count > 0U) && (max_size > record_size)) {
+		total_size = max_size;
+		idx        = 1;
+	}
+
+	p_resp->num_records       = idx;
+	p_resp->record_bytes_left = total_size;
+	seal_app_tx(idx);
+
+	return total_size;
+}
+
+/**
+ * send_app_data_batch sends the records of a CC_APP_DATA_BATCH payload, one
+ * size and one buffer at a time, keeping the payload CRC up with them.
+ *
+ * @param inst: Pointer to the interface instance structure.
+ * @param p_req: Pointer to the request.
+ * @param p_resp: Pointer to the response set up by plan_app_data_batch().
+ *
+ * @return true once all records are sent, false while more are to be sent.
+ */
+static bool send_app_data_batch(
+	struct iface_instance                                 *inst,
+	struct _recv_data_from_gard_at_offset_request_unpked  *p_req,
+	struct _recv_data_from_gard_at_offset_response_unpked *p_resp)
+{
+	struct app_tx_desc *p_desc;
+	bool                crc_needed = p_req->control_code & CC_CHECKSUM_PRESENT;
+
+	while (p_resp->record_idx < p_resp->num_records) {
+		p_desc = app_tx_queue_entry(p_resp->record_idx);
+
+		switch (p_resp->record_phase) {
+		case APP_DATA_RECORD__SEND_SIZE:
+			if (p_desc->framed) {
+				// The batch buffer holds its records with their sizes.
+				p_resp->record_size =
+					MIN(p_resp->record_bytes_left, p_desc->size);
+				p_resp->record_bytes_left -= p_resp->record_size;
+				p_resp->record_phase = APP_DATA_RECORD__WAIT_FOR_SIZE_SEND;
+				break;
+			}
+
+			p_resp->record_size =
+				p_resp->record_bytes_left - sizeof(p_resp->record_size);
+			if (p_resp->record_size > p_desc->size) {
+				p_resp->record_size = p_desc->size;
+			}
+			p_resp->record_bytes_left -=
+				sizeof(p_resp->record_size) + p_resp->record_size;
+
+			if (crc_needed) {
+				p_resp->crc.value = crc32_update(
+					p_resp->crc.value, (const uint8_t *)&p_resp->record_size,
+					sizeof(p_resp->record_size));
+			}
+
+			inst->hc_data.tx_done = false;
+			inst->send_data_async_call(inst, sizeof(p_resp->record_size),
+									   (uint8_t *)&p_resp->record_size);
+
+			p_resp->record_phase = APP_DATA_RECORD__WAIT_FOR_SIZE_SEND;
+
+			// Fall through to send the buffer once its size is out.
+
+		case APP_DATA_RECORD__WAIT_FOR_SIZE_SEND:
+			if (!inst->hc_data.tx_done) {
+				return false;
+			}
+
+			start_app_tx_spans(inst);
+			p_resp->record_phase = APP_DATA_RECORD__WAIT_FOR_DATA_SEND;
+
+			// Fall through to send the buffer.
+
+		case APP_DATA_RECORD__WAIT_FOR_DATA_SEND:
+			if (!send_app_tx_spans(inst, p_desc, p_resp->record_size,
+								   crc_needed ? &p_resp->crc : NULL)) {
+				return false;
+			}
+
+			p_resp->record_idx++;
+			p_resp->record_phase = APP_DATA_RECORD__SEND_SIZE;
+			break;
+
+		default:
+			// Invalid phase, stop the payload short.
+			p_resp->record_idx = p_resp->num_records;
+			break;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * exec_send_data_frames_to_gard executes the state machine for
+ * SEND_DATA_TO_GARD_FOR_OFFSET command sent with CC_USE_MTU_SIZE.
+ *
+ * The payload arrives in packets of at most mtu_size bytes, each received
+ * straight into its place in GARD memory and answered with a struct
+ * _data_frame_response. The response to a packet goes out while the header
+ * of the next one is being received, so that Host can keep a window of
+ * packets in flight.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_send_data_frames_to_gard(
+	struct iface_instance           *inst,
+	enum host_request_service_state *current_state,
+	struct _host_requests_unpked    *host_req,
+	struct _host_responses_unpked   *host_resp)
+{
+	struct _send_data_to_gard_for_offset_request_unpked *p_send_data_req;
+	struct _data_frame_response_unpked                  *p_frame_resp;
+	uint32_t                                             mtu_size;
+	uint32_t                                             data_size;
+	uint32_t                                             frame_offset;
+	uint32_t                                             frame_size;
+	uint8_t                                             *p_frame_data;
+
+	p_send_data_req = &host_req->send_data_to_gard_for_offset_request;
+	p_frame_resp    = &host_resp->data_frame_response;
+	mtu_size        = p_send_data_req->cmd.mtu_size;
+	data_size       = p_send_data_req->cmd.data_size;
+	frame_offset    = (uint32_t)p_send_data_req->frame.hdr.frame_num * mtu_size;
+	frame_size      = p_send_data_req->frame.hdr.frame_size;
+	p_frame_data =
+		(uint8_t *)(p_send_data_req->cmd.offset_address + frame_offset);
+
+	GARD__CASSERT(
+		(sizeof(p_send_data_req->frame.hdr) ==
+		 sizeof(struct _data_frame_header)) &&
+			(sizeof(p_send_data_req->frame.trl) ==
+			 sizeof(struct _data_frame_trailer)) &&
+			(sizeof(*p_frame_resp) == sizeof(struct _data_frame_response)),
+		"Sizes of packed and unpacked structures mismatch.");
+
+	switch (*current_state) {
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__START_PROCESSING:
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__VALIDATE_PARAMETERS:
+
+		if ((mtu_size == 0) || (data_size == 0)) {
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			return false;
+		}
+
+		// next_frame_num past the last packet must not read as an abort.
+		p_send_data_req->frame.num_frames = ((data_size - 1) / mtu_size) + 1;
+		if (p_send_data_req->frame.num_frames >= GARD_HUB_FRAME_NUM_ABORT) {
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			return false;
+		}
+
+		p_send_data_req->frame.next_frame_num = 0;
+
+		// No packet response is being sent yet.
+		inst->hc_data.tx_done                 = true;
+
+		// Fall through to receive the first packet header.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_HEADER:
+
+		// Same layout packed and unpacked, receive it in place.
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+		inst->read_data_async_call(inst, sizeof(p_send_data_req->frame.hdr),
+								   (uint8_t *)&p_send_data_req->frame.hdr);
+
+		*current_state = EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_HEADER;
+
+		// Fall through to check if the header has arrived.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_HEADER:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// Fall through to receive the packet data.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_DATA:
+
+		// The header was just received, refresh what depends on it.
+		frame_offset =
+			(uint32_t)p_send_data_req->frame.hdr.frame_num * mtu_size;
+		frame_size   = p_send_data_req->frame.hdr.frame_size;
+		p_frame_data =
+			(uint8_t *)(p_send_data_req->cmd.offset_address + frame_offset);
+
+		if ((p_send_data_req->frame.hdr.frame_num <
+			 p_send_data_req->frame.next_frame_num) ||
+			(frame_size == 0) || (frame_size > mtu_size) ||
+			(frame_offset >= data_size) ||
+			(frame_size > (data_size - frame_offset))) {
+			// The packet would land on data already taken, or has no place
+			// in the payload at all. Host never resends behind a NAK, so the
+			// header is broken and the bytes following it cannot be trusted
+			// either. Give up on the transfer.
+			p_send_data_req->frame.ack_or_nak     = 0;
+			p_send_data_req->frame.next_frame_num = GARD_HUB_FRAME_NUM_ABORT;
+			*current_state = EXEC_SEND_DATA_FRAMES_TO_GARD__SEND_FRAME_RESPONSE;
+			return false;
+		}
+
+		// Out of order packets are received in their place too; they are
+		// NAKed and come again in order.
+		p_send_data_req->crc.value     = 0;
+		p_send_data_req->crc.num_bytes = 0;
+		inst->hc_data.rx_done          = false;  // Wait for new data.
+		inst->read_data_async_call(inst, frame_size, p_frame_data);
+
+		*current_state = EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_DATA;
+
+		// Fall through to check if the data has arrived.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_DATA:
+		if (!inst->hc_data.rx_done) {
+			crc_data_in_flight(&p_send_data_req->crc, p_frame_data,
+							   inst->bytes_read);
+			return false;
+		}
+
+		crc_data_in_flight(&p_send_data_req->crc, p_frame_data, frame_size);
+
+		// Fall through to receive the packet trailer.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_TRAILER:
+
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+		inst->read_data_async_call(inst, sizeof(p_send_data_req->frame.trl),
+								   (uint8_t *)&p_send_data_req->frame.trl);
+
+		*current_state =
+			EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_TRAILER;
+
+		// Fall through to check if the trailer has arrived.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_FRAME_TRAILER:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// Fall through to validate the packet.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__VALIDATE_FRAME:
+
+		// Only the expected packet, of the expected size and intact, is
+		// taken. All but the last packet are mtu_size bytes.
+		if ((p_send_data_req->frame.hdr.frame_num ==
+			 p_send_data_req->frame.next_frame_num) &&
+			(frame_size == MIN(mtu_size, data_size - frame_offset)) &&
+			(p_send_data_req->frame.trl.crc == p_send_data_req->crc.value)) {
+			p_send_data_req->frame.ack_or_nak = ACK_BYTE;
+			p_send_data_req->frame.next_frame_num++;
+		} else {
+			p_send_data_req->frame.ack_or_nak = 0;
+		}
+
+		// Fall through to answer the packet.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__SEND_FRAME_RESPONSE:
+
+		// The response to the previous packet may still be going out.
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		p_frame_resp->ack_or_nak     = p_send_data_req->frame.ack_or_nak;
+		p_frame_resp->rsvd1          = 0;
+		p_frame_resp->next_frame_num = p_send_data_req->frame.next_frame_num;
+
+		inst->hc_data.tx_done        = false;
+		inst->send_data_async_call(inst, sizeof(*p_frame_resp),
+								   (uint8_t *)p_frame_resp);
+
+		if ((p_frame_resp->next_frame_num !=
+			 p_send_data_req->frame.num_frames) &&
+			(p_frame_resp->next_frame_num != GARD_HUB_FRAME_NUM_ABORT)) {
+			// Receive the next packet while this response goes out.
+			*current_state = EXEC_SEND_DATA_FRAMES_TO_GARD__REQ_FRAME_HEADER;
+			return false;
+		}
+
+		*current_state =
+			EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_LAST_RESPONSE_SEND;
+
+		// Fall through to wait for the last response to be sent.
+
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__WAIT_FOR_LAST_RESPONSE_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		// Command complete. Go back to start state to wait for new
+		// command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		break;
+
+	default:
+		// Invalid state, reset to start state.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		return false;  // Error in state machine, abort execution.
+	}
+
+	return true;
+}
+
 /**
  * exec_send_data_to_gard_for_offset executes the state machine for
  * SEND_DATA_TO_GARD_FOR_OFFSET command.
@@ -173,8 +978,11 @@ static bool exec_send_data_to_gard_for_offset(
 	uint32_t                                              bytes_to_read;
 	struct _send_data_to_gard_for_offset_request_unpked  *p_send_data_req;
 	struct _send_data_to_gard_for_offset_response_unpked *p_send_data_resp;
+	uint8_t                                              *p_payload;
 
-	p_send_data_req = &host_req->send_data_to_gard_for_offset_request;
+	p_send_data_req  = &host_req->send_data_to_gard_for_offset_request;
+	p_send_data_resp = &host_resp->send_data_to_gard_for_offset_response;
+	p_payload        = (uint8_t *)p_send_data_req->cmd.offset_address;
 
 	// This function executes the SEND_DATA_TO_GARD_FOR_OFFSET command.
 	// It handles the state transitions and data transfers as per the command
@@ -182,6 +990,16 @@ static bool exec_send_data_to_gard_for_offset(
 
 	switch (*current_state) {
 	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__START_PROCESSING:
+
+		// A payload sent in packets has its own state machine.
+		if (p_send_data_req->cmd.control_code & CC_USE_MTU_SIZE) {
+			*current_state = EXEC_SEND_DATA_FRAMES_TO_GARD__START_PROCESSING;
+			return exec_send_data_frames_to_gard(inst, current_state,
+												 host_req, host_resp);
+		}
+
+		// Fall through to receive the payload in one go.
+
 	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__REQ_PAYLOAD:
 
 		// Request interface to receive the data from the Host and write it to
@@ -190,20 +1008,31 @@ static bool exec_send_data_to_gard_for_offset(
 		// fields should be received separately in our local buffer, hence we
 		// will need to split the receive operation into two steps.
 
+		p_send_data_req->crc.value     = 0;
+		p_send_data_req->crc.num_bytes = 0;
 		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
-		inst->read_data_async_call(
-			inst, p_send_data_req->cmd.data_size,
-			(uint8_t *)p_send_data_req->cmd.offset_address);
+		inst->read_data_async_call(inst, p_send_data_req->cmd.data_size,
+								   p_payload);
 
 		*current_state = EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__WAIT_FOR_PAYLOAD;
 		// Fall through to check if the data has arrived.
 
 	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__WAIT_FOR_PAYLOAD:
-		// Check if all the requested data has been received.
+		// Check if all the requested data has been received. Meanwhile, keep
+		// the CRC up with the bytes received so far.
 		if (!inst->hc_data.rx_done) {
+			if (p_send_data_req->cmd.control_code & CC_CHECKSUM_PRESENT) {
+				crc_data_in_flight(&p_send_data_req->crc, p_payload,
+								   inst->bytes_read);
+			}
 			return false;
 		}
 
+		if (p_send_data_req->cmd.control_code & CC_CHECKSUM_PRESENT) {
+			crc_data_in_flight(&p_send_data_req->crc, p_payload,
+							   p_send_data_req->cmd.data_size);
+		}
+
 		// Payload data has arrived, now request interface to receive the
 		// end-of-data marker and optional CRC for the command.
 
@@ -260,6 +1089,7 @@ static bool exec_send_data_to_gard_for_offset(
 		} else if (!(p_send_data_req->cmd.control_code & CC_CHECKSUM_PRESENT)) {
 			// Done executing the SEND_DATA_TO_GARD_FOR_OFFSET command.
 			// Check if ACK is requested.
+			p_send_data_resp->opt_ack = ACK_BYTE;
 			*current_state = EXEC_SEND_DATA_TO_GARD_FOR_OFFSET___SEND_ACK;
 			break;
 		}
@@ -268,22 +1098,17 @@ static bool exec_send_data_to_gard_for_offset(
 
 	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET___VALIDATE_CRC:
 
-		if (p_send_data_req->eod.opt_crc !=
-			calculate_checksum(p_send_data_req->data,
-							   p_send_data_req->cmd.data_size)) {
-			// Handle checksum error.
-			// This could involve logging an error or sending an error
-			// response.
-			*current_state = EXEC_SEND_DATA_TO_GARD_FOR_OFFSET___VALIDATE_CRC;
-			return false;  // Error in checksum, abort execution.
-		}
+		// The CRC-32 of the payload was computed while it was received. A
+		// corrupted payload is NAKed so that Host can send it again.
+		p_send_data_resp->opt_ack =
+			(p_send_data_req->eod.opt_crc == p_send_data_req->crc.value)
+				? ACK_BYTE
+				: 0;
 
-		// Fall through to send ACK if required.
+		// Fall through to send ACK (or NAK) if required.
 
 	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET___SEND_ACK:
 
-		p_send_data_resp = &host_resp->send_data_to_gard_for_offset_response;
-
 		if (!(p_send_data_req->cmd.control_code & CC_SEND_ACK_AFTER_XFER)) {
 			// Command complete. Go back to start state to wait for new
 			// command.
@@ -294,10 +1119,9 @@ static bool exec_send_data_to_gard_for_offset(
 		// If ACK is requested, send acknowledgment to terminate this
 		// command transaction. Since the ACK byte is 1-byte long we can send it
 		// in either the packed or unpacked structure. Here we use the
-		// unpacked structure to send the ACK byte.
+		// unpacked structure to send the ACK byte, set when the payload
+		// was validated.
 		inst->hc_data.tx_done = false;
-		p_send_data_resp->opt_ack =
-			ACK_BYTE;  // Set ACK byte to indicate success.
 		inst->send_data_async_call(inst, sizeof(p_send_data_resp->opt_ack),
 								   &p_send_data_resp->opt_ack);
 
@@ -317,7 +1141,13 @@ static bool exec_send_data_to_gard_for_offset(
 		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 		break;
 
-	default:
+	case EXEC_SEND_DATA_FRAMES_TO_GARD__START_PROCESSING ... EXEC_SEND_DATA_FRAMES_TO_GARD__END_PROCESSING:
+
+		// The payload is being received in packets.
+		return exec_send_data_frames_to_gard(inst, current_state, host_req,
+											 host_resp);
+
+	default:
 		// Invalid state, reset to start state.
 		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 		return false;  // Error in state machine, abort execution.
@@ -326,6 +1156,94 @@ static bool exec_send_data_to_gard_for_offset(
 	return true;  // No commands processed in this stub.
 }
 
+/**
+ * is_control_host_request_ready tells if the next command, taken in while a
+ * CC_SEGMENTED payload is being sent, may be served between two of its
+ * segments. Only a tagged command can, as Host tells its response from the
+ * payload by the tag, and only one that does not move bulk data itself nor
+ * changes the interface.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ *
+ * @return true if the next command is in and can go ahead of the payload.
+ */
+static bool is_control_host_request_ready(const struct iface_instance *inst)
+{
+	if ((NEXT_REQUEST__READY != inst->hc_data.next_req_state) ||
+		!inst->hc_data.is_tagged) {
+		return false;
+	}
+
+	switch (inst->hc_data.iface_host_req.command_id) {
+	case SEND_DATA_TO_GARD_FOR_OFFSET:
+	case RECV_DATA_FROM_GARD_AT_OFFSET:
+	case UPGRADE_FIRMWARE:
+	case SET_UART_PARAMETERS:
+		return false;
+
+	default:
+		return true;
+	}
+}
+
+/**
+ * park_bulk_host_request sets the CC_SEGMENTED receive data command being
+ * served aside in bulk_lane, so that the control command taken in meanwhile
+ * can use host_req and host_resp. It is resumed at its next segment by
+ * resume_bulk_host_request() once the control command is done.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ */
+static void park_bulk_host_request(struct iface_instance *inst)
+{
+	memcpy((uint8_t *)&inst->hc_data.bulk_lane.req,
+		   (const uint8_t *)&inst->hc_data.host_req
+			   .recv_data_from_gard_at_offset_request,
+		   sizeof(inst->hc_data.bulk_lane.req));
+	memcpy((uint8_t *)&inst->hc_data.bulk_lane.resp,
+		   (const uint8_t *)&inst->hc_data.host_resp
+			   .recv_data_from_gard_at_offset_response,
+		   sizeof(inst->hc_data.bulk_lane.resp));
+
+	inst->hc_data.bulk_lane.state =
+		EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_SEGMENT_HEADER;
+}
+
+/**
+ * resume_bulk_host_request puts the command set aside by
+ * park_bulk_host_request() back in service, if any.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ *
+ * @return true if a command was resumed, false if none was set aside.
+ */
+static bool resume_bulk_host_request(struct iface_instance *inst)
+{
+	if (0U == inst->hc_data.bulk_lane.state) {
+		return false;
+	}
+
+	// As in EXECUTE_HOST_IFACE_CMD, on a little-endian architecture.
+	*((uint8_t *)&inst->hc_data.host_req.command_id) =
+		RECV_DATA_FROM_GARD_AT_OFFSET;
+	memcpy((uint8_t *)&inst->hc_data.host_req
+			   .recv_data_from_gard_at_offset_request,
+		   (const uint8_t *)&inst->hc_data.bulk_lane.req,
+		   sizeof(inst->hc_data.bulk_lane.req));
+	memcpy((uint8_t *)&inst->hc_data.host_resp
+			   .recv_data_from_gard_at_offset_response,
+		   (const uint8_t *)&inst->hc_data.bulk_lane.resp,
+		   sizeof(inst->hc_data.bulk_lane.resp));
+
+	inst->hc_data.host_request_service_state = inst->hc_data.bulk_lane.state;
+	inst->hc_data.bulk_lane.state            = 0;
+
+	return true;
+}
+
 /**
  * exec_recv_data_from_gard_at_offset executes the state machine for
  * RECV_DATA_FROM_GARD_AT_OFFSET command.
@@ -350,11 +1268,40 @@ static bool exec_recv_data_from_gard_at_offset(
 	uint32_t                                               bytes_to_send;
 	struct _recv_data_from_gard_at_offset_request_unpked  *p_recv_data_req;
 	struct _recv_data_from_gard_at_offset_response_unpked *p_recv_data_resp;
+	struct _data_segment_header_unpked                    *p_seg_hdr;
 	uint8_t                                               *data_to_send_addr;
+	uint32_t                                               seg_size;
+	bool                                                   is_app_data;
+	bool                                                   is_batch;
+	bool                                                   is_segmented;
 
 	p_recv_data_req  = &host_req->recv_data_from_gard_at_offset_request;
 	p_recv_data_resp = &host_resp->recv_data_from_gard_at_offset_response;
 
+	// Several App Module buffers in one response, see CC_APP_DATA_BATCH.
+	is_app_data = (0U != (p_recv_data_req->control_code & CC_APP_DATA));
+	is_batch    = is_app_data &&
+				  (p_recv_data_req->control_code & CC_APP_DATA_BATCH);
+
+	// Payload sent a segment at a time, see CC_SEGMENTED.
+	is_segmented = !is_app_data &&
+				   (p_recv_data_req->control_code & CC_SEGMENTED);
+	p_seg_hdr    = &p_recv_data_resp->seg_hdr;
+
+	if (is_app_data) {
+		/**
+		 * If the data to be sent is in the App Modules buffer then the oldest
+		 * queued buffer is sent, a span at a time, see send_app_tx_spans().
+		 */
+		data_to_send_addr = NULL;
+	} else {
+		/**
+		 * Otherwise use the offset address provided in the command to
+		 * send the data.
+		 */
+		data_to_send_addr = (uint8_t *)p_recv_data_req->offset_address;
+	}
+
 	// This function executes the RECV_DATA_FROM_GARD_AT_OFFSET command.
 	// It handles the state transitions and data transfers as per the command
 	// documentation.
@@ -375,15 +1322,26 @@ static bool exec_recv_data_from_gard_at_offset(
 		p_recv_data_resp->start_of_data_marker = START_OF_DATA_MARKER;
 		bytes_to_send = sizeof(p_recv_data_resp->start_of_data_marker);
 
-		if (p_recv_data_req->control_code & CC_APP_DATA) {
+		if (is_batch) {
+			/**
+			 * Send as many of the queued buffers as fit, each with its size.
+			 */
+			p_recv_data_resp->data_size = plan_app_data_batch(
+				p_recv_data_resp, p_recv_data_req->data_size);
+		} else if (p_recv_data_req->control_code & CC_APP_DATA) {
 			/**
 			 * If the data to be sent is by the App Module then send the size of
-			 * the data.
+			 * the data. There is none while Host is subscribed, as it is pushed
+			 * then.
 			 */
-			p_recv_data_resp->data_size =
-				(p_recv_data_req->data_size < app_tx_buffer_size)
-					? p_recv_data_req->data_size
-					: app_tx_buffer_size;
+			p_recv_data_resp->data_size = 0;
+			if ((app_tx_queue_count > 0U) && (NULL == app_data_subscriber)) {
+				p_recv_data_resp->data_size =
+					(p_recv_data_req->data_size < app_tx_queue_entry(0)->size)
+						? p_recv_data_req->data_size
+						: app_tx_queue_entry(0)->size;
+				seal_app_tx(1);
+			}
 		} else {
 			/**
 			 * For non App Module data transfers, set the original data size.
@@ -413,22 +1371,21 @@ static bool exec_recv_data_from_gard_at_offset(
 	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_PAYLOAD:
 
 		// Reset the flag to wait for data to be sent.
-		inst->hc_data.tx_done = false;
-		if (p_recv_data_req->control_code & CC_APP_DATA) {
-			/**
-			 * If the data to be sent is in the App Modules buffer then use that
-			 * buffer to send the data.
-			 */
-			data_to_send_addr = app_tx_buffer;
+		inst->hc_data.tx_done           = false;
+		p_recv_data_resp->crc.value     = 0;
+		p_recv_data_resp->crc.num_bytes = 0;
+		p_recv_data_resp->seg_bytes_done = 0;
+		if (is_segmented) {
+			// Segments sent from SEND_SEGMENT_HEADER.
+			inst->hc_data.tx_done = true;
+		} else if (!is_app_data && (p_recv_data_resp->data_size > 0U)) {
+			inst->send_data_async_call(inst, p_recv_data_resp->data_size,
+									   data_to_send_addr);
 		} else {
-			/**
-			 * Otherwise use the offset address provided in the command to
-			 * send the data.
-			 */
-			data_to_send_addr = (uint8_t *)p_recv_data_req->offset_address;
+			// Nothing to send, or App Module buffers sent in the wait state.
+			start_app_tx_spans(inst);
+			inst->hc_data.tx_done = true;
 		}
-		inst->send_data_async_call(inst, p_recv_data_resp->data_size,
-								   data_to_send_addr);
 
 		*current_state =
 			EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_PAYLOAD_SEND;
@@ -436,10 +1393,68 @@ static bool exec_recv_data_from_gard_at_offset(
 		// Fall through to wait for payload to be sent.
 
 	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_PAYLOAD_SEND:
+		if (is_batch &&
+			!send_app_data_batch(inst, p_recv_data_req, p_recv_data_resp)) {
+			return false;
+		}
+
+		if (is_app_data && !is_batch && (p_recv_data_resp->data_size > 0U) &&
+			!send_app_tx_spans(
+				inst, app_tx_queue_entry(0), p_recv_data_resp->data_size,
+				(p_recv_data_req->control_code & CC_CHECKSUM_PRESENT)
+					? &p_recv_data_resp->crc
+					: NULL)) {
+			return false;
+		}
+
+		// Keep the CRC up with the bytes sent so far, so that the eod can go
+		// out right after the payload.
 		if (!inst->hc_data.tx_done) {
+			if (p_recv_data_req->control_code & CC_CHECKSUM_PRESENT) {
+				crc_data_in_flight(&p_recv_data_resp->crc, data_to_send_addr,
+								   inst->bytes_sent);
+			}
 			return false;
 		}
 
+		// Fall through to send the segments of a CC_SEGMENTED payload.
+
+	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_SEGMENT_HEADER:
+		if (is_segmented && (p_recv_data_resp->seg_bytes_done <
+							 p_recv_data_resp->data_size)) {
+			p_seg_hdr->segment_marker = DATA_SEGMENT_MARKER;
+			p_seg_hdr->rsvd1          = 0;
+
+			if (is_control_host_request_ready(inst)) {
+				// Let the control command taken in meanwhile go ahead of
+				// the next segment, announced by an empty one.
+				p_seg_hdr->segment_size = 0;
+				*current_state =
+					EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_YIELD_SEND;
+			} else {
+				seg_size = (p_recv_data_req->mtu_size > 0U)
+							   ? p_recv_data_req->mtu_size
+							   : DATA_SEGMENT_SIZE;
+				if (seg_size > (p_recv_data_resp->data_size -
+								p_recv_data_resp->seg_bytes_done)) {
+					seg_size = p_recv_data_resp->data_size -
+							   p_recv_data_resp->seg_bytes_done;
+				}
+				p_seg_hdr->segment_size = (uint16_t)seg_size;
+				*current_state =
+					EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_HEADER_SEND;
+			}
+
+			GARD__CASSERT(sizeof(*p_seg_hdr) ==
+							  sizeof(struct _data_segment_header),
+						  "Sizes of packed and unpacked structures mismatch.");
+
+			inst->hc_data.tx_done = false;
+			inst->send_data_async_call(inst, sizeof(*p_seg_hdr),
+									   (uint8_t *)p_seg_hdr);
+			return true;
+		}
+
 		// Payload data has been sent,
 		// Fall through to send the end-of-data marker and optionally a
 		// checksum.
@@ -464,9 +1479,11 @@ static bool exec_recv_data_from_gard_at_offset(
 			// If checksum is present, we need to send the end-of-data
 			// marker and the checksum.
 			bytes_to_send += sizeof(p_recv_data_resp->eod.opt_crc);
-			p_recv_data_resp->eod.opt_crc =
-				calculate_checksum((uint8_t *)p_recv_data_req->offset_address,
-								   p_recv_data_req->data_size);
+			if (!is_app_data) {
+				crc_data_in_flight(&p_recv_data_resp->crc, data_to_send_addr,
+								   p_recv_data_resp->data_size);
+			}
+			p_recv_data_resp->eod.opt_crc = p_recv_data_resp->crc.value;
 		}
 
 		// Reset the flag to wait for data to be sent.
@@ -483,9 +1500,12 @@ static bool exec_recv_data_from_gard_at_offset(
 			return false;
 		}
 
-		/* If App Data was sent flag the marker as Job is DONE. */
-		if (p_recv_data_req->control_code & CC_APP_DATA) {
-			*p_app_tx_complete = true;
+		/* If App Data was sent flag the buffers as Job is DONE. */
+		if (is_batch) {
+			complete_app_tx(p_recv_data_resp->num_records);
+		} else if ((p_recv_data_req->control_code & CC_APP_DATA) &&
+				   (p_recv_data_resp->data_size > 0U)) {
+			complete_app_tx(1);
 		}
 		/**
 		 * Command complete. Go back to start state to wait for new
@@ -493,6 +1513,49 @@ static bool exec_recv_data_from_gard_at_offset(
 		 */
 		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 		break;
+
+	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_HEADER_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		inst->hc_data.tx_done = false;
+		inst->send_data_async_call(
+			inst, p_seg_hdr->segment_size,
+			data_to_send_addr + p_recv_data_resp->seg_bytes_done);
+
+		*current_state =
+			EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_SEND;
+
+		// Fall through to wait for the segment to be sent.
+
+	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SEGMENT_SEND:
+		if (!inst->hc_data.tx_done) {
+			if (p_recv_data_req->control_code & CC_CHECKSUM_PRESENT) {
+				crc_data_in_flight(
+					&p_recv_data_resp->crc, data_to_send_addr,
+					p_recv_data_resp->seg_bytes_done + inst->bytes_sent);
+			}
+			return false;
+		}
+
+		p_recv_data_resp->seg_bytes_done += p_seg_hdr->segment_size;
+
+		*current_state =
+			EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__SEND_SEGMENT_HEADER;
+		break;
+
+	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_YIELD_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		// Serve the control command, then resume at the next segment, see
+		// resume_bulk_host_request().
+		park_bulk_host_request(inst);
+		*current_state = IFACE_WAIT_FOR_NEXT_CMD;
+		break;
+
 	default:
 		// Invalid state, reset to start state.
 		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
@@ -520,10 +1583,10 @@ static bool exec_recv_data_from_gard_at_offset(
 static bool exec_read_reg_value_from_gard_at_offset(
 	struct iface_instance           *inst,
 	enum host_request_service_state *current_state,
-	struct _host_requests           *host_req,
+	struct _host_requests_unpked    *host_req,
 	struct _host_responses_unpked   *host_resp)
 {
-	struct _read_reg_value_from_gard_at_offset_request         *p_read_reg_req;
+	struct _read_reg_value_from_gard_at_offset_request_unpked  *p_read_reg_req;
 	struct _read_reg_value_from_gard_at_offset_response_unpked *p_read_reg_resp;
 	uint32_t                                                   *p_reg;
 
@@ -772,6 +1835,67 @@ static bool
 	return true;
 }
 
+/**
+ * Profile GARD reports in its GARD_DISCOVERY response, set at build time with
+ * GARD_PROFILE_ID (see Makefile.vars).
+ */
+#ifndef GARD_PROFILE_ID
+#define GARD_PROFILE_ID 12345U
+#endif
+
+/**
+ * Capabilities GARD reports in its GARD_DISCOVERY response. The USB data bus
+ * is a hardware bridge to GARD memory, present if GARD_USB_BRIDGE is defined.
+ */
+#if defined(GARD_USB_BRIDGE)
+#define GARD_CAPABILITIES_USB GARD_CAP_BUS_USB
+#else
+#define GARD_CAPABILITIES_USB 0U
+#endif
+#define GARD_CAPABILITIES                                                      \
+	(GARD_CAP_BUS_I2C | GARD_CAP_BUS_UART | GARD_CAPABILITIES_USB |            \
+	 GARD_CAP_DATA_CRC | GARD_CAP_APP_DATA_STREAM | GARD_CAP_SEGMENTED_RECV |  \
+	 GARD_CAP_RESYNC)
+
+/**
+ * murmur3_fmix32 scrambles the bits of a 32-bit value (MurmurHash3 finalizer),
+ * with 32-bit multiplications only.
+ */
+static uint32_t murmur3_fmix32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x85EBCA6BU;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35U;
+	x ^= x >> 16;
+	return x;
+}
+
+/**
+ * get_gard_device_id returns the id GARD reports in its GARD_DISCOVERY
+ * response. GARD has no unique id it can read, so the id is drawn from the
+ * CPU TSC at the first discovery after boot: it is then the same on all the
+ * buses of this GARD, and GARD boards discovered one after the other by Host
+ * get different ids.
+ *
+ * @param device_id: Filled with the id, low word first.
+ */
+static void get_gard_device_id(uint32_t device_id[2])
+{
+	static uint32_t gard_device_id[2];
+	uint64_t        tsc;
+
+	if ((0U == gard_device_id[0]) && (0U == gard_device_id[1])) {
+		tsc               = get_cpu_tsc();
+		gard_device_id[0] = murmur3_fmix32((uint32_t)tsc);
+		gard_device_id[1] =
+			murmur3_fmix32((uint32_t)(tsc >> 32) ^ gard_device_id[0]) | 1U;
+	}
+
+	device_id[0] = gard_device_id[0];
+	device_id[1] = gard_device_id[1];
+}
+
 /**
  * exec_gard_discovery executes the state machine for GARD_DISCOVERY_OVER_IFACE
  * command.
@@ -794,10 +1918,15 @@ static bool exec_gard_discovery(struct iface_instance           *inst,
 {
 	struct _gard_discovery_response_unpked *p_disc_resp =
 		&host_resp->gard_discovery_response;
-	struct _gard_discovery_response temp = {.start_of_data_marker = 0x50DB50DBU,
-											.signature            = "I AM GARD",
-											.end_of_data_marker =
-												END_OF_DATA_MARKER};
+	struct _gard_discovery_response temp = {
+		.start_of_data_marker = 0x50DB50DBU,
+		.signature            = "I AM GARD",
+		.profile_id           = GARD_PROFILE_ID,
+		.fw_version =
+			(VERSION_MAJOR << 16) | (VERSION_MINOR << 8) | VERSION_BUG_FIX,
+		.capabilities       = GARD_CAPABILITIES,
+		.max_mtu_size       = UINT16_MAX,
+		.end_of_data_marker = END_OF_DATA_MARKER};
 
 	// In the interest of space we will use the unpacked structure instead of
 	// the packed structure to send the response frame. This is because we know
@@ -811,6 +1940,10 @@ static bool exec_gard_discovery(struct iface_instance           *inst,
 	switch (*current_state) {
 	case EXECUTE_CMD_DISCOVERY__START_PROCESSING:
 	case EXECUTE_CMD_DISCOVERY__COMPOSE_RESPONSE_TO_SEND:
+		get_gard_device_id(p_disc_resp->device_id);
+		temp.device_id[0] = p_disc_resp->device_id[0];
+		temp.device_id[1] = p_disc_resp->device_id[1];
+
 		*((struct _gard_discovery_response *)p_disc_resp) =
 			temp;  // Copy the temporary response to the actual
 				   // response structure.
@@ -841,7 +1974,11 @@ static bool exec_gard_discovery(struct iface_instance           *inst,
 		 * after receiving the GARD_DISCOVERY command. This data sending will
 		 * start 5 seconds after the GARD_DISCOVERY response is sent.
 		 */
-		set_timer_for_time(5000);
+		sw_timer_start(&test_data_xfer_timer, 5000, 5000);
+#endif
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+		/* Run the ML pipeline on the frame of the RFS, see synthetic_bench.h */
+		synthetic_bench_arm();
 #endif
 
 		break;
@@ -878,10 +2015,22 @@ static bool
 	struct _capture_rescaled_image_request_unpked  *p_capture_img_req;
 	struct _capture_rescaled_image_response_unpked *p_capture_img_resp;
 	struct image_info                               captured_img_info;
+	bool                                            capture_img_snapshot;
+	struct snapshot_format                          capture_img_format;
+	bool                                            camera_supported;
+	uint32_t                                        frame_seq;
+	uint64_t                                        capture_tsc;
 
 	p_capture_img_req  = &host_req->capture_rescaled_image_request_unpked;
 	p_capture_img_resp = &host_resp->capture_rescaled_image_response_unpked;
 
+	/* The image is copied out instead of pausing the pipeline on it. */
+	capture_img_snapshot =
+		(0U != (p_capture_img_req->flags & CAPTURE_RESCALED_IMAGE__NO_PAUSE));
+
+	/* An unknown camera gets an empty image rather than halting GARD. */
+	camera_supported = (p_capture_img_req->camera_id < GARD_CAMERA_COUNT);
+
 	switch (*current_state) {
 	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__START_PROCESSING:
 	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__VALIDATE_PARAMETERS:
@@ -895,11 +2044,7 @@ static bool
 			return false;  // Error in end-of-data marker, abort execution.
 		}
 
-		// Currently only camera ID 0 is supported.
-		GARD__DBG_ASSERT(p_capture_img_req->camera_id == 0,
-						 "Unsupported camera ID");
-
-		if (!camera_started) {
+		if (!camera_supported || !camera_started) {
 			*current_state =
 				EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__COMPOSE_RESPONSE_TO_SEND;
 			return false;  // Camera not started, skip calling capture.
@@ -909,7 +2054,22 @@ static bool
 
 	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__TRIGGER_IMAGE_CAPTURE:
 
-		capture_rescaled_image_async();
+		// Copy the image out if asked to, else pause the pipeline on it.
+		capture_img_format.roi_x      = p_capture_img_req->roi_x;
+		capture_img_format.roi_y      = p_capture_img_req->roi_y;
+		capture_img_format.roi_width  = p_capture_img_req->roi_width;
+		capture_img_format.roi_height = p_capture_img_req->roi_height;
+		capture_img_format.decimation = p_capture_img_req->decimation;
+		capture_img_format.codec      = p_capture_img_req->codec;
+
+		if (capture_img_snapshot &&
+			!snapshot_rescaled_image_async(&capture_img_format)) {
+			p_capture_img_req->flags &= ~CAPTURE_RESCALED_IMAGE__NO_PAUSE;
+			capture_img_snapshot = false;
+		}
+		if (!capture_img_snapshot) {
+			capture_rescaled_image_async();
+		}
 
 		*current_state =
 			EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__WAIT_FOR_IMAGE_CAPTURE;
@@ -917,7 +2077,8 @@ static bool
 		// Fall through to wait for image capture to complete.
 
 	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__WAIT_FOR_IMAGE_CAPTURE:
-		if (!is_rescaled_image_captured()) {
+		if (capture_img_snapshot ? !is_rescaled_image_snapshot_ready()
+								 : !is_rescaled_image_captured()) {
 			return false;  // Wait for image capture to complete.
 		}
 
@@ -927,7 +2088,13 @@ static bool
 		// Fall through to collect image information and compose response.
 
 	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__COMPOSE_RESPONSE_TO_SEND:
-		get_rescaled_image_info(&captured_img_info);
+		if (capture_img_snapshot) {
+			get_rescaled_image_snapshot_info(&captured_img_info,
+											 &p_capture_img_resp->codec);
+		} else {
+			get_rescaled_image_info(&captured_img_info);
+			p_capture_img_resp->codec = IMAGE_CODEC__NONE;
+		}
 
 		p_capture_img_resp->start_of_data_marker = START_OF_DATA_MARKER;
 
@@ -943,6 +2110,24 @@ static bool
 
 		p_capture_img_resp->image_format           = captured_img_info.format;
 
+		if (!camera_supported) {
+			captured_img_info.image_data = NULL;
+			captured_img_info.size       = 0U;
+			captured_img_info.width      = 0U;
+			captured_img_info.height     = 0U;
+		}
+
+		p_capture_img_resp->pipeline_paused = is_pipeline_execution_paused();
+
+		p_capture_img_resp->rsvd1[0]        = 0U;
+		p_capture_img_resp->rsvd1[1]        = 0U;
+
+		get_rescaled_image_frame(capture_img_snapshot, &frame_seq,
+								 &capture_tsc);
+		p_capture_img_resp->frame_seq       = frame_seq;
+		p_capture_img_resp->capture_time_lo = (uint32_t)capture_tsc;
+		p_capture_img_resp->capture_time_hi = (uint32_t)(capture_tsc >> 32);
+
 		p_capture_img_resp->eod.end_of_data_marker = END_OF_DATA_MARKER;
 
 		// Fall through to send the composed response to Host.
@@ -1011,9 +2196,12 @@ static bool exec_resume_pipeline(struct iface_instance           *inst,
 			return false;
 		}
 
-		// Currently only camera ID 0 is supported.
-		GARD__DBG_ASSERT(p_resume_pipe_req->camera_id == 0,
-						 "Unsupported camera ID");
+		// An unknown camera is NAKed rather than halting GARD.
+		if (p_resume_pipe_req->camera_id >= GARD_CAMERA_COUNT) {
+			*current_state =
+				EXECUTE_CMD_RESUME_PIPELINE__COMPOSE_RESPONSE_TO_SEND;
+			return false;
+		}
 
 		// Fall through to trigger the pipeline resume.
 
@@ -1024,7 +2212,8 @@ static bool exec_resume_pipeline(struct iface_instance           *inst,
 		// Fall through to compose response.
 
 	case EXECUTE_CMD_RESUME_PIPELINE__COMPOSE_RESPONSE_TO_SEND:
-		p_resume_pipe_resp->ack_or_nak = ACK_BYTE;
+		p_resume_pipe_resp->ack_or_nak =
+			(p_resume_pipe_req->camera_id < GARD_CAMERA_COUNT) ? ACK_BYTE : 0;
 
 		// Fall through to send the composed response to Host.
 
@@ -1059,418 +2248,2960 @@ static bool exec_resume_pipeline(struct iface_instance           *inst,
 }
 
 /**
- * service_host_requests processes the host requests that originate
- * over UART/I2C or other slow serial interfaces.
+ * is_uart_baud_rate_supported checks that the UART divisor can generate
+ * baud_rate from the UART clock within UART_BAUD_RATE_MAX_ERROR_PERCENT.
  *
- * This function implements a state machine to handle various host commands
- * received over serial interfaces. It reads the command ID, calculates the
- * command body size based on the command ID, and then reads the command body
- * from the interface. Once the command body is fully received, it executes the
- * command based on the command ID. For different commands it offloads the
- * responsibility to sub-functions that handle the specific command execution
- * logic.
+ * @param uart: Pointer to the UART instance.
+ * @param baud_rate: Requested baud rate in bits/sec.
  *
- * @return true if the command execution is complete, false if more data is
- *         expected or if an error occurs.
+ * @return true if the baud rate can be used, false otherwise.
  */
-static bool service_host_request_over_iface(struct iface_instance *inst)
+static bool is_uart_baud_rate_supported(struct uart_instance *uart,
+										uint32_t              baud_rate)
 {
-	// The following variables are used in the state machine and need to
-	// maintain their values across function calls.
-	enum host_request_service_state *current_state =
-		(enum host_request_service_state *)&inst->hc_data
-			.host_request_service_state;
+	uint32_t divisor;
+	uint32_t actual_rate;
+	uint32_t delta;
 
-	/**
-	 * The next two variables are used within this file to work on the received
-	 * command. These variables are unpacked versions of their packed cousins
-	 * that are filled with the data arriving over the interface.
-	 */
-	struct _host_requests_unpked  *host_req  = &inst->hc_data.host_req;
-	struct _host_responses_unpked *host_resp = &inst->hc_data.host_resp;
+	if (baud_rate == 0) {
+		return false;
+	}
 
-	/**
-	 * The next variable is used to receive the command body over the
-	 * interface.
-	 */
-	struct _host_requests *iface_host_req    = &inst->hc_data.iface_host_req;
-	uint32_t               bytes_to_read;
+	divisor = uart->sys_clk / baud_rate;
+	if ((divisor == 0) || (divisor > 0xFFFFU)) {
+		return false;
+	}
 
-	switch (*current_state) {
-	case REQUEST_IFACE_TO_RECV_CMD_ID:
-		iface_host_req->command_id = 0;
+	actual_rate = uart->sys_clk / divisor;
+	delta = (actual_rate > baud_rate) ? (actual_rate - baud_rate)
+									  : (baud_rate - actual_rate);
 
-		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+	return ((delta * 100U) / baud_rate) <= UART_BAUD_RATE_MAX_ERROR_PERCENT;
+}
 
-		// Request interface to receive 1 byte command code.
-		inst->read_data_async_call(inst, sizeof(iface_host_req->command_id),
-								   (uint8_t *)&iface_host_req->command_id);
+/**
+ * exec_set_uart_parameters executes the state machine for SET_UART_PARAMETERS
+ * command.
+ *
+ * The response is sent at the current baud rate. Only once it has fully left
+ * the UART is the new rate programmed, so Host can switch its side right
+ * after reading the ACK.
+ *
+ * The UART IP has no modem control lines, hence a request for RTS/CTS flow
+ * control is NAKed.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_set_uart_parameters(struct iface_instance           *inst,
+							 enum host_request_service_state *current_state,
+							 struct _host_requests_unpked    *host_req,
+							 struct _host_responses_unpked   *host_resp)
+{
+	struct _set_uart_parameters_request_unpked  *p_set_uart_req;
+	struct _set_uart_parameters_response_unpked *p_set_uart_resp;
 
-		// Wait for the command code to be received.
-		*current_state = IFACE_WAIT_FOR_CMD_ID;
+	p_set_uart_req  = &host_req->set_uart_parameters_request_unpked;
+	p_set_uart_resp = &host_resp->set_uart_parameters_response_unpked;
 
-		// Fall through to the next state.
+	switch (*current_state) {
+	case EXECUTE_CMD_SET_UART_PARAMETERS__START_PROCESSING:
+	case EXECUTE_CMD_SET_UART_PARAMETERS__VALIDATE_PARAMETERS:
+
+		if (p_set_uart_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 
-	case IFACE_WAIT_FOR_CMD_ID:
-		// Check if command code is available.
-		if (!inst->hc_data.rx_done) {
 			return false;
 		}
 
-		// Fall through to the next state to calcaulate the size of command
-		// body.
-
-	case IFACE_CALCULATE_CMD_BODY_SIZE:
-
-		// Calculate the size of the command body based on the command ID.
-
-		switch (iface_host_req->command_id) {
-		case SEND_DATA_TO_GARD_FOR_OFFSET:
-			bytes_to_read = sizeof(
-				iface_host_req->send_data_to_gard_for_offset_request.cmd);
-			break;
+		// Fall through to compose response.
 
-		case RECV_DATA_FROM_GARD_AT_OFFSET:
-			bytes_to_read =
-				sizeof(iface_host_req->recv_data_from_gard_at_offset_request);
-			break;
+	case EXECUTE_CMD_SET_UART_PARAMETERS__COMPOSE_RESPONSE_TO_SEND:
+		// Only a UART interface can change its line parameters.
+		if ((inst->bsp_data.iface_getchars == uart_getchars) &&
+			(p_set_uart_req->hw_flow_control == 0) &&
+			is_uart_baud_rate_supported(&inst->bsp_data.uart_inst,
+										p_set_uart_req->baud_rate)) {
+			p_set_uart_resp->ack_or_nak = ACK_BYTE;
+		} else {
+			p_set_uart_resp->ack_or_nak = 0;
+		}
 
-		case READ_REG_VALUE_FROM_GARD_AT_OFFSET:
-			bytes_to_read = sizeof(
-				iface_host_req->read_reg_value_from_gard_at_offset_request);
-			break;
+		// Fall through to send the composed response to Host.
 
-		case WRITE_REG_VALUE_TO_GARD_AT_OFFSET:
-			bytes_to_read = sizeof(
-				iface_host_req->write_reg_value_to_gard_at_offset_request);
-			break;
+	case EXECUTE_CMD_SET_UART_PARAMETERS__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
 
-		case GET_ML_ENGINE_STATUS:
-			bytes_to_read =
-				sizeof(iface_host_req->get_ml_engine_status_request);
-			break;
+		inst->send_data_async_call(inst, sizeof(*p_set_uart_resp),
+								   (uint8_t *)p_set_uart_resp);
 
-		case GARD_DISCOVERY:
-			bytes_to_read = sizeof(iface_host_req->gard_discovery_request);
-			break;
+		*current_state =
+			EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_RESPONSE_SEND;
 
-		case CAPTURE_RESCALED_IMAGE:
-			bytes_to_read =
-				sizeof(iface_host_req->capture_rescaled_image_request);
-			break;
+		// Fall through to check if the response is sent.
 
-		case RESUME_PIPELINE:
-			bytes_to_read = sizeof(iface_host_req->resume_pipeline_request);
-			break;
+	case EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_RESPONSE_SEND:
 
-		default:
-			bytes_to_read = 0;
-			break;
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
 		}
 
-		// Fall through to receive command body (minus the command code).
-
-	case REQUEST_IFACE_TO_RECV_CMD_BODY:
-
-		if (bytes_to_read == 0) {
-			// No command body to read, we jump to execute the command.
-			*current_state = EXECUTE_HOST_IFACE_CMD;
-			return true;  // No command body to read, return success.
+		if (p_set_uart_resp->ack_or_nak != ACK_BYTE) {
+			// Nothing to apply, go back to wait for new command.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			break;
 		}
 
-		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
-
-		// Request interface to receive remaining command body.
-		inst->read_data_async_call(inst, bytes_to_read,
-								   (uint8_t *)&iface_host_req->command_body);
+		*current_state = EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_LINE_IDLE;
 
-		// Wait for complete command body to be received.
-		*current_state = IFACE_WAIT_FOR_CMD_BODY;
+		// Fall through to wait for the response to leave the UART.
 
-		// Fall through to the next state.
+	case EXECUTE_CMD_SET_UART_PARAMETERS__WAIT_FOR_LINE_IDLE:
 
-	case IFACE_WAIT_FOR_CMD_BODY:
-		// Check if command body has been received over the interface.
-		if (!inst->hc_data.rx_done) {
-			return false;
+		if (!uart_is_tx_idle(&inst->bsp_data.uart_inst)) {
+			return false;  // Response is still in the UART FIFO.
 		}
 
-		// The command body has been received, but it is a packed structure
-		// containing unaligned fields. We need to unpack it to a similar padded
-		// structure so that RISC-V can access the fields without dying. The
-		// unpacking process is delegated to the individual command handlers
-		// instead of executing the code in this common routine.
+		// Fall through to program the new parameters.
 
-		// Fall through to the next state to unpack the command body and start
-		// executing the command
+	case EXECUTE_CMD_SET_UART_PARAMETERS__APPLY_PARAMETERS:
+		uart_set_rate(&inst->bsp_data.uart_inst, p_set_uart_req->baud_rate);
 
-	case EXECUTE_HOST_IFACE_CMD: {
-		// Copy the command ID between the packed and unpacked structures. This
-		// is done here since the command ID is common to all commands.
-		// For the next line we assume the code is running on a little-endian
-		// architecture.
-		*((uint8_t *)&host_req->command_id) = iface_host_req->command_id;
+		// Go back to start state to wait for new command at the new rate.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 
-		switch (iface_host_req->command_id) {
-		case SEND_DATA_TO_GARD_FOR_OFFSET:
-
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
-
-			// Currently _host_requests.send_data_to_gard_for_offset_request.cmd
-			// has the same size for both packed and unpacked versions so
-			// calling memcpy once to copy the entire structure is done. In
-			// future if these sizes differ, then individual fields should be
-			// copied between these structures.
-			GARD__CASSERT(
-				sizeof(host_req->send_data_to_gard_for_offset_request.cmd) ==
-					sizeof(iface_host_req->send_data_to_gard_for_offset_request
-							   .cmd),
-				"Sizes of packed and unpacked structures mismatch.");
-
-			memcpy(
-				(uint8_t *)&host_req->send_data_to_gard_for_offset_request.cmd,
-				(const uint8_t *)&iface_host_req
-					->send_data_to_gard_for_offset_request.cmd,
-				sizeof(
-					iface_host_req->send_data_to_gard_for_offset_request.cmd));
+		break;
 
-			*current_state =
-				EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__START_PROCESSING;
-			break;
+	default:
+		break;
+	}
 
-		case RECV_DATA_FROM_GARD_AT_OFFSET:
+	return true;  // Command execution complete.
+}
 
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
+/**
+ * exec_read_regs_from_gard executes the state machine for READ_REGS_FROM_GARD
+ * command.
+ *
+ * The register addresses and the end of data marker following them are
+ * received in one go. All the registers are then read and their values go
+ * back to Host in a single response.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_read_regs_from_gard(struct iface_instance           *inst,
+							 enum host_request_service_state *current_state,
+							 struct _host_requests_unpked    *host_req,
+							 struct _host_responses_unpked   *host_resp)
+{
+	struct _read_regs_from_gard_request_unpked  *p_read_regs_req;
+	struct _read_regs_from_gard_response_unpked *p_read_regs_resp;
+	uint32_t                                     num_regs;
+	uint32_t                                     idx;
 
-			// Currently _host_requests.recv_data_from_gard_at_offset_request
-			// has the same size for both packed and unpacked versions, hence
-			// using the packed structure to capture the body for this command.
-			GARD__CASSERT(
-				sizeof(host_req->recv_data_from_gard_at_offset_request) ==
-					sizeof(
-						iface_host_req->recv_data_from_gard_at_offset_request),
-				"Sizes of packed and unpacked structures mismatch.");
+	p_read_regs_req  = &host_req->read_regs_from_gard_request_unpked;
+	p_read_regs_resp = &host_resp->read_regs_from_gard_response_unpked;
+	num_regs         = p_read_regs_req->cmd.num_regs;
 
-			memcpy(
-				(uint8_t *)&host_req->recv_data_from_gard_at_offset_request,
-				(const uint8_t *)&iface_host_req
-					->recv_data_from_gard_at_offset_request,
-				sizeof(iface_host_req->recv_data_from_gard_at_offset_request));
+	switch (*current_state) {
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__START_PROCESSING:
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__VALIDATE_PARAMETERS:
 
-			*current_state =
-				EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__START_PROCESSING;
-			break;
+		if ((num_regs == 0) || (num_regs > GARD_HUB_MAX_REGS_PER_CMD)) {
+			// The payload cannot be received, drop the command.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			return false;
+		}
+
+		// Fall through to receive the register addresses.
 
-		case READ_REG_VALUE_FROM_GARD_AT_OFFSET:
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__REQ_PAYLOAD:
 
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
+		// Addresses and the end of data marker are 4-byte fields packed
+		// back to back, so they can be received straight into the aligned
+		// payload array.
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+		inst->read_data_async_call(inst, (num_regs + 1) * sizeof(uint32_t),
+								   (uint8_t *)p_read_regs_req->payload);
 
-			// Currently
-			// _host_requests.read_reg_value_from_gard_at_offset_request has the
-			// same size for both packed and unpacked versions so we use the
-			// packed version instead.
-			GARD__CASSERT(
-				sizeof(host_req->read_reg_value_from_gard_at_offset_request) ==
-					sizeof(iface_host_req
-							   ->read_reg_value_from_gard_at_offset_request),
-				"Sizes of packed and unpacked structures mismatch.");
+		*current_state = EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_PAYLOAD;
 
-			*current_state =
-				EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__START_PROCESSING;
-			break;
+		// Fall through to check if the data has arrived.
+
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_PAYLOAD:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
 
-		case WRITE_REG_VALUE_TO_GARD_AT_OFFSET:
-
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
-
-			// Currently
-			// _host_requests.write_reg_value_to_gard_at_offset_request has the
-			// same size for both packed and unpacked versions so calling
-			// memcpy once to copy the entire structure is done. In future if
-			// these sizes differ, then individual fields should be copied
-			// between these structures.
-			GARD__CASSERT(
-				sizeof(host_req->write_reg_value_to_gard_at_offset_request) ==
-					sizeof(iface_host_req
-							   ->write_reg_value_to_gard_at_offset_request),
-				"Sizes of packed and unpacked structures mismatch.");
-
-			memcpy(
-				(uint8_t *)&host_req->write_reg_value_to_gard_at_offset_request,
-				(const uint8_t *)&iface_host_req
-					->write_reg_value_to_gard_at_offset_request,
-				sizeof(
-					iface_host_req->write_reg_value_to_gard_at_offset_request));
+		// Fall through to validate the end of data marker.
 
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__VALIDATE_EOD_MARKER:
+
+		if (p_read_regs_req->payload[num_regs] != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
 			*current_state =
-				EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__START_PROCESSING;
-			break;
+				EXECUTE_CMD_READ_REGS_FROM_GARD__VALIDATE_EOD_MARKER;
+			return false;  // Error in end-of-data marker, abort execution.
+		}
 
-		case GET_ML_ENGINE_STATUS:
-
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
-
-			// Currently
-			// _host_requests.get_ml_engine_status_request has the
-			// same size for both packed and unpacked versions so calling
-			// memcpy once to copy the entire structure is done. In future if
-			// these sizes differ, then individual fields should be copied
-			// between these structures.
-			GARD__CASSERT(
-				sizeof(host_req->get_ml_engine_status_request) ==
-					sizeof(iface_host_req->get_ml_engine_status_request),
-				"Sizes of packed and unpacked structures mismatch.");
-
-			memcpy(
-				(uint8_t *)&host_req->get_ml_engine_status_request,
-				(const uint8_t *)&iface_host_req->get_ml_engine_status_request,
-				sizeof(iface_host_req->get_ml_engine_status_request));
-
-			*current_state = EXECUTE_CMD_GET_ML_ENGINE_STATUS__START_PROCESSING;
-			break;
+		// Fall through to read the registers.
 
-		case GARD_DISCOVERY:
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__COMPOSE_RESPONSE_TO_SEND:
 
-			// Currently
-			// _host_requests.gard_discovery_request is empty so no data
-			// unpacking is needed. In future if the need arises please refer to
-			// the previous states for code template to be used here.
-			*current_state = EXECUTE_CMD_DISCOVERY__START_PROCESSING;
-			break;
+		p_read_regs_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_read_regs_resp->num_regs             = num_regs;
+
+		for (idx = 0; idx < num_regs; idx++) {
+			p_read_regs_resp->reg_value[idx] =
+				*(volatile uint32_t *)p_read_regs_req->payload[idx];
+		}
+
+		p_read_regs_resp->reg_value[num_regs] = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		// sod, num_regs, the values and the eod marker in one go.
+		inst->send_data_async_call(inst, (num_regs + 3) * sizeof(uint32_t),
+								   (uint8_t *)p_read_regs_resp);
+
+		*current_state =
+			EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_RESPONSE_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Response has been sent, go back to start state to wait for
+		// new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		break;
+
+	default:
+		// Invalid state, reset to start state.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		return false;  // Error in state machine, abort execution.
+	}
+
+	return true;
+}
+
+/**
+ * exec_write_regs_to_gard executes the state machine for WRITE_REGS_TO_GARD
+ * command.
+ *
+ * The (address, value) pairs and the end of data marker following them are
+ * received in one go. The registers are written in the order listed and a
+ * single ACK is sent once all of them are done.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_write_regs_to_gard(struct iface_instance           *inst,
+							enum host_request_service_state *current_state,
+							struct _host_requests_unpked    *host_req,
+							struct _host_responses_unpked   *host_resp)
+{
+	struct _write_regs_to_gard_request_unpked  *p_write_regs_req;
+	struct _write_regs_to_gard_response_unpked *p_write_regs_resp;
+	uint32_t                                    num_regs;
+	uint32_t                                    idx;
+
+	p_write_regs_req  = &host_req->write_regs_to_gard_request_unpked;
+	p_write_regs_resp = &host_resp->write_regs_to_gard_response_unpked;
+	num_regs          = p_write_regs_req->cmd.num_regs;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__START_PROCESSING:
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__VALIDATE_PARAMETERS:
+
+		if ((num_regs == 0) || (num_regs > GARD_HUB_MAX_REGS_PER_CMD)) {
+			// The payload cannot be received, drop the command.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			return false;
+		}
+
+		// Fall through to receive the (address, value) pairs.
 
-		case CAPTURE_RESCALED_IMAGE:
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
-
-			// Move received parameters to the unpacked structure in optimized
-			// way as the received packed structure has made an attempt to align
-			// fields. Use assert to capture if this is not the case.
-			GARD__CASSERT(
-				(GET_MEMBER_SIZE(struct _host_requests,
-								 capture_rescaled_image_request.camera_id) ==
-				 sizeof(uint8_t)) &&
-					(GET_MEMBER_SIZE(
-						 struct _host_requests,
-						 capture_rescaled_image_request.end_of_data_marker) ==
-					 sizeof(uint32_t)) &&
-					((GET_MEMBER_OFFSET(
-						  struct _host_requests,
-						  capture_rescaled_image_request.end_of_data_marker) %
-					  sizeof(cpu_size_t)) == 0),
-				"Sizes or offsets of fields in packed structure have changed, "
-				"update the unpacking code.");
-
-			host_req->capture_rescaled_image_request_unpked.camera_id =
-				iface_host_req->capture_rescaled_image_request.camera_id;
-
-			host_req->capture_rescaled_image_request_unpked.end_of_data_marker =
-				iface_host_req->capture_rescaled_image_request
-					.end_of_data_marker;
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__REQ_PAYLOAD:
 
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+		inst->read_data_async_call(inst,
+								   ((2 * num_regs) + 1) * sizeof(uint32_t),
+								   (uint8_t *)p_write_regs_req->payload);
+
+		*current_state = EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_PAYLOAD;
+
+		// Fall through to check if the data has arrived.
+
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_PAYLOAD:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// Fall through to validate the end of data marker.
+
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__VALIDATE_EOD_MARKER:
+
+		if (p_write_regs_req->payload[2 * num_regs] != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
 			*current_state =
-				EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__START_PROCESSING;
-			break;
+				EXECUTE_CMD_WRITE_REGS_TO_GARD__VALIDATE_EOD_MARKER;
+			return false;  // Error in end-of-data marker, abort execution.
+		}
 
-		case RESUME_PIPELINE:
-			// Dummy statement to make compiler not complain about the
-			// GARD__CASSERT statement which follows.
-			iface_host_req->command_id = iface_host_req->command_id;
-
-			// Move received parameters to the unpacked structure in optimized
-			// way as the received packed structure has made an attempt to align
-			// fields. Use assert to capture if this is not the case.
-			GARD__CASSERT(
-				(GET_MEMBER_SIZE(struct _host_requests,
-								 resume_pipeline_request.camera_id) ==
-				 sizeof(uint8_t)) &&
-					(GET_MEMBER_SIZE(
-						 struct _host_requests,
-						 resume_pipeline_request.end_of_data_marker) ==
-					 sizeof(uint32_t)) &&
-					((GET_MEMBER_OFFSET(
-						  struct _host_requests,
-						  resume_pipeline_request.end_of_data_marker) %
-					  sizeof(cpu_size_t)) == 0),
-				"Sizes or offsets of fields in packed structure have changed, "
-				"update the unpacking code.");
-
-			host_req->capture_rescaled_image_request_unpked.camera_id =
-				iface_host_req->capture_rescaled_image_request.camera_id;
-
-			host_req->capture_rescaled_image_request_unpked.end_of_data_marker =
-				iface_host_req->capture_rescaled_image_request
-					.end_of_data_marker;
-
-			*current_state = EXECUTE_CMD_RESUME_PIPELINE__START_PROCESSING;
-			break;
+		// Fall through to write the registers.
 
-		default:
-			// Unsupported command ID, we should ASSERT here or handle
-			// the error appropriately.
-			return false;  // Unsupported command ID, abort execution.
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__WRITE_REGS_TO_GARD:
+
+		for (idx = 0; idx < num_regs; idx++) {
+			*(volatile uint32_t *)p_write_regs_req->payload[2 * idx] =
+				p_write_regs_req->payload[(2 * idx) + 1];
+		}
+
+		// Fall through to compose the response to send.
+
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__COMPOSE_RESPONSE_TO_SEND:
+		p_write_regs_resp->ack = ACK_BYTE;  // Set ACK byte to indicate success.
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+		inst->send_data_async_call(inst, sizeof(*p_write_regs_resp),
+								   (uint8_t *)p_write_regs_resp);
+
+		*current_state = EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_RESPONSE_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Writes are done, go back to start state to wait for
+		// new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		break;
+
+	default:
+		// Invalid state, reset to start state.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		return false;  // Error in state machine, abort execution.
+	}
+
+	return true;
+}
+
+/**
+ * exec_subscribe_app_data executes the state machine for SUBSCRIBE_APP_DATA
+ * command.
+ *
+ * Only a UART interface can push data to Host, I2C being a slave. A
+ * subscription on any other interface is NAKed. Subscribing moves the
+ * subscription over from any other interface and restarts the result
+ * numbering.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_subscribe_app_data(struct iface_instance           *inst,
+							enum host_request_service_state *current_state,
+							struct _host_requests_unpked    *host_req,
+							struct _host_responses_unpked   *host_resp)
+{
+	struct _subscribe_app_data_request_unpked  *p_subscribe_req;
+	struct _subscribe_app_data_response_unpked *p_subscribe_resp;
+
+	p_subscribe_req  = &host_req->subscribe_app_data_request_unpked;
+	p_subscribe_resp = &host_resp->subscribe_app_data_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_SUBSCRIBE_APP_DATA__START_PROCESSING:
+	case EXECUTE_CMD_SUBSCRIBE_APP_DATA__VALIDATE_PARAMETERS:
+
+		if (p_subscribe_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_SUBSCRIBE_APP_DATA__COMPOSE_RESPONSE_TO_SEND:
+
+		if (!p_subscribe_req->enable) {
+			// Buffers still queued are fetched on the next host IRQ.
+			if (app_data_subscriber == inst) {
+				app_data_subscriber = NULL;
+			}
+			p_subscribe_resp->ack_or_nak = ACK_BYTE;
+		} else if (inst->bsp_data.iface_getchars == uart_getchars) {
+			// Pushes start once the response is out, between commands, with
+			// the buffers already queued numbered from 0.
+			app_data_subscriber = inst;
+			for (app_data_push_seq_num = 0;
+				 app_data_push_seq_num < app_tx_queue_count;
+				 app_data_push_seq_num++) {
+				app_tx_queue_entry(app_data_push_seq_num)->seq_num =
+					app_data_push_seq_num;
+			}
+			p_subscribe_resp->ack_or_nak = ACK_BYTE;
+		} else {
+			p_subscribe_resp->ack_or_nak = 0;
+		}
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_SUBSCRIBE_APP_DATA__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_subscribe_resp),
+								   (uint8_t *)p_subscribe_resp);
+
+		*current_state = EXECUTE_CMD_SUBSCRIBE_APP_DATA__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_SUBSCRIBE_APP_DATA__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
 		}
 
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
 		break;
 	}
 
-	case EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__START_PROCESSING ... EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__END_PROCESSING:
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_get_pipeline_stats executes the state machine for GET_PIPELINE_STATS
+ * command. The statistics are copied when the response is composed, so the
+ * ones sent are consistent; with reset set they are cleared right after.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_get_pipeline_stats(struct iface_instance           *inst,
+							enum host_request_service_state *current_state,
+							struct _host_requests_unpked    *host_req,
+							struct _host_responses_unpked   *host_resp)
+{
+	struct _get_pipeline_stats_request_unpked  *p_stats_req;
+	struct _get_pipeline_stats_response_unpked *p_stats_resp;
+
+	p_stats_req  = &host_req->get_pipeline_stats_request_unpked;
+	p_stats_resp = &host_resp->get_pipeline_stats_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_GET_PIPELINE_STATS__START_PROCESSING:
+	case EXECUTE_CMD_GET_PIPELINE_STATS__VALIDATE_PARAMETERS:
+
+		if (p_stats_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 
-		return exec_send_data_to_gard_for_offset(inst, current_state, host_req,
-												 host_resp);
+			return false;
+		}
 
-	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__START_PROCESSING ... EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__END_PROCESSING:
+		// Fall through to compose response.
 
-		return exec_recv_data_from_gard_at_offset(inst, current_state, host_req,
-												  host_resp);
+	case EXECUTE_CMD_GET_PIPELINE_STATS__COMPOSE_RESPONSE_TO_SEND:
 
-	case EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__START_PROCESSING ... EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__END_PROCESSING:
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_stats_resp) ==
+						  sizeof(struct _get_pipeline_stats_response),
+					  "Sizes of packed and unpacked structures mismatch.");
 
-		return exec_read_reg_value_from_gard_at_offset(
-			inst, current_state, iface_host_req, host_resp);
+		p_stats_resp->start_of_data_marker   = START_OF_DATA_MARKER;
+		p_stats_resp->cycles_per_us          = PIPELINE_STATS_CYCLES_PER_US;
+		p_stats_resp->num_stages             = PIPELINE_STATS__NUM_STAGES;
+		p_stats_resp->rsvd1                  = 0;
+		p_stats_resp->eod.rsvd2              = 0;
+		p_stats_resp->eod.end_of_data_marker = END_OF_DATA_MARKER;
+		pipeline_stats_get(p_stats_resp->stages);
 
-	case EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__START_PROCESSING ... EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__END_PROCESSING:
+		if (p_stats_req->reset) {
+			pipeline_stats_reset();
+		}
 
-		return exec_write_reg_value_to_gard_at_offset(inst, current_state,
-													  host_req, host_resp);
+		// Fall through to send the composed response to Host.
 
-	case EXECUTE_CMD_GET_ML_ENGINE_STATUS__START_PROCESSING ... EXECUTE_CMD_GET_ML_ENGINE_STATUS__END_PROCESSING:
+	case EXECUTE_CMD_GET_PIPELINE_STATS__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
 
-		return exec_gel_ml_engine_status(inst, current_state, host_req,
-										 host_resp);
+		inst->send_data_async_call(inst, sizeof(*p_stats_resp),
+								   (uint8_t *)p_stats_resp);
 
-	case EXECUTE_CMD_DISCOVERY__START_PROCESSING ... EXECUTE_CMD_DISCOVERY__END_PROCESSING:
+		*current_state = EXECUTE_CMD_GET_PIPELINE_STATS__WAIT_FOR_RESPONSE_SEND;
 
-		return exec_gard_discovery(inst, current_state, host_req, host_resp);
+		// Fall through to check if the response is sent.
 
-	case EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__START_PROCESSING ... EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__END_PROCESSING:
+	case EXECUTE_CMD_GET_PIPELINE_STATS__WAIT_FOR_RESPONSE_SEND:
 
-		return exec_capture_rescaled_image(inst, current_state, host_req,
-										   host_resp);
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
 
-	case EXECUTE_CMD_RESUME_PIPELINE__START_PROCESSING ... EXECUTE_CMD_RESUME_PIPELINE__END_PROCESSING:
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 
-		return exec_resume_pipeline(inst, current_state, host_req, host_resp);
+		break;
 
 	default:
-		// ERROR - We should ASSERT here.
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_get_network_residency executes the state machine for
+ * GET_NETWORK_RESIDENCY command. It reports where the registered ML networks
+ * are in HRAM and how much of the HRAM for networks is free.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_get_network_residency(struct iface_instance           *inst,
+							   enum host_request_service_state *current_state,
+							   struct _host_requests_unpked    *host_req,
+							   struct _host_responses_unpked   *host_resp)
+{
+	struct _get_network_residency_request_unpked  *p_res_req;
+	struct _get_network_residency_response_unpked *p_res_resp;
+
+	p_res_req  = &host_req->get_network_residency_request_unpked;
+	p_res_resp = &host_resp->get_network_residency_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__START_PROCESSING:
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__VALIDATE_PARAMETERS:
+
+		if (p_res_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_res_resp) ==
+						  sizeof(struct _get_network_residency_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		memset(p_res_resp, 0, sizeof(*p_res_resp));
+		get_network_residency(p_res_resp);
+		p_res_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_res_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_res_resp),
+								   (uint8_t *)p_res_resp);
+
+		*current_state =
+			EXECUTE_CMD_GET_NETWORK_RESIDENCY__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_INFERENCE_RATE__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_inference_rate executes the state machine for INFERENCE_RATE command.
+ * With set it changes the policy picking the images the ML engine is run on,
+ * and in all cases it reports the policy in use and the rates it gives.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_inference_rate(struct iface_instance           *inst,
+								enum host_request_service_state *current_state,
+								struct _host_requests_unpked    *host_req,
+								struct _host_responses_unpked   *host_resp)
+{
+	struct _inference_rate_request_unpked  *p_rate_req;
+	struct _inference_rate_response_unpked *p_rate_resp;
+	bool                                    taken = true;
+
+	p_rate_req  = &host_req->inference_rate_request_unpked;
+	p_rate_resp = &host_resp->inference_rate_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_INFERENCE_RATE__START_PROCESSING:
+	case EXECUTE_CMD_INFERENCE_RATE__VALIDATE_PARAMETERS:
+
+		if (p_rate_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		if (p_rate_req->set) {
+			taken = set_inference_rate(
+				(enum inference_rate_modes)p_rate_req->mode,
+				p_rate_req->param);
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_INFERENCE_RATE__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_rate_resp) ==
+						  sizeof(struct _inference_rate_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		memset(p_rate_resp, 0, sizeof(*p_rate_resp));
+		get_inference_rate_report(p_rate_resp);
+		p_rate_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_rate_resp->ack_or_nak           = taken ? ACK_BYTE : 0;
+		p_rate_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_INFERENCE_RATE__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_rate_resp),
+								   (uint8_t *)p_rate_resp);
+
+		*current_state = EXECUTE_CMD_INFERENCE_RATE__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_INFERENCE_RATE__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_scaler_config executes the state machine for SCALER_CONFIG command.
+ * With set it gives the scaler engine a new capture configuration, applied at
+ * a frame boundary, and in all cases it reports the configuration last set.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_scaler_config(struct iface_instance           *inst,
+							   enum host_request_service_state *current_state,
+							   struct _host_requests_unpked    *host_req,
+							   struct _host_responses_unpked   *host_resp)
+{
+	struct _scaler_config_request_unpked  *p_cfg_req;
+	struct _scaler_config_response_unpked *p_cfg_resp;
+	struct scaler_config                   config;
+	bool                                   applied;
+	bool                                   taken = true;
+
+	p_cfg_req  = &host_req->scaler_config_request_unpked;
+	p_cfg_resp = &host_resp->scaler_config_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_SCALER_CONFIG__START_PROCESSING:
+	case EXECUTE_CMD_SCALER_CONFIG__VALIDATE_PARAMETERS:
+
+		if (p_cfg_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		if (p_cfg_req->set) {
+			config.precrop_left   = p_cfg_req->precrop_left;
+			config.precrop_right  = p_cfg_req->precrop_right;
+			config.precrop_upper  = p_cfg_req->precrop_upper;
+			config.precrop_bottom = p_cfg_req->precrop_bottom;
+			config.box_factor_x   = p_cfg_req->box_factor_x;
+			config.box_factor_y   = p_cfg_req->box_factor_y;
+			config.crop_left      = p_cfg_req->crop_left;
+			config.crop_right     = p_cfg_req->crop_right;
+			config.crop_upper     = p_cfg_req->crop_upper;
+			config.crop_bottom    = p_cfg_req->crop_bottom;
+			config.crop_in_width  = p_cfg_req->crop_in_width;
+			config.crop_in_height = p_cfg_req->crop_in_height;
+			config.out_width      = p_cfg_req->out_width;
+			config.out_height     = p_cfg_req->out_height;
+
+			taken = set_scaler_config(&config);
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_SCALER_CONFIG__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_cfg_resp) ==
+						  sizeof(struct _scaler_config_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		get_scaler_config(&config, &applied);
+
+		p_cfg_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_cfg_resp->ack_or_nak           = taken ? ACK_BYTE : 0;
+		p_cfg_resp->applied              = applied ? 1 : 0;
+		p_cfg_resp->box_factor_x         = config.box_factor_x;
+		p_cfg_resp->box_factor_y         = config.box_factor_y;
+		p_cfg_resp->precrop_left         = config.precrop_left;
+		p_cfg_resp->precrop_right        = config.precrop_right;
+		p_cfg_resp->precrop_upper        = config.precrop_upper;
+		p_cfg_resp->precrop_bottom       = config.precrop_bottom;
+		p_cfg_resp->crop_left            = config.crop_left;
+		p_cfg_resp->crop_right           = config.crop_right;
+		p_cfg_resp->crop_upper           = config.crop_upper;
+		p_cfg_resp->crop_bottom          = config.crop_bottom;
+		p_cfg_resp->crop_in_width        = config.crop_in_width;
+		p_cfg_resp->crop_in_height       = config.crop_in_height;
+		p_cfg_resp->out_width            = config.out_width;
+		p_cfg_resp->out_height           = config.out_height;
+		p_cfg_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_SCALER_CONFIG__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_cfg_resp),
+								   (uint8_t *)p_cfg_resp);
+
+		*current_state = EXECUTE_CMD_SCALER_CONFIG__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_SCALER_CONFIG__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_get_image_stats executes the state machine for GET_IMAGE_STATS command.
+ * It reports the ISP statistics of the last images captured.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_get_image_stats(struct iface_instance           *inst,
+								 enum host_request_service_state *current_state,
+								 struct _host_requests_unpked    *host_req,
+								 struct _host_responses_unpked   *host_resp)
+{
+	struct _get_image_stats_request_unpked  *p_stats_req;
+	struct _get_image_stats_response_unpked *p_stats_resp;
+
+	p_stats_req  = &host_req->get_image_stats_request_unpked;
+	p_stats_resp = &host_resp->get_image_stats_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_GET_IMAGE_STATS__START_PROCESSING:
+	case EXECUTE_CMD_GET_IMAGE_STATS__VALIDATE_PARAMETERS:
+
+		if (p_stats_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_GET_IMAGE_STATS__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_stats_resp) ==
+						  sizeof(struct _get_image_stats_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		memset(p_stats_resp, 0, sizeof(*p_stats_resp));
+		get_image_stats_report(p_stats_resp);
+		p_stats_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_stats_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_GET_IMAGE_STATS__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_stats_resp),
+								   (uint8_t *)p_stats_resp);
+
+		*current_state = EXECUTE_CMD_GET_IMAGE_STATS__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_GET_IMAGE_STATS__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_upgrade_firmware executes the state machine for UPGRADE_FIRMWARE
+ * command. The sub-commands only open the upgrade, queue a chunk or report
+ * the progress, the flash is programmed by continue_fw_upgrade().
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_upgrade_firmware(struct iface_instance           *inst,
+								  enum host_request_service_state *current_state,
+								  struct _host_requests_unpked    *host_req,
+								  struct _host_responses_unpked   *host_resp)
+{
+	struct _upgrade_firmware_request_unpked  *p_upgrade_req;
+	struct _upgrade_firmware_response_unpked *p_upgrade_resp;
+	struct fw_upgrade_xfer_info               xfer_info;
+	uint32_t                                  resp_size;
+
+	p_upgrade_req  = &host_req->upgrade_firmware_request_unpked;
+	p_upgrade_resp = &host_resp->upgrade_firmware_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__START_PROCESSING:
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__VALIDATE_PARAMETERS:
+
+		if ((p_upgrade_req->sub_command_id < USCID__GET_XFER_INFORMATION) ||
+			(p_upgrade_req->sub_command_id > USCID__IS_OPERATION_COMPLETE)) {
+			// Unknown sub-command, not answered.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_upgrade_resp) ==
+						  sizeof(struct _upgrade_firmware_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		memset(p_upgrade_resp, 0, sizeof(*p_upgrade_resp));
+
+		switch (p_upgrade_req->sub_command_id) {
+		case USCID__GET_XFER_INFORMATION:
+			fw_upgrade_start(p_upgrade_req->firmware_size,
+							 0 != p_upgrade_req->is_bitstream_included,
+							 0 != p_upgrade_req->resume, &xfer_info);
+			p_upgrade_resp->get_xfer_information_response
+				.start_of_data_marker = START_OF_DATA_MARKER;
+			p_upgrade_resp->get_xfer_information_response.buffer_address =
+				xfer_info.buffer_address;
+			p_upgrade_resp->get_xfer_information_response.buffer_size =
+				xfer_info.buffer_size;
+			p_upgrade_resp->get_xfer_information_response.flash_address =
+				xfer_info.flash_address;
+			p_upgrade_resp->get_xfer_information_response.num_buffers =
+				xfer_info.num_buffers;
+			p_upgrade_resp->get_xfer_information_response.end_of_data_marker =
+				END_OF_DATA_MARKER;
+			break;
+
+		case USCID__WRITE_FIRMWARE_TO_FLASH:
+			p_upgrade_resp->write_firmware_to_flash_response.ack =
+				fw_upgrade_queue_chunk(p_upgrade_req->buffer_address,
+									   p_upgrade_req->bytes_to_write,
+									   p_upgrade_req->flash_address,
+									   p_upgrade_req->crc)
+					? ACK_BYTE
+					: 0;
+			break;
+
+		default:
+			p_upgrade_resp->is_operation_complete_response.operation_status =
+				fw_upgrade_get_status(&p_upgrade_resp
+										   ->is_operation_complete_response
+										   .bytes_programmed);
+			break;
+		}
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__SEND_RESPONSE_TO_HOST:
+		// Only the part of the sub-command is sent.
+		switch (p_upgrade_req->sub_command_id) {
+		case USCID__GET_XFER_INFORMATION:
+			resp_size = sizeof(p_upgrade_resp->get_xfer_information_response);
+			break;
+		case USCID__WRITE_FIRMWARE_TO_FLASH:
+			resp_size =
+				sizeof(p_upgrade_resp->write_firmware_to_flash_response);
+			break;
+		default:
+			resp_size = sizeof(p_upgrade_resp->is_operation_complete_response);
+			break;
+		}
+
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, resp_size, (uint8_t *)p_upgrade_resp);
+
+		*current_state = EXECUTE_CMD_UPGRADE_FIRMWARE__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_get_gard_time executes the state machine for GET_GARD_TIME command.
+ * It reports the CPU TSC the frames are time stamped with, read right before
+ * the response is sent so that Host can pair it with its own clock.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_get_gard_time(struct iface_instance           *inst,
+							   enum host_request_service_state *current_state,
+							   struct _host_requests_unpked    *host_req,
+							   struct _host_responses_unpked   *host_resp)
+{
+	struct _get_gard_time_request_unpked  *p_time_req;
+	struct _get_gard_time_response_unpked *p_time_resp;
+	uint64_t                               now;
+
+	p_time_req  = &host_req->get_gard_time_request_unpked;
+	p_time_resp = &host_resp->get_gard_time_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_GET_GARD_TIME__START_PROCESSING:
+	case EXECUTE_CMD_GET_GARD_TIME__VALIDATE_PARAMETERS:
+
+		if (p_time_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_GET_GARD_TIME__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_time_resp) ==
+						  sizeof(struct _get_gard_time_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		now                               = get_cpu_tsc();
+		p_time_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_time_resp->time_lo              = (uint32_t)now;
+		p_time_resp->time_hi              = (uint32_t)(now >> 32);
+		p_time_resp->timer_freq           = CLINT_TIMEBASE_FREQ;
+		p_time_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_GET_GARD_TIME__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_time_resp),
+								   (uint8_t *)p_time_resp);
+
+		*current_state = EXECUTE_CMD_GET_GARD_TIME__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_GET_GARD_TIME__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_run_inference_on_buffer executes the state machine for
+ * RUN_INFERENCE_ON_BUFFER command. It queues the image Host wrote to an input
+ * slot for the ML engine, or goes back to the camera images, and in all cases
+ * it reports the input slots.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool
+	exec_run_inference_on_buffer(struct iface_instance           *inst,
+								 enum host_request_service_state *current_state,
+								 struct _host_requests_unpked    *host_req,
+								 struct _host_responses_unpked   *host_resp)
+{
+	struct _run_inference_on_buffer_request_unpked  *p_run_req;
+	struct _run_inference_on_buffer_response_unpked *p_run_resp;
+	struct host_input_status                         status;
+	bool                                             taken = true;
+	uint32_t                                         idx;
+
+	p_run_req  = &host_req->run_inference_on_buffer_request_unpked;
+	p_run_resp = &host_resp->run_inference_on_buffer_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__START_PROCESSING:
+	case EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__VALIDATE_PARAMETERS:
+
+		if (p_run_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		switch (p_run_req->op) {
+		case HOST_INFERENCE__QUERY:
+			break;
+		case HOST_INFERENCE__SUBMIT:
+			taken = submit_host_input(
+				p_run_req->slot, (enum image_formats)p_run_req->format,
+				p_run_req->width, p_run_req->height, p_run_req->frame_id);
+			break;
+		case HOST_INFERENCE__STOP:
+			stop_host_input();
+			break;
+		default:
+			taken = false;
+			break;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_run_resp) ==
+						  sizeof(struct _run_inference_on_buffer_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		get_host_input_status(&status);
+
+		p_run_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_run_resp->ack_or_nak           = taken ? ACK_BYTE : 0;
+		p_run_resp->active               = status.active ? 1 : 0;
+		p_run_resp->free_slots           = status.free_slots;
+		p_run_resp->rsvd1                = 0;
+		for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+			p_run_resp->slot_address[idx] = status.slot_address[idx];
+		}
+		p_run_resp->slot_size          = status.slot_size;
+		p_run_resp->end_of_data_marker = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_run_resp),
+								   (uint8_t *)p_run_resp);
+
+		*current_state =
+			EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_swap_network executes the state machine for SWAP_NETWORK command. It
+ * stages, commits or aborts the swap of a registered network, the check,
+ * switch and RFS update being done in the background, see network_swap.h. In
+ * all cases it reports the swap.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_swap_network(struct iface_instance           *inst,
+							  enum host_request_service_state *current_state,
+							  struct _host_requests_unpked    *host_req,
+							  struct _host_responses_unpked   *host_resp)
+{
+	struct _swap_network_request_unpked  *p_swap_req;
+	struct _swap_network_response_unpked *p_swap_resp;
+	struct network_swap_info              info;
+	bool                                  taken = true;
+
+	p_swap_req  = &host_req->swap_network_request_unpked;
+	p_swap_resp = &host_resp->swap_network_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_SWAP_NETWORK__START_PROCESSING:
+	case EXECUTE_CMD_SWAP_NETWORK__VALIDATE_PARAMETERS:
+
+		if (p_swap_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		switch (p_swap_req->op) {
+		case NETWORK_SWAP__STATUS:
+			break;
+		case NETWORK_SWAP__STAGE:
+			taken = network_swap_stage(
+				(ml_network_handle_t)p_swap_req->network, p_swap_req->size);
+			break;
+		case NETWORK_SWAP__COMMIT:
+			taken = network_swap_commit(
+				(ml_network_handle_t)p_swap_req->network, p_swap_req->size,
+				p_swap_req->crc,
+				0U != (p_swap_req->flags & NETWORK_SWAP__PERSIST));
+			break;
+		case NETWORK_SWAP__ABORT:
+			taken = network_swap_abort();
+			break;
+		default:
+			taken = false;
+			break;
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_SWAP_NETWORK__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_swap_resp) ==
+						  sizeof(struct _swap_network_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		network_swap_get_info(&info);
+
+		p_swap_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_swap_resp->ack_or_nak           = taken ? ACK_BYTE : 0;
+		p_swap_resp->status               = info.status;
+		p_swap_resp->rsvd1                = 0;
+		p_swap_resp->network              = info.network;
+		p_swap_resp->staging_address      = info.staging_address;
+		p_swap_resp->staging_size         = info.staging_size;
+		p_swap_resp->bytes_persisted      = info.bytes_persisted;
+		p_swap_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_SWAP_NETWORK__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_swap_resp),
+								   (uint8_t *)p_swap_resp);
+
+		*current_state = EXECUTE_CMD_SWAP_NETWORK__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_SWAP_NETWORK__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_app_data_coalescing executes the state machine for APP_DATA_COALESCING
+ * command. With set it turns the coalescing of the app data IRQs on or off,
+ * see app_tx_coalesce.h, and in all cases it reports the setting in use and
+ * its counts.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_app_data_coalescing(
+	struct iface_instance           *inst,
+	enum host_request_service_state *current_state,
+	struct _host_requests_unpked    *host_req,
+	struct _host_responses_unpked   *host_resp)
+{
+	struct _app_data_coalescing_request_unpked  *p_coal_req;
+	struct _app_data_coalescing_response_unpked *p_coal_resp;
+	bool                                         taken = true;
+
+	p_coal_req  = &host_req->app_data_coalescing_request_unpked;
+	p_coal_resp = &host_resp->app_data_coalescing_response_unpked;
+
+	switch (*current_state) {
+	case EXECUTE_CMD_APP_DATA_COALESCING__START_PROCESSING:
+	case EXECUTE_CMD_APP_DATA_COALESCING__VALIDATE_PARAMETERS:
+
+		if (p_coal_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		if (p_coal_req->set) {
+			taken = set_app_tx_coalescing(0U != p_coal_req->enable,
+										  p_coal_req->max_latency_ms);
+		}
+
+		// Fall through to compose response.
+
+	case EXECUTE_CMD_APP_DATA_COALESCING__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_coal_resp) ==
+						  sizeof(struct _app_data_coalescing_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		memset(p_coal_resp, 0, sizeof(*p_coal_resp));
+		get_app_tx_coalescing_report(p_coal_resp);
+		p_coal_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_coal_resp->ack_or_nak           = taken ? ACK_BYTE : 0;
+		p_coal_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_APP_DATA_COALESCING__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done =
+			false;  // Reset the flag to wait for data to be sent.
+
+		inst->send_data_async_call(inst, sizeof(*p_coal_resp),
+								   (uint8_t *)p_coal_resp);
+
+		*current_state =
+			EXECUTE_CMD_APP_DATA_COALESCING__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_APP_DATA_COALESCING__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * exec_app_command executes the state machine for an App Module command
+ * registered with register_host_command(). The command body is received in
+ * the buffer registered with the command, then the App Module handler is
+ * called and the status it returns is sent to Host.
+ *
+ * The body size of a command that is not registered is not known, so its
+ * bytes are skipped up to END_OF_DATA_MARKER, to stay in step with Host, and
+ * APP_COMMAND_STATUS_NOT_REGISTERED is sent instead.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ * @param current_state: Pointer to the current state of the command execution.
+ * @param host_req: Pointer to the host request structure containing the request
+ *                  details.
+ * @param host_resp: Pointer to the host response structure containing the
+ * 					response details.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool exec_app_command(struct iface_instance           *inst,
+							 enum host_request_service_state *current_state,
+							 struct _host_requests_unpked    *host_req,
+							 struct _host_responses_unpked   *host_resp)
+{
+	struct _app_command_request_unpked  *p_app_req;
+	struct _app_command_response_unpked *p_app_resp;
+	struct app_host_cmd                 *p_app_cmd;
+
+	p_app_req  = &host_req->app_command_request_unpked;
+	p_app_resp = &host_resp->app_command_response_unpked;
+	p_app_cmd  = &app_host_cmds[host_req->command_id - APP_COMMAND_ID_FIRST];
+
+	switch (*current_state) {
+	case EXECUTE_CMD_APP_COMMAND__START_PROCESSING:
+	case EXECUTE_CMD_APP_COMMAND__REQ_PAYLOAD:
+		if (NULL == p_app_cmd->handler) {
+			p_app_req->end_of_data_marker = 0U;
+			*current_state = EXECUTE_CMD_APP_COMMAND__SKIP_BODY;
+
+			return false;
+		}
+
+		// The command body goes straight to the App Module buffer.
+		if (p_app_cmd->body_size > 0U) {
+			inst->hc_data.rx_done = false;
+			inst->read_data_async_call(inst, p_app_cmd->body_size,
+									   p_app_cmd->p_body);
+		} else {
+			inst->hc_data.rx_done = true;
+		}
+
+		*current_state = EXECUTE_CMD_APP_COMMAND__WAIT_FOR_PAYLOAD;
+
+		// Fall through to wait for the command body.
+
+	case EXECUTE_CMD_APP_COMMAND__WAIT_FOR_PAYLOAD:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		inst->hc_data.rx_done = false;
+		inst->read_data_async_call(inst, sizeof(p_app_req->end_of_data_marker),
+								   (uint8_t *)&p_app_req->end_of_data_marker);
+
+		*current_state = EXECUTE_CMD_APP_COMMAND__WAIT_FOR_EOD_MARKER;
+
+		// Fall through to wait for the end of data marker.
+
+	case EXECUTE_CMD_APP_COMMAND__WAIT_FOR_EOD_MARKER:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// Fall through to validate the end of data marker.
+
+	case EXECUTE_CMD_APP_COMMAND__VALIDATE_EOD_MARKER:
+		if (p_app_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			// Handle error in end-of-data marker.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+			return false;
+		}
+
+		// Fall through to run the command and compose the response.
+
+	case EXECUTE_CMD_APP_COMMAND__COMPOSE_RESPONSE_TO_SEND:
+
+		// The unpacked response is sent as is, its layout has to be the
+		// same as the packed one.
+		GARD__CASSERT(sizeof(*p_app_resp) ==
+						  sizeof(struct _app_command_response),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		p_app_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_app_resp->status               = p_app_cmd->handler(
+			p_app_cmd->app_context, host_req->command_id, p_app_cmd->p_body,
+			p_app_cmd->body_size);
+		p_app_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		// Fall through to send the composed response to Host.
+
+	case EXECUTE_CMD_APP_COMMAND__SEND_RESPONSE_TO_HOST:
+		inst->hc_data.tx_done = false;
+		inst->send_data_async_call(inst, sizeof(*p_app_resp),
+								   (uint8_t *)p_app_resp);
+
+		*current_state = EXECUTE_CMD_APP_COMMAND__WAIT_FOR_RESPONSE_SEND;
+
+		// Fall through to check if the response is sent.
+
+	case EXECUTE_CMD_APP_COMMAND__WAIT_FOR_RESPONSE_SEND:
+
+		if (!inst->hc_data.tx_done) {
+			return false;  // Wait for response to be sent.
+		}
+
+		// Go back to start state to wait for new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+
+		break;
+
+	case EXECUTE_CMD_APP_COMMAND__SKIP_BODY:
+		inst->hc_data.rx_done = false;
+		inst->read_data_async_call(inst, sizeof(p_app_req->skipped_byte),
+								   &p_app_req->skipped_byte);
+
+		*current_state = EXECUTE_CMD_APP_COMMAND__WAIT_FOR_SKIPPED_BYTE;
+
+		// Fall through to wait for the byte.
+
+	case EXECUTE_CMD_APP_COMMAND__WAIT_FOR_SKIPPED_BYTE:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// The last 4 bytes, in the little-endian order of the marker.
+		p_app_req->end_of_data_marker =
+			(p_app_req->end_of_data_marker >> 8) |
+			((uint32_t)p_app_req->skipped_byte << 24);
+
+		if (p_app_req->end_of_data_marker != END_OF_DATA_MARKER) {
+			*current_state = EXECUTE_CMD_APP_COMMAND__SKIP_BODY;
+
+			return false;
+		}
+
+		p_app_resp->start_of_data_marker = START_OF_DATA_MARKER;
+		p_app_resp->status               = APP_COMMAND_STATUS_NOT_REGISTERED;
+		p_app_resp->end_of_data_marker   = END_OF_DATA_MARKER;
+
+		*current_state = EXECUTE_CMD_APP_COMMAND__SEND_RESPONSE_TO_HOST;
+
+		return false;
+
+	default:
+		break;
+	}
+
+	return true;  // Command execution complete.
+}
+
+/**
+ * push_app_data_to_host pushes the pending App Module result to the Host
+ * subscribed on the interface, as struct _app_data_push_header, the data
+ * and END_OF_DATA_MARKER.
+ *
+ * It is called while the interface waits for a command id, i.e. between two
+ * commands, so a push never splits a response. A command id arriving during
+ * a push is only looked at once the push is complete, so the response to it
+ * follows the push on the wire.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ *
+ * @return true while the push is in progress, false otherwise.
+ */
+static bool push_app_data_to_host(struct iface_instance *inst)
+{
+	GARD__CASSERT(sizeof(inst->hc_data.push_hdr) ==
+					  sizeof(struct _app_data_push_header),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	switch (inst->hc_data.push_state) {
+	case APP_DATA_PUSH__IDLE:
+
+		// Nothing to push, or the interface is still sending.
+		if ((app_data_subscriber != inst) || (0U == app_tx_queue_count) ||
+			(inst->bytes_to_send != 0U)) {
+			return false;
+		}
+
+		// The oldest buffer stays queued until it is out, the App Module
+		// queues the next ones meanwhile.
+		inst->hc_data.push_hdr.push_marker = APP_DATA_PUSH_MARKER;
+		inst->hc_data.push_hdr.seq_num     = app_tx_queue_entry(0)->seq_num;
+		inst->hc_data.push_hdr.data_size   = app_tx_queue_entry(0)->size;
+		inst->hc_data.push_eod_marker      = END_OF_DATA_MARKER;
+		seal_app_tx(1);
+
+		inst->hc_data.tx_done              = false;
+		inst->send_data_async_call(inst, sizeof(inst->hc_data.push_hdr),
+								   (uint8_t *)&inst->hc_data.push_hdr);
+
+		inst->hc_data.push_state = APP_DATA_PUSH__WAIT_FOR_HEADER_SEND;
+
+		// Fall through to send the data once the header is out.
+
+	case APP_DATA_PUSH__WAIT_FOR_HEADER_SEND:
+		if (!inst->hc_data.tx_done) {
+			return true;
+		}
+
+		start_app_tx_spans(inst);
+		inst->hc_data.push_state = APP_DATA_PUSH__WAIT_FOR_PAYLOAD_SEND;
+
+		// Fall through to send the data, then the end of data marker.
+
+	case APP_DATA_PUSH__WAIT_FOR_PAYLOAD_SEND:
+		if (!send_app_tx_spans(inst, app_tx_queue_entry(0),
+							   inst->hc_data.push_hdr.data_size, NULL)) {
+			return true;
+		}
+
+		inst->hc_data.tx_done = false;
+		inst->send_data_async_call(inst, sizeof(inst->hc_data.push_eod_marker),
+								   (uint8_t *)&inst->hc_data.push_eod_marker);
+
+		inst->hc_data.push_state = APP_DATA_PUSH__WAIT_FOR_EOD_SEND;
+
+		// Fall through to complete the push.
+
+	case APP_DATA_PUSH__WAIT_FOR_EOD_SEND:
+		if (!inst->hc_data.tx_done) {
+			return true;
+		}
+
+		// Same completion as for a result read with CC_APP_DATA.
+		complete_app_tx(1);
+
+		inst->hc_data.push_state = APP_DATA_PUSH__IDLE;
+		break;
+
+	default:
+		// Invalid state, drop the push.
+		inst->hc_data.push_state = APP_DATA_PUSH__IDLE;
+		break;
+	}
+
+	return false;
+}
+
+/**
+ * unpack_send_data_to_gard_for_offset unpacks the body of
+ * SEND_DATA_TO_GARD_FOR_OFFSET command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_send_data_to_gard_for_offset(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.send_data_to_gard_for_offset_request.cmd has
+	// the same size for both packed and unpacked versions so calling memcpy
+	// once to copy the entire structure is done. In future if these sizes
+	// differ, then individual fields should be copied between these
+	// structures.
+	GARD__CASSERT(
+		sizeof(host_req->send_data_to_gard_for_offset_request.cmd) ==
+			sizeof(iface_host_req->send_data_to_gard_for_offset_request.cmd),
+		"Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->send_data_to_gard_for_offset_request.cmd,
+		   (const uint8_t *)&iface_host_req
+			   ->send_data_to_gard_for_offset_request.cmd,
+		   sizeof(iface_host_req->send_data_to_gard_for_offset_request.cmd));
+}
+
+/**
+ * unpack_recv_data_from_gard_at_offset unpacks the body of
+ * RECV_DATA_FROM_GARD_AT_OFFSET command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_recv_data_from_gard_at_offset(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.recv_data_from_gard_at_offset_request has the
+	// same size for both packed and unpacked versions, hence using the packed
+	// structure to capture the body for this command.
+	GARD__CASSERT(
+		sizeof(host_req->recv_data_from_gard_at_offset_request) ==
+			sizeof(iface_host_req->recv_data_from_gard_at_offset_request),
+		"Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->recv_data_from_gard_at_offset_request,
+		   (const uint8_t *)&iface_host_req
+			   ->recv_data_from_gard_at_offset_request,
+		   sizeof(iface_host_req->recv_data_from_gard_at_offset_request));
+}
+
+/**
+ * unpack_read_reg_value_from_gard_at_offset unpacks the body of
+ * READ_REG_VALUE_FROM_GARD_AT_OFFSET command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_read_reg_value_from_gard_at_offset(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.read_reg_value_from_gard_at_offset_request has
+	// the same size for both packed and unpacked versions so calling memcpy
+	// once to copy the entire structure is done. In future if these sizes
+	// differ, then individual fields should be copied between these
+	// structures.
+	GARD__CASSERT(
+		sizeof(host_req->read_reg_value_from_gard_at_offset_request) ==
+			sizeof(iface_host_req->read_reg_value_from_gard_at_offset_request),
+		"Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->read_reg_value_from_gard_at_offset_request,
+		   (const uint8_t *)&iface_host_req
+			   ->read_reg_value_from_gard_at_offset_request,
+		   sizeof(iface_host_req->read_reg_value_from_gard_at_offset_request));
+}
+
+/**
+ * unpack_write_reg_value_to_gard_at_offset unpacks the body of
+ * WRITE_REG_VALUE_TO_GARD_AT_OFFSET command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_write_reg_value_to_gard_at_offset(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.write_reg_value_to_gard_at_offset_request has
+	// the same size for both packed and unpacked versions so calling memcpy
+	// once to copy the entire structure is done. In future if these sizes
+	// differ, then individual fields should be copied between these
+	// structures.
+	GARD__CASSERT(
+		sizeof(host_req->write_reg_value_to_gard_at_offset_request) ==
+			sizeof(iface_host_req->write_reg_value_to_gard_at_offset_request),
+		"Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->write_reg_value_to_gard_at_offset_request,
+		   (const uint8_t *)&iface_host_req
+			   ->write_reg_value_to_gard_at_offset_request,
+		   sizeof(iface_host_req->write_reg_value_to_gard_at_offset_request));
+}
+
+/**
+ * unpack_get_ml_engine_status unpacks the body of GET_ML_ENGINE_STATUS
+ * command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_get_ml_engine_status(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.get_ml_engine_status_request has the same size
+	// for both packed and unpacked versions so calling memcpy once to copy
+	// the entire structure is done. In future if these sizes differ, then
+	// individual fields should be copied between these structures.
+	GARD__CASSERT(sizeof(host_req->get_ml_engine_status_request) ==
+					  sizeof(iface_host_req->get_ml_engine_status_request),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->get_ml_engine_status_request,
+		   (const uint8_t *)&iface_host_req->get_ml_engine_status_request,
+		   sizeof(iface_host_req->get_ml_engine_status_request));
+}
+
+/**
+ * unpack_capture_rescaled_image unpacks the body of CAPTURE_RESCALED_IMAGE
+ * command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_capture_rescaled_image(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Move received parameters to the unpacked structure in optimized way as
+	// the received packed structure has made an attempt to align fields. Use
+	// assert to capture if this is not the case.
+	GARD__CASSERT(
+		(GET_MEMBER_SIZE(struct _host_requests,
+						 capture_rescaled_image_request.camera_id) ==
+		 sizeof(uint8_t)) &&
+			(GET_MEMBER_SIZE(
+				 struct _host_requests,
+				 capture_rescaled_image_request.end_of_data_marker) ==
+			 sizeof(uint32_t)) &&
+			((GET_MEMBER_OFFSET(
+				  struct _host_requests,
+				  capture_rescaled_image_request.end_of_data_marker) %
+			  sizeof(cpu_size_t)) == 0),
+		"Sizes or offsets of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	host_req->capture_rescaled_image_request_unpked.camera_id =
+		iface_host_req->capture_rescaled_image_request.camera_id;
+
+	host_req->capture_rescaled_image_request_unpked.flags =
+		iface_host_req->capture_rescaled_image_request.flags;
+
+	host_req->capture_rescaled_image_request_unpked.decimation =
+		iface_host_req->capture_rescaled_image_request.decimation;
+
+	host_req->capture_rescaled_image_request_unpked.roi_x =
+		iface_host_req->capture_rescaled_image_request.roi_x;
+
+	host_req->capture_rescaled_image_request_unpked.roi_y =
+		iface_host_req->capture_rescaled_image_request.roi_y;
+
+	host_req->capture_rescaled_image_request_unpked.roi_width =
+		iface_host_req->capture_rescaled_image_request.roi_width;
+
+	host_req->capture_rescaled_image_request_unpked.roi_height =
+		iface_host_req->capture_rescaled_image_request.roi_height;
+
+	host_req->capture_rescaled_image_request_unpked.codec =
+		iface_host_req->capture_rescaled_image_request.codec;
+
+	host_req->capture_rescaled_image_request_unpked.end_of_data_marker =
+		iface_host_req->capture_rescaled_image_request.end_of_data_marker;
+}
+
+/**
+ * unpack_resume_pipeline unpacks the body of RESUME_PIPELINE command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_resume_pipeline(struct _host_requests_unpked *host_req,
+								   const struct _host_requests  *iface_host_req)
+{
+	// Move received parameters to the unpacked structure in optimized way as
+	// the received packed structure has made an attempt to align fields. Use
+	// assert to capture if this is not the case.
+	GARD__CASSERT(
+		(GET_MEMBER_SIZE(struct _host_requests,
+						 resume_pipeline_request.camera_id) ==
+		 sizeof(uint8_t)) &&
+			(GET_MEMBER_SIZE(struct _host_requests,
+							 resume_pipeline_request.end_of_data_marker) ==
+			 sizeof(uint32_t)) &&
+			((GET_MEMBER_OFFSET(struct _host_requests,
+								resume_pipeline_request.end_of_data_marker) %
+			  sizeof(cpu_size_t)) == 0),
+		"Sizes or offsets of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	host_req->resume_pipeline_request_unpked.camera_id =
+		iface_host_req->resume_pipeline_request.camera_id;
+
+	host_req->resume_pipeline_request_unpked.end_of_data_marker =
+		iface_host_req->resume_pipeline_request.end_of_data_marker;
+}
+
+/**
+ * unpack_set_uart_parameters unpacks the body of SET_UART_PARAMETERS command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_set_uart_parameters(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// The packed request keeps baud_rate and the end of data marker 4-byte
+	// aligned relative to each other. Use assert to capture if this is not
+	// the case.
+	GARD__CASSERT(
+		(GET_MEMBER_SIZE(struct _host_requests,
+						 set_uart_parameters_request.baud_rate) ==
+		 sizeof(uint32_t)) &&
+			(GET_MEMBER_SIZE(struct _host_requests,
+							 set_uart_parameters_request.end_of_data_marker) ==
+			 sizeof(uint32_t)),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	// Unaligned fields of the packed request are copied byte-wise.
+	memcpy((uint8_t *)&host_req->set_uart_parameters_request_unpked.baud_rate,
+		   (const uint8_t *)&iface_host_req->set_uart_parameters_request
+			   .baud_rate,
+		   sizeof(uint32_t));
+
+	host_req->set_uart_parameters_request_unpked.hw_flow_control =
+		iface_host_req->set_uart_parameters_request.hw_flow_control;
+
+	memcpy((uint8_t *)&host_req->set_uart_parameters_request_unpked
+			   .end_of_data_marker,
+		   (const uint8_t *)&iface_host_req->set_uart_parameters_request
+			   .end_of_data_marker,
+		   sizeof(uint32_t));
+}
+
+/**
+ * unpack_read_regs_from_gard unpacks the body of READ_REGS_FROM_GARD command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_read_regs_from_gard(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.read_regs_from_gard_request.cmd has the same
+	// size for both packed and unpacked versions so calling memcpy once to
+	// copy the entire structure is done. The register addresses are received
+	// later by the command handler.
+	GARD__CASSERT(sizeof(host_req->read_regs_from_gard_request_unpked.cmd) ==
+					  sizeof(iface_host_req->read_regs_from_gard_request.cmd),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->read_regs_from_gard_request_unpked.cmd,
+		   (const uint8_t *)&iface_host_req->read_regs_from_gard_request.cmd,
+		   sizeof(iface_host_req->read_regs_from_gard_request.cmd));
+}
+
+/**
+ * unpack_write_regs_to_gard unpacks the body of WRITE_REGS_TO_GARD command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_write_regs_to_gard(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	// Currently _host_requests.write_regs_to_gard_request.cmd has the same
+	// size for both packed and unpacked versions so calling memcpy once to
+	// copy the entire structure is done. The (address, value) pairs are
+	// received later by the command handler.
+	GARD__CASSERT(sizeof(host_req->write_regs_to_gard_request_unpked.cmd) ==
+					  sizeof(iface_host_req->write_regs_to_gard_request.cmd),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	memcpy((uint8_t *)&host_req->write_regs_to_gard_request_unpked.cmd,
+		   (const uint8_t *)&iface_host_req->write_regs_to_gard_request.cmd,
+		   sizeof(iface_host_req->write_regs_to_gard_request.cmd));
+}
+
+/**
+ * unpack_subscribe_app_data unpacks the body of SUBSCRIBE_APP_DATA command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_subscribe_app_data(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(
+		GET_MEMBER_SIZE(struct _host_requests,
+						subscribe_app_data_request.end_of_data_marker) ==
+			sizeof(uint32_t),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	host_req->subscribe_app_data_request_unpked.enable =
+		iface_host_req->subscribe_app_data_request.enable;
+
+	// The packed marker is not 4-byte aligned, copy it byte-wise.
+	memcpy((uint8_t *)&host_req->subscribe_app_data_request_unpked
+			   .end_of_data_marker,
+		   (const uint8_t *)&iface_host_req->subscribe_app_data_request
+			   .end_of_data_marker,
+		   sizeof(uint32_t));
+}
+
+/**
+ * unpack_get_pipeline_stats unpacks the body of GET_PIPELINE_STATS command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_get_pipeline_stats(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(
+		GET_MEMBER_SIZE(struct _host_requests,
+						get_pipeline_stats_request.end_of_data_marker) ==
+			sizeof(uint32_t),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	host_req->get_pipeline_stats_request_unpked.reset =
+		iface_host_req->get_pipeline_stats_request.reset;
+
+	// The packed marker is not 4-byte aligned, copy it byte-wise.
+	memcpy((uint8_t *)&host_req->get_pipeline_stats_request_unpked
+			   .end_of_data_marker,
+		   (const uint8_t *)&iface_host_req->get_pipeline_stats_request
+			   .end_of_data_marker,
+		   sizeof(uint32_t));
+}
+
+/**
+ * unpack_get_network_residency unpacks the body of GET_NETWORK_RESIDENCY
+ * command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_get_network_residency(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(
+		GET_MEMBER_SIZE(struct _host_requests,
+						get_network_residency_request.end_of_data_marker) ==
+			sizeof(uint32_t),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	memcpy((uint8_t *)&host_req->get_network_residency_request_unpked
+			   .end_of_data_marker,
+		   (const uint8_t *)&iface_host_req->get_network_residency_request
+			   .end_of_data_marker,
+		   sizeof(uint32_t));
+}
+
+/**
+ * unpack_inference_rate unpacks the body of INFERENCE_RATE command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_inference_rate(struct _host_requests_unpked *host_req,
+								  const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(
+		(GET_MEMBER_SIZE(struct _host_requests, inference_rate_request.param) ==
+		 sizeof(uint32_t)) &&
+			(GET_MEMBER_SIZE(struct _host_requests,
+							 inference_rate_request.end_of_data_marker) ==
+			 sizeof(uint32_t)),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	host_req->inference_rate_request_unpked.set =
+		iface_host_req->inference_rate_request.set;
+	host_req->inference_rate_request_unpked.mode =
+		iface_host_req->inference_rate_request.mode;
+
+	// The packed fields are not 4-byte aligned, copy them byte-wise.
+	memcpy((uint8_t *)&host_req->inference_rate_request_unpked.param,
+		   (const uint8_t *)&iface_host_req->inference_rate_request.param,
+		   sizeof(uint32_t));
+	memcpy(
+		(uint8_t *)&host_req->inference_rate_request_unpked.end_of_data_marker,
+		(const uint8_t *)&iface_host_req->inference_rate_request
+			.end_of_data_marker,
+		sizeof(uint32_t));
+}
+
+/**
+ * unpack_scaler_config unpacks the body of SCALER_CONFIG command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_scaler_config(struct _host_requests_unpked *host_req,
+								 const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(sizeof(host_req->scaler_config_request_unpked) ==
+					  sizeof(struct _scaler_config_request),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	// The packed fields are not aligned, copy the body byte-wise.
+	memcpy((uint8_t *)&host_req->scaler_config_request_unpked,
+		   (const uint8_t *)&iface_host_req->scaler_config_request,
+		   sizeof(struct _scaler_config_request));
+}
+
+/**
+ * unpack_get_image_stats unpacks the body of GET_IMAGE_STATS command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_get_image_stats(struct _host_requests_unpked *host_req,
+								   const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(GET_MEMBER_SIZE(struct _host_requests,
+								  get_image_stats_request.end_of_data_marker) ==
+					  sizeof(uint32_t),
+				  "Sizes of fields in packed structure have changed, "
+				  "update the unpacking code.");
+
+	memcpy(
+		(uint8_t *)&host_req->get_image_stats_request_unpked.end_of_data_marker,
+		(const uint8_t *)&iface_host_req->get_image_stats_request
+			.end_of_data_marker,
+		sizeof(uint32_t));
+}
+
+/**
+ * unpack_upgrade_firmware unpacks the body of UPGRADE_FIRMWARE command, the
+ * fields of its sub-command only.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_upgrade_firmware(struct _host_requests_unpked *host_req,
+									const struct _host_requests  *iface_host_req)
+{
+	const struct _upgrade_firmware_request  *p_req;
+	struct _upgrade_firmware_request_unpked *p_unpked;
+
+	p_req    = &iface_host_req->upgrade_firmware_request;
+	p_unpked = &host_req->upgrade_firmware_request_unpked;
+
+	GARD__CASSERT(
+		(GET_MEMBER_SIZE(struct _upgrade_firmware_request,
+						 get_xfer_information.firmware_size) ==
+		 sizeof(uint32_t)) &&
+			(GET_MEMBER_SIZE(struct _upgrade_firmware_request,
+							 write_firmware_to_flash.crc) == sizeof(uint32_t)),
+		"Sizes of fields in packed structure have changed, "
+		"update the unpacking code.");
+
+	memset(p_unpked, 0, sizeof(*p_unpked));
+	p_unpked->sub_command_id = p_req->sub_command_id;
+
+	// The packed fields are not 4-byte aligned, copy them byte-wise.
+	switch (p_req->sub_command_id) {
+	case USCID__GET_XFER_INFORMATION:
+		p_unpked->is_bitstream_included =
+			p_req->get_xfer_information.is_bitstream_included;
+		p_unpked->resume = p_req->get_xfer_information.resume;
+		memcpy((uint8_t *)&p_unpked->firmware_size,
+			   (const uint8_t *)&p_req->get_xfer_information.firmware_size,
+			   sizeof(uint32_t));
+		break;
+
+	case USCID__WRITE_FIRMWARE_TO_FLASH:
+		memcpy((uint8_t *)&p_unpked->buffer_address,
+			   (const uint8_t *)&p_req->write_firmware_to_flash.buffer_address,
+			   sizeof(uint32_t));
+		memcpy((uint8_t *)&p_unpked->bytes_to_write,
+			   (const uint8_t *)&p_req->write_firmware_to_flash.bytes_to_write,
+			   sizeof(uint32_t));
+		memcpy((uint8_t *)&p_unpked->flash_address,
+			   (const uint8_t *)&p_req->write_firmware_to_flash.flash_address,
+			   sizeof(uint32_t));
+		memcpy((uint8_t *)&p_unpked->crc,
+			   (const uint8_t *)&p_req->write_firmware_to_flash.crc,
+			   sizeof(uint32_t));
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ * unpack_get_gard_time unpacks the body of GET_GARD_TIME command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_get_gard_time(struct _host_requests_unpked *host_req,
+								 const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(GET_MEMBER_SIZE(struct _host_requests,
+								  get_gard_time_request.end_of_data_marker) ==
+					  sizeof(uint32_t),
+				  "Sizes of fields in packed structure have changed, "
+				  "update the unpacking code.");
+
+	memcpy(
+		(uint8_t *)&host_req->get_gard_time_request_unpked.end_of_data_marker,
+		(const uint8_t *)&iface_host_req->get_gard_time_request
+			.end_of_data_marker,
+		sizeof(uint32_t));
+}
+
+/**
+ * unpack_run_inference_on_buffer unpacks the body of RUN_INFERENCE_ON_BUFFER
+ * command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void
+	unpack_run_inference_on_buffer(struct _host_requests_unpked *host_req,
+								   const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(sizeof(host_req->run_inference_on_buffer_request_unpked) ==
+					  sizeof(struct _run_inference_on_buffer_request),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	// The packed fields are not aligned, copy the body byte-wise.
+	memcpy((uint8_t *)&host_req->run_inference_on_buffer_request_unpked,
+		   (const uint8_t *)&iface_host_req->run_inference_on_buffer_request,
+		   sizeof(struct _run_inference_on_buffer_request));
+}
+
+/**
+ * unpack_swap_network unpacks the body of SWAP_NETWORK command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_swap_network(struct _host_requests_unpked *host_req,
+								const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(sizeof(host_req->swap_network_request_unpked) ==
+					  sizeof(struct _swap_network_request),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	// The packed fields are not aligned, copy the body byte-wise.
+	memcpy((uint8_t *)&host_req->swap_network_request_unpked,
+		   (const uint8_t *)&iface_host_req->swap_network_request,
+		   sizeof(struct _swap_network_request));
+}
+
+/**
+ * unpack_app_data_coalescing unpacks the body of APP_DATA_COALESCING command.
+ *
+ * @param host_req: Pointer to the unpacked host request to fill.
+ * @param iface_host_req: Pointer to the host request received over the
+ *                        interface.
+ */
+static void unpack_app_data_coalescing(
+	struct _host_requests_unpked *host_req,
+	const struct _host_requests  *iface_host_req)
+{
+	GARD__CASSERT(sizeof(host_req->app_data_coalescing_request_unpked) ==
+					  sizeof(struct _app_data_coalescing_request),
+				  "Sizes of packed and unpacked structures mismatch.");
+
+	// The packed fields are not aligned, copy the body byte-wise.
+	memcpy((uint8_t *)&host_req->app_data_coalescing_request_unpked,
+		   (const uint8_t *)&iface_host_req->app_data_coalescing_request,
+		   sizeof(struct _app_data_coalescing_request));
+}
+
+/**
+ * HOST_CMD_DESC fills the host_cmd_desc of a command from the member of
+ * union _host_requests holding its body, its unpack function, its exec
+ * function and the range of states of the latter.
+ */
+#define HOST_CMD_DESC(body, unpack_fn, exec_fn, first, last)                   \
+	{.body_size   = GET_MEMBER_SIZE(struct _host_requests, body),              \
+	 .unpack      = unpack_fn,                                                 \
+	 .exec        = exec_fn,                                                   \
+	 .first_state = first,                                                     \
+	 .last_state  = last}
+
+/**
+ * host_cmd_table holds the FW Core commands, indexed by command id. The
+ * entries of the command ids FW Core does not support are left empty.
+ */
+static const struct host_cmd_desc host_cmd_table[] = {
+	[GARD_DISCOVERY] = HOST_CMD_DESC(
+		gard_discovery_request, NULL,
+		exec_gard_discovery,
+		EXECUTE_CMD_DISCOVERY__START_PROCESSING,
+		EXECUTE_CMD_DISCOVERY__END_PROCESSING),
+	[SEND_DATA_TO_GARD_FOR_OFFSET] = HOST_CMD_DESC(
+		send_data_to_gard_for_offset_request.cmd,
+		unpack_send_data_to_gard_for_offset,
+		exec_send_data_to_gard_for_offset,
+		EXEC_SEND_DATA_TO_GARD_FOR_OFFSET__START_PROCESSING,
+		EXEC_SEND_DATA_FRAMES_TO_GARD__END_PROCESSING),
+	[RECV_DATA_FROM_GARD_AT_OFFSET] = HOST_CMD_DESC(
+		recv_data_from_gard_at_offset_request,
+		unpack_recv_data_from_gard_at_offset,
+		exec_recv_data_from_gard_at_offset,
+		EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__START_PROCESSING,
+		EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__END_PROCESSING),
+	[READ_REG_VALUE_FROM_GARD_AT_OFFSET] = HOST_CMD_DESC(
+		read_reg_value_from_gard_at_offset_request,
+		unpack_read_reg_value_from_gard_at_offset,
+		exec_read_reg_value_from_gard_at_offset,
+		EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__START_PROCESSING,
+		EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__END_PROCESSING),
+	[WRITE_REG_VALUE_TO_GARD_AT_OFFSET] = HOST_CMD_DESC(
+		write_reg_value_to_gard_at_offset_request,
+		unpack_write_reg_value_to_gard_at_offset,
+		exec_write_reg_value_to_gard_at_offset,
+		EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__START_PROCESSING,
+		EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__END_PROCESSING),
+	[GET_ML_ENGINE_STATUS] = HOST_CMD_DESC(
+		get_ml_engine_status_request, unpack_get_ml_engine_status,
+		exec_gel_ml_engine_status,
+		EXECUTE_CMD_GET_ML_ENGINE_STATUS__START_PROCESSING,
+		EXECUTE_CMD_GET_ML_ENGINE_STATUS__END_PROCESSING),
+	[CAPTURE_RESCALED_IMAGE] = HOST_CMD_DESC(
+		capture_rescaled_image_request, unpack_capture_rescaled_image,
+		exec_capture_rescaled_image,
+		EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__START_PROCESSING,
+		EXECUTE_CMD_CAPTURE_RESCALED_IMAGE__END_PROCESSING),
+	[RESUME_PIPELINE] = HOST_CMD_DESC(
+		resume_pipeline_request, unpack_resume_pipeline,
+		exec_resume_pipeline,
+		EXECUTE_CMD_RESUME_PIPELINE__START_PROCESSING,
+		EXECUTE_CMD_RESUME_PIPELINE__END_PROCESSING),
+	[SET_UART_PARAMETERS] = HOST_CMD_DESC(
+		set_uart_parameters_request, unpack_set_uart_parameters,
+		exec_set_uart_parameters,
+		EXECUTE_CMD_SET_UART_PARAMETERS__START_PROCESSING,
+		EXECUTE_CMD_SET_UART_PARAMETERS__END_PROCESSING),
+	[READ_REGS_FROM_GARD] = HOST_CMD_DESC(
+		read_regs_from_gard_request.cmd, unpack_read_regs_from_gard,
+		exec_read_regs_from_gard,
+		EXECUTE_CMD_READ_REGS_FROM_GARD__START_PROCESSING,
+		EXECUTE_CMD_READ_REGS_FROM_GARD__END_PROCESSING),
+	[WRITE_REGS_TO_GARD] = HOST_CMD_DESC(
+		write_regs_to_gard_request.cmd, unpack_write_regs_to_gard,
+		exec_write_regs_to_gard,
+		EXECUTE_CMD_WRITE_REGS_TO_GARD__START_PROCESSING,
+		EXECUTE_CMD_WRITE_REGS_TO_GARD__END_PROCESSING),
+	[SUBSCRIBE_APP_DATA] = HOST_CMD_DESC(
+		subscribe_app_data_request, unpack_subscribe_app_data,
+		exec_subscribe_app_data,
+		EXECUTE_CMD_SUBSCRIBE_APP_DATA__START_PROCESSING,
+		EXECUTE_CMD_SUBSCRIBE_APP_DATA__END_PROCESSING),
+	[GET_PIPELINE_STATS] = HOST_CMD_DESC(
+		get_pipeline_stats_request, unpack_get_pipeline_stats,
+		exec_get_pipeline_stats,
+		EXECUTE_CMD_GET_PIPELINE_STATS__START_PROCESSING,
+		EXECUTE_CMD_GET_PIPELINE_STATS__END_PROCESSING),
+	[GET_NETWORK_RESIDENCY] = HOST_CMD_DESC(
+		get_network_residency_request, unpack_get_network_residency,
+		exec_get_network_residency,
+		EXECUTE_CMD_GET_NETWORK_RESIDENCY__START_PROCESSING,
+		EXECUTE_CMD_GET_NETWORK_RESIDENCY__END_PROCESSING),
+	[INFERENCE_RATE] = HOST_CMD_DESC(
+		inference_rate_request, unpack_inference_rate, exec_inference_rate,
+		EXECUTE_CMD_INFERENCE_RATE__START_PROCESSING,
+		EXECUTE_CMD_INFERENCE_RATE__END_PROCESSING),
+	[SCALER_CONFIG] = HOST_CMD_DESC(
+		scaler_config_request, unpack_scaler_config, exec_scaler_config,
+		EXECUTE_CMD_SCALER_CONFIG__START_PROCESSING,
+		EXECUTE_CMD_SCALER_CONFIG__END_PROCESSING),
+	[GET_IMAGE_STATS] = HOST_CMD_DESC(
+		get_image_stats_request, unpack_get_image_stats, exec_get_image_stats,
+		EXECUTE_CMD_GET_IMAGE_STATS__START_PROCESSING,
+		EXECUTE_CMD_GET_IMAGE_STATS__END_PROCESSING),
+	[GET_GARD_TIME] = HOST_CMD_DESC(
+		get_gard_time_request, unpack_get_gard_time, exec_get_gard_time,
+		EXECUTE_CMD_GET_GARD_TIME__START_PROCESSING,
+		EXECUTE_CMD_GET_GARD_TIME__END_PROCESSING),
+	[RUN_INFERENCE_ON_BUFFER] = HOST_CMD_DESC(
+		run_inference_on_buffer_request, unpack_run_inference_on_buffer,
+		exec_run_inference_on_buffer,
+		EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__START_PROCESSING,
+		EXECUTE_CMD_RUN_INFERENCE_ON_BUFFER__END_PROCESSING),
+	[SWAP_NETWORK] = HOST_CMD_DESC(
+		swap_network_request, unpack_swap_network, exec_swap_network,
+		EXECUTE_CMD_SWAP_NETWORK__START_PROCESSING,
+		EXECUTE_CMD_SWAP_NETWORK__END_PROCESSING),
+	[APP_DATA_COALESCING] = HOST_CMD_DESC(
+		app_data_coalescing_request, unpack_app_data_coalescing,
+		exec_app_data_coalescing,
+		EXECUTE_CMD_APP_DATA_COALESCING__START_PROCESSING,
+		EXECUTE_CMD_APP_DATA_COALESCING__END_PROCESSING),
+	[UPGRADE_FIRMWARE] = HOST_CMD_DESC(
+		upgrade_firmware_request, unpack_upgrade_firmware,
+		exec_upgrade_firmware, EXECUTE_CMD_UPGRADE_FIRMWARE__START_PROCESSING,
+		EXECUTE_CMD_UPGRADE_FIRMWARE__END_PROCESSING),
+};
+
+/**
+ * app_host_cmd_desc is shared by all the App Module commands, whose body is
+ * received by exec_app_command() into the buffer registered with the command.
+ */
+static const struct host_cmd_desc app_host_cmd_desc = {
+	.body_size   = 0,
+	.unpack      = NULL,
+	.exec        = exec_app_command,
+	.first_state = EXECUTE_CMD_APP_COMMAND__START_PROCESSING,
+	.last_state  = EXECUTE_CMD_APP_COMMAND__END_PROCESSING,
+};
+
+/**
+ * host_cmd_lookup finds how to handle a command, be it a FW Core command or a
+ * registered App Module command.
+ *
+ * @param command_id: Command id, with CMD_ID_TAGGED stripped.
+ *
+ * @return Pointer to the command descriptor, NULL for an unknown command.
+ */
+static const struct host_cmd_desc *host_cmd_lookup(uint8_t command_id)
+{
+	const struct host_cmd_desc *p_cmd = NULL;
+
+	if (command_id < (sizeof(host_cmd_table) / sizeof(host_cmd_table[0]))) {
+		p_cmd = &host_cmd_table[command_id];
+	} else if ((command_id >= APP_COMMAND_ID_FIRST) &&
+			   (command_id <= APP_COMMAND_ID_LAST)) {
+		// Registered or not, see exec_app_command().
+		p_cmd = &app_host_cmd_desc;
+	}
+
+	return ((NULL != p_cmd) && (NULL != p_cmd->exec)) ? p_cmd : NULL;
+}
+
+/**
+ * host_request_body_size returns the size of the command body that follows
+ * the command id of a host request on the interface.
+ *
+ * @param p_req: Pointer to the host request, with its command id received.
+ *
+ * @return Size of the command body in bytes, 0 for an unknown command.
+ */
+static uint32_t host_request_body_size(const struct _host_requests *p_req)
+{
+	const struct host_cmd_desc *p_cmd = host_cmd_lookup(p_req->command_id);
+
+	return (NULL != p_cmd) ? p_cmd->body_size : 0U;
+}
+
+/**
+ * is_host_response_in_flight tells if the command being served only has its
+ * response left to send. The command no longer needs the interface RX nor
+ * iface_host_req then, so the next command can be taken in meanwhile.
+ *
+ * SET_UART_PARAMETERS is left out as the baud rate changes once its response
+ * is out.
+ *
+ * @param state: Current state of the host request service state machine.
+ *
+ * @return true if only the response is left to send, false otherwise.
+ */
+static bool is_host_response_in_flight(enum host_request_service_state state)
+{
+	switch (state) {
+	case EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_SOD_SEND ... EXEC_CMD_RECV_DATA_FROM_GARD_AT_OFFSET__WAIT_FOR_EOD_SEND:
+	case EXECUTE_CMD_READ_REG_VALUE_FROM_GARD_AT_OFFSET__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_WRITE_REG_VALUE_TO_GARD_AT_OFFSET__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_GET_ML_ENGINE_STATUS__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_READ_REGS_FROM_GARD__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_WRITE_REGS_TO_GARD__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_GET_PIPELINE_STATS__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_GET_NETWORK_RESIDENCY__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_UPGRADE_FIRMWARE__WAIT_FOR_RESPONSE_SEND:
+	case EXECUTE_CMD_APP_COMMAND__WAIT_FOR_RESPONSE_SEND:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * receive_next_host_request takes the next command in, command id, tag and
+ * command body, while the response of the current one is being sent. It
+ * receives into iface_host_req, is_tagged and tag_hdr directly as the current
+ * command is done with them, see is_host_response_in_flight(). Once
+ * NEXT_REQUEST__READY the command is served from IFACE_WAIT_FOR_NEXT_CMD.
+ *
+ * TBD-SRP: only one command is taken in ahead, which is all HUB sends.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ */
+static void receive_next_host_request(struct iface_instance *inst)
+{
+	struct _host_requests *iface_host_req = &inst->hc_data.iface_host_req;
+	uint32_t               bytes_to_read;
+
+	switch (inst->hc_data.next_req_state) {
+	case NEXT_REQUEST__IDLE:
+		iface_host_req->command_id = 0;
+
+		inst->hc_data.rx_done      = false;
+		inst->read_data_async_call(inst, sizeof(iface_host_req->command_id),
+								   (uint8_t *)&iface_host_req->command_id);
+
+		inst->hc_data.next_req_state = NEXT_REQUEST__WAIT_FOR_CMD_ID;
+
+		// Fall through to wait for the command id.
+
+	case NEXT_REQUEST__WAIT_FOR_CMD_ID:
+		if (!inst->hc_data.rx_done) {
+			return;
+		}
+
+		inst->hc_data.is_tagged =
+			(0U != (iface_host_req->command_id & CMD_ID_TAGGED));
+		if (inst->hc_data.is_tagged) {
+			iface_host_req->command_id &= (uint8_t)~CMD_ID_TAGGED;
+
+			inst->hc_data.rx_done       = false;
+			inst->read_data_async_call(inst, sizeof(inst->hc_data.tag_hdr.tag),
+									   &inst->hc_data.tag_hdr.tag);
+		}
+
+		inst->hc_data.next_req_state = NEXT_REQUEST__WAIT_FOR_CMD_TAG;
+
+		// Fall through to wait for the tag, if any.
+
+	case NEXT_REQUEST__WAIT_FOR_CMD_TAG:
+		if (!inst->hc_data.rx_done) {
+			return;
+		}
+
+		bytes_to_read = host_request_body_size(iface_host_req);
+		if (bytes_to_read > 0U) {
+			inst->hc_data.rx_done = false;
+			inst->read_data_async_call(
+				inst, bytes_to_read, (uint8_t *)&iface_host_req->command_body);
+		}
+
+		inst->hc_data.next_req_state = NEXT_REQUEST__WAIT_FOR_CMD_BODY;
+
+		// Fall through to wait for the command body.
+
+	case NEXT_REQUEST__WAIT_FOR_CMD_BODY:
+		if (!inst->hc_data.rx_done) {
+			return;
+		}
+
+		inst->hc_data.next_req_state = NEXT_REQUEST__READY;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ * resync_host_requests drops the command being served on an interface once
+ * Host has sent GARD_HUB_RESYNC_SEQUENCE, along with the command taken in
+ * ahead, the bulk command set aside and the push in progress, and has
+ * struct _resync_ack sent so that Host knows where the next command starts.
+ *
+ * A dropped command is not undone: a capture leaves the pipeline paused until
+ * Host resumes it, and a push is sent again from its start as its result is
+ * still queued. A firmware upgrade or a network swap cut short is started
+ * again by Host.
+ *
+ * @param inst: Pointer to the interface instance structure that contains
+ *              the interface details and the host command data.
+ */
+static void resync_host_requests(struct iface_instance *inst)
+{
+	iface_resync(inst);
+
+	inst->hc_data.rx_done         = false;
+	inst->hc_data.tx_done         = false;
+	inst->hc_data.is_tagged       = false;
+	inst->hc_data.next_req_state  = NEXT_REQUEST__IDLE;
+	inst->hc_data.bulk_lane.state = 0;
+	inst->hc_data.push_state      = APP_DATA_PUSH__IDLE;
+
+	inst->hc_data.resync_ack.resync_ack_marker  = RESYNC_ACK_MARKER;
+	inst->hc_data.resync_ack.resync_count++;
+	inst->hc_data.resync_ack.end_of_data_marker = END_OF_DATA_MARKER;
+
+	inst->hc_data.host_request_service_state = IFACE_SEND_RESYNC_ACK;
+}
+
+/**
+ * service_host_requests processes the host requests that originate
+ * over UART/I2C or other slow serial interfaces.
+ *
+ * This function implements a state machine to handle various host commands
+ * received over serial interfaces. It reads the command ID, calculates the
+ * command body size based on the command ID, and then reads the command body
+ * from the interface. Once the command body is fully received, it executes the
+ * command based on the command ID. For different commands it offloads the
+ * responsibility to sub-functions that handle the specific command execution
+ * logic, found in host_cmd_table or among the registered App Module commands.
+ *
+ * @return true if the command execution is complete, false if more data is
+ *         expected or if an error occurs.
+ */
+static bool service_host_request_over_iface(struct iface_instance *inst)
+{
+	// The following variables are used in the state machine and need to
+	// maintain their values across function calls.
+	enum host_request_service_state *current_state =
+		(enum host_request_service_state *)&inst->hc_data
+			.host_request_service_state;
+
+	/**
+	 * The next two variables are used within this file to work on the received
+	 * command. These variables are unpacked versions of their packed cousins
+	 * that are filled with the data arriving over the interface.
+	 */
+	struct _host_requests_unpked  *host_req  = &inst->hc_data.host_req;
+	struct _host_responses_unpked *host_resp = &inst->hc_data.host_resp;
+
+	/**
+	 * The next variable is used to receive the command body over the
+	 * interface.
+	 */
+	struct _host_requests      *iface_host_req = &inst->hc_data.iface_host_req;
+	uint32_t                    bytes_to_read;
+	const struct host_cmd_desc *p_cmd;
+
+	// Host resynchronizes whatever is being served, see iface_resync().
+	if (inst->resync_requested) {
+		resync_host_requests(inst);
+	}
+
+	// Take the next command in while the response of this one goes out, see
+	// CMD_ID_TAGGED.
+	if (is_host_response_in_flight(*current_state)) {
+		receive_next_host_request(inst);
+	}
+
+	switch (*current_state) {
+	case REQUEST_IFACE_TO_RECV_CMD_ID:
+		// Go back first to a bulk command set aside for the control command
+		// just served, see CC_SEGMENTED.
+		if (resume_bulk_host_request(inst)) {
+			return true;
+		}
+
+		// Serve first the next command if it has been taken in, even partly,
+		// while the last response was being sent.
+		if (NEXT_REQUEST__IDLE != inst->hc_data.next_req_state) {
+			*current_state = IFACE_WAIT_FOR_NEXT_CMD;
+			return true;
+		}
+
+		iface_host_req->command_id = 0;
+
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+
+		// Request interface to receive 1 byte command code.
+		inst->read_data_async_call(inst, sizeof(iface_host_req->command_id),
+								   (uint8_t *)&iface_host_req->command_id);
+
+		// Wait for the command code to be received.
+		*current_state = IFACE_WAIT_FOR_CMD_ID;
+
+		// Fall through to the next state.
+
+	case IFACE_WAIT_FOR_CMD_ID:
+		// Between two commands, push the pending result to a subscribed
+		// Host. A command that has come in meanwhile waits for the push.
+		if (push_app_data_to_host(inst)) {
+			return true;
+		}
+
+		// Check if command code is available.
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// A tagged command id is followed by its tag, see CMD_ID_TAGGED.
+		inst->hc_data.is_tagged =
+			(0U != (iface_host_req->command_id & CMD_ID_TAGGED));
+		if (inst->hc_data.is_tagged) {
+			iface_host_req->command_id &= (uint8_t)~CMD_ID_TAGGED;
+
+			inst->hc_data.rx_done       = false;
+			inst->read_data_async_call(inst, sizeof(inst->hc_data.tag_hdr.tag),
+									   &inst->hc_data.tag_hdr.tag);
+		}
+
+		*current_state = IFACE_WAIT_FOR_CMD_TAG;
+
+		// Fall through to wait for the tag, if any.
+
+	case IFACE_WAIT_FOR_CMD_TAG:
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// Fall through to the next state to calcaulate the size of command
+		// body.
+
+	case IFACE_CALCULATE_CMD_BODY_SIZE:
+
+		// Calculate the size of the command body based on the command ID.
+		bytes_to_read = host_request_body_size(iface_host_req);
+
+		// Fall through to receive command body (minus the command code).
+
+	case REQUEST_IFACE_TO_RECV_CMD_BODY:
+
+		if (bytes_to_read == 0) {
+			// No command body to read, we jump to execute the command.
+			*current_state = IFACE_SEND_RESPONSE_TAG;
+			return true;  // No command body to read, return success.
+		}
+
+		inst->hc_data.rx_done = false;  // Reset the flag to wait for new data.
+
+		// Request interface to receive remaining command body.
+		inst->read_data_async_call(inst, bytes_to_read,
+								   (uint8_t *)&iface_host_req->command_body);
+
+		// Wait for complete command body to be received.
+		*current_state = IFACE_WAIT_FOR_CMD_BODY;
+
+		// Fall through to the next state.
+
+	case IFACE_WAIT_FOR_CMD_BODY:
+		// Check if command body has been received over the interface.
+		if (!inst->hc_data.rx_done) {
+			return false;
+		}
+
+		// The command body has been received, but it is a packed structure
+		// containing unaligned fields. We need to unpack it to a similar padded
+		// structure so that RISC-V can access the fields without dying. The
+		// unpacking is done by the unpack function of the command, see
+		// host_cmd_table.
+
+		// Fall through to the next state to send the tag of the command, if
+		// any, then unpack the command body and start executing the command.
+
+	case IFACE_SEND_RESPONSE_TAG:
+		if (inst->hc_data.is_tagged) {
+			GARD__CASSERT(sizeof(inst->hc_data.tag_hdr) ==
+							  sizeof(struct _response_tag_header),
+						  "Sizes of packed and unpacked structures mismatch.");
+
+			inst->hc_data.tag_hdr.tag_marker = RESPONSE_TAG_MARKER;
+
+			inst->hc_data.tx_done            = false;
+			inst->send_data_async_call(inst, sizeof(inst->hc_data.tag_hdr),
+									   (uint8_t *)&inst->hc_data.tag_hdr);
+		} else {
+			inst->hc_data.tx_done = true;
+		}
+
+		*current_state = IFACE_WAIT_FOR_RESPONSE_TAG_SEND;
+
+		// Fall through to start the command once the tag is out.
+
+	case IFACE_WAIT_FOR_RESPONSE_TAG_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		// Fall through to unpack the command body and execute the command.
+
+	case EXECUTE_HOST_IFACE_CMD:
+		// Copy the command ID between the packed and unpacked structures. This
+		// is done here since the command ID is common to all commands.
+		// For the next line we assume the code is running on a little-endian
+		// architecture.
+		*((uint8_t *)&host_req->command_id) = iface_host_req->command_id;
+
+		p_cmd = host_cmd_lookup(iface_host_req->command_id);
+		if (NULL == p_cmd) {
+			// Unsupported command ID, drop it and wait for the next command.
+			*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+			return false;
+		}
+
+		if (NULL != p_cmd->unpack) {
+			p_cmd->unpack(host_req, iface_host_req);
+		}
+
+		*current_state = p_cmd->first_state;
+		break;
+
+	case IFACE_SEND_RESYNC_ACK:
+		GARD__CASSERT(sizeof(inst->hc_data.resync_ack) ==
+						  sizeof(struct _resync_ack),
+					  "Sizes of packed and unpacked structures mismatch.");
+
+		inst->hc_data.tx_done = false;
+		inst->send_data_async_call(inst, sizeof(inst->hc_data.resync_ack),
+								   (uint8_t *)&inst->hc_data.resync_ack);
+
+		*current_state = IFACE_WAIT_FOR_RESYNC_ACK_SEND;
+
+		// Fall through to wait for the acknowledgement to go out.
+
+	case IFACE_WAIT_FOR_RESYNC_ACK_SEND:
+		if (!inst->hc_data.tx_done) {
+			return false;
+		}
+
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
+		return true;
+
+	case IFACE_WAIT_FOR_NEXT_CMD:
+		// Between two commands, as in IFACE_WAIT_FOR_CMD_ID, but no push is
+		// started once some of the next command has come in: Host expects its
+		// response right after the last one.
+		if (((APP_DATA_PUSH__IDLE != inst->hc_data.push_state) ||
+			 (NEXT_REQUEST__WAIT_FOR_CMD_ID == inst->hc_data.next_req_state)) &&
+			push_app_data_to_host(inst)) {
+			return true;
+		}
+
+		receive_next_host_request(inst);
+		if (NEXT_REQUEST__READY != inst->hc_data.next_req_state) {
+			return false;
+		}
+
+		// The command is all in, serve it as if it had just been received.
+		inst->hc_data.next_req_state = NEXT_REQUEST__IDLE;
+		*current_state               = IFACE_SEND_RESPONSE_TAG;
+		return true;
+
+	default:
+		// A state of the command being executed, see host_cmd_table.
+		p_cmd = host_cmd_lookup(host_req->command_id);
+		if ((NULL != p_cmd) && (*current_state >= p_cmd->first_state) &&
+			(*current_state <= p_cmd->last_state)) {
+			return p_cmd->exec(inst, current_state, host_req, host_resp);
+		}
+
+		// ERROR - Invalid state, reset to wait for a new command.
+		*current_state = REQUEST_IFACE_TO_RECV_CMD_ID;
 		break;
 	}
 
 	return false;  // No commands processed in this stub.
 }
 
-bool service_host_requests(void)
+GARD__HOT bool service_host_requests(void)
 {
 	uint32_t idx;
 	bool     work_done = false;
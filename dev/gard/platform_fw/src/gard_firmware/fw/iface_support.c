@@ -12,6 +12,7 @@
 #include "host_cmds.h"
 #include "sys_platform.h"
 #include "iface_support.h"
+#include "irq_support.h"
 #include "fw_globals.h"
 
 enum rx_states {
@@ -22,8 +23,258 @@ enum rx_states {
 enum tx_states {
 	TX_CHECK_DATA_TO_SEND = 1,  // Check if data to send is available
 	TX_DATA_TO_INTERFACE,       // Send data over interface
+	TX_DATA_BY_ISR,             // Wait for the ISR to send the data
 };
 
+/**
+ * The sequence Host sends to resynchronize with GARD.
+ */
+static const uint8_t resync_sequence[GARD_HUB_RESYNC_SEQUENCE_SIZE] =
+	GARD_HUB_RESYNC_SEQUENCE;
+
+/**
+ * iface_match_resync looks for GARD_HUB_RESYNC_SEQUENCE among bytes received
+ * on an interface, carrying on from the bytes received before them. Once it
+ * is all in, resync_requested is set for host_cmds, see iface_resync().
+ *
+ * @param inst: Pointer to the interface instance.
+ * @param p_data: Pointer to the bytes received.
+ * @param count: Number of bytes received.
+ * @param p_end: Set to the number of bytes up to the end of the sequence.
+ *
+ * @return true if the sequence ends among the bytes, false otherwise.
+ */
+static bool iface_match_resync(struct iface_instance *inst,
+							   const uint8_t         *p_data,
+							   uint32_t               count,
+							   uint32_t              *p_end)
+{
+	uint32_t matched = inst->resync_matched;
+	uint32_t idx;
+
+	for (idx = 0; idx < count; idx++) {
+		// The first byte of the sequence is found nowhere else in it, a
+		// mismatch can only be the start of the sequence again.
+		if (p_data[idx] == resync_sequence[matched]) {
+			matched++;
+		} else {
+			matched = (p_data[idx] == resync_sequence[0]) ? 1U : 0U;
+		}
+
+		if (GARD_HUB_RESYNC_SEQUENCE_SIZE == matched) {
+			inst->resync_matched   = 0;
+			inst->resync_requested = true;
+			*p_end                 = idx + 1U;
+			return true;
+		}
+	}
+
+	inst->resync_matched = matched;
+
+	return false;
+}
+
+#ifndef NO_IFACE_RX_ISR
+/**
+ * iface_rx_mask masks or unmasks the RX interrupt of an interface. The UART
+ * only has its RX data ready interrupt masked, its IRQ being needed for TX as
+ * well; the caller is to have the interrupts of the CPU disabled.
+ *
+ * @param inst: Pointer to the interface instance.
+ * @param mask: true to mask the interrupt, false to unmask it.
+ *
+ * @return None
+ */
+static void iface_rx_mask(struct iface_instance *inst, bool mask)
+{
+	if (inst->bsp_data.iface_getchars == i2c_getchars) {
+		if (mask) {
+			irq_source_disable(inst->rx_irq);
+		} else {
+			irq_source_enable(inst->rx_irq);
+		}
+	} else {
+		uart_rx_int_enable(&inst->bsp_data.uart_inst, !mask);
+	}
+}
+
+#ifdef IFACE_TX_ISR
+/**
+ * iface_tx_isr refills the TX FIFO of a UART from the buffer handed over by
+ * tx_handler(), and stops the TX interrupt once the buffer is all out.
+ *
+ * @param inst: Pointer to the interface instance.
+ *
+ * @return None
+ */
+static void iface_tx_isr(struct iface_instance *inst)
+{
+	uint32_t count;
+
+	if (!inst->tx_by_isr) {
+		return;
+	}
+
+	count = uart_putchars(&inst->bsp_data.uart_inst, inst->p_tx_data_buffer,
+						  inst->bytes_to_send - inst->bytes_sent);
+	inst->p_tx_data_buffer += count;
+	inst->bytes_sent       += count;
+
+	if (inst->bytes_sent == inst->bytes_to_send) {
+		uart_tx_int_enable(&inst->bsp_data.uart_inst, false);
+		inst->tx_by_isr = false;
+	}
+}
+#endif
+
+/**
+ * iface_isr moves the bytes received on an interface from its FIFO into its
+ * rx_ring. When the ring is full the rest is left in the FIFO and the RX
+ * interrupt is masked until rx_handler() has made room. On a UART it also
+ * refills the TX FIFO, see iface_tx_isr().
+ *
+ * @param ctx: Pointer to the interface instance.
+ *
+ * @return None
+ */
+static void iface_isr(void *ctx)
+{
+	struct iface_instance *inst = (struct iface_instance *)ctx;
+	uint32_t               head = inst->rx_ring_head;
+	uint32_t               space, count, end;
+
+	// A status raised while draining brings the ISR back.
+	if (inst->bsp_data.iface_getchars == i2c_getchars) {
+		i2c_slave_clear_int(&inst->bsp_data.i2c_inst);
+	}
+#ifdef IFACE_TX_ISR
+	else {
+		iface_tx_isr(inst);
+	}
+#endif
+
+	if (inst->rx_ring_stalled) {
+		return;
+	}
+
+	while ((space = IFACE_RX_RING_SIZE - (head - inst->rx_ring_tail)) != 0U) {
+		// Up to the end of the ring in one go, the rest after the wrap.
+		if (space > IFACE_RX_RING_SIZE - (head % IFACE_RX_RING_SIZE)) {
+			space = IFACE_RX_RING_SIZE - (head % IFACE_RX_RING_SIZE);
+		}
+
+		count = inst->bsp_data.iface_getchars(
+			inst->bsp_data.iface_inst,
+			&inst->rx_ring[head % IFACE_RX_RING_SIZE], space);
+		if (0U == count) {
+			break;
+		}
+
+		// Looked for as the bytes come in rather than as they are read, as
+		// GARD may be only sending when Host resynchronizes.
+		if (iface_match_resync(inst, &inst->rx_ring[head % IFACE_RX_RING_SIZE],
+							   count, &end)) {
+			inst->rx_resync_head = head + end;
+		}
+		head += count;
+	}
+
+	inst->rx_ring_head = head;
+
+	if (0U == space) {
+		inst->rx_ring_stalled = true;
+		iface_rx_mask(inst, true);
+	}
+}
+
+/**
+ * iface_rx_irq_init sets up the ring and the RX interrupt of an interface.
+ *
+ * @param inst: Pointer to the interface instance.
+ *
+ * @return None
+ */
+static void iface_rx_irq_init(struct iface_instance *inst)
+{
+	inst->rx_ring_head    = 0U;
+	inst->rx_ring_tail    = 0U;
+	inst->rx_ring_stalled = false;
+
+	if (inst->bsp_data.iface_getchars == i2c_getchars) {
+		inst->rx_irq = I2C_SLAVE0_INST_IRQ;
+		i2c_slave_clear_int(&inst->bsp_data.i2c_inst);
+		i2c_slave_rx_int_enable(&inst->bsp_data.i2c_inst, true);
+	} else {
+		inst->rx_irq = UART0_INST_IRQ;
+		uart_rx_int_enable(&inst->bsp_data.uart_inst, true);
+	}
+
+#ifdef IFACE_TX_ISR
+	inst->tx_by_isr = false;
+#endif
+
+	GARD__DBG_ASSERT(irq_register_isr(inst->rx_irq, iface_isr, inst),
+					 "Failed to register ISR for IRQ %u", inst->rx_irq);
+}
+#endif
+
+/**
+ * iface_read_chars reads up to count bytes received on an interface, from its
+ * rx_ring or, with NO_IFACE_RX_ISR, straight from its FIFO.
+ *
+ * @param inst: Pointer to the interface instance.
+ * @param p_buffer: Pointer to the buffer where the bytes will be stored.
+ * @param count: Maximum number of bytes to read.
+ *
+ * @return Number of bytes read.
+ */
+static uint32_t iface_read_chars(struct iface_instance *inst,
+								 uint8_t               *p_buffer,
+								 uint32_t               count)
+{
+#ifdef NO_IFACE_RX_ISR
+	uint32_t end;
+
+	count = inst->bsp_data.iface_getchars(inst->bsp_data.iface_inst, p_buffer,
+										  count);
+
+	// The read is dropped by iface_resync(), and the bytes with it.
+	if (iface_match_resync(inst, p_buffer, count, &end)) {
+		return 0;
+	}
+
+	return count;
+#else
+	uint32_t tail = inst->rx_ring_tail;
+	uint32_t idx, irq_state;
+
+	// Nothing more is handed out once the ISR has found the resync sequence,
+	// the command being received is to be dropped.
+	if (inst->resync_requested) {
+		return 0;
+	}
+
+	if (count > inst->rx_ring_head - tail) {
+		count = inst->rx_ring_head - tail;
+	}
+
+	for (idx = 0; idx < count; idx++) {
+		p_buffer[idx] = inst->rx_ring[(tail + idx) % IFACE_RX_RING_SIZE];
+	}
+	inst->rx_ring_tail = tail + count;
+
+	// There is room again, let the ISR drain what was left in the FIFO.
+	if ((count > 0U) && inst->rx_ring_stalled) {
+		irq_state             = irq_save();
+		inst->rx_ring_stalled = false;
+		iface_rx_mask(inst, false);
+		irq_restore(irq_state);
+	}
+
+	return count;
+#endif
+}
+
 /**
  * iface_init initializes the interfaces (UART and I2C) used by the firmware.
  * It sets up the UART and I2C instances with the required parameters and
@@ -71,6 +322,14 @@ bool ifaces_init(void)
 		// to keep the changes to the driver minimal we do the assignments here.
 		inst->bsp_data.iface_getchars = i2c_getchars;
 		inst->bsp_data.iface_putchars = i2c_putchars;
+
+#ifdef GARD_I2C_CLK_STRETCH
+		/**
+		 * At 1 MHz the bytes come in and go out faster than the ISR and the
+		 * TX handler move them: the bus waits on the FIFOs instead.
+		 */
+		i2c_slave_clk_stretch(&inst->bsp_data.i2c_inst, true);
+#endif
 		inst++;
 	}
 
@@ -90,6 +349,13 @@ bool ifaces_init(void)
 		inst->bytes_sent           = 0U;
 		inst->p_tx_data_buffer     = NULL;
 
+		inst->resync_matched       = 0U;
+		inst->resync_requested     = false;
+#ifndef NO_IFACE_RX_ISR
+		inst->rx_resync_head       = 0U;
+		iface_rx_irq_init(inst);
+#endif
+
 		inst++;
 	}
 
@@ -190,8 +456,8 @@ bool rx_handler(struct iface_instance *inst)
 
 		// Read interface FIFO till the requested number of bytes are received.
 		while ((inst->bytes_read < inst->bytes_requested) &&
-			   (temp_count = inst->bsp_data.iface_getchars(
-					inst->bsp_data.iface_inst, inst->p_rx_data_buffer,
+			   (temp_count = iface_read_chars(
+					inst, inst->p_rx_data_buffer,
 					inst->bytes_requested - inst->bytes_read)) != 0) {
 			// Read as many bytes as available in the interface FIFO.
 			inst->p_rx_data_buffer += temp_count;
@@ -212,7 +478,11 @@ bool rx_handler(struct iface_instance *inst)
 			// but in interrupt mode we will return false so that
 			// the CPU can enter low-power mode if no activity is detected on
 			// interface.
+#ifdef NO_IFACE_RX_ISR
 			return true;
+#else
+			return false;
+#endif
 		}
 
 		return true;  // Data read successfully.
@@ -275,6 +545,9 @@ bool tx_handler(struct iface_instance *inst)
 {
 	uint32_t temp_count;
 	uint32_t bytes_sent_orig = inst->bytes_sent;
+#ifdef IFACE_TX_ISR
+	uint32_t irq_state;
+#endif
 
 	switch (inst->tx_handler_state) {
 	case TX_CHECK_DATA_TO_SEND:
@@ -282,6 +555,19 @@ bool tx_handler(struct iface_instance *inst)
 			break;  // No data to send, nothing to do.
 		}
 
+#ifdef IFACE_TX_ISR
+		// Hand the buffer over to the ISR, which is raised right away as the
+		// TX FIFO is empty when nothing is being sent.
+		if (inst->bsp_data.iface_putchars == uart_putchars) {
+			inst->tx_handler_state = TX_DATA_BY_ISR;
+			irq_state              = irq_save();
+			inst->tx_by_isr        = true;
+			uart_tx_int_enable(&inst->bsp_data.uart_inst, true);
+			irq_restore(irq_state);
+			return true;
+		}
+#endif
+
 		// Fall through to send data.
 
 	case TX_DATA_TO_INTERFACE:
@@ -311,6 +597,21 @@ bool tx_handler(struct iface_instance *inst)
 			return true;
 		}
 		break;
+
+#ifdef IFACE_TX_ISR
+	case TX_DATA_BY_ISR:
+		// The main loop may sleep meanwhile, each refill wakes it up.
+		if (inst->tx_by_isr) {
+			break;
+		}
+
+		set_tx_done(inst);
+
+		inst->bytes_to_send = inst->bytes_sent = 0U;
+		inst->p_tx_data_buffer                 = NULL;
+		inst->tx_handler_state                 = TX_CHECK_DATA_TO_SEND;
+		return true;
+#endif
 	}
 
 	return false;
@@ -340,6 +641,70 @@ bool execute_rx_handlers(void)
 	return work_done;
 }
 
+/**
+ * iface_resync drops the read and the send in progress on an interface once
+ * Host has sent GARD_HUB_RESYNC_SEQUENCE, along with the bytes received up to
+ * the end of the sequence, so that the next byte received is the first of a
+ * command. Bytes already in the TX FIFO still go out, Host skips them.
+ *
+ * @param inst: Pointer to the interface instance.
+ *
+ * @return None
+ */
+void iface_resync(struct iface_instance *inst)
+{
+	uint32_t irq_state;
+
+	irq_state = irq_save();
+#ifndef NO_IFACE_RX_ISR
+	inst->rx_ring_tail = inst->rx_resync_head;
+	if (inst->rx_ring_stalled) {
+		inst->rx_ring_stalled = false;
+		iface_rx_mask(inst, false);
+	}
+#endif
+#ifdef IFACE_TX_ISR
+	if (inst->tx_by_isr) {
+		uart_tx_int_enable(&inst->bsp_data.uart_inst, false);
+		inst->tx_by_isr = false;
+	}
+#endif
+	inst->resync_requested = false;
+	irq_restore(irq_state);
+
+	inst->bytes_read = inst->bytes_requested = 0U;
+	inst->p_rx_data_buffer                   = NULL;
+	inst->rx_handler_state                   = RX_CHECK_DATA_AVAILABLE;
+
+	inst->bytes_to_send = inst->bytes_sent = 0U;
+	inst->p_tx_data_buffer                 = NULL;
+	inst->tx_handler_state                 = TX_CHECK_DATA_TO_SEND;
+}
+
+/**
+ * iface_rx_pending returns true if bytes received on an interface wait for
+ * rx_handler(). With NO_IFACE_RX_ISR the FIFOs are not looked at and false is
+ * returned.
+ *
+ * @return true if received bytes are pending, false otherwise.
+ */
+bool iface_rx_pending(void)
+{
+#ifndef NO_IFACE_RX_ISR
+	struct iface_instance *inst;
+
+	inst = &iface_inst[0];
+	for (uint32_t idx = 0; idx < valid_ifaces; idx++) {
+		if (inst->is_active && (inst->rx_ring_head != inst->rx_ring_tail)) {
+			return true;
+		}
+		inst++;
+	}
+#endif
+
+	return false;
+}
+
 /**
  * execute_tx_handlers runs the TX handlers for all active interfaces.
  * It checks if there is data to send on each interface and processes it.
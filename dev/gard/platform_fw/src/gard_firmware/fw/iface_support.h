@@ -20,6 +20,26 @@
  */
 #define MAX_IFACES_SUPPORTED 2
 
+#ifndef NO_IFACE_RX_ISR
+/**
+ * Bytes received on an interface are moved out of its FIFO by an ISR into a
+ * ring of this many bytes (a power of 2), so that a command arriving while the
+ * main loop is busy, e.g. in app_ml_done(), is not lost in the few bytes deep
+ * FIFO. With NO_IFACE_RX_ISR the FIFOs are polled by the main loop instead.
+ */
+#define IFACE_RX_RING_SIZE 256U
+
+#ifndef NO_IFACE_TX_ISR
+/**
+ * The same ISR refills the TX FIFO of a UART from the buffer being sent each
+ * time it drains, so that the main loop can sleep while a response goes out
+ * instead of polling the FIFO. I2C is clocked by Host and stays polled. With
+ * NO_IFACE_TX_ISR the UART TX FIFO is polled by the main loop too.
+ */
+#define IFACE_TX_ISR
+#endif
+#endif
+
 /**
  * This structure iface_instance is used to hold all the variables related to
  * handling the communication with interface.
@@ -57,6 +77,42 @@ struct iface_instance {
 		struct _host_requests_unpked  host_req;
 		struct _host_responses_unpked host_resp;
 		struct _host_requests         iface_host_req;
+
+		// Tag of the command being served, sent back ahead of its response
+		// when is_tagged, see CMD_ID_TAGGED.
+		bool                               is_tagged;
+		struct _response_tag_header_unpked tag_hdr;
+
+		// State of the next command taken in, into iface_host_req, while the
+		// response of the current one is being sent.
+		uint32_t                           next_req_state;
+
+		// CC_SEGMENTED receive data command set aside, between two of its
+		// segments, while a tagged command taken in meanwhile is served, see
+		// park_bulk_host_request().
+		struct {
+			uint32_t state;  // State to resume it at, 0 if none
+			struct _recv_data_from_gard_at_offset_request_unpked  req;
+			struct _recv_data_from_gard_at_offset_response_unpked resp;
+		} bulk_lane;
+
+		// State of the App Module result being pushed to a subscribed Host,
+		// which happens only between two commands.
+		uint32_t                            push_state;
+		struct _app_data_push_header_unpked push_hdr;
+		uint32_t                            push_eod_marker;
+
+		// Progress of the App Module buffer being sent, a span at a time,
+		// be it pushed or read by Host.
+		struct {
+			uint32_t span_idx;    // Span being sent
+			uint32_t span_size;   // Bytes of it being sent, 0 if none
+			uint32_t bytes_done;  // Bytes of the spans before it
+		} app_tx;
+
+		// Sent to Host once the command being served has been dropped on
+		// GARD_HUB_RESYNC_SEQUENCE, see resync_host_requests().
+		struct _resync_ack_unpked           resync_ack;
 	} hc_data;
 
 	/**
@@ -75,10 +131,31 @@ struct iface_instance {
 		uint32_t bytes_requested;
 		uint8_t *p_rx_data_buffer;
 
-		uint32_t tx_handler_state;
-		uint32_t bytes_to_send;
-		uint32_t bytes_sent;
-		uint8_t *p_tx_data_buffer;
+		uint32_t          tx_handler_state;
+		uint32_t          bytes_to_send;
+		volatile uint32_t bytes_sent;  // Moved by the ISR with IFACE_TX_ISR
+		uint8_t          *p_tx_data_buffer;
+
+		// Bytes of GARD_HUB_RESYNC_SEQUENCE matched so far among the bytes
+		// received, and set once all of them are, see iface_resync().
+		uint32_t          resync_matched;
+		volatile bool     resync_requested;
+
+#ifndef NO_IFACE_RX_ISR
+		// Ring of received bytes. Only the ISR moves rx_ring_head and only
+		// rx_handler() moves rx_ring_tail; both run freely and wrap.
+		uint8_t           rx_ring[IFACE_RX_RING_SIZE];
+		volatile uint32_t rx_ring_head;
+		volatile uint32_t rx_ring_tail;
+		volatile bool     rx_ring_stalled;  // Full, rx_irq masked
+		uint32_t          rx_resync_head;   // Just past the resync sequence
+		uint32_t          rx_irq;
+#endif
+#ifdef IFACE_TX_ISR
+		// Set by tx_handler() to hand the buffer over to the ISR, cleared by
+		// the ISR once it is all in the TX FIFO.
+		volatile bool     tx_by_isr;
+#endif
 	};
 
 	/**
@@ -138,6 +215,17 @@ bool execute_tx_handlers(void);
  */
 bool ifaces_init(void);
 
+/**
+ * iface_resync drops what an interface is receiving and sending once Host
+ * has sent GARD_HUB_RESYNC_SEQUENCE, see resync_requested.
+ */
+void iface_resync(struct iface_instance *inst);
+
+/**
+ * iface_rx_pending returns true if received bytes wait for rx_handler().
+ */
+bool iface_rx_pending(void);
+
 /**
  * iface_get_count returns the number of interfaces available for use.
  */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "hw_regs.h"
+#include "irq_support.h"
+#include "utils.h"
+#include "image_stats.h"
+
+/**
+ * The statistics of the last IMAGE_STATS__HISTORY images captured, stats_next
+ * being the entry written next and images_recorded the count of images
+ * recorded since boot.
+ */
+static struct _image_stats_unpked image_stats[IMAGE_STATS__HISTORY];
+static uint32_t                   stats_next      = 0;
+static uint32_t                   images_recorded = 0;
+
+/**
+ * image_stats_record() records the ISP statistics of the image just captured,
+ * overwriting the oldest entry of the history.
+ *
+ * @param frame_seq is the sequence number of the captured image.
+ *
+ * @return None
+ */
+void image_stats_record(uint32_t frame_seq)
+{
+	struct _image_stats_unpked *p_stats = &image_stats[stats_next];
+
+	p_stats->frame_seq = frame_seq;
+	p_stats->gray_avg  = GARD__CAPTURE_IMAGE_STATS__IMG_AVG;
+	p_stats->gray_min  = GARD__CAPTURE_IMAGE_STATS__IMG_MIN;
+	p_stats->gray_max  = GARD__CAPTURE_IMAGE_STATS__IMG_MAX;
+	p_stats->rsvd1     = 0;
+
+	stats_next = (stats_next + 1U) % IMAGE_STATS__HISTORY;
+	images_recorded++;
+}
+
+/**
+ * get_image_stats_report() fills the GET_IMAGE_STATS response with the
+ * statistics of the last images captured, the newest first.
+ *
+ * @param p_resp is the response to fill, but for its data markers.
+ *
+ * @return None
+ */
+void get_image_stats_report(struct _get_image_stats_response_unpked *p_resp)
+{
+	uint32_t irq_state;
+	uint32_t idx;
+	uint32_t entry;
+
+	/* The capture done ISR records the statistics. */
+	irq_state = irq_save();
+
+	p_resp->images_recorded = images_recorded;
+	p_resp->num_stats       = MIN(images_recorded, IMAGE_STATS__HISTORY);
+
+	entry = stats_next;
+	for (idx = 0; idx < p_resp->num_stats; idx++) {
+		entry = (entry + IMAGE_STATS__HISTORY - 1U) % IMAGE_STATS__HISTORY;
+		p_resp->stats[idx] = image_stats[entry];
+	}
+
+	irq_restore(irq_state);
+}
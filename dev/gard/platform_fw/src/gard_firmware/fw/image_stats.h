@@ -0,0 +1,33 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef IMAGE_STATS_H
+#define IMAGE_STATS_H
+
+#include "gard_types.h"
+#include "gard_hub_iface_unpacked.h"
+
+/**
+ * This file defines the history of the ISP statistics of the captured images,
+ * read by Host with GET_IMAGE_STATS so that it can judge the scene without
+ * pulling the images.
+ */
+
+/**
+ * image_stats_record() records the ISP statistics of the image just captured.
+ * It is called by the capture done ISR, before the next capture overwrites
+ * them.
+ */
+void image_stats_record(uint32_t frame_seq);
+
+/**
+ * get_image_stats_report() fills the GET_IMAGE_STATS response with the
+ * statistics of the last images captured, leaving the markers to the caller.
+ */
+void get_image_stats_report(struct _get_image_stats_response_unpked *p_resp);
+
+#endif /* IMAGE_STATS_H */
@@ -0,0 +1,432 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "cpu.h"
+#include "utils.h"
+#include "fw_core.h"
+#include "fw_globals.h"
+#include "camera_capture.h"
+#include "i2c_master.h"
+#include "pipeline_stats.h"
+#include "sony_camera_configs.h"
+#include "sw_timer.h"
+#include "inference_rate.h"
+
+/* CPU cycles the rates are measured over, one second */
+#define RATE_WINDOW_CYCLES ((uint64_t)PIPELINE_STATS_CYCLES_PER_US * 1000000U)
+
+/**
+ * The policy in use, see set_inference_rate(). One image is run out of
+ * run_interval, frame_in_interval counting the images since the last one
+ * run. next_run_at is when the next image is due with
+ * INFERENCE_RATE__TARGET_FPS.
+ */
+static enum inference_rate_modes rate_mode = INFERENCE_RATE__ALL_FRAMES;
+static uint32_t                  rate_param        = 0;
+static uint32_t                  run_interval      = 1;
+static uint32_t                  frame_in_interval = 0;
+static uint64_t                  next_run_at       = 0;
+
+/**
+ * With INFERENCE_RATE__DUTY_CYCLE, the capture of the next image is held until
+ * wake_timer fires, the image sensor in standby and the main loop in WFI
+ * meanwhile. The timer fires wake_ticks ahead of next_wake_at, the time the
+ * sensor was measured to take from standby to a captured image, so that the
+ * image is captured when it is due. The times are in CLINT ticks, which keep
+ * counting in WFI.
+ */
+static struct sw_timer wake_timer;
+static bool            wake_timer_ready = false;
+static bool            capture_held     = false;
+static bool            camera_standby   = false;
+static bool            camera_waking    = false;
+static uint64_t        wake_started_at  = 0;
+static uint64_t        wake_ticks       = 0;
+static uint64_t        next_wake_at     = 0;
+
+/* Images offered to and run on the ML engine since boot. */
+static uint32_t frames_offered = 0;
+static uint32_t frames_run     = 0;
+
+/**
+ * The rates are measured over windows of RATE_WINDOW_CYCLES starting at
+ * window_start, when the ML engine had been busy for window_ml_cycles. The
+ * rates of the last complete window are kept in images per 1000 s.
+ */
+static uint64_t window_start     = 0;
+static uint64_t window_ml_cycles = 0;
+static uint32_t window_offered   = 0;
+static uint32_t window_run       = 0;
+static uint32_t offered_mfps     = 0;
+static uint32_t run_mfps         = 0;
+
+/**
+ * is_host_tx_behind() tells if the App Module buffers queued for the Host
+ * pile up, i.e. the Host link does not keep up with the results.
+ *
+ * @return true if half of the queue or more is in use, false otherwise.
+ */
+static bool is_host_tx_behind(void)
+{
+	return (app_tx_queue_count >= ((APP_TX_QUEUE_DEPTH + 1U) / 2U));
+}
+
+/**
+ * close_rate_window() computes the rates of the window ending now and starts
+ * the next one. With INFERENCE_RATE__ADAPTIVE, it also adapts run_interval:
+ * doubled when the ML engine was busy more than rate_param % of the window or
+ * the Host TX fell behind, decreased by one when both are well below.
+ *
+ * @param now is the CPU cycle counter.
+ *
+ * @return None
+ */
+static void close_rate_window(uint64_t now)
+{
+	uint64_t elapsed   = now - window_start;
+	uint64_t ml_cycles = pipeline_stats_total_cycles(PIPELINE_STATS__ML);
+	uint64_t busy_pct;
+
+	/* The ML engine time goes back to 0 with GET_PIPELINE_STATS reset. */
+	if (ml_cycles < window_ml_cycles) {
+		window_ml_cycles = ml_cycles;
+	}
+
+	offered_mfps =
+		(uint32_t)((window_offered * RATE_WINDOW_CYCLES * 1000U) / elapsed);
+	run_mfps = (uint32_t)((window_run * RATE_WINDOW_CYCLES * 1000U) / elapsed);
+
+	if (INFERENCE_RATE__ADAPTIVE == rate_mode) {
+		busy_pct = ((ml_cycles - window_ml_cycles) * 100U) / elapsed;
+
+		if ((busy_pct > rate_param) || is_host_tx_behind()) {
+			run_interval *= 2U;
+			if (run_interval > INFERENCE_RATE_MAX_RUN_INTERVAL) {
+				run_interval = INFERENCE_RATE_MAX_RUN_INTERVAL;
+			}
+		} else if ((busy_pct < (rate_param / 2U)) &&
+				   (0U == app_tx_queue_count) && (run_interval > 1U)) {
+			run_interval--;
+		}
+	}
+
+	window_start     = now;
+	window_ml_cycles = ml_cycles;
+	window_offered   = 0;
+	window_run       = 0;
+}
+
+/**
+ * ms_to_clint_ticks() converts milliseconds to CLINT ticks.
+ *
+ * @param ms is the time in milliseconds.
+ *
+ * @return The time in CLINT ticks.
+ */
+static uint64_t ms_to_clint_ticks(uint32_t ms)
+{
+	return ((uint64_t)CLINT_TIMEBASE_FREQ * ms) / 1000U;
+}
+
+/**
+ * clint_ticks_to_ms() converts CLINT ticks to milliseconds, rounded up so
+ * that a timer armed for them does not fire early.
+ *
+ * @param ticks is the time in CLINT ticks.
+ *
+ * @return The time in milliseconds.
+ */
+static uint32_t clint_ticks_to_ms(uint64_t ticks)
+{
+	return (uint32_t)(((ticks * 1000U) + CLINT_TIMEBASE_FREQ - 1U) /
+					  CLINT_TIMEBASE_FREQ);
+}
+
+/**
+ * wake_camera_for_capture() is the wake_timer callback: the image that was
+ * held is now due, its capture is started.
+ *
+ * @param ctx is unused.
+ *
+ * @return None
+ */
+static void wake_camera_for_capture(void *ctx)
+{
+	(void)ctx;
+
+	capture_held = false;
+	capture_image_async();
+}
+
+/**
+ * release_held_capture() starts the capture held by
+ * INFERENCE_RATE__DUTY_CYCLE, if any, once the policy has changed.
+ *
+ * @return None
+ */
+static void release_held_capture(void)
+{
+	if (!capture_held) {
+		return;
+	}
+
+	sw_timer_stop(&wake_timer);
+	capture_held = false;
+	capture_image_async();
+}
+
+/**
+ * set_inference_rate() sets the policy picking the captured images the ML
+ * engine is run on, see fw_core.h.
+ *
+ * @param mode is the policy.
+ * @param param is the parameter of the policy, see enum inference_rate_modes.
+ *
+ * @return true if the policy was set, false if mode or param is not valid.
+ */
+bool set_inference_rate(enum inference_rate_modes mode, uint32_t param)
+{
+	switch (mode) {
+	case INFERENCE_RATE__ALL_FRAMES:
+		run_interval = 1U;
+		break;
+
+	case INFERENCE_RATE__EVERY_NTH:
+		if (0U == param) {
+			return false;
+		}
+		run_interval = param;
+		break;
+
+	case INFERENCE_RATE__TARGET_FPS:
+		if (0U == param) {
+			return false;
+		}
+		run_interval = 1U;
+		break;
+
+	case INFERENCE_RATE__ADAPTIVE:
+		if ((0U == param) || (param > 100U)) {
+			return false;
+		}
+		run_interval = 1U;
+		break;
+
+	case INFERENCE_RATE__DUTY_CYCLE:
+		/* The camera cannot stop with the capture free-running. */
+		if ((0U == param) || is_continuous_capture_enabled()) {
+			return false;
+		}
+		run_interval = 1U;
+		if (!wake_timer_ready) {
+			sw_timer_init(&wake_timer, "duty_cycle_wake",
+						  wake_camera_for_capture, NULL);
+			wake_timer_ready = true;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	rate_mode         = mode;
+	rate_param        = param;
+	frame_in_interval = 0;
+	next_run_at       = pipeline_stats_now();
+	next_wake_at      = get_cpu_tsc();
+
+	/* A duty cycle capture held is now due, or due sooner. */
+	release_held_capture();
+
+	return true;
+}
+
+/**
+ * inference_rate_hold_capture() holds the capture of the next image with
+ * INFERENCE_RATE__DUTY_CYCLE until it is due. The image sensor is put in
+ * standby meanwhile and wake_timer armed to start the capture, early by the
+ * wake-up time of the sensor.
+ *
+ * @return true if the capture is held, false if it is to start now.
+ */
+bool inference_rate_hold_capture(void)
+{
+	uint64_t now;
+	uint64_t wake_at;
+
+	if (INFERENCE_RATE__DUTY_CYCLE != rate_mode) {
+		return false;
+	}
+
+	if (capture_held) {
+		return true;
+	}
+
+	now     = get_cpu_tsc();
+	wake_at = next_wake_at - wake_ticks;
+	if ((int64_t)(now - wake_at) >= 0) {
+		return false;
+	}
+
+	/* Retried by the next hold if the camera write queue is full. */
+	if (!camera_standby && set_image_sensor_standby(true)) {
+		camera_standby = true;
+	}
+
+	capture_held = true;
+	sw_timer_start(&wake_timer, clint_ticks_to_ms(wake_at - now), 0);
+
+	return true;
+}
+
+/**
+ * inference_rate_wake_camera() takes the image sensor out of the standby of
+ * INFERENCE_RATE__DUTY_CYCLE before a capture starts, and times its wake-up
+ * up to the end of the capture, see inference_rate_capture_done().
+ *
+ * @return None
+ */
+void inference_rate_wake_camera(void)
+{
+	if (!camera_standby) {
+		return;
+	}
+
+	if (!set_image_sensor_standby(false)) {
+		return;
+	}
+
+	camera_standby  = false;
+	camera_waking   = true;
+	wake_started_at = get_cpu_tsc();
+}
+
+/**
+ * inference_rate_capture_done() measures the wake-up time of the image sensor
+ * on the first capture done after the standby: it is kept as a running
+ * average, a quarter of each new measure, and schedules the next image due
+ * with INFERENCE_RATE__DUTY_CYCLE.
+ *
+ * @return None
+ */
+void inference_rate_capture_done(void)
+{
+	uint64_t now;
+	uint64_t measured;
+
+	if (INFERENCE_RATE__DUTY_CYCLE != rate_mode) {
+		camera_waking = false;
+		return;
+	}
+
+	now = get_cpu_tsc();
+	if (camera_waking) {
+		camera_waking = false;
+		measured      = now - wake_started_at;
+		if (0U == wake_ticks) {
+			wake_ticks = measured;
+		} else {
+			wake_ticks = wake_ticks - (wake_ticks / 4U) + (measured / 4U);
+		}
+	}
+
+	/* Time lost is not made up for, as with INFERENCE_RATE__TARGET_FPS. */
+	next_wake_at += ms_to_clint_ticks(rate_param);
+	if ((int64_t)(now - next_wake_at) >= 0) {
+		next_wake_at = now + ms_to_clint_ticks(rate_param);
+	}
+}
+
+/**
+ * inference_rate_admit() decides if the ML engine is to be run on the image
+ * now ready for it, and accounts the image in the rates.
+ *
+ * @return true if the ML engine is to be run on the image, false if it is to
+ *         be dropped.
+ */
+bool inference_rate_admit(void)
+{
+	uint64_t now = pipeline_stats_now();
+	uint64_t period;
+	bool     run;
+
+	if ((now - window_start) >= RATE_WINDOW_CYCLES) {
+		close_rate_window(now);
+	}
+
+	switch (rate_mode) {
+	case INFERENCE_RATE__TARGET_FPS:
+		/**
+		 * The images are run period apart on average. Time lost while no
+		 * image was ready is not made up for with a burst.
+		 */
+		period = (RATE_WINDOW_CYCLES * 1000U) / rate_param;
+		run    = ((int64_t)(now - next_run_at) >= 0);
+		if (run) {
+			next_run_at += period;
+			if ((int64_t)(now - next_run_at) >= 0) {
+				next_run_at = now + period;
+			}
+		}
+		break;
+
+	case INFERENCE_RATE__ADAPTIVE:
+		/* Results that cannot be sent are not worth computing. */
+		if (app_tx_queue_count >= APP_TX_QUEUE_DEPTH) {
+			run = false;
+			break;
+		}
+
+		// Fall through to run one image out of run_interval.
+
+	case INFERENCE_RATE__EVERY_NTH:
+		run = (0U == frame_in_interval);
+		if (++frame_in_interval >= run_interval) {
+			frame_in_interval = 0;
+		}
+		break;
+
+	case INFERENCE_RATE__DUTY_CYCLE:
+		// The images are captured when due, see inference_rate_hold_capture().
+
+	case INFERENCE_RATE__ALL_FRAMES:
+	default:
+		run = true;
+		break;
+	}
+
+	frames_offered++;
+	window_offered++;
+	if (run) {
+		frames_run++;
+		window_run++;
+	}
+
+	return run;
+}
+
+/**
+ * get_inference_rate_report() fills the policy in use and the rates it gives
+ * in the INFERENCE_RATE response.
+ *
+ * @param p_resp is the response to fill, but for its markers and ack_or_nak.
+ *
+ * @return None
+ */
+void get_inference_rate_report(struct _inference_rate_response_unpked *p_resp)
+{
+	p_resp->mode           = (uint8_t)rate_mode;
+	p_resp->param          = rate_param;
+	p_resp->frames_offered = frames_offered;
+	p_resp->frames_run     = frames_run;
+	p_resp->offered_mfps   = offered_mfps;
+	p_resp->run_mfps       = run_mfps;
+	p_resp->run_interval   = run_interval;
+	p_resp->wake_us        = (uint32_t)((wake_ticks * 1000000U) /
+										CLINT_TIMEBASE_FREQ);
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef INFERENCE_RATE_H
+#define INFERENCE_RATE_H
+
+#include "gard_types.h"
+#include "gard_hub_iface_unpacked.h"
+
+/**
+ * This file defines the policy picking the captured images the ML engine is
+ * run on, see set_inference_rate().
+ */
+
+/* Most images one is run out of with INFERENCE_RATE__ADAPTIVE */
+#define INFERENCE_RATE_MAX_RUN_INTERVAL (16U)
+
+/**
+ * inference_rate_admit() is called by the main loop with each image ready for
+ * the ML engine. It returns true if the ML engine is to be run on it, false
+ * if it is to be dropped.
+ */
+bool inference_rate_admit(void);
+
+/**
+ * inference_rate_hold_capture() is called by capture_image_async(). It returns
+ * true if the capture is to wait for the next image due with
+ * INFERENCE_RATE__DUTY_CYCLE, the camera in standby meanwhile; the capture is
+ * then started again once due.
+ */
+bool inference_rate_hold_capture(void);
+
+/**
+ * inference_rate_wake_camera() is called before a capture starts, to take the
+ * camera out of the standby of INFERENCE_RATE__DUTY_CYCLE if in it.
+ */
+void inference_rate_wake_camera(void);
+
+/**
+ * inference_rate_capture_done() is called once an image is captured, to time
+ * the wake-up of the camera and schedule INFERENCE_RATE__DUTY_CYCLE.
+ */
+void inference_rate_capture_done(void);
+
+/**
+ * get_inference_rate_report() fills the policy in use and the rates it gives
+ * in the INFERENCE_RATE response, leaving the markers to the caller.
+ */
+void get_inference_rate_report(struct _inference_rate_response_unpked *p_resp);
+
+#endif /* INFERENCE_RATE_H */
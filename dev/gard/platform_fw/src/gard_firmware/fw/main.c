@@ -10,8 +10,10 @@
 #include "sys_platform.h"
 #include "uart.h"
 #include "ospi_support.h"
+#include "rfs.h"
 #include "host_cmds.h"
 #include "iface_support.h"
+#include "irq_support.h"
 #include "app_module.h"
 #include "fw_core.h"
 #include "camera_config.h"
@@ -22,6 +24,59 @@
 #include "gpio.h"
 #include "gpio_support.h"
 #include "pipeline_ops.h"
+#include "task_sched.h"
+#include "sw_timer.h"
+#include "pipeline_stats.h"
+#include "trace_pins.h"
+#include "roi_batch.h"
+#include "inference_rate.h"
+#include "fw_upgrade.h"
+#include "network_swap.h"
+#include "fw_boot.h"
+#include "synthetic_bench.h"
+
+/**
+ * The main loop may only sleep when idle if nothing is left that it has to
+ * poll, i.e. if all the events it waits for come in by interrupt: the Host
+ * interfaces, the GPIOs and the capture / rescale / ML done interrupts
+ * through the PLIC, and the CLINT timer for the software timers.
+ */
+#if !defined(NO_IFACE_RX_ISR) && !defined(NO_CAPTURE_DONE_ISR) &&              \
+	!defined(NO_ML_DONE_ISR) && !defined(NO_RESCALE_DONE_ISR) &&               \
+	!defined(NO_BUFF_MOVE_DONE_ISR)
+#define IDLE_IN_LOW_POWER_MODE
+#endif
+
+#if defined(TEST_AUTO_EXPOSURE)
+static struct sw_timer test_auto_exposure_timer;
+
+/**
+ * test_auto_exposure_toggle() flips the auto exposure target between its two
+ * extremes, every 10 s.
+ *
+ * @param ctx: Unused.
+ *
+ * @return None
+ */
+static void test_auto_exposure_toggle(void *ctx)
+{
+	/**
+	 * When testing auto exposure, we can turn OFF the auto exposure toggling
+	 * by setting this flag to false.
+	 */
+	static bool     toggle_auto_exposure = true;
+	static uint32_t gray_target          = 250;
+
+	if (toggle_auto_exposure && auto_exposure_enabled) {
+		set_target_gray_average(gray_target);
+		if (gray_target == 1) {
+			gray_target = 250;
+		} else {
+			gray_target = 1;
+		}
+	}
+}
+#endif
 
 /**
  * fw_core_init() initializes the Gard Firmware (GARD FW) environment. This is
@@ -47,12 +102,24 @@ bool fw_core_init()
 	sd = ospi_init();
 	GARD__DBG_ASSERT(sd != NULL, "OSPI initialization failed");
 
+	/* Use the RFS of the slot the loader booted, see fw_boot.h. */
+	rfs_set_config_addr(FW_BOOT_SLOT_RFS_ADDR(fw_boot_running_slot(sd)));
+
+	/* Cache the RFS directory, lookups search the flash if this fails. */
+	(void)rfs_mount(sd);
+
 	/* Initialize all the GPIOs used by the firmware. */
 	gpio_init();
 
 	/* Reset ml_engine_work_done as ML engine has not even started. */
 	ml_engine_work_done = false;
 
+	/* Take interrupts before the interfaces and engines register ISRs. */
+	irq_support_init();
+
+	/* Hook the done IRQs of the capture / rescale / ML engines. */
+	pipeline_irqs_init();
+
 	/* Initialize the slow serial interfaces. */
 	ifaces_init();
 
@@ -77,15 +144,445 @@ bool fw_core_init()
 #ifdef TEST_AUTO_EXPOSURE
 	set_target_gray_average(250);
 
-	set_timer_for_time(10000);
+	sw_timer_init(&test_auto_exposure_timer, "test_auto_exposure",
+				  test_auto_exposure_toggle, NULL);
+	sw_timer_start(&test_auto_exposure_timer, 10000, 10000);
 #endif
 
 	return true;
 }
 
 #if defined(TEST_APP_MOD_DATA_XFER_TRIGGER)
-uint8_t  temp_buf[100]                        = "Sending data to Host\n";
-uint32_t count_of_gpio_interrupts_to_dispatch = 10;
+uint8_t         temp_buf[100]                        = "Sending data to Host\n";
+uint32_t        count_of_gpio_interrupts_to_dispatch = 10;
+struct sw_timer test_data_xfer_timer;
+#endif
+
+/**
+ * The tasks run by the main loop, see task_register() calls in main().
+ */
+static struct task pipeline_stages_task;
+static struct task host_requests_task;
+static struct task rx_handlers_task;
+static struct task tx_handlers_task;
+static struct task ml_done_task;
+static struct task image_processing_done_task;
+static struct task network_prefetch_task;
+static struct task camera_writes_task;
+static struct task fw_upgrade_task;
+static struct task network_swap_task;
+static struct task sw_timers_task;
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+static struct task synthetic_bench_task;
+#endif
+
+/**
+ * ml_done_in_progress is set while app_ml_done() is being called on the
+ * results of an ML run, see run_ml_done().
+ */
+static bool ml_done_in_progress = false;
+
+#ifdef ML_APP_MOD
+/**
+ * ml_start_deferred is set when a rescaled image waits for app_preprocess()
+ * to be called, which starts the ML engine on it. This waits for the results
+ * of the previous ML run to be processed, as they share the ML engine
+ * buffers with the next run.
+ */
+static bool ml_start_deferred = false;
+#endif
+
+#if defined(ML_APP_MOD) || defined(NO_BUFF_MOVE_DONE_ISR)
+/**
+ * run_or_drop_image() calls app_preprocess() on the image now in the ML engine
+ * input, which starts the ML engine on it, or drops it as picked by the
+ * inference rate policy, see set_inference_rate(). The capture of the next
+ * image then starts right away, nothing waiting for the ML results.
+ *
+ * @param app_ctxt_handle is the App Module context.
+ *
+ * @return None
+ */
+static void run_or_drop_image(app_handle_t app_ctxt_handle)
+{
+	if (inference_rate_admit()) {
+		(app_module_callbacks.app_preprocess_cb)(app_ctxt_handle, NULL);
+	} else {
+		capture_image_async();
+	}
+}
+#endif
+
+/**
+ * run_pipeline_stages() handles the completion of the pipeline stages, as
+ * posted by their done IRQ or, with the NO_*_DONE_ISR workarounds, as polled
+ * from the engines. This keeps the next capture / ML run starting as early as
+ * possible.
+ *
+ * @param ctx: App Module context.
+ *
+ * @return true if any stage completed, false otherwise.
+ */
+static bool run_pipeline_stages(void *ctx)
+{
+	app_handle_t app_ctxt_handle = (app_handle_t)ctx;
+	bool         did_work        = false;
+
+	/**
+	 * TBD-SRP: The NO_*_DONE_ISR polling is a temporary workaround for the
+	 * bitstreams that do not route the done IRQs, to be removed with them.
+	 */
+#ifdef NO_ML_DONE_ISR
+	if (ml_engine_started && GARD__IS_ML_ENGINE_DONE()) {
+#else
+	if (pipeline_event_take(PIPELINE_EVENT_ML_DONE)) {
+#endif
+		ml_engine_started = false;
+		TRACE_END(ML_RUN);
+		ml_engine_done_isr(NULL);
+#ifndef NO_ML_DONE_ISR
+		pipeline_event_rearm(PIPELINE_EVENT_ML_DONE);
+#endif
+		did_work = true;
+	}
+
+	/**
+	 * The rescale of a captured image waits for the ML engine to be done with
+	 * the previous one, as it writes to the ML engine input, and for the
+	 * results being streamed from the ML engine buffers to be sent, see
+	 * stream_spans_to_host_async(). With the continuous capture the image
+	 * waits in the frame ring instead.
+	 */
+	if (capture_started &&
+		(is_continuous_capture_enabled() ||
+		 ((false == ml_engine_started) && (0U == app_tx_ml_output_holds)))
+#ifdef ML_APP_MOD
+		&& (is_continuous_capture_enabled() || !ml_start_deferred)
+#endif
+#if !defined(NO_CAPTURE_DONE_ISR)
+		&& pipeline_event_take(PIPELINE_EVENT_CAPTURE_DONE)
+#elif defined(ML_APP_MOD)
+		&& GARD__IS_CAPTURE_STAGE_DONE()
+#endif
+	) {
+		capture_started = false;
+		TRACE_END(CAPTURE);
+		capture_done_isr(NULL);
+#ifndef NO_CAPTURE_DONE_ISR
+		pipeline_event_rearm(PIPELINE_EVENT_CAPTURE_DONE);
+#endif
+		did_work = true;
+	}
+
+	if (rescaling_started &&
+#ifndef NO_RESCALE_DONE_ISR
+		pipeline_event_take(PIPELINE_EVENT_RESCALE_DONE)) {
+#elif defined(ML_APP_HMI)
+		GARD__IS_SCALER_ENGINE_DONE()) {
+#elif defined(ML_APP_MOD)
+		GARD__IS_RESCALE_STAGE_DONE()) {
+#endif
+		rescaling_started = false;
+#ifdef ML_APP_HMI
+		/* The scaler engine captured the image too. */
+		TRACE_END(CAPTURE);
+#endif
+		TRACE_END(RESCALE);
+#ifdef ML_APP_MOD
+		if (is_roi_batch_active()) {
+			/* An ROI of the batch, see run_network_on_rois_async(). */
+			roi_batch_rescale_done();
+		} else {
+			rescaling_done_isr(NULL);
+
+			if (PIPELINE_PAUSED != ml_pipeline_state) {
+				ml_start_deferred = true;
+
+				/* The capture buffer is free again, see set_capture_ahead(). */
+				if (is_capture_ahead_enabled()) {
+					capture_image_async();
+				}
+			}
+		}
+#else
+		rescaling_done_isr(NULL);
+#endif
+#ifndef NO_RESCALE_DONE_ISR
+		pipeline_event_rearm(PIPELINE_EVENT_RESCALE_DONE);
+#endif
+		did_work = true;
+	}
+
+#ifdef ML_APP_MOD
+	/* Keep the scaler free-running, see set_continuous_capture(). */
+	if (continue_continuous_capture(!ml_engine_started && !ml_start_deferred &&
+									(0U == app_tx_ml_output_holds))) {
+		did_work = true;
+	}
+
+	/* Run the images sent by Host, see submit_host_input(). */
+	if (continue_host_input(!ml_engine_started && !ml_start_deferred &&
+							(0U == app_tx_ml_output_holds))) {
+		did_work = true;
+	}
+
+	/* Copy the rescaled image out for Host before the ML engine runs on it. */
+	if (continue_snapshot_copy()) {
+		did_work = true;
+	}
+
+	if (ml_start_deferred && !ml_engine_started && !ml_engine_work_done &&
+		!ml_done_in_progress && !is_roi_batch_active() &&
+		!is_snapshot_copy_in_progress() && (0U == app_tx_ml_output_holds)) {
+		ml_start_deferred = false;
+		if ((NULL != app_module_callbacks.app_preprocess_cb) &&
+			(PIPELINE_PAUSED != ml_pipeline_state)) {
+			run_or_drop_image(app_ctxt_handle);
+		}
+		did_work = true;
+	}
+#endif
+
+#ifdef NO_BUFF_MOVE_DONE_ISR
+	/**
+	 * This is a temporary workaround to continue the normal Rescaling done
+	 * processing in the absence of RESCALE_DONE_ISR.
+	 *
+	 * TBD-SRP: Should be removed once the RESCALE_DONE_ISR ISR is
+	 * implemented.
+	 */
+	if (buffer_move_to_ml_started &&
+		GARD__IS_ML_ENGINE_READ_SCALER_DATA_DONE()) {
+		buffer_move_to_ml_started = false;
+		TRACE_END(ML_COPY);
+
+		if ((NULL != app_module_callbacks.app_preprocess_cb) &&
+			(PIPELINE_PAUSED != ml_pipeline_state)) {
+			run_or_drop_image(app_ctxt_handle);
+		}
+		did_work = true;
+	}
+#endif
+
+	(void)app_ctxt_handle;
+
+	return did_work;
+}
+
+/**
+ * run_host_requests() services the Host Commands arriving over the various
+ * interfaces.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if a request was serviced, false otherwise.
+ */
+static bool run_host_requests(void *ctx)
+{
+	return service_host_requests();
+}
+
+/**
+ * run_rx_handlers() / run_tx_handlers() service the handlers of the
+ * interfaces.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if any handler made progress, false otherwise.
+ */
+static bool run_rx_handlers(void *ctx)
+{
+	return execute_rx_handlers();
+}
+
+static bool run_tx_handlers(void *ctx)
+{
+	return execute_tx_handlers();
+}
+
+/**
+ * run_ml_done() hands the results of a completed ML run to app_ml_done().
+ * If the App Module returns APP_CODE__CONTINUE, its post-processing is resumed
+ * on the next slice with the same results, letting the higher priority tasks
+ * run in between.
+ *
+ * @param ctx: App Module context.
+ *
+ * @return true if app_ml_done() was called, false otherwise.
+ */
+static bool run_ml_done(void *ctx)
+{
+	static void         *p_ml_results;
+	static uint64_t      busy_cycles;
+	uint64_t             start;
+	struct network_info *p_network;
+	enum app_ret_code    ret = APP_CODE__SUCCESS;
+
+	if (!ml_done_in_progress) {
+		/* Runs of queued networks are handed over in their order. */
+		p_network = take_completed_network_run();
+		if (NULL == p_network) {
+			return false;
+		}
+
+		/* The runs of an ROI batch are handed over together. */
+		if (roi_batch_ml_done((app_handle_t)ctx, p_network)) {
+			return true;
+		}
+
+		ml_done_in_progress = true;
+		busy_cycles         = 0;
+		p_ml_results        = (void *)p_network->inout_offset;
+	}
+
+	/* ML engine has completed processing the image, call the app_ml_done()
+	 * function to allow App Module to process the results.
+	 */
+	start = pipeline_stats_now();
+	if (NULL != app_module_callbacks.app_ml_done_cb) {
+		ret = (app_module_callbacks.app_ml_done_cb)((app_handle_t)ctx,
+													p_ml_results);
+	}
+	busy_cycles += pipeline_stats_now() - start;
+
+	if (APP_CODE__CONTINUE != ret) {
+		ml_done_in_progress = false;
+
+		/* Post-processing is timed over its slices only. */
+		pipeline_stats_add(PIPELINE_STATS__POST_PROCESSING, busy_cycles);
+
+		/* Frames run through to the end confirm a freshly upgraded FW. */
+		if (APP_CODE__SUCCESS == ret) {
+			fw_upgrade_frame_done();
+		}
+
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+		synthetic_bench_frame_done();
+#endif
+
+		/* Process pipeline pause request at post processing boundary */
+		pipeline_stage_completed(PIPELINE_STAGE_ML_POST_PROCESSING_DONE);
+	}
+
+	return true;
+}
+
+/**
+ * run_image_processing_done() calls app_image_processing_done() when the App
+ * Module asked for it.
+ *
+ * @param ctx: App Module context.
+ *
+ * @return true if app_image_processing_done() was due, false otherwise.
+ */
+static bool run_image_processing_done(void *ctx)
+{
+	if (!call_app_image_processing_done) {
+		return false;
+	}
+
+	if (NULL != app_module_callbacks.app_image_processing_done_cb) {
+		(app_module_callbacks.app_image_processing_done_cb)((app_handle_t)ctx);
+	}
+	call_app_image_processing_done = false;
+
+	return true;
+}
+
+/**
+ * run_network_prefetch() loads the ML network to be run next from flash in
+ * the background, one slice at a time.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if a slice was loaded, false otherwise.
+ */
+static bool run_network_prefetch(void *ctx)
+{
+	return continue_network_prefetch();
+}
+
+/**
+ * run_camera_writes() sends the image sensor writes queued by the auto exposure
+ * without waiting on the I2C bus.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if a write was submitted or retired, false otherwise.
+ */
+static bool run_camera_writes(void *ctx)
+{
+	return continue_camera_writes();
+}
+
+/**
+ * run_fw_upgrade() programs the firmware image chunks queued by Host with
+ * UPGRADE_FIRMWARE, one erase, page or CRC slice at a time.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if a chunk is being programmed, false otherwise.
+ */
+static bool run_fw_upgrade(void *ctx)
+{
+	return continue_fw_upgrade();
+}
+
+/**
+ * run_network_swap() checks, switches to and persists the network staged by
+ * Host with SWAP_NETWORK, one CRC, erase or page slice at a time.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if the swap did some work, false otherwise.
+ */
+static bool run_network_swap(void *ctx)
+{
+	return continue_network_swap();
+}
+
+/**
+ * run_sw_timers() calls the callbacks of the software timers due.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if a timer fired, false otherwise.
+ */
+static bool run_sw_timers(void *ctx)
+{
+	return sw_timers_run();
+}
+
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+/**
+ * run_synthetic_bench() takes the synthetic benchmark through its steps.
+ *
+ * @param ctx: Unused.
+ *
+ * @return true if the benchmark made progress, false otherwise.
+ */
+static bool run_synthetic_bench(void *ctx)
+{
+	return continue_synthetic_bench();
+}
+#endif
+
+#if defined(TEST_APP_MOD_DATA_XFER_TRIGGER)
+/**
+ * test_data_xfer_send() sends dummy App Module data to Host, every 5 s once
+ * started after GARD_DISCOVERY, count_of_gpio_interrupts_to_dispatch times.
+ *
+ * @param ctx: Unused.
+ *
+ * @return None
+ */
+static void test_data_xfer_send(void *ctx)
+{
+	stream_data_to_host_async(temp_buf, sizeof(temp_buf), 100, NULL);
+	if (--count_of_gpio_interrupts_to_dispatch == 0) {
+		sw_timer_stop(&test_data_xfer_timer);
+	}
+}
 #endif
 
 /**
@@ -102,15 +599,10 @@ uint32_t count_of_gpio_interrupts_to_dispatch = 10;
  */
 int main(void)
 {
-	bool         no_work         = false;
 	app_handle_t app_ctxt_handle = NULL;
-#ifdef TEST_AUTO_EXPOSURE
-	/**
-	 * When testing auto exposure, we can turn OFF the auto exposure toggling
-	 * by setting this flag to false.
-	 */
-	bool     toggle_auto_exposure = auto_exposure_enabled;
-	uint32_t gray_target          = 250;
+#ifdef IDLE_IN_LOW_POWER_MODE
+	uint32_t irq_state;
+	uint32_t irq_events;
 #endif
 
 	/**
@@ -134,163 +626,72 @@ int main(void)
 	GARD__DBG_ASSERT(NULL != app_ctxt_handle,
 					 "App Module Initialization Failed.");
 
-	while (true) {
-		/* Service Host Commands arriving over various interfaces */
-		if (service_host_requests()) {
-			no_work = false;
-		}
-
-		/* Service handlers for interfaces. */
-		if (execute_rx_handlers()) {
-			no_work = false;
-		}
-
-		if (execute_tx_handlers()) {
-			no_work = false;
-		}
-
-		if (ml_engine_work_done) {
-			ml_engine_work_done = false;
-
-			/* ML engine has completed processing the image, call the
-			 * app_ml_done() function to allow App Module to process the
-			 * results.
-			 */
-			if (NULL != app_module_callbacks.app_ml_done_cb) {
-				(app_module_callbacks.app_ml_done_cb)(
-					app_ctxt_handle,
-					(void *)get_info_of_last_executed_network()->inout_offset);
-			}
-			/* Process pipeline pause request at post processing boundary */
-			pipeline_stage_completed(PIPELINE_STAGE_ML_POST_PROCESSING_DONE);
-			no_work = false;
-		}
-
-		if (call_app_image_processing_done) {
-			if (NULL != app_module_callbacks.app_image_processing_done_cb) {
-				(app_module_callbacks.app_image_processing_done_cb)(
-					app_ctxt_handle);
-			}
-			call_app_image_processing_done = false;
-			no_work                        = false;
-		}
-
-#ifdef NO_ML_DONE_ISR
-		/**
-		 * This is a temporary workaround to continue the normal ML Done
-		 * processing in the absence of ML_DONE ISR.
-		 *
-		 * TBD-SRP: Should be removed once the ML_DONE ISR is implemented.
-		 */
-		if (ml_engine_started && GARD__IS_ML_ENGINE_DONE()) {
-			ml_engine_started = false;
-			gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_LOW);
-			ml_engine_done_isr(NULL);
-		}
-#endif
-
-#ifdef NO_CAPTURE_DONE_ISR
-		/**
-		 * This is a temporary workaround to continue the normal capture done
-		 * processing in the absence of CAPTURE_DONE_ISR.
-		 *
-		 * TBD-SRP: Should be removed once the CAPTURE_DONE_ISR ISR is
-		 * implemented.
-		 */
-		if (capture_started && (false == ml_engine_started)
-#if defined(ML_APP_MOD)
-			&& GARD__IS_CAPTURE_STAGE_DONE()
-#endif
-		) {
-			capture_started = false;
-			gpio_pin_write(&gpio_0, GPIO_PIN_1, GPIO_OUTPUT_LOW);
-			gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_LOW);
-			capture_done_isr(NULL);
-		}
-#endif
-
-#ifdef NO_RESCALE_DONE_ISR
-		/**
-		 * This is a temporary workaround to continue the normal Rescaling done
-		 * processing in the absence of RESCALE_DONE_ISR.
-		 *
-		 * TBD-SRP: Should be removed once the RESCALE_DONE_ISR ISR is
-		 * implemented.
-		 */
-		if (rescaling_started &&
-#ifdef ML_APP_HMI
-			GARD__IS_SCALER_ENGINE_DONE()) {
-#elif defined(ML_APP_MOD)
-			GARD__IS_RESCALE_STAGE_DONE()) {
-#endif
-			rescaling_started = false;
-			gpio_pin_write(&gpio_0, GPIO_PIN_1, GPIO_OUTPUT_LOW);
-			gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_LOW);
-			rescaling_done_isr(NULL);
-
-#ifdef ML_APP_MOD
-			if ((NULL != app_module_callbacks.app_preprocess_cb) &&
-				(PIPELINE_PAUSED != ml_pipeline_state)) {
-				(app_module_callbacks.app_preprocess_cb)(app_ctxt_handle, NULL);
-			}
-#endif
-		}
+	/**
+	 * Pipeline stage completions come first so that the next capture / ML run
+	 * is started before any Host or App Module work is done.
+	 */
+	task_register(&pipeline_stages_task, "pipeline_stages", run_pipeline_stages,
+				  app_ctxt_handle, TASK_PRIO_PIPELINE);
+	task_register(&host_requests_task, "host_requests", run_host_requests, NULL,
+				  TASK_PRIO_HOST);
+	task_register(&rx_handlers_task, "rx_handlers", run_rx_handlers, NULL,
+				  TASK_PRIO_HOST);
+	task_register(&sw_timers_task, "sw_timers", run_sw_timers, NULL,
+				  TASK_PRIO_HOST);
+	task_register(&tx_handlers_task, "tx_handlers", run_tx_handlers, NULL,
+				  TASK_PRIO_HOST);
+	task_register(&ml_done_task, "ml_done", run_ml_done, app_ctxt_handle,
+				  TASK_PRIO_APP);
+	task_register(&image_processing_done_task, "image_processing_done",
+				  run_image_processing_done, app_ctxt_handle, TASK_PRIO_APP);
+	task_register(&camera_writes_task, "camera_writes", run_camera_writes, NULL,
+				  TASK_PRIO_APP);
+	task_register(&network_prefetch_task, "network_prefetch",
+				  run_network_prefetch, NULL, TASK_PRIO_APP);
+	task_register(&fw_upgrade_task, "fw_upgrade", run_fw_upgrade, NULL,
+				  TASK_PRIO_APP);
+	task_register(&network_swap_task, "network_swap", run_network_swap, NULL,
+				  TASK_PRIO_APP);
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+	task_register(&synthetic_bench_task, "synthetic_bench",
+				  run_synthetic_bench, NULL, TASK_PRIO_APP);
 #endif
-
-#ifdef NO_BUFF_MOVE_DONE_ISR
-		/**
-		 * This is a temporary workaround to continue the normal Rescaling done
-		 * processing in the absence of RESCALE_DONE_ISR.
-		 *
-		 * TBD-SRP: Should be removed once the RESCALE_DONE_ISR ISR is
-		 * implemented.
-		 */
-		if (buffer_move_to_ml_started &&
-			GARD__IS_ML_ENGINE_READ_SCALER_DATA_DONE()) {
-			buffer_move_to_ml_started = false;
-			gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_LOW);
-
-			if ((NULL != app_module_callbacks.app_preprocess_cb) &&
-				(PIPELINE_PAUSED != ml_pipeline_state)) {
-				(app_module_callbacks.app_preprocess_cb)(app_ctxt_handle, NULL);
-			}
-		}
+#if defined(TEST_APP_MOD_DATA_XFER_TRIGGER)
+	sw_timer_init(&test_data_xfer_timer, "test_data_xfer", test_data_xfer_send,
+				  NULL);
 #endif
 
-#if defined(TEST_AUTO_EXPOSURE)
-		if (has_timer_expired() && toggle_auto_exposure) {
-			set_target_gray_average(gray_target);
-			if (gray_target == 1) {
-				gray_target = 250;
-			} else {
-				gray_target = 1;
-			}
-
-			set_timer_for_time(10000);
-		}
+	/**
+	 * TBD-SRP: The current implementation of GARD does not support moving
+	 * the captured image to HRAM buffer and hence we do not call
+	 * app_rescale_done().
+	 */
+	while (true) {
+#ifdef IDLE_IN_LOW_POWER_MODE
+		irq_events = irq_event_count();
 #endif
-
-#if defined(TEST_APP_MOD_DATA_XFER_TRIGGER)
-		if (count_of_gpio_interrupts_to_dispatch && has_timer_expired()) {
-			stream_data_to_host_async(temp_buf, sizeof(temp_buf), 100, NULL);
-			if (--count_of_gpio_interrupts_to_dispatch != 0) {
-				set_timer_for_time(5000);  // 5 seconds
-			}
+		if (task_sched_run()) {
+			continue;
 		}
-#endif
-		/**
-		 * TBD-SRP: The current implementation of GARD does not support moving
-		 * the captured image to HRAM buffer and hence we do not call
-		 * app_rescale_done().
-		 */
 
 		/**
 		 * Finally, if we did not do any work then we enter low-power mode
 		 * until the next interrupt arrives.
 		 */
-		if (no_work) {
-			/* Execute WFI instruction for CPU to enter low-power mode. */
+#ifdef IDLE_IN_LOW_POWER_MODE
+		/**
+		 * With interrupts held off, no event is missed: an ISR which ran
+		 * since the round started, e.g. for a capture or ML done or bytes
+		 * received after the RX handlers ran, changed the event count and
+		 * the tasks get another round. Any later one stays pending, which
+		 * ends the WFI, and is taken once the interrupts are restored.
+		 */
+		irq_state = irq_save();
+		if ((irq_event_count() == irq_events) && !iface_rx_pending()) {
+			irq_wait_for_interrupt();
 		}
+		irq_restore(irq_state);
+#endif
 	}
 
 	return 0;
@@ -18,6 +18,11 @@
 #include "gpio_support.h"
 #include "ml_info.h"
 #include "pipeline_ops.h"
+#include "pipeline_stats.h"
+#include "trace_pins.h"
+#include "irq_support.h"
+#include "ml_ops.h"
+#include "camera_capture.h"
 
 /**
  * This file defines the ML operations related interfaces used by the App
@@ -57,6 +62,42 @@ static ml_network_handle_t currently_running_network = INVALID_NETWORK_HANDLE;
  */
 static ml_network_handle_t last_executed_network     = INVALID_NETWORK_HANDLE;
 
+/**
+ * p_prefetch_network is the network being loaded from flash to RAM in the
+ * background, see prefetch_network(), NULL if none. prefetch_offset is the
+ * count of its bytes loaded so far.
+ */
+static struct network_info *p_prefetch_network        = NULL;
+static uint32_t             prefetch_offset           = 0;
+
+/**
+ * run_queue holds the networks queued by queue_networks_to_run(), of which
+ * the ones from run_queue_pos on are still to be started. It is shared with
+ * the ML done IRQ, see chain_next_network_run(). run_queue_running is set
+ * from the start of the queue by start_ml_engine() until its last network is
+ * done, so the networks run by start_ml_engine_on_network() are not chained.
+ */
+static ml_network_handle_t  run_queue[ML_RUN_QUEUE_DEPTH];
+static volatile uint32_t    run_queue_count           = 0;
+static volatile uint32_t    run_queue_pos             = 0;
+static volatile bool        run_queue_running         = false;
+
+/**
+ * completed_runs are the networks whose ML runs are done but whose results
+ * are still to be handed to app_ml_done(), oldest first. The ring holds the
+ * runs of a queue and those of the queue after it.
+ */
+#define COMPLETED_RUNS_DEPTH (2U * ML_RUN_QUEUE_DEPTH)
+static struct network_info *completed_runs[COMPLETED_RUNS_DEPTH];
+static volatile uint32_t    completed_runs_head       = 0;
+static volatile uint32_t    completed_runs_count      = 0;
+
+/**
+ * Bytes of a network loaded by one call of continue_network_prefetch(), so
+ * that a prefetch does not hold up the other tasks of the main loop for long.
+ */
+#define NETWORK_PREFETCH_SLICE_SIZE (4U * 1024U)
+
 /**
  * Currently we support a maximum of 5 networks hence we can have up to
  * (5 * 2=) 10 slots to hold dis-jointed input and output buffers across all
@@ -73,6 +114,21 @@ struct mem_range {
 	uint32_t size;
 };
 
+/**
+ * network_mem_slots are the free memory slots of the ML networks region of
+ * HRAM, sorted by address and never adjacent to each other. The networks are
+ * given HRAM from them when loaded and give it back when evicted, see
+ * make_network_resident().
+ */
+static struct mem_range network_mem_slots[MAX_FREE_MEM_SLOTS];
+static uint32_t         network_valid_slots = 0;
+
+/**
+ * ml_run_seq counts the networks started on the ML engine. It is used to
+ * evict the least recently run network first when HRAM runs out.
+ */
+static uint32_t         ml_run_seq          = 0;
+
 /**
  * create_empty_slot_at_index() creates an empty slot at the specified index. If
  * needed it also shifts up the existing occupied slots up to make space for the
@@ -132,6 +188,10 @@ static void delete_empty_slot_at_index(uint32_t          index_of_slot_to_del,
 			free_mem_slots[index_of_slot_to_del + 1];
 		index_of_slot_to_del++;
 	}
+
+	/* Do not leave a copy of the last slot behind the valid ones. */
+	free_mem_slots[*valid_slots].start_addr = 0U;
+	free_mem_slots[*valid_slots].size       = 0U;
 }
 
 /**
@@ -237,15 +297,41 @@ static bool
 	return false;
 }
 
+/**
+ * aligned_network_size() returns the HRAM size set aside for a network, that is
+ * its size rounded up to the alignment required by the ML engine.
+ *
+ * @param network_size is the size of the network in bytes.
+ *
+ * @return The size of HRAM needed to hold the network.
+ */
+static uint32_t aligned_network_size(uint32_t network_size)
+{
+#if defined(ML_ENGINE_MEM_ALIGNMENT_BYTES) &&                                  \
+	(ML_ENGINE_MEM_ALIGNMENT_BYTES > 1U)
+	/**
+	 * If the size is not aligned then we will allocate space with extra bytes
+	 * to satisfy the alignment requirements.
+	 */
+	if (0U != (network_size % ML_ENGINE_MEM_ALIGNMENT_BYTES)) {
+		network_size += (ML_ENGINE_MEM_ALIGNMENT_BYTES -
+						 (network_size % ML_ENGINE_MEM_ALIGNMENT_BYTES));
+	}
+#endif
+
+	return network_size;
+}
+
 /**
  * allocate_space_for_network_in_mem_range() allocates space for a network in
- * the fragmented free memory range captured in free_mem_slots. The routine
- * adjusts the slot whose memory was used to hold the network.
+ * the fragmented free memory range captured in free_mem_slots. The smallest
+ * slot the network fits in is used (best fit), so that the larger slots are
+ * kept for the larger networks. The routine adjusts the slot whose memory was
+ * used to hold the network.
  *
  * @param network_size is the size of the network that should be set aside in
  * 					   the memory.
  * @param free_mem_slots is a pointer to the array of free memory slots
- * @param mem_slot_count is the count of total slots in the free_mem_slots
  * @param valid_slots is a pointer to the variable that holds the count of valid
  * * 				  slots in the free_mem_slots array.
  *
@@ -255,51 +341,44 @@ static bool
 static uint32_t
 	allocate_space_for_network_in_mem_range(uint32_t          network_size,
 											struct mem_range *free_mem_slots,
-											uint32_t          mem_slot_count,
 											uint32_t         *valid_slots)
 {
 	uint32_t          idx;
-	struct mem_range *fms        = free_mem_slots;
+	struct mem_range *fms        = NULL;
 	uint32_t          start_addr = 0U;
 
 	GARD__DBG_ASSERT((0U != network_size) && (NULL != free_mem_slots),
 					 "Invalid memory range parameters");
 
-#if defined(ML_ENGINE_MEM_ALIGNMENT_BYTES) &&                                  \
-	(ML_ENGINE_MEM_ALIGNMENT_BYTES > 1U)
-	/**
-	 * If the size is not aligned then we will allocate space with extra bytes
-	 * to satisfy the alignment requirements.
-	 */
-	if (0U != (network_size % ML_ENGINE_MEM_ALIGNMENT_BYTES)) {
-		network_size += (ML_ENGINE_MEM_ALIGNMENT_BYTES -
-						 (network_size % ML_ENGINE_MEM_ALIGNMENT_BYTES));
+	network_size = aligned_network_size(network_size);
+
+	for (idx = 0; idx < *valid_slots; idx++) {
+		if ((network_size <= free_mem_slots[idx].size) &&
+			((NULL == fms) || (free_mem_slots[idx].size < fms->size))) {
+			fms = &free_mem_slots[idx];
+		}
 	}
-#endif
 
-	for (idx = 0; idx < mem_slot_count; idx++) {
-		if (network_size == fms->size) {
-			start_addr = fms->start_addr;
+	if (NULL == fms) {
+		return 0U;
+	}
 
-			/**
-			 * This slot is no more needed. Shift down the rest of the free mem
-			 * slot entries.
-			 */
-			delete_empty_slot_at_index(idx, free_mem_slots, valid_slots);
-			break;
-		} else if (network_size < fms->size) {
-			/**
-			 * Network fits in the slot but leaves some space.
-			 * We need to adjust the size of the current slot size to
-			 * account for the network that is being allocated.
-			 */
-			start_addr       = fms->start_addr;
-
-			fms->size       -= network_size;
-			fms->start_addr += network_size;
-			break;
-		}
-		fms++;
+	start_addr = fms->start_addr;
+	if (network_size == fms->size) {
+		/**
+		 * This slot is no more needed. Shift down the rest of the free mem
+		 * slot entries.
+		 */
+		delete_empty_slot_at_index((uint32_t)(fms - free_mem_slots),
+								   free_mem_slots, valid_slots);
+	} else {
+		/**
+		 * Network fits in the slot but leaves some space.
+		 * We need to adjust the size of the current slot size to
+		 * account for the network that is being allocated.
+		 */
+		fms->size       -= network_size;
+		fms->start_addr += network_size;
 	}
 
 #if defined(ML_ENGINE_MEM_ALIGNMENT_BYTES) &&                                  \
@@ -316,6 +395,154 @@ static uint32_t
 	return start_addr;
 }
 
+/**
+ * free_space_in_mem_range() gives back memory set aside by
+ * allocate_space_for_network_in_mem_range() to the free memory slots. The
+ * memory is merged with the free slots right before and after it, so that
+ * freeing networks one after the other does not leave the memory fragmented.
+ *
+ * @param start_addr is the start address of the memory to free.
+ * @param size is the size of the memory to free, as given to the allocator.
+ * @param free_mem_slots is a pointer to the array of free memory slots
+ * @param valid_slots is a pointer to the variable that holds the count of valid
+ * 					  slots in the free_mem_slots array.
+ *
+ * @return None
+ */
+static void free_space_in_mem_range(uint32_t          start_addr,
+									uint32_t          size,
+									struct mem_range *free_mem_slots,
+									uint32_t         *valid_slots)
+{
+	uint32_t          idx;
+	struct mem_range *prev;
+	struct mem_range *next;
+
+	size = aligned_network_size(size);
+
+	/* Find the first free slot after the memory being freed. */
+	for (idx = 0; idx < *valid_slots; idx++) {
+		if (free_mem_slots[idx].start_addr > start_addr) {
+			break;
+		}
+	}
+
+	prev = (idx > 0U) ? &free_mem_slots[idx - 1U] : NULL;
+	next = (idx < *valid_slots) ? &free_mem_slots[idx] : NULL;
+
+	GARD__DBG_ASSERT(((NULL == prev) ||
+					  (prev->start_addr + prev->size <= start_addr)) &&
+						 ((NULL == next) ||
+						  (start_addr + size <= next->start_addr)),
+					 "Freeing memory that is already free");
+
+	if ((NULL != prev) && (prev->start_addr + prev->size == start_addr)) {
+		prev->size += size;
+		if ((NULL != next) && (start_addr + size == next->start_addr)) {
+			/* The freed memory bridges its two neighbours. */
+			prev->size += next->size;
+			delete_empty_slot_at_index(idx, free_mem_slots, valid_slots);
+		}
+	} else if ((NULL != next) && (start_addr + size == next->start_addr)) {
+		next->start_addr  = start_addr;
+		next->size       += size;
+	} else {
+		create_empty_slot_at_index(idx, free_mem_slots, valid_slots);
+		free_mem_slots[idx].start_addr = start_addr;
+		free_mem_slots[idx].size       = size;
+	}
+}
+
+/**
+ * load_network_from_offset() loads a network from flash to RAM, from offset
+ * onwards.
+ *
+ * @param p_network is the network to load.
+ * @param offset is the count of bytes of the network already loaded.
+ * @param max_bytes is the maximum count of bytes to load.
+ *
+ * @return The count of bytes of the network loaded once done.
+ */
+static uint32_t load_network_from_offset(struct network_info *p_network,
+										 uint32_t             offset,
+										 uint32_t             max_bytes)
+{
+	uint32_t num_bytes = p_network->fw_core_data.network_size_in_bytes - offset;
+
+	if (num_bytes > max_bytes) {
+		num_bytes = max_bytes;
+	}
+
+	if ((0U == offset) && (num_bytes > 0U)) {
+		p_network->fw_core_data.count_of_loads++;
+	}
+
+	if (num_bytes > 0U) {
+		GARD__ASSERT(
+			ospi_read_from_flash(
+				sd,
+				(void *)(p_network->fw_core_data.addr_of_network_in_ram +
+						 offset),
+				p_network->fw_core_data.addr_of_network_in_flash + offset,
+				num_bytes) == num_bytes,
+			"Load ML network failed");
+	}
+
+	return offset + num_bytes;
+}
+
+/**
+ * network_outranks() tells if a network is to be kept in HRAM over another
+ * one: pinned networks outrank the others, then the highest residency
+ * priority does.
+ *
+ * @param p_a is the first network.
+ * @param p_b is the second network.
+ *
+ * @return true if p_a outranks p_b, false otherwise.
+ */
+static bool network_outranks(const struct network_info *p_a,
+							 const struct network_info *p_b)
+{
+	if (p_a->pinned != p_b->pinned) {
+		return p_a->pinned;
+	}
+
+	return p_a->residency_priority > p_b->residency_priority;
+}
+
+/**
+ * next_network_to_place() picks the network register_networks() places in
+ * HRAM next: the one outranking all the others not placed yet, the first
+ * registered of them on a tie.
+ *
+ * @param p_networks is the networks being registered.
+ * @param p_placed is the bit mask of the indexes of the networks already
+ * 				   placed, updated with the one picked.
+ *
+ * @return The network to place next.
+ */
+static struct network_info *next_network_to_place(struct networks *p_networks,
+												  uint32_t        *p_placed)
+{
+	struct network_info *p_next   = NULL;
+	uint32_t             next_idx = 0;
+	uint32_t             idx;
+
+	for (idx = 0; idx < p_networks->count_of_networks; idx++) {
+		if ((0U == (*p_placed & (1U << idx))) &&
+			((NULL == p_next) ||
+			 network_outranks(&p_networks->networks[idx], p_next))) {
+			p_next   = &p_networks->networks[idx];
+			next_idx = idx;
+		}
+	}
+
+	*p_placed |= (1U << next_idx);
+
+	return p_next;
+}
+
 /**
  * register_networks() takes a stock of networks that the App Module will be
  * needing and figures out a way to optimally distribute the available
@@ -331,19 +558,15 @@ bool register_networks(struct networks *p_networks)
 {
 	uint32_t             ntwrk_idx;
 	struct network_info *ntwrk;
-	struct mem_range     network_mem_slots[MAX_FREE_MEM_SLOTS] = {0};
-	struct mem_range     io_mem_slots[MAX_FREE_MEM_SLOTS]      = {0};
-	uint32_t             network_valid_slots                   = 0;
-	uint32_t             io_valid_slots                        = 0;
-	uint32_t             ntwrk_addr;
+	struct mem_range     io_mem_slots[MAX_FREE_MEM_SLOTS] = {0};
+	uint32_t             io_valid_slots                   = 0;
+	uint32_t             placed                           = 0;
 	uint32_t             inout_start;
 	uint32_t             inout_end;
 	uint32_t             io_region_start;
 	uint32_t             io_region_end;
-	uint32_t             ntwrk_start;
-	uint32_t             ntwrk_end;
-	uint32_t             network_region_start;
-	uint32_t             network_region_end;
+	enum image_formats   capture_format = IMAGE_FORMAT__GRAYSCALE;
+	bool                 format_set;
 
 	GARD__DBG_ASSERT((NULL != p_networks) &&
 						 (0U != p_networks->count_of_networks) &&
@@ -359,16 +582,21 @@ bool register_networks(struct networks *p_networks)
 	 *    enabled, this routine will also ensure that the none of the input
 	 * and output buffers across all the networks overlap with each other.
 	 * 3. After memory has been set aside for the input and output buffers,
-	 * and surplus memory is still available check if the networks can be
-	 * loaded into this excess memory to improve performance. At least try
-	 * to get the first network loaded into the HRAM.
+	 * set HRAM aside for as many networks as fit in the networks region of
+	 * HRAM: the pinned networks first, then by residency priority. The others
+	 * get HRAM when they are run or prefetched, evicting the lowest priority
+	 * networks if needed, see make_network_resident().
+	 * 4. The networks are not loaded here but in the background by the main
+	 * loop, see continue_network_prefetch(), so that the App Module can go on
+	 * with starting the camera and the first capture in the meantime. What is
+	 * left of a network to load when it is started is loaded then.
 	 */
 
 	/**
 	 * TBD-SRP
 	 * The current version of the code assumes the following:
-	 * - Enough HRAM is available to hold all the networks and their input
-	 * and output buffers.
+	 * - Enough HRAM is available to hold the input and output buffers of all
+	 * the networks, and the largest network on its own.
 	 * - The input and output buffers of the networks do not overlap each
 	 * other.
 	 * - The buffers are assigned from the start of the HRAM for each
@@ -387,9 +615,14 @@ bool register_networks(struct networks *p_networks)
 #endif
 
 	/* Seed the allocator with the ML network partition. */
+	for (ntwrk_idx = 0; ntwrk_idx < MAX_FREE_MEM_SLOTS; ntwrk_idx++) {
+		network_mem_slots[ntwrk_idx].start_addr = 0U;
+		network_mem_slots[ntwrk_idx].size       = 0U;
+	}
 	network_mem_slots[0].start_addr = HRAM_ML_NETWORKS_START_ADDR;
 	network_mem_slots[0].size       = HRAM_ML_NETWORKS_SIZE;
 	network_valid_slots             = 1;
+	ml_run_seq                      = 0;
 
 	/* Seed the allocator with the ML IO partition. */
 	io_mem_slots[0].start_addr      = HRAM_ML_IO_START_ADDR;
@@ -426,57 +659,60 @@ bool register_networks(struct networks *p_networks)
 			ntwrk->inout_offset, ntwrk->inout_size, io_mem_slots,
 			GET_ARRAY_COUNT(io_mem_slots), &io_valid_slots);
 
+		/* The images are grayscale if all the networks take grayscale. */
+		if (IMAGE_FORMAT__GRAYSCALE != ntwrk->input_format) {
+			capture_format = IMAGE_FORMAT__RGB_PLANAR;
+		}
+
 		/* Remember the network is still not loaded in RAM. */
-		ntwrk->fw_core_data.loaded_into_ram = false;
+		ntwrk->fw_core_data.loaded_into_ram        = false;
+		ntwrk->fw_core_data.addr_of_network_in_ram = 0U;
+		ntwrk->fw_core_data.last_run_seq           = 0U;
+		ntwrk->fw_core_data.count_of_loads         = 0U;
+		ntwrk->fw_core_data.swapped_in_ram         = false;
+
+		GARD__DBG_ASSERT(aligned_network_size(
+							 ntwrk->fw_core_data.network_size_in_bytes) <=
+							 HRAM_ML_NETWORKS_SIZE,
+						 "ML network does not fit in HRAM");
 	}
 
+	format_set = set_capture_format(capture_format);
+	GARD__ASSERT(format_set, "ML network input format not supported");
+
 	/**
 	 * At this point we have reserved space for both input and output buffers in
 	 * the HRAM for all the networks. The remaining HRAM memory can be used to
 	 * place networks.
 	 */
 
-	/** We start to assign memory for holding the networks in HRAM. Currently
-	 * we just take the first available memory and assign it to the network.
-	 * Going forward we should find the most optimal way to place the networks
-	 * in HRAM, since they could be of different sizes and we will need to have
-	 * additional logic to ensure that all the networks find space in HRAM.
+	/**
+	 * The networks are placed in HRAM for as long as they fit, the pinned
+	 * networks first, then by residency priority and then in the order they
+	 * are registered. A network that does not fit is left without HRAM and is
+	 * placed when it is to be run, or prefetched before that. The placed
+	 * networks are loaded by the background prefetch.
 	 */
+	p_networks_handler = p_networks;
+	p_prefetch_network = NULL;
+
+	GARD__DBG_ASSERT(p_networks->count_of_networks <= 32U,
+					 "Too many ML networks");
 
 	for (ntwrk_idx = 0; ntwrk_idx < p_networks->count_of_networks;
 		 ntwrk_idx++) {
-		ntwrk      = &p_networks->networks[ntwrk_idx];
+		ntwrk = next_network_to_place(p_networks, &placed);
 
-		ntwrk_addr = allocate_space_for_network_in_mem_range(
-			ntwrk->fw_core_data.network_size_in_bytes, network_mem_slots,
-			GET_ARRAY_COUNT(network_mem_slots), &network_valid_slots);
+		ntwrk->fw_core_data.addr_of_network_in_ram =
+			allocate_space_for_network_in_mem_range(
+				ntwrk->fw_core_data.network_size_in_bytes, network_mem_slots,
+				&network_valid_slots);
 
-		GARD__DBG_ASSERT(0U != ntwrk_addr,
-						 "Failed to allocate HRAM for ML network");
-
-		/* Verifies the network allocation is within the networks region. */
-		ntwrk_start = ntwrk_addr;
-		ntwrk_end   = ntwrk_start + ntwrk->fw_core_data.network_size_in_bytes;
-		network_region_start = HRAM_ML_NETWORKS_START_ADDR;
-		network_region_end   = network_region_start + HRAM_ML_NETWORKS_SIZE;
-
-		GARD__DBG_ASSERT((ntwrk_start >= network_region_start) &&
-							 (ntwrk_end <= network_region_end),
-						 "Network allocation outside ML networks region");
-
-		GARD__ASSERT(
-			ospi_read_from_flash(sd, (void *)ntwrk_addr,
-								 ntwrk->fw_core_data.addr_of_network_in_flash,
-								 ntwrk->fw_core_data.network_size_in_bytes) ==
-				ntwrk->fw_core_data.network_size_in_bytes,
-			"Load ML network failed");
-
-		/* The network is now loaded in RAM for quicker access.*/
-		ntwrk->fw_core_data.loaded_into_ram        = true;
-		ntwrk->fw_core_data.addr_of_network_in_ram = ntwrk_addr;
+		GARD__ASSERT(!ntwrk->pinned ||
+						 (0U != ntwrk->fw_core_data.addr_of_network_in_ram),
+					 "Pinned ML networks do not fit in HRAM");
 	}
 
-	p_networks_handler        = p_networks;
 	next_network_to_run       = p_networks->networks[0].network;
 	currently_running_network = INVALID_NETWORK_HANDLE;
 
@@ -493,8 +729,7 @@ bool register_networks(struct networks *p_networks)
  * @return A pointer to the network_info structure if the network is found,
  *         NULL otherwise.
  */
-static struct network_info *
-	get_network_info_for_uid(ml_network_handle_t network)
+struct network_info *get_network_info_for_uid(ml_network_handle_t network)
 {
 	uint32_t idx;
 
@@ -511,6 +746,350 @@ static struct network_info *
 	return NULL;
 }
 
+/**
+ * evict_network() gives the HRAM of a network back to the free memory slots.
+ * The network is loaded again when it is run or prefetched next. A prefetch of
+ * the network is dropped.
+ *
+ * @param p_network is the network to evict, it must not be running.
+ *
+ * @return None
+ */
+static void evict_network(struct network_info *p_network)
+{
+	free_space_in_mem_range(p_network->fw_core_data.addr_of_network_in_ram,
+							p_network->fw_core_data.network_size_in_bytes,
+							network_mem_slots, &network_valid_slots);
+
+	p_network->fw_core_data.addr_of_network_in_ram = 0U;
+	p_network->fw_core_data.loaded_into_ram        = false;
+	if (p_prefetch_network == p_network) {
+		p_prefetch_network = NULL;
+	}
+}
+
+/**
+ * is_network_queued() tells if a network is queued to run, see
+ * queue_networks_to_run().
+ *
+ * @param network is the UID of the network.
+ *
+ * @return true if the network is yet to be started by the queue, false
+ *         otherwise.
+ */
+static bool is_network_queued(ml_network_handle_t network)
+{
+	uint32_t idx;
+
+	for (idx = run_queue_pos; idx < run_queue_count; idx++) {
+		if (run_queue[idx] == network) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * evict_one_network() evicts the network with HRAM that is needed the least:
+ * the one with the lowest residency priority, and the one that ran the
+ * longest time ago among those, networks that never ran first. Pinned
+ * networks, swapped networks not in flash yet, the network running on the ML
+ * engine and p_network are never evicted, nor are the networks queued to run.
+ *
+ * @param p_network is the network HRAM is needed for, NULL if none.
+ *
+ * @return true if a network was evicted, false if none can be.
+ */
+static bool evict_one_network(struct network_info *p_network)
+{
+	struct network_info *p_other;
+	struct network_info *p_victim = NULL;
+	uint32_t             idx;
+	uint32_t             irq_state;
+
+	/* The ML done IRQ may start a queued network meanwhile. */
+	irq_state = irq_save();
+	for (idx = 0; idx < p_networks_handler->count_of_networks; idx++) {
+		p_other = &p_networks_handler->networks[idx];
+		if ((p_other == p_network) || p_other->pinned ||
+			p_other->fw_core_data.swapped_in_ram ||
+			(0U == p_other->fw_core_data.addr_of_network_in_ram) ||
+			(p_other->network == currently_running_network) ||
+			is_network_queued(p_other->network)) {
+			continue;
+		}
+
+		if (NULL == p_victim) {
+			p_victim = p_other;
+		} else if (p_other->residency_priority !=
+				   p_victim->residency_priority) {
+			if (p_other->residency_priority < p_victim->residency_priority) {
+				p_victim = p_other;
+			}
+		} else if ((0U != p_victim->fw_core_data.last_run_seq) &&
+				   ((0U == p_other->fw_core_data.last_run_seq) ||
+					((int32_t)(p_other->fw_core_data.last_run_seq -
+							   p_victim->fw_core_data.last_run_seq) < 0))) {
+			/* Signed difference so that the run counter can wrap around. */
+			p_victim = p_other;
+		}
+	}
+
+	if (NULL != p_victim) {
+		evict_network(p_victim);
+	}
+	irq_restore(irq_state);
+
+	return (NULL != p_victim);
+}
+
+/**
+ * make_network_resident() sets aside HRAM for a network, evicting the networks
+ * needed the least until it fits, see evict_one_network(). The network still
+ * has to be loaded in it.
+ *
+ * @param p_network is the network to place in HRAM.
+ *
+ * @return true if the network has HRAM, false if it cannot get any while the
+ *         network running on the ML engine and the pinned networks hold
+ *         their HRAM.
+ */
+static bool make_network_resident(struct network_info *p_network)
+{
+	while (0U == p_network->fw_core_data.addr_of_network_in_ram) {
+		p_network->fw_core_data.addr_of_network_in_ram =
+			allocate_space_for_network_in_mem_range(
+				p_network->fw_core_data.network_size_in_bytes,
+				network_mem_slots, &network_valid_slots);
+
+		if ((0U == p_network->fw_core_data.addr_of_network_in_ram) &&
+			!evict_one_network(p_network)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * prefetch_network() starts loading a network from flash to RAM in the
+ * background, one slice at a time from the main loop, so that it is ready
+ * by the time it is started on the ML engine. A prefetch in progress of
+ * another network is dropped.
+ *
+ * The network scheduled to run next is prefetched without the App Module
+ * asking for it, as soon as there is HRAM for it besides the HRAM of the
+ * network running on the ML engine.
+ *
+ * @param network is the UID of the already registered network to prefetch.
+ *
+ * @return true if the network is loaded in RAM or being loaded, false if no
+ *         HRAM can be set aside for it yet.
+ */
+bool prefetch_network(ml_network_handle_t network)
+{
+	struct network_info *p_network;
+
+	GARD__DBG_ASSERT(NULL != p_networks_handler, "Networks not registered");
+
+	p_network = get_network_info_for_uid(network);
+
+	GARD__DBG_ASSERT(NULL != p_network,
+					 "Network not found in the registered networks");
+
+	if (p_network->fw_core_data.loaded_into_ram ||
+		(p_prefetch_network == p_network)) {
+		return true;
+	}
+
+	if (!make_network_resident(p_network)) {
+		return false;
+	}
+
+	p_prefetch_network = p_network;
+	prefetch_offset    = 0;
+
+	return true;
+}
+
+/**
+ * network_to_prefetch() picks the network to prefetch when none is being
+ * prefetched: the network scheduled to run next, or once it is loaded in RAM
+ * the next queued network not loaded yet, or else the first network with HRAM
+ * set aside that register_networks() left to load.
+ *
+ * @return The UID of the network to prefetch.
+ */
+static ml_network_handle_t network_to_prefetch(void)
+{
+	struct network_info *p_network;
+	uint32_t             idx;
+
+	p_network = get_network_info_for_uid(next_network_to_run);
+	if ((NULL == p_network) || !p_network->fw_core_data.loaded_into_ram) {
+		return next_network_to_run;
+	}
+
+	for (idx = run_queue_pos; idx < run_queue_count; idx++) {
+		p_network = get_network_info_for_uid(run_queue[idx]);
+		if (!p_network->fw_core_data.loaded_into_ram) {
+			return run_queue[idx];
+		}
+	}
+
+	for (idx = 0; idx < p_networks_handler->count_of_networks; idx++) {
+		p_network = &p_networks_handler->networks[idx];
+		if ((0U != p_network->fw_core_data.addr_of_network_in_ram) &&
+			!p_network->fw_core_data.loaded_into_ram) {
+			return p_network->network;
+		}
+	}
+
+	return next_network_to_run;
+}
+
+/**
+ * continue_network_prefetch() loads the next slice of the network being
+ * prefetched. With no prefetch in progress, it starts prefetching the network
+ * picked by network_to_prefetch().
+ *
+ * @return true if a slice was loaded, false if there is nothing to prefetch.
+ */
+bool continue_network_prefetch(void)
+{
+	if ((NULL == p_networks_handler) ||
+		((NULL == p_prefetch_network) &&
+		 !prefetch_network(network_to_prefetch())) ||
+		(NULL == p_prefetch_network)) {
+		return false;
+	}
+
+	prefetch_offset = load_network_from_offset(
+		p_prefetch_network, prefetch_offset, NETWORK_PREFETCH_SLICE_SIZE);
+
+	if (prefetch_offset ==
+		p_prefetch_network->fw_core_data.network_size_in_bytes) {
+		p_prefetch_network->fw_core_data.loaded_into_ram = true;
+		p_prefetch_network                               = NULL;
+	}
+
+	return true;
+}
+
+/**
+ * reserve_network_staging() sets aside HRAM of the ML networks region for a
+ * network Host sends to replace a registered one, see network_swap.h. The
+ * networks needed the least are evicted until it fits, see
+ * evict_one_network().
+ *
+ * @param size is the size of the network in bytes.
+ *
+ * @return The HRAM address set aside, 0 if the network cannot fit while the
+ *         pinned, swapped, running and queued networks hold their HRAM.
+ */
+uint32_t reserve_network_staging(uint32_t size)
+{
+	uint32_t addr = 0U;
+
+	if ((NULL == p_networks_handler) || (0U == size) ||
+		(aligned_network_size(size) > HRAM_ML_NETWORKS_SIZE)) {
+		return 0U;
+	}
+
+	while (0U == addr) {
+		addr = allocate_space_for_network_in_mem_range(
+			size, network_mem_slots, &network_valid_slots);
+
+		if ((0U == addr) && !evict_one_network(NULL)) {
+			return 0U;
+		}
+	}
+
+	return addr;
+}
+
+/**
+ * release_network_staging() gives back HRAM set aside by
+ * reserve_network_staging() and not switched to.
+ *
+ * @param addr is the HRAM address set aside.
+ * @param size is the size given to reserve_network_staging().
+ *
+ * @return None
+ */
+void release_network_staging(uint32_t addr, uint32_t size)
+{
+	free_space_in_mem_range(addr, size, network_mem_slots,
+							&network_valid_slots);
+}
+
+/**
+ * switch_network_in_ram() makes a registered network run from the staged
+ * copy at addr from its next run on. This is only done while the ML engine is
+ * idle and the network is not queued to run, so that no ML run sees a part of
+ * each copy. The HRAM of the previous copy is given back and the network is
+ * held in HRAM until network_persisted() is called, as its flash copy is the
+ * previous one.
+ *
+ * @param network is the UID of the registered network.
+ * @param addr is the HRAM address of the new copy, from
+ *             reserve_network_staging().
+ * @param size is the size of the new copy in bytes.
+ *
+ * @return true if the network was switched, false if it is to be tried again
+ *         at the next frame boundary.
+ */
+bool switch_network_in_ram(ml_network_handle_t network,
+						   uint32_t            addr,
+						   uint32_t            size)
+{
+	struct network_info *p_network = get_network_info_for_uid(network);
+	uint32_t             irq_state;
+
+	GARD__DBG_ASSERT(NULL != p_network,
+					 "Network not found in the registered networks");
+
+	/* The ML done IRQ may start a queued network meanwhile. */
+	irq_state = irq_save();
+	if ((INVALID_NETWORK_HANDLE != currently_running_network) ||
+		is_network_queued(network)) {
+		irq_restore(irq_state);
+		return false;
+	}
+
+	if (0U != p_network->fw_core_data.addr_of_network_in_ram) {
+		evict_network(p_network);
+	}
+
+	p_network->fw_core_data.addr_of_network_in_ram = addr;
+	p_network->fw_core_data.network_size_in_bytes  = size;
+	p_network->fw_core_data.loaded_into_ram        = true;
+	p_network->fw_core_data.swapped_in_ram         = true;
+	irq_restore(irq_state);
+
+	return true;
+}
+
+/**
+ * network_persisted() tells that the flash copy of a network switched to by
+ * switch_network_in_ram() is now the one in RAM, so that it can be evicted
+ * and loaded again like the other networks.
+ *
+ * @param network is the UID of the registered network.
+ *
+ * @return None
+ */
+void network_persisted(ml_network_handle_t network)
+{
+	struct network_info *p_network = get_network_info_for_uid(network);
+
+	GARD__DBG_ASSERT(NULL != p_network,
+					 "Network not found in the registered networks");
+
+	p_network->fw_core_data.swapped_in_ram = false;
+}
+
 /**
  * schedule_network_to_run() is invoked by routines in the App Module to
  * schedule the ML network that should be executed next on the ML engine. The
@@ -526,6 +1105,7 @@ static struct network_info *
 bool schedule_network_to_run(ml_network_handle_t network)
 {
 	uint32_t idx;
+	uint32_t irq_state;
 	bool     found_network = false;
 
 	GARD__DBG_ASSERT(NULL != p_networks_handler, "Networks not registered");
@@ -554,8 +1134,54 @@ bool schedule_network_to_run(ml_network_handle_t network)
 	GARD__DBG_ASSERT(found_network,
 					 "Network not found in the registered networks");
 
-	/* Set network to be run next. */
+	/* Set network to be run next, the App Module takes over from the queue. */
+	irq_state           = irq_save();
+	run_queue_count     = 0;
+	run_queue_pos       = 0;
+	run_queue_running   = false;
 	next_network_to_run = network;
+	irq_restore(irq_state);
+
+	return true;
+}
+
+/**
+ * queue_networks_to_run() queues ML networks to be run back to back on the
+ * same frame, see fw_core.h.
+ *
+ * @param p_networks is the UIDs of the already registered networks, in the
+ *                   order they are to be run.
+ * @param count is the count of networks in p_networks.
+ *
+ * @return true if the networks were queued, false otherwise.
+ */
+bool queue_networks_to_run(const ml_network_handle_t *p_networks,
+						   uint32_t                   count)
+{
+	uint32_t idx;
+	uint32_t irq_state;
+
+	GARD__DBG_ASSERT(NULL != p_networks_handler, "Networks not registered");
+
+	if ((NULL == p_networks) || (0U == count) ||
+		(count > ML_RUN_QUEUE_DEPTH)) {
+		return false;
+	}
+
+	for (idx = 0; idx < count; idx++) {
+		GARD__DBG_ASSERT(NULL != get_network_info_for_uid(p_networks[idx]),
+						 "Network not found in the registered networks");
+	}
+
+	irq_state = irq_save();
+	for (idx = 0; idx < count; idx++) {
+		run_queue[idx] = p_networks[idx];
+	}
+	run_queue_count     = count;
+	run_queue_pos       = 1;
+	run_queue_running   = false;
+	next_network_to_run = p_networks[0];
+	irq_restore(irq_state);
 
 	return true;
 }
@@ -589,80 +1215,164 @@ int32_t get_uid_of_currently_running_network(void)
 }
 
 /**
- * start_ml_engine() starts the ML engine to execute the network whose UID is
- * present in scheduled_network_to_run. If no network is scheduled, which will
- * happen only when the networks are not registered, then the function will
- * assert.
+ * run_network_on_engine() starts the ML engine on a network loaded in RAM. It
+ * is also called from the ML done IRQ, see chain_next_network_run().
+ *
+ * @param p_network is the network to run, loaded in RAM.
  *
  * @return None
  */
-void start_ml_engine(void)
+static void run_network_on_engine(struct network_info *p_network)
 {
-	struct network_info *p_network_to_start;
-	struct network_info *p_network_last_run;
+	/* Setup ML engine to run the new network. */
+	GARD__ML_ENG_CODE_BASE = p_network->fw_core_data.addr_of_network_in_ram;
 
-	GARD__DBG_ASSERT((NULL != p_networks_handler) ||
-						 (INVALID_NETWORK_HANDLE != next_network_to_run),
-					 "Networks not registered");
+	TRACE_BEGIN(ML_RUN);
+	/* Start ML Engine. */
+	GARD__START_ML_ENGINE();
+	pipeline_stats_start(PIPELINE_STATS__ML);
+
+	ml_engine_started = true;
+
+	/* ML Network started. Update local variables to indicate status */
+	currently_running_network = p_network->network;
+	last_executed_network     = p_network->network;
+
+	/* 0 is kept for the networks that never ran. */
+	if (0U == ++ml_run_seq) {
+		ml_run_seq = 1U;
+	}
+	p_network->fw_core_data.last_run_seq = ml_run_seq;
+}
+
+/**
+ * push_completed_run() records that the ML run of a network is done, for its
+ * results to be handed to app_ml_done().
+ *
+ * @param p_network is the network whose run is done.
+ *
+ * @return None
+ */
+static void push_completed_run(struct network_info *p_network)
+{
+	uint32_t irq_state = irq_save();
+
+	GARD__DBG_ASSERT(completed_runs_count < COMPLETED_RUNS_DEPTH,
+					 "Too many ML results pending");
+
+	completed_runs[(completed_runs_head + completed_runs_count) %
+				   COMPLETED_RUNS_DEPTH] = p_network;
+	completed_runs_count++;
+
+	/**
+	 * Signal to the main loop that ML engine work is complete and any
+	 * processing needed to be done on the output data can be started.
+	 */
+	ml_engine_work_done = true;
+	irq_restore(irq_state);
+}
+
+/**
+ * take_completed_network_run() returns the oldest ML run whose results are
+ * still to be handed to app_ml_done().
+ *
+ * @return The network of the run, NULL if there is none.
+ */
+struct network_info *take_completed_network_run(void)
+{
+	struct network_info *p_network = NULL;
+	uint32_t             irq_state = irq_save();
+
+	if (0U != completed_runs_count) {
+		p_network           = completed_runs[completed_runs_head];
+		completed_runs_head = (completed_runs_head + 1U) % COMPLETED_RUNS_DEPTH;
+		completed_runs_count--;
+	}
+	ml_engine_work_done = (0U != completed_runs_count);
+	irq_restore(irq_state);
+
+	return p_network;
+}
+
+/**
+ * chain_next_network_run() is called from the ML done IRQ. If the next network
+ * queued by queue_networks_to_run() is loaded in RAM, the run just done is
+ * completed and the next network started right away, without waiting for the
+ * main loop. A network still to be loaded from flash is left to
+ * ml_engine_done_isr().
+ *
+ * @return true if the next network was started, false if the completion is to
+ *         be handled by ml_engine_done_isr().
+ */
+bool chain_next_network_run(void)
+{
+	struct network_info *p_next;
+
+	if ((NULL == p_networks_handler) || !run_queue_running ||
+		(run_queue_pos >= run_queue_count) ||
+		(INVALID_NETWORK_HANDLE == currently_running_network) ||
+		(completed_runs_count >= COMPLETED_RUNS_DEPTH)) {
+		return false;
+	}
+
+	p_next = get_network_info_for_uid(run_queue[run_queue_pos]);
+	if (!p_next->fw_core_data.loaded_into_ram) {
+		return false;
+	}
+
+	pipeline_stats_end(PIPELINE_STATS__ML);
+	GARD__CLEAR_ISR();
+	push_completed_run(get_network_info_for_uid(currently_running_network));
+
+	/* The next network is running before it leaves the queue, see eviction. */
+	next_network_to_run = p_next->network;
+	run_network_on_engine(p_next);
+	run_queue_pos++;
+
+	return true;
+}
+
+/**
+ * load_and_start_network() loads a network in RAM if it is not there yet and
+ * starts the ML engine on it.
+ *
+ * @param p_network_to_start is the network to run.
+ *
+ * @return None
+ */
+static void load_and_start_network(struct network_info *p_network_to_start)
+{
+	uint32_t offset;
 
 	/**
 	 * A few things need to be done as a part of starting the engine:
-	 * 1) If last run network in RAM overlaps with the address to hold the
-	 *    new network then we mark the last run network as not loaded in RAM and
-	 *    load the new network in RAM for execution.
-	 * 2) If the network to be run is already loaded in RAM then no loading is
-	 *    needed, if not then we load the new network from flash to RAM.
+	 * 1) If the network to be run is already loaded in RAM then no loading is
+	 *    needed, if not then we load the new network from flash to RAM, or
+	 *    its part not prefetched yet.
+	 * 2) If the network has no HRAM, the least recently run networks are
+	 *    evicted from HRAM until it fits. They are reloaded when they are
+	 *    scheduled to run again.
 	 * 3) Initialize the ML engine registers to run the new network.
 	 * 4) Start the ML engine.
 	 */
-	p_network_to_start = get_network_info_for_uid(next_network_to_run);
-
-	if (last_executed_network != next_network_to_run &&
-		INVALID_NETWORK_HANDLE != last_executed_network) {
-		p_network_last_run = get_network_info_for_uid(last_executed_network);
-		/**
-		 * If we find an overlap of memory addresses between the last run
-		 * network and the new network to be started then we mark the last
-		 * network as not loaded in RAM so that it can be reloaded in RAM when
-		 * it is scheduled to run again. This is because we are going to load
-		 * the new network in RAM and thus overwrite the contents of the last
-		 * run network.
-		 */
-		if (((p_network_last_run->fw_core_data.addr_of_network_in_ram <=
-			  p_network_to_start->fw_core_data.addr_of_network_in_ram) &&
-			 (p_network_last_run->fw_core_data.addr_of_network_in_ram +
-				  p_network_last_run->fw_core_data.network_size_in_bytes >
-			  p_network_to_start->fw_core_data.addr_of_network_in_ram)) ||
-			((p_network_to_start->fw_core_data.addr_of_network_in_ram <
-			  p_network_last_run->fw_core_data.addr_of_network_in_ram) &&
-			 (p_network_to_start->fw_core_data.addr_of_network_in_ram +
-				  p_network_to_start->fw_core_data.network_size_in_bytes >
-			  p_network_last_run->fw_core_data.addr_of_network_in_ram))) {
-			/**
-			 * Network addresses in RAM overlap. In this case we mark the last
-			 * execute network as not loaded in RAM so that it can be
-			 * reloaded in RAM when it is scheduled to run again.
-			 */
-			p_network_last_run->fw_core_data.loaded_into_ram = false;
+	if (!p_network_to_start->fw_core_data.loaded_into_ram) {
+		if (p_prefetch_network == p_network_to_start) {
+			/* Only the part not prefetched yet is left to load. */
+			offset             = prefetch_offset;
+			p_prefetch_network = NULL;
 		} else {
-			/**
-			 * In case of no overlaps we leave the last executed network loaded
-			 * in RAM so that it can be reused later when needed.
-			 */
+			/* Nothing runs on the ML engine here, so HRAM can be made. */
+			GARD__ASSERT(make_network_resident(p_network_to_start),
+						 "No HRAM for ML network");
+			offset = 0;
 		}
-	}
-	if (!p_network_to_start->fw_core_data.loaded_into_ram) {
+
 		/**
 		 * Load the network in RAM so that it can be used by ML engine.
 		 */
-		GARD__ASSERT(
-			ospi_read_from_flash(
-				sd,
-				(void *)p_network_to_start->fw_core_data.addr_of_network_in_ram,
-				p_network_to_start->fw_core_data.addr_of_network_in_flash,
-				p_network_to_start->fw_core_data.network_size_in_bytes) ==
-				p_network_to_start->fw_core_data.network_size_in_bytes,
-			"Load ML network failed");
+		(void)load_network_from_offset(
+			p_network_to_start, offset,
+			p_network_to_start->fw_core_data.network_size_in_bytes);
 
 		p_network_to_start->fw_core_data.loaded_into_ram = true;
 	}
@@ -672,22 +1382,31 @@ void start_ml_engine(void)
 	GARD__CLEAR_MOVE_DATA_FROM_SCALER_TO_ML_ENGINE();
 #endif
 
-	/* Setup ML engine to run the new network. */
-	GARD__ML_ENG_CODE_BASE =
-		p_network_to_start->fw_core_data.addr_of_network_in_ram;
+	run_network_on_engine(p_network_to_start);
+}
 
-	gpio_pin_write(&gpio_0, GPIO_PIN_2, GPIO_OUTPUT_HIGH);
-	/* Start ML Engine. */
-	GARD__START_ML_ENGINE();
+/**
+ * start_ml_engine() starts the ML engine to execute the network whose UID is
+ * present in scheduled_network_to_run. If no network is scheduled, which will
+ * happen only when the networks are not registered, then the function will
+ * assert.
+ *
+ * @return None
+ */
+void start_ml_engine(void)
+{
+	GARD__DBG_ASSERT((NULL != p_networks_handler) ||
+						 (INVALID_NETWORK_HANDLE != next_network_to_run),
+					 "Networks not registered");
 
-#ifdef NO_ML_DONE_ISR
-	/* TBD-SRP: To be removed when the ML Done ISR becomes available. */
-	ml_engine_started = true;
-#endif
+	/* The networks queued to run are run from the first one on. */
+	run_queue_running = (0U != run_queue_count);
+	if (run_queue_running) {
+		next_network_to_run = run_queue[0];
+		run_queue_pos       = 1;
+	}
 
-	/* ML Network started. Update local variables to indicate status */
-	currently_running_network = next_network_to_run;
-	last_executed_network     = next_network_to_run;
+	load_and_start_network(get_network_info_for_uid(next_network_to_run));
 
 	/**
 	 * We leave the next_network_to_run to the same network UID, the App Module
@@ -695,6 +1414,26 @@ void start_ml_engine(void)
 	 */
 }
 
+/**
+ * start_ml_engine_on_network() starts the ML engine on a network, leaving the
+ * networks scheduled to run by the App Module as they are. It is used by the
+ * FW Core for the ML runs it drives itself, see run_network_on_rois_async().
+ *
+ * @param network is the UID of the network to run.
+ *
+ * @return None
+ */
+void start_ml_engine_on_network(ml_network_handle_t network)
+{
+	struct network_info *p_network = get_network_info_for_uid(network);
+
+	GARD__DBG_ASSERT(NULL != p_network,
+					 "Network not found in the registered networks");
+	GARD__DBG_ASSERT(!ml_engine_started, "ML engine is busy");
+
+	load_and_start_network(p_network);
+}
+
 /**
  * ml_engine_done_isr() is triggered upon completion of the ML engine's
  * processing of the current network. This function is called by the IRQ handler
@@ -711,8 +1450,31 @@ void ml_engine_done_isr(void *ctx)
 						 (NULL != p_networks_handler->networks),
 					 "Networks not registered");
 
+	pipeline_stats_end(PIPELINE_STATS__ML);
+
 	GARD__CLEAR_ISR();
 
+	push_completed_run(get_network_info_for_uid(currently_running_network));
+	currently_running_network = INVALID_NETWORK_HANDLE;
+
+	if (run_queue_running && (run_queue_pos < run_queue_count)) {
+		/**
+		 * The next network of the queue could not be started from the ML done
+		 * IRQ as it is not loaded in RAM yet, start it now. The frame is not
+		 * done with the ML engine until the queue is.
+		 */
+		next_network_to_run = run_queue[run_queue_pos++];
+		load_and_start_network(get_network_info_for_uid(next_network_to_run));
+		return;
+	}
+
+	if (run_queue_running) {
+		/* The queue is run again on the next frame. */
+		run_queue_running   = false;
+		next_network_to_run = run_queue[0];
+		run_queue_pos       = 1;
+	}
+
 #ifdef ML_APP_HMI
 	if (waiting_to_copy_image) {
 		/**
@@ -730,18 +1492,6 @@ void ml_engine_done_isr(void *ctx)
 	}
 #endif
 
-	/**
-	 * At this point nothing is running on the ML engine, we reflect this state
-	 * of the engine by resetting the currently running network variable.
-	 */
-	currently_running_network = INVALID_NETWORK_HANDLE;
-
-	/**
-	 * Signal to the main loop that ML engine work is complete and any
-	 * processing needed to be done on the output data can be started.
-	 */
-	ml_engine_work_done       = true;
-
 	/* Mark ML completion so pause requests can latch on this boundary. */
 	pipeline_stage_completed(PIPELINE_STAGE_ML_DONE);
 }
@@ -763,6 +1513,79 @@ struct network_info *get_info_of_last_executed_network(void)
 	return get_network_info_for_uid(last_executed_network);
 }
 
+/**
+ * get_network_residency() reports where the registered networks are in HRAM,
+ * for the GET_NETWORK_RESIDENCY host command.
+ *
+ * @param p_resp is the response to fill, but for its data markers.
+ *
+ * @return None
+ */
+void get_network_residency(
+	struct _get_network_residency_response_unpked *p_resp)
+{
+	struct _network_residency_unpked *p_entry;
+	struct network_info              *p_network;
+	uint32_t                          idx;
+
+	p_resp->num_networks       = 0;
+	p_resp->free_bytes         = 0;
+	p_resp->largest_free_bytes = 0;
+
+	for (idx = 0; idx < network_valid_slots; idx++) {
+		p_resp->free_bytes += network_mem_slots[idx].size;
+		if (network_mem_slots[idx].size > p_resp->largest_free_bytes) {
+			p_resp->largest_free_bytes = network_mem_slots[idx].size;
+		}
+	}
+
+	if (NULL == p_networks_handler) {
+		return;
+	}
+
+	for (idx = 0; (idx < p_networks_handler->count_of_networks) &&
+				  (idx < NETWORK_RESIDENCY__MAX_NETWORKS);
+		 idx++) {
+		p_network            = &p_networks_handler->networks[idx];
+		p_entry              = &p_resp->networks[idx];
+
+		p_entry->network     = (uint32_t)p_network->network;
+		p_entry->addr_in_ram = p_network->fw_core_data.addr_of_network_in_ram;
+		p_entry->size        = p_network->fw_core_data.network_size_in_bytes;
+		p_entry->priority    = p_network->residency_priority;
+		p_entry->loads       = p_network->fw_core_data.count_of_loads;
+		p_entry->flags       = 0;
+
+		if (0U != p_entry->addr_in_ram) {
+			p_entry->flags |= NETWORK_RESIDENCY__HAS_RAM;
+		}
+		if (p_network->fw_core_data.loaded_into_ram) {
+			p_entry->flags |= NETWORK_RESIDENCY__LOADED;
+		}
+		if (p_network->network == currently_running_network) {
+			p_entry->flags |= NETWORK_RESIDENCY__RUNNING;
+		}
+		if (p_prefetch_network == p_network) {
+			p_entry->flags |= NETWORK_RESIDENCY__PREFETCHING;
+		}
+		if (p_network->pinned) {
+			p_entry->flags |= NETWORK_RESIDENCY__PINNED;
+		}
+		if (p_network->fw_core_data.swapped_in_ram) {
+			p_entry->flags |= NETWORK_RESIDENCY__SWAPPED;
+		}
+
+		if (0U == p_network->fw_core_data.last_run_seq) {
+			p_entry->runs_since_last_run = 0xFFFFFFFFU;
+		} else {
+			p_entry->runs_since_last_run =
+				ml_run_seq - p_network->fw_core_data.last_run_seq;
+		}
+	}
+
+	p_resp->num_networks = idx;
+}
+
 /**
  * get_ml_engine_status() retrieves the status of the specified ML engine.
  * The function takes an engine ID as input and returns a status code.
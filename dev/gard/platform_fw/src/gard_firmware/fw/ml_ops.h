@@ -9,6 +9,7 @@
 #define ML_OPS_H
 
 #include "gard_types.h"
+#include "gard_hub_iface_unpacked.h"
 
 /**
  * get_info_of_last_executed_network() is used by the FW Core to retrieve the
@@ -16,12 +17,76 @@
  */
 struct network_info *get_info_of_last_executed_network(void);
 
+/**
+ * take_completed_network_run() returns the oldest ML run whose results are
+ * still to be handed to app_ml_done(), NULL if none.
+ */
+struct network_info *take_completed_network_run(void);
+
+/**
+ * chain_next_network_run() is called from the ML done IRQ to start the next
+ * network queued by queue_networks_to_run() right away. It returns false when
+ * the completion is to be handled by ml_engine_done_isr() instead.
+ */
+bool chain_next_network_run(void);
+
+/**
+ * get_network_info_for_uid() returns the network_info of a registered network,
+ * NULL if none has the UID.
+ */
+struct network_info *get_network_info_for_uid(ml_network_handle_t network);
+
+/**
+ * start_ml_engine_on_network() starts the ML engine on a network without
+ * changing the networks scheduled to run by the App Module.
+ */
+void start_ml_engine_on_network(ml_network_handle_t network);
+
 /**
  * ml_engine_done_isr() is the ISR that is triggered when the ML engine
  * completes processing the current network.
  */
 extern void ml_engine_done_isr(void *ctx);
 
+/**
+ * continue_network_prefetch() loads the next slice of the network being
+ * prefetched in the background, see prefetch_network(). It returns false when
+ * there is nothing to prefetch.
+ */
+bool continue_network_prefetch(void);
+
+/**
+ * reserve_network_staging() sets aside HRAM for a network replacing a
+ * registered one, evicting networks if needed. It returns 0 if none can be.
+ */
+uint32_t reserve_network_staging(uint32_t size);
+
+/**
+ * release_network_staging() gives back HRAM from reserve_network_staging()
+ * that was not switched to.
+ */
+void release_network_staging(uint32_t addr, uint32_t size);
+
+/**
+ * switch_network_in_ram() makes a registered network run from a staged copy,
+ * at a frame boundary. It returns false while the network is in use.
+ */
+bool switch_network_in_ram(ml_network_handle_t network,
+						   uint32_t            addr,
+						   uint32_t            size);
+
+/**
+ * network_persisted() tells that a network switched to is now in flash too.
+ */
+void network_persisted(ml_network_handle_t network);
+
+/**
+ * get_network_residency() fills the GET_NETWORK_RESIDENCY response with where
+ * the registered networks are in HRAM, but for its data markers.
+ */
+void get_network_residency(
+	struct _get_network_residency_response_unpked *p_resp);
+
 /**
  * get_ml_engine_status() returns the status of the specified ML engine.
  */
@@ -0,0 +1,344 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "rfs.h"
+#include "ospi_support.h"
+#include "utils.h"
+#include "gard_hub_iface.h"
+#include "fw_globals.h"
+#include "ml_ops.h"
+#include "network_swap.h"
+
+/**
+ * Bytes of the staged network, or of the flash, the CRC is computed over in a
+ * slice.
+ */
+#define NETWORK_SWAP_CRC_SLICE    (4U * 1024U)
+
+/**
+ * Bytes read back from the flash in a slice of the verification.
+ */
+#define NETWORK_SWAP_VERIFY_SLICE (256U)
+
+/**
+ * The steps of the update of the RFS copy, one slice at a time.
+ */
+enum network_swap_phase {
+	NETWORK_SWAP_PHASE__ERASE = 0,  // Erase of its flash sectors
+	NETWORK_SWAP_PHASE__PROGRAM,    // Program of its flash pages
+	NETWORK_SWAP_PHASE__VERIFY,     // CRC of the programmed flash
+};
+
+/**
+ * The state of the swap. ram_addr is the staged network, which becomes the
+ * HRAM of the network once switched to.
+ */
+static struct {
+	enum network_swap_status status;
+	ml_network_handle_t      network;
+	uint32_t                 ram_addr;
+	uint32_t                 size;
+	uint32_t                 crc;  // CRC-32 Host gave
+	bool                     persist;
+	uint32_t                 flash_addr;
+	enum network_swap_phase  phase;
+	uint32_t                 offset;  // Progress of the check or the phase
+	uint32_t                 crc_so_far;
+	uint32_t                 bytes_persisted;
+} swap = {.status = NETWORK_SWAP__IDLE};
+
+static uint8_t verify_buf[NETWORK_SWAP_VERIFY_SLICE] __attribute__((aligned(4)));
+
+/**
+ * network_swap_is_staging() tells if the swap holds HRAM not switched to yet.
+ */
+static bool network_swap_is_staging(void)
+{
+	return (NETWORK_SWAP__STAGED == swap.status) ||
+		   (NETWORK_SWAP__CHECKING == swap.status) ||
+		   (NETWORK_SWAP__PENDING == swap.status);
+}
+
+/**
+ * network_swap_stage() sets aside HRAM for the network Host sends to replace
+ * a registered one. HRAM staged for a previous swap not committed is given
+ * back first.
+ *
+ * @param network is the UID of the registered network to replace.
+ * @param size is the size of the new network in bytes.
+ *
+ * @return Returns true if HRAM is set aside, false if the swap is refused:
+ * another one is in progress, the network is not registered or HRAM cannot
+ * be set aside.
+ */
+bool network_swap_stage(ml_network_handle_t network, uint32_t size)
+{
+	uint32_t addr;
+
+	if ((NETWORK_SWAP__CHECKING == swap.status) ||
+		(NETWORK_SWAP__PENDING == swap.status) ||
+		(NETWORK_SWAP__PERSISTING == swap.status)) {
+		return false;
+	}
+
+	if (NETWORK_SWAP__STAGED == swap.status) {
+		release_network_staging(swap.ram_addr, swap.size);
+	}
+	swap.status = NETWORK_SWAP__IDLE;
+
+	addr        = reserve_network_staging(size);
+	if (0U == addr) {
+		return false;
+	}
+
+	if (NULL == get_network_info_for_uid(network)) {
+		release_network_staging(addr, size);
+		return false;
+	}
+
+	swap.status          = NETWORK_SWAP__STAGED;
+	swap.network         = network;
+	swap.ram_addr        = addr;
+	swap.size            = size;
+	swap.bytes_persisted = 0;
+
+	return true;
+}
+
+/**
+ * network_swap_commit() starts the check of the CRC of the staged network. It
+ * is switched to once checked, see continue_network_swap().
+ *
+ * @param network is the UID given to network_swap_stage().
+ * @param size is the size given to network_swap_stage().
+ * @param crc is the CRC-32 of the new network.
+ * @param persist tells to update the RFS copy of the network once switched
+ * to. The module of the network has to be of size bytes and start at a flash
+ * sector, as it keeps its place and size in the RFS.
+ *
+ * @return Returns true if the check is started, false if the commit is
+ * refused.
+ */
+bool network_swap_commit(ml_network_handle_t network,
+						 uint32_t            size,
+						 uint32_t            crc,
+						 bool                persist)
+{
+	uint32_t module_size;
+
+	if ((NETWORK_SWAP__STAGED != swap.status) || (network != swap.network) ||
+		(size != swap.size)) {
+		return false;
+	}
+
+	if (persist &&
+		(!locate_module_id(sd, network, &swap.flash_addr, &module_size) ||
+		 (module_size != size) ||
+		 (0U != (swap.flash_addr % OSPI_FLASH_SECTOR_SIZE)))) {
+		return false;
+	}
+
+	swap.status     = NETWORK_SWAP__CHECKING;
+	swap.crc        = crc;
+	swap.persist    = persist;
+	swap.offset     = 0;
+	swap.crc_so_far = 0;
+
+	return true;
+}
+
+/**
+ * network_swap_abort() drops a swap not switched to yet, giving its HRAM back,
+ * or clears the report of a swap done or failed.
+ *
+ * @return Returns true if dropped, false while the RFS copy is being updated.
+ */
+bool network_swap_abort(void)
+{
+	if (NETWORK_SWAP__PERSISTING == swap.status) {
+		return false;
+	}
+
+	if (network_swap_is_staging()) {
+		release_network_staging(swap.ram_addr, swap.size);
+	}
+	swap.status = NETWORK_SWAP__IDLE;
+
+	return true;
+}
+
+/**
+ * network_swap_get_info() reports the swap.
+ *
+ * @param p_info is filled with the swap, staging_address 0 unless HRAM is set
+ * aside and not switched to yet.
+ *
+ * @return None
+ */
+void network_swap_get_info(struct network_swap_info *p_info)
+{
+	memset(p_info, 0, sizeof(*p_info));
+
+	p_info->status = (uint8_t)swap.status;
+	if (NETWORK_SWAP__IDLE == swap.status) {
+		return;
+	}
+
+	p_info->network         = (uint32_t)swap.network;
+	p_info->bytes_persisted = swap.bytes_persisted;
+	if (network_swap_is_staging()) {
+		p_info->staging_address = swap.ram_addr;
+		p_info->staging_size    = swap.size;
+	}
+}
+
+/**
+ * network_swap_next_phase() moves the update of the RFS copy to the given
+ * phase.
+ */
+static void network_swap_next_phase(enum network_swap_phase phase)
+{
+	swap.phase      = phase;
+	swap.offset     = 0;
+	swap.crc_so_far = 0;
+}
+
+/**
+ * continue_network_persist() runs a slice of the update of the RFS copy of
+ * the network switched to: the erase of a sector, the program of a page, or
+ * the CRC of a slice read back. While the flash is busy with an erase or a
+ * program, the slice only polls it.
+ *
+ * @return None
+ */
+static void continue_network_persist(void)
+{
+	const uint8_t *p_data = (const uint8_t *)(uintptr_t)swap.ram_addr;
+	uint32_t       bytes;
+
+	if (ospi_is_flash_busy(sd)) {
+		return;
+	}
+
+	switch (swap.phase) {
+	case NETWORK_SWAP_PHASE__ERASE:
+		if (swap.offset >= swap.size) {
+			network_swap_next_phase(NETWORK_SWAP_PHASE__PROGRAM);
+			break;
+		}
+
+		if (!ospi_erase_sector_async(sd, swap.flash_addr + swap.offset)) {
+			swap.status = NETWORK_SWAP__FAILED;
+			break;
+		}
+		swap.offset += OSPI_FLASH_SECTOR_SIZE;
+		break;
+
+	case NETWORK_SWAP_PHASE__PROGRAM:
+		if (swap.offset == swap.size) {
+			network_swap_next_phase(NETWORK_SWAP_PHASE__VERIFY);
+			break;
+		}
+
+		// The module starts at a sector, its pages are aligned to the flash.
+		bytes = MIN(OSPI_FLASH_PAGE_SIZE, swap.size - swap.offset);
+		if (!ospi_program_page_async(
+				sd, (const uint32_t *)&p_data[swap.offset],
+				swap.flash_addr + swap.offset, bytes)) {
+			swap.status = NETWORK_SWAP__FAILED;
+			break;
+		}
+		swap.offset += bytes;
+		break;
+
+	case NETWORK_SWAP_PHASE__VERIFY:
+		bytes = MIN(sizeof(verify_buf), swap.size - swap.offset);
+		if (ospi_read_from_flash(sd, verify_buf,
+								 swap.flash_addr + swap.offset,
+								 bytes) != bytes) {
+			swap.status = NETWORK_SWAP__FAILED;
+			break;
+		}
+		swap.crc_so_far = crc32_update(swap.crc_so_far, verify_buf, bytes);
+		swap.offset += bytes;
+		swap.bytes_persisted = swap.offset;
+
+		if (swap.offset == swap.size) {
+			if (swap.crc_so_far != swap.crc) {
+				swap.status = NETWORK_SWAP__FAILED;
+				break;
+			}
+
+			// The network can be evicted and loaded from flash again.
+			network_persisted(swap.network);
+			swap.status = NETWORK_SWAP__PERSISTED;
+		}
+		break;
+
+	default:
+		GARD__DBG_ASSERT(0, "Invalid network swap phase");
+		break;
+	}
+}
+
+/**
+ * continue_network_swap() runs a slice of the swap: the CRC of a slice of the
+ * staged network, its switch once the network is idle, or a slice of the
+ * update of its RFS copy. A failed update leaves the network switched to but
+ * held in HRAM, as its flash copy is not usable.
+ *
+ * @return Returns true if it did some work, false if there was nothing to do
+ * or the network is still in use.
+ */
+bool continue_network_swap(void)
+{
+	const uint8_t *p_data = (const uint8_t *)(uintptr_t)swap.ram_addr;
+	uint32_t       bytes;
+
+	switch (swap.status) {
+	case NETWORK_SWAP__CHECKING:
+		bytes = MIN(NETWORK_SWAP_CRC_SLICE, swap.size - swap.offset);
+		swap.crc_so_far =
+			crc32_update(swap.crc_so_far, &p_data[swap.offset], bytes);
+		swap.offset += bytes;
+
+		if (swap.offset == swap.size) {
+			if (swap.crc_so_far != swap.crc) {
+				release_network_staging(swap.ram_addr, swap.size);
+				swap.status = NETWORK_SWAP__FAILED;
+				break;
+			}
+			swap.status = NETWORK_SWAP__PENDING;
+		}
+		break;
+
+	case NETWORK_SWAP__PENDING:
+		// Tried again after the ML done IRQ wakes the main loop up.
+		if (!switch_network_in_ram(swap.network, swap.ram_addr, swap.size)) {
+			return false;
+		}
+
+		if (swap.persist) {
+			swap.status = NETWORK_SWAP__PERSISTING;
+			network_swap_next_phase(NETWORK_SWAP_PHASE__ERASE);
+		} else {
+			swap.status = NETWORK_SWAP__SWAPPED;
+		}
+		break;
+
+	case NETWORK_SWAP__PERSISTING:
+		continue_network_persist();
+		break;
+
+	default:
+		return false;
+	}
+
+	return true;
+}
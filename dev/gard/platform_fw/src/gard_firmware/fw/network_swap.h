@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef NETWORK_SWAP_H
+#define NETWORK_SWAP_H
+
+#include "gard_types.h"
+#include "network_info.h"
+
+/**
+ * This file defines the swap of a registered network behind SWAP_NETWORK. The
+ * network Host stages in HRAM is checked and switched to at a frame boundary,
+ * and its RFS copy updated, by a main loop task a slice at a time, so that
+ * the ML runs go on with the previous network in the meantime.
+ */
+
+/**
+ * The swap as reported to Host, see swap_network_response.
+ */
+struct network_swap_info {
+	uint8_t  status;           // enum network_swap_status
+	uint32_t network;          // UID of the network swapped
+	uint32_t staging_address;  // HRAM set aside, 0 if none
+	uint32_t staging_size;     // Bytes set aside
+	uint32_t bytes_persisted;  // Of the RFS copy
+};
+
+/**
+ * network_swap_stage() sets aside HRAM for a network of size bytes replacing
+ * the registered one. It returns false if the swap is refused.
+ */
+bool network_swap_stage(ml_network_handle_t network, uint32_t size);
+
+/**
+ * network_swap_commit() starts the check of the staged network and its switch.
+ * It returns false if the commit is refused.
+ */
+bool network_swap_commit(ml_network_handle_t network,
+						 uint32_t            size,
+						 uint32_t            crc,
+						 bool                persist);
+
+/**
+ * network_swap_abort() drops a swap not switched to yet, or clears the report
+ * of one done. It returns false while the RFS copy is being updated.
+ */
+bool network_swap_abort(void);
+
+/**
+ * network_swap_get_info() reports the swap.
+ */
+void network_swap_get_info(struct network_swap_info *p_info);
+
+/**
+ * continue_network_swap() runs a slice of the check, switch or RFS update of
+ * the swap. It returns true if it did some work, false if there was nothing
+ * to do.
+ */
+bool continue_network_swap(void);
+
+#endif /* NETWORK_SWAP_H */
@@ -11,7 +11,11 @@
 #include "fw_globals.h"
 #include "memmap.h"
 #include "utils.h"
+#include "hw_regs.h"
+#include "irq_support.h"
 #include "pipeline_ops.h"
+#include "ml_ops.h"
+#include "camera_capture.h"
 
 /**
  * This file defines the ML operations related interfaces
@@ -49,65 +53,169 @@
 	})
 
 /**
- * pause_pipeline_execution_async() records the requested pause trigger so the
- * pipeline can stall once the matching stage completes.
+ * struct pipeline_pause_hold is the pause of one owner of the pipeline.
+ */
+struct pipeline_pause_hold {
+	enum pipeline_pause_trigger trigger;      // PIPELINE_PAUSE_NONE if none
+	uint32_t                    frames_left;  // Triggers let through first
+	bool                        holding;      // Pipeline is paused for owner
+};
+
+static struct pipeline_pause_hold pause_holds[PIPELINE_PAUSE_OWNER__NB];
+
+/**
+ * update_pipeline_state() derives the pipeline state from the pauses of all
+ * owners: paused if any holds it, pending if any waits for its trigger and
+ * running otherwise. It is called with the interrupts disabled.
  *
- * @param pause_request Requested stage trigger that should cause the pipeline
- *                      to pause. Use values from enum pipeline_pause_trigger.
+ * @param None
  *
  * @return None
  */
-void pause_pipeline_execution_async(enum pipeline_pause_trigger pause_request)
+static void update_pipeline_state(void)
 {
+	enum pipeline_pause_trigger pending = PIPELINE_PAUSE_NONE;
+	bool                        holding = false;
+	uint32_t                    owner;
+
+	for (owner = 0; owner < PIPELINE_PAUSE_OWNER__NB; owner++) {
+		if (pause_holds[owner].holding) {
+			holding = true;
+		} else if ((PIPELINE_PAUSE_NONE == pending) &&
+				   (PIPELINE_PAUSE_NONE != pause_holds[owner].trigger)) {
+			pending = pause_holds[owner].trigger;
+		}
+	}
+
+	/* The request of the first owner still waiting, for diagnostics. */
+	ml_pipeline_pause_request = pending;
+
+	if (holding) {
+		ml_pipeline_state = PIPELINE_PAUSED;
+	} else if (PIPELINE_PAUSE_NONE != pending) {
+		ml_pipeline_state     = PIPELINE_PAUSE_PENDING;
+		ml_pipeline_paused_at = PIPELINE_STAGE_UNKNOWN;
+	} else {
+		ml_pipeline_state     = PIPELINE_RUNNING;
+		ml_pipeline_paused_at = PIPELINE_STAGE_UNKNOWN;
+	}
+}
+
+/**
+ * pause_pipeline_for() records the pause of owner so the pipeline can stall
+ * once the matching stage completes. The stage is let through after_frames
+ * times first, e.g. for the App Module to take a few more results before the
+ * pipeline stops. Pausing again replaces the pending pause of owner.
+ *
+ * If the pipeline is already paused for another owner, a pause with no frames
+ * to let through holds it right away.
+ *
+ * @param owner is who pauses the pipeline.
+ * @param when is the stage trigger that should cause the pipeline to pause.
+ *             Use values from enum pipeline_pause_trigger.
+ * @param after_frames is the count of completions of the stage to let
+ *                     through before pausing.
+ *
+ * @return None
+ */
+void pause_pipeline_for(enum pipeline_pause_owner   owner,
+						enum pipeline_pause_trigger when,
+						uint32_t                    after_frames)
+{
+	struct pipeline_pause_hold *p_hold;
+	uint32_t                    irq_state;
+
 	/* Pause Request invalid */
-	GARD__DBG_ASSERT(PIPELINE_PAUSE_NONE != pause_request,
+	GARD__DBG_ASSERT((PIPELINE_PAUSE_NONE != when) &&
+						 (owner < PIPELINE_PAUSE_OWNER__NB),
 					 "Invalid pause request");
 
-	/* Already paused at the requested stage; nothing to do. */
-	if (PIPELINE_PAUSED == ml_pipeline_state) {
-		return;
-	}
+	p_hold    = &pause_holds[owner];
+	irq_state = irq_save();
+
+	if (!p_hold->holding) {
+		p_hold->trigger     = when;
+		p_hold->frames_left = after_frames;
+
+		/* Already paused for another owner; hold it there. */
+		if ((PIPELINE_PAUSED == ml_pipeline_state) && (0U == after_frames)) {
+			p_hold->holding = true;
+		}
 
-	/* Record the desired trigger so the matching stage can honor it. */
-	ml_pipeline_pause_request = pause_request;
+		update_pipeline_state();
+	}
 
-	/* Transition into pending state until the requested stage completes. */
-	ml_pipeline_state         = PIPELINE_PAUSE_PENDING;
-	ml_pipeline_paused_at     = PIPELINE_STAGE_UNKNOWN;
+	irq_restore(irq_state);
 }
 
 /**
- * resume_pipeline_async() clears any outstanding pause request and transitions
- * the ML pipeline back to running state. If no stages are currently active,
- * this function kicks off a fresh image capture to resume processing.
+ * resume_pipeline_for() clears the pause of owner. Once no owner holds or
+ * waits to pause the pipeline it is back to running state: the image captured
+ * while it was paused, see prearm_capture_on_pause(), is rescaled right away.
+ * Failing that, if no stages are currently active, a fresh image capture is
+ * started to resume processing.
  *
- * @param None
+ * @param owner is who resumes the pipeline.
  *
  * @return None
  */
-void resume_pipeline_async(void)
+void resume_pipeline_for(enum pipeline_pause_owner owner)
 {
-	bool restart_pipeline = false;
+	enum pipeline_state previous_state;
+	bool                restart_pipeline;
+	uint32_t            irq_state;
+
+	GARD__DBG_ASSERT(owner < PIPELINE_PAUSE_OWNER__NB, "Invalid pause owner");
 
-	/* Nothing to resume if the pipeline never paused. */
-	if (PIPELINE_RUNNING == ml_pipeline_state) {
+	irq_state                  = irq_save();
+	previous_state             = ml_pipeline_state;
+
+	pause_holds[owner].trigger = PIPELINE_PAUSE_NONE;
+	pause_holds[owner].holding = false;
+	update_pipeline_state();
+
+	restart_pipeline = (PIPELINE_RUNNING != previous_state) &&
+					   (PIPELINE_RUNNING == ml_pipeline_state);
+	irq_restore(irq_state);
+
+	/* Nothing to resume if the pipeline never paused or is still held. */
+	if (!restart_pipeline) {
 		return;
 	}
 
-	/* Check whether all stages are idle so we know if we must restart capture.
-	 */
-	restart_pipeline          = !GARD__IS_PIPELINE_ACTIVE();
+	/* Pick up the image captured while paused, else start a fresh capture. */
+	if (!start_prearmed_capture()) {
+		if (!GARD__IS_PIPELINE_ACTIVE()) {
+			capture_image_async();
+		}
+	}
+}
 
-	/* Clear the pause request/state regardless of whether we restart work. */
-	ml_pipeline_pause_request = PIPELINE_PAUSE_NONE;
-	ml_pipeline_paused_at     = PIPELINE_STAGE_UNKNOWN;
-	ml_pipeline_state         = PIPELINE_RUNNING;
+/**
+ * pause_pipeline_execution_async() records the requested pause trigger so the
+ * pipeline can stall once the matching stage completes.
+ *
+ * @param pause_request Requested stage trigger that should cause the pipeline
+ *                      to pause. Use values from enum pipeline_pause_trigger.
+ *
+ * @return None
+ */
+void pause_pipeline_execution_async(enum pipeline_pause_trigger pause_request)
+{
+	pause_pipeline_for(PIPELINE_PAUSE_OWNER__HOST, pause_request, 0U);
+}
 
-	/* If no work is currently active, kick the pipeline with a fresh capture.
-	 */
-	if (restart_pipeline) {
-		capture_image_async();
-	}
+/**
+ * resume_pipeline_async() clears the pause request of Host and transitions the
+ * ML pipeline back to running state, unless another owner still holds it.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void resume_pipeline_async(void)
+{
+	resume_pipeline_for(PIPELINE_PAUSE_OWNER__HOST);
 }
 
 /**
@@ -126,7 +234,8 @@ bool is_pipeline_execution_paused(void)
 /**
  * pipeline_stage_completed() is invoked when a pipeline stage finishes
  * (capture, rescale, ML, or post-processing). It updates bookkeeping and
- * applies a pending pause request if the completed stage matches the trigger.
+ * applies the pending pauses whose trigger matches the completed stage, once
+ * they let through their frames.
  *
  * @param completed_stage is the identifier for the stage that has completed.
  *
@@ -134,7 +243,9 @@ bool is_pipeline_execution_paused(void)
  */
 void pipeline_stage_completed(enum pipeline_stage_id completed_stage)
 {
-	enum pipeline_stage_id requested_stage;
+	struct pipeline_pause_hold *p_hold;
+	uint32_t                    owner;
+	uint32_t                    irq_state;
 
 	GARD__DBG_ASSERT(PIPELINE_STAGE_UNKNOWN != completed_stage,
 					 "Invalid pipeline stage completion");
@@ -147,20 +258,146 @@ void pipeline_stage_completed(enum pipeline_stage_id completed_stage)
 		return;
 	}
 
-	/* ASAP pauses latch on the very next stage that reports completion. */
-	if (PIPELINE_PAUSE_ASAP == ml_pipeline_pause_request) {
-		ml_pipeline_state     = PIPELINE_PAUSED;
+	irq_state = irq_save();
+
+	for (owner = 0; owner < PIPELINE_PAUSE_OWNER__NB; owner++) {
+		p_hold = &pause_holds[owner];
+		if ((PIPELINE_PAUSE_NONE == p_hold->trigger) || p_hold->holding) {
+			continue;
+		}
+
+		/* ASAP pauses latch on the very next stage that reports completion. */
+		if ((PIPELINE_PAUSE_ASAP != p_hold->trigger) &&
+			(completed_stage !=
+			 GARD__TRACE_COMPLETION_STAGE_POST_PAUSE(p_hold->trigger))) {
+			continue;
+		}
+
+		if (0U != p_hold->frames_left) {
+			p_hold->frames_left--;
+			continue;
+		}
+
+		p_hold->holding       = true;
 		ml_pipeline_paused_at = completed_stage;
-		return;
 	}
 
-	/* If the requested stage is valid and the completed stage matches the
-	 * requested stage, then pause the pipeline */
-	requested_stage =
-		GARD__TRACE_COMPLETION_STAGE_POST_PAUSE(ml_pipeline_pause_request);
+	update_pipeline_state();
 
-	if (completed_stage == requested_stage) {
-		ml_pipeline_state     = PIPELINE_PAUSED;
-		ml_pipeline_paused_at = completed_stage;
+	irq_restore(irq_state);
+}
+
+/**
+ * Done IRQ line of every pipeline event, in the order of the event bits.
+ */
+static const uint32_t pipeline_event_irqs[] = {
+	GARD__CAPTURE_STAGE_DONE_IRQ,
+	GARD__RESCALE_STAGE_DONE_IRQ,
+	GARD__ML_ENG_DONE_IRQ,
+};
+
+/* Events posted by the done ISRs, not yet taken by the main loop */
+static volatile uint32_t pipeline_events;
+
+/**
+ * pipeline_event_irq() returns the done IRQ line of an event.
+ *
+ * @param event is a single event bit.
+ *
+ * @return The IRQ line of the event.
+ */
+static uint32_t pipeline_event_irq(enum pipeline_event event)
+{
+	return pipeline_event_irqs[__builtin_ctz((uint32_t)event)];
+}
+
+/**
+ * pipeline_done_isr() is the ISR of all the done IRQs of the pipeline engines.
+ * The completion is still pending at the engine until its done handler runs in
+ * the main loop, so the IRQ is masked and the event posted for the main loop.
+ * The ML done of a network queued to run after another one that is loaded in
+ * RAM is completed here instead, and the next network started right away.
+ *
+ * @param ctx is the event of the IRQ.
+ *
+ * @return None
+ */
+static void pipeline_done_isr(void *ctx)
+{
+	enum pipeline_event event = (enum pipeline_event)(uintptr_t)ctx;
+
+	if ((PIPELINE_EVENT_ML_DONE == event) && chain_next_network_run()) {
+		return;
 	}
+
+	irq_source_disable(pipeline_event_irq(event));
+	pipeline_events |= (uint32_t)event;
+}
+
+/**
+ * pipeline_irqs_init() registers the ISRs of the done IRQs of the pipeline
+ * engines that are not polled. It is to be called after irq_support_init().
+ *
+ * @param None
+ *
+ * @return None
+ */
+void pipeline_irqs_init(void)
+{
+	pipeline_events = 0;
+
+#if !defined(NO_CAPTURE_DONE_ISR) && defined(ML_APP_MOD)
+	GARD__DBG_ASSERT(irq_register_isr(GARD__CAPTURE_STAGE_DONE_IRQ,
+									  pipeline_done_isr,
+									  (void *)PIPELINE_EVENT_CAPTURE_DONE),
+					 "Capture done IRQ registration failed");
+#endif
+
+#ifndef NO_RESCALE_DONE_ISR
+	GARD__DBG_ASSERT(irq_register_isr(GARD__RESCALE_STAGE_DONE_IRQ,
+									  pipeline_done_isr,
+									  (void *)PIPELINE_EVENT_RESCALE_DONE),
+					 "Rescale done IRQ registration failed");
+#endif
+
+#ifndef NO_ML_DONE_ISR
+	GARD__DBG_ASSERT(irq_register_isr(GARD__ML_ENG_DONE_IRQ, pipeline_done_isr,
+									  (void *)PIPELINE_EVENT_ML_DONE),
+					 "ML done IRQ registration failed");
+#endif
+}
+
+/**
+ * pipeline_event_take() returns whether the event was posted by its done ISR,
+ * clearing it. The event stays masked until pipeline_event_rearm().
+ *
+ * @param event is a single event bit.
+ *
+ * @return true if the event was posted, false otherwise.
+ */
+bool pipeline_event_take(enum pipeline_event event)
+{
+	uint32_t irq_state;
+	bool     posted;
+
+	irq_state = irq_save();
+	posted    = (0U != (pipeline_events & (uint32_t)event));
+	pipeline_events &= ~(uint32_t)event;
+	irq_restore(irq_state);
+
+	return posted;
+}
+
+/**
+ * pipeline_event_rearm() unmasks the done IRQ of an event again. It is to be
+ * called once the done handler cleared the completion at the engine, else the
+ * IRQ would come right back.
+ *
+ * @param event is a single event bit.
+ *
+ * @return None
+ */
+void pipeline_event_rearm(enum pipeline_event event)
+{
+	irq_source_enable(pipeline_event_irq(event));
 }
@@ -30,6 +30,16 @@ enum pipeline_pause_trigger {
 	PIPELINE_PAUSE_ON_ML_POST_PROCESSING_DONE,
 };
 
+/**
+ * enum pipeline_pause_owner lists who can hold the pipeline paused. Each owner
+ * pauses and resumes on its own, the pipeline runs again once none holds it.
+ */
+enum pipeline_pause_owner {
+	PIPELINE_PAUSE_OWNER__HOST = 0,  // Host commands, e.g. image capture
+	PIPELINE_PAUSE_OWNER__APP,       // App Module
+	PIPELINE_PAUSE_OWNER__NB,
+};
+
 /**
  * enum pipeline_stage_id represents the physical stages that raise completion
  * events. This is similar to the pause triggers but does not include the ASAP
@@ -43,6 +53,16 @@ enum pipeline_stage_id {
 	PIPELINE_STAGE_ML_POST_PROCESSING_DONE,
 };
 
+/**
+ * enum pipeline_event are the stage completions posted by the done IRQs of the
+ * pipeline engines, to be handled by the main loop.
+ */
+enum pipeline_event {
+	PIPELINE_EVENT_CAPTURE_DONE = (1U << 0),
+	PIPELINE_EVENT_RESCALE_DONE = (1U << 1),
+	PIPELINE_EVENT_ML_DONE      = (1U << 2),
+};
+
 /**
  * enum pipeline_state captures the coarse pause state for the ML pipeline.
  */
@@ -56,16 +76,32 @@ enum pipeline_state {
  * pause_pipeline_execution_async() marks the requested stage at which the
  * pipeline should transition to a paused state. The hardware continues running
  * until the specified stage completes (or the next stage if ASAP is selected).
+ * It is the pause of PIPELINE_PAUSE_OWNER__HOST.
  */
 void pause_pipeline_execution_async(enum pipeline_pause_trigger when);
 
 /**
  * resume_pipeline_async() clears the pause request and schedules the pipeline
  * to restart when the hardware reaches a safe point (i.e. resumption is not
- * instantaneous if engines are still running).
+ * instantaneous if engines are still running). It resumes the pause of
+ * PIPELINE_PAUSE_OWNER__HOST.
  */
 void resume_pipeline_async(void);
 
+/**
+ * pause_pipeline_for() makes owner hold the pipeline paused once the stage of
+ * when has completed after_frames + 1 times.
+ */
+void pause_pipeline_for(enum pipeline_pause_owner   owner,
+						enum pipeline_pause_trigger when,
+						uint32_t                    after_frames);
+
+/**
+ * resume_pipeline_for() drops the pause of owner, the pipeline resumes when no
+ * other owner holds it.
+ */
+void resume_pipeline_for(enum pipeline_pause_owner owner);
+
 /**
  * is_pipeline_execution_paused() reports whether the pipeline has transitioned
  * to the paused state.
@@ -79,4 +115,21 @@ bool is_pipeline_execution_paused(void);
  */
 void pipeline_stage_completed(enum pipeline_stage_id completed_stage);
 
+/**
+ * pipeline_irqs_init() registers the ISRs of the done IRQs of the pipeline
+ * engines that are not polled (see the NO_*_DONE_ISR defines).
+ */
+void pipeline_irqs_init(void);
+
+/**
+ * pipeline_event_take() returns whether the event was posted, clearing it.
+ */
+bool pipeline_event_take(enum pipeline_event event);
+
+/**
+ * pipeline_event_rearm() unmasks the done IRQ of an event again, once its done
+ * handler has cleared the completion at the engine.
+ */
+void pipeline_event_rearm(enum pipeline_event event);
+
 #endif /* PIPELINE_OPS_H */
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "pipeline_stats.h"
+
+/**
+ * Timing of one stage: the statistics and the start of the stage in progress.
+ */
+struct pipeline_stage_timing {
+	struct _pipeline_stage_stats_unpked stats;
+	uint64_t                            started_at;
+	bool                                started;
+};
+
+static struct pipeline_stage_timing stage_timings[PIPELINE_STATS__NUM_STAGES];
+
+/**
+ * pipeline_stats_start() records the start of a stage. Starting a stage
+ * already in progress restarts it.
+ *
+ * @param stage is the stage that starts.
+ *
+ * @return None
+ */
+void pipeline_stats_start(enum pipeline_stats_stages stage)
+{
+	GARD__DBG_ASSERT(stage < PIPELINE_STATS__NUM_STAGES, "Invalid stage");
+
+	stage_timings[stage].started_at = pipeline_stats_now();
+	stage_timings[stage].started    = true;
+}
+
+/**
+ * pipeline_stats_end() accounts the duration of a stage since its
+ * pipeline_stats_start().
+ *
+ * @param stage is the stage that completes.
+ *
+ * @return None
+ */
+void pipeline_stats_end(enum pipeline_stats_stages stage)
+{
+	GARD__DBG_ASSERT(stage < PIPELINE_STATS__NUM_STAGES, "Invalid stage");
+
+	if (!stage_timings[stage].started) {
+		return;
+	}
+
+	stage_timings[stage].started = false;
+	pipeline_stats_add(stage,
+					   pipeline_stats_now() - stage_timings[stage].started_at);
+}
+
+/**
+ * pipeline_stats_mark() accounts the time since the previous mark of a stage
+ * and starts the next period. The first mark only starts a period.
+ *
+ * @param stage is the stage whose period is measured.
+ *
+ * @return None
+ */
+void pipeline_stats_mark(enum pipeline_stats_stages stage)
+{
+	pipeline_stats_end(stage);
+	pipeline_stats_start(stage);
+}
+
+/**
+ * pipeline_stats_add() accounts one duration of a stage.
+ *
+ * @param stage is the stage the duration is of.
+ * @param cycles is the duration in CPU cycles.
+ *
+ * @return None
+ */
+void pipeline_stats_add(enum pipeline_stats_stages stage, uint64_t cycles)
+{
+	struct _pipeline_stage_stats_unpked *p_stats;
+
+	GARD__DBG_ASSERT(stage < PIPELINE_STATS__NUM_STAGES, "Invalid stage");
+
+	p_stats = &stage_timings[stage].stats;
+	if ((0U == p_stats->count) || (cycles < p_stats->min_cycles)) {
+		p_stats->min_cycles = cycles;
+	}
+	if (cycles > p_stats->max_cycles) {
+		p_stats->max_cycles = cycles;
+	}
+	p_stats->total_cycles += cycles;
+	p_stats->count++;
+}
+
+/**
+ * pipeline_stats_get() copies the statistics of all the stages.
+ *
+ * @param stats is filled with the statistics, in enum pipeline_stats_stages
+ *              order.
+ *
+ * @return None
+ */
+void pipeline_stats_get(
+	struct _pipeline_stage_stats_unpked stats[PIPELINE_STATS__NUM_STAGES])
+{
+	uint32_t stage;
+
+	for (stage = 0; stage < PIPELINE_STATS__NUM_STAGES; stage++) {
+		stats[stage] = stage_timings[stage].stats;
+	}
+}
+
+/**
+ * pipeline_stats_total_cycles() returns the time accounted for a stage.
+ *
+ * @param stage is the stage the time is of.
+ *
+ * @return the total duration of the stage in CPU cycles.
+ */
+uint64_t pipeline_stats_total_cycles(enum pipeline_stats_stages stage)
+{
+	GARD__DBG_ASSERT(stage < PIPELINE_STATS__NUM_STAGES, "Invalid stage");
+
+	return stage_timings[stage].stats.total_cycles;
+}
+
+/**
+ * pipeline_stats_reset() clears the statistics of all the stages.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void pipeline_stats_reset(void)
+{
+	uint32_t stage;
+
+	for (stage = 0; stage < PIPELINE_STATS__NUM_STAGES; stage++) {
+		stage_timings[stage].stats.count        = 0;
+		stage_timings[stage].stats.min_cycles   = 0;
+		stage_timings[stage].stats.max_cycles   = 0;
+		stage_timings[stage].stats.total_cycles = 0;
+	}
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef PIPELINE_STATS_H
+#define PIPELINE_STATS_H
+
+#include "gard_types.h"
+#include "sys_platform.h"
+#include "gard_hub_iface_unpacked.h"
+
+/**
+ * This file defines the timing statistics kept for the stages of the
+ * capture / rescale / ML pipeline, see enum pipeline_stats_stages. They are
+ * read by Host with GET_PIPELINE_STATS.
+ */
+
+/* CPU cycles per microsecond, the CPU clock being given in MHz */
+#define PIPELINE_STATS_CYCLES_PER_US ((uint32_t)RISCV_RX0_INST_SYS_CLOCK_FREQ)
+
+/**
+ * pipeline_stats_now() returns the CPU cycle counter (mcycle).
+ */
+static inline uint64_t pipeline_stats_now(void)
+{
+	uint32_t hi, lo, hi2;
+
+	do {
+		__asm__ volatile("csrr %0, mcycleh" : "=r"(hi));
+		__asm__ volatile("csrr %0, mcycle" : "=r"(lo));
+		__asm__ volatile("csrr %0, mcycleh" : "=r"(hi2));
+	} while (hi != hi2);
+
+	return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * pipeline_stats_start() records the start of a stage.
+ */
+void pipeline_stats_start(enum pipeline_stats_stages stage);
+
+/**
+ * pipeline_stats_end() accounts the duration of a stage since its
+ * pipeline_stats_start(). It is ignored if the stage was not started.
+ */
+void pipeline_stats_end(enum pipeline_stats_stages stage);
+
+/**
+ * pipeline_stats_mark() accounts the time since the previous mark of a stage,
+ * i.e. the period of a recurring event, and starts the next period.
+ */
+void pipeline_stats_mark(enum pipeline_stats_stages stage);
+
+/**
+ * pipeline_stats_add() accounts one duration of a stage measured by the
+ * caller.
+ */
+void pipeline_stats_add(enum pipeline_stats_stages stage, uint64_t cycles);
+
+/**
+ * pipeline_stats_get() copies the statistics of all the stages.
+ */
+void pipeline_stats_get(
+	struct _pipeline_stage_stats_unpked stats[PIPELINE_STATS__NUM_STAGES]);
+
+/**
+ * pipeline_stats_total_cycles() returns the time accounted for a stage since
+ * the last pipeline_stats_reset().
+ */
+uint64_t pipeline_stats_total_cycles(enum pipeline_stats_stages stage);
+
+/**
+ * pipeline_stats_reset() clears the statistics of all the stages. Stages in
+ * progress are still accounted when they end.
+ */
+void pipeline_stats_reset(void);
+
+#endif /* PIPELINE_STATS_H */
@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "assert.h"
+#include "utils.h"
+#include "fw_core.h"
+#include "fw_globals.h"
+#include "hw_regs.h"
+#include "ml_ops.h"
+#include "camera_capture.h"
+#include "roi_batch.h"
+
+/**
+ * The batch in progress, see run_network_on_rois_async(). p_batch_network is
+ * the network run on the ROIs, NULL when no batch is in progress, and
+ * batch_roi the index of the ROI being rescaled or run.
+ */
+static struct roi_batch     batch;
+static struct roi_box       batch_rois[ROI_BATCH_MAX_ROIS];
+static struct network_info *p_batch_network  = NULL;
+static uint32_t             batch_roi        = 0;
+static bool                 capture_deferred = false;
+
+/**
+ * run_network_on_rois_async() starts running a network on a batch of ROIs of
+ * the captured image, see fw_core.h.
+ *
+ * @param p_batch is the batch to run.
+ *
+ * @return true if the batch was started, false otherwise.
+ */
+bool run_network_on_rois_async(const struct roi_batch *p_batch)
+{
+	struct network_info *p_network;
+	uint32_t             idx;
+
+	if ((NULL == p_batch) || (NULL != p_batch_network) ||
+		(NULL == p_batch->p_rois) || (NULL == p_batch->p_results) ||
+		(NULL == p_batch->done_cb) || (0U == p_batch->count_of_rois) ||
+		(p_batch->count_of_rois > ROI_BATCH_MAX_ROIS)) {
+		return false;
+	}
+
+	p_network = get_network_info_for_uid(p_batch->network);
+	if ((NULL == p_network) ||
+		(USING_INTERNAL_BUFFERS == p_network->inout_offset) ||
+		(p_batch->result_size > p_network->inout_size) ||
+		((get_capture_planes() * p_batch->in_width * p_batch->in_height) >
+		 p_network->inout_size)) {
+		return false;
+	}
+
+	/**
+	 * The captured image must stay in the capture buffer and the ML engine
+	 * must be left to the batch, see fw_core.h.
+	 */
+	if (capture_started || rescaling_started || ml_engine_started ||
+		ml_engine_work_done) {
+		return false;
+	}
+
+	batch = *p_batch;
+	for (idx = 0; idx < p_batch->count_of_rois; idx++) {
+		batch_rois[idx] = p_batch->p_rois[idx];
+	}
+	batch.p_rois = batch_rois;
+	batch_roi    = 0;
+
+	if (!start_roi_rescale(&batch_rois[0], batch.in_width, batch.in_height,
+						   p_network->inout_offset)) {
+		return false;
+	}
+	p_batch_network = p_network;
+
+	return true;
+}
+
+/**
+ * is_roi_batch_active() tells if a batch of ROIs is in progress.
+ *
+ * @return true if a batch is in progress, false otherwise.
+ */
+bool is_roi_batch_active(void)
+{
+	return (NULL != p_batch_network);
+}
+
+/**
+ * defer_capture_after_roi_batch() starts the capture requested during the
+ * batch once it is done.
+ *
+ * @return None
+ */
+void defer_capture_after_roi_batch(void)
+{
+	capture_deferred = true;
+}
+
+/**
+ * roi_batch_rescale_done() runs the network on the ROI just rescaled into its
+ * input.
+ *
+ * @return None
+ */
+void roi_batch_rescale_done(void)
+{
+	GARD__DBG_ASSERT(NULL != p_batch_network, "No ROI batch in progress");
+
+	GARD__STOP_RESCALE_STAGE();
+
+	start_ml_engine_on_network(batch.network);
+}
+
+/**
+ * roi_batch_ml_done() copies the results of the ROI just run and moves on to
+ * the next ROI. After the last one, the App Module is handed the results of
+ * all the ROIs and a capture held during the batch is started.
+ *
+ * @param app_context is the App Module context passed to done_cb.
+ * @param p_network is the network of the completed ML run.
+ *
+ * @return true if the run was that of an ROI of the batch, false otherwise.
+ */
+bool roi_batch_ml_done(app_handle_t         app_context,
+					   struct network_info *p_network)
+{
+	uint8_t *p_slot;
+
+	if (NULL == p_batch_network) {
+		return false;
+	}
+
+	/* Nothing else runs on the ML engine during a batch. */
+	GARD__DBG_ASSERT(p_network == p_batch_network, "Unexpected ML run");
+
+	p_slot = (uint8_t *)batch.p_results + (batch_roi * batch.result_size);
+	(void)memcpy(p_slot, (const void *)p_network->inout_offset,
+				 batch.result_size);
+
+	if (++batch_roi < batch.count_of_rois) {
+		if (start_roi_rescale(&batch_rois[batch_roi], batch.in_width,
+							  batch.in_height, p_network->inout_offset)) {
+			return true;
+		}
+	}
+
+	/* The batch is done, or cut short by an ROI out of the image. */
+	p_batch_network = NULL;
+	(void)(batch.done_cb)(app_context, batch.p_results, batch_roi);
+
+	if (capture_deferred) {
+		capture_deferred = false;
+		capture_image_async();
+	}
+
+	return true;
+}
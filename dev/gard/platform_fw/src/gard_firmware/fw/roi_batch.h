@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef ROI_BATCH_H
+#define ROI_BATCH_H
+
+#include "gard_types.h"
+#include "fw_core.h"
+
+/**
+ * is_roi_batch_active() tells if a batch started by run_network_on_rois_async()
+ * is in progress.
+ */
+bool is_roi_batch_active(void);
+
+/**
+ * defer_capture_after_roi_batch() holds a capture_image_async() call made
+ * during a batch until the batch is done.
+ */
+void defer_capture_after_roi_batch(void);
+
+/**
+ * roi_batch_rescale_done() is called by the main loop when the rescale of an
+ * ROI of the batch is done, to run the network on it.
+ */
+void roi_batch_rescale_done(void);
+
+/**
+ * roi_batch_ml_done() is called by the main loop with each completed ML run.
+ * It returns true if the run was that of an ROI of the batch, which is then
+ * not to be handed to app_ml_done().
+ */
+bool roi_batch_ml_done(app_handle_t         app_context,
+					   struct network_info *p_network);
+
+#endif /* ROI_BATCH_H */
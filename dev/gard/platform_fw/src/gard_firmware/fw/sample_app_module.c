@@ -6,10 +6,10 @@
  ******************************************************************************/
 
 #include "assert.h"
+#include "ospi_support.h"
 #include "ml_ops.h"
 #include "hw_regs.h"
 #include "fw_core.h"
-#include "ospi_support.h"
 #include "app_module.h"
 #include "utils.h"
 #include "memmap.h"
@@ -36,6 +36,22 @@ struct networks     app_networks    = {
 		   .networks          = networks_list,
 };
 
+/**
+ * Bytes of the output of the first network sent to Host, from the start of its
+ * ML engine buffers. A real App Module sends the part of the output its Host
+ * counterpart decodes.
+ */
+#define APP_RESULTS_SIZE (256U)
+
+/**
+ * struct app_results_header is sent to Host ahead of the results of each
+ * frame, see app_ml_done().
+ */
+struct app_results_header {
+	uint32_t frame_seq;     // get_frame_sequence() of the frame
+	uint32_t results_size;  // Bytes of results following
+};
+
 /**
  * struct  app_module_context is a sample structure that shows what could be
  * used to maintain the App Module's context. The App Module can define its own
@@ -43,16 +59,49 @@ struct networks     app_networks    = {
  * App Module's functions.
  */
 struct app_module_context {
-	enum ml_done_states state_var;
-	struct networks    *p_networks;
+	enum ml_done_states       state_var;
+	struct networks          *p_networks;
+	struct app_results_header results_hdr;
+	uint8_t                   results_sent;  // Set by FW Core once sent
+	uint32_t                  frames_done;
+	uint32_t                  frames_reported;
+	struct task               background_task;
 };
 
 /* app_ctxt is the variable holding App Module Context contents. */
 struct app_module_context app_ctxt = {
-	.state_var  = ML_DONE_FIRST_NETWORK_COMPLETE,
-	.p_networks = &app_networks,
+	.state_var    = ML_DONE_FIRST_NETWORK_COMPLETE,
+	.p_networks   = &app_networks,
+	.results_sent = true,
 };
 
+/**
+ * app_background_work() is a task of the App Module, see register_app_task().
+ * The FW Core calls it only when it has nothing else to do, so the work that
+ * can wait, e.g. statistics, logging or flash writes, goes here instead of in
+ * app_ml_done() where it would delay the next frame.
+ *
+ * @param ctx is the handle given to register_app_task().
+ *
+ * @return true if some work was done, false if there was nothing to do.
+ */
+static bool app_background_work(void *ctx)
+{
+	struct app_module_context *ctxt = (struct app_module_context *)ctx;
+
+	if (ctxt->frames_reported == ctxt->frames_done) {
+		return false;
+	}
+
+	/**
+	 * A bounded slice of the deferred work is done here, one frame at a time
+	 * in this example; the task is called again for the next slice.
+	 */
+	ctxt->frames_reported++;
+
+	return true;
+}
+
 /**
  * app_preinit() is called by the FW Core before it has initialized all of its
  * data structures and hardware blocks.
@@ -104,6 +153,16 @@ app_handle_t app_init(app_handle_t app_context)
 	 */
 	schedule_network_to_run(ctxt->p_networks->networks[0].network);
 
+	/**
+	 * Capture the next image while the current one is run and post-processed,
+	 * instead of once app_ml_done() calls capture_image_async().
+	 */
+	set_capture_ahead(true);
+
+	/* Work that can wait runs when the pipeline has nothing to do. */
+	register_app_task(&ctxt->background_task, "app_background",
+					  app_background_work, app_context);
+
 #ifdef START_CAMERA_STREAM_ON_BOOT
 	(void)start_camera_streaming();
 #endif
@@ -166,6 +225,7 @@ enum app_ret_code app_preprocess(app_handle_t app_context, void *image_data)
 enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
 {
 	struct app_module_context *ctxt = (struct app_module_context *)app_context;
+	struct tx_span             spans[2];
 
 	GARD__DBG_ASSERT((app_context == (app_handle_t)&app_ctxt) &&
 						 (NULL != ml_results),
@@ -188,7 +248,32 @@ enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results)
 		 */
 		// schedule_network_to_run(ctxt->p_networks->networks[1].network);
 
-		/* Start image capture -> rescale -> ml sequence again */
+		/**
+		 * Send the results straight from the ML engine output, behind a
+		 * header of our own, instead of copying them to a buffer first. The
+		 * FW Core holds the ML engine output until they are sent.
+		 */
+		if (ctxt->results_sent) {
+			ctxt->results_hdr.frame_seq    = get_frame_sequence();
+			ctxt->results_hdr.results_size = APP_RESULTS_SIZE;
+
+			spans[0].p_data = &ctxt->results_hdr;
+			spans[0].size   = sizeof(ctxt->results_hdr);
+			spans[1].p_data = ml_results;
+			spans[1].size   = APP_RESULTS_SIZE;
+
+			ctxt->results_sent = false;
+			if (!stream_spans_to_host_async(spans, GET_ARRAY_COUNT(spans), true,
+											100, &ctxt->results_sent)) {
+				ctxt->results_sent = true;
+			}
+		}
+		ctxt->frames_done++;
+
+		/**
+		 * Start image capture -> rescale -> ml sequence again, the capture is
+		 * already in flight with set_capture_ahead().
+		 */
 		capture_image_async();
 
 		// ctxt->state_var = ML_DONE_SECOND_NETWORK_COMPLETE;
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "gard_types.h"
+#include "snapshot_codec.h"
+
+/* Most samples one PackBits run or literal covers */
+#define PACKBITS_MAX_COUNT (128U)
+
+/**
+ * packbits_row() encodes width bytes of p_row with PackBits: a byte n of 0 to
+ * 127 is followed by n + 1 literal bytes, a byte n of 129 to 255 by one byte
+ * repeated 257 - n times. Runs of 3 bytes or more are encoded as runs.
+ *
+ * @param p_row is the bytes to encode.
+ * @param width is the count of bytes to encode.
+ * @param p_dst is where the encoded bytes are written. It may start up to
+ *              (width + 127) / 128 bytes before p_row.
+ *
+ * @return The count of bytes written.
+ */
+static uint32_t packbits_row(const uint8_t *p_row, uint32_t width,
+							 uint8_t *p_dst)
+{
+	uint32_t in = 0, out = 0, run, lit_start;
+	uint8_t  sample;
+
+	while (in < width) {
+		/* Measure the run starting here. */
+		run = 1;
+		while (((in + run) < width) && (run < PACKBITS_MAX_COUNT) &&
+			   (p_row[in + run] == p_row[in])) {
+			run++;
+		}
+
+		if (run >= 3U) {
+			/* p_dst may overlap p_row, read before writing. */
+			sample        = p_row[in];
+			p_dst[out++]  = (uint8_t)(257U - run);
+			p_dst[out++]  = sample;
+			in           += run;
+			continue;
+		}
+
+		/* Literals up to the next run of 3 bytes or more. */
+		lit_start = in;
+		while ((in < width) && ((in - lit_start) < PACKBITS_MAX_COUNT)) {
+			if (((in + 2U) < width) && (p_row[in] == p_row[in + 1U]) &&
+				(p_row[in] == p_row[in + 2U])) {
+				break;
+			}
+			in++;
+		}
+
+		p_dst[out++] = (uint8_t)(in - lit_start - 1U);
+		while (lit_start < in) {
+			p_dst[out++] = p_row[lit_start++];
+		}
+	}
+
+	return out;
+}
+
+/**
+ * snapshot_encode_row() encodes a row of samples of a plane of an image, see
+ * enum image_codecs.
+ *
+ * @param codec is the encoding.
+ * @param p_src is the first sample of the row.
+ * @param step is the distance between two samples of the row, > 1 when the
+ *             row is decimated.
+ * @param width is the count of samples of the row.
+ * @param p_dst is where the encoded row is written, at least
+ *              SNAPSHOT_CODEC_MAX_ROW_SIZE(width) bytes.
+ *
+ * @return The count of bytes written.
+ */
+uint32_t snapshot_encode_row(enum image_codecs codec,
+							 const uint8_t    *p_src,
+							 uint32_t          step,
+							 uint32_t          width,
+							 uint8_t          *p_dst)
+{
+	uint8_t  prev = 0, sample;
+	uint32_t idx;
+
+	switch (codec) {
+	case IMAGE_CODEC__RLE:
+	case IMAGE_CODEC__DELTA_RLE:
+		/**
+		 * The samples, or their deltas, are gathered at the end of p_dst and
+		 * encoded from there. PackBits writes at most 1 byte more than it
+		 * has read, so the encoded bytes never catch up with the ones left.
+		 */
+		for (idx = 0; idx < width; idx++) {
+			sample = p_src[idx * step];
+			p_dst[SNAPSHOT_CODEC_MAX_ROW_SIZE(width) - width + idx] =
+				(IMAGE_CODEC__DELTA_RLE == codec) ? (uint8_t)(sample - prev)
+												  : sample;
+			prev = sample;
+		}
+		return packbits_row(&p_dst[SNAPSHOT_CODEC_MAX_ROW_SIZE(width) - width],
+							width, p_dst);
+
+	case IMAGE_CODEC__PACK4:
+		for (idx = 0; idx < width; idx++) {
+			sample = p_src[idx * step] & 0xF0U;
+			if (0U == (idx & 1U)) {
+				p_dst[idx / 2U] = sample;
+			} else {
+				p_dst[idx / 2U] |= (uint8_t)(sample >> 4);
+			}
+		}
+		return (width + 1U) / 2U;
+
+	case IMAGE_CODEC__NONE:
+	default:
+		for (idx = 0; idx < width; idx++) {
+			p_dst[idx] = p_src[idx * step];
+		}
+		return width;
+	}
+}
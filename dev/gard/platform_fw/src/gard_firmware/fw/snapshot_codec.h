@@ -0,0 +1,35 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef SNAPSHOT_CODEC_H
+#define SNAPSHOT_CODEC_H
+
+#include "gard_types.h"
+#include "gard_hub_iface.h"
+
+/**
+ * This file defines the encoders of the rows of the images sent to Host with
+ * CAPTURE_RESCALED_IMAGE, see enum image_codecs.
+ */
+
+/**
+ * SNAPSHOT_CODEC_MAX_ROW_SIZE() is the most bytes a row of width samples is
+ * encoded in, whatever the codec. PackBits adds 1 byte per 128 literals.
+ */
+#define SNAPSHOT_CODEC_MAX_ROW_SIZE(width) ((width) + (((width) + 127U) / 128U))
+
+/**
+ * snapshot_encode_row() encodes the width samples at p_src, p_src + step, ...
+ * to p_dst with codec, and returns the count of bytes written.
+ */
+uint32_t snapshot_encode_row(enum image_codecs codec,
+							 const uint8_t    *p_src,
+							 uint32_t          step,
+							 uint32_t          width,
+							 uint8_t          *p_dst);
+
+#endif /* SNAPSHOT_CODEC_H */
@@ -12,6 +12,7 @@
 #include "sony_camera_configs.h"
 #include "hw_regs.h"
 #include "fw_globals.h"
+#include "utils.h"
 
 /**
  * This enum image_sensor_address_size defines the size of address of
@@ -49,6 +50,14 @@ enum image_sensor_model_id {
 
 #define MAX_CAMERA_DETECTION_RETRY_COUNT 5U
 
+/**
+ * The mode_select register of Sony IMX_219, to stop streaming frames into
+ * software standby and back. The registers keep their value in standby.
+ */
+#define IMAGE_SENSOR_SONY_IMX_219_MODE_SELECT_ADDRESS 0x0100U
+#define IMAGE_SENSOR_SONY_IMX_219_MODE_STANDBY        0x00U
+#define IMAGE_SENSOR_SONY_IMX_219_MODE_STREAMING      0x01U
+
 /**
  * detect_image_sensor() is used to detect the image sensor by reading
  * the model ID register over I2C. This function is used specifically for
@@ -128,21 +137,34 @@ const uint32_t MIN_EXPOSURE_SUPPORTED_BY_CAMERA = 0;
 
 #define DEFAULT_EXPOSURE_VALUE 6U
 
+/**
+ * Gains of the PI control of the exposure, in 1/256th of an exposure step per
+ * gray level of error. The integral term carries the exposure that holds the
+ * target, the proportional term speeds up the response to a step change.
+ */
+#define AE_KP_Q8               16
+#define AE_KI_Q8               6
+
 /**
  * set_exposure() is used to adjust the Sony IMX219 camera's exposure gain
- * control by calculating the optimal exposure in one step using proportional
- * control based on the full gray scale range (0-255).
+ * control with a PI control of the error between the gray average of the last
+ * image and the target one. The integral is clamped to the exposure range of
+ * the camera so that it does not wind up while the exposure is saturated.
  *
  * @param target_gray_avg is the target gray average value.
  *
- * @return None
+ * @return true if a new exposure was queued for the camera, false otherwise.
  */
-void set_exposure(uint32_t target_gray_avg)
+bool set_exposure(uint32_t target_gray_avg)
 {
-	static uint32_t current_exposure     = DEFAULT_EXPOSURE_VALUE;
-	uint32_t        new_exp_value        = current_exposure;
-	uint8_t         command_to_camera[3] = {0x01, 0x5A, 0x00};
-	int32_t         dist_from_target;
+	static uint32_t current_exposure = DEFAULT_EXPOSURE_VALUE;
+#if !defined(USE_PROPORTIONAL_CONTROL_FOR_EXPOSURE)
+	static int32_t exposure_integral_q8 = DEFAULT_EXPOSURE_VALUE << 8;
+	int32_t        new_exp_value_q8;
+#endif
+	uint32_t new_exp_value        = current_exposure;
+	uint8_t  command_to_camera[3] = {0x01, 0x5A, 0x00};
+	int32_t  dist_from_target;
 
 	GARD__DBG_ASSERT(target_gray_avg >= MIN_GRAY_AVERAGE_SUPPORTED_BY_ISP &&
 						 target_gray_avg <= MAX_GRAY_AVERAGE_SUPPORTED_BY_ISP,
@@ -159,20 +181,23 @@ void set_exposure(uint32_t target_gray_avg)
 
 	dist_from_target = dist_from_target; /* To keep the compiler happy. */
 #else
+	/* Positive when the image is too dark and needs more exposure. */
 	dist_from_target =
-		(int32_t)get_image_gray_average() - (int32_t)target_gray_avg;
+		(int32_t)target_gray_avg - (int32_t)get_image_gray_average();
 
-	if (dist_from_target > 50) {
-		new_exp_value /= 2;
-	} else if (dist_from_target > 20) {
-		if (new_exp_value > 2U) {
-			new_exp_value -= 2U;
-		}
-	} else if (dist_from_target < -30) {
-		new_exp_value += 5;
-	} else if (dist_from_target < -10) {
-		new_exp_value += 1;
-	}
+	exposure_integral_q8 += AE_KI_Q8 * dist_from_target;
+	exposure_integral_q8 =
+		MAX(exposure_integral_q8,
+			(int32_t)(MIN_EXPOSURE_SUPPORTED_BY_CAMERA << 8));
+	exposure_integral_q8 =
+		MIN(exposure_integral_q8,
+			(int32_t)(MAX_EXPOSURE_SUPPORTED_BY_CAMERA << 8));
+
+	/* Round to the nearest exposure step. */
+	new_exp_value_q8 =
+		exposure_integral_q8 + (AE_KP_Q8 * dist_from_target) + (1 << 7);
+	new_exp_value = (new_exp_value_q8 > 0) ? (uint32_t)(new_exp_value_q8 >> 8)
+										   : 0U;
 #endif
 
 	/**
@@ -187,7 +212,7 @@ void set_exposure(uint32_t target_gray_avg)
 
 	if (current_exposure == new_exp_value) {
 		/* No change in exposure needed */
-		return;
+		return false;
 	}
 
 	/**
@@ -202,8 +227,39 @@ void set_exposure(uint32_t target_gray_avg)
 	 */
 	command_to_camera[2] = (uint8_t)(new_exp_value & 0xFFU);
 
-	write_to_camera(IMAGE_SENSOR_SONY_IMX_219, sizeof(command_to_camera),
-					command_to_camera);
+	/**
+	 * This runs once per frame, possibly from the rescale done ISR, so the
+	 * write is queued rather than waited for. If the queue is full the next
+	 * frame tries again.
+	 */
+	if (!write_to_camera_async(IMAGE_SENSOR_SONY_IMX_219,
+							   sizeof(command_to_camera), command_to_camera)) {
+		return false;
+	}
 
 	current_exposure = new_exp_value;
+
+	return true;
+}
+
+/**
+ * set_image_sensor_standby() puts the image sensor in software standby, where
+ * it stops streaming frames and draws little power, or back to streaming. The
+ * write is queued like the exposure ones, see write_to_camera_async(), and the
+ * first frame after standby comes a frame time or so after it is sent.
+ *
+ * @param standby is true to stop streaming, false to start again.
+ *
+ * @return true if the write was queued, false if the queue is full.
+ */
+bool set_image_sensor_standby(bool standby)
+{
+	uint8_t command_to_camera[3] = {
+		(uint8_t)(IMAGE_SENSOR_SONY_IMX_219_MODE_SELECT_ADDRESS >> 8),
+		(uint8_t)(IMAGE_SENSOR_SONY_IMX_219_MODE_SELECT_ADDRESS & 0xFFU),
+		standby ? IMAGE_SENSOR_SONY_IMX_219_MODE_STANDBY
+				: IMAGE_SENSOR_SONY_IMX_219_MODE_STREAMING};
+
+	return write_to_camera_async(IMAGE_SENSOR_SONY_IMX_219,
+								 sizeof(command_to_camera), command_to_camera);
 }
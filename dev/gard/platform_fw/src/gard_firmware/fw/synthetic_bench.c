@@ -0,0 +1,293 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#include "synthetic_bench.h"
+
+#if defined(TEST_SYNTHETIC_BENCHMARK)
+
+#include "cpu.h"
+#include "utils.h"
+#include "fw_core.h"
+#include "fw_globals.h"
+#include "rfs.h"
+#include "camera_capture.h"
+#include "pipeline_stats.h"
+#include "sw_timer.h"
+
+/* Frames run in all, the warm-up ones then the timed ones */
+#define SYNTHETIC_BENCH_FRAMES \
+	(SYNTHETIC_BENCH_WARMUP + SYNTHETIC_BENCH_ITERATIONS)
+
+/**
+ * The steps of the benchmark, see continue_synthetic_bench(). The frame is
+ * LOADed into the Host input slots, the pipeline SWITCHed over to it, the
+ * frames RUN, then the report sent.
+ */
+enum synthetic_bench_steps {
+	SYNTHETIC_BENCH_STEP__IDLE = 0,
+	SYNTHETIC_BENCH_STEP__ARMED,
+	SYNTHETIC_BENCH_STEP__LOAD,
+	SYNTHETIC_BENCH_STEP__SWITCH,
+	SYNTHETIC_BENCH_STEP__RUN,
+	SYNTHETIC_BENCH_STEP__REPORT,
+	SYNTHETIC_BENCH_STEP__DONE
+};
+
+static enum synthetic_bench_steps bench_step = SYNTHETIC_BENCH_STEP__IDLE;
+static struct sw_timer            start_timer;
+
+/**
+ * The frame, as read from the RFS module header, and the capture format it
+ * takes. frames_submitted / frames_done count the frames given to and
+ * post-processed by the pipeline, timing_start is the CPU cycle counter when
+ * the warm-up frames were done. switch_deadline is the CPU TSC time the
+ * pipeline must have taken the frame by.
+ */
+static struct synthetic_bench_frame_hdr frame;
+static uint32_t                         frames_submitted = 0;
+static uint32_t                         frames_done      = 0;
+static uint64_t                         timing_start     = 0;
+static uint64_t                         switch_deadline  = 0;
+
+static struct synthetic_bench_report report;
+static uint8_t                       report_sent = 0;
+
+/**
+ * start_bench() is the callback of start_timer.
+ *
+ * @param ctx: Unused.
+ *
+ * @return None
+ */
+static void start_bench(void *ctx)
+{
+	(void)ctx;
+
+	bench_step = SYNTHETIC_BENCH_STEP__LOAD;
+}
+
+/**
+ * end_bench() moves to the report with its status.
+ *
+ * @param status is the outcome of the benchmark.
+ *
+ * @return None
+ */
+static void end_bench(enum synthetic_bench_status status)
+{
+	report.signature     = SYNTHETIC_BENCH_REPORT_SIGNATURE;
+	report.status        = (uint32_t)status;
+	report.cycles_per_us = PIPELINE_STATS_CYCLES_PER_US;
+
+	bench_step = SYNTHETIC_BENCH_STEP__REPORT;
+}
+
+/**
+ * load_frame() reads the frame from the RFS into the free Host input slots.
+ *
+ * @return SYNTHETIC_BENCH__DONE if the frame is loaded, the failure otherwise.
+ */
+static enum synthetic_bench_status load_frame(void)
+{
+	struct host_input_status status;
+	uint32_t                 planes;
+	uint32_t                 bytes;
+	uint32_t                 idx;
+
+	if (sizeof(frame) != read_module_from_rfs(sd, SYNTHETIC_BENCH_FRAME_UID, 0,
+											  sizeof(frame), &frame)) {
+		return SYNTHETIC_BENCH__NO_FRAME;
+	}
+
+	if ((SYNTHETIC_BENCH_FRAME_SIGNATURE != frame.signature) ||
+		(0U == frame.width) || (0U == frame.height)) {
+		return SYNTHETIC_BENCH__BAD_FRAME;
+	}
+
+	if (IMAGE_FORMAT__GRAYSCALE == frame.format) {
+		planes = 1U;
+	} else if (IMAGE_FORMAT__RGB_PLANAR == frame.format) {
+		planes = 3U;
+	} else {
+		return SYNTHETIC_BENCH__BAD_FRAME;
+	}
+
+	/* The RFS is read in words, the last one may run past the image. */
+	bytes = planes * frame.width * frame.height;
+	bytes = (bytes + sizeof(uint32_t) - 1U) & ~(sizeof(uint32_t) - 1U);
+
+	get_host_input_status(&status);
+	if ((bytes > status.slot_size) || (0U == status.free_slots)) {
+		return SYNTHETIC_BENCH__BAD_FRAME;
+	}
+
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		if (0U == (status.free_slots & (1U << idx))) {
+			continue;
+		}
+
+		if (read_module_from_rfs(sd, SYNTHETIC_BENCH_FRAME_UID, sizeof(frame),
+								 bytes, (void *)status.slot_address[idx]) <
+			(planes * frame.width * frame.height)) {
+			return SYNTHETIC_BENCH__BAD_FRAME;
+		}
+	}
+
+	return SYNTHETIC_BENCH__DONE;
+}
+
+/**
+ * submit_frames() submits the frame from the free Host input slots, until
+ * enough frames are done.
+ *
+ * @return true if a frame was submitted, false otherwise.
+ */
+static bool submit_frames(void)
+{
+	struct host_input_status status;
+	bool                     submitted = false;
+	uint32_t                 idx;
+
+	get_host_input_status(&status);
+
+	for (idx = 0; idx < HOST_INFERENCE__SLOTS; idx++) {
+		/**
+		 * Frames are submitted on until the last one is done, so that those
+		 * dropped on their way do not stall the benchmark.
+		 */
+		if ((frames_done >= SYNTHETIC_BENCH_FRAMES) ||
+			(0U == (status.free_slots & (1U << idx)))) {
+			continue;
+		}
+
+		if (submit_host_input((uint8_t)idx, (enum image_formats)frame.format,
+							  frame.width, frame.height, frames_submitted)) {
+			frames_submitted++;
+			submitted = true;
+		}
+	}
+
+	return submitted;
+}
+
+/**
+ * synthetic_bench_arm() starts the benchmark SYNTHETIC_BENCH_START_DELAY_MS
+ * from now, on the first call only.
+ *
+ * @return None
+ */
+void synthetic_bench_arm(void)
+{
+	if (SYNTHETIC_BENCH_STEP__IDLE != bench_step) {
+		return;
+	}
+
+	sw_timer_init(&start_timer, "synthetic_bench", start_bench, NULL);
+	sw_timer_start(&start_timer, SYNTHETIC_BENCH_START_DELAY_MS, 0);
+	bench_step = SYNTHETIC_BENCH_STEP__ARMED;
+}
+
+/**
+ * continue_synthetic_bench() takes the benchmark through its steps.
+ *
+ * @return true if the benchmark made progress, false otherwise.
+ */
+bool continue_synthetic_bench(void)
+{
+	enum synthetic_bench_status status;
+
+	switch (bench_step) {
+	case SYNTHETIC_BENCH_STEP__LOAD:
+		status = load_frame();
+		if (SYNTHETIC_BENCH__DONE != status) {
+			end_bench(status);
+			return true;
+		}
+
+		switch_deadline = get_cpu_tsc() +
+						  (((uint64_t)CLINT_TIMEBASE_FREQ *
+							SYNTHETIC_BENCH_SWITCH_TIMEOUT_MS) /
+						   1000U);
+		bench_step = SYNTHETIC_BENCH_STEP__SWITCH;
+		return true;
+
+	case SYNTHETIC_BENCH_STEP__SWITCH:
+		/**
+		 * The format is not switched while a camera image is captured or
+		 * rescaled, nor the Host input started while the capture free-runs.
+		 */
+		if (set_capture_format((enum image_formats)frame.format) &&
+			submit_frames()) {
+			pipeline_stats_reset();
+			timing_start = pipeline_stats_now();
+			bench_step   = SYNTHETIC_BENCH_STEP__RUN;
+			return true;
+		}
+
+		if (get_cpu_tsc() > switch_deadline) {
+			end_bench(SYNTHETIC_BENCH__NOT_SWITCHED);
+			return true;
+		}
+		return false;
+
+	case SYNTHETIC_BENCH_STEP__RUN:
+		return submit_frames();
+
+	case SYNTHETIC_BENCH_STEP__REPORT:
+		if (!stream_data_to_host_async((uint8_t *)&report, sizeof(report), 100,
+									   &report_sent)) {
+			return false;
+		}
+
+		bench_step = SYNTHETIC_BENCH_STEP__DONE;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * synthetic_bench_frame_done() counts the frames of the benchmark. The
+ * statistics are reset when the warm-up frames are done, and taken into the
+ * report when the timed ones are.
+ *
+ * @return None
+ */
+void synthetic_bench_frame_done(void)
+{
+	uint64_t now;
+
+	if (SYNTHETIC_BENCH_STEP__RUN != bench_step) {
+		return;
+	}
+
+	frames_done++;
+	now = pipeline_stats_now();
+
+	if (SYNTHETIC_BENCH_WARMUP == frames_done) {
+		pipeline_stats_reset();
+		timing_start = now;
+	}
+
+	if (SYNTHETIC_BENCH_FRAMES == frames_done) {
+		report.iterations     = SYNTHETIC_BENCH_ITERATIONS;
+		report.elapsed_cycles = now - timing_start;
+		report.mfps           = 0;
+		if (0U != report.elapsed_cycles) {
+			report.mfps = (uint32_t)(((uint64_t)SYNTHETIC_BENCH_ITERATIONS *
+									  PIPELINE_STATS_CYCLES_PER_US *
+									  1000000000U) /
+									 report.elapsed_cycles);
+		}
+		pipeline_stats_get(report.stages);
+
+		end_bench(SYNTHETIC_BENCH__DONE);
+	}
+}
+
+#endif /* TEST_SYNTHETIC_BENCHMARK */
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef SYNTHETIC_BENCH_H
+#define SYNTHETIC_BENCH_H
+
+#include "gard_types.h"
+#include "gard_hub_iface_unpacked.h"
+
+/**
+ * This file defines the synthetic benchmark of the TEST_SYNTHETIC_BENCHMARK
+ * test build, see FW_SYNTHETIC_BENCHMARK in fw/Makefile. Once Host has
+ * discovered GARD, the ML pipeline is run back-to-back on a fixed frame read
+ * from the RFS, through the Host input slots in place of the camera images
+ * (see submit_host_input()), so that its throughput does not depend on the
+ * exposure or the scene. After SYNTHETIC_BENCH_WARMUP frames, the pipeline
+ * statistics are reset and SYNTHETIC_BENCH_ITERATIONS frames are timed. A
+ * struct synthetic_bench_report is then sent to Host as App Module data. No
+ * more frames are submitted, the pipeline waits for the next Host input until
+ * Host stops it with RUN_INFERENCE_ON_BUFFER.
+ *
+ * The frames dropped by the inference rate policy are not timed, the
+ * benchmark is meant to run with INFERENCE_RATE__ALL_FRAMES.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, which takes the Host input slots,
+ * supports it.
+ */
+
+/* RFS module of the frame, the first unassigned module ID by default */
+#ifndef SYNTHETIC_BENCH_FRAME_UID
+#define SYNTHETIC_BENCH_FRAME_UID (0x5001U)
+#endif
+
+/* Frames timed */
+#ifndef SYNTHETIC_BENCH_ITERATIONS
+#define SYNTHETIC_BENCH_ITERATIONS (1000U)
+#endif
+
+/* Frames run before the timing starts, to settle the network caches */
+#ifndef SYNTHETIC_BENCH_WARMUP
+#define SYNTHETIC_BENCH_WARMUP (8U)
+#endif
+
+/* Time from GARD_DISCOVERY to the start, for Host to set up the App data */
+#ifndef SYNTHETIC_BENCH_START_DELAY_MS
+#define SYNTHETIC_BENCH_START_DELAY_MS (2000U)
+#endif
+
+/* Time the pipeline is given to switch over to the frame */
+#define SYNTHETIC_BENCH_SWITCH_TIMEOUT_MS (1000U)
+
+#define SYNTHETIC_BENCH_FRAME_SIGNATURE  (0x4D524642U)  // "BFRM"
+#define SYNTHETIC_BENCH_REPORT_SIGNATURE (0x48434E42U)  // "BNCH"
+
+/**
+ * The RFS module of the frame: this header, then the image in the Host input
+ * format, each plane of width x height bytes.
+ */
+struct synthetic_bench_frame_hdr {
+	uint32_t signature;  // SYNTHETIC_BENCH_FRAME_SIGNATURE
+	uint16_t width;      // In pixels
+	uint16_t height;     // In pixels
+	uint32_t format;     // IMAGE_FORMAT__RGB_PLANAR or IMAGE_FORMAT__GRAYSCALE
+};
+
+/* Outcomes of the benchmark, the status of its report */
+enum synthetic_bench_status {
+	SYNTHETIC_BENCH__DONE = 0,    // Frames timed, see the report
+	SYNTHETIC_BENCH__NO_FRAME,    // No SYNTHETIC_BENCH_FRAME_UID module
+	SYNTHETIC_BENCH__BAD_FRAME,   // Bad signature, or too big for a slot
+	SYNTHETIC_BENCH__NOT_SWITCHED // The pipeline did not take the frame
+};
+
+/**
+ * The report of the benchmark. The stages are those of GET_PIPELINE_STATS,
+ * in CPU cycles (mcycle), over the frames timed.
+ */
+struct synthetic_bench_report {
+	uint32_t signature;       // SYNTHETIC_BENCH_REPORT_SIGNATURE
+	uint32_t status;          // enum synthetic_bench_status
+	uint32_t iterations;      // Frames timed
+	uint32_t cycles_per_us;   // CPU cycles per microsecond
+	uint64_t elapsed_cycles;  // From the first frame timed to the last done
+	uint32_t mfps;            // Frames per 1000 s
+	uint32_t rsvd1;           // Pad bytes.
+	struct _pipeline_stage_stats_unpked stages[PIPELINE_STATS__NUM_STAGES];
+};
+
+/**
+ * synthetic_bench_arm() is called when Host discovers GARD. The first call
+ * starts the benchmark SYNTHETIC_BENCH_START_DELAY_MS later.
+ */
+void synthetic_bench_arm(void);
+
+/**
+ * continue_synthetic_bench() is run by the main loop. It loads the frame,
+ * submits it to the free Host input slots and sends the report.
+ */
+bool continue_synthetic_bench(void);
+
+/**
+ * synthetic_bench_frame_done() is called for each frame post-processed.
+ */
+void synthetic_bench_frame_done(void);
+
+#endif /* SYNTHETIC_BENCH_H */
@@ -11,15 +11,18 @@
 #include "octal_spi_controller.h"
 #include "ospi_support.h"
 #include "fw_reader.h"
+#include "fw_boot.h"
+#include "rfs.h"
 #include "memmap.h"
 
 /**
  * main() is the entry point of the firmware loader after the assembly code has
- * setup the stack and initialized the BSS section. This routine performs three
+ * setup the stack and initialized the BSS section. This routine performs four
  * main tasks:
  * 1. Initializes the OSPI controller.
- * 2. Locates the firmware in flash memory.
- * 3. Loads the firmware from flash memory and executes it.
+ * 2. Picks the firmware slot to boot, see fw_boot.h.
+ * 3. Locates the firmware in the RFS of that slot.
+ * 4. Loads the firmware from flash memory and executes it.
  *
  * The code never reaches the end of main as
  * load_firmware_from_flash_and_execute() jumps to the firmware code and does
@@ -39,6 +42,9 @@ int main(void)
 	ospi_handle = ospi_init();
 	GARD__DBG_ASSERT(ospi_handle != NULL, "OSPI initialization failed");
 
+	rfs_set_config_addr(
+		FW_BOOT_SLOT_RFS_ADDR(fw_boot_select_slot(ospi_handle)));
+
 	GARD__DBG_ASSERT(
 		locate_firmware_in_flash(ospi_handle, &fw_flash_addr, &fw_size),
 		"Failed to locate firmware in flash");
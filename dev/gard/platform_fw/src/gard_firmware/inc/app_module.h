@@ -52,8 +52,9 @@
  * implemented in the app module.
  */
 enum app_ret_code {
-	APP_CODE__SUCCESS = 0,     // Operation completed successfully
-	APP_CODE__FAILURE = -100,  // Go to the previous step in the flow
+	APP_CODE__SUCCESS  = 0,    // Operation completed successfully
+	APP_CODE__CONTINUE = 1,    // Not done yet, call again for the next slice
+	APP_CODE__FAILURE  = -100, // Go to the previous step in the flow
 
 	// Keep adding more error codes as needed.
 };
@@ -90,6 +91,11 @@ enum app_ret_code app_preprocess(app_handle_t app_context, void *image_data);
  * app_ml_done() is called by the FW Core when the ML engine has finished
  * processing the image data. This function is an opportunity for the App Module
  * to perform any post-processing on the ML results.
+ *
+ * Lengthy post-processing can be split in slices: returning APP_CODE__CONTINUE
+ * makes the FW Core call app_ml_done() again with the same ml_results once it
+ * has serviced the pipeline and the Host, until another code is returned.
+ * The App Module keeps track of its progress in its own context.
  */
 enum app_ret_code app_ml_done(app_handle_t app_context, void *ml_results);
 
@@ -24,6 +24,14 @@
 #define GARD__DBG_ASSERT(expr, ...) /* Do nothing */
 #endif
 
+/* Runtime assert for hot paths, run on every element of a frame, only for
+ * PARANOID builds.*/
+#ifdef GARD_PARANOID
+#define GARD__PARANOID_ASSERT(expr, ...) GARD__ASSERT(expr, __VA_ARGS__)
+#else
+#define GARD__PARANOID_ASSERT(expr, ...) /* Do nothing */
+#endif
+
 /* Compile-time asserts. */
 #if (__STDC_VERSION__ >= 201112)
 /**
@@ -21,7 +21,9 @@
  * - Modules: Different modules that are a part of the GARD infrastructure.
  *
  * Two copies of Configuration, Directory and Modules are present for
- * redundancy when enough space is available for accomodating both.
+ * redundancy when enough space is available for accomodating both. They are
+ * the A and B firmware slots, the boot control record picking the one booted,
+ * see fw_boot.h.
  *
  * The Flash memory is organized as follows:
  * +---------------------+ Bottom of memory  @ 0x0
@@ -30,6 +32,9 @@
  * |                     |
  * +---------------------+  End of Bitstream ~ @2.5MB
  * |     Unused          |
+ * +---------------------+  Start of Boot control @(3MB - 8KB)
+ * |    Boot control     |  Two copies of the boot control record, one per
+ * |                     |  4KB sector.
  * +---------------------+  Start of RFS Configuration @ 3MB
  * |                     |
  * |  RFS Configuration  |  RFS Configuration data.
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef FW_BOOT_H
+#define FW_BOOT_H
+
+#include "gard_types.h"
+#include "rfs.h"
+
+/**
+ * This file defines the A/B firmware slots, see flashmap.h. Each half of the
+ * flash holds a copy of the RFS, with its firmware, networks and camera
+ * configurations; the firmware loader boots the firmware of the RFS of the
+ * active slot.
+ *
+ * An upgrade is programmed in the slot not running and made active once
+ * complete. Until the new firmware confirms it runs well, see
+ * fw_boot_confirm(), every boot of it is counted. After FW_BOOT_MAX_ATTEMPTS
+ * unconfirmed boots the loader falls back to the other slot, so that a bad
+ * or partly written image never leaves GARD without a firmware to boot.
+ *
+ * The boot control record lives in two flash sectors just below the RFS of
+ * slot A, written in turn, so that a power loss while one is rewritten leaves
+ * the other. The boot counts and flags are cleared one bit at a time, which
+ * the flash allows without an erase.
+ */
+
+#define FW_BOOT_NUM_SLOTS     (2U)
+#define FW_BOOT_SLOT_A        (0U)
+#define FW_BOOT_SLOT_B        (1U)
+
+/* Each slot is a half of the 16 MB flash. */
+#define FW_BOOT_SLOT_SIZE     (8U * 1024U * 1024U)
+
+/* Flash address of the RFS configuration of a slot. */
+#define FW_BOOT_SLOT_RFS_ADDR(slot)                                            \
+	(((slot) * FW_BOOT_SLOT_SIZE) + RFS_CONFIG_START_ADDR)
+
+/* Unconfirmed boots of the active slot before falling back to the other. */
+#ifndef FW_BOOT_MAX_ATTEMPTS
+#define FW_BOOT_MAX_ATTEMPTS  (3U)
+#endif
+
+#define FW_BOOT_CTRL_SIGNATURE 0x544F4F42U  // "BOOT" in ASCII
+
+/**
+ * struct fw_boot_ctrl is the boot control record. A field reads all ones
+ * until it is cleared, so that a freshly written record is an unconfirmed
+ * active slot not booted yet.
+ */
+struct fw_boot_ctrl {
+	uint32_t signature;    // FW_BOOT_CTRL_SIGNATURE
+	uint32_t sequence;     // The record with the higher one is current
+	uint32_t active_slot;  // Slot to boot
+	uint32_t attempts;     // A bit cleared per unconfirmed boot
+	uint32_t confirmed;    // 0 once the active slot is confirmed
+	uint32_t fell_back;    // 0 once the loader fell back to the other slot
+} __attribute__((packed));
+
+/**
+ * fw_boot_select_slot() is called by the firmware loader to pick the slot to
+ * boot, counting the boot if the active slot is not confirmed.
+ */
+uint32_t fw_boot_select_slot(void *ospi_handle);
+
+/**
+ * fw_boot_running_slot() tells the firmware the slot it was booted from.
+ */
+uint32_t fw_boot_running_slot(void *ospi_handle);
+
+/**
+ * fw_boot_confirm() marks the active slot as good, once the firmware booted
+ * from it runs well. Its boots are no longer counted.
+ */
+bool fw_boot_confirm(void *ospi_handle);
+
+/**
+ * fw_boot_activate_slot() makes slot the active one, not confirmed, so that
+ * the next boots try it.
+ */
+bool fw_boot_activate_slot(void *ospi_handle, uint32_t slot);
+
+#endif /* FW_BOOT_H */
@@ -12,6 +12,7 @@
 #include "network_info.h"
 #include "image_info.h"
 #include "app_module.h"
+#include "task_sched.h"
 
 /**
  * This file defines the interfaces intended for use by the App Module.
@@ -109,6 +110,10 @@ bool set_i2c_target_parameters(void    *i2c_handle,
  * Once this function is called the App Module should assume the networks
  * variable is owned by the FW Core. Hence the App Module should not
  * modify the contents of the networks variable after this call.
+ *
+ * The networks are loaded from flash in the background once app_init()
+ * returns, so that the camera is started and the first image captured in the
+ * meantime. start_ml_engine() loads what is left of a network started before.
  */
 bool register_networks(struct networks *list_of_networks);
 
@@ -123,6 +128,43 @@ bool register_networks(struct networks *list_of_networks);
  */
 bool schedule_network_to_run(ml_network_handle_t network);
 
+/**
+ * prefetch_network() is invoked by routines in the App Module to have the FW
+ * Core load an ML network from flash to RAM in the background, e.g. while the
+ * current network runs or while an image is captured, so that switching to it
+ * does not wait for the flash. The network scheduled to run next is
+ * prefetched anyway, this routine lets the App Module get one ready earlier.
+ *
+ * It returns false if the RAM of the network is in use by the network
+ * running on the ML engine, the App Module can try again once it is done.
+ */
+bool prefetch_network(ml_network_handle_t network);
+
+/* Most networks queue_networks_to_run() takes for one frame. */
+#define ML_RUN_QUEUE_DEPTH (8U)
+
+/**
+ * queue_networks_to_run() is invoked by routines in the App Module to have a
+ * cascade of ML networks, e.g. a detector and then a classifier, run back to
+ * back on the same frame. The first network is scheduled to run next and is
+ * started by the next call of start_ml_engine(). Each of the others is started
+ * by the FW Core as soon as the one before it is done, straight from the ML
+ * done IRQ when it is already loaded in RAM, so the ML engine is not left idle
+ * between the stages. app_ml_done() is called once per network, in order.
+ *
+ * The queued networks are never evicted from RAM while they wait to run, and
+ * the next of them not loaded yet is prefetched. Each network keeps its own
+ * input and output buffers: a network reading the results of the one before
+ * it must use that network's buffers as its input.
+ *
+ * The queue is run again on every frame, until queue_networks_to_run() or
+ * schedule_network_to_run() replaces it.
+ *
+ * It returns false if count is 0 or more than ML_RUN_QUEUE_DEPTH.
+ */
+bool queue_networks_to_run(const ml_network_handle_t *p_networks,
+						   uint32_t                   count);
+
 /**
  * get_uid_of_next_network_to_run() is called by the App Module routines to
  * find the UID of the ML network that will be run next on the ML engine.
@@ -155,20 +197,80 @@ void *register_buffer_for_host_data(uint8_t     *buffer,
 									uint32_t     buffer_size,
 									rx_handler_t app_rx_handler);
 
+/**
+ * register_host_command() is used by the App Module to handle a command of its
+ * own from its counterpart running on the Host, e.g. to update a threshold or
+ * to load reference vectors, next to the FW Core commands. command_id is to be
+ * in the APP_COMMAND_ID_FIRST to APP_COMMAND_ID_LAST range. Every command
+ * carries body_size bytes, received in body before app_cmd_handler is called.
+ * app_cmd_handler is not to return APP_COMMAND_STATUS_NOT_REGISTERED, which
+ * tells Host that a command is not registered.
+ *
+ * This function should be called from within the app_init() routine of the
+ * App Module. The body buffer is owned by the FW Core from then on.
+ */
+bool register_host_command(uint8_t            command_id,
+						   uint8_t           *body,
+						   uint32_t           body_size,
+						   host_cmd_handler_t app_cmd_handler,
+						   app_handle_t       app_context);
+
+/**
+ * Number of buffers stream_data_to_host_async() keeps queued for the Host.
+ * An App Module cycling through as many buffers always finds room in the
+ * queue for a buffer whose send has completed.
+ */
+#define APP_TX_QUEUE_DEPTH (4U)
+
 /**
  * stream_data_to_host_async() is used by the App Module to send streaming data,
  * recurring data such as information generated by the pipeline, to the Host.
  *
  * The data is sent asynchronously, meaning the data transfer could complete
  * to the Host in the background and the App Module should populate this buffer
- * only when the *p_send_complete parameter is set to true. App Module could use
- * two buffers to accumulate new data in the mean time.
+ * only when the *p_send_complete parameter is set to true. Up to
+ * APP_TX_QUEUE_DEPTH buffers are queued, so the App Module can use that many
+ * buffers to accumulate new data in the mean time. It returns false, and
+ * the buffer is not sent, if the queue is full. With APP_DATA_COALESCING set
+ * by the Host, such a buffer is copied instead, and *p_send_complete set
+ * right away.
  */
-void stream_data_to_host_async(uint8_t *data,
+bool stream_data_to_host_async(uint8_t *data,
 							   uint32_t count_of_data_bytes,
 							   uint32_t timeout_ms,
 							   uint8_t *p_send_complete);
 
+/* Most spans stream_spans_to_host_async() takes for one buffer. */
+#define APP_TX_MAX_SPANS (4U)
+
+/**
+ * The struct tx_span is a piece of a buffer sent by
+ * stream_spans_to_host_async().
+ */
+struct tx_span {
+	const void *p_data;
+	uint32_t    size;
+};
+
+/**
+ * stream_spans_to_host_async() is stream_data_to_host_async() for a buffer made
+ * of up to APP_TX_MAX_SPANS pieces, sent back to back as one buffer, e.g. a
+ * header built by the App Module followed by the results straight from the ML
+ * engine output, without copying them together first. The p_spans array is
+ * copied, the data is not: it is to be left as is until *p_send_complete is
+ * set.
+ *
+ * With hold_ml_output set, the FW Core does not rescale the next image into
+ * the ML engine buffers nor run the ML engine again until the buffer is sent,
+ * so that the spans can point in the results handed to app_ml_done(). The
+ * pipeline then runs no faster than the Host reads the results.
+ */
+bool stream_spans_to_host_async(const struct tx_span *p_spans,
+								uint32_t              count_of_spans,
+								bool                  hold_ml_output,
+								uint32_t              timeout_ms,
+								uint8_t              *p_send_complete);
+
 /**
  * send_event_to_host() is used by the App Module to send asynchronous data to
  * the Host. This is used by the App Module to send 'unexpected' events to the
@@ -189,6 +291,84 @@ bool send_event_to_host(uint8_t *event_data,
  */
 void capture_image_async(void);
 
+/**
+ * set_capture_ahead() lets the FW Core start the capture of the next image as
+ * soon as the current one has been rescaled into the ML engine input, instead
+ * of waiting for the App Module to call capture_image_async(). The capture
+ * then overlaps the ML run and the post-processing of the current image. The
+ * ML run of the next image still waits for app_ml_done() to be done with the
+ * results of the current one, as they share the ML engine buffers.
+ *
+ * capture_image_async() calls made while a capture is in flight are ignored,
+ * so the App Module can keep calling it from app_ml_done().
+ */
+void set_capture_ahead(bool enable);
+
+/* Capture buffers of the frame ring, see set_continuous_capture(). */
+#define FRAME_RING_DEPTH (3U)
+
+/**
+ * The enum frame_ring_policy tells which of the captured images waiting in the
+ * frame ring is handed to the ML engine next, see set_continuous_capture().
+ */
+enum frame_ring_policy {
+	/* The newest image is run, the older ones are dropped. */
+	FRAME_RING_POLICY__LATEST_WINS = 0,
+	/* The oldest image is run, the captures stall while the ring is full. */
+	FRAME_RING_POLICY__IN_ORDER = 1,
+};
+
+/**
+ * set_continuous_capture() lets the camera capture free-run, instead of
+ * capturing one image per capture_image_async() call. The captured images go
+ * to a ring of FRAME_RING_DEPTH capture buffers, and the FW Core rescales one
+ * of them into the ML engine input, as picked by policy, as soon as the ML
+ * engine is done with the previous one. The frame rate then follows the
+ * sensor whenever the ML run and app_ml_done() take less than a frame period.
+ *
+ * The capture and rescale stages share the scaler, so a rescale waits for the
+ * capture in flight to be done. capture_image_async() calls are ignored while
+ * the capture is free-running, so the App Module can keep calling it from
+ * app_ml_done(). get_frame_sequence() tells which image the results are for.
+ *
+ * This function should be called from within the app_init() routine of the
+ * App Module, before the first capture. It returns false if a capture is in
+ * flight or the pipeline does not support it.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, which keeps the captured images in
+ * buffers of their own, supports it.
+ */
+bool set_continuous_capture(bool enable, enum frame_ring_policy policy);
+
+/**
+ * get_frame_sequence() returns the sequence number of the image last
+ * rescaled into the ML engine input, i.e. of the image the ML run in progress
+ * or just done is for. Every captured image is numbered, so a gap between two
+ * numbers tells how many images were dropped.
+ */
+uint32_t get_frame_sequence(void);
+
+/**
+ * get_frame_capture_time() returns the CPU TSC, see get_cpu_tsc(), at which
+ * the capture of that same image started, to time stamp its results. Host
+ * maps it to its own clock with GET_GARD_TIME.
+ */
+uint64_t get_frame_capture_time(void);
+
+/**
+ * set_inference_rate() picks the images the ML engine is run on, the others
+ * being dropped before app_preprocess() is called for them: all of them, one
+ * out of param, param images per 1000 seconds at most, or as many as keep the
+ * ML engine busy no more than param % of the time and the Host TX keeping up,
+ * see enum inference_rate_modes. This bounds the power and the Host link load
+ * when the camera delivers more images than the application needs.
+ *
+ * This function can be called at any time, by the App Module or through the
+ * INFERENCE_RATE Host command. It returns false if param is not valid for
+ * mode, in which case the policy in use is kept.
+ */
+bool set_inference_rate(enum inference_rate_modes mode, uint32_t param);
+
 /**
  * start_ml_engine() is used by the App Module to start the ML engine. This
  * function should be called after the App Module has registered its networks
@@ -211,6 +391,79 @@ void start_ml_engine(void);
 bool crop_and_rescale_image(struct image_info *in_image,
 							struct image_info *scaled_image);
 
+/* Most ROIs run_network_on_rois_async() takes in one batch. */
+#define ROI_BATCH_MAX_ROIS (16U)
+
+/**
+ * The struct roi_batch describes a batch of ROIs of the captured image to run
+ * a second-stage network on, e.g. a classifier on the persons found by a
+ * detector, see run_network_on_rois_async().
+ */
+struct roi_batch {
+	/* Network run on each ROI, registered with register_networks(). */
+	ml_network_handle_t network;
+	/* Size in pixels of the network input, that each ROI is rescaled to. */
+	uint16_t in_width;
+	uint16_t in_height;
+	/* ROIs of the captured image, up to ROI_BATCH_MAX_ROIS. */
+	const struct roi_box *p_rois;
+	uint32_t              count_of_rois;
+	/**
+	 * Buffer receiving result_size bytes of the network output per ROI, in
+	 * consecutive slots in the order of p_rois.
+	 */
+	void    *p_results;
+	uint32_t result_size;
+	/**
+	 * Called once with the results of all the ROIs. count_of_rois is less
+	 * than asked for if an ROI is not within the captured image, the ROIs
+	 * from it on are left out.
+	 */
+	enum app_ret_code (*done_cb)(app_handle_t app_context,
+								 void        *p_results,
+								 uint32_t     count_of_rois);
+};
+
+/**
+ * run_network_on_rois_async() is used by the App Module to run a network on
+ * a batch of ROIs of the last captured image. The FW Core crops and rescales
+ * each ROI into the network input and runs the network on it, one ROI after
+ * the other, straight from the done events of the rescale stage and the ML
+ * engine. The App Module is called once, by done_cb, when all the ROIs are
+ * done, instead of once per ROI.
+ *
+ * The ROIs are cropped from the capture buffer, so the next capture must not
+ * be in flight, see set_capture_ahead() and set_continuous_capture().
+ * capture_image_async() calls made during the batch are held until it is
+ * done. The ML engine must be idle with all its results handed to
+ * app_ml_done(); the batch is typically started from app_ml_done() of the
+ * first-stage network. The p_rois array is copied.
+ *
+ * TBD-SRP: Only the ML_APP_MOD pipeline, which keeps the captured image in a
+ * buffer of its own, supports it.
+ *
+ * It returns false if the batch cannot be started, in which case done_cb is
+ * not called.
+ */
+bool run_network_on_rois_async(const struct roi_batch *p_batch);
+
+/**
+ * register_app_task() is used by the App Module to run work of its own that
+ * can wait, e.g. statistics, logging or flash writes, as a task of the FW Core
+ * main loop, see task_sched.h. The task is run at TASK_PRIO_BACKGROUND, only
+ * when the pipeline stages, the Host and the App Module callbacks have nothing
+ * to do, so that it never delays the next capture or ML run. Like the App
+ * Module callbacks, fn must do a bounded slice of work and return true if it
+ * did some, to be called again for the next slice.
+ *
+ * This function should be called from within the app_init() routine of the
+ * App Module. The task is owned by the FW Core from then on.
+ */
+void register_app_task(struct task *p_task,
+					   const char  *name,
+					   task_fn_t    fn,
+					   app_handle_t app_context);
+
 /**
  * schedule_image_processing_done_event() is used by the App Module to schedule
  * a callback from FW Core once any other waiting events have been serviced.
@@ -230,4 +483,25 @@ uint32_t read_module_data(uint32_t module_uid,
 						  uint32_t read_bytes,
 						  uint8_t *buffer);
 
+/**
+ * write_module_data() is used by the App Module to replace the data of a
+ * module it owns, from a flash sector aligned offset on. The module keeps its
+ * size, a write overflowing it is refused. It blocks until the data is
+ * programmed and verified, which takes up to tens of milliseconds per sector.
+ */
+uint32_t write_module_data(uint32_t       module_uid,
+						   uint32_t       module_write_offset,
+						   uint32_t       write_bytes,
+						   const uint8_t *buffer);
+
+/**
+ * map_module_data() is used by the App Module to read the data of a module in
+ * place from the memory-mapped flash, without copying it to RAM. It returns
+ * NULL where the flash is not mapped, the App Module then falls back to
+ * read_module_data(). The data must not be written.
+ */
+const void *map_module_data(uint32_t  module_uid,
+							uint32_t  module_read_offset,
+							uint32_t *mapped_bytes);
+
 #endif /* FW_CORE_H */
@@ -33,4 +33,15 @@ typedef bool (*rx_handler_t)(uint8_t *data, uint32_t data_length);
  */
 typedef void *app_handle_t;
 
+/**
+ * App Module provided Handler function to be called by FW Core when an App
+ * Module command registered with register_host_command() is received from
+ * Host. The command body is in body, the returned status is sent back to Host
+ * in the response of the command.
+ */
+typedef uint32_t (*host_cmd_handler_t)(app_handle_t app_context,
+									   uint8_t      command_id,
+									   uint8_t     *body,
+									   uint32_t     body_size);
+
 #endif /* GARD_TYPES_H */
@@ -138,6 +138,15 @@
 /* 2 Stage mini isp capture stage status register */
 #define GARD__2_STAGE_MISP_STATUS          (*(volatile uint32_t *)0x40010008)
 
+/**
+ * Done interrupt lines of the pipeline engines on the PLIC, following the ones
+ * of bsp/sys_platform.h.
+ * TBD-SRP: To be taken from sys_platform.h once the bitstream routes them.
+ */
+#define GARD__ML_ENG_DONE_IRQ              (6U)
+#define GARD__CAPTURE_STAGE_DONE_IRQ       (7U)
+#define GARD__RESCALE_STAGE_DONE_IRQ       (8U)
+
 /**
  * ML Engine related helper macros
  */
@@ -314,6 +323,23 @@
 		GARD__SET_BITS(GARD__CAPTURE_FEATURE_CTRL, GARD__CAPTURE_ENABLE_AWB);  \
 	})
 
+/**
+ * Sets or clears the grayscale capture of the mini-ISP, which then writes a
+ * single luminance plane instead of the three RGB planes.
+ * Usage: GARD__SET_MISP_GRAYSCALE(enable);
+ *
+ */
+#define GARD__SET_MISP_GRAYSCALE(enable)                                       \
+	({                                                                         \
+		if (enable) {                                                          \
+			GARD__SET_BITS(GARD__CAPTURE_FEATURE_CTRL,                         \
+						   GARD__CAPTURE_GRAYSCALE);                           \
+		} else {                                                               \
+			GARD__RESET_BITS(GARD__CAPTURE_FEATURE_CTRL,                       \
+							 GARD__CAPTURE_GRAYSCALE);                         \
+		}                                                                      \
+	})
+
 /**
  * Configures the image capture system with frame buffer settings and capture
  * features. Sets up the AXI configuration, frame buffer write base address, and
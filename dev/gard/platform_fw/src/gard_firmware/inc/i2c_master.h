@@ -48,10 +48,45 @@ typedef enum {
 	I2CM_STATE_READ,
 	I2CM_STATE_WRITE,
 	I2CM_STATE_TIMEOUT,
+	I2CM_STATE_QUEUED,  // transaction submitted, not completed yet
 
 	I2CM_STATE_ERROR = 0xFF
 } i2cm_state;
 
+#define I2CM_MSG_READ (0x01)  // message reads from the slave, writes otherwise
+
+/*
+ * One message of a transaction, sent after a repeated start when it is not
+ * the first one. Messages longer than the 255 bytes the controller counts are
+ * split, each part after a repeated start.
+ */
+struct i2cm_msg {
+	uint8_t *buffer;
+	uint16_t length;
+	uint8_t  flags;  // I2CM_MSG_READ
+};
+
+struct i2cm_xfer;
+
+/*
+ * Completion callback of a transaction, called from i2c_master_isr().
+ */
+typedef void (*i2cm_xfer_done_t)(struct i2cm_xfer *p_xfer);
+
+/*
+ * A transaction to the slave at address, owned by the caller until its state
+ * is no longer I2CM_STATE_QUEUED.
+ */
+struct i2cm_xfer {
+	uint16_t          address;
+	uint8_t           num_msgs;
+	struct i2cm_msg  *msgs;
+	i2cm_xfer_done_t  done;  // may be NULL
+	void             *ctx;   // for the caller's use
+	volatile uint8_t  state;  // QUEUED, then IDLE once done or ERROR
+	struct i2cm_xfer *next;
+};
+
 typedef enum {
 	I2CM_ADDR_7BIT_MODE  = 7,
 	I2CM_ADDR_10BIT_MODE = 10,
@@ -66,6 +101,15 @@ struct i2cm_instance {
 	uint16_t    interrupts_en;
 	uint8_t    *rx_buff;
 	uint8_t     rcv_length;
+	uint8_t    *tx_buff;    // bytes still to load, i2c_master_write_start()
+	uint8_t     tx_length;  // count of bytes at tx_buff
+
+	// transactions of i2c_master_xfer_submit(), the head one in flight
+	struct i2cm_xfer *xfer_head;
+	struct i2cm_xfer *xfer_tail;
+	uint8_t           msg_idx;     // message of xfer_head in flight
+	uint16_t          msg_offset;  // bytes of it loaded or received
+	uint16_t          chunk_end;   // offset where its part in flight ends
 };
 
 /*
@@ -191,6 +235,63 @@ uint8_t i2c_master_write(struct i2cm_instance *this_i2cm,
 						 uint8_t               buffer_size,
 						 uint8_t              *data_buffer);
 
+/*
+ *****************************************************************************
+ *
+ * uint8_t i2c_master_write_start(struct i2cm_instance* this_i2cm,
+ *                                uint16_t address,
+ *                                uint8_t  buffer_size,
+ *                                uint8_t  *data_buffer)
+ *
+ * starts an i2c master write operation without waiting for it to complete
+ *
+ * Note: This function loads the tx fifo and starts the transaction. The
+ * caller must keep data_buffer intact and call i2c_master_write_poll() until
+ * the transaction is no longer in progress.
+ *
+ *
+ * Arguments:
+ *    struct i2cm_instance* this_i2cm: i2c master instance
+ *    uint16_t address               : address of the slave device
+ *    uint8_t  buffer_size           : number of bytes to write
+ *    uint8_t  *data_buffer          : pointer to data buffer
+
+ *
+ * Return Value:
+ *    int: 0 if the transaction was started, 1 otherwise.
+ *
+ *
+ *****************************************************************************
+ */
+uint8_t i2c_master_write_start(struct i2cm_instance *this_i2cm,
+							   uint16_t              address,
+							   uint8_t               buffer_size,
+							   uint8_t              *data_buffer);
+
+/*
+ *****************************************************************************
+ *
+ * uint8_t i2c_master_write_poll(struct i2cm_instance* this_i2cm)
+ *
+ * progresses the write operation started by i2c_master_write_start()
+ *
+ * Note: This function refills the tx fifo and checks for completion and
+ * errors. It never waits on the bus.
+ *
+ *
+ * Arguments:
+ *    struct i2cm_instance* this_i2cm: i2c master instance
+ *
+ * Return Value:
+ *    uint8_t: I2CM_STATE_WRITE while the transaction is in progress,
+ *             I2CM_STATE_IDLE once it completed and
+ *             I2CM_STATE_ERROR if it failed (the master is reset and idle).
+ *
+ *
+ *****************************************************************************
+ */
+uint8_t i2c_master_write_poll(struct i2cm_instance *this_i2cm);
+
 /*
  *****************************************************************************
  *
@@ -226,6 +327,51 @@ uint8_t i2c_master_repeated_start(struct i2cm_instance *this_i2cm,
 								  uint8_t               rd_data_size,
 								  uint8_t              *rd_data_buffer);
 
-// void i2c_master_isr(void *ctx);
+/*
+ *****************************************************************************
+ *
+ * uint8_t i2c_master_xfer_submit(struct i2cm_instance *this_i2cm,
+ *                                struct i2cm_xfer *p_xfer)
+ *
+ * queues a transaction, started right away if the bus is free
+ *
+ * Note: The transaction runs from i2c_master_isr(), which is to be registered
+ * for the controller interrupt; the caller does not wait on the bus. Once done
+ * p_xfer->state is I2CM_STATE_IDLE, or I2CM_STATE_ERROR if it failed, and
+ * p_xfer->done is called from the ISR, where it may submit a transaction.
+ * p_xfer, its messages and their buffers are to be kept intact until then.
+ *
+ *
+ * Arguments:
+ *    struct i2cm_instance* this_i2cm: i2c master instance
+ *    struct i2cm_xfer* p_xfer       : transaction, address and messages set
+ *
+ * Return Value:
+ *    int: 0 if the transaction was queued, 1 otherwise.
+ *
+ *
+ *****************************************************************************
+ */
+uint8_t i2c_master_xfer_submit(struct i2cm_instance *this_i2cm,
+							   struct i2cm_xfer     *p_xfer);
+
+/*
+ *****************************************************************************
+ *
+ * void i2c_master_isr(void *ctx)
+ *
+ * i2c master interrupt service routine
+ *
+ * Note: This function moves the data of the transaction in flight between
+ * its buffers and the fifos, starts its next message, or completes it and
+ * starts the next queued one.
+ *
+ *
+ * Arguments:
+ *    void* ctx: i2c master instance
+ *
+ *****************************************************************************
+ */
+void i2c_master_isr(void *ctx);
 
 #endif /*I2C Master Header File */
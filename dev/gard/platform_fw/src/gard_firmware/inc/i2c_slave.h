@@ -125,6 +125,41 @@ uint8_t i2c_slave_clk_stretch(struct i2c_slave_instance *this_i2cs,
 *****************************************************************************
 */
 uint8_t  i2c_slave_config(struct i2c_slave_instance *this_i2cs);
+/*
+*****************************************************************************
+* Enable or disable the I2C slave RX interrupts
+*
+* Note: This function enables the interrupts for the RX FIFO almost full and
+* the stop condition, so that an ISR can drain the RX FIFO
+*
+*
+* Arguments:
+*    struct i2c_slave_instance *this_i2cs: i2c slave instance
+*    uint8_t enable                       : enable or disable the interrupts
+*
+* Return Value:
+*    uint8_t: status code
+*
+*
+*****************************************************************************
+*/
+uint8_t  i2c_slave_rx_int_enable(struct i2c_slave_instance *this_i2cs,
+								 uint8_t                    enable);
+/*
+*****************************************************************************
+* Clear the pending I2C slave interrupts
+*
+*
+* Arguments:
+*    struct i2c_slave_instance *this_i2cs: i2c slave instance
+*
+* Return Value:
+*    uint32_t: the interrupt status that was cleared
+*
+*
+*****************************************************************************
+*/
+uint32_t i2c_slave_clear_int(struct i2c_slave_instance *this_i2cs);
 
 uint32_t i2c_getchars(void *handle, uint8_t *rx_buf, uint32_t length);
 
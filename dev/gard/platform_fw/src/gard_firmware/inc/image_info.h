@@ -54,4 +54,16 @@ struct image_info {
 	uint32_t size;
 };
 
+/**
+ * A region of interest of an image, in pixels, with the same bounds as the
+ * crop registers of the scaler take them: from left to right and from upper
+ * to bottom.
+ */
+struct roi_box {
+	uint16_t left;
+	uint16_t right;
+	uint16_t upper;
+	uint16_t bottom;
+};
+
 #endif /* IMAGE_INFO_H */
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef IRQ_SUPPORT_H
+#define IRQ_SUPPORT_H
+
+#include "gard_types.h"
+
+/**
+ * This file defines the interfaces for handling the external interrupts of
+ * the peripherals (UART, I2C target, ...) routed to the CPU through the
+ * platform interrupt controller (PLIC).
+ *
+ * ISRs run in machine mode with interrupts disabled and must be short; the
+ * real work is left to the main loop.
+ */
+
+/* Interrupt sources that can have an ISR, see the *_INST_IRQ defines */
+#define IRQ_MAX_SOURCES (16U)
+
+/* An ISR, called with the context given to irq_register_isr() */
+typedef void (*irq_isr_t)(void *ctx);
+
+/**
+ * irq_support_init installs the trap handler, masks all interrupt sources and
+ * enables the external interrupts of the CPU.
+ */
+void irq_support_init(void);
+
+/**
+ * irq_register_isr registers the ISR of an interrupt source and enables the
+ * source.
+ */
+bool irq_register_isr(uint32_t irq, irq_isr_t isr, void *ctx);
+
+/**
+ * irq_source_enable / irq_source_disable unmask / mask an interrupt source.
+ */
+void irq_source_enable(uint32_t irq);
+
+void irq_source_disable(uint32_t irq);
+
+/**
+ * irq_event_count returns a count bumped every time interrupts are handled,
+ * so that the main loop can tell if an ISR ran since it last looked.
+ */
+uint32_t irq_event_count(void);
+
+/**
+ * irq_wake_at arms the CLINT timer to end irq_wait_for_interrupt() at the
+ * given CPU TSC time, for the work the main loop has to do at a set time.
+ */
+void irq_wake_at(uint64_t tsc);
+
+/**
+ * irq_save disables the interrupts of the CPU, returning the state to be
+ * given back to irq_restore().
+ */
+static inline uint32_t irq_save(void)
+{
+	uint32_t mstatus;
+
+	__asm__ volatile("csrrci %0, mstatus, 8" : "=r"(mstatus) : : "memory");
+
+	return mstatus;
+}
+
+/**
+ * irq_restore enables the interrupts of the CPU again if they were enabled
+ * when irq_save() was called.
+ */
+static inline void irq_restore(uint32_t mstatus)
+{
+	if (mstatus & 8U) {
+		__asm__ volatile("csrsi mstatus, 8" : : : "memory");
+	}
+}
+
+/**
+ * irq_wait_for_interrupt puts the CPU in low-power mode until an enabled
+ * interrupt source is pending. It returns even with the interrupts of the CPU
+ * disabled by irq_save(), so that the caller can check for work and sleep
+ * without missing an interrupt in between.
+ */
+static inline void irq_wait_for_interrupt(void)
+{
+	__asm__ volatile("wfi" : : : "memory");
+}
+
+#endif  // IRQ_SUPPORT_H
@@ -138,6 +138,17 @@
 #define HRAM_RISCV_START_ADDR      (HRAM_ML_IO_START_ADDR + HRAM_ML_IO_SIZE)
 #define HRAM_RISCV_SIZE            (8 * 1024 * 1024)
 
+/*
+ * Staging buffers of UPGRADE_FIRMWARE, at the top of the RISC-V region: Host
+ * sends the next chunk of the image to one while the other is programmed.
+ */
+#define HRAM_FW_UPGRADE_NUM_BUFFERS (2U)
+#define HRAM_FW_UPGRADE_BUFFER_SIZE (64U * 1024U)
+#define HRAM_FW_UPGRADE_STAGING_SIZE                                           \
+	(HRAM_FW_UPGRADE_NUM_BUFFERS * HRAM_FW_UPGRADE_BUFFER_SIZE)
+#define HRAM_FW_UPGRADE_STAGING_ADDR                                           \
+	(HRAM_RISCV_START_ADDR + HRAM_RISCV_SIZE - HRAM_FW_UPGRADE_STAGING_SIZE)
+
 /**
  *
  * HRAM layout when firmware executes entirely out of HRAM:
@@ -9,6 +9,7 @@
 #define NETWORK_INFO_H
 
 #include "gard_types.h"
+#include "gard_hub_iface.h"
 
 /**
  * This file defines the structure whose variables the App Module needs to
@@ -53,6 +54,31 @@ struct network_info {
 	 */
 	uint32_t inout_size;
 
+	/**
+	 * When set, the network gets HRAM from register_networks() and is never
+	 * evicted, e.g. for a network run on every frame. Registering more pinned
+	 * networks than fit in HRAM asserts.
+	 */
+	bool pinned;
+
+	/**
+	 * Residency priority of a network that is not pinned. When HRAM runs out,
+	 * the networks with the lowest priority are evicted first, and the least
+	 * recently run among them. The networks with the highest priority are
+	 * also given HRAM first by register_networks(). 0 is the lowest priority.
+	 */
+	uint32_t residency_priority;
+
+	/**
+	 * Format of the image the network takes as input, IMAGE_FORMAT__INVALID,
+	 * the default, being IMAGE_FORMAT__RGB_PLANAR. When all the registered
+	 * networks take IMAGE_FORMAT__GRAYSCALE, the images are captured and
+	 * rescaled as a single luminance plane, a third of the RGB planar size,
+	 * e.g. for the models trained on luminance. The snapshots for Host are
+	 * then grayscale too.
+	 */
+	enum image_formats input_format;
+
 	/**
 	 * This data is used by the FW Core for managing this network. App Module
 	 * should not write or depend on the contents of the following variables.
@@ -67,8 +93,24 @@ struct network_info {
 		/* Flag indicating if the network has been loaded in RAM. */
 		bool loaded_into_ram;
 
-		/* RAM address where this network has been loaded. */
+		/**
+		 * RAM address set aside for this network, 0 if none is. The network
+		 * is loaded there when loaded_into_ram is set.
+		 */
 		uint32_t addr_of_network_in_ram;
+
+		/* Value of the ML run counter when this network last ran, 0 never. */
+		uint32_t last_run_seq;
+
+		/* Count of times this network was loaded from flash. */
+		uint32_t count_of_loads;
+
+		/**
+		 * Set while the network in RAM, switched to by SWAP_NETWORK, differs
+		 * from its flash copy. The network is then never evicted, as it
+		 * could not be loaded again.
+		 */
+		bool swapped_in_ram;
 	} fw_core_data;
 };
 
@@ -87,13 +129,14 @@ struct network_info {
  *		.count_of_networks = 3,
  *
  *		.networks = {
- *			// First network information.
+ *			// First network information, kept in HRAM at all times.
  *			{
  *				.network = FIRST_NETWORK_HANDLE,
  *				.input_offset = 0x1000,
  *				.input_size = 0x200,
  *				.output_offset = 0x3000,
  *				.output_size = 0x400,
+ *				.pinned = true,
  *			},
  *
  *			// Second network information.
@@ -65,10 +65,16 @@ FUNCTIONALITY THROUGH THE USE OF FORMAL SOFTWARE VALIDATION METHODS.
 #define OCTAL_SPI_CONTROLLER_DRV_VER "v25.1.0"
 
 /**
- * Temporary workaround to read the flash in chunks of 256 bytes.
+ * Largest read of flash_read(), which empties the Rx FIFO only at the end of
+ * the transaction. Use flash_read_burst() for larger reads.
  */
 #define FLASH_READ_CHUNK_SIZE 256U
 
+/**
+ * Largest read of flash_read_burst(), the data length of a packet has 16 bits.
+ */
+#define FLASH_READ_BURST_MAX_SIZE 0xFFFCU
+
 //Success and Failure
 #define FAILURE                         0
 #define SUCCESS                         1
@@ -790,6 +796,7 @@ unsigned char flash_rd_reg(spix8_ctl_handle_t *handle, unsigned int *reg_data, u
 unsigned char flash_erase(spix8_ctl_handle_t *handle, unsigned int reg_addr, unsigned int pkt_fmt, unsigned int erase_type);
 unsigned char flash_program(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf, unsigned int start_addr, unsigned int pkt_fmt);
 unsigned char flash_read(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf, unsigned int start_addr, unsigned int pkt_fmt, unsigned int use_data_stb);
+unsigned char flash_read_burst(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf, unsigned int start_addr, unsigned int use_data_stb);
 unsigned char quad_xip_activate(spix8_ctl_handle_t *handle, unsigned int read_type);
 unsigned char gencmd_octspi_erase(spix8_ctl_handle_t *handle, unsigned char erase_type, unsigned int start_addr);
 unsigned char gencmd_quadspi_page_program(spix8_ctl_handle_t *handle, unsigned int num_bytes, unsigned int *dat_buf, unsigned int start_addr);
@@ -24,4 +24,41 @@ uint32_t ospi_read_from_flash(void    *handle,
 							  uint32_t flash_addr,
 							  uint32_t num_bytes);
 
+/**
+ * ospi_map_flash returns the address at which the CPU can read num_bytes of
+ * the flash starting from flash_addr directly, NULL if the flash is not
+ * mapped on this platform (OSPI_FLASH_MAP_BASE_ADDR is not defined).
+ */
+const void *ospi_map_flash(void    *handle,
+						   uint32_t flash_addr,
+						   uint32_t num_bytes);
+
+/**
+ * Size of the flash sectors erased by ospi_erase_sector_async() and of the
+ * pages programmed by ospi_program_page_async().
+ */
+#define OSPI_FLASH_SECTOR_SIZE (4U * 1024U)
+#define OSPI_FLASH_PAGE_SIZE   (256U)
+
+/**
+ * ospi_erase_sector_async starts the erase of the flash sector at flash_addr
+ * and returns without waiting for the flash, see ospi_is_flash_busy().
+ */
+bool ospi_erase_sector_async(void *handle, uint32_t flash_addr);
+
+/**
+ * ospi_program_page_async starts programming num_bytes of p_data at flash_addr,
+ * within one flash page, and returns without waiting for the flash, see
+ * ospi_is_flash_busy().
+ */
+bool ospi_program_page_async(void           *handle,
+							 const uint32_t *p_data,
+							 uint32_t        flash_addr,
+							 uint32_t        num_bytes);
+
+/**
+ * ospi_is_flash_busy tells if the flash is still erasing or programming.
+ */
+bool ospi_is_flash_busy(void *handle);
+
 #endif /* OSPI_SUPPORT_H */
@@ -308,6 +308,13 @@ struct rfs_dir_entry {
 	uint32_t size;
 } __attribute__((packed));
 
+/**
+ * rfs_set_config_addr() selects the RFS to look the modules up in, by the
+ * flash address of its configuration section, RFS_CONFIG_START_ADDR by
+ * default. See fw_boot.h for the RFS of each firmware slot.
+ */
+void rfs_set_config_addr(uint32_t config_addr);
+
 /**
  * load_configuration_section() loads the configuration section from Flash
  * memory into the provided buffer.
@@ -316,6 +323,13 @@ bool load_configuration_section(void    *ospi_handle,
 								void    *buffer,
 								uint32_t buffer_size);
 
+/**
+ * rfs_mount() caches the RFS directory in RAM, sorted by UID, so that module
+ * lookups do not read the configuration and directory from flash each time.
+ * It is called on the first lookup if not called before.
+ */
+bool rfs_mount(void *ospi_handle);
+
 /**
  * locate_module_id() locates the module in the directory stored in flash memory
  * and returns the start address and size of the module.
@@ -336,5 +350,26 @@ uint32_t read_module_from_rfs(void    *ospi_handle,
 							  uint32_t read_bytes,
 							  void    *buffer);
 
+/**
+ * write_module_to_rfs() replaces the data of the module with the specified UID
+ * in Flash memory, from a sector aligned offset on, and blocks until it is
+ * programmed and verified. The module keeps its place and size.
+ */
+uint32_t write_module_to_rfs(void       *ospi_handle,
+							 uint32_t    module_uid,
+							 uint32_t    module_write_offset,
+							 uint32_t    write_bytes,
+							 const void *buffer);
+
+/**
+ * map_module_from_rfs() returns the address at which the module with the
+ * specified UID can be read directly from the memory-mapped flash, NULL if the
+ * flash is not mapped.
+ */
+const void *map_module_from_rfs(void     *ospi_handle,
+								uint32_t  module_uid,
+								uint32_t  module_read_offset,
+								uint32_t *mapped_bytes);
+
 #endif /* RFS_H */
 
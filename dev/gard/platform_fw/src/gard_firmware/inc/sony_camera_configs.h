@@ -33,7 +33,19 @@ bool detect_image_sensor(uint16_t              image_sensor_id,
  * by calculating the optimal exposure based on the camera exposure range.
  *
  * @param target_gray_avg is the target gray average value (0-255)
+ *
+ * @return true if a new exposure was queued for the camera, false otherwise.
+ */
+bool set_exposure(uint32_t target_gray_avg);
+
+/**
+ * set_image_sensor_standby() puts the image sensor in software standby, which
+ * stops its frames, or back to streaming, by a queued write.
+ *
+ * @param standby is true to stop streaming, false to start again.
+ *
+ * @return true if the write was queued, false if the queue is full.
  */
-void set_exposure(uint32_t target_gray_avg);
+bool set_image_sensor_standby(bool standby);
 
 #endif /* SONY_CAMERA_CONFIG_H */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef SW_TIMER_H
+#define SW_TIMER_H
+
+#include "gard_types.h"
+
+/**
+ * This file defines the software timers of the main loop. Any number of
+ * timers can be armed at once; they are kept sorted by expiry and the CLINT
+ * timer interrupt is armed for the earliest one, so that the main loop wakes
+ * from WFI when it is due instead of polling the time.
+ *
+ * The callbacks run from the main loop, see sw_timers_run(), never from an
+ * ISR; like tasks they must do a bounded piece of work and return. The timer
+ * functions are not to be called from ISRs.
+ */
+
+/**
+ * A timer callback, called with the context given to sw_timer_init().
+ */
+typedef void (*sw_timer_fn_t)(void *ctx);
+
+/**
+ * A timer, to be statically allocated by its owner and set up with
+ * sw_timer_init().
+ */
+struct sw_timer {
+	const char      *name;
+	sw_timer_fn_t    fn;
+	void            *ctx;
+	uint64_t         expiry;        // CPU TSC time it is due at
+	uint32_t         period_ticks;  // Re-armed this much later, 0 if one shot
+	bool             is_armed;
+	struct sw_timer *next;
+};
+
+/**
+ * sw_timer_init sets up a timer, not armed.
+ */
+void sw_timer_init(struct sw_timer *p_timer, const char *name,
+				   sw_timer_fn_t fn, void *ctx);
+
+/**
+ * sw_timer_start arms a timer to fire delay_ms from now, then every
+ * period_ms if period_ms is not 0. A timer already armed is re-armed.
+ */
+void sw_timer_start(struct sw_timer *p_timer, uint32_t delay_ms,
+					uint32_t period_ms);
+
+/**
+ * sw_timer_stop disarms a timer, if armed.
+ */
+void sw_timer_stop(struct sw_timer *p_timer);
+
+/**
+ * sw_timer_is_armed returns true if the timer is yet to fire.
+ */
+bool sw_timer_is_armed(const struct sw_timer *p_timer);
+
+/**
+ * sw_timers_run calls the callbacks of the timers due, to be run as a task of
+ * the main loop. It returns true if any timer fired.
+ */
+bool sw_timers_run(void);
+
+#endif  // SW_TIMER_H
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef TASK_SCHED_H
+#define TASK_SCHED_H
+
+#include "gard_types.h"
+
+/**
+ * This file defines a cooperative, run-to-completion scheduler for the main
+ * loop. A task is a function that does a bounded slice of work and returns;
+ * it is called again on a later round for the next slice. Tasks never block
+ * and are never preempted by another task, only by ISRs.
+ *
+ * Tasks are grouped by priority. On every round the levels are run from the
+ * highest priority down, and a level is only reached when all the levels
+ * above it found nothing to do, so that e.g. kicking off the next capture or
+ * ML run is never held up behind post-processing.
+ */
+
+/**
+ * Priority levels, highest first.
+ */
+enum task_prio {
+	TASK_PRIO_PIPELINE = 0,  // Capture / rescale / ML stage completions
+	TASK_PRIO_HOST,          // Host commands and interface handlers
+	TASK_PRIO_APP,           // App Module callbacks, post-processing
+	TASK_PRIO_BACKGROUND,    // Deferrable App Module work
+	TASK_PRIO_NB,
+};
+
+/**
+ * A level that was skipped this many rounds in a row for higher priority work
+ * gets to run anyway, so that a busy level cannot starve the ones below it.
+ */
+#define TASK_SCHED_MAX_SKIPPED_ROUNDS (8U)
+
+/**
+ * A task runs one slice of work. It returns true if it did some work, false
+ * if there was nothing to do.
+ */
+typedef bool (*task_fn_t)(void *ctx);
+
+/**
+ * The run statistics of a task, in CPU TSC units (see get_cpu_tsc()).
+ * 32-bit counters are enough as the TSC runs at 32 KHz.
+ */
+struct task_stats {
+	uint32_t runs;        // Number of slices that did work
+	uint32_t busy_ticks;  // Total time spent in those slices
+	uint32_t max_ticks;   // Longest slice
+};
+
+/**
+ * A task, to be statically allocated by its owner and registered with
+ * task_register().
+ */
+struct task {
+	const char       *name;
+	task_fn_t         fn;
+	void             *ctx;
+	enum task_prio    prio;
+	struct task_stats stats;
+	struct task      *next;
+};
+
+/**
+ * task_register adds a task to its priority level, after the tasks already
+ * registered at that level.
+ */
+void task_register(struct task *p_task, const char *name, task_fn_t fn,
+				   void *ctx, enum task_prio prio);
+
+/**
+ * task_sched_run runs one round of the scheduler. It returns true if any task
+ * did some work, false if all tasks are idle.
+ */
+bool task_sched_run(void);
+
+/**
+ * task_sched_for_each calls fn for every registered task, highest priority
+ * first, e.g. to report the task statistics.
+ */
+void task_sched_for_each(void (*fn)(const struct task *p_task, void *ctx),
+						 void *ctx);
+
+#endif  // TASK_SCHED_H
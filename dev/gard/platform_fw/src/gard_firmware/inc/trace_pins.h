@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: UNLICENSED
+ *
+ ******************************************************************************/
+
+#ifndef TRACE_PINS_H
+#define TRACE_PINS_H
+
+/**
+ * This file defines the trace points of the pipeline stages. Built with
+ * GARD_TRACE_PINS, see FW_TRACE_PINS in Makefile.vars, TRACE_BEGIN(id) drives
+ * the GPIO pin of the trace id high and TRACE_END(id) low, so that a logic
+ * analyser times each stage to the sample, without UART prints. The captures
+ * are turned into latency tables by scripts/TracePinsReport.py, or decoded in
+ * PulseView with scripts/sigrok/gard_trace. Without GARD_TRACE_PINS the trace
+ * points compile to nothing.
+ *
+ * The trace pins are spare pins of GPIO 0, kept clear of the pins of
+ * gpio_mapper.h, see gpio_init(). A trace id is mapped to its pin with
+ * TRACE_PIN_<id>, which can be given on the command line; TRACE_PIN_NONE
+ * leaves it out.
+ */
+
+#include "gard_types.h"
+#include "gpio.h"
+#include "gpio_support.h"
+
+/* GPIO instance the trace pins are on */
+#define TRACE_PINS_INST gpio_0
+
+/* Trace id mapped to no pin */
+#define TRACE_PIN_NONE  (0xFFU)
+
+/* Camera capture, or capture and rescale by the scaler engine of HMI */
+#ifndef TRACE_PIN_CAPTURE
+#define TRACE_PIN_CAPTURE GPIO_PIN_1
+#endif
+
+/* Rescale of a captured, or Host, image to the network input */
+#ifndef TRACE_PIN_RESCALE
+#define TRACE_PIN_RESCALE GPIO_PIN_2
+#endif
+
+/* Move of the rescaled image to the ML engine */
+#ifndef TRACE_PIN_ML_COPY
+#define TRACE_PIN_ML_COPY GPIO_PIN_3
+#endif
+
+/* ML engine run, start to done */
+#ifndef TRACE_PIN_ML_RUN
+#define TRACE_PIN_ML_RUN GPIO_PIN_4
+#endif
+
+#ifdef GARD_TRACE_PINS
+
+#define TRACE_PIN_WRITE(pin, value)                             \
+	do {                                                        \
+		if (TRACE_PIN_NONE != (pin)) {                          \
+			gpio_pin_write(&TRACE_PINS_INST, (pin), (value));   \
+		}                                                       \
+	} while (0)
+
+#else
+
+#define TRACE_PIN_WRITE(pin, value) \
+	do {                            \
+	} while (0)
+
+#endif /* GARD_TRACE_PINS */
+
+/* Start of the stage of trace id, e.g. TRACE_BEGIN(ML_RUN) */
+#define TRACE_BEGIN(id) TRACE_PIN_WRITE(TRACE_PIN_##id, GPIO_OUTPUT_HIGH)
+
+/* End of the stage of trace id */
+#define TRACE_END(id)   TRACE_PIN_WRITE(TRACE_PIN_##id, GPIO_OUTPUT_LOW)
+
+#endif /* TRACE_PINS_H */
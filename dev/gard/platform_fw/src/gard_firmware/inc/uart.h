@@ -118,6 +118,9 @@ uint8_t  uart_config(struct uart_instance *this_uart,
 					 uint8_t               parity_en,
 					 uint8_t               even_odd,
 					 uint32_t              stopbits);
+bool     uart_is_tx_idle(struct uart_instance *this_uart);
+void     uart_rx_int_enable(struct uart_instance *this_uart, bool enable);
+void     uart_tx_int_enable(struct uart_instance *this_uart, bool enable);
 uint32_t uart_getchars(void *handle, uint8_t *buffer, uint32_t count);
 uint32_t uart_putchars(void *handle, uint8_t *buffer, uint32_t count);
 
@@ -19,6 +19,19 @@
 
 #define GET_ARRAY_COUNT(array) (sizeof(array) / sizeof((array)[0]))
 
+/**
+ * GARD__HOT places a function with the hot path code, run for every frame or
+ * host request (ISRs, host request service, post-processing kernels). The hot
+ * code is grouped at the start of the TCM code, see gard_fw.ld, so it stays
+ * contiguous whatever the link order.
+ *
+ * GARD__COLD places a function with the cold code, run once or on errors (init,
+ * configuration), grouped after all the other code. The compiler also
+ * optimises it for size and its callers for the paths not calling it.
+ */
+#define GARD__HOT              __attribute__((section(".text_hot")))
+#define GARD__COLD             __attribute__((cold, section(".text_cold")))
+
 #define GET_MEMBER_OFFSET(container_type, member)                              \
 	(cpu_size_t)(&(((container_type *)0)->member))
 
@@ -36,11 +49,34 @@
 uint32_t calculate_checksum(uint8_t *data, uint32_t size);
 
 /**
- * memcpy() copies 'size' bytes from 'src' to 'dest'.
- * The function does not handle overlapping memory regions.
+ * checksum_update() returns the checksum of previous data with checksum
+ * 'checksum' followed by the given data, so that it can be computed while
+ * the data streams in.
+ */
+uint32_t checksum_update(uint32_t checksum, const uint8_t *data, uint32_t size);
+
+/**
+ * crc32_update() returns the CRC-32 of previous data with CRC 'crc' followed
+ * by the given data.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t size);
+
+#ifdef GARD_HOST_SIM
+/* The host simulation of the App Modules uses the C library ones. */
+#include <string.h>
+#else
+/**
+ * memcpy() copies 'size' bytes from 'src' to 'dest', by words when both have
+ * the same alignment within a word. The function does not handle overlapping
+ * memory regions.
  */
 void *memcpy(void *dest, const void *src, uint32_t size);
 
+/**
+ * memmove() copies 'size' bytes from 'src' to 'dest', which may overlap.
+ */
+void *memmove(void *dest, const void *src, uint32_t size);
+
 /**
  * memcpy_w() copies 'size' bytes from 'src' to 'dest' in word (4-byte)
  * increments. The function expects 'src' and 'dest' to be word-aligned and
@@ -50,9 +86,11 @@ void *memcpy(void *dest, const void *src, uint32_t size);
 uint32_t *memcpy_w(uint32_t *dest, const uint32_t *src, uint32_t size);
 
 /**
- * memset() sets 'size' bytes in 'buffer' to the specified 'value'.
+ * memset() sets 'size' bytes in 'buffer' to the specified 'value', by words
+ * once 'buffer' is word aligned.
  */
 void *memset(void *buffer, int32_t value, uint32_t size);
+#endif /* GARD_HOST_SIM */
 
 /**
  * get_cpu_tsc() reads and returns the current value of the CPU's Time Stamp
@@ -65,16 +103,4 @@ uint64_t get_cpu_tsc(void);
  */
 void delay(uint32_t delay_in_ms);
 
-/**
- * set_timer_for_time() sets a timer to expire after the specified time in
- * ms. It returns the absolute time (in CPU TSC units) when the timer will
- * expire.
- */
-uint64_t set_timer_for_time(uint32_t time_in_ms);
-
-/**
- * has_timer_expired() checks if the previously set timer has expired.
- */
-bool has_timer_expired(void);
-
 #endif /* UTILS_H */
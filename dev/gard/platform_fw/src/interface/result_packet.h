@@ -0,0 +1,506 @@
+/******************************************************************************
+ * Copyright (c) 2025 Lattice Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ ******************************************************************************/
+
+#ifndef RESULT_PACKET_H
+#define RESULT_PACKET_H
+
+/**
+ * Make sure the compiler search path uses the types.h in the interface folder
+ * for maximum compatibility between GARD and HUB.
+ */
+#include "types.h"
+
+/**
+ * Compact result packet, written by the App Modules on GARD and read on Host.
+ *
+ * The packet starts like the legacy RT_DATA packet, so that a reader can tell
+ * them apart from the record type:
+ *
+ *   u8   RESULT_PACKET_START_FLAG
+ *   u16  size of the packet after this field, little endian
+ *   u8   RESULT_PACKET_RECORD_TYPE
+ *   u8   RESULT_PACKET_VERSION
+ *
+ * followed by the header:
+ *
+ *   varint  frame sequence number of the image, see get_frame_sequence()
+ *   varint  capture start time of the image, in ms of the GARD time (see
+ *           GET_GARD_TIME), wrapping at 2^32
+ *   svarint ROI left, top
+ *   varint  ROI width, height
+ *   u16     number of records, little endian
+ *
+ * and by the records. Each record starts with a tag byte, the record kind in
+ * the upper 4 bits and the optional fields present in the lower 4 bits:
+ *
+ *   RESULT_RECORD_OBJECT:
+ *     svarint left, top, relative to the ROI left, top
+ *     varint  width, height
+ *     varint  class                  if RESULT_FIELD_CLASS
+ *     varint  confidence, Q10        if RESULT_FIELD_CONFIDENCE
+ *     varint  track ID               if RESULT_FIELD_TRACK_ID
+ *   RESULT_RECORD_SCORE:
+ *     svarint score
+ *     u8      score fractional bits
+ *     u8      verdict, 0 or 1        if RESULT_FIELD_VERDICT
+ *   RESULT_RECORD_UNCHANGED:
+ *     nothing, the results are the same as in the last packet with records
+ *     of the other kinds; a heartbeat sent instead of repeating them
+ *   RESULT_RECORD_HEATMAP:
+ *     u8      columns, rows of the grid of cells over the ROI
+ *     u8      value of each cell, row by row, columns * rows of them
+ *
+ * varint is an unsigned LEB128 number, 7 bits per byte, low bits first, and
+ * svarint the zigzag encoding of a signed one as a varint, so that the
+ * coordinates of an object take 1 to 2 bytes each instead of 2 to 4.
+ * A reader skips the records of a kind it does not know only if it knows
+ * their size, so a new kind bumps RESULT_PACKET_VERSION.
+ */
+
+#define RESULT_PACKET_START_FLAG   (0x7Eu)
+#define RESULT_PACKET_RECORD_TYPE  (0x02u) /* legacy RT_DATA is 0x01 */
+#define RESULT_PACKET_VERSION      (0x03u) /* 0x03 adds HEATMAP records */
+
+/* Size of the start flag, size, record type and version fields */
+#define RESULT_PACKET_PREAMBLE_SIZE (5u)
+
+/* Largest size of an object record, with all of its optional fields */
+#define RESULT_PACKET_MAX_OBJECT_SIZE (1u + 4u * 5u + 3u * 5u)
+
+/* Size of a heatmap record of cells_nb cells */
+#define RESULT_PACKET_HEATMAP_SIZE(cells_nb) (3u + (cells_nb))
+
+enum result_record_kinds {
+	RESULT_RECORD_OBJECT    = 0x1u,
+	RESULT_RECORD_SCORE     = 0x2u,
+	RESULT_RECORD_UNCHANGED = 0x3u,
+	RESULT_RECORD_HEATMAP   = 0x4u,
+};
+
+enum result_record_fields {
+	/* Object records */
+	RESULT_FIELD_CLASS      = (1 << 0),
+	RESULT_FIELD_CONFIDENCE = (1 << 1),
+	RESULT_FIELD_TRACK_ID   = (1 << 2),
+
+	/* Score records */
+	RESULT_FIELD_VERDICT    = (1 << 0),
+};
+
+struct result_packet_header {
+	uint32_t sequence;
+	uint32_t timestamp_ms;
+	int32_t  roi_left;
+	int32_t  roi_top;
+	uint32_t roi_width;
+	uint32_t roi_height;
+	uint16_t records_nb;
+};
+
+/**
+ * A record as read. Only the fields of its kind, and among the optional ones
+ * those set in fields, are meaningful.
+ */
+struct result_packet_record {
+	uint8_t  kind;
+	uint8_t  fields;
+
+	/* RESULT_RECORD_OBJECT, in the coordinates of the ROI */
+	int32_t  left;
+	int32_t  top;
+	int32_t  right;
+	int32_t  bottom;
+	uint32_t object_class;
+	uint32_t confidence;
+	uint32_t track_id;
+
+	/* RESULT_RECORD_SCORE */
+	int32_t  score;
+	uint8_t  score_frac_bits;
+	uint8_t  verdict;
+
+	/* RESULT_RECORD_HEATMAP, the cells point in the packet buffer */
+	uint8_t        heatmap_columns;
+	uint8_t        heatmap_rows;
+	const uint8_t *heatmap;
+};
+
+/**
+ * Writes a packet into a buffer. Once a record does not fit, it and the
+ * following ones are dropped, the packet keeps the records written before.
+ */
+struct result_packet_writer {
+	uint8_t *buf;
+	uint32_t capacity;
+	uint32_t size;
+	uint32_t records_nb_pos;
+	uint16_t records_nb;
+	int32_t  roi_left;
+	int32_t  roi_top;
+	bool     overflow;
+};
+
+/**
+ * Reads a packet from a buffer. Reading past the end of the packet fails.
+ */
+struct result_packet_reader {
+	const uint8_t *buf;
+	uint32_t size;
+	uint32_t pos;
+	int32_t  roi_left;
+	int32_t  roi_top;
+	uint16_t records_left;
+};
+
+/* Writer */
+
+static inline void result_packet_put_u8(struct result_packet_writer *w,
+										uint8_t value)
+{
+	if (w->size >= w->capacity) {
+		w->overflow = true;
+		return;
+	}
+	w->buf[w->size++] = value;
+}
+
+static inline void result_packet_put_u16(struct result_packet_writer *w,
+										 uint16_t value)
+{
+	result_packet_put_u8(w, (uint8_t)value);
+	result_packet_put_u8(w, (uint8_t)(value >> 8));
+}
+
+static inline void result_packet_put_varint(struct result_packet_writer *w,
+											uint32_t value)
+{
+	while (value >= 0x80u) {
+		result_packet_put_u8(w, (uint8_t)(value | 0x80u));
+		value >>= 7;
+	}
+	result_packet_put_u8(w, (uint8_t)value);
+}
+
+static inline void result_packet_put_svarint(struct result_packet_writer *w,
+											 int32_t value)
+{
+	result_packet_put_varint(
+		w, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/**
+ * result_packet_begin() starts a packet in buf, of capacity bytes, and writes
+ * its header. The object coordinates are then written relative to the ROI.
+ */
+static inline void result_packet_begin(struct result_packet_writer *w,
+									   uint8_t *buf, uint32_t capacity,
+									   uint32_t sequence,
+									   uint32_t timestamp_ms,
+									   int32_t roi_left, int32_t roi_top,
+									   uint32_t roi_width,
+									   uint32_t roi_height)
+{
+	w->buf            = buf;
+	w->capacity       = capacity;
+	w->size           = 0;
+	w->records_nb     = 0;
+	w->roi_left       = roi_left;
+	w->roi_top        = roi_top;
+	w->overflow       = false;
+
+	result_packet_put_u8(w, RESULT_PACKET_START_FLAG);
+	result_packet_put_u16(w, 0); /* set by result_packet_end() */
+	result_packet_put_u8(w, RESULT_PACKET_RECORD_TYPE);
+	result_packet_put_u8(w, RESULT_PACKET_VERSION);
+
+	result_packet_put_varint(w, sequence);
+	result_packet_put_varint(w, timestamp_ms);
+	result_packet_put_svarint(w, roi_left);
+	result_packet_put_svarint(w, roi_top);
+	result_packet_put_varint(w, roi_width);
+	result_packet_put_varint(w, roi_height);
+
+	w->records_nb_pos = w->size;
+	result_packet_put_u16(w, 0); /* set by result_packet_end() */
+}
+
+/**
+ * result_packet_add_object() writes an object record, with the optional
+ * fields set in fields. Returns false, writing nothing, if it does not fit.
+ */
+static inline bool result_packet_add_object(struct result_packet_writer *w,
+											uint8_t fields, int32_t left,
+											int32_t top, int32_t right,
+											int32_t bottom,
+											uint32_t object_class,
+											uint32_t confidence,
+											uint32_t track_id)
+{
+	uint32_t start = w->size;
+
+	result_packet_put_u8(w, (uint8_t)((RESULT_RECORD_OBJECT << 4) | fields));
+	result_packet_put_svarint(w, left - w->roi_left);
+	result_packet_put_svarint(w, top - w->roi_top);
+	result_packet_put_varint(w, (uint32_t)(right - left));
+	result_packet_put_varint(w, (uint32_t)(bottom - top));
+	if (fields & RESULT_FIELD_CLASS) {
+		result_packet_put_varint(w, object_class);
+	}
+	if (fields & RESULT_FIELD_CONFIDENCE) {
+		result_packet_put_varint(w, confidence);
+	}
+	if (fields & RESULT_FIELD_TRACK_ID) {
+		result_packet_put_varint(w, track_id);
+	}
+
+	if (w->overflow) {
+		w->size = start;
+		return false;
+	}
+	w->records_nb++;
+	return true;
+}
+
+/**
+ * result_packet_add_score() writes a score record, with a verdict if
+ * RESULT_FIELD_VERDICT is set in fields. Returns false, writing nothing, if it
+ * does not fit.
+ */
+static inline bool result_packet_add_score(struct result_packet_writer *w,
+										   uint8_t fields, int32_t score,
+										   uint8_t score_frac_bits,
+										   bool verdict)
+{
+	uint32_t start = w->size;
+
+	result_packet_put_u8(w, (uint8_t)((RESULT_RECORD_SCORE << 4) | fields));
+	result_packet_put_svarint(w, score);
+	result_packet_put_u8(w, score_frac_bits);
+	if (fields & RESULT_FIELD_VERDICT) {
+		result_packet_put_u8(w, verdict ? 1 : 0);
+	}
+
+	if (w->overflow) {
+		w->size = start;
+		return false;
+	}
+	w->records_nb++;
+	return true;
+}
+
+/**
+ * result_packet_add_unchanged() writes an unchanged record, see
+ * RESULT_RECORD_UNCHANGED. Returns false, writing nothing, if it does not fit.
+ */
+static inline bool result_packet_add_unchanged(struct result_packet_writer *w)
+{
+	result_packet_put_u8(w, (uint8_t)(RESULT_RECORD_UNCHANGED << 4));
+
+	if (w->overflow) {
+		return false;
+	}
+	w->records_nb++;
+	return true;
+}
+
+/**
+ * result_packet_add_heatmap() writes a heatmap record of columns * rows cells,
+ * row by row. Returns false, writing nothing, if it does not fit.
+ */
+static inline bool result_packet_add_heatmap(struct result_packet_writer *w,
+											 uint8_t columns, uint8_t rows,
+											 const uint8_t *cells)
+{
+	uint32_t start = w->size;
+	uint32_t cells_nb = (uint32_t)columns * rows;
+
+	result_packet_put_u8(w, (uint8_t)(RESULT_RECORD_HEATMAP << 4));
+	result_packet_put_u8(w, columns);
+	result_packet_put_u8(w, rows);
+	for (uint32_t i = 0; i < cells_nb; i++) {
+		result_packet_put_u8(w, cells[i]);
+	}
+
+	if (w->overflow) {
+		w->size = start;
+		return false;
+	}
+	w->records_nb++;
+	return true;
+}
+
+/**
+ * result_packet_end() completes the size and number of records of the packet.
+ * Returns the size of the packet, or 0 if its header did not fit.
+ */
+static inline uint32_t result_packet_end(struct result_packet_writer *w)
+{
+	if (w->records_nb_pos + 2 > w->capacity) {
+		return 0;
+	}
+	w->buf[1] = (uint8_t)(w->size - 3);
+	w->buf[2] = (uint8_t)((w->size - 3) >> 8);
+	w->buf[w->records_nb_pos]     = (uint8_t)w->records_nb;
+	w->buf[w->records_nb_pos + 1] = (uint8_t)(w->records_nb >> 8);
+	return w->size;
+}
+
+/* Reader */
+
+static inline bool result_packet_get_u8(struct result_packet_reader *r,
+										uint8_t *value)
+{
+	if (r->pos >= r->size) {
+		return false;
+	}
+	*value = r->buf[r->pos++];
+	return true;
+}
+
+static inline bool result_packet_get_varint(struct result_packet_reader *r,
+											uint32_t *value)
+{
+	uint8_t byte;
+
+	*value = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7) {
+		if (!result_packet_get_u8(r, &byte)) {
+			return false;
+		}
+		*value |= (uint32_t)(byte & 0x7Fu) << shift;
+		if (!(byte & 0x80u)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline bool result_packet_get_svarint(struct result_packet_reader *r,
+											 int32_t *value)
+{
+	uint32_t zigzag;
+
+	if (!result_packet_get_varint(r, &zigzag)) {
+		return false;
+	}
+	*value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1u);
+	return true;
+}
+
+/**
+ * result_packet_read_header() checks the preamble of the packet in buf, of
+ * size bytes, and reads its header. Returns false if buf does not hold a
+ * complete compact result packet of a known version, e.g. a legacy RT_DATA one.
+ */
+static inline bool result_packet_read_header(struct result_packet_reader *r,
+											 const uint8_t *buf,
+											 uint32_t size,
+											 struct result_packet_header *hdr)
+{
+	uint32_t packet_size;
+
+	if (size < RESULT_PACKET_PREAMBLE_SIZE ||
+		buf[0] != RESULT_PACKET_START_FLAG ||
+		buf[3] != RESULT_PACKET_RECORD_TYPE ||
+		buf[4] != RESULT_PACKET_VERSION) {
+		return false;
+	}
+	packet_size = 3u + (buf[1] | ((uint32_t)buf[2] << 8));
+	if (packet_size > size) {
+		return false;
+	}
+
+	r->buf  = buf;
+	r->size = packet_size;
+	r->pos  = RESULT_PACKET_PREAMBLE_SIZE;
+
+	if (!result_packet_get_varint(r, &hdr->sequence) ||
+		!result_packet_get_varint(r, &hdr->timestamp_ms) ||
+		!result_packet_get_svarint(r, &hdr->roi_left) ||
+		!result_packet_get_svarint(r, &hdr->roi_top) ||
+		!result_packet_get_varint(r, &hdr->roi_width) ||
+		!result_packet_get_varint(r, &hdr->roi_height) ||
+		r->pos + 2 > r->size) {
+		return false;
+	}
+	hdr->records_nb = buf[r->pos] | ((uint16_t)buf[r->pos + 1] << 8);
+	r->pos += 2;
+
+	r->roi_left     = hdr->roi_left;
+	r->roi_top      = hdr->roi_top;
+	r->records_left = hdr->records_nb;
+	return true;
+}
+
+/**
+ * result_packet_read_record() reads the next record of the packet. Returns
+ * false once all records are read, or if the packet is malformed.
+ */
+static inline bool result_packet_read_record(struct result_packet_reader *r,
+											 struct result_packet_record *rec)
+{
+	uint8_t tag;
+	uint32_t width, height;
+
+	if (r->records_left == 0 || !result_packet_get_u8(r, &tag)) {
+		return false;
+	}
+	r->records_left--;
+	rec->kind   = tag >> 4;
+	rec->fields = tag & 0x0Fu;
+
+	switch (rec->kind) {
+	case RESULT_RECORD_OBJECT:
+		if (!result_packet_get_svarint(r, &rec->left) ||
+			!result_packet_get_svarint(r, &rec->top) ||
+			!result_packet_get_varint(r, &width) ||
+			!result_packet_get_varint(r, &height)) {
+			return false;
+		}
+		rec->left  += r->roi_left;
+		rec->top   += r->roi_top;
+		rec->right  = rec->left + (int32_t)width;
+		rec->bottom = rec->top + (int32_t)height;
+		if (((rec->fields & RESULT_FIELD_CLASS) &&
+			 !result_packet_get_varint(r, &rec->object_class)) ||
+			((rec->fields & RESULT_FIELD_CONFIDENCE) &&
+			 !result_packet_get_varint(r, &rec->confidence)) ||
+			((rec->fields & RESULT_FIELD_TRACK_ID) &&
+			 !result_packet_get_varint(r, &rec->track_id))) {
+			return false;
+		}
+		return true;
+
+	case RESULT_RECORD_SCORE:
+		if (!result_packet_get_svarint(r, &rec->score) ||
+			!result_packet_get_u8(r, &rec->score_frac_bits) ||
+			((rec->fields & RESULT_FIELD_VERDICT) &&
+			 !result_packet_get_u8(r, &rec->verdict))) {
+			return false;
+		}
+		return true;
+
+	case RESULT_RECORD_UNCHANGED:
+		return true;
+
+	case RESULT_RECORD_HEATMAP:
+		if (!result_packet_get_u8(r, &rec->heatmap_columns) ||
+			!result_packet_get_u8(r, &rec->heatmap_rows) ||
+			r->size - r->pos <
+				(uint32_t)rec->heatmap_columns * rec->heatmap_rows) {
+			return false;
+		}
+		rec->heatmap = &r->buf[r->pos];
+		r->pos += (uint32_t)rec->heatmap_columns * rec->heatmap_rows;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+#endif  // RESULT_PACKET_H
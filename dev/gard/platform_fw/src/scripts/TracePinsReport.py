@@ -0,0 +1,177 @@
+################################################################################
+# Copyright (c) 2025 Lattice Semiconductor Corporation
+#
+# SPDX-License-Identifier: UNLICENSED
+################################################################################
+
+
+################################################################################
+# This file turns a logic analyser capture of the GARD trace pins into latency
+# tables of the pipeline stages. The firmware drives the pins when built with
+# FW_TRACE_PINS=true, see inc/trace_pins.h: a pin is high from the start of
+# its stage to its end.
+#
+# The capture is a sigrok session file (.sr), as saved by sigrok-cli or
+# PulseView, e.g.:
+#
+#   sigrok-cli -d fx2lafw --config samplerate=4m --time 5s \
+#       -C D1=capture,D2=rescale,D3=ml_copy,D4=ml_run -o gard.sr
+#   python TracePinsReport.py gard.sr
+#
+# The channels are found by their names, or given with --stage, e.g.
+# --stage ml_run=D4. For each stage the script prints the count, minimum,
+# average, 99th percentile and maximum of its spans, then the frame period,
+# from a capture start to the next, and the latency from a capture start to
+# the end of the ML run on its image.
+#
+# The same stages can be looked at in PulseView with the gard_trace decoder of
+# scripts/sigrok, installed in the sigrok decoders path.
+################################################################################
+
+import argparse
+import configparser
+import sys
+import zipfile
+
+# Stages in pipeline order, named as the trace ids of inc/trace_pins.h.
+STAGES = ['capture', 'rescale', 'ml_copy', 'ml_run']
+
+parser = argparse.ArgumentParser(description='Latency tables of the GARD trace pins', formatter_class=argparse.RawTextHelpFormatter)
+
+parser.add_argument('capture', metavar="FILE", type=str,
+					help='sigrok session file (.sr) of the trace pins')
+parser.add_argument('-s', '--stage', action='append', type=str, default=[],
+					help="""STAGE=CHANNEL maps a stage to a channel of the capture, by name or by
+					index from 0, e.g. --stage ml_run=D4. Stages: """ + ', '.join(STAGES))
+parser.add_argument('-u', '--unit', choices=['us', 'ms'], default='us',
+					help='Unit of the tables, us by default')
+
+
+# Reads the samplerate, the channel names and the samples of a sigrok session.
+# It returns the samplerate in Hz, the channel names by index and the samples
+# as an integer per sample, bit N being channel N.
+def read_session(path):
+	with zipfile.ZipFile(path) as sr:
+		meta = configparser.ConfigParser()
+		meta.read_string(sr.read('metadata').decode('utf-8'))
+
+		device = next(s for s in meta.sections() if s.startswith('device'))
+		dev = meta[device]
+
+		rate = dev.get('samplerate', '1 MHz').split()
+		samplerate = float(rate[0])
+		if len(rate) > 1:
+			samplerate *= {'Hz': 1, 'kHz': 1e3, 'MHz': 1e6, 'GHz': 1e9}[rate[1]]
+
+		unitsize = dev.getint('unitsize', 1)
+		names = {}
+		for key, value in dev.items():
+			if key.startswith('probe'):
+				names[int(key[len('probe'):]) - 1] = value
+
+		# The samples are split in chunks <capturefile>-1, <capturefile>-2...
+		prefix = dev.get('capturefile', 'logic-1')
+		chunks = [n for n in sr.namelist() if n == prefix or n.startswith(prefix + '-')]
+		chunks.sort(key=lambda n: int(n.rsplit('-', 1)[1]) if n != prefix else 0)
+		data = b''.join(sr.read(n) for n in chunks)
+
+	samples = [int.from_bytes(data[i:i + unitsize], 'little')
+			   for i in range(0, len(data) - unitsize + 1, unitsize)]
+	return samplerate, names, samples
+
+
+# Maps each stage to its channel index, from --stage or the channel names.
+def map_stages(names, stage_args):
+	by_name = {name.lower(): idx for idx, name in names.items()}
+	mapping = {}
+
+	for stage in STAGES:
+		if stage in by_name:
+			mapping[stage] = by_name[stage]
+
+	for arg in stage_args:
+		stage, _, channel = arg.partition('=')
+		stage = stage.strip().lower()
+		channel = channel.strip()
+		if stage not in STAGES:
+			sys.exit(f"Unknown stage '{stage}', stages: {', '.join(STAGES)}")
+		if channel.lower() in by_name:
+			mapping[stage] = by_name[channel.lower()]
+		elif channel.isdigit():
+			mapping[stage] = int(channel)
+		else:
+			sys.exit(f"Unknown channel '{channel}' for stage '{stage}'")
+
+	return mapping
+
+
+# Returns the (start, end) sample numbers of the spans the channel is high,
+# leaving out those cut by the start or the end of the capture.
+def find_spans(samples, channel):
+	spans = []
+	start = None
+	prev = (samples[0] >> channel) & 1 if samples else 0
+
+	for idx, sample in enumerate(samples):
+		level = (sample >> channel) & 1
+		if level and not prev:
+			start = idx
+		elif prev and not level and start is not None:
+			spans.append((start, idx))
+			start = None
+		prev = level
+
+	return spans
+
+
+# Prints a table row of the count, min, avg, p99 and max of values.
+def print_row(label, values, scale):
+	if not values:
+		print(f"{label:<22}{0:>8}")
+		return
+
+	values = sorted(v * scale for v in values)
+	p99 = values[min(len(values) - 1, (len(values) * 99) // 100)]
+	print(f"{label:<22}{len(values):>8}{values[0]:>12.1f}"
+		  f"{sum(values) / len(values):>12.1f}{p99:>12.1f}{values[-1]:>12.1f}")
+
+
+def report(args):
+	samplerate, names, samples = read_session(args.capture)
+	mapping = map_stages(names, args.stage)
+	if not mapping:
+		sys.exit("No channel of the capture is mapped to a stage, see --stage")
+
+	scale = (1e6 if args.unit == 'us' else 1e3) / samplerate
+	spans = {stage: find_spans(samples, channel) for stage, channel in mapping.items()}
+
+	print(f"{len(samples)} samples at {samplerate / 1e6:g} MHz, in {args.unit}")
+	print(f"{'Stage':<22}{'Count':>8}{'Min':>12}{'Avg':>12}{'P99':>12}{'Max':>12}")
+	for stage in STAGES:
+		if stage in spans:
+			print_row(stage, [end - start for start, end in spans[stage]], scale)
+
+	if 'capture' not in spans:
+		return
+
+	starts = [start for start, _ in spans['capture']]
+	print_row('frame period', [b - a for a, b in zip(starts, starts[1:])], scale)
+
+	# An ML run is paired with the latest capture done before it starts, as
+	# the next capture can start while the ML engine runs on the previous one.
+	if 'ml_run' in spans:
+		latencies = []
+		idx = -1
+		for run_start, run_end in spans['ml_run']:
+			while (idx + 1 < len(spans['capture']) and
+				   spans['capture'][idx + 1][1] <= run_start):
+				idx += 1
+			if idx >= 0:
+				latencies.append(run_end - spans['capture'][idx][0])
+		print_row('capture to ML done', latencies, scale)
+
+
+if __name__ == "__main__":
+
+	# Parse the command line arguments using argparse.
+	report(parser.parse_args())
@@ -0,0 +1,16 @@
+################################################################################
+# Copyright (c) 2025 Lattice Semiconductor Corporation
+#
+# SPDX-License-Identifier: UNLICENSED
+################################################################################
+
+'''
+This decoder annotates the pipeline stages of GARD from its trace pins, see
+inc/trace_pins.h of the firmware: each stage is shown with its duration, and
+each ML run with the latency from the start of the capture of its image.
+
+Copy the gard_trace directory in the sigrok decoders path, e.g.
+~/.local/share/libsigrokdecode/decoders, for PulseView to list it.
+'''
+
+from .pd import Decoder
@@ -0,0 +1,93 @@
+################################################################################
+# Copyright (c) 2025 Lattice Semiconductor Corporation
+#
+# SPDX-License-Identifier: UNLICENSED
+################################################################################
+
+import sigrokdecode as srd
+
+# Stages in pipeline order, as the channels, named as the trace ids of
+# inc/trace_pins.h.
+STAGES = ('capture', 'rescale', 'ml_copy', 'ml_run')
+
+ANN_LATENCY = len(STAGES)
+
+class Decoder(srd.Decoder):
+	api_version = 3
+	id = 'gard_trace'
+	name = 'GARD trace'
+	longname = 'GARD pipeline trace pins'
+	desc = 'Pipeline stages of GARD, timed by its trace pins.'
+	license = 'unlicense'
+	inputs = ['logic']
+	outputs = []
+	tags = ['Debug/trace']
+	optional_channels = tuple(
+		{'id': stage, 'name': stage.upper(), 'desc': 'Trace pin of ' + stage}
+		for stage in STAGES)
+	annotations = tuple((stage, stage.replace('_', ' ')) for stage in STAGES) + (
+		('latency', 'Capture to ML done'),
+	)
+	annotation_rows = tuple((stage + '-row', stage.replace('_', ' '), (idx,))
+							for idx, stage in enumerate(STAGES)) + (
+		('latency-row', 'Latency', (ANN_LATENCY,)),
+	)
+
+	def __init__(self):
+		self.reset()
+
+	def reset(self):
+		self.samplerate = None
+		self.starts = [None] * len(STAGES)
+		self.last_capture = None  # (start, end) of the latest capture done
+
+	def metadata(self, key, value):
+		if key == srd.SRD_CONF_SAMPLERATE:
+			self.samplerate = value
+
+	def start(self):
+		self.out_ann = self.register(srd.OUTPUT_ANN)
+
+	def duration(self, samples):
+		if not self.samplerate:
+			return '%d samples' % samples
+		us = samples * 1e6 / self.samplerate
+		return '%.1f ms' % (us / 1e3) if us >= 1e3 else '%.1f us' % us
+
+	def span_done(self, idx, start, end):
+		stage = STAGES[idx]
+		self.put(start, end, self.out_ann,
+				 [idx, ['%s: %s' % (stage, self.duration(end - start)),
+						self.duration(end - start)]])
+
+		if stage == 'capture':
+			self.last_capture = (start, end)
+		elif stage == 'ml_run' and self.last_capture is not None:
+			# The ML engine runs on the latest capture done before it started.
+			if self.last_capture[1] <= start:
+				first = self.last_capture[0]
+				self.put(first, end, self.out_ann,
+						 [ANN_LATENCY, ['Capture to ML done: %s' %
+										self.duration(end - first),
+										self.duration(end - first)]])
+
+	def decode(self):
+		used = [idx for idx in range(len(STAGES)) if self.has_channel(idx)]
+		if not used:
+			return
+
+		# A stage already running at the first sample is left out, as its
+		# start is not known.
+		levels = list(self.wait())
+		conds = [{idx: 'e'} for idx in used]
+		while True:
+			pins = self.wait(conds)
+			for idx in used:
+				if pins[idx] == levels[idx]:
+					continue
+				levels[idx] = pins[idx]
+				if pins[idx] == 1:
+					self.starts[idx] = self.samplenum
+				elif self.starts[idx] is not None:
+					self.span_done(idx, self.starts[idx], self.samplenum)
+					self.starts[idx] = None